@@ -31,6 +31,24 @@ VOID (
     IN  BOOLEAN DisableMmu
     ) = ArmReplaceLiveTranslationEntry;
 
+UINT64
+EFIAPI
+ArmMmuReadIdAA64Isar0 (
+  VOID
+  );
+
+VOID
+EFIAPI
+ArmMmuInvalidateTlbPage (
+  IN  UINT64  Operand
+  );
+
+VOID
+EFIAPI
+ArmMmuInvalidateTlbRange (
+  IN  UINT64  Operand
+  );
+
 STATIC
 UINT64
 ArmMemoryAttributeToPageAttribute (
@@ -85,6 +103,31 @@ ArmMemoryAttributeToPageAttribute (
 #define BITS_PER_LEVEL  9
 #define MAX_VA_BITS     48
 
+//
+// ID_AA64ISAR0_EL1.TLB reads as 2 if the TLBI range instructions are implemented
+//
+#define ID_AA64ISAR0_TLB_SHIFT  56
+#define ID_AA64ISAR0_TLB_MASK   0xF
+#define ID_AA64ISAR0_TLB_RANGE  2
+
+//
+// Without the TLBI range instructions, regions of more pages than this are
+// invalidated from the TLBs entirely rather than page by page.
+//
+#define MAX_TLBI_PAGES  512
+
+//
+// A TLBI range instruction covers (NUM + 1) * 2^(5 * SCALE + 1) pages, for a
+// NUM of 0 to 31 and a SCALE of 0 to 3.
+//
+#define MAX_TLBI_RANGE_PAGES  (32ULL << 16)
+
+#define TLBI_RANGE_TG_4KB  (1ULL << 46)
+
+#define TLBI_RANGE_OPERAND(Address, Scale, Num)                 \
+  (TLBI_RANGE_TG_4KB | ((UINT64)(Scale) << 44) |                \
+   ((UINT64)(Num) << 39) | (((Address) >> EFI_PAGE_SHIFT) & (BIT37 - 1)))
+
 STATIC
 UINTN
 GetRootTableEntryCount (
@@ -146,6 +189,74 @@ ReplaceTableEntry (
   }
 }
 
+/**
+  Invalidate the TLB entries of a region after its live page table entries
+  have been updated.
+
+  The updates of the page table entries of the region are completed by a
+  single barrier, after which the region is invalidated with TLBI range
+  instructions if FEAT_TLBIRANGE is implemented, or page by page if it is
+  small. Otherwise the TLBs are invalidated entirely.
+
+  @param[in]  RegionStart   The start of the region.
+  @param[in]  RegionLength  The length of the region.
+
+**/
+STATIC
+VOID
+InvalidateTlbRegion (
+  IN  UINT64  RegionStart,
+  IN  UINT64  RegionLength
+  )
+{
+  UINT64   Pages;
+  UINT64   Num;
+  UINTN    Scale;
+  BOOLEAN  HasTlbiRange;
+
+  Pages        = RegionLength >> EFI_PAGE_SHIFT;
+  HasTlbiRange = ((ArmMmuReadIdAA64Isar0 () >> ID_AA64ISAR0_TLB_SHIFT) &
+                  ID_AA64ISAR0_TLB_MASK) >= ID_AA64ISAR0_TLB_RANGE;
+
+  ArmDataSynchronizationBarrier ();
+
+  if ((Pages >= MAX_TLBI_RANGE_PAGES) ||
+      (!HasTlbiRange && (Pages > MAX_TLBI_PAGES)))
+  {
+    ArmInvalidateTlb ();
+    return;
+  }
+
+  if (!HasTlbiRange) {
+    for ( ; Pages > 0; Pages--, RegionStart += EFI_PAGE_SIZE) {
+      ArmMmuInvalidateTlbPage (RegionStart >> EFI_PAGE_SHIFT);
+    }
+  } else {
+    //
+    // A range covers an even number of pages, so take care of an odd page at
+    // the start separately, and then of the remaining pages five bits of the
+    // page count at a time.
+    //
+    if ((Pages & 1) != 0) {
+      ArmMmuInvalidateTlbPage (RegionStart >> EFI_PAGE_SHIFT);
+      RegionStart += EFI_PAGE_SIZE;
+      Pages--;
+    }
+
+    for (Scale = 0; Pages > 0; Scale++) {
+      Num = (Pages >> (5 * Scale + 1)) & 0x1F;
+      if (Num != 0) {
+        ArmMmuInvalidateTlbRange (TLBI_RANGE_OPERAND (RegionStart, Scale, Num - 1));
+        RegionStart += Num << (5 * Scale + 1 + EFI_PAGE_SHIFT);
+        Pages       -= Num << (5 * Scale + 1);
+      }
+    }
+  }
+
+  ArmDataSynchronizationBarrier ();
+  ArmInstructionSynchronizationBarrier ();
+}
+
 STATIC
 VOID
 FreePageTablesRecursive (
@@ -353,6 +464,13 @@ UpdateRegionMappingRecursive (
       }
 
       if (!IsTableEntry (*Entry, Level)) {
+        //
+        // The entries of the new table were not written with barriers, so
+        // make sure the page table walker observes them before it observes
+        // the table entry.
+        //
+        ArmDataSynchronizationBarrier ();
+
         EntryValue = (UINTN)TranslationTable | TT_TYPE_TABLE_ENTRY;
         ReplaceTableEntry (
           Entry,
@@ -368,7 +486,18 @@ UpdateRegionMappingRecursive (
       EntryValue |= (Level == 3) ? TT_TYPE_BLOCK_ENTRY_LEVEL3
                                  : TT_TYPE_BLOCK_ENTRY;
 
-      ReplaceTableEntry (Entry, EntryValue, RegionStart, BlockMask, FALSE);
+      if (ArmMmuEnabled ()) {
+        //
+        // Changing the output attributes of a block or page entry does not
+        // require a break-before-make sequence. The TLB entries of live tables
+        // are invalidated by UpdateRegionMapping () once the entire region has
+        // been updated, and tables that are not live are not cached in the TLBs
+        // at all, so the entry can simply be overwritten.
+        //
+        *Entry = EntryValue;
+      } else {
+        ReplaceTableEntry (Entry, EntryValue, RegionStart, BlockMask, FALSE);
+      }
     }
   }
 
@@ -386,7 +515,8 @@ UpdateRegionMapping (
   IN  BOOLEAN  TableIsLive
   )
 {
-  UINTN  T0SZ;
+  UINTN       T0SZ;
+  EFI_STATUS  Status;
 
   if (((RegionStart | RegionLength) & EFI_PAGE_MASK) != 0) {
     return EFI_INVALID_PARAMETER;
@@ -394,15 +524,24 @@ UpdateRegionMapping (
 
   T0SZ = ArmGetTCR () & TCR_T0SZ_MASK;
 
-  return UpdateRegionMappingRecursive (
-           RegionStart,
-           RegionStart + RegionLength,
-           AttributeSetMask,
-           AttributeClearMask,
-           RootTable,
-           GetRootTableLevel (T0SZ),
-           TableIsLive
-           );
+  Status = UpdateRegionMappingRecursive (
+             RegionStart,
+             RegionStart + RegionLength,
+             AttributeSetMask,
+             AttributeClearMask,
+             RootTable,
+             GetRootTableLevel (T0SZ),
+             TableIsLive
+             );
+
+  //
+  // Even on failure, part of the region may have been updated already.
+  //
+  if (TableIsLive && ArmMmuEnabled ()) {
+    InvalidateTlbRegion (RegionStart, RegionLength);
+  }
+
+  return Status;
 }
 
 STATIC
@@ -713,6 +852,11 @@ ArmConfigureMmu (
     MAIR_ATTR (TT_ATTR_INDX_MEMORY_WRITE_BACK, MAIR_ATTR_NORMAL_MEMORY_WRITE_BACK)
     );
 
+  //
+  // The new translation table was populated without any barriers or TLB
+  // maintenance, since it was not live.
+  //
+  ArmDataSynchronizationBarrier ();
   ArmSetTTBR0 (TranslationTable);
 
   if (!ArmMmuEnabled ()) {
@@ -722,6 +866,8 @@ ArmConfigureMmu (
     ArmEnableDataCache ();
 
     ArmEnableMmu ();
+  } else {
+    ArmInvalidateTlb ();
   }
 
   return EFI_SUCCESS;
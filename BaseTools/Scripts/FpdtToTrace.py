@@ -0,0 +1,298 @@
+##
+# Convert the firmware boot performance records to a Chrome trace.
+#
+# The Firmware Basic Boot Performance Table (FBPT) of the ACPI FPDT holds the
+# basic boot record, followed by all the edk2 extended performance records
+# logged in PEI, DXE, SMM and BDS (MdeModulePkg/Include/Guid/
+# ExtendedFirmwarePerformance.h). This tool pairs the start and end records as
+# the Dp shell command does, and writes them in the Trace Event JSON format
+# that chrome://tracing and Perfetto load.
+#
+# The FBPT is read from a binary dump, such as the file written by "dp -o", or
+# on Linux from the FPDT in sysfs and /dev/mem.
+#
+# --collapsed writes the measurements as collapsed stacks instead, one line of
+# "outer;inner exclusive-microseconds" per call stack, that flamegraph.pl and
+# speedscope draw as a flame graph. --diff compares the total time of each
+# measurement with that of another FBPT dump, to find what a firmware change
+# made slower or faster.
+#
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import argparse
+import json
+import struct
+import sys
+import uuid
+
+#
+# FPDT record types, MdePkg/Include/IndustryStandard/Acpi50.h
+#
+FPDT_BOOT_PERFORMANCE_TABLE_POINTER = 0x0000
+FPDT_FIRMWARE_BASIC_BOOT            = 0x0002
+
+#
+# edk2 extended record types
+#
+FPDT_GUID_EVENT_TYPE               = 0x1010
+FPDT_DYNAMIC_STRING_EVENT_TYPE     = 0x1011
+FPDT_DUAL_GUID_STRING_EVENT_TYPE   = 0x1012
+FPDT_GUID_QWORD_EVENT_TYPE         = 0x1013
+FPDT_GUID_QWORD_STRING_EVENT_TYPE  = 0x1014
+
+#
+# Progress identifiers, MdePkg/Include/Library/PerformanceLib.h
+#
+PERF_EVENT_ID             = 0x00
+PERF_EVENTSIGNAL_START_ID = 0x10
+PERF_CROSSMODULE_START_ID = 0x50
+PERF_CROSSMODULE_END_ID   = 0x51
+
+CORE_TOKENS = {
+    0x01: 'StartImage:',
+    0x03: 'LoadImage:',
+    0x05: 'DB:Start:',
+    0x07: 'DB:Support:',
+    0x09: 'DB:Stop:',
+}
+
+CATEGORIES = {
+    0x00: 'event',
+    0x01: 'image',
+    0x03: 'image',
+    0x05: 'driver-binding',
+    0x07: 'driver-binding',
+    0x09: 'driver-binding',
+    0x10: 'event-signal',
+    0x20: 'callback',
+    0x30: 'function',
+    0x40: 'in-module',
+    0x50: 'cross-module',
+}
+
+BASIC_BOOT_FIELDS = [
+    'ResetEnd',
+    'OsLoaderLoadImageStart',
+    'OsLoaderStartImageStart',
+    'ExitBootServicesEntry',
+    'ExitBootServicesExit',
+]
+
+class Record:
+    def __init__(self, Data):
+        self.Type, self.Length, self.Revision = struct.unpack_from('<HBB', Data, 0)
+        self.ProgressId, self.ApicId, self.Timestamp = struct.unpack_from('<HIQ', Data, 4)
+        self.Guid = str(uuid.UUID(bytes_le=bytes(Data[18:34]))).upper()
+        self.Guid2 = None
+        self.Qword = None
+        String = b''
+        if self.Type == FPDT_DYNAMIC_STRING_EVENT_TYPE:
+            String = Data[34:self.Length]
+        elif self.Type == FPDT_DUAL_GUID_STRING_EVENT_TYPE:
+            self.Guid2 = str(uuid.UUID(bytes_le=bytes(Data[34:50]))).upper()
+            String = Data[50:self.Length]
+        elif self.Type == FPDT_GUID_QWORD_EVENT_TYPE:
+            self.Qword, = struct.unpack_from('<Q', Data, 34)
+        elif self.Type == FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+            self.Qword, = struct.unpack_from('<Q', Data, 34)
+            String = Data[42:self.Length]
+        self.String = bytes(String).split(b'\0', 1)[0].decode('ascii', 'replace')
+
+    def IsStart(self):
+        if self.ProgressId >= PERF_EVENTSIGNAL_START_ID:
+            return (self.ProgressId & 0x000F) == 0
+        return (self.ProgressId & 0x0001) != 0
+
+    def StartId(self):
+        if self.ProgressId >= PERF_EVENTSIGNAL_START_ID:
+            return self.ProgressId & ~0x000F
+        return self.ProgressId if (self.ProgressId & 0x0001) != 0 else self.ProgressId - 1
+
+    def MatchKey(self):
+        #
+        # Cross module measurements may start and end in different modules.
+        #
+        if self.StartId() == PERF_CROSSMODULE_START_ID:
+            return (PERF_CROSSMODULE_START_ID, self.String)
+        return (self.StartId(), self.Guid, self.String)
+
+    def Name(self):
+        Name = self.String
+        if self.ProgressId < PERF_EVENTSIGNAL_START_ID:
+            Name = CORE_TOKENS.get(self.StartId(), '') + Name
+        return Name if Name != '' else self.Guid
+
+    def Args(self):
+        Args = {'Guid': self.Guid, 'ProgressId': '0x%04X' % self.ProgressId}
+        if self.Guid2 is not None:
+            Args['Guid2'] = self.Guid2
+        if self.Qword is not None:
+            Args['Qword'] = '0x%X' % self.Qword
+        return Args
+
+def ReadFbptFromLinux():
+    with open('/sys/firmware/acpi/tables/FPDT', 'rb') as File:
+        Fpdt = File.read()
+    Offset = 36
+    while Offset + 4 <= len(Fpdt):
+        Type, Length = struct.unpack_from('<HB', Fpdt, Offset)
+        if Length == 0:
+            break
+        if Type == FPDT_BOOT_PERFORMANCE_TABLE_POINTER:
+            Address, = struct.unpack_from('<Q', Fpdt, Offset + 8)
+            with open('/dev/mem', 'rb') as Mem:
+                Mem.seek(Address)
+                Header = Mem.read(8)
+                Signature, TableLength = struct.unpack('<4sI', Header)
+                if Signature != b'FBPT':
+                    raise ValueError('no FBPT at 0x%X' % Address)
+                return Header + Mem.read(TableLength - 8)
+        Offset += Length
+    raise ValueError('no boot performance table pointer in the FPDT')
+
+def ConvertFbpt(Fbpt):
+    Signature, TableLength = struct.unpack_from('<4sI', Fbpt, 0)
+    if Signature != b'FBPT':
+        raise ValueError('not a Firmware Basic Boot Performance Table')
+    TableLength = min(TableLength, len(Fbpt))
+
+    Events = []
+    Opened = {}
+    Offset = 8
+    while Offset + 4 <= TableLength:
+        Type, Length = struct.unpack_from('<HB', Fbpt, Offset)
+        if Length == 0 or Offset + Length > TableLength:
+            break
+        Data = memoryview(Fbpt)[Offset:Offset + Length]
+        Offset += Length
+
+        if Type == FPDT_FIRMWARE_BASIC_BOOT:
+            Values = struct.unpack_from('<5Q', Data, 8)
+            for Name, Value in zip(BASIC_BOOT_FIELDS, Values):
+                if Value != 0:
+                    Events.append({'name': Name, 'cat': 'basic-boot', 'ph': 'i', 's': 'g',
+                                   'ts': Value / 1000.0, 'pid': 0, 'tid': 0})
+            continue
+        if Type < FPDT_GUID_EVENT_TYPE or Type > FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+            continue
+
+        Rec = Record(Data)
+        if Rec.ProgressId == PERF_EVENT_ID:
+            Events.append({'name': Rec.Name(), 'cat': 'event', 'ph': 'i', 's': 't',
+                           'ts': Rec.Timestamp / 1000.0, 'pid': 0, 'tid': Rec.ApicId,
+                           'args': Rec.Args()})
+        elif Rec.IsStart():
+            Opened.setdefault(Rec.MatchKey(), []).append(Rec)
+        else:
+            #
+            # Like Dp, an end record closes the last open start record.
+            #
+            Starts = Opened.get(Rec.MatchKey())
+            if not Starts:
+                continue
+            Start = Starts.pop()
+            Events.append({'name': Start.Name(), 'cat': CATEGORIES.get(Start.StartId(), 'other'),
+                           'ph': 'X', 'ts': Start.Timestamp / 1000.0,
+                           'dur': max(Rec.Timestamp - Start.Timestamp, 0) / 1000.0,
+                           'pid': 0, 'tid': Start.ApicId, 'args': Start.Args()})
+
+    Events.sort(key=lambda Event: Event['ts'])
+    return {'traceEvents': Events, 'displayTimeUnit': 'ns'}
+
+def CollapseStacks(Trace):
+    #
+    # Nest the measurements of each processor by their intervals: a measurement
+    # is inside the last one that is still open when it starts. The time of a
+    # stack excludes the time of the measurements nested in it.
+    #
+    Stacks = {}
+    Threads = {}
+    for Event in Trace['traceEvents']:
+        if Event['ph'] == 'X':
+            Threads.setdefault(Event['tid'], []).append(Event)
+    for Events in Threads.values():
+        Events.sort(key=lambda Event: (Event['ts'], -Event['dur']))
+        Open = []
+        Nested = []
+        for Event in Events:
+            End = Event['ts'] + Event['dur']
+            while Open and Open[-1][1] < End:
+                Open.pop()
+            if Open:
+                Open[-1][2] -= Event['dur']
+            Path = (Open[-1][0] + ';' if Open else '') + Event['name'].replace(';', ':')
+            Open.append([Path, End, Event['dur']])
+            Nested.append(Open[-1])
+        for Path, End, Self in Nested:
+            Stacks[Path] = Stacks.get(Path, 0.0) + max(Self, 0.0)
+    return Stacks
+
+def TotalsByName(Trace):
+    Totals = {}
+    for Event in Trace['traceEvents']:
+        if Event['ph'] == 'X':
+            Count, Duration = Totals.get(Event['name'], (0, 0.0))
+            Totals[Event['name']] = (Count + 1, Duration + Event['dur'])
+    return Totals
+
+def DiffTraces(Base, Trace, File):
+    BaseTotals = TotalsByName(Base)
+    Totals = TotalsByName(Trace)
+    Rows = []
+    for Name in set(BaseTotals) | set(Totals):
+        BaseCount, BaseDuration = BaseTotals.get(Name, (0, 0.0))
+        Count, Duration = Totals.get(Name, (0, 0.0))
+        Rows.append((Duration - BaseDuration, Name, BaseCount, BaseDuration, Count, Duration))
+    Rows.sort(key=lambda Row: (-abs(Row[0]), Row[1]))
+    print('%12s %12s %12s %6s %6s  %s' % ('Base(us)', 'New(us)', 'Delta(us)', 'Base#', 'New#', 'Name'), file=File)
+    for Delta, Name, BaseCount, BaseDuration, Count, Duration in Rows:
+        print('%12.0f %12.0f %+12.0f %6d %6d  %s' % (BaseDuration, Duration, Delta, BaseCount, Count, Name), file=File)
+
+def main():
+    Parser = argparse.ArgumentParser(
+        description='Convert the firmware boot performance records (FBPT) to a Chrome trace.')
+    Source = Parser.add_mutually_exclusive_group(required=True)
+    Source.add_argument('-i', '--input', help='binary dump of the FBPT')
+    Source.add_argument('--linux', action='store_true',
+                        help='read the FBPT of the running Linux system (needs access to /dev/mem)')
+    Parser.add_argument('-o', '--output', help='output file, standard output by default')
+    Mode = Parser.add_mutually_exclusive_group()
+    Mode.add_argument('--collapsed', action='store_true',
+                      help='write collapsed stacks for a flame graph instead of the trace')
+    Mode.add_argument('--diff', metavar='BASE',
+                      help='compare the time of each measurement with the binary FBPT dump BASE')
+    Args = Parser.parse_args()
+
+    try:
+        if Args.linux:
+            Fbpt = ReadFbptFromLinux()
+        else:
+            with open(Args.input, 'rb') as File:
+                Fbpt = File.read()
+        Trace = ConvertFbpt(Fbpt)
+        Base = None
+        if Args.diff:
+            with open(Args.diff, 'rb') as File:
+                Base = ConvertFbpt(File.read())
+    except (OSError, ValueError, struct.error) as Error:
+        print('FpdtToTrace: %s' % Error, file=sys.stderr)
+        return 1
+
+    File = open(Args.output, 'w') if Args.output else sys.stdout
+    try:
+        if Args.collapsed:
+            for Path, Duration in sorted(CollapseStacks(Trace).items()):
+                print('%s %d' % (Path, round(Duration)), file=File)
+        elif Base is not None:
+            DiffTraces(Base, Trace, File)
+        else:
+            json.dump(Trace, File, indent=1)
+    finally:
+        if File is not sys.stdout:
+            File.close()
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1177,6 +1177,61 @@ Returns:
   return TRUE;
 }
 
+STATIC
+VOID
+MoveFfsFile (
+  IN MEMORY_FILE  *FvImage,
+  IN UINT8        *Destination,
+  IN UINT8        *Source,
+  IN UINTN        FileSize,
+  IN UINTN        BufferSize
+  )
+/*++
+
+Routine Description:
+
+  This function moves an FFS file that was read into the free space of the FV
+  image to its final place, and sets the free space that it leaves behind back
+  to the erase polarity of the FV.
+
+Arguments:
+
+  FvImage               The memory image of the FV.
+  Destination           The final place of the FFS file.
+  Source                The place where the FFS file was read.
+  FileSize              The size of the FFS file.
+  BufferSize            The size of the free space that the file was read into.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINT8  *SourceEnd;
+  UINT8  *EraseStart;
+  INT32  EraseValue;
+
+  if (((EFI_FIRMWARE_VOLUME_HEADER *) FvImage->FileImage)->Attributes & EFI_FVB2_ERASE_POLARITY) {
+    EraseValue = -1;
+  } else {
+    EraseValue = 0;
+  }
+
+  if (Destination != Source) {
+    memmove (Destination, Source, FileSize);
+  }
+
+  SourceEnd = Source + BufferSize;
+  if (Destination > Source) {
+    memset (Source, EraseValue, (UINTN) ((Destination < SourceEnd ? Destination : SourceEnd) - Source));
+  }
+  EraseStart = Destination + FileSize > Source ? Destination + FileSize : Source;
+  if (EraseStart < SourceEnd) {
+    memset (EraseStart, EraseValue, (UINTN) (SourceEnd - EraseStart));
+  }
+}
+
 EFI_STATUS
 AddFile (
   IN OUT MEMORY_FILE          *FvImage,
@@ -1193,6 +1248,9 @@ Routine Description:
   This function adds a file to the FV image.  The file will pad to the
   appropriate alignment if required.
 
+  The file is read straight into the free space of the FV image, and it is
+  aligned and rebased there, so no copy of it is allocated.
+
 Arguments:
 
   FvImage       The memory image of the FV to add it to.  The current offset
@@ -1215,12 +1273,14 @@ Returns:
 {
   FILE                  *NewFile;
   UINTN                 FileSize;
+  UINTN                 ReadSize;
   UINT8                 *FileBuffer;
   UINTN                 NumBytesRead;
   UINT32                CurrentFileAlignment;
   EFI_STATUS            Status;
   UINTN                 Index1;
   UINT8                 FileGuidString[PRINTED_GUID_BUFFER_SIZE];
+  EFI_FFS_FILE_HEADER   *FfsFile;
 
   Index1 = 0;
   //
@@ -1244,15 +1304,32 @@ Returns:
   // Get the file size
   //
   FileSize = _filelength (fileno (NewFile));
+  ReadSize = FileSize;
 
   //
-  // Read the file into a buffer
+  // Verify space exists to add the file, and find where it is read. A non PI
+  // file is read into its final place. An FFS file is read into the top of the
+  // free space, below the VTF file if one was added: its alignment is only
+  // known once it is read, and it is moved down to its final place after the
+  // pad file in front of it is added.
   //
-  FileBuffer = malloc (FileSize);
-  if (FileBuffer == NULL) {
-    fclose (NewFile);
-    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
-    return EFI_OUT_OF_RESOURCES;
+  if (!FvInfo->IsPiFvImage) {
+    if (FileSize > (UINTN) (FvImage->Eof - FvImage->CurrentFilePointer)) {
+      fclose (NewFile);
+      Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    FileBuffer = (UINT8 *) FvImage->CurrentFilePointer;
+  } else {
+    if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
+      fclose (NewFile);
+      Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    FileBuffer = (UINT8 *) (((UINTN) *VtfFileImage - FileSize) & ~((UINTN) EFI_FFS_FILE_HEADER_ALIGNMENT - 1));
+    if ((UINTN) FileBuffer < (UINTN) FvImage->CurrentFilePointer) {
+      FileBuffer = (UINT8 *) FvImage->CurrentFilePointer;
+    }
   }
 
   NumBytesRead = fread (FileBuffer, sizeof (UINT8), FileSize, NewFile);
@@ -1266,7 +1343,6 @@ Returns:
   // Verify read successful
   //
   if (NumBytesRead != sizeof (UINT8) * FileSize) {
-    free  (FileBuffer);
     Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
     return EFI_ABORTED;
   }
@@ -1275,13 +1351,12 @@ Returns:
   // For None PI Ffs file, directly add them into FvImage.
   //
   if (!FvInfo->IsPiFvImage) {
-    memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
     if (FvInfo->SizeofFvFiles[Index] > FileSize) {
       FvImage->CurrentFilePointer += FvInfo->SizeofFvFiles[Index];
     } else {
       FvImage->CurrentFilePointer += FileSize;
     }
-    goto Done;
+    return EFI_SUCCESS;
   }
 
   //
@@ -1289,20 +1364,10 @@ Returns:
   //
   Status = VerifyFfsFile ((EFI_FFS_FILE_HEADER *)FileBuffer);
   if (EFI_ERROR (Status)) {
-    free (FileBuffer);
     Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
     return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Verify space exists to add the file
-  //
-  if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
-    free (FileBuffer);
-    Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
-    return EFI_OUT_OF_RESOURCES;
-  }
-
   //
   // Verify the input file is the duplicated file in this Fv image
   //
@@ -1310,7 +1375,6 @@ Returns:
     if (CompareGuid ((EFI_GUID *) FileBuffer, &mFileGuidArray [Index1]) == 0) {
       Error (NULL, 0, 2000, "Invalid parameter", "the %dth file and %uth file have the same file GUID.", (unsigned) Index1 + 1, (unsigned) Index + 1);
       PrintGuid ((EFI_GUID *) FileBuffer);
-      free (FileBuffer);
       return EFI_INVALID_PARAMETER;
     }
   }
@@ -1343,33 +1407,32 @@ Returns:
       //
       // No previous VTF, add this one.
       //
-      *VtfFileImage = (EFI_FFS_FILE_HEADER *) (UINTN) ((UINTN) FvImage->FileImage + FvInfo->Size - FileSize);
+      FfsFile = (EFI_FFS_FILE_HEADER *) (UINTN) ((UINTN) FvImage->FileImage + FvInfo->Size - FileSize);
       //
       // Sanity check. The file MUST align appropriately
       //
-      if (((UINTN) *VtfFileImage + GetFfsHeaderLength((EFI_FFS_FILE_HEADER *)FileBuffer) - (UINTN) FvImage->FileImage) % (1 << CurrentFileAlignment)) {
+      if (((UINTN) FfsFile + GetFfsHeaderLength((EFI_FFS_FILE_HEADER *)FileBuffer) - (UINTN) FvImage->FileImage) % (1 << CurrentFileAlignment)) {
         Error (NULL, 0, 3000, "Invalid", "VTF file cannot be aligned on a %u-byte boundary.", (unsigned) (1 << CurrentFileAlignment));
-        free (FileBuffer);
         return EFI_ABORTED;
       }
       //
-      // Rebase the PE or TE image in FileBuffer of FFS file for XIP
+      // Move the VTF file to the top of the FV
+      //
+      MoveFfsFile (FvImage, (UINT8 *) FfsFile, FileBuffer, FileSize, ReadSize);
+      *VtfFileImage = FfsFile;
+      //
+      // Rebase the PE or TE image of the FFS file in the FV image for XIP
       // Rebase for the debug genfvmap tool
       //
-      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
+      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], FfsFile, (UINTN) FfsFile - (UINTN) FvImage->FileImage, FvMapFile);
       if (EFI_ERROR (Status)) {
         Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
         return Status;
       }
-      //
-      // copy VTF File
-      //
-      memcpy (*VtfFileImage, FileBuffer, FileSize);
 
-      PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
+      PrintGuidToBuffer ((EFI_GUID *) FfsFile, FileGuidString, sizeof (FileGuidString), TRUE);
       fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
 
-      free (FileBuffer);
       DebugMsg (NULL, 0, 9, "Add VTF FFS file in FV image", NULL);
       return EFI_SUCCESS;
     } else {
@@ -1377,20 +1440,18 @@ Returns:
       // Already found a VTF file.
       //
       Error (NULL, 0, 3000, "Invalid", "multiple VTF files are not permitted within a single FV.");
-      free (FileBuffer);
       return EFI_ABORTED;
     }
   }
 
   //
-  // Add pad file if necessary
+  // Add pad file if necessary. The pad file must end below the file read.
   //
   if (!AdjustInternalFfsPadding ((EFI_FFS_FILE_HEADER *) FileBuffer, FvImage,
          1 << CurrentFileAlignment, &FileSize)) {
-    Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, *VtfFileImage, NULL, FileSize);
+    Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, FileBuffer, NULL, FileSize);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 4002, "Resource", "FV space is full, could not add pad file for data alignment property.");
-      free (FileBuffer);
       return EFI_ABORTED;
     }
   }
@@ -1399,24 +1460,24 @@ Returns:
   //
   if ((UINTN) (FvImage->CurrentFilePointer + FileSize) <= (UINTN) (*VtfFileImage)) {
     //
-    // Rebase the PE or TE image in FileBuffer of FFS file for XIP.
-    // Rebase Bs and Rt drivers for the debug genfvmap tool.
+    // Move the file to its place
     //
-    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
-  if (EFI_ERROR (Status)) {
-    Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-    return Status;
-  }
+    FfsFile = (EFI_FFS_FILE_HEADER *) FvImage->CurrentFilePointer;
+    MoveFfsFile (FvImage, (UINT8 *) FfsFile, FileBuffer, FileSize, ReadSize);
     //
-    // Copy the file
+    // Rebase the PE or TE image of the FFS file in the FV image for XIP.
+    // Rebase Bs and Rt drivers for the debug genfvmap tool.
     //
-    memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
-    PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
+    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], FfsFile, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
+      return Status;
+    }
+    PrintGuidToBuffer ((EFI_GUID *) FfsFile, FileGuidString, sizeof (FileGuidString), TRUE);
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
   } else {
     Error (NULL, 0, 4002, "Resource", "FV space is full, cannot add file %s.", FvInfo->FvFiles[Index]);
-    free (FileBuffer);
     return EFI_ABORTED;
   }
   //
@@ -1426,12 +1487,6 @@ Returns:
     FvImage->CurrentFilePointer++;
   }
 
-Done:
-  //
-  // Free allocated memory.
-  //
-  free (FileBuffer);
-
   return EFI_SUCCESS;
 }
 
@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#include <new>
 #include "VfrCompiler.h"
 #include "CommonLib.h"
 #include "EfiUtilityMsgs.h"
@@ -53,7 +54,8 @@ CVfrCompiler::IS_RUN_STATUS (
 VOID
 CVfrCompiler::OptionInitialization (
   IN INT32      Argc,
-  IN CHAR8      **Argv
+  IN CHAR8      **Argv,
+  IN UINT32     InputFileIndex
   )
 {
   INT32         Index;
@@ -79,6 +81,7 @@ CVfrCompiler::OptionInitialization (
   mOptions.AutoDefault                   = FALSE;
   mOptions.CheckDefault                  = FALSE;
   memset (&mOptions.OverrideClassGuid, 0, sizeof (EFI_GUID));
+  mInputFileCount                        = 0;
 
   if (Argc == 1) {
     Usage ();
@@ -169,10 +172,23 @@ CVfrCompiler::OptionInitialization (
     }
   }
 
-  if (Index != Argc - 1) {
+  //
+  // The options apply to all VFR files that follow them, which are compiled
+  // one after another.
+  //
+  if (Index >= Argc) {
     DebugError (NULL, 0, 1001, "Missing option", "VFR file name is not specified.");
     goto Fail;
   } else {
+    mInputFileCount = (UINT32) (Argc - Index);
+    for (; Index < Argc; Index++) {
+      if (Argv[Index][0] == '-') {
+        DebugError (NULL, 0, 1000, "Unknown option", "option %s must precede the VFR files", Argv[Index]);
+        goto Fail;
+      }
+    }
+    Index = Argc - (INT32) mInputFileCount + (INT32) InputFileIndex;
+
     mOptions.VfrFileName = (CHAR8 *) malloc (strlen (Argv[Index]) + 1);
     if (mOptions.VfrFileName == NULL) {
       DebugError (NULL, 0, 4001, "Resource: memory can't be allocated", NULL);
@@ -465,7 +481,8 @@ CVfrCompiler::SetRecordListFileName (
 
 CVfrCompiler::CVfrCompiler (
   IN INT32      Argc,
-  IN CHAR8      **Argv
+  IN CHAR8      **Argv,
+  IN UINT32     InputFileIndex
   )
 {
   mPreProcessCmd = (CHAR8 *) PREPROCESSOR_COMMAND;
@@ -473,7 +490,7 @@ CVfrCompiler::CVfrCompiler (
 
   SET_RUN_STATUS (STATUS_STARTED);
 
-  OptionInitialization(Argc, Argv);
+  OptionInitialization(Argc, Argv, InputFileIndex);
 
   if ((IS_RUN_STATUS(STATUS_FAILED)) || (IS_RUN_STATUS(STATUS_DEAD))) {
     return;
@@ -545,7 +562,7 @@ CVfrCompiler::Usage (
     "VfrCompile version " VFR_COMPILER_VERSION "Build " __BUILD_VERSION,
     "Copyright (c) 2004-2016 Intel Corporation. All rights reserved.",
     " ",
-    "Usage: VfrCompile [options] VfrFile",
+    "Usage: VfrCompile [options] VfrFile [VfrFile ...]",
     " ",
     "Options:",
     "  -h, --help     prints this help",
@@ -904,6 +921,58 @@ Err1:
   fclose (pInFile);
 }
 
+template <class T>
+static VOID
+ResetGlobalObject (
+  IN OUT T  &Object
+  )
+{
+  Object.~T ();
+  new (&Object) T ();
+}
+
+static VOID
+FreePackageData (
+  IN OUT PACKAGE_DATA  &Package
+  )
+{
+  if (Package.Buffer != NULL) {
+    delete[] Package.Buffer;
+  }
+  Package.Buffer = NULL;
+  Package.Size   = 0;
+}
+
+/**
+  Restores the global state left by the compilation of a VFR file, so that the
+  next VFR file of the command line is compiled as if by a new process.
+
+**/
+static VOID
+ResetGlobalData (
+  VOID
+  )
+{
+  ResetGlobalObject (gCFormPkg);
+  ResetGlobalObject (gCIfrRecordInfoDB);
+  ResetGlobalObject (gCVfrDataStorage);
+  ResetGlobalObject (gCVfrDefaultStore);
+  ResetGlobalObject (gCVfrVarDataTypeDB);
+  ResetGlobalObject (gCVfrBufferConfig);
+  ResetGlobalObject (gCVfrErrorHandle);
+  ResetGlobalObject (gCVfrStringDB);
+
+  memset (CIfrFormId::FormIdBitMap, 0, sizeof (CIfrFormId::FormIdBitMap));
+  gAdjustOpcodeOffset = 0;
+  gNeedAdjustOpcode   = FALSE;
+  gAdjustOpcodeLen    = 0;
+  gCreateOp           = TRUE;
+  gScopeCount         = 0;
+
+  FreePackageData (gCBuffer);
+  FreePackageData (gRBuffer);
+}
+
 int
 main (
   IN int             Argc,
@@ -911,29 +980,43 @@ main (
   )
 {
   COMPILER_RUN_STATUS  Status;
+  CVfrCompiler         *Compiler;
+  UINT32               FileIndex;
+  UINT32               FileCount;
 
   SetPrintLevel(WARNING_LOG_LEVEL);
-  CVfrCompiler         Compiler(Argc, Argv);
 
-  Compiler.PreProcess();
-  Compiler.Compile();
-  Compiler.AdjustBin();
-  Compiler.GenBinary();
-  Compiler.GenCFile();
-  Compiler.GenRecordListFile ();
+  //
+  // Each VFR file of the command line is compiled by a compiler of its own,
+  // which saves a process creation for each of the VFR files of a module.
+  //
+  FileCount = 1;
+  for (FileIndex = 0; FileIndex < FileCount; FileIndex++) {
+    if (FileIndex > 0) {
+      ResetGlobalData ();
+    }
 
-  Status = Compiler.RunStatus ();
-  if ((Status == STATUS_DEAD) || (Status == STATUS_FAILED)) {
-    return 2;
-  }
+    Compiler = new CVfrCompiler (Argc, Argv, FileIndex);
+    if (FileIndex == 0) {
+      FileCount = Compiler->InputFileCount ();
+    }
 
-  if (gCBuffer.Buffer != NULL) {
-    delete[] gCBuffer.Buffer;
+    Compiler->PreProcess();
+    Compiler->Compile();
+    Compiler->AdjustBin();
+    Compiler->GenBinary();
+    Compiler->GenCFile();
+    Compiler->GenRecordListFile ();
+
+    Status = Compiler->RunStatus ();
+    delete Compiler;
+    if ((Status == STATUS_DEAD) || (Status == STATUS_FAILED)) {
+      return 2;
+    }
   }
 
-  if (gRBuffer.Buffer != NULL) {
-    delete[] gRBuffer.Buffer;
-  }
+  FreePackageData (gCBuffer);
+  FreePackageData (gRBuffer);
 
   return GetUtilityStatus ();
 }
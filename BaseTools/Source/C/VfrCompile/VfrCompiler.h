@@ -71,8 +71,9 @@ private:
   OPTIONS              mOptions;
   CHAR8                *mPreProcessCmd;
   CHAR8                *mPreProcessOpt;
+  UINT32               mInputFileCount;
 
-  VOID    OptionInitialization (IN INT32 , IN CHAR8 **);
+  VOID    OptionInitialization (IN INT32 , IN CHAR8 **, IN UINT32);
   VOID    AppendIncludePath (IN CHAR8 *);
   VOID    AppendCPreprocessorOptions (IN CHAR8 *);
   INT8    SetBaseFileName (VOID);
@@ -89,8 +90,12 @@ public:
     return mRunStatus;
   }
 
+  UINT32 InputFileCount (VOID) {
+    return mInputFileCount;
+  }
+
 public:
-  CVfrCompiler (IN INT32 , IN CHAR8 **);
+  CVfrCompiler (IN INT32 , IN CHAR8 **, IN UINT32 InputFileIndex = 0);
   ~CVfrCompiler ();
 
   VOID                Usage (VOID);
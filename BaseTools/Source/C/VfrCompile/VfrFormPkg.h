@@ -167,6 +167,7 @@ extern CFormPkg       gCFormPkg;
 extern CVfrStringDB   gCVfrStringDB;
 extern UINT32         gAdjustOpcodeOffset;
 extern BOOLEAN        gNeedAdjustOpcode;
+extern UINT32         gAdjustOpcodeLen;
 
 struct SIfrRecord {
   UINT32     mLineNo;
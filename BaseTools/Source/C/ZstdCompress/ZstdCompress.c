@@ -0,0 +1,2112 @@
+/** @file
+  Compress and decompress files in the Zstandard format of RFC 8878.
+
+  The encoder writes a single frame that records its content size, in blocks
+  of 128KB whose window is the whole content. The matches are found with hash
+  chains and a two steps lazy evaluation, the literals are Huffman coded and
+  the sequences FSE coded with the predefined or tailored distributions. The
+  frames are decoded with the decoder of ZstdCustomDecompressLib.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ParseInf.h"
+#include "EfiUtilityMsgs.h"
+#include "CommonLib.h"
+#include "ZstdDecompress.h"
+
+#define UTILITY_NAME           "ZstdCompress"
+#define UTILITY_MAJOR_VERSION  0
+#define UTILITY_MINOR_VERSION  1
+
+#define ZSTD_NULL    0
+#define ZSTD_ENCODE  1
+#define ZSTD_DECODE  2
+
+#define ZSTD_MAGIC_NUMBER       0xFD2FB528
+#define ZSTD_BLOCK_SIZE_MAX     SIZE_128KB
+#define ZSTD_BLOCK_HEADER_SIZE  3
+#define ZSTD_FRAME_HEADER_MAX   14
+
+#define ZSTD_BLOCK_TYPE_RAW         0
+#define ZSTD_BLOCK_TYPE_RLE         1
+#define ZSTD_BLOCK_TYPE_COMPRESSED  2
+
+#define ZSTD_LITERALS_TYPE_RAW         0
+#define ZSTD_LITERALS_TYPE_RLE         1
+#define ZSTD_LITERALS_TYPE_COMPRESSED  2
+
+#define ZSTD_TABLE_MODE_PREDEFINED  0
+#define ZSTD_TABLE_MODE_RLE         1
+#define ZSTD_TABLE_MODE_COMPRESSED  2
+
+#define ZSTD_HASH_LOG      17
+#define ZSTD_SEARCH_DEPTH  32
+#define ZSTD_MATCH_MIN     4
+#define ZSTD_MATCH_GOOD    128
+
+#define ZSTD_HUFFMAN_LOG_MAX      11
+#define ZSTD_HUFFMAN_SYMBOLS_MAX  256
+#define ZSTD_WEIGHT_LOG_MAX       6
+#define ZSTD_FSE_LOG_MIN          5
+#define ZSTD_FSE_LOG_MAX          9
+#define ZSTD_FSE_SYMBOLS_MAX      53
+
+#define ZSTD_LITERAL_LENGTH_CODE_MAX  35
+#define ZSTD_MATCH_LENGTH_CODE_MAX    52
+#define ZSTD_OFFSET_CODE_MAX          31
+#define ZSTD_OFFSET_DEFAULT_CODE_MAX  28
+
+//
+// A sequence of a block: the literals that precede the match, and the match,
+// with its offset value of the repeat offsets rules.
+//
+typedef struct {
+  UINT32    LiteralLength;
+  UINT32    MatchLength;
+  UINT32    OffsetValue;
+} ZSTD_SEQUENCE;
+
+//
+// The forward bit writer of the Huffman and FSE streams, that are read
+// backward by the decoder.
+//
+typedef struct {
+  UINT8      *Buffer;
+  UINTN      Capacity;
+  UINTN      Position;
+  UINT64     Container;
+  UINTN      Bits;
+  BOOLEAN    Overflow;
+} ZSTD_BIT_WRITER;
+
+//
+// The encoding transform of a symbol of a FSE table.
+//
+typedef struct {
+  INT32     DeltaFindState;
+  UINT32    DeltaNbBits;
+} ZSTD_FSE_SYMBOL;
+
+//
+// The encoding table of a FSE distribution.
+//
+typedef struct {
+  UINTN              Log;
+  UINT16             StateTable[1 << ZSTD_FSE_LOG_MAX];
+  ZSTD_FSE_SYMBOL    Symbol[ZSTD_FSE_SYMBOLS_MAX];
+} ZSTD_FSE_TABLE;
+
+//
+// The encoder context.
+//
+typedef struct {
+  CONST UINT8      *Source;
+  UINTN            SourceSize;
+  UINT32           *Head;
+  UINT32           *Chain;
+  UINTN            NextInsert;
+  UINT32           Repeat[3];
+  ZSTD_SEQUENCE    *Sequences;
+  UINTN            SequenceCount;
+  UINT8            *Literals;
+  UINTN            LiteralCount;
+} ZSTD_ENCODER;
+
+//
+// The baselines of the literal length and match length codes, and their
+// number of extra bits.
+//
+STATIC CONST UINT32  mLiteralLengthBase[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  0,   1,    2,    3,    4,    5,    6,     7,     8,     9,     10,    11,
+  12,  13,   14,   15,   16,   18,   20,    22,    24,    28,    32,    40,
+  48,  64,   128,  256,  512,  1024, 2048,  4096,  8192,  16384, 32768, 65536
+};
+
+STATIC CONST UINT8  mLiteralLengthBits[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,  0,
+  0, 0, 0, 0, 1, 1, 1, 1, 2, 2,  3,  3,
+  4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+
+STATIC CONST UINT32  mMatchLengthBase[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  3,   4,   5,    6,    7,    8,    9,    10,   11,    12,    13,    14,    15,    16,
+  17,  18,  19,   20,   21,   22,   23,   24,   25,    26,    27,    28,    29,    30,
+  31,  32,  33,   34,   35,   37,   39,   41,   43,    47,    51,    59,    67,    83,
+  99,  131, 259,  515,  1027, 2051, 4099, 8195, 16387, 32771, 65539
+};
+
+STATIC CONST UINT8  mMatchLengthBits[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,
+  0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4,  4,
+  5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+
+//
+// The predefined distributions of the literal length, offset and match length
+// codes.
+//
+STATIC CONST INT16  mLiteralLengthDefault[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1
+};
+
+STATIC CONST INT16  mOffsetDefault[ZSTD_OFFSET_DEFAULT_CODE_MAX + 1] = {
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+STATIC CONST INT16  mMatchLengthDefault[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1
+};
+
+#define ZSTD_LITERAL_LENGTH_DEFAULT_LOG  6
+#define ZSTD_OFFSET_DEFAULT_LOG          5
+#define ZSTD_MATCH_LENGTH_DEFAULT_LOG    6
+
+/**
+  Returns the bit position of the highest bit set in a 32-bit value.
+
+  @param  Operand  The value, not zero.
+
+  @return The bit position of the highest bit set.
+**/
+INTN
+ZstdHighBitSet32 (
+  IN UINT32  Operand
+  )
+{
+  INTN  BitIndex;
+
+  for (BitIndex = -1; Operand != 0; BitIndex++) {
+    Operand >>= 1;
+  }
+
+  return BitIndex;
+}
+
+/**
+  Returns the base 2 logarithm of a value, in 1/256 bits.
+
+  @param  Value  The value, not zero.
+
+  @return The logarithm, with a linear interpolation between the powers of two.
+**/
+STATIC
+UINTN
+ZstdLog2Fraction (
+  IN UINT32  Value
+  )
+{
+  UINTN  HighBit;
+
+  HighBit = (UINTN)ZstdHighBitSet32 (Value);
+  return HighBit * 256 + (((UINT64)Value << 8) >> HighBit) - 256;
+}
+
+/**
+  Writes a little endian value.
+
+  @param  Buffer  The unaligned value.
+  @param  Value   The value.
+  @param  Size    The size of the value in bytes.
+**/
+STATIC
+VOID
+ZstdWriteLittleEndian (
+  OUT UINT8   *Buffer,
+  IN  UINT64  Value,
+  IN  UINTN   Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)(Value >> (Index * 8));
+  }
+}
+
+/**
+  Starts a bit stream.
+
+  @param  Writer    The bit writer.
+  @param  Buffer    The buffer of the stream.
+  @param  Capacity  The size of the buffer in bytes.
+**/
+STATIC
+VOID
+ZstdBitWriterInit (
+  OUT ZSTD_BIT_WRITER  *Writer,
+  IN  UINT8            *Buffer,
+  IN  UINTN            Capacity
+  )
+{
+  Writer->Buffer    = Buffer;
+  Writer->Capacity  = Capacity;
+  Writer->Position  = 0;
+  Writer->Container = 0;
+  Writer->Bits      = 0;
+  Writer->Overflow  = FALSE;
+}
+
+/**
+  Writes bits to a bit stream.
+
+  @param  Writer  The bit writer.
+  @param  Value   The bits, of which only the low Bits bits are written.
+  @param  Bits    The number of bits, at most 32.
+**/
+STATIC
+VOID
+ZstdBitWriterAdd (
+  IN OUT ZSTD_BIT_WRITER  *Writer,
+  IN     UINT64           Value,
+  IN     UINTN            Bits
+  )
+{
+  Writer->Container |= (Value & (((UINT64)1 << Bits) - 1)) << Writer->Bits;
+  Writer->Bits      += Bits;
+  while (Writer->Bits >= 8) {
+    if (Writer->Position < Writer->Capacity) {
+      Writer->Buffer[Writer->Position++] = (UINT8)Writer->Container;
+    } else {
+      Writer->Overflow = TRUE;
+    }
+
+    Writer->Container >>= 8;
+    Writer->Bits       -= 8;
+  }
+}
+
+/**
+  Ends a bit stream with its end mark.
+
+  @param  Writer  The bit writer.
+
+  @return The size of the stream in bytes, or 0 if it does not fit its buffer.
+**/
+STATIC
+UINTN
+ZstdBitWriterClose (
+  IN OUT ZSTD_BIT_WRITER  *Writer
+  )
+{
+  ZstdBitWriterAdd (Writer, 1, 1);
+  if (Writer->Bits != 0) {
+    ZstdBitWriterAdd (Writer, 0, 8 - Writer->Bits);
+  }
+
+  return Writer->Overflow ? 0 : Writer->Position;
+}
+
+/**
+  Chooses the accuracy log of the FSE distribution of symbols.
+
+  @param  Total      The number of symbols.
+  @param  SymbolMax  The largest symbol.
+  @param  LogMax     The largest accuracy log.
+
+  @return The accuracy log.
+**/
+STATIC
+UINTN
+ZstdFseOptimalLog (
+  IN UINTN  Total,
+  IN UINTN  SymbolMax,
+  IN UINTN  LogMax
+  )
+{
+  UINTN  Log;
+  UINTN  MinBits;
+
+  Log = LogMax;
+  if ((Total > 1) && ((UINTN)ZstdHighBitSet32 ((UINT32)(Total - 1)) < Log + 2)) {
+    Log = (UINTN)ZstdHighBitSet32 ((UINT32)(Total - 1)) - 2;
+  }
+
+  MinBits = (UINTN)ZstdHighBitSet32 ((UINT32)Total) + 1;
+  if ((UINTN)ZstdHighBitSet32 ((UINT32)SymbolMax + 1) + 2 < MinBits) {
+    MinBits = (UINTN)ZstdHighBitSet32 ((UINT32)SymbolMax + 1) + 2;
+  }
+
+  if ((INTN)Log < (INTN)MinBits) {
+    Log = MinBits;
+  }
+
+  if (Log < ZSTD_FSE_LOG_MIN) {
+    Log = ZSTD_FSE_LOG_MIN;
+  }
+
+  return (Log > LogMax) ? LogMax : Log;
+}
+
+/**
+  Scales the counts of symbols to a FSE distribution, in which every present
+  symbol has a probability of at least one state.
+
+  @param  Counts     The counts of the symbols.
+  @param  SymbolMax  The largest symbol.
+  @param  Total      The sum of the counts.
+  @param  Log        The accuracy log of the distribution.
+  @param  Norm       The distribution.
+**/
+STATIC
+VOID
+ZstdFseNormalize (
+  IN  CONST UINT32  *Counts,
+  IN  UINTN         SymbolMax,
+  IN  UINTN         Total,
+  IN  UINTN         Log,
+  OUT INT16         *Norm
+  )
+{
+  UINTN  Size;
+  UINTN  Sum;
+  UINTN  Symbol;
+  UINTN  Largest;
+  UINT64 Scaled;
+
+  Size    = (UINTN)1 << Log;
+  Sum     = 0;
+  Largest = 0;
+  for (Symbol = 0; Symbol <= SymbolMax; Symbol++) {
+    Norm[Symbol] = 0;
+    if (Counts[Symbol] != 0) {
+      Scaled       = ((UINT64)Counts[Symbol] * Size + Total / 2) / Total;
+      Norm[Symbol] = (INT16)((Scaled == 0) ? 1 : Scaled);
+      Sum         += Norm[Symbol];
+      if (Counts[Symbol] > Counts[Largest]) {
+        Largest = Symbol;
+      }
+    }
+  }
+
+  //
+  // The rounding errors are taken from the most probable symbols.
+  //
+  while (Sum > Size) {
+    Largest = 0;
+    for (Symbol = 1; Symbol <= SymbolMax; Symbol++) {
+      if (Norm[Symbol] > Norm[Largest]) {
+        Largest = Symbol;
+      }
+    }
+
+    Norm[Largest]--;
+    Sum--;
+  }
+
+  Norm[Largest] = (INT16)(Norm[Largest] + (Size - Sum));
+}
+
+/**
+  Writes the description of a FSE distribution.
+
+  @param  Buffer     The description.
+  @param  Capacity   The size of the buffer in bytes.
+  @param  Norm       The distribution.
+  @param  SymbolMax  The largest symbol.
+  @param  Log        The accuracy log of the distribution.
+
+  @return The size of the description in bytes, or 0 if it does not fit the
+          buffer.
+**/
+STATIC
+UINTN
+ZstdFseWriteDistribution (
+  OUT UINT8        *Buffer,
+  IN  UINTN        Capacity,
+  IN  CONST INT16  *Norm,
+  IN  UINTN        SymbolMax,
+  IN  UINTN        Log
+  )
+{
+  ZSTD_BIT_WRITER  Writer;
+  INTN             Remaining;
+  INTN             Threshold;
+  INTN             Max;
+  INTN             Count;
+  UINTN            Bits;
+  UINTN            Symbol;
+  UINTN            Start;
+  BOOLEAN          PreviousZero;
+
+  ZstdBitWriterInit (&Writer, Buffer, Capacity);
+  ZstdBitWriterAdd (&Writer, Log - ZSTD_FSE_LOG_MIN, 4);
+  Remaining    = ((INTN)1 << Log) + 1;
+  Threshold    = (INTN)1 << Log;
+  Bits         = Log + 1;
+  Symbol       = 0;
+  PreviousZero = FALSE;
+  while ((Symbol <= SymbolMax) && (Remaining > 1)) {
+    if (PreviousZero) {
+      //
+      // The zero counts that follow a zero count are 2-bit repeat counts.
+      //
+      Start = Symbol;
+      while ((Symbol <= SymbolMax) && (Norm[Symbol] == 0)) {
+        Symbol++;
+      }
+
+      while (Symbol >= Start + 3) {
+        Start += 3;
+        ZstdBitWriterAdd (&Writer, 3, 2);
+      }
+
+      ZstdBitWriterAdd (&Writer, Symbol - Start, 2);
+    }
+
+    Count      = Norm[Symbol++];
+    Max        = (2 * Threshold - 1) - Remaining;
+    Remaining -= (Count < 0) ? -Count : Count;
+    Count++;
+    if (Count >= Threshold) {
+      Count += Max;
+    }
+
+    ZstdBitWriterAdd (&Writer, (UINT64)Count, (Count < Max) ? Bits - 1 : Bits);
+    PreviousZero = (BOOLEAN)(Count == 1);
+    while (Remaining < Threshold) {
+      Bits--;
+      Threshold >>= 1;
+    }
+  }
+
+  if (Writer.Bits != 0) {
+    ZstdBitWriterAdd (&Writer, 0, 8 - Writer.Bits);
+  }
+
+  return Writer.Overflow ? 0 : Writer.Position;
+}
+
+/**
+  Builds the encoding table of a FSE distribution.
+
+  @param  Table      The encoding table.
+  @param  Norm       The distribution, -1 for a less than one probability.
+  @param  SymbolMax  The largest symbol.
+  @param  Log        The accuracy log of the distribution.
+**/
+STATIC
+VOID
+ZstdFseBuildTable (
+  OUT ZSTD_FSE_TABLE  *Table,
+  IN  CONST INT16     *Norm,
+  IN  UINTN           SymbolMax,
+  IN  UINTN           Log
+  )
+{
+  UINT8   Spread[1 << ZSTD_FSE_LOG_MAX];
+  UINT32  Cumulative[ZSTD_FSE_SYMBOLS_MAX + 1];
+  UINTN   Size;
+  UINTN   High;
+  UINTN   Step;
+  UINTN   Position;
+  UINTN   Symbol;
+  UINTN   Index;
+  UINT32  Total;
+  UINTN   MaxBitsOut;
+
+  Size = (UINTN)1 << Log;
+  High = Size - 1;
+
+  //
+  // The states are spread as the decoder does.
+  //
+  Cumulative[0] = 0;
+  for (Symbol = 0; Symbol <= SymbolMax; Symbol++) {
+    if (Norm[Symbol] == -1) {
+      Cumulative[Symbol + 1] = Cumulative[Symbol] + 1;
+      Spread[High--]         = (UINT8)Symbol;
+    } else {
+      Cumulative[Symbol + 1] = Cumulative[Symbol] + Norm[Symbol];
+    }
+  }
+
+  Step     = (Size >> 1) + (Size >> 3) + 3;
+  Position = 0;
+  for (Symbol = 0; Symbol <= SymbolMax; Symbol++) {
+    for (Index = 0; (INTN)Index < Norm[Symbol]; Index++) {
+      Spread[Position] = (UINT8)Symbol;
+      do {
+        Position = (Position + Step) & (Size - 1);
+      } while (Position > High);
+    }
+  }
+
+  for (Index = 0; Index < Size; Index++) {
+    Table->StateTable[Cumulative[Spread[Index]]++] = (UINT16)(Size + Index);
+  }
+
+  Total = 0;
+  for (Symbol = 0; Symbol <= SymbolMax; Symbol++) {
+    switch (Norm[Symbol]) {
+      case 0:
+        Table->Symbol[Symbol].DeltaNbBits    = (UINT32)(((Log + 1) << 16) - Size);
+        Table->Symbol[Symbol].DeltaFindState = 0;
+        break;
+
+      case -1:
+      case 1:
+        Table->Symbol[Symbol].DeltaNbBits    = (UINT32)((Log << 16) - Size);
+        Table->Symbol[Symbol].DeltaFindState = (INT32)Total - 1;
+        Total++;
+        break;
+
+      default:
+        MaxBitsOut                           = Log - (UINTN)ZstdHighBitSet32 ((UINT32)Norm[Symbol] - 1);
+        Table->Symbol[Symbol].DeltaNbBits    = (UINT32)((MaxBitsOut << 16) - ((UINTN)Norm[Symbol] << MaxBitsOut));
+        Table->Symbol[Symbol].DeltaFindState = (INT32)Total - Norm[Symbol];
+        Total                               += Norm[Symbol];
+        break;
+    }
+  }
+
+  Table->Log = Log;
+}
+
+/**
+  Returns the first state of a FSE stream, the state that will encode the
+  last symbol of the stream.
+
+  @param  Table   The encoding table.
+  @param  Symbol  The last symbol of the stream.
+
+  @return The state.
+**/
+STATIC
+UINT32
+ZstdFseInitState (
+  IN CONST ZSTD_FSE_TABLE  *Table,
+  IN UINTN                 Symbol
+  )
+{
+  UINT32  BitsOut;
+  UINT32  Value;
+
+  BitsOut = (Table->Symbol[Symbol].DeltaNbBits + (1 << 15)) >> 16;
+  Value   = (BitsOut << 16) - Table->Symbol[Symbol].DeltaNbBits;
+  return Table->StateTable[(INT32)(Value >> BitsOut) + Table->Symbol[Symbol].DeltaFindState];
+}
+
+/**
+  Encodes a symbol with a FSE state.
+
+  @param  Writer  The bit writer.
+  @param  Table   The encoding table.
+  @param  State   The state.
+  @param  Symbol  The symbol.
+**/
+STATIC
+VOID
+ZstdFseEncode (
+  IN OUT ZSTD_BIT_WRITER       *Writer,
+  IN     CONST ZSTD_FSE_TABLE  *Table,
+  IN OUT UINT32                *State,
+  IN     UINTN                 Symbol
+  )
+{
+  UINT32  BitsOut;
+
+  BitsOut = (*State + Table->Symbol[Symbol].DeltaNbBits) >> 16;
+  ZstdBitWriterAdd (Writer, *State, BitsOut);
+  *State = Table->StateTable[(INT32)(*State >> BitsOut) + Table->Symbol[Symbol].DeltaFindState];
+}
+
+/**
+  Returns the cost of the symbols of a histogram with a FSE distribution.
+
+  @param  Counts     The histogram.
+  @param  SymbolMax  The largest symbol of the histogram.
+  @param  Norm       The distribution, -1 for a less than one probability.
+  @param  NormMax    The largest symbol of the distribution.
+  @param  Log        The accuracy log of the distribution.
+
+  @return The cost in 1/256 bits, or MAX_UINTN if a symbol has no probability.
+**/
+STATIC
+UINTN
+ZstdFseCost (
+  IN CONST UINT32  *Counts,
+  IN UINTN         SymbolMax,
+  IN CONST INT16   *Norm,
+  IN UINTN         NormMax,
+  IN UINTN         Log
+  )
+{
+  UINTN  Cost;
+  UINTN  Symbol;
+
+  Cost = 0;
+  for (Symbol = 0; Symbol <= SymbolMax; Symbol++) {
+    if (Counts[Symbol] == 0) {
+      continue;
+    }
+
+    if ((Symbol > NormMax) || (Norm[Symbol] == 0)) {
+      return MAX_UINTN;
+    }
+
+    Cost += Counts[Symbol] * (Log * 256 - ZstdLog2Fraction ((Norm[Symbol] < 0) ? 1 : (UINT32)Norm[Symbol]));
+  }
+
+  return Cost;
+}
+
+/**
+  Computes the Huffman code lengths of the literals, limited to
+  ZSTD_HUFFMAN_LOG_MAX bits, as a complete prefix code.
+
+  @param  Frequency  The histogram of the literals, of at least two symbols.
+  @param  Length     The code lengths, 0 for the absent symbols.
+**/
+STATIC
+VOID
+ZstdHuffmanBuildLengths (
+  IN  CONST UINT32  *Frequency,
+  OUT UINT8         *Length
+  )
+{
+  UINT32  NodeWeight[2 * ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINT16  NodeParent[2 * ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINT16  Leaf[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINTN   LeafCount;
+  UINTN   NodeCount;
+  UINTN   NextLeaf;
+  UINTN   NextNode;
+  UINTN   Index;
+  UINTN   Child[2];
+  UINTN   Symbol;
+  UINTN   Best;
+  UINTN   Depth;
+  UINTN   Node;
+  UINT16  Swap;
+  UINT32  Kraft;
+
+  //
+  // The leaves in increasing weights, then the two queues construction.
+  //
+  LeafCount = 0;
+  for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+    Length[Symbol] = 0;
+    if (Frequency[Symbol] != 0) {
+      Leaf[LeafCount++] = (UINT16)Symbol;
+    }
+  }
+
+  for (Index = 1; Index < LeafCount; Index++) {
+    Swap = Leaf[Index];
+    for (Node = Index; Node > 0 && Frequency[Leaf[Node - 1]] > Frequency[Swap]; Node--) {
+      Leaf[Node] = Leaf[Node - 1];
+    }
+
+    Leaf[Node] = Swap;
+  }
+
+  for (Index = 0; Index < LeafCount; Index++) {
+    NodeWeight[Index] = Frequency[Leaf[Index]];
+  }
+
+  NodeCount = LeafCount;
+  NextLeaf  = 0;
+  NextNode  = LeafCount;
+  while (NodeCount < 2 * LeafCount - 1) {
+    for (Index = 0; Index < 2; Index++) {
+      if ((NextLeaf < LeafCount) &&
+          ((NextNode >= NodeCount) || (NodeWeight[NextLeaf] <= NodeWeight[NextNode])))
+      {
+        Child[Index] = NextLeaf++;
+      } else {
+        Child[Index] = NextNode++;
+      }
+    }
+
+    NodeWeight[NodeCount]  = NodeWeight[Child[0]] + NodeWeight[Child[1]];
+    NodeParent[Child[0]]   = (UINT16)NodeCount;
+    NodeParent[Child[1]]   = (UINT16)NodeCount;
+    NodeCount++;
+  }
+
+  for (Index = 0; Index < LeafCount; Index++) {
+    Depth = 0;
+    for (Node = Index; Node != NodeCount - 1; Node = NodeParent[Node]) {
+      Depth++;
+    }
+
+    Length[Leaf[Index]] = (UINT8)((Depth > ZSTD_HUFFMAN_LOG_MAX) ? ZSTD_HUFFMAN_LOG_MAX : Depth);
+  }
+
+  //
+  // The lengths cut to the limit overfill the code space: lengthen the least
+  // frequent of the longest codes below the limit until it fits, then shorten
+  // the most frequent codes that fill the space left.
+  //
+  Kraft = 0;
+  for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+    if (Length[Symbol] != 0) {
+      Kraft += 1U << (ZSTD_HUFFMAN_LOG_MAX - Length[Symbol]);
+    }
+  }
+
+  while (Kraft > (1U << ZSTD_HUFFMAN_LOG_MAX)) {
+    Best = ZSTD_HUFFMAN_SYMBOLS_MAX;
+    for (Index = 0; Index < LeafCount; Index++) {
+      Symbol = Leaf[Index];
+      if ((Length[Symbol] < ZSTD_HUFFMAN_LOG_MAX) &&
+          ((Best == ZSTD_HUFFMAN_SYMBOLS_MAX) || (Length[Symbol] > Length[Best])))
+      {
+        Best = Symbol;
+      }
+    }
+
+    Kraft -= 1U << (ZSTD_HUFFMAN_LOG_MAX - Length[Best] - 1);
+    Length[Best]++;
+  }
+
+  while (Kraft < (1U << ZSTD_HUFFMAN_LOG_MAX)) {
+    Best = ZSTD_HUFFMAN_SYMBOLS_MAX;
+    for (Index = LeafCount; Index-- > 0;) {
+      Symbol = Leaf[Index];
+      if ((Length[Symbol] > 1) &&
+          ((1U << (ZSTD_HUFFMAN_LOG_MAX - Length[Symbol])) <= (1U << ZSTD_HUFFMAN_LOG_MAX) - Kraft) &&
+          ((Best == ZSTD_HUFFMAN_SYMBOLS_MAX) || (Length[Symbol] > Length[Best])))
+      {
+        Best = Symbol;
+      }
+    }
+
+    Kraft += 1U << (ZSTD_HUFFMAN_LOG_MAX - Length[Best]);
+    Length[Best]--;
+  }
+}
+
+/**
+  Writes the Huffman tree description of the literals, with direct or FSE
+  compressed weights.
+
+  @param  Buffer     The description.
+  @param  Capacity   The size of the buffer in bytes.
+  @param  Length     The code lengths of the literals.
+  @param  MaxBits    The longest code length.
+
+  @return The size of the description in bytes, or 0 if it cannot be written.
+**/
+STATIC
+UINTN
+ZstdHuffmanWriteTree (
+  OUT UINT8        *Buffer,
+  IN  UINTN        Capacity,
+  IN  CONST UINT8  *Length,
+  IN  UINTN        MaxBits
+  )
+{
+  UINT8            Weights[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINT32           Counts[ZSTD_HUFFMAN_LOG_MAX + 1];
+  INT16            Norm[ZSTD_HUFFMAN_LOG_MAX + 1];
+  UINT8            Compressed[128];
+  ZSTD_FSE_TABLE   Table;
+  ZSTD_BIT_WRITER  Writer;
+  UINTN            Count;
+  UINTN            Symbol;
+  UINTN            WeightMax;
+  UINTN            Distinct;
+  UINTN            Log;
+  UINTN            TableSize;
+  UINTN            StreamSize;
+  UINTN            DirectSize;
+  UINT32           State[2];
+
+  //
+  // The weight of the last symbol is implied.
+  //
+  Count = 0;
+  for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+    Weights[Symbol] = (UINT8)((Length[Symbol] == 0) ? 0 : MaxBits + 1 - Length[Symbol]);
+    if (Weights[Symbol] != 0) {
+      Count = Symbol;
+    }
+  }
+
+  ZeroMem (Counts, sizeof (Counts));
+  WeightMax = 0;
+  Distinct  = 0;
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    if (Counts[Weights[Symbol]]++ == 0) {
+      Distinct++;
+    }
+
+    if (Weights[Symbol] > WeightMax) {
+      WeightMax = Weights[Symbol];
+    }
+  }
+
+  DirectSize = (Count <= 128) ? 1 + (Count + 1) / 2 : MAX_UINTN;
+
+  //
+  // The FSE compressed weights are decoded by two interleaved states, the
+  // first one decoding the even weights.
+  //
+  StreamSize = 0;
+  if ((Count > 2) && (Distinct > 1)) {
+    Log = ZstdFseOptimalLog (Count, WeightMax, ZSTD_WEIGHT_LOG_MAX);
+    ZstdFseNormalize (Counts, WeightMax, Count, Log, Norm);
+    TableSize = ZstdFseWriteDistribution (Compressed, sizeof (Compressed), Norm, WeightMax, Log);
+    if (TableSize != 0) {
+      ZstdFseBuildTable (&Table, Norm, WeightMax, Log);
+      ZstdBitWriterInit (&Writer, Compressed + TableSize, sizeof (Compressed) - TableSize);
+      State[(Count - 1) & 1] = ZstdFseInitState (&Table, Weights[Count - 1]);
+      State[(Count - 2) & 1] = ZstdFseInitState (&Table, Weights[Count - 2]);
+      for (Symbol = Count - 2; Symbol-- > 0;) {
+        ZstdFseEncode (&Writer, &Table, &State[Symbol & 1], Weights[Symbol]);
+      }
+
+      ZstdBitWriterAdd (&Writer, State[1], Log);
+      ZstdBitWriterAdd (&Writer, State[0], Log);
+      StreamSize = ZstdBitWriterClose (&Writer);
+      if (StreamSize != 0) {
+        StreamSize += TableSize;
+      }
+    }
+  }
+
+  if ((StreamSize != 0) && (StreamSize < 128) && (StreamSize + 1 < DirectSize)) {
+    if (StreamSize + 1 > Capacity) {
+      return 0;
+    }
+
+    Buffer[0] = (UINT8)StreamSize;
+    memcpy (Buffer + 1, Compressed, StreamSize);
+    return StreamSize + 1;
+  }
+
+  if ((DirectSize == MAX_UINTN) || (DirectSize > Capacity)) {
+    return 0;
+  }
+
+  Buffer[0] = (UINT8)(127 + Count);
+  for (Symbol = 0; Symbol < Count; Symbol += 2) {
+    Buffer[1 + Symbol / 2] = (UINT8)((Weights[Symbol] << 4) | ((Symbol + 1 < Count) ? Weights[Symbol + 1] : 0));
+  }
+
+  return DirectSize;
+}
+
+/**
+  Writes a Huffman coded stream of literals, from the last one, which the
+  decoder reads first.
+
+  @param  Buffer    The stream.
+  @param  Capacity  The size of the buffer in bytes.
+  @param  Literals  The literals.
+  @param  Count     The number of literals.
+  @param  Code      The codes of the literals.
+  @param  Length    The code lengths of the literals.
+
+  @return The size of the stream in bytes, or 0 if it does not fit the buffer.
+**/
+STATIC
+UINTN
+ZstdHuffmanWriteStream (
+  OUT UINT8         *Buffer,
+  IN  UINTN         Capacity,
+  IN  CONST UINT8   *Literals,
+  IN  UINTN         Count,
+  IN  CONST UINT16  *Code,
+  IN  CONST UINT8   *Length
+  )
+{
+  ZSTD_BIT_WRITER  Writer;
+
+  ZstdBitWriterInit (&Writer, Buffer, Capacity);
+  while (Count-- > 0) {
+    ZstdBitWriterAdd (&Writer, Code[Literals[Count]], Length[Literals[Count]]);
+  }
+
+  return ZstdBitWriterClose (&Writer);
+}
+
+/**
+  Writes the literals section of a compressed block: Huffman coded when it is
+  smaller, raw or RLE otherwise.
+
+  @param  Buffer    The literals section.
+  @param  Capacity  The size of the buffer in bytes.
+  @param  Literals  The literals.
+  @param  Count     The number of literals.
+
+  @return The size of the section in bytes, or 0 if it does not fit the buffer.
+**/
+STATIC
+UINTN
+ZstdWriteLiterals (
+  OUT UINT8        *Buffer,
+  IN  UINTN        Capacity,
+  IN  CONST UINT8  *Literals,
+  IN  UINTN        Count
+  )
+{
+  UINT32  Frequency[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINT8   Length[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINT16  Code[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  UINTN   Start[ZSTD_HUFFMAN_LOG_MAX + 2];
+  UINTN   Distinct;
+  UINTN   Index;
+  UINTN   Symbol;
+  UINTN   MaxBits;
+  UINTN   Weight;
+  UINTN   HeaderSize;
+  UINTN   RawHeaderSize;
+  UINTN   Streams;
+  UINTN   Segment;
+  UINTN   Size;
+  UINTN   StreamSize;
+  UINTN   JumpTable;
+  UINT64  Header;
+
+  RawHeaderSize = (Count < 32) ? 1 : ((Count < 4096) ? 2 : 3);
+
+  ZeroMem (Frequency, sizeof (Frequency));
+  Distinct = 0;
+  for (Index = 0; Index < Count; Index++) {
+    if (Frequency[Literals[Index]]++ == 0) {
+      Distinct++;
+    }
+  }
+
+  if (Distinct == 1) {
+    if (RawHeaderSize + 1 > Capacity) {
+      return 0;
+    }
+
+    Header = ZSTD_LITERALS_TYPE_RLE | (Count << ((RawHeaderSize == 1) ? 3 : 4)) | ((RawHeaderSize == 1) ? 0 : (RawHeaderSize == 2) ? 1 << 2 : 3 << 2);
+    ZstdWriteLittleEndian (Buffer, Header, RawHeaderSize);
+    Buffer[RawHeaderSize] = Literals[0];
+    return RawHeaderSize + 1;
+  }
+
+  if (Distinct > 1) {
+    //
+    // The canonical codes follow the order of the decoding table: the
+    // longest codes first, then in symbol order.
+    //
+    ZstdHuffmanBuildLengths (Frequency, Length);
+    MaxBits = 0;
+    for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+      if (Length[Symbol] > MaxBits) {
+        MaxBits = Length[Symbol];
+      }
+    }
+
+    ZeroMem (Start, sizeof (Start));
+    for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+      if (Length[Symbol] != 0) {
+        Weight             = MaxBits + 1 - Length[Symbol];
+        Start[Weight + 1] += (UINTN)1 << (Weight - 1);
+      }
+    }
+
+    for (Weight = 2; Weight <= MaxBits + 1; Weight++) {
+      Start[Weight] += Start[Weight - 1];
+    }
+
+    for (Symbol = 0; Symbol < ZSTD_HUFFMAN_SYMBOLS_MAX; Symbol++) {
+      if (Length[Symbol] != 0) {
+        Weight         = MaxBits + 1 - Length[Symbol];
+        Code[Symbol]   = (UINT16)(Start[Weight] >> (Weight - 1));
+        Start[Weight] += (UINTN)1 << (Weight - 1);
+      }
+    }
+
+    //
+    // One stream for the few literals, four otherwise, after a jump table.
+    //
+    Streams    = (Count < 256) ? 1 : 4;
+    HeaderSize = (Streams == 1) ? 3 : ((Count < 1024) ? 3 : ((Count < 16384) ? 4 : 5));
+    Size       = HeaderSize;
+    StreamSize = 0;
+    if (Size < Capacity) {
+      StreamSize = ZstdHuffmanWriteTree (Buffer + Size, Capacity - Size, Length, MaxBits);
+    }
+
+    if (StreamSize != 0) {
+      Size     += StreamSize;
+      JumpTable = Size;
+      if (Streams == 4) {
+        Size += 6;
+        if (Size > Capacity) {
+          StreamSize = 0;
+        }
+      }
+
+      Segment = (Count + Streams - 1) / Streams;
+      for (Index = 0; Index < Streams && StreamSize != 0; Index++) {
+        StreamSize = ZstdHuffmanWriteStream (
+                       Buffer + Size,
+                       Capacity - Size,
+                       Literals + Index * Segment,
+                       (Index < Streams - 1) ? Segment : Count - Index * Segment,
+                       Code,
+                       Length
+                       );
+        if ((Streams == 4) && (Index < 3)) {
+          if (StreamSize > MAX_UINT16) {
+            StreamSize = 0;
+          }
+
+          ZstdWriteLittleEndian (Buffer + JumpTable + Index * 2, StreamSize, 2);
+        }
+
+        Size += StreamSize;
+      }
+
+      if ((StreamSize != 0) && (Size < RawHeaderSize + Count) &&
+          (((HeaderSize == 3) && (Size - HeaderSize < 1024)) ||
+           ((HeaderSize == 4) && (Size - HeaderSize < 16384)) ||
+           (HeaderSize == 5)))
+      {
+        Header = ZSTD_LITERALS_TYPE_COMPRESSED |
+                 ((UINT64)((Streams == 1) ? 0 : HeaderSize - 2) << 2) |
+                 ((UINT64)Count << 4) |
+                 ((UINT64)(Size - HeaderSize) << (4 + ((HeaderSize == 3) ? 10 : ((HeaderSize == 4) ? 14 : 18))));
+        ZstdWriteLittleEndian (Buffer, Header, HeaderSize);
+        return Size;
+      }
+    }
+  }
+
+  if (RawHeaderSize + Count > Capacity) {
+    return 0;
+  }
+
+  Header = ZSTD_LITERALS_TYPE_RAW | (Count << ((RawHeaderSize == 1) ? 3 : 4)) | ((RawHeaderSize == 1) ? 0 : (RawHeaderSize == 2) ? 1 << 2 : 3 << 2);
+  ZstdWriteLittleEndian (Buffer, Header, RawHeaderSize);
+  memcpy (Buffer + RawHeaderSize, Literals, Count);
+  return RawHeaderSize + Count;
+}
+
+/**
+  Returns the literal length code of a literal length.
+
+  @param  LiteralLength  The literal length.
+
+  @return The code.
+**/
+STATIC
+UINTN
+ZstdLiteralLengthCode (
+  IN UINT32  LiteralLength
+  )
+{
+  UINTN  Code;
+
+  for (Code = ZSTD_LITERAL_LENGTH_CODE_MAX; mLiteralLengthBase[Code] > LiteralLength; Code--) {
+  }
+
+  return Code;
+}
+
+/**
+  Returns the match length code of a match length.
+
+  @param  MatchLength  The match length, at least 3.
+
+  @return The code.
+**/
+STATIC
+UINTN
+ZstdMatchLengthCode (
+  IN UINT32  MatchLength
+  )
+{
+  UINTN  Code;
+
+  for (Code = ZSTD_MATCH_LENGTH_CODE_MAX; mMatchLengthBase[Code] > MatchLength; Code--) {
+  }
+
+  return Code;
+}
+
+/**
+  Chooses the table of one of the literal length, offset and match length
+  codes of the sequences of a block, RLE, predefined or FSE compressed, and
+  writes its description.
+
+  @param  Buffer      The table description.
+  @param  Capacity    The size of the buffer in bytes.
+  @param  Codes       The codes of the sequences.
+  @param  Count       The number of sequences.
+  @param  CodeMax     The largest code.
+  @param  LogMax      The largest accuracy log.
+  @param  Default     The predefined distribution of the code.
+  @param  DefaultMax  The largest code of the predefined distribution.
+  @param  DefaultLog  The accuracy log of the predefined distribution.
+  @param  Table       The encoding table of the codes.
+  @param  Mode        The table mode.
+
+  @return The size of the table description in bytes, or MAX_UINTN if it does
+          not fit the buffer.
+**/
+STATIC
+UINTN
+ZstdWriteSequenceTable (
+  OUT UINT8           *Buffer,
+  IN  UINTN           Capacity,
+  IN  CONST UINT8     *Codes,
+  IN  UINTN           Count,
+  IN  UINTN           CodeMax,
+  IN  UINTN           LogMax,
+  IN  CONST INT16     *Default,
+  IN  UINTN           DefaultMax,
+  IN  UINTN           DefaultLog,
+  OUT ZSTD_FSE_TABLE  *Table,
+  OUT UINTN           *Mode
+  )
+{
+  UINT32  Counts[ZSTD_FSE_SYMBOLS_MAX];
+  INT16   Norm[ZSTD_FSE_SYMBOLS_MAX];
+  UINT8   Description[ZSTD_FSE_SYMBOLS_MAX * 2];
+  UINTN   Index;
+  UINTN   SymbolMax;
+  UINTN   Distinct;
+  UINTN   Log;
+  UINTN   Size;
+  UINTN   DefaultCost;
+  UINTN   Cost;
+
+  ZeroMem (Counts, sizeof (Counts));
+  SymbolMax = 0;
+  Distinct  = 0;
+  for (Index = 0; Index < Count; Index++) {
+    if (Counts[Codes[Index]]++ == 0) {
+      Distinct++;
+    }
+
+    if (Codes[Index] > SymbolMax) {
+      SymbolMax = Codes[Index];
+    }
+  }
+
+  //
+  // A single code takes no bits.
+  //
+  if (Distinct == 1) {
+    if (Capacity < 1) {
+      return MAX_UINTN;
+    }
+
+    ZeroMem (Norm, sizeof (Norm));
+    Norm[SymbolMax] = 1;
+    ZstdFseBuildTable (Table, Norm, SymbolMax, 0);
+    Buffer[0] = (UINT8)SymbolMax;
+    *Mode     = ZSTD_TABLE_MODE_RLE;
+    return 1;
+  }
+
+  DefaultCost = MAX_UINTN;
+  if (SymbolMax <= DefaultMax) {
+    DefaultCost = ZstdFseCost (Counts, SymbolMax, Default, DefaultMax, DefaultLog);
+  }
+
+  Log = ZstdFseOptimalLog (Count, SymbolMax, LogMax);
+  ZstdFseNormalize (Counts, SymbolMax, Count, Log, Norm);
+  Size = ZstdFseWriteDistribution (Description, sizeof (Description), Norm, SymbolMax, Log);
+  Cost = ZstdFseCost (Counts, SymbolMax, Norm, SymbolMax, Log) + Size * 8 * 256;
+  if ((Size == 0) || (DefaultCost <= Cost)) {
+    ZstdFseBuildTable (Table, Default, DefaultMax, DefaultLog);
+    *Mode = ZSTD_TABLE_MODE_PREDEFINED;
+    return 0;
+  }
+
+  if (Size > Capacity) {
+    return MAX_UINTN;
+  }
+
+  memcpy (Buffer, Description, Size);
+  ZstdFseBuildTable (Table, Norm, SymbolMax, Log);
+  *Mode = ZSTD_TABLE_MODE_COMPRESSED;
+  return Size;
+}
+
+/**
+  Writes the sequences section of a compressed block.
+
+  @param  Encoder   The encoder context, with the sequences of the block.
+  @param  Codes     A buffer for the codes of the sequences, of three times
+                    their number.
+  @param  Buffer    The sequences section.
+  @param  Capacity  The size of the buffer in bytes.
+
+  @return The size of the section in bytes, or 0 if it does not fit the buffer.
+**/
+STATIC
+UINTN
+ZstdWriteSequences (
+  IN  ZSTD_ENCODER  *Encoder,
+  IN  UINT8         *Codes,
+  OUT UINT8         *Buffer,
+  IN  UINTN         Capacity
+  )
+{
+  ZSTD_FSE_TABLE       LiteralLengthTable;
+  ZSTD_FSE_TABLE       OffsetTable;
+  ZSTD_FSE_TABLE       MatchLengthTable;
+  ZSTD_BIT_WRITER      Writer;
+  CONST ZSTD_SEQUENCE  *Sequence;
+  UINT8                *LiteralLengthCode;
+  UINT8                *OffsetCode;
+  UINT8                *MatchLengthCode;
+  UINTN                Count;
+  UINTN                Index;
+  UINTN                Size;
+  UINTN                Used;
+  UINTN                ModesOffset;
+  UINTN                Mode[3];
+  UINT32               LiteralLengthState;
+  UINT32               OffsetState;
+  UINT32               MatchLengthState;
+
+  Count = Encoder->SequenceCount;
+  if (Capacity < 4) {
+    return 0;
+  }
+
+  if (Count < 128) {
+    Buffer[0] = (UINT8)Count;
+    Size      = 1;
+  } else if (Count < 0x7F00) {
+    Buffer[0] = (UINT8)((Count >> 8) + 128);
+    Buffer[1] = (UINT8)Count;
+    Size      = 2;
+  } else {
+    Buffer[0] = 255;
+    ZstdWriteLittleEndian (Buffer + 1, Count - 0x7F00, 2);
+    Size = 3;
+  }
+
+  if (Count == 0) {
+    return Size;
+  }
+
+  LiteralLengthCode = Codes;
+  OffsetCode        = Codes + Count;
+  MatchLengthCode   = Codes + 2 * Count;
+  for (Index = 0; Index < Count; Index++) {
+    Sequence                 = &Encoder->Sequences[Index];
+    LiteralLengthCode[Index] = (UINT8)ZstdLiteralLengthCode (Sequence->LiteralLength);
+    OffsetCode[Index]        = (UINT8)ZstdHighBitSet32 (Sequence->OffsetValue);
+    MatchLengthCode[Index]   = (UINT8)ZstdMatchLengthCode (Sequence->MatchLength);
+  }
+
+  //
+  // The symbol compression modes, then the tables of the literal length,
+  // offset and match length codes.
+  //
+  ModesOffset = Size++;
+  Used        = ZstdWriteSequenceTable (
+           Buffer + Size,
+           Capacity - Size,
+           LiteralLengthCode,
+           Count,
+           ZSTD_LITERAL_LENGTH_CODE_MAX,
+           ZSTD_FSE_LOG_MAX,
+           mLiteralLengthDefault,
+           ZSTD_LITERAL_LENGTH_CODE_MAX,
+           ZSTD_LITERAL_LENGTH_DEFAULT_LOG,
+           &LiteralLengthTable,
+           &Mode[0]
+           );
+  if (Used == MAX_UINTN) {
+    return 0;
+  }
+
+  Size += Used;
+  Used  = ZstdWriteSequenceTable (
+            Buffer + Size,
+            Capacity - Size,
+            OffsetCode,
+            Count,
+            ZSTD_OFFSET_CODE_MAX,
+            ZSTD_FSE_LOG_MAX - 1,
+            mOffsetDefault,
+            ZSTD_OFFSET_DEFAULT_CODE_MAX,
+            ZSTD_OFFSET_DEFAULT_LOG,
+            &OffsetTable,
+            &Mode[1]
+            );
+  if (Used == MAX_UINTN) {
+    return 0;
+  }
+
+  Size += Used;
+  Used  = ZstdWriteSequenceTable (
+            Buffer + Size,
+            Capacity - Size,
+            MatchLengthCode,
+            Count,
+            ZSTD_MATCH_LENGTH_CODE_MAX,
+            ZSTD_FSE_LOG_MAX,
+            mMatchLengthDefault,
+            ZSTD_MATCH_LENGTH_CODE_MAX,
+            ZSTD_MATCH_LENGTH_DEFAULT_LOG,
+            &MatchLengthTable,
+            &Mode[2]
+            );
+  if (Used == MAX_UINTN) {
+    return 0;
+  }
+
+  Size               += Used;
+  Buffer[ModesOffset] = (UINT8)((Mode[0] << 6) | (Mode[1] << 4) | (Mode[2] << 2));
+
+  //
+  // The sequences are encoded from the last one, which the decoder reads last:
+  // the states, then the extra bits of the literal length, match length and
+  // offset.
+  //
+  ZstdBitWriterInit (&Writer, Buffer + Size, Capacity - Size);
+  Index              = Count - 1;
+  Sequence           = &Encoder->Sequences[Index];
+  MatchLengthState   = ZstdFseInitState (&MatchLengthTable, MatchLengthCode[Index]);
+  OffsetState        = ZstdFseInitState (&OffsetTable, OffsetCode[Index]);
+  LiteralLengthState = ZstdFseInitState (&LiteralLengthTable, LiteralLengthCode[Index]);
+  for ( ; ;) {
+    ZstdBitWriterAdd (
+      &Writer,
+      Sequence->LiteralLength - mLiteralLengthBase[LiteralLengthCode[Index]],
+      mLiteralLengthBits[LiteralLengthCode[Index]]
+      );
+    ZstdBitWriterAdd (
+      &Writer,
+      Sequence->MatchLength - mMatchLengthBase[MatchLengthCode[Index]],
+      mMatchLengthBits[MatchLengthCode[Index]]
+      );
+    ZstdBitWriterAdd (&Writer, Sequence->OffsetValue, OffsetCode[Index]);
+    if (Index-- == 0) {
+      break;
+    }
+
+    Sequence = &Encoder->Sequences[Index];
+    ZstdFseEncode (&Writer, &OffsetTable, &OffsetState, OffsetCode[Index]);
+    ZstdFseEncode (&Writer, &MatchLengthTable, &MatchLengthState, MatchLengthCode[Index]);
+    ZstdFseEncode (&Writer, &LiteralLengthTable, &LiteralLengthState, LiteralLengthCode[Index]);
+  }
+
+  ZstdBitWriterAdd (&Writer, MatchLengthState, MatchLengthTable.Log);
+  ZstdBitWriterAdd (&Writer, OffsetState, OffsetTable.Log);
+  ZstdBitWriterAdd (&Writer, LiteralLengthState, LiteralLengthTable.Log);
+  Used = ZstdBitWriterClose (&Writer);
+  return (Used == 0) ? 0 : Size + Used;
+}
+
+/**
+  Returns the hash of the 4 bytes at a position.
+
+  @param  Buffer  The bytes.
+
+  @return The hash, of ZSTD_HASH_LOG bits.
+**/
+STATIC
+UINT32
+ZstdHash (
+  IN CONST UINT8  *Buffer
+  )
+{
+  UINT32  Value;
+
+  Value = Buffer[0] | (Buffer[1] << 8) | (Buffer[2] << 16) | ((UINT32)Buffer[3] << 24);
+  return (Value * 2654435761U) >> (32 - ZSTD_HASH_LOG);
+}
+
+/**
+  Adds the positions before a position to the hash chains.
+
+  @param  Encoder   The encoder context.
+  @param  Position  The position.
+**/
+STATIC
+VOID
+ZstdInsert (
+  IN OUT ZSTD_ENCODER  *Encoder,
+  IN     UINTN         Position
+  )
+{
+  UINT32  Hash;
+
+  for ( ; Encoder->NextInsert < Position; Encoder->NextInsert++) {
+    if (Encoder->NextInsert + ZSTD_MATCH_MIN <= Encoder->SourceSize) {
+      Hash                                    = ZstdHash (Encoder->Source + Encoder->NextInsert);
+      Encoder->Chain[Encoder->NextInsert]     = Encoder->Head[Hash];
+      Encoder->Head[Hash]                     = (UINT32)Encoder->NextInsert + 1;
+    }
+  }
+}
+
+/**
+  Returns the length of the common prefix of two buffers.
+
+  @param  First   The first buffer.
+  @param  Second  The second buffer.
+  @param  Limit   The largest length.
+
+  @return The length.
+**/
+STATIC
+UINTN
+ZstdCommonLength (
+  IN CONST UINT8  *First,
+  IN CONST UINT8  *Second,
+  IN UINTN        Limit
+  )
+{
+  UINTN  Length;
+
+  for (Length = 0; Length < Limit && First[Length] == Second[Length]; Length++) {
+  }
+
+  return Length;
+}
+
+/**
+  Finds the best match at a position, among the repeat offsets and the
+  positions of the hash chain. The gain of a match is its length, less the
+  cost of its offset.
+
+  @param  Encoder   The encoder context.
+  @param  Position  The position.
+  @param  End       The end of the block.
+  @param  Offset    The offset of the match.
+  @param  Gain      The gain of the match.
+
+  @return The length of the match, or 0 if there is none.
+**/
+STATIC
+UINTN
+ZstdFindMatch (
+  IN OUT ZSTD_ENCODER  *Encoder,
+  IN     UINTN         Position,
+  IN     UINTN         End,
+  OUT    UINT32        *Offset,
+  OUT    INTN          *Gain
+  )
+{
+  CONST UINT8  *Current;
+  UINTN        Limit;
+  UINTN        Length;
+  UINTN        BestLength;
+  INTN         BestGain;
+  INTN         MatchGain;
+  UINTN        Index;
+  UINTN        Distance;
+  UINT32       Candidate;
+  UINTN        Depth;
+
+  Current    = Encoder->Source + Position;
+  Limit      = End - Position;
+  BestLength = 0;
+  BestGain   = 0;
+  for (Index = 0; Index < 3; Index++) {
+    Distance = Encoder->Repeat[Index];
+    if (Distance <= Position) {
+      Length    = ZstdCommonLength (Current, Current - Distance, Limit);
+      MatchGain = (INTN)Length * 4 - 1;
+      if ((Length >= ZSTD_MATCH_MIN) && (MatchGain > BestGain)) {
+        BestLength = Length;
+        BestGain   = MatchGain;
+        *Offset    = (UINT32)Distance;
+      }
+    }
+  }
+
+  ZstdInsert (Encoder, Position);
+  Candidate = Encoder->Head[ZstdHash (Current)];
+  for (Depth = 0; Depth < ZSTD_SEARCH_DEPTH && Candidate != 0 && BestLength < Limit && BestLength < ZSTD_MATCH_GOOD; Depth++) {
+    Distance = Position - (Candidate - 1);
+    if (Current[BestLength] == Current[BestLength - Distance]) {
+      Length    = ZstdCommonLength (Current, Current - Distance, Limit);
+      MatchGain = (INTN)Length * 4 - ZstdHighBitSet32 ((UINT32)Distance + 3);
+      if ((Length >= ZSTD_MATCH_MIN) && (MatchGain > BestGain)) {
+        BestLength = Length;
+        BestGain   = MatchGain;
+        *Offset    = (UINT32)Distance;
+      }
+    }
+
+    Candidate = Encoder->Chain[Candidate - 1];
+  }
+
+  *Gain = BestGain;
+  return BestLength;
+}
+
+/**
+  Returns the offset value of a match, and updates the repeat offsets as the
+  decoder does.
+
+  @param  Repeat         The repeat offsets.
+  @param  Offset         The offset of the match.
+  @param  LiteralLength  The number of literals before the match.
+
+  @return The offset value.
+**/
+STATIC
+UINT32
+ZstdOffsetValue (
+  IN OUT UINT32  *Repeat,
+  IN     UINT32  Offset,
+  IN     UINT32  LiteralLength
+  )
+{
+  UINT32  OffsetValue;
+  UINT32  Index;
+
+  OffsetValue = Offset + 3;
+  if (LiteralLength != 0) {
+    if (Offset == Repeat[0]) {
+      OffsetValue = 1;
+    } else if (Offset == Repeat[1]) {
+      OffsetValue = 2;
+    } else if (Offset == Repeat[2]) {
+      OffsetValue = 3;
+    }
+  } else {
+    if (Offset == Repeat[1]) {
+      OffsetValue = 1;
+    } else if (Offset == Repeat[2]) {
+      OffsetValue = 2;
+    } else if (Offset == Repeat[0] - 1) {
+      OffsetValue = 3;
+    }
+  }
+
+  if (OffsetValue > 3) {
+    Repeat[2] = Repeat[1];
+    Repeat[1] = Repeat[0];
+    Repeat[0] = Offset;
+  } else {
+    Index = OffsetValue - 1 + ((LiteralLength == 0) ? 1 : 0);
+    if (Index != 0) {
+      if (Index != 1) {
+        Repeat[2] = Repeat[1];
+      }
+
+      Repeat[1] = Repeat[0];
+      Repeat[0] = Offset;
+    }
+  }
+
+  return OffsetValue;
+}
+
+/**
+  Splits a block in sequences, with a lazy evaluation of the matches: a match
+  is deferred while the next positions have a better one.
+
+  @param  Encoder  The encoder context.
+  @param  Start    The start of the block.
+  @param  End      The end of the block.
+**/
+STATIC
+VOID
+ZstdParseBlock (
+  IN OUT ZSTD_ENCODER  *Encoder,
+  IN     UINTN         Start,
+  IN     UINTN         End
+  )
+{
+  ZSTD_SEQUENCE  *Sequence;
+  UINTN          Position;
+  UINTN          Anchor;
+  UINTN          Length;
+  UINTN          NextLength;
+  UINTN          Step;
+  UINT32         Offset;
+  UINT32         NextOffset;
+  INTN           Gain;
+  INTN           NextGain;
+
+  Encoder->SequenceCount = 0;
+  Encoder->LiteralCount  = 0;
+  Position               = Start;
+  Anchor                 = Start;
+  while (Position + ZSTD_MATCH_MIN <= End) {
+    Length = ZstdFindMatch (Encoder, Position, End, &Offset, &Gain);
+    if (Length == 0) {
+      Position++;
+      continue;
+    }
+
+    //
+    // Look for a better match one or two positions later.
+    //
+    for (Step = 1; Step <= 2 && Length < ZSTD_MATCH_GOOD && Position + Step + ZSTD_MATCH_MIN <= End;) {
+      NextLength = ZstdFindMatch (Encoder, Position + Step, End, &NextOffset, &NextGain);
+      if ((NextLength != 0) && (NextGain > Gain + ((Step == 1) ? 4 : 7))) {
+        Position += Step;
+        Length    = NextLength;
+        Offset    = NextOffset;
+        Gain      = NextGain;
+        Step      = 1;
+      } else {
+        Step++;
+      }
+    }
+
+    memcpy (Encoder->Literals + Encoder->LiteralCount, Encoder->Source + Anchor, Position - Anchor);
+    Encoder->LiteralCount  += Position - Anchor;
+    Sequence                = &Encoder->Sequences[Encoder->SequenceCount++];
+    Sequence->LiteralLength = (UINT32)(Position - Anchor);
+    Sequence->MatchLength   = (UINT32)Length;
+    Sequence->OffsetValue   = ZstdOffsetValue (Encoder->Repeat, Offset, Sequence->LiteralLength);
+    Position               += Length;
+    Anchor                  = Position;
+  }
+
+  memcpy (Encoder->Literals + Encoder->LiteralCount, Encoder->Source + Anchor, End - Anchor);
+  Encoder->LiteralCount += End - Anchor;
+}
+
+/**
+  Compresses a Zstandard frame.
+
+  @param  Source           The data to compress.
+  @param  SourceSize       The size of the data in bytes.
+  @param  Destination      The frame, allocated with malloc().
+  @param  DestinationSize  The size of the frame in bytes.
+
+  @retval EFI_SUCCESS           The frame is returned.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory.
+**/
+STATIC
+EFI_STATUS
+ZstdCompressBuffer (
+  IN  CONST UINT8  *Source,
+  IN  UINTN        SourceSize,
+  OUT UINT8        **Destination,
+  OUT UINTN        *DestinationSize
+  )
+{
+  ZSTD_ENCODER  Encoder;
+  UINT8         *Output;
+  UINT8         *Codes;
+  UINTN         Size;
+  UINTN         Position;
+  UINTN         BlockSize;
+  UINTN         Compressed;
+  UINTN         Index;
+  UINT32        Repeat[3];
+  UINT32        BlockHeader;
+  BOOLEAN       Last;
+
+  Output            = malloc (ZSTD_FRAME_HEADER_MAX + SourceSize + (SourceSize / ZSTD_BLOCK_SIZE_MAX + 1) * ZSTD_BLOCK_HEADER_SIZE);
+  Encoder.Head      = calloc ((UINTN)1 << ZSTD_HASH_LOG, sizeof (UINT32));
+  Encoder.Chain     = malloc ((SourceSize + 1) * sizeof (UINT32));
+  Encoder.Sequences = malloc ((ZSTD_BLOCK_SIZE_MAX / ZSTD_MATCH_MIN + 1) * sizeof (ZSTD_SEQUENCE));
+  Encoder.Literals  = malloc (ZSTD_BLOCK_SIZE_MAX);
+  Codes             = malloc ((ZSTD_BLOCK_SIZE_MAX / ZSTD_MATCH_MIN + 1) * 3);
+  if ((Output == NULL) || (Encoder.Head == NULL) || (Encoder.Chain == NULL) ||
+      (Encoder.Sequences == NULL) || (Encoder.Literals == NULL) || (Codes == NULL))
+  {
+    free (Output);
+    free (Encoder.Head);
+    free (Encoder.Chain);
+    free (Encoder.Sequences);
+    free (Encoder.Literals);
+    free (Codes);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Encoder.Source     = Source;
+  Encoder.SourceSize = SourceSize;
+  Encoder.NextInsert = 0;
+  Encoder.Repeat[0]  = 1;
+  Encoder.Repeat[1]  = 4;
+  Encoder.Repeat[2]  = 8;
+
+  //
+  // A single segment frame, whose window is its content, without checksum.
+  //
+  ZstdWriteLittleEndian (Output, ZSTD_MAGIC_NUMBER, 4);
+  if (SourceSize < 256) {
+    Output[4] = BIT5;
+    Output[5] = (UINT8)SourceSize;
+    Size      = 6;
+  } else if (SourceSize < 65536 + 256) {
+    Output[4] = (1 << 6) | BIT5;
+    ZstdWriteLittleEndian (Output + 5, SourceSize - 256, 2);
+    Size = 7;
+  } else if (SourceSize <= MAX_UINT32) {
+    Output[4] = (2 << 6) | BIT5;
+    ZstdWriteLittleEndian (Output + 5, SourceSize, 4);
+    Size = 9;
+  } else {
+    Output[4] = (3 << 6) | BIT5;
+    ZstdWriteLittleEndian (Output + 5, SourceSize, 8);
+    Size = 13;
+  }
+
+  Position = 0;
+  do {
+    BlockSize = SourceSize - Position;
+    if (BlockSize > ZSTD_BLOCK_SIZE_MAX) {
+      BlockSize = ZSTD_BLOCK_SIZE_MAX;
+    }
+
+    Last = (BOOLEAN)(Position + BlockSize == SourceSize);
+    for (Index = 1; Index < BlockSize && Source[Position + Index] == Source[Position]; Index++) {
+    }
+
+    if ((BlockSize > 1) && (Index == BlockSize)) {
+      BlockHeader                          = Last | (ZSTD_BLOCK_TYPE_RLE << 1) | (UINT32)(BlockSize << 3);
+      Output[Size + ZSTD_BLOCK_HEADER_SIZE] = Source[Position];
+      Compressed                           = 1;
+    } else {
+      //
+      // The block is stored raw when it does not compress, as if its
+      // sequences were never seen.
+      //
+      memcpy (Repeat, Encoder.Repeat, sizeof (Repeat));
+      Compressed = 0;
+      if (BlockSize > 1) {
+        ZstdParseBlock (&Encoder, Position, Position + BlockSize);
+        Compressed = ZstdWriteLiterals (Output + Size + ZSTD_BLOCK_HEADER_SIZE, BlockSize - 1, Encoder.Literals, Encoder.LiteralCount);
+        if (Compressed != 0) {
+          Index      = ZstdWriteSequences (&Encoder, Codes, Output + Size + ZSTD_BLOCK_HEADER_SIZE + Compressed, BlockSize - 1 - Compressed);
+          Compressed = (Index == 0) ? 0 : Compressed + Index;
+        }
+      }
+
+      if (Compressed != 0) {
+        BlockHeader = Last | (ZSTD_BLOCK_TYPE_COMPRESSED << 1) | (UINT32)(Compressed << 3);
+      } else {
+        memcpy (Encoder.Repeat, Repeat, sizeof (Repeat));
+        memcpy (Output + Size + ZSTD_BLOCK_HEADER_SIZE, Source + Position, BlockSize);
+        BlockHeader = Last | (ZSTD_BLOCK_TYPE_RAW << 1) | (UINT32)(BlockSize << 3);
+        Compressed  = BlockSize;
+      }
+    }
+
+    ZstdWriteLittleEndian (Output + Size, BlockHeader, ZSTD_BLOCK_HEADER_SIZE);
+    Size     += ZSTD_BLOCK_HEADER_SIZE + Compressed;
+    Position += BlockSize;
+  } while (!Last);
+
+  free (Encoder.Head);
+  free (Encoder.Chain);
+  free (Encoder.Sequences);
+  free (Encoder.Literals);
+  free (Codes);
+  *Destination     = Output;
+  *DestinationSize = Size;
+  return EFI_SUCCESS;
+}
+
+/**
+  Displays the standard utility information to STDOUT.
+**/
+STATIC
+VOID
+Version (
+  VOID
+  )
+{
+  fprintf (stdout, "%s Version %d.%d %s \n", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
+}
+
+/**
+  Displays the utility usage syntax to STDOUT.
+**/
+STATIC
+VOID
+Usage (
+  VOID
+  )
+{
+  //
+  // Summary usage
+  //
+  fprintf (stdout, "Usage: ZstdCompress -e|-d [options] <input_file>\n\n");
+
+  //
+  // Copyright declaration
+  //
+  fprintf (stdout, "Copyright (c) 2026, Intel Corporation. All rights reserved.\n\n");
+
+  //
+  // Details Option
+  //
+  fprintf (stdout, "optional arguments:\n");
+  fprintf (stdout, "  -h, --help            Show this help message and exit\n");
+  fprintf (stdout, "  --version             Show program's version number and exit\n");
+  fprintf (stdout, "  --debug [DEBUG]       Output DEBUG statements, where DEBUG_LEVEL is 0 (min)\n\
+                        - 9 (max)\n");
+  fprintf (stdout, "  -v, --verbose         Print informational statements\n");
+  fprintf (stdout, "  -q, --quiet           Returns the exit code, error messages will be\n\
+                        displayed\n");
+  fprintf (stdout, "  -e, --encode          Compress the input file in a Zstandard frame\n");
+  fprintf (stdout, "  -d, --decode          Decompress the Zstandard frame of the input file\n");
+  fprintf (stdout, "  -o OUTPUT_FILENAME, --output OUTPUT_FILENAME\n\
+                        Output file name\n");
+}
+
+/**
+  Main function.
+
+  @param  argc  Number of command line parameters.
+  @param  argv  Array of pointers to parameter strings.
+
+  @retval STATUS_SUCCESS  Utility exits successfully.
+  @retval STATUS_ERROR    Some error occurred during execution.
+**/
+int
+main (
+  int    argc,
+  CHAR8  *argv[]
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *OutputFileName;
+  CHAR8       *InputFileName;
+  UINT8       *FileBuffer;
+  UINT8       *OutputBuffer;
+  UINT8       *Scratch;
+  UINT32      FileSize;
+  UINTN       OutputSize;
+  UINT32      DestinationSize;
+  UINT32      ScratchSize;
+  UINT64      LogLevel;
+  UINT8       FileAction;
+  FILE        *InFile;
+  FILE        *OutFile;
+
+  LogLevel       = 0;
+  InputFileName  = NULL;
+  OutputFileName = NULL;
+  FileAction     = ZSTD_NULL;
+  FileBuffer     = NULL;
+  OutputBuffer   = NULL;
+  Scratch        = NULL;
+  OutFile        = NULL;
+
+  SetUtilityName (UTILITY_NAME);
+
+  if (argc == 1) {
+    Error (NULL, 0, 1001, "Missing options", "no options input");
+    Usage ();
+    return STATUS_ERROR;
+  }
+
+  //
+  // Parse command line
+  //
+  argc--;
+  argv++;
+
+  if ((stricmp (argv[0], "-h") == 0) || (stricmp (argv[0], "--help") == 0)) {
+    Usage ();
+    return STATUS_SUCCESS;
+  }
+
+  if (stricmp (argv[0], "--version") == 0) {
+    Version ();
+    return STATUS_SUCCESS;
+  }
+
+  while (argc > 0) {
+    if ((stricmp (argv[0], "-o") == 0) || (stricmp (argv[0], "--output") == 0)) {
+      if ((argv[1] == NULL) || (argv[1][0] == '-')) {
+        Error (NULL, 0, 1003, "Invalid option value", "Output File name is missing for -o option");
+        goto Finish;
+      }
+
+      OutputFileName = argv[1];
+      argc          -= 2;
+      argv          += 2;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-e") == 0) || (stricmp (argv[0], "--encode") == 0)) {
+      FileAction = ZSTD_ENCODE;
+      argc--;
+      argv++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-d") == 0) || (stricmp (argv[0], "--decode") == 0)) {
+      FileAction = ZSTD_DECODE;
+      argc--;
+      argv++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-v") == 0) || (stricmp (argv[0], "--verbose") == 0)) {
+      SetPrintLevel (VERBOSE_LOG_LEVEL);
+      VerboseMsg ("Verbose output Mode Set!");
+      argc--;
+      argv++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-q") == 0) || (stricmp (argv[0], "--quiet") == 0)) {
+      SetPrintLevel (KEY_LOG_LEVEL);
+      KeyMsg ("Quiet output Mode Set!");
+      argc--;
+      argv++;
+      continue;
+    }
+
+    if (stricmp (argv[0], "--debug") == 0) {
+      Status = AsciiStringToUint64 (argv[1], FALSE, &LogLevel);
+      if (EFI_ERROR (Status)) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto Finish;
+      }
+
+      if (LogLevel > 9) {
+        Error (NULL, 0, 1003, "Invalid option value", "Debug Level range is 0-9, current input level is %d", (int)LogLevel);
+        goto Finish;
+      }
+
+      SetPrintLevel (LogLevel);
+      DebugMsg (NULL, 0, 9, "Debug Mode Set", "Debug Output Mode Level %s is set!", argv[1]);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if (argv[0][0] == '-') {
+      Error (NULL, 0, 1000, "Unknown option", argv[0]);
+      goto Finish;
+    }
+
+    //
+    // Get Input file file name.
+    //
+    InputFileName = argv[0];
+    argc--;
+    argv++;
+  }
+
+  VerboseMsg ("%s tool start.", UTILITY_NAME);
+
+  //
+  // Check Input parameters
+  //
+  if (FileAction == ZSTD_NULL) {
+    Error (NULL, 0, 1001, "Missing option", "either the encode or the decode option must be specified!");
+    return STATUS_ERROR;
+  }
+
+  if (InputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Input files are not specified");
+    goto Finish;
+  }
+
+  if (OutputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Output file are not specified");
+    goto Finish;
+  }
+
+  //
+  // Open Input file and read file data.
+  //
+  InFile = fopen (LongFilePath (InputFileName), "rb");
+  if (InFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", InputFileName);
+    return STATUS_ERROR;
+  }
+
+  fseek (InFile, 0, SEEK_END);
+  FileSize = ftell (InFile);
+  fseek (InFile, 0, SEEK_SET);
+
+  FileBuffer = (UINT8 *)malloc (FileSize + 1);
+  if (FileBuffer == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    fclose (InFile);
+    goto Finish;
+  }
+
+  if (fread (FileBuffer, 1, FileSize, InFile) != FileSize) {
+    Error (NULL, 0, 0004, "Error reading file", InputFileName);
+    fclose (InFile);
+    goto Finish;
+  }
+
+  fclose (InFile);
+  VerboseMsg ("the size of the input file is %u bytes", (unsigned)FileSize);
+
+  if (FileAction == ZSTD_ENCODE) {
+    Status = ZstdCompressBuffer (FileBuffer, FileSize, &OutputBuffer, &OutputSize);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+      goto Finish;
+    }
+  } else {
+    Status = ZstdUefiDecompressGetInfo (FileBuffer, FileSize, &DestinationSize, &ScratchSize);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Input file is not a Zstandard frame of a known content size!");
+      goto Finish;
+    }
+
+    OutputBuffer = (UINT8 *)malloc (DestinationSize + 1);
+    Scratch      = (UINT8 *)malloc (ScratchSize);
+    if ((OutputBuffer == NULL) || (Scratch == NULL)) {
+      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+      goto Finish;
+    }
+
+    Status = ZstdUefiDecompress (FileBuffer, FileSize, OutputBuffer, Scratch);
+    if (EFI_ERROR (Status)) {
+      Error (NULL, 0, 3000, "Invalid", "Zstandard frame of the input file is corrupted!");
+      goto Finish;
+    }
+
+    OutputSize = DestinationSize;
+  }
+
+  //
+  // Done, write output file.
+  //
+  OutFile = fopen (LongFilePath (OutputFileName), "wb");
+  if (OutFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", OutputFileName);
+    goto Finish;
+  }
+
+  if (fwrite (OutputBuffer, 1, OutputSize, OutFile) != OutputSize) {
+    Error (NULL, 0, 0002, "Error writing file", OutputFileName);
+    goto Finish;
+  }
+
+  VerboseMsg ("the size of the %s file is %u bytes", (FileAction == ZSTD_ENCODE) ? "encoded" : "decoded", (unsigned)OutputSize);
+
+Finish:
+  if (FileBuffer != NULL) {
+    free (FileBuffer);
+  }
+
+  if (OutputBuffer != NULL) {
+    free (OutputBuffer);
+  }
+
+  if (Scratch != NULL) {
+    free (Scratch);
+  }
+
+  if (OutFile != NULL) {
+    fclose (OutFile);
+  }
+
+  VerboseMsg ("%s tool done with return code is 0x%x.", UTILITY_NAME, GetUtilityStatus ());
+
+  return GetUtilityStatus ();
+}
@@ -0,0 +1,98 @@
+/** @file
+  Definitions that build the Zstandard decoder of ZstdCustomDecompressLib in
+  the ZstdCompress tool.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_H__
+#define __ZSTD_DECOMPRESS_H__
+
+#include <string.h>
+#include <Common/UefiBaseTypes.h>
+
+#ifndef MAX_UINT32
+#define MAX_UINT32  ((UINT32)0xFFFFFFFF)
+#endif
+
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(Array)  (sizeof (Array) / sizeof ((Array)[0]))
+#endif
+
+#define SIZE_128KB  0x00020000
+
+//
+// The BaseLib and BaseMemoryLib functions that the decoder uses.
+//
+#define LShiftU64(Operand, Count)        ((UINT64)(Operand) << (Count))
+#define RShiftU64(Operand, Count)        ((UINT64)(Operand) >> (Count))
+#define LRotU64(Operand, Count)          (((UINT64)(Operand) << (Count)) | ((UINT64)(Operand) >> (64 - (Count))))
+#define MultU64x64(Multiplicand, Multiplier)  ((UINT64)(Multiplicand) * (UINT64)(Multiplier))
+#define HighBitSet32(Operand)            ZstdHighBitSet32 (Operand)
+#define CopyMem(Destination, Source, Length)  memcpy ((Destination), (Source), (Length))
+#define SetMem(Buffer, Length, Value)    memset ((Buffer), (Value), (Length))
+#define ZeroMem(Buffer, Length)          memset ((Buffer), 0, (Length))
+
+/**
+  Returns the bit position of the highest bit set in a 32-bit value.
+
+  @param  Operand  The value, not zero.
+
+  @return The bit position of the highest bit set.
+**/
+INTN
+ZstdHighBitSet32 (
+  IN UINT32  Operand
+  );
+
+/**
+  Retrieves the size of the uncompressed buffer and the size of the scratch
+  buffer required to decompress a Zstandard frame.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize The size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     The size, in bytes, of the scratch buffer.
+
+  @retval RETURN_SUCCESS           The sizes are returned.
+  @retval RETURN_INVALID_PARAMETER The source buffer does not start with a
+                                   Zstandard frame header.
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, the
+                                   size does not fit in a UINT32, or the frame
+                                   needs a dictionary.
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a Zstandard frame.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A temporary scratch buffer that is used to perform the
+                      decompression.
+
+  @retval RETURN_SUCCESS           Decompression completed successfully.
+  @retval RETURN_INVALID_PARAMETER The source buffer is corrupted.
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, or
+                                   needs a dictionary.
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+#endif
@@ -12,6 +12,7 @@ from AutoGen.ModuleAutoGen import ModuleAutoGen
 from AutoGen.ModuleAutoGenHelper import WorkSpaceInfo,AutoGenInfo
 import Common.GlobalData as GlobalData
 import Common.EdkLogger as EdkLogger
+from Common.RemoteCache import GetRemoteCache
 import os
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 from AutoGen.AutoGen import AutoGen
@@ -141,6 +142,9 @@ class AutoGenManager(threading.Thread):
                 item = cacheq.get()
                 if item == "CacheDone":
                     cache_num += 1
+                elif item[0] == "RemoteCache":
+                    # Statistics of the remote cache of a worker
+                    GetRemoteCache().MergeStatistics(item[1])
                 else:
                     GlobalData.gModuleAllCacheStatus.add(item)
                 if cache_num  == len(self.autogen_workers):
@@ -208,6 +212,8 @@ class AutoGenWorkerInProcess(mp.Process):
             GlobalData.gUseHashCache = self.data_pipe.Get("UseHashCache")
             GlobalData.gBinCacheSource = self.data_pipe.Get("BinCacheSource")
             GlobalData.gBinCacheDest = self.data_pipe.Get("BinCacheDest")
+            GlobalData.gBinCacheRemote = self.data_pipe.Get("BinCacheRemote")
+            GlobalData.gBinCacheSize = self.data_pipe.Get("BinCacheSize")
             GlobalData.gPlatformHashFile = self.data_pipe.Get("PlatformHashFile")
             GlobalData.gModulePreMakeCacheStatus = dict()
             GlobalData.gModuleMakeCacheStatus = dict()
@@ -302,6 +308,9 @@ class AutoGenWorkerInProcess(mp.Process):
         finally:
             EdkLogger.debug(EdkLogger.DEBUG_9, "Worker %s: %s" % (os.getpid(), "Done"))
             self.feedback_q.put("Done")
+            RemoteCache = GetRemoteCache()
+            if RemoteCache is not None:
+                self.cache_q.put(("RemoteCache", RemoteCache.Statistics))
             self.cache_q.put("CacheDone")
 
     def printStatus(self):
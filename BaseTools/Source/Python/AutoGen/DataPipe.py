@@ -168,6 +168,10 @@ class MemoryDataPipe(DataPipe):
 
         self.DataContainer = {"BinCacheDest":GlobalData.gBinCacheDest}
 
+        self.DataContainer = {"BinCacheRemote":GlobalData.gBinCacheRemote}
+
+        self.DataContainer = {"BinCacheSize":GlobalData.gBinCacheSize}
+
         self.DataContainer = {"EnableGenfdsMultiThread":GlobalData.gEnableGenfdsMultiThread}
 
         self.DataContainer = {"gPlatformFinalPcds":GlobalData.gPlatformFinalPcds}
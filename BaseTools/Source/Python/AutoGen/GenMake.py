@@ -27,32 +27,6 @@ from Common.DataType import TAB_COMPILER_MSFT
 ## Regular expression for finding header file inclusions
 gIncludePattern = re.compile(r"^[ \t]*[#%]?[ \t]*include(?:[ \t]*(?:\\(?:\r\n|\r|\n))*[ \t]*)*(?:\(?[\"<]?[ \t]*)([-\w.\\/() \t]+)(?:[ \t]*[\">]?\)?)", re.MULTILINE | re.UNICODE | re.IGNORECASE)
 
-## Regular expression for matching macro used in header file inclusion
-gMacroPattern = re.compile("([_A-Z][_A-Z0-9]*)[ \t]*\((.+)\)", re.UNICODE)
-
-gIsFileMap = {}
-
-## pattern for include style in Edk.x code
-gProtocolDefinition = "Protocol/%(HeaderKey)s/%(HeaderKey)s.h"
-gGuidDefinition = "Guid/%(HeaderKey)s/%(HeaderKey)s.h"
-gArchProtocolDefinition = "ArchProtocol/%(HeaderKey)s/%(HeaderKey)s.h"
-gPpiDefinition = "Ppi/%(HeaderKey)s/%(HeaderKey)s.h"
-gIncludeMacroConversion = {
-  "EFI_PROTOCOL_DEFINITION"         :   gProtocolDefinition,
-  "EFI_GUID_DEFINITION"             :   gGuidDefinition,
-  "EFI_ARCH_PROTOCOL_DEFINITION"    :   gArchProtocolDefinition,
-  "EFI_PROTOCOL_PRODUCER"           :   gProtocolDefinition,
-  "EFI_PROTOCOL_CONSUMER"           :   gProtocolDefinition,
-  "EFI_PROTOCOL_DEPENDENCY"         :   gProtocolDefinition,
-  "EFI_ARCH_PROTOCOL_PRODUCER"      :   gArchProtocolDefinition,
-  "EFI_ARCH_PROTOCOL_CONSUMER"      :   gArchProtocolDefinition,
-  "EFI_ARCH_PROTOCOL_DEPENDENCY"    :   gArchProtocolDefinition,
-  "EFI_PPI_DEFINITION"              :   gPpiDefinition,
-  "EFI_PPI_PRODUCER"                :   gPpiDefinition,
-  "EFI_PPI_CONSUMER"                :   gPpiDefinition,
-  "EFI_PPI_DEPENDENCY"              :   gPpiDefinition,
-}
-
 NMAKE_FILETYPE = "nmake"
 GMAKE_FILETYPE = "gmake"
 WIN32_PLATFORM = "win32"
@@ -453,7 +427,6 @@ cleanlib:
         self.FileListMacros = {}
         self.ListFileMacros = {}
         self.ObjTargetDict = OrderedDict()
-        self.FileCache = {}
         self.LibraryBuildCommandList = []
         self.LibraryFileList = []
         self.LibraryMakefileList = []
@@ -1145,20 +1118,6 @@ cleanlib:
             if not LibraryAutoGen.IsBinaryModule:
                 self.LibraryBuildDirectoryList.append(self.PlaceMacro(LibraryAutoGen.BuildDir, self.Macros))
 
-    ## Return a list containing source file's dependencies
-    #
-    #   @param      FileList        The list of source files
-    #   @param      ForceInculeList The list of files which will be included forcely
-    #   @param      SearchPathList  The list of search path
-    #
-    #   @retval     dict            The mapping between source file path and its dependencies
-    #
-    def GetFileDependency(self, FileList, ForceInculeList, SearchPathList):
-        Dependency = {}
-        for F in FileList:
-            Dependency[F] = GetDependencyList(self._AutoGenObject, self.FileCache, F, ForceInculeList, SearchPathList)
-        return Dependency
-
 
 ## CustomMakefile class
 #
@@ -1683,111 +1642,178 @@ class TopLevelMakefile(BuildFile):
                 DirList.append(os.path.join(self._AutoGenObject.BuildDir, LibraryAutoGen.BuildDir))
         return DirList
 
-## Find dependencies for one source file
+## NinjaBuildFile class
+#
+#  This class generates one Ninja build file for all modules and libraries of
+#  a platform build. Every module is one build statement, which runs make with
+#  the makefile of the module. Ninja schedules all of them across the platform,
+#  skips the modules whose inputs are older than their outputs without running
+#  make, and prunes the modules depending on a library that make left unchanged.
+#
+#  The inputs of a module are listed in a depfile, ninja.d in the module build
+#  directory. It has the INF file, the makefile, the source and AutoGen files,
+#  and the header files that the compiler reported in the last build (deps.txt).
 #
-#  By searching recursively "#include" directive in file, find out all the
-#  files needed by given source file. The dependencies will be only searched
-#  in given search path list.
+class NinjaBuildFile(BuildFile):
+    _DEFAULT_FILE_NAME_ = "build.ninja"
+
+    _DEP_FILE_NAME_ = "ninja.d"
+
+    ## template used to generate the Ninja build file
+    _TEMPLATE_ = TemplateString('''\
+${ninja_header}
+ninja_required_version = 1.3
+
+builddir = ${build_directory}
+
+rule make
+  command = ${make_command}
+  description = Building $module
+  depfile = $dir${separator}${dep_file_name}
+  restat = 1
+
+${BEGIN}${module_build}
+${END}
+default${BEGIN} ${default_target}${END}
+''')
+
+    _MODULE_BUILD_TEMPLATE = TemplateString('''\
+build${BEGIN} ${output}${END}: make${BEGIN} ${library}${END}
+  dir = ${module_build_directory}
+  module = ${module_name}
+''')
+
+    _NINJA_HEADER_ = '''#
+# DO NOT EDIT
+# This file is auto-generated by build utility
 #
-#   @param      File            The source file
-#   @param      ForceInculeList The list of files which will be included forcely
-#   @param      SearchPathList  The list of search path
+# Abstract:
 #
-#   @retval     list            The list of files the given source file depends on
+#   Auto-generated Ninja build file for building modules and libraries of platform
 #
-def GetDependencyList(AutoGenObject, FileCache, File, ForceList, SearchPathList):
-    EdkLogger.debug(EdkLogger.DEBUG_1, "Try to get dependency files for %s" % File)
-    FileStack = [File] + ForceList
-    DependencySet = set()
+'''
 
-    if AutoGenObject.Arch not in gDependencyDatabase:
-        gDependencyDatabase[AutoGenObject.Arch] = {}
-    DepDb = gDependencyDatabase[AutoGenObject.Arch]
+    ## The command of rule make for each platform
+    _NINJA_MAKE_TEMPLATE_ = {
+        WIN32_PLATFORM :   'cmd /c "cd /d $dir && %(make)s tbuild"',
+        POSIX_PLATFORM :   'cd "$dir" && %(make)s tbuild'
+    }
 
-    while len(FileStack) > 0:
-        F = FileStack.pop()
+    ## Constructor of NinjaBuildFile
+    #
+    #   @param  Workspace       Object of WorkspaceAutoGen class
+    #   @param  ModuleList      The list of ModuleAutoGen objects of the driver modules to build
+    #   @param  BuildCommand    The make command of the platform
+    #
+    def __init__(self, Workspace, ModuleList, BuildCommand):
+        BuildFile.__init__(self, Workspace)
+        self.BuildCommand = BuildCommand
+        self.MakefileName = BuildFile._FILE_NAME_[self._FileType]
+        self.ModuleList = []
+        self._ModuleSet = set()
+        for Ma in ModuleList:
+            self._AddModule(Ma)
+
+    ## Add a module and, before it, all libraries that it links
+    def _AddModule(self, Ma):
+        Key = (Ma.MetaFile.Path, Ma.Arch)
+        if Ma.IsBinaryModule or Key in self._ModuleSet:
+            return
+        self._ModuleSet.add(Key)
+        for La in Ma.LibraryAutoGenList:
+            self._AddModule(La)
+        self.ModuleList.append(Ma)
 
-        FullPathDependList = []
-        if F in FileCache:
-            for CacheFile in FileCache[F]:
-                FullPathDependList.append(CacheFile)
-                if CacheFile not in DependencySet:
-                    FileStack.append(CacheFile)
-            DependencySet.update(FullPathDependList)
-            continue
+    def getMakefileName(self):
+        return self._DEFAULT_FILE_NAME_
 
-        CurrentFileDependencyList = []
-        if F in DepDb:
-            CurrentFileDependencyList = DepDb[F]
-        else:
-            try:
-                Fd = open(F.Path, 'rb')
-                FileContent = Fd.read()
-                Fd.close()
-            except BaseException as X:
-                EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=F.Path + "\n\t" + str(X))
-            if len(FileContent) == 0:
-                continue
-            try:
-                if FileContent[0] == 0xff or FileContent[0] == 0xfe:
-                    FileContent = FileContent.decode('utf-16')
-                else:
-                    FileContent = FileContent.decode()
-            except:
-                # The file is not txt file. for example .mcb file
-                continue
-            IncludedFileList = gIncludePattern.findall(FileContent)
-
-            for Inc in IncludedFileList:
-                Inc = Inc.strip()
-                # if there's macro used to reference header file, expand it
-                HeaderList = gMacroPattern.findall(Inc)
-                if len(HeaderList) == 1 and len(HeaderList[0]) == 2:
-                    HeaderType = HeaderList[0][0]
-                    HeaderKey = HeaderList[0][1]
-                    if HeaderType in gIncludeMacroConversion:
-                        Inc = gIncludeMacroConversion[HeaderType] % {"HeaderKey" : HeaderKey}
-                    else:
-                        # not known macro used in #include, always build the file by
-                        # returning a empty dependency
-                        FileCache[File] = []
-                        return []
-                Inc = os.path.normpath(Inc)
-                CurrentFileDependencyList.append(Inc)
-            DepDb[F] = CurrentFileDependencyList
-
-        CurrentFilePath = F.Dir
-        PathList = [CurrentFilePath] + SearchPathList
-        for Inc in CurrentFileDependencyList:
-            for SearchPath in PathList:
-                FilePath = os.path.join(SearchPath, Inc)
-                if FilePath in gIsFileMap:
-                    if not gIsFileMap[FilePath]:
-                        continue
-                # If isfile is called too many times, the performance is slow down.
-                elif not os.path.isfile(FilePath):
-                    gIsFileMap[FilePath] = False
-                    continue
-                else:
-                    gIsFileMap[FilePath] = True
-                FilePath = PathClass(FilePath)
-                FullPathDependList.append(FilePath)
-                if FilePath not in DependencySet:
-                    FileStack.append(FilePath)
-                break
-            else:
-                EdkLogger.debug(EdkLogger.DEBUG_9, "%s included by %s was not found "\
-                                "in any given path:\n\t%s" % (Inc, F, "\n\t".join(SearchPathList)))
+    ## The path of the Ninja build file
+    @property
+    def FilePath(self):
+        return os.path.join(self._AutoGenObject.BuildDir, self.getMakefileName())
 
-        FileCache[F] = FullPathDependList
-        DependencySet.update(FullPathDependList)
+    ## Escape a path used in a build statement
+    @staticmethod
+    def _Escape(Path):
+        return Path.replace('$', '$$').replace(' ', '$ ').replace(':', '$:')
 
-    DependencySet.update(ForceList)
-    if File in DependencySet:
-        DependencySet.remove(File)
-    DependencyList = list(DependencySet)  # remove duplicate ones
+    ## Return the paths of the files that the build of a module creates
+    #
+    #   @param      Ma      Object of ModuleAutoGen class
+    #
+    #   @retval     list    The paths of the outputs of the module
+    #
+    @staticmethod
+    def GetModuleOutputs(Ma):
+        return [str(T.Target) for T in Ma.CodaTargetList]
 
-    return DependencyList
+    ## Save the depfile of a module
+    #
+    #   The depfile is saved again after the module is built, because the
+    #   compiler may have found new header files.
+    #
+    #   @param      Ma              Object of ModuleAutoGen class
+    #   @param      MakefileName    The file name of the makefile of the module
+    #
+    @staticmethod
+    def SaveDependency(Ma, MakefileName):
+        Outputs = NinjaBuildFile.GetModuleOutputs(Ma)
+        if not Outputs:
+            return
+        DepSet = set([Ma.MetaFile.Path, os.path.join(Ma.MakeFileDir, MakefileName)])
+        DepSet.update(F.Path for F in Ma.SourceFileList)
+        DepSet.update(F.Path for F in Ma.BinaryFileList)
+        DepSet.update(str(F) for F in Ma.AutoGenFileList)
+        DepsTxt = os.path.join(Ma.MakeFileDir, "deps.txt")
+        if os.path.exists(DepsTxt):
+            with open(DepsTxt, "r") as fd:
+                DepSet.update(Line.strip() for Line in fd if Line.strip())
+        DepList = [Dep.replace(' ', '\\ ') for Dep in sorted(DepSet)]
+        Content = "%s: \\\n  %s\n" % (Outputs[0].replace(' ', '\\ '), " \\\n  ".join(DepList))
+        SaveFileOnChange(os.path.join(Ma.MakeFileDir, NinjaBuildFile._DEP_FILE_NAME_), Content, False)
+
+    # Compose a dict object containing information used to do replacement in template
+    @property
+    def _TemplateDict(self):
+        ModuleBuildList = []
+        DefaultTargetList = []
+        for Ma in self.ModuleList:
+            Outputs = self.GetModuleOutputs(Ma)
+            if not Outputs:
+                continue
+            self.SaveDependency(Ma, self.MakefileName)
+            Libraries = []
+            for La in Ma.LibraryAutoGenList:
+                if not La.IsBinaryModule:
+                    Libraries.extend(self.GetModuleOutputs(La))
+            ModuleBuildList.append(self._MODULE_BUILD_TEMPLATE.Replace({
+                "output"                : [self._Escape(O) for O in Outputs],
+                "library"               : ["|"] + [self._Escape(L) for L in Libraries] if Libraries else [],
+                "module_build_directory": Ma.MakeFileDir.replace('$', '$$'),
+                "module_name"           : "%s [%s]" % (Ma.MetaFile.File, Ma.Arch),
+                }))
+            if not Ma.IsLibrary:
+                DefaultTargetList.append(self._Escape(Outputs[0]))
+
+        MakeCommand = " ".join('"%s"' % Item if ' ' in Item else Item for Item in self.BuildCommand).replace('$', '$$')
+        return {
+            "ninja_header"      : self._NINJA_HEADER_,
+            "build_directory"   : self._AutoGenObject.BuildDir.replace('$', '$$'),
+            "make_command"      : self._NINJA_MAKE_TEMPLATE_[self._Platform] % {"make": MakeCommand},
+            "separator"         : self._SEP_[self._Platform],
+            "dep_file_name"     : self._DEP_FILE_NAME_,
+            "module_build"      : ModuleBuildList,
+            "default_target"    : DefaultTargetList,
+        }
+
+    ## Create the Ninja build file and the depfiles of the modules
+    #
+    #  @retval TRUE     The build file is created or re-created successfully.
+    #  @retval FALSE    The build file exists and is the same as the one to be generated.
+    #
+    def Generate(self):
+        FileContent = self._TEMPLATE_.Replace(self._TemplateDict)
+        return SaveFileOnChange(self.FilePath, FileContent, False)
 
 # This acts like the main() function for the script, unless it is 'import'ed into another script.
 if __name__ == '__main__':
@@ -12,10 +12,14 @@ from Common.BuildToolError import *
 from Common.Misc import SaveFileOnChange, PathClass
 from Common.Misc import TemplateString
 import sys
+import json
 gIsFileMap = {}
 
 DEP_FILE_TAIL = "# Updated \n"
 
+## The file in the build folder of a module that caches the includes found in its .deps files
+DEPS_CACHE_FILE = "deps_cache.json"
+
 class IncludesAutoGen():
     """ This class is to manage the dependent files witch are used in Makefile to support incremental build.
         1. C files:
@@ -88,42 +92,85 @@ ${END}
 
     @cached_property
     def DepsCollection(self):
-        """ Collect all the dependency files list from all .deps files under a module's build folder """
+        """ Collect all the dependency files list from all .deps files under a module's build folder.
+            The includes found in each .deps file are cached with its size and mtime, so only the
+            .deps files written since the last collection are parsed again.
+        """
         includes = set()
-        targetname = [item[0].Name for item in self.TargetFileList.values()]
+        targetname = sorted(set(item[0].Name for item in self.TargetFileList.values()))
+        cache_path = os.path.join(self.makefile_folder, DEPS_CACHE_FILE)
+        cache = self.LoadDepsCache(cache_path, targetname)
+        new_cache = {}
         for abspath in self.deps_files:
             try:
-                with open(abspath,"r") as fd:
-                    lines = fd.readlines()
+                stat = os.stat(abspath)
+            except OSError:
+                continue
+            entry = cache.get(abspath)
+            if entry and entry[0] == stat.st_mtime_ns and entry[1] == stat.st_size:
+                file_includes = entry[2]
+            else:
+                file_includes = self.ParseDepsFile(abspath, targetname)
+                if file_includes is None:
+                    continue
+            new_cache[abspath] = [stat.st_mtime_ns, stat.st_size, file_includes]
+            includes.update(file_includes)
+        if new_cache != cache:
+            try:
+                with open(cache_path, "w") as fw:
+                    json.dump({"Targets": targetname, "Files": new_cache}, fw)
+            except (OSError, IOError):
+                pass
+        rt = sorted(list(includes))
+        return rt
 
-                firstlineitems = lines[0].split(": ")
-                dependency_file = firstlineitems[1].strip(" \\\n")
-                dependency_file = dependency_file.strip('''"''')
-                if dependency_file:
-                    if os.path.normpath(dependency_file +".deps") == abspath:
-                        continue
-                    filename = os.path.basename(dependency_file).strip()
-                    if filename not in targetname:
-                        includes.add(dependency_file.strip())
+    @staticmethod
+    def LoadDepsCache(cache_path, targetname):
+        """ Load the parsed .deps files of a module, if they were parsed for the same targets """
+        try:
+            with open(cache_path, "r") as fd:
+                cache = json.load(fd)
+        except (OSError, IOError, ValueError):
+            return {}
+        if not isinstance(cache, dict) or cache.get("Targets") != targetname:
+            return {}
+        return cache.get("Files", {})
 
-                for item in lines[1:]:
-                    if item == DEP_FILE_TAIL:
-                        continue
-                    dependency_file = item.strip(" \\\n")
-                    dependency_file = dependency_file.strip('''"''')
-                    if dependency_file == '':
-                        continue
-                    if os.path.normpath(dependency_file +".deps") == abspath:
-                        continue
-                    filename = os.path.basename(dependency_file).strip()
-                    if filename in targetname:
-                        continue
+    @staticmethod
+    def ParseDepsFile(abspath, targetname):
+        """ Get the included files listed by a .deps file """
+        includes = set()
+        try:
+            with open(abspath,"r") as fd:
+                lines = fd.readlines()
+
+            firstlineitems = lines[0].split(": ")
+            dependency_file = firstlineitems[1].strip(" \\\n")
+            dependency_file = dependency_file.strip('''"''')
+            if dependency_file:
+                if os.path.normpath(dependency_file +".deps") == abspath:
+                    return []
+                filename = os.path.basename(dependency_file).strip()
+                if filename not in targetname:
                     includes.add(dependency_file.strip())
-            except Exception as e:
-                EdkLogger.error("build",FILE_NOT_FOUND, "%s doesn't exist" % abspath, ExtraData=str(e), RaiseError=False)
-                continue
-        rt = sorted(list(set([item.strip(' " \\\n') for item in includes])))
-        return rt
+
+            for item in lines[1:]:
+                if item == DEP_FILE_TAIL:
+                    continue
+                dependency_file = item.strip(" \\\n")
+                dependency_file = dependency_file.strip('''"''')
+                if dependency_file == '':
+                    continue
+                if os.path.normpath(dependency_file +".deps") == abspath:
+                    continue
+                filename = os.path.basename(dependency_file).strip()
+                if filename in targetname:
+                    continue
+                includes.add(dependency_file.strip())
+        except Exception as e:
+            EdkLogger.error("build",FILE_NOT_FOUND, "%s doesn't exist" % abspath, ExtraData=str(e), RaiseError=False)
+            return None
+        return sorted(set([item.strip(' " \\\n') for item in includes]))
 
     @cached_property
     def SourceFileList(self):
@@ -167,10 +214,20 @@ ${END}
                 targets[block.Target.Path] = (block.Target,block.Inputs[0])
         return targets
 
+    @cached_property
+    def SourceTargetMap(self):
+        """ Get a map of the input file path of module's targets to the target path """
+        return {item[1].Path:item[0].Path for item in self.TargetFileList.values()}
+
+    @cached_property
+    def SourceNameMap(self):
+        """ Get a map of the input file name of module's targets to the target path """
+        return {item[1].File:item[0].Path for item in self.TargetFileList.values()}
+
     def GetRealTarget(self,source_file_abs):
         """ Get the final target file based on source file abspath """
-        source_target_map = {item[1].Path:item[0].Path for item in self.TargetFileList.values()}
-        source_name_map = {item[1].File:item[0].Path for item in self.TargetFileList.values()}
+        source_target_map = self.SourceTargetMap
+        source_name_map = self.SourceNameMap
         target_abs = source_target_map.get(source_file_abs)
         if target_abs is None:
             if source_file_abs.strip().endswith(".i"):
@@ -25,6 +25,7 @@ from GenPatchPcdTable.GenPatchPcdTable import parsePcdInfoFromMapFile
 from Workspace.MetaFileCommentParser import UsageList
 from .GenPcdDb import CreatePcdDatabaseCode
 from Common.caching import cached_class_function
+from Common.RemoteCache import FetchCacheFile, FetchCacheTree, GetRemoteCache, REMOTE_FILE_LIST
 from AutoGen.ModuleAutoGenHelper import PlatformInfo,WorkSpaceInfo
 import json
 import tempfile
@@ -1700,6 +1701,8 @@ class ModuleAutoGen(AutoGen):
         # Create ModuleHashPair file to support multiple version cache together
         ModuleHashPair = path.join(FileDir, self.Name + ".ModuleHashPair")
         ModuleHashPairList = [] # tuple list: [tuple(PreMakefileHash, MakeHash)]
+        # Keep the versions that other builds have uploaded to the remote cache
+        FetchCacheFile(ModuleHashPair)
         if os.path.exists(ModuleHashPair):
             with open(ModuleHashPair, 'r') as f:
                 ModuleHashPairList = json.load(f)
@@ -1725,6 +1728,11 @@ class ModuleAutoGen(AutoGen):
                     self.CacheCopyFile(FileDir, self.BuildDir, File)
                 else:
                     self.CacheCopyFile(CacheFileDir, self.BuildDir, File)
+
+        RemoteCache = GetRemoteCache()
+        if RemoteCache is not None:
+            RemoteCache.SaveFileList(CacheFileDir)
+            RemoteCache.SaveFileList(CacheFfsDir)
     ## Create makefile for the module and its dependent libraries
     #
     #   @param      CreateLibraryMakeFile   Flag indicating if or not the makefiles of
@@ -2171,6 +2179,7 @@ class ModuleAutoGen(AutoGen):
 
         ModuleHashPairList = [] # tuple list: [tuple(PreMakefileHash, MakeHash)]
         ModuleHashPair = path.join(ModuleCacheDir, self.Name + ".ModuleHashPair")
+        FetchCacheFile(ModuleHashPair)
         try:
             with open(LongFilePath(ModuleHashPair), 'r') as f:
                 ModuleHashPairList = json.load(f)
@@ -2188,6 +2197,7 @@ class ModuleAutoGen(AutoGen):
             PreMakeHashFileList_FilePah = path.join(ModuleCacheDir, self.Name + ".PreMakeHashFileList." + PreMakefileHash)
             MakeHashFileList_FilePah = path.join(ModuleCacheDir, self.Name + ".MakeHashFileList." + MakeHash)
 
+            FetchCacheFile(MakeHashFileList_FilePah)
             try:
                 with open(LongFilePath(MakeHashFileList_FilePah), 'r') as f:
                     MakeHashFileList = json.load(f)
@@ -2208,6 +2218,7 @@ class ModuleAutoGen(AutoGen):
                 # Convert to path start with cache source dir
                 RelativePath = os.path.relpath(HashChainFile, self.WorkspaceDir)
                 NewFilePath = os.path.join(GlobalData.gBinCacheSource, RelativePath)
+                FetchCacheFile(NewFilePath)
                 if self.CheckHashChainFile(NewFilePath):
                     GlobalData.gHashChainStatus[HashChainFile] = True
                     # Save the module self HashFile for GenPreMakefileHashList later usage
@@ -2222,13 +2233,19 @@ class ModuleAutoGen(AutoGen):
                 continue
 
             # PreMakefile cache hit, restore the module build result
+            FetchCacheTree(SourceHashDir)
+            FetchCacheTree(SourceFfsHashDir)
             for root, dir, files in os.walk(SourceHashDir):
                 for f in files:
+                    if f == REMOTE_FILE_LIST:
+                        continue
                     File = path.join(root, f)
                     self.CacheCopyFile(self.BuildDir, SourceHashDir, File)
             if os.path.exists(SourceFfsHashDir):
                 for root, dir, files in os.walk(SourceFfsHashDir):
                     for f in files:
+                        if f == REMOTE_FILE_LIST:
+                            continue
                         File = path.join(root, f)
                         self.CacheCopyFile(self.FfsOutputDir, SourceFfsHashDir, File)
 
@@ -2331,6 +2348,7 @@ class ModuleAutoGen(AutoGen):
 
         ModuleHashPairList = [] # tuple list: [tuple(PreMakefileHash, MakeHash)]
         ModuleHashPair = path.join(ModuleCacheDir, self.Name + ".ModuleHashPair")
+        FetchCacheFile(ModuleHashPair)
         try:
             with open(LongFilePath(ModuleHashPair), 'r') as f:
                 ModuleHashPairList = json.load(f)
@@ -2348,6 +2366,7 @@ class ModuleAutoGen(AutoGen):
             PreMakeHashFileList_FilePah = path.join(ModuleCacheDir, self.Name + ".PreMakeHashFileList." + PreMakefileHash)
             MakeHashFileList_FilePah = path.join(ModuleCacheDir, self.Name + ".MakeHashFileList." + MakeHash)
 
+            FetchCacheFile(PreMakeHashFileList_FilePah)
             try:
                 with open(LongFilePath(PreMakeHashFileList_FilePah), 'r') as f:
                     PreMakeHashFileList = json.load(f)
@@ -2368,6 +2387,7 @@ class ModuleAutoGen(AutoGen):
                 # Convert to path start with cache source dir
                 RelativePath = os.path.relpath(HashChainFile, self.WorkspaceDir)
                 NewFilePath = os.path.join(GlobalData.gBinCacheSource, RelativePath)
+                FetchCacheFile(NewFilePath)
                 if self.CheckHashChainFile(NewFilePath):
                     GlobalData.gHashChainStatus[HashChainFile] = True
                 else:
@@ -2379,13 +2399,19 @@ class ModuleAutoGen(AutoGen):
                 continue
 
             # PreMakefile cache hit, restore the module build result
+            FetchCacheTree(SourceHashDir)
+            FetchCacheTree(SourceFfsHashDir)
             for root, dir, files in os.walk(SourceHashDir):
                 for f in files:
+                    if f == REMOTE_FILE_LIST:
+                        continue
                     File = path.join(root, f)
                     self.CacheCopyFile(self.BuildDir, SourceHashDir, File)
             if os.path.exists(SourceFfsHashDir):
                 for root, dir, files in os.walk(SourceFfsHashDir):
                     for f in files:
+                        if f == REMOTE_FILE_LIST:
+                            continue
                         File = path.join(root, f)
                         self.CacheCopyFile(self.FfsOutputDir, SourceFfsHashDir, File)
 
@@ -105,6 +105,9 @@ gConditionalPcds = []
 gUseHashCache = None
 gBinCacheDest = None
 gBinCacheSource = None
+# The URL of the remote binary cache, and the size limit of its local directory in MB
+gBinCacheRemote = None
+gBinCacheSize = None
 gPlatformHash = None
 gPlatformHashFile = None
 gPackageHash = None
@@ -119,6 +122,8 @@ gModuleAllCacheStatus = None
 gModuleCacheHit = None
 
 gEnableGenfdsMultiThread = True
+# Build the modules of the platform with ninja
+gUseNinja = False
 gSikpAutoGenCache = set()
 # Common lock for the file access in multiple process AutoGens
 file_lock = None
@@ -0,0 +1,318 @@
+## @file
+# Remote backend of the binary cache of the build command
+#
+# A remote binary cache is an HTTP or HTTPS server, or an S3-compatible object
+# store, that serves the files of a binary cache directory at the same relative
+# paths with GET, and stores them with PUT. The build keeps a local directory
+# as --binary-source or --binary-destination: files are fetched into it on
+# demand, files written to it during the build are uploaded after the build,
+# and it is trimmed to a size limit by removing the least recently used files.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+#
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+## Import Modules
+#
+from __future__ import absolute_import
+import os
+import json
+import time
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from urllib.request import Request, urlopen
+from urllib.error import HTTPError, URLError
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.LongFilePathSupport import LongFilePath
+
+## The name of the file that lists the files of a cached directory
+REMOTE_FILE_LIST = '.RemoteFileList'
+
+## The size limit of the local directory in MB, if --binary-cache-size is not given
+DEFAULT_LOCAL_CACHE_SIZE = 8192
+
+## The number of concurrent transfers of each process
+TRANSFER_THREAD_NUMBER = 8
+
+## The timeout of each transfer in seconds
+TRANSFER_TIMEOUT = 60
+
+## The environment variable whose value, if set, is sent as the Authorization header
+AUTHORIZATION_ENV = 'EDK_BINARY_CACHE_AUTHORIZATION'
+
+## Check whether the binary cache option is the URL of a remote cache
+#
+#   @param  Value   The value of --binary-source or --binary-destination
+#
+#   @retval True    Value is an HTTP or HTTPS URL
+#   @retval False   Value is a directory
+#
+def IsRemoteCache(Value):
+    return Value is not None and Value.lower().startswith(('http://', 'https://'))
+
+## The remote binary cache of a build process
+#
+class RemoteCache(object):
+    ## Constructor
+    #
+    #   @param  Url         The URL of the root of the remote cache
+    #   @param  LocalDir    The local directory that mirrors the remote cache
+    #   @param  MaxSize     The size limit of LocalDir in MB
+    #
+    def __init__(self, Url, LocalDir, MaxSize):
+        self.Url = Url.rstrip('/')
+        self.LocalDir = os.path.normpath(LocalDir)
+        self.MaxSize = MaxSize * 1024 * 1024
+        self.StartTime = time.time()
+        self.Pid = os.getpid()
+        self.Lock = threading.Lock()
+        self.Pool = ThreadPoolExecutor(max_workers=TRANSFER_THREAD_NUMBER)
+        self.UploadedDict = {}
+        self.MissSet = set()
+        self.Statistics = {
+            'LocalHit':      0,
+            'RemoteHit':     0,
+            'RemoteMiss':    0,
+            'Downloaded':    0,
+            'Uploaded':      0,
+            'UploadedBytes': 0,
+            'Error':         0,
+            }
+
+    def _Count(self, Name, Value=1):
+        with self.Lock:
+            self.Statistics[Name] += Value
+
+    def _Request(self, RelativePath, Method='GET', Data=None):
+        Url = self.Url + '/' + RelativePath.replace(os.sep, '/')
+        Req = Request(Url, data=Data, method=Method)
+        Authorization = os.environ.get(AUTHORIZATION_ENV)
+        if Authorization:
+            Req.add_header('Authorization', Authorization)
+        if Data is not None:
+            Req.add_header('Content-Type', 'application/octet-stream')
+        return urlopen(Req, timeout=TRANSFER_TIMEOUT)
+
+    ## Make sure that a file of the local directory is there
+    #
+    #   The file is downloaded from the remote cache if the local directory does
+    #   not have it yet. A file that the remote cache does not have is not
+    #   requested again by this process.
+    #
+    #   @param  LocalPath   The path of the file in the local directory
+    #
+    #   @retval True        The file is in the local directory
+    #   @retval False       Neither the local directory nor the remote cache has the file
+    #
+    def Fetch(self, LocalPath):
+        LocalPath = os.path.normpath(LocalPath)
+        if os.path.isfile(LongFilePath(LocalPath)):
+            # Mark the file as recently used for Trim()
+            try:
+                os.utime(LongFilePath(LocalPath), None)
+            except OSError:
+                pass
+            self._Count('LocalHit')
+            return True
+
+        RelativePath = os.path.relpath(LocalPath, self.LocalDir)
+        if RelativePath.startswith(os.pardir) or RelativePath in self.MissSet:
+            return False
+
+        try:
+            with self._Request(RelativePath) as Response:
+                Content = Response.read()
+        except HTTPError as X:
+            if X.code != 404:
+                EdkLogger.quiet("[cache warning]: fail to fetch %s: %s" % (RelativePath, X))
+                self._Count('Error')
+            self._Count('RemoteMiss')
+            with self.Lock:
+                self.MissSet.add(RelativePath)
+            return False
+        except (URLError, OSError) as X:
+            EdkLogger.quiet("[cache warning]: fail to fetch %s: %s" % (RelativePath, X))
+            self._Count('Error')
+            self._Count('RemoteMiss')
+            with self.Lock:
+                self.MissSet.add(RelativePath)
+            return False
+
+        #
+        # Other processes may fetch the same file, so write it to a file
+        # of this thread and rename it.
+        #
+        TempPath = '%s.%d.%d.tmp' % (LocalPath, os.getpid(), threading.get_ident())
+        try:
+            if not os.path.isdir(LongFilePath(os.path.dirname(LocalPath))):
+                os.makedirs(LongFilePath(os.path.dirname(LocalPath)), exist_ok=True)
+            with open(LongFilePath(TempPath), 'wb') as File:
+                File.write(Content)
+            os.replace(LongFilePath(TempPath), LongFilePath(LocalPath))
+        except OSError as X:
+            EdkLogger.quiet("[cache warning]: fail to save %s: %s" % (LocalPath, X))
+            self._Count('Error')
+            return False
+        self._Count('RemoteHit')
+        self._Count('Downloaded', len(Content))
+        return True
+
+    ## Make sure that a directory of the local directory and all its files are there
+    #
+    #   The files listed by the REMOTE_FILE_LIST file of the directory are
+    #   fetched concurrently.
+    #
+    #   @param  LocalDir    The path of the directory in the local directory
+    #
+    #   @retval True        All files of the directory are in the local directory
+    #   @retval False       The directory or any of its files is not in the cache
+    #
+    def FetchTree(self, LocalDir):
+        FileListPath = os.path.join(LocalDir, REMOTE_FILE_LIST)
+        if not self.Fetch(FileListPath):
+            return False
+        try:
+            with open(LongFilePath(FileListPath), 'r') as File:
+                FileList = json.load(File)
+        except (OSError, ValueError):
+            EdkLogger.quiet("[cache error]: fail to load %s" % FileListPath)
+            return False
+        Paths = [os.path.join(LocalDir, os.path.normpath(Name)) for Name in FileList]
+        return all(self.Pool.map(self.Fetch, Paths))
+
+    ## Write the REMOTE_FILE_LIST file of a directory of the local directory
+    #
+    #   @param  LocalDir    The path of the directory in the local directory
+    #
+    def SaveFileList(self, LocalDir):
+        FileList = []
+        for Root, Dirs, Files in os.walk(LocalDir):
+            for Name in Files:
+                if Name != REMOTE_FILE_LIST and not Name.endswith('.tmp'):
+                    FileList.append(os.path.relpath(os.path.join(Root, Name), LocalDir).replace(os.sep, '/'))
+        FileList.sort()
+        with open(LongFilePath(os.path.join(LocalDir, REMOTE_FILE_LIST)), 'w') as File:
+            json.dump(FileList, File, indent=2)
+
+    def _Upload(self, LocalPath):
+        RelativePath = os.path.relpath(LocalPath, self.LocalDir)
+        try:
+            MTime = os.path.getmtime(LongFilePath(LocalPath))
+            with open(LongFilePath(LocalPath), 'rb') as File:
+                Content = File.read()
+            with self._Request(RelativePath, 'PUT', Content):
+                pass
+        except (URLError, OSError) as X:
+            EdkLogger.quiet("[cache warning]: fail to upload %s: %s" % (RelativePath, X))
+            self._Count('Error')
+            return
+        self.UploadedDict[LocalPath] = MTime
+        self._Count('Uploaded')
+        self._Count('UploadedBytes', len(Content))
+
+    ## Upload the files that the build has written to the local directory
+    #
+    #   The REMOTE_FILE_LIST files are uploaded after the other files, so a
+    #   directory is not visible to other builds before all its files are.
+    #
+    def Upload(self):
+        Files = []
+        FileLists = []
+        for Root, Dirs, Names in os.walk(self.LocalDir):
+            for Name in Names:
+                LocalPath = os.path.join(Root, Name)
+                MTime = os.path.getmtime(LongFilePath(LocalPath))
+                if Name.endswith('.tmp') or MTime < self.StartTime or self.UploadedDict.get(LocalPath) == MTime:
+                    continue
+                if Name == REMOTE_FILE_LIST:
+                    FileLists.append(LocalPath)
+                else:
+                    Files.append(LocalPath)
+        list(self.Pool.map(self._Upload, Files))
+        list(self.Pool.map(self._Upload, FileLists))
+
+    ## Remove the least recently used files until the local directory fits in its size limit
+    #
+    def Trim(self):
+        FileList = []
+        TotalSize = 0
+        for Root, Dirs, Names in os.walk(self.LocalDir):
+            for Name in Names:
+                LocalPath = os.path.join(Root, Name)
+                try:
+                    Stat = os.stat(LongFilePath(LocalPath))
+                except OSError:
+                    continue
+                FileList.append((Stat.st_mtime, Stat.st_size, LocalPath))
+                TotalSize += Stat.st_size
+        if TotalSize <= self.MaxSize:
+            return
+        FileList.sort()
+        for (MTime, Size, LocalPath) in FileList:
+            if TotalSize <= self.MaxSize:
+                break
+            try:
+                os.remove(LongFilePath(LocalPath))
+            except OSError:
+                continue
+            TotalSize -= Size
+
+    ## Add the statistics of another process
+    #
+    #   @param  Statistics  The Statistics of the RemoteCache of the other process
+    #
+    def MergeStatistics(self, Statistics):
+        with self.Lock:
+            for Name in Statistics:
+                self.Statistics[Name] += Statistics[Name]
+
+    ## Print the statistics of the remote cache
+    #
+    def PrintSummary(self):
+        Statistics = self.Statistics
+        EdkLogger.quiet("[cache Summary]: Remote cache %s" % self.Url)
+        EdkLogger.quiet("[cache Summary]: Local hit num: %d, remote hit num: %d, remote miss num: %d" %
+                        (Statistics['LocalHit'], Statistics['RemoteHit'], Statistics['RemoteMiss']))
+        EdkLogger.quiet("[cache Summary]: Downloaded %d bytes, uploaded %d files of %d bytes, %d errors" %
+                        (Statistics['Downloaded'], Statistics['Uploaded'], Statistics['UploadedBytes'], Statistics['Error']))
+
+## The RemoteCache of this process
+_RemoteCache = None
+
+## Get the RemoteCache of this process
+#
+#   A process started by multiprocessing gets a RemoteCache of its own, because
+#   the threads of the transfer pool are not inherited.
+#
+#   @retval RemoteCache The remote cache given by GlobalData.gBinCacheRemote
+#   @retval None        No remote cache is used
+#
+def GetRemoteCache():
+    global _RemoteCache
+    if not GlobalData.gBinCacheRemote:
+        return None
+    if _RemoteCache is None or _RemoteCache.Pid != os.getpid():
+        LocalDir = GlobalData.gBinCacheSource if GlobalData.gBinCacheSource else GlobalData.gBinCacheDest
+        _RemoteCache = RemoteCache(GlobalData.gBinCacheRemote, LocalDir, GlobalData.gBinCacheSize)
+    return _RemoteCache
+
+## Fetch a file of the binary cache from the remote cache, if one is used
+#
+#   @param  LocalPath   The path of the file in the binary cache directory
+#
+def FetchCacheFile(LocalPath):
+    Cache = GetRemoteCache()
+    if Cache is not None:
+        Cache.Fetch(LocalPath)
+
+## Fetch a directory of the binary cache from the remote cache, if one is used
+#
+#   @param  LocalDir    The path of the directory in the binary cache directory
+#
+def FetchCacheTree(LocalDir):
+    Cache = GetRemoteCache()
+    if Cache is not None:
+        Cache.FetchTree(LocalDir)
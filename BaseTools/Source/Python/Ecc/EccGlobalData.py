@@ -19,3 +19,4 @@ gCFileList = []
 gHFileList = []
 gUFileList = []
 gException = None
+gJobs = 0
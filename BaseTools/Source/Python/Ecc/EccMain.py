@@ -341,6 +341,10 @@ class Ecc(object):
             self.ScanMetaData = False
         if Options.folders is not None:
             self.OnlyScan = True
+        if Options.Jobs is not None:
+            if Options.Jobs < 1:
+                EdkLogger.error("ECC", BuildToolError.OPTION_VALUE_INVALID, ExtraData="-n/--jobs must be at least 1")
+            EccGlobalData.gJobs = Options.Jobs
 
     ## SetLogLevel
     #
@@ -392,6 +396,8 @@ class Ecc(object):
         Parser.add_option("-d", "--debug", action="store", type="int", help="Enable debug messages at specified level.")
         Parser.add_option("-w", "--workspace", action="store", type="string", dest='Workspace', help="Specify workspace.")
         Parser.add_option("-f", "--folders", action="store_true", type=None, help="Only scanning specified folders which are recorded in config.ini file.")
+        Parser.add_option("-n", "--jobs", action="store", type="int", dest="Jobs",
+            help="Specify the number of processes that parse the C source files. Defaultly use the number of processors.")
 
         (Opt, Args)=Parser.parse_args()
 
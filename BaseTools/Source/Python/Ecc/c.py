@@ -12,6 +12,9 @@ import sys
 import Common.LongFilePathOs as os
 import re
 import string
+import pickle
+import hashlib
+import multiprocessing
 from Ecc import CodeFragmentCollector
 from Ecc import FileProfile
 from CommonDataClass import DataClass
@@ -28,6 +31,15 @@ ComplexTypeDict = {}
 SUDict = {}
 IgnoredKeywordList = ['EFI_ERROR']
 
+## The file that keeps the parse results of the C source files between runs
+PARSE_CACHE_FILE = 'EccParseCache.pickle'
+
+## The files that a worker process parses at a time
+PARSE_CHUNK_SIZE = 16
+
+## The TokenReleaceList of the source files parsed by this process
+_ParseTokenReleaceList = []
+
 def GetIgnoredDirListPattern():
     skipList = list(EccGlobalData.gConfig.SkipDirList) + ['.svn']
     DirString = '|'.join(skipList)
@@ -493,6 +505,78 @@ def GetFileModificationTimeFromDB(FullFileName):
         TimeValue = Result[0]
     return TimeValue
 
+## Load the parse results of the previous run
+#
+#   @retval Dict    The parse results, keyed by the full path of the source file
+#
+def LoadParseCache():
+    try:
+        with open(PARSE_CACHE_FILE, 'rb') as File:
+            Cache = pickle.load(File)
+    except Exception:
+        return {}
+    if not isinstance(Cache, dict):
+        return {}
+    return Cache
+
+## Save the parse results of this run for the next one
+#
+#   @param  Cache   The parse results, keyed by the full path of the source file
+#
+def SaveParseCache(Cache):
+    try:
+        with open(PARSE_CACHE_FILE + '.tmp', 'wb') as File:
+            pickle.dump(Cache, File, pickle.HIGHEST_PROTOCOL)
+        os.replace(PARSE_CACHE_FILE + '.tmp', PARSE_CACHE_FILE)
+    except OSError as X:
+        EdkLogger.verbose("Failed to save %s: %s" % (PARSE_CACHE_FILE, X))
+
+## Get the digest that a parse result of a source file is valid for
+#
+#   The parse result of a C source file depends only on its content and on the
+#   TokenReleaceList of the configuration, since the parser does not follow
+#   #include directives.
+#
+#   @param  FullName            The full path of the source file
+#   @param  TokenReleaceList    The TokenReleaceList of the configuration
+#
+def GetSourceFileDigest(FullName, TokenReleaceList):
+    Hash = hashlib.sha256()
+    with open(FullName, 'rb') as File:
+        Hash.update(File.read())
+    Hash.update(repr(TokenReleaceList).encode('utf-8'))
+    return Hash.hexdigest()
+
+def InitParseProcess(TokenReleaceList, LogLevel):
+    global _ParseTokenReleaceList
+    _ParseTokenReleaceList = TokenReleaceList
+    EdkLogger.SetLevel(LogLevel)
+
+## Parse a C source file
+#
+#   This function runs in the worker processes of CollectSourceCodeDataIntoDB,
+#   and uses only the module-level state of the parser of its own process.
+#
+#   @param  FullName    The full path of the source file
+#
+#   @retval tuple       (FunctionList, IdentifierList, HasParseError)
+#
+def ParseSourceFile(FullName):
+    EdkLogger.info("Parsing " + FullName)
+    HasParseError = False
+    collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
+    collector.TokenReleaceList = _ParseTokenReleaceList
+    try:
+        collector.ParseFile()
+    except UnicodeError:
+        HasParseError = True
+        collector.CleanFileProfileBuffer()
+        collector.ParseFileWithClearedPPDirective()
+#    collector.PrintFragments()
+    Result = (GetFunctionList(), GetIdentifierList(), HasParseError)
+    collector.CleanFileProfileBuffer()
+    return Result
+
 def CollectSourceCodeDataIntoDB(RootDir):
     FileObjList = []
     tuple = os.walk(RootDir)
@@ -500,6 +584,7 @@ def CollectSourceCodeDataIntoDB(RootDir):
     ParseErrorFileList = []
     TokenReleaceList = EccGlobalData.gConfig.TokenReleaceList
     TokenReleaceList.extend(['L",\\\""'])
+    SourceFileList = []
 
     for dirpath, dirnames, filenames in tuple:
         if IgnoredPattern.match(dirpath.upper()):
@@ -517,29 +602,63 @@ def CollectSourceCodeDataIntoDB(RootDir):
         for f in filenames:
             if f.lower() in EccGlobalData.gConfig.SkipFileList:
                 continue
-            collector = None
             FullName = os.path.normpath(os.path.join(dirpath, f))
             model = DataClass.MODEL_FILE_OTHERS
             if os.path.splitext(f)[1] in ('.h', '.c'):
-                EdkLogger.info("Parsing " + FullName)
                 model = f.endswith('c') and DataClass.MODEL_FILE_C or DataClass.MODEL_FILE_H
-                collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
-                collector.TokenReleaceList = TokenReleaceList
-                try:
-                    collector.ParseFile()
-                except UnicodeError:
-                    ParseErrorFileList.append(FullName)
-                    collector.CleanFileProfileBuffer()
-                    collector.ParseFileWithClearedPPDirective()
-#                collector.PrintFragments()
+                SourceFileList.append(FullName)
             BaseName = os.path.basename(f)
             DirName = os.path.dirname(FullName)
             Ext = os.path.splitext(f)[1].lstrip('.')
             ModifiedTime = os.path.getmtime(FullName)
-            FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, GetFunctionList(), GetIdentifierList(), [])
+            FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, [], [], [])
             FileObjList.append(FileObj)
-            if collector:
-                collector.CleanFileProfileBuffer()
+
+    #
+    # Only the source files that have changed since the previous run are
+    # parsed, and they are parsed by a pool of worker processes.
+    #
+    ParseCache = LoadParseCache()
+    ResultDict = {}
+    DigestDict = {}
+    ParseFileList = []
+    for FullName in SourceFileList:
+        DigestDict[FullName] = GetSourceFileDigest(FullName, TokenReleaceList)
+        Cached = ParseCache.get(FullName)
+        if Cached is not None and Cached[0] == DigestDict[FullName]:
+            ResultDict[FullName] = Cached[1]
+        else:
+            ParseFileList.append(FullName)
+    EdkLogger.quiet("Parsing %d of %d C source files ..." % (len(ParseFileList), len(SourceFileList)))
+
+    Jobs = EccGlobalData.gJobs if EccGlobalData.gJobs else multiprocessing.cpu_count()
+    Jobs = min(Jobs, (len(ParseFileList) + PARSE_CHUNK_SIZE - 1) // PARSE_CHUNK_SIZE)
+    if Jobs > 1:
+        Pool = multiprocessing.Pool(Jobs, InitParseProcess, (TokenReleaceList, EdkLogger.GetLevel()))
+        try:
+            for FullName, Result in zip(ParseFileList, Pool.imap(ParseSourceFile, ParseFileList, PARSE_CHUNK_SIZE)):
+                ResultDict[FullName] = Result
+        finally:
+            Pool.close()
+            Pool.join()
+    else:
+        InitParseProcess(TokenReleaceList, EdkLogger.GetLevel())
+        for FullName in ParseFileList:
+            ResultDict[FullName] = ParseSourceFile(FullName)
+
+    NewParseCache = dict(ParseCache)
+    for FullName in SourceFileList:
+        NewParseCache[FullName] = (DigestDict[FullName], ResultDict[FullName])
+    for FullName in list(NewParseCache):
+        if not os.path.isfile(FullName):
+            del NewParseCache[FullName]
+    SaveParseCache(NewParseCache)
+
+    for FileObj in FileObjList:
+        if FileObj.FullPath in ResultDict:
+            (FileObj.FunctionList, FileObj.IdentifierList, HasParseError) = ResultDict[FileObj.FullPath]
+            if HasParseError:
+                ParseErrorFileList.append(FileObj.FullPath)
 
     if len(ParseErrorFileList) > 0:
         EdkLogger.info("Found unrecoverable error during parsing:\n\t%s\n" % "\n\t".join(ParseErrorFileList))
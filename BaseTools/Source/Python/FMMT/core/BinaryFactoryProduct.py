@@ -112,10 +112,12 @@ class SectionProduct(BinaryProduct):
             Whole_Data = ParTree.Data.Data
         else:
             Data_Size = len(Whole_Data)
+        # Parse the headers from a view of the data instead of a copy of the rest of it.
+        Whole_View = memoryview(Whole_Data)
         # Parser all the data to collect all the Section recorded in its Parent Section.
         while Rel_Offset < Data_Size:
             # Create a SectionNode and set it as the SectionTree's Data
-            Section_Info = SectionNode(Whole_Data[Rel_Offset:])
+            Section_Info = SectionNode(Whole_View[Rel_Offset:])
             Section_Tree = BIOSTREE(Section_Info.Name)
             Section_Tree.type = SECTION_TREE
             Section_Info.Data = Whole_Data[Rel_Offset+Section_Info.HeaderLength: Rel_Offset+Section_Info.Size]
@@ -156,10 +158,12 @@ class FfsProduct(BinaryProduct):
             Whole_Data = ParTree.Data.Data
         else:
             Data_Size = len(Whole_Data)
+        # Parse the headers from a view of the data instead of a copy of the rest of it.
+        Whole_View = memoryview(Whole_Data)
         # Parser all the data to collect all the Section recorded in Ffs.
         while Rel_Offset < Data_Size:
             # Create a SectionNode and set it as the SectionTree's Data
-            Section_Info = SectionNode(Whole_Data[Rel_Offset:])
+            Section_Info = SectionNode(Whole_View[Rel_Offset:])
             Section_Tree = BIOSTREE(Section_Info.Name)
             Section_Tree.type = SECTION_TREE
             Section_Info.Data = Whole_Data[Rel_Offset+Section_Info.HeaderLength: Rel_Offset+Section_Info.Size]
@@ -201,6 +205,8 @@ class FvProduct(BinaryProduct):
             Whole_Data = ParTree.Data.Data
         else:
             Data_Size = len(Whole_Data)
+        # Parse the headers from a view of the data instead of a copy of the rest of it.
+        Whole_View = memoryview(Whole_Data)
         # Parser all the data to collect all the Ffs recorded in Fv.
         while Rel_Offset < Data_Size:
             # Create a FfsNode and set it as the FFsTree's Data
@@ -214,7 +220,7 @@ class FvProduct(BinaryProduct):
                 ParTree.insertChild(Ffs_Tree)
                 Rel_Offset = Data_Size
             else:
-                Ffs_Info = FfsNode(Whole_Data[Rel_Offset:])
+                Ffs_Info = FfsNode(Whole_View[Rel_Offset:])
                 Ffs_Tree = BIOSTREE(Ffs_Info.Name)
                 Ffs_Info.HOffset = Ffs_Offset + Rel_Whole_Offset
                 Ffs_Info.DOffset = Ffs_Offset + Ffs_Info.Header.HeaderLength + Rel_Whole_Offset
@@ -309,8 +315,8 @@ class FdProduct(BinaryProduct):
         cur_index = 0
         # Get all the EFI_FIRMWARE_FILE_SYSTEM2_GUID_BYTE FV image offset and length.
         while cur_index < data_size:
-            if EFI_FIRMWARE_FILE_SYSTEM2_GUID_BYTE in whole_data[cur_index:]:
-                target_index = whole_data[cur_index:].index(EFI_FIRMWARE_FILE_SYSTEM2_GUID_BYTE) + cur_index
+            target_index = whole_data.find(EFI_FIRMWARE_FILE_SYSTEM2_GUID_BYTE, cur_index)
+            if target_index != -1:
                 if whole_data[target_index+24:target_index+28] == FVH_SIGNATURE:
                     Fd_Struct.append([FV_TREE, target_index - 16, unpack("Q", whole_data[target_index+16:target_index+24])])
                     cur_index = Fd_Struct[-1][1] + Fd_Struct[-1][2][0]
@@ -321,8 +327,8 @@ class FdProduct(BinaryProduct):
         cur_index = 0
         # Get all the EFI_FIRMWARE_FILE_SYSTEM3_GUID_BYTE FV image offset and length.
         while cur_index < data_size:
-            if EFI_FIRMWARE_FILE_SYSTEM3_GUID_BYTE in whole_data[cur_index:]:
-                target_index = whole_data[cur_index:].index(EFI_FIRMWARE_FILE_SYSTEM3_GUID_BYTE) + cur_index
+            target_index = whole_data.find(EFI_FIRMWARE_FILE_SYSTEM3_GUID_BYTE, cur_index)
+            if target_index != -1:
                 if whole_data[target_index+24:target_index+28] == FVH_SIGNATURE:
                     Fd_Struct.append([FV_TREE, target_index - 16, unpack("Q", whole_data[target_index+16:target_index+24])])
                     cur_index = Fd_Struct[-1][1] + Fd_Struct[-1][2][0]
@@ -333,8 +339,8 @@ class FdProduct(BinaryProduct):
         cur_index = 0
         # Get all the EFI_SYSTEM_NVDATA_FV_GUID_BYTE FV image offset and length.
         while cur_index < data_size:
-            if EFI_SYSTEM_NVDATA_FV_GUID_BYTE in whole_data[cur_index:]:
-                target_index = whole_data[cur_index:].index(EFI_SYSTEM_NVDATA_FV_GUID_BYTE) + cur_index
+            target_index = whole_data.find(EFI_SYSTEM_NVDATA_FV_GUID_BYTE, cur_index)
+            if target_index != -1:
                 if whole_data[target_index+24:target_index+28] == FVH_SIGNATURE:
                     Fd_Struct.append([DATA_FV_TREE, target_index - 16, unpack("Q", whole_data[target_index+16:target_index+24])])
                     cur_index = Fd_Struct[-1][1] + Fd_Struct[-1][2][0]
@@ -377,4 +383,4 @@ class ParserEntry():
     def DataParser(self, Tree, Data: bytes, Offset: int) -> None:
         TargetFactory = self.GetTargetFactory(Tree.type)
         if TargetFactory:
-            self.Generate_Product(TargetFactory, Tree, Data, Offset)
\ No newline at end of file
+            self.Generate_Product(TargetFactory, Tree, Data, Offset)
@@ -32,12 +32,35 @@ class BIOSTREE:
         self.key = NodeName
         self.type = None
         self.Data = None
+        self.Expander = None
         self.Child = []
         self.Findlist = []
         self.Parent = None
         self.NextRel = None
         self.LastRel = None
 
+    ## The child nodes of the node
+    #
+    # The children of a node whose parsing is deferred, such as an encapsulated
+    # section, are parsed by its Expander on the first access to Child.
+    #
+    @property
+    def Child(self) -> list:
+        self.Expand()
+        return self._Child
+
+    @Child.setter
+    def Child(self, Value: list) -> None:
+        # Replacing the children discards the deferred parsing.
+        self.Expander = None
+        self._Child = Value
+
+    def Expand(self) -> None:
+        if self.Expander:
+            Expander = self.Expander
+            self.Expander = None
+            Expander(self)
+
     def HasChild(self) -> bool:
         if self.Child == []:
             return False
@@ -145,6 +168,8 @@ class BIOSTREE:
     def ExportTree(self,TreeInfo: dict=None) -> dict:
         if TreeInfo is None:
             TreeInfo =collections.OrderedDict()
+        # The size of a GUID defined section is known after it is decompressed.
+        self.Expand()
 
         if self.type == ROOT_TREE or self.type == ROOT_FV_TREE or self.type == ROOT_FFS_TREE or self.type == ROOT_SECTION_TREE:
             key = str(self.key)
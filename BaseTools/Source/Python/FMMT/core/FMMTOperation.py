@@ -42,9 +42,7 @@ def ViewFile(inputfile: str, ROOT_TYPE: str, layoutfile: str=None, outputfile: s
     # 4. Data Encapsulation
     if outputfile:
         logger.debug('Start encapsulating data......')
-        FmmtParser.Encapsulation(FmmtParser.WholeFvTree, False)
-        with open(outputfile, "wb") as f:
-            f.write(FmmtParser.FinalData)
+        FmmtParser.EncapsulationToFile(FmmtParser.WholeFvTree, False, outputfile)
         logger.debug('Encapsulated data is saved in {}.'.format(outputfile))
 
 def DeleteFfs(inputfile: str, TargetFfs_name: str, outputfile: str, Fv_name: str=None) -> None:
@@ -77,9 +75,7 @@ def DeleteFfs(inputfile: str, TargetFfs_name: str, outputfile: str, Fv_name: str
     # 4. Data Encapsulation
     if Status:
         logger.debug('Start encapsulating data......')
-        FmmtParser.Encapsulation(FmmtParser.WholeFvTree, False)
-        with open(outputfile, "wb") as f:
-            f.write(FmmtParser.FinalData)
+        FmmtParser.EncapsulationToFile(FmmtParser.WholeFvTree, False, outputfile)
         logger.debug('Encapsulated data is saved in {}.'.format(outputfile))
 
 def AddNewFfs(inputfile: str, Fv_name: str, newffsfile: str, outputfile: str) -> None:
@@ -121,9 +117,7 @@ def AddNewFfs(inputfile: str, Fv_name: str, newffsfile: str, outputfile: str) ->
     # 4. Data Encapsulation
     if Status:
         logger.debug('Start encapsulating data......')
-        FmmtParser.Encapsulation(FmmtParser.WholeFvTree, False)
-        with open(outputfile, "wb") as f:
-            f.write(FmmtParser.FinalData)
+        FmmtParser.EncapsulationToFile(FmmtParser.WholeFvTree, False, outputfile)
         logger.debug('Encapsulated data is saved in {}.'.format(outputfile))
 
 def ReplaceFfs(inputfile: str, Ffs_name: str, newffsfile: str, outputfile: str, Fv_name: str=None) -> None:
@@ -163,9 +157,7 @@ def ReplaceFfs(inputfile: str, Ffs_name: str, newffsfile: str, outputfile: str,
     # 4. Data Encapsulation
     if Status:
         logger.debug('Start encapsulating data......')
-        FmmtParser.Encapsulation(FmmtParser.WholeFvTree, False)
-        with open(outputfile, "wb") as f:
-            f.write(FmmtParser.FinalData)
+        FmmtParser.EncapsulationToFile(FmmtParser.WholeFvTree, False, outputfile)
         logger.debug('Encapsulated data is saved in {}.'.format(outputfile))
 
 def ExtractFfs(inputfile: str, Ffs_name: str, outputfile: str, Fv_name: str=None) -> None:
@@ -226,7 +218,5 @@ def ShrinkFv(inputfile: str, outputfile: str) -> None:
     # 4. Data Encapsulation
     if Status:
         logger.debug('Start encapsulating data......')
-        FmmtParser.Encapsulation(FmmtParser.WholeFvTree, False)
-        with open(outputfile, "wb") as f:
-            f.write(FmmtParser.FinalData)
+        FmmtParser.EncapsulationToFile(FmmtParser.WholeFvTree, False, outputfile)
         logger.debug('Encapsulated data is saved in {}.'.format(outputfile))
@@ -15,17 +15,47 @@ class FMMTParser:
     def __init__(self, name: str, TYPE: str) -> None:
         self.WholeFvTree = BIOSTREE(name)
         self.WholeFvTree.type = TYPE
-        self.FinalData = b''
+        self.FinalData = bytearray()
+        self.OutputFile = None
         self.BinaryInfo = []
 
     ## Parser the nodes in WholeTree.
+    #
+    # The GUID defined and firmware volume image sections are parsed on the
+    # first access to their Child, so an encapsulated section is decompressed
+    # only when its content is needed. They are still parsed in the same order
+    # as the other nodes, because the nodes are accessed in depth-first order,
+    # so the nested Fvs are numbered in the same way.
+    #
     def ParserFromRoot(self, WholeFvTree=None, whole_data: bytes=b'', Reloffset: int=0) -> None:
         if WholeFvTree.type == ROOT_TREE or WholeFvTree.type == ROOT_FV_TREE:
             ParserEntry().DataParser(self.WholeFvTree, whole_data, Reloffset)
         else:
             ParserEntry().DataParser(WholeFvTree, whole_data, Reloffset)
         for Child in WholeFvTree.Child:
-            self.ParserFromRoot(Child, "")
+            if Child.type == SECTION_TREE and Child.Data.Type in (0x02, 0x17):
+                if Child.Data.Type == 0x02:
+                    Child.Data.OriData = Child.Data.Data
+                Child.Expander = self.ParserFromRoot
+            else:
+                self.ParserFromRoot(Child, "")
+
+    ## Add data to the output of Encapsulation
+    def WriteData(self, Data: bytes) -> None:
+        if self.OutputFile:
+            self.OutputFile.write(Data)
+        else:
+            self.FinalData += Data
+
+    ## Encapuslation all the data in tree into outputfile
+    #
+    # The data is written to the file node by node instead of being collected
+    # in self.FinalData first.
+    #
+    def EncapsulationToFile(self, rootTree, CompressStatus: bool, outputfile: str) -> None:
+        with open(outputfile, "wb") as self.OutputFile:
+            self.Encapsulation(rootTree, CompressStatus)
+        self.OutputFile = None
 
     ## Encapuslation all the data in tree into self.FinalData
     def Encapsulation(self, rootTree, CompressStatus: bool) -> None:
@@ -34,54 +64,54 @@ class FMMTParser:
             logger.debug('Encapsulated successfully!')
         # If current node do not have Header, just add Data.
         elif rootTree.type == BINARY_DATA or rootTree.type == FFS_FREE_SPACE:
-            self.FinalData += rootTree.Data.Data
+            self.WriteData(rootTree.Data.Data)
             rootTree.Child = []
         # If current node do not have Child and ExtHeader, just add its Header and Data.
         elif rootTree.type == DATA_FV_TREE or rootTree.type == FFS_PAD:
-            self.FinalData += struct2stream(rootTree.Data.Header) + rootTree.Data.Data + rootTree.Data.PadData
+            self.WriteData(struct2stream(rootTree.Data.Header) + rootTree.Data.Data + rootTree.Data.PadData)
             if rootTree.isFinalChild():
                 ParTree = rootTree.Parent
                 if ParTree.type != 'ROOT':
-                    self.FinalData += ParTree.Data.PadData
+                    self.WriteData(ParTree.Data.PadData)
             rootTree.Child = []
         # If current node is not Section node and may have Child and ExtHeader, add its Header,ExtHeader. If do not have Child, add its Data.
         elif rootTree.type == FV_TREE or rootTree.type == FFS_TREE or rootTree.type == SEC_FV_TREE:
             if rootTree.HasChild():
-                self.FinalData += struct2stream(rootTree.Data.Header)
+                self.WriteData(struct2stream(rootTree.Data.Header))
             else:
-                self.FinalData += struct2stream(rootTree.Data.Header) + rootTree.Data.Data + rootTree.Data.PadData
+                self.WriteData(struct2stream(rootTree.Data.Header) + rootTree.Data.Data + rootTree.Data.PadData)
                 if rootTree.isFinalChild():
                     ParTree = rootTree.Parent
                     if ParTree.type != 'ROOT':
-                        self.FinalData += ParTree.Data.PadData
+                        self.WriteData(ParTree.Data.PadData)
         # If current node is Section, need to consider its ExtHeader, Child and Compressed Status.
         elif rootTree.type == SECTION_TREE:
             # Not compressed section
             if rootTree.Data.OriData == b'' or (rootTree.Data.OriData != b'' and CompressStatus):
                 if rootTree.HasChild():
                     if rootTree.Data.ExtHeader:
-                        self.FinalData += struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader)
+                        self.WriteData(struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader))
                     else:
-                        self.FinalData += struct2stream(rootTree.Data.Header)
+                        self.WriteData(struct2stream(rootTree.Data.Header))
                 else:
                     Data = rootTree.Data.Data
                     if rootTree.Data.ExtHeader:
-                        self.FinalData += struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader) + Data + rootTree.Data.PadData
+                        self.WriteData(struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader) + Data + rootTree.Data.PadData)
                     else:
-                        self.FinalData += struct2stream(rootTree.Data.Header) + Data + rootTree.Data.PadData
+                        self.WriteData(struct2stream(rootTree.Data.Header) + Data + rootTree.Data.PadData)
                     if rootTree.isFinalChild():
                         ParTree = rootTree.Parent
-                        self.FinalData += ParTree.Data.PadData
+                        self.WriteData(ParTree.Data.PadData)
             # If compressed section
             else:
                 Data = rootTree.Data.OriData
                 rootTree.Child = []
                 if rootTree.Data.ExtHeader:
-                    self.FinalData += struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader) + Data + rootTree.Data.PadData
+                    self.WriteData(struct2stream(rootTree.Data.Header) + struct2stream(rootTree.Data.ExtHeader) + Data + rootTree.Data.PadData)
                 else:
-                    self.FinalData += struct2stream(rootTree.Data.Header) + Data + rootTree.Data.PadData
+                    self.WriteData(struct2stream(rootTree.Data.Header) + Data + rootTree.Data.PadData)
                 if rootTree.isFinalChild():
                     ParTree = rootTree.Parent
-                    self.FinalData += ParTree.Data.PadData
+                    self.WriteData(ParTree.Data.PadData)
         for Child in rootTree.Child:
             self.Encapsulation(Child, CompressStatus)
@@ -133,16 +133,21 @@ def ModifyFvExtData(TreeNode) -> None:
         InfoNode.Data.Data = FvExtData + InfoNode.Data.Data[TreeNode.Data.ExtHeader.ExtHeaderSize:]
         InfoNode.Data.ModCheckSum()
 
+## Get the data of a Fv from the header and data of its child nodes.
+def GetFvData(TargetFv) -> bytes:
+    DataList = []
+    for item in TargetFv.Child:
+        if item.type == FFS_FREE_SPACE:
+            DataList.append(item.Data.Data + item.Data.PadData)
+        else:
+            DataList.append(struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData)
+    return b''.join(DataList)
+
 def ModifyFvSystemGuid(TargetFv) -> None:
     if struct2stream(TargetFv.Data.Header.FileSystemGuid) == EFI_FIRMWARE_FILE_SYSTEM2_GUID_BYTE:
         TargetFv.Data.Header.FileSystemGuid = ModifyGuidFormat("5473C07A-3DCB-4dca-BD6F-1E9689E7349A")
     TargetFv.Data.ModCheckSum()
-    TargetFv.Data.Data = b''
-    for item in TargetFv.Child:
-        if item.type == FFS_FREE_SPACE:
-            TargetFv.Data.Data += item.Data.Data + item.Data.PadData
-        else:
-            TargetFv.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+    TargetFv.Data.Data = GetFvData(TargetFv)
 
 class FvHandler:
     def __init__(self, NewFfs, TargetFfs=None) -> None:
@@ -281,11 +286,7 @@ class FvHandler:
                         ParTree.Data.Size += Needed_Space
                         ParTree.Data.Header.Fvlength = ParTree.Data.Size
                 ModifyFvSystemGuid(ParTree)
-                for item in ParTree.Child:
-                    if item.type == FFS_FREE_SPACE:
-                        ParTree.Data.Data += item.Data.Data + item.Data.PadData
-                    else:
-                        ParTree.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+                ParTree.Data.Data += GetFvData(ParTree)
                 ParTree.Data.ModFvExt()
                 ParTree.Data.ModFvSize()
                 ParTree.Data.ModExtHeaderData()
@@ -425,12 +426,7 @@ class FvHandler:
                         TargetFv.Data.Free_Space = 0
                         TargetFv.insertChild(self.NewFfs)
                     # Encapsulate the Fv Data for update.
-                    TargetFv.Data.Data = b''
-                    for item in TargetFv.Child:
-                        if item.type == FFS_FREE_SPACE:
-                            TargetFv.Data.Data += item.Data.Data + item.Data.PadData
-                        else:
-                            TargetFv.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+                    TargetFv.Data.Data = GetFvData(TargetFv)
                     TargetFv.Data.Size += Needed_Space
                     # Modify TargetFv Data Header and ExtHeader info.
                     TargetFv.Data.Header.FvLength = TargetFv.Data.Size
@@ -524,12 +520,7 @@ class FvHandler:
                         TargetFv.Data.Free_Space = 0
                     ModifyFfsType(self.NewFfs)
                     ModifyFvSystemGuid(TargetFv)
-                    TargetFv.Data.Data = b''
-                    for item in TargetFv.Child:
-                        if item.type == FFS_FREE_SPACE:
-                            TargetFv.Data.Data += item.Data.Data + item.Data.PadData
-                        else:
-                            TargetFv.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+                    TargetFv.Data.Data = GetFvData(TargetFv)
                     # Encapsulate the Fv Data for update.
                     TargetFv.Data.Size += TargetLen
                     TargetFv.Data.Header.FvLength = TargetFv.Data.Size
@@ -564,12 +555,7 @@ class FvHandler:
                     TargetFv.insertChild(self.NewFfs)
                 ModifyFfsType(self.NewFfs)
                 ModifyFvSystemGuid(TargetFv)
-                TargetFv.Data.Data = b''
-                for item in TargetFv.Child:
-                    if item.type == FFS_FREE_SPACE:
-                        TargetFv.Data.Data += item.Data.Data + item.Data.PadData
-                    else:
-                        TargetFv.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+                TargetFv.Data.Data = GetFvData(TargetFv)
                 TargetFv.Data.Size += TargetLen
                 TargetFv.Data.Header.FvLength = TargetFv.Data.Size
                 TargetFv.Data.ModFvExt()
@@ -652,11 +638,7 @@ class FvHandler:
             TargetFv.Data.Size -= Removed_Space
             TargetFv.Data.Header.Fvlength = TargetFv.Data.Size
             ModifyFvSystemGuid(TargetFv)
-            for item in TargetFv.Child:
-                if item.type == FFS_FREE_SPACE:
-                    TargetFv.Data.Data += item.Data.Data + item.Data.PadData
-                else:
-                    TargetFv.Data.Data += struct2stream(item.Data.Header)+ item.Data.Data + item.Data.PadData
+            TargetFv.Data.Data += GetFvData(TargetFv)
             TargetFv.Data.ModFvExt()
             TargetFv.Data.ModFvSize()
             TargetFv.Data.ModExtHeaderData()
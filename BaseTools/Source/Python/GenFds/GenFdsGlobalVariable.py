@@ -14,6 +14,8 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import hashlib
+import shutil
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
@@ -29,6 +31,7 @@ from AutoGen.BuildEngine import ToolBuildRule
 import Common.DataType as DataType
 from Common.Misc import PathClass,CreateDirectory
 from Common.LongFilePathSupport import OpenLongFilePath as open
+from Common.LongFilePathSupport import CopyLongFilePath
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 import Common.GlobalData as GlobalData
 from Common.BuildToolError import *
@@ -92,6 +95,18 @@ class GenFdsGlobalVariable:
     # FvName, FdName, CapName in FDF, Image file name
     ImageBinDict = {}
 
+    #
+    # The content cache of the section, FFS and FV images lives in
+    # FvDir + os.sep + 'Cache'. Each entry is named by the digest of a tool
+    # command and of the content of its input files, and keeps copies of the
+    # files that the command generated, so an image whose inputs have only been
+    # touched or regenerated with the same content is restored instead of being
+    # generated again. Up to ContentCacheDepth entries are kept for each output.
+    #
+    ContentCacheDepth = 2
+    FileDigestDict = {}
+    ToolDigestDict = {}
+
     ## LoadBuildRule
     #
     @staticmethod
@@ -432,6 +447,112 @@ class GenFdsGlobalVariable:
                 return True
         return False
 
+    ## Get the digest of the content of a file
+    #
+    #   @param  File            Path of the file
+    #
+    #   @retval string          The hex digest of the file content
+    #
+    @staticmethod
+    def GetFileDigest(File):
+        Stat = os.stat(File)
+        Key = (File, Stat.st_size, Stat.st_mtime)
+        Digest = GenFdsGlobalVariable.FileDigestDict.get(Key)
+        if Digest is None:
+            Hash = hashlib.sha256()
+            with open(File, 'rb') as Fd:
+                for Chunk in iter(lambda: Fd.read(0x100000), b''):
+                    Hash.update(Chunk)
+            Digest = Hash.hexdigest()
+            GenFdsGlobalVariable.FileDigestDict[Key] = Digest
+        return Digest
+
+    ## Get the digest of a tool command and of the content of its input files
+    #
+    #   The path, size and time stamp of the tool itself are part of the digest,
+    #   so a rebuilt tool does not reuse the images of the old one.
+    #
+    #   @param  Cmd             The tool command
+    #   @param  Input           Path list of input files
+    #
+    #   @retval string          The hex digest
+    #   @retval None            if any Input doesn't exist
+    #
+    @staticmethod
+    def GetContentDigest(Cmd, Input):
+        Tool = Cmd[0]
+        if Tool not in GenFdsGlobalVariable.ToolDigestDict:
+            ToolPath = shutil.which(Tool) if hasattr(shutil, 'which') else None
+            ToolDigest = Tool
+            if ToolPath:
+                Stat = os.stat(ToolPath)
+                ToolDigest = '%s %d %d' % (ToolPath, Stat.st_size, Stat.st_mtime)
+            GenFdsGlobalVariable.ToolDigestDict[Tool] = ToolDigest
+
+        Hash = hashlib.sha256()
+        Hash.update(GenFdsGlobalVariable.ToolDigestDict[Tool].encode('utf-8'))
+        Hash.update(' '.join(Cmd).encode('utf-8'))
+        for F in Input:
+            if not os.path.isfile(F):
+                return None
+            Hash.update(GenFdsGlobalVariable.GetFileDigest(F).encode('utf-8'))
+        return Hash.hexdigest()
+
+    ## Call an external tool unless the content cache holds its output
+    #
+    #   @param  Cmd             The tool command
+    #   @param  errorMess       The error message if the tool fails
+    #   @param  Output          Path of output file
+    #   @param  Input           Path list of input files
+    #   @param  returnValue     See CallExternalTool
+    #   @param  SideOutput      Path list of other files that the tool writes
+    #
+    @staticmethod
+    def CallCachedTool(Cmd, errorMess, Output, Input, returnValue=[], SideOutput=[]):
+        Digest = None
+        if GenFdsGlobalVariable.FvDir:
+            Digest = GenFdsGlobalVariable.GetContentDigest(Cmd, Input)
+        if Digest is None:
+            GenFdsGlobalVariable.CallExternalTool(Cmd, errorMess, returnValue)
+            return
+
+        CacheDir = os.path.join(GenFdsGlobalVariable.FvDir, 'Cache')
+        EntryDir = os.path.join(CacheDir, Digest)
+        Files = [Output] + list(SideOutput)
+        if os.path.isfile(os.path.join(EntryDir, '0')):
+            for Index, F in enumerate(Files):
+                if os.path.isfile(os.path.join(EntryDir, str(Index))):
+                    CopyLongFilePath(os.path.join(EntryDir, str(Index)), F)
+            GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s is restored from content cache %s" % (Output, Digest))
+            if returnValue != []:
+                returnValue[0] = 0
+            return
+
+        GenFdsGlobalVariable.CallExternalTool(Cmd, errorMess, returnValue)
+        if (returnValue != [] and returnValue[0] != 0) or not os.path.isfile(Output):
+            return
+
+        if not CreateDirectory(EntryDir):
+            return
+        for Index, F in enumerate(Files):
+            if os.path.isfile(F):
+                CopyLongFilePath(F, os.path.join(EntryDir, str(Index)))
+
+        #
+        # Drop the oldest entries of Output
+        #
+        IndexFile = os.path.join(CacheDir, hashlib.sha256(Output.encode('utf-8')).hexdigest() + '.txt')
+        DigestList = []
+        if os.path.isfile(IndexFile):
+            with open(IndexFile, 'r') as Fd:
+                DigestList = Fd.read().split()
+        if Digest in DigestList:
+            DigestList.remove(Digest)
+        DigestList.append(Digest)
+        for OldDigest in DigestList[:-GenFdsGlobalVariable.ContentCacheDepth]:
+            shutil.rmtree(os.path.join(CacheDir, OldDigest), ignore_errors=True)
+        SaveFileOnChange(IndexFile, '\n'.join(DigestList[-GenFdsGlobalVariable.ContentCacheDepth:]), False)
+
     @staticmethod
     def GenerateSection(Output, Input, Type=None, CompressionType=None, Guid=None,
                         GuidHdrLen=None, GuidAttr=[], Ui=None, Ver=None, InputAlign=[], BuildNumber=None, DummyFile=None, IsMakefile=False):
@@ -501,7 +622,7 @@ class GenFdsGlobalVariable:
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate section", Output, list(Input))
         else:
             Cmd += ("-o", Output)
             Cmd += Input
@@ -516,7 +637,7 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate section", Output, list(Input))
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -572,7 +693,7 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate FFS", Output, list(Input))
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -604,7 +725,16 @@ class GenFdsGlobalVariable:
         for I in Input:
             Cmd += ("-i", I)
 
-        GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FV")
+        #
+        # GenFv also writes the map file, the report file and the base addresses
+        # of the FV images inside the FV, so they are restored with Output.
+        #
+        CacheInput = Input + FfsList
+        SideOutput = [MapFile if MapFile else Output + '.map', Output + '.txt']
+        if AddressFile:
+            CacheInput = CacheInput + [AddressFile]
+            SideOutput.append(AddressFile)
+        GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate FV", Output, CacheInput, SideOutput=SideOutput)
 
     @staticmethod
     def GenerateFirmwareImage(Output, Input, Type="efi", SubType=None, Zero=False,
@@ -641,7 +771,7 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate firmware image")
+            GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate firmware image", Output, Input)
 
     @staticmethod
     def GenerateOptionRom(Output, EfiInput, BinaryInput, Compress=False, ClassCode=None,
@@ -684,7 +814,7 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate option rom")
+            GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to generate option rom", Output, InputList)
 
     @staticmethod
     def GuidTool(Output, Input, ToolPath, Options='', returnValue=[], IsMakefile=False):
@@ -700,7 +830,7 @@ class GenFdsGlobalVariable:
             if " ".join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                 GenFdsGlobalVariable.SecCmdList.append(" ".join(Cmd).strip())
         else:
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to call " + ToolPath, returnValue)
+            GenFdsGlobalVariable.CallCachedTool(Cmd, "Failed to call " + ToolPath, Output, Input, returnValue)
 
     @staticmethod
     def CallExternalTool (cmd, errorMess, returnValue=[]):
@@ -11,6 +11,7 @@
 import Common.LongFilePathOs as os
 import sys
 import re
+import shlex
 from io import BytesIO
 import codecs
 from optparse import OptionParser
@@ -499,10 +500,12 @@ def GenerateVfrBinSec(ModuleName, DebugDir, OutputFile):
 #
 # Using standard Python module optparse to parse command line option of this tool.
 #
+# @param  ArgList   The arguments to parse, or None for the command line
+#
 # @retval Options   A optparse.Values object containing the parsed options
 # @retval InputFile Path of file to be trimmed
 #
-def Options():
+def Options(ArgList=None):
     OptionList = [
         make_option("-s", "--source-code", dest="FileType", const="SourceCode", action="store_const",
                           help="The input file is preprocessed source code, including C or assembly code"),
@@ -528,6 +531,8 @@ def Options():
         make_option("--ModuleName", dest="ModuleName", help="The module's BASE_NAME"),
         make_option("--DebugDir", dest="DebugDir",
                           help="Debug Output directory to store the output files"),
+        make_option("--batch", dest="BatchFile",
+                          help="The input file lists the options and the input file of one trim job per line"),
         make_option("-v", "--verbose", dest="LogLevel", action="store_const", const=EdkLogger.VERBOSE,
                           help="Run verbosely"),
         make_option("-d", "--debug", dest="LogLevel", type="int",
@@ -538,16 +543,22 @@ def Options():
     ]
 
     # use clearer usage to override default usage message
-    UsageString = "%prog [-s|-r|-a|--Vfr-Uni-Offset] [-c] [-v|-d <debug_level>|-q] [-i <include_path_file>] [-o <output_file>] [--ModuleName <ModuleName>] [--DebugDir <DebugDir>] [<input_file>]"
+    UsageString = "%prog [-s|-r|-a|--Vfr-Uni-Offset] [-c] [-v|-d <debug_level>|-q] [-i <include_path_file>] [-o <output_file>] [--ModuleName <ModuleName>] [--DebugDir <DebugDir>] [--batch <batch_file>] [<input_file>]"
 
     Parser = OptionParser(description=__copyright__, version=__version__, option_list=OptionList, usage=UsageString)
     Parser.set_defaults(FileType="Vfr")
     Parser.set_defaults(ConvertHex=False)
     Parser.set_defaults(LogLevel=EdkLogger.INFO)
 
-    Options, Args = Parser.parse_args()
+    Options, Args = Parser.parse_args(ArgList)
 
     # error check
+    if Options.BatchFile:
+        if ArgList is not None:
+            EdkLogger.error("Trim", OPTION_NOT_SUPPORTED, "--batch is not allowed in a batch file", ExtraData=" ".join(ArgList))
+        if len(Args) > 0:
+            EdkLogger.error("Trim", OPTION_NOT_SUPPORTED, ExtraData=Parser.get_usage())
+        return Options, ''
     if Options.FileType == 'VfrOffsetBin':
         if len(Args) == 0:
             return Options, ''
@@ -561,6 +572,57 @@ def Options():
     InputFile = Args[0]
     return Options, InputFile
 
+## Read the trim jobs of a batch file
+#
+# Each line of the batch file holds the options and the input file of one
+# trim job, in the same form as the command line. Empty lines and lines
+# starting with '#' are ignored. Running all trim jobs of a module in one
+# process saves the Python start-up time of each of them.
+#
+# @param  BatchFile The path of the batch file
+#
+# @retval JobList   A list of (Options, InputFile) of the trim jobs
+#
+def GetBatchJobs(BatchFile):
+    try:
+        with open(BatchFile, 'r') as File:
+            Lines = File.readlines()
+    except:
+        EdkLogger.error("Trim", FILE_OPEN_FAILURE, ExtraData=BatchFile)
+
+    JobList = []
+    for Line in Lines:
+        Line = Line.strip()
+        if not Line or Line.startswith('#'):
+            continue
+        ArgList = [Arg.strip('"') for Arg in shlex.split(Line, posix=False)]
+        JobList.append(Options(ArgList))
+    return JobList
+
+## Run one trim job
+#
+# @param  CommandOptions    A optparse.Values object containing the options of the job
+# @param  InputFile         Path of file to be trimmed
+#
+def TrimFile(CommandOptions, InputFile):
+    del gIncludedAslFile[:]
+    if CommandOptions.FileType == "Vfr":
+        if CommandOptions.OutputFile is None:
+            CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
+        TrimPreprocessedVfr(InputFile, CommandOptions.OutputFile)
+    elif CommandOptions.FileType == "Asl":
+        if CommandOptions.OutputFile is None:
+            CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
+        TrimAslFile(InputFile, CommandOptions.OutputFile, CommandOptions.IncludePathFile,CommandOptions.AslDeps)
+    elif CommandOptions.FileType == "VfrOffsetBin":
+        GenerateVfrBinSec(CommandOptions.ModuleName, CommandOptions.DebugDir, CommandOptions.OutputFile)
+    elif CommandOptions.FileType == "Asm":
+        TrimAsmFile(InputFile, CommandOptions.OutputFile, CommandOptions.IncludePathFile)
+    else :
+        if CommandOptions.OutputFile is None:
+            CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
+        TrimPreprocessedFile(InputFile, CommandOptions.OutputFile, CommandOptions.ConvertHex, CommandOptions.TrimLong)
+
 ## Entrance method
 #
 # This method mainly dispatch specific methods per the command line options.
@@ -578,26 +640,15 @@ def Main():
             EdkLogger.SetLevel(CommandOptions.LogLevel + 1)
         else:
             EdkLogger.SetLevel(CommandOptions.LogLevel)
+        JobList = [(CommandOptions, InputFile)]
+        if CommandOptions.BatchFile:
+            JobList = GetBatchJobs(CommandOptions.BatchFile)
     except FatalError as X:
         return 1
 
     try:
-        if CommandOptions.FileType == "Vfr":
-            if CommandOptions.OutputFile is None:
-                CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
-            TrimPreprocessedVfr(InputFile, CommandOptions.OutputFile)
-        elif CommandOptions.FileType == "Asl":
-            if CommandOptions.OutputFile is None:
-                CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
-            TrimAslFile(InputFile, CommandOptions.OutputFile, CommandOptions.IncludePathFile,CommandOptions.AslDeps)
-        elif CommandOptions.FileType == "VfrOffsetBin":
-            GenerateVfrBinSec(CommandOptions.ModuleName, CommandOptions.DebugDir, CommandOptions.OutputFile)
-        elif CommandOptions.FileType == "Asm":
-            TrimAsmFile(InputFile, CommandOptions.OutputFile, CommandOptions.IncludePathFile)
-        else :
-            if CommandOptions.OutputFile is None:
-                CommandOptions.OutputFile = os.path.splitext(InputFile)[0] + '.iii'
-            TrimPreprocessedFile(InputFile, CommandOptions.OutputFile, CommandOptions.ConvertHex, CommandOptions.TrimLong)
+        for CommandOptions, InputFile in JobList:
+            TrimFile(CommandOptions, InputFile)
     except FatalError as X:
         import platform
         import traceback
@@ -258,7 +258,18 @@ class MetaFileParser(object):
             else:
                 self._Table = self._RawTable
                 self._PostProcessed = False
-                self.Start()
+                #
+                # The records of INF and DEC files only depend on the file
+                # content, so they are kept in an on-disk cache. The records
+                # of DSC files depend on the macros of the build.
+                #
+                if self._FileType not in (MODEL_FILE_INF, MODEL_FILE_DEC):
+                    self.Start()
+                elif self._RawTable.LoadCache():
+                    self._Finished = True
+                else:
+                    self.Start()
+                    self._RawTable.SaveCache()
     ## Data parser for the common format in different type of file
     #
     #   The common format in the meatfile is like
@@ -10,9 +10,14 @@
 #
 from __future__ import absolute_import
 import uuid
+import pickle
+from hashlib import md5
 
+import Common.LongFilePathOs as os
 import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
 from Common.BuildToolError import FORMAT_INVALID
+from Common.LongFilePathSupport import OpenLongFilePath as open
 
 from CommonDataClass.DataClass import MODEL_FILE_DSC, MODEL_FILE_DEC, MODEL_FILE_INF, \
                                       MODEL_FILE_OTHERS
@@ -23,6 +28,10 @@ class MetaFileTable():
     _ID_STEP_ = 1
     _ID_MAX_ = 99999999
 
+    # version of the on-disk cache of the table content
+    _CACHE_VERSION_ = 1
+    _CacheStamp = None
+
     ## Constructor
     def __init__(self, DB, MetaFile, FileType, Temporary, FromItem=None):
         self.MetaFile = MetaFile
@@ -61,6 +70,116 @@ class MetaFileTable():
     def SetEndFlag(self):
         self.CurrentContent.append(self._DUMMY_)
 
+    ## Get the version of the on-disk cache
+    #
+    # The time stamps of the parser and of the table code are part of the
+    # version, so the content parsed by other BaseTools is not used.
+    #
+    @staticmethod
+    def _GetCacheStamp():
+        if MetaFileTable._CacheStamp is None:
+            Dir = os.path.dirname(os.path.abspath(__file__))
+            MetaFileTable._CacheStamp = (MetaFileTable._CACHE_VERSION_,
+                                         os.stat(os.path.join(Dir, 'MetaFileParser.py'))[8],
+                                         os.stat(os.path.join(Dir, 'MetaFileTable.py'))[8])
+        return MetaFileTable._CacheStamp
+
+    ## Get the path of the on-disk cache of the table content
+    #
+    # The cache lives next to the build database, which is only known to the
+    # build tools that set an absolute GlobalData.gDatabasePath. It is not used
+    # with --check-usage, which checks the comments during parsing.
+    #
+    # @retval string    The path of the cache file
+    # @retval None      The on-disk cache is not used
+    #
+    def _GetCachePath(self):
+        if not os.path.isabs(GlobalData.gDatabasePath):
+            return None
+        if GlobalData.gOptions and getattr(GlobalData.gOptions, 'CheckUsage', False):
+            return None
+        return os.path.join(os.path.dirname(GlobalData.gDatabasePath), 'MetaFile',
+                            md5(self.MetaFile.Path.encode('utf-8')).hexdigest() + '.pickle')
+
+    def _GetFileHash(self):
+        with open(self.MetaFile.Path, 'rb') as File:
+            return md5(File.read()).hexdigest()
+
+    def _WriteCache(self, CachePath, Entry):
+        TempPath = '%s.%s.tmp' % (CachePath, uuid.uuid4().hex)
+        try:
+            if not os.path.exists(os.path.dirname(CachePath)):
+                os.makedirs(os.path.dirname(CachePath))
+            with open(TempPath, 'wb') as File:
+                pickle.dump(Entry, File, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempPath, CachePath)
+        except (OSError, pickle.PickleError) as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
+
+    ## Load the table content from the on-disk cache
+    #
+    # The cache matches if the size and time stamp of the meta file are the
+    # recorded ones, or if the content of the meta file has the recorded hash.
+    # The IDs of the records are moved to the ID range of this table.
+    #
+    # @retval True      The table content is loaded and complete
+    # @retval False     The cache has no content of the meta file
+    #
+    def LoadCache(self):
+        CachePath = self._GetCachePath()
+        if not CachePath or not os.path.exists(CachePath):
+            return False
+        try:
+            with open(CachePath, 'rb') as File:
+                Entry = pickle.load(File)
+            if Entry['Stamp'] != self._GetCacheStamp() or Entry['Path'] != self.MetaFile.Path:
+                return False
+            Stat = os.stat(self.MetaFile.Path)
+            if (Entry['Size'], Entry['TimeStamp']) != (Stat[6], Stat[8]):
+                if Entry['Hash'] != self._GetFileHash():
+                    return False
+                # Only the time stamp of the meta file has changed
+                Entry['Size'], Entry['TimeStamp'] = Stat[6], Stat[8]
+                self._WriteCache(CachePath, Entry)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
+            return False
+
+        Offset = self.FileId * 10**8 - Entry['BaseId']
+        self.CurrentContent = []
+        for Row in Entry['Content']:
+            Row = list(Row)
+            Row[0] += Offset
+            if Row[7] >= 0:
+                Row[7] += Offset
+            self.CurrentContent.append(Row)
+        self.ID = Entry['LastId'] + Offset
+        self.SetEndFlag()
+        return True
+
+    ## Save the complete table content in the on-disk cache
+    #
+    def SaveCache(self):
+        CachePath = self._GetCachePath()
+        if not CachePath or not self.IsIntegrity():
+            return
+        try:
+            Stat = os.stat(self.MetaFile.Path)
+            Entry = {
+                'Stamp'     : self._GetCacheStamp(),
+                'Path'      : self.MetaFile.Path,
+                'Size'      : Stat[6],
+                'TimeStamp' : Stat[8],
+                'Hash'      : self._GetFileHash(),
+                'BaseId'    : self.FileId * 10**8,
+                'LastId'    : self.ID,
+                'Content'   : [Row for Row in self.CurrentContent if Row[0] >= 0],
+            }
+        except OSError as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, str(Exc))
+            return
+        self._WriteCache(CachePath, Entry)
+
     def GetAll(self):
         return [item for item in self.CurrentContent if item[0] >= 0 and item[-1]>=0]
 
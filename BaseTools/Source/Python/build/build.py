@@ -43,6 +43,7 @@ from buildoptions import MyOptionParser
 from Common.Misc import PathClass,SaveFileOnChange,RemoveDirectory
 from Common.StringUtils import NormPath
 from Common.MultipleWorkspace import MultipleWorkspace as mws
+from Common.RemoteCache import IsRemoteCache, GetRemoteCache, DEFAULT_LOCAL_CACHE_SIZE
 from Common.BuildToolError import *
 from Common.DataType import *
 import Common.EdkLogger as EdkLogger
@@ -271,17 +272,26 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
 
         EdkLogger.error("build", COMMAND_FAILURE, ExtraData="%s [%s]" % (Command, WorkingDir))
     if ModuleAuto:
-        iau = IncludesAutoGen(WorkingDir,ModuleAuto)
-        if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
-            iau.CreateDepsFileForMsvc(Proc.ProcOut)
-        else:
-            iau.UpdateDepsFileforNonMsvc()
-        iau.UpdateDepsFileforTrim()
-        iau.CreateModuleDeps()
-        iau.CreateDepsInclude()
-        iau.CreateDepsTarget()
+        UpdateModuleDeps(WorkingDir, ModuleAuto, Proc.ProcOut)
     return "%dms" % (int(round((time.time() - BeginTime) * 1000)))
 
+## Update the dependency files of a module after it is built
+#
+#   @param  WorkingDir  The build directory of the module
+#   @param  ModuleAuto  The ModuleAutoGen object of the module
+#   @param  ProcOut     The output of the build command, used for MSFT tool chains
+#
+def UpdateModuleDeps(WorkingDir, ModuleAuto, ProcOut):
+    iau = IncludesAutoGen(WorkingDir,ModuleAuto)
+    if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
+        iau.CreateDepsFileForMsvc(ProcOut)
+    else:
+        iau.UpdateDepsFileforNonMsvc()
+    iau.UpdateDepsFileforTrim()
+    iau.CreateModuleDeps()
+    iau.CreateDepsInclude()
+    iau.CreateDepsTarget()
+
 ## The smallest unit that can be built in multi-thread build mode
 #
 # This is the base class of build unit. The "Obj" parameter must provide
@@ -747,6 +757,7 @@ class Build():
         GlobalData.gBinCacheDest   = BuildOptions.BinCacheDest
         GlobalData.gBinCacheSource = BuildOptions.BinCacheSource
         GlobalData.gEnableGenfdsMultiThread = not BuildOptions.NoGenfdsMultiThread
+        GlobalData.gUseNinja = BuildOptions.UseNinja
         GlobalData.gDisableIncludePathCheck = BuildOptions.DisableIncludePathCheck
 
         if GlobalData.gBinCacheDest and not GlobalData.gUseHashCache:
@@ -758,6 +769,24 @@ class Build():
         if GlobalData.gBinCacheDest and GlobalData.gBinCacheSource:
             EdkLogger.error("build", OPTION_NOT_SUPPORTED, ExtraData="--binary-destination can not be used together with --binary-source.")
 
+        #
+        # A remote binary cache is used through a local directory, which takes
+        # the place of the URL as the binary cache directory.
+        #
+        GlobalData.gBinCacheRemote = None
+        GlobalData.gBinCacheSize = BuildOptions.BinCacheSize if BuildOptions.BinCacheSize else DEFAULT_LOCAL_CACHE_SIZE
+        if IsRemoteCache(GlobalData.gBinCacheSource) or IsRemoteCache(GlobalData.gBinCacheDest):
+            GlobalData.gBinCacheRemote = GlobalData.gBinCacheSource if GlobalData.gBinCacheSource else GlobalData.gBinCacheDest
+            BinCacheDir = BuildOptions.BinCacheDir
+            if not BinCacheDir:
+                BinCacheDir = os.path.join(GlobalData.gConfDirectory, '.cache', 'BinaryCache')
+            if GlobalData.gBinCacheSource:
+                GlobalData.gBinCacheSource = BinCacheDir
+            else:
+                GlobalData.gBinCacheDest = BinCacheDir
+        elif BuildOptions.BinCacheDir:
+            EdkLogger.error("build", OPTION_NOT_SUPPORTED, ExtraData="--binary-cache-dir must be used together with the URL of --binary-source or --binary-destination.")
+
         if GlobalData.gBinCacheSource:
             BinCacheSource = os.path.normpath(GlobalData.gBinCacheSource)
             if not os.path.isabs(BinCacheSource):
@@ -776,6 +805,10 @@ class Build():
             if GlobalData.gBinCacheDest is not None:
                 EdkLogger.error("build", OPTION_VALUE_INVALID, ExtraData="Invalid value of option --binary-destination.")
 
+        if GlobalData.gBinCacheRemote:
+            # Start the remote cache now, so the upload includes every file written by this build
+            GetRemoteCache()
+
         GlobalData.gDatabasePath = os.path.normpath(os.path.join(GlobalData.gConfDirectory, GlobalData.gDatabasePath))
         if not os.path.exists(os.path.join(GlobalData.gConfDirectory, '.cache')):
             os.makedirs(os.path.join(GlobalData.gConfDirectory, '.cache'))
@@ -2288,9 +2321,15 @@ class Build():
                     EdkLogger.quiet("[cache Summary]: PreMakecache miss num: %s " % len(self.PreMakeCacheMiss))
                     EdkLogger.quiet("[cache Summary]: Makecache miss num: %s " % len(self.MakeCacheMiss))
 
+                # Modules built by ninja need no build task
+                if GlobalData.gUseNinja and self._NinjaBuild(Wa, Pa):
+                    MakeModules = set()
+                else:
+                    MakeModules = set(self.BuildModules)
+
                 for Arch in Wa.ArchList:
                     MakeStart = time.time()
-                    for Ma in set(self.BuildModules):
+                    for Ma in MakeModules:
                         # Generate build task for the module
                         if not Ma.IsBinaryModule:
                             Bt = BuildTask.New(ModuleMakeUnit(Ma, Pa.BuildCommand,self.Target))
@@ -2376,6 +2415,45 @@ class Build():
                     self._SaveMapFile(MapBuffer, Wa)
                 self.CreateGuidedSectionToolsFile(Wa)
 
+    ## Build the modules of the platform with one Ninja build file
+    #
+    #   @param  Wa      The WorkspaceAutoGen object
+    #   @param  Pa      The PlatformAutoGen object
+    #
+    #   @retval True    The modules are built by ninja
+    #   @retval False   The modules can not be built by ninja, and must be built by build tasks
+    #
+    def _NinjaBuild(self, Wa, Pa):
+        if self.Target not in [None, "", "all", "fds"]:
+            return False
+        for Ma in self.BuildModules:
+            if Ma.ToolChainFamily == TAB_COMPILER_MSFT:
+                # The header dependencies of MSFT tool chains are only known from the output of the build of each module
+                EdkLogger.warn("build", "--ninja is not supported by the %s tool chain family, modules are built without ninja." % TAB_COMPILER_MSFT)
+                return False
+        if not IsToolInPath("ninja"):
+            EdkLogger.error("build", FILE_NOT_FOUND, "ninja is not found in PATH", ExtraData="--ninja")
+
+        MakeStart = time.time()
+        NinjaFile = GenMake.NinjaBuildFile(Wa, self.BuildModules, Pa.BuildCommand)
+        NinjaFile.Generate()
+        EdkLogger.quiet("Building ... %s" % NinjaFile.FilePath)
+        try:
+            LaunchCommand(["ninja", "-f", NinjaFile.FilePath, "-j", str(self.ThreadNumber)], Wa.BuildDir)
+        finally:
+            #
+            # Update the dependency files of the modules that ninja has built,
+            # including the ones built before a failure.
+            #
+            for Ma in NinjaFile.ModuleList:
+                for Output in NinjaFile.GetModuleOutputs(Ma):
+                    if os.path.exists(Output) and os.path.getmtime(Output) >= int(MakeStart):
+                        UpdateModuleDeps(Ma.MakeFileDir, Ma, [])
+                        NinjaFile.SaveDependency(Ma, NinjaFile.MakefileName)
+                        break
+            self.MakeTime += int(round((time.time() - MakeStart)))
+        return True
+
     ## GetFreeSizeThreshold()
     #
     #   @retval int             Threshold value
@@ -2495,6 +2573,11 @@ class Build():
         if self.Target == 'cleanall':
             RemoveDirectory(os.path.dirname(GlobalData.gDatabasePath), True)
 
+        RemoteCache = GetRemoteCache()
+        if RemoteCache is not None:
+            RemoteCache.Trim()
+            RemoteCache.PrintSummary()
+
     def CreateAsBuiltInf(self):
         for Module in self.BuildModules:
             Module.CreateAsBuiltInf()
@@ -2504,6 +2587,9 @@ class Build():
             Module.GenPreMakefileHashList()
             Module.GenMakefileHashList()
             Module.CopyModuleToCache()
+        RemoteCache = GetRemoteCache()
+        if RemoteCache is not None:
+            RemoteCache.Upload()
 
     def GenLocalPreMakeCache(self):
         for Module in self.PreMakeCacheMiss:
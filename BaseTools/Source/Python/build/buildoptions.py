@@ -98,8 +98,11 @@ class MyOptionParser():
         Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
         Parser.add_option("-l", "--cmd-len", action="store", type="int", dest="CommandLength", help="Specify the maximum line length of build command. Default is 4096.")
         Parser.add_option("--hash", action="store_true", dest="UseHashCache", default=False, help="Enable hash-based caching during build process.")
-        Parser.add_option("--binary-destination", action="store", type="string", dest="BinCacheDest", help="Generate a cache of binary files in the specified directory.")
-        Parser.add_option("--binary-source", action="store", type="string", dest="BinCacheSource", help="Consume a cache of binary files from the specified directory.")
+        Parser.add_option("--binary-destination", action="store", type="string", dest="BinCacheDest", help="Generate a cache of binary files in the specified directory, or upload it to the specified HTTP or HTTPS URL.")
+        Parser.add_option("--binary-source", action="store", type="string", dest="BinCacheSource", help="Consume a cache of binary files from the specified directory, or download it from the specified HTTP or HTTPS URL.")
+        Parser.add_option("--binary-cache-dir", action="store", type="string", dest="BinCacheDir", help="Specify the local directory of a remote binary cache. Default is Conf/.cache/BinaryCache.")
+        Parser.add_option("--binary-cache-size", action="store", type="int", dest="BinCacheSize", help="Specify the size limit in MB of the local directory of a remote binary cache. Default is 8192.")
+        Parser.add_option("--ninja", action="store_true", dest="UseNinja", default=False, help="Generate a Ninja build file for all modules of the platform, and build them with ninja instead of the build scheduler.")
         Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
         Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
         Parser.add_option("--disable-include-path-check", action="store_true", dest="DisableIncludePathCheck", default=False, help="Disable the include path check for outside of package.")
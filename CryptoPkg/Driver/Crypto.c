@@ -2525,6 +2525,44 @@ CryptoServiceRsaFree (
   CALL_VOID_BASECRYPTLIB (Rsa.Services.Free, RsaFree, (RsaContext));
 }
 
+/**
+  Gets the RSA context of a public key from the RSA public key cache.
+
+  The RSA context of a public key is created on the first request for the
+  key, and kept for the next requests, along with the Montgomery context of
+  its modulus once it was used. The least recently used key is dropped from
+  the cache when there is no room left.
+
+  The returned RSA context is shared with the cache and the other callers, and
+  must not be modified with RsaSetKey(). It must be released with RsaFree().
+
+  If PublicModulus is NULL, then return NULL.
+  If PublicExponent is NULL, then return NULL.
+  If ModulusSize or ExponentSize is 0 or larger than INT_MAX, then return NULL.
+  If this interface is not supported, then return NULL, and the caller sets up
+  its own RSA context with RsaNew() and RsaSetKey().
+
+  @param[in]  PublicModulus    Pointer to the public modulus (N) octet string.
+  @param[in]  ModulusSize      Size of the public modulus in bytes.
+  @param[in]  PublicExponent   Pointer to the public exponent (e) octet string.
+  @param[in]  ExponentSize     Size of the public exponent in bytes.
+
+  @return  Pointer to the RSA context of the public key.
+           If the key cannot be set up, RsaGetCachedPublicKey() returns NULL.
+
+**/
+VOID *
+EFIAPI
+CryptoServiceRsaGetCachedPublicKey (
+  IN  CONST UINT8  *PublicModulus,
+  IN  UINTN        ModulusSize,
+  IN  CONST UINT8  *PublicExponent,
+  IN  UINTN        ExponentSize
+  )
+{
+  return CALL_BASECRYPTLIB (Rsa.Services.GetCachedPublicKey, RsaGetCachedPublicKey, (PublicModulus, ModulusSize, PublicExponent, ExponentSize), NULL);
+}
+
 /**
   Sets the tag-designated key component into the established RSA context.
 
@@ -6987,5 +7025,7 @@ const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   CryptoServiceX509VerifyCertChain,
   CryptoServiceX509GetCertFromCertChain,
   CryptoServiceAsn1GetTag,
-  CryptoServiceX509GetExtendedBasicConstraints
+  CryptoServiceX509GetExtendedBasicConstraints,
+  /// RSA (continued)
+  CryptoServiceRsaGetCachedPublicKey
 };
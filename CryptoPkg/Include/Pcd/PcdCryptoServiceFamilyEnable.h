@@ -158,6 +158,7 @@ typedef struct {
       UINT8    Pkcs1Verify          : 1;
       UINT8    GetPrivateKeyFromPem : 1;
       UINT8    GetPublicKeyFromX509 : 1;
+      UINT8    GetCachedPublicKey   : 1;
     } Services;
     UINT32    Family;
   } Rsa;
@@ -0,0 +1,183 @@
+/** @file
+  RSA public key cache over OpenSSL.
+
+  This file implements following APIs which provide the RSA public key cache:
+  1) RsaGetCachedPublicKey
+
+  The RSA contexts of the public keys verified against are kept for the
+  lifetime of the module. OpenSSL keeps the Montgomery context of the modulus
+  in the RSA context after its first public key operation, so the next
+  verifications against the same key skip the parsing of the key and the
+  set up of its Montgomery context.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+#include <openssl/bn.h>
+#include <openssl/rsa.h>
+
+#define RSA_KEY_CACHE_SIZE  8
+
+typedef struct {
+  UINT8     *Key;         // The public modulus followed by the public exponent.
+  UINTN     ModulusSize;
+  UINTN     ExponentSize;
+  RSA       *Rsa;
+  UINT64    Stamp;
+} RSA_KEY_CACHE_ENTRY;
+
+STATIC RSA_KEY_CACHE_ENTRY  mRsaKeyCache[RSA_KEY_CACHE_SIZE];
+STATIC UINT64               mRsaKeyCacheStamp;
+
+/**
+  Create the RSA context of a public key.
+
+  @param[in]  PublicModulus    Pointer to the public modulus (N) octet string.
+  @param[in]  ModulusSize      Size of the public modulus in bytes.
+  @param[in]  PublicExponent   Pointer to the public exponent (e) octet string.
+  @param[in]  ExponentSize     Size of the public exponent in bytes.
+
+  @return The RSA context, or NULL on failure.
+
+**/
+STATIC
+RSA *
+RsaKeyCacheCreateKey (
+  IN  CONST UINT8  *PublicModulus,
+  IN  UINTN        ModulusSize,
+  IN  CONST UINT8  *PublicExponent,
+  IN  UINTN        ExponentSize
+  )
+{
+  RSA     *Rsa;
+  BIGNUM  *BnN;
+  BIGNUM  *BnE;
+
+  Rsa = RSA_new ();
+  BnN = BN_bin2bn (PublicModulus, (UINT32)ModulusSize, NULL);
+  BnE = BN_bin2bn (PublicExponent, (UINT32)ExponentSize, NULL);
+  if ((Rsa == NULL) || (BnN == NULL) || (BnE == NULL) ||
+      (RSA_set0_key (Rsa, BnN, BnE, NULL) == 0))
+  {
+    BN_free (BnN);
+    BN_free (BnE);
+    RSA_free (Rsa);
+    return NULL;
+  }
+
+  return Rsa;
+}
+
+/**
+  Gets the RSA context of a public key from the RSA public key cache.
+
+  The RSA context of a public key is created on the first request for the
+  key, and kept for the next requests, along with the Montgomery context of
+  its modulus once it was used. The least recently used key is dropped from
+  the cache when there is no room left.
+
+  The returned RSA context is shared with the cache and the other callers, and
+  must not be modified with RsaSetKey(). It must be released with RsaFree().
+
+  If PublicModulus is NULL, then return NULL.
+  If PublicExponent is NULL, then return NULL.
+  If ModulusSize or ExponentSize is 0 or larger than INT_MAX, then return NULL.
+  If this interface is not supported, then return NULL, and the caller sets up
+  its own RSA context with RsaNew() and RsaSetKey().
+
+  @param[in]  PublicModulus    Pointer to the public modulus (N) octet string.
+  @param[in]  ModulusSize      Size of the public modulus in bytes.
+  @param[in]  PublicExponent   Pointer to the public exponent (e) octet string.
+  @param[in]  ExponentSize     Size of the public exponent in bytes.
+
+  @return  Pointer to the RSA context of the public key.
+           If the key cannot be set up, RsaGetCachedPublicKey() returns NULL.
+
+**/
+VOID *
+EFIAPI
+RsaGetCachedPublicKey (
+  IN  CONST UINT8  *PublicModulus,
+  IN  UINTN        ModulusSize,
+  IN  CONST UINT8  *PublicExponent,
+  IN  UINTN        ExponentSize
+  )
+{
+  RSA_KEY_CACHE_ENTRY  *Entry;
+  UINTN                Index;
+  UINT8                *Key;
+  RSA                  *Rsa;
+
+  //
+  // Check input parameters.
+  //
+  if ((PublicModulus == NULL) || (PublicExponent == NULL) ||
+      (ModulusSize == 0) || (ModulusSize > INT_MAX) ||
+      (ExponentSize == 0) || (ExponentSize > INT_MAX))
+  {
+    return NULL;
+  }
+
+  Entry = NULL;
+  for (Index = 0; Index < RSA_KEY_CACHE_SIZE; Index++) {
+    if ((mRsaKeyCache[Index].Rsa != NULL) &&
+        (mRsaKeyCache[Index].ModulusSize == ModulusSize) &&
+        (mRsaKeyCache[Index].ExponentSize == ExponentSize) &&
+        (CompareMem (mRsaKeyCache[Index].Key, PublicModulus, ModulusSize) == 0) &&
+        (CompareMem (mRsaKeyCache[Index].Key + ModulusSize, PublicExponent, ExponentSize) == 0))
+    {
+      Entry = &mRsaKeyCache[Index];
+      break;
+    }
+  }
+
+  if (Entry == NULL) {
+    Key = AllocatePool (ModulusSize + ExponentSize);
+    if (Key == NULL) {
+      return NULL;
+    }
+
+    Rsa = RsaKeyCacheCreateKey (PublicModulus, ModulusSize, PublicExponent, ExponentSize);
+    if (Rsa == NULL) {
+      FreePool (Key);
+      return NULL;
+    }
+
+    CopyMem (Key, PublicModulus, ModulusSize);
+    CopyMem (Key + ModulusSize, PublicExponent, ExponentSize);
+
+    //
+    // Replace the least recently used key. Its RSA context is only released
+    // once the callers still holding it released it too.
+    //
+    Entry = &mRsaKeyCache[0];
+    for (Index = 1; Index < RSA_KEY_CACHE_SIZE; Index++) {
+      if (mRsaKeyCache[Index].Stamp < Entry->Stamp) {
+        Entry = &mRsaKeyCache[Index];
+      }
+    }
+
+    if (Entry->Rsa != NULL) {
+      RSA_free (Entry->Rsa);
+      FreePool (Entry->Key);
+    }
+
+    Entry->Key          = Key;
+    Entry->ModulusSize  = ModulusSize;
+    Entry->ExponentSize = ExponentSize;
+    Entry->Rsa          = Rsa;
+  }
+
+  //
+  // The caller gets its own reference to the RSA context, released by RsaFree().
+  //
+  if (RSA_up_ref (Entry->Rsa) != 1) {
+    return NULL;
+  }
+
+  Entry->Stamp = ++mRsaKeyCacheStamp;
+  return (VOID *)Entry->Rsa;
+}
@@ -0,0 +1,34 @@
+/** @file
+  RSA public key cache Wrapper Null Implementation.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Gets the RSA context of a public key from the RSA public key cache.
+
+  Return NULL to indicate this interface is not supported.
+
+  @param[in]  PublicModulus    Pointer to the public modulus (N) octet string.
+  @param[in]  ModulusSize      Size of the public modulus in bytes.
+  @param[in]  PublicExponent   Pointer to the public exponent (e) octet string.
+  @param[in]  ExponentSize     Size of the public exponent in bytes.
+
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+RsaGetCachedPublicKey (
+  IN  CONST UINT8  *PublicModulus,
+  IN  UINTN        ModulusSize,
+  IN  CONST UINT8  *PublicExponent,
+  IN  UINTN        ExponentSize
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
@@ -24,6 +24,8 @@ OPENSSL_cpuid_setup (
 
   The constructor calls an internal OpenSSL function which fetches a local copy
   of the hardware capability flags, used to enable native crypto instructions.
+  The flags cannot be stored by a module that executes in place from flash, the
+  assembly code then takes its paths that need no CPU extension.
 
   @param  None
 
@@ -39,6 +39,50 @@ typedef struct {
   // Memory BIO for the TLS/SSL Writing operations.
   //
   BIO    *OutBio;
+  //
+  // Host name of the server, which keys the client session cache.
+  //
+  CHAR8  *HostName;
 } TLS_CONNECTION;
 
+//
+// Number of servers whose client session is kept for resumption.
+//
+#define TLS_SESSION_CACHE_SIZE  8
+
+/**
+  Enable the client session cache on a TLS context.
+
+  @param[in]  SslCtx    The SSL_CTX object.
+
+**/
+VOID
+TlsSessionCacheInit (
+  IN     SSL_CTX  *SslCtx
+  );
+
+/**
+  Offer the cached session of the server, if any, on a client connection that
+  is about to send its ClientHello.
+
+  @param[in]  TlsConn    The TLS connection.
+
+**/
+VOID
+TlsSessionCacheApply (
+  IN     TLS_CONNECTION  *TlsConn
+  );
+
+/**
+  Drop the cached session of the server a TLS connection goes to, after its
+  handshake failed.
+
+  @param[in]  TlsConn    The TLS connection.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN     TLS_CONNECTION  *TlsConn
+  );
+
 #endif
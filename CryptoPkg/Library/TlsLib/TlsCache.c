@@ -0,0 +1,219 @@
+/** @file
+  SSL/TLS client session cache over OpenSSL.
+
+  The sessions negotiated by the client connections are kept, per server host
+  name, for the lifetime of the module. A later connection to the same host
+  offers the cached session (a TLS 1.2 session ID or a TLS 1.3 ticket), and an
+  abbreviated handshake replaces the certificate exchange and the key agreement
+  when the server accepts it.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalTlsLib.h"
+
+typedef struct {
+  CHAR8          *HostName;
+  INTN           VerifyMode;
+  SSL_SESSION    *Session;
+  UINT64         Stamp;
+} TLS_SESSION_CACHE_ENTRY;
+
+STATIC TLS_SESSION_CACHE_ENTRY  mTlsSessionCache[TLS_SESSION_CACHE_SIZE];
+STATIC UINT64                   mTlsSessionStamp;
+
+/**
+  Release a cache entry.
+
+  @param[in]  Entry    The cache entry.
+
+**/
+STATIC
+VOID
+TlsSessionCacheFreeEntry (
+  IN     TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->Session != NULL) {
+    SSL_SESSION_free (Entry->Session);
+  }
+
+  if (Entry->HostName != NULL) {
+    FreePool (Entry->HostName);
+  }
+
+  ZeroMem (Entry, sizeof (TLS_SESSION_CACHE_ENTRY));
+}
+
+/**
+  Find the cache entry of the server a TLS connection goes to.
+
+  A session is only offered to a connection with the same peer verification
+  mode as the one that established it, so that a connection that verifies the
+  server never resumes a session negotiated without verification.
+
+  @param[in]  TlsConn    The TLS connection.
+
+  @return The cache entry, or NULL if there is none.
+
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheFind (
+  IN     TLS_CONNECTION  *TlsConn
+  )
+{
+  UINTN  Index;
+
+  if (TlsConn->HostName == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    if ((mTlsSessionCache[Index].HostName != NULL) &&
+        (mTlsSessionCache[Index].VerifyMode == SSL_get_verify_mode (TlsConn->Ssl)) &&
+        (AsciiStriCmp (mTlsSessionCache[Index].HostName, TlsConn->HostName) == 0))
+    {
+      return &mTlsSessionCache[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  OpenSSL callback invoked when a client connection receives a new session,
+  at the end of a TLS 1.2 full handshake or along with a TLS 1.3 ticket.
+
+  @param[in]  Ssl        The SSL connection.
+  @param[in]  Session    The new session.
+
+  @retval 1    The cache took the reference to Session.
+  @retval 0    The session is not cached.
+
+**/
+STATIC
+int
+TlsSessionCacheNewCallback (
+  SSL          *Ssl,
+  SSL_SESSION  *Session
+  )
+{
+  TLS_CONNECTION           *TlsConn;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  UINTN                    Index;
+  CHAR8                    *HostName;
+
+  TlsConn = (TLS_CONNECTION *)SSL_get_app_data (Ssl);
+  if ((TlsConn == NULL) || (TlsConn->HostName == NULL) || !SSL_SESSION_is_resumable (Session)) {
+    return 0;
+  }
+
+  //
+  // Replace the session of the same server, or the least recently used one.
+  //
+  Entry = TlsSessionCacheFind (TlsConn);
+  if (Entry == NULL) {
+    HostName = AllocateCopyPool (AsciiStrSize (TlsConn->HostName), TlsConn->HostName);
+    if (HostName == NULL) {
+      return 0;
+    }
+
+    Entry = &mTlsSessionCache[0];
+    for (Index = 1; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+      if (mTlsSessionCache[Index].Stamp < Entry->Stamp) {
+        Entry = &mTlsSessionCache[Index];
+      }
+    }
+
+    TlsSessionCacheFreeEntry (Entry);
+    Entry->HostName   = HostName;
+    Entry->VerifyMode = SSL_get_verify_mode (Ssl);
+  } else if (Entry->Session != NULL) {
+    SSL_SESSION_free (Entry->Session);
+  }
+
+  Entry->Session = Session;
+  Entry->Stamp   = ++mTlsSessionStamp;
+
+  return 1;
+}
+
+/**
+  Enable the client session cache on a TLS context.
+
+  @param[in]  SslCtx    The SSL_CTX object.
+
+**/
+VOID
+TlsSessionCacheInit (
+  IN     SSL_CTX  *SslCtx
+  )
+{
+  //
+  // The sessions are kept in mTlsSessionCache rather than in the context, which
+  // only lives as long as one TLS instance.
+  //
+  SSL_CTX_set_session_cache_mode (SslCtx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb (SslCtx, TlsSessionCacheNewCallback);
+}
+
+/**
+  Offer the cached session of the server, if any, on a client connection that
+  is about to send its ClientHello.
+
+  @param[in]  TlsConn    The TLS connection.
+
+**/
+VOID
+TlsSessionCacheApply (
+  IN     TLS_CONNECTION  *TlsConn
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  if (SSL_is_server (TlsConn->Ssl) || (SSL_get_session (TlsConn->Ssl) != NULL)) {
+    return;
+  }
+
+  Entry = TlsSessionCacheFind (TlsConn);
+  if ((Entry == NULL) || (Entry->Session == NULL)) {
+    return;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, Entry->Session) != 1) {
+    TlsSessionCacheFreeEntry (Entry);
+    return;
+  }
+
+  //
+  // A TLS 1.3 ticket should only be used once, the connection receives its own
+  // tickets once the handshake is done.
+  //
+  if (SSL_SESSION_get_protocol_version (Entry->Session) >= TLS1_3_VERSION) {
+    TlsSessionCacheFreeEntry (Entry);
+  } else {
+    Entry->Stamp = ++mTlsSessionStamp;
+  }
+}
+
+/**
+  Drop the cached session of the server a TLS connection goes to, after its
+  handshake failed.
+
+  @param[in]  TlsConn    The TLS connection.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN     TLS_CONNECTION  *TlsConn
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  Entry = TlsSessionCacheFind (TlsConn);
+  if (Entry != NULL) {
+    TlsSessionCacheFreeEntry (Entry);
+  }
+}
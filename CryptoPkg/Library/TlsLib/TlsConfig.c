@@ -596,6 +596,12 @@ TlsSetVerifyHost (
 
   SSL_set_hostflags (TlsConn->Ssl, Flags);
 
+  if (TlsConn->HostName != NULL) {
+    FreePool (TlsConn->HostName);
+  }
+
+  TlsConn->HostName = AllocateCopyPool (AsciiStrSize (HostName), HostName);
+
   VerifyParam = SSL_get0_param (TlsConn->Ssl);
   ASSERT (VerifyParam != NULL);
 
@@ -106,6 +106,11 @@ TlsCtxNew (
   //
   SSL_CTX_set_min_proto_version (TlsCtx, ProtoVersion);
 
+  //
+  // Resume the sessions of the servers connected before.
+  //
+  TlsSessionCacheInit (TlsCtx);
+
   return (VOID *)TlsCtx;
 }
 
@@ -138,6 +143,10 @@ TlsFree (
     SSL_free (TlsConn->Ssl);
   }
 
+  if (TlsConn->HostName != NULL) {
+    FreePool (TlsConn->HostName);
+  }
+
   OPENSSL_free (Tls);
 }
 
@@ -174,7 +183,8 @@ TlsNew (
     return NULL;
   }
 
-  TlsConn->Ssl = NULL;
+  TlsConn->Ssl      = NULL;
+  TlsConn->HostName = NULL;
 
   //
   // Create a new SSL Object
@@ -185,6 +195,11 @@ TlsNew (
     return NULL;
   }
 
+  //
+  // Let the session cache callback find the TLS connection.
+  //
+  SSL_set_app_data (TlsConn->Ssl, TlsConn);
+
   //
   // This retains compatibility with previous version of OpenSSL.
   //
@@ -105,6 +105,7 @@ TlsDoHandshake (
     PendingBufferSize = (UINTN)BIO_ctrl_pending (TlsConn->OutBio);
     if (PendingBufferSize == 0) {
       SSL_set_connect_state (TlsConn->Ssl);
+      TlsSessionCacheApply (TlsConn);
       Ret               = SSL_do_handshake (TlsConn->Ssl);
       PendingBufferSize = (UINTN)BIO_ctrl_pending (TlsConn->OutBio);
     }
@@ -150,6 +151,7 @@ TlsDoHandshake (
       }
 
       DEBUG_CODE_END ();
+      TlsSessionCacheRemove (TlsConn);
       return EFI_ABORTED;
     }
   }
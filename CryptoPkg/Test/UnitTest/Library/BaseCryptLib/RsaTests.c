@@ -300,6 +300,47 @@ TestVerifyRsaPkcs1SignVerify (
   return UNIT_TEST_PASSED;
 }
 
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyRsaCachedPublicKey (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8    HashValue[SHA1_DIGEST_SIZE];
+  VOID     *PublicKey;
+  VOID     *CachedPublicKey;
+  BOOLEAN  Status;
+
+  Status = Sha1HashAll (RsaSignData, AsciiStrLen (RsaSignData), HashValue);
+  UT_ASSERT_TRUE (Status);
+
+  PublicKey = RsaGetCachedPublicKey (RsaN, sizeof (RsaN), RsaE, sizeof (RsaE));
+  UT_ASSERT_NOT_NULL (PublicKey);
+
+  Status = RsaPkcs1Verify (PublicKey, HashValue, sizeof (HashValue), RsaPkcs1Signature, sizeof (RsaPkcs1Signature));
+  UT_ASSERT_TRUE (Status);
+
+  //
+  // The same key gets the same context, still usable after the first caller released it.
+  //
+  CachedPublicKey = RsaGetCachedPublicKey (RsaN, sizeof (RsaN), RsaE, sizeof (RsaE));
+  UT_ASSERT_EQUAL ((UINTN)CachedPublicKey, (UINTN)PublicKey);
+  RsaFree (PublicKey);
+
+  Status = RsaPkcs1Verify (CachedPublicKey, HashValue, sizeof (HashValue), RsaPkcs1Signature, sizeof (RsaPkcs1Signature));
+  UT_ASSERT_TRUE (Status);
+
+  HashValue[0] ^= 0xFF;
+  Status        = RsaPkcs1Verify (CachedPublicKey, HashValue, sizeof (HashValue), RsaPkcs1Signature, sizeof (RsaPkcs1Signature));
+  UT_ASSERT_FALSE (Status);
+  RsaFree (CachedPublicKey);
+
+  UT_ASSERT_TRUE (RsaGetCachedPublicKey (NULL, sizeof (RsaN), RsaE, sizeof (RsaE)) == NULL);
+  UT_ASSERT_TRUE (RsaGetCachedPublicKey (RsaN, sizeof (RsaN), RsaE, 0) == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
 TEST_DESC  mRsaTest[] = {
   //
   // -----Description--------------------------------------Class----------------------Function---------------------------------Pre---------------------Post---------Context
@@ -307,6 +348,7 @@ TEST_DESC  mRsaTest[] = {
   { "TestVerifyRsaSetGetKeyComponents()",   "CryptoPkg.BaseCryptLib.Rsa", TestVerifyRsaSetGetKeyComponents,   TestVerifyRsaPreReq, TestVerifyRsaCleanUp, NULL },
   { "TestVerifyRsaGenerateKeyComponents()", "CryptoPkg.BaseCryptLib.Rsa", TestVerifyRsaGenerateKeyComponents, TestVerifyRsaPreReq, TestVerifyRsaCleanUp, NULL },
   { "TestVerifyRsaPkcs1SignVerify()",       "CryptoPkg.BaseCryptLib.Rsa", TestVerifyRsaPkcs1SignVerify,       TestVerifyRsaPreReq, TestVerifyRsaCleanUp, NULL },
+  { "TestVerifyRsaCachedPublicKey()",       "CryptoPkg.BaseCryptLib.Rsa", TestVerifyRsaCachedPublicKey,       NULL,                NULL,                 NULL },
 };
 
 UINTN  mRsaTestNum = ARRAY_SIZE (mRsaTest);
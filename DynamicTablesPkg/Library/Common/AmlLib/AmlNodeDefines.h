@@ -48,6 +48,10 @@ typedef struct AmlRootNode {
 
   /// ACPI DSDT/SSDT header.
   EFI_ACPI_DESCRIPTION_HEADER    *SdtHeader;
+
+  /// Namespace index of the tree, built by the first search in the
+  /// namespace. NULL if not built.
+  struct AmlNameSpaceIndex       *NameSpaceIndex;
 } AML_ROOT_NODE;
 
 /** Root Node handle.
@@ -124,6 +124,71 @@ typedef struct AmlPathSearchContext {
   AML_NODE_HEADER    *OutNode;
 } AML_PATH_SEARCH_CONTEXT;
 
+/// Initial number of buckets of a namespace index. Must be a power of 2.
+#define AML_NAMESPACE_INDEX_MIN_BUCKETS  64U
+
+/** Entry of a namespace index.
+
+  There is one entry per raw AML absolute path found in the namespace.
+  Several namespace nodes can have the same path, e.g. a Device (\_SB.PCI0)
+  and a Scope (\_SB.PCI0) node.
+*/
+typedef struct AmlNameSpaceIndexEntry {
+  /// Next entry in the same bucket.
+  struct AmlNameSpaceIndexEntry    *Next;
+
+  /// Hash of the path.
+  UINT32                           Hash;
+
+  /// Number of namespace nodes having this path.
+  UINT32                           Count;
+
+  /// First namespace node having this path, in the AML bytestream order.
+  /// NULL if unknown. The tree is then enumerated by the next search.
+  AML_NODE_HEADER                  *Node;
+
+  /// Size of the path.
+  UINT32                           PathSize;
+
+  /// Raw AML absolute path, PathSize bytes long.
+  UINT8                            Path[1];
+} AML_NAMESPACE_INDEX_ENTRY;
+
+/** Namespace index of a tree.
+
+  Hash table mapping the raw AML absolute paths of the namespace nodes
+  of a tree to these nodes. It is built by the first search in the tree,
+  and is kept up to date when subtrees are attached to or detached from
+  the tree. Other modifications free it.
+*/
+typedef struct AmlNameSpaceIndex {
+  /// Buckets of the hash table.
+  AML_NAMESPACE_INDEX_ENTRY    **Buckets;
+
+  /// Number of buckets. This is a power of 2.
+  UINT32                       BucketCount;
+
+  /// Number of entries.
+  UINT32                       EntryCount;
+
+  /// Backward stream used to get the path of the nodes being indexed.
+  AML_STREAM                   PathBStream;
+
+  /// Buffer of the PathBStream.
+  UINT8                        PathBuffer[MAX_ASL_NAMESTRING_SIZE];
+} AML_NAMESPACE_INDEX;
+
+/** Context of the callback function adding nodes to a namespace index.
+*/
+typedef struct AmlNameSpaceIndexContext {
+  /// Namespace index to add the nodes to.
+  AML_NAMESPACE_INDEX    *Index;
+
+  /// TRUE if the whole tree is being indexed, i.e. the nodes are added
+  /// in the AML bytestream order.
+  BOOLEAN                InOrder;
+} AML_NAMESPACE_INDEX_CONTEXT;
+
 /** Return the first AML namespace node up in the parent hierarchy.
 
     Return the root node if no namespace node is found is the hierarchy.
@@ -1328,6 +1393,520 @@ exit_handler:
   return Status;
 }
 
+/** Compute the hash of a raw AML absolute path.
+
+  @param  [in]  Path      Raw AML absolute path.
+  @param  [in]  PathSize  Size of the path.
+
+  @return The FNV-1a hash of the path.
+**/
+STATIC
+UINT32
+EFIAPI
+AmlNameSpaceIndexHash (
+  IN  CONST UINT8   *Path,
+  IN        UINT32  PathSize
+  )
+{
+  UINT32  Hash;
+
+  Hash = 0x811C9DC5U;
+  while (PathSize-- > 0) {
+    Hash = (Hash ^ *Path++) * 0x01000193U;
+  }
+
+  return Hash;
+}
+
+/** Get the entry of a raw AML absolute path in a namespace index.
+
+  @param  [in]  Index     Pointer to a namespace index.
+  @param  [in]  Path      Raw AML absolute path.
+  @param  [in]  PathSize  Size of the path.
+
+  @return The entry of the path.
+          NULL if no namespace node has this path.
+**/
+STATIC
+AML_NAMESPACE_INDEX_ENTRY *
+EFIAPI
+AmlNameSpaceIndexGetEntry (
+  IN  CONST AML_NAMESPACE_INDEX  *Index,
+  IN  CONST UINT8                *Path,
+  IN        UINT32               PathSize
+  )
+{
+  AML_NAMESPACE_INDEX_ENTRY  *Entry;
+  UINT32                     Hash;
+
+  Hash  = AmlNameSpaceIndexHash (Path, PathSize);
+  Entry = Index->Buckets[Hash & (Index->BucketCount - 1)];
+  while (Entry != NULL) {
+    if ((Entry->Hash == Hash)         &&
+        (Entry->PathSize == PathSize) &&
+        (CompareMem (Entry->Path, Path, PathSize) == 0))
+    {
+      return Entry;
+    }
+
+    Entry = Entry->Next;
+  }
+
+  return NULL;
+}
+
+/** Free a namespace index.
+
+  @param  [in]  Index   Pointer to a namespace index.
+**/
+STATIC
+VOID
+EFIAPI
+AmlNameSpaceIndexFree (
+  IN  AML_NAMESPACE_INDEX  *Index
+  )
+{
+  AML_NAMESPACE_INDEX_ENTRY  *Entry;
+  AML_NAMESPACE_INDEX_ENTRY  *NextEntry;
+  UINT32                     Bucket;
+
+  for (Bucket = 0; Bucket < Index->BucketCount; Bucket++) {
+    for (Entry = Index->Buckets[Bucket]; Entry != NULL; Entry = NextEntry) {
+      NextEntry = Entry->Next;
+      FreePool (Entry);
+    }
+  }
+
+  FreePool (Index->Buckets);
+  FreePool (Index);
+}
+
+/** Double the number of buckets of a namespace index.
+
+  @param  [in]  Index   Pointer to a namespace index.
+
+  @retval EFI_SUCCESS             The function completed successfully.
+  @retval EFI_OUT_OF_RESOURCES    Could not allocate memory.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AmlNameSpaceIndexGrow (
+  IN  AML_NAMESPACE_INDEX  *Index
+  )
+{
+  AML_NAMESPACE_INDEX_ENTRY  **Buckets;
+  AML_NAMESPACE_INDEX_ENTRY  *Entry;
+  AML_NAMESPACE_INDEX_ENTRY  *NextEntry;
+  UINT32                     BucketCount;
+  UINT32                     Bucket;
+  UINT32                     NewBucket;
+
+  BucketCount = Index->BucketCount * 2;
+  Buckets     = AllocateZeroPool (BucketCount * sizeof (*Buckets));
+  if (Buckets == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Bucket = 0; Bucket < Index->BucketCount; Bucket++) {
+    for (Entry = Index->Buckets[Bucket]; Entry != NULL; Entry = NextEntry) {
+      NextEntry          = Entry->Next;
+      NewBucket          = Entry->Hash & (BucketCount - 1);
+      Entry->Next        = Buckets[NewBucket];
+      Buckets[NewBucket] = Entry;
+    }
+  }
+
+  FreePool (Index->Buckets);
+  Index->Buckets     = Buckets;
+  Index->BucketCount = BucketCount;
+
+  return EFI_SUCCESS;
+}
+
+/** Callback function adding a namespace node to a namespace index.
+
+  @param  [in]      Node      Pointer to the node being enumerated.
+  @param  [in, out] Context   A pointer to an AML_NAMESPACE_INDEX_CONTEXT.
+  @param  [in, out] Status    At entry, contains the status returned by the
+                              last call to this exact function during the
+                              enumeration.
+                              As exit, contains the returned status of the
+                              call to this function.
+                              Optional, can be NULL.
+
+  @retval TRUE if the enumeration can continue or has finished without
+          interruption.
+  @retval FALSE if the enumeration needs to stopped or has stopped.
+**/
+STATIC
+BOOLEAN
+EFIAPI
+AmlNameSpaceIndexAddCallback (
+  IN      AML_NODE_HEADER  *Node,
+  IN  OUT VOID             *Context,
+  IN  OUT EFI_STATUS       *Status   OPTIONAL
+  )
+{
+  EFI_STATUS                   Status1;
+  AML_NAMESPACE_INDEX_CONTEXT  *IndexContext;
+  AML_NAMESPACE_INDEX          *Index;
+  AML_NAMESPACE_INDEX_ENTRY    *Entry;
+  UINT8                        *Path;
+  UINT32                       PathSize;
+  UINT32                       Hash;
+  UINT32                       Bucket;
+
+  if (!AmlNodeHasAttribute (
+         (CONST AML_OBJECT_NODE *)Node,
+         AML_IN_NAMESPACE
+         ))
+  {
+    return TRUE;
+  }
+
+  IndexContext = (AML_NAMESPACE_INDEX_CONTEXT *)Context;
+  Index        = IndexContext->Index;
+
+  Status1 = AmlStreamReset (&Index->PathBStream);
+  if (!EFI_ERROR (Status1)) {
+    Status1 = AmlGetRawNameSpacePath (Node, 0, &Index->PathBStream);
+  }
+
+  if (EFI_ERROR (Status1)) {
+    goto exit_handler;
+  }
+
+  Path     = AmlStreamGetCurrPos (&Index->PathBStream);
+  PathSize = AmlStreamGetIndex (&Index->PathBStream);
+
+  Entry = AmlNameSpaceIndexGetEntry (Index, Path, PathSize);
+  if (Entry != NULL) {
+    // When the whole tree is indexed, nodes are added in the AML bytestream
+    // order and the entry already points to the first node with this path.
+    // Otherwise the first node is not known anymore.
+    Entry->Count++;
+    if (!IndexContext->InOrder) {
+      Entry->Node = NULL;
+    }
+
+    goto exit_handler;
+  }
+
+  Entry = AllocatePool (OFFSET_OF (AML_NAMESPACE_INDEX_ENTRY, Path) + PathSize);
+  if (Entry == NULL) {
+    Status1 = EFI_OUT_OF_RESOURCES;
+    goto exit_handler;
+  }
+
+  Hash            = AmlNameSpaceIndexHash (Path, PathSize);
+  Entry->Hash     = Hash;
+  Entry->Count    = 1;
+  Entry->Node     = Node;
+  Entry->PathSize = PathSize;
+  CopyMem (Entry->Path, Path, PathSize);
+
+  Bucket                 = Hash & (Index->BucketCount - 1);
+  Entry->Next            = Index->Buckets[Bucket];
+  Index->Buckets[Bucket] = Entry;
+  Index->EntryCount++;
+
+  if (Index->EntryCount > Index->BucketCount) {
+    Status1 = AmlNameSpaceIndexGrow (Index);
+  }
+
+exit_handler:
+  if (Status != NULL) {
+    *Status = Status1;
+  }
+
+  return !EFI_ERROR (Status1);
+}
+
+/** Callback function removing a namespace node from a namespace index.
+
+  @param  [in]      Node      Pointer to the node being enumerated.
+  @param  [in, out] Context   A pointer to an AML_NAMESPACE_INDEX.
+  @param  [in, out] Status    At entry, contains the status returned by the
+                              last call to this exact function during the
+                              enumeration.
+                              As exit, contains the returned status of the
+                              call to this function.
+                              Optional, can be NULL.
+
+  @retval TRUE if the enumeration can continue or has finished without
+          interruption.
+  @retval FALSE if the enumeration needs to stopped or has stopped.
+**/
+STATIC
+BOOLEAN
+EFIAPI
+AmlNameSpaceIndexRemoveCallback (
+  IN      AML_NODE_HEADER  *Node,
+  IN  OUT VOID             *Context,
+  IN  OUT EFI_STATUS       *Status   OPTIONAL
+  )
+{
+  EFI_STATUS                 Status1;
+  AML_NAMESPACE_INDEX        *Index;
+  AML_NAMESPACE_INDEX_ENTRY  *Entry;
+  AML_NAMESPACE_INDEX_ENTRY  **EntryLink;
+
+  if (!AmlNodeHasAttribute (
+         (CONST AML_OBJECT_NODE *)Node,
+         AML_IN_NAMESPACE
+         ))
+  {
+    return TRUE;
+  }
+
+  Index = (AML_NAMESPACE_INDEX *)Context;
+
+  Status1 = AmlStreamReset (&Index->PathBStream);
+  if (!EFI_ERROR (Status1)) {
+    Status1 = AmlGetRawNameSpacePath (Node, 0, &Index->PathBStream);
+  }
+
+  if (EFI_ERROR (Status1)) {
+    goto exit_handler;
+  }
+
+  Entry = AmlNameSpaceIndexGetEntry (
+            Index,
+            AmlStreamGetCurrPos (&Index->PathBStream),
+            AmlStreamGetIndex (&Index->PathBStream)
+            );
+  if (Entry == NULL) {
+    Status1 = EFI_NOT_FOUND;
+    goto exit_handler;
+  }
+
+  Entry->Count--;
+  if (Entry->Count != 0) {
+    // Removing a node does not reorder the other ones. The first node
+    // with this path is only unknown if it is the removed one.
+    if (Entry->Node == Node) {
+      Entry->Node = NULL;
+    }
+
+    goto exit_handler;
+  }
+
+  EntryLink = &Index->Buckets[Entry->Hash & (Index->BucketCount - 1)];
+  while (*EntryLink != Entry) {
+    EntryLink = &(*EntryLink)->Next;
+  }
+
+  *EntryLink = Entry->Next;
+  FreePool (Entry);
+  Index->EntryCount--;
+
+exit_handler:
+  if (Status != NULL) {
+    *Status = Status1;
+  }
+
+  return !EFI_ERROR (Status1);
+}
+
+/** Get the root node of the tree Node belongs to, if this tree has a
+    namespace index.
+
+  Contrary to AmlGetRootNode (), Node can be in a detached subtree.
+
+  @param  [in]  Node  Pointer to a node.
+
+  @return The root node of the tree.
+          NULL if Node is not in a tree or if the tree has no namespace index.
+**/
+STATIC
+AML_ROOT_NODE *
+EFIAPI
+AmlNameSpaceIndexGetRoot (
+  IN  CONST AML_NODE_HEADER  *Node
+  )
+{
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  while (Node->Parent != NULL) {
+    Node = Node->Parent;
+  }
+
+  if (!IS_AML_ROOT_NODE (Node)                            ||
+      (((AML_ROOT_NODE *)Node)->NameSpaceIndex == NULL))
+  {
+    return NULL;
+  }
+
+  return (AML_ROOT_NODE *)Node;
+}
+
+/** Get the namespace index of a tree, building it if needed.
+
+  @param  [in]  RootNode  Pointer to a root node.
+  @param  [out] Index     If success, contains the namespace index of the
+                          tree.
+
+  @retval EFI_SUCCESS             The function completed successfully.
+  @retval EFI_OUT_OF_RESOURCES    Could not allocate memory.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AmlNameSpaceIndexGet (
+  IN  AML_ROOT_NODE        *RootNode,
+  OUT AML_NAMESPACE_INDEX  **Index
+  )
+{
+  EFI_STATUS                   Status;
+  AML_NAMESPACE_INDEX          *NewIndex;
+  AML_NAMESPACE_INDEX_CONTEXT  IndexContext;
+
+  if (RootNode->NameSpaceIndex != NULL) {
+    *Index = RootNode->NameSpaceIndex;
+    return EFI_SUCCESS;
+  }
+
+  NewIndex = AllocateZeroPool (sizeof (AML_NAMESPACE_INDEX));
+  if (NewIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NewIndex->BucketCount = AML_NAMESPACE_INDEX_MIN_BUCKETS;
+  NewIndex->Buckets     = AllocateZeroPool (
+                            NewIndex->BucketCount * sizeof (*NewIndex->Buckets)
+                            );
+  if (NewIndex->Buckets == NULL) {
+    FreePool (NewIndex);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = AmlStreamInit (
+             &NewIndex->PathBStream,
+             NewIndex->PathBuffer,
+             sizeof (NewIndex->PathBuffer),
+             EAmlStreamDirectionBackward
+             );
+  if (EFI_ERROR (Status)) {
+    AmlNameSpaceIndexFree (NewIndex);
+    return Status;
+  }
+
+  IndexContext.Index   = NewIndex;
+  IndexContext.InOrder = TRUE;
+
+  Status = EFI_SUCCESS;
+  AmlEnumTree (
+    (AML_NODE_HEADER *)RootNode,
+    AmlNameSpaceIndexAddCallback,
+    (VOID *)&IndexContext,
+    &Status
+    );
+  if (EFI_ERROR (Status)) {
+    AmlNameSpaceIndexFree (NewIndex);
+    return Status;
+  }
+
+  RootNode->NameSpaceIndex = NewIndex;
+  *Index                   = NewIndex;
+
+  return EFI_SUCCESS;
+}
+
+/** Add the namespace nodes of a subtree to the namespace index of the tree
+    it has been attached to.
+
+  Nothing is done if the tree has no namespace index. If the nodes cannot
+  be added, the index is freed and rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to the root of the subtree, already attached.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexAddTree (
+  IN  AML_NODE_HEADER  *Node
+  )
+{
+  EFI_STATUS                   Status;
+  AML_ROOT_NODE                *RootNode;
+  AML_NAMESPACE_INDEX_CONTEXT  IndexContext;
+
+  RootNode = AmlNameSpaceIndexGetRoot (Node);
+  if (RootNode == NULL) {
+    return;
+  }
+
+  IndexContext.Index   = RootNode->NameSpaceIndex;
+  IndexContext.InOrder = FALSE;
+
+  Status = EFI_SUCCESS;
+  AmlEnumTree (Node, AmlNameSpaceIndexAddCallback, (VOID *)&IndexContext, &Status);
+  if (EFI_ERROR (Status)) {
+    AmlNameSpaceIndexInvalidate ((AML_NODE_HEADER *)RootNode);
+  }
+}
+
+/** Remove the namespace nodes of a subtree from the namespace index of the
+    tree it is about to be detached from.
+
+  Nothing is done if the tree has no namespace index. If the nodes cannot
+  be removed, the index is freed and rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to the root of the subtree, still attached.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexRemoveTree (
+  IN  AML_NODE_HEADER  *Node
+  )
+{
+  EFI_STATUS     Status;
+  AML_ROOT_NODE  *RootNode;
+
+  RootNode = AmlNameSpaceIndexGetRoot (Node);
+  if (RootNode == NULL) {
+    return;
+  }
+
+  Status = EFI_SUCCESS;
+  AmlEnumTree (
+    Node,
+    AmlNameSpaceIndexRemoveCallback,
+    (VOID *)RootNode->NameSpaceIndex,
+    &Status
+    );
+  if (EFI_ERROR (Status)) {
+    AmlNameSpaceIndexInvalidate ((AML_NODE_HEADER *)RootNode);
+  }
+}
+
+/** Free the namespace index of the tree Node belongs to.
+
+  This must be called before a modification of the tree that can change
+  the path of its namespace nodes, and which is not a subtree being added
+  or removed. The index is rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to a node of the tree, or its root node.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexInvalidate (
+  IN  AML_NODE_HEADER  *Node
+  )
+{
+  AML_ROOT_NODE  *RootNode;
+
+  RootNode = AmlNameSpaceIndexGetRoot (Node);
+  if (RootNode == NULL) {
+    return;
+  }
+
+  AmlNameSpaceIndexFree (RootNode->NameSpaceIndex);
+  RootNode->NameSpaceIndex = NULL;
+}
+
 /** Find a node in the AML namespace, given an ASL path and a reference Node.
 
    - The AslPath can be an absolute path, or a relative path from the
@@ -1379,8 +1958,10 @@ AmlFindNode (
 {
   EFI_STATUS  Status;
 
-  AML_PATH_SEARCH_CONTEXT  PathSearchContext;
-  AML_ROOT_NODE            *RootNode;
+  AML_PATH_SEARCH_CONTEXT    PathSearchContext;
+  AML_ROOT_NODE              *RootNode;
+  AML_NAMESPACE_INDEX        *Index;
+  AML_NAMESPACE_INDEX_ENTRY  *IndexEntry;
 
   // Backward stream used to build the raw AML absolute path to the searched
   // node.
@@ -1459,7 +2040,31 @@ AmlFindNode (
     goto exit_handler;
   }
 
-  // 4. Create a backward stream large enough to hold the current node path
+  // 4. Look the search path up in the namespace index of the tree. The
+  //    index is built by the first search. If the index is not available,
+  //    enumerate the tree.
+  IndexEntry = NULL;
+  if (!EFI_ERROR (AmlNameSpaceIndexGet (RootNode, &Index))) {
+    IndexEntry = AmlNameSpaceIndexGetEntry (
+                   Index,
+                   AmlStreamGetCurrPos (&RawAmlAbsSearchPathBStream),
+                   AmlStreamGetIndex (&RawAmlAbsSearchPathBStream)
+                   );
+    if (IndexEntry == NULL) {
+      Status = EFI_NOT_FOUND;
+      goto exit_handler;
+    }
+
+    // If several nodes have this path and the first one is not known,
+    // enumerate the tree to find it.
+    if (IndexEntry->Node != NULL) {
+      *OutNode = IndexEntry->Node;
+      Status   = EFI_SUCCESS;
+      goto exit_handler;
+    }
+  }
+
+  // 5. Create a backward stream large enough to hold the current node path
   //    during enumeration. This prevents from doing multiple allocation/free
   //    operations.
   RawAmlAbsCurrNodePathBufferSize = MAX_ASL_NAMESTRING_SIZE;
@@ -1483,7 +2088,7 @@ AmlFindNode (
     goto exit_handler;
   }
 
-  // 5. Fill a path search context structure with:
+  // 6. Fill a path search context structure with:
   //     - SearchPathStream: backward stream containing the raw absolute AML
   //       path to the searched node;
   //     - CurrNodePathStream: backward stream containing the raw absolute AML
@@ -1493,7 +2098,7 @@ AmlFindNode (
   PathSearchContext.CurrNodePathBStream = &RawAmlAbsCurrNodePathBStream;
   PathSearchContext.OutNode             = NULL;
 
-  // 6. Iterate through the namespace nodes of the tree.
+  // 7. Iterate through the namespace nodes of the tree.
   //    For each namespace node, build its raw AML absolute path. Then compare
   //    it with the search path.
   AmlEnumTree (
@@ -1512,6 +2117,10 @@ AmlFindNode (
     Status = EFI_NOT_FOUND;
   }
 
+  if (IndexEntry != NULL) {
+    IndexEntry->Node = *OutNode;
+  }
+
 exit_handler:
   // Free allocated memory.
   FreePool (RawAmlAbsSearchPathBuffer);
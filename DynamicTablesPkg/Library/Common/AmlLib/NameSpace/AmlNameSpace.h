@@ -12,6 +12,48 @@
 #include <AmlNodeDefines.h>
 #include <Stream/AmlStream.h>
 
+/** Add the namespace nodes of a subtree to the namespace index of the tree
+    it has been attached to.
+
+  Nothing is done if the tree has no namespace index. If the nodes cannot
+  be added, the index is freed and rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to the root of the subtree, already attached.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexAddTree (
+  IN  AML_NODE_HEADER  *Node
+  );
+
+/** Remove the namespace nodes of a subtree from the namespace index of the
+    tree it is about to be detached from.
+
+  Nothing is done if the tree has no namespace index. If the nodes cannot
+  be removed, the index is freed and rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to the root of the subtree, still attached.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexRemoveTree (
+  IN  AML_NODE_HEADER  *Node
+  );
+
+/** Free the namespace index of the tree Node belongs to.
+
+  This must be called before a modification of the tree that can change
+  the path of its namespace nodes, and which is not a subtree being added
+  or removed. The index is rebuilt by the next search.
+
+  @param  [in]  Node  Pointer to a node of the tree, or its root node.
+**/
+VOID
+EFIAPI
+AmlNameSpaceIndexInvalidate (
+  IN  AML_NODE_HEADER  *Node
+  );
+
 /** Return the first AML namespace node up in the parent hierarchy.
 
     Return the root node if no namespace node is found is the hierarchy.
@@ -190,29 +190,16 @@ AmlSerializeTree (
     return EFI_INVALID_PARAMETER;
   }
 
-  // Compute the total size of the AML blob.
-  Status = AmlComputeSize (
-             (CONST AML_NODE_HEADER *)RootNode,
-             &TableSize
-             );
-  if (EFI_ERROR (Status)) {
-    ASSERT (0);
-    return Status;
-  }
-
-  // Add the size of the ACPI header.
-  TableSize += (UINT32)sizeof (EFI_ACPI_DESCRIPTION_HEADER);
-
-  // Check the size against the SDT header.
-  // The Length field in the SDT Header is updated if the tree has
-  // been modified.
-  if (TableSize != RootNode->SdtHeader->Length) {
+  // The Length field in the SDT Header is updated each time the tree
+  // is modified, so there is no need to compute the size of the tree.
+  TableSize = RootNode->SdtHeader->Length;
+  if (TableSize < sizeof (EFI_ACPI_DESCRIPTION_HEADER)) {
     ASSERT (0);
     return EFI_INVALID_PARAMETER;
   }
 
   // Buffer is not big enough, or NULL.
-  if ((TableSize < *BufferSize) || (Buffer == NULL)) {
+  if ((*BufferSize < TableSize) || (Buffer == NULL)) {
     *BufferSize = TableSize;
     return EFI_SUCCESS;
   }
@@ -252,6 +239,15 @@ AmlSerializeTree (
     return Status;
   }
 
+  // Check the whole stream has been written, i.e. the size of the tree
+  // matches the SDT header.
+  if (AmlStreamGetIndex (&FStream) != TableSize) {
+    ASSERT (0);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *BufferSize = TableSize;
+
   // Update the checksum.
   return AcpiPlatformChecksum ((EFI_ACPI_DESCRIPTION_HEADER *)Buffer);
 }
@@ -288,21 +284,10 @@ AmlSerializeDefinitionBlock (
     return EFI_INVALID_PARAMETER;
   }
 
-  *Table      = NULL;
-  TableBuffer = NULL;
-  TableSize   = 0;
-
-  // Get the size of the SSDT table.
-  Status = AmlSerializeTree (
-             RootNode,
-             TableBuffer,
-             &TableSize
-             );
-  if (EFI_ERROR (Status)) {
-    ASSERT (0);
-    return Status;
-  }
+  *Table = NULL;
 
+  // The SDT header holds the size of the table.
+  TableSize   = RootNode->SdtHeader->Length;
   TableBuffer = (UINT8 *)AllocateZeroPool (TableSize);
   if (TableBuffer == NULL) {
     DEBUG ((
@@ -9,6 +9,7 @@
 #include <AmlNodeDefines.h>
 
 #include <AmlCoreInterface.h>
+#include <NameSpace/AmlNameSpace.h>
 #include <ResourceData/AmlResourceData.h>
 #include <String/AmlString.h>
 #include <Tree/AmlNode.h>
@@ -451,6 +452,11 @@ AmlUpdateDataNode (
         return Status;
       }
 
+      // The NameString can be the name of a namespace node.
+      if (AmlNodeHasAttribute (ParentNode, AML_IN_NAMESPACE)) {
+        AmlNameSpaceIndexInvalidate ((AML_NODE_HEADER *)ParentNode);
+      }
+
       break;
     }
     case EAmlNodeDataTypeString:
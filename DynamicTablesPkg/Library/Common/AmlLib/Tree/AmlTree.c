@@ -9,6 +9,7 @@
 #include <Tree/AmlTree.h>
 
 #include <AmlCoreInterface.h>
+#include <NameSpace/AmlNameSpace.h>
 #include <Tree/AmlNode.h>
 #include <Tree/AmlTreeTraversal.h>
 #include <Utils/AmlUtility.h>
@@ -177,6 +178,11 @@ AmlSetFixedArgument (
        IS_AML_OBJECT_NODE (NewNode)                                       ||
        IS_AML_DATA_NODE (NewNode)))
   {
+    // The fixed arguments of a namespace node hold its name.
+    if (AmlNodeHasAttribute (ObjectNode, AML_IN_NAMESPACE)) {
+      AmlNameSpaceIndexInvalidate ((AML_NODE_HEADER *)ObjectNode);
+    }
+
     ObjectNode->FixedArgs[Index] = NewNode;
 
     // If NewNode is a data node or an object node, set its parent.
@@ -264,6 +270,7 @@ AmlRemoveNodeFromVarArgList (
   }
 
   // Unlink Node from the tree.
+  AmlNameSpaceIndexRemoveTree (Node);
   RemoveEntryList (&Node->Link);
   InitializeListHead (&Node->Link);
   Node->Parent = NULL;
@@ -346,6 +353,7 @@ AmlVarListAddHead (
 
   InsertHeadList (ChildrenList, &NewNode->Link);
   NewNode->Parent = ParentNode;
+  AmlNameSpaceIndexAddTree (NewNode);
 
   // Get the size of the NewNode.
   Status = AmlComputeSize (NewNode, &NewSize);
@@ -404,6 +412,7 @@ AmlVarListAddTailInternal (
 
   InsertTailList (ChildrenList, &NewNode->Link);
   NewNode->Parent = ParentNode;
+  AmlNameSpaceIndexAddTree (NewNode);
 
   return EFI_SUCCESS;
 }
@@ -490,6 +499,7 @@ AmlVarListAddBefore (
   // Insert it before the input Node.
   InsertTailList (&Node->Link, &NewNode->Link);
   NewNode->Parent = ParentNode;
+  AmlNameSpaceIndexAddTree (NewNode);
 
   // Get the size of the NewNode.
   Status = AmlComputeSize (NewNode, &NewSize);
@@ -546,6 +556,7 @@ AmlVarListAddAfter (
   // Insert the new node after the input Node.
   InsertHeadList (&Node->Link, &NewNode->Link);
   NewNode->Parent = ParentNode;
+  AmlNameSpaceIndexAddTree (NewNode);
 
   // Get the size of the NewNode.
   Status = AmlComputeSize (NewNode, &NewSize);
@@ -863,6 +874,7 @@ AmlReplaceVariableArgument (
   }
 
   // Unlink OldNode from the tree.
+  AmlNameSpaceIndexRemoveTree (OldNode);
   NextLink = RemoveEntryList (&OldNode->Link);
   InitializeListHead (&OldNode->Link);
   OldNode->Parent = NULL;
@@ -870,6 +882,7 @@ AmlReplaceVariableArgument (
   // Add the NewNode.
   InsertHeadList (NextLink, &NewNode->Link);
   NewNode->Parent = ParentNode;
+  AmlNameSpaceIndexAddTree (NewNode);
 
   // Get the size of the OldNode.
   Status = AmlComputeSize (OldNode, &OldSize);
@@ -7,6 +7,71 @@ bbe
 
 #include "EmuBlockIo.h"
 
+/**
+  Signal the tokens of the non-blocking requests that the host has completed.
+
+  @param[in]  Event    The poll timer event.
+  @param[in]  Context  The EMU_BLOCK_IO_PRIVATE instance.
+
+**/
+VOID
+EFIAPI
+EmuBlockIoPollNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EMU_BLOCK_IO_PRIVATE  *Private;
+  EFI_BLOCK_IO2_TOKEN   *Token;
+
+  Private = (EMU_BLOCK_IO_PRIVATE *)Context;
+
+  while (!EFI_ERROR (Private->Io->Poll (Private->Io, &Token))) {
+    ASSERT (Private->PendingTokens != 0);
+    Private->PendingTokens--;
+    gBS->SignalEvent (Token->Event);
+  }
+
+  if (Private->PendingTokens == 0) {
+    gBS->SetTimer (Private->PollEvent, TimerCancel, 0);
+  }
+}
+
+/**
+  Account for a request passed to the host. A non-blocking request that was
+  queued successfully is signaled later by EmuBlockIoPollNotify().
+
+  Must be called at TPL_CALLBACK.
+
+  @param[in]  Private  The EMU_BLOCK_IO_PRIVATE instance.
+  @param[in]  Token    The token of the request.
+  @param[in]  Status   The status returned by the host.
+
+  @return Status.
+
+**/
+EFI_STATUS
+EmuBlockIoTrackToken (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN EFI_BLOCK_IO2_TOKEN   *Token,
+  IN EFI_STATUS            Status
+  )
+{
+  if (EFI_ERROR (Status) || (Token == NULL) || (Token->Event == NULL)) {
+    return Status;
+  }
+
+  if (Private->PendingTokens++ == 0) {
+    gBS->SetTimer (Private->PollEvent, TimerPeriodic, EMU_BLOCK_IO_POLL_INTERVAL);
+  }
+
+  //
+  // Requests the host completed synchronously are signaled right away.
+  //
+  EmuBlockIoPollNotify (Private->PollEvent, Private);
+  return Status;
+}
+
 /**
   Reset the block device hardware.
 
@@ -35,7 +100,11 @@ EmuBlockIo2Reset (
 
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
+  //
+  // The host waits for the requests in flight before resetting the device.
+  //
   Status = Private->Io->Reset (Private->Io, ExtendedVerification);
+  EmuBlockIoPollNotify (Private->PollEvent, Private);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -94,6 +163,7 @@ EmuBlockIo2ReadBlocksEx (
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
   Status = Private->Io->ReadBlocks (Private->Io, MediaId, LBA, Token, BufferSize, Buffer);
+  Status = EmuBlockIoTrackToken (Private, Token, Status);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -150,6 +220,7 @@ EmuBlockIo2WriteBlocksEx (
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
   Status = Private->Io->WriteBlocks (Private->Io, MediaId, LBA, Token, BufferSize, Buffer);
+  Status = EmuBlockIoTrackToken (Private, Token, Status);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -193,6 +264,7 @@ EmuBlockIo2Flush (
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
   Status = Private->Io->FlushBlocks (Private->Io, Token);
+  Status = EmuBlockIoTrackToken (Private, Token, Status);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -225,6 +297,7 @@ EmuBlockIoReset (
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
   Status = Private->Io->Reset (Private->Io, ExtendedVerification);
+  EmuBlockIoPollNotify (Private->PollEvent, Private);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -538,6 +611,19 @@ EmuBlockIoDriverBindingStart (
   Private->BlockIo2.FlushBlocksEx = EmuBlockIo2Flush;
 
   Private->ControllerNameTable = NULL;
+  Private->PendingTokens       = 0;
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  EmuBlockIoPollNotify,
+                  Private,
+                  &Private->PollEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    Private->PollEvent = NULL;
+    goto Done;
+  }
 
   Status = Private->Io->CreateMapping (Private->Io, &Private->Media);
   if (EFI_ERROR (Status)) {
@@ -576,6 +662,10 @@ Done:
         FreeUnicodeStringTable (Private->ControllerNameTable);
       }
 
+      if (Private->PollEvent != NULL) {
+        gBS->CloseEvent (Private->PollEvent);
+      }
+
       gBS->FreePool (Private);
     }
 
@@ -628,6 +718,7 @@ EmuBlockIoDriverBindingStop (
   EFI_BLOCK_IO_PROTOCOL  *BlockIo;
   EFI_STATUS             Status;
   EMU_BLOCK_IO_PRIVATE   *Private;
+  EFI_TPL                OldTpl;
 
   //
   // Get our context back
@@ -663,6 +754,14 @@ EmuBlockIoDriverBindingStop (
                     );
     ASSERT_EFI_ERROR (Status);
     //
+    // Signal the requests still in flight before the host goes away.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    Private->Io->Reset (Private->Io, FALSE);
+    EmuBlockIoPollNotify (Private->PollEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+    gBS->CloseEvent (Private->PollEvent);
+    //
     // Destroy the IO interface.
     //
     Status = Private->IoThunk->Close (Private->IoThunk);
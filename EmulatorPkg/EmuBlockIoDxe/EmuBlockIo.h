@@ -38,6 +38,12 @@ Abstract:
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// Period of the timer that signals the tokens of completed non-blocking
+// requests.
+//
+#define EMU_BLOCK_IO_POLL_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
 //
 // Language supported for driverconfiguration protocol
 //
@@ -53,6 +59,13 @@ typedef struct {
   EFI_BLOCK_IO2_PROTOCOL      BlockIo2;
   EFI_BLOCK_IO_MEDIA          Media;
 
+  //
+  // Non-blocking requests queued on the host and not signaled yet. The
+  // timer runs only while there are some.
+  //
+  EFI_EVENT                   PollEvent;
+  UINTN                       PendingTokens;
+
   EFI_UNICODE_STRING_TABLE    *ControllerNameTable;
 } EMU_BLOCK_IO_PRIVATE;
 
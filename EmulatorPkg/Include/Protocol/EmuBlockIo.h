@@ -163,6 +163,29 @@ EFI_STATUS
   IN     EFI_BLOCK_IO_MEDIA       *Media
   );
 
+/**
+  Retrieve a non-blocking request that has completed.
+
+  ReadBlocks(), WriteBlocks() and FlushBlocks() queue the request on the host
+  and return EFI_SUCCESS when Token->Event is not NULL. The host can't signal
+  EFI events, so the caller polls this function and signals Token->Event of
+  every token it returns.
+
+  @param[in]   This     Indicates a pointer to the calling context.
+  @param[out]  Token    Returns the token of the completed request, with
+                        TransactionStatus updated.
+
+  @retval EFI_SUCCESS    A request has completed and is returned in Token.
+  @retval EFI_NOT_READY  No queued request has completed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EMU_BLOCK_POLL)(
+  IN     EMU_BLOCK_IO_PROTOCOL    *This,
+  OUT    EFI_BLOCK_IO2_TOKEN      **Token
+  );
+
 ///
 ///  The Block I/O2 protocol defines an extension to the Block I/O protocol which
 ///  enables the ability to read and write data at a block level in a non-blocking
@@ -174,6 +197,7 @@ struct _EMU_BLOCK_IO_PROTOCOL  {
   EMU_BLOCK_WRITE             WriteBlocks;
   EMU_BLOCK_FLUSH             FlushBlocks;
   EMU_BLOCK_CREATE_MAPPING    CreateMapping;
+  EMU_BLOCK_POLL              Poll;
 };
 
 extern EFI_GUID  gEmuBlockIoProtocolGuid;
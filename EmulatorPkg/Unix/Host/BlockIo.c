@@ -7,6 +7,54 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Host.h"
 
+//
+// Depth of the io_uring submission queue used for non-blocking requests.
+//
+#define EMU_BLOCK_IO_URING_ENTRIES  64
+
+#define EMU_BLOCK_IO_OP_READ   0
+#define EMU_BLOCK_IO_OP_WRITE  1
+#define EMU_BLOCK_IO_OP_FLUSH  2
+
+//
+// A non-blocking request, from the time it is queued until the caller picks
+// up its token with Poll().
+//
+typedef struct _EMU_BLOCK_IO_REQUEST EMU_BLOCK_IO_REQUEST;
+struct _EMU_BLOCK_IO_REQUEST {
+  EMU_BLOCK_IO_REQUEST    *Next;
+  EFI_BLOCK_IO2_TOKEN     *Token;
+  BOOLEAN                 Write;
+  struct iovec            Iov;
+};
+
+ #ifdef EMU_BLOCK_IO_URING
+STATIC CONST UINT8  mEmuBlockIoRingOpcode[] = {
+  IORING_OP_READV,
+  IORING_OP_WRITEV,
+  IORING_OP_FSYNC
+};
+
+typedef struct {
+  int                    Fd;
+  UINT32                 Entries;
+  VOID                   *SqRing;
+  size_t                 SqRingSize;
+  VOID                   *CqRing;
+  size_t                 CqRingSize;
+  struct io_uring_sqe    *Sqes;
+  size_t                 SqesSize;
+  UINT32                 *SqHead;
+  UINT32                 *SqTail;
+  UINT32                 *SqMask;
+  UINT32                 *SqArray;
+  UINT32                 *CqHead;
+  UINT32                 *CqTail;
+  UINT32                 *CqMask;
+  struct io_uring_cqe    *Cqes;
+} EMU_IO_URING;
+ #endif
+
 #define EMU_BLOCK_IO_PRIVATE_SIGNATURE  SIGNATURE_32 ('E', 'M', 'b', 'k')
 typedef struct {
   UINTN                    Signature;
@@ -27,6 +75,19 @@ typedef struct {
 
   EMU_BLOCK_IO_PROTOCOL    EmuBlockIo;
   EFI_BLOCK_IO_MEDIA       *Media;
+
+  //
+  // Non-blocking requests. Requests reaped from the ring, or completed
+  // synchronously when the ring isn't available, wait on the completed list
+  // for Poll().
+  //
+  EMU_BLOCK_IO_REQUEST     *CompletedHead;
+  EMU_BLOCK_IO_REQUEST     *CompletedTail;
+  UINTN                    InFlight;
+ #ifdef EMU_BLOCK_IO_URING
+  EMU_IO_URING             Ring;
+  BOOLEAN                  RingFailed;
+ #endif
 } EMU_BLOCK_IO_PRIVATE;
 
 #define EMU_BLOCK_IO_PRIVATE_DATA_FROM_THIS(a) \
@@ -318,6 +379,427 @@ EmuBlockIoReadWriteCommon (
   return EFI_SUCCESS;
 }
 
+/**
+  Append a non-blocking request to the completed list.
+
+  @param  Private   The block device.
+  @param  Request   The request that has completed.
+  @param  Status    The status of the request.
+
+**/
+VOID
+EmuBlockIoCompleteRequest (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN EMU_BLOCK_IO_REQUEST  *Request,
+  IN EFI_STATUS            Status
+  )
+{
+  Request->Token->TransactionStatus = Status;
+  Request->Next                     = NULL;
+  if (Private->CompletedTail == NULL) {
+    Private->CompletedHead = Request;
+  } else {
+    Private->CompletedTail->Next = Request;
+  }
+
+  Private->CompletedTail = Request;
+}
+
+/**
+  Convert the result of a read, a write or a flush to an EFI status, and
+  update the media state the way the blocking path does.
+
+  @param  Private   The block device.
+  @param  Request   The request.
+  @param  Result    The number of bytes transferred, or -errno.
+
+  @return The status of the request.
+
+**/
+EFI_STATUS
+EmuBlockIoRequestStatus (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN EMU_BLOCK_IO_REQUEST  *Request,
+  IN ssize_t               Result
+  )
+{
+  if (Result < 0) {
+    errno = (int)-Result;
+    return EmuBlockIoError (Private);
+  }
+
+  if ((size_t)Result != Request->Iov.iov_len) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Private->Media->MediaPresent = TRUE;
+  if (Request->Write) {
+    Private->Media->ReadOnly = FALSE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+ #ifdef EMU_BLOCK_IO_URING
+
+/**
+  Set up the io_uring of a block device. The ring is mapped on the first
+  non-blocking request, so devices that are only used through Block I/O
+  never create one.
+
+  @param  Private   The block device.
+
+  @retval EFI_SUCCESS       The ring is ready.
+  @retval EFI_UNSUPPORTED   The host kernel doesn't provide io_uring.
+
+**/
+EFI_STATUS
+EmuBlockIoUringSetup (
+  IN EMU_BLOCK_IO_PRIVATE  *Private
+  )
+{
+  EMU_IO_URING            *Ring;
+  struct io_uring_params  Params;
+  UINT8                   *SqRing;
+  UINT8                   *CqRing;
+
+  Ring = &Private->Ring;
+  if (Ring->Fd >= 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (Private->RingFailed) {
+    return EFI_UNSUPPORTED;
+  }
+
+  memset (&Params, 0, sizeof (Params));
+  Ring->Fd = (int)syscall (__NR_io_uring_setup, EMU_BLOCK_IO_URING_ENTRIES, &Params);
+  if (Ring->Fd < 0) {
+    printf ("EmuBlockIo: io_uring is not available (%s), completing requests synchronously\n", strerror (errno));
+    Private->RingFailed = TRUE;
+    return EFI_UNSUPPORTED;
+  }
+
+  Ring->Entries    = Params.sq_entries;
+  Ring->SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof (UINT32);
+  Ring->CqRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof (struct io_uring_cqe);
+  Ring->SqesSize   = Params.sq_entries * sizeof (struct io_uring_sqe);
+  if ((Params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    Ring->SqRingSize = MAX (Ring->SqRingSize, Ring->CqRingSize);
+    Ring->CqRingSize = 0;
+  }
+
+  Ring->SqRing = mmap (NULL, Ring->SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_SQ_RING);
+  Ring->CqRing = MAP_FAILED;
+  Ring->Sqes   = MAP_FAILED;
+  if (Ring->SqRing == MAP_FAILED) {
+    goto Error;
+  }
+
+  if (Ring->CqRingSize == 0) {
+    Ring->CqRing = Ring->SqRing;
+  } else {
+    Ring->CqRing = mmap (NULL, Ring->CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_CQ_RING);
+    if (Ring->CqRing == MAP_FAILED) {
+      goto Error;
+    }
+  }
+
+  Ring->Sqes = mmap (NULL, Ring->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd, IORING_OFF_SQES);
+  if (Ring->Sqes == MAP_FAILED) {
+    goto Error;
+  }
+
+  SqRing        = Ring->SqRing;
+  CqRing        = Ring->CqRing;
+  Ring->SqHead  = (UINT32 *)(SqRing + Params.sq_off.head);
+  Ring->SqTail  = (UINT32 *)(SqRing + Params.sq_off.tail);
+  Ring->SqMask  = (UINT32 *)(SqRing + Params.sq_off.ring_mask);
+  Ring->SqArray = (UINT32 *)(SqRing + Params.sq_off.array);
+  Ring->CqHead  = (UINT32 *)(CqRing + Params.cq_off.head);
+  Ring->CqTail  = (UINT32 *)(CqRing + Params.cq_off.tail);
+  Ring->CqMask  = (UINT32 *)(CqRing + Params.cq_off.ring_mask);
+  Ring->Cqes    = (struct io_uring_cqe *)(CqRing + Params.cq_off.cqes);
+  return EFI_SUCCESS;
+
+Error:
+  printf ("EmuBlockIo: Could not map the io_uring: %s\n", strerror (errno));
+  if (Ring->Sqes != MAP_FAILED) {
+    munmap (Ring->Sqes, Ring->SqesSize);
+  }
+
+  if ((Ring->CqRing != MAP_FAILED) && (Ring->CqRingSize != 0)) {
+    munmap (Ring->CqRing, Ring->CqRingSize);
+  }
+
+  if (Ring->SqRing != MAP_FAILED) {
+    munmap (Ring->SqRing, Ring->SqRingSize);
+  }
+
+  close (Ring->Fd);
+  Ring->Fd            = -1;
+  Private->RingFailed = TRUE;
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Unmap and close the io_uring of a block device. No request may be in flight.
+
+  @param  Private   The block device.
+
+**/
+VOID
+EmuBlockIoUringTeardown (
+  IN EMU_BLOCK_IO_PRIVATE  *Private
+  )
+{
+  EMU_IO_URING  *Ring;
+
+  Ring = &Private->Ring;
+  if (Ring->Fd < 0) {
+    return;
+  }
+
+  munmap (Ring->Sqes, Ring->SqesSize);
+  if (Ring->CqRingSize != 0) {
+    munmap (Ring->CqRing, Ring->CqRingSize);
+  }
+
+  munmap (Ring->SqRing, Ring->SqRingSize);
+  close (Ring->Fd);
+  Ring->Fd = -1;
+}
+
+/**
+  Submit a request to the io_uring.
+
+  @param  Private   The block device.
+  @param  Request   The request to submit.
+  @param  Opcode    IORING_OP_READV, IORING_OP_WRITEV or IORING_OP_FSYNC.
+  @param  Offset    The byte offset on the device.
+
+  @retval EFI_SUCCESS           The request is in flight.
+  @retval EFI_OUT_OF_RESOURCES  The ring is full.
+  @retval EFI_DEVICE_ERROR      The kernel refused the request.
+
+**/
+EFI_STATUS
+EmuBlockIoUringSubmit (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN EMU_BLOCK_IO_REQUEST  *Request,
+  IN UINT8                 Opcode,
+  IN UINT64                Offset
+  )
+{
+  EMU_IO_URING         *Ring;
+  struct io_uring_sqe  *Sqe;
+  UINT32               Tail;
+  UINT32               Index;
+
+  Ring = &Private->Ring;
+
+  //
+  // The completion queue is twice as deep as the submission queue, so it
+  // can't overflow as long as the requests in flight fit in the latter.
+  //
+  if (Private->InFlight >= Ring->Entries) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Tail  = *Ring->SqTail;
+  Index = Tail & *Ring->SqMask;
+  Sqe   = &Ring->Sqes[Index];
+
+  memset (Sqe, 0, sizeof (*Sqe));
+  Sqe->opcode    = Opcode;
+  Sqe->fd        = Private->fd;
+  Sqe->off       = Offset;
+  Sqe->user_data = (UINT64)(UINTN)Request;
+  if (Opcode != IORING_OP_FSYNC) {
+    Sqe->addr = (UINT64)(UINTN)&Request->Iov;
+    Sqe->len  = 1;
+  }
+
+  Ring->SqArray[Index] = Index;
+  __atomic_store_n (Ring->SqTail, Tail + 1, __ATOMIC_RELEASE);
+
+  if (syscall (__NR_io_uring_enter, Ring->Fd, 1, 0, 0, NULL, 0) != 1) {
+    //
+    // Take the entry back; the kernel didn't consume it.
+    //
+    __atomic_store_n (Ring->SqTail, Tail, __ATOMIC_RELEASE);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Private->InFlight++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Move the requests that the kernel has completed to the completed list.
+
+  @param  Private   The block device.
+  @param  Wait      Wait for all the requests in flight when TRUE.
+
+**/
+VOID
+EmuBlockIoUringReap (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN BOOLEAN               Wait
+  )
+{
+  EMU_IO_URING          *Ring;
+  struct io_uring_cqe   *Cqe;
+  EMU_BLOCK_IO_REQUEST  *Request;
+  UINT32                Head;
+
+  Ring = &Private->Ring;
+  if ((Ring->Fd < 0) || (Private->InFlight == 0)) {
+    return;
+  }
+
+  do {
+    Head = *Ring->CqHead;
+    while (Head != __atomic_load_n (Ring->CqTail, __ATOMIC_ACQUIRE)) {
+      Cqe     = &Ring->Cqes[Head & *Ring->CqMask];
+      Request = (EMU_BLOCK_IO_REQUEST *)(UINTN)Cqe->user_data;
+      EmuBlockIoCompleteRequest (Private, Request, EmuBlockIoRequestStatus (Private, Request, Cqe->res));
+      Private->InFlight--;
+      Head++;
+    }
+
+    __atomic_store_n (Ring->CqHead, Head, __ATOMIC_RELEASE);
+
+    if (Wait && (Private->InFlight != 0)) {
+      syscall (__NR_io_uring_enter, Ring->Fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+  } while (Wait && (Private->InFlight != 0));
+}
+
+ #endif
+
+/**
+  Queue a non-blocking read, write or flush. The request goes to the io_uring
+  when the host has one; otherwise, or when the ring is full, it is carried
+  out right away and its token is delivered by the next Poll().
+
+  @param  Private     The block device.
+  @param  Token       The token of the request.
+  @param  Opcode      EMU_BLOCK_IO_OP_READ, EMU_BLOCK_IO_OP_WRITE or
+                      EMU_BLOCK_IO_OP_FLUSH.
+  @param  Offset      The byte offset on the device.
+  @param  Buffer      The data buffer.
+  @param  BufferSize  The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS           The request is queued.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be allocated.
+
+**/
+EFI_STATUS
+EmuBlockIoQueueRequest (
+  IN EMU_BLOCK_IO_PRIVATE  *Private,
+  IN EFI_BLOCK_IO2_TOKEN   *Token,
+  IN UINTN                 Opcode,
+  IN UINT64                Offset,
+  IN VOID                  *Buffer,
+  IN UINTN                 BufferSize
+  )
+{
+  EMU_BLOCK_IO_REQUEST  *Request;
+  ssize_t               Result;
+
+  Request = malloc (sizeof (EMU_BLOCK_IO_REQUEST));
+  if (Request == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Request->Token        = Token;
+  Request->Write        = (BOOLEAN)(Opcode == EMU_BLOCK_IO_OP_WRITE);
+  Request->Iov.iov_base = Buffer;
+  Request->Iov.iov_len  = BufferSize;
+
+ #ifdef EMU_BLOCK_IO_URING
+  if ((Private->fd >= 0) && !EFI_ERROR (EmuBlockIoUringSetup (Private))) {
+    if (!EFI_ERROR (EmuBlockIoUringSubmit (Private, Request, mEmuBlockIoRingOpcode[Opcode], Offset))) {
+      return EFI_SUCCESS;
+    }
+  }
+
+ #endif
+
+  switch (Opcode) {
+    case EMU_BLOCK_IO_OP_READ:
+      Result = pread (Private->fd, Buffer, BufferSize, (off_t)Offset);
+      break;
+
+    case EMU_BLOCK_IO_OP_WRITE:
+      Result = pwrite (Private->fd, Buffer, BufferSize, (off_t)Offset);
+      break;
+
+    default:
+      Result = 0;
+      if (Private->fd >= 0) {
+        Result = fsync (Private->fd);
+ #if __APPLE__
+        fcntl (Private->fd, F_FULLFSYNC);
+ #endif
+      }
+
+      break;
+  }
+
+  if (Result < 0) {
+    Result = -errno;
+  }
+
+  EmuBlockIoCompleteRequest (Private, Request, EmuBlockIoRequestStatus (Private, Request, Result));
+  return EFI_SUCCESS;
+}
+
+/**
+  Retrieve a non-blocking request that has completed.
+
+  @param[in]   This     Indicates a pointer to the calling context.
+  @param[out]  Token    Returns the token of the completed request, with
+                        TransactionStatus updated.
+
+  @retval EFI_SUCCESS    A request has completed and is returned in Token.
+  @retval EFI_NOT_READY  No queued request has completed.
+
+**/
+EFI_STATUS
+EmuBlockIoPoll (
+  IN     EMU_BLOCK_IO_PROTOCOL  *This,
+  OUT    EFI_BLOCK_IO2_TOKEN    **Token
+  )
+{
+  EMU_BLOCK_IO_PRIVATE  *Private;
+  EMU_BLOCK_IO_REQUEST  *Request;
+
+  Private = EMU_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
+
+ #ifdef EMU_BLOCK_IO_URING
+  if (Private->CompletedHead == NULL) {
+    EmuBlockIoUringReap (Private, FALSE);
+  }
+
+ #endif
+
+  Request = Private->CompletedHead;
+  if (Request == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  Private->CompletedHead = Request->Next;
+  if (Private->CompletedHead == NULL) {
+    Private->CompletedTail = NULL;
+  }
+
+  *Token = Request->Token;
+  free (Request);
+  return EFI_SUCCESS;
+}
+
 /**
   Read BufferSize bytes from Lba into Buffer.
 
@@ -369,32 +851,31 @@ EmuBlockIoReadBlocks (
 
   Status = EmuBlockIoReadWriteCommon (Private, MediaId, LBA, BufferSize, Buffer, "UnixReadBlocks");
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return Status;
+  }
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return EmuBlockIoQueueRequest (
+             Private,
+             Token,
+             EMU_BLOCK_IO_OP_READ,
+             MultU64x32 (LBA, Private->Media->BlockSize),
+             Buffer,
+             BufferSize
+             );
   }
 
   len = read (Private->fd, Buffer, BufferSize);
   if (len != BufferSize) {
     DEBUG ((DEBUG_INIT, "ReadBlocks: ReadFile failed.\n"));
-    Status = EmuBlockIoError (Private);
-    goto Done;
+    return EmuBlockIoError (Private);
   }
 
   //
   // If we read then media is present.
   //
   Private->Media->MediaPresent = TRUE;
-  Status                       = EFI_SUCCESS;
-
-Done:
-  if (Token != NULL) {
-    if (Token->Event != NULL) {
-      // Caller is responsible for signaling EFI Event
-      Token->TransactionStatus = Status;
-      return EFI_SUCCESS;
-    }
-  }
-
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -446,14 +927,24 @@ EmuBlockIoWriteBlocks (
 
   Status = EmuBlockIoReadWriteCommon (Private, MediaId, LBA, BufferSize, Buffer, "UnixWriteBlocks");
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return Status;
+  }
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return EmuBlockIoQueueRequest (
+             Private,
+             Token,
+             EMU_BLOCK_IO_OP_WRITE,
+             MultU64x32 (LBA, Private->Media->BlockSize),
+             Buffer,
+             BufferSize
+             );
   }
 
   len = write (Private->fd, Buffer, BufferSize);
   if (len != BufferSize) {
     DEBUG ((DEBUG_INIT, "ReadBlocks: WriteFile failed.\n"));
-    Status = EmuBlockIoError (Private);
-    goto Done;
+    return EmuBlockIoError (Private);
   }
 
   //
@@ -461,18 +952,7 @@ EmuBlockIoWriteBlocks (
   //
   Private->Media->MediaPresent = TRUE;
   Private->Media->ReadOnly     = FALSE;
-  Status                       = EFI_SUCCESS;
-
-Done:
-  if (Token != NULL) {
-    if (Token->Event != NULL) {
-      // Caller is responsible for signaling EFI Event
-      Token->TransactionStatus = Status;
-      return EFI_SUCCESS;
-    }
-  }
-
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -507,6 +987,10 @@ EmuBlockIoFlushBlocks (
 
   Private = EMU_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
 
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return EmuBlockIoQueueRequest (Private, Token, EMU_BLOCK_IO_OP_FLUSH, 0, NULL, 0);
+  }
+
   if (Private->fd >= 0) {
     fsync (Private->fd);
  #if __APPLE__
@@ -514,14 +998,6 @@ EmuBlockIoFlushBlocks (
  #endif
   }
 
-  if (Token != NULL) {
-    if (Token->Event != NULL) {
-      // Caller is responsible for signaling EFI Event
-      Token->TransactionStatus = EFI_SUCCESS;
-      return EFI_SUCCESS;
-    }
-  }
-
   return EFI_SUCCESS;
 }
 
@@ -548,6 +1024,14 @@ EmuBlockIoReset (
 
   Private = EMU_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
 
+ #ifdef EMU_BLOCK_IO_URING
+  //
+  // Don't close the file under the requests in flight. Their tokens stay on
+  // the completed list until the caller polls them.
+  //
+  EmuBlockIoUringReap (Private, TRUE);
+ #endif
+
   if (Private->fd >= 0) {
     close (Private->fd);
     Private->fd = -1;
@@ -585,7 +1069,8 @@ EMU_BLOCK_IO_PROTOCOL  gEmuBlockIoProtocol = {
   GasketEmuBlockIoReadBlocks,
   GasketEmuBlockIoWriteBlocks,
   GasketEmuBlockIoFlushBlocks,
-  GasketEmuBlockIoCreateMapping
+  GasketEmuBlockIoCreateMapping,
+  GasketEmuBlockIoPoll
 };
 
 EFI_STATUS
@@ -615,6 +1100,14 @@ EmuBlockIoThunkOpen (
   Private->fd        = -1;
   Private->BlockSize = 512;
 
+  Private->CompletedHead = NULL;
+  Private->CompletedTail = NULL;
+  Private->InFlight      = 0;
+ #ifdef EMU_BLOCK_IO_URING
+  Private->Ring.Fd    = -1;
+  Private->RingFailed = FALSE;
+ #endif
+
   Private->Filename = StdDupUnicodeToAscii (This->ConfigString);
   if (Private->Filename == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -662,6 +1155,16 @@ EmuBlockIoThunkClose (
   Private = This->Private;
 
   if (This->Private != NULL) {
+    EmuBlockIoReset (&Private->EmuBlockIo, FALSE);
+ #ifdef EMU_BLOCK_IO_URING
+    EmuBlockIoUringTeardown (Private);
+ #endif
+    while (Private->CompletedHead != NULL) {
+      Private->CompletedTail = Private->CompletedHead;
+      Private->CompletedHead = Private->CompletedHead->Next;
+      free (Private->CompletedTail);
+    }
+
     if (Private->Filename != NULL) {
       free (Private->Filename);
     }
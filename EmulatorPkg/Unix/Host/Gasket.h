@@ -479,6 +479,13 @@ GasketEmuBlockIoCreateMapping (
   IN     EFI_BLOCK_IO_MEDIA     *Media
   );
 
+EFI_STATUS
+EFIAPI
+GasketEmuBlockIoPoll (
+  IN     EMU_BLOCK_IO_PROTOCOL  *This,
+  OUT    EFI_BLOCK_IO2_TOKEN    **Token
+  );
+
 EFI_STATUS
 EFIAPI
 GasketBlockIoThunkOpen (
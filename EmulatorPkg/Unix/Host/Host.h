@@ -69,6 +69,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   #include <termio.h>
   #include <sys/vfs.h>
   #include <linux/fs.h>
+  #if __has_include (<linux/io_uring.h>)
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <linux/io_uring.h>
+#define EMU_BLOCK_IO_URING  1
+  #endif
 #endif
 
 #include <utime.h>
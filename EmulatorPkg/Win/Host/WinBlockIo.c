@@ -7,6 +7,20 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "WinHost.h"
 
+//
+// A non-blocking request, from the time it is queued until the caller picks
+// up its token with Poll(). Overlapped must be first; the completion port
+// returns a pointer to it.
+//
+typedef struct _WIN_NT_BLOCK_IO_REQUEST WIN_NT_BLOCK_IO_REQUEST;
+struct _WIN_NT_BLOCK_IO_REQUEST {
+  OVERLAPPED                 Overlapped;
+  WIN_NT_BLOCK_IO_REQUEST    *Next;
+  EFI_BLOCK_IO2_TOKEN        *Token;
+  BOOLEAN                    Write;
+  DWORD                      Length;
+};
+
 #define WIN_NT_BLOCK_IO_PRIVATE_SIGNATURE  SIGNATURE_32 ('N', 'T', 'b', 'k')
 typedef struct {
   UINTN                    Signature;
@@ -22,6 +36,18 @@ typedef struct {
 
   EFI_BLOCK_IO_MEDIA       *Media;
   EMU_BLOCK_IO_PROTOCOL    EmuBlockIo;
+
+  //
+  // Non-blocking requests go through a second handle, opened for overlapped
+  // I/O and bound to a completion port. Requests completed synchronously
+  // wait on the completed list for Poll().
+  //
+  HANDLE                     AsyncHandle;
+  HANDLE                     CompletionPort;
+  BOOLEAN                    AsyncFailed;
+  UINTN                      InFlight;
+  WIN_NT_BLOCK_IO_REQUEST    *CompletedHead;
+  WIN_NT_BLOCK_IO_REQUEST    *CompletedTail;
 } WIN_NT_BLOCK_IO_PRIVATE;
 
 #define WIN_NT_BLOCK_IO_PRIVATE_DATA_FROM_THIS(a) \
@@ -225,21 +251,269 @@ Returns:
   return Status;
 }
 
+/**
+  Append a non-blocking request to the completed list.
+
+  @param  Private   The block device.
+  @param  Request   The request that has completed.
+  @param  Status    The status of the request.
+
+**/
+VOID
+WinNtBlockIoCompleteRequest (
+  IN WIN_NT_BLOCK_IO_PRIVATE  *Private,
+  IN WIN_NT_BLOCK_IO_REQUEST  *Request,
+  IN EFI_STATUS               Status
+  )
+{
+  Request->Token->TransactionStatus = Status;
+  Request->Next                     = NULL;
+  if (Private->CompletedTail == NULL) {
+    Private->CompletedHead = Request;
+  } else {
+    Private->CompletedTail->Next = Request;
+  }
+
+  Private->CompletedTail = Request;
+}
+
+/**
+  Open the overlapped handle of a block device and bind it to a completion
+  port. This is done on the first non-blocking request, so devices that are
+  only used through Block I/O never open one.
+
+  @param  Private   The block device.
+
+  @retval EFI_SUCCESS       The overlapped handle is ready.
+  @retval EFI_UNSUPPORTED   The file can't be opened for overlapped I/O.
+
+**/
 EFI_STATUS
-WinNtSignalToken (
-  IN OUT EFI_BLOCK_IO2_TOKEN  *Token,
-  IN     EFI_STATUS           Status
+WinNtBlockIoOpenAsync (
+  IN WIN_NT_BLOCK_IO_PRIVATE  *Private
   )
 {
-  if (Token != NULL) {
-    if (Token->Event != NULL) {
-      // Caller is responcible for signaling EFI Event
-      Token->TransactionStatus = Status;
+  if (Private->AsyncHandle != INVALID_HANDLE_VALUE) {
+    return EFI_SUCCESS;
+  }
+
+  if (Private->AsyncFailed) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Private->AsyncHandle = CreateFile (
+                           Private->FileName,
+                           GENERIC_READ | (Private->Readonly ? 0 : GENERIC_WRITE),
+                           FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL,
+                           OPEN_EXISTING,
+                           FILE_FLAG_OVERLAPPED,
+                           NULL
+                           );
+  if (Private->AsyncHandle == INVALID_HANDLE_VALUE) {
+    DEBUG ((DEBUG_INFO, "OpenBlock: Could not open %S for overlapped I/O, %x\n", Private->FileName, GetLastError ()));
+    Private->AsyncFailed = TRUE;
+    return EFI_UNSUPPORTED;
+  }
+
+  Private->CompletionPort = CreateIoCompletionPort (Private->AsyncHandle, NULL, 0, 1);
+  if (Private->CompletionPort == NULL) {
+    CloseHandle (Private->AsyncHandle);
+    Private->AsyncHandle = INVALID_HANDLE_VALUE;
+    Private->AsyncFailed = TRUE;
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Move the requests that have completed on the completion port to the
+  completed list.
+
+  @param  Private   The block device.
+  @param  Wait      Wait for all the requests in flight when TRUE.
+
+**/
+VOID
+WinNtBlockIoReap (
+  IN WIN_NT_BLOCK_IO_PRIVATE  *Private,
+  IN BOOLEAN                  Wait
+  )
+{
+  WIN_NT_BLOCK_IO_REQUEST  *Request;
+  LPOVERLAPPED             Overlapped;
+  ULONG_PTR                Key;
+  DWORD                    Bytes;
+  BOOL                     Success;
+  EFI_STATUS               Status;
+
+  while (Private->InFlight != 0) {
+    Success = GetQueuedCompletionStatus (Private->CompletionPort, &Bytes, &Key, &Overlapped, Wait ? INFINITE : 0);
+    if (Overlapped == NULL) {
+      break;
+    }
+
+    Request = (WIN_NT_BLOCK_IO_REQUEST *)Overlapped;
+    Private->InFlight--;
+
+    if (!Success) {
+      //
+      // This may reset the device, which reaps the rest of the requests.
+      //
+      Status = WinNtBlockIoError (Private);
+    } else if (Bytes != Request->Length) {
+      Status = EFI_DEVICE_ERROR;
+    } else {
+      Private->Media->MediaPresent = TRUE;
+      if (Request->Write) {
+        Private->Media->ReadOnly = FALSE;
+      }
+
+      Status = EFI_SUCCESS;
+    }
+
+    WinNtBlockIoCompleteRequest (Private, Request, Status);
+  }
+}
+
+/**
+  Queue a non-blocking read, write or flush. Reads and writes are issued on
+  the overlapped handle when it is available; otherwise, and for flushes, the
+  request is carried out right away and its token is delivered by the next
+  Poll().
+
+  @param  Private     The block device.
+  @param  Token       The token of the request.
+  @param  Write       TRUE for a write, FALSE for a read.
+  @param  Flush       TRUE for a flush. Offset, Buffer and BufferSize are
+                      ignored.
+  @param  Offset      The byte offset on the device.
+  @param  Buffer      The data buffer.
+  @param  BufferSize  The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS           The request is queued.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be allocated.
+  @retval Others                The request could not be issued.
+
+**/
+EFI_STATUS
+WinNtBlockIoQueueRequest (
+  IN WIN_NT_BLOCK_IO_PRIVATE  *Private,
+  IN EFI_BLOCK_IO2_TOKEN      *Token,
+  IN BOOLEAN                  Write,
+  IN BOOLEAN                  Flush,
+  IN UINT64                   Offset,
+  IN VOID                     *Buffer,
+  IN UINTN                    BufferSize
+  )
+{
+  WIN_NT_BLOCK_IO_REQUEST  *Request;
+  BOOL                     Success;
+  DWORD                    Bytes;
+  EFI_STATUS               Status;
+
+  Request = AllocateZeroPool (sizeof (WIN_NT_BLOCK_IO_REQUEST));
+  if (Request == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Request->Token  = Token;
+  Request->Write  = Write;
+  Request->Length = (DWORD)BufferSize;
+
+  if (Flush) {
+    if (Private->NtHandle != INVALID_HANDLE_VALUE) {
+      FlushFileBuffers (Private->NtHandle);
+    }
+
+    WinNtBlockIoCompleteRequest (Private, Request, EFI_SUCCESS);
+    return EFI_SUCCESS;
+  }
+
+  if (!EFI_ERROR (WinNtBlockIoOpenAsync (Private))) {
+    Request->Overlapped.Offset     = (DWORD)Offset;
+    Request->Overlapped.OffsetHigh = (DWORD)RShiftU64 (Offset, 32);
+    if (Write) {
+      Success = WriteFile (Private->AsyncHandle, Buffer, Request->Length, NULL, &Request->Overlapped);
+    } else {
+      Success = ReadFile (Private->AsyncHandle, Buffer, Request->Length, NULL, &Request->Overlapped);
+    }
+
+    //
+    // Even a request that completes right away posts a completion packet.
+    //
+    if (Success || (GetLastError () == ERROR_IO_PENDING)) {
+      Private->InFlight++;
       return EFI_SUCCESS;
     }
+
+    Status = WinNtBlockIoError (Private);
+    FreePool (Request);
+    return Status;
   }
 
-  return Status;
+  Status = SetFilePointer64 (Private, Offset, NULL, FILE_BEGIN);
+  if (!EFI_ERROR (Status)) {
+    if (Write) {
+      Success = WriteFile (Private->NtHandle, Buffer, Request->Length, &Bytes, NULL);
+    } else {
+      Success = ReadFile (Private->NtHandle, Buffer, Request->Length, &Bytes, NULL);
+    }
+
+    if (!Success || (Bytes != Request->Length)) {
+      Status = WinNtBlockIoError (Private);
+    } else {
+      Private->Media->MediaPresent = TRUE;
+      if (Write) {
+        Private->Media->ReadOnly = FALSE;
+      }
+    }
+  }
+
+  WinNtBlockIoCompleteRequest (Private, Request, Status);
+  return EFI_SUCCESS;
+}
+
+/**
+  Retrieve a non-blocking request that has completed.
+
+  @param[in]   This     Indicates a pointer to the calling context.
+  @param[out]  Token    Returns the token of the completed request, with
+                        TransactionStatus updated.
+
+  @retval EFI_SUCCESS    A request has completed and is returned in Token.
+  @retval EFI_NOT_READY  No queued request has completed.
+
+**/
+EFI_STATUS
+WinNtBlockIoPoll (
+  IN     EMU_BLOCK_IO_PROTOCOL  *This,
+  OUT    EFI_BLOCK_IO2_TOKEN    **Token
+  )
+{
+  WIN_NT_BLOCK_IO_PRIVATE  *Private;
+  WIN_NT_BLOCK_IO_REQUEST  *Request;
+
+  Private = WIN_NT_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
+
+  if (Private->CompletedHead == NULL) {
+    WinNtBlockIoReap (Private, FALSE);
+  }
+
+  Request = Private->CompletedHead;
+  if (Request == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  Private->CompletedHead = Request->Next;
+  if (Private->CompletedHead == NULL) {
+    Private->CompletedTail = NULL;
+  }
+
+  *Token = Request->Token;
+  FreePool (Request);
+  return EFI_SUCCESS;
 }
 
 /**
@@ -294,24 +568,28 @@ WinNtBlockIoReadBlocks (
 
   Private = WIN_NT_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
 
+  DistanceToMove = MultU64x32 (Lba, (UINT32)Private->BlockSize);
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return WinNtBlockIoQueueRequest (Private, Token, FALSE, FALSE, DistanceToMove, Buffer, BufferSize);
+  }
+
   //
   // Seek to proper position
   //
-  DistanceToMove = MultU64x32 (Lba, (UINT32)Private->BlockSize);
-  Status         = SetFilePointer64 (Private, DistanceToMove, &DistanceMoved, FILE_BEGIN);
+  Status = SetFilePointer64 (Private, DistanceToMove, &DistanceMoved, FILE_BEGIN);
 
   if (EFI_ERROR (Status) || (DistanceToMove != DistanceMoved)) {
     DEBUG ((DEBUG_INIT, "ReadBlocks: SetFilePointer failed\n"));
-    return WinNtBlockIoError (Private->Media);
+    return WinNtBlockIoError (Private);
   }
 
   Flag = ReadFile (Private->NtHandle, Buffer, (DWORD)BufferSize, (LPDWORD)&BytesRead, NULL);
   if (!Flag || (BytesRead != BufferSize)) {
-    return WinNtBlockIoError (Private->Media);
+    return WinNtBlockIoError (Private);
   }
 
   Private->Media->MediaPresent = TRUE;
-  return WinNtSignalToken (Token, EFI_SUCCESS);
+  return EFI_SUCCESS;
 }
 
 /**
@@ -364,20 +642,24 @@ WinNtBlockIoWriteBlocks (
 
   Private = WIN_NT_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
 
+  DistanceToMove = MultU64x32 (Lba, (UINT32)Private->BlockSize);
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return WinNtBlockIoQueueRequest (Private, Token, TRUE, FALSE, DistanceToMove, Buffer, BufferSize);
+  }
+
   //
   // Seek to proper position
   //
-  DistanceToMove = MultU64x32 (Lba, (UINT32)Private->BlockSize);
-  Status         = SetFilePointer64 (Private, DistanceToMove, &DistanceMoved, FILE_BEGIN);
+  Status = SetFilePointer64 (Private, DistanceToMove, &DistanceMoved, FILE_BEGIN);
 
   if (EFI_ERROR (Status) || (DistanceToMove != DistanceMoved)) {
     DEBUG ((DEBUG_INIT, "WriteBlocks: SetFilePointer failed\n"));
-    return WinNtBlockIoError (Private->Media);
+    return WinNtBlockIoError (Private);
   }
 
   Success = WriteFile (Private->NtHandle, Buffer, (DWORD)BufferSize, (LPDWORD)&BytesWritten, NULL);
   if (!Success || (BytesWritten != BufferSize)) {
-    return WinNtBlockIoError (Private->Media);
+    return WinNtBlockIoError (Private);
   }
 
   //
@@ -385,7 +667,7 @@ WinNtBlockIoWriteBlocks (
   //
   Private->Media->MediaPresent = TRUE;
   Private->Media->ReadOnly     = FALSE;
-  return WinNtSignalToken (Token, EFI_SUCCESS);
+  return EFI_SUCCESS;
 }
 
 /**
@@ -416,7 +698,19 @@ WinNtBlockIoFlushBlocks (
   IN OUT EFI_BLOCK_IO2_TOKEN    *Token
   )
 {
-  return WinNtSignalToken (Token, EFI_SUCCESS);
+  WIN_NT_BLOCK_IO_PRIVATE  *Private;
+
+  Private = WIN_NT_BLOCK_IO_PRIVATE_DATA_FROM_THIS (This);
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    return WinNtBlockIoQueueRequest (Private, Token, FALSE, TRUE, 0, NULL, 0);
+  }
+
+  if (Private->NtHandle != INVALID_HANDLE_VALUE) {
+    FlushFileBuffers (Private->NtHandle);
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -447,6 +741,19 @@ WinNtBlockIoReset (
     Private->NtHandle = INVALID_HANDLE_VALUE;
   }
 
+  //
+  // Don't close the overlapped handle under the requests in flight. Their
+  // tokens stay on the completed list until the caller polls them.
+  //
+  if (Private->AsyncHandle != INVALID_HANDLE_VALUE) {
+    WinNtBlockIoReap (Private, TRUE);
+    if (Private->AsyncHandle != INVALID_HANDLE_VALUE) {
+      CloseHandle (Private->CompletionPort);
+      CloseHandle (Private->AsyncHandle);
+      Private->AsyncHandle = INVALID_HANDLE_VALUE;
+    }
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -455,7 +762,8 @@ EMU_BLOCK_IO_PROTOCOL  gEmuBlockIoProtocol = {
   WinNtBlockIoReadBlocks,
   WinNtBlockIoWriteBlocks,
   WinNtBlockIoFlushBlocks,
-  WinNtBlockIoCreateMapping
+  WinNtBlockIoCreateMapping,
+  WinNtBlockIoPoll
 };
 
 EFI_STATUS
@@ -478,6 +786,13 @@ WinNtBlockIoThunkOpen (
   Private->BlockSize = 512;
   Private->NtHandle  = INVALID_HANDLE_VALUE;
 
+  Private->AsyncHandle    = INVALID_HANDLE_VALUE;
+  Private->CompletionPort = NULL;
+  Private->AsyncFailed    = FALSE;
+  Private->InFlight       = 0;
+  Private->CompletedHead  = NULL;
+  Private->CompletedTail  = NULL;
+
   Private->FileName = AllocateCopyPool (StrSize (This->ConfigString), This->ConfigString);
   if (Private->FileName == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -524,6 +839,13 @@ WinNtBlockIoThunkClose (
   Private = This->Private;
 
   if (Private != NULL) {
+    WinNtBlockIoReset (&Private->EmuBlockIo, FALSE);
+    while (Private->CompletedHead != NULL) {
+      Private->CompletedTail = Private->CompletedHead;
+      Private->CompletedHead = Private->CompletedHead->Next;
+      FreePool (Private->CompletedTail);
+    }
+
     if (Private->FileName != NULL) {
       FreePool (Private->FileName);
     }
@@ -93,25 +93,26 @@ FatDiscardODir (
     //
     ODir->DirCacheTag = OFile->FileCluster;
     InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
-      //
-      // Replace the least recent used directory
-      //
+    Volume->DirCacheCount++;
+    Volume->DirCacheEntryCount += ODir->CurrentEndPos;
+    //
+    // Replace the least recent used directories until the cache fits in its
+    // bounds. The directory just cached with its hash tables is always kept
+    //
+    while ((Volume->DirCacheCount > 1) &&
+           ((Volume->DirCacheCount > FAT_MAX_DIR_CACHE_COUNT) ||
+            (Volume->DirCacheEntryCount > FAT_MAX_DIR_CACHE_ENTRY_COUNT)))
+    {
       ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
       RemoveEntryList (&ODir->DirCacheLink);
-    } else {
-      //
-      // No need to find a replace
-      //
-      Volume->DirCacheCount++;
-      ODir = NULL;
+      Volume->DirCacheCount--;
+      Volume->DirCacheEntryCount -= ODir->CurrentEndPos;
+      FatFreeODir (ODir);
     }
-  }
-
-  //
-  // Release ODir Structure
-  //
-  if (ODir != NULL) {
+  } else {
+    //
+    // Release ODir Structure
+    //
     FatFreeODir (ODir);
   }
 }
@@ -149,6 +150,7 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
+      Volume->DirCacheEntryCount -= CurrentODir->CurrentEndPos;
       ODir = CurrentODir;
       break;
     }
@@ -184,4 +186,6 @@ FatCleanupODirCache (
     FatFreeODir (ODir);
     Volume->DirCacheCount--;
   }
+
+  Volume->DirCacheEntryCount = 0;
 }
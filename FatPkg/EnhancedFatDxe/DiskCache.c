@@ -8,6 +8,45 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+/**
+
+  Find the cache page which holds PageNo, or the least recently used page of
+  the set of PageNo when PageNo is not cached.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - PageNo to match with the cache.
+  @param  Replace               - Return the page to replace when PageNo is not cached.
+
+  @return The Cache Tag of the page, or NULL if PageNo is not cached and Replace is FALSE.
+
+**/
+STATIC
+CACHE_TAG *
+FatFindCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo,
+  IN BOOLEAN     Replace
+  )
+{
+  UINTN      WayNo;
+  CACHE_TAG  *CacheTag;
+  CACHE_TAG  *Victim;
+
+  Victim = NULL;
+  for (WayNo = 0; WayNo < DiskCache->WayCount; WayNo++) {
+    CacheTag = &DiskCache->CacheTag[CACHE_SLOT (DiskCache, WayNo, PageNo)];
+    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+      return CacheTag;
+    }
+
+    if ((Victim == NULL) || (CacheTag->LastAccess < Victim->LastAccess)) {
+      Victim = CacheTag;
+    }
+  }
+
+  return Replace ? Victim : NULL;
+}
+
 /**
 
   This function is used by the Data Cache.
@@ -38,24 +77,18 @@ FatFlushDataCacheRange (
   )
 {
   UINTN       PageNo;
-  UINTN       GroupNo;
-  UINTN       GroupMask;
   UINTN       PageSize;
   UINT8       PageAlignment;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINT8       *BaseAddress;
 
   DiskCache     = &Volume->DiskCache[CacheData];
-  BaseAddress   = DiskCache->CacheBase;
-  GroupMask     = DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
   PageSize      = (UINTN)1 << PageAlignment;
 
   for (PageNo = StartPageNo; PageNo < EndPageNo; PageNo++) {
-    GroupNo  = PageNo & GroupMask;
-    CacheTag = &DiskCache->CacheTag[GroupNo];
-    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+    CacheTag = FatFindCacheTag (DiskCache, PageNo, FALSE);
+    if (CacheTag != NULL) {
       //
       // When reading data form disk directly, if some dirty data
       // in cache is in this rang, this data in the Buffer need to
@@ -65,7 +98,7 @@ FatFlushDataCacheRange (
         if (CacheTag->Dirty) {
           CopyMem (
             Buffer + ((PageNo - StartPageNo) << PageAlignment),
-            BaseAddress + (GroupNo << PageAlignment),
+            CACHE_PAGE_ADDRESS (DiskCache, CacheTag),
             PageSize
             );
         }
@@ -73,7 +106,8 @@ FatFlushDataCacheRange (
         //
         // Make all valid entries in this range invalid.
         //
-        CacheTag->RealSize = 0;
+        CacheTag->RealSize   = 0;
+        CacheTag->LastAccess = 0;
       }
     }
   }
@@ -104,7 +138,6 @@ FatExchangeCachePage (
   )
 {
   EFI_STATUS  Status;
-  UINTN       GroupNo;
   UINTN       PageNo;
   UINTN       WriteCount;
   UINTN       RealSize;
@@ -116,9 +149,8 @@ FatExchangeCachePage (
 
   DiskCache     = &Volume->DiskCache[DataType];
   PageNo        = CacheTag->PageNo;
-  GroupNo       = PageNo & DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
-  PageAddress   = DiskCache->CacheBase + (GroupNo << PageAlignment);
+  PageAddress   = CACHE_PAGE_ADDRESS (DiskCache, CacheTag);
   EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
   RealSize      = CacheTag->RealSize;
   if (IoMode == ReadDisk) {
@@ -152,13 +184,90 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Load a data cache page from the disk together with the pages following it,
+  in a single disk read.
+
+  The following pages are loaded in the same way of the next sets, which is
+  contiguous in the cache buffer. Read-ahead stops at the first page which is
+  already cached, or whose cache page is dirty.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - PageNo to load.
+  @param  CacheTag              - The Cache Tag of the cache page to load PageNo into.
+
+  @retval EFI_SUCCESS           - The cache pages are loaded successfully.
+  @return other                 - An error occurred when reading the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  UINTN       PageCount;
+  UINTN       Index;
+  UINT64      EntryPos;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+
+  for (PageCount = 1; PageCount < FAT_DATACACHE_READ_AHEAD_COUNT; PageCount++) {
+    if ((((PageNo + PageCount) & DiskCache->GroupMask) == 0) ||
+        (EntryPos + LShiftU64 (PageCount + 1, PageAlignment) > DiskCache->LimitAddress) ||
+        ((CacheTag[PageCount].RealSize > 0) && CacheTag[PageCount].Dirty) ||
+        (FatFindCacheTag (DiskCache, PageNo + PageCount, FALSE) != NULL))
+    {
+      break;
+    }
+  }
+
+  if (PageCount == 1) {
+    CacheTag->PageNo = PageNo;
+    return FatExchangeCachePage (Volume, CacheData, ReadDisk, CacheTag, NULL);
+  }
+
+  Status = FatDiskIo (
+             Volume,
+             ReadDisk,
+             EntryPos,
+             PageCount << PageAlignment,
+             CACHE_PAGE_ADDRESS (DiskCache, CacheTag),
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag[Index].PageNo     = PageNo + Index;
+    CacheTag[Index].RealSize   = (UINTN)1 << PageAlignment;
+    CacheTag[Index].LastAccess = DiskCache->AccessCount;
+    CacheTag[Index].Dirty      = FALSE;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Get one cache page by specified PageNo.
 
+  When PageNo is not cached, the least recently used page of its set
+  is replaced.
+
   @param  Volume                - FAT file system volume.
-  @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
+  @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
   @param  PageNo                - PageNo to match with the cache.
+  @param  ReadAhead             - Load the data pages following PageNo too on a cache miss.
   @param  CacheTag              - The Cache Tag for the current cache page.
 
   @retval EFI_SUCCESS           - Get the cache page successfully.
@@ -168,28 +277,33 @@ FatExchangeCachePage (
 STATIC
 EFI_STATUS
 FatGetCachePage (
-  IN FAT_VOLUME       *Volume,
-  IN CACHE_DATA_TYPE  CacheDataType,
-  IN UINTN            PageNo,
-  IN CACHE_TAG        *CacheTag
+  IN  FAT_VOLUME       *Volume,
+  IN  CACHE_DATA_TYPE  CacheDataType,
+  IN  UINTN            PageNo,
+  IN  BOOLEAN          ReadAhead,
+  OUT CACHE_TAG        **CacheTag
   )
 {
   EFI_STATUS  Status;
-  UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *Tag;
 
-  OldPageNo = CacheTag->PageNo;
-  if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
+  DiskCache = &Volume->DiskCache[CacheDataType];
+  Tag       = FatFindCacheTag (DiskCache, PageNo, TRUE);
+  *CacheTag = Tag;
+  if ((Tag->RealSize > 0) && (Tag->PageNo == PageNo)) {
     //
     // Cache Hit occurred
     //
+    Tag->LastAccess = ++DiskCache->AccessCount;
     return EFI_SUCCESS;
   }
 
   //
   // Write dirty cache page back to disk
   //
-  if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
-    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, NULL);
+  if ((Tag->RealSize > 0) && Tag->Dirty) {
+    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, Tag, NULL);
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -198,10 +312,21 @@ FatGetCachePage (
   //
   // Load new data from disk;
   //
-  CacheTag->PageNo = PageNo;
-  Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
+  if (ReadAhead) {
+    Status = FatReadAheadCachePages (Volume, PageNo, Tag);
+  } else {
+    Tag->PageNo = PageNo;
+    Status      = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, Tag, NULL);
+  }
 
-  return Status;
+  if (EFI_ERROR (Status)) {
+    Tag->RealSize   = 0;
+    Tag->LastAccess = 0;
+    return Status;
+  }
+
+  Tag->LastAccess = ++DiskCache->AccessCount;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -215,6 +340,7 @@ FatGetCachePage (
   @param  PageNo                - The number of unaligned cache page.
   @param  Offset                - The starting byte of cache page.
   @param  Length                - The number of bytes that is read or written
+  @param  ReadAhead             - Load the data pages following PageNo too on a cache miss.
   @param  Buffer                - Buffer containing cache data.
 
   @retval EFI_SUCCESS           - The data was accessed correctly.
@@ -230,6 +356,7 @@ FatAccessUnalignedCachePage (
   IN     UINTN            PageNo,
   IN     UINTN            Offset,
   IN     UINTN            Length,
+  IN     BOOLEAN          ReadAhead,
   IN OUT VOID             *Buffer
   )
 {
@@ -238,14 +365,11 @@ FatAccessUnalignedCachePage (
   VOID        *Destination;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINTN       GroupNo;
 
   DiskCache = &Volume->DiskCache[CacheDataType];
-  GroupNo   = PageNo & DiskCache->GroupMask;
-  CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, ReadAhead, &CacheTag);
   if (!EFI_ERROR (Status)) {
-    Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
+    Source      = CACHE_PAGE_ADDRESS (DiskCache, CacheTag) + Offset;
     Destination = Buffer;
     if (IoMode != ReadDisk) {
       CacheTag->Dirty  = TRUE;
@@ -274,7 +398,9 @@ FatAccessUnalignedCachePage (
   2. Access of Data cache (CACHE_DATA):
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
-     but the Aligned data will be accessed with disk directly.
+     but the Aligned data will be accessed with disk directly, except for the
+     leading pages of a read which are already cached.
+     The pages following a sequential read are read ahead into the Data cache.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -312,6 +438,8 @@ FatAccessCache (
   DISK_CACHE  *DiskCache;
   UINT64      EntryPos;
   UINT8       PageAlignment;
+  BOOLEAN     ReadAhead;
+  CACHE_TAG   *CacheTag;
 
   ASSERT (Volume->CacheBuffer != NULL);
 
@@ -323,13 +451,23 @@ FatAccessCache (
   PageNo        = (UINTN)RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN)EntryPos) & (PageSize - 1);
 
+  //
+  // A data read is sequential when it starts in or right after the
+  // last page of the previous one
+  //
+  ReadAhead = FALSE;
+  if ((CacheDataType == CacheData) && (IoMode == ReadDisk)) {
+    ReadAhead             = (BOOLEAN)((PageNo == DiskCache->NextPageNo) || (PageNo + 1 == DiskCache->NextPageNo));
+    DiskCache->NextPageNo = (UINTN)RShiftU64 (EntryPos + BufferSize + PageSize - 1, PageAlignment);
+  }
+
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
     if (Length > BufferSize) {
       Length = BufferSize;
     }
 
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, Buffer);
+    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, ReadAhead, Buffer);
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -350,6 +488,26 @@ FatAccessCache (
     //
     ASSERT (CacheDataType == CacheData);
 
+    //
+    // Copy the leading pages of a read which are cached, they may have been
+    // read ahead
+    //
+    while ((IoMode == ReadDisk) && (AlignedPageCount > 0)) {
+      CacheTag = FatFindCacheTag (DiskCache, PageNo, FALSE);
+      if ((CacheTag == NULL) || (CacheTag->RealSize != PageSize)) {
+        break;
+      }
+
+      CopyMem (Buffer, CACHE_PAGE_ADDRESS (DiskCache, CacheTag), PageSize);
+      CacheTag->LastAccess = ++DiskCache->AccessCount;
+      Buffer              += PageSize;
+      BufferSize          -= PageSize;
+      PageNo++;
+      AlignedPageCount--;
+    }
+  }
+
+  if (AlignedPageCount > 0) {
     EntryPos    = Volume->RootPos + LShiftU64 (PageNo, PageAlignment);
     AlignedSize = AlignedPageCount << PageAlignment;
     Status      = FatDiskIo (Volume, IoMode, EntryPos, AlignedSize, Buffer, Task);
@@ -374,7 +532,7 @@ FatAccessCache (
     //
     // Last read is not a complete page
     //
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
+    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, ReadAhead, Buffer);
   }
 
   return Status;
@@ -400,7 +558,7 @@ FatVolumeFlushCache (
   EFI_STATUS       Status;
   CACHE_DATA_TYPE  CacheDataType;
   UINTN            GroupIndex;
-  UINTN            GroupMask;
+  UINTN            GroupCount;
   DISK_CACHE       *DiskCache;
   CACHE_TAG        *CacheTag;
 
@@ -410,8 +568,8 @@ FatVolumeFlushCache (
       //
       // Data cache or fat cache is dirty, write the dirty data back
       //
-      GroupMask = DiskCache->GroupMask;
-      for (GroupIndex = 0; GroupIndex <= GroupMask; GroupIndex++) {
+      GroupCount = (DiskCache->GroupMask + 1) * DiskCache->WayCount;
+      for (GroupIndex = 0; GroupIndex < GroupCount; GroupIndex++) {
         CacheTag = &DiskCache->CacheTag[GroupIndex];
         if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
           //
@@ -439,6 +597,9 @@ FatVolumeFlushCache (
 
   Initialize the disk cache according to Volume's FatType.
 
+  The data cache is sized after the volume, and shrunk down to
+  FAT_DATACACHE_GROUP_COUNT pages when the memory is short.
+
   @param  Volume                - FAT file system volume.
 
   @retval EFI_SUCCESS           - The disk cache is successfully initialized.
@@ -450,44 +611,71 @@ FatInitializeDiskCache (
   IN FAT_VOLUME  *Volume
   )
 {
-  DISK_CACHE  *DiskCache;
-  UINTN       FatCacheGroupCount;
-  UINTN       DataCacheSize;
-  UINTN       FatCacheSize;
-  UINT8       *CacheBuffer;
+  DISK_CACHE       *DiskCache;
+  CACHE_DATA_TYPE  CacheDataType;
+  UINTN            GroupCount[CacheMaxType];
+  UINTN            DataCacheSize;
+  UINTN            FatCacheSize;
+  UINT8            *CacheBuffer;
+  CACHE_TAG        *CacheTag;
 
   DiskCache = Volume->DiskCache;
   //
   // Configure the parameters of disk cache
   //
   if (Volume->FatType == Fat12) {
-    FatCacheGroupCount                 = FAT_FATCACHE_GROUP_MIN_COUNT;
+    GroupCount[CacheFat]               = FAT_FATCACHE_GROUP_MIN_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MIN_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MIN_ALIGNMENT;
   } else {
-    FatCacheGroupCount                 = FAT_FATCACHE_GROUP_MAX_COUNT;
+    GroupCount[CacheFat]               = FAT_FATCACHE_GROUP_MAX_COUNT;
     DiskCache[CacheFat].PageAlignment  = FAT_FATCACHE_PAGE_MAX_ALIGNMENT;
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask    = FAT_DATACACHE_GROUP_COUNT - 1;
+  GroupCount[CacheData] = FAT_DATACACHE_GROUP_MAX_COUNT;
+  while ((GroupCount[CacheData] > FAT_DATACACHE_GROUP_COUNT) &&
+         (LShiftU64 (GroupCount[CacheData], DiskCache[CacheData].PageAlignment) > Volume->VolumeSize))
+  {
+    GroupCount[CacheData] >>= 1;
+  }
+
   DiskCache[CacheData].BaseAddress  = Volume->RootPos;
   DiskCache[CacheData].LimitAddress = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask     = FatCacheGroupCount - 1;
   DiskCache[CacheFat].BaseAddress   = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress  = Volume->FatPos + Volume->FatSize;
-  FatCacheSize                      = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                     = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  FatCacheSize                      = GroupCount[CacheFat] << DiskCache[CacheFat].PageAlignment;
   //
-  // Allocate the Fat Cache buffer
+  // Allocate the Fat Cache buffer, followed by the cache tags
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
-  if (CacheBuffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  for ( ; ;) {
+    DataCacheSize = GroupCount[CacheData] << DiskCache[CacheData].PageAlignment;
+    CacheBuffer   = AllocateZeroPool (
+                      FatCacheSize + DataCacheSize +
+                      (GroupCount[CacheFat] + GroupCount[CacheData]) * sizeof (CACHE_TAG)
+                      );
+    if (CacheBuffer != NULL) {
+      break;
+    }
+
+    if (GroupCount[CacheData] == FAT_DATACACHE_GROUP_COUNT) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    GroupCount[CacheData] >>= 1;
   }
 
   Volume->CacheBuffer            = CacheBuffer;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+
+  CacheTag = (CACHE_TAG *)(CacheBuffer + FatCacheSize + DataCacheSize);
+  for (CacheDataType = (CACHE_DATA_TYPE)0; CacheDataType < CacheMaxType; CacheDataType++) {
+    DiskCache[CacheDataType].WayCount  = MIN (FAT_CACHE_WAY_COUNT, GroupCount[CacheDataType]);
+    DiskCache[CacheDataType].GroupMask = GroupCount[CacheDataType] / DiskCache[CacheDataType].WayCount - 1;
+    DiskCache[CacheDataType].CacheTag  = CacheTag;
+    CacheTag                          += GroupCount[CacheDataType];
+  }
+
   return EFI_SUCCESS;
 }
@@ -75,14 +75,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Minimum fat page size is 8K, maximum fat page alignment is 32K
 // Minimum data page size is 8K, maximum fat page alignment is 64K
+// The data cache holds FAT_DATACACHE_GROUP_COUNT to FAT_DATACACHE_GROUP_MAX_COUNT
+// pages, depending on the volume size and the memory available.
+// The cache pages are grouped in sets of FAT_CACHE_WAY_COUNT pages, which are
+// replaced in LRU order. Up to FAT_DATACACHE_READ_AHEAD_COUNT data pages are
+// read at once on sequential reads.
 //
 #define FAT_FATCACHE_PAGE_MIN_ALIGNMENT   13
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
 #define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_GROUP_MAX_COUNT     256
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
+#define FAT_CACHE_WAY_COUNT               4
+#define FAT_DATACACHE_READ_AHEAD_COUNT    8
 
 //
 // Used in 8.3 generation algorithm
@@ -103,8 +111,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LC_ISO_639_2_ENTRY_SIZE  3
 #define MAX_LANG_CODE_SIZE       100
 
-#define FAT_MAX_DIR_CACHE_COUNT  8
-#define FAT_MAX_DIRENTRY_COUNT   0xFFFF
+//
+// The volume caches up to FAT_MAX_DIR_CACHE_COUNT directories of closed
+// files, which hold up to FAT_MAX_DIR_CACHE_ENTRY_COUNT directory entries
+//
+#define FAT_MAX_DIR_CACHE_COUNT        64
+#define FAT_MAX_DIR_CACHE_ENTRY_COUNT  0x10000
+#define FAT_MAX_DIRENTRY_COUNT         0xFFFF
+
+//
+// The number of cluster runs tracked by the extent cache of an opened file
+//
+#define FAT_EXTENT_CACHE_MIN_COUNT  16
+#define FAT_EXTENT_CACHE_MAX_COUNT  1024
 typedef CHAR8 LC_ISO_639_2;
 
 //
@@ -139,12 +158,20 @@ typedef enum {
 #define RAW_ACCESS(a)     ((IO_MODE)((a) & 0x1))
 #define CACHE_TYPE(a)     ((CACHE_DATA_TYPE)((a) >> 2))
 
+//
+// The cache pages are laid out way by way, so that the pages of
+// consecutive sets in a way are contiguous in the cache buffer
+//
+#define CACHE_SLOT(Cache, Way, PageNo)  ((Way) * ((Cache)->GroupMask + 1) + ((PageNo) & (Cache)->GroupMask))
+#define CACHE_PAGE_ADDRESS(Cache, Tag)  ((Cache)->CacheBase + ((UINTN)((Tag) - (Cache)->CacheTag) << (Cache)->PageAlignment))
+
 //
 // Disk cache tag
 //
 typedef struct {
   UINTN      PageNo;
   UINTN      RealSize;
+  UINTN      LastAccess;            // 0 for a page which is not in use
   BOOLEAN    Dirty;
 } CACHE_TAG;
 
@@ -154,8 +181,11 @@ typedef struct {
   UINT8        *CacheBase;
   BOOLEAN      Dirty;
   UINT8        PageAlignment;
-  UINTN        GroupMask;
-  CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  UINTN        GroupMask;           // selects the set of a page
+  UINTN        WayCount;            // number of pages in a set
+  UINTN        AccessCount;         // clock of the LRU replacement
+  UINTN        NextPageNo;          // page following the last data read
+  CACHE_TAG    *CacheTag;
 } DISK_CACHE;
 
 //
@@ -228,6 +258,15 @@ typedef struct {
   LIST_ENTRY            Link;
 } FAT_SUBTASK;
 
+//
+// FAT_EXTENT - A run of consecutive clusters in the cluster chain of a file
+//
+typedef struct {
+  UINTN    FileCluster;           // index of the first cluster within the file
+  UINTN    Cluster;               // first cluster on the disk
+  UINTN    Count;                 // number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -251,6 +290,15 @@ struct _FAT_OFILE {
   UINTN         FileCluster;
   UINTN         FileCurrentCluster;
   UINTN         FileLastCluster;
+  //
+  // The extent cache of the cluster chain, built lazily as the
+  // chain is walked. It covers the first ExtentClusters clusters
+  // of the file with ExtentCount runs of consecutive clusters
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         ExtentMax;
+  UINTN         ExtentClusters;
 
   //
   // Dirty is set if there have been any updates to the
@@ -368,6 +416,7 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                         DirCacheList;
   UINTN                              DirCacheCount;
+  UINTN                              DirCacheEntryCount;
 
   //
   // Disk Cache for this volume
@@ -895,6 +944,21 @@ FatGrowEof (
   IN UINT64     NewSizeInBytes
   );
 
+/**
+
+  Drop the runs of the extent cache of the open file which are beyond
+  the first Clusters clusters of the file.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters which remain valid.
+
+**/
+VOID
+FatTruncateExtents (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Clusters
+  );
+
 /**
 
   Get the size of directory of the open file.
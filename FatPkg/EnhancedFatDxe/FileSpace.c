@@ -406,6 +406,7 @@ FatShrinkEof (
   OFile->FileCurrentCluster = OFile->FileCluster;
   OFile->FileLastCluster    = LastCluster;
   OFile->Dirty              = TRUE;
+  FatTruncateExtents (OFile, NewSize);
   //
   // Free the remaining cluster chain
   //
@@ -545,6 +546,144 @@ Done:
   return Status;
 }
 
+/**
+
+  Drop the runs of the extent cache of the open file which are beyond
+  the first Clusters clusters of the file.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of clusters which remain valid.
+
+**/
+VOID
+FatTruncateExtents (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Clusters
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  if (OFile->ExtentClusters <= Clusters) {
+    return;
+  }
+
+  while (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster < Clusters) {
+      Extent->Count = Clusters - Extent->FileCluster;
+      break;
+    }
+
+    OFile->ExtentCount--;
+  }
+
+  OFile->ExtentClusters = Clusters;
+}
+
+/**
+
+  Record the disk cluster of a cluster of the open file in the extent cache.
+  Only the cluster following the ones covered by the cache is recorded, so
+  the cache always maps the beginning of the cluster chain.
+
+  @param  OFile                 - The open file.
+  @param  FileCluster           - The index of the cluster within the file.
+  @param  Cluster               - The cluster on the disk.
+
+**/
+STATIC
+VOID
+FatAddExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      FileCluster,
+  IN UINTN      Cluster
+  )
+{
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *Extents;
+  UINTN       ExtentMax;
+
+  if ((FileCluster != OFile->ExtentClusters) ||
+      (Cluster < FAT_MIN_CLUSTER) || (Cluster > OFile->Volume->MaxCluster + 1))
+  {
+    return;
+  }
+
+  if (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->Cluster + Extent->Count == Cluster) {
+      Extent->Count++;
+      OFile->ExtentClusters++;
+      return;
+    }
+  }
+
+  if (OFile->ExtentCount == OFile->ExtentMax) {
+    if (OFile->ExtentMax >= FAT_EXTENT_CACHE_MAX_COUNT) {
+      return;
+    }
+
+    ExtentMax = (OFile->ExtentMax == 0) ? FAT_EXTENT_CACHE_MIN_COUNT : OFile->ExtentMax * 2;
+    Extents   = ReallocatePool (
+                  OFile->ExtentMax * sizeof (FAT_EXTENT),
+                  ExtentMax * sizeof (FAT_EXTENT),
+                  OFile->Extents
+                  );
+    if (Extents == NULL) {
+      return;
+    }
+
+    OFile->Extents   = Extents;
+    OFile->ExtentMax = ExtentMax;
+  }
+
+  Extent              = &OFile->Extents[OFile->ExtentCount];
+  Extent->FileCluster = FileCluster;
+  Extent->Cluster     = Cluster;
+  Extent->Count       = 1;
+  OFile->ExtentCount++;
+  OFile->ExtentClusters++;
+}
+
+/**
+
+  Find the run of the extent cache of the open file which holds a cluster.
+
+  @param  OFile                 - The open file.
+  @param  FileCluster           - The index of the cluster within the file.
+
+  @return The run which holds the cluster, or NULL if the cluster is not cached.
+
+**/
+STATIC
+FAT_EXTENT *
+FatFindExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      FileCluster
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  if (FileCluster >= OFile->ExtentClusters) {
+    return NULL;
+  }
+
+  Low  = 0;
+  High = OFile->ExtentCount - 1;
+  while (Low < High) {
+    Middle = (Low + High + 1) / 2;
+    if (OFile->Extents[Middle].FileCluster <= FileCluster) {
+      Low = Middle;
+    } else {
+      High = Middle - 1;
+    }
+  }
+
+  return &OFile->Extents[Low];
+}
+
 /**
 
   Seek OFile to requested position, and calculate the number of
@@ -570,6 +709,9 @@ FatOFilePosition (
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       FileCluster;
+  FAT_EXTENT  *Extent;
+  BOOLEAN     RunEnded;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -603,6 +745,23 @@ FatOFilePosition (
       Cluster  = OFile->FileCluster;
     }
 
+    //
+    // Take the cluster from the extent cache when it is cached, otherwise
+    // resume the walk from the end of the cache if that is closer
+    //
+    FileCluster = Position >> Volume->ClusterAlignment;
+    Extent      = FatFindExtent (OFile, FileCluster);
+    if (Extent != NULL) {
+      StartPos = FileCluster << Volume->ClusterAlignment;
+      Cluster  = Extent->Cluster + FileCluster - Extent->FileCluster;
+    } else if ((OFile->ExtentClusters != 0) &&
+               (((OFile->ExtentClusters - 1) << Volume->ClusterAlignment) > StartPos))
+    {
+      StartPos = (OFile->ExtentClusters - 1) << Volume->ClusterAlignment;
+      Cluster  = OFile->Extents[OFile->ExtentCount - 1].Cluster + OFile->Extents[OFile->ExtentCount - 1].Count - 1;
+    }
+
+    FatAddExtent (OFile, StartPos >> Volume->ClusterAlignment, Cluster);
     while (StartPos + ClusterSize <= Position) {
       StartPos += ClusterSize;
       if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
@@ -611,6 +770,7 @@ FatOFilePosition (
       }
 
       Cluster = FatGetFatEntry (Volume, Cluster);
+      FatAddExtent (OFile, StartPos >> Volume->ClusterAlignment, Cluster);
     }
 
     if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
@@ -626,11 +786,26 @@ FatOFilePosition (
     //
     // Compute the number of consecutive clusters in the file
     //
-    Run = StartPos + ClusterSize - Position;
-    if (!FAT_END_OF_FAT_CHAIN (Cluster)) {
+    Run         = StartPos + ClusterSize - Position;
+    FileCluster = StartPos >> Volume->ClusterAlignment;
+    RunEnded    = FALSE;
+    if (Extent != NULL) {
+      //
+      // The clusters up to the end of the cached run are consecutive. The
+      // next cached run, if any, starts a new run on the disk
+      //
+      Run        += (Extent->FileCluster + Extent->Count - 1 - FileCluster) << Volume->ClusterAlignment;
+      Cluster     = Extent->Cluster + Extent->Count - 1;
+      FileCluster = Extent->FileCluster + Extent->Count - 1;
+      RunEnded    = (BOOLEAN)(Extent != &OFile->Extents[OFile->ExtentCount - 1]);
+    }
+
+    if (!RunEnded && !FAT_END_OF_FAT_CHAIN (Cluster)) {
       while ((FatGetFatEntry (Volume, Cluster) == Cluster + 1) && Run < PosLimit) {
-        Run     += ClusterSize;
-        Cluster += 1;
+        Run         += ClusterSize;
+        Cluster     += 1;
+        FileCluster += 1;
+        FatAddExtent (OFile, FileCluster, Cluster);
       }
     }
   }
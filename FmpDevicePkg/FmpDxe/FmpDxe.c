@@ -1110,6 +1110,103 @@ CheckTheImage (
   return CheckTheImageInternal (This, ImageIndex, Image, ImageSize, ImageUpdatable, &LastAttemptStatus);
 }
 
+/**
+  Stages the payload of a firmware image in the firmware device with
+  FmpDeviceStageImageChunk().
+
+  The payload is staged before the image is authenticated, so the firmware
+  device can program its staging storage while FmpDxe authenticates and checks
+  the image.  The staged payload does not replace the firmware image until it
+  is committed with FmpDeviceCommitStagedImage().  If the headers of the image
+  are malformed nothing is staged, and CheckTheImageInternal() reports the
+  error.
+
+  @param[in]  Image              Points to the new image.
+  @param[in]  ImageSize          Size of the new image in bytes.
+  @param[out] LastAttemptStatus  A pointer to a UINT32 that holds the last attempt status to report
+                                 back to the ESRT table in case of error.
+
+  @retval EFI_SUCCESS      The payload of the image was staged.
+  @retval EFI_UNSUPPORTED  The FmpDeviceLib does not support staging, or the headers of the image
+                           are malformed.  Nothing was staged.
+  @retval Others           The payload could not be staged.  The partially staged payload was
+                           discarded.
+
+**/
+EFI_STATUS
+StageTheImage (
+  IN  CONST VOID  *Image,
+  IN  UINTN       ImageSize,
+  OUT UINT32      *LastAttemptStatus
+  )
+{
+  EFI_STATUS   Status;
+  UINT32       DependenciesSize;
+  VOID         *FmpHeader;
+  UINTN        FmpPayloadSize;
+  UINT32       FmpHeaderSize;
+  UINT32       AllHeaderSize;
+  CONST UINT8  *Payload;
+  UINTN        PayloadSize;
+  UINTN        Offset;
+  UINTN        ChunkSize;
+  CHAR16       *AbortReason;
+  UINT32       DiscardLastAttemptStatus;
+
+  if ((Image == NULL) || (ImageSize <= sizeof (EFI_FIRMWARE_IMAGE_AUTHENTICATION))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Locate the payload the same way as SetTheImage() does once the image is checked
+  //
+  DependenciesSize = 0;
+  GetImageDependency ((EFI_FIRMWARE_IMAGE_AUTHENTICATION *)Image, ImageSize, &DependenciesSize, NULL);
+  FmpHeader = GetFmpHeader ((EFI_FIRMWARE_IMAGE_AUTHENTICATION *)Image, ImageSize, DependenciesSize, &FmpPayloadSize);
+  if (FmpHeader == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = GetFmpPayloadHeaderSize (FmpHeader, FmpPayloadSize, &FmpHeaderSize);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  AllHeaderSize = GetAllHeaderSize ((EFI_FIRMWARE_IMAGE_AUTHENTICATION *)Image, FmpHeaderSize + DependenciesSize);
+  if ((AllHeaderSize == 0) || (AllHeaderSize >= ImageSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Payload     = (CONST UINT8 *)Image + AllHeaderSize;
+  PayloadSize = ImageSize - AllHeaderSize;
+  for (Offset = 0; Offset < PayloadSize; Offset += ChunkSize) {
+    ChunkSize = MIN (PayloadSize - Offset, FMP_STAGE_CHUNK_SIZE);
+    Status    = FmpDeviceStageImageChunk (Payload + Offset, ChunkSize, Offset, PayloadSize, LastAttemptStatus);
+    if ((Status == EFI_UNSUPPORTED) && (Offset == 0)) {
+      return Status;
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "FmpDxe(%s): StageTheImage() - FmpDeviceStageImageChunk() at offset 0x%x failed %r.\n", mImageIdName, Offset, Status));
+      if ((*LastAttemptStatus < LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MIN_ERROR_CODE_VALUE) ||
+          (*LastAttemptStatus > LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MAX_ERROR_CODE_VALUE))
+      {
+        *LastAttemptStatus = LAST_ATTEMPT_STATUS_ERROR_UNSUCCESSFUL;
+      }
+
+      AbortReason = NULL;
+      FmpDeviceCommitStagedImage (FALSE, NULL, NULL, 0, &AbortReason, &DiscardLastAttemptStatus);
+      if (AbortReason != NULL) {
+        FreePool (AbortReason);
+      }
+
+      return (Status == EFI_UNSUPPORTED) ? EFI_DEVICE_ERROR : Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Updates the firmware image of the device.
 
@@ -1182,6 +1279,9 @@ SetTheImage (
   UINT32                            LowestSupportedVersion;
   EFI_FIRMWARE_IMAGE_DEP            *Dependencies;
   UINT32                            DependenciesSize;
+  BOOLEAN                           Staged;
+  CHAR16                            *DiscardAbortReason;
+  UINT32                            DiscardLastAttemptStatus;
 
   Status            = EFI_SUCCESS;
   Private           = NULL;
@@ -1195,6 +1295,7 @@ SetTheImage (
   LastAttemptStatus = LAST_ATTEMPT_STATUS_ERROR_UNSUCCESSFUL;
   Dependencies      = NULL;
   DependenciesSize  = 0;
+  Staged            = FALSE;
 
   if (!FeaturePcdGet (PcdFmpDeviceStorageAccessEnable)) {
     return EFI_UNSUPPORTED;
@@ -1234,6 +1335,18 @@ SetTheImage (
     goto cleanup;
   }
 
+  //
+  // Stage the payload first if the FmpDeviceLib supports it, so the device
+  // programs it while the image is authenticated below.  The staged payload
+  // is only committed once all the checks have passed.
+  //
+  Status = StageTheImage (Image, ImageSize, &LastAttemptStatus);
+  if (!EFI_ERROR (Status)) {
+    Staged = TRUE;
+  } else if (Status != EFI_UNSUPPORTED) {
+    goto cleanup;
+  }
+
   //
   // Call check image to verify the image
   //
@@ -1395,17 +1508,31 @@ SetTheImage (
   Progress (5);
 
   //
-  // Copy the requested image to the firmware using the FmpDeviceLib
+  // Copy the requested image to the firmware using the FmpDeviceLib, or
+  // activate the payload that has already been staged
   //
-  Status = FmpDeviceSetImageWithStatus (
-             (((UINT8 *)Image) + AllHeaderSize),
-             ImageSize - AllHeaderSize,
-             VendorCode,
-             FmpDxeProgress,
-             IncomingFwVersion,
-             AbortReason,
-             &LastAttemptStatus
-             );
+  if (Staged) {
+    Staged = FALSE;
+    Status = FmpDeviceCommitStagedImage (
+               TRUE,
+               VendorCode,
+               FmpDxeProgress,
+               IncomingFwVersion,
+               AbortReason,
+               &LastAttemptStatus
+               );
+  } else {
+    Status = FmpDeviceSetImageWithStatus (
+               (((UINT8 *)Image) + AllHeaderSize),
+               ImageSize - AllHeaderSize,
+               VendorCode,
+               FmpDxeProgress,
+               IncomingFwVersion,
+               AbortReason,
+               &LastAttemptStatus
+               );
+  }
+
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "FmpDxe(%s): SetTheImage() SetImage from FmpDeviceLib failed. Status =  %r.\n", mImageIdName, Status));
 
@@ -1467,6 +1594,17 @@ SetTheImage (
 cleanup:
   mProgressFunc = NULL;
 
+  if (Staged) {
+    //
+    // The image failed a check after its payload was staged, so discard it
+    //
+    DiscardAbortReason = NULL;
+    FmpDeviceCommitStagedImage (FALSE, NULL, NULL, 0, &DiscardAbortReason, &DiscardLastAttemptStatus);
+    if (DiscardAbortReason != NULL) {
+      FreePool (DiscardAbortReason);
+    }
+  }
+
   if (Private != NULL) {
     DEBUG ((DEBUG_INFO, "FmpDxe(%s): SetTheImage() LastAttemptStatus: %u.\n", mImageIdName, LastAttemptStatus));
     SetLastAttemptStatusInVariable (Private, LastAttemptStatus);
@@ -42,6 +42,11 @@
 #define VERSION_STRING_NOT_SUPPORTED  L"VERSION STRING NOT SUPPORTED"
 #define VERSION_STRING_NOT_AVAILABLE  L"VERSION STRING NOT AVAILABLE"
 
+//
+// Size of the chunks passed to FmpDeviceStageImageChunk()
+//
+#define FMP_STAGE_CHUNK_SIZE  SIZE_64KB
+
 ///
 ///
 ///
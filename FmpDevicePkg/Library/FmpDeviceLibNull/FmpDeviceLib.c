@@ -620,6 +620,118 @@ FmpDeviceSetImageWithStatus (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Writes a chunk of a new firmware image to the staging storage of a firmware
+  device, such as the inactive bank of a dual-bank device.  A staged image does
+  not replace the running firmware image until FmpDeviceCommitStagedImage() is
+  called with Commit set to TRUE, so the caller may stage the chunks of an image
+  before the image is authenticated.
+
+  The chunks are staged in order, starting at Offset 0.  This function may
+  return before the chunk is written to the firmware device, so that the device
+  programs the chunk while the caller stages the next chunk or authenticates the
+  image.  The buffer of the chunk must remain valid until
+  FmpDeviceCommitStagedImage() returns.
+
+  @param[in]  Chunk             Points to the chunk of the new firmware image.
+  @param[in]  ChunkSize         Size, in bytes, of the chunk.
+  @param[in]  Offset            Offset, in bytes, of the chunk in the new
+                                firmware image.
+  @param[in]  ImageSize         Size, in bytes, of the new firmware image.
+  @param[out] LastAttemptStatus A pointer to a UINT32 that holds the last attempt
+                                status to report back to the ESRT table in case
+                                of error. This value will only be checked when this
+                                function returns an error other than EFI_UNSUPPORTED.
+
+                                The return status code must fall in the range of
+                                LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MIN_ERROR_CODE_VALUE to
+                                LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MAX_ERROR_CODE_VALUE.
+
+                                If the value falls outside this range, it will be converted
+                                to LAST_ATTEMPT_STATUS_ERROR_UNSUCCESSFUL.
+
+  @retval EFI_SUCCESS            The chunk was staged.
+  @retval EFI_INVALID_PARAMETER  Chunk is NULL, or the chunk does not follow the
+                                 previous chunk.
+  @retval EFI_UNSUPPORTED        The firmware device does not support staging.
+                                 The image must be written with
+                                 FmpDeviceSetImageWithStatus().
+  @retval EFI_DEVICE_ERROR       The chunk could not be staged.
+
+**/
+EFI_STATUS
+EFIAPI
+FmpDeviceStageImageChunk (
+  IN  CONST VOID  *Chunk,
+  IN  UINTN       ChunkSize,
+  IN  UINTN       Offset,
+  IN  UINTN       ImageSize,
+  OUT UINT32      *LastAttemptStatus
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Completes an update of a firmware device whose new firmware image has been
+  staged with FmpDeviceStageImageChunk().  If Commit is TRUE, this function
+  waits until the staged image is written, performs the same validations as
+  FmpDeviceSetImageWithStatus(), and makes the staged image the firmware image
+  of the firmware device.  If Commit is FALSE, the staged image is discarded and
+  the firmware image of the firmware device is not changed.
+
+  @param[in]  Commit            TRUE to activate the staged image, FALSE to
+                                discard it.
+  @param[in]  VendorCode        This enables vendor to implement vendor-specific
+                                firmware image update policy.  NULL indicates
+                                the caller did not specify the policy or use the
+                                default policy.
+  @param[in]  Progress          A function used to report the progress of
+                                updating the firmware device with the new
+                                firmware image.
+  @param[in]  CapsuleFwVersion  The version of the new firmware image from the
+                                update capsule that provided the new firmware
+                                image.
+  @param[out] AbortReason       A pointer to a pointer to a Null-terminated
+                                Unicode string providing more details on an
+                                aborted operation. The buffer is allocated by
+                                this function with
+                                EFI_BOOT_SERVICES.AllocatePool().  It is the
+                                caller's responsibility to free this buffer with
+                                EFI_BOOT_SERVICES.FreePool().
+  @param[out] LastAttemptStatus A pointer to a UINT32 that holds the last attempt
+                                status to report back to the ESRT table in case
+                                of error. This value will only be checked when this
+                                function returns an error.
+
+                                The return status code must fall in the range of
+                                LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MIN_ERROR_CODE_VALUE to
+                                LAST_ATTEMPT_STATUS_DEVICE_LIBRARY_MAX_ERROR_CODE_VALUE.
+
+                                If the value falls outside this range, it will be converted
+                                to LAST_ATTEMPT_STATUS_ERROR_UNSUCCESSFUL.
+
+  @retval EFI_SUCCESS            The staged image was activated or discarded.
+  @retval EFI_ABORTED            The operation is aborted.  Additional details
+                                 are provided in AbortReason.
+  @retval EFI_NOT_READY          No image has been staged.
+  @retval EFI_UNSUPPORTED        The operation is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+FmpDeviceCommitStagedImage (
+  IN  BOOLEAN                                        Commit,
+  IN  CONST VOID                                     *VendorCode        OPTIONAL,
+  IN  EFI_FIRMWARE_MANAGEMENT_UPDATE_IMAGE_PROGRESS  Progress           OPTIONAL,
+  IN  UINT32                                         CapsuleFwVersion,
+  OUT CHAR16                                         **AbortReason,
+  OUT UINT32                                         *LastAttemptStatus
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Lock the firmware device that contains a firmware image.  Once a firmware
   device is locked, any attempts to modify the firmware image contents in the
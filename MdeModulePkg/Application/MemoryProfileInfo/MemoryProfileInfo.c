@@ -414,6 +414,41 @@ DumpMemoryProfileAllocInfo (
   return (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)AllocInfo + AllocInfo->Header.Length);
 }
 
+/**
+  Dump memory profile call site information.
+
+  @param[in] DriverInfo         Pointer to memory profile driver info.
+  @param[in] AllocIndex         Memory profile alloc info index.
+  @param[in] CallSiteInfo       Pointer to memory profile call site info.
+  @param[in] IsForSmm           TRUE  - SMRAM profile.
+                                FALSE - UEFI memory profile.
+
+  @return Pointer to next memory profile alloc info.
+
+**/
+MEMORY_PROFILE_ALLOC_INFO *
+DumpMemoryProfileCallSiteInfo (
+  IN MEMORY_PROFILE_DRIVER_INFO     *DriverInfo,
+  IN UINTN                          AllocIndex,
+  IN MEMORY_PROFILE_CALL_SITE_INFO  *CallSiteInfo,
+  IN BOOLEAN                        IsForSmm
+  )
+{
+  Print (L"    MEMORY_PROFILE_CALL_SITE_INFO (0x%x)\n", AllocIndex);
+  Print (L"      Signature     - 0x%08x\n", CallSiteInfo->Header.Signature);
+  Print (L"      Length        - 0x%04x\n", CallSiteInfo->Header.Length);
+  Print (L"      Revision      - 0x%04x\n", CallSiteInfo->Header.Revision);
+  Print (L"      CallerAddress - 0x%016lx (Offset: 0x%08x)\n", CallSiteInfo->CallerAddress, (UINTN)(CallSiteInfo->CallerAddress - DriverInfo->ImageBase));
+  Print (L"      Action        - 0x%08x (%a)\n", CallSiteInfo->Action, ProfileActionToStr (CallSiteInfo->Action, NULL, IsForSmm));
+  Print (L"      MemoryType    - 0x%08x (%a)\n", CallSiteInfo->MemoryType, ProfileMemoryTypeToStr (CallSiteInfo->MemoryType));
+  Print (L"      CurrentUsage  - 0x%016lx\n", CallSiteInfo->CurrentUsage);
+  Print (L"      PeakUsage     - 0x%016lx\n", CallSiteInfo->PeakUsage);
+  Print (L"      CurrentCount  - 0x%08x\n", CallSiteInfo->CurrentCount);
+  Print (L"      TotalCount    - 0x%08x\n", CallSiteInfo->TotalCount);
+
+  return (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)CallSiteInfo + CallSiteInfo->Header.Length);
+}
+
 /**
   Dump memory profile driver information.
 
@@ -471,6 +506,11 @@ DumpMemoryProfileDriverInfo (
 
   AllocInfo = (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)DriverInfo + DriverInfo->Header.Length);
   for (AllocIndex = 0; AllocIndex < DriverInfo->AllocRecordCount; AllocIndex++) {
+    if (AllocInfo->Header.Signature == MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE) {
+      AllocInfo = DumpMemoryProfileCallSiteInfo (DriverInfo, AllocIndex, (MEMORY_PROFILE_CALL_SITE_INFO *)AllocInfo, IsForSmm);
+      continue;
+    }
+
     AllocInfo = DumpMemoryProfileAllocInfo (DriverInfo, AllocIndex, AllocInfo, IsForSmm);
     if (AllocInfo == NULL) {
       return NULL;
@@ -774,8 +814,27 @@ CreateAllocSummaryInfo (
 {
   MEMORY_PROFILE_ALLOC_SUMMARY_INFO_DATA  *AllocSummaryInfoData;
   MEMORY_PROFILE_ALLOC_SUMMARY_INFO       *AllocSummaryInfo;
+  MEMORY_PROFILE_CALL_SITE_INFO           *CallSiteInfo;
+  MEMORY_PROFILE_ACTION                   Action;
+  UINT32                                  AllocateCount;
+  UINT64                                  Size;
 
-  if (AllocInfo->Header.Signature != MEMORY_PROFILE_ALLOC_INFO_SIGNATURE) {
+  if (AllocInfo->Header.Signature == MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE) {
+    //
+    // A call site counts the allocations of the caller that are not freed.
+    //
+    CallSiteInfo  = (MEMORY_PROFILE_CALL_SITE_INFO *)AllocInfo;
+    Action        = CallSiteInfo->Action;
+    AllocateCount = CallSiteInfo->CurrentCount;
+    Size          = CallSiteInfo->CurrentUsage;
+    if (AllocateCount == 0) {
+      return (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)AllocInfo + AllocInfo->Header.Length);
+    }
+  } else if (AllocInfo->Header.Signature == MEMORY_PROFILE_ALLOC_INFO_SIGNATURE) {
+    Action        = AllocInfo->Action;
+    AllocateCount = 1;
+    Size          = AllocInfo->Size;
+  } else {
     return NULL;
   }
 
@@ -792,8 +851,8 @@ CreateAllocSummaryInfo (
     AllocSummaryInfo->Header.Length    = sizeof (*AllocSummaryInfo);
     AllocSummaryInfo->Header.Revision  = MEMORY_PROFILE_ALLOC_SUMMARY_INFO_REVISION;
     AllocSummaryInfo->CallerAddress    = AllocInfo->CallerAddress;
-    AllocSummaryInfo->Action           = AllocInfo->Action;
-    if (AllocInfo->ActionStringOffset != 0) {
+    AllocSummaryInfo->Action           = Action;
+    if ((AllocInfo->Header.Signature == MEMORY_PROFILE_ALLOC_INFO_SIGNATURE) && (AllocInfo->ActionStringOffset != 0)) {
       AllocSummaryInfo->ActionString = (CHAR8 *)((UINTN)AllocInfo + AllocInfo->ActionStringOffset);
     } else {
       AllocSummaryInfo->ActionString = NULL;
@@ -805,8 +864,8 @@ CreateAllocSummaryInfo (
   }
 
   AllocSummaryInfo = &AllocSummaryInfoData->AllocSummaryInfo;
-  AllocSummaryInfo->AllocateCount++;
-  AllocSummaryInfo->TotalSize += AllocInfo->Size;
+  AllocSummaryInfo->AllocateCount += AllocateCount;
+  AllocSummaryInfo->TotalSize     += Size;
 
   return (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)AllocInfo + AllocInfo->Header.Length);
 }
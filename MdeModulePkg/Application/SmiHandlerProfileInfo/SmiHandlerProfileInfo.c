@@ -629,6 +629,15 @@ DumpSmiHandler (
         }
 
         Print (L"      </Caller>\n", SmiHandlerStruct->Handler);
+        if ((SmiStruct->Header.Revision >= 0x0002) && (SmiHandlerStruct->InvocationCount != 0)) {
+          Print (
+            L"      <Statistics InvocationCount=\"%ld\" TotalTimeNs=\"%ld\" MaxTimeNs=\"%ld\"/>\n",
+            SmiHandlerStruct->InvocationCount,
+            SmiHandlerStruct->TotalTime,
+            SmiHandlerStruct->MaxTime
+            );
+        }
+
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print (L"    </SmiHandler>\n");
       }
@@ -642,6 +651,64 @@ DumpSmiHandler (
   return;
 }
 
+/**
+  Dump the slowest SMI handler invocations.
+
+  @retval TRUE   The slowest SMI handler invocations are recorded.
+  @retval FALSE  The SMI handler invocations are not measured.
+**/
+BOOLEAN
+DumpSlowSmiInvocation (
+  VOID
+  )
+{
+  SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE  *SlowStruct;
+  SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE           *Invocation;
+  UINTN                                            Index;
+  SMM_CORE_IMAGE_DATABASE_STRUCTURE                *ImageStruct;
+  CHAR8                                            *NameString;
+
+  SlowStruct = (VOID *)mSmiHandlerProfileDatabase;
+  while ((UINTN)SlowStruct < (UINTN)mSmiHandlerProfileDatabase + mSmiHandlerProfileDatabaseSize) {
+    if (SlowStruct->Header.Signature == SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_SIGNATURE) {
+      break;
+    }
+
+    SlowStruct = (VOID *)((UINTN)SlowStruct + SlowStruct->Header.Length);
+  }
+
+  if ((UINTN)SlowStruct >= (UINTN)mSmiHandlerProfileDatabase + mSmiHandlerProfileDatabaseSize) {
+    return FALSE;
+  }
+
+  Invocation = (VOID *)(SlowStruct + 1);
+  for (Index = 0; Index < SlowStruct->InvocationCount; Index++, Invocation++) {
+    Print (L"  <SmiInvocation");
+    if (!IsZeroGuid (&Invocation->HandlerType)) {
+      Print (L" HandlerType=\"%g\"", &Invocation->HandlerType);
+    }
+
+    Print (
+      L" Category=\"%s\" TimeNs=\"%ld\" Status=\"%r\">\n",
+      (Invocation->HandlerCategory == SmmCoreSmiHandlerCategoryRootHandler) ? L"RootSmi" : L"GuidSmi",
+      Invocation->Time,
+      (EFI_STATUS)(UINTN)Invocation->ReturnStatus
+      );
+    ImageStruct = GetImageFromRef ((UINTN)Invocation->ImageRef);
+    NameString  = GetDriverNameString (ImageStruct);
+    Print (L"    <Module RefId=\"0x%x\" Name=\"%a\"/>\n", Invocation->ImageRef, NameString);
+    Print (L"    <Handler Address=\"0x%lx\">\n", Invocation->Handler);
+    if (ImageStruct != NULL) {
+      Print (L"       <RVA>0x%x</RVA>\n", (UINTN)(Invocation->Handler - ImageStruct->ImageBase));
+    }
+
+    Print (L"    </Handler>\n");
+    Print (L"  </SmiInvocation>\n");
+  }
+
+  return TRUE;
+}
+
 /**
   The Entry Point for SMI handler profile info application.
 
@@ -695,6 +762,17 @@ SmiHandlerProfileInfoEntrypoint (
   Print (L"  </SmiHandlerCategory>\n\n");
 
   Print (L"</SmiHandlerDatabase>\n");
+
+  //
+  // Dump the slowest SMI handler invocations
+  //
+  Print (L"<SlowSmiInvocationDatabase>\n");
+  Print (L"  <!-- The slowest SMI handler invocations, slowest first -->\n");
+  if (!DumpSlowSmiInvocation ()) {
+    Print (L"  <!-- Not recorded, set BIT1 of PcdSmiHandlerProfilePropertyMask -->\n");
+  }
+
+  Print (L"</SlowSmiInvocationDatabase>\n");
   Print (L"</SmiHandlerProfile>\n");
 
   if (mSmiHandlerProfileDatabase != NULL) {
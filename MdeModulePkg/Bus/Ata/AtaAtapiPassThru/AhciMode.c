@@ -127,6 +127,105 @@ AhciOrReg (
   AhciWriteReg (PciIo, Offset, Data);
 }
 
+//
+// The register or memory location AhciWaitMmioSet() and AhciWaitMemSet() wait for.
+//
+typedef struct {
+  EFI_PCI_IO_PROTOCOL    *PciIo;
+  UINTN                  Offset;
+  UINT32                 MaskValue;
+  UINT32                 TestValue;
+} AHCI_WAIT_SET_CONTEXT;
+
+//
+// The port AhciWaitDeviceReady() and the PHY detection wait for.
+//
+typedef struct {
+  EFI_PCI_IO_PROTOCOL    *PciIo;
+  UINT8                  Port;
+} AHCI_WAIT_PORT_CONTEXT;
+
+/**
+  Check if the value of the MMIO register described by Context is set to the test value.
+
+  @param  Context           The pointer to the AHCI_WAIT_SET_CONTEXT data structure.
+
+  @retval EFI_NOT_READY     The MMIO is not set.
+  @retval EFI_SUCCESS       The MMIO is correct set.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckMmioSetCondition (
+  IN VOID  *Context
+  )
+{
+  AHCI_WAIT_SET_CONTEXT  *WaitContext;
+
+  WaitContext = (AHCI_WAIT_SET_CONTEXT *)Context;
+
+  //
+  // Access PCI MMIO space to see if the value is the tested one.
+  //
+  if ((AhciReadReg (WaitContext->PciIo, (UINT32)WaitContext->Offset) & WaitContext->MaskValue) == WaitContext->TestValue) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Check if the value of the system memory described by Context is set to the test value.
+
+  @param  Context           The pointer to the AHCI_WAIT_SET_CONTEXT data structure.
+
+  @retval EFI_NOT_READY     The memory is not set.
+  @retval EFI_SUCCESS       The memory is correct set.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckMemSetCondition (
+  IN VOID  *Context
+  )
+{
+  AHCI_WAIT_SET_CONTEXT  *WaitContext;
+
+  WaitContext = (AHCI_WAIT_SET_CONTEXT *)Context;
+
+  //
+  // The system memory pointed by Offset will be updated by the
+  // SATA Host Controller, "volatile" is introduced to prevent
+  // compiler from optimizing the access to the memory address
+  // to only read once.
+  //
+  if ((*(volatile UINT32 *)WaitContext->Offset & WaitContext->MaskValue) == WaitContext->TestValue) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Convert an AHCI timeout in 100ns units to the timeout of PollLibWaitUntil().
+
+  @param  Timeout           The time out value, uses 100ns as a unit. 0 means infinite wait.
+
+  @return The time out value in microseconds.
+
+**/
+UINT64
+AhciGetPollTimeout (
+  IN UINT64  Timeout
+  )
+{
+  if (Timeout == 0) {
+    return POLL_LIB_WAIT_FOREVER;
+  }
+
+  return DivU64x32 (Timeout, 10) + 1;
+}
+
 /**
   Wait for the value of the specified MMIO register set to the test value.
 
@@ -150,37 +249,17 @@ AhciWaitMmioSet (
   IN  UINT64               Timeout
   )
 {
-  UINT32   Value;
-  UINT64   Delay;
-  BOOLEAN  InfiniteWait;
+  AHCI_WAIT_SET_CONTEXT  WaitContext;
 
-  if (Timeout == 0) {
-    InfiniteWait = TRUE;
-  } else {
-    InfiniteWait = FALSE;
-  }
-
-  Delay = DivU64x32 (Timeout, 1000) + 1;
-
-  do {
-    //
-    // Access PCI MMIO space to see if the value is the tested one.
-    //
-    Value = AhciReadReg (PciIo, (UINT32)Offset) & MaskValue;
-
-    if (Value == TestValue) {
-      return EFI_SUCCESS;
-    }
-
-    //
-    // Stall for 100 microseconds.
-    //
-    MicroSecondDelay (100);
-
-    Delay--;
-  } while (InfiniteWait || (Delay > 0));
+  WaitContext.PciIo     = PciIo;
+  WaitContext.Offset    = Offset;
+  WaitContext.MaskValue = MaskValue;
+  WaitContext.TestValue = TestValue;
 
-  return EFI_TIMEOUT;
+  //
+  // Poll with a growing interval of up to 100 microseconds.
+  //
+  return PollLibWaitUntil (NULL, AhciCheckMmioSetCondition, &WaitContext, AhciGetPollTimeout (Timeout), 100);
 }
 
 /**
@@ -204,43 +283,17 @@ AhciWaitMemSet (
   IN  UINT64                Timeout
   )
 {
-  UINT32   Value;
-  UINT64   Delay;
-  BOOLEAN  InfiniteWait;
+  AHCI_WAIT_SET_CONTEXT  WaitContext;
 
-  if (Timeout == 0) {
-    InfiniteWait = TRUE;
-  } else {
-    InfiniteWait = FALSE;
-  }
-
-  Delay =  DivU64x32 (Timeout, 1000) + 1;
+  WaitContext.PciIo     = NULL;
+  WaitContext.Offset    = (UINTN)Address;
+  WaitContext.MaskValue = MaskValue;
+  WaitContext.TestValue = TestValue;
 
-  do {
-    //
-    // Access system memory to see if the value is the tested one.
-    //
-    // The system memory pointed by Address will be updated by the
-    // SATA Host Controller, "volatile" is introduced to prevent
-    // compiler from optimizing the access to the memory address
-    // to only read once.
-    //
-    Value  = *(volatile UINT32 *)(UINTN)Address;
-    Value &= MaskValue;
-
-    if (Value == TestValue) {
-      return EFI_SUCCESS;
-    }
-
-    //
-    // Stall for 100 microseconds.
-    //
-    MicroSecondDelay (100);
-
-    Delay--;
-  } while (InfiniteWait || (Delay > 0));
-
-  return EFI_TIMEOUT;
+  //
+  // Poll with a growing interval of up to 100 microseconds.
+  //
+  return PollLibWaitUntil (NULL, AhciCheckMemSetCondition, &WaitContext, AhciGetPollTimeout (Timeout), 100);
 }
 
 /**
@@ -601,6 +654,41 @@ AhciBuildCommandFis (
   CmdFis->AhciCFisDevHead = (UINT8)(AtaCommandBlock->AtaDeviceHead | 0xE0);
 }
 
+/**
+  Check if the SATA device reports it is ready for operation.
+
+  @param[in] Context  The pointer to the AHCI_WAIT_PORT_CONTEXT data structure.
+
+  @retval EFI_SUCCESS    Device ready for operation.
+  @retval EFI_NOT_READY  Device is not ready yet.
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckDeviceReady (
+  IN VOID  *Context
+  )
+{
+  AHCI_WAIT_PORT_CONTEXT  *WaitContext;
+  UINT32                  Data;
+  UINT32                  Offset;
+
+  WaitContext = (AHCI_WAIT_PORT_CONTEXT *)Context;
+
+  Offset = EFI_AHCI_PORT_START + WaitContext->Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
+  if (AhciReadReg (WaitContext->PciIo, Offset) != 0) {
+    AhciWriteReg (WaitContext->PciIo, Offset, AhciReadReg (WaitContext->PciIo, Offset));
+  }
+
+  Offset = EFI_AHCI_PORT_START + WaitContext->Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+
+  Data = AhciReadReg (WaitContext->PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK;
+  if (Data == 0) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_READY;
+}
+
 /**
   Wait until SATA device reports it is ready for operation.
 
@@ -616,38 +704,53 @@ AhciWaitDeviceReady (
   IN UINT8                Port
   )
 {
-  UINT32  PhyDetectDelay;
-  UINT32  Data;
-  UINT32  Offset;
+  EFI_STATUS              Status;
+  UINT32                  Offset;
+  AHCI_WAIT_PORT_CONTEXT  WaitContext;
 
   //
   // According to SATA1.0a spec section 5.2, we need to wait for PxTFD.BSY and PxTFD.DRQ
   // and PxTFD.ERR to be zero. The maximum wait time is 16s which is defined at ATA spec.
   //
-  PhyDetectDelay = 16 * 1000;
-  do {
-    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
-    if (AhciReadReg (PciIo, Offset) != 0) {
-      AhciWriteReg (PciIo, Offset, AhciReadReg (PciIo, Offset));
-    }
+  WaitContext.PciIo = PciIo;
+  WaitContext.Port  = Port;
+  Status            = PollLibWaitUntil ("AhciWaitDeviceReady", AhciCheckDeviceReady, &WaitContext, 16 * 1000 * 1000, 1000);
 
+  if (EFI_ERROR (Status)) {
     Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+    DEBUG ((DEBUG_ERROR, "Port %d Device not ready (TFD=0x%X)\n", Port, AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK));
+    return EFI_TIMEOUT;
+  } else {
+    return EFI_SUCCESS;
+  }
+}
 
-    Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK;
-    if (Data == 0) {
-      break;
-    }
+/**
+  Check if the PHY detected the presence of a device on a SATA port.
 
-    MicroSecondDelay (1000);
-    PhyDetectDelay--;
-  } while (PhyDetectDelay > 0);
+  @param[in] Context  The pointer to the AHCI_WAIT_PORT_CONTEXT data structure.
 
-  if (PhyDetectDelay == 0) {
-    DEBUG ((DEBUG_ERROR, "Port %d Device not ready (TFD=0x%X)\n", Port, Data));
-    return EFI_TIMEOUT;
-  } else {
+  @retval EFI_SUCCESS    A device is detected.
+  @retval EFI_NOT_READY  No device is detected yet.
+**/
+EFI_STATUS
+EFIAPI
+AhciCheckPhyDetect (
+  IN VOID  *Context
+  )
+{
+  AHCI_WAIT_PORT_CONTEXT  *WaitContext;
+  UINT32                  Data;
+  UINT32                  Offset;
+
+  WaitContext = (AHCI_WAIT_PORT_CONTEXT *)Context;
+  Offset      = EFI_AHCI_PORT_START + WaitContext->Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
+  Data        = AhciReadReg (WaitContext->PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
+  if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
     return EFI_SUCCESS;
   }
+
+  return EFI_NOT_READY;
 }
 
 /**
@@ -1563,28 +1666,24 @@ AhciStopCommand (
 }
 
 /**
-  Start command for give slot on specific port.
+  Start the command list processing of specific port.
 
   @param  PciIo              The PCI IO protocol instance.
   @param  Port               The number of port.
-  @param  CommandSlot        The number of Command Slot.
   @param  Timeout            The timeout value of start, uses 100ns as a unit.
 
-  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
   @retval EFI_TIMEOUT        The operation is time out.
-  @retval EFI_SUCCESS        The command start successfully.
+  @retval EFI_SUCCESS        The port start successfully.
 
 **/
 EFI_STATUS
-EFIAPI
-AhciStartCommand (
+AhciStartPort (
   IN  EFI_PCI_IO_PROTOCOL  *PciIo,
   IN  UINT8                Port,
-  IN  UINT8                CommandSlot,
   IN  UINT64               Timeout
   )
 {
-  UINT32      CmdSlotBit;
   EFI_STATUS  Status;
   UINT32      PortStatus;
   UINT32      StartCmd;
@@ -1597,8 +1696,6 @@ AhciStartCommand (
   //
   Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
 
-  CmdSlotBit = (UINT32)(1 << CommandSlot);
-
   AhciClearPortStatus (
     PciIo,
     Port
@@ -1645,6 +1742,42 @@ AhciStartCommand (
   Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
   AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST | StartCmd);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Start command for give slot on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  CommandSlot        The number of Command Slot.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommand (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT8                CommandSlot,
+  IN  UINT64               Timeout
+  )
+{
+  UINT32      CmdSlotBit;
+  EFI_STATUS  Status;
+  UINT32      Offset;
+
+  CmdSlotBit = (UINT32)(1 << CommandSlot);
+
+  Status = AhciStartPort (PciIo, Port, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Setting the command
   //
@@ -1655,6 +1788,372 @@ AhciStartCommand (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the number of commands a non-blocking task may share the device with through
+  Native Command Queuing.
+
+  Only READ DMA EXT and WRITE DMA EXT commands to a hard disk attached directly to a
+  port of an AHCI HBA which supports NCQ are queued.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Task        Pointer to the ATA_NONBLOCK_TASK.
+
+  @return The NCQ queue depth for the task, or 0 if the task can't be queued.
+
+**/
+UINT8
+AhciGetNcqDepth (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN ATA_NONBLOCK_TASK             *Task
+  )
+{
+  EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  LIST_ENTRY                        *Node;
+  EFI_ATA_DEVICE_INFO               *DeviceInfo;
+  ATA_IDENTIFY_DATA                 *IdentifyData;
+  UINT32                            DataCount;
+
+  if ((Instance->Mode != EfiAtaAhciMode) ||
+      (Instance->AhciRegisters.AhciNcqCommandTable == NULL) ||
+      (Task->PortMultiplier != 0xFFFF))
+  {
+    return 0;
+  }
+
+  Packet = Task->Packet;
+  if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_UDMA_DATA_IN) &&
+      (Packet->Acb->AtaCommand == ATA_CMD_READ_DMA_EXT))
+  {
+    DataCount = Packet->InTransferLength;
+  } else if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_UDMA_DATA_OUT) &&
+             (Packet->Acb->AtaCommand == ATA_CMD_WRITE_DMA_EXT))
+  {
+    DataCount = Packet->OutTransferLength;
+  } else {
+    return 0;
+  }
+
+  if ((DataCount == 0) ||
+      (DivU64x32 ((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1, EFI_AHCI_MAX_DATA_PER_PRDT) > AHCI_NCQ_MAX_PRDT_NUMBER))
+  {
+    return 0;
+  }
+
+  Node = SearchDeviceInfoList (Instance, Task->Port, Task->PortMultiplier, EfiIdeHarddisk);
+  if (Node == NULL) {
+    return 0;
+  }
+
+  DeviceInfo   = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+  IdentifyData = &DeviceInfo->IdentifyData->AtaData;
+
+  //
+  // Word 76 bit 8 reports NCQ support, word 75 bits 4:0 the maximum queue depth - 1.
+  //
+  if ((IdentifyData->serial_ata_capabilities == 0xFFFF) ||
+      ((IdentifyData->serial_ata_capabilities & BIT8) == 0))
+  {
+    return 0;
+  }
+
+  return (UINT8)MIN ((IdentifyData->queue_depth & 0x1F) + 1, Instance->AhciRegisters.NcqSlotNumber);
+}
+
+/**
+  Issue a non-blocking task as a READ FPDMA QUEUED or WRITE FPDMA QUEUED command.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Task        Pointer to the ATA_NONBLOCK_TASK.
+  @param[in]  Depth       The NCQ queue depth returned by AhciGetNcqDepth().
+
+  @retval EFI_SUCCESS          The command is issued.
+  @retval EFI_NOT_READY        No command slot is free, or queued commands are outstanding
+                               on another port.
+  @retval EFI_BAD_BUFFER_SIZE  The data buffer can't be mapped.
+  @retval Others               The port failed to start.
+
+**/
+EFI_STATUS
+AhciIssueNcqTask (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN ATA_NONBLOCK_TASK             *Task,
+  IN UINT8                         Depth
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  EFI_AHCI_REGISTERS                *AhciRegisters;
+  EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  AHCI_NCQ_COMMAND_TABLE            *CommandTable;
+  EFI_AHCI_COMMAND_LIST             *CommandList;
+  EFI_AHCI_COMMAND_FIS              *CommandFis;
+  EFI_PCI_IO_PROTOCOL_OPERATION     Flag;
+  EFI_PHYSICAL_ADDRESS              PhyAddr;
+  VOID                              *MemoryAddr;
+  UINTN                             MapLength;
+  UINT32                            DataCount;
+  UINT32                            PrdtNumber;
+  UINT32                            PrdtIndex;
+  UINT32                            Offset;
+  DATA_64                           Data64;
+  BOOLEAN                           Read;
+  UINT8                             Port;
+  UINT8                             Slot;
+
+  PciIo         = Instance->PciIo;
+  AhciRegisters = &Instance->AhciRegisters;
+  Packet        = Task->Packet;
+  Port          = (UINT8)Task->Port;
+
+  if ((Instance->NcqActiveSlots != 0) && (Instance->NcqPort != Port)) {
+    return EFI_NOT_READY;
+  }
+
+  for (Slot = 0; Slot < Depth; Slot++) {
+    if ((Instance->NcqActiveSlots & (UINT32)(1 << Slot)) == 0) {
+      break;
+    }
+  }
+
+  if (Slot == Depth) {
+    return EFI_NOT_READY;
+  }
+
+  Read = (BOOLEAN)(Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_UDMA_DATA_IN);
+  if (Read) {
+    Flag       = EfiPciIoOperationBusMasterWrite;
+    MemoryAddr = Packet->InDataBuffer;
+    DataCount  = Packet->InTransferLength;
+  } else {
+    Flag       = EfiPciIoOperationBusMasterRead;
+    MemoryAddr = Packet->OutDataBuffer;
+    DataCount  = Packet->OutTransferLength;
+  }
+
+  MapLength = DataCount;
+  Status    = PciIo->Map (
+                       PciIo,
+                       Flag,
+                       MemoryAddr,
+                       &MapLength,
+                       &PhyAddr,
+                       &Task->Map
+                       );
+  if (EFI_ERROR (Status) || (DataCount != MapLength)) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Task->Map);
+    }
+
+    Task->Map = NULL;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  //
+  // The sector count moves to the Features register and the tag, which is the command
+  // slot, takes its place. Device register bit 6 selects LBA addressing.
+  //
+  CommandTable = &AhciRegisters->AhciNcqCommandTable[Slot];
+  CommandFis   = &CommandTable->CommandFis;
+  ZeroMem (CommandTable, sizeof (AHCI_NCQ_COMMAND_TABLE));
+  AhciBuildCommandFis (CommandFis, Packet->Acb);
+  CommandFis->AhciCFisCmd         = Read ? ATA_CMD_READ_FPDMA_QUEUED : ATA_CMD_WRITE_FPDMA_QUEUED;
+  CommandFis->AhciCFisFeature     = Packet->Acb->AtaSectorCount;
+  CommandFis->AhciCFisFeatureExp  = Packet->Acb->AtaSectorCountExp;
+  CommandFis->AhciCFisSecCount    = (UINT8)(Slot << 3);
+  CommandFis->AhciCFisSecCountExp = 0;
+  CommandFis->AhciCFisDevHead     = BIT6;
+
+  PrdtNumber = (UINT32)DivU64x32 ((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1, EFI_AHCI_MAX_DATA_PER_PRDT);
+  ASSERT (PrdtNumber <= AHCI_NCQ_MAX_PRDT_NUMBER);
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    Data64.Uint64                                   = PhyAddr + MultU64x32 (EFI_AHCI_MAX_DATA_PER_PRDT, PrdtIndex);
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba  = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau = Data64.Uint32.Upper32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc  = MIN (DataCount - PrdtIndex * EFI_AHCI_MAX_DATA_PER_PRDT, EFI_AHCI_MAX_DATA_PER_PRDT) - 1;
+  }
+
+  CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
+
+  CommandList = &AhciRegisters->AhciCmdList[Slot];
+  ZeroMem (CommandList, sizeof (EFI_AHCI_COMMAND_LIST));
+  CommandList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+  CommandList->AhciCmdW     = Read ? 0 : 1;
+  CommandList->AhciCmdPrdtl = PrdtNumber;
+  Data64.Uint64             = (UINT64)(UINTN)&AhciRegisters->AhciNcqCommandTablePciAddr[Slot];
+  CommandList->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CommandList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
+  if (Instance->NcqActiveSlots == 0) {
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+    AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+
+    Status = AhciStartPort (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    if (EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map = NULL;
+      return Status;
+    }
+
+    Instance->NcqPort = Port;
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "Starting NCQ command on port %d slot %d:\n", Port, Slot));
+  AhciPrintCommandBlock (Packet->Acb, DEBUG_VERBOSE);
+
+  //
+  // PxSACT must be set before PxCI. Writing 0 to either register has no effect.
+  //
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+  AhciWriteReg (PciIo, Offset, (UINT32)(1 << Slot));
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+  AhciWriteReg (PciIo, Offset, (UINT32)(1 << Slot));
+
+  Task->IsStart             = TRUE;
+  Instance->NcqTasks[Slot]  = Task;
+  Instance->NcqActiveSlots |= (UINT32)(1 << Slot);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Complete the queued commands the device has finished.
+
+  The tasks of completed commands are removed from the non-blocking task list and their
+  events are signaled. On an error or a timeout, all the queued commands are aborted and
+  their tasks are left in the list for the caller to fail.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS          No error occurred.
+  @retval EFI_DEVICE_ERROR     A queued command failed.
+  @retval EFI_TIMEOUT          A queued command timed out.
+
+**/
+EFI_STATUS
+AhciCheckNcqCompletion (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  ATA_NONBLOCK_TASK    *Task;
+  UINT32               PortInterrupt;
+  UINT32               Outstanding;
+  UINT32               Offset;
+  UINT8                Port;
+  UINT8                Slot;
+
+  if (Instance->NcqActiveSlots == 0) {
+    return EFI_SUCCESS;
+  }
+
+  PciIo  = Instance->PciIo;
+  Port   = Instance->NcqPort;
+  Status = EFI_SUCCESS;
+
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+  PortInterrupt = AhciReadReg (PciIo, Offset);
+  if ((PortInterrupt & EFI_AHCI_PORT_IS_ERROR_MASK) != 0) {
+    DEBUG ((DEBUG_ERROR, "AHCI: NCQ error interrupt reported PxIS: %X\n", PortInterrupt));
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  //
+  // A command is complete when the HBA has sent it (PxCI) and the device has reported
+  // its completion with a Set Device Bits FIS (PxSACT).
+  //
+  Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+  Outstanding  = AhciReadReg (PciIo, Offset);
+  Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+  Outstanding |= AhciReadReg (PciIo, Offset);
+
+  for (Slot = 0; (Slot < AHCI_NCQ_MAX_SLOTS) && !EFI_ERROR (Status); Slot++) {
+    if ((Instance->NcqActiveSlots & (UINT32)(1 << Slot)) == 0) {
+      continue;
+    }
+
+    Task = Instance->NcqTasks[Slot];
+    if ((Outstanding & (UINT32)(1 << Slot)) == 0) {
+      PciIo->Unmap (PciIo, Task->Map);
+      ZeroMem (Task->Packet->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+      Task->Packet->Asb->AtaStatus = ATA_STSREG_DRDY | ATA_STSREG_DSC;
+
+      Instance->NcqTasks[Slot]  = NULL;
+      Instance->NcqActiveSlots &= ~(UINT32)(1 << Slot);
+
+      RemoveEntryList (&Task->Link);
+      gBS->SignalEvent (Task->Event);
+      FreePool (Task);
+    } else if (!Task->InfiniteWait) {
+      if (Task->RetryTimes == 0) {
+        DEBUG ((DEBUG_ERROR, "AHCI: NCQ command on port %d slot %d timed out\n", Port, Slot));
+        Status = EFI_TIMEOUT;
+      } else {
+        Task->RetryTimes--;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // The device aborts all its queued commands on an error. Stop the port to abort the
+    // ones the HBA still holds, and release them.
+    //
+    AhciRecoverPortError (PciIo, Port);
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    for (Slot = 0; Slot < AHCI_NCQ_MAX_SLOTS; Slot++) {
+      if ((Instance->NcqActiveSlots & (UINT32)(1 << Slot)) != 0) {
+        PciIo->Unmap (PciIo, Instance->NcqTasks[Slot]->Map);
+        Instance->NcqTasks[Slot]->Map = NULL;
+        Instance->NcqTasks[Slot]      = NULL;
+      }
+    }
+
+    Instance->NcqActiveSlots = 0;
+  }
+
+  if (Instance->NcqActiveSlots == 0) {
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  }
+
+  return Status;
+}
+
+/**
+  Wait for all the queued commands to complete, before a command which needs command
+  slot 0 of the shared command list is sent.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+AhciWaitNcqIdle (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Instance->NcqActiveSlots == 0) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (Instance->NcqActiveSlots != 0) {
+    if (EFI_ERROR (AhciCheckNcqCompletion (Instance))) {
+      DestroyAsynTaskList (Instance, TRUE);
+      break;
+    }
+
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Do AHCI HBA reset.
 
@@ -2200,6 +2699,73 @@ AhciPacketCommandExecute (
   return Status;
 }
 
+/**
+  Allocate the per command slot tables used by Native Command Queuing.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param  SlotNumber            The number of command slots to allocate tables for.
+  @param  Support64Bit          Whether the HBA supports 64-bit addressing.
+
+**/
+VOID
+AhciCreateNcqCommandTables (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN     UINT8                SlotNumber,
+  IN     BOOLEAN              Support64Bit
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  UINT64                MaxNcqCommandTableSize;
+  EFI_PHYSICAL_ADDRESS  AhciNcqCommandTablePciAddr;
+
+  MaxNcqCommandTableSize = SlotNumber * sizeof (AHCI_NCQ_COMMAND_TABLE);
+
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES ((UINTN)MaxNcqCommandTableSize),
+                    &Buffer,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxNcqCommandTableSize);
+  Bytes = (UINTN)MaxNcqCommandTableSize;
+
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciNcqCommandTablePciAddr,
+                    &AhciRegisters->MapNcqCommandTable
+                    );
+  if (EFI_ERROR (Status) || (Bytes != MaxNcqCommandTableSize) ||
+      ((!Support64Bit) && (AhciNcqCommandTablePciAddr + MaxNcqCommandTableSize > 0x100000000ULL)))
+  {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, AhciRegisters->MapNcqCommandTable);
+    }
+
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES ((UINTN)MaxNcqCommandTableSize), Buffer);
+    AhciRegisters->MapNcqCommandTable = NULL;
+    DEBUG ((DEBUG_WARN, "AHCI: Unable to map NCQ command tables, NCQ is disabled\n"));
+    return;
+  }
+
+  AhciRegisters->AhciNcqCommandTable        = Buffer;
+  AhciRegisters->AhciNcqCommandTablePciAddr = (AHCI_NCQ_COMMAND_TABLE *)(UINTN)AhciNcqCommandTablePciAddr;
+  AhciRegisters->MaxNcqCommandTableSize     = MaxNcqCommandTableSize;
+  AhciRegisters->NcqSlotNumber              = SlotNumber;
+}
+
 /**
   Allocate transfer-related data struct which is used at AHCI mode.
 
@@ -2410,6 +2976,14 @@ AhciCreateTransferDescriptor (
 
   AhciRegisters->AhciCommandTablePciAddr = (EFI_AHCI_COMMAND_TABLE *)(UINTN)AhciCommandTablePciAddr;
 
+  //
+  // Allocate one command table per command slot for Native Command Queuing. NCQ is
+  // optional, so a failure here leaves it disabled.
+  //
+  if ((Capability & EFI_AHCI_CAP_SNCQ) != 0) {
+    AhciCreateNcqCommandTables (PciIo, AhciRegisters, MIN (MaxCommandSlotNumber, AHCI_NCQ_MAX_SLOTS), Support64Bit);
+  }
+
   return EFI_SUCCESS;
   //
   // Map error or unable to map the whole CmdList buffer into a contiguous region.
@@ -2881,7 +3455,7 @@ AhciModeInitialization (
   EFI_ATA_DEVICE_TYPE      DeviceType;
   EFI_ATA_COLLECTIVE_MODE  *SupportedModes;
   EFI_ATA_TRANSFER_MODE    TransferMode;
-  UINT32                   PhyDetectDelay;
+  AHCI_WAIT_PORT_CONTEXT   WaitContext;
   UINT32                   Value;
 
   if (Instance == NULL) {
@@ -3014,19 +3588,16 @@ AhciModeInitialization (
       //
       // Wait for the Phy to detect the presence of a device.
       //
-      PhyDetectDelay = EFI_AHCI_BUS_PHY_DETECT_TIMEOUT;
-      Offset         = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
-      do {
-        Data = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
-        if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
-          break;
-        }
-
-        MicroSecondDelay (1000);
-        PhyDetectDelay--;
-      } while (PhyDetectDelay > 0);
-
-      if (PhyDetectDelay == 0) {
+      WaitContext.PciIo = PciIo;
+      WaitContext.Port  = Port;
+      Status            = PollLibWaitUntil (
+                            "AhciPhyDetect",
+                            AhciCheckPhyDetect,
+                            &WaitContext,
+                            EFI_AHCI_BUS_PHY_DETECT_TIMEOUT * 1000,
+                            1000
+                            );
+      if (EFI_ERROR (Status)) {
         //
         // No device detected at this port.
         // Clear PxCMD.SUD for those ports at which there are no device present.
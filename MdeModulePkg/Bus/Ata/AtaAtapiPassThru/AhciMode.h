@@ -14,6 +14,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET  0x0000
 #define   EFI_AHCI_CAP_SAM          BIT18
 #define   EFI_AHCI_CAP_SSS          BIT27
+#define   EFI_AHCI_CAP_SNCQ         BIT30
 #define   EFI_AHCI_CAP_S64A         BIT31
 #define EFI_AHCI_GHC_OFFSET         0x0004
 #define   EFI_AHCI_GHC_RESET        BIT0
@@ -62,6 +63,16 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT  0x400000
 
+//
+// Native Command Queuing. Each command slot used for NCQ has its own command table with
+// AHCI_NCQ_MAX_PRDT_NUMBER PRDT entries, which is enough for a 48-bit LBA transfer of
+// 65536 sectors of 4KB.
+//
+#define AHCI_NCQ_MAX_SLOTS          32
+#define AHCI_NCQ_MAX_PRDT_NUMBER    64
+#define ATA_CMD_READ_FPDMA_QUEUED   0x60
+#define ATA_CMD_WRITE_FPDMA_QUEUED  0x61
+
 #define EFI_AHCI_FIS_REGISTER_H2D           0x27         // Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH  20
 #define EFI_AHCI_FIS_REGISTER_D2H           0x34         // Register FIS - Device to Host
@@ -286,6 +297,16 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table of a command slot used for Native Command Queuing
+//
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;       // A software constructed FIS.
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;         // 12 or 16 bytes ATAPI cmd.
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[AHCI_NCQ_MAX_PRDT_NUMBER];
+} AHCI_NCQ_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -325,6 +346,14 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+  //
+  // One command table per NCQ command slot, NULL if the HBA doesn't support NCQ.
+  //
+  AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTable;
+  AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTablePciAddr;
+  UINT64                    MaxNcqCommandTableSize;
+  VOID                      *MapNcqCommandTable;
+  UINT8                     NcqSlotNumber;
 } EFI_AHCI_REGISTERS;
 
 /**
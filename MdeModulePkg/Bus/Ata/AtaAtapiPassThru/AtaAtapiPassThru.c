@@ -277,6 +277,13 @@ AtaPassThruPassThruExecute (
 
       break;
     case EfiAtaAhciMode:
+      if (Task == NULL) {
+        //
+        // Blocking commands use command slot 0, which may hold a queued command.
+        //
+        AhciWaitNcqIdle (Instance);
+      }
+
       if (PortMultiplierPort == 0xFFFF) {
         //
         // If there is no port multiplier, PortMultiplierPort will be 0xFFFF
@@ -403,19 +410,56 @@ AsyncNonBlockingTransferRoutine (
   ATA_NONBLOCK_TASK             *Task;
   EFI_STATUS                    Status;
   ATA_ATAPI_PASS_THRU_INSTANCE  *Instance;
+  UINT8                         Depth;
 
   Instance    = (ATA_ATAPI_PASS_THRU_INSTANCE *)Context;
   EntryHeader = &Instance->NonBlockingTaskList;
+
+  //
+  // Retire the queued commands the device has completed. An error aborts all of them.
+  //
+  if (Instance->NcqActiveSlots != 0) {
+    Status = AhciCheckNcqCompletion (Instance);
+    if (EFI_ERROR (Status)) {
+      DestroyAsynTaskList (Instance, TRUE);
+      return;
+    }
+  }
+
   //
   // Get the Tasks from the Tasks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
+  // Tasks which can be queued with NCQ are issued back to back while slots are free.
   //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  Entry = GetFirstNode (EntryHeader);
+  while (!IsNull (EntryHeader, Entry)) {
+    Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    Entry = GetNextNode (EntryHeader, Entry);
+
+    Depth = AhciGetNcqDepth (Instance, Task);
+    if (Depth != 0) {
+      if (Task->IsStart) {
+        continue;
+      }
+
+      Status = AhciIssueNcqTask (Instance, Task, Depth);
+      if (Status == EFI_NOT_READY) {
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        DestroyAsynTaskList (Instance, TRUE);
+        break;
+      }
+
+      continue;
+    }
+
+    //
+    // Other commands use command slot 0 and wait until the queued commands are done.
+    //
+    if (Instance->NcqActiveSlots != 0) {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -928,6 +972,10 @@ AtaAtapiPassThruStop (
     Instance->TimerEvent = NULL;
   }
 
+  if (Instance->Mode == EfiAtaAhciMode) {
+    AhciWaitNcqIdle (Instance);
+  }
+
   DestroyAsynTaskList (Instance, FALSE);
   //
   // Free allocated resource
@@ -952,6 +1000,18 @@ AtaAtapiPassThruStop (
   //
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    if (AhciRegisters->AhciNcqCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapNcqCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxNcqCommandTableSize),
+               AhciRegisters->AhciNcqCommandTable
+               );
+    }
+
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -2116,6 +2176,7 @@ ExtScsiPassThruPassThru (
         PortMultiplier = 0;
       }
 
+      AhciWaitNcqIdle (Instance);
       Status = AhciPacketCommandExecute (Instance->PciIo, &Instance->AhciRegisters, Port, PortMultiplier, Packet);
       break;
     default:
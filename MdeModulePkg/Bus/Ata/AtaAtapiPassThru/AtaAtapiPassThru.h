@@ -29,6 +29,7 @@
 #include <Library/UefiLib.h>
 #include <Library/PciLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PollLib.h>
 #include <Library/TimerLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/ReportStatusCodeLib.h>
@@ -119,6 +120,15 @@ typedef struct {
   //
   EFI_EVENT                           TimerEvent;
   LIST_ENTRY                          NonBlockingTaskList;
+
+  //
+  // For Native Command Queuing in AHCI mode. All the ports share one command list, so
+  // queued commands are outstanding on one port at a time, and other commands wait for
+  // them to complete.
+  //
+  UINT8                               NcqPort;
+  UINT32                              NcqActiveSlots;
+  ATA_NONBLOCK_TASK                   *NcqTasks[AHCI_NCQ_MAX_SLOTS];
 } ATA_ATAPI_PASS_THRU_INSTANCE;
 
 //
@@ -1148,6 +1158,77 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK             *Task
   );
 
+/**
+  Get the number of commands a non-blocking task may share the device with through
+  Native Command Queuing.
+
+  Only READ DMA EXT and WRITE DMA EXT commands to a hard disk attached directly to a
+  port of an AHCI HBA which supports NCQ are queued.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Task        Pointer to the ATA_NONBLOCK_TASK.
+
+  @return The NCQ queue depth for the task, or 0 if the task can't be queued.
+
+**/
+UINT8
+AhciGetNcqDepth (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN ATA_NONBLOCK_TASK             *Task
+  );
+
+/**
+  Issue a non-blocking task as a READ FPDMA QUEUED or WRITE FPDMA QUEUED command.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Task        Pointer to the ATA_NONBLOCK_TASK.
+  @param[in]  Depth       The NCQ queue depth returned by AhciGetNcqDepth().
+
+  @retval EFI_SUCCESS          The command is issued.
+  @retval EFI_NOT_READY        No command slot is free, or queued commands are outstanding
+                               on another port.
+  @retval EFI_BAD_BUFFER_SIZE  The data buffer can't be mapped.
+  @retval Others               The port failed to start.
+
+**/
+EFI_STATUS
+AhciIssueNcqTask (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN ATA_NONBLOCK_TASK             *Task,
+  IN UINT8                         Depth
+  );
+
+/**
+  Complete the queued commands the device has finished.
+
+  The tasks of completed commands are removed from the non-blocking task list and their
+  events are signaled. On an error or a timeout, all the queued commands are aborted and
+  their tasks are left in the list for the caller to fail.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS          No error occurred.
+  @retval EFI_DEVICE_ERROR     A queued command failed.
+  @retval EFI_TIMEOUT          A queued command timed out.
+
+**/
+EFI_STATUS
+AhciCheckNcqCompletion (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
+/**
+  Wait for all the queued commands to complete, before a command which needs command
+  slot 0 of the shared command list is sent.
+
+  @param[in]  Instance    A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+AhciWaitNcqIdle (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
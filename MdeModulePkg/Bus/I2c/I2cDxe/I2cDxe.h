@@ -25,6 +25,7 @@
 #include <Protocol/DriverBinding.h>
 #include <Protocol/I2cEnumerate.h>
 #include <Protocol/I2cHost.h>
+#include <Protocol/I2cHostBatch.h>
 #include <Protocol/I2cIo.h>
 #include <Protocol/I2cMaster.h>
 #include <Protocol/I2cBusConfigurationManagement.h>
@@ -88,6 +89,21 @@ typedef struct {
 
 #define I2C_DEVICE_CONTEXT_FROM_PROTOCOL(a)  CR (a, I2C_DEVICE_CONTEXT, I2cIo, I2C_DEVICE_SIGNATURE)
 
+//
+// I2C register reads queued by one EDKII_I2C_HOST_BATCH_PROTOCOL call
+//
+typedef struct {
+  //
+  // Number of the reads that did not complete yet
+  //
+  UINTN        Pending;
+
+  //
+  // Event to set when all the reads completed
+  //
+  EFI_EVENT    Event;
+} I2C_BATCH;
+
 //
 // I2C Request
 //
@@ -127,6 +143,16 @@ typedef struct {
   // Optional buffer to receive the I2C operation completion status
   //
   EFI_STATUS                *Status;
+
+  //
+  // Batch the request is part of, NULL for a request of QueueRequest
+  //
+  I2C_BATCH                 *Batch;
+
+  //
+  // Register address written by a request of a batch
+  //
+  UINT8                     Register[2];
 } I2C_REQUEST;
 
 #define I2C_REQUEST_FROM_ENTRY(a)  CR (a, I2C_REQUEST, Link, I2C_REQUEST_SIGNATURE);
@@ -175,6 +201,11 @@ typedef struct {
   //
   EFI_I2C_HOST_PROTOCOL                            I2cHost;
 
+  //
+  // Batched register reads API
+  //
+  EDKII_I2C_HOST_BATCH_PROTOCOL                    I2cHostBatch;
+
   //
   // I2C bus configuration management protocol
   //
@@ -186,7 +217,8 @@ typedef struct {
   EFI_I2C_MASTER_PROTOCOL                          *I2cMaster;
 } I2C_HOST_CONTEXT;
 
-#define I2C_HOST_CONTEXT_FROM_PROTOCOL(a)  CR (a, I2C_HOST_CONTEXT, I2cHost, I2C_HOST_SIGNATURE)
+#define I2C_HOST_CONTEXT_FROM_PROTOCOL(a)        CR (a, I2C_HOST_CONTEXT, I2cHost, I2C_HOST_SIGNATURE)
+#define I2C_HOST_CONTEXT_FROM_BATCH_PROTOCOL(a)  CR (a, I2C_HOST_CONTEXT, I2cHostBatch, I2C_HOST_SIGNATURE)
 
 //
 // Global Variables
@@ -1053,6 +1085,43 @@ I2cHostQueueRequest (
   OUT EFI_STATUS                  *I2cStatus       OPTIONAL
   );
 
+/**
+  Queue several register reads for execution on the I2C controller.
+
+  Each read is queued as an I2C request that writes the register address and
+  then reads the registers, so the reads are processed back to back in the
+  FIFO order of the I2C host.
+
+  @param[in]     This                 Address of an EDKII_I2C_HOST_BATCH_PROTOCOL instance.
+  @param[in]     I2cBusConfiguration  I2C bus configuration to access the I2C devices.
+  @param[in,out] Reads                The register reads to perform. The Status of each
+                                      read receives its result.
+  @param[in]     ReadCount            The number of reads.
+  @param[in]     Event                Event to signal when all the reads completed, NULL
+                                      for synchronous operations.
+
+  @retval EFI_SUCCESS                 For synchronous operations, all the reads
+                                      completed successfully. For asynchronous
+                                      operations, the reads were queued.
+  @retval EFI_INVALID_PARAMETER       Reads is NULL, ReadCount is zero or a read is
+                                      invalid.
+  @retval EFI_INVALID_PARAMETER       TPL is too high.
+  @retval EFI_NOT_FOUND               I2C slave address of a read exceeds maximum address.
+  @retval EFI_OUT_OF_RESOURCES        Insufficient memory for I2C operations.
+  @retval Others                      For synchronous operations, the Status of the
+                                      first read that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+I2cHostQueueRegisterReads (
+  IN CONST EDKII_I2C_HOST_BATCH_PROTOCOL  *This,
+  IN UINTN                                I2cBusConfiguration,
+  IN OUT EDKII_I2C_REGISTER_READ          *Reads,
+  IN UINTN                                ReadCount,
+  IN EFI_EVENT                            Event      OPTIONAL
+  );
+
 /**
   The user Entry Point for I2C host module. The user code starts with this function.
 
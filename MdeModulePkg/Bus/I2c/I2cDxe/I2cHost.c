@@ -426,6 +426,7 @@ I2cHostDriverStart (
   //
   I2cHostContext->I2cHost.QueueRequest              = I2cHostQueueRequest;
   I2cHostContext->I2cHost.I2cControllerCapabilities = I2cMaster->I2cControllerCapabilities;
+  I2cHostContext->I2cHostBatch.QueueRegisterReads   = I2cHostQueueRegisterReads;
 
   //
   //  Install the driver protocol
@@ -434,6 +435,8 @@ I2cHostDriverStart (
                   &Controller,
                   &gEfiI2cHostProtocolGuid,
                   &I2cHostContext->I2cHost,
+                  &gEdkiiI2cHostBatchProtocolGuid,
+                  &I2cHostContext->I2cHostBatch,
                   NULL
                   );
 Exit:
@@ -552,6 +555,8 @@ I2cHostDriverStop (
                     Controller,
                     &gEfiI2cHostProtocolGuid,
                     I2cHost,
+                    &gEdkiiI2cHostBatchProtocolGuid,
+                    &I2cHostContext->I2cHostBatch,
                     NULL
                     );
   }
@@ -715,6 +720,17 @@ I2cHostRequestComplete (
     gBS->SignalEvent (I2cRequest->Event);
   }
 
+  //
+  //  Notify the user once all the reads of a batch completed
+  //
+  if ( NULL != I2cRequest->Batch ) {
+    I2cRequest->Batch->Pending--;
+    if (I2cRequest->Batch->Pending == 0) {
+      gBS->SignalEvent (I2cRequest->Batch->Event);
+      FreePool (I2cRequest->Batch);
+    }
+  }
+
   //
   // Done with this request, remove the current request from list
   //
@@ -846,6 +862,40 @@ I2cHostRequestEnable (
   return Status;
 }
 
+/**
+  Check that no reserved bit is set in an I2C slave address.
+
+  @param[in] SlaveAddress     Address of the device on the I2C bus.
+
+  @retval TRUE                The slave address is valid.
+  @retval FALSE               A reserved bit is set in the slave address.
+
+**/
+STATIC
+BOOLEAN
+I2cHostIsSlaveAddressValid (
+  IN UINTN  SlaveAddress
+  )
+{
+  UINTN  StartBit;
+
+  if ((SlaveAddress & I2C_ADDRESSING_10_BIT) != 0) {
+    //
+    // 10-bit address, bits 0-9 are used for 10-bit I2C slave addresses,
+    // bits 10-30 are reserved bits and must be zero
+    //
+    StartBit = 10;
+  } else {
+    //
+    // 7-bit address, Bits 0-6 are used for 7-bit I2C slave addresses,
+    // bits 7-30 are reserved bits and must be zero
+    //
+    StartBit = 7;
+  }
+
+  return (BOOLEAN)(BitFieldRead32 ((UINT32)SlaveAddress, StartBit, 30) == 0);
+}
+
 /**
   Queue an I2C operation for execution on the I2C controller.
 
@@ -928,7 +978,6 @@ I2cHostQueueRequest (
   I2C_HOST_CONTEXT  *I2cHostContext;
   BOOLEAN           FirstRequest;
   UINTN             RequestPacketSize;
-  UINTN             StartBit;
 
   SyncEvent    = NULL;
   FirstRequest = FALSE;
@@ -938,24 +987,7 @@ I2cHostQueueRequest (
     return EFI_INVALID_PARAMETER;
   }
 
-  if ((SlaveAddress & I2C_ADDRESSING_10_BIT) != 0) {
-    //
-    // 10-bit address, bits 0-9 are used for 10-bit I2C slave addresses,
-    // bits 10-30 are reserved bits and must be zero
-    //
-    StartBit = 10;
-  } else {
-    //
-    // 7-bit address, Bits 0-6 are used for 7-bit I2C slave addresses,
-    // bits 7-30 are reserved bits and must be zero
-    //
-    StartBit = 7;
-  }
-
-  if (BitFieldRead32 ((UINT32)SlaveAddress, StartBit, 30) != 0) {
-    //
-    // Reserved bit set in the SlaveAddress parameter
-    //
+  if (!I2cHostIsSlaveAddressValid (SlaveAddress)) {
     return EFI_NOT_FOUND;
   }
 
@@ -1074,6 +1106,217 @@ I2cHostQueueRequest (
   return Status;
 }
 
+/**
+  Queue several register reads for execution on the I2C controller.
+
+  Each read is queued as an I2C request that writes the register address and
+  then reads the registers, so the reads are processed back to back in the
+  FIFO order of the I2C host.
+
+  @param[in]     This                 Address of an EDKII_I2C_HOST_BATCH_PROTOCOL instance.
+  @param[in]     I2cBusConfiguration  I2C bus configuration to access the I2C devices.
+  @param[in,out] Reads                The register reads to perform. The Status of each
+                                      read receives its result.
+  @param[in]     ReadCount            The number of reads.
+  @param[in]     Event                Event to signal when all the reads completed, NULL
+                                      for synchronous operations.
+
+  @retval EFI_SUCCESS                 For synchronous operations, all the reads
+                                      completed successfully. For asynchronous
+                                      operations, the reads were queued.
+  @retval EFI_INVALID_PARAMETER       Reads is NULL, ReadCount is zero or a read is
+                                      invalid.
+  @retval EFI_INVALID_PARAMETER       TPL is too high.
+  @retval EFI_NOT_FOUND               I2C slave address of a read exceeds maximum address.
+  @retval EFI_OUT_OF_RESOURCES        Insufficient memory for I2C operations.
+  @retval Others                      For synchronous operations, the Status of the
+                                      first read that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+I2cHostQueueRegisterReads (
+  IN CONST EDKII_I2C_HOST_BATCH_PROTOCOL  *This,
+  IN UINTN                                I2cBusConfiguration,
+  IN OUT EDKII_I2C_REGISTER_READ          *Reads,
+  IN UINTN                                ReadCount,
+  IN EFI_EVENT                            Event      OPTIONAL
+  )
+{
+  EFI_STATUS              Status;
+  EFI_EVENT               SyncEvent;
+  EFI_TPL                 TplPrevious;
+  I2C_HOST_CONTEXT        *I2cHostContext;
+  I2C_BATCH               *Batch;
+  I2C_REQUEST             *I2cRequest;
+  EFI_I2C_REQUEST_PACKET  *RequestPacket;
+  EFI_I2C_OPERATION       *Operation;
+  LIST_ENTRY              Requests;
+  LIST_ENTRY              *Entry;
+  BOOLEAN                 FirstRequest;
+  UINTN                   Index;
+
+  if ((Reads == NULL) || (ReadCount == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < ReadCount; Index++) {
+    if ((Reads[Index].Buffer == NULL) || (Reads[Index].Length == 0) || (Reads[Index].RegisterSize > 2)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (!I2cHostIsSlaveAddressValid (Reads[Index].SlaveAddress)) {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  //
+  // TPL should be at or below TPL_NOTIFY.
+  // For synchronous requests this routine must be called at or below TPL_CALLBACK.
+  //
+  TplPrevious = EfiGetCurrentTpl ();
+  if ((TplPrevious > TPL_I2C_SYNC) || ((Event == NULL) && (TplPrevious > TPL_CALLBACK))) {
+    DEBUG ((DEBUG_ERROR, "ERROR - TPL %d is too high!\n", TplPrevious));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  I2cHostContext = I2C_HOST_CONTEXT_FROM_BATCH_PROTOCOL (This);
+  SyncEvent      = NULL;
+  InitializeListHead (&Requests);
+
+  Batch = AllocateZeroPool (sizeof (I2C_BATCH));
+  if (Batch == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Event == NULL) {
+    //
+    // For synchronous transaction, register an event used to wait for finishing synchronous transaction
+    //
+    Status = gBS->CreateEvent (
+                    0,
+                    TPL_I2C_SYNC,
+                    NULL,
+                    NULL,
+                    &SyncEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      FreePool (Batch);
+      return Status;
+    }
+  }
+
+  Batch->Pending = ReadCount;
+  Batch->Event   = (Event == NULL) ? SyncEvent : Event;
+
+  //
+  // Build all the requests before queueing any of them, the register address
+  // write and the data read of a read are separated by a repeated START
+  //
+  for (Index = 0; Index < ReadCount; Index++) {
+    I2cRequest    = AllocateZeroPool (sizeof (I2C_REQUEST));
+    RequestPacket = AllocateZeroPool (sizeof (UINTN) + 2 * sizeof (EFI_I2C_OPERATION));
+    if ((I2cRequest == NULL) || (RequestPacket == NULL)) {
+      if (I2cRequest != NULL) {
+        FreePool (I2cRequest);
+      }
+
+      if (RequestPacket != NULL) {
+        FreePool (RequestPacket);
+      }
+
+      DEBUG ((DEBUG_ERROR, "WARNING - Failed to allocate I2C_REQUEST!\n"));
+      while (!IsListEmpty (&Requests)) {
+        I2cRequest = I2C_REQUEST_FROM_ENTRY (GetFirstNode (&Requests));
+        RemoveEntryList (&I2cRequest->Link);
+        FreePool (I2cRequest->RequestPacket);
+        FreePool (I2cRequest);
+      }
+
+      if (SyncEvent != NULL) {
+        gBS->CloseEvent (SyncEvent);
+      }
+
+      FreePool (Batch);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    I2cRequest->Signature           = I2C_REQUEST_SIGNATURE;
+    I2cRequest->I2cBusConfiguration = I2cBusConfiguration;
+    I2cRequest->SlaveAddress        = Reads[Index].SlaveAddress;
+    I2cRequest->Status              = &Reads[Index].Status;
+    I2cRequest->Batch               = Batch;
+    I2cRequest->RequestPacket       = RequestPacket;
+
+    Operation = RequestPacket->Operation;
+    if (Reads[Index].RegisterSize == 2) {
+      I2cRequest->Register[0] = (UINT8)(Reads[Index].Register >> 8);
+      I2cRequest->Register[1] = (UINT8)Reads[Index].Register;
+    } else {
+      I2cRequest->Register[0] = (UINT8)Reads[Index].Register;
+    }
+
+    if (Reads[Index].RegisterSize != 0) {
+      Operation->Flags         = 0;
+      Operation->LengthInBytes = Reads[Index].RegisterSize;
+      Operation->Buffer        = I2cRequest->Register;
+      Operation++;
+    }
+
+    Operation->Flags              = I2C_FLAG_READ;
+    Operation->LengthInBytes      = Reads[Index].Length;
+    Operation->Buffer             = Reads[Index].Buffer;
+    RequestPacket->OperationCount = (Reads[Index].RegisterSize != 0) ? 2 : 1;
+
+    Reads[Index].Status = EFI_NOT_READY;
+    InsertTailList (&Requests, &I2cRequest->Link);
+  }
+
+  //
+  // Synchronize with the other threads, and queue all the requests at once
+  //
+  gBS->RaiseTPL (TPL_I2C_SYNC);
+
+  FirstRequest = IsListEmpty (&I2cHostContext->RequestList);
+  while (!IsListEmpty (&Requests)) {
+    Entry = GetFirstNode (&Requests);
+    RemoveEntryList (Entry);
+    InsertTailList (&I2cHostContext->RequestList, Entry);
+  }
+
+  gBS->RestoreTPL (TplPrevious);
+
+  if (FirstRequest) {
+    //
+    // Start the first I2C request, then the subsequent of I2C request will continue
+    //
+    I2cHostRequestEnable (I2cHostContext);
+  }
+
+  if (Event != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // For synchronous transaction, wait for the completion of all the reads
+  //
+  do {
+    Status = gBS->CheckEvent (SyncEvent);
+  } while (Status == EFI_NOT_READY);
+
+  gBS->CloseEvent (SyncEvent);
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < ReadCount; Index++) {
+    if (EFI_ERROR (Reads[Index].Status)) {
+      Status = Reads[Index].Status;
+      break;
+    }
+  }
+
+  return Status;
+}
+
 /**
   The user Entry Point for I2C host module. The user code starts with this function.
 
@@ -527,6 +527,115 @@ UnregisterNvmeNamespace (
   return EFI_SUCCESS;
 }
 
+/**
+  Reap the completions of an asynchronous I/O completion queue.
+
+  All the new completion queue entries are processed before the completion queue
+  head doorbell is written once.
+
+  @param[in]  Private   The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  QueueId   The asynchronous I/O queue Id.
+
+**/
+VOID
+NvmeReapAsyncCompletions (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT16                        QueueId
+  )
+{
+  EFI_PCI_IO_PROTOCOL       *PciIo;
+  NVME_CQ                   *Cq;
+  UINT32                    Data;
+  NVME_PASS_THRU_ASYNC_REQ  **AsyncRequests;
+  NVME_PASS_THRU_ASYNC_REQ  *AsyncRequest;
+  BOOLEAN                   HasNewItem;
+
+  PciIo         = Private->PciIo;
+  AsyncRequests = Private->AsyncRequests + (QueueId - NVME_ASYNC_QUEUE_ID) * Private->AsyncQueueSlots;
+  Cq            = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  HasNewItem    = FALSE;
+
+  while (Cq->Pt != Private->Pt[QueueId]) {
+    ASSERT (Cq->Sqid == QueueId);
+
+    HasNewItem = TRUE;
+
+    //
+    // Find the command with given Command Id.
+    //
+    AsyncRequest = NULL;
+    if (Cq->Cid < Private->AsyncQueueSize) {
+      AsyncRequest = AsyncRequests[Cq->Cid];
+    }
+
+    if (AsyncRequest != NULL) {
+      ASSERT (AsyncRequest->CommandId == Cq->Cid);
+
+      //
+      // Copy the Respose Queue entry for this command to the callers
+      // response buffer.
+      //
+      CopyMem (
+        AsyncRequest->Packet->NvmeCompletion,
+        Cq,
+        sizeof (EFI_NVM_EXPRESS_COMPLETION)
+        );
+
+      //
+      // Free the resources allocated before cmd submission
+      //
+      if (AsyncRequest->MapData != NULL) {
+        PciIo->Unmap (PciIo, AsyncRequest->MapData);
+      }
+
+      if (AsyncRequest->MapMeta != NULL) {
+        PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
+      }
+
+      if (AsyncRequest->PrpListHost != NULL) {
+        NvmeFreePrpList (
+          Private,
+          AsyncRequest->PrpListHost,
+          AsyncRequest->PrpListNo,
+          AsyncRequest->MapPrpList
+          );
+      }
+
+      RemoveEntryList (&AsyncRequest->Link);
+      AsyncRequests[Cq->Cid] = NULL;
+      gBS->SignalEvent (AsyncRequest->CallerEvent);
+      FreePool (AsyncRequest);
+
+      //
+      // Update submission queue head.
+      //
+      Private->AsyncSqHead[QueueId] = Cq->Sqhd;
+    } else {
+      DEBUG ((DEBUG_ERROR, "%a: no request for queue %d command Id %d\n", __func__, QueueId, Cq->Cid));
+    }
+
+    Private->CqHdbl[QueueId].Cqh++;
+    if (Private->CqHdbl[QueueId].Cqh > Private->AsyncQueueSize) {
+      Private->CqHdbl[QueueId].Cqh = 0;
+      Private->Pt[QueueId]        ^= 1;
+    }
+
+    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+  }
+
+  if (HasNewItem) {
+    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
+    PciIo->Mem.Write (
+                 PciIo,
+                 EfiPciIoWidthUint32,
+                 NVME_BAR,
+                 NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
+                 1,
+                 &Data
+                 );
+  }
+}
+
 /**
   Call back function when the timer event is signaled.
 
@@ -543,24 +652,23 @@ ProcessAsyncTaskList (
   )
 {
   NVME_CONTROLLER_PRIVATE_DATA  *Private;
-  EFI_PCI_IO_PROTOCOL           *PciIo;
-  NVME_CQ                       *Cq;
   UINT16                        QueueId;
-  UINT32                        Data;
   LIST_ENTRY                    *Link;
   LIST_ENTRY                    *NextLink;
-  NVME_PASS_THRU_ASYNC_REQ      *AsyncRequest;
   NVME_BLKIO2_SUBTASK           *Subtask;
   NVME_BLKIO2_REQUEST           *BlkIo2Request;
   EFI_BLOCK_IO2_TOKEN           *Token;
-  BOOLEAN                       HasNewItem;
   EFI_STATUS                    Status;
 
-  Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
-  PciIo      = Private->PciIo;
+  Private = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
+
+  //
+  // Reap the completed commands first, so that the submission queue entries they
+  // occupied can be reused by the subtasks submitted below.
+  //
+  for (QueueId = NVME_ASYNC_QUEUE_ID; QueueId < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueNum; QueueId++) {
+    NvmeReapAsyncCompletions (Private, QueueId);
+  }
 
   //
   // Submit asynchronous subtasks to the NVMe Submission Queue
@@ -635,87 +743,6 @@ ProcessAsyncTaskList (
       }
     }
   }
-
-  while (Cq->Pt != Private->Pt[QueueId]) {
-    ASSERT (Cq->Sqid == QueueId);
-
-    HasNewItem = TRUE;
-
-    //
-    // Find the command with given Command Id.
-    //
-    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
-         !IsNull (&Private->AsyncPassThruQueue, Link);
-         Link = NextLink)
-    {
-      NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
-      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
-      if (AsyncRequest->CommandId == Cq->Cid) {
-        //
-        // Copy the Respose Queue entry for this command to the callers
-        // response buffer.
-        //
-        CopyMem (
-          AsyncRequest->Packet->NvmeCompletion,
-          Cq,
-          sizeof (EFI_NVM_EXPRESS_COMPLETION)
-          );
-
-        //
-        // Free the resources allocated before cmd submission
-        //
-        if (AsyncRequest->MapData != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapData);
-        }
-
-        if (AsyncRequest->MapMeta != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
-        }
-
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
-
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
-        }
-
-        RemoveEntryList (Link);
-        gBS->SignalEvent (AsyncRequest->CallerEvent);
-        FreePool (AsyncRequest);
-
-        //
-        // Update submission queue head.
-        //
-        Private->AsyncSqHead = Cq->Sqhd;
-        break;
-      }
-    }
-
-    Private->CqHdbl[QueueId].Cqh++;
-    if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
-      Private->CqHdbl[QueueId].Cqh = 0;
-      Private->Pt[QueueId]        ^= 1;
-    }
-
-    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  }
-
-  if (HasNewItem) {
-    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
-    PciIo->Mem.Write (
-                 PciIo,
-                 EfiPciIoWidthUint32,
-                 NVME_BAR,
-                 NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
-                 1,
-                 &Data
-                 );
-  }
 }
 
 /**
@@ -1002,21 +1029,33 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
+    // BufferPages x 4kB aligned buffers will be carved out of this buffer.
     // 1st 4kB boundary is the start of the admin submission queue.
     // 2nd 4kB boundary is the start of the admin completion queue.
     // 3rd 4kB boundary is the start of I/O submission queue #1.
     // 4th 4kB boundary is the start of I/O completion queue #1.
-    // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // The asynchronous I/O submission & completion queues follow, with room for
+    // AsyncQueueSlots entries each.
+    // The last NVME_PRP_LIST_POOL_PAGES pages are the PRP list pool.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate BufferPages pages of memory, then map it for bus master read and write.
     //
+    Private->AsyncQueueSlots = NvmeGetAsyncQueueSlots ();
+    Private->BufferPages     = 4 + NvmeGetAsyncQueuePairs () * NvmeGetAsyncQueuePages (Private->AsyncQueueSlots) +
+                               NVME_PRP_LIST_POOL_PAGES;
+    Private->AsyncRequests   = AllocateZeroPool (
+                                 NvmeGetAsyncQueuePairs () * Private->AsyncQueueSlots * sizeof (NVME_PASS_THRU_ASYNC_REQ *)
+                                 );
+    if (Private->AsyncRequests == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      Private->BufferPages,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1024,7 +1063,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (Private->BufferPages);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1034,7 +1073,7 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Private->BufferPages))) {
       goto Exit;
     }
 
@@ -1144,13 +1183,17 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, Private->BufferPages, Private->Buffer);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
     FreePool (Private->ControllerData);
   }
 
+  if ((Private != NULL) && (Private->AsyncRequests != NULL)) {
+    FreePool (Private->AsyncRequests);
+  }
+
   if (Private != NULL) {
     if (Private->TimerEvent != NULL) {
       gBS->CloseEvent (Private->TimerEvent);
@@ -1266,10 +1309,11 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, Private->BufferPages, Private->Buffer);
       }
 
       FreePool (Private->ControllerData);
+      FreePool (Private->AsyncRequests);
       FreePool (Private);
     }
 
@@ -33,16 +33,19 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/PollLib.h>
 #include <Library/PrintLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA  NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA      NVME_DEVICE_PRIVATE_DATA;
+typedef struct _NVME_PASS_THRU_ASYNC_REQ      NVME_PASS_THRU_ASYNC_REQ;
 
 #include "NvmExpressBlockIo.h"
 #include "NvmExpressDiskInfo.h"
@@ -63,20 +66,39 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 #define NVME_CCQ_SIZE  1                                // Number of I/O completion queue entries, which is 0-based
 
 //
-// Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// Maximum number of asynchronous I/O submission & completion queue pairs supported by the driver.
+// The number of pairs and their number of entries are set by PcdNvmeAsyncIoQueuePairs and
+// PcdNvmeAsyncIoQueueDepth, and are limited by what the controller reports.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_MAX_ASYNC_QUEUES  16
+
 //
-// Number of asynchronous I/O completion queue entries, which is 0-based.
-// The asynchronous I/O completion queue size is 4kB in total.
+// Queue 0 is the admin queue, queue 1 is the blocking I/O queue, and the asynchronous I/O
+// queues start at NVME_ASYNC_QUEUE_ID.
 //
-#define NVME_ASYNC_CCQ_SIZE  255
-
-#define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
+#define NVME_ASYNC_QUEUE_ID  2
+#define NVME_MAX_QUEUES      (NVME_ASYNC_QUEUE_ID + NVME_MAX_ASYNC_QUEUES)
 
 #define NVME_CONTROLLER_ID  0
 
+//
+// Number of 4kB pages kept mapped for PRP lists, so that commands with a PRP list don't have
+// to allocate and map one. The pool is carved out after the I/O queues.
+//
+#define NVME_PRP_LIST_POOL_PAGES  32
+
+//
+// PSDT value selecting an SGL for the data transfer and a contiguous metadata buffer.
+//
+#define NVME_PSDT_SGL_MPTR_CONTIGUOUS  1
+
+//
+// SGL Support (SGLS) field of the identify controller data, bits 1:0.
+//
+#define NVME_SGLS_SUPPORT_MASK     (BIT0 | BIT1)
+#define NVME_SGLS_SUPPORTED        BIT0
+#define NVME_SGLS_SUPPORTED_DWORD  BIT1
+
 //
 // Time out value for Nvme transaction execution
 //
@@ -116,16 +138,25 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // BufferPages x 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // The asynchronous I/O submission & completion queues follow, each of them
+  // starting at a 4kB boundary.
+  // The last NVME_PRP_LIST_POOL_PAGES pages are the PRP list pool.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
+  UINTN          BufferPages;
+
+  //
+  // PRP list pool, one bit per page in use.
+  //
+  UINT8          *PrpListPool;
+  UINT8          *PrpListPoolPciAddr;
+  UINT32         PrpListPoolMap;
 
   //
   // Pointers to 4kB aligned submission & completion queues.
@@ -140,7 +171,22 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_SQTDBL    SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
-  UINT16         AsyncSqHead;
+  UINT16         AsyncSqHead[NVME_MAX_QUEUES];
+
+  //
+  // Asynchronous I/O queue pairs. AsyncQueueNum pairs with AsyncQueueSize (0-based) entries are
+  // created, out of the AsyncQueueSlots entries allocated for each. New requests are spread over
+  // the pairs starting with NextAsyncQueue.
+  //
+  UINT16         AsyncQueueNum;
+  UINT16         AsyncQueueSize;
+  UINT16         AsyncQueueSlots;
+  UINT16         NextAsyncQueue;
+
+  //
+  // The outstanding asynchronous requests, indexed by queue and command Id.
+  //
+  NVME_PASS_THRU_ASYNC_REQ  **AsyncRequests;
 
   //
   // Flag to indicate internal IO queue creation.
@@ -286,11 +332,12 @@ typedef struct {
 //
 #define NVME_PASS_THRU_ASYNC_REQ_SIG  SIGNATURE_32 ('N', 'P', 'A', 'R')
 
-typedef struct {
+struct _NVME_PASS_THRU_ASYNC_REQ {
   UINT32                                      Signature;
   LIST_ENTRY                                  Link;
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
+  UINT16                                      QueueId;
   UINT16                                      CommandId;
   VOID                                        *MapPrpList;
   UINTN                                       PrpListNo;
@@ -298,7 +345,7 @@ typedef struct {
   VOID                                        *MapData;
   VOID                                        *MapMeta;
   EFI_EVENT                                   CallerEvent;
-} NVME_PASS_THRU_ASYNC_REQ;
+};
 
 #define NVME_PASS_THRU_ASYNC_REQ_FROM_THIS(a) \
   CR (a,                                                 \
@@ -721,6 +768,54 @@ NvmeDumpStatus (
   IN NVME_CQ  *Cq
   );
 
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Free the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL if the
+                            PRP lists come from the PRP list pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
@@ -828,6 +828,109 @@ NvmeAsyncRead (
   return Status;
 }
 
+/**
+  Read some blocks from the device, with the commands a large read is split into all
+  in flight at the same time.
+
+  A read which needs more than one command is sent as an asynchronous read, and the
+  asynchronous I/O queues are serviced here until it completes, instead of sending the
+  commands one after the other on the blocking I/O queue.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer                 The buffer used to store the data read from the device.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be read.
+
+  @retval EFI_SUCCESS            Datum are read from the device.
+  @retval EFI_TIMEOUT            The read did not complete in time, the controller is reset.
+  @retval Others                 Fail to read all the datum.
+
+**/
+EFI_STATUS
+NvmeOverlappedRead (
+  IN     NVME_DEVICE_PRIVATE_DATA  *Device,
+  OUT VOID                         *Buffer,
+  IN     UINT64                    Lba,
+  IN     UINTN                     Blocks
+  )
+{
+  EFI_STATUS                    Status;
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  UINT32                        MaxTransferBlocks;
+  EFI_BLOCK_IO2_TOKEN           Token;
+  EFI_EVENT                     TimerEvent;
+  BOOLEAN                       TimedOut;
+  EFI_TPL                       OldTpl;
+
+  Private = Device->Controller;
+
+  if (Private->ControllerData->Mdts != 0) {
+    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / Device->Media.BlockSize;
+  } else {
+    MaxTransferBlocks = 1024;
+  }
+
+  if (Blocks <= MaxTransferBlocks) {
+    return NvmeRead (Device, Buffer, Lba, Blocks);
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Allow each command the time it would have had if sent on the blocking I/O queue.
+  //
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Token.Event);
+    return Status;
+  }
+
+  gBS->SetTimer (
+         TimerEvent,
+         TimerRelative,
+         MultU64x64 (NVME_GENERIC_TIMEOUT, DivU64x32 (Blocks + MaxTransferBlocks - 1, MaxTransferBlocks))
+         );
+
+  Token.TransactionStatus = EFI_SUCCESS;
+  Status                  = NvmeAsyncRead (Device, Buffer, Lba, Blocks, &Token);
+  TimedOut                = FALSE;
+
+  while (!EFI_ERROR (Status) && EFI_ERROR (gBS->CheckEvent (Token.Event))) {
+    if (!TimedOut && !EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      //
+      // Timeout occurs. Reset the controller to abort the outstanding commands, which
+      // completes the read.
+      //
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe command.\n", __func__));
+      TimedOut = TRUE;
+
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+      if (!EFI_ERROR (NvmeControllerInit (Private))) {
+        gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+      }
+
+      AbortAsyncPassThruTasks (Private);
+      continue;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = TimedOut ? EFI_TIMEOUT : Token.TransactionStatus;
+  }
+
+  gBS->CloseEvent (TimerEvent);
+  gBS->CloseEvent (Token.Event);
+
+  return Status;
+}
+
 /**
   Write some blocks from the device in an asynchronous manner.
 
@@ -1080,7 +1183,7 @@ NvmeBlockIoReadBlocks (
 
   Device = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
 
-  Status = NvmeRead (Device, Buffer, Lba, NumberOfBlocks);
+  Status = NvmeOverlappedRead (Device, Buffer, Lba, NumberOfBlocks);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -1376,7 +1479,7 @@ NvmeBlockIoReadBlocksEx (
     Token->TransactionStatus = EFI_SUCCESS;
     Status                   = NvmeAsyncRead (Device, Buffer, Lba, NumberOfBlocks, Token);
   } else {
-    Status = NvmeRead (Device, Buffer, Lba, NumberOfBlocks);
+    Status = NvmeOverlappedRead (Device, Buffer, Lba, NumberOfBlocks);
   }
 
   gBS->RestoreTPL (OldTpl);
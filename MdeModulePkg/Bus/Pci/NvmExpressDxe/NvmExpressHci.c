@@ -300,6 +300,40 @@ WriteNvmeAdminCompletionQueueBaseAddress (
   return EFI_SUCCESS;
 }
 
+typedef struct {
+  NVME_CONTROLLER_PRIVATE_DATA    *Private;
+  UINT8                           Rdy;
+} NVME_WAIT_READY_CONTEXT;
+
+/**
+  Check if the CSTS.RDY bit of the Nvm Express controller reached the expected value.
+
+  @param  Context          The pointer to the NVME_WAIT_READY_CONTEXT data structure.
+
+  @return EFI_SUCCESS      CSTS.RDY has the expected value.
+  @return EFI_NOT_READY    CSTS.RDY does not have the expected value yet.
+  @return EFI_DEVICE_ERROR Fail to read the controller status register.
+
+**/
+EFI_STATUS
+EFIAPI
+NvmeCheckControllerReady (
+  IN VOID  *Context
+  )
+{
+  NVME_WAIT_READY_CONTEXT  *WaitContext;
+  NVME_CSTS                Csts;
+  EFI_STATUS               Status;
+
+  WaitContext = (NVME_WAIT_READY_CONTEXT *)Context;
+  Status      = ReadNvmeControllerStatus (WaitContext->Private, &Csts);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return (Csts.Rdy == WaitContext->Rdy) ? EFI_SUCCESS : EFI_NOT_READY;
+}
+
 /**
   Disable the Nvm Express controller.
 
@@ -314,11 +348,10 @@ NvmeDisableController (
   IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
-  NVME_CC     Cc;
-  NVME_CSTS   Csts;
-  EFI_STATUS  Status;
-  UINT32      Index;
-  UINT8       Timeout;
+  NVME_CC                  Cc;
+  EFI_STATUS               Status;
+  UINT8                    Timeout;
+  NVME_WAIT_READY_CONTEXT  WaitContext;
 
   //
   // Read Controller Configuration Register.
@@ -341,7 +374,7 @@ NvmeDisableController (
 
   //
   // Cap.To specifies max delay time in 500ms increments for Csts.Rdy to transition from 1 to 0 after
-  // Cc.Enable transition from 1 to 0. Loop produces a 1 millisecond delay per itteration, up to 500 * Cap.To.
+  // Cc.Enable transition from 1 to 0. Csts.Rdy is polled with a growing interval of up to 1 millisecond.
   //
   if (Private->Cap.To == 0) {
     Timeout = 1;
@@ -349,24 +382,20 @@ NvmeDisableController (
     Timeout = Private->Cap.To;
   }
 
-  for (Index = (Timeout * 500); Index != 0; --Index) {
-    gBS->Stall (1000);
-
-    //
-    // Check if the controller is initialized
-    //
-    Status = ReadNvmeControllerStatus (Private, &Csts);
-
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    if (Csts.Rdy == 0) {
-      break;
-    }
+  WaitContext.Private = Private;
+  WaitContext.Rdy     = 0;
+  Status              = PollLibWaitUntil (
+                          "NvmeDisableController",
+                          NvmeCheckControllerReady,
+                          &WaitContext,
+                          MultU64x32 (Timeout, 500 * 1000),
+                          1000
+                          );
+  if ((Status != EFI_SUCCESS) && (Status != EFI_TIMEOUT)) {
+    return Status;
   }
 
-  if (Index == 0) {
+  if (Status == EFI_TIMEOUT) {
     Status = EFI_DEVICE_ERROR;
     REPORT_STATUS_CODE (
       (EFI_ERROR_CODE | EFI_ERROR_MAJOR),
@@ -393,11 +422,10 @@ NvmeEnableController (
   IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
-  NVME_CC     Cc;
-  NVME_CSTS   Csts;
-  EFI_STATUS  Status;
-  UINT32      Index;
-  UINT8       Timeout;
+  NVME_CC                  Cc;
+  EFI_STATUS               Status;
+  UINT8                    Timeout;
+  NVME_WAIT_READY_CONTEXT  WaitContext;
 
   //
   // Enable the controller.
@@ -415,7 +443,7 @@ NvmeEnableController (
 
   //
   // Cap.To specifies max delay time in 500ms increments for Csts.Rdy to set after
-  // Cc.Enable. Loop produces a 1 millisecond delay per itteration, up to 500 * Cap.To.
+  // Cc.Enable. Csts.Rdy is polled with a growing interval of up to 1 millisecond.
   //
   if (Private->Cap.To == 0) {
     Timeout = 1;
@@ -423,25 +451,20 @@ NvmeEnableController (
     Timeout = Private->Cap.To;
   }
 
-  for (Index = (Timeout * 500); Index != 0; --Index) {
-    gBS->Stall (1000);
-
-    //
-    // Check if the controller is initialized
-    //
-    Status = ReadNvmeControllerStatus (Private, &Csts);
-
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    if (Csts.Rdy) {
-      break;
-    }
+  WaitContext.Private = Private;
+  WaitContext.Rdy     = 1;
+  Status              = PollLibWaitUntil (
+                          "NvmeEnableController",
+                          NvmeCheckControllerReady,
+                          &WaitContext,
+                          MultU64x32 (Timeout, 500 * 1000),
+                          1000
+                          );
+  if ((Status != EFI_SUCCESS) && (Status != EFI_TIMEOUT)) {
+    return Status;
   }
 
-  if (Index == 0) {
-    Status = EFI_TIMEOUT;
+  if (Status == EFI_TIMEOUT) {
     REPORT_STATUS_CODE (
       (EFI_ERROR_CODE | EFI_ERROR_MAJOR),
       (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR)
@@ -558,6 +581,105 @@ NvmeIdentifyNamespace (
   return Status;
 }
 
+/**
+  Get the number of asynchronous I/O queue pairs the driver is configured to create.
+
+  @return The number of asynchronous I/O queue pairs, from 1 to NVME_MAX_ASYNC_QUEUES.
+
+**/
+UINT16
+NvmeGetAsyncQueuePairs (
+  VOID
+  )
+{
+  return (UINT16)MIN (MAX (PcdGet8 (PcdNvmeAsyncIoQueuePairs), 1), NVME_MAX_ASYNC_QUEUES);
+}
+
+/**
+  Get the number of entries the driver allocates for each asynchronous I/O queue.
+
+  @return The number of entries of each asynchronous I/O submission & completion queue, 1-based.
+
+**/
+UINT16
+NvmeGetAsyncQueueSlots (
+  VOID
+  )
+{
+  return MAX (PcdGet16 (PcdNvmeAsyncIoQueueDepth), 2);
+}
+
+/**
+  Get the number of pages an asynchronous I/O queue pair takes.
+
+  @param  Slots            The number of entries of each queue of the pair, 1-based.
+
+  @return The number of 4kB pages of the submission queue and the completion queue.
+
+**/
+UINTN
+NvmeGetAsyncQueuePages (
+  IN UINT16  Slots
+  )
+{
+  return EFI_SIZE_TO_PAGES (Slots * sizeof (NVME_SQ)) + EFI_SIZE_TO_PAGES (Slots * sizeof (NVME_CQ));
+}
+
+/**
+  Request the number of I/O submission & completion queues with the Set Features command.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param  QueueNum         The number of I/O queue pairs to request, 1-based.
+  @param  GrantedQueueNum  Return the number of I/O queue pairs allocated by the controller, 1-based.
+
+  @return EFI_SUCCESS      Successfully set the number of queues.
+  @return EFI_DEVICE_ERROR Fail to set the number of queues.
+
+**/
+EFI_STATUS
+NvmeSetNumberOfQueues (
+  IN  NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN  UINT16                        QueueNum,
+  OUT UINT16                        *GrantedQueueNum
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET  CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                   Command;
+  EFI_NVM_EXPRESS_COMPLETION                Completion;
+  EFI_STATUS                                Status;
+
+  ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+  ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
+  ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+
+  CommandPacket.NvmeCmd        = &Command;
+  CommandPacket.NvmeCompletion = &Completion;
+
+  Command.Cdw0.Opcode          = NVME_ADMIN_SET_FEATURES_CMD;
+  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
+  //
+  // Number of I/O Submission Queues Requested and Number of I/O Completion Queues
+  // Requested are both 0-based.
+  //
+  CommandPacket.NvmeCmd->Cdw10 = NVME_FEATURE_NUMBER_OF_QUEUES;
+  CommandPacket.NvmeCmd->Cdw11 = (UINT32)(QueueNum - 1) | ((UINT32)(QueueNum - 1) << 16);
+  CommandPacket.NvmeCmd->Flags = CDW10_VALID | CDW11_VALID;
+
+  Status = Private->Passthru.PassThru (
+                               &Private->Passthru,
+                               0,
+                               &CommandPacket,
+                               NULL
+                               );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *GrantedQueueNum = (UINT16)(MIN (Completion.DW0 & 0xFFFF, Completion.DW0 >> 16) + 1);
+  return EFI_SUCCESS;
+}
+
 /**
   Create io completion queue.
 
@@ -583,7 +705,7 @@ NvmeCreateIoCompletionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -601,11 +723,7 @@ NvmeCreateIoCompletionQueue (
     if (Index == 1) {
       QueueSize = NVME_CCQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
-        QueueSize = NVME_ASYNC_CCQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncQueueSize;
     }
 
     CrIoCq.Qid   = Index;
@@ -655,7 +773,7 @@ NvmeCreateIoSubmissionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_ID + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -673,11 +791,7 @@ NvmeCreateIoSubmissionQueue (
     if (Index == 1) {
       QueueSize = NVME_CSQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
-        QueueSize = NVME_ASYNC_CSQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncQueueSize;
     }
 
     CrIoSq.Qid   = Index;
@@ -726,6 +840,9 @@ NvmeControllerInit (
   NVME_ACQ             Acq;
   UINT8                Sn[21];
   UINT8                Mn[41];
+  UINT16               Index;
+  UINTN                QueueOffset;
+  UINT16               QueueNum;
 
   //
   // Enable this controller.
@@ -771,19 +888,15 @@ NvmeControllerInit (
   //
   ASSERT ((Private->Cap.Mpsmin + 12) <= EFI_PAGE_SHIFT);
 
-  Private->Cid[0]        = 0;
-  Private->Cid[1]        = 0;
-  Private->Cid[2]        = 0;
-  Private->Pt[0]         = 0;
-  Private->Pt[1]         = 0;
-  Private->Pt[2]         = 0;
-  Private->SqTdbl[0].Sqt = 0;
-  Private->SqTdbl[1].Sqt = 0;
-  Private->SqTdbl[2].Sqt = 0;
-  Private->CqHdbl[0].Cqh = 0;
-  Private->CqHdbl[1].Cqh = 0;
-  Private->CqHdbl[2].Cqh = 0;
-  Private->AsyncSqHead   = 0;
+  for (Index = 0; Index < NVME_MAX_QUEUES; Index++) {
+    Private->Cid[Index]         = 0;
+    Private->Pt[Index]          = 0;
+    Private->SqTdbl[Index].Sqt  = 0;
+    Private->CqHdbl[Index].Cqh  = 0;
+    Private->AsyncSqHead[Index] = 0;
+  }
+
+  Private->NextAsyncQueue = 0;
 
   Status = NvmeDisableController (Private);
 
@@ -812,7 +925,7 @@ NvmeControllerInit (
   //
   // Address of I/O submission & completion queue.
   //
-  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
+  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (Private->BufferPages));
   Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
   Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
   Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
@@ -821,10 +934,22 @@ NvmeControllerInit (
   Private->SqBufferPciAddr[1] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 2 * EFI_PAGE_SIZE);
   Private->CqBuffer[1]        = (NVME_CQ *)(UINTN)(Private->Buffer + 3 * EFI_PAGE_SIZE);
   Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 3 * EFI_PAGE_SIZE);
-  Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
-  Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-  Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-  Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
+
+  QueueOffset = 4 * EFI_PAGE_SIZE;
+  for (Index = NVME_ASYNC_QUEUE_ID; Index < NVME_ASYNC_QUEUE_ID + NvmeGetAsyncQueuePairs (); Index++) {
+    Private->SqBuffer[Index]        = (NVME_SQ *)(UINTN)(Private->Buffer + QueueOffset);
+    Private->SqBufferPciAddr[Index] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + QueueOffset);
+    QueueOffset                    += EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (Private->AsyncQueueSlots * sizeof (NVME_SQ)));
+    Private->CqBuffer[Index]        = (NVME_CQ *)(UINTN)(Private->Buffer + QueueOffset);
+    Private->CqBufferPciAddr[Index] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + QueueOffset);
+    QueueOffset                    += EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (Private->AsyncQueueSlots * sizeof (NVME_CQ)));
+  }
+
+  Private->PrpListPool        = Private->Buffer + QueueOffset;
+  Private->PrpListPoolPciAddr = Private->BufferPciAddr + QueueOffset;
+  QueueOffset                += EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_PAGES);
+
+  ASSERT (QueueOffset <= EFI_PAGES_TO_SIZE (Private->BufferPages));
 
   DEBUG ((DEBUG_INFO, "Private->Buffer = [%016X]\n", (UINT64)(UINTN)Private->Buffer));
   DEBUG ((DEBUG_INFO, "Admin     Submission Queue size (Aqa.Asqs) = [%08X]\n", Aqa.Asqs));
@@ -833,8 +958,10 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "Admin     Completion Queue (CqBuffer[0]) = [%016X]\n", Private->CqBuffer[0]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Submission Queue (SqBuffer[1]) = [%016X]\n", Private->SqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
-  DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
-  DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
+  for (Index = NVME_ASYNC_QUEUE_ID; Index < NVME_ASYNC_QUEUE_ID + NvmeGetAsyncQueuePairs (); Index++) {
+    DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[%d]) = [%016X]\n", Index, Private->SqBuffer[Index]));
+    DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[%d]) = [%016X]\n", Index, Private->CqBuffer[Index]));
+  }
 
   //
   // Program admin queue attributes.
@@ -913,8 +1040,32 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "    NN        : 0x%x\n", Private->ControllerData->Nn));
 
   //
-  // Create two I/O completion queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Negotiate the asynchronous I/O queues: the queue depth is limited by CAP.MQES, and the
+  // number of queue pairs by what the controller allocates. The default configuration of one
+  // asynchronous queue pair does not need to request more queues than controllers allocate
+  // by default.
+  //
+  Private->AsyncQueueSize = (UINT16)MIN (Private->AsyncQueueSlots - 1, Private->Cap.Mqes);
+  Private->AsyncQueueNum  = NvmeGetAsyncQueuePairs ();
+  if (Private->AsyncQueueNum > 1) {
+    Status = NvmeSetNumberOfQueues (Private, NVME_ASYNC_QUEUE_ID - 1 + Private->AsyncQueueNum, &QueueNum);
+    if (EFI_ERROR (Status) || (QueueNum < NVME_ASYNC_QUEUE_ID)) {
+      Private->AsyncQueueNum = 1;
+    } else {
+      Private->AsyncQueueNum = MIN (Private->AsyncQueueNum, QueueNum - (NVME_ASYNC_QUEUE_ID - 1));
+    }
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "NvmeControllerInit: %d async I/O queue pairs with %d entries\n",
+    Private->AsyncQueueNum,
+    Private->AsyncQueueSize + 1
+    ));
+
+  //
+  // Create the I/O completion queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoCompletionQueue (Private);
   if (EFI_ERROR (Status)) {
@@ -922,8 +1073,8 @@ NvmeControllerInit (
   }
 
   //
-  // Create two I/O Submission queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Create the I/O Submission queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoSubmissionQueue (Private);
 
@@ -18,6 +18,46 @@
 //
 #define NVME_ASQ_BUF_OFFSET  EFI_PAGE_SIZE
 
+//
+// Feature Identifier of the Number of Queues feature
+//
+#define NVME_FEATURE_NUMBER_OF_QUEUES  0x07
+
+/**
+  Get the number of asynchronous I/O queue pairs the driver is configured to create.
+
+  @return The number of asynchronous I/O queue pairs, from 1 to NVME_MAX_ASYNC_QUEUES.
+
+**/
+UINT16
+NvmeGetAsyncQueuePairs (
+  VOID
+  );
+
+/**
+  Get the number of entries the driver allocates for each asynchronous I/O queue.
+
+  @return The number of entries of each asynchronous I/O submission & completion queue, 1-based.
+
+**/
+UINT16
+NvmeGetAsyncQueueSlots (
+  VOID
+  );
+
+/**
+  Get the number of pages an asynchronous I/O queue pair takes.
+
+  @param  Slots            The number of entries of each queue of the pair, 1-based.
+
+  @return The number of 4kB pages of the submission queue and the completion queue.
+
+**/
+UINTN
+NvmeGetAsyncQueuePages (
+  IN UINT16  Slots
+  );
+
 /**
   Initialize the Nvm Express controller.
 
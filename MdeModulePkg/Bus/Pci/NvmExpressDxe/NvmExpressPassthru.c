@@ -195,30 +195,115 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Take contiguous pages from the PRP list pool.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  Pages          The number of pages to take.
+  @param[out] PrpListHost    The host base address of the pages.
+  @param[out] PrpListPciAddr The PCI controller specific address of the pages.
+
+  @retval TRUE    The pages are taken from the pool.
+  @retval FALSE   The pool has no such number of contiguous free pages.
+
+**/
+BOOLEAN
+NvmeAllocatePoolPrpList (
+  IN  NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN  UINTN                         Pages,
+  OUT VOID                          **PrpListHost,
+  OUT EFI_PHYSICAL_ADDRESS          *PrpListPciAddr
+  )
+{
+  UINT32   Mask;
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if (Pages > NVME_PRP_LIST_POOL_PAGES) {
+    return FALSE;
+  }
+
+  Mask = (UINT32)(LShiftU64 (1, Pages) - 1);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Index = 0; Index + Pages <= NVME_PRP_LIST_POOL_PAGES; Index++) {
+    if ((Private->PrpListPoolMap & (Mask << Index)) == 0) {
+      Private->PrpListPoolMap |= Mask << Index;
+      gBS->RestoreTPL (OldTpl);
+
+      *PrpListHost    = Private->PrpListPool + EFI_PAGES_TO_SIZE (Index);
+      *PrpListPciAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Private->PrpListPoolPciAddr + EFI_PAGES_TO_SIZE (Index));
+      return TRUE;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return FALSE;
+}
+
+/**
+  Free the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL if the
+                            PRP lists come from the PRP list pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  )
+{
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if (Mapping == NULL) {
+    Index = EFI_SIZE_TO_PAGES ((UINTN)((UINT8 *)PrpListHost - Private->PrpListPool));
+    ASSERT (Index + PrpListNo <= NVME_PRP_LIST_POOL_PAGES);
+
+    OldTpl                   = gBS->RaiseTPL (TPL_NOTIFY);
+    Private->PrpListPoolMap &= ~((UINT32)(LShiftU64 (1, PrpListNo) - 1) << Index);
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Private->PciIo->Unmap (Private->PciIo, Mapping);
+  Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
+  The PRP lists are taken from the PRP list pool if it has enough free pages, otherwise
+  they are allocated and mapped.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
   @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+  @param[out]    Mapping             The mapping value returned from PciIo.Map(), or NULL if
+                                     the PRP lists are taken from the PRP list pool.
 
   @retval The pointer to the first PRP List of the PRP lists.
 
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost,
+  IN OUT UINTN                         *PrpListNo,
+  OUT VOID                             **Mapping
   )
 {
+  EFI_PCI_IO_PROTOCOL   *PciIo;
   UINTN                 PrpEntryNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
@@ -228,6 +313,9 @@ NvmeCreatePrpList (
   UINTN                 Bytes;
   EFI_STATUS            Status;
 
+  PciIo    = Private->PciIo;
+  *Mapping = NULL;
+
   //
   // The number of Prp Entry in a memory page.
   //
@@ -247,32 +335,34 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
+  Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
+  if (!NvmeAllocatePoolPrpList (Private, *PrpListNo, PrpListHost, &PrpListPhyAddr)) {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      *PrpListNo,
+                      PrpListHost,
+                      0
+                      );
 
-  if (EFI_ERROR (Status)) {
-    return NULL;
-  }
+    if (EFI_ERROR (Status)) {
+      return NULL;
+    }
 
-  Bytes  = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      *PrpListHost,
+                      &Bytes,
+                      &PrpListPhyAddr,
+                      Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
+      DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      goto EXIT;
+    }
   }
 
   //
@@ -310,6 +400,11 @@ NvmeCreatePrpList (
   return (VOID *)(UINTN)PrpListPhyAddr;
 
 EXIT:
+  if (!EFI_ERROR (Status)) {
+    PciIo->Unmap (PciIo, *Mapping);
+    *Mapping = NULL;
+  }
+
   PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
   return NULL;
 }
@@ -384,16 +479,13 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
     if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+      NvmeFreePrpList (
+        Private,
+        AsyncRequest->PrpListHost,
+        AsyncRequest->PrpListNo,
+        AsyncRequest->MapPrpList
+        );
     }
 
     RemoveEntryList (Link);
@@ -401,6 +493,11 @@ AbortAsyncPassThruTasks (
     FreePool (AsyncRequest);
   }
 
+  ZeroMem (
+    Private->AsyncRequests,
+    NvmeGetAsyncQueuePairs () * Private->AsyncQueueSlots * sizeof (NVME_PASS_THRU_ASYNC_REQ *)
+    );
+
   if (IsListEmpty (&Private->AsyncPassThruQueue) &&
       IsListEmpty (&Private->UnsubmittedSubtasks))
   {
@@ -414,6 +511,63 @@ AbortAsyncPassThruTasks (
   return Status;
 }
 
+/**
+  Pick an asynchronous I/O queue pair and a command Id for a non-blocking command.
+
+  The queue pairs are used in turn, starting with the one after the pair the previous
+  command was placed in, so that the outstanding commands are spread over all of them.
+
+  @param[in]  Private    The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[out] QueueId    Return the queue Id of the asynchronous I/O queue pair.
+  @param[out] CommandId  Return a command Id that is not used by an outstanding command
+                         of the queue pair.
+
+  @retval EFI_SUCCESS    A queue pair with room for a command is found.
+  @retval EFI_NOT_READY  All the asynchronous I/O queue pairs are full.
+
+**/
+EFI_STATUS
+NvmeGetAsyncQueue (
+  IN  NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  OUT UINT16                        *QueueId,
+  OUT UINT16                        *CommandId
+  )
+{
+  NVME_PASS_THRU_ASYNC_REQ  **AsyncRequests;
+  UINT16                    QueueSize;
+  UINT16                    Index;
+  UINT16                    CidIndex;
+  UINT16                    Cid;
+
+  QueueSize = Private->AsyncQueueSize + 1;
+  for (Index = 0; Index < Private->AsyncQueueNum; Index++) {
+    *QueueId = NVME_ASYNC_QUEUE_ID + (Private->NextAsyncQueue + Index) % Private->AsyncQueueNum;
+
+    //
+    // Submission queue full check.
+    //
+    if ((Private->SqTdbl[*QueueId].Sqt + 1) % QueueSize == Private->AsyncSqHead[*QueueId]) {
+      continue;
+    }
+
+    //
+    // The command Id indexes the outstanding requests of the queue pair. At most AsyncQueueSize
+    // commands are outstanding, so that the completion queue never overflows.
+    //
+    AsyncRequests = Private->AsyncRequests + (*QueueId - NVME_ASYNC_QUEUE_ID) * Private->AsyncQueueSlots;
+    for (CidIndex = 0; CidIndex < Private->AsyncQueueSize; CidIndex++) {
+      Cid = (Private->Cid[*QueueId] + CidIndex) % Private->AsyncQueueSize;
+      if (AsyncRequests[Cid] == NULL) {
+        *CommandId              = Cid;
+        Private->NextAsyncQueue = (Private->NextAsyncQueue + Index + 1) % Private->AsyncQueueNum;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  return EFI_NOT_READY;
+}
+
 /**
   Sends an NVM Express Command Packet to an NVM Express controller or namespace. This function supports
   both blocking I/O and non-blocking I/O. The blocking I/O functionality is required, and the non-blocking
@@ -463,6 +617,7 @@ NvmExpressPassThru (
   volatile NVME_CQ               *Cq;
   UINT16                         QueueId;
   UINT16                         QueueSize;
+  UINT16                         CommandId;
   UINT32                         Bytes;
   UINT16                         Offset;
   EFI_EVENT                      TimerEvent;
@@ -478,6 +633,7 @@ NvmExpressPassThru (
   UINT32                         Attributes;
   UINT32                         IoAlign;
   UINT32                         MaxTransLen;
+  UINT32                         SglSupport;
   UINT32                         Data;
   NVME_PASS_THRU_ASYNC_REQ       *AsyncRequest;
   EFI_TPL                        OldTpl;
@@ -553,7 +709,8 @@ NvmExpressPassThru (
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  QueueSize   = Private->AsyncQueueSize + 1;
+  CommandId   = 0;
 
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
     QueueId = 0;
@@ -561,15 +718,9 @@ NvmExpressPassThru (
     if (Event == NULL) {
       QueueId = 1;
     } else {
-      QueueId = 2;
-
-      //
-      // Submission queue full check.
-      //
-      if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize ==
-          Private->AsyncSqHead)
-      {
-        return EFI_NOT_READY;
+      Status = NvmeGetAsyncQueue (Private, &QueueId, &CommandId);
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
     }
   }
@@ -584,11 +735,17 @@ NvmExpressPassThru (
   ZeroMem (Sq, sizeof (NVME_SQ));
   Sq->Opc  = (UINT8)Packet->NvmeCmd->Cdw0.Opcode;
   Sq->Fuse = (UINT8)Packet->NvmeCmd->Cdw0.FusedOperation;
-  Sq->Cid  = Private->Cid[QueueId]++;
+  if ((Event != NULL) && (QueueId != 0)) {
+    Sq->Cid               = CommandId;
+    Private->Cid[QueueId] = CommandId + 1;
+  } else {
+    Sq->Cid = Private->Cid[QueueId]++;
+  }
+
   Sq->Nsid = Packet->NvmeCmd->Nsid;
 
   //
-  // Currently we only support PRP for data transfer, SGL is NOT supported.
+  // The driver, not the caller, chooses between PRP and SGL for data transfer below.
   //
   ASSERT (Sq->Psdt == 0);
   if (Sq->Psdt != 0) {
@@ -643,6 +800,21 @@ NvmExpressPassThru (
 
       Sq->Prp[0] = PhyAddr;
       Sq->Prp[1] = 0;
+
+      //
+      // The mapped buffer is contiguous, so an I/O command can describe it with a single
+      // SGL Data Block descriptor instead of a PRP list if the controller supports SGLs.
+      // The descriptor takes the place of the PRP entries: the address in the first 8 bytes,
+      // the length in the next 4 bytes and SGL identifier 0h (Data Block) in the last byte.
+      //
+      SglSupport = Private->ControllerData->Sgls & NVME_SGLS_SUPPORT_MASK;
+      if ((QueueId != 0) &&
+          ((SglSupport == NVME_SGLS_SUPPORTED) ||
+           ((SglSupport == NVME_SGLS_SUPPORTED_DWORD) && (((PhyAddr | Packet->TransferLength) & 0x3) == 0))))
+      {
+        Sq->Psdt   = NVME_PSDT_SGL_MPTR_CONTIGUOUS;
+        Sq->Prp[1] = Packet->TransferLength;
+      }
     }
 
     if ((Packet->MetadataLength != 0) && (Packet->MetadataBuffer != NULL)) {
@@ -675,20 +847,22 @@ NvmExpressPassThru (
   Offset = ((UINT16)Sq->Prp[0]) & (EFI_PAGE_SIZE - 1);
   Bytes  = Packet->TransferLength;
 
-  if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
-    //
-    // Create PrpList for remaining data buffer.
-    //
-    PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
-    if (Prp == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      goto EXIT;
-    }
+  if (Sq->Psdt == 0) {
+    if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+      //
+      // Create PrpList for remaining data buffer.
+      //
+      PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
+      Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+      if (Prp == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto EXIT;
+      }
 
-    Sq->Prp[1] = (UINT64)(UINTN)Prp;
-  } else if ((Offset + Bytes) > EFI_PAGE_SIZE) {
-    Sq->Prp[1] = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
+      Sq->Prp[1] = (UINT64)(UINTN)Prp;
+    } else if ((Offset + Bytes) > EFI_PAGE_SIZE) {
+      Sq->Prp[1] = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
+    }
   }
 
   if (Packet->NvmeCmd->Flags & CDW2_VALID) {
@@ -760,6 +934,7 @@ NvmExpressPassThru (
 
     AsyncRequest->Signature   = NVME_PASS_THRU_ASYNC_REQ_SIG;
     AsyncRequest->Packet      = Packet;
+    AsyncRequest->QueueId     = QueueId;
     AsyncRequest->CommandId   = Sq->Cid;
     AsyncRequest->CallerEvent = Event;
     AsyncRequest->MapData     = MapData;
@@ -770,6 +945,7 @@ NvmExpressPassThru (
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Private->AsyncPassThruQueue, &AsyncRequest->Link);
+    Private->AsyncRequests[(QueueId - NVME_ASYNC_QUEUE_ID) * Private->AsyncQueueSlots + AsyncRequest->CommandId] = AsyncRequest;
     gBS->RestoreTPL (OldTpl);
 
     return EFI_SUCCESS;
@@ -905,15 +1081,8 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
-    PciIo->Unmap (
-             PciIo,
-             MapPrpList
-             );
-  }
-
   if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo, MapPrpList);
   }
 
   if (TimerEvent != NULL) {
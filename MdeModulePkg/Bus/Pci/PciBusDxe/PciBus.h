@@ -36,6 +36,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PcdLib.h>
 
@@ -73,6 +74,7 @@ typedef enum {
 #include "PciDeviceSupport.h"
 #include "PciEnumerator.h"
 #include "PciEnumeratorSupport.h"
+#include "PciEnumerationCache.h"
 #include "PciDriverOverride.h"
 #include "PciRomTable.h"
 #include "PciOptionRomSupport.h"
@@ -101,6 +103,29 @@ struct _PCI_BAR {
   UINT16          Offset;
 };
 
+//
+// A capability of a PCI function, as read by the walk of its capability list
+//
+typedef struct {
+  UINT16    CapabilityId;
+  UINT16    Offset;
+  UINT16    NextOffset;
+} PCI_CAPABILITY_ENTRY;
+
+//
+// The capability list or extended capability list of a PCI function, walked
+// once for all the lookups
+//
+typedef struct {
+  BOOLEAN                 Walked;
+  //
+  // FALSE if the list is too long to be recorded
+  //
+  BOOLEAN                 Complete;
+  UINTN                   Count;
+  PCI_CAPABILITY_ENTRY    *Entries;
+} PCI_CAPABILITY_LIST;
+
 //
 // defined in PCI Card Specification, 8.0
 //
@@ -238,6 +263,12 @@ struct _PCI_IO_DEVICE {
   //
   BOOLEAN                                      AllOpRomProcessed;
 
+  //
+  // TRUE if the EFI drivers of the OpROM are dispatched when the device is
+  // first connected rather than when it is registered
+  //
+  BOOLEAN                                      OpRomDispatchPending;
+
   //
   // TRUE if there is any EFI driver in the OptionRom
   //
@@ -282,6 +313,12 @@ struct _PCI_IO_DEVICE {
   UINT16                                       BridgeIoAlignment;
   UINT32                                       ResizableBarOffset;
   UINT32                                       ResizableBarNumber;
+
+  //
+  // The capability lists of the device, read on the first lookup
+  //
+  PCI_CAPABILITY_LIST                          CapabilityList;
+  PCI_CAPABILITY_LIST                          ExpressCapabilityList;
 };
 
 #define PCI_IO_DEVICE_FROM_PCI_IO_THIS(a) \
@@ -8,6 +8,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PciBus.h"
 
+//
+// Number of capabilities that a capability list record holds, above all the
+// 48 capabilities that fit in the PCI compatible configuration space.
+//
+#define PCI_CAPABILITY_LIST_MAX_ENTRIES  64
+
 /**
   Operate the PCI register via PciIo function interface.
 
@@ -89,6 +95,231 @@ PciCapabilitySupport (
   return FALSE;
 }
 
+/**
+  Record a walked capability list in the device.
+
+  @param List          The capability list of the device.
+  @param Entries       The capabilities read by the walk.
+  @param Count         The number of capabilities read by the walk.
+  @param Complete      FALSE if the walk stopped before the end of the list.
+
+**/
+STATIC
+VOID
+PciSaveCapabilityList (
+  OUT PCI_CAPABILITY_LIST   *List,
+  IN  PCI_CAPABILITY_ENTRY  *Entries,
+  IN  UINTN                 Count,
+  IN  BOOLEAN               Complete
+  )
+{
+  List->Walked   = TRUE;
+  List->Complete = Complete;
+  List->Count    = 0;
+  List->Entries  = NULL;
+
+  if (Complete && (Count != 0)) {
+    List->Entries = AllocateCopyPool (Count * sizeof (PCI_CAPABILITY_ENTRY), Entries);
+    if (List->Entries == NULL) {
+      List->Complete = FALSE;
+    } else {
+      List->Count = Count;
+    }
+  }
+}
+
+/**
+  Walk the capability list of a device once, so that the lookups do not read
+  the capability headers again.
+
+  @param PciIoDevice   A pointer to the PCI_IO_DEVICE.
+
+**/
+STATIC
+VOID
+PciWalkCapabilityList (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_CAPABILITY_ENTRY  Entries[PCI_CAPABILITY_LIST_MAX_ENTRIES];
+  UINTN                 Count;
+  BOOLEAN               Complete;
+  UINT32                PointerOffset;
+  UINT8                 CapabilityPtr;
+  UINT16                CapabilityEntry;
+
+  if (IS_CARDBUS_BRIDGE (&PciIoDevice->Pci)) {
+    PointerOffset = EFI_PCI_CARDBUS_BRIDGE_CAPABILITY_PTR;
+  } else {
+    PointerOffset = PCI_CAPBILITY_POINTER_OFFSET;
+  }
+
+  CapabilityPtr = 0;
+  PciIoDevice->PciIo.Pci.Read (
+                           &PciIoDevice->PciIo,
+                           EfiPciIoWidthUint8,
+                           PointerOffset,
+                           1,
+                           &CapabilityPtr
+                           );
+
+  Count    = 0;
+  Complete = TRUE;
+  while ((CapabilityPtr >= 0x40) && ((CapabilityPtr & 0x03) == 0x00)) {
+    if (Count == PCI_CAPABILITY_LIST_MAX_ENTRIES) {
+      Complete = FALSE;
+      break;
+    }
+
+    CapabilityEntry = 0;
+    PciIoDevice->PciIo.Pci.Read (
+                             &PciIoDevice->PciIo,
+                             EfiPciIoWidthUint16,
+                             CapabilityPtr,
+                             1,
+                             &CapabilityEntry
+                             );
+
+    Entries[Count].CapabilityId = (UINT8)CapabilityEntry;
+    Entries[Count].Offset       = CapabilityPtr;
+    Entries[Count].NextOffset   = (UINT8)(CapabilityEntry >> 8);
+    Count++;
+
+    //
+    // Certain PCI device may incorrectly have capability pointing to itself,
+    // break to avoid dead loop.
+    //
+    if (CapabilityPtr == (UINT8)(CapabilityEntry >> 8)) {
+      break;
+    }
+
+    CapabilityPtr = (UINT8)(CapabilityEntry >> 8);
+  }
+
+  PciSaveCapabilityList (&PciIoDevice->CapabilityList, Entries, Count, Complete);
+}
+
+/**
+  Walk the extended capability list of a device once, so that the lookups do
+  not read the extended capability headers again.
+
+  @param PciIoDevice   A pointer to the PCI_IO_DEVICE.
+
+**/
+STATIC
+VOID
+PciWalkExpressCapabilityList (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  EFI_STATUS            Status;
+  PCI_CAPABILITY_ENTRY  Entries[PCI_CAPABILITY_LIST_MAX_ENTRIES];
+  UINTN                 Count;
+  BOOLEAN               Complete;
+  UINT32                CapabilityPtr;
+  UINT32                CapabilityEntry;
+
+  Count         = 0;
+  Complete      = TRUE;
+  CapabilityPtr = EFI_PCIE_CAPABILITY_BASE_OFFSET;
+  while (CapabilityPtr != 0) {
+    if (Count == PCI_CAPABILITY_LIST_MAX_ENTRIES) {
+      Complete = FALSE;
+      break;
+    }
+
+    //
+    // Mask it to DWORD alignment per PCI spec
+    //
+    CapabilityPtr &= 0xFFC;
+    Status         = PciIoDevice->PciIo.Pci.Read (
+                                              &PciIoDevice->PciIo,
+                                              EfiPciIoWidthUint32,
+                                              CapabilityPtr,
+                                              1,
+                                              &CapabilityEntry
+                                              );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (CapabilityEntry == MAX_UINT32) {
+      DEBUG ((
+        DEBUG_WARN,
+        "%a: [%02x|%02x|%02x] failed to access config space at offset 0x%x\n",
+        __func__,
+        PciIoDevice->BusNumber,
+        PciIoDevice->DeviceNumber,
+        PciIoDevice->FunctionNumber,
+        CapabilityPtr
+        ));
+      break;
+    }
+
+    Entries[Count].CapabilityId = (UINT16)CapabilityEntry;
+    Entries[Count].Offset       = (UINT16)CapabilityPtr;
+    Entries[Count].NextOffset   = (UINT16)((CapabilityEntry >> 20) & 0xFFF);
+    Count++;
+
+    CapabilityPtr = (CapabilityEntry >> 20) & 0xFFF;
+  }
+
+  PciSaveCapabilityList (&PciIoDevice->ExpressCapabilityList, Entries, Count, Complete);
+}
+
+/**
+  Look a capability up in a walked capability list.
+
+  @param List          The capability list of the device.
+  @param CapId         The capability ID.
+  @param Start         The offset of the capability to start from, 0 to start
+                       from the head of the list.
+  @param Offset        The offset of the capability found.
+  @param NextRegBlock  The offset of the capability after the one found.
+
+  @retval EFI_SUCCESS      The capability is found.
+  @retval EFI_NOT_FOUND    The list does not hold the capability.
+  @retval EFI_NOT_READY    The record cannot answer, the device must be read.
+
+**/
+STATIC
+EFI_STATUS
+PciFindCapability (
+  IN  PCI_CAPABILITY_LIST  *List,
+  IN  UINT16               CapId,
+  IN  UINT32               Start,
+  OUT UINT32               *Offset,
+  OUT UINT32               *NextRegBlock
+  )
+{
+  UINTN  Index;
+
+  if (!List->Complete) {
+    return EFI_NOT_READY;
+  }
+
+  Index = 0;
+  if (Start != 0) {
+    while ((Index < List->Count) && (List->Entries[Index].Offset != Start)) {
+      Index++;
+    }
+
+    if (Index == List->Count) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  for ( ; Index < List->Count; Index++) {
+    if (List->Entries[Index].CapabilityId == CapId) {
+      *Offset       = List->Entries[Index].Offset;
+      *NextRegBlock = List->Entries[Index].NextOffset;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
 /**
   Locate capability register block per capability ID.
 
@@ -110,9 +341,12 @@ LocateCapabilityRegBlock (
   OUT UINT8         *NextRegBlock OPTIONAL
   )
 {
-  UINT8   CapabilityPtr;
-  UINT16  CapabilityEntry;
-  UINT8   CapabilityID;
+  EFI_STATUS  Status;
+  UINT8       CapabilityPtr;
+  UINT16      CapabilityEntry;
+  UINT8       CapabilityID;
+  UINT32      FoundOffset;
+  UINT32      FoundNext;
 
   //
   // To check the capability of this device supports
@@ -121,6 +355,22 @@ LocateCapabilityRegBlock (
     return EFI_UNSUPPORTED;
   }
 
+  if (!PciIoDevice->CapabilityList.Walked) {
+    PciWalkCapabilityList (PciIoDevice);
+  }
+
+  Status = PciFindCapability (&PciIoDevice->CapabilityList, CapId, *Offset, &FoundOffset, &FoundNext);
+  if (Status != EFI_NOT_READY) {
+    if (!EFI_ERROR (Status)) {
+      *Offset = (UINT8)FoundOffset;
+      if (NextRegBlock != NULL) {
+        *NextRegBlock = (UINT8)FoundNext;
+      }
+    }
+
+    return Status;
+  }
+
   if (*Offset != 0) {
     CapabilityPtr = *Offset;
   } else {
@@ -203,6 +453,8 @@ LocatePciExpressCapabilityRegBlock (
   UINT32      CapabilityPtr;
   UINT32      CapabilityEntry;
   UINT16      CapabilityID;
+  UINT32      FoundOffset;
+  UINT32      FoundNext;
 
   //
   // To check the capability of this device supports
@@ -211,6 +463,22 @@ LocatePciExpressCapabilityRegBlock (
     return EFI_UNSUPPORTED;
   }
 
+  if (!PciIoDevice->ExpressCapabilityList.Walked) {
+    PciWalkExpressCapabilityList (PciIoDevice);
+  }
+
+  Status = PciFindCapability (&PciIoDevice->ExpressCapabilityList, CapId, *Offset & 0xFFC, &FoundOffset, &FoundNext);
+  if (Status != EFI_NOT_READY) {
+    if (!EFI_ERROR (Status)) {
+      *Offset = FoundOffset;
+      if (NextRegBlock != NULL) {
+        *NextRegBlock = FoundNext;
+      }
+    }
+
+    return Status;
+  }
+
   if (*Offset != 0) {
     CapabilityPtr = *Offset;
   } else {
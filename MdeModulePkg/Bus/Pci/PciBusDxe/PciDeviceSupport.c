@@ -104,6 +104,14 @@ FreePciDevice (
     FreePool (PciIoDevice->BusNumberRanges);
   }
 
+  if (PciIoDevice->CapabilityList.Entries != NULL) {
+    FreePool (PciIoDevice->CapabilityList.Entries);
+  }
+
+  if (PciIoDevice->ExpressCapabilityList.Entries != NULL) {
+    FreePool (PciIoDevice->ExpressCapabilityList.Entries);
+  }
+
   FreePool (PciIoDevice);
 }
 
@@ -329,8 +337,26 @@ RegisterPciDevice (
     // or loaded from device in the previous round of bus enumeration
     //
     if (HasEfiImage) {
-      ProcessOpRomImage (PciIoDevice);
+      if (FeaturePcdGet (PcdPciOptionRomLazyDispatch)) {
+        PciIoDevice->OpRomDispatchPending = TRUE;
+      } else {
+        ProcessOpRomImage (PciIoDevice);
+      }
     }
+  } else if (HasEfiImage && !PciIoDevice->BusOverride && FeaturePcdGet (PcdPciOptionRomLazyDispatch)) {
+    //
+    // The bus was enumerated again before the device was ever connected, so
+    // the EFI OpRom of the device is still to be dispatched.
+    //
+    PciIoDevice->OpRomDispatchPending = TRUE;
+  }
+
+  if (PciIoDevice->OpRomDispatchPending) {
+    //
+    // GetDriver() of the Bus Specific Driver Override Protocol dispatches
+    // the EFI OpRom when the device is first connected.
+    //
+    PciIoDevice->BusOverride = TRUE;
   }
 
   if (PciIoDevice->BusOverride) {
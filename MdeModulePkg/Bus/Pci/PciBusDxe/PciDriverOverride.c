@@ -106,6 +106,16 @@ GetDriver (
   Override    = NULL;
   PciIoDevice = PCI_IO_DEVICE_FROM_PCI_DRIVER_OVERRIDE_THIS (This);
   ReturnNext  = (BOOLEAN)(*DriverImageHandle == NULL);
+
+  if (ReturnNext && PciIoDevice->OpRomDispatchPending) {
+    //
+    // The device is being connected for the first time, load and start the
+    // EFI drivers of its OpRom so that they are offered for it.
+    //
+    PciIoDevice->OpRomDispatchPending = FALSE;
+    ProcessOpRomImage (PciIoDevice);
+  }
+
   for ( Link = GetFirstNode (&PciIoDevice->OptionRomDriverList)
         ; !IsNull (&PciIoDevice->OptionRomDriverList, Link)
         ; Link = GetNextNode (&PciIoDevice->OptionRomDriverList, Link)
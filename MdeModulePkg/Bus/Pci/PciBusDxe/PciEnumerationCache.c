@@ -0,0 +1,476 @@
+/** @file
+  Cache of the BAR sizing of the PCI functions across boots.
+
+  A full enumeration sizes every BAR, bridge window and option ROM BAR of every
+  function by writing all ones to the register and reading it back, once when
+  the bus numbers are assigned and again when the resources are collected.
+  When PcdPciEnumerationCacheEnable is TRUE, the results of the sizing are kept
+  in a non-volatile variable for the next boot.
+
+  An entry is found by the segment, bus, device and function numbers of the
+  function, and is only used if the identification registers of the function
+  match it. The bus numbers are assigned from the bridges above the function,
+  so the location and the identification of the functions above are part of
+  the match. Once a function does not match its entry, or has none, the cache
+  is not used anymore in this boot and every function is sized. The variable
+  is rewritten at the end of the enumeration when the results differ from it.
+
+  The resources are still assigned from these sizes on every boot, which gives
+  the same assignment for the same topology. The BARs of functions with the
+  Resizable BAR capability are always sized, as their size is programmed.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PciBus.h"
+
+#define PCI_ENUMERATION_CACHE_VARIABLE_NAME  L"PciEnumerationCache"
+#define PCI_ENUMERATION_CACHE_REVISION       0x00000001
+
+//
+// The parts of an entry that were sized.
+//
+#define PCI_ENUMERATION_CACHE_BARS      BIT0
+#define PCI_ENUMERATION_CACHE_ROM_SIZE  BIT1
+
+typedef struct {
+  UINT64    Length;
+  UINT64    Alignment;
+  UINT32    BarType;
+  UINT16    Offset;
+  UINT16    Reserved;
+} PCI_ENUMERATION_CACHE_BAR;
+
+typedef struct {
+  UINT32                       Segment;
+  UINT8                        Bus;
+  UINT8                        Device;
+  UINT8                        Function;
+  UINT8                        HeaderType;
+  UINT16                       VendorId;
+  UINT16                       DeviceId;
+  UINT8                        RevisionId;
+  UINT8                        ClassCode[3];
+  UINT32                       Valid;
+  UINT32                       Decodes;
+  UINT32                       RomSize;
+  UINT16                       BridgeIoAlignment;
+  UINT16                       Reserved;
+  PCI_ENUMERATION_CACHE_BAR    Bar[PCI_MAX_BAR];
+} PCI_ENUMERATION_CACHE_ENTRY;
+
+typedef struct {
+  UINT32    Revision;
+  UINT32    EntrySize;
+  UINT32    EntryCount;
+  UINT32    Reserved;
+  // PCI_ENUMERATION_CACHE_ENTRY  Entries[EntryCount];
+} PCI_ENUMERATION_CACHE_HEADER;
+
+//
+// The cache of the previous boot, and whether it is still used in this boot.
+//
+STATIC PCI_ENUMERATION_CACHE_HEADER  *mPciEnumerationCache;
+STATIC BOOLEAN                       mPciEnumerationCacheMatch;
+
+//
+// The entries recorded in this boot.
+//
+STATIC PCI_ENUMERATION_CACHE_ENTRY  *mPciEnumerationRecord;
+STATIC UINTN                        mPciEnumerationRecordCount;
+STATIC UINTN                        mPciEnumerationRecordCapacity;
+
+/**
+  Find the entry of a function in a list of entries.
+
+  @param Entries        The entries.
+  @param EntryCount     The number of entries.
+  @param PciIoDevice    PCI device instance.
+
+  @return The entry of the function at the location of the device, or NULL.
+
+**/
+STATIC
+PCI_ENUMERATION_CACHE_ENTRY *
+PciEnumerationCacheFind (
+  IN PCI_ENUMERATION_CACHE_ENTRY  *Entries,
+  IN UINTN                        EntryCount,
+  IN PCI_IO_DEVICE                *PciIoDevice
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((Entries[Index].Segment == PciIoDevice->PciRootBridgeIo->SegmentNumber) &&
+        (Entries[Index].Bus == PciIoDevice->BusNumber) &&
+        (Entries[Index].Device == PciIoDevice->DeviceNumber) &&
+        (Entries[Index].Function == PciIoDevice->FunctionNumber))
+    {
+      return &Entries[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Return the entry of a function in the cache of the previous boot.
+
+  The cache is not used anymore once a function does not match it.
+
+  @param PciIoDevice    PCI device instance.
+  @param Part           The part of the entry that is needed.
+
+  @return The entry of the function, or NULL if it must be sized.
+
+**/
+STATIC
+PCI_ENUMERATION_CACHE_ENTRY *
+PciEnumerationCacheLookup (
+  IN PCI_IO_DEVICE  *PciIoDevice,
+  IN UINT32         Part
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+  PCI_TYPE00                   *Pci;
+
+  if (!mPciEnumerationCacheMatch || (PciIoDevice->ResizableBarOffset != 0)) {
+    return NULL;
+  }
+
+  Entry = PciEnumerationCacheFind (
+            (PCI_ENUMERATION_CACHE_ENTRY *)(mPciEnumerationCache + 1),
+            mPciEnumerationCache->EntryCount,
+            PciIoDevice
+            );
+  Pci = &PciIoDevice->Pci;
+  if ((Entry == NULL) ||
+      (Entry->HeaderType != Pci->Hdr.HeaderType) ||
+      (Entry->VendorId != Pci->Hdr.VendorId) ||
+      (Entry->DeviceId != Pci->Hdr.DeviceId) ||
+      (Entry->RevisionId != Pci->Hdr.RevisionID) ||
+      (CompareMem (Entry->ClassCode, Pci->Hdr.ClassCode, sizeof (Entry->ClassCode)) != 0) ||
+      ((Entry->Valid & Part) == 0))
+  {
+    DEBUG ((
+      DEBUG_INFO,
+      "PciBus: [%02x|%02x|%02x] does not match the enumeration cache, it is not used anymore\n",
+      PciIoDevice->BusNumber,
+      PciIoDevice->DeviceNumber,
+      PciIoDevice->FunctionNumber
+      ));
+    mPciEnumerationCacheMatch = FALSE;
+    return NULL;
+  }
+
+  return Entry;
+}
+
+/**
+  Return the entry of a function recorded in this boot, adding it if needed.
+
+  @param PciIoDevice    PCI device instance.
+
+  @return The entry of the function, or NULL if it cannot be recorded.
+
+**/
+STATIC
+PCI_ENUMERATION_CACHE_ENTRY *
+PciEnumerationCacheRecordEntry (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+  PCI_ENUMERATION_CACHE_ENTRY  *Entries;
+  UINTN                        Capacity;
+
+  if (!FeaturePcdGet (PcdPciEnumerationCacheEnable) || (PciIoDevice->ResizableBarOffset != 0)) {
+    return NULL;
+  }
+
+  //
+  // The functions are gathered again when the resources are collected, the
+  // entry of the first time is updated.
+  //
+  Entry = PciEnumerationCacheFind (mPciEnumerationRecord, mPciEnumerationRecordCount, PciIoDevice);
+  if (Entry != NULL) {
+    return Entry;
+  }
+
+  if (mPciEnumerationRecordCount == mPciEnumerationRecordCapacity) {
+    Capacity = MAX (mPciEnumerationRecordCapacity * 2, 32);
+    Entries  = ReallocatePool (
+                 mPciEnumerationRecordCapacity * sizeof (PCI_ENUMERATION_CACHE_ENTRY),
+                 Capacity * sizeof (PCI_ENUMERATION_CACHE_ENTRY),
+                 mPciEnumerationRecord
+                 );
+    if (Entries == NULL) {
+      return NULL;
+    }
+
+    mPciEnumerationRecord         = Entries;
+    mPciEnumerationRecordCapacity = Capacity;
+  }
+
+  Entry = &mPciEnumerationRecord[mPciEnumerationRecordCount++];
+  ZeroMem (Entry, sizeof (*Entry));
+  Entry->Segment    = (UINT32)PciIoDevice->PciRootBridgeIo->SegmentNumber;
+  Entry->Bus        = PciIoDevice->BusNumber;
+  Entry->Device     = PciIoDevice->DeviceNumber;
+  Entry->Function   = PciIoDevice->FunctionNumber;
+  Entry->HeaderType = PciIoDevice->Pci.Hdr.HeaderType;
+  Entry->VendorId   = PciIoDevice->Pci.Hdr.VendorId;
+  Entry->DeviceId   = PciIoDevice->Pci.Hdr.DeviceId;
+  Entry->RevisionId = PciIoDevice->Pci.Hdr.RevisionID;
+  CopyMem (Entry->ClassCode, PciIoDevice->Pci.Hdr.ClassCode, sizeof (Entry->ClassCode));
+
+  return Entry;
+}
+
+/**
+  Read the cache of the previous boot, before a full enumeration.
+
+  Nothing is done unless PcdPciEnumerationCacheEnable is TRUE.
+
+**/
+VOID
+PciEnumerationCacheLoad (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  PCI_ENUMERATION_CACHE_HEADER  *Cache;
+  UINTN                         Size;
+
+  if (!FeaturePcdGet (PcdPciEnumerationCacheEnable) || (mPciEnumerationCache != NULL)) {
+    return;
+  }
+
+  Status = GetVariable2 (PCI_ENUMERATION_CACHE_VARIABLE_NAME, &gEfiCallerIdGuid, (VOID **)&Cache, &Size);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  if ((Size < sizeof (*Cache)) ||
+      (Cache->Revision != PCI_ENUMERATION_CACHE_REVISION) ||
+      (Cache->EntrySize != sizeof (PCI_ENUMERATION_CACHE_ENTRY)) ||
+      (Cache->EntryCount > (Size - sizeof (*Cache)) / sizeof (PCI_ENUMERATION_CACHE_ENTRY)))
+  {
+    FreePool (Cache);
+    return;
+  }
+
+  mPciEnumerationCache      = Cache;
+  mPciEnumerationCacheMatch = TRUE;
+}
+
+/**
+  Write the cache for the next boot after a full enumeration, if it differs
+  from the cache of this boot, and release the cache.
+
+**/
+VOID
+PciEnumerationCacheSave (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  PCI_ENUMERATION_CACHE_HEADER  *Cache;
+  UINTN                         Size;
+
+  if (mPciEnumerationRecordCount == 0) {
+    goto Done;
+  }
+
+  Size = mPciEnumerationRecordCount * sizeof (PCI_ENUMERATION_CACHE_ENTRY);
+  if ((mPciEnumerationCache != NULL) &&
+      (mPciEnumerationCache->EntryCount == mPciEnumerationRecordCount) &&
+      (CompareMem (mPciEnumerationCache + 1, mPciEnumerationRecord, Size) == 0))
+  {
+    goto Done;
+  }
+
+  Cache = AllocatePool (sizeof (*Cache) + Size);
+  if (Cache == NULL) {
+    goto Done;
+  }
+
+  Cache->Revision   = PCI_ENUMERATION_CACHE_REVISION;
+  Cache->EntrySize  = sizeof (PCI_ENUMERATION_CACHE_ENTRY);
+  Cache->EntryCount = (UINT32)mPciEnumerationRecordCount;
+  Cache->Reserved   = 0;
+  CopyMem (Cache + 1, mPciEnumerationRecord, Size);
+
+  Status = gRT->SetVariable (
+                  PCI_ENUMERATION_CACHE_VARIABLE_NAME,
+                  &gEfiCallerIdGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                  sizeof (*Cache) + Size,
+                  Cache
+                  );
+  DEBUG ((DEBUG_INFO, "PciBus: Save the enumeration cache of %d functions - %r\n", mPciEnumerationRecordCount, Status));
+  FreePool (Cache);
+
+Done:
+  if (mPciEnumerationCache != NULL) {
+    FreePool (mPciEnumerationCache);
+    mPciEnumerationCache = NULL;
+  }
+
+  if (mPciEnumerationRecord != NULL) {
+    FreePool (mPciEnumerationRecord);
+    mPciEnumerationRecord = NULL;
+  }
+
+  mPciEnumerationCacheMatch     = FALSE;
+  mPciEnumerationRecordCount    = 0;
+  mPciEnumerationRecordCapacity = 0;
+}
+
+/**
+  Take the BARs of a function, and for a PCI-PCI bridge its decodes, from the
+  cache instead of sizing them.
+
+  @param PciIoDevice    PCI device instance.
+
+  @retval TRUE          The BARs are taken from the cache.
+  @retval FALSE         The BARs must be sized.
+
+**/
+BOOLEAN
+PciEnumerationCacheRestoreBars (
+  IN OUT PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+  PCI_BAR                      *PciBar;
+  UINTN                        BarIndex;
+  UINT32                       Value;
+
+  Entry = PciEnumerationCacheLookup (PciIoDevice, PCI_ENUMERATION_CACHE_BARS);
+  if (Entry == NULL) {
+    return FALSE;
+  }
+
+  for (BarIndex = 0; BarIndex < PCI_MAX_BAR; BarIndex++) {
+    PciBar               = &PciIoDevice->PciBar[BarIndex];
+    PciBar->BarType      = (PCI_BAR_TYPE)Entry->Bar[BarIndex].BarType;
+    PciBar->BarTypeFixed = FALSE;
+    PciBar->Offset       = Entry->Bar[BarIndex].Offset;
+    PciBar->Length       = Entry->Bar[BarIndex].Length;
+    PciBar->Alignment    = Entry->Bar[BarIndex].Alignment;
+    PciBar->BaseAddress  = 0;
+
+    //
+    // Only the sizing is skipped, the BAR content is read as PciParseBar () does.
+    //
+    if (PciBar->Length == 0) {
+      continue;
+    }
+
+    PciIoDevice->PciIo.Pci.Read (&PciIoDevice->PciIo, EfiPciIoWidthUint32, PciBar->Offset, 1, &Value);
+    if ((PciBar->BarType == PciBarTypeIo16) || (PciBar->BarType == PciBarTypeIo32)) {
+      PciBar->BaseAddress = Value & 0xfffffffc;
+    } else {
+      PciBar->BaseAddress = Value & 0xfffffff0;
+    }
+
+    if ((PciBar->BarType == PciBarTypeMem64) || (PciBar->BarType == PciBarTypePMem64)) {
+      PciIoDevice->PciIo.Pci.Read (&PciIoDevice->PciIo, EfiPciIoWidthUint32, PciBar->Offset + 4, 1, &Value);
+      PciBar->BaseAddress |= LShiftU64 ((UINT64)Value, 32);
+    }
+  }
+
+  if (IS_PCI_BRIDGE (&PciIoDevice->Pci)) {
+    PciIoDevice->Decodes           = Entry->Decodes;
+    PciIoDevice->BridgeIoAlignment = Entry->BridgeIoAlignment;
+  }
+
+  PciEnumerationCacheRecordBars (PciIoDevice);
+  return TRUE;
+}
+
+/**
+  Record the sized BARs of a function, and for a PCI-PCI bridge its decodes.
+
+  @param PciIoDevice    PCI device instance.
+
+**/
+VOID
+PciEnumerationCacheRecordBars (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+  UINTN                        BarIndex;
+
+  Entry = PciEnumerationCacheRecordEntry (PciIoDevice);
+  if (Entry == NULL) {
+    return;
+  }
+
+  for (BarIndex = 0; BarIndex < PCI_MAX_BAR; BarIndex++) {
+    Entry->Bar[BarIndex].Length    = PciIoDevice->PciBar[BarIndex].Length;
+    Entry->Bar[BarIndex].Alignment = PciIoDevice->PciBar[BarIndex].Alignment;
+    Entry->Bar[BarIndex].BarType   = PciIoDevice->PciBar[BarIndex].BarType;
+    Entry->Bar[BarIndex].Offset    = PciIoDevice->PciBar[BarIndex].Offset;
+  }
+
+  if (IS_PCI_BRIDGE (&PciIoDevice->Pci)) {
+    Entry->Decodes           = PciIoDevice->Decodes;
+    Entry->BridgeIoAlignment = PciIoDevice->BridgeIoAlignment;
+  }
+
+  Entry->Valid |= PCI_ENUMERATION_CACHE_BARS;
+}
+
+/**
+  Take the option ROM size of a function from the cache instead of sizing the
+  option ROM BAR.
+
+  @param PciIoDevice    PCI device instance.
+
+  @retval TRUE          The option ROM size is taken from the cache.
+  @retval FALSE         The option ROM BAR must be sized.
+
+**/
+BOOLEAN
+PciEnumerationCacheRestoreRomSize (
+  IN OUT PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+
+  Entry = PciEnumerationCacheLookup (PciIoDevice, PCI_ENUMERATION_CACHE_ROM_SIZE);
+  if (Entry == NULL) {
+    return FALSE;
+  }
+
+  PciIoDevice->RomSize = Entry->RomSize;
+
+  PciEnumerationCacheRecordRomSize (PciIoDevice);
+  return TRUE;
+}
+
+/**
+  Record the option ROM size of a function.
+
+  @param PciIoDevice    PCI device instance.
+
+**/
+VOID
+PciEnumerationCacheRecordRomSize (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  )
+{
+  PCI_ENUMERATION_CACHE_ENTRY  *Entry;
+
+  Entry = PciEnumerationCacheRecordEntry (PciIoDevice);
+  if (Entry == NULL) {
+    return;
+  }
+
+  Entry->RomSize = PciIoDevice->RomSize;
+  Entry->Valid  |= PCI_ENUMERATION_CACHE_ROM_SIZE;
+}
@@ -0,0 +1,84 @@
+/** @file
+  Cache of the BAR sizing of the PCI functions across boots.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_PCI_ENUMERATION_CACHE_H_
+#define _EFI_PCI_ENUMERATION_CACHE_H_
+
+/**
+  Read the cache of the previous boot, before a full enumeration.
+
+  Nothing is done unless PcdPciEnumerationCacheEnable is TRUE.
+
+**/
+VOID
+PciEnumerationCacheLoad (
+  VOID
+  );
+
+/**
+  Write the cache for the next boot after a full enumeration, if it differs
+  from the cache of this boot, and release the cache.
+
+**/
+VOID
+PciEnumerationCacheSave (
+  VOID
+  );
+
+/**
+  Take the BARs of a function, and for a PCI-PCI bridge its decodes, from the
+  cache instead of sizing them.
+
+  @param PciIoDevice    PCI device instance.
+
+  @retval TRUE          The BARs are taken from the cache.
+  @retval FALSE         The BARs must be sized.
+
+**/
+BOOLEAN
+PciEnumerationCacheRestoreBars (
+  IN OUT PCI_IO_DEVICE  *PciIoDevice
+  );
+
+/**
+  Record the sized BARs of a function, and for a PCI-PCI bridge its decodes.
+
+  @param PciIoDevice    PCI device instance.
+
+**/
+VOID
+PciEnumerationCacheRecordBars (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  );
+
+/**
+  Take the option ROM size of a function from the cache instead of sizing the
+  option ROM BAR.
+
+  @param PciIoDevice    PCI device instance.
+
+  @retval TRUE          The option ROM size is taken from the cache.
+  @retval FALSE         The option ROM BAR must be sized.
+
+**/
+BOOLEAN
+PciEnumerationCacheRestoreRomSize (
+  IN OUT PCI_IO_DEVICE  *PciIoDevice
+  );
+
+/**
+  Record the option ROM size of a function.
+
+  @param PciIoDevice    PCI device instance.
+
+**/
+VOID
+PciEnumerationCacheRecordRomSize (
+  IN PCI_IO_DEVICE  *PciIoDevice
+  );
+
+#endif
@@ -54,6 +54,11 @@ PciEnumerator (
     return Status;
   }
 
+  //
+  // Take the BAR sizes of the previous boot if the platform caches them
+  //
+  PciEnumerationCacheLoad ();
+
   //
   // Start the bus allocation phase
   //
@@ -98,6 +103,8 @@ PciEnumerator (
     return Status;
   }
 
+  PciEnumerationCacheSave ();
+
   return EFI_SUCCESS;
 }
 
@@ -61,14 +61,14 @@ PciDevicePresent (
 
   if (!EFI_ERROR (Status) && ((Pci->Hdr).VendorId != 0xffff)) {
     //
-    // Read the entire config header for the device
+    // Read the rest of the config header for the device
     //
     Status = PciRootBridgeIo->Pci.Read (
                                     PciRootBridgeIo,
                                     EfiPciWidthUint32,
-                                    Address,
-                                    sizeof (PCI_TYPE00) / sizeof (UINT32),
-                                    Pci
+                                    Address + sizeof (UINT32),
+                                    sizeof (PCI_TYPE00) / sizeof (UINT32) - 1,
+                                    (UINT32 *)Pci + 1
                                     );
 
     return EFI_SUCCESS;
@@ -300,8 +300,11 @@ PciSearchDevice (
   // Detect this function has option rom
   //
   if (gFullEnumeration) {
-    if (!IS_CARDBUS_BRIDGE (Pci) && !IgnoreOptionRom) {
+    if (!IS_CARDBUS_BRIDGE (Pci) && !IgnoreOptionRom &&
+        !PciEnumerationCacheRestoreRomSize (PciIoDevice))
+    {
       GetOpRomInfo (PciIoDevice);
+      PciEnumerationCacheRecordRomSize (PciIoDevice);
     }
 
     ResetPowerManagementFeature (PciIoDevice);
@@ -491,8 +494,12 @@ GatherDeviceInfo (
   //
   // Start to parse the bars
   //
-  for (Offset = 0x10, BarIndex = 0; Offset <= 0x24 && BarIndex < PCI_MAX_BAR; BarIndex++) {
-    Offset = PciParseBar (PciIoDevice, Offset, BarIndex);
+  if (!PciEnumerationCacheRestoreBars (PciIoDevice)) {
+    for (Offset = 0x10, BarIndex = 0; Offset <= 0x24 && BarIndex < PCI_MAX_BAR; BarIndex++) {
+      Offset = PciParseBar (PciIoDevice, Offset, BarIndex);
+    }
+
+    PciEnumerationCacheRecordBars (PciIoDevice);
   }
 
   //
@@ -566,103 +573,110 @@ GatherPpbInfo (
   }
 
   //
-  // PPB can have two BARs
+  // The BARs and the decodes of the bridge are sized unless they are cached
   //
-  if (PciParseBar (PciIoDevice, 0x10, PPB_BAR_0) == 0x14) {
+  if (!PciEnumerationCacheRestoreBars (PciIoDevice)) {
     //
-    // Not 64-bit bar
+    // PPB can have two BARs
     //
-    PciParseBar (PciIoDevice, 0x14, PPB_BAR_1);
-  }
-
-  PciIo = &PciIoDevice->PciIo;
-
-  //
-  // Test whether it support 32 decode or not
-  //
-  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Temp);
-  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &gAllOne);
-  PciIo->Pci.Read (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Value);
-  PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Temp);
-
-  if (Value != 0) {
-    if ((Value & 0x01) != 0) {
-      PciIoDevice->Decodes |= EFI_BRIDGE_IO32_DECODE_SUPPORTED;
-    } else {
-      PciIoDevice->Decodes |= EFI_BRIDGE_IO16_DECODE_SUPPORTED;
+    if (PciParseBar (PciIoDevice, 0x10, PPB_BAR_0) == 0x14) {
+      //
+      // Not 64-bit bar
+      //
+      PciParseBar (PciIoDevice, 0x14, PPB_BAR_1);
     }
-  }
 
-  //
-  // if PcdPciBridgeIoAlignmentProbe is TRUE, PCI bus driver probes
-  // PCI bridge supporting non-standard I/O window alignment less than 4K.
-  //
+    PciIo = &PciIoDevice->PciIo;
 
-  PciIoDevice->BridgeIoAlignment = 0xFFF;
-  if (FeaturePcdGet (PcdPciBridgeIoAlignmentProbe)) {
     //
-    // Check any bits of bit 3-1 of I/O Base Register are writable.
-    // if so, it is assumed non-standard I/O window alignment is supported by this bridge.
-    // Per spec, bit 3-1 of I/O Base Register are reserved bits, so its content can't be assumed.
+    // Test whether it support 32 decode or not
     //
-    Value = (UINT8)(Temp ^ (BIT3 | BIT2 | BIT1));
-    PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Value);
+    PciIo->Pci.Read (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Temp);
+    PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &gAllOne);
     PciIo->Pci.Read (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Value);
     PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Temp);
-    Value = (UINT8)((Value ^ Temp) & (BIT3 | BIT2 | BIT1));
-    switch (Value) {
-      case BIT3:
-        PciIoDevice->BridgeIoAlignment = 0x7FF;
-        break;
-      case BIT3 | BIT2:
-        PciIoDevice->BridgeIoAlignment = 0x3FF;
-        break;
-      case BIT3 | BIT2 | BIT1:
-        PciIoDevice->BridgeIoAlignment = 0x1FF;
-        break;
+
+    if (Value != 0) {
+      if ((Value & 0x01) != 0) {
+        PciIoDevice->Decodes |= EFI_BRIDGE_IO32_DECODE_SUPPORTED;
+      } else {
+        PciIoDevice->Decodes |= EFI_BRIDGE_IO16_DECODE_SUPPORTED;
+      }
     }
-  }
 
-  Status = BarExisted (
-             PciIoDevice,
-             0x24,
-             NULL,
-             &PMemBaseLimit
-             );
+    //
+    // if PcdPciBridgeIoAlignmentProbe is TRUE, PCI bus driver probes
+    // PCI bridge supporting non-standard I/O window alignment less than 4K.
+    //
+
+    PciIoDevice->BridgeIoAlignment = 0xFFF;
+    if (FeaturePcdGet (PcdPciBridgeIoAlignmentProbe)) {
+      //
+      // Check any bits of bit 3-1 of I/O Base Register are writable.
+      // if so, it is assumed non-standard I/O window alignment is supported by this bridge.
+      // Per spec, bit 3-1 of I/O Base Register are reserved bits, so its content can't be assumed.
+      //
+      Value = (UINT8)(Temp ^ (BIT3 | BIT2 | BIT1));
+      PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Value);
+      PciIo->Pci.Read (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Value);
+      PciIo->Pci.Write (PciIo, EfiPciIoWidthUint8, 0x1C, 1, &Temp);
+      Value = (UINT8)((Value ^ Temp) & (BIT3 | BIT2 | BIT1));
+      switch (Value) {
+        case BIT3:
+          PciIoDevice->BridgeIoAlignment = 0x7FF;
+          break;
+        case BIT3 | BIT2:
+          PciIoDevice->BridgeIoAlignment = 0x3FF;
+          break;
+        case BIT3 | BIT2 | BIT1:
+          PciIoDevice->BridgeIoAlignment = 0x1FF;
+          break;
+      }
+    }
 
-  //
-  // Test if it supports 64 memory or not
-  //
-  // The bottom 4 bits of both the Prefetchable Memory Base and Prefetchable Memory Limit
-  // registers:
-  //   0 - the bridge supports only 32 bit addresses.
-  //   1 - the bridge supports 64-bit addresses.
-  //
-  PrefetchableMemoryBase  = (UINT16)(PMemBaseLimit & 0xffff);
-  PrefetchableMemoryLimit = (UINT16)(PMemBaseLimit >> 16);
-  if (!EFI_ERROR (Status) &&
-      ((PrefetchableMemoryBase & 0x000f) == 0x0001) &&
-      ((PrefetchableMemoryLimit & 0x000f) == 0x0001))
-  {
     Status = BarExisted (
                PciIoDevice,
-               0x28,
+               0x24,
                NULL,
-               NULL
+               &PMemBaseLimit
                );
 
-    if (!EFI_ERROR (Status)) {
-      PciIoDevice->Decodes |= EFI_BRIDGE_PMEM32_DECODE_SUPPORTED;
-      PciIoDevice->Decodes |= EFI_BRIDGE_PMEM64_DECODE_SUPPORTED;
-    } else {
-      PciIoDevice->Decodes |= EFI_BRIDGE_PMEM32_DECODE_SUPPORTED;
+    //
+    // Test if it supports 64 memory or not
+    //
+    // The bottom 4 bits of both the Prefetchable Memory Base and Prefetchable Memory Limit
+    // registers:
+    //   0 - the bridge supports only 32 bit addresses.
+    //   1 - the bridge supports 64-bit addresses.
+    //
+    PrefetchableMemoryBase  = (UINT16)(PMemBaseLimit & 0xffff);
+    PrefetchableMemoryLimit = (UINT16)(PMemBaseLimit >> 16);
+    if (!EFI_ERROR (Status) &&
+        ((PrefetchableMemoryBase & 0x000f) == 0x0001) &&
+        ((PrefetchableMemoryLimit & 0x000f) == 0x0001))
+    {
+      Status = BarExisted (
+                 PciIoDevice,
+                 0x28,
+                 NULL,
+                 NULL
+                 );
+
+      if (!EFI_ERROR (Status)) {
+        PciIoDevice->Decodes |= EFI_BRIDGE_PMEM32_DECODE_SUPPORTED;
+        PciIoDevice->Decodes |= EFI_BRIDGE_PMEM64_DECODE_SUPPORTED;
+      } else {
+        PciIoDevice->Decodes |= EFI_BRIDGE_PMEM32_DECODE_SUPPORTED;
+      }
     }
-  }
 
-  //
-  // Memory 32 code is required for ppb
-  //
-  PciIoDevice->Decodes |= EFI_BRIDGE_MEM32_DECODE_SUPPORTED;
+    //
+    // Memory 32 code is required for ppb
+    //
+    PciIoDevice->Decodes |= EFI_BRIDGE_MEM32_DECODE_SUPPORTED;
+
+    PciEnumerationCacheRecordBars (PciIoDevice);
+  }
 
   GetResourcePaddingPpb (PciIoDevice);
 
@@ -2203,8 +2217,9 @@ CreatePciIoDevice (
   PciIoDevice->Registered        = FALSE;
   PciIoDevice->Attributes        = 0;
   PciIoDevice->Supports          = 0;
-  PciIoDevice->BusOverride       = FALSE;
-  PciIoDevice->AllOpRomProcessed = FALSE;
+  PciIoDevice->BusOverride          = FALSE;
+  PciIoDevice->AllOpRomProcessed    = FALSE;
+  PciIoDevice->OpRomDispatchPending = FALSE;
 
   PciIoDevice->IsPciExp = FALSE;
 
@@ -0,0 +1,1102 @@
+/** @file
+  Command Queueing Engine (CQE) support of the SD/MMC host controller driver.
+
+  The SD/MMC pass thru protocol is command based, so eMMC devices with command
+  queuing enabled are driven by the eMMC 5.1 sequence of CMD44 and CMD45 to
+  queue a task, CMD13 with the SQS bit to read the Queue Status Register and
+  CMD46/CMD47 to execute the task. On slots with a CQE, these packets don't go
+  out on the bus: the task they describe is written into the Task Descriptor
+  List of the CQE, which sends the commands itself and runs up to 32 tasks
+  concurrently. Other commands are executed with the CQE disabled, once the
+  tasks under execution have completed.
+
+  The CQE register block lives at a vendor specific offset of the slot BAR,
+  given by PcdSdMmcCqeRegisterOffset.
+
+  Refer to eMMC Electrical Standard Spec 5.1 Section 6.6.39 and Annex B for
+  details.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "SdMmcPciHcDxe.h"
+
+/**
+  Read/write a register of the Command Queueing Engine.
+
+  @param[in]      Private   A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]      Slot      The slot number of the eMMC device.
+  @param[in]      Offset    The offset of the register in the CQE register block.
+  @param[in]      Read      A boolean to indicate it's read or write operation.
+  @param[in, out] Data      The register value.
+
+  @retval EFI_SUCCESS       The read/write operation succeeds.
+  @retval Others            The read/write operation fails.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeRwReg (
+  IN     SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN     UINT8                   Slot,
+  IN     UINT32                  Offset,
+  IN     BOOLEAN                 Read,
+  IN OUT UINT32                  *Data
+  )
+{
+  return SdMmcHcRwMmio (
+           Private->PciIo,
+           Slot,
+           Private->Cqe[Slot]->Base + Offset,
+           Read,
+           sizeof (UINT32),
+           Data
+           );
+}
+
+/**
+  Write a register of the Command Queueing Engine.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] Offset         The offset of the register in the CQE register block.
+  @param[in] Value          The value to write.
+
+  @retval EFI_SUCCESS       The write operation succeeds.
+  @retval Others            The write operation fails.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeWriteReg (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT32                  Offset,
+  IN UINT32                  Value
+  )
+{
+  return SdMmcCqeRwReg (Private, Slot, Offset, FALSE, &Value);
+}
+
+/**
+  Complete a queued task: report its status, free its TRB and signal its event.
+
+  @param[in] Cqe            A pointer to the SD_MMC_CQE instance.
+  @param[in] TaskId         The ID of the task.
+  @param[in] Status         The transaction status of the task.
+
+**/
+STATIC
+VOID
+SdMmcCqeCompleteTask (
+  IN SD_MMC_CQE  *Cqe,
+  IN UINT8       TaskId,
+  IN EFI_STATUS  Status
+  )
+{
+  SD_MMC_HC_TRB  *Trb;
+  EFI_EVENT      TrbEvent;
+
+  Trb                            = Cqe->Task[TaskId].Trb;
+  Trb->Packet->TransactionStatus = Status;
+  TrbEvent                       = Trb->Event;
+  SdMmcFreeTrb (Trb);
+  ZeroMem (&Cqe->Task[TaskId], sizeof (SD_MMC_CQE_TASK));
+
+  if (TrbEvent != NULL) {
+    DEBUG ((DEBUG_VERBOSE, "SdMmcCqeCompleteTask(): Signal Event %p of task %d with %r\n", TrbEvent, TaskId, Status));
+    gBS->SignalEvent (TrbEvent);
+  }
+}
+
+/**
+  Enable the Command Queueing Engine of a slot.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The CQE is enabled.
+  @retval Others            The CQE can't be enabled.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeEnable (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  SD_MMC_CQE           *Cqe;
+  UINT8                HostCtrl1;
+  UINT16               BlkSize;
+  UINT32               Config;
+
+  PciIo = Private->PciIo;
+  Cqe   = Private->Cqe[Slot];
+  if (Cqe->Enabled) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The CQE transfers the data through ADMA2, in blocks of 512 bytes.
+  //
+  HostCtrl1 = BIT4;
+  Status    = SdMmcHcOrMmio (PciIo, Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  BlkSize = 0x200;
+  Status  = SdMmcHcRwMmio (PciIo, Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Config = Cqe->Dma64 ? SD_MMC_CQE_CFG_TASK_DESC_128 : 0;
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CFG, Config);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_TDLBA, (UINT32)Cqe->TdlPhy);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_TDLBAU, (UINT32)RShiftU64 (Cqe->TdlPhy, 32));
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The CQE polls the device queue status with CMD13 addressed to the RCA
+  // assigned by EmmcIdentification().
+  //
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_SSC2, (UINT32)Slot + 1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Completions and errors are polled, latch them without signaling.
+  //
+  Status = SdMmcCqeWriteReg (
+             Private,
+             Slot,
+             SD_MMC_CQE_ISTE,
+             SD_MMC_CQE_IS_HAC | SD_MMC_CQE_IS_TCC | SD_MMC_CQE_IS_TCL | SD_MMC_CQE_IS_ERROR
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_ISGE, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_IS, MAX_UINT32);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CFG, Config | SD_MMC_CQE_CFG_ENABLE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CTL, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Cqe->Enabled = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Halt the Command Queueing Engine of a slot, discard the tasks it holds and
+  disable it.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] ClearAll       Whether to discard the tasks held by the CQE.
+
+  @retval EFI_SUCCESS       The CQE is disabled.
+  @retval Others            The CQE can't be halted. It is disabled anyway.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeDisable (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN BOOLEAN                 ClearAll
+  )
+{
+  EFI_STATUS  Status;
+  SD_MMC_CQE  *Cqe;
+
+  Cqe = Private->Cqe[Slot];
+  if (!Cqe->Enabled) {
+    return EFI_SUCCESS;
+  }
+
+  Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CTL, SD_MMC_CQE_CTL_HALT);
+  if (!EFI_ERROR (Status)) {
+    Status = SdMmcHcWaitMmioSet (
+               Private->PciIo,
+               Slot,
+               Cqe->Base + SD_MMC_CQE_CTL,
+               sizeof (UINT32),
+               SD_MMC_CQE_CTL_HALT,
+               SD_MMC_CQE_CTL_HALT,
+               SD_MMC_HC_GENERIC_TIMEOUT
+               );
+  }
+
+  if (!EFI_ERROR (Status) && ClearAll) {
+    Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CTL, SD_MMC_CQE_CTL_HALT | SD_MMC_CQE_CTL_CLEAR_ALL);
+    if (!EFI_ERROR (Status)) {
+      Status = SdMmcHcWaitMmioSet (
+                 Private->PciIo,
+                 Slot,
+                 Cqe->Base + SD_MMC_CQE_CTL,
+                 sizeof (UINT32),
+                 SD_MMC_CQE_CTL_CLEAR_ALL,
+                 0,
+                 SD_MMC_HC_GENERIC_TIMEOUT
+                 );
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "SdMmcCqeDisable: Slot[%d] fails to halt the CQE - %r\n", Slot, Status));
+  }
+
+  SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_CFG, 0);
+  SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_IS, MAX_UINT32);
+  Cqe->Enabled = FALSE;
+
+  return Status;
+}
+
+/**
+  Discard all the tasks queued in the eMMC device with CMD48.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+STATIC
+VOID
+SdMmcCqeDiscardQueue (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS                           Status;
+  EFI_SD_MMC_COMMAND_BLOCK             SdMmcCmdBlk;
+  EFI_SD_MMC_STATUS_BLOCK              SdMmcStatusBlk;
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  Packet;
+  SD_MMC_HC_TRB                        *Trb;
+
+  ZeroMem (&SdMmcCmdBlk, sizeof (SdMmcCmdBlk));
+  ZeroMem (&SdMmcStatusBlk, sizeof (SdMmcStatusBlk));
+  ZeroMem (&Packet, sizeof (Packet));
+  Packet.SdMmcCmdBlk    = &SdMmcCmdBlk;
+  Packet.SdMmcStatusBlk = &SdMmcStatusBlk;
+  Packet.Timeout        = SD_MMC_HC_GENERIC_TIMEOUT;
+
+  //
+  // TM op-code 1h: discard the entire queue.
+  //
+  SdMmcCmdBlk.CommandIndex    = EMMC_CMDQ_TASK_MGMT;
+  SdMmcCmdBlk.CommandType     = SdMmcCommandTypeAc;
+  SdMmcCmdBlk.ResponseType    = SdMmcResponseTypeR1b;
+  SdMmcCmdBlk.CommandArgument = 1;
+
+  Trb = SdMmcCreateTrb (Private, Slot, &Packet, NULL);
+  if (Trb == NULL) {
+    return;
+  }
+
+  Status = SdMmcWaitTrbEnv (Private, Trb);
+  if (!EFI_ERROR (Status)) {
+    Status = SdMmcExecTrb (Private, Trb);
+    if (!EFI_ERROR (Status)) {
+      Status = SdMmcWaitTrbResult (Private, Trb);
+    }
+  }
+
+  SdMmcFreeTrb (Trb);
+  DEBUG ((DEBUG_INFO, "SdMmcCqeDiscardQueue: Slot[%d] discards the device queue - %r\n", Slot, Status));
+}
+
+/**
+  Recover the Command Queueing Engine of a slot from an error: discard the
+  tasks held by the CQE and the eMMC device, reset the CMD and DAT lines and
+  complete the started tasks. The tasks which haven't started are kept.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] Status         The transaction status of the started tasks.
+
+**/
+STATIC
+VOID
+SdMmcCqeRecover (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              Status
+  )
+{
+  SD_MMC_CQE  *Cqe;
+  UINT32      IntStatus;
+  UINT32      TaskError;
+  UINT8       TaskId;
+
+  Cqe       = Private->Cqe[Slot];
+  IntStatus = 0;
+  TaskError = 0;
+  SdMmcCqeRwReg (Private, Slot, SD_MMC_CQE_IS, TRUE, &IntStatus);
+  SdMmcCqeRwReg (Private, Slot, SD_MMC_CQE_TERRI, TRUE, &TaskError);
+  DEBUG ((
+    DEBUG_ERROR,
+    "SdMmcCqeRecover: Slot[%d] CQIS 0x%x CQTERRI 0x%x - %r\n",
+    Slot,
+    IntStatus,
+    TaskError,
+    Status
+    ));
+
+  SdMmcCqeDisable (Private, Slot, TRUE);
+  SdMmcSoftwareReset (Private, Slot, 0x7F);
+
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    if (Cqe->Task[TaskId].Started) {
+      SdMmcCqeCompleteTask (Cqe, TaskId, Status);
+    }
+  }
+
+  SdMmcCqeDiscardQueue (Private, Slot);
+}
+
+/**
+  Fill in the Task Descriptor List slot of a task.
+
+  @param[in] Cqe            A pointer to the SD_MMC_CQE instance.
+  @param[in] TaskId         The ID of the task.
+
+**/
+STATIC
+VOID
+SdMmcCqeBuildTaskDesc (
+  IN SD_MMC_CQE  *Cqe,
+  IN UINT8       TaskId
+  )
+{
+  SD_MMC_CQE_TASK         *Task;
+  SD_MMC_CQE_TASK_DESC    *Desc;
+  SD_MMC_CQE_TDL_SLOT_32  *Slot32;
+  SD_MMC_CQE_TDL_SLOT_64  *Slot64;
+
+  Task = &Cqe->Task[TaskId];
+  Desc = (SD_MMC_CQE_TASK_DESC *)((UINT8 *)Cqe->Tdl + TaskId * Cqe->SlotSize);
+  ZeroMem (Desc, Cqe->SlotSize);
+
+  //
+  // The fields of the task descriptor come from the CMD44 argument.
+  //
+  Desc->Valid        = 1;
+  Desc->End          = 1;
+  Desc->Int          = 1;
+  Desc->Act          = SD_MMC_CQE_ACT_TASK;
+  Desc->Forced       = BitFieldRead32 (Task->Params, 24, 24);
+  Desc->ContextId    = BitFieldRead32 (Task->Params, 25, 28);
+  Desc->Tag          = BitFieldRead32 (Task->Params, 29, 29);
+  Desc->DataDir      = BitFieldRead32 (Task->Params, 30, 30);
+  Desc->Priority     = BitFieldRead32 (Task->Params, 23, 23);
+  Desc->RelWrite     = BitFieldRead32 (Task->Params, 31, 31);
+  Desc->BlockCount   = BitFieldRead32 (Task->Params, 0, 15);
+  Desc->BlockAddress = Task->Address;
+
+  //
+  // The link descriptor points to the ADMA2 descriptors of the TRB.
+  //
+  if (Cqe->Dma64) {
+    Slot64                    = (SD_MMC_CQE_TDL_SLOT_64 *)Desc;
+    Slot64->Link.Valid        = 1;
+    Slot64->Link.Act          = 3;
+    Slot64->Link.LowerAddress = (UINT32)Task->Trb->AdmaDescPhy;
+    Slot64->Link.UpperAddress = (UINT32)RShiftU64 (Task->Trb->AdmaDescPhy, 32);
+  } else {
+    Slot32               = (SD_MMC_CQE_TDL_SLOT_32 *)Desc;
+    Slot32->Link.Valid   = 1;
+    Slot32->Link.Act     = 3;
+    Slot32->Link.Address = (UINT32)Task->Trb->AdmaDescPhy;
+  }
+}
+
+/**
+  Hand the executed tasks of a slot which haven't started over to the Command
+  Queueing Engine. The regular commands queued for the slot before are executed
+  first. Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+STATIC
+VOID
+SdMmcCqeStartTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS       Status;
+  SD_MMC_CQE       *Cqe;
+  SD_MMC_CQE_TASK  *Task;
+  LIST_ENTRY       *Link;
+  SD_MMC_HC_TRB    *Trb;
+  UINT32           Doorbell;
+  UINT8            TaskId;
+
+  Cqe = Private->Cqe[Slot];
+
+  for (Link = GetFirstNode (&Private->Queue);
+       !IsNull (&Private->Queue, Link);
+       Link = GetNextNode (&Private->Queue, Link))
+  {
+    Trb = SD_MMC_HC_TRB_FROM_THIS (Link);
+    if (Trb->Slot == Slot) {
+      return;
+    }
+  }
+
+  Doorbell = 0;
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    Task = &Cqe->Task[TaskId];
+    if ((Task->Trb == NULL) || Task->Started) {
+      continue;
+    }
+
+    Status = SdMmcCqeEnable (Private, Slot);
+    if (EFI_ERROR (Status)) {
+      SdMmcCqeCompleteTask (Cqe, TaskId, Status);
+      continue;
+    }
+
+    SdMmcCqeBuildTaskDesc (Cqe, TaskId);
+    Task->Started = TRUE;
+    Doorbell     |= (UINT32)LShiftU64 (1, TaskId);
+  }
+
+  if (Doorbell != 0) {
+    Status = SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_TDBR, Doorbell);
+    if (EFI_ERROR (Status)) {
+      SdMmcCqeRecover (Private, Slot, Status);
+    }
+  }
+}
+
+/**
+  Execute a task with the Command Queueing Engine, from its CMD46/CMD47 packet.
+
+  @param[in]     Private    A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]     Slot       The slot number of the eMMC device.
+  @param[in,out] Packet     A pointer to the CMD46/CMD47 packet.
+  @param[in]     Event      If Event is NULL, blocking I/O is performed. If Event is
+                            not NULL, then nonblocking I/O is performed, and Event
+                            will be signaled when the Packet completes.
+
+  @retval EFI_SUCCESS           The task is queued if Event is not NULL, or is executed
+                                successfully if Event is NULL.
+  @retval EFI_INVALID_PARAMETER The task isn't queued or doesn't match the packet.
+  @retval EFI_OUT_OF_RESOURCES  The task can't be mapped for the DMA transfer.
+  @retval Others                The task isn't executed successfully.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeExecuteTask (
+  IN     SD_MMC_HC_PRIVATE_DATA               *Private,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event
+  )
+{
+  SD_MMC_CQE       *Cqe;
+  SD_MMC_CQE_TASK  *Task;
+  SD_MMC_HC_TRB    *Trb;
+  EFI_TPL          OldTpl;
+  BOOLEAN          IsRead;
+  UINT32           DataLen;
+  UINT64           Timeout;
+  BOOLEAN          InfiniteWait;
+  BOOLEAN          Done;
+  UINT8            TaskId;
+
+  Cqe     = Private->Cqe[Slot];
+  TaskId  = (UINT8)BitFieldRead32 (Packet->SdMmcCmdBlk->CommandArgument, 16, 20);
+  Task    = &Cqe->Task[TaskId];
+  IsRead  = (BOOLEAN)(Packet->SdMmcCmdBlk->CommandIndex == EMMC_EXECUTE_READ_TASK);
+  DataLen = IsRead ? Packet->InTransferLength : Packet->OutTransferLength;
+
+  if (!Task->ParamsValid || !Task->AddressValid || (Task->Trb != NULL) ||
+      (BitFieldRead32 (Task->Params, 30, 30) != (IsRead ? 1 : 0)) ||
+      (DataLen == 0) || (DataLen != BitFieldRead32 (Task->Params, 0, 15) * 0x200))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Trb = SdMmcCreateTrb (Private, Slot, Packet, NULL);
+  if (Trb == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Trb->Mode != (Cqe->Dma64 ? SdMmcAdma64bV4Mode : SdMmcAdma32bMode)) {
+    SdMmcFreeTrb (Trb);
+    return EFI_UNSUPPORTED;
+  }
+
+  Trb->Event = Event;
+
+  OldTpl    = gBS->RaiseTPL (TPL_NOTIFY);
+  Task->Trb = Trb;
+  SdMmcCqeStartTasks (Private, Slot);
+  gBS->RestoreTPL (OldTpl);
+
+  if (Event != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Blocking I/O: poll the CQE until the task completes.
+  //
+  Timeout      = Packet->Timeout;
+  InfiniteWait = (BOOLEAN)(Timeout == 0);
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    SdMmcCqeProcessTasks (Private, Slot);
+    Done = (BOOLEAN)(Task->Trb != Trb);
+    if (!Done && !InfiniteWait && (Timeout-- == 0)) {
+      if (Task->Started) {
+        SdMmcCqeRecover (Private, Slot, EFI_TIMEOUT);
+      } else {
+        SdMmcCqeCompleteTask (Cqe, TaskId, EFI_TIMEOUT);
+      }
+
+      Done = TRUE;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    if (Done) {
+      break;
+    }
+
+    gBS->Stall (1);
+  }
+
+  return Packet->TransactionStatus;
+}
+
+/**
+  Detect the Command Queueing Engine of an eMMC slot and allocate its Task
+  Descriptor List. The CQE is left disabled until a queued task is executed.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeInitSlot (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  SD_MMC_CQE           *Cqe;
+  UINT32               Version;
+  UINTN                TdlSize;
+  UINTN                Bytes;
+
+  PciIo = Private->PciIo;
+  if ((PcdGet32 (PcdSdMmcCqeRegisterOffset) == 0) ||
+      !Private->Slot[Slot].Enable ||
+      !Private->Slot[Slot].Initialized ||
+      (Private->Slot[Slot].CardType != EmmcCardType) ||
+      (Private->Capability[Slot].Adma2 == 0) ||
+      (Private->ControllerVersion[Slot] < SD_MMC_HC_CTRL_VER_400))
+  {
+    return;
+  }
+
+  Status = SdMmcHcRwMmio (
+             PciIo,
+             Slot,
+             PcdGet32 (PcdSdMmcCqeRegisterOffset) + SD_MMC_CQE_VER,
+             TRUE,
+             sizeof (Version),
+             &Version
+             );
+  if (EFI_ERROR (Status) || (Version == 0) || (Version == MAX_UINT32)) {
+    return;
+  }
+
+  Cqe = AllocateZeroPool (sizeof (SD_MMC_CQE));
+  if (Cqe == NULL) {
+    return;
+  }
+
+  Cqe->Base = PcdGet32 (PcdSdMmcCqeRegisterOffset);
+  //
+  // Follow the transfer mode SdMmcCreateTrb() picks for the slot: the 128-bit
+  // task descriptors go with the 128-bit ADMA2 descriptors of the V4 mode.
+  //
+  Cqe->Dma64 = (BOOLEAN)(((Private->ControllerVersion[Slot] == SD_MMC_HC_CTRL_VER_400) &&
+                          (Private->Capability[Slot].SysBus64V3 == 1)) ||
+                         ((Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) &&
+                          (Private->Capability[Slot].SysBus64V4 == 1)));
+  if (Cqe->Dma64) {
+    Cqe->SlotSize = sizeof (SD_MMC_CQE_TDL_SLOT_64);
+  } else {
+    Cqe->SlotSize = sizeof (SD_MMC_CQE_TDL_SLOT_32);
+  }
+
+  TdlSize = Cqe->SlotSize * SD_MMC_CQE_MAX_TASKS;
+  Status  = PciIo->AllocateBuffer (
+                     PciIo,
+                     AllocateAnyPages,
+                     EfiBootServicesData,
+                     EFI_SIZE_TO_PAGES (TdlSize),
+                     &Cqe->Tdl,
+                     0
+                     );
+  if (EFI_ERROR (Status)) {
+    FreePool (Cqe);
+    return;
+  }
+
+  ZeroMem (Cqe->Tdl, TdlSize);
+  Bytes  = TdlSize;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Cqe->Tdl,
+                    &Bytes,
+                    &Cqe->TdlPhy,
+                    &Cqe->TdlMap
+                    );
+  if (EFI_ERROR (Status) || (Bytes != TdlSize) ||
+      (!Cqe->Dma64 && (Cqe->TdlPhy + TdlSize > 0x100000000ull)))
+  {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Cqe->TdlMap);
+    }
+
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES (TdlSize), Cqe->Tdl);
+    FreePool (Cqe);
+    return;
+  }
+
+  Private->Cqe[Slot] = Cqe;
+  DEBUG ((
+    DEBUG_INFO,
+    "SdMmcCqeInitSlot: Slot[%d] CQE version 0x%x with %a-bit task descriptors\n",
+    Slot,
+    Version,
+    Cqe->Dma64 ? "128" : "64"
+    ));
+}
+
+/**
+  Abort the queued tasks of a slot and free its Command Queueing Engine.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeFreeSlot (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  SD_MMC_CQE           *Cqe;
+  EFI_TPL              OldTpl;
+
+  Cqe = Private->Cqe[Slot];
+  if (Cqe == NULL) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  SdMmcCqeAbortTasks (Private, Slot, EFI_ABORTED);
+  gBS->RestoreTPL (OldTpl);
+
+  PciIo = Private->PciIo;
+  PciIo->Unmap (PciIo, Cqe->TdlMap);
+  PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES (Cqe->SlotSize * SD_MMC_CQE_MAX_TASKS), Cqe->Tdl);
+  FreePool (Cqe);
+  Private->Cqe[Slot] = NULL;
+}
+
+/**
+  Handle the eMMC command queuing packets of a slot with a Command Queueing
+  Engine. CMD44 and CMD45 only record the task, CMD13 with the SQS bit reports
+  the recorded tasks as ready and CMD46/CMD47 hands the task over to the CQE.
+  Enabling command queuing in the device is rejected when the slot has no CQE.
+
+  @param[in]  Private       A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Slot          The slot number of the eMMC device.
+  @param[in]  Packet        A pointer to the SD command data structure.
+  @param[in]  Event         If Event is NULL, blocking I/O is performed. If Event is
+                            not NULL, then nonblocking I/O is performed, and Event
+                            will be signaled when the Packet completes.
+  @param[out] Status        The status of PassThru() when the packet is handled.
+
+  @retval TRUE              The packet is handled and Status is returned.
+  @retval FALSE             The packet must be executed as a regular command.
+
+**/
+BOOLEAN
+SdMmcCqePassThru (
+  IN     SD_MMC_HC_PRIVATE_DATA               *Private,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event,
+  OUT    EFI_STATUS                           *Status
+  )
+{
+  SD_MMC_CQE       *Cqe;
+  SD_MMC_CQE_TASK  *Task;
+  EFI_TPL          OldTpl;
+  UINT32           Argument;
+  UINT32           QueueStatus;
+  UINT8            TaskId;
+
+  if (Private->Slot[Slot].CardType != EmmcCardType) {
+    return FALSE;
+  }
+
+  Cqe      = Private->Cqe[Slot];
+  Argument = Packet->SdMmcCmdBlk->CommandArgument;
+
+  if (Cqe == NULL) {
+    //
+    // Without a CQE, each task would take four commands executed one at a time,
+    // so keep the device out of command queuing: reject a SWITCH which sets
+    // CMDQ_MODE_EN with the "Set Bits" or "Write Byte" access.
+    //
+    if ((Packet->SdMmcCmdBlk->CommandIndex == EMMC_SWITCH) &&
+        (BitFieldRead32 (Argument, 16, 23) == OFFSET_OF (EMMC_EXT_CSD, CmdqModeEn)) &&
+        ((Argument & BIT24) != 0) &&
+        ((Argument & BIT8) != 0))
+    {
+      *Status = EFI_UNSUPPORTED;
+      return TRUE;
+    }
+
+    return FALSE;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  switch (Packet->SdMmcCmdBlk->CommandIndex) {
+    case EMMC_QUEUED_TASK_PARAMS:
+      TaskId = (UINT8)BitFieldRead32 (Argument, 16, 20);
+      Task   = &Cqe->Task[TaskId];
+      if (Task->Trb != NULL) {
+        *Status = EFI_DEVICE_ERROR;
+        break;
+      }
+
+      Task->Params       = Argument;
+      Task->ParamsValid  = TRUE;
+      Task->AddressValid = FALSE;
+      Cqe->LastTaskId    = TaskId;
+      *Status            = EFI_SUCCESS;
+      break;
+
+    case EMMC_QUEUED_TASK_ADDRESS:
+      //
+      // CMD45 applies to the task of the preceding CMD44.
+      //
+      Task = &Cqe->Task[Cqe->LastTaskId];
+      if (!Task->ParamsValid || (Task->Trb != NULL)) {
+        *Status = EFI_DEVICE_ERROR;
+        break;
+      }
+
+      Task->Address      = Argument;
+      Task->AddressValid = TRUE;
+      *Status            = EFI_SUCCESS;
+      break;
+
+    case EMMC_SEND_STATUS:
+      if ((Argument & BIT15) == 0) {
+        gBS->RestoreTPL (OldTpl);
+        return FALSE;
+      }
+
+      //
+      // The CQE checks the device queue status itself before executing a task,
+      // so all the recorded tasks are reported as ready.
+      //
+      QueueStatus = 0;
+      for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+        Task = &Cqe->Task[TaskId];
+        if (Task->ParamsValid && Task->AddressValid && (Task->Trb == NULL)) {
+          QueueStatus |= (UINT32)LShiftU64 (1, TaskId);
+        }
+      }
+
+      Packet->SdMmcStatusBlk->Resp0 = QueueStatus;
+      *Status                       = EFI_SUCCESS;
+      break;
+
+    case EMMC_EXECUTE_READ_TASK:
+    case EMMC_EXECUTE_WRITE_TASK:
+      gBS->RestoreTPL (OldTpl);
+      *Status = SdMmcCqeExecuteTask (Private, Slot, Packet, Event);
+      return TRUE;
+
+    default:
+      gBS->RestoreTPL (OldTpl);
+      return FALSE;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  //
+  // The packets which only record the task complete at once.
+  //
+  if ((Event != NULL) && !EFI_ERROR (*Status)) {
+    Packet->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Event);
+  }
+
+  return TRUE;
+}
+
+/**
+  Complete the finished tasks of a slot and start the pending ones.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeProcessTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS  Status;
+  SD_MMC_CQE  *Cqe;
+  UINT32      IntStatus;
+  UINT16      HcIntStatus;
+  UINT32      Completed;
+  UINT8       TaskId;
+
+  Cqe = Private->Cqe[Slot];
+  if (Cqe == NULL) {
+    return;
+  }
+
+  if (Cqe->Enabled) {
+    Status = SdMmcCqeRwReg (Private, Slot, SD_MMC_CQE_IS, TRUE, &IntStatus);
+    if (!EFI_ERROR (Status)) {
+      Status = SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_NOR_INT_STS, TRUE, sizeof (HcIntStatus), &HcIntStatus);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+
+    //
+    // Data and command errors of the tasks are reported through the Error
+    // Interrupt Status register of the host controller.
+    //
+    if (((IntStatus & SD_MMC_CQE_IS_ERROR) != 0) || ((HcIntStatus & BIT15) != 0)) {
+      SdMmcCqeRecover (Private, Slot, EFI_DEVICE_ERROR);
+    } else {
+      Status = SdMmcCqeRwReg (Private, Slot, SD_MMC_CQE_TCN, TRUE, &Completed);
+      if (EFI_ERROR (Status)) {
+        return;
+      }
+
+      if (Completed != 0) {
+        SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_TCN, Completed);
+        SdMmcCqeWriteReg (Private, Slot, SD_MMC_CQE_IS, SD_MMC_CQE_IS_TCC);
+        for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+          if (((Completed & LShiftU64 (1, TaskId)) != 0) && Cqe->Task[TaskId].Started) {
+            SdMmcCqeCompleteTask (Cqe, TaskId, EFI_SUCCESS);
+          }
+        }
+      }
+    }
+  }
+
+  SdMmcCqeStartTasks (Private, Slot);
+}
+
+/**
+  Count down the timeout of the started tasks of a slot, once per tick of the
+  asynchronous I/O monitor, and recover the CQE from the expired ones.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeCheckTimeout (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  SD_MMC_CQE     *Cqe;
+  SD_MMC_HC_TRB  *Trb;
+  UINT8          TaskId;
+
+  Cqe = Private->Cqe[Slot];
+  if (Cqe == NULL) {
+    return;
+  }
+
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    Trb = Cqe->Task[TaskId].Trb;
+    if ((Trb == NULL) || !Cqe->Task[TaskId].Started || (Trb->Event == NULL) ||
+        (Trb->Packet->Timeout == 0))
+    {
+      continue;
+    }
+
+    if (Trb->Timeout-- == 0) {
+      SdMmcCqeRecover (Private, Slot, EFI_TIMEOUT);
+      return;
+    }
+  }
+}
+
+/**
+  Check whether a slot has no queued task waiting for or under execution.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval TRUE              No task is waiting for or under execution.
+  @retval FALSE             Some tasks are waiting for or under execution.
+
+**/
+BOOLEAN
+SdMmcCqeIsIdle (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  SD_MMC_CQE  *Cqe;
+  UINT8       TaskId;
+
+  Cqe = Private->Cqe[Slot];
+  if (Cqe == NULL) {
+    return TRUE;
+  }
+
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    if (Cqe->Task[TaskId].Trb != NULL) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Disable the Command Queueing Engine of a slot, so that a regular command can
+  be executed. Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The CQE is disabled or the slot has no CQE.
+  @retval EFI_NOT_READY     Some tasks are under execution.
+  @retval Others            The CQE can't be halted.
+
+**/
+EFI_STATUS
+SdMmcCqeStop (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  SD_MMC_CQE  *Cqe;
+  UINT8       TaskId;
+
+  Cqe = Private->Cqe[Slot];
+  if ((Cqe == NULL) || !Cqe->Enabled) {
+    return EFI_SUCCESS;
+  }
+
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    if (Cqe->Task[TaskId].Started) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  return SdMmcCqeDisable (Private, Slot, FALSE);
+}
+
+/**
+  Abort all the queued tasks of a slot.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] Status         The transaction status of the aborted tasks.
+
+**/
+VOID
+SdMmcCqeAbortTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              Status
+  )
+{
+  SD_MMC_CQE  *Cqe;
+  BOOLEAN     Started;
+  UINT8       TaskId;
+
+  Cqe = Private->Cqe[Slot];
+  if (Cqe == NULL) {
+    return;
+  }
+
+  Started = FALSE;
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    Started |= Cqe->Task[TaskId].Started;
+  }
+
+  SdMmcCqeDisable (Private, Slot, TRUE);
+
+  //
+  // The tasks under execution are queued in the device as well.
+  //
+  if (Started) {
+    SdMmcCqeDiscardQueue (Private, Slot);
+  }
+
+  for (TaskId = 0; TaskId < SD_MMC_CQE_MAX_TASKS; TaskId++) {
+    if (Cqe->Task[TaskId].Trb != NULL) {
+      SdMmcCqeCompleteTask (Cqe, TaskId, Status);
+    } else {
+      ZeroMem (&Cqe->Task[TaskId], sizeof (SD_MMC_CQE_TASK));
+    }
+  }
+}
@@ -161,9 +161,20 @@ ProcessAsyncTaskList (
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
   BOOLEAN                              InfiniteWait;
   EFI_EVENT                            TrbEvent;
+  UINT8                                Slot;
 
   Private = (SD_MMC_HC_PRIVATE_DATA *)Context;
 
+  //
+  // Complete the tasks finished by the Command Queueing Engines.
+  //
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    if (Private->Cqe[Slot] != NULL) {
+      SdMmcCqeCheckTimeout (Private, Slot);
+      SdMmcCqeProcessTasks (Private, Slot);
+    }
+  }
+
   //
   // Check if the first entry in the async I/O queue is done or not.
   //
@@ -178,6 +189,14 @@ ProcessAsyncTaskList (
     }
 
     if (!Trb->Started) {
+      //
+      // Regular commands wait for the queued tasks under execution.
+      //
+      Status = SdMmcCqeStop (Private, Trb->Slot);
+      if (EFI_ERROR (Status)) {
+        goto Done;
+      }
+
       //
       // Check whether the cmd/data line is ready for transfer.
       //
@@ -283,6 +302,7 @@ SdMmcPciHcEnumerateDevice (
           }
         }
 
+        SdMmcCqeAbortTasks (Private, Slot, EFI_NO_MEDIA);
         gBS->RestoreTPL (OldTpl);
         //
         // Notify the upper layer the connect state change through ReinstallProtocolInterface.
@@ -796,6 +816,13 @@ SdMmcPciHcDriverBindingStart (
     }
   }
 
+  //
+  // Set up the Command Queueing Engines of the eMMC slots
+  //
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    SdMmcCqeInitSlot (Private, Slot);
+  }
+
   //
   // Start the asynchronous I/O monitor
   //
@@ -873,6 +900,10 @@ Done:
     }
 
     if (Private != NULL) {
+      for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+        SdMmcCqeFreeSlot (Private, Slot);
+      }
+
       FreePool (Private);
     }
   }
@@ -922,6 +953,7 @@ SdMmcPciHcDriverBindingStop (
   LIST_ENTRY                     *Link;
   LIST_ENTRY                     *NextLink;
   SD_MMC_HC_TRB                  *Trb;
+  UINT8                          Slot;
 
   DEBUG ((DEBUG_INFO, "SdMmcPciHcDriverBindingStop: Start\n"));
 
@@ -967,6 +999,10 @@ SdMmcPciHcDriverBindingStop (
     SdMmcFreeTrb (Trb);
   }
 
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    SdMmcCqeFreeSlot (Private, Slot);
+  }
+
   //
   // Uninstall Block I/O protocol from the device handle
   //
@@ -1024,12 +1060,18 @@ SdMmcPassThruExecSyncTrb (
   EFI_TPL     OldTpl;
 
   //
-  // Wait async I/O list is empty before execute sync I/O operation.
+  // Wait async I/O list is empty and the queued tasks of the slot are done
+  // before execute sync I/O operation.
   //
   while (TRUE) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
-    if (IsListEmpty (&Private->Queue)) {
+    if (IsListEmpty (&Private->Queue) && SdMmcCqeIsIdle (Private, Trb->Slot)) {
+      Status = SdMmcCqeStop (Private, Trb->Slot);
       gBS->RestoreTPL (OldTpl);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
       break;
     }
 
@@ -1138,6 +1180,10 @@ SdMmcPassThruPassThru (
     return EFI_DEVICE_ERROR;
   }
 
+  if (SdMmcCqePassThru (Private, Slot, Packet, Event, &Status)) {
+    return Status;
+  }
+
   Trb = SdMmcCreateTrb (Private, Slot, Packet, Event);
   if (Trb == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -1454,6 +1500,7 @@ SdMmcPassThruResetDevice (
     SdMmcFreeTrb (Trb);
   }
 
+  SdMmcCqeAbortTasks (Private, Slot, EFI_ABORTED);
   gBS->RestoreTPL (OldTpl);
 
   return EFI_SUCCESS;
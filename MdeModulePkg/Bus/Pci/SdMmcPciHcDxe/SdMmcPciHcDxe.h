@@ -88,6 +88,8 @@ typedef struct {
   EDKII_SD_MMC_OPERATING_PARAMETERS    OperatingParameters;
 } SD_MMC_HC_SLOT;
 
+typedef struct _SD_MMC_CQE SD_MMC_CQE;
+
 typedef struct {
   UINTN                            Signature;
 
@@ -121,6 +123,11 @@ typedef struct {
   // value stored in Capabilities Register 1.
   //
   UINT32                           BaseClkFreq[SD_MMC_HC_MAX_SLOT];
+
+  //
+  // Command Queueing Engine of the eMMC slots, NULL when not available.
+  //
+  SD_MMC_CQE                       *Cqe[SD_MMC_HC_MAX_SLOT];
 } SD_MMC_HC_PRIVATE_DATA;
 
 typedef struct {
@@ -175,6 +182,38 @@ typedef struct {
 #define SD_MMC_HC_TRB_FROM_THIS(a) \
     CR(a, SD_MMC_HC_TRB, TrbList, SD_MMC_HC_TRB_SIG)
 
+//
+// eMMC queued task, gathered from the CMD44, CMD45 and CMD46/CMD47 packets
+// of the task.
+//
+typedef struct {
+  BOOLEAN          ParamsValid;
+  BOOLEAN          AddressValid;
+  UINT32           Params;
+  UINT32           Address;
+  //
+  // TRB of the CMD46/CMD47 packet, which maps the data and holds the ADMA2
+  // transfer descriptors. NULL until the task is executed.
+  //
+  SD_MMC_HC_TRB    *Trb;
+  BOOLEAN          Started;
+} SD_MMC_CQE_TASK;
+
+//
+// Command Queueing Engine of an eMMC slot.
+//
+struct _SD_MMC_CQE {
+  UINT32                  Base;
+  BOOLEAN                 Enabled;
+  BOOLEAN                 Dma64;
+  UINTN                   SlotSize;
+  UINT8                   LastTaskId;
+  VOID                    *Tdl;
+  EFI_PHYSICAL_ADDRESS    TdlPhy;
+  VOID                    *TdlMap;
+  SD_MMC_CQE_TASK         Task[SD_MMC_CQE_MAX_TASKS];
+};
+
 //
 // Task for Non-blocking mode.
 //
@@ -772,6 +811,156 @@ SdMmcWaitTrbResult (
   IN SD_MMC_HC_TRB           *Trb
   );
 
+/**
+  Performs SW reset based on passed error status mask.
+
+  @param[in]  Private       Pointer to driver private data.
+  @param[in]  Slot          Index of the slot to reset.
+  @param[in]  ErrIntStatus  Error interrupt status mask.
+
+  @retval EFI_SUCCESS  Software reset performed successfully.
+  @retval Other        Software reset failed.
+**/
+EFI_STATUS
+SdMmcSoftwareReset (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT16                  ErrIntStatus
+  );
+
+/**
+  Detect the Command Queueing Engine of an eMMC slot and allocate its Task
+  Descriptor List. The CQE is left disabled until a queued task is executed.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeInitSlot (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Abort the queued tasks of a slot and free its Command Queueing Engine.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeFreeSlot (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Handle the eMMC command queuing packets of a slot with a Command Queueing
+  Engine. CMD44 and CMD45 only record the task, CMD13 with the SQS bit reports
+  the recorded tasks as ready and CMD46/CMD47 hands the task over to the CQE.
+  Enabling command queuing in the device is rejected when the slot has no CQE.
+
+  @param[in]  Private       A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Slot          The slot number of the eMMC device.
+  @param[in]  Packet        A pointer to the SD command data structure.
+  @param[in]  Event         If Event is NULL, blocking I/O is performed. If Event is
+                            not NULL, then nonblocking I/O is performed, and Event
+                            will be signaled when the Packet completes.
+  @param[out] Status        The status of PassThru() when the packet is handled.
+
+  @retval TRUE              The packet is handled and Status is returned.
+  @retval FALSE             The packet must be executed as a regular command.
+
+**/
+BOOLEAN
+SdMmcCqePassThru (
+  IN     SD_MMC_HC_PRIVATE_DATA               *Private,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event,
+  OUT    EFI_STATUS                           *Status
+  );
+
+/**
+  Complete the finished tasks of a slot and start the pending ones.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeProcessTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Count down the timeout of the started tasks of a slot, once per tick of the
+  asynchronous I/O monitor, and recover the CQE from the expired ones.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeCheckTimeout (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Check whether a slot has no queued task waiting for or under execution.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval TRUE              No task is waiting for or under execution.
+  @retval FALSE             Some tasks are waiting for or under execution.
+
+**/
+BOOLEAN
+SdMmcCqeIsIdle (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Disable the Command Queueing Engine of a slot, so that a regular command can
+  be executed. Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The CQE is disabled or the slot has no CQE.
+  @retval EFI_NOT_READY     Some tasks are under execution.
+  @retval Others            The CQE can't be halted.
+
+**/
+EFI_STATUS
+SdMmcCqeStop (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Abort all the queued tasks of a slot.
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] Status         The transaction status of the aborted tasks.
+
+**/
+VOID
+SdMmcCqeAbortTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              Status
+  );
+
 /**
   Execute EMMC device identification procedure.
 
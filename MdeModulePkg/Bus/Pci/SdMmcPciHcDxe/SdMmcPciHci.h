@@ -205,6 +205,89 @@ typedef struct {
 #define SD_MMC_HC_64_ADDR_EN           BIT13
 #define SD_MMC_HC_26_DATA_LEN_ADMA_EN  BIT10
 
+//
+// Command Queueing Engine (CQE) register offsets, relative to the base of the
+// CQE register block in the slot BAR. Refer to the eMMC 5.1 spec Annex B.
+//
+#define SD_MMC_CQE_VER     0x00
+#define SD_MMC_CQE_CAP     0x04
+#define SD_MMC_CQE_CFG     0x08
+#define SD_MMC_CQE_CTL     0x0C
+#define SD_MMC_CQE_IS      0x10
+#define SD_MMC_CQE_ISTE    0x14
+#define SD_MMC_CQE_ISGE    0x18
+#define SD_MMC_CQE_IC      0x1C
+#define SD_MMC_CQE_TDLBA   0x20
+#define SD_MMC_CQE_TDLBAU  0x24
+#define SD_MMC_CQE_TDBR    0x28
+#define SD_MMC_CQE_TCN     0x2C
+#define SD_MMC_CQE_DQS     0x30
+#define SD_MMC_CQE_DPT     0x34
+#define SD_MMC_CQE_TCLR    0x38
+#define SD_MMC_CQE_SSC1    0x40
+#define SD_MMC_CQE_SSC2    0x44
+#define SD_MMC_CQE_CRDCT   0x48
+#define SD_MMC_CQE_RMEM    0x50
+#define SD_MMC_CQE_TERRI   0x54
+#define SD_MMC_CQE_CRI     0x58
+#define SD_MMC_CQE_CRA     0x5C
+
+//
+// CQE register bits
+//
+#define SD_MMC_CQE_CFG_ENABLE         BIT0
+#define SD_MMC_CQE_CFG_TASK_DESC_128  BIT8
+#define SD_MMC_CQE_CTL_HALT           BIT0
+#define SD_MMC_CQE_CTL_CLEAR_ALL      BIT8
+#define SD_MMC_CQE_IS_HAC             BIT0
+#define SD_MMC_CQE_IS_TCC             BIT1
+#define SD_MMC_CQE_IS_RED             BIT2
+#define SD_MMC_CQE_IS_TCL             BIT3
+#define SD_MMC_CQE_IS_GCE             BIT4
+#define SD_MMC_CQE_IS_ICCE            BIT5
+#define SD_MMC_CQE_IS_ERROR           (SD_MMC_CQE_IS_RED | SD_MMC_CQE_IS_GCE | SD_MMC_CQE_IS_ICCE)
+#define SD_MMC_CQE_TERRI_RESP_VALID   BIT15
+#define SD_MMC_CQE_TERRI_DATA_VALID   BIT31
+
+#define SD_MMC_CQE_MAX_TASKS  32
+
+//
+// Task descriptor of the CQE Task Descriptor List. The upper 64 bits of the
+// 128-bit descriptor used with 64b addressing are reserved.
+//
+typedef struct {
+  UINT32    Valid        : 1;  // bit 0
+  UINT32    End          : 1;  // bit 1
+  UINT32    Int          : 1;  // bit 2
+  UINT32    Act          : 3;  // bit 3:5
+  UINT32    Forced       : 1;  // bit 6
+  UINT32    ContextId    : 4;  // bit 7:10
+  UINT32    Tag          : 1;  // bit 11
+  UINT32    DataDir      : 1;  // bit 12
+  UINT32    Priority     : 1;  // bit 13
+  UINT32    Qbr          : 1;  // bit 14
+  UINT32    RelWrite     : 1;  // bit 15
+  UINT32    BlockCount   : 16; // bit 16:31
+  UINT32    BlockAddress;      // bit 32:63
+} SD_MMC_CQE_TASK_DESC;
+
+#define SD_MMC_CQE_ACT_TASK  0x5
+
+//
+// A slot of the Task Descriptor List: the task descriptor, followed by the
+// link descriptor pointing to the ADMA2 transfer descriptors of the task.
+//
+typedef struct {
+  SD_MMC_CQE_TASK_DESC           Task;
+  SD_MMC_HC_ADMA_32_DESC_LINE    Link;
+} SD_MMC_CQE_TDL_SLOT_32;
+
+typedef struct {
+  SD_MMC_CQE_TASK_DESC              Task;
+  UINT32                            Reserved[2];
+  SD_MMC_HC_ADMA_64_V4_DESC_LINE    Link;
+} SD_MMC_CQE_TDL_SLOT_64;
+
 /**
   Dump the content of SD/MMC host controller's Capability Register.
 
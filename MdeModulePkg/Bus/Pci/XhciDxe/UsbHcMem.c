@@ -54,6 +54,8 @@ UsbHcAllocMemBlock (
     return NULL;
   }
 
+  Block->FreeUnits = Block->BitsLen * 8;
+
   //
   // Allocate the number of Pages of memory, then map it for
   // bus master read and write.
@@ -158,12 +160,49 @@ UsbHcAllocMemFromBlock (
 
   ASSERT ((Block != 0) && (Units != 0));
 
+  if (Block->FreeUnits < Units) {
+    return NULL;
+  }
+
   StartByte     = 0;
   StartBit      = 0;
   Available     = 0;
   AlignmentMask = ~((UINTN)USBHC_MEM_TRB_RINGS_BOUNDARY - 1);
 
   for (Byte = 0, Bit = 0; Byte < Block->BitsLen;) {
+    //
+    // At a byte boundary, a fully allocated or a fully free byte of the
+    // bit array is handled at once instead of bit by bit.
+    //
+    if ((Bit == 0) && (Block->Bits[Byte] == 0xFF)) {
+      Byte++;
+
+      Available = 0;
+      StartByte = Byte;
+      StartBit  = 0;
+      continue;
+    }
+
+    if ((Bit == 0) && (Block->Bits[Byte] == 0) && (Units - Available >= 8)) {
+      if (AllocationForRing && (Available != 0)) {
+        MemUnitAddr = (UINTN)Block->BufHost + Byte * 8 * USBHC_MEM_UNIT;
+        if ((MemUnitAddr & AlignmentMask) != ((MemUnitAddr - USBHC_MEM_UNIT) & AlignmentMask)) {
+          Available = 0;
+          StartByte = Byte;
+          StartBit  = 0;
+        }
+      }
+
+      Available += 8;
+      Byte++;
+
+      if (Available >= Units) {
+        break;
+      }
+
+      continue;
+    }
+
     //
     // If current bit is zero, the corresponding memory unit is
     // available, otherwise we need to restart our searching.
@@ -210,13 +249,24 @@ UsbHcAllocMemFromBlock (
   Byte = StartByte;
   Bit  = StartBit;
 
-  for (Count = 0; Count < Units; Count++) {
-    ASSERT (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
+  for (Count = 0; Count < Units;) {
+    if ((Bit == 0) && (Units - Count >= 8)) {
+      ASSERT (Block->Bits[Byte] == 0);
+
+      Block->Bits[Byte] = 0xFF;
+      Byte++;
+      Count += 8;
+    } else {
+      ASSERT (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
 
-    Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] | USB_HC_BIT (Bit));
-    NEXT_BIT (Byte, Bit);
+      Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] | USB_HC_BIT (Bit));
+      NEXT_BIT (Byte, Bit);
+      Count++;
+    }
   }
 
+  Block->FreeUnits -= Units;
+
   return Block->BufHost + (StartByte * 8 + StartBit) * USBHC_MEM_UNIT;
 }
 
@@ -350,15 +400,7 @@ UsbHcIsMemBlockEmpty (
   IN USBHC_MEM_BLOCK  *Block
   )
 {
-  UINTN  Index;
-
-  for (Index = 0; Index < Block->BitsLen; Index++) {
-    if (Block->Bits[Index] != 0) {
-      return FALSE;
-    }
-  }
-
-  return TRUE;
+  return (BOOLEAN)(Block->FreeUnits == Block->BitsLen * 8);
 }
 
 /**
@@ -573,13 +615,24 @@ UsbHcFreeMem (
       //
       // reset associated bits in bit array
       //
-      for (Count = 0; Count < (AllocSize / USBHC_MEM_UNIT); Count++) {
-        ASSERT (USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
-
-        Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] ^ USB_HC_BIT (Bit));
-        NEXT_BIT (Byte, Bit);
+      for (Count = 0; Count < (AllocSize / USBHC_MEM_UNIT);) {
+        if ((Bit == 0) && ((AllocSize / USBHC_MEM_UNIT) - Count >= 8)) {
+          ASSERT (Block->Bits[Byte] == 0xFF);
+
+          Block->Bits[Byte] = 0;
+          Byte++;
+          Count += 8;
+        } else {
+          ASSERT (USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
+
+          Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] ^ USB_HC_BIT (Bit));
+          NEXT_BIT (Byte, Bit);
+          Count++;
+        }
       }
 
+      Block->FreeUnits += AllocSize / USBHC_MEM_UNIT;
+
       break;
     }
   }
@@ -19,6 +19,7 @@ typedef struct _USBHC_MEM_BLOCK USBHC_MEM_BLOCK;
 struct _USBHC_MEM_BLOCK {
   UINT8              *Bits;         // Bit array to record which unit is allocated
   UINTN              BitsLen;
+  UINTN              FreeUnits;     // Number of units not allocated
   UINT8              *Buf;
   UINT8              *BufHost;
   UINTN              BufLen;        // Memory size in bytes
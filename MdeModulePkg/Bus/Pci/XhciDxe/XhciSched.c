@@ -227,6 +227,7 @@ XhcCreateTransferTrb (
   TRB                            *TrbStart;
   UINTN                          TotalLen;
   UINTN                          Len;
+  UINTN                          Remaining;
   UINTN                          TrbNum;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
@@ -385,6 +386,12 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
+      //
+      // Queue the whole buffer as a single TD of chained Normal TRBs, so
+      // that it is started by one doorbell ring and completed by a single
+      // event: the one of the last TRB, or the one of the TRB a short
+      // packet ends the TD at.
+      //
       TotalLen = 0;
       Len      = 0;
       TrbNum   = 0;
@@ -396,14 +403,17 @@ XhcCreateTransferTrb (
           Len = 0x10000;
         }
 
+        Remaining = Urb->DataLen - TotalLen - Len;
+
         TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
         TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
         TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
         TrbStart->TrbNormal.Length    = (UINT32)Len;
-        TrbStart->TrbNormal.TDSize    = 0;
+        TrbStart->TrbNormal.TDSize    = (UINT32)MIN ((Remaining + Urb->Ep.MaxPacket - 1) / Urb->Ep.MaxPacket, 31);
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
+        TrbStart->TrbNormal.CH        = (Remaining != 0) ? 1 : 0;
+        TrbStart->TrbNormal.IOC       = (Remaining != 0) ? 0 : 1;
         TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
         //
         // Update the cycle bit
@@ -808,6 +818,7 @@ CreateEventRing (
   EventRing->TrbNumber        = EVENT_RING_TRB_NUMBER;
   EventRing->EventRingDequeue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
   EventRing->EventRingEnqueue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
+  EventRing->EventRingErdp    = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
 
   DequeuePhy = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Buf, Size);
 
@@ -1104,14 +1115,13 @@ XhcCheckUrbResult (
 {
   EVT_TRB_TRANSFER      *EvtTrb;
   TRB_TEMPLATE          *TRBPtr;
+  TRANSFER_TRB_NORMAL   *NormalTrb;
   UINTN                 Index;
   UINT8                 TRBType;
   EFI_STATUS            Status;
   URB                   *AsyncUrb;
   URB                   *CheckedUrb;
-  UINT64                XhcDequeue;
-  UINT32                High;
-  UINT32                Low;
+  UINT64                TrbPhyAddr;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
@@ -1214,9 +1224,21 @@ XhcCheckUrbResult (
         }
 
         TRBType = (UINT8)(TRBPtr->Type);
-        if ((TRBType == TRB_TYPE_DATA_STAGE) ||
-            (TRBType == TRB_TYPE_NORMAL) ||
-            (TRBType == TRB_TYPE_ISOCH))
+        if ((CheckedUrb->Ep.Type == XHC_BULK_TRANSFER) && (TRBType == TRB_TYPE_NORMAL)) {
+          //
+          // The bulk TRBs form a single TD which reports one event only. All
+          // the TRBs before the reported one are transferred in full.
+          //
+          NormalTrb             = (TRANSFER_TRB_NORMAL *)TRBPtr;
+          TrbPhyAddr            = NormalTrb->TRBPtrLo | LShiftU64 ((UINT64)NormalTrb->TRBPtrHi, 32);
+          CheckedUrb->Completed = (UINTN)(TrbPhyAddr - (UINTN)CheckedUrb->DataPhy) + NormalTrb->Length - EvtTrb->Length;
+          if (EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) {
+            CheckedUrb->StartDone = TRUE;
+            CheckedUrb->EndDone   = TRUE;
+          }
+        } else if ((TRBType == TRB_TYPE_DATA_STAGE) ||
+                   (TRBType == TRB_TYPE_NORMAL) ||
+                   (TRBType == TRB_TYPE_ISOCH))
         {
           CheckedUrb->Completed += (((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length);
         }
@@ -1239,6 +1261,9 @@ XhcCheckUrbResult (
 
     if (TRBPtr == CheckedUrb->TrbEnd) {
       CheckedUrb->EndDone = TRUE;
+      if (CheckedUrb->Ep.Type == XHC_BULK_TRANSFER) {
+        CheckedUrb->StartDone = TRUE;
+      }
     }
 
     if (CheckedUrb->StartDone && CheckedUrb->EndDone) {
@@ -1250,24 +1275,20 @@ XhcCheckUrbResult (
 EXIT:
 
   //
-  // Advance event ring to last available entry
-  //
-  // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
-  // So divide it to two 32-bytes width register access.
+  // Advance event ring to last available entry. The dequeue pointer last
+  // programmed is tracked, so that the polls which find no new event
+  // don't access the register.
   //
-  Low        = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET);
-  High       = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4);
-  XhcDequeue = (UINT64)(LShiftU64 ((UINT64)High, 32) | Low);
-
-  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
+  if (Xhc->EventRing.EventRingDequeue != Xhc->EventRing.EventRingErdp) {
+    PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
 
-  if ((XhcDequeue & (~0x0F)) != (PhyAddr & (~0x0F))) {
     //
     // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
     // So divide it to two 32-bytes width register access.
     //
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET, XHC_LOW_32BIT (PhyAddr) | BIT3);
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4, XHC_HIGH_32BIT (PhyAddr));
+    Xhc->EventRing.EventRingErdp = Xhc->EventRing.EventRingDequeue;
   }
 
   return Urb->Finished;
@@ -1635,14 +1656,27 @@ XhcMonitorAsyncRequests (
   UINT8              SlotId;
   EFI_STATUS         Status;
   EFI_TPL            OldTpl;
+  BOOLEAN            NewEvent;
 
   OldTpl = gBS->RaiseTPL (XHC_TPL);
 
   Xhc = (USB_XHCI_INSTANCE *)Context;
 
+  //
+  // Most of the periodic checks find no new event. Look at the event ring
+  // in memory first, and only check the URBs completed by an earlier poll
+  // in that case.
+  //
+  NewEvent = (BOOLEAN)((Xhc->EventRing.EventRingDequeue != Xhc->EventRing.EventRingEnqueue) ||
+                       (Xhc->EventRing.EventRingEnqueue->CycleBit == Xhc->EventRing.EventRingCCS));
+
   BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncIntTransfers) {
     Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
 
+    if (!NewEvent && !Urb->Finished) {
+      continue;
+    }
+
     //
     // Make sure that the device is available before every check.
     //
@@ -1656,6 +1690,7 @@ XhcMonitorAsyncRequests (
     // active, check the next one.
     //
     XhcCheckUrbResult (Xhc, Urb);
+    NewEvent = (BOOLEAN)(Xhc->EventRing.EventRingDequeue != Xhc->EventRing.EventRingEnqueue);
 
     if (!Urb->Finished) {
       continue;
@@ -2002,6 +2037,10 @@ XhcSyncTrsRing (
     if ((UINT8)TrsTrb->Type == TRB_TYPE_LINK) {
       ASSERT (((LINK_TRB *)TrsTrb)->TC != 0);
       //
+      // The Link TRB is part of the TD if the TRB before it is chained.
+      //
+      ((LINK_TRB *)TrsTrb)->CH = ((TRANSFER_TRB_NORMAL *)(TrsTrb - 1))->CH;
+      //
       // set cycle bit in Link TRB as normal
       //
       ((LINK_TRB *)TrsTrb)->CycleBit = TrsRing->RingPCS & BIT0;
@@ -152,6 +152,10 @@ typedef struct _EVENT_RING {
   UINTN           TrbNumber;
   TRB_TEMPLATE    *EventRingEnqueue;
   TRB_TEMPLATE    *EventRingDequeue;
+  //
+  // The dequeue pointer last written to the ERDP register
+  //
+  TRB_TEMPLATE    *EventRingErdp;
   UINT32          EventRingCCS;
 } EVENT_RING;
 
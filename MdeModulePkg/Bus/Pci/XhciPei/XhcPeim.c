@@ -146,6 +146,42 @@ XhcPeiClearOpRegBit (
   XhcPeiWriteOpReg (Xhc, Offset, Data);
 }
 
+//
+// The operational register bit XhcPeiWaitOpRegBit() waits for.
+//
+typedef struct {
+  PEI_XHC_DEV    *Xhc;
+  UINT32         Offset;
+  UINT32         Bit;
+  BOOLEAN        WaitToSet;
+} XHC_PEI_WAIT_OP_REG_BIT_CONTEXT;
+
+/**
+  Check if the operation register's bit as specified by Context
+  is set (or clear).
+
+  @param  Context       The pointer to the XHC_PEI_WAIT_OP_REG_BIT_CONTEXT data structure.
+
+  @retval EFI_SUCCESS   The bit has the expected value.
+  @retval EFI_NOT_READY The bit does not have the expected value yet.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcPeiCheckOpRegBit (
+  IN VOID  *Context
+  )
+{
+  XHC_PEI_WAIT_OP_REG_BIT_CONTEXT  *WaitContext;
+
+  WaitContext = (XHC_PEI_WAIT_OP_REG_BIT_CONTEXT *)Context;
+  if (XHC_REG_BIT_IS_SET (WaitContext->Xhc, WaitContext->Offset, WaitContext->Bit) == WaitContext->WaitToSet) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_READY;
+}
+
 /**
   Wait the operation register's bit as specified by Bit
   to become set (or clear).
@@ -169,17 +205,20 @@ XhcPeiWaitOpRegBit (
   IN UINT32       Timeout
   )
 {
-  UINT64  Index;
-
-  for (Index = 0; Index < Timeout * XHC_1_MILLISECOND; Index++) {
-    if (XHC_REG_BIT_IS_SET (Xhc, Offset, Bit) == WaitToSet) {
-      return EFI_SUCCESS;
-    }
-
-    MicroSecondDelay (XHC_1_MICROSECOND);
-  }
-
-  return EFI_TIMEOUT;
+  XHC_PEI_WAIT_OP_REG_BIT_CONTEXT  WaitContext;
+
+  WaitContext.Xhc       = Xhc;
+  WaitContext.Offset    = Offset;
+  WaitContext.Bit       = Bit;
+  WaitContext.WaitToSet = WaitToSet;
+
+  return PollLibWaitUntil (
+           "XhcPeiWaitOpRegBit",
+           XhcPeiCheckOpRegBit,
+           &WaitContext,
+           MultU64x32 (Timeout, XHC_1_MILLISECOND),
+           XHC_POLL_MAX_INTERVAL
+           );
 }
 
 /**
@@ -24,6 +24,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/TimerLib.h>
 #include <Library/IoLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PollLib.h>
 
 typedef struct _PEI_XHC_DEV      PEI_XHC_DEV;
 typedef struct _USB_DEV_CONTEXT  USB_DEV_CONTEXT;
@@ -41,6 +42,11 @@ typedef struct _USB_DEV_CONTEXT  USB_DEV_CONTEXT;
 #define XHC_1_MILLISECOND  (1000 * XHC_1_MICROSECOND)
 #define XHC_1_SECOND       (1000 * XHC_1_MILLISECOND)
 
+//
+// The maximum interval between two reads of a register that is waited for.
+//
+#define XHC_POLL_MAX_INTERVAL  (100 * XHC_1_MICROSECOND)
+
 //
 // XHC reset timeout experience values.
 // The unit is millisecond, setting it as 1s.
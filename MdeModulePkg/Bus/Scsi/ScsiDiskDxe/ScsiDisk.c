@@ -278,6 +278,7 @@ ScsiDiskDriverBindingStart (
   ScsiDiskDevice->BlockLimitsVpdSupported           = FALSE;
   ScsiDiskDevice->Handle                            = Controller;
   InitializeListHead (&ScsiDiskDevice->AsyncTaskQueue);
+  InitializeListHead (&ScsiDiskDevice->PendingRWQueue);
 
   ScsiIo->GetDeviceType (ScsiIo, &(ScsiDiskDevice->DeviceType));
   switch (ScsiDiskDevice->DeviceType) {
@@ -2670,6 +2671,14 @@ ScsiDiskInquiryDevice (
               (BlockLimits->OptimalTransferLengthGranularity2 << 8) |
               BlockLimits->OptimalTransferLengthGranularity1;
 
+            ScsiDiskLimitTransferBlocks (
+              ScsiDiskDevice,
+              (BlockLimits->MaximumTransferLength4 << 24) |
+              (BlockLimits->MaximumTransferLength3 << 16) |
+              (BlockLimits->MaximumTransferLength2 << 8)  |
+              BlockLimits->MaximumTransferLength1
+              );
+
             ScsiDiskDevice->UnmapInfo.MaxLbaCnt =
               (BlockLimits->MaximumUnmapLbaCount4 << 24) |
               (BlockLimits->MaximumUnmapLbaCount3 << 16) |
@@ -3476,11 +3485,7 @@ ScsiDiskReadSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3576,6 +3581,7 @@ ScsiDiskReadSectors (
       NextSectorCount = ByteCount / BlockSize;
       if (NextSectorCount < SectorCount) {
         SectorCount = NextSectorCount;
+        ScsiDiskLimitTransferBlocks (ScsiDiskDevice, SectorCount);
         //
         // Account for any rounding down.
         //
@@ -3641,11 +3647,7 @@ ScsiDiskWriteSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3740,6 +3742,7 @@ ScsiDiskWriteSectors (
       NextSectorCount = ByteCount / BlockSize;
       if (NextSectorCount < SectorCount) {
         SectorCount = NextSectorCount;
+        ScsiDiskLimitTransferBlocks (ScsiDiskDevice, SectorCount);
         //
         // Account for any rounding down.
         //
@@ -3825,11 +3828,7 @@ ScsiDiskAsyncReadSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3916,6 +3915,7 @@ ScsiDiskAsyncReadSectors (
       if ((Status == EFI_DEVICE_ERROR) || (Status == EFI_TIMEOUT)) {
         if ((MaxBlock > 1) && (SectorCount > 1)) {
           MaxBlock = MIN (MaxBlock, SectorCount) >> 1;
+          ScsiDiskLimitTransferBlocks (ScsiDiskDevice, MaxBlock);
           continue;
         }
       }
@@ -4043,11 +4043,7 @@ ScsiDiskAsyncWriteSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -4134,6 +4130,7 @@ ScsiDiskAsyncWriteSectors (
       if ((Status == EFI_DEVICE_ERROR) || (Status == EFI_TIMEOUT)) {
         if ((MaxBlock > 1) && (SectorCount > 1)) {
           MaxBlock = MIN (MaxBlock, SectorCount) >> 1;
+          ScsiDiskLimitTransferBlocks (ScsiDiskDevice, MaxBlock);
           continue;
         }
       }
@@ -4725,9 +4722,24 @@ ScsiDiskNotify (
   Request        = (SCSI_ASYNC_RW_REQUEST *)Context;
   ScsiDiskDevice = Request->ScsiDiskDevice;
   Token          = Request->BlkIo2Req->Token;
+  MaxRetry       = 2;
+
+  //
+  // A coalesced command carrying the sub-tasks following this one completes
+  // them too if it fully succeeds. Otherwise they are sent again on their own
+  // and only this sub-task goes through the error handling below.
+  //
+  if (!IsListEmpty (&Request->MergedQueue)) {
+    ScsiDiskAsyncSplitRW (
+      Request,
+      (BOOLEAN)((Request->HostAdapterStatus == EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OK) &&
+                (Request->TargetStatus == EFI_EXT_SCSI_STATUS_TARGET_GOOD) &&
+                (Request->DataLength == Request->SectorCount * ScsiDiskDevice->BlkIo.Media->BlockSize))
+      );
+  }
+
   OldDataLength  = Request->DataLength;
   OldSectorCount = Request->SectorCount;
-  MaxRetry       = 2;
 
   //
   // If previous sub-tasks already fails, no need to process this sub-task.
@@ -4807,6 +4819,7 @@ ScsiDiskNotify (
       Request->SectorCount >>= 1;
       Request->DataLength    = Request->SectorCount * ScsiDiskDevice->BlkIo.Media->BlockSize;
       Request->TimesRetry    = 0;
+      ScsiDiskLimitTransferBlocks (ScsiDiskDevice, Request->SectorCount);
 
       goto Retry;
     } else {
@@ -4962,22 +4975,367 @@ Retry:
   }
 
 Exit:
+  ScsiDiskDevice->OutstandingRWCount--;
+  ScsiDiskAsyncCompleteRW (Request);
+
+  //
+  // Send the sub-tasks waiting for a free slot on the device
+  //
+  ScsiDiskAsyncSendPendingRW (ScsiDiskDevice);
+}
+
+/**
+  Complete a SCSI Read/Write sub-task, and signal the event of its BlockIo2
+  request if it is the last sub-task of the request.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+**/
+VOID
+ScsiDiskAsyncCompleteRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  )
+{
+  SCSI_BLKIO2_REQUEST  *BlkIo2Req;
+
+  BlkIo2Req = Request->BlkIo2Req;
+
   RemoveEntryList (&Request->Link);
-  if ((IsListEmpty (&Request->BlkIo2Req->ScsiRWQueue)) &&
-      (Request->BlkIo2Req->LastScsiRW))
+  if ((IsListEmpty (&BlkIo2Req->ScsiRWQueue)) &&
+      (BlkIo2Req->LastScsiRW))
   {
     //
     // The last SCSI R/W command of a BlockIo2 request completes
     //
-    RemoveEntryList (&Request->BlkIo2Req->Link);
-    FreePool (Request->BlkIo2Req);  // Should be freed only once
-    gBS->SignalEvent (Token->Event);
+    RemoveEntryList (&BlkIo2Req->Link);
+    gBS->SignalEvent (BlkIo2Req->Token->Event);
+    FreePool (BlkIo2Req);  // Should be freed only once
   }
 
   FreePool (Request->SenseData);
   FreePool (Request);
 }
 
+/**
+  Split a coalesced SCSI Read/Write command back into its sub-tasks.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  Request    The sub-task which carried the coalesced command.
+  @param  Completed  TRUE if the command transferred all its data, then the
+                     coalesced sub-tasks are completed. Otherwise they are
+                     put back to the head of the pending queue.
+
+**/
+VOID
+ScsiDiskAsyncSplitRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request,
+  IN  BOOLEAN                Completed
+  )
+{
+  SCSI_DISK_DEV          *ScsiDiskDevice;
+  LIST_ENTRY             *Entry;
+  SCSI_ASYNC_RW_REQUEST  *Merged;
+
+  ScsiDiskDevice = Request->ScsiDiskDevice;
+
+  Request->SectorCount      -= Request->MergedSectorCount;
+  Request->DataLength        = Request->SectorCount * ScsiDiskDevice->BlkIo.Media->BlockSize;
+  Request->MergedSectorCount = 0;
+
+  while (!IsListEmpty (&Request->MergedQueue)) {
+    if (Completed) {
+      Entry  = GetFirstNode (&Request->MergedQueue);
+      Merged = BASE_CR (Entry, SCSI_ASYNC_RW_REQUEST, PendingLink);
+      RemoveEntryList (Entry);
+      ScsiDiskAsyncCompleteRW (Merged);
+    } else {
+      //
+      // Walk backwards so that the sub-tasks keep their order in the queue.
+      //
+      Entry = GetPreviousNode (&Request->MergedQueue, &Request->MergedQueue);
+      RemoveEntryList (Entry);
+      InsertHeadList (&ScsiDiskDevice->PendingRWQueue, Entry);
+    }
+  }
+}
+
+/**
+  Send a SCSI Read/Write sub-task to the device.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+  @return Status returned by calling ScsiRead10CommandEx(), ScsiRead16CommandEx(),
+          ScsiWrite10CommandEx() or ScsiWrite16CommandEx().
+
+**/
+EFI_STATUS
+ScsiDiskAsyncSendRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  )
+{
+  EFI_STATUS     Status;
+  SCSI_DISK_DEV  *ScsiDiskDevice;
+  EFI_EVENT      AsyncIoEvent;
+  UINT64         Timeout;
+
+  ScsiDiskDevice = Request->ScsiDiskDevice;
+
+  //
+  // A coalesced command gets the timeout for its whole transfer length, see
+  // ScsiDiskAsyncReadSectors().
+  //
+  Timeout = Request->Timeout;
+  if (Request->MergedSectorCount != 0) {
+    Timeout = MAX (Timeout, EFI_TIMER_PERIOD_SECONDS (Request->DataLength / 2100000 + 31));
+  }
+
+  //
+  // Create Event
+  //
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  ScsiDiskNotify,
+                  Request,
+                  &AsyncIoEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Request->InBuffer != NULL) {
+    if (!ScsiDiskDevice->Cdb16Byte) {
+      Status = ScsiRead10CommandEx (
+                 ScsiDiskDevice->ScsiIo,
+                 Timeout,
+                 Request->SenseData,
+                 &Request->SenseDataLength,
+                 &Request->HostAdapterStatus,
+                 &Request->TargetStatus,
+                 Request->InBuffer,
+                 &Request->DataLength,
+                 (UINT32)Request->StartLba,
+                 Request->SectorCount,
+                 AsyncIoEvent
+                 );
+    } else {
+      Status = ScsiRead16CommandEx (
+                 ScsiDiskDevice->ScsiIo,
+                 Timeout,
+                 Request->SenseData,
+                 &Request->SenseDataLength,
+                 &Request->HostAdapterStatus,
+                 &Request->TargetStatus,
+                 Request->InBuffer,
+                 &Request->DataLength,
+                 Request->StartLba,
+                 Request->SectorCount,
+                 AsyncIoEvent
+                 );
+    }
+  } else {
+    if (!ScsiDiskDevice->Cdb16Byte) {
+      Status = ScsiWrite10CommandEx (
+                 ScsiDiskDevice->ScsiIo,
+                 Timeout,
+                 Request->SenseData,
+                 &Request->SenseDataLength,
+                 &Request->HostAdapterStatus,
+                 &Request->TargetStatus,
+                 Request->OutBuffer,
+                 &Request->DataLength,
+                 (UINT32)Request->StartLba,
+                 Request->SectorCount,
+                 AsyncIoEvent
+                 );
+    } else {
+      Status = ScsiWrite16CommandEx (
+                 ScsiDiskDevice->ScsiIo,
+                 Timeout,
+                 Request->SenseData,
+                 &Request->SenseDataLength,
+                 &Request->HostAdapterStatus,
+                 &Request->TargetStatus,
+                 Request->OutBuffer,
+                 &Request->DataLength,
+                 Request->StartLba,
+                 Request->SectorCount,
+                 AsyncIoEvent
+                 );
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (AsyncIoEvent);
+  }
+
+  return Status;
+}
+
+/**
+  Send a SCSI Read/Write sub-task to the device, or queue it if the device
+  already has SCSI_DISK_MAX_OUTSTANDING_RW commands outstanding.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+  @retval EFI_SUCCESS  The sub-task is sent or queued.
+  @return others       Status returned by calling ScsiDiskAsyncSendRW().
+
+**/
+EFI_STATUS
+ScsiDiskAsyncQueueRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  )
+{
+  EFI_STATUS     Status;
+  SCSI_DISK_DEV  *ScsiDiskDevice;
+  EFI_TPL        OldTpl;
+
+  ScsiDiskDevice = Request->ScsiDiskDevice;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if ((ScsiDiskDevice->OutstandingRWCount >= SCSI_DISK_MAX_OUTSTANDING_RW) ||
+      !IsListEmpty (&ScsiDiskDevice->PendingRWQueue))
+  {
+    InsertTailList (&ScsiDiskDevice->PendingRWQueue, &Request->PendingLink);
+    gBS->RestoreTPL (OldTpl);
+    return EFI_SUCCESS;
+  }
+
+  ScsiDiskDevice->OutstandingRWCount++;
+  gBS->RestoreTPL (OldTpl);
+
+  Status = ScsiDiskAsyncSendRW (Request);
+  if (EFI_ERROR (Status)) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ScsiDiskDevice->OutstandingRWCount--;
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  return Status;
+}
+
+/**
+  Send the queued SCSI Read/Write sub-tasks while the device has free slots.
+
+  Queued sub-tasks which continue each other both on the device and in memory
+  are coalesced into one command, up to the maximum transfer length of the
+  device.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+
+**/
+VOID
+ScsiDiskAsyncSendPendingRW (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice
+  )
+{
+  EFI_STATUS             Status;
+  SCSI_ASYNC_RW_REQUEST  *Request;
+  SCSI_ASYNC_RW_REQUEST  *Next;
+  UINT32                 MaxBlock;
+  UINT8                  *RequestBuffer;
+  UINT8                  *NextBuffer;
+
+  MaxBlock = ScsiDiskGetMaxTransferBlocks (ScsiDiskDevice);
+
+  while ((ScsiDiskDevice->OutstandingRWCount < SCSI_DISK_MAX_OUTSTANDING_RW) &&
+         !IsListEmpty (&ScsiDiskDevice->PendingRWQueue))
+  {
+    Request = BASE_CR (GetFirstNode (&ScsiDiskDevice->PendingRWQueue), SCSI_ASYNC_RW_REQUEST, PendingLink);
+    RemoveEntryList (&Request->PendingLink);
+
+    //
+    // Retried sub-tasks may have been shortened on purpose, so they are never
+    // coalesced.
+    //
+    while ((Request->TimesRetry == 0) && !IsListEmpty (&ScsiDiskDevice->PendingRWQueue)) {
+      Next          = BASE_CR (GetFirstNode (&ScsiDiskDevice->PendingRWQueue), SCSI_ASYNC_RW_REQUEST, PendingLink);
+      RequestBuffer = (Request->InBuffer != NULL) ? Request->InBuffer : Request->OutBuffer;
+      NextBuffer    = (Next->InBuffer != NULL) ? Next->InBuffer : Next->OutBuffer;
+      if ((Next->TimesRetry != 0) ||
+          ((Request->InBuffer == NULL) != (Next->InBuffer == NULL)) ||
+          (Request->StartLba + Request->SectorCount != Next->StartLba) ||
+          (RequestBuffer + Request->DataLength != NextBuffer) ||
+          ((UINT64)Request->SectorCount + Next->SectorCount > MaxBlock) ||
+          ((UINT64)Request->DataLength + Next->DataLength > MAX_UINT32))
+      {
+        break;
+      }
+
+      RemoveEntryList (&Next->PendingLink);
+      InsertTailList (&Request->MergedQueue, &Next->PendingLink);
+      Request->SectorCount       += Next->SectorCount;
+      Request->DataLength        += Next->DataLength;
+      Request->MergedSectorCount += Next->SectorCount;
+    }
+
+    ScsiDiskDevice->OutstandingRWCount++;
+    Status = ScsiDiskAsyncSendRW (Request);
+    if (EFI_ERROR (Status)) {
+      ScsiDiskDevice->OutstandingRWCount--;
+      ScsiDiskAsyncSplitRW (Request, FALSE);
+      Request->BlkIo2Req->Token->TransactionStatus = EFI_DEVICE_ERROR;
+      ScsiDiskAsyncCompleteRW (Request);
+    }
+  }
+}
+
+/**
+  Get the maximum number of blocks one Read/Write command may transfer.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+
+  @return The maximum number of blocks.
+
+**/
+UINT32
+ScsiDiskGetMaxTransferBlocks (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice
+  )
+{
+  UINT32  MaxBlock;
+
+  if (!ScsiDiskDevice->Cdb16Byte) {
+    MaxBlock = 0xFFFF;
+  } else {
+    MaxBlock = 0xFFFFFFFF;
+  }
+
+  if (ScsiDiskDevice->MaxTransferBlocks != 0) {
+    MaxBlock = MIN (MaxBlock, ScsiDiskDevice->MaxTransferBlocks);
+  }
+
+  return MaxBlock;
+}
+
+/**
+  Lower the maximum number of blocks one Read/Write command may transfer, so
+  that later requests are split to a length the device accepts.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+  @param  Blocks             The number of blocks. 0 is ignored.
+
+**/
+VOID
+ScsiDiskLimitTransferBlocks (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice,
+  IN  UINT32         Blocks
+  )
+{
+  if ((Blocks != 0) &&
+      ((ScsiDiskDevice->MaxTransferBlocks == 0) || (Blocks < ScsiDiskDevice->MaxTransferBlocks)))
+  {
+    DEBUG ((DEBUG_INFO, "ScsiDisk: Limit transfer length to %d blocks\n", Blocks));
+    ScsiDiskDevice->MaxTransferBlocks = Blocks;
+  }
+}
+
 /**
   Submit Async Read(10) command.
 
@@ -5013,11 +5371,8 @@ ScsiDiskAsyncRead10 (
 {
   EFI_STATUS             Status;
   SCSI_ASYNC_RW_REQUEST  *Request;
-  EFI_EVENT              AsyncIoEvent;
   EFI_TPL                OldTpl;
 
-  AsyncIoEvent = NULL;
-
   Request = AllocateZeroPool (sizeof (SCSI_ASYNC_RW_REQUEST));
   if (Request == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -5042,34 +5397,9 @@ ScsiDiskAsyncRead10 (
   Request->StartLba       = StartLba;
   Request->SectorCount    = SectorCount;
   Request->BlkIo2Req      = BlkIo2Req;
+  InitializeListHead (&Request->MergedQueue);
 
-  //
-  // Create Event
-  //
-  Status = gBS->CreateEvent (
-                  EVT_NOTIFY_SIGNAL,
-                  TPL_NOTIFY,
-                  ScsiDiskNotify,
-                  Request,
-                  &AsyncIoEvent
-                  );
-  if (EFI_ERROR (Status)) {
-    goto ErrorExit;
-  }
-
-  Status = ScsiRead10CommandEx (
-             ScsiDiskDevice->ScsiIo,
-             Request->Timeout,
-             Request->SenseData,
-             &Request->SenseDataLength,
-             &Request->HostAdapterStatus,
-             &Request->TargetStatus,
-             Request->InBuffer,
-             &Request->DataLength,
-             (UINT32)Request->StartLba,
-             Request->SectorCount,
-             AsyncIoEvent
-             );
+  Status = ScsiDiskAsyncQueueRW (Request);
   if (EFI_ERROR (Status)) {
     goto ErrorExit;
   }
@@ -5077,10 +5407,6 @@ ScsiDiskAsyncRead10 (
   return EFI_SUCCESS;
 
 ErrorExit:
-  if (AsyncIoEvent != NULL) {
-    gBS->CloseEvent (AsyncIoEvent);
-  }
-
   if (Request != NULL) {
     if (Request->SenseData != NULL) {
       FreePool (Request->SenseData);
@@ -5131,11 +5457,8 @@ ScsiDiskAsyncWrite10 (
 {
   EFI_STATUS             Status;
   SCSI_ASYNC_RW_REQUEST  *Request;
-  EFI_EVENT              AsyncIoEvent;
   EFI_TPL                OldTpl;
 
-  AsyncIoEvent = NULL;
-
   Request = AllocateZeroPool (sizeof (SCSI_ASYNC_RW_REQUEST));
   if (Request == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -5160,34 +5483,9 @@ ScsiDiskAsyncWrite10 (
   Request->StartLba       = StartLba;
   Request->SectorCount    = SectorCount;
   Request->BlkIo2Req      = BlkIo2Req;
+  InitializeListHead (&Request->MergedQueue);
 
-  //
-  // Create Event
-  //
-  Status = gBS->CreateEvent (
-                  EVT_NOTIFY_SIGNAL,
-                  TPL_NOTIFY,
-                  ScsiDiskNotify,
-                  Request,
-                  &AsyncIoEvent
-                  );
-  if (EFI_ERROR (Status)) {
-    goto ErrorExit;
-  }
-
-  Status = ScsiWrite10CommandEx (
-             ScsiDiskDevice->ScsiIo,
-             Request->Timeout,
-             Request->SenseData,
-             &Request->SenseDataLength,
-             &Request->HostAdapterStatus,
-             &Request->TargetStatus,
-             Request->OutBuffer,
-             &Request->DataLength,
-             (UINT32)Request->StartLba,
-             Request->SectorCount,
-             AsyncIoEvent
-             );
+  Status = ScsiDiskAsyncQueueRW (Request);
   if (EFI_ERROR (Status)) {
     goto ErrorExit;
   }
@@ -5195,10 +5493,6 @@ ScsiDiskAsyncWrite10 (
   return EFI_SUCCESS;
 
 ErrorExit:
-  if (AsyncIoEvent != NULL) {
-    gBS->CloseEvent (AsyncIoEvent);
-  }
-
   if (Request != NULL) {
     if (Request->SenseData != NULL) {
       FreePool (Request->SenseData);
@@ -5249,11 +5543,8 @@ ScsiDiskAsyncRead16 (
 {
   EFI_STATUS             Status;
   SCSI_ASYNC_RW_REQUEST  *Request;
-  EFI_EVENT              AsyncIoEvent;
   EFI_TPL                OldTpl;
 
-  AsyncIoEvent = NULL;
-
   Request = AllocateZeroPool (sizeof (SCSI_ASYNC_RW_REQUEST));
   if (Request == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -5278,34 +5569,9 @@ ScsiDiskAsyncRead16 (
   Request->StartLba       = StartLba;
   Request->SectorCount    = SectorCount;
   Request->BlkIo2Req      = BlkIo2Req;
+  InitializeListHead (&Request->MergedQueue);
 
-  //
-  // Create Event
-  //
-  Status = gBS->CreateEvent (
-                  EVT_NOTIFY_SIGNAL,
-                  TPL_NOTIFY,
-                  ScsiDiskNotify,
-                  Request,
-                  &AsyncIoEvent
-                  );
-  if (EFI_ERROR (Status)) {
-    goto ErrorExit;
-  }
-
-  Status = ScsiRead16CommandEx (
-             ScsiDiskDevice->ScsiIo,
-             Request->Timeout,
-             Request->SenseData,
-             &Request->SenseDataLength,
-             &Request->HostAdapterStatus,
-             &Request->TargetStatus,
-             Request->InBuffer,
-             &Request->DataLength,
-             Request->StartLba,
-             Request->SectorCount,
-             AsyncIoEvent
-             );
+  Status = ScsiDiskAsyncQueueRW (Request);
   if (EFI_ERROR (Status)) {
     goto ErrorExit;
   }
@@ -5313,10 +5579,6 @@ ScsiDiskAsyncRead16 (
   return EFI_SUCCESS;
 
 ErrorExit:
-  if (AsyncIoEvent != NULL) {
-    gBS->CloseEvent (AsyncIoEvent);
-  }
-
   if (Request != NULL) {
     if (Request->SenseData != NULL) {
       FreePool (Request->SenseData);
@@ -5367,11 +5629,8 @@ ScsiDiskAsyncWrite16 (
 {
   EFI_STATUS             Status;
   SCSI_ASYNC_RW_REQUEST  *Request;
-  EFI_EVENT              AsyncIoEvent;
   EFI_TPL                OldTpl;
 
-  AsyncIoEvent = NULL;
-
   Request = AllocateZeroPool (sizeof (SCSI_ASYNC_RW_REQUEST));
   if (Request == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -5396,34 +5655,9 @@ ScsiDiskAsyncWrite16 (
   Request->StartLba       = StartLba;
   Request->SectorCount    = SectorCount;
   Request->BlkIo2Req      = BlkIo2Req;
+  InitializeListHead (&Request->MergedQueue);
 
-  //
-  // Create Event
-  //
-  Status = gBS->CreateEvent (
-                  EVT_NOTIFY_SIGNAL,
-                  TPL_NOTIFY,
-                  ScsiDiskNotify,
-                  Request,
-                  &AsyncIoEvent
-                  );
-  if (EFI_ERROR (Status)) {
-    goto ErrorExit;
-  }
-
-  Status = ScsiWrite16CommandEx (
-             ScsiDiskDevice->ScsiIo,
-             Request->Timeout,
-             Request->SenseData,
-             &Request->SenseDataLength,
-             &Request->HostAdapterStatus,
-             &Request->TargetStatus,
-             Request->OutBuffer,
-             &Request->DataLength,
-             Request->StartLba,
-             Request->SectorCount,
-             AsyncIoEvent
-             );
+  Status = ScsiDiskAsyncQueueRW (Request);
   if (EFI_ERROR (Status)) {
     goto ErrorExit;
   }
@@ -5431,10 +5665,6 @@ ScsiDiskAsyncWrite16 (
   return EFI_SUCCESS;
 
 ErrorExit:
-  if (AsyncIoEvent != NULL) {
-    gBS->CloseEvent (AsyncIoEvent);
-  }
-
   if (Request != NULL) {
     if (Request->SenseData != NULL) {
       FreePool (Request->SenseData);
@@ -40,6 +40,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define UFS_WLUN_RPMB  0xC4
 
+//
+// The number of SCSI Read/Write commands of BlockIo2 requests kept outstanding on
+// a device. Further commands wait in a queue, where adjacent ones are coalesced.
+//
+#define SCSI_DISK_MAX_OUTSTANDING_RW  8
+
 typedef struct {
   UINT32    MaxLbaCnt;
   UINT32    MaxBlkDespCnt;
@@ -90,10 +96,24 @@ typedef struct {
   //
   BOOLEAN                                  Cdb16Byte;
 
+  //
+  // The maximum number of blocks transferred by one Read/Write command. It is
+  // reported by the Block Limits VPD page and lowered when the device fails a
+  // longer transfer. 0 means only the CDB limits the transfer length.
+  //
+  UINT32                                   MaxTransferBlocks;
+
   //
   // The queue for asynchronous task requests
   //
   LIST_ENTRY                               AsyncTaskQueue;
+
+  //
+  // The SCSI Read/Write sub-tasks waiting to be sent to the device, and the
+  // number of sub-tasks sent and not completed yet
+  //
+  LIST_ENTRY                               PendingRWQueue;
+  UINT32                                   OutstandingRWCount;
 } SCSI_DISK_DEV;
 
 #define SCSI_DISK_DEV_FROM_BLKIO(a)     CR (a, SCSI_DISK_DEV, BlkIo, SCSI_DISK_DEV_SIGNATURE)
@@ -148,6 +168,19 @@ typedef struct {
   SCSI_BLKIO2_REQUEST    *BlkIo2Req;
 
   LIST_ENTRY             Link;
+
+  //
+  // Link in the PendingRWQueue of the device, or in the MergedQueue of the
+  // sub-task this one is coalesced into
+  //
+  LIST_ENTRY             PendingLink;
+
+  //
+  // The sub-tasks following this one on the device which are sent to the
+  // device as part of this command
+  //
+  LIST_ENTRY             MergedQueue;
+  UINT32                 MergedSectorCount;
 } SCSI_ASYNC_RW_REQUEST;
 
 //
@@ -1368,6 +1401,110 @@ ScsiDiskAsyncWrite16 (
   IN     EFI_BLOCK_IO2_TOKEN  *Token
   );
 
+/**
+  Complete a SCSI Read/Write sub-task, and signal the event of its BlockIo2
+  request if it is the last sub-task of the request.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+**/
+VOID
+ScsiDiskAsyncCompleteRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  );
+
+/**
+  Split a coalesced SCSI Read/Write command back into its sub-tasks.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  Request    The sub-task which carried the coalesced command.
+  @param  Completed  TRUE if the command transferred all its data, then the
+                     coalesced sub-tasks are completed. Otherwise they are
+                     put back to the head of the pending queue.
+
+**/
+VOID
+ScsiDiskAsyncSplitRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request,
+  IN  BOOLEAN                Completed
+  );
+
+/**
+  Send a SCSI Read/Write sub-task to the device.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+  @return Status returned by calling ScsiRead10CommandEx(), ScsiRead16CommandEx(),
+          ScsiWrite10CommandEx() or ScsiWrite16CommandEx().
+
+**/
+EFI_STATUS
+ScsiDiskAsyncSendRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  );
+
+/**
+  Send a SCSI Read/Write sub-task to the device, or queue it if the device
+  already has SCSI_DISK_MAX_OUTSTANDING_RW commands outstanding.
+
+  @param  Request    The SCSI Read/Write sub-task.
+
+  @retval EFI_SUCCESS  The sub-task is sent or queued.
+  @return others       Status returned by calling ScsiDiskAsyncSendRW().
+
+**/
+EFI_STATUS
+ScsiDiskAsyncQueueRW (
+  IN  SCSI_ASYNC_RW_REQUEST  *Request
+  );
+
+/**
+  Send the queued SCSI Read/Write sub-tasks while the device has free slots.
+
+  Queued sub-tasks which continue each other both on the device and in memory
+  are coalesced into one command, up to the maximum transfer length of the
+  device.
+
+  The caller must be at TPL_NOTIFY.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+
+**/
+VOID
+ScsiDiskAsyncSendPendingRW (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice
+  );
+
+/**
+  Get the maximum number of blocks one Read/Write command may transfer.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+
+  @return The maximum number of blocks.
+
+**/
+UINT32
+ScsiDiskGetMaxTransferBlocks (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice
+  );
+
+/**
+  Lower the maximum number of blocks one Read/Write command may transfer, so
+  that later requests are split to a length the device accepts.
+
+  @param  ScsiDiskDevice     The pointer of ScsiDiskDevice.
+  @param  Blocks             The number of blocks. 0 is ignored.
+
+**/
+VOID
+ScsiDiskLimitTransferBlocks (
+  IN  SCSI_DISK_DEV  *ScsiDiskDevice,
+  IN  UINT32         Blocks
+  );
+
 /**
   Get information from media read capacity command.
 
@@ -49,6 +49,10 @@ AsyncIoCallback (
 
   RemoveEntryList (&Request->Link);
 
+  if (Request->IsTask) {
+    Request->Device->CmdqTaskMap &= ~(UINT32)LShiftU64 (1, Request->TaskId);
+  }
+
   if (Request->IsEnd) {
     gBS->SignalEvent (Request->Token->Event);
   }
@@ -404,6 +408,71 @@ Error:
   return Status;
 }
 
+/**
+  Enable command queuing in the EMMC device. When the host controller can't
+  execute queued tasks, command queuing is no longer used for the device.
+
+  @param[in]  Partition         A pointer to the EMMC_PARTITION instance.
+
+**/
+VOID
+EmmcEnableCmdq (
+  IN     EMMC_PARTITION  *Partition
+  )
+{
+  EFI_STATUS   Status;
+  EMMC_DEVICE  *Device;
+
+  Device = Partition->Device;
+  if (!Device->CmdqSupported || (Device->ExtCsd.CmdqModeEn != 0)) {
+    return;
+  }
+
+  Status = EmmcSetExtCsd (Partition, OFFSET_OF (EMMC_EXT_CSD, CmdqModeEn), 1, NULL, FALSE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "EmmcEnableCmdq: Slot[%d] doesn't use command queuing - %r\n", Device->Slot, Status));
+    Device->CmdqSupported = FALSE;
+    return;
+  }
+
+  Device->ExtCsd.CmdqModeEn = 1;
+}
+
+/**
+  Disable command queuing in the EMMC device, after the queued tasks complete.
+
+  @param[in]  Partition         A pointer to the EMMC_PARTITION instance.
+
+  @retval EFI_SUCCESS           Command queuing is disabled.
+  @retval Others                The request could not be executed successfully.
+
+**/
+EFI_STATUS
+EmmcDisableCmdq (
+  IN     EMMC_PARTITION  *Partition
+  )
+{
+  EFI_STATUS   Status;
+  EMMC_DEVICE  *Device;
+
+  Device = Partition->Device;
+  if (Device->ExtCsd.CmdqModeEn == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The SWITCH command is only accepted once the queue of the device is empty,
+  // the host controller holds it back until then.
+  //
+  Status = EmmcSetExtCsd (Partition, OFFSET_OF (EMMC_EXT_CSD, CmdqModeEn), 0, NULL, FALSE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Device->ExtCsd.CmdqModeEn = 0;
+  return EFI_SUCCESS;
+}
+
 /**
   Set the number of blocks for a block read/write cmd through sync or async I/O request.
 
@@ -776,6 +845,252 @@ Error:
   return Status;
 }
 
+/**
+  Send a command of the queued task sequence to the device.
+
+  @param[in]  Device            A pointer to the EMMC_DEVICE instance.
+  @param[in]  CommandIndex      The index of the command.
+  @param[in]  Argument          The argument of the command.
+  @param[out] Response          The buffer to store the response. Optional.
+
+  @retval EFI_SUCCESS           The request is executed successfully.
+  @retval Others                The request could not be executed successfully.
+
+**/
+EFI_STATUS
+EmmcSendQueueCmd (
+  IN     EMMC_DEVICE  *Device,
+  IN     UINT8        CommandIndex,
+  IN     UINT32       Argument,
+  OUT    UINT32       *Response  OPTIONAL
+  )
+{
+  EFI_STATUS                           Status;
+  EFI_SD_MMC_PASS_THRU_PROTOCOL        *PassThru;
+  EFI_SD_MMC_COMMAND_BLOCK             SdMmcCmdBlk;
+  EFI_SD_MMC_STATUS_BLOCK              SdMmcStatusBlk;
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  Packet;
+
+  PassThru = Device->Private->PassThru;
+
+  ZeroMem (&SdMmcCmdBlk, sizeof (SdMmcCmdBlk));
+  ZeroMem (&SdMmcStatusBlk, sizeof (SdMmcStatusBlk));
+  ZeroMem (&Packet, sizeof (Packet));
+  Packet.SdMmcCmdBlk    = &SdMmcCmdBlk;
+  Packet.SdMmcStatusBlk = &SdMmcStatusBlk;
+  Packet.Timeout        = EMMC_GENERIC_TIMEOUT;
+
+  SdMmcCmdBlk.CommandIndex    = CommandIndex;
+  SdMmcCmdBlk.CommandType     = SdMmcCommandTypeAc;
+  SdMmcCmdBlk.ResponseType    = SdMmcResponseTypeR1;
+  SdMmcCmdBlk.CommandArgument = Argument;
+
+  Status = PassThru->PassThru (PassThru, Device->Slot, &Packet, NULL);
+  if (!EFI_ERROR (Status) && (Response != NULL)) {
+    *Response = SdMmcStatusBlk.Resp0;
+  }
+
+  return Status;
+}
+
+/**
+  Read/write multiple blocks as a queued task through sync or async I/O request.
+
+  The task is queued with QUEUED_TASK_PARAMS and QUEUED_TASK_ADDRESS, and is
+  executed with EXECUTE_READ_TASK or EXECUTE_WRITE_TASK once the Queue Status
+  Register reports it as ready. Refer to EMMC Electrical Standard Spec 5.1
+  Section 6.6.39 for details.
+
+  @param[in]  Partition         A pointer to the EMMC_PARTITION instance.
+  @param[in]  Lba               The starting logical block address to be read/written.
+                                The caller is responsible for reading/writing to only
+                                legitimate locations.
+  @param[in]  Buffer            A pointer to the destination/source buffer for the data.
+  @param[in]  BufferSize        Size of Buffer, must be a multiple of device block size.
+  @param[in]  IsRead            Indicates it is a read or write operation.
+  @param[in]  Token             A pointer to the token associated with the transaction.
+  @param[in]  IsEnd             A boolean to show whether it's the last cmd in a series of cmds.
+                                This parameter is only meaningful in async I/O request.
+
+  @retval EFI_SUCCESS           The request is executed successfully.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be executed due to a lack of resources.
+  @retval Others                The request could not be executed successfully.
+
+**/
+EFI_STATUS
+EmmcQueueTask (
+  IN  EMMC_PARTITION       *Partition,
+  IN  EFI_LBA              Lba,
+  IN  VOID                 *Buffer,
+  IN  UINTN                BufferSize,
+  IN  BOOLEAN              IsRead,
+  IN  EFI_BLOCK_IO2_TOKEN  *Token,
+  IN  BOOLEAN              IsEnd
+  )
+{
+  EFI_STATUS                     Status;
+  EMMC_DEVICE                    *Device;
+  EMMC_REQUEST                   *TaskReq;
+  EFI_SD_MMC_PASS_THRU_PROTOCOL  *PassThru;
+  EFI_TPL                        OldTpl;
+  UINT8                          TaskId;
+  UINT32                         Argument;
+  UINT32                         QueueStatus;
+  UINT32                         Timeout;
+
+  TaskReq = NULL;
+
+  Device   = Partition->Device;
+  PassThru = Device->Private->PassThru;
+
+  //
+  // Take a free task ID. The IDs in use are released as the tasks complete,
+  // each within the timeout of its own request.
+  //
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    for (TaskId = 0; TaskId < Device->CmdqDepth; TaskId++) {
+      if ((Device->CmdqTaskMap & LShiftU64 (1, TaskId)) == 0) {
+        Device->CmdqTaskMap |= (UINT32)LShiftU64 (1, TaskId);
+        break;
+      }
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    if (TaskId < Device->CmdqDepth) {
+      break;
+    }
+
+    gBS->Stall (1);
+  }
+
+  Argument = (UINT32)(BufferSize / Partition->BlockMedia.BlockSize) | ((UINT32)TaskId << 16);
+  if (IsRead) {
+    Argument |= BIT30;
+  }
+
+  Status = EmmcSendQueueCmd (Device, EMMC_QUEUED_TASK_PARAMS, Argument, NULL);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  if (Device->SectorAddressing) {
+    Argument = (UINT32)Lba;
+  } else {
+    Argument = (UINT32)MultU64x32 (Lba, Partition->BlockMedia.BlockSize);
+  }
+
+  Status = EmmcSendQueueCmd (Device, EMMC_QUEUED_TASK_ADDRESS, Argument, NULL);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  //
+  // Wait for the task to be ready for execution.
+  //
+  Timeout = EMMC_GENERIC_TIMEOUT;
+  while (TRUE) {
+    Status = EmmcSendQueueCmd (Device, EMMC_SEND_STATUS, ((UINT32)(Device->Slot + 1) << 16) | BIT15, &QueueStatus);
+    if (EFI_ERROR (Status)) {
+      goto Error;
+    }
+
+    if ((QueueStatus & LShiftU64 (1, TaskId)) != 0) {
+      break;
+    }
+
+    if (Timeout-- == 0) {
+      Status = EFI_TIMEOUT;
+      goto Error;
+    }
+
+    gBS->Stall (1);
+  }
+
+  TaskReq = AllocateZeroPool (sizeof (EMMC_REQUEST));
+  if (TaskReq == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error;
+  }
+
+  TaskReq->Signature = EMMC_REQUEST_SIGNATURE;
+  OldTpl             = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Partition->Queue, &TaskReq->Link);
+  gBS->RestoreTPL (OldTpl);
+  TaskReq->Packet.SdMmcCmdBlk    = &TaskReq->SdMmcCmdBlk;
+  TaskReq->Packet.SdMmcStatusBlk = &TaskReq->SdMmcStatusBlk;
+  //
+  // Same timeout as EmmcRwMultiBlocks().
+  //
+  TaskReq->Packet.Timeout = (BufferSize / (2 * 1024 * 1024) + 1) * 1000 * 1000;
+
+  if (IsRead) {
+    TaskReq->Packet.InDataBuffer     = Buffer;
+    TaskReq->Packet.InTransferLength = (UINT32)BufferSize;
+
+    TaskReq->SdMmcCmdBlk.CommandIndex = EMMC_EXECUTE_READ_TASK;
+  } else {
+    TaskReq->Packet.OutDataBuffer     = Buffer;
+    TaskReq->Packet.OutTransferLength = (UINT32)BufferSize;
+
+    TaskReq->SdMmcCmdBlk.CommandIndex = EMMC_EXECUTE_WRITE_TASK;
+  }
+
+  TaskReq->SdMmcCmdBlk.CommandType     = SdMmcCommandTypeAdtc;
+  TaskReq->SdMmcCmdBlk.ResponseType    = SdMmcResponseTypeR1;
+  TaskReq->SdMmcCmdBlk.CommandArgument = (UINT32)TaskId << 16;
+
+  TaskReq->IsEnd  = IsEnd;
+  TaskReq->IsTask = TRUE;
+  TaskReq->TaskId = TaskId;
+  TaskReq->Token  = Token;
+  TaskReq->Device = Device;
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    AsyncIoCallback,
+                    TaskReq,
+                    &TaskReq->Event
+                    );
+    if (EFI_ERROR (Status)) {
+      goto Error;
+    }
+  } else {
+    TaskReq->Event = NULL;
+  }
+
+  Status = PassThru->PassThru (PassThru, Device->Slot, &TaskReq->Packet, TaskReq->Event);
+
+  //
+  // For asynchronous operation, the task ID is released in the asynchronous
+  // callback for success case.
+  //
+  if (!EFI_ERROR (Status) && (Token != NULL) && (Token->Event != NULL)) {
+    return Status;
+  }
+
+Error:
+  OldTpl               = gBS->RaiseTPL (TPL_NOTIFY);
+  Device->CmdqTaskMap &= ~(UINT32)LShiftU64 (1, TaskId);
+  if (TaskReq != NULL) {
+    RemoveEntryList (&TaskReq->Link);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (TaskReq != NULL) {
+    if (TaskReq->Event != NULL) {
+      gBS->CloseEvent (TaskReq->Event);
+    }
+
+    FreePool (TaskReq);
+  }
+
+  return Status;
+}
+
 /**
   This function transfers data from/to EMMC device.
 
@@ -870,10 +1185,16 @@ EmmcReadWrite (
   }
 
   //
-  // Check if needs to switch partition access.
+  // Check if needs to switch partition access. The partition can't be switched
+  // while command queuing is enabled.
   //
   PartitionConfig = Device->ExtCsd.PartitionConfig;
   if ((PartitionConfig & 0x7) != Partition->PartitionType) {
+    Status = EmmcDisableCmdq (Partition);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
     PartitionConfig &= (UINT8) ~0x7;
     PartitionConfig |= Partition->PartitionType;
     Status           = EmmcSetExtCsd (Partition, OFFSET_OF (EMMC_EXT_CSD, PartitionConfig), PartitionConfig, Token, FALSE);
@@ -884,6 +1205,14 @@ EmmcReadWrite (
     Device->ExtCsd.PartitionConfig = PartitionConfig;
   }
 
+  //
+  // Keep the requests in flight through command queuing when it is available.
+  // The RPMB partition is only accessed through regular commands.
+  //
+  if (Partition->PartitionType != EmmcPartitionRPMB) {
+    EmmcEnableCmdq (Partition);
+  }
+
   //
   // Start to execute data transfer. The max block number in single cmd is 65535 blocks.
   //
@@ -898,15 +1227,22 @@ EmmcReadWrite (
       BlockNum = MaxBlock;
     }
 
-    Status = EmmcSetBlkCount (Partition, (UINT16)BlockNum, Token, FALSE);
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
     BufferSize = BlockNum * BlockSize;
-    Status     = EmmcRwMultiBlocks (Partition, Lba, Buffer, BufferSize, IsRead, Token, LastRw);
-    if (EFI_ERROR (Status)) {
-      return Status;
+    if (Device->ExtCsd.CmdqModeEn != 0) {
+      Status = EmmcQueueTask (Partition, Lba, Buffer, BufferSize, IsRead, Token, LastRw);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    } else {
+      Status = EmmcSetBlkCount (Partition, (UINT16)BlockNum, Token, FALSE);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Status = EmmcRwMultiBlocks (Partition, Lba, Buffer, BufferSize, IsRead, Token, LastRw);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
     }
 
     DEBUG ((
@@ -1099,6 +1435,10 @@ EmmcResetEx (
     gBS->CloseEvent (Request->Event);
     Request->Token->TransactionStatus = EFI_ABORTED;
 
+    if (Request->IsTask) {
+      Partition->Device->CmdqTaskMap &= ~(UINT32)LShiftU64 (1, Request->TaskId);
+    }
+
     if (Request->IsEnd) {
       gBS->SignalEvent (Request->Token->Event);
     }
@@ -1366,6 +1706,14 @@ EmmcSecurityProtocolInOut (
   while (!IsListEmpty (&Partition->Queue)) {
   }
 
+  //
+  // The security protocol commands can't be sent while command queuing is enabled.
+  //
+  Status = EmmcDisableCmdq (Partition);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Check if needs to switch partition access.
   //
@@ -2058,8 +2406,14 @@ EmmcEraseBlocks (
   LastLba  = Lba + BlockNum - 1;
 
   //
-  // Check if needs to switch partition access.
+  // Check if needs to switch partition access. The erase commands can't be
+  // sent while command queuing is enabled.
   //
+  Status = EmmcDisableCmdq (Partition);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   PartitionConfig = Device->ExtCsd.PartitionConfig;
   if ((PartitionConfig & 0x7) != Partition->PartitionType) {
     PartitionConfig &= (UINT8) ~0x7;
@@ -420,6 +420,18 @@ DiscoverAllPartitions (
     }
   }
 
+  //
+  // Command queuing is enabled on the first read/write request. Start with it
+  // disabled, in case an earlier boot stage left it enabled.
+  //
+  Device->CmdqSupported = (BOOLEAN)((ExtCsd->ExtCsdRev >= 8) && ((ExtCsd->CmdqSupport & BIT0) != 0));
+  Device->CmdqDepth     = (ExtCsd->CmdqDepth & 0x1F) + 1;
+  Device->CmdqTaskMap   = 0;
+  Status                = EmmcDisableCmdq (&Device->Partition[EmmcPartitionUserData]);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   return EFI_SUCCESS;
 }
 
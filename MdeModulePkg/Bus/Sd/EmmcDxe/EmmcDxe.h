@@ -83,9 +83,15 @@ typedef struct {
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET    Packet;
 
   BOOLEAN                                IsEnd;
+  //
+  // Whether the request executes a queued task, and the ID of the task.
+  //
+  BOOLEAN                                IsTask;
+  UINT8                                  TaskId;
 
   EFI_BLOCK_IO2_TOKEN                    *Token;
   EFI_EVENT                              Event;
+  EMMC_DEVICE                            *Device;
 } EMMC_REQUEST;
 
 #define EMMC_REQUEST_FROM_LINK(a) \
@@ -139,6 +145,13 @@ struct _EMMC_DEVICE {
   //
   CHAR16                      ModelName[EMMC_MODEL_NAME_MAX_LEN];
   EMMC_DRIVER_PRIVATE_DATA    *Private;
+  //
+  // Command queuing: whether it is used for the read/write requests, the
+  // queue depth of the device and the IDs of the tasks in use.
+  //
+  BOOLEAN                     CmdqSupported;
+  UINT8                       CmdqDepth;
+  UINT32                      CmdqTaskMap;
 };
 
 //
@@ -497,4 +510,18 @@ EmmcGetExtCsd (
   OUT EMMC_EXT_CSD    *ExtCsd
   );
 
+/**
+  Disable command queuing in the EMMC device, after the queued tasks complete.
+
+  @param[in]  Partition         A pointer to the EMMC_PARTITION instance.
+
+  @retval EFI_SUCCESS           Command queuing is disabled.
+  @retval Others                The request could not be executed successfully.
+
+**/
+EFI_STATUS
+EmmcDisableCmdq (
+  IN     EMMC_PARTITION  *Partition
+  );
+
 #endif
@@ -75,6 +75,11 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
   //
   EFI_EVENT                             TimerEvent;
   LIST_ENTRY                            Queue;
+  //
+  // The transfer request slots taken by the requests in flight, released
+  // once their completion is processed.
+  //
+  UINT32                                TrlSlotsInUse;
 } UFS_PASS_THRU_PRIVATE_DATA;
 
 #define UFS_PASS_THRU_TRANS_REQ_SIG  SIGNATURE_32 ('U', 'F', 'S', 'T')
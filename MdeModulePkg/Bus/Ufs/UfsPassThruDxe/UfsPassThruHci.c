@@ -705,7 +705,11 @@ UfsCreateNopCommandDesc (
 }
 
 /**
-  Find out available slot in transfer list of a UFS device.
+  Find out available slot in transfer list of a UFS device and take it.
+
+  A slot whose doorbell is cleared stays taken until the completion of its
+  request is processed and the slot is released by UfsReleaseSlotInTrl(), so
+  all the slots the controller reports can be used by concurrent requests.
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[out] Slot          The available slot.
@@ -720,28 +724,54 @@ UfsFindAvailableSlotInTrl (
   OUT UINT8                          *Slot
   )
 {
-  UINT8       Nutrs;
   UINT8       Index;
   UINT32      Data;
   EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
+    gBS->RestoreTPL (OldTpl);
     return Status;
   }
 
-  Nutrs = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
-
-  for (Index = 0; Index < Nutrs; Index++) {
+  Data  |= Private->TrlSlotsInUse;
+  Status = EFI_NOT_READY;
+  for (Index = 0; Index < Private->Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
-      *Slot = Index;
-      return EFI_SUCCESS;
+      Private->TrlSlotsInUse |= BIT0 << Index;
+      *Slot                   = Index;
+      Status                  = EFI_SUCCESS;
+      break;
     }
   }
 
-  return EFI_NOT_READY;
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Release a slot taken by UfsFindAvailableSlotInTrl().
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be released.
+
+**/
+VOID
+UfsReleaseSlotInTrl (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl                  = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->TrlSlotsInUse &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
 }
 
 /**
@@ -924,6 +954,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -940,7 +971,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -971,6 +1002,7 @@ Exit:
   UfsHc->Flush (UfsHc);
 
   UfsStopExecCmd (Private, Slot);
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1275,6 +1307,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD *)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -1309,6 +1342,7 @@ Exit:
   UfsHc->Flush (UfsHc);
 
   UfsStopExecCmd (Private, Slot);
+  UfsReleaseSlotInTrl (Private, Slot);
 
   if (CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, CmdDescMapping);
@@ -1519,6 +1553,7 @@ UfsExecScsiCmds (
   //
   Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
   if (EFI_ERROR (Status)) {
+    FreePool (TransReq);
     return Status;
   }
 
@@ -1536,7 +1571,7 @@ UfsExecScsiCmds (
              &TransReq->CmdDescMapping
              );
   if (EFI_ERROR (Status)) {
-    return Status;
+    goto Exit1;
   }
 
   TransReq->CmdDescSize = TransReq->Trd->PrdtO * sizeof (UINT32) + TransReq->Trd->PrdtL * sizeof (UTP_TR_PRD);
@@ -1547,13 +1582,22 @@ UfsExecScsiCmds (
   }
 
   //
-  // Insert the async SCSI cmd to the Async I/O list
+  // Insert the async SCSI cmd to the Async I/O list and start to execute it.
+  // The doorbell is rung with the timer held off, so that the completion scan
+  // doesn't see the cleared doorbell of a request which hasn't started yet.
+  // Requests in other slots keep running meanwhile.
   //
   if (Event != NULL) {
     OldTpl                = gBS->RaiseTPL (TPL_NOTIFY);
     TransReq->CallerEvent = Event;
     InsertTailList (&Private->Queue, &TransReq->TransferList);
+    UfsStartExecCmd (Private, TransReq->Slot);
     gBS->RestoreTPL (OldTpl);
+
+    //
+    // Immediately return for async I/O.
+    //
+    return EFI_SUCCESS;
   }
 
   //
@@ -1561,13 +1605,6 @@ UfsExecScsiCmds (
   //
   UfsStartExecCmd (Private, TransReq->Slot);
 
-  //
-  // Immediately return for async I/O.
-  //
-  if (Event != NULL) {
-    return EFI_SUCCESS;
-  }
-
   //
   // Wait for the completion of the transfer request.
   //
@@ -1632,6 +1669,8 @@ Exit:
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
 Exit1:
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -2249,6 +2288,8 @@ SignalCallerEvent (
 
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -2289,28 +2330,22 @@ ProcessAsyncTaskList (
   UTP_RESPONSE_UPIU                           *Response;
   UINT16                                      SenseDataLen;
   UINT32                                      ResTranCount;
-  UINT32                                      SlotsMap;
   UINT32                                      Value;
   EFI_STATUS                                  Status;
 
-  Private  = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
-  SlotsMap = 0;
+  Private = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
 
   //
-  // Check the entries in the async I/O queue are done or not.
+  // Check the entries in the async I/O queue are done or not. Each request
+  // owns its slot, so a single doorbell read reports all the completions.
   //
   if (!IsListEmpty (&Private->Queue)) {
+    Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
+
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->Queue) {
       TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
       Packet   = TransReq->Packet;
 
-      if ((SlotsMap & (BIT0 << TransReq->Slot)) != 0) {
-        return;
-      }
-
-      SlotsMap |= BIT0 << TransReq->Slot;
-
-      Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
       if (EFI_ERROR (Status)) {
         //
         // TODO: Should find/add a proper host adapter return status for this
@@ -204,10 +204,12 @@ BotDataPhase (
 
   while (Remain > 0) {
     //
-    // Using 15 packets to avoid Bitstuff error
+    // The endpoints of high and super speed devices, whose max packet size
+    // is at least 512, take the whole data phase in one transfer, which the
+    // host controller splits itself.
     //
-    if (Remain > 16 * MaxPacketLen) {
-      Increment = 16 * MaxPacketLen;
+    if ((MaxPacketLen < 512) && (Remain > USB_BOT_FULL_SPEED_MAX_PACKETS * MaxPacketLen)) {
+      Increment = USB_BOT_FULL_SPEED_MAX_PACKETS * MaxPacketLen;
     } else {
       Increment = Remain;
     }
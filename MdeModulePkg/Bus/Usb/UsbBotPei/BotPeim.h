@@ -51,6 +51,17 @@ typedef struct {
 #define CSWSIG  0x53425355
 #define CBWSIG  0x43425355
 
+//
+// The largest data transfer of a Read(10) command, in bytes.
+//
+#define USB_BOT_MAX_READ_SIZE  SIZE_1MB
+
+//
+// Data phases of full speed endpoints are split in transfers of that many
+// packets to avoid Bitstuff error.
+//
+#define USB_BOT_FULL_SPEED_MAX_PACKETS  16
+
 /**
   Sends out ATAPI Inquiry Packet Command to the specified device. This command will
   return INQUIRY data of the device.
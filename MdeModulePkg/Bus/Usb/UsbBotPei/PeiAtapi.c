@@ -382,7 +382,7 @@ PeiUsbRead10 (
 {
   ATAPI_PACKET_COMMAND  Packet;
   ATAPI_READ10_CMD      *Read10Packet;
-  UINT16                MaxBlock;
+  UINT32                MaxBlock;
   UINT32                BlocksRemaining;
   UINT32                SectorCount;
   UINT32                Lba32;
@@ -402,7 +402,7 @@ PeiUsbRead10 (
 
   BlockSize = (UINT32)PeiBotDevice->Media.BlockSize;
 
-  MaxBlock = (UINT16)(MAX_UINT16 / BlockSize);
+  MaxBlock = MIN (USB_BOT_MAX_READ_SIZE / BlockSize, MAX_UINT16);
   ASSERT (NumberOfBlocks < MAX_UINT32);
   BlocksRemaining = (UINT32)NumberOfBlocks;
 
@@ -474,7 +474,7 @@ BotReadBlocks (
                  PeiBotDev,
                  Buffer,
                  StartLBA,
-                 1
+                 NumberOfBlocks
                  );
     }
   } else {
@@ -533,30 +533,9 @@ BotReadBlocks (
       default:
         return EFI_DEVICE_ERROR;
     }
-  } else {
-    StartLBA       += 1;
-    NumberOfBlocks -= 1;
-    Buffer          = (UINT8 *)Buffer + PeiBotDev->Media.BlockSize;
-
-    if (NumberOfBlocks == 0) {
-      return EFI_SUCCESS;
-    }
-
-    Status = PeiUsbRead10 (
-               PeiServices,
-               PeiBotDev,
-               Buffer,
-               StartLBA,
-               NumberOfBlocks
-               );
-    switch (Status) {
-      case EFI_SUCCESS:
-        return EFI_SUCCESS;
-
-      default:
-        return EFI_DEVICE_ERROR;
-    }
   }
+
+  return EFI_SUCCESS;
 }
 
 /**
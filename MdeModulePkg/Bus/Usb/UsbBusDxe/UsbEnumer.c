@@ -652,6 +652,7 @@ UsbFindChild (
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
   @param  ResetIsNeeded         The boolean to control whether skip the reset of the port.
+  @param  PortIsStable          TRUE if the connection has already been debounced.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -662,7 +663,8 @@ EFI_STATUS
 UsbEnumerateNewDev (
   IN USB_INTERFACE  *HubIf,
   IN UINT8          Port,
-  IN BOOLEAN        ResetIsNeeded
+  IN BOOLEAN        ResetIsNeeded,
+  IN BOOLEAN        PortIsStable
   )
 {
   USB_BUS              *Bus;
@@ -679,7 +681,9 @@ UsbEnumerateNewDev (
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  if (!PortIsStable) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
 
   //
   // Hub resets the device for at least 10 milliseconds.
@@ -875,11 +879,61 @@ ON_ERROR:
   return Status;
 }
 
+/**
+  Get the state of the port whose events are to be processed.
+
+  Host learns of the new device by polling the hub for port changes. The
+  state is read only once per enumeration, as the root hub of some host
+  controllers acknowledges the changes it reports.
+
+  @param  HubIf                 The HUB that has the port.
+  @param  Port                  The port index of the hub (started with zero).
+  @param  PortState             Receives the state of the port. No change is
+                                reported if the state cannot be read.
+
+  @retval TRUE                  A new device is to be enumerated on the port.
+  @retval FALSE                 No device is to be enumerated on the port.
+
+**/
+STATIC
+BOOLEAN
+UsbGetPortState (
+  IN  USB_INTERFACE        *HubIf,
+  IN  UINT8                Port,
+  OUT EFI_USB_PORT_STATUS  *PortState
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = HubIf->HubApi->GetPortStatus (HubIf, Port, PortState);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbEnumeratePort: failed to get state of port %d\n", Port));
+    ZeroMem (PortState, sizeof (*PortState));
+    return FALSE;
+  }
+
+  if ((PortState->PortChangeStatus & USB_PORT_ENUMERATION_CHANGES) == 0) {
+    return FALSE;
+  }
+
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT) &&
+      USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_OVERCURRENT))
+  {
+    return FALSE;
+  }
+
+  return USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_CONNECTION);
+}
+
 /**
   Process the events on the port.
 
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  PortState             The state of the port, from UsbGetPortState ().
+  @param  PortIsStable          TRUE if the connection of a new device has
+                                already been debounced.
 
   @retval EFI_SUCCESS           The device is enumerated (added or removed).
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
@@ -888,33 +942,24 @@ ON_ERROR:
 **/
 EFI_STATUS
 UsbEnumeratePort (
-  IN USB_INTERFACE  *HubIf,
-  IN UINT8          Port
+  IN USB_INTERFACE        *HubIf,
+  IN UINT8                Port,
+  IN EFI_USB_PORT_STATUS  *PortState,
+  IN BOOLEAN              PortIsStable
   )
 {
-  USB_HUB_API          *HubApi;
-  USB_DEVICE           *Child;
-  EFI_USB_PORT_STATUS  PortState;
-  EFI_STATUS           Status;
+  USB_HUB_API  *HubApi;
+  USB_DEVICE   *Child;
+  EFI_STATUS   Status;
 
   Child  = NULL;
   HubApi = HubIf->HubApi;
-
-  //
-  // Host learns of the new device by polling the hub for port changes.
-  //
-  Status = HubApi->GetPortStatus (HubIf, Port, &PortState);
-
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "UsbEnumeratePort: failed to get state of port %d\n", Port));
-    return Status;
-  }
+  Status = EFI_SUCCESS;
 
   //
   // Only handle connection/enable/overcurrent/reset change.
-  // Usb super speed hub may report other changes, such as warm reset change. Ignore them.
   //
-  if ((PortState.PortChangeStatus & (USB_PORT_STAT_C_CONNECTION | USB_PORT_STAT_C_ENABLE | USB_PORT_STAT_C_OVERCURRENT | USB_PORT_STAT_C_RESET)) == 0) {
+  if ((PortState->PortChangeStatus & USB_PORT_ENUMERATION_CHANGES) == 0) {
     return EFI_SUCCESS;
   }
 
@@ -922,8 +967,8 @@ UsbEnumeratePort (
     DEBUG_INFO,
     "UsbEnumeratePort: port %d state - %02x, change - %02x on %p\n",
     Port,
-    PortState.PortStatus,
-    PortState.PortChangeStatus,
+    PortState->PortStatus,
+    PortState->PortChangeStatus,
     HubIf
     ));
 
@@ -933,8 +978,8 @@ UsbEnumeratePort (
   // ENABLE/RESET is used to reset port. SUSPEND isn't supported.
   //
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT)) {
-    if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_OVERCURRENT)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_OVERCURRENT)) {
+    if (USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_OVERCURRENT)) {
       //
       // Case1:
       //   Both OverCurrent and OverCurrentChange set, means over current occurs,
@@ -954,7 +999,7 @@ UsbEnumeratePort (
     DEBUG ((DEBUG_ERROR, "UsbEnumeratePort: 2.0 device Recovery Over Current (port %d)\n", Port));
   }
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_ENABLE)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_ENABLE)) {
     //
     // Case3:
     //   1.1 roothub port reg doesn't reflect over-current state, while its counterpart
@@ -964,7 +1009,7 @@ UsbEnumeratePort (
     DEBUG ((DEBUG_ERROR, "UsbEnumeratePort: 1.1 device Recovery Over Current (port %d)\n", Port));
   }
 
-  if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_CONNECTION)) {
+  if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_CONNECTION)) {
     //
     // Case4:
     //   Device connected or disconnected normally.
@@ -982,15 +1027,15 @@ UsbEnumeratePort (
     UsbRemoveDevice (Child);
   }
 
-  if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION)) {
+  if (USB_BIT_IS_SET (PortState->PortStatus, USB_PORT_STAT_CONNECTION)) {
     //
     // Now, new device connected, enumerate and configure the device
     //
     DEBUG ((DEBUG_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
-    if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
+    if (USB_BIT_IS_SET (PortState->PortChangeStatus, USB_PORT_STAT_C_RESET)) {
+      Status = UsbEnumerateNewDev (HubIf, Port, FALSE, PortIsStable);
     } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
+      Status = UsbEnumerateNewDev (HubIf, Port, TRUE, PortIsStable);
     }
   } else {
     DEBUG ((DEBUG_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
@@ -1014,11 +1059,13 @@ UsbHubEnumeration (
   IN VOID       *Context
   )
 {
-  USB_INTERFACE  *HubIf;
-  UINT8          Byte;
-  UINT8          Bit;
-  UINT8          Index;
-  USB_DEVICE     *Child;
+  USB_INTERFACE        *HubIf;
+  UINT8                Byte;
+  UINT8                Bit;
+  UINT8                Index;
+  USB_DEVICE           *Child;
+  EFI_USB_PORT_STATUS  PortStates[MAX_UINT8];
+  BOOLEAN              NewDevice;
 
   ASSERT (Context != NULL);
 
@@ -1037,14 +1084,34 @@ UsbHubEnumeration (
   }
 
   //
-  // HUB starts its port index with 1.
+  // HUB starts its port index with 1. The devices connected to the changed
+  // ports are debounced together, before they are reset and addressed one
+  // after the other.
   //
+  Byte      = 0;
+  Bit       = 1;
+  NewDevice = FALSE;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
+      if (UsbGetPortState (HubIf, Index, &PortStates[Index])) {
+        NewDevice = TRUE;
+      }
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  if (NewDevice) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
+
   Byte = 0;
   Bit  = 1;
 
   for (Index = 0; Index < HubIf->NumOfPort; Index++) {
     if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
+      UsbEnumeratePort (HubIf, Index, &PortStates[Index], NewDevice);
     }
 
     USB_NEXT_BIT (Byte, Bit);
@@ -1071,11 +1138,14 @@ UsbRootHubEnumeration (
   IN VOID       *Context
   )
 {
-  USB_INTERFACE  *RootHub;
-  UINT8          Index;
-  USB_DEVICE     *Child;
+  USB_INTERFACE        *RootHub;
+  UINT8                Index;
+  USB_DEVICE           *Child;
+  EFI_USB_PORT_STATUS  PortStates[MAX_UINT8];
+  BOOLEAN              NewDevice;
 
-  RootHub = (USB_INTERFACE *)Context;
+  RootHub   = (USB_INTERFACE *)Context;
+  NewDevice = FALSE;
 
   for (Index = 0; Index < RootHub->NumOfPort; Index++) {
     Child = UsbFindChild (RootHub, Index);
@@ -1084,6 +1154,20 @@ UsbRootHubEnumeration (
       UsbRemoveDevice (Child);
     }
 
-    UsbEnumeratePort (RootHub, Index);
+    if (UsbGetPortState (RootHub, Index, &PortStates[Index])) {
+      NewDevice = TRUE;
+    }
+  }
+
+  //
+  // The devices connected to the ports are debounced together, before they
+  // are reset and addressed one after the other.
+  //
+  if (NewDevice) {
+    gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
+  }
+
+  for (Index = 0; Index < RootHub->NumOfPort; Index++) {
+    UsbEnumeratePort (RootHub, Index, &PortStates[Index], NewDevice);
   }
 }
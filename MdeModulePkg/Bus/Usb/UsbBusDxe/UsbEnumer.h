@@ -22,6 +22,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
             }                 \
           } while (0)
 
+//
+// The port changes the enumeration handles. Usb super speed hub may report
+// other changes, such as warm reset change, which are ignored.
+//
+#define USB_PORT_ENUMERATION_CHANGES  (USB_PORT_STAT_C_CONNECTION |  \
+                                       USB_PORT_STAT_C_ENABLE |      \
+                                       USB_PORT_STAT_C_OVERCURRENT | \
+                                       USB_PORT_STAT_C_RESET)
+
 //
 // Common interface used by usb bus enumeration process.
 // This interface is defined to mask the difference between
@@ -31,6 +31,7 @@ typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
 #include "UsbMassBoot.h"
+#include "UsbMassUas.h"
 #include "UsbMassDiskInfo.h"
 #include "UsbMassImpl.h"
 
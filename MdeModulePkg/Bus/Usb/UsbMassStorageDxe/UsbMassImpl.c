@@ -8,11 +8,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "UsbMass.h"
 
-#define USB_MASS_TRANSPORT_COUNT  3
+#define USB_MASS_TRANSPORT_COUNT  4
 //
-// Array of USB transport interfaces.
+// Array of USB transport interfaces. UAS is tried first, as it is
+// provided by an alternate setting of an interface which also has BOT.
 //
 USB_MASS_TRANSPORT  *mUsbMassTransport[USB_MASS_TRANSPORT_COUNT] = {
+  &mUsbUasTransport,
   &mUsbCbi0Transport,
   &mUsbCbi1Transport,
   &mUsbBotTransport,
@@ -422,13 +424,19 @@ UsbMassInitTransport (
   // matching transport protocol.
   // If not found, return EFI_UNSUPPORTED.
   // If found, execute USB_MASS_TRANSPORT.Init() to initialize the transport context.
+  // UAS is looked up in the alternate settings of the interface, and the
+  // search goes on if the interface doesn't have it.
   //
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     *Transport = mUsbMassTransport[Index];
 
-    if (Interface.InterfaceProtocol == (*Transport)->Protocol) {
+    if ((Interface.InterfaceProtocol == (*Transport)->Protocol) ||
+        ((*Transport)->Protocol == USB_MASS_STORE_UAS))
+    {
       Status = (*Transport)->Init (UsbIo, Context);
-      break;
+      if (Status != EFI_UNSUPPORTED) {
+        break;
+      }
     }
   }
 
@@ -751,9 +759,13 @@ USBMassDriverBindingSupported (
   //
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     Transport = mUsbMassTransport[Index];
-    if (Interface.InterfaceProtocol == Transport->Protocol) {
+    if ((Interface.InterfaceProtocol == Transport->Protocol) ||
+        (Transport->Protocol == USB_MASS_STORE_UAS))
+    {
       Status = Transport->Init (UsbIo, NULL);
-      break;
+      if (Status != EFI_UNSUPPORTED) {
+        break;
+      }
     }
   }
 
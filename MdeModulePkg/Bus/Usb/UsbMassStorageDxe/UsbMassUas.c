@@ -0,0 +1,690 @@
+/** @file
+  Implementation of the USB mass storage USB Attached SCSI transport protocol.
+
+  The UsbIo protocol doesn't expose bulk streams, so the transport drives the
+  UAS pipes the way the specification defines for high-speed devices: one
+  command at a time, with the Read Ready and Write Ready IUs announcing the
+  data phase. A UAS alternate setting whose endpoints require streams is
+  not used, and the device stays on the Bulk-Only transport.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbMass.h"
+
+//
+// Definition of USB UAS Transport Protocol
+//
+USB_MASS_TRANSPORT  mUsbUasTransport = {
+  USB_MASS_STORE_UAS,
+  UsbUasInit,
+  UsbUasExecCommand,
+  UsbUasResetDevice,
+  UsbUasGetMaxLun,
+  UsbUasCleanUp
+};
+
+/**
+  Select an alternate setting of the USB mass storage interface.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  InterfaceNumber       The number of the interface
+  @param  AltSetting            The alternate setting to select
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval Others                Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSetInterface (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                InterfaceNumber,
+  IN UINT8                AltSetting
+  )
+{
+  EFI_USB_DEVICE_REQUEST  Request;
+  UINT32                  Result;
+
+  Request.RequestType = USB_REQ_TYPE_STANDARD | USB_TARGET_INTERFACE;
+  Request.Request     = USB_REQ_SET_INTERFACE;
+  Request.Value       = AltSetting;
+  Request.Index       = InterfaceNumber;
+  Request.Length      = 0;
+
+  return UsbIo->UsbControlTransfer (
+                  UsbIo,
+                  &Request,
+                  EfiUsbNoData,
+                  USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND,
+                  NULL,
+                  0,
+                  &Result
+                  );
+}
+
+/**
+  Look up the UAS alternate setting of the USB mass storage interface in the
+  configuration descriptor, and the endpoints of its pipes.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  UsbUas                The UAS protocol context. Interface holds the
+                                current interface descriptor on input, the
+                                alternate setting and the endpoints are
+                                filled on output.
+
+  @retval EFI_SUCCESS           The UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+  @retval EFI_OUT_OF_RESOURCES  The memory allocation failed.
+
+**/
+EFI_STATUS
+UsbUasFindAltSetting (
+  IN     EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN OUT USB_UAS_PROTOCOL     *UsbUas
+  )
+{
+  EFI_USB_DEVICE_REQUEST        Request;
+  EFI_USB_CONFIG_DESCRIPTOR     ConfigDesc;
+  EFI_USB_INTERFACE_DESCRIPTOR  *IfDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *EpDesc;
+  UINT8                         *Buffer;
+  UINTN                         Offset;
+  UINT8                         Length;
+  UINT8                         Type;
+  UINT8                         EpAddress;
+  BOOLEAN                       InUasSetting;
+  BOOLEAN                       Found;
+  BOOLEAN                       Streams;
+  UINT32                        Result;
+  EFI_STATUS                    Status;
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &ConfigDesc);
+  if (EFI_ERROR (Status) || (ConfigDesc.TotalLength < sizeof (ConfigDesc))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Buffer = AllocateZeroPool (ConfigDesc.TotalLength);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Request.RequestType = USB_DEV_GET_DESCRIPTOR_REQ_TYPE;
+  Request.Request     = USB_REQ_GET_DESCRIPTOR;
+  Request.Value       = (UINT16)((USB_DESC_TYPE_CONFIG << 8) | (ConfigDesc.ConfigurationValue - 1));
+  Request.Index       = 0;
+  Request.Length      = ConfigDesc.TotalLength;
+
+  Status = UsbIo->UsbControlTransfer (
+                    UsbIo,
+                    &Request,
+                    EfiUsbDataIn,
+                    USB_UAS_SEND_IU_TIMEOUT / USB_MASS_1_MILLISECOND,
+                    Buffer,
+                    ConfigDesc.TotalLength,
+                    &Result
+                    );
+  if (EFI_ERROR (Status)) {
+    FreePool (Buffer);
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Walk the descriptors of the UAS alternate setting. Each bulk endpoint
+  // is followed by its class specific descriptors: the SuperSpeed Endpoint
+  // Companion if the device runs at SuperSpeed, then the Pipe Usage.
+  //
+  Found        = FALSE;
+  Streams      = FALSE;
+  InUasSetting = FALSE;
+  EpAddress    = 0;
+  Offset       = 0;
+  while (Offset + 2 <= ConfigDesc.TotalLength) {
+    Length = Buffer[Offset];
+    Type   = Buffer[Offset + 1];
+    if ((Length < 2) || (Offset + Length > ConfigDesc.TotalLength)) {
+      break;
+    }
+
+    if (Type == USB_DESC_TYPE_INTERFACE) {
+      if (InUasSetting) {
+        break;
+      }
+
+      IfDesc = (EFI_USB_INTERFACE_DESCRIPTOR *)(Buffer + Offset);
+      if ((Length >= sizeof (EFI_USB_INTERFACE_DESCRIPTOR)) &&
+          (IfDesc->InterfaceNumber == UsbUas->Interface.InterfaceNumber) &&
+          (IfDesc->InterfaceClass == USB_MASS_STORE_CLASS) &&
+          (IfDesc->InterfaceProtocol == USB_MASS_STORE_UAS))
+      {
+        InUasSetting       = TRUE;
+        UsbUas->AltSetting = IfDesc->AlternateSetting;
+      }
+    } else if (InUasSetting) {
+      if (Type == USB_DESC_TYPE_ENDPOINT) {
+        EpDesc    = (EFI_USB_ENDPOINT_DESCRIPTOR *)(Buffer + Offset);
+        EpAddress = 0;
+        if ((Length >= sizeof (EFI_USB_ENDPOINT_DESCRIPTOR)) && USB_IS_BULK_ENDPOINT (EpDesc->Attributes)) {
+          EpAddress = EpDesc->EndpointAddress;
+        }
+      } else if (Type == USB_UAS_DESC_TYPE_SS_COMPANION) {
+        //
+        // The bulk endpoints of a SuperSpeed UAS interface require streams.
+        //
+        DEBUG ((DEBUG_INFO, "UsbUasFindAltSetting: SuperSpeed UAS needs bulk streams\n"));
+        Streams = TRUE;
+        break;
+      } else if ((Type == USB_UAS_DESC_TYPE_PIPE_USAGE) && (Length >= 3) && (EpAddress != 0)) {
+        switch (Buffer[Offset + 2]) {
+          case USB_UAS_PIPE_COMMAND:
+            UsbUas->CommandEndpoint = EpAddress;
+            break;
+          case USB_UAS_PIPE_STATUS:
+            UsbUas->StatusEndpoint = EpAddress;
+            break;
+          case USB_UAS_PIPE_DATA_IN:
+            UsbUas->DataInEndpoint = EpAddress;
+            break;
+          case USB_UAS_PIPE_DATA_OUT:
+            UsbUas->DataOutEndpoint = EpAddress;
+            break;
+          default:
+            break;
+        }
+      }
+
+      if ((UsbUas->CommandEndpoint != 0) && (UsbUas->StatusEndpoint != 0) &&
+          (UsbUas->DataInEndpoint != 0) && (UsbUas->DataOutEndpoint != 0))
+      {
+        Found = TRUE;
+      }
+    }
+
+    Offset += Length;
+  }
+
+  FreePool (Buffer);
+
+  if (!Found || Streams) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks up the alternate setting of the USB mass storage
+  interface which implements the USB Attached SCSI protocol. If Context
+  is not NULL, the alternate setting is selected and the UAS protocol
+  context is returned. Otherwise it only checks whether UAS is supported.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is supported and protocol initialized.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+  @retval EFI_OUT_OF_RESOURCES  The memory allocation failed.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT VOID                 **Context OPTIONAL
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+  EFI_STATUS        Status;
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_PROTOCOL));
+  if (UsbUas == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+  if (EFI_ERROR (Status) || (UsbUas->Interface.InterfaceClass != USB_MASS_STORE_CLASS)) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  Status = UsbUasFindAltSetting (UsbIo, UsbUas);
+  if (EFI_ERROR (Status) || (Context == NULL)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Switch the interface to the UAS alternate setting. The USB bus driver
+  // tracks the selected setting, so the interface descriptor is read again.
+  //
+  if (UsbUas->Interface.AlternateSetting != UsbUas->AltSetting) {
+    Status = UsbUasSetInterface (UsbIo, UsbUas->Interface.InterfaceNumber, UsbUas->AltSetting);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasInit: Failed to select the UAS setting (%r)\n", Status));
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+
+    Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+    if (EFI_ERROR (Status) || (UsbUas->Interface.InterfaceProtocol != USB_MASS_STORE_UAS)) {
+      UsbUasSetInterface (UsbIo, UsbUas->Interface.InterfaceNumber, 0);
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+  }
+
+  UsbUas->UsbIo = UsbIo;
+  UsbUas->Tag   = 0x01;
+  *Context      = UsbUas;
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  FreePool (UsbUas);
+  return Status;
+}
+
+/**
+  Fill the 8 bytes LUN field of an IU from the logic unit number.
+
+  @param  Lun                   The number of logic unit
+  @param  LunField              The LUN field of the IU
+
+**/
+VOID
+UsbUasSetLun (
+  IN  UINT8  Lun,
+  OUT UINT8  *LunField
+  )
+{
+  ZeroMem (LunField, 8);
+  LunField[1] = Lun;
+}
+
+/**
+  Issue a bulk transfer on one of the UAS pipes, and clear the endpoint
+  stall condition if the transfer fails with a stall.
+
+  @param  UsbUas                The USB UAS device
+  @param  Endpoint              The endpoint address of the pipe
+  @param  Data                  The buffer to transfer
+  @param  Length                On input, the length of the buffer. On output,
+                                the length actually transferred.
+  @param  Timeout               The time to wait the transfer to complete
+
+  @retval EFI_SUCCESS           The data is transferred
+  @retval Others                Failed to transfer data
+
+**/
+EFI_STATUS
+UsbUasBulkTransfer (
+  IN     USB_UAS_PROTOCOL  *UsbUas,
+  IN     UINT8             Endpoint,
+  IN OUT VOID              *Data,
+  IN OUT UINTN             *Length,
+  IN     UINT32            Timeout
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Result;
+
+  Result = 0;
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            Endpoint,
+                            Data,
+                            Length,
+                            Timeout / USB_MASS_1_MILLISECOND,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "UsbUasBulkTransfer: Endpoint 0x%x (%r) Result=0x%x\n", Endpoint, Status, Result));
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbUas->UsbIo, Endpoint);
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Receive the next IU of the current tag from the status pipe.
+
+  @param  UsbUas                The USB UAS device
+  @param  Timeout               The time to wait the IU
+
+  @retval EFI_SUCCESS           The IU is received in UsbUas->StatusBuffer.
+  @retval EFI_DEVICE_ERROR      The device returned an unexpected IU.
+  @retval Others                Failed to receive the IU.
+
+**/
+EFI_STATUS
+UsbUasGetStatus (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT32            Timeout
+  )
+{
+  USB_UAS_IU_HEADER  *Header;
+  UINTN              Len;
+  EFI_STATUS         Status;
+
+  Len    = sizeof (UsbUas->StatusBuffer);
+  Status = UsbUasBulkTransfer (UsbUas, UsbUas->StatusEndpoint, UsbUas->StatusBuffer, &Len, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Header = (USB_UAS_IU_HEADER *)UsbUas->StatusBuffer;
+  if ((Len < sizeof (USB_UAS_IU_HEADER)) ||
+      (((Header->Tag[0] << 8) | Header->Tag[1]) != UsbUas->Tag))
+  {
+    DEBUG ((DEBUG_ERROR, "UsbUasGetStatus: Unexpected IU of %d bytes\n", Len));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (((Header->IuId == USB_UAS_IU_SENSE) && (Len < sizeof (USB_UAS_SENSE_IU))) ||
+      ((Header->IuId == USB_UAS_IU_RESPONSE) && (Len < sizeof (USB_UAS_RESPONSE_IU))))
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Move to the next tag of the UAS protocol.
+
+  @param  UsbUas                The USB UAS device
+
+**/
+VOID
+UsbUasNextTag (
+  IN USB_UAS_PROTOCOL  *UsbUas
+  )
+{
+  UsbUas->Tag++;
+  if (UsbUas->Tag == 0) {
+    UsbUas->Tag = 0x01;
+  }
+}
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue
+  the command/data/status circle to execute the commands.
+
+  The sense data the device returns in the Sense IU of a failed command
+  is kept, and handed out for the REQUEST SENSE command the boot layer
+  issues next. The device has discarded the sense data already once it
+  reported it.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  )
+{
+  USB_UAS_PROTOCOL    *UsbUas;
+  USB_UAS_COMMAND_IU  CmdIu;
+  USB_UAS_SENSE_IU    *SenseIu;
+  UINT8               IuId;
+  UINTN               Len;
+  UINTN               SenseLen;
+  EFI_STATUS          Status;
+
+  *CmdStatus = USB_MASS_CMD_FAIL;
+  UsbUas     = (USB_UAS_PROTOCOL *)Context;
+
+  if ((CmdLen == 0) || (CmdLen > USB_UAS_MAX_CDB_LEN)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Serve REQUEST SENSE from the sense data of the previous command.
+  //
+  if ((((UINT8 *)Cmd)[0] == USB_BOOT_REQUEST_SENSE_OPCODE) && UsbUas->SenseValid &&
+      (DataDir == EfiUsbDataIn))
+  {
+    UsbUas->SenseValid = FALSE;
+    CopyMem (Data, UsbUas->SenseData, MIN (DataLen, UsbUas->SenseLength));
+    *CmdStatus = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  UsbUas->SenseValid = FALSE;
+
+  //
+  // Send the Command IU to the device through the command pipe.
+  //
+  ZeroMem (&CmdIu, sizeof (CmdIu));
+  CmdIu.IuId          = USB_UAS_IU_COMMAND;
+  CmdIu.Tag[0]        = (UINT8)(UsbUas->Tag >> 8);
+  CmdIu.Tag[1]        = (UINT8)UsbUas->Tag;
+  CmdIu.TaskAttribute = USB_UAS_TASK_SIMPLE;
+  UsbUasSetLun (Lun, CmdIu.Lun);
+  CopyMem (CmdIu.Cdb, Cmd, CmdLen);
+
+  Len    = sizeof (CmdIu);
+  Status = UsbUasBulkTransfer (UsbUas, UsbUas->CommandEndpoint, &CmdIu, &Len, USB_UAS_SEND_IU_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Send Command IU (%r)\n", Status));
+    goto ON_EXIT;
+  }
+
+  //
+  // The device announces the data phase by a Read Ready or Write Ready IU,
+  // or concludes the command by a Sense IU directly.
+  //
+  Status = UsbUasGetStatus (UsbUas, Timeout);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Receive IU (%r)\n", Status));
+    goto ON_EXIT;
+  }
+
+  IuId = ((USB_UAS_IU_HEADER *)UsbUas->StatusBuffer)->IuId;
+  if ((IuId == USB_UAS_IU_READ_READY) || (IuId == USB_UAS_IU_WRITE_READY)) {
+    if ((DataLen == 0) ||
+        ((IuId == USB_UAS_IU_READ_READY) && (DataDir != EfiUsbDataIn)) ||
+        ((IuId == USB_UAS_IU_WRITE_READY) && (DataDir != EfiUsbDataOut)))
+    {
+      Status = EFI_DEVICE_ERROR;
+      goto ON_EXIT;
+    }
+
+    //
+    // Transfer the data. Don't return immediately even data transfer
+    // failed, the device concludes the command with a Sense IU anyway.
+    //
+    Len = (UINTN)DataLen;
+    UsbUasBulkTransfer (
+      UsbUas,
+      (DataDir == EfiUsbDataIn) ? UsbUas->DataInEndpoint : UsbUas->DataOutEndpoint,
+      Data,
+      &Len,
+      Timeout
+      );
+
+    Status = UsbUasGetStatus (UsbUas, USB_UAS_RECV_STATUS_TIMEOUT);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Receive Sense IU (%r)\n", Status));
+      goto ON_EXIT;
+    }
+
+    IuId = ((USB_UAS_IU_HEADER *)UsbUas->StatusBuffer)->IuId;
+  }
+
+  if (IuId != USB_UAS_IU_SENSE) {
+    DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Unexpected IU 0x%x\n", IuId));
+    Status = EFI_DEVICE_ERROR;
+    goto ON_EXIT;
+  }
+
+  SenseIu = (USB_UAS_SENSE_IU *)UsbUas->StatusBuffer;
+  if (SenseIu->Status == USB_UAS_STATUS_GOOD) {
+    *CmdStatus = USB_MASS_CMD_SUCCESS;
+  } else {
+    SenseLen = (SenseIu->Length[0] << 8) | SenseIu->Length[1];
+    SenseLen = MIN (SenseLen, sizeof (UsbUas->StatusBuffer) - sizeof (USB_UAS_SENSE_IU));
+    SenseLen = MIN (SenseLen, sizeof (UsbUas->SenseData));
+    if (SenseLen != 0) {
+      CopyMem (UsbUas->SenseData, SenseIu + 1, SenseLen);
+      UsbUas->SenseLength = (UINT8)SenseLen;
+      UsbUas->SenseValid  = TRUE;
+    }
+  }
+
+ON_EXIT:
+  //
+  // The tag is increased even if there is an error.
+  //
+  UsbUasNextTag (UsbUas);
+
+  if (Status == EFI_TIMEOUT) {
+    UsbUasResetDevice (UsbUas, FALSE);
+  }
+
+  return Status;
+}
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue LOGICAL UNIT RESET task management function.
+                                If TRUE, reset parent hub port instead.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  )
+{
+  USB_UAS_PROTOCOL      *UsbUas;
+  USB_UAS_TASK_MGMT_IU  TmIu;
+  USB_UAS_RESPONSE_IU   *ResponseIu;
+  UINTN                 Len;
+  EFI_STATUS            Status;
+
+  UsbUas             = (USB_UAS_PROTOCOL *)Context;
+  UsbUas->SenseValid = FALSE;
+
+  if (ExtendedVerification) {
+    //
+    // The port reset restores the default alternate setting, select
+    // the UAS setting again.
+    //
+    Status = UsbUas->UsbIo->UsbPortReset (UsbUas->UsbIo);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    return UsbUasSetInterface (UsbUas->UsbIo, UsbUas->Interface.InterfaceNumber, UsbUas->AltSetting);
+  }
+
+  ZeroMem (&TmIu, sizeof (TmIu));
+  TmIu.IuId     = USB_UAS_IU_TASK_MGMT;
+  TmIu.Tag[0]   = (UINT8)(UsbUas->Tag >> 8);
+  TmIu.Tag[1]   = (UINT8)UsbUas->Tag;
+  TmIu.Function = USB_UAS_TMF_LUN_RESET;
+  UsbUasSetLun (0, TmIu.Lun);
+
+  Len    = sizeof (TmIu);
+  Status = UsbUasBulkTransfer (UsbUas, UsbUas->CommandEndpoint, &TmIu, &Len, USB_UAS_SEND_IU_TIMEOUT);
+  if (!EFI_ERROR (Status)) {
+    Status = UsbUasGetStatus (UsbUas, USB_UAS_RESET_DEVICE_TIMEOUT);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    ResponseIu = (USB_UAS_RESPONSE_IU *)UsbUas->StatusBuffer;
+    if ((ResponseIu->Header.IuId != USB_UAS_IU_RESPONSE) ||
+        ((ResponseIu->ResponseCode != USB_UAS_RESPONSE_TMF_COMPLETE) &&
+         (ResponseIu->ResponseCode != USB_UAS_RESPONSE_TMF_SUCCEEDED)))
+    {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  UsbUasNextTag (UsbUas);
+
+  //
+  // Clear the stall on all the pipes, they may be halted by the aborted command.
+  //
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataInEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataOutEndpoint);
+
+  return Status;
+}
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  The UAS transport drives the logic unit 0 only.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN. (e.g. MaxLun=1 means LUN0 and
+                           LUN1 in all.)
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  )
+{
+  *MaxLun = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  The interface is switched back to the default alternate setting.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+  UsbUasSetInterface (UsbUas->UsbIo, UsbUas->Interface.InterfaceNumber, 0);
+
+  FreePool (UsbUas);
+  return EFI_SUCCESS;
+}
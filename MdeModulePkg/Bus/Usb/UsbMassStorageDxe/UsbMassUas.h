@@ -0,0 +1,254 @@
+/** @file
+  Definition for the USB Attached SCSI protocol, based on the "Universal
+  Serial Bus Mass Storage Class - USB Attached SCSI Protocol (UASP)"
+  Revision 1.0, June 24, 2009.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_USBMASS_UAS_H_
+#define _EFI_USBMASS_UAS_H_
+
+extern USB_MASS_TRANSPORT  mUsbUasTransport;
+
+//
+// Class specific descriptors of the UAS interface
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE    0x24  ///< Pipe Usage descriptor
+#define USB_UAS_DESC_TYPE_SS_COMPANION  0x30  ///< SuperSpeed Endpoint Companion descriptor
+
+//
+// Pipe ID carried in the Pipe Usage descriptor
+//
+#define USB_UAS_PIPE_COMMAND   0x01
+#define USB_UAS_PIPE_STATUS    0x02
+#define USB_UAS_PIPE_DATA_IN   0x03
+#define USB_UAS_PIPE_DATA_OUT  0x04
+
+//
+// Information Unit ID
+//
+#define USB_UAS_IU_COMMAND      0x01
+#define USB_UAS_IU_SENSE        0x03
+#define USB_UAS_IU_RESPONSE     0x04
+#define USB_UAS_IU_TASK_MGMT    0x05
+#define USB_UAS_IU_READ_READY   0x06
+#define USB_UAS_IU_WRITE_READY  0x07
+
+//
+// Task attribute of the Command IU and task management function of the
+// Task Management IU
+//
+#define USB_UAS_TASK_SIMPLE    0x00
+#define USB_UAS_TMF_LUN_RESET  0x08
+
+//
+// Response code of the Response IU
+//
+#define USB_UAS_RESPONSE_TMF_COMPLETE   0x00
+#define USB_UAS_RESPONSE_TMF_SUCCEEDED  0x08
+
+//
+// SCSI status of the Sense IU
+//
+#define USB_UAS_STATUS_GOOD  0x00
+
+#define USB_UAS_MAX_CDB_LEN  16
+
+//
+// The status pipe is read a full high-speed bulk packet at a time, so that
+// a Sense IU carrying more sense data than expected doesn't overflow.
+//
+#define USB_UAS_STATUS_BUFFER_LEN  512
+
+//
+// Usb UAS transport timeout, set by experience
+//
+#define USB_UAS_SEND_IU_TIMEOUT       (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RECV_STATUS_TIMEOUT   (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
+
+#pragma pack(1)
+///
+/// The Command IU used by the USB UAS protocol. The tag is big-endian.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved;
+  UINT8    Tag[2];
+  UINT8    TaskAttribute;       ///< Bits 0~2 are used
+  UINT8    Reserved2;
+  UINT8    AddCdbLen;           ///< Bits 2~7 are used
+  UINT8    Reserved3;
+  UINT8    Lun[8];
+  UINT8    Cdb[USB_UAS_MAX_CDB_LEN];
+} USB_UAS_COMMAND_IU;
+
+///
+/// The Task Management IU used by the USB UAS protocol.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved;
+  UINT8    Tag[2];
+  UINT8    Function;
+  UINT8    Reserved2;
+  UINT8    ManagedTag[2];
+  UINT8    Lun[8];
+} USB_UAS_TASK_MGMT_IU;
+
+///
+/// The common header of the IUs received from the status pipe.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved;
+  UINT8    Tag[2];
+} USB_UAS_IU_HEADER;
+
+///
+/// The Sense IU which concludes a command. The sense data follows it.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                StatusQualifier[2];
+  UINT8                Status;
+  UINT8                Reserved[7];
+  UINT8                Length[2];      ///< Length of the sense data
+} USB_UAS_SENSE_IU;
+
+///
+/// The Response IU which concludes a task management function.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                AddResponseInfo[3];
+  UINT8                ResponseCode;
+} USB_UAS_RESPONSE_IU;
+#pragma pack()
+
+typedef struct {
+  //
+  // Put Interface at the first field to make it easy to distinguish BOT/CBI/UAS Protocol instance
+  //
+  EFI_USB_INTERFACE_DESCRIPTOR    Interface;
+  EFI_USB_IO_PROTOCOL             *UsbIo;
+  UINT8                           AltSetting;
+  UINT8                           CommandEndpoint;
+  UINT8                           StatusEndpoint;
+  UINT8                           DataInEndpoint;
+  UINT8                           DataOutEndpoint;
+  UINT16                          Tag;
+  //
+  // The sense data returned by the Sense IU of the last failed command,
+  // handed out for the REQUEST SENSE issued next by the boot layer.
+  //
+  BOOLEAN                         SenseValid;
+  UINT8                           SenseLength;
+  UINT8                           SenseData[sizeof (USB_BOOT_REQUEST_SENSE_DATA)];
+  UINT8                           StatusBuffer[USB_UAS_STATUS_BUFFER_LEN];
+} USB_UAS_PROTOCOL;
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks up the alternate setting of the USB mass storage
+  interface which implements the USB Attached SCSI protocol. If Context
+  is not NULL, the alternate setting is selected and the UAS protocol
+  context is returned. Otherwise it only checks whether UAS is supported.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is supported and protocol initialized.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+  @retval EFI_OUT_OF_RESOURCES  The memory allocation failed.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT VOID                 **Context OPTIONAL
+  );
+
+/**
+  Call the USB Mass Storage Class UAS protocol to issue
+  the command/data/status circle to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  );
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue LOGICAL UNIT RESET task management function.
+                                If TRUE, reset parent hub port instead.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  );
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN. (e.g. MaxLun=1 means LUN0 and
+                           LUN1 in all.)
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  );
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  );
+
+#endif
@@ -392,6 +392,20 @@ UsbNcmDriverStart (
 
   UsbEthDriver->BulkBuffer = AllocateZeroPool (USB_NCM_MAX_NTB_SIZE);
 
+  Status = UsbNcmInitTransmit (UsbEthDriver);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseProtocol (
+           ControllerHandle,
+           &gEfiUsbIoProtocolGuid,
+           This->DriverBindingHandle,
+           ControllerHandle
+           );
+    FreePool (UsbEthDriver->BulkBuffer);
+    FreePool (UsbEthDriver->Config);
+    FreePool (UsbEthDriver);
+    return Status;
+  }
+
   Status = gBS->InstallProtocolInterface (
                   &ControllerHandle,
                   &gEdkIIUsbEthProtocolGuid,
@@ -405,6 +419,8 @@ UsbNcmDriverStart (
            This->DriverBindingHandle,
            ControllerHandle
            );
+    gBS->CloseEvent (UsbEthDriver->TxFlushEvent);
+    FreePool (UsbEthDriver->TxBuffer);
     FreePool (UsbEthDriver);
     return Status;
   }
@@ -467,6 +483,8 @@ UsbNcmDriverStop (
                   This->DriverBindingHandle,
                   ControllerHandle
                   );
+  gBS->CloseEvent (UsbEthDriver->TxFlushEvent);
+  FreePool (UsbEthDriver->TxBuffer);
   FreePool (UsbEthDriver->Config);
   FreePool (UsbEthDriver->BulkBuffer);
   FreePool (UsbEthDriver);
@@ -31,9 +31,26 @@ typedef struct {
   UINT8                          InterruptEndpoint;
   EFI_MAC_ADDRESS                MacAddress;
   UINT16                         BulkOutSequence;
+  UINT16                         BulkOutMaxPacket;
   UINT8                          *BulkBuffer;
-  UINT8                          TotalDatagram;
-  UINT8                          NowDatagram;
+  //
+  // The NTB being received, see UsbEthNcmReceive().
+  //
+  UINT16                         RxBlockLength;
+  UINT16                         RxNdpIndex;
+  UINT16                         RxDatagram;
+  //
+  // The NTB being aggregated, see UsbEthNcmTransmit().
+  //
+  UINT8                          *TxBuffer;
+  UINT16                         TxNtbMaxSize;
+  UINT16                         TxNdpIndex;
+  UINT16                         TxNdpDivisor;
+  UINT16                         TxNdpRemainder;
+  UINT16                         TxMaxDatagrams;
+  UINT16                         TxLength;
+  UINT16                         TxDatagrams;
+  EFI_EVENT                      TxFlushEvent;
 } USB_ETHERNET_DRIVER;
 
 #define USB_NCM_DRIVER_VERSION         1
@@ -49,6 +66,40 @@ typedef struct {
 #define USB_NCM_NTH_LENGTH       0x000C
 #define USB_NCM_NDP_LENGTH       0x0010// at least 16
 
+// Defined in USB NCM 1.0 spec., section 6.2.1
+#define GET_NTB_PARAMETERS_REQ  0x80
+
+//
+// Limits of the NTBs built by UsbEthNcmTransmit(). The device may lower them
+// in its NTB parameters.
+//
+#define USB_NCM_TX_MAX_DATAGRAMS  32
+#define USB_NCM_TX_NTB_SIZE       0x4000
+
+//
+// Time a datagram may wait in the NTB being aggregated before the NTB is sent,
+// in 100ns units.
+//
+#define USB_NCM_TX_FLUSH_DELAY  10000
+
+#pragma pack(1)
+// USB NCM NTB parameter structure, defined in USB NCM 1.0 spec., section 6.2.1
+typedef struct {
+  UINT16    Length;
+  UINT16    NtbFormatsSupported;
+  UINT32    NtbInMaxSize;
+  UINT16    NdpInDivisor;
+  UINT16    NdpInPayloadRemainder;
+  UINT16    NdpInAlignment;
+  UINT16    Reserved;
+  UINT32    NtbOutMaxSize;
+  UINT16    NdpOutDivisor;
+  UINT16    NdpOutPayloadRemainder;
+  UINT16    NdpOutAlignment;
+  UINT16    NtbOutMaxDatagrams;
+} USB_NCM_NTB_PARAMETERS;
+#pragma pack()
+
 // USB NCM Transfer header structure - UINT16
 typedef struct {
   UINT32    Signature;
@@ -131,6 +182,23 @@ GetEndpoint (
   IN OUT  USB_ETHERNET_DRIVER  *UsbEthDriver
   );
 
+EFI_STATUS
+UsbNcmInitTransmit (
+  IN OUT  USB_ETHERNET_DRIVER  *UsbEthDriver
+  );
+
+EFI_STATUS
+UsbNcmFlushTransmit (
+  IN OUT  USB_ETHERNET_DRIVER  *UsbEthDriver
+  );
+
+VOID
+EFIAPI
+UsbNcmFlushTransmitNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 EFI_STATUS
 EFIAPI
 UsbEthNcmReceive (
@@ -185,7 +185,8 @@ GetEndpoint (
         if (Endpoint.EndpointAddress & BIT7) {
           UsbEthDriver->BulkInEndpoint = Endpoint.EndpointAddress;
         } else {
-          UsbEthDriver->BulkOutEndpoint = Endpoint.EndpointAddress;
+          UsbEthDriver->BulkOutEndpoint  = Endpoint.EndpointAddress;
+          UsbEthDriver->BulkOutMaxPacket = Endpoint.MaxPacketSize;
         }
 
         break;
@@ -197,127 +198,315 @@ GetEndpoint (
 }
 
 /**
-  This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk in.
+  Return the first offset from a given offset where a transmitted datagram can
+  start, as required by the NTB parameters of the device.
 
-  @param[in]      Cdb           A pointer to the command descriptor block.
-  @param[in]      This          A pointer to the EDKII_USB_ETHERNET_PROTOCOL instance.
-  @param[in, out] Packet        A pointer to the buffer of data that will be transmitted to USB
-                                device or received from USB device.
-  @param[in, out] PacketLength  A pointer to the PacketLength.
+  @param[in]  UsbEthDriver  A pointer to the USB_ETHERNET_DRIVER instance.
+  @param[in]  Offset        The offset in the transmit NTB.
 
-  @retval EFI_SUCCESS           The bulk transfer has been successfully executed.
-  @retval EFI_DEVICE_ERROR      The transfer failed. The transfer status is returned in status.
-  @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
-  @retval EFI_OUT_OF_RESOURCES  The request could not be submitted due to a lack of resources.
-  @retval EFI_TIMEOUT           The control transfer fails due to timeout.
+  @return The offset of the datagram.
+
+**/
+STATIC
+UINTN
+UsbNcmTxDatagramOffset (
+  IN  USB_ETHERNET_DRIVER  *UsbEthDriver,
+  IN  UINTN                Offset
+  )
+{
+  return Offset + (UsbEthDriver->TxNdpRemainder + UsbEthDriver->TxNdpDivisor -
+                   Offset % UsbEthDriver->TxNdpDivisor) % UsbEthDriver->TxNdpDivisor;
+}
+
+/**
+  Prepare the aggregation of the transmitted datagrams into NTBs, from the NTB
+  parameters of the device.
+
+  A device that does not report its NTB parameters gets one datagram per NTB.
+
+  @param[in, out] UsbEthDriver  A pointer to the USB_ETHERNET_DRIVER instance.
+
+  @retval EFI_SUCCESS           The transmit NTB is ready.
+  @retval EFI_OUT_OF_RESOURCES  The transmit NTB could not be allocated.
+  @retval other                 The flush timer could not be created.
 
 **/
 EFI_STATUS
-EFIAPI
-UsbEthNcmReceive (
-  IN     PXE_CDB                      *Cdb,
-  IN     EDKII_USB_ETHERNET_PROTOCOL  *This,
-  IN OUT VOID                         *Packet,
-  IN OUT UINTN                        *PacketLength
+UsbNcmInitTransmit (
+  IN OUT  USB_ETHERNET_DRIVER  *UsbEthDriver
+  )
+{
+  EFI_STATUS              Status;
+  EFI_USB_DEVICE_REQUEST  Request;
+  UINT32                  TransStatus;
+  USB_NCM_NTB_PARAMETERS  Parameters;
+
+  ZeroMem (&Parameters, sizeof (USB_NCM_NTB_PARAMETERS));
+
+  Request.RequestType = USB_ETHERNET_GET_REQ_TYPE;
+  Request.Request     = GET_NTB_PARAMETERS_REQ;
+  Request.Value       = 0;
+  Request.Index       = UsbEthDriver->NumOfInterface;
+  Request.Length      = sizeof (USB_NCM_NTB_PARAMETERS);
+
+  Status = UsbEthDriver->UsbIo->UsbControlTransfer (
+                                  UsbEthDriver->UsbIo,
+                                  &Request,
+                                  EfiUsbDataIn,
+                                  USB_ETHERNET_TRANSFER_TIMEOUT,
+                                  &Parameters,
+                                  sizeof (USB_NCM_NTB_PARAMETERS),
+                                  &TransStatus
+                                  );
+  if (EFI_ERROR (Status) ||
+      (Parameters.NtbOutMaxSize < USB_NCM_NTH_LENGTH + USB_NCM_NDP_LENGTH + USB_ETHERNET_FRAME_SIZE))
+  {
+    DEBUG ((DEBUG_WARN, "%a: No NTB parameters (%r), one datagram per NTB\n", __func__, Status));
+    UsbEthDriver->TxNtbMaxSize   = USB_NCM_NTH_LENGTH + USB_NCM_NDP_LENGTH + USB_ETHERNET_FRAME_SIZE;
+    UsbEthDriver->TxNdpIndex     = USB_NCM_NTH_LENGTH;
+    UsbEthDriver->TxNdpDivisor   = 4;
+    UsbEthDriver->TxNdpRemainder = 0;
+    UsbEthDriver->TxMaxDatagrams = 1;
+  } else {
+    UsbEthDriver->TxNtbMaxSize = (UINT16)MIN (Parameters.NtbOutMaxSize, USB_NCM_TX_NTB_SIZE);
+    UsbEthDriver->TxNdpIndex   = USB_NCM_NTH_LENGTH;
+    if ((Parameters.NdpOutAlignment > 4) && ((Parameters.NdpOutAlignment & (Parameters.NdpOutAlignment - 1)) == 0)) {
+      UsbEthDriver->TxNdpIndex = ALIGN_VALUE (USB_NCM_NTH_LENGTH, Parameters.NdpOutAlignment);
+    }
+
+    UsbEthDriver->TxNdpDivisor   = (Parameters.NdpOutDivisor != 0) ? Parameters.NdpOutDivisor : 4;
+    UsbEthDriver->TxNdpRemainder = Parameters.NdpOutPayloadRemainder % UsbEthDriver->TxNdpDivisor;
+    UsbEthDriver->TxMaxDatagrams = USB_NCM_TX_MAX_DATAGRAMS;
+    if (Parameters.NtbOutMaxDatagrams != 0) {
+      UsbEthDriver->TxMaxDatagrams = MIN (Parameters.NtbOutMaxDatagrams, USB_NCM_TX_MAX_DATAGRAMS);
+    }
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: NTB of %d bytes, up to %d datagrams\n",
+    __func__,
+    UsbEthDriver->TxNtbMaxSize,
+    UsbEthDriver->TxMaxDatagrams
+    ));
+
+  UsbEthDriver->TxLength    = 0;
+  UsbEthDriver->TxDatagrams = 0;
+  UsbEthDriver->TxBuffer    = AllocateZeroPool (UsbEthDriver->TxNtbMaxSize);
+  if (UsbEthDriver->TxBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  UsbNcmFlushTransmitNotify,
+                  UsbEthDriver,
+                  &UsbEthDriver->TxFlushEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (UsbEthDriver->TxBuffer);
+    UsbEthDriver->TxBuffer = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Send the NTB being aggregated, if it holds any datagram.
+
+  The caller must be at TPL_CALLBACK, which serializes the aggregation with
+  the flush timer.
+
+  @param[in, out] UsbEthDriver  A pointer to the USB_ETHERNET_DRIVER instance.
+
+  @retval EFI_SUCCESS           The NTB was sent, or there was nothing to send.
+  @retval other                 The bulk transfer failed, the datagrams of the
+                                NTB are dropped.
+
+**/
+EFI_STATUS
+UsbNcmFlushTransmit (
+  IN OUT  USB_ETHERNET_DRIVER  *UsbEthDriver
   )
 {
   EFI_STATUS                   Status;
-  USB_ETHERNET_DRIVER          *UsbEthDriver;
   EFI_USB_IO_PROTOCOL          *UsbIo;
   UINT32                       TransStatus;
-  UINT8                        Index;
-  UINTN                        BulkDataLength;
-  UINTN                        TotalLength;
   USB_NCM_TRANSFER_HEADER_16   *Nth;
   USB_NCM_DATAGRAM_POINTER_16  *Ndp;
-  USB_NCM_DATA_GRAM            *Datagram;
+  UINTN                        Length;
 
-  UsbEthDriver = USB_ETHERNET_DEV_FROM_THIS (This);
-  TotalLength  = 0;
+  if (UsbEthDriver->TxDatagrams == 0) {
+    return EFI_SUCCESS;
+  }
 
-  if (UsbEthDriver->TotalDatagram == UsbEthDriver->NowDatagram) {
-    Status = gBS->HandleProtocol (
-                    UsbEthDriver->UsbCdcDataHandle,
-                    &gEfiUsbIoProtocolGuid,
-                    (VOID **)&UsbIo
-                    );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+  gBS->SetTimer (UsbEthDriver->TxFlushEvent, TimerCancel, 0);
+
+  Length = UsbEthDriver->TxLength;
 
-    if (UsbEthDriver->BulkInEndpoint == 0) {
+  Status = gBS->HandleProtocol (
+                  UsbEthDriver->UsbCdcDataHandle,
+                  &gEfiUsbIoProtocolGuid,
+                  (VOID **)&UsbIo
+                  );
+  if (!EFI_ERROR (Status)) {
+    if (UsbEthDriver->BulkOutEndpoint == 0) {
       GetEndpoint (UsbIo, UsbEthDriver);
     }
 
-    BulkDataLength = USB_NCM_MAX_NTB_SIZE;
-    SetMem (UsbEthDriver->BulkBuffer, BulkDataLength, 0);
-    UsbEthDriver->NowDatagram   = 0;
-    UsbEthDriver->TotalDatagram = 0;
+    //
+    // An NTB shorter than dwNtbOutMaxSize must end with a short packet, pad it
+    // with the zero byte that follows the last datagram.
+    //
+    if ((UsbEthDriver->BulkOutMaxPacket != 0) &&
+        (Length % UsbEthDriver->BulkOutMaxPacket == 0) &&
+        (Length < UsbEthDriver->TxNtbMaxSize))
+    {
+      Length++;
+    }
+
+    Nth               = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->TxBuffer;
+    Nth->Signature    = USB_NCM_NTH_SIGN_16;
+    Nth->HeaderLength = USB_NCM_NTH_LENGTH;
+    Nth->Sequence     = UsbEthDriver->BulkOutSequence++;
+    Nth->BlockLength  = (UINT16)Length;
+    Nth->NdpIndex     = UsbEthDriver->TxNdpIndex;
+
+    //
+    // The datagram entry after the last one is still zero, it ends the table.
+    //
+    Ndp               = (USB_NCM_DATAGRAM_POINTER_16 *)(UsbEthDriver->TxBuffer + Nth->NdpIndex);
+    Ndp->Signature    = USB_NCM_NDP_SIGN_16;
+    Ndp->Length       = (UINT16)(sizeof (USB_NCM_DATAGRAM_POINTER_16) + (UsbEthDriver->TxDatagrams + 1) * sizeof (USB_NCM_DATA_GRAM));
+    Ndp->NextNdpIndex = 0x00;
 
     Status = UsbIo->UsbBulkTransfer (
                       UsbIo,
-                      UsbEthDriver->BulkInEndpoint,
-                      UsbEthDriver->BulkBuffer,
-                      &BulkDataLength,
-                      USB_ETHERNET_BULK_TIMEOUT,
+                      UsbEthDriver->BulkOutEndpoint,
+                      UsbEthDriver->TxBuffer,
+                      &Length,
+                      USB_ETHERNET_TRANSFER_TIMEOUT,
                       &TransStatus
                       );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %d datagrams dropped - %r\n", __func__, UsbEthDriver->TxDatagrams, Status));
+  }
+
+  ZeroMem (UsbEthDriver->TxBuffer, UsbEthDriver->TxLength);
+  UsbEthDriver->TxLength    = 0;
+  UsbEthDriver->TxDatagrams = 0;
+
+  return Status;
+}
 
-    Nth                         = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
-    Ndp                         = (USB_NCM_DATAGRAM_POINTER_16 *)((UINT8 *)UsbEthDriver->BulkBuffer + Nth->NdpIndex);
-    Datagram                    = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-    UsbEthDriver->TotalDatagram = (UINT8)((Ndp->Length - 8) / 4 - 1);
+/**
+  Timer notification that sends the NTB being aggregated once its first
+  datagram waited USB_NCM_TX_FLUSH_DELAY.
+
+  @param[in]  Event         The flush timer.
+  @param[in]  Context       A pointer to the USB_ETHERNET_DRIVER instance.
 
-    for (Index = 0; Index < UsbEthDriver->TotalDatagram; Index++) {
-      TotalLength += Datagram->DatagramLength;
-      Datagram     = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM));
+**/
+VOID
+EFIAPI
+UsbNcmFlushTransmitNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  UsbNcmFlushTransmit ((USB_ETHERNET_DRIVER *)Context);
+}
+
+/**
+  Copy the next datagram of the NTB being received, walking the datagram
+  tables of all its NDPs.
+
+  Malformed NDPs end the NTB, and datagrams that are out of the NTB or larger
+  than the caller buffer are skipped. The NDPs must be chained forward, which
+  also bounds the walk.
+
+  @param[in, out] UsbEthDriver  A pointer to the USB_ETHERNET_DRIVER instance.
+  @param[out]     Packet        A pointer to the buffer receiving the datagram.
+  @param[in, out] PacketLength  On input the size of Packet, on output the length
+                                of the datagram.
+
+  @retval EFI_SUCCESS           A datagram was copied.
+  @retval EFI_NOT_READY         There are no more datagrams in the NTB.
+
+**/
+STATIC
+EFI_STATUS
+UsbNcmNextDatagram (
+  IN OUT USB_ETHERNET_DRIVER  *UsbEthDriver,
+  OUT    VOID                 *Packet,
+  IN OUT UINTN                *PacketLength
+  )
+{
+  USB_NCM_DATAGRAM_POINTER_16  *Ndp;
+  USB_NCM_DATA_GRAM            *Datagram;
+  UINTN                        Count;
+
+  while (UsbEthDriver->RxNdpIndex != 0) {
+    if (((UsbEthDriver->RxNdpIndex & 0x3) != 0) ||
+        ((UINTN)UsbEthDriver->RxNdpIndex + USB_NCM_NDP_LENGTH > UsbEthDriver->RxBlockLength))
+    {
+      break;
     }
 
-    if (TotalLength < USB_ETHERNET_FRAME_SIZE) {
-      Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
+    Ndp = (USB_NCM_DATAGRAM_POINTER_16 *)(UsbEthDriver->BulkBuffer + UsbEthDriver->RxNdpIndex);
+    if (((Ndp->Signature != USB_NCM_NDP_SIGN_16) && (Ndp->Signature != USB_NCM_NDP_SIGN_16_CRC)) ||
+        (Ndp->Length < USB_NCM_NDP_LENGTH) ||
+        ((UINTN)UsbEthDriver->RxNdpIndex + Ndp->Length > UsbEthDriver->RxBlockLength))
+    {
+      break;
+    }
 
-      TotalLength = 0;
-      for (Index = 0; Index < UsbEthDriver->TotalDatagram; Index++) {
-        CopyMem ((UINT8 *)Packet + TotalLength, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
-        TotalLength += Datagram->DatagramLength;
-        Datagram     = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM));
+    Count = (Ndp->Length - sizeof (USB_NCM_DATAGRAM_POINTER_16)) / sizeof (USB_NCM_DATA_GRAM);
+    while (UsbEthDriver->RxDatagram < Count) {
+      Datagram = (USB_NCM_DATA_GRAM *)(Ndp + 1) + UsbEthDriver->RxDatagram;
+      if ((Datagram->DatagramIndex == 0) || (Datagram->DatagramLength == 0)) {
+        break;
       }
 
-      *PacketLength             = TotalLength;
-      UsbEthDriver->NowDatagram = UsbEthDriver->TotalDatagram;
-    } else {
-      UsbEthDriver->NowDatagram++;
+      UsbEthDriver->RxDatagram++;
+
+      if (((UINTN)Datagram->DatagramIndex + Datagram->DatagramLength > UsbEthDriver->RxBlockLength) ||
+          (Datagram->DatagramLength > *PacketLength))
+      {
+        DEBUG ((DEBUG_WARN, "%a: Bad datagram %d:%d skipped\n", __func__, Datagram->DatagramIndex, Datagram->DatagramLength));
+        continue;
+      }
 
-      Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-      CopyMem (Packet, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
+      CopyMem (Packet, UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
       *PacketLength = Datagram->DatagramLength;
+      return EFI_SUCCESS;
     }
 
-    return Status;
-  } else {
-    UsbEthDriver->NowDatagram++;
-
-    Nth      = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
-    Ndp      = (USB_NCM_DATAGRAM_POINTER_16 *)((UINT8 *)UsbEthDriver->BulkBuffer + Nth->NdpIndex);
-    Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-    Datagram = (USB_NCM_DATA_GRAM *)((UINT8 *)Datagram + sizeof (USB_NCM_DATA_GRAM) * (UsbEthDriver->NowDatagram - 1));
-
-    CopyMem (Packet, (UINT8 *)UsbEthDriver->BulkBuffer + Datagram->DatagramIndex, Datagram->DatagramLength);
-    *PacketLength = Datagram->DatagramLength;
+    if (Ndp->NextNdpIndex <= UsbEthDriver->RxNdpIndex) {
+      break;
+    }
 
-    return EFI_SUCCESS;
+    UsbEthDriver->RxNdpIndex = Ndp->NextNdpIndex;
+    UsbEthDriver->RxDatagram = 0;
   }
+
+  UsbEthDriver->RxNdpIndex = 0;
+  return EFI_NOT_READY;
 }
 
 /**
-  This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk out.
+  This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk in.
+
+  One NTB may carry many datagrams, they are returned one per call before the
+  next NTB is read. The NTB being aggregated for transmission is sent first, so
+  that the replies it asks for are not held back by the flush timer.
 
   @param[in]      Cdb           A pointer to the command descriptor block.
   @param[in]      This          A pointer to the EDKII_USB_ETHERNET_PROTOCOL instance.
-  @param[in]      Packet        A pointer to the buffer of data that will be transmitted to USB
+  @param[in, out] Packet        A pointer to the buffer of data that will be transmitted to USB
                                 device or received from USB device.
   @param[in, out] PacketLength  A pointer to the PacketLength.
 
@@ -326,29 +515,41 @@ UsbEthNcmReceive (
   @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
   @retval EFI_OUT_OF_RESOURCES  The request could not be submitted due to a lack of resources.
   @retval EFI_TIMEOUT           The control transfer fails due to timeout.
+  @retval EFI_NOT_READY         The NTB received holds no datagram.
 
 **/
 EFI_STATUS
 EFIAPI
-UsbEthNcmTransmit (
-  IN      PXE_CDB                      *Cdb,
-  IN      EDKII_USB_ETHERNET_PROTOCOL  *This,
-  IN      VOID                         *Packet,
-  IN OUT  UINTN                        *PacketLength
+UsbEthNcmReceive (
+  IN     PXE_CDB                      *Cdb,
+  IN     EDKII_USB_ETHERNET_PROTOCOL  *This,
+  IN OUT VOID                         *Packet,
+  IN OUT UINTN                        *PacketLength
   )
 {
-  EFI_STATUS                   Status;
-  USB_ETHERNET_DRIVER          *UsbEthDriver;
-  EFI_USB_IO_PROTOCOL          *UsbIo;
-  UINT32                       TransStatus;
-  USB_NCM_TRANSFER_HEADER_16   *Nth;
-  USB_NCM_DATAGRAM_POINTER_16  *Ndp;
-  USB_NCM_DATA_GRAM            *Datagram;
-  UINT8                        *TotalPacket;
-  UINTN                        TotalLength;
+  EFI_STATUS                  Status;
+  USB_ETHERNET_DRIVER         *UsbEthDriver;
+  EFI_USB_IO_PROTOCOL         *UsbIo;
+  UINT32                      TransStatus;
+  UINTN                       BulkDataLength;
+  USB_NCM_TRANSFER_HEADER_16  *Nth;
+  EFI_TPL                     OldTpl;
 
   UsbEthDriver = USB_ETHERNET_DEV_FROM_THIS (This);
 
+  if (UsbEthDriver->TxDatagrams != 0) {
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    UsbNcmFlushTransmit (UsbEthDriver);
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (UsbEthDriver->RxNdpIndex != 0) {
+    Status = UsbNcmNextDatagram (UsbEthDriver, Packet, PacketLength);
+    if (!EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   Status = gBS->HandleProtocol (
                   UsbEthDriver->UsbCdcDataHandle,
                   &gEfiUsbIoProtocolGuid,
@@ -358,48 +559,123 @@ UsbEthNcmTransmit (
     return Status;
   }
 
-  if (UsbEthDriver->BulkOutEndpoint == 0) {
+  if (UsbEthDriver->BulkInEndpoint == 0) {
     GetEndpoint (UsbIo, UsbEthDriver);
   }
 
-  TotalLength = (UINTN)(USB_NCM_NTH_LENGTH + USB_NCM_NDP_LENGTH + (*PacketLength));
+  BulkDataLength = USB_NCM_MAX_NTB_SIZE;
 
-  Status = gBS->AllocatePool (EfiBootServicesData, TotalLength, (VOID **)&TotalPacket);
+  Status = UsbIo->UsbBulkTransfer (
+                    UsbIo,
+                    UsbEthDriver->BulkInEndpoint,
+                    UsbEthDriver->BulkBuffer,
+                    &BulkDataLength,
+                    USB_ETHERNET_BULK_TIMEOUT,
+                    &TransStatus
+                    );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  SetMem (TotalPacket, TotalLength, 0);
+  Nth = (USB_NCM_TRANSFER_HEADER_16 *)UsbEthDriver->BulkBuffer;
+  if ((BulkDataLength < USB_NCM_NTH_LENGTH) ||
+      (Nth->Signature != USB_NCM_NTH_SIGN_16) ||
+      (Nth->BlockLength > BulkDataLength))
+  {
+    return EFI_NOT_READY;
+  }
+
+  //
+  // A zero block length means the NTB ends with the short packet.
+  //
+  UsbEthDriver->RxBlockLength = (Nth->BlockLength != 0) ? Nth->BlockLength : (UINT16)BulkDataLength;
+  UsbEthDriver->RxNdpIndex    = Nth->NdpIndex;
+  UsbEthDriver->RxDatagram    = 0;
 
-  Nth               = (USB_NCM_TRANSFER_HEADER_16 *)TotalPacket;
-  Nth->Signature    = USB_NCM_NTH_SIGN_16;
-  Nth->HeaderLength = USB_NCM_NTH_LENGTH;
-  Nth->Sequence     = UsbEthDriver->BulkOutSequence++;
-  Nth->BlockLength  = (UINT16)TotalLength;
-  Nth->NdpIndex     = Nth->HeaderLength;
+  return UsbNcmNextDatagram (UsbEthDriver, Packet, PacketLength);
+}
+
+/**
+  This function is used to manage a USB device with the bulk transfer pipe. The endpoint is Bulk out.
+
+  The datagram is added to the NTB being aggregated, which is sent once it is
+  full, when the next datagram is received, or USB_NCM_TX_FLUSH_DELAY after its
+  first datagram, whichever comes first.
+
+  @param[in]      Cdb           A pointer to the command descriptor block.
+  @param[in]      This          A pointer to the EDKII_USB_ETHERNET_PROTOCOL instance.
+  @param[in]      Packet        A pointer to the buffer of data that will be transmitted to USB
+                                device or received from USB device.
+  @param[in, out] PacketLength  A pointer to the PacketLength.
 
-  Ndp               = (USB_NCM_DATAGRAM_POINTER_16 *)((UINT8 *)TotalPacket + Nth->NdpIndex);
-  Ndp->Signature    = USB_NCM_NDP_SIGN_16;
-  Ndp->Length       = USB_NCM_NDP_LENGTH;
-  Ndp->NextNdpIndex = 0x00;
+  @retval EFI_SUCCESS           The bulk transfer has been successfully executed.
+  @retval EFI_DEVICE_ERROR      The transfer failed. The transfer status is returned in status.
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be submitted due to a lack of resources.
+  @retval EFI_TIMEOUT           The control transfer fails due to timeout.
 
-  Datagram                 = (USB_NCM_DATA_GRAM *)((UINT8 *)Ndp + sizeof (USB_NCM_DATAGRAM_POINTER_16));
-  Datagram->DatagramIndex  = Nth->HeaderLength + Ndp->Length;
+**/
+EFI_STATUS
+EFIAPI
+UsbEthNcmTransmit (
+  IN      PXE_CDB                      *Cdb,
+  IN      EDKII_USB_ETHERNET_PROTOCOL  *This,
+  IN      VOID                         *Packet,
+  IN OUT  UINTN                        *PacketLength
+  )
+{
+  EFI_STATUS                   Status;
+  USB_ETHERNET_DRIVER          *UsbEthDriver;
+  USB_NCM_DATAGRAM_POINTER_16  *Ndp;
+  USB_NCM_DATA_GRAM            *Datagram;
+  UINTN                        FirstOffset;
+  UINTN                        Offset;
+  EFI_TPL                      OldTpl;
+
+  UsbEthDriver = USB_ETHERNET_DEV_FROM_THIS (This);
+
+  FirstOffset = UsbNcmTxDatagramOffset (
+                  UsbEthDriver,
+                  UsbEthDriver->TxNdpIndex + sizeof (USB_NCM_DATAGRAM_POINTER_16) +
+                  (UsbEthDriver->TxMaxDatagrams + 1) * sizeof (USB_NCM_DATA_GRAM)
+                  );
+  if (FirstOffset + *PacketLength > UsbEthDriver->TxNtbMaxSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Offset = FirstOffset;
+  if (UsbEthDriver->TxDatagrams != 0) {
+    Offset = UsbNcmTxDatagramOffset (UsbEthDriver, UsbEthDriver->TxLength);
+    if (Offset + *PacketLength > UsbEthDriver->TxNtbMaxSize) {
+      Status = UsbNcmFlushTransmit (UsbEthDriver);
+      if (EFI_ERROR (Status)) {
+        gBS->RestoreTPL (OldTpl);
+        return Status;
+      }
+
+      Offset = FirstOffset;
+    }
+  }
+
+  Ndp                      = (USB_NCM_DATAGRAM_POINTER_16 *)(UsbEthDriver->TxBuffer + UsbEthDriver->TxNdpIndex);
+  Datagram                 = (USB_NCM_DATA_GRAM *)(Ndp + 1) + UsbEthDriver->TxDatagrams;
+  Datagram->DatagramIndex  = (UINT16)Offset;
   Datagram->DatagramLength = (UINT16)*PacketLength;
 
-  CopyMem (TotalPacket + Datagram->DatagramIndex, Packet, *PacketLength);
+  CopyMem (UsbEthDriver->TxBuffer + Offset, Packet, *PacketLength);
+  UsbEthDriver->TxLength = (UINT16)(Offset + *PacketLength);
+  UsbEthDriver->TxDatagrams++;
 
-  *PacketLength = TotalLength;
+  if (UsbEthDriver->TxDatagrams == UsbEthDriver->TxMaxDatagrams) {
+    Status = UsbNcmFlushTransmit (UsbEthDriver);
+  } else if (UsbEthDriver->TxDatagrams == 1) {
+    gBS->SetTimer (UsbEthDriver->TxFlushEvent, TimerRelative, USB_NCM_TX_FLUSH_DELAY);
+  }
 
-  Status = UsbIo->UsbBulkTransfer (
-                    UsbIo,
-                    UsbEthDriver->BulkOutEndpoint,
-                    TotalPacket,
-                    PacketLength,
-                    USB_ETHERNET_BULK_TIMEOUT,
-                    &TransStatus
-                    );
-  FreePool (TotalPacket);
+  gBS->RestoreTPL (OldTpl);
   return Status;
 }
 
@@ -431,3 +431,86 @@ CoreIsSchedulable (
 Done:
   return FALSE;
 }
+
+/**
+  Check whether the dependency expression of a driver needs to be evaluated
+  again. A dependency expression that evaluated to FALSE can only change its
+  result after an interface of one of the protocols it references has been
+  installed or removed.
+
+  @param  DriverEntry           DriverEntry element to check.
+
+  @retval TRUE                  The dependency expression must be evaluated.
+  @retval FALSE                 The dependency expression still evaluates to
+                                FALSE.
+
+**/
+BOOLEAN
+CoreIsDepexEvaluationNeeded (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8     *Iterator;
+  EFI_GUID  DriverGuid;
+
+  //
+  // A NULL Depex depends on the architectural protocols table rather than on
+  // the protocols it references, so it is always evaluated.
+  //
+  if (!DriverEntry->DepexEvaluated || (DriverEntry->Depex == NULL)) {
+    return TRUE;
+  }
+
+  //
+  // Nothing has been installed or removed since the last evaluation
+  //
+  if (CoreGetProtocolDatabaseChangeKey () == DriverEntry->DepexChangeKey) {
+    return FALSE;
+  }
+
+  Iterator = DriverEntry->Depex;
+  while (((UINTN)Iterator - (UINTN)DriverEntry->Depex) < DriverEntry->DepexSize) {
+    switch (*Iterator) {
+      case EFI_DEP_PUSH:
+        if (((UINTN)Iterator - (UINTN)DriverEntry->Depex) + sizeof (EFI_GUID) >= DriverEntry->DepexSize) {
+          return TRUE;
+        }
+
+        CopyMem (&DriverGuid, Iterator + 1, sizeof (EFI_GUID));
+        if (CoreGetProtocolChangeKey (&DriverGuid) > DriverEntry->DepexChangeKey) {
+          return TRUE;
+        }
+
+        Iterator += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_REPLACE_TRUE:
+        //
+        // A GUID that was found once is treated as TRUE from then on
+        //
+        Iterator += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_SOR:
+      case EFI_DEP_AND:
+      case EFI_DEP_OR:
+      case EFI_DEP_NOT:
+      case EFI_DEP_TRUE:
+      case EFI_DEP_FALSE:
+        break;
+
+      case EFI_DEP_END:
+        return FALSE;
+
+      default:
+        //
+        // Let CoreIsSchedulable() report malformed expressions
+        //
+        return TRUE;
+    }
+
+    Iterator++;
+  }
+
+  return TRUE;
+}
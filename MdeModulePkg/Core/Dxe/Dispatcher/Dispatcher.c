@@ -60,6 +60,22 @@ EFI_LOCK  mDispatcherLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 //
 BOOLEAN  gDispatcherRunning = FALSE;
 
+//
+// Number of dependency expression evaluations skipped because none of the
+// protocols they reference changed. Only maintained in DEBUG builds.
+//
+UINTN  mDepexEvaluationsSaved = 0;
+
+//
+// The dispatch order handed over by the platform, and the dispatch order
+// recorded in this boot. Only used when PcdDxeDispatchOrderCache is TRUE.
+//
+EDKII_DXE_DISPATCH_ORDER  *mDispatchOrderHint           = NULL;
+EDKII_DXE_DISPATCH_ORDER  *mDispatchOrderRecord         = NULL;
+UINTN                     mDispatchOrderRecordCapacity = 0;
+
+#define DISPATCH_ORDER_RECORD_INCREMENT  64
+
 //
 // Module globals to manage the FwVol registration notification event
 //
@@ -195,6 +211,81 @@ CoreProcessFvImageFile (
   IN  EFI_GUID                       *FileName
   );
 
+/**
+  Return the position of a driver in the dispatch order handed over by the
+  platform.
+
+  @param  FileName              The file name GUID of the driver.
+
+  @return The position of the driver, or MAX_UINTN if the driver is not part
+          of the recorded dispatch order.
+
+**/
+UINTN
+CoreGetDispatchRank (
+  IN EFI_GUID  *FileName
+  )
+{
+  EFI_GUID  *RecordedName;
+  UINTN     Index;
+
+  if (mDispatchOrderHint == NULL) {
+    return MAX_UINTN;
+  }
+
+  RecordedName = (EFI_GUID *)(mDispatchOrderHint + 1);
+  for (Index = 0; Index < mDispatchOrderHint->Count; Index++) {
+    if (CompareGuid (&RecordedName[Index], FileName)) {
+      return Index;
+    }
+  }
+
+  return MAX_UINTN;
+}
+
+/**
+  Append a driver to the dispatch order of this boot, and publish the updated
+  order in the configuration table.
+
+  @param  FileName              The file name GUID of the driver being started.
+
+**/
+VOID
+CoreRecordDispatchOrder (
+  IN EFI_GUID  *FileName
+  )
+{
+  EDKII_DXE_DISPATCH_ORDER  *NewRecord;
+  EDKII_DXE_DISPATCH_ORDER  *OldRecord;
+  UINTN                     NewCapacity;
+
+  OldRecord = mDispatchOrderRecord;
+  if ((OldRecord == NULL) || (OldRecord->Count == mDispatchOrderRecordCapacity)) {
+    NewCapacity = mDispatchOrderRecordCapacity + DISPATCH_ORDER_RECORD_INCREMENT;
+    NewRecord   = AllocateZeroPool (sizeof (EDKII_DXE_DISPATCH_ORDER) + NewCapacity * sizeof (EFI_GUID));
+    if (NewRecord == NULL) {
+      return;
+    }
+
+    if (OldRecord != NULL) {
+      CopyMem (NewRecord, OldRecord, sizeof (EDKII_DXE_DISPATCH_ORDER) + OldRecord->Count * sizeof (EFI_GUID));
+    }
+
+    //
+    // Publish the new buffer before the old one goes away
+    //
+    CoreInstallConfigurationTable (&gEdkiiDxeDispatchOrderGuid, NewRecord);
+    mDispatchOrderRecord         = NewRecord;
+    mDispatchOrderRecordCapacity = NewCapacity;
+    if (OldRecord != NULL) {
+      CoreFreePool (OldRecord);
+    }
+  }
+
+  CopyGuid ((EFI_GUID *)(mDispatchOrderRecord + 1) + mDispatchOrderRecord->Count, FileName);
+  mDispatchOrderRecord->Count++;
+}
+
 /**
   Enter critical section by gaining lock on mDispatcherLock.
 
@@ -256,6 +347,11 @@ CoreGetDepexSectionAndPreProccess (
                       (UINTN *)&DriverEntry->DepexSize,
                       &AuthenticationStatus
                       );
+  //
+  // Any previous evaluation result no longer applies to the Depex read here
+  //
+  DriverEntry->DepexEvaluated = FALSE;
+
   if (EFI_ERROR (Status)) {
     if (Status == EFI_PROTOCOL_ERROR) {
       //
@@ -501,6 +597,10 @@ CoreDispatcher (
 
       CoreReleaseDispatcherLock ();
 
+      if (FeaturePcdGet (PcdDxeDispatchOrderCache)) {
+        CoreRecordDispatchOrder (&DriverEntry->FileName);
+      }
+
       if (DriverEntry->IsFvImage) {
         //
         // Produce a firmware volume block protocol for FvImage so it gets dispatched from.
@@ -552,6 +652,18 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        if (!CoreIsDepexEvaluationNeeded (DriverEntry)) {
+          DEBUG_CODE_BEGIN ();
+          mDepexEvaluationsSaved++;
+          DEBUG_CODE_END ();
+          continue;
+        }
+
+        //
+        // Record the protocol database state the result is based on
+        //
+        DriverEntry->DepexChangeKey = CoreGetProtocolDatabaseChangeKey ();
+        DriverEntry->DepexEvaluated = TRUE;
         if (CoreIsSchedulable (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
@@ -566,6 +678,8 @@ CoreDispatcher (
     }
   } while (ReadyToRun);
 
+  DEBUG ((DEBUG_DISPATCH, "DXE dispatcher skipped %d unchanged DEPEX evaluations\n", mDepexEvaluationsSaved));
+
   //
   // Close DXE dispatch Event
   //
@@ -861,6 +975,8 @@ CoreAddToDriverList (
   )
 {
   EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  EFI_CORE_DRIVER_ENTRY  *Entry;
+  LIST_ENTRY             *Link;
 
   //
   // Create the Driver Entry for the list. ZeroPool initializes lots of variables to
@@ -870,6 +986,11 @@ CoreAddToDriverList (
   ASSERT (DriverEntry != NULL);
   if (Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE) {
     DriverEntry->IsFvImage = TRUE;
+    //
+    // The FV image is only processed once its depex is satisfied, so start
+    // decompressing it now and let that overlap with driver execution.
+    //
+    CorePrefetchGuidedSections (Fv, DriverName);
   }
 
   DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
@@ -882,7 +1003,24 @@ CoreAddToDriverList (
 
   CoreAcquireDispatcherLock ();
 
-  InsertTailList (&mDiscoveredList, &DriverEntry->Link);
+  Link = &mDiscoveredList;
+  if (FeaturePcdGet (PcdDxeDispatchOrderCache)) {
+    //
+    // Keep drivers of the recorded dispatch order sorted by their position in
+    // it, ahead of the drivers that the record does not know about.
+    //
+    DriverEntry->DispatchRank = CoreGetDispatchRank (DriverName);
+    if (DriverEntry->DispatchRank != MAX_UINTN) {
+      for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
+        Entry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+        if (Entry->DispatchRank > DriverEntry->DispatchRank) {
+          break;
+        }
+      }
+    }
+  }
+
+  InsertTailList (Link, &DriverEntry->Link);
 
   CoreReleaseDispatcherLock ();
 
@@ -1445,8 +1583,26 @@ CoreInitializeDispatcher (
   VOID
   )
 {
+  EFI_HOB_GUID_TYPE         *GuidHob;
+  EDKII_DXE_DISPATCH_ORDER  *DispatchOrder;
+
   PERF_FUNCTION_BEGIN ();
 
+  if (FeaturePcdGet (PcdDxeDispatchOrderCache)) {
+    GuidHob = GetFirstGuidHob (&gEdkiiDxeDispatchOrderGuid);
+    if (GuidHob != NULL) {
+      DispatchOrder = GET_GUID_HOB_DATA (GuidHob);
+      if ((GET_GUID_HOB_DATA_SIZE (GuidHob) >= sizeof (EDKII_DXE_DISPATCH_ORDER)) &&
+          (DispatchOrder->Count <= (GET_GUID_HOB_DATA_SIZE (GuidHob) - sizeof (EDKII_DXE_DISPATCH_ORDER)) / sizeof (EFI_GUID)))
+      {
+        mDispatchOrderHint = DispatchOrder;
+        DEBUG ((DEBUG_DISPATCH, "DXE dispatch order with %d drivers handed over\n", DispatchOrder->Count));
+      } else {
+        DEBUG ((DEBUG_WARN, "Ignoring malformed DXE dispatch order HOB\n"));
+      }
+    }
+  }
+
   mFwVolEvent = EfiCreateProtocolNotifyEvent (
                   &gEfiFirmwareVolume2ProtocolGuid,
                   TPL_CALLBACK,
@@ -44,11 +44,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/TcgService.h>
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
+#include <Protocol/MemoryAccept.h>
 #include <Protocol/PeCoffImageEmulator.h>
+#include <Protocol/MpService.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/HobList.h>
+#include <Guid/HobListIndex.h>
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
 #include <Guid/Apriori.h>
@@ -62,6 +65,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/DxeDispatchOrder.h>
+#include <Guid/DxeCoreServiceStatistics.h>
+#include <Guid/LzmaDecompress.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -84,6 +90,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DxeServicesLib.h>
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
+#include <Library/TimerLib.h>
 
 //
 // attributes for reserved memory before it is promoted to system memory
@@ -158,6 +165,11 @@ typedef struct {
   BOOLEAN                          Initialized;
   BOOLEAN                          DepexProtocolError;
 
+  BOOLEAN                          DepexEvaluated;      // Depex evaluated to FALSE at DepexChangeKey
+  UINT64                           DepexChangeKey;
+
+  UINTN                            DispatchRank;        // Position in the recorded dispatch order
+
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
 } EFI_CORE_DRIVER_ENTRY;
@@ -223,6 +235,8 @@ typedef struct {
   PE_COFF_LOADER_IMAGE_CONTEXT            ImageContext;
   /// Status returned by LoadImage() service.
   EFI_STATUS                              LoadImageStatus;
+  /// The image executes in place in a memory mapped FV and owns no pages.
+  BOOLEAN                                 ExecuteInPlace;
 } LOADED_IMAGE_PRIVATE_DATA;
 
 #define LOADED_IMAGE_PRIVATE_DATA_FROM_THIS(a) \
@@ -269,6 +283,7 @@ extern EFI_SECURITY_ARCH_PROTOCOL        *gSecurity;
 extern EFI_SECURITY2_ARCH_PROTOCOL       *gSecurity2;
 extern EFI_BDS_ARCH_PROTOCOL             *gBds;
 extern EFI_SMM_BASE2_PROTOCOL            *gSmmBase2;
+extern EDKII_MEMORY_ACCEPT_PROTOCOL      *gMemoryAccept;
 
 extern EFI_TPL  gEfiCurrentTpl;
 
@@ -427,6 +442,92 @@ CoreAllEfiServicesAvailable (
   VOID
   );
 
+/**
+  Build the index of the GUID extension HOBs of the HOB list, and install it
+  into the EFI System Table's Configuration Table.
+
+  @param  HobStart               Pointer to the beginning of the HOB List.
+
+**/
+VOID
+CoreInstallHobListIndex (
+  IN VOID  *HobStart
+  );
+
+///
+/// The DXE Core services that count their calls and time with
+/// PcdDxeCoreServiceStatistics.
+///
+typedef enum {
+  CoreServiceAllocatePages,
+  CoreServiceFreePages,
+  CoreServiceAllocatePool,
+  CoreServiceFreePool,
+  CoreServiceLocateProtocol,
+  CoreServiceLocateHandleBuffer,
+  CoreServiceOpenProtocol,
+  CoreServiceInstallProtocol,
+  CoreServiceSignalEvent,
+  CoreServiceDispatchEventNotifies,
+  CoreServiceGetSection,
+  CoreServiceRaiseTpl,
+  CoreServiceRestoreTpl,
+  CoreServiceMax
+} CORE_SERVICE_ID;
+
+/**
+  Start timing a call of a DXE Core service.
+
+  @param  Service   The service called.
+
+  @return The performance counter at the start of the call.
+
+**/
+UINT64
+CoreServiceStatisticsStart (
+  IN CORE_SERVICE_ID  Service
+  );
+
+/**
+  Stop timing a call of a DXE Core service, and accumulate its time.
+
+  @param  Service   The service called.
+  @param  Start     The value returned by CoreServiceStatisticsStart().
+
+**/
+VOID
+CoreServiceStatisticsEnd (
+  IN CORE_SERVICE_ID  Service,
+  IN UINT64           Start
+  );
+
+/**
+  Start collecting the DXE Core service statistics, and install them into the
+  EFI System Table's Configuration Table.
+
+  This must be called after the library constructors of the DXE Core, when the
+  performance counter of TimerLib is available.
+
+**/
+VOID
+CoreInstallServiceStatisticsTable (
+  VOID
+  );
+
+//
+// The hooks of the service statistics. They compile to nothing when
+// PcdDxeCoreServiceStatistics is FALSE.
+//
+#define CORE_SERVICE_STATISTICS_START(Service) \
+  (FeaturePcdGet (PcdDxeCoreServiceStatistics) ? CoreServiceStatisticsStart (Service) : 0)
+
+#define CORE_SERVICE_STATISTICS_END(Service, Start) \
+  do { \
+    if (FeaturePcdGet (PcdDxeCoreServiceStatistics)) { \
+      CoreServiceStatisticsEnd ((Service), (Start)); \
+    } \
+  } while (FALSE)
+
 /**
   Calcualte the 32-bit CRC in a EFI table using the service provided by the
   gRuntime service.
@@ -480,6 +581,24 @@ CoreIsSchedulable (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   );
 
+/**
+  Check whether the dependency expression of a driver needs to be evaluated
+  again. A dependency expression that evaluated to FALSE can only change its
+  result after an interface of one of the protocols it references has been
+  installed or removed.
+
+  @param  DriverEntry           DriverEntry element to check.
+
+  @retval TRUE                  The dependency expression must be evaluated.
+  @retval FALSE                 The dependency expression still evaluates to
+                                FALSE.
+
+**/
+BOOLEAN
+CoreIsDepexEvaluationNeeded (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
 /**
   Preprocess dependency expression and update DriverEntry to reflect the
   state of  Before, After, and SOR dependencies. If DriverEntry->Before
@@ -1069,6 +1188,35 @@ CoreGetHandleDatabaseKey (
   VOID
   );
 
+/**
+  Return the protocol change key of the protocol database.
+
+  The key is incremented each time any protocol interface is installed or
+  removed.
+
+  @return The protocol change key.
+
+**/
+UINT64
+CoreGetProtocolDatabaseChangeKey (
+  VOID
+  );
+
+/**
+  Return the protocol change key of the last install or removal of an
+  interface of the specified protocol.
+
+  @param  Protocol               The published unique identifier of the protocol.
+
+  @return The protocol change key, or 0 if no interface of the protocol has
+          ever been installed.
+
+**/
+UINT64
+CoreGetProtocolChangeKey (
+  IN EFI_GUID  *Protocol
+  );
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -1988,6 +2136,35 @@ FwVolDriverInit (
   IN EFI_SYSTEM_TABLE  *SystemTable
   );
 
+/**
+  Locate the PE32 section of a file in place, in a memory mapped firmware
+  volume produced by the DXE core, so that the image can be executed from
+  where it is. The section is returned at most once per file, as executing
+  the image modifies its data in the firmware volume.
+
+  @param  Fv                    The firmware volume containing the file.
+  @param  NameGuid              The file name GUID of the file.
+  @param  Buffer                Returns the PE32 image inside the firmware volume.
+  @param  BufferSize            Returns the size of the PE32 image.
+  @param  AuthenticationStatus  Returns the authentication status of the
+                                firmware volume.
+
+  @retval EFI_SUCCESS           The PE32 image was found in place.
+  @retval EFI_UNSUPPORTED       The firmware volume is not memory mapped, or
+                                not produced by the DXE core.
+  @retval EFI_NOT_FOUND         The file has no top level PE32 section, or it
+                                has already been returned.
+
+**/
+EFI_STATUS
+CoreFvGetMappedImage (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT VOID                           **Buffer,
+  OUT UINTN                          *BufferSize,
+  OUT UINT32                         *AuthenticationStatus
+  );
+
 /**
   Entry point of the section extraction code. Initializes an instance of the
   section extraction interface and installs it on a new handle.
@@ -2006,6 +2183,21 @@ InitializeSectionExtraction (
   IN EFI_SYSTEM_TABLE  *SystemTable
   );
 
+/**
+  Start decompressing the top level GUIDed sections of a firmware file on the
+  application processors, so that the result is ready when the file is read
+  through the section extraction code later.
+
+  @param  Fv                    The firmware volume containing the file.
+  @param  FileName              The file name GUID of the file.
+
+**/
+VOID
+CorePrefetchGuidedSections (
+  IN EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN EFI_GUID                       *FileName
+  );
+
 /**
   This DXE service routine is used to process a firmware volume. In
   particular, it can be called by BDS to process a single firmware
@@ -27,7 +27,8 @@ EFI_WATCHDOG_TIMER_ARCH_PROTOCOL  *gWatchdogTimer = NULL;
 //
 // DXE Core globals for optional protocol dependencies
 //
-EFI_SMM_BASE2_PROTOCOL  *gSmmBase2 = NULL;
+EFI_SMM_BASE2_PROTOCOL        *gSmmBase2     = NULL;
+EDKII_MEMORY_ACCEPT_PROTOCOL  *gMemoryAccept = NULL;
 
 //
 // DXE Core Global used to update core loaded image protocol handle
@@ -342,12 +343,22 @@ DxeMain (
   Status = CoreInstallConfigurationTable (&gEfiDxeServicesTableGuid, gDxeCoreDS);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Start the statistics of the DXE Core services
+  //
+  CoreInstallServiceStatisticsTable ();
+
   //
   // Install the HOB List into the EFI System Tables's Configuration Table
   //
   Status = CoreInstallConfigurationTable (&gEfiHobListGuid, HobStart);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Install the index of the GUIDed HOBs into the EFI System Tables's Configuration Table
+  //
+  CoreInstallHobListIndex (HobStart);
+
   //
   // Install Memory Type Information Table into the EFI System Tables's Configuration Table
   //
@@ -719,6 +730,72 @@ CoreEfiNotAvailableYetArg5 (
   return EFI_NOT_AVAILABLE_YET;
 }
 
+/**
+  Build the index of the GUID extension HOBs of the HOB list, and install it
+  into the EFI System Table's Configuration Table so that the HOB Library
+  instances of the drivers can find GUIDed HOBs without walking the HOB list.
+  The HOB list does not change after the DXE Core hand off, so the index is
+  built only once.
+
+  @param  HobStart               Pointer to the beginning of the HOB List.
+
+**/
+VOID
+CoreInstallHobListIndex (
+  IN VOID  *HobStart
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PEI_HOB_POINTERS  Hob;
+  UINTN                 Count;
+  UINTN                 Index;
+  HOB_LIST_INDEX        *HobListIndex;
+  HOB_LIST_INDEX_ENTRY  Entry;
+
+  Count = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+  }
+
+  HobListIndex = AllocatePool (OFFSET_OF (HOB_LIST_INDEX, Entry) + Count * sizeof (HOB_LIST_INDEX_ENTRY));
+  if (HobListIndex == NULL) {
+    return;
+  }
+
+  HobListIndex->HobList = HobStart;
+  HobListIndex->Count   = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) != EFI_HOB_TYPE_GUID_EXTENSION) {
+      continue;
+    }
+
+    //
+    // Insertion sort by name. HOBs of the same name stay in HOB list order.
+    //
+    CopyGuid (&Entry.Name, &Hob.Guid->Name);
+    Entry.Hob = Hob.Guid;
+    for (Index = HobListIndex->Count; Index > 0; Index--) {
+      if (CompareMem (&HobListIndex->Entry[Index - 1].Name, &Entry.Name, sizeof (EFI_GUID)) <= 0) {
+        break;
+      }
+
+      CopyMem (&HobListIndex->Entry[Index], &HobListIndex->Entry[Index - 1], sizeof (HOB_LIST_INDEX_ENTRY));
+    }
+
+    CopyMem (&HobListIndex->Entry[Index], &Entry, sizeof (HOB_LIST_INDEX_ENTRY));
+    HobListIndex->Count++;
+  }
+
+  HobListIndex->EndOfHobList = Hob.Raw;
+
+  Status = CoreInstallConfigurationTable (&gEdkiiHobListIndexGuid, HobListIndex);
+  if (EFI_ERROR (Status)) {
+    CoreFreePool (HobListIndex);
+  }
+}
+
 /**
   Calcualte the 32-bit CRC in a EFI table using the service provided by the
   gRuntime service.
@@ -155,6 +155,9 @@ CoreDispatchEventNotifies (
 {
   IEVENT      *Event;
   LIST_ENTRY  *Head;
+  UINT64      StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceDispatchEventNotifies);
 
   CoreAcquireEventLock ();
   ASSERT (gEventQueueLock.OwnerTpl == Priority);
@@ -193,6 +196,7 @@ CoreDispatchEventNotifies (
 
   gEventPending &= ~(UINTN)(1 << Priority);
   CoreReleaseEventLock ();
+  CORE_SERVICE_STATISTICS_END (CoreServiceDispatchEventNotifies, StatisticsStart);
 }
 
 /**
@@ -516,6 +520,7 @@ CoreSignalEvent (
   )
 {
   IEVENT  *Event;
+  UINT64  StatisticsStart;
 
   Event = UserEvent;
 
@@ -527,6 +532,8 @@ CoreSignalEvent (
     return EFI_INVALID_PARAMETER;
   }
 
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceSignalEvent);
+
   CoreAcquireEventLock ();
 
   //
@@ -555,6 +562,7 @@ CoreSignalEvent (
   }
 
   CoreReleaseEventLock ();
+  CORE_SERVICE_STATISTICS_END (CoreServiceSignalEvent, StatisticsStart);
   return EFI_SUCCESS;
 }
 
@@ -48,17 +48,20 @@ CoreInsertEventTimer (
   TriggerTime = Event->Timer.TriggerTime;
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Insert the timer into the timer database in assending sorted order,
+  // after any timer with the same trigger time. The list is searched from
+  // the tail, since timers armed now, in particular periodic timers being
+  // re-armed from CoreCheckTimers(), usually expire after all queued ones.
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
+  for (Link = mEfiTimerList.BackLink; Link != &mEfiTimerList; Link = Link->BackLink) {
     Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
+    if (Event2->Timer.TriggerTime <= TriggerTime) {
       break;
     }
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  InsertHeadList (Link, &Event->Timer.Link);
 }
 
 /**
@@ -278,6 +281,20 @@ CoreSetTimer (
     }
 
     Event->Timer.TriggerTime = CoreCurrentSystemTime () + TriggerTime;
+
+    //
+    // Round the trigger time up to the coalescing window, so that timers
+    // due close to each other expire on the same tick and are processed
+    // by a single CoreCheckTimers() pass.
+    //
+    if ((PcdGet32 (PcdTimerCoalescingWindow) != 0) && (TriggerTime != 0)) {
+      Event->Timer.TriggerTime = DivU64x32 (
+                                   Event->Timer.TriggerTime + PcdGet32 (PcdTimerCoalescingWindow) - 1,
+                                   PcdGet32 (PcdTimerCoalescingWindow)
+                                   );
+      Event->Timer.TriggerTime = MultU64x32 (Event->Timer.TriggerTime, PcdGet32 (PcdTimerCoalescingWindow));
+    }
+
     CoreInsertEventTimer (Event);
 
     if (TriggerTime == 0) {
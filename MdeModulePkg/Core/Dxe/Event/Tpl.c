@@ -59,6 +59,9 @@ CoreRaiseTpl (
   )
 {
   EFI_TPL  OldTpl;
+  UINT64   StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceRaiseTpl);
 
   OldTpl = gEfiCurrentTpl;
   if (OldTpl > NewTpl) {
@@ -80,6 +83,7 @@ CoreRaiseTpl (
   //
   gEfiCurrentTpl = NewTpl;
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceRaiseTpl, StatisticsStart);
   return OldTpl;
 }
 
@@ -98,6 +102,9 @@ CoreRestoreTpl (
 {
   EFI_TPL  OldTpl;
   EFI_TPL  PendingTpl;
+  UINT64   StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceRestoreTpl);
 
   OldTpl = gEfiCurrentTpl;
   if (NewTpl > OldTpl) {
@@ -146,4 +153,6 @@ CoreRestoreTpl (
   if (gEfiCurrentTpl < TPL_HIGH_LEVEL) {
     CoreSetInterruptState (TRUE);
   }
+
+  CORE_SERVICE_STATISTICS_END (CoreServiceRestoreTpl, StatisticsStart);
 }
@@ -536,6 +536,10 @@ FvCheck (
       FfsFileEntry->FfsHeader  = CacheFfsHeader;
       FfsFileEntry->FileCached = FileCached;
       FileCached               = FALSE;
+      if (FvDevice->IsMemoryMapped) {
+        FfsFileEntry->MappedFfsHeader = FfsHeader;
+      }
+
       InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
     }
 
@@ -20,6 +20,12 @@ typedef struct {
   EFI_FFS_FILE_HEADER    *FfsHeader;
   UINTN                  StreamHandle;
   BOOLEAN                FileCached;
+  //
+  // Location of the file in a memory mapped FV, NULL otherwise. FfsHeader
+  // may point to a cached copy of it.
+  //
+  EFI_FFS_FILE_HEADER    *MappedFfsHeader;
+  BOOLEAN                MappedImageReturned;
 } FFS_FILE_LIST_ENTRY;
 
 typedef struct {
@@ -530,3 +530,99 @@ FvReadFileSection (
 Done:
   return Status;
 }
+
+/**
+  Locate the PE32 section of a file in place, in a memory mapped firmware
+  volume produced by the DXE core, so that the image can be executed from
+  where it is. The section is returned at most once per file, as executing
+  the image modifies its data in the firmware volume.
+
+  @param  Fv                    The firmware volume containing the file.
+  @param  NameGuid              The file name GUID of the file.
+  @param  Buffer                Returns the PE32 image inside the firmware volume.
+  @param  BufferSize            Returns the size of the PE32 image.
+  @param  AuthenticationStatus  Returns the authentication status of the
+                                firmware volume.
+
+  @retval EFI_SUCCESS           The PE32 image was found in place.
+  @retval EFI_UNSUPPORTED       The firmware volume is not memory mapped, or
+                                not produced by the DXE core.
+  @retval EFI_NOT_FOUND         The file has no top level PE32 section, or it
+                                has already been returned.
+
+**/
+EFI_STATUS
+CoreFvGetMappedImage (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT VOID                           **Buffer,
+  OUT UINTN                          *BufferSize,
+  OUT UINT32                         *AuthenticationStatus
+  )
+{
+  FV_DEVICE                  *FvDevice;
+  LIST_ENTRY                 *Link;
+  FFS_FILE_LIST_ENTRY        *FfsEntry;
+  EFI_FFS_FILE_HEADER        *FfsHeader;
+  EFI_COMMON_SECTION_HEADER  *Section;
+  UINT8                      *FileData;
+  UINTN                      FileDataSize;
+  UINTN                      Offset;
+  UINTN                      SectionLength;
+
+  if (Fv->ReadFile != FvReadFile) {
+    return EFI_UNSUPPORTED;
+  }
+
+  FvDevice = FV_DEVICE_FROM_THIS (Fv);
+  if (!FvDevice->IsMemoryMapped) {
+    return EFI_UNSUPPORTED;
+  }
+
+  for (Link = FvDevice->FfsFileListHeader.ForwardLink; Link != &FvDevice->FfsFileListHeader; Link = Link->ForwardLink) {
+    FfsEntry = (FFS_FILE_LIST_ENTRY *)Link;
+    if (CompareGuid (&FfsEntry->FfsHeader->Name, NameGuid)) {
+      break;
+    }
+  }
+
+  if ((Link == &FvDevice->FfsFileListHeader) || (FfsEntry->MappedFfsHeader == NULL) || FfsEntry->MappedImageReturned) {
+    return EFI_NOT_FOUND;
+  }
+
+  FfsHeader = FfsEntry->MappedFfsHeader;
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    FileData     = (UINT8 *)FfsHeader + sizeof (EFI_FFS_FILE_HEADER2);
+    FileDataSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileData     = (UINT8 *)FfsHeader + sizeof (EFI_FFS_FILE_HEADER);
+    FileDataSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+  }
+
+  Offset = 0;
+  while (Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileDataSize) {
+    Section       = (EFI_COMMON_SECTION_HEADER *)(FileData + Offset);
+    SectionLength = IS_SECTION2 (Section) ? SECTION2_SIZE (Section) : SECTION_SIZE (Section);
+    if ((SectionLength < sizeof (EFI_COMMON_SECTION_HEADER)) || (SectionLength > FileDataSize - Offset)) {
+      break;
+    }
+
+    if (Section->Type == EFI_SECTION_PE32) {
+      if (IS_SECTION2 (Section)) {
+        *Buffer     = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER2);
+        *BufferSize = SectionLength - sizeof (EFI_COMMON_SECTION_HEADER2);
+      } else {
+        *Buffer     = (UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER);
+        *BufferSize = SectionLength - sizeof (EFI_COMMON_SECTION_HEADER);
+      }
+
+      *AuthenticationStatus         = FvDevice->AuthenticationStatus;
+      FfsEntry->MappedImageReturned = TRUE;
+      return EFI_SUCCESS;
+    }
+
+    Offset += ALIGN_VALUE (SectionLength, 4);
+  }
+
+  return EFI_NOT_FOUND;
+}
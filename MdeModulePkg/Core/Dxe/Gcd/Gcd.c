@@ -45,6 +45,14 @@ EFI_LOCK    mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 LIST_ENTRY  mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY  mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// The entry found by the last CoreSearchGcdMapEntry() on each map. Callers
+// tend to walk the address space in order (page by page attribute updates,
+// resource allocation), so the next search usually starts right there.
+//
+LIST_ENTRY  *mGcdMemorySpaceMapSearchHint = NULL;
+LIST_ENTRY  *mGcdIoSpaceMapSearchHint     = NULL;
+
 EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -460,6 +468,27 @@ CoreInsertGcdMapEntry (
   return EFI_SUCCESS;
 }
 
+/**
+  Return the search hint slot of a GCD map.
+
+  @param  Map                    The GCD map
+
+  @return The address of the search hint of Map.
+
+**/
+LIST_ENTRY **
+CoreGetGcdMapSearchHint (
+  IN LIST_ENTRY  *Map
+  )
+{
+  if (Map == &mGcdIoSpaceMap) {
+    return &mGcdIoSpaceMapSearchHint;
+  }
+
+  ASSERT (Map == &mGcdMemorySpaceMap);
+  return &mGcdMemorySpaceMapSearchHint;
+}
+
 /**
   Merge the Gcd region specified by Link and its adjacent entry.
 
@@ -532,6 +561,13 @@ CoreMergeGcdMapEntry (
     Entry->BaseAddress = AdjacentEntry->BaseAddress;
   }
 
+  //
+  // Entry now covers the range of AdjacentEntry, so it replaces it as hint
+  //
+  if (*CoreGetGcdMapSearchHint (Map) == AdjacentLink) {
+    *CoreGetGcdMapSearchHint (Map) = Link;
+  }
+
   RemoveEntryList (AdjacentLink);
   CoreFreePool (AdjacentEntry);
 
@@ -605,6 +641,7 @@ CoreSearchGcdMapEntry (
   )
 {
   LIST_ENTRY         *Link;
+  LIST_ENTRY         **SearchHint;
   EFI_GCD_MAP_ENTRY  *Entry;
 
   ASSERT (Length != 0);
@@ -612,11 +649,30 @@ CoreSearchGcdMapEntry (
   *StartLink = NULL;
   *EndLink   = NULL;
 
-  Link = Map->ForwardLink;
+  //
+  // The map is sorted by address and covers the whole space, so the search
+  // may start from any entry at or below BaseAddress. Start from the entry
+  // found last time, stepping back first if BaseAddress is below it.
+  //
+  SearchHint = CoreGetGcdMapSearchHint (Map);
+  Link       = Map->ForwardLink;
+  if (*SearchHint != NULL) {
+    Link = *SearchHint;
+    while (Link->BackLink != Map) {
+      Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+      if (Entry->BaseAddress <= BaseAddress) {
+        break;
+      }
+
+      Link = Link->BackLink;
+    }
+  }
+
   while (Link != Map) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
     if ((BaseAddress >= Entry->BaseAddress) && (BaseAddress <= Entry->EndAddress)) {
-      *StartLink = Link;
+      *StartLink  = Link;
+      *SearchHint = Link;
     }
 
     if (*StartLink != NULL) {
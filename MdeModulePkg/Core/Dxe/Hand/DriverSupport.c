@@ -368,6 +368,176 @@ AddSortedDriverBindingProtocol (
   }
 }
 
+/**
+  Forgets the Driver Binding Protocols recorded as not supporting a handle,
+  because the protocols installed on the handle changed.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle
+
+**/
+VOID
+CoreFlushUnsupportedDrivers (
+  IN IHANDLE  *Handle
+  )
+{
+  UNSUPPORTED_DRIVER  *Unsupported;
+
+  while (!IsListEmpty (&Handle->UnsupportedDrivers)) {
+    Unsupported = CR (Handle->UnsupportedDrivers.ForwardLink, UNSUPPORTED_DRIVER, Link, UNSUPPORTED_DRIVER_SIGNATURE);
+    RemoveEntryList (&Unsupported->Link);
+    Unsupported->Signature = 0;
+    CoreFreePool (Unsupported);
+  }
+}
+
+/**
+  Counts the BY_DRIVER and EXCLUSIVE opens of the protocols of a handle.
+
+  Supported() fails when another driver holds a protocol it needs, so its
+  result only holds while the same opens are held. The opens of Supported()
+  itself are closed before it returns and do not count.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle.
+
+  @return The number of opens.
+
+**/
+STATIC
+UINTN
+CoreGetDriverOpenCount (
+  IN IHANDLE  *Handle
+  )
+{
+  LIST_ENTRY          *Link;
+  LIST_ENTRY          *OpenLink;
+  PROTOCOL_INTERFACE  *Prot;
+  OPEN_PROTOCOL_DATA  *OpenData;
+  UINTN               Count;
+
+  Count = 0;
+  for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    for (OpenLink = Prot->OpenList.ForwardLink; OpenLink != &Prot->OpenList; OpenLink = OpenLink->ForwardLink) {
+      OpenData = CR (OpenLink, OPEN_PROTOCOL_DATA, Link, OPEN_PROTOCOL_DATA_SIGNATURE);
+      if ((OpenData->Attributes & (EFI_OPEN_PROTOCOL_BY_DRIVER | EFI_OPEN_PROTOCOL_EXCLUSIVE)) != 0) {
+        Count++;
+      }
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Checks if a Driver Binding Protocol was recorded as not supporting a
+  controller since the protocols of the controller last changed.
+
+  @param  ControllerHandle       The handle of the controller.
+  @param  DriverBinding          The Driver Binding Protocol instance.
+  @param  RemainingDevicePath    The device path passed to Supported().
+
+  @retval TRUE                   Supported() returned EFI_UNSUPPORTED, it is not
+                                 called again.
+  @retval FALSE                  Supported() must be called.
+
+**/
+STATIC
+BOOLEAN
+CoreIsUnsupportedDriver (
+  IN EFI_HANDLE                   ControllerHandle,
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  )
+{
+  IHANDLE             *Handle;
+  LIST_ENTRY          *Link;
+  UNSUPPORTED_DRIVER  *Unsupported;
+  UINTN               DriverOpenCount;
+  BOOLEAN             Found;
+
+  //
+  // Supported() may answer differently for another RemainingDevicePath.
+  //
+  if (!FeaturePcdGet (PcdDxeDriverSupportedCache) || (RemainingDevicePath != NULL)) {
+    return FALSE;
+  }
+
+  Found = FALSE;
+  CoreAcquireProtocolLock ();
+  if (!EFI_ERROR (CoreValidateHandle (ControllerHandle)) &&
+      !EFI_ERROR (CoreValidateHandle (DriverBinding->DriverBindingHandle)))
+  {
+    Handle          = (IHANDLE *)ControllerHandle;
+    DriverOpenCount = CoreGetDriverOpenCount (Handle);
+    for (Link = Handle->UnsupportedDrivers.ForwardLink; Link != &Handle->UnsupportedDrivers; Link = Link->ForwardLink) {
+      Unsupported = CR (Link, UNSUPPORTED_DRIVER, Link, UNSUPPORTED_DRIVER_SIGNATURE);
+      if ((Unsupported->DriverBinding == DriverBinding) &&
+          (Unsupported->DriverBindingHandle == DriverBinding->DriverBindingHandle) &&
+          (Unsupported->DriverBindingKey == ((IHANDLE *)DriverBinding->DriverBindingHandle)->Key) &&
+          (Unsupported->DriverOpenCount == DriverOpenCount))
+      {
+        Found = TRUE;
+        break;
+      }
+    }
+  }
+
+  CoreReleaseProtocolLock ();
+  return Found;
+}
+
+/**
+  Records that a Driver Binding Protocol does not support a controller.
+
+  The Key of the DriverBindingHandle tells apart a driver unloaded and another
+  one installed at the same addresses.
+
+  @param  ControllerHandle       The handle of the controller.
+  @param  DriverBinding          The Driver Binding Protocol instance.
+  @param  RemainingDevicePath    The device path passed to Supported().
+
+**/
+STATIC
+VOID
+CoreRecordUnsupportedDriver (
+  IN EFI_HANDLE                   ControllerHandle,
+  IN EFI_DRIVER_BINDING_PROTOCOL  *DriverBinding,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  )
+{
+  UNSUPPORTED_DRIVER  *Unsupported;
+
+  if (!FeaturePcdGet (PcdDxeDriverSupportedCache) || (RemainingDevicePath != NULL)) {
+    return;
+  }
+
+  Unsupported = AllocatePool (sizeof (UNSUPPORTED_DRIVER));
+  if (Unsupported == NULL) {
+    return;
+  }
+
+  CoreAcquireProtocolLock ();
+  if (!EFI_ERROR (CoreValidateHandle (ControllerHandle)) &&
+      !EFI_ERROR (CoreValidateHandle (DriverBinding->DriverBindingHandle)))
+  {
+    Unsupported->Signature           = UNSUPPORTED_DRIVER_SIGNATURE;
+    Unsupported->DriverBinding       = DriverBinding;
+    Unsupported->DriverBindingHandle = DriverBinding->DriverBindingHandle;
+    Unsupported->DriverBindingKey    = ((IHANDLE *)DriverBinding->DriverBindingHandle)->Key;
+    Unsupported->DriverOpenCount     = CoreGetDriverOpenCount ((IHANDLE *)ControllerHandle);
+    InsertTailList (&((IHANDLE *)ControllerHandle)->UnsupportedDrivers, &Unsupported->Link);
+    Unsupported = NULL;
+  }
+
+  CoreReleaseProtocolLock ();
+
+  if (Unsupported != NULL) {
+    CoreFreePool (Unsupported);
+  }
+}
+
 /**
   Connects a controller to a driver.
 
@@ -634,6 +804,10 @@ CoreConnectSingleController (
     for (Index = 0; (Index < NumberOfSortedDriverBindingProtocols) && !DriverFound; Index++) {
       if (SortedDriverBindingProtocols[Index] != NULL) {
         DriverBinding = SortedDriverBindingProtocols[Index];
+        if (CoreIsUnsupportedDriver (ControllerHandle, DriverBinding, RemainingDevicePath)) {
+          continue;
+        }
+
         PERF_DRIVER_BINDING_SUPPORT_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
         Status = DriverBinding->Supported (
                                   DriverBinding,
@@ -641,6 +815,10 @@ CoreConnectSingleController (
                                   RemainingDevicePath
                                   );
         PERF_DRIVER_BINDING_SUPPORT_END (DriverBinding->DriverBindingHandle, ControllerHandle);
+        if (Status == EFI_UNSUPPORTED) {
+          CoreRecordUnsupportedDriver (ControllerHandle, DriverBinding, RemainingDevicePath);
+        }
+
         if (!EFI_ERROR (Status)) {
           SortedDriverBindingProtocols[Index] = NULL;
           DriverFound                         = TRUE;
@@ -10,15 +10,137 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system.
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
+// gProtocolChangeKey    -  The Key to show that a protocol interface has been installed/removed
 //
 LIST_ENTRY  mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
 LIST_ENTRY  gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK    gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64      gHandleDatabaseKey    = 0;
+UINT64      gProtocolChangeKey    = 0;
+
+//
+// mHandleHashTable        - Hash buckets of IHANDLE, keyed by handle address
+// mProtocolEntryHashTable - Hash buckets of PROTOCOL_ENTRY, keyed by protocol GUID
+//
+// Both tables mirror gHandleList and mProtocolDatabase so that handle validation
+// and protocol entry lookup do not have to walk the whole database.
+//
+LIST_ENTRY  mHandleHashTable[HANDLE_HASH_BUCKETS];
+LIST_ENTRY  mProtocolEntryHashTable[PROTOCOL_ENTRY_HASH_BUCKETS];
+BOOLEAN     mHashTablesInitialized = FALSE;
+
+/**
+  Initialize the handle and protocol entry hash tables on first use.
+  The gProtocolDatabaseLock must be owned
+
+**/
+VOID
+CoreInitializeHashTables (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  if (mHashTablesInitialized) {
+    return;
+  }
+
+  for (Index = 0; Index < HANDLE_HASH_BUCKETS; Index++) {
+    InitializeListHead (&mHandleHashTable[Index]);
+  }
+
+  for (Index = 0; Index < PROTOCOL_ENTRY_HASH_BUCKETS; Index++) {
+    InitializeListHead (&mProtocolEntryHashTable[Index]);
+  }
+
+  mHashTablesInitialized = TRUE;
+}
+
+/**
+  Return the hash bucket of a handle.
+
+  @param  Handle                 The handle address
+
+  @return The list head of the bucket the handle belongs to
+
+**/
+LIST_ENTRY *
+CoreGetHandleHashBucket (
+  IN VOID  *Handle
+  )
+{
+  CoreInitializeHashTables ();
+
+  //
+  // Handles come from the pool allocator, so the low bits are always zero.
+  //
+  return &mHandleHashTable[((UINTN)Handle >> 3) & (HANDLE_HASH_BUCKETS - 1)];
+}
+
+/**
+  Return the hash bucket of a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The list head of the bucket the protocol belongs to
+
+**/
+LIST_ENTRY *
+CoreGetProtocolEntryHashBucket (
+  IN EFI_GUID  *Protocol
+  )
+{
+  UINT32  Hash;
+
+  CoreInitializeHashTables ();
+
+  Hash  = ReadUnaligned32 ((UINT32 *)Protocol);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 1);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 2);
+  Hash ^= ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &mProtocolEntryHashTable[Hash & (PROTOCOL_ENTRY_HASH_BUCKETS - 1)];
+}
+
+/**
+  Adds a newly created handle to the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to insert
+
+**/
+VOID
+CoreInsertHandleHash (
+  IN IHANDLE  *Handle
+  )
+{
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  InsertHeadList (CoreGetHandleHashBucket (Handle), &Handle->HashLink);
+}
+
+/**
+  Removes a handle from the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to remove
+
+**/
+VOID
+CoreRemoveHandleHash (
+  IN IHANDLE  *Handle
+  )
+{
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  RemoveEntryList (&Handle->HashLink);
+}
 
 /**
   Acquire lock on gProtocolDatabaseLock.
@@ -60,6 +182,7 @@ CoreValidateHandle (
   )
 {
   IHANDLE     *Handle;
+  LIST_ENTRY  *Bucket;
   LIST_ENTRY  *Link;
 
   if (UserHandle == NULL) {
@@ -68,8 +191,13 @@ CoreValidateHandle (
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
-  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
-    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+  //
+  // Only the hash bucket the handle address maps to needs to be searched.
+  // The handle itself is never dereferenced until it has been found.
+  //
+  Bucket = CoreGetHandleHashBucket (UserHandle);
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Handle = CR (Link, IHANDLE, HashLink, EFI_HANDLE_SIGNATURE);
     if (Handle == (IHANDLE *)UserHandle) {
       return EFI_SUCCESS;
     }
@@ -94,6 +222,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY      *Bucket;
   LIST_ENTRY      *Link;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
@@ -101,15 +230,16 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the database for the matching GUID
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = CoreGetProtocolEntryHashBucket (Protocol);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
@@ -135,11 +265,13 @@ CoreFindProtocolEntry (
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
+      ProtEntry->ChangeKey = 0;
 
       //
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -330,6 +462,7 @@ CoreInstallProtocolInterfaceNotify (
   IHANDLE             *Handle;
   EFI_STATUS          Status;
   VOID                *ExistingInterface;
+  UINT64              StatisticsStart;
 
   //
   // returns EFI_INVALID_PARAMETER if InterfaceType is invalid.
@@ -359,6 +492,8 @@ CoreInstallProtocolInterfaceNotify (
     }
   }
 
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceInstallProtocol);
+
   //
   // Lock the protocol database
   //
@@ -397,6 +532,7 @@ CoreInstallProtocolInterfaceNotify (
     //
     Handle->Signature = EFI_HANDLE_SIGNATURE;
     InitializeListHead (&Handle->Protocols);
+    InitializeListHead (&Handle->UnsupportedDrivers);
 
     //
     // Initialize the Key to show that the handle has been created/modified
@@ -409,6 +545,7 @@ CoreInstallProtocolInterfaceNotify (
     // in the system
     //
     InsertTailList (&gHandleList, &Handle->AllHandles);
+    CoreInsertHandleHash (Handle);
   } else {
     Status = CoreValidateHandle (Handle);
     if (EFI_ERROR (Status)) {
@@ -448,6 +585,14 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  CoreFlushUnsupportedDrivers (Handle);
+
+  //
+  // Update the Key to show that an interface of this protocol has been installed
+  //
+  gProtocolChangeKey++;
+  ProtEntry->ChangeKey = gProtocolChangeKey;
+
   //
   // Notify the notification list for this protocol
   //
@@ -478,6 +623,7 @@ Done:
     DEBUG ((DEBUG_ERROR, "InstallProtocolInterface: %g %p failed with %r\n", Protocol, Interface, Status));
   }
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceInstallProtocol, StatisticsStart);
   return Status;
 }
 
@@ -751,6 +897,7 @@ CoreUninstallProtocolInterface (
     //
     gHandleDatabaseKey++;
     Handle->Key = gHandleDatabaseKey;
+    CoreFlushUnsupportedDrivers (Handle);
 
     //
     // Remove the protocol interface from the handle
@@ -771,6 +918,7 @@ CoreUninstallProtocolInterface (
   if (IsListEmpty (&Handle->Protocols)) {
     Handle->Signature = 0;
     RemoveEntryList (&Handle->AllHandles);
+    CoreRemoveHandleHash (Handle);
     CoreFreePool (Handle);
   }
 
@@ -887,13 +1035,21 @@ CoreGetProtocolInterface (
 
   Handle = (IHANDLE *)UserHandle;
 
+  //
+  // Resolve the protocol entry once through the hash table, so the handle's
+  // protocol list can be matched by pointer instead of by GUID.
+  //
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry == NULL) {
+    return NULL;
+  }
+
   //
   // Look at each protocol interface for a match
   //
   for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
-    Prot      = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
-    ProtEntry = Prot->Protocol;
-    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
       return Prot;
     }
   }
@@ -973,6 +1129,7 @@ CoreOpenProtocol (
   BOOLEAN             Exclusive;
   BOOLEAN             Disconnect;
   BOOLEAN             ExactMatch;
+  UINT64              StatisticsStart;
 
   //
   // Check for invalid Protocol
@@ -988,6 +1145,8 @@ CoreOpenProtocol (
     return EFI_INVALID_PARAMETER;
   }
 
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceOpenProtocol);
+
   //
   // Lock the protocol database
   //
@@ -1193,6 +1352,7 @@ Done:
   // Done. Release the database lock and return
   //
   CoreReleaseProtocolLock ();
+  CORE_SERVICE_STATISTICS_END (CoreServiceOpenProtocol, StatisticsStart);
   return Status;
 }
 
@@ -1504,6 +1664,49 @@ CoreGetHandleDatabaseKey (
   return gHandleDatabaseKey;
 }
 
+/**
+  Return the protocol change key of the protocol database.
+
+  The key is incremented each time any protocol interface is installed or
+  removed.
+
+  @return The protocol change key.
+
+**/
+UINT64
+CoreGetProtocolDatabaseChangeKey (
+  VOID
+  )
+{
+  return gProtocolChangeKey;
+}
+
+/**
+  Return the protocol change key of the last install or removal of an
+  interface of the specified protocol.
+
+  @param  Protocol               The published unique identifier of the protocol.
+
+  @return The protocol change key, or 0 if no interface of the protocol has
+          ever been installed.
+
+**/
+UINT64
+CoreGetProtocolChangeKey (
+  IN EFI_GUID  *Protocol
+  )
+{
+  PROTOCOL_ENTRY  *ProtEntry;
+  UINT64          ChangeKey;
+
+  CoreAcquireProtocolLock ();
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  ChangeKey = (ProtEntry != NULL) ? ProtEntry->ChangeKey : 0;
+  CoreReleaseProtocolLock ();
+
+  return ChangeKey;
+}
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
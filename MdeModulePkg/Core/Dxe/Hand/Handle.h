@@ -11,6 +11,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define EFI_HANDLE_SIGNATURE  SIGNATURE_32('h','n','d','l')
 
+///
+/// Number of buckets in the handle and protocol entry hash tables.
+/// Both values must be a power of 2.
+///
+#define HANDLE_HASH_BUCKETS          256
+#define PROTOCOL_ENTRY_HASH_BUCKETS  64
+
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
@@ -18,11 +25,15 @@ typedef struct {
   UINTN         Signature;
   /// All handles list of IHANDLE
   LIST_ENTRY    AllHandles;
+  /// Link on the handle hash bucket list
+  LIST_ENTRY    HashLink;
   /// List of PROTOCOL_INTERFACE's for this handle
   LIST_ENTRY    Protocols;
   UINTN         LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
   UINT64        Key;
+  /// List of UNSUPPORTED_DRIVER's for this handle
+  LIST_ENTRY    UnsupportedDrivers;
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -38,12 +49,16 @@ typedef struct {
   UINTN         Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY    AllEntries;
+  /// Link Entry inserted to the protocol entry hash bucket list
+  LIST_ENTRY    HashLink;
   /// ID of the protocol
   EFI_GUID      ProtocolID;
   /// All protocol interfaces
   LIST_ENTRY    Protocols;
   /// Registerd notification handlers
   LIST_ENTRY    Notify;
+  /// The gProtocolChangeKey value when an interface of this protocol was last installed or removed
+  UINT64        ChangeKey;
 } PROTOCOL_ENTRY;
 
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
@@ -84,6 +99,27 @@ typedef struct {
 
 #define PROTOCOL_NOTIFY_SIGNATURE  SIGNATURE_32('p','r','t','n')
 
+#define UNSUPPORTED_DRIVER_SIGNATURE  SIGNATURE_32('u','d','r','v')
+
+///
+/// UNSUPPORTED_DRIVER - a Driver Binding Protocol whose Supported() returned
+/// EFI_UNSUPPORTED for a handle, recorded when PcdDxeDriverSupportedCache is
+/// TRUE so that ConnectController() does not ask it again until the protocols
+/// of the handle, or the drivers managing them, change
+///
+typedef struct {
+  UINTN                          Signature;
+  /// Link on IHANDLE.UnsupportedDrivers
+  LIST_ENTRY                     Link;
+  /// The Driver Binding Protocol instance
+  EFI_DRIVER_BINDING_PROTOCOL    *DriverBinding;
+  /// The DriverBindingHandle of the instance and its Key when Supported() was called
+  EFI_HANDLE                     DriverBindingHandle;
+  UINT64                         DriverBindingKey;
+  /// The number of BY_DRIVER or EXCLUSIVE opens of the protocols of the handle
+  UINTN                          DriverOpenCount;
+} UNSUPPORTED_DRIVER;
+
 ///
 /// PROTOCOL_NOTIFY - used for each register notification for a protocol
 ///
@@ -114,6 +150,43 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   );
 
+/**
+  Adds a newly created handle to the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to insert
+
+**/
+VOID
+CoreInsertHandleHash (
+  IN IHANDLE  *Handle
+  );
+
+/**
+  Forgets the Driver Binding Protocols recorded as not supporting a handle,
+  because the protocols installed on the handle changed.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle
+
+**/
+VOID
+CoreFlushUnsupportedDrivers (
+  IN IHANDLE  *Handle
+  );
+
+/**
+  Removes a handle from the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to remove
+
+**/
+VOID
+CoreRemoveHandleHash (
+  IN IHANDLE  *Handle
+  );
+
 /**
   Signal event for every protocol in protocol entry.
 
@@ -248,5 +321,6 @@ CoreValidateHandle (
 extern EFI_LOCK    gProtocolDatabaseLock;
 extern LIST_ENTRY  gHandleList;
 extern UINT64      gHandleDatabaseKey;
+extern UINT64      gProtocolChangeKey;
 
 #endif
@@ -582,11 +582,14 @@ CoreLocateProtocol (
   LOCATE_POSITION  Position;
   PROTOCOL_NOTIFY  *ProtNotify;
   IHANDLE          *Handle;
+  UINT64           StatisticsStart;
 
   if ((Interface == NULL) || (Protocol == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceLocateProtocol);
+
   *Interface = NULL;
   Status     = EFI_SUCCESS;
 
@@ -602,6 +605,7 @@ CoreLocateProtocol (
   //
   Status = CoreAcquireLockOrFail (&gProtocolDatabaseLock);
   if (EFI_ERROR (Status)) {
+    CORE_SERVICE_STATISTICS_END (CoreServiceLocateProtocol, StatisticsStart);
     return EFI_NOT_FOUND;
   }
 
@@ -637,6 +641,7 @@ CoreLocateProtocol (
 
 Done:
   CoreReleaseProtocolLock ();
+  CORE_SERVICE_STATISTICS_END (CoreServiceLocateProtocol, StatisticsStart);
   return Status;
 }
 
@@ -674,6 +679,7 @@ CoreLocateHandleBuffer (
 {
   EFI_STATUS  Status;
   UINTN       BufferSize;
+  UINT64      StatisticsStart;
 
   if (NumberHandles == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -683,6 +689,8 @@ CoreLocateHandleBuffer (
     return EFI_INVALID_PARAMETER;
   }
 
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceLocateHandleBuffer);
+
   BufferSize     = 0;
   *NumberHandles = 0;
   *Buffer        = NULL;
@@ -710,12 +718,14 @@ CoreLocateHandleBuffer (
     }
 
     CoreReleaseProtocolLock ();
+    CORE_SERVICE_STATISTICS_END (CoreServiceLocateHandleBuffer, StatisticsStart);
     return Status;
   }
 
   *Buffer = AllocatePool (BufferSize);
   if (*Buffer == NULL) {
     CoreReleaseProtocolLock ();
+    CORE_SERVICE_STATISTICS_END (CoreServiceLocateHandleBuffer, StatisticsStart);
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -733,5 +743,6 @@ CoreLocateHandleBuffer (
   }
 
   CoreReleaseProtocolLock ();
+  CORE_SERVICE_STATISTICS_END (CoreServiceLocateHandleBuffer, StatisticsStart);
   return Status;
 }
@@ -76,6 +76,12 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+
+    //
+    // Update the Key to show that an interface of this protocol has been removed
+    //
+    gProtocolChangeKey++;
+    ProtEntry->ChangeKey = gProtocolChangeKey;
   }
 
   return Prot;
@@ -248,6 +254,7 @@ CoreReinstallProtocolInterface (
   //
   gHandleDatabaseKey++;
   Handle->Key = gHandleDatabaseKey;
+  CoreFlushUnsupportedDrivers (Handle);
 
   //
   // Release the lock and connect all drivers to UserHandle
@@ -550,6 +550,72 @@ CoreIsImageTypeSupported (
          EFI_IMAGE_MACHINE_CROSS_TYPE_SUPPORTED (Image->ImageContext.Machine);
 }
 
+/**
+  Check whether an image can be executed from where it sits in a memory mapped
+  FV. This requires a boot service driver that is linked at its location in the
+  FV, suitably aligned, and whose sections are laid out in the file exactly as
+  in memory, so that loading and relocating it does not change it.
+
+  @param  Pe32Handle              The handle of PE32 image
+  @param  Image                   PE image to be loaded
+
+  @retval TRUE                    The image can be executed in place.
+  @retval FALSE                   The image must be copied into allocated pages.
+
+**/
+BOOLEAN
+CoreIsImageExecuteInPlace (
+  IN IMAGE_FILE_HANDLE          *Pe32Handle,
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  Hdr;
+  EFI_IMAGE_SECTION_HEADER             *Section;
+  UINTN                                Index;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR      Descriptor;
+
+  if (!Pe32Handle->SourceIsMapped ||
+      Image->ImageContext.IsTeImage ||
+      (Image->ImageContext.ImageType != EFI_IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER) ||
+      (PcdGet64 (PcdLoadModuleAtFixAddressEnable) != 0))
+  {
+    return FALSE;
+  }
+
+  if ((Image->ImageContext.ImageAddress != (EFI_PHYSICAL_ADDRESS)(UINTN)Pe32Handle->Source) ||
+      ((Image->ImageContext.ImageAddress & (Image->ImageContext.SectionAlignment - 1)) != 0) ||
+      ((Image->ImageContext.ImageAddress & EFI_PAGE_MASK) != 0) ||
+      (Image->ImageContext.ImageSize > Pe32Handle->SourceSize))
+  {
+    return FALSE;
+  }
+
+  //
+  // The image writes its data in place, so the FV must be in system memory
+  //
+  if (EFI_ERROR (CoreGetMemorySpaceDescriptor (Image->ImageContext.ImageAddress, &Descriptor)) ||
+      (Descriptor.GcdMemoryType != EfiGcdMemoryTypeSystemMemory) ||
+      (Image->ImageContext.ImageAddress + Image->ImageContext.ImageSize > Descriptor.BaseAddress + Descriptor.Length))
+  {
+    return FALSE;
+  }
+
+  Hdr.Union = (EFI_IMAGE_OPTIONAL_HEADER_UNION *)((UINT8 *)Pe32Handle->Source + Image->ImageContext.PeCoffHeaderOffset);
+  Section   = (EFI_IMAGE_SECTION_HEADER *)(
+                                           (UINT8 *)&Hdr.Pe32->OptionalHeader +
+                                           Hdr.Pe32->FileHeader.SizeOfOptionalHeader
+                                           );
+  for (Index = 0; Index < Hdr.Pe32->FileHeader.NumberOfSections; Index++) {
+    if ((Section[Index].SizeOfRawData != 0) &&
+        (Section[Index].PointerToRawData != Section[Index].VirtualAddress))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Loads, relocates, and invokes a PE/COFF image
 
@@ -638,7 +704,15 @@ CoreLoadPeImage (
   // Allocate memory of the correct memory type aligned on the required image boundary
   //
   DstBufAlocated = FALSE;
-  if (DstBuffer == 0) {
+  if ((DstBuffer == 0) && CoreIsImageExecuteInPlace (Pe32Handle, Image)) {
+    //
+    // Load the image onto itself. The PE/COFF loader copies nothing, as source
+    // and destination are the same, and the relocation delta is zero.
+    //
+    Image->ExecuteInPlace = TRUE;
+    Image->NumberOfPages  = EFI_SIZE_TO_PAGES ((UINTN)Image->ImageContext.ImageSize);
+    DEBUG ((DEBUG_LOAD, "Executing image in place at 0x%11p\n", (VOID *)(UINTN)Image->ImageContext.ImageAddress));
+  } else if (DstBuffer == 0) {
     //
     // Allocate Destination Buffer as caller did not pass it in
     //
@@ -1068,9 +1142,9 @@ CoreUnloadAndCloseImage (
   }
 
   //
-  // Free the Image from memory
+  // Free the Image from memory. An image executed in place lives in the FV.
   //
-  if ((Image->ImageBasePage != 0) && FreePage) {
+  if ((Image->ImageBasePage != 0) && FreePage && !Image->ExecuteInPlace) {
     CoreFreePages (Image->ImageBasePage, Image->NumberOfPages);
   }
 
@@ -1092,6 +1166,44 @@ CoreUnloadAndCloseImage (
   CoreFreePool (Image);
 }
 
+/**
+  Get the PE32 image of a file in a memory mapped FV, so that it can be loaded
+  without reading a copy of it first.
+
+  @param  DeviceHandle            The handle of the FV containing the image.
+  @param  FilePath                The remaining device path to the image file.
+  @param  FHand                   The image file handle to fill in.
+  @param  AuthenticationStatus    Returns the authentication status of the FV.
+
+**/
+VOID
+CoreGetMappedImage (
+  IN     EFI_HANDLE                DeviceHandle,
+  IN     EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  IN OUT IMAGE_FILE_HANDLE         *FHand,
+  OUT    UINT32                    *AuthenticationStatus
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv;
+  EFI_GUID                       *NameGuid;
+
+  NameGuid = EfiGetNameGuidFromFwVolDevicePathNode ((CONST MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)FilePath);
+  if ((NameGuid == NULL) || !IsDevicePathEnd (NextDevicePathNode (FilePath))) {
+    return;
+  }
+
+  Status = CoreHandleProtocol (DeviceHandle, &gEfiFirmwareVolume2ProtocolGuid, (VOID **)&Fv);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = CoreFvGetMappedImage (Fv, NameGuid, &FHand->Source, &FHand->SourceSize, AuthenticationStatus);
+  if (!EFI_ERROR (Status)) {
+    FHand->SourceIsMapped = TRUE;
+  }
+}
+
 /**
   Loads an EFI image into memory and returns a handle to the image.
 
@@ -1243,15 +1355,25 @@ CoreLoadImageCommon (
     }
 
     //
-    // Get the source file buffer by its device path.
+    // Use the image in place if it sits in a memory mapped FV, otherwise get
+    // the source file buffer by its device path.
     //
-    FHand.Source = GetFileBufferByFilePath (
-                     BootPolicy,
-                     FilePath,
-                     &FHand.SourceSize,
-                     &AuthenticationStatus
-                     );
-    if (FHand.Source == NULL) {
+    if (ImageIsFromFv && FeaturePcdGet (PcdDxeImageExecuteInPlace)) {
+      CoreGetMappedImage (DeviceHandle, HandleFilePath, &FHand, &AuthenticationStatus);
+    }
+
+    if (!FHand.SourceIsMapped) {
+      FHand.Source = GetFileBufferByFilePath (
+                       BootPolicy,
+                       FilePath,
+                       &FHand.SourceSize,
+                       &AuthenticationStatus
+                       );
+    }
+
+    if (FHand.SourceIsMapped) {
+      Status = EFI_SUCCESS;
+    } else if (FHand.Source == NULL) {
       Status = EFI_NOT_FOUND;
     } else {
       FHand.FreeBuffer = TRUE;
@@ -18,6 +18,10 @@ typedef struct {
   BOOLEAN    FreeBuffer;
   VOID       *Source;
   UINTN      SourceSize;
+  //
+  // Source is the image inside a memory mapped FV
+  //
+  BOOLEAN    SourceIsMapped;
 } IMAGE_FILE_HANDLE;
 
 #endif
@@ -319,6 +319,18 @@ IsPageTypeToGuard (
   IN EFI_ALLOCATE_TYPE  AllocateType
   );
 
+/**
+  Check to see if an allocation of a memory type to guard is sampled for
+  guarding, according to PcdHeapGuardSampleRate and PcdHeapGuardSampleLimit.
+
+  @return TRUE  The allocation should be guarded.
+  @return FALSE The allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampled (
+  VOID
+  );
+
 /**
   Check to see if the page at the given address is guarded or not.
 
@@ -33,6 +33,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct {
   UINTN              Signature;
   LIST_ENTRY         Link;
+  ///
+  /// Link on gConventionalMemoryMap, only valid for EfiConventionalMemory entries
+  ///
+  LIST_ENTRY         ConventionalLink;
   BOOLEAN            FromPages;
 
   EFI_MEMORY_TYPE    Type;
@@ -168,5 +172,7 @@ CoreInternalAllocatePages (
 
 extern EFI_LOCK    gMemoryLock;
 extern LIST_ENTRY  gMemoryMap;
+extern LIST_ENTRY  gConventionalMemoryMap;
 extern LIST_ENTRY  mGcdMemorySpaceMap;
+extern EFI_LOCK    mGcdMemorySpaceLock;
 #endif
@@ -17,3 +17,8 @@ EFI_LOCK  gMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 // MemoryMap - the current memory map
 //
 LIST_ENTRY  gMemoryMap = INITIALIZE_LIST_HEAD_VARIABLE (gMemoryMap);
+
+//
+// ConventionalMemoryMap - the EfiConventionalMemory entries of gMemoryMap
+//
+LIST_ENTRY  gConventionalMemoryMap = INITIALIZE_LIST_HEAD_VARIABLE (gConventionalMemoryMap);
@@ -9,7 +9,8 @@
 #include "DxeMain.h"
 #include "Imem.h"
 
-#define IS_UEFI_MEMORY_PROFILE_ENABLED  ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT0) != 0)
+#define IS_UEFI_MEMORY_PROFILE_ENABLED     ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT0) != 0)
+#define IS_UEFI_MEMORY_PROFILE_AGGREGATED  ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT3) != 0)
 
 #define GET_OCCUPIED_SIZE(ActualSize, Alignment) \
   ((ActualSize) + (((Alignment) - ((ActualSize) & ((Alignment) - 1))) & ((Alignment) - 1)))
@@ -35,6 +36,33 @@ typedef struct {
   LIST_ENTRY                   Link;
 } MEMORY_PROFILE_ALLOC_INFO_DATA;
 
+//
+// When the allocations are counted per call site, the AllocInfoList of a
+// driver holds MEMORY_PROFILE_CALL_SITE_DATA, and each allocation not freed is
+// only tracked by a MEMORY_PROFILE_ALLOC_TRACK_DATA in a hash table.
+//
+typedef struct {
+  UINT32                             Signature;
+  MEMORY_PROFILE_CALL_SITE_INFO      CallSiteInfo;
+  MEMORY_PROFILE_DRIVER_INFO_DATA    *DriverInfoData;
+  LIST_ENTRY                         Link;
+  LIST_ENTRY                         HashLink;
+} MEMORY_PROFILE_CALL_SITE_DATA;
+
+typedef struct {
+  LIST_ENTRY                       HashLink;
+  PHYSICAL_ADDRESS                 Buffer;
+  UINT64                           Size;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
+} MEMORY_PROFILE_ALLOC_TRACK_DATA;
+
+//
+// DXE drivers allocate much more often than SMM drivers, the hash tables are
+// larger than those of the SMRAM profile.
+//
+#define MEMORY_PROFILE_CALL_SITE_HASH_SIZE  256
+#define MEMORY_PROFILE_ALLOC_HASH_SIZE      1024
+
 GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                   mImageQueue           = INITIALIZE_LIST_HEAD_VARIABLE (mImageQueue);
 GLOBAL_REMOVE_IF_UNREFERENCED MEMORY_PROFILE_CONTEXT_DATA  mMemoryProfileContext = {
   MEMORY_PROFILE_CONTEXT_SIGNATURE,
@@ -61,6 +89,9 @@ GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mMemoryProfileGettingSta
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mMemoryProfileRecordingEnable = MEMORY_PROFILE_RECORDING_DISABLE;
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_DEVICE_PATH_PROTOCOL  *mMemoryProfileDriverPath;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN                     mMemoryProfileDriverPathSize;
+GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mMemoryProfileAggregated = FALSE;
+GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                *mMemoryProfileCallSiteHash;
+GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                *mMemoryProfileAllocHash;
 
 /**
   Get memory profile data.
@@ -582,6 +613,42 @@ RegisterDxeCore (
   return TRUE;
 }
 
+/**
+  Allocate the hash tables of the call sites and of the allocations, so that
+  the memory profile counts the allocations per call site.
+
+  The memory profile records each allocation if they cannot be allocated.
+
+**/
+VOID
+MemoryProfileInitAggregation (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  //
+  // Use CoreInternalAllocatePool() that will not update profile for this AllocatePool action.
+  //
+  Status = CoreInternalAllocatePool (
+             EfiBootServicesData,
+             (MEMORY_PROFILE_CALL_SITE_HASH_SIZE + MEMORY_PROFILE_ALLOC_HASH_SIZE) * sizeof (LIST_ENTRY),
+             (VOID **)&mMemoryProfileCallSiteHash
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "MemoryProfileInit: the allocations are not counted per call site - %r\n", Status));
+    return;
+  }
+
+  mMemoryProfileAllocHash = mMemoryProfileCallSiteHash + MEMORY_PROFILE_CALL_SITE_HASH_SIZE;
+  for (Index = 0; Index < MEMORY_PROFILE_CALL_SITE_HASH_SIZE + MEMORY_PROFILE_ALLOC_HASH_SIZE; Index++) {
+    InitializeListHead (&mMemoryProfileCallSiteHash[Index]);
+  }
+
+  mMemoryProfileAggregated = TRUE;
+}
+
 /**
   Initialize memory profile.
 
@@ -615,6 +682,10 @@ MemoryProfileInit (
   mMemoryProfileDriverPath     = AllocateCopyPool (mMemoryProfileDriverPathSize, PcdGetPtr (PcdMemoryProfileDriverPath));
   mMemoryProfileContextPtr     = &mMemoryProfileContext;
 
+  if (IS_UEFI_MEMORY_PROFILE_AGGREGATED) {
+    MemoryProfileInitAggregation ();
+  }
+
   RegisterDxeCore (HobStart, &mMemoryProfileContext);
 
   DEBUG ((DEBUG_INFO, "MemoryProfileInit MemoryProfileContext - 0x%x\n", &mMemoryProfileContext));
@@ -956,6 +1027,382 @@ GetProfileMemoryIndex (
   }
 }
 
+/**
+  Add the size of an allocation to the usage of its driver and to the total
+  usage.
+
+  @param ContextData      Memory profile context.
+  @param DriverInfoData   Memory profile driver info of the caller.
+  @param MemoryType       Memory type.
+  @param Size             Buffer size.
+
+**/
+VOID
+MemoryProfileAddUsage (
+  IN MEMORY_PROFILE_CONTEXT_DATA      *ContextData,
+  IN MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData,
+  IN EFI_MEMORY_TYPE                  MemoryType,
+  IN UINTN                            Size
+  )
+{
+  MEMORY_PROFILE_CONTEXT      *Context;
+  MEMORY_PROFILE_DRIVER_INFO  *DriverInfo;
+  UINTN                       ProfileMemoryIndex;
+
+  Context            = &ContextData->Context;
+  DriverInfo         = &DriverInfoData->DriverInfo;
+  ProfileMemoryIndex = GetProfileMemoryIndex (MemoryType);
+
+  DriverInfo->CurrentUsage += Size;
+  if (DriverInfo->PeakUsage < DriverInfo->CurrentUsage) {
+    DriverInfo->PeakUsage = DriverInfo->CurrentUsage;
+  }
+
+  DriverInfo->CurrentUsageByType[ProfileMemoryIndex] += Size;
+  if (DriverInfo->PeakUsageByType[ProfileMemoryIndex] < DriverInfo->CurrentUsageByType[ProfileMemoryIndex]) {
+    DriverInfo->PeakUsageByType[ProfileMemoryIndex] = DriverInfo->CurrentUsageByType[ProfileMemoryIndex];
+  }
+
+  Context->CurrentTotalUsage += Size;
+  if (Context->PeakTotalUsage < Context->CurrentTotalUsage) {
+    Context->PeakTotalUsage = Context->CurrentTotalUsage;
+  }
+
+  Context->CurrentTotalUsageByType[ProfileMemoryIndex] += Size;
+  if (Context->PeakTotalUsageByType[ProfileMemoryIndex] < Context->CurrentTotalUsageByType[ProfileMemoryIndex]) {
+    Context->PeakTotalUsageByType[ProfileMemoryIndex] = Context->CurrentTotalUsageByType[ProfileMemoryIndex];
+  }
+}
+
+/**
+  Get the index of the hash table bucket of a call site.
+
+  @param CallerAddress  Address of caller who call Allocate.
+  @param Action         This Allocate action.
+  @param MemoryType     Memory type.
+
+  @return The index of the bucket in mMemoryProfileCallSiteHash.
+
+**/
+STATIC
+UINTN
+MemoryProfileCallSiteHash (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType
+  )
+{
+  UINT64  Key;
+
+  Key = CallerAddress ^ LShiftU64 (Action, 32) ^ MemoryType;
+  return (UINTN)(Key ^ RShiftU64 (Key, 8) ^ RShiftU64 (Key, 16)) & (MEMORY_PROFILE_CALL_SITE_HASH_SIZE - 1);
+}
+
+/**
+  Get the index of the hash table bucket of an allocation.
+
+  @param Buffer         Buffer address.
+
+  @return The index of the bucket in mMemoryProfileAllocHash.
+
+**/
+STATIC
+UINTN
+MemoryProfileAllocHash (
+  IN PHYSICAL_ADDRESS  Buffer
+  )
+{
+  return (UINTN)(RShiftU64 (Buffer, 4) ^ RShiftU64 (Buffer, 14)) & (MEMORY_PROFILE_ALLOC_HASH_SIZE - 1);
+}
+
+/**
+  Count an allocation in its call site, when the memory profile counts the
+  allocations per call site.
+
+  @param DriverInfoData Memory profile driver info of the caller.
+  @param CallerAddress  Address of caller who call Allocate.
+  @param Action         This Allocate action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size.
+  @param Buffer         Buffer address.
+
+  @return EFI_SUCCESS           The allocation is counted.
+  @return EFI_OUT_OF_RESOURCES  No enough resource to count the allocation.
+
+**/
+EFI_STATUS
+MemoryProfileAggregateAllocate (
+  IN MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData,
+  IN PHYSICAL_ADDRESS                 CallerAddress,
+  IN MEMORY_PROFILE_ACTION            Action,
+  IN EFI_MEMORY_TYPE                  MemoryType,
+  IN UINTN                            Size,
+  IN VOID                             *Buffer
+  )
+{
+  EFI_STATUS                       Status;
+  LIST_ENTRY                       *Bucket;
+  LIST_ENTRY                       *Link;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
+  MEMORY_PROFILE_CALL_SITE_INFO    *CallSiteInfo;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+
+  CallSiteData = NULL;
+  Bucket       = &mMemoryProfileCallSiteHash[MemoryProfileCallSiteHash (CallerAddress, Action, MemoryType)];
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    CallSiteData = CR (
+                     Link,
+                     MEMORY_PROFILE_CALL_SITE_DATA,
+                     HashLink,
+                     MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE
+                     );
+    CallSiteInfo = &CallSiteData->CallSiteInfo;
+    if ((CallSiteInfo->CallerAddress == CallerAddress) &&
+        (CallSiteInfo->Action == Action) &&
+        (CallSiteInfo->MemoryType == MemoryType))
+    {
+      break;
+    }
+
+    CallSiteData = NULL;
+  }
+
+  //
+  // Use CoreInternalAllocatePool() that will not update profile for this AllocatePool action.
+  //
+  AllocTrackData = NULL;
+  Status         = CoreInternalAllocatePool (
+                     EfiBootServicesData,
+                     sizeof (*AllocTrackData),
+                     (VOID **)&AllocTrackData
+                     );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (CallSiteData == NULL) {
+    Status = CoreInternalAllocatePool (
+               EfiBootServicesData,
+               sizeof (*CallSiteData),
+               (VOID **)&CallSiteData
+               );
+    if (EFI_ERROR (Status)) {
+      CoreInternalFreePool (AllocTrackData, NULL);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ZeroMem (CallSiteData, sizeof (*CallSiteData));
+    CallSiteData->Signature        = MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE;
+    CallSiteData->DriverInfoData   = DriverInfoData;
+    CallSiteInfo                   = &CallSiteData->CallSiteInfo;
+    CallSiteInfo->Header.Signature = MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE;
+    CallSiteInfo->Header.Length    = sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+    CallSiteInfo->Header.Revision  = MEMORY_PROFILE_CALL_SITE_INFO_REVISION;
+    CallSiteInfo->CallerAddress    = CallerAddress;
+    CallSiteInfo->Action           = Action;
+    CallSiteInfo->MemoryType       = MemoryType;
+
+    InsertTailList (DriverInfoData->AllocInfoList, &CallSiteData->Link);
+    InsertTailList (Bucket, &CallSiteData->HashLink);
+    DriverInfoData->DriverInfo.AllocRecordCount++;
+  }
+
+  CallSiteInfo                = &CallSiteData->CallSiteInfo;
+  CallSiteInfo->CurrentUsage += Size;
+  if (CallSiteInfo->PeakUsage < CallSiteInfo->CurrentUsage) {
+    CallSiteInfo->PeakUsage = CallSiteInfo->CurrentUsage;
+  }
+
+  CallSiteInfo->CurrentCount++;
+  CallSiteInfo->TotalCount++;
+
+  AllocTrackData->Buffer       = (PHYSICAL_ADDRESS)(UINTN)Buffer;
+  AllocTrackData->Size         = Size;
+  AllocTrackData->CallSiteData = CallSiteData;
+  InsertTailList (&mMemoryProfileAllocHash[MemoryProfileAllocHash (AllocTrackData->Buffer)], &AllocTrackData->HashLink);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the tracked allocation that a Free action releases, when the memory
+  profile counts the allocations per call site.
+
+  @param BasicAction        This Free basic action.
+  @param Size               Buffer size, for FreePages.
+  @param Buffer             Buffer address.
+
+  @return Pointer to the tracked allocation, or NULL if none is found.
+
+**/
+MEMORY_PROFILE_ALLOC_TRACK_DATA *
+MemoryProfileFindAllocTrack (
+  IN MEMORY_PROFILE_ACTION  BasicAction,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  MEMORY_PROFILE_ACTION            AllocAction;
+  LIST_ENTRY                       *Bucket;
+  LIST_ENTRY                       *Link;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+  UINTN                            Index;
+
+  if (BasicAction == MemoryProfileActionFreePages) {
+    AllocAction = MemoryProfileActionAllocatePages;
+  } else {
+    AllocAction = MemoryProfileActionAllocatePool;
+  }
+
+  //
+  // Most buffers are freed from their start.
+  //
+  Bucket = &mMemoryProfileAllocHash[MemoryProfileAllocHash ((PHYSICAL_ADDRESS)(UINTN)Buffer)];
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    AllocTrackData = BASE_CR (Link, MEMORY_PROFILE_ALLOC_TRACK_DATA, HashLink);
+    if ((AllocTrackData->Buffer == (PHYSICAL_ADDRESS)(UINTN)Buffer) &&
+        (AllocTrackData->Size >= Size) &&
+        ((AllocTrackData->CallSiteData->CallSiteInfo.Action & MEMORY_PROFILE_ACTION_BASIC_MASK) == AllocAction))
+    {
+      return AllocTrackData;
+    }
+  }
+
+  if (BasicAction != MemoryProfileActionFreePages) {
+    return NULL;
+  }
+
+  //
+  // Pages may also be freed from the middle or the end of an allocation.
+  //
+  for (Index = 0; Index < MEMORY_PROFILE_ALLOC_HASH_SIZE; Index++) {
+    Bucket = &mMemoryProfileAllocHash[Index];
+    for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+      AllocTrackData = BASE_CR (Link, MEMORY_PROFILE_ALLOC_TRACK_DATA, HashLink);
+      if ((AllocTrackData->Buffer <= (PHYSICAL_ADDRESS)(UINTN)Buffer) &&
+          ((AllocTrackData->Buffer + AllocTrackData->Size) >= ((PHYSICAL_ADDRESS)(UINTN)Buffer + Size)) &&
+          ((AllocTrackData->CallSiteData->CallSiteInfo.Action & MEMORY_PROFILE_ACTION_BASIC_MASK) == AllocAction))
+      {
+        return AllocTrackData;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Remove a Free action from the counters of the call sites, when the memory
+  profile counts the allocations per call site.
+
+  @param ContextData    Memory profile context.
+  @param BasicAction    This Free basic action.
+  @param Size           Buffer size, for FreePages.
+  @param Buffer         Buffer address.
+
+  @return EFI_SUCCESS           Memory profile is updated.
+  @return EFI_NOT_FOUND         No matched allocation found for free action.
+
+**/
+EFI_STATUS
+MemoryProfileAggregateFree (
+  IN MEMORY_PROFILE_CONTEXT_DATA  *ContextData,
+  IN MEMORY_PROFILE_ACTION        BasicAction,
+  IN UINTN                        Size,
+  IN VOID                         *Buffer
+  )
+{
+  EFI_STATUS                       Status;
+  MEMORY_PROFILE_CONTEXT           *Context;
+  MEMORY_PROFILE_DRIVER_INFO       *DriverInfo;
+  MEMORY_PROFILE_CALL_SITE_INFO    *CallSiteInfo;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *TailTrackData;
+  UINTN                            ProfileMemoryIndex;
+  PHYSICAL_ADDRESS                 FreeStart;
+  PHYSICAL_ADDRESS                 FreeEnd;
+  PHYSICAL_ADDRESS                 AllocEnd;
+  UINT64                           FreedSize;
+  BOOLEAN                          Found;
+
+  Context   = &ContextData->Context;
+  FreeStart = (PHYSICAL_ADDRESS)(UINTN)Buffer;
+  FreeEnd   = FreeStart + Size;
+
+  //
+  // Need use do-while loop to find all possible records,
+  // because one address might be recorded multiple times.
+  //
+  Found = FALSE;
+  do {
+    AllocTrackData = MemoryProfileFindAllocTrack (BasicAction, Size, Buffer);
+    if (AllocTrackData == NULL) {
+      //
+      // If (!Found), the allocate action of this buffer was filtered, as in
+      // CoreUpdateProfileFree ().
+      //
+      return (Found ? EFI_SUCCESS : EFI_NOT_FOUND);
+    }
+
+    Found        = TRUE;
+    CallSiteInfo = &AllocTrackData->CallSiteData->CallSiteInfo;
+    DriverInfo   = &AllocTrackData->CallSiteData->DriverInfoData->DriverInfo;
+    AllocEnd     = AllocTrackData->Buffer + AllocTrackData->Size;
+
+    if ((BasicAction == MemoryProfileActionFreePool) || (Size == AllocTrackData->Size)) {
+      FreedSize = AllocTrackData->Size;
+      RemoveEntryList (&AllocTrackData->HashLink);
+      CoreInternalFreePool (AllocTrackData, NULL);
+      CallSiteInfo->CurrentCount--;
+    } else if (AllocTrackData->Buffer == FreeStart) {
+      FreedSize = Size;
+      RemoveEntryList (&AllocTrackData->HashLink);
+      AllocTrackData->Buffer = FreeEnd;
+      AllocTrackData->Size   = AllocEnd - FreeEnd;
+      InsertTailList (&mMemoryProfileAllocHash[MemoryProfileAllocHash (AllocTrackData->Buffer)], &AllocTrackData->HashLink);
+    } else {
+      FreedSize            = Size;
+      AllocTrackData->Size = FreeStart - AllocTrackData->Buffer;
+      if (AllocEnd != FreeEnd) {
+        //
+        // The pages are freed from the middle of the allocation, the rest of
+        // it is tracked as another allocation of the call site. If it cannot
+        // be, it is not counted anymore.
+        //
+        Status = CoreInternalAllocatePool (
+                   EfiBootServicesData,
+                   sizeof (*TailTrackData),
+                   (VOID **)&TailTrackData
+                   );
+        if (EFI_ERROR (Status)) {
+          FreedSize += AllocEnd - FreeEnd;
+        } else {
+          TailTrackData->Buffer       = FreeEnd;
+          TailTrackData->Size         = AllocEnd - FreeEnd;
+          TailTrackData->CallSiteData = AllocTrackData->CallSiteData;
+          InsertTailList (&mMemoryProfileAllocHash[MemoryProfileAllocHash (TailTrackData->Buffer)], &TailTrackData->HashLink);
+          CallSiteInfo->CurrentCount++;
+        }
+      }
+    }
+
+    CallSiteInfo->CurrentUsage -= FreedSize;
+
+    //
+    // Update summary if and only if it is basic action.
+    //
+    if (CallSiteInfo->Action == (CallSiteInfo->Action & MEMORY_PROFILE_ACTION_BASIC_MASK)) {
+      ProfileMemoryIndex = GetProfileMemoryIndex (CallSiteInfo->MemoryType);
+
+      Context->CurrentTotalUsage                           -= FreedSize;
+      Context->CurrentTotalUsageByType[ProfileMemoryIndex] -= FreedSize;
+
+      DriverInfo->CurrentUsage                           -= FreedSize;
+      DriverInfo->CurrentUsageByType[ProfileMemoryIndex] -= FreedSize;
+    }
+  } while (TRUE);
+}
+
 /**
   Update memory profile Allocate information.
 
@@ -983,13 +1430,10 @@ CoreUpdateProfileAllocate (
   )
 {
   EFI_STATUS                       Status;
-  MEMORY_PROFILE_CONTEXT           *Context;
-  MEMORY_PROFILE_DRIVER_INFO       *DriverInfo;
   MEMORY_PROFILE_ALLOC_INFO        *AllocInfo;
   MEMORY_PROFILE_CONTEXT_DATA      *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA   *AllocInfoData;
-  UINTN                            ProfileMemoryIndex;
   MEMORY_PROFILE_ACTION            BasicAction;
   UINTN                            ActionStringSize;
   UINTN                            ActionStringOccupiedSize;
@@ -1006,6 +1450,16 @@ CoreUpdateProfileAllocate (
     return EFI_UNSUPPORTED;
   }
 
+  if (mMemoryProfileAggregated) {
+    Status = MemoryProfileAggregateAllocate (DriverInfoData, CallerAddress, Action, MemoryType, Size, Buffer);
+    if (!EFI_ERROR (Status) && (Action == BasicAction)) {
+      ContextData->Context.SequenceCount++;
+      MemoryProfileAddUsage (ContextData, DriverInfoData, MemoryType, Size);
+    }
+
+    return Status;
+  }
+
   ActionStringSize         = 0;
   ActionStringOccupiedSize = 0;
   if (ActionString != NULL) {
@@ -1057,35 +1511,13 @@ CoreUpdateProfileAllocate (
 
   InsertTailList (DriverInfoData->AllocInfoList, &AllocInfoData->Link);
 
-  Context    = &ContextData->Context;
-  DriverInfo = &DriverInfoData->DriverInfo;
-  DriverInfo->AllocRecordCount++;
+  DriverInfoData->DriverInfo.AllocRecordCount++;
 
   //
   // Update summary if and only if it is basic action.
   //
   if (Action == BasicAction) {
-    ProfileMemoryIndex = GetProfileMemoryIndex (MemoryType);
-
-    DriverInfo->CurrentUsage += Size;
-    if (DriverInfo->PeakUsage < DriverInfo->CurrentUsage) {
-      DriverInfo->PeakUsage = DriverInfo->CurrentUsage;
-    }
-
-    DriverInfo->CurrentUsageByType[ProfileMemoryIndex] += Size;
-    if (DriverInfo->PeakUsageByType[ProfileMemoryIndex] < DriverInfo->CurrentUsageByType[ProfileMemoryIndex]) {
-      DriverInfo->PeakUsageByType[ProfileMemoryIndex] = DriverInfo->CurrentUsageByType[ProfileMemoryIndex];
-    }
-
-    Context->CurrentTotalUsage += Size;
-    if (Context->PeakTotalUsage < Context->CurrentTotalUsage) {
-      Context->PeakTotalUsage = Context->CurrentTotalUsage;
-    }
-
-    Context->CurrentTotalUsageByType[ProfileMemoryIndex] += Size;
-    if (Context->PeakTotalUsageByType[ProfileMemoryIndex] < Context->CurrentTotalUsageByType[ProfileMemoryIndex]) {
-      Context->PeakTotalUsageByType[ProfileMemoryIndex] = Context->CurrentTotalUsageByType[ProfileMemoryIndex];
-    }
+    MemoryProfileAddUsage (ContextData, DriverInfoData, MemoryType, Size);
   }
 
   return EFI_SUCCESS;
@@ -1197,6 +1629,10 @@ CoreUpdateProfileFree (
     return EFI_UNSUPPORTED;
   }
 
+  if (mMemoryProfileAggregated) {
+    return MemoryProfileAggregateFree (ContextData, BasicAction, Size, Buffer);
+  }
+
   DriverInfoData = GetMemoryProfileDriverInfoFromAddress (ContextData, CallerAddress);
 
   //
@@ -1468,6 +1904,11 @@ MemoryProfileGetDataSize (
                        );
     TotalSize += DriverInfoData->DriverInfo.Header.Length;
 
+    if (mMemoryProfileAggregated) {
+      TotalSize += DriverInfoData->DriverInfo.AllocRecordCount * sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+      continue;
+    }
+
     AllocInfoList = DriverInfoData->AllocInfoList;
     for (AllocLink = AllocInfoList->ForwardLink;
          AllocLink != AllocInfoList;
@@ -1503,6 +1944,7 @@ MemoryProfileCopyData (
   MEMORY_PROFILE_CONTEXT_DATA      *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA   *AllocInfoData;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
   LIST_ENTRY                       *DriverInfoList;
   LIST_ENTRY                       *DriverLink;
   LIST_ENTRY                       *AllocInfoList;
@@ -1543,6 +1985,18 @@ MemoryProfileCopyData (
          AllocLink != AllocInfoList;
          AllocLink = AllocLink->ForwardLink)
     {
+      if (mMemoryProfileAggregated) {
+        CallSiteData = CR (
+                         AllocLink,
+                         MEMORY_PROFILE_CALL_SITE_DATA,
+                         Link,
+                         MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE
+                         );
+        CopyMem (AllocInfo, &CallSiteData->CallSiteInfo, sizeof (MEMORY_PROFILE_CALL_SITE_INFO));
+        AllocInfo = (MEMORY_PROFILE_ALLOC_INFO *)((UINTN)AllocInfo + sizeof (MEMORY_PROFILE_CALL_SITE_INFO));
+        continue;
+      }
+
       AllocInfoData = CR (
                         AllocLink,
                         MEMORY_PROFILE_ALLOC_INFO_DATA,
@@ -31,6 +31,12 @@ UINTN  mMemoryMapKey = 0;
 
 #define MAX_MAP_DEPTH  6
 
+//
+// The minimum size of the unaccepted memory that is accepted when an
+// allocation does not fit in the accepted memory.
+//
+#define ACCEPT_MEMORY_CHUNK_SIZE  SIZE_32MB
+
 ///
 /// mMapDepth - depth of new descriptor stack
 ///
@@ -119,6 +125,47 @@ CoreReleaseMemoryLock (
   CoreReleaseLock (&gMemoryLock);
 }
 
+/**
+  Internal function.  Links a descriptor entry into the memory map.
+
+  The entry is inserted in gMemoryMap before ListPosition. Entries of type
+  EfiConventionalMemory are also linked into gConventionalMemoryMap, so that
+  free page searches do not have to walk allocated descriptors.
+
+  @param  ListPosition           The gMemoryMap position to insert the entry before
+  @param  Entry                  The entry to insert
+
+**/
+VOID
+InsertMemoryMapEntry (
+  IN LIST_ENTRY      *ListPosition,
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  InsertTailList (ListPosition, &Entry->Link);
+  if (Entry->Type == EfiConventionalMemory) {
+    InsertTailList (&gConventionalMemoryMap, &Entry->ConventionalLink);
+  }
+}
+
+/**
+  Internal function.  Unlinks a descriptor entry from the memory map.
+
+  @param  Entry                  The entry to unlink
+
+**/
+VOID
+UnlinkMemoryMapEntry (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  RemoveEntryList (&Entry->Link);
+  Entry->Link.ForwardLink = NULL;
+  if (Entry->Type == EfiConventionalMemory) {
+    RemoveEntryList (&Entry->ConventionalLink);
+  }
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -130,8 +177,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
-  RemoveEntryList (&Entry->Link);
-  Entry->Link.ForwardLink = NULL;
+  UnlinkMemoryMapEntry (Entry);
 
   if (Entry->FromPages) {
     //
@@ -162,6 +208,7 @@ CoreAddRange (
   )
 {
   LIST_ENTRY  *Link;
+  LIST_ENTRY  *MapHead;
   MEMORY_MAP  *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
@@ -209,11 +256,18 @@ CoreAddRange (
   // Two memory descriptors can only be merged if they have the same Type
   // and the same Attribute
   //
+  // Free ranges only need to be compared with the other free ranges.
+  //
+  MapHead = (Type == EfiConventionalMemory) ? &gConventionalMemoryMap : &gMemoryMap;
+  Link    = MapHead->ForwardLink;
+  while (Link != MapHead) {
+    if (MapHead == &gConventionalMemoryMap) {
+      Entry = CR (Link, MEMORY_MAP, ConventionalLink, MEMORY_MAP_SIGNATURE);
+    } else {
+      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    }
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
+    Link = Link->ForwardLink;
 
     if (Entry->Type != Type) {
       continue;
@@ -243,7 +297,7 @@ CoreAddRange (
   mMapStack[mMapDepth].End          = End;
   mMapStack[mMapDepth].VirtualStart = 0;
   mMapStack[mMapDepth].Attribute    = Attribute;
-  InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  InsertMemoryMapEntry (&gMemoryMap, &mMapStack[mMapDepth]);
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -350,8 +404,7 @@ CoreFreeMemoryMapStack (
       //
       // Move this entry to general memory
       //
-      RemoveEntryList (&mMapStack[mMapDepth].Link);
-      mMapStack[mMapDepth].Link.ForwardLink = NULL;
+      UnlinkMemoryMapEntry (&mMapStack[mMapDepth]);
 
       CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
@@ -366,7 +419,7 @@ CoreFreeMemoryMapStack (
         }
       }
 
-      InsertTailList (Link2, &Entry->Link);
+      InsertMemoryMapEntry (Link2, Entry);
     } else {
       //
       // This item of mMapStack[mMapDepth] has already been dequeued from gMemoryMap list,
@@ -464,6 +517,129 @@ PromoteMemoryResource (
   return Promoted;
 }
 
+/**
+  Accept a part of the unaccepted memory in the GCD map and convert it to be
+  DXE allocatable.
+
+  The platform may leave a part of the memory unaccepted before DXE, and only
+  accept it when it is needed. The memory is accepted with the Memory Accept
+  Protocol in chunks of at least ACCEPT_MEMORY_CHUNK_SIZE bytes. None of the
+  memory locks may be held by the caller.
+
+  @param  Type           The type of the allocation that failed.
+  @param  Address        The address of an AllocateAddress allocation, or the
+                         max address of an AllocateMaxAddress allocation.
+  @param  NumberOfPages  The number of pages of the allocation that failed.
+
+  @retval TRUE   Some memory was accepted and added to the memory map.
+  @retval FALSE  No memory was accepted.
+
+**/
+BOOLEAN
+AcceptMemoryResource (
+  IN EFI_ALLOCATE_TYPE     Type,
+  IN EFI_PHYSICAL_ADDRESS  Address,
+  IN UINTN                 NumberOfPages
+  )
+{
+  STATIC BOOLEAN        Accepting = FALSE;
+  LIST_ENTRY            *Link;
+  EFI_GCD_MAP_ENTRY     *Entry;
+  EFI_GCD_MAP_ENTRY     Unaccepted;
+  BOOLEAN               Found;
+  EFI_PHYSICAL_ADDRESS  MaxAddress;
+  EFI_PHYSICAL_ADDRESS  Start;
+  EFI_PHYSICAL_ADDRESS  End;
+  UINT64                Size;
+  EFI_STATUS            Status;
+
+  if ((gMemoryAccept == NULL) || Accepting || (mGcdMemorySpaceLock.Lock != EfiLockReleased)) {
+    return FALSE;
+  }
+
+  MaxAddress = (Type == AllocateAnyPages) ? MAX_ALLOC_ADDRESS : Address;
+  Size       = ALIGN_VALUE (EFI_PAGES_TO_SIZE ((UINT64)NumberOfPages) + SIZE_2MB, SIZE_2MB);
+  Size       = MAX (Size, ACCEPT_MEMORY_CHUNK_SIZE);
+
+  //
+  // Find the unaccepted memory that contains the address of an AllocateAddress
+  // allocation, or the highest unaccepted memory below the max address.
+  //
+  CoreAcquireGcdMemoryLock ();
+
+  Found = FALSE;
+  for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    if ((Entry->GcdMemoryType != EFI_GCD_MEMORY_TYPE_UNACCEPTED) || (Entry->BaseAddress > MaxAddress)) {
+      continue;
+    }
+
+    if ((Type == AllocateAddress) && (Entry->EndAddress < Address)) {
+      continue;
+    }
+
+    CopyMem (&Unaccepted, Entry, sizeof (Unaccepted));
+    Found = TRUE;
+    if (Type == AllocateAddress) {
+      break;
+    }
+  }
+
+  CoreReleaseGcdMemoryLock ();
+
+  if (!Found) {
+    return FALSE;
+  }
+
+  //
+  // DXE allocates memory from the top, so accept the top of the unaccepted
+  // memory, or the memory around the address of an AllocateAddress allocation.
+  //
+  if (Type == AllocateAddress) {
+    Start = Address & ~(UINT64)(SIZE_2MB - 1);
+  } else {
+    End   = MIN (Unaccepted.EndAddress, MaxAddress) + 1;
+    End  &= ~(UINT64)(SIZE_2MB - 1);
+    Start = (End > Size) ? End - Size : 0;
+  }
+
+  Start = MAX (Start, Unaccepted.BaseAddress);
+  End   = MIN (Start + Size - 1, Unaccepted.EndAddress) + 1;
+  if (End <= Start) {
+    return FALSE;
+  }
+
+  DEBUG ((DEBUG_PAGE, "Accept the memory resource %lx - %lx\n", Start, End - 1));
+
+  Accepting = TRUE;
+  Status    = gMemoryAccept->AcceptMemory (gMemoryAccept, Start, End - Start);
+  if (!EFI_ERROR (Status)) {
+    Status = CoreRemoveMemorySpace (Start, End - Start);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    //
+    // Allocable system memory resource capabilities as masked in
+    // PromoteMemoryResource()
+    //
+    Status = CoreAddMemorySpace (
+               EfiGcdMemoryTypeSystemMemory,
+               Start,
+               End - Start,
+               Unaccepted.Capabilities & ~(EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED | EFI_MEMORY_RUNTIME)
+               );
+  }
+
+  Accepting = FALSE;
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: fail to accept %lx - %lx: %r\n", __func__, Start, End - 1, Status));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
   This function try to allocate Runtime code & Boot time code memory range. If LMFA enabled, 2 patchable PCD
   PcdLoadFixAddressRuntimeCodePageNumber & PcdLoadFixAddressBootTimeCodePageNumber which are set by tools will record the
@@ -742,6 +918,7 @@ CoreConvertPagesEx (
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
   LIST_ENTRY       *Link;
+  LIST_ENTRY       *MapHead;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -762,19 +939,33 @@ CoreConvertPagesEx (
   // Convert the entire range
   //
 
+  //
+  // Allocating pages always converts from EfiConventionalMemory, so only the
+  // free descriptors have to be searched for the range to convert.
+  //
+  if (ChangingType && (NewType != EfiConventionalMemory)) {
+    MapHead = &gConventionalMemoryMap;
+  } else {
+    MapHead = &gMemoryMap;
+  }
+
   while (Start < End) {
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    for (Link = MapHead->ForwardLink; Link != MapHead; Link = Link->ForwardLink) {
+      if (MapHead == &gConventionalMemoryMap) {
+        Entry = CR (Link, MEMORY_MAP, ConventionalLink, MEMORY_MAP_SIGNATURE);
+      } else {
+        Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+      }
 
       if ((Entry->Start <= Start) && (Entry->End > Start)) {
         break;
       }
     }
 
-    if (Link == &gMemoryMap) {
+    if (Link == MapHead) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -888,7 +1079,7 @@ CoreConvertPagesEx (
       ASSERT (Entry->Start < Entry->End);
 
       Entry = &mMapStack[mMapDepth];
-      InsertTailList (&gMemoryMap, &Entry->Link);
+      InsertMemoryMapEntry (&gMemoryMap, Entry);
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1071,15 +1262,13 @@ CoreFindFreePagesI (
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target        = 0;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
+  //
+  // Only free entries are candidates, so walk the EfiConventionalMemory index
+  // instead of the whole memory map.
+  //
+  for (Link = gConventionalMemoryMap.ForwardLink; Link != &gConventionalMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, ConventionalLink, MEMORY_MAP_SIGNATURE);
+    ASSERT (Entry->Type == EfiConventionalMemory);
 
     DescStart = Entry->Start;
     DescEnd   = Entry->End;
@@ -1478,8 +1667,11 @@ CoreAllocatePages (
 {
   EFI_STATUS  Status;
   BOOLEAN     NeedGuard;
+  UINT64      StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceAllocatePages);
 
-  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding;
+  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && !mOnGuarding && IsGuardSampled ();
   Status    = CoreInternalAllocatePages (
                 Type,
                 MemoryType,
@@ -1487,6 +1679,21 @@ CoreAllocatePages (
                 Memory,
                 NeedGuard
                 );
+  if (((Status == EFI_OUT_OF_RESOURCES) || (Status == EFI_NOT_FOUND)) &&
+      AcceptMemoryResource (Type, *Memory, NumberOfPages))
+  {
+    //
+    // Some unaccepted memory has been accepted, re-attempt the allocation.
+    //
+    Status = CoreInternalAllocatePages (
+               Type,
+               MemoryType,
+               NumberOfPages,
+               Memory,
+               NeedGuard
+               );
+  }
+
   if (!EFI_ERROR (Status)) {
     CoreUpdateProfile (
       (EFI_PHYSICAL_ADDRESS)(UINTN)RETURN_ADDRESS (0),
@@ -1505,6 +1712,7 @@ CoreAllocatePages (
       );
   }
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceAllocatePages, StatisticsStart);
   return Status;
 }
 
@@ -1616,6 +1824,9 @@ CoreFreePages (
 {
   EFI_STATUS       Status;
   EFI_MEMORY_TYPE  MemoryType;
+  UINT64           StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceFreePages);
 
   Status = CoreInternalFreePages (Memory, NumberOfPages, &MemoryType);
   if (!EFI_ERROR (Status)) {
@@ -1637,6 +1848,7 @@ CoreFreePages (
       );
   }
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceFreePages, StatisticsStart);
   return Status;
 }
 
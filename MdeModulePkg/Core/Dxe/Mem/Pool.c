@@ -19,6 +19,12 @@ typedef struct {
   LIST_ENTRY    Link;
 } POOL_FREE;
 
+//
+// An empty pool page kept on POOL.EmptyPages is tagged with this signature
+// in its first POOL_FREE, so it is never mistaken for a free pool entry.
+//
+#define POOL_EMPTY_PAGE_SIGNATURE  SIGNATURE_32('p','e','p','0')
+
 #define POOL_HEAD_SIGNATURE      SIGNATURE_32('p','h','d','0')
 #define POOLPAGE_HEAD_SIGNATURE  SIGNATURE_32('p','h','d','1')
 typedef struct {
@@ -70,6 +76,11 @@ typedef struct {
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
   LIST_ENTRY         Link;
+  ///
+  /// Fully freed pool pages kept for reuse, see PcdPoolEmptyPageCacheCount
+  ///
+  LIST_ENTRY         EmptyPages;
+  UINTN              EmptyPageCount;
 } POOL;
 
 //
@@ -120,12 +131,15 @@ CoreInitializePool (
   UINTN  Index;
 
   for (Type = 0; Type < EfiMaxMemoryType; Type++) {
-    mPoolHead[Type].Signature  = 0;
-    mPoolHead[Type].Used       = 0;
-    mPoolHead[Type].MemoryType = (EFI_MEMORY_TYPE)Type;
+    mPoolHead[Type].Signature      = 0;
+    mPoolHead[Type].Used           = 0;
+    mPoolHead[Type].MemoryType     = (EFI_MEMORY_TYPE)Type;
+    mPoolHead[Type].EmptyPageCount = 0;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+
+    InitializeListHead (&mPoolHead[Type].EmptyPages);
   }
 }
 
@@ -168,13 +182,16 @@ LookupPoolHead (
       return NULL;
     }
 
-    Pool->Signature  = POOL_SIGNATURE;
-    Pool->Used       = 0;
-    Pool->MemoryType = MemoryType;
+    Pool->Signature      = POOL_SIGNATURE;
+    Pool->Used           = 0;
+    Pool->MemoryType     = MemoryType;
+    Pool->EmptyPageCount = 0;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
     }
 
+    InitializeListHead (&Pool->EmptyPages);
+
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
     return Pool;
@@ -232,7 +249,7 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding;
+  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding && IsGuardSampled ();
 
   //
   // Acquire the memory lock and make the allocation
@@ -271,6 +288,9 @@ CoreAllocatePool (
   )
 {
   EFI_STATUS  Status;
+  UINT64      StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceAllocatePool);
 
   Status = CoreInternalAllocatePool (PoolType, Size, Buffer);
   if (!EFI_ERROR (Status)) {
@@ -285,6 +305,7 @@ CoreAllocatePool (
     InstallMemoryAttributesTableOnMemoryAllocation (PoolType);
   }
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceAllocatePool, StatisticsStart);
   return Status;
 }
 
@@ -336,6 +357,32 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Checks whether fully freed pool pages of a pool may be
+  kept for reuse instead of being returned to the page allocator.
+
+  Only pools of the standard memory types with the default granularity use
+  the cache, so runtime and OS/OEM pools never pin extra pages.
+
+  @param  Pool                   The pool the pages belong to
+  @param  Granularity            The page allocation granularity of the pool
+
+  @retval TRUE                   Empty pages of this pool may be cached.
+  @retval FALSE                  Empty pages of this pool must be freed.
+
+**/
+STATIC
+BOOLEAN
+IsPoolEmptyPageCacheable (
+  IN POOL   *Pool,
+  IN UINTN  Granularity
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdPoolEmptyPageCacheCount) != 0) &&
+                   ((UINT32)Pool->MemoryType < EfiMaxMemoryType) &&
+                   (Granularity == DEFAULT_PAGE_ALLOCATION_GRANULARITY));
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -444,8 +491,16 @@ CoreAllocatePoolI (
     }
 
     //
-    // Get another page
+    // Get another page, reusing a cached empty page of this pool if any
     //
+    if (!IsListEmpty (&Pool->EmptyPages)) {
+      Free = CR (Pool->EmptyPages.ForwardLink, POOL_FREE, Link, POOL_EMPTY_PAGE_SIGNATURE);
+      RemoveEntryList (&Free->Link);
+      Pool->EmptyPageCount--;
+      NewPage = (CHAR8 *)Free;
+      goto Carve;
+    }
+
     NewPage = CoreAllocatePoolPagesI (
                 PoolType,
                 EFI_SIZE_TO_PAGES (Granularity),
@@ -583,6 +638,9 @@ CoreFreePool (
 {
   EFI_STATUS       Status;
   EFI_MEMORY_TYPE  PoolType;
+  UINT64           StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceFreePool);
 
   Status = CoreInternalFreePool (Buffer, &PoolType);
   if (!EFI_ERROR (Status)) {
@@ -597,6 +655,7 @@ CoreFreePool (
     InstallMemoryAttributesTableOnMemoryAllocation (PoolType);
   }
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceFreePool, StatisticsStart);
   return Status;
 }
 
@@ -846,13 +905,24 @@ CoreFreePoolI (
         }
 
         //
-        // Free the page
+        // Keep the page for the next allocation while the cache of this
+        // pool has room, otherwise free the page
         //
-        CoreFreePoolPagesI (
-          Pool->MemoryType,
-          (EFI_PHYSICAL_ADDRESS)(UINTN)NewPage,
-          EFI_SIZE_TO_PAGES (Granularity)
-          );
+        if (IsPoolEmptyPageCacheable (Pool, Granularity) &&
+            (Pool->EmptyPageCount < PcdGet8 (PcdPoolEmptyPageCacheCount)))
+        {
+          Free            = (POOL_FREE *)&NewPage[0];
+          Free->Signature = POOL_EMPTY_PAGE_SIGNATURE;
+          Free->Index     = 0;
+          InsertHeadList (&Pool->EmptyPages, &Free->Link);
+          Pool->EmptyPageCount++;
+        } else {
+          CoreFreePoolPagesI (
+            Pool->MemoryType,
+            (EFI_PHYSICAL_ADDRESS)(UINTN)NewPage,
+            EFI_SIZE_TO_PAGES (Granularity)
+            );
+        }
       }
     }
   }
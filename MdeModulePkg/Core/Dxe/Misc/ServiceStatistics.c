@@ -0,0 +1,156 @@
+/** @file
+  Call counts and cumulative time of the hot DXE Core services.
+
+  With PcdDxeCoreServiceStatistics, the memory allocation, protocol lookup,
+  event, section extraction and TPL services count their calls and the
+  performance counter ticks spent in them, from the installation of the
+  statistics configuration table on. Without it, the hooks compile to nothing.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+//
+// The names of the services in the table, in CORE_SERVICE_ID order.
+//
+STATIC CONST CHAR8  *mCoreServiceNames[CoreServiceMax] = {
+  "AllocatePages",
+  "FreePages",
+  "AllocatePool",
+  "FreePool",
+  "LocateProtocol",
+  "LocateHandleBuffer",
+  "OpenProtocol",
+  "InstallProtocol",
+  "SignalEvent",
+  "DispatchEventNotifies",
+  "GetSection",
+  "RaiseTpl",
+  "RestoreTpl"
+};
+
+//
+// The configuration table, its entries follow the header.
+//
+typedef struct {
+  DXE_CORE_SERVICE_STATISTICS          Header;
+  DXE_CORE_SERVICE_STATISTICS_ENTRY    Entries[CoreServiceMax - 1];
+} CORE_SERVICE_STATISTICS_TABLE;
+
+STATIC CORE_SERVICE_STATISTICS_TABLE  mCoreServiceStatistics;
+
+//
+// The nesting depth of each service, only the outermost call is timed.
+//
+STATIC UINT32  mCoreServiceDepth[CoreServiceMax];
+
+STATIC BOOLEAN  mCoreServiceStatisticsStarted = FALSE;
+STATIC UINT64   mCoreServiceCounterStart;
+STATIC UINT64   mCoreServiceCounterEnd;
+
+/**
+  Start timing a call of a DXE Core service.
+
+  @param  Service   The service called.
+
+  @return The performance counter at the start of the call.
+
+**/
+UINT64
+CoreServiceStatisticsStart (
+  IN CORE_SERVICE_ID  Service
+  )
+{
+  if (!mCoreServiceStatisticsStarted) {
+    return 0;
+  }
+
+  mCoreServiceStatistics.Header.Entry[Service].Calls++;
+  if (mCoreServiceDepth[Service]++ != 0) {
+    return 0;
+  }
+
+  return GetPerformanceCounter ();
+}
+
+/**
+  Stop timing a call of a DXE Core service, and accumulate its time.
+
+  @param  Service   The service called.
+  @param  Start     The value returned by CoreServiceStatisticsStart().
+
+**/
+VOID
+CoreServiceStatisticsEnd (
+  IN CORE_SERVICE_ID  Service,
+  IN UINT64           Start
+  )
+{
+  UINT64  End;
+
+  if (!mCoreServiceStatisticsStarted || (mCoreServiceDepth[Service] == 0)) {
+    return;
+  }
+
+  if (--mCoreServiceDepth[Service] != 0) {
+    return;
+  }
+
+  End = GetPerformanceCounter ();
+  if (mCoreServiceCounterEnd >= mCoreServiceCounterStart) {
+    if (End >= Start) {
+      mCoreServiceStatistics.Header.Entry[Service].Ticks += End - Start;
+    } else {
+      mCoreServiceStatistics.Header.Entry[Service].Ticks += (mCoreServiceCounterEnd - Start) + (End - mCoreServiceCounterStart) + 1;
+    }
+  } else {
+    if (Start >= End) {
+      mCoreServiceStatistics.Header.Entry[Service].Ticks += Start - End;
+    } else {
+      mCoreServiceStatistics.Header.Entry[Service].Ticks += (Start - mCoreServiceCounterEnd) + (mCoreServiceCounterStart - End) + 1;
+    }
+  }
+}
+
+/**
+  Start collecting the DXE Core service statistics, and install them into the
+  EFI System Table's Configuration Table.
+
+  This must be called after the library constructors of the DXE Core, when the
+  performance counter of TimerLib is available.
+
+**/
+VOID
+CoreInstallServiceStatisticsTable (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  if (!FeaturePcdGet (PcdDxeCoreServiceStatistics)) {
+    return;
+  }
+
+  mCoreServiceStatistics.Header.Revision  = DXE_CORE_SERVICE_STATISTICS_REVISION;
+  mCoreServiceStatistics.Header.Count     = CoreServiceMax;
+  mCoreServiceStatistics.Header.Frequency = GetPerformanceCounterProperties (
+                                              &mCoreServiceCounterStart,
+                                              &mCoreServiceCounterEnd
+                                              );
+  for (Index = 0; Index < CoreServiceMax; Index++) {
+    AsciiStrCpyS (
+      mCoreServiceStatistics.Header.Entry[Index].Name,
+      DXE_CORE_SERVICE_STATISTICS_NAME_SIZE,
+      mCoreServiceNames[Index]
+      );
+  }
+
+  mCoreServiceStatisticsStarted = TRUE;
+
+  Status = CoreInstallConfigurationTable (&gEdkiiDxeCoreServiceStatisticsGuid, &mCoreServiceStatistics);
+  ASSERT_EFI_ERROR (Status);
+}
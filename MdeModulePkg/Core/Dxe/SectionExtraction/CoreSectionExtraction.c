@@ -92,6 +92,30 @@ typedef struct {
   VOID                        *Registration;
 } RPN_EVENT_CONTEXT;
 
+#define CORE_SECTION_PREFETCH_SIGNATURE  SIGNATURE_32('S','X','P','F')
+#define SECTION_PREFETCH_FROM_LINK(Node) \
+  CR (Node, CORE_SECTION_PREFETCH_NODE, Link, CORE_SECTION_PREFETCH_SIGNATURE)
+
+typedef struct {
+  UINT32              Signature;
+  LIST_ENTRY          Link;
+  //
+  // Private copy of the GUIDed section being decompressed on an AP
+  //
+  VOID                *InputSection;
+  UINTN               InputSize;
+  VOID                *AllocatedOutputBuffer;
+  VOID                *ScratchBuffer;
+  UINT32              OutputSize;
+  //
+  // Written by the AP. Done is set once everything else is valid.
+  //
+  VOID                *OutputBuffer;
+  UINT32              AuthenticationStatus;
+  EFI_STATUS          Status;
+  volatile BOOLEAN    Done;
+} CORE_SECTION_PREFETCH_NODE;
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -196,6 +220,20 @@ EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol =
   CustomGuidedSectionExtract
 };
 
+//
+// GUIDed sections being, or already, decompressed on the APs
+//
+LIST_ENTRY  mSectionPrefetchList = INITIALIZE_LIST_HEAD_VARIABLE (mSectionPrefetchList);
+
+EFI_MP_SERVICES_PROTOCOL  *mSectionPrefetchMpServices = NULL;
+UINTN                     mSectionPrefetchProcessorCount;
+UINTN                     mSectionPrefetchBspNumber;
+UINTN                     mSectionPrefetchNextProcessor;
+//
+// One completion event per processor, reused for every request handed to it
+//
+EFI_EVENT  *mSectionPrefetchEvents = NULL;
+
 /**
   Entry point of the section extraction code. Initializes an instance of the
   section extraction interface and installs it on a new handle.
@@ -1261,6 +1299,9 @@ GetSection (
   UINT8                      *CopyBuffer;
   UINTN                      SectionSize;
   EFI_COMMON_SECTION_HEADER  *Section;
+  UINT64                     StatisticsStart;
+
+  StatisticsStart = CORE_SERVICE_STATISTICS_START (CoreServiceGetSection);
 
   ChildStreamNode = NULL;
   OldTpl          = CoreRaiseTpl (TPL_NOTIFY);
@@ -1361,6 +1402,7 @@ GetSection (
 GetSection_Done:
   CoreRestoreTpl (OldTpl);
 
+  CORE_SERVICE_STATISTICS_END (CoreServiceGetSection, StatisticsStart);
   return Status;
 }
 
@@ -1456,6 +1498,364 @@ CloseSectionStream (
   return Status;
 }
 
+/**
+  Return the size of a section, including its header.
+
+  @param  Section               The section header.
+
+  @return The size of the section.
+
+**/
+UINTN
+CoreGetSectionLength (
+  IN EFI_COMMON_SECTION_HEADER  *Section
+  )
+{
+  if (IS_SECTION2 (Section)) {
+    return SECTION2_SIZE (Section);
+  }
+
+  return SECTION_SIZE (Section);
+}
+
+/**
+  Decompress a prefetched GUIDed section. Runs on an AP, so it must not use
+  any boot service.
+
+  @param  Buffer                The CORE_SECTION_PREFETCH_NODE to decompress.
+
+**/
+VOID
+EFIAPI
+CoreDecodeSectionOnAp (
+  IN OUT VOID  *Buffer
+  )
+{
+  CORE_SECTION_PREFETCH_NODE  *Node;
+
+  Node               = (CORE_SECTION_PREFETCH_NODE *)Buffer;
+  Node->OutputBuffer = Node->AllocatedOutputBuffer;
+  Node->Status       = ExtractGuidedSectionDecode (
+                         Node->InputSection,
+                         &Node->OutputBuffer,
+                         Node->ScratchBuffer,
+                         &Node->AuthenticationStatus
+                         );
+  MemoryFence ();
+  Node->Done = TRUE;
+}
+
+/**
+  Free a prefetch node and all the buffers it owns, except the output buffer
+  when it has been handed over to the caller.
+
+  @param  Node                  The prefetch node to free.
+
+**/
+VOID
+CoreFreeSectionPrefetchNode (
+  IN CORE_SECTION_PREFETCH_NODE  *Node
+  )
+{
+  if (Node->AllocatedOutputBuffer != NULL) {
+    CoreFreePool (Node->AllocatedOutputBuffer);
+  }
+
+  if (Node->ScratchBuffer != NULL) {
+    CoreFreePool (Node->ScratchBuffer);
+  }
+
+  CoreFreePool (Node->InputSection);
+  CoreFreePool (Node);
+}
+
+/**
+  Hand a prefetch node to the next idle AP.
+
+  @param  Node                  The prefetch node to decompress.
+
+  @retval EFI_SUCCESS           An AP is decompressing the section.
+  @retval EFI_NOT_READY         No AP is available.
+
+**/
+EFI_STATUS
+CoreStartSectionDecodeOnAp (
+  IN CORE_SECTION_PREFETCH_NODE  *Node
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       EnabledProcessorCount;
+  UINTN       Index;
+  UINTN       ProcessorNumber;
+
+  if (mSectionPrefetchMpServices == NULL) {
+    Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mSectionPrefetchMpServices);
+    if (EFI_ERROR (Status)) {
+      mSectionPrefetchMpServices = NULL;
+      return EFI_NOT_READY;
+    }
+
+    Status = mSectionPrefetchMpServices->GetNumberOfProcessors (
+                                           mSectionPrefetchMpServices,
+                                           &mSectionPrefetchProcessorCount,
+                                           &EnabledProcessorCount
+                                           );
+    if (!EFI_ERROR (Status)) {
+      Status = mSectionPrefetchMpServices->WhoAmI (mSectionPrefetchMpServices, &mSectionPrefetchBspNumber);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      mSectionPrefetchEvents = AllocateZeroPool (mSectionPrefetchProcessorCount * sizeof (EFI_EVENT));
+    }
+
+    if (mSectionPrefetchEvents == NULL) {
+      mSectionPrefetchProcessorCount = 0;
+    }
+  }
+
+  for (Index = 0; Index < mSectionPrefetchProcessorCount; Index++) {
+    ProcessorNumber               = mSectionPrefetchNextProcessor;
+    mSectionPrefetchNextProcessor = (mSectionPrefetchNextProcessor + 1) % mSectionPrefetchProcessorCount;
+    if (ProcessorNumber == mSectionPrefetchBspNumber) {
+      continue;
+    }
+
+    if (mSectionPrefetchEvents[ProcessorNumber] == NULL) {
+      Status = CoreCreateEvent (
+                 EVT_NOTIFY_SIGNAL,
+                 TPL_CALLBACK,
+                 EfiEventEmptyFunction,
+                 NULL,
+                 &mSectionPrefetchEvents[ProcessorNumber]
+                 );
+      if (EFI_ERROR (Status)) {
+        mSectionPrefetchEvents[ProcessorNumber] = NULL;
+        continue;
+      }
+    }
+
+    //
+    // A busy or disabled AP fails the request, so simply try the next one
+    //
+    Status = mSectionPrefetchMpServices->StartupThisAP (
+                                           mSectionPrefetchMpServices,
+                                           CoreDecodeSectionOnAp,
+                                           ProcessorNumber,
+                                           mSectionPrefetchEvents[ProcessorNumber],
+                                           0,
+                                           Node,
+                                           NULL
+                                           );
+    if (!EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Start decompressing a GUIDed section on an AP, if the section uses an
+  algorithm known to run without boot services.
+
+  @param  Section               The GUIDed section.
+  @param  SectionLength         The size of the section, including its header.
+
+**/
+VOID
+CoreStartSectionPrefetch (
+  IN EFI_COMMON_SECTION_HEADER  *Section,
+  IN UINTN                      SectionLength
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_GUID                    *SectionDefinitionGuid;
+  CORE_SECTION_PREFETCH_NODE  *Node;
+  UINT32                      ScratchSize;
+  UINT16                      SectionAttribute;
+
+  if (IS_SECTION2 (Section)) {
+    SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+  } else {
+    SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+  }
+
+  if (!CompareGuid (SectionDefinitionGuid, &gLzmaCustomDecompressGuid) &&
+      !CompareGuid (SectionDefinitionGuid, &gLzmaF86CustomDecompressGuid))
+  {
+    return;
+  }
+
+  Node = AllocateZeroPool (sizeof (CORE_SECTION_PREFETCH_NODE));
+  if (Node == NULL) {
+    return;
+  }
+
+  Node->Signature    = CORE_SECTION_PREFETCH_SIGNATURE;
+  Node->InputSize    = SectionLength;
+  Node->InputSection = AllocateCopyPool (SectionLength, Section);
+  if (Node->InputSection == NULL) {
+    CoreFreePool (Node);
+    return;
+  }
+
+  Status = ExtractGuidedSectionGetInfo (
+             Node->InputSection,
+             &Node->OutputSize,
+             &ScratchSize,
+             &SectionAttribute
+             );
+  if (EFI_ERROR (Status) || (Node->OutputSize == 0)) {
+    CoreFreeSectionPrefetchNode (Node);
+    return;
+  }
+
+  Node->AllocatedOutputBuffer = AllocatePool (Node->OutputSize);
+  if (ScratchSize > 0) {
+    Node->ScratchBuffer = AllocatePool (ScratchSize);
+  }
+
+  if ((Node->AllocatedOutputBuffer == NULL) || ((ScratchSize > 0) && (Node->ScratchBuffer == NULL))) {
+    CoreFreeSectionPrefetchNode (Node);
+    return;
+  }
+
+  InsertTailList (&mSectionPrefetchList, &Node->Link);
+  if (EFI_ERROR (CoreStartSectionDecodeOnAp (Node))) {
+    RemoveEntryList (&Node->Link);
+    CoreFreeSectionPrefetchNode (Node);
+  }
+}
+
+/**
+  Start decompressing the top level GUIDed sections of a firmware file on the
+  application processors, so that the result is ready when the file is read
+  through the section extraction code later.
+
+  @param  Fv                    The firmware volume containing the file.
+  @param  FileName              The file name GUID of the file.
+
+**/
+VOID
+CorePrefetchGuidedSections (
+  IN EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN EFI_GUID                       *FileName
+  )
+{
+  EFI_STATUS                 Status;
+  VOID                       *FileBuffer;
+  UINTN                      FileSize;
+  EFI_FV_FILETYPE            FileType;
+  EFI_FV_FILE_ATTRIBUTES     FileAttributes;
+  UINT32                     AuthenticationStatus;
+  UINTN                      Offset;
+  UINTN                      SectionLength;
+  EFI_COMMON_SECTION_HEADER  *Section;
+
+  if (!FeaturePcdGet (PcdDxeApSectionDecompression)) {
+    return;
+  }
+
+  FileBuffer = NULL;
+  FileSize   = 0;
+  Status     = Fv->ReadFile (
+                     Fv,
+                     FileName,
+                     &FileBuffer,
+                     &FileSize,
+                     &FileType,
+                     &FileAttributes,
+                     &AuthenticationStatus
+                     );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Offset = 0;
+  while (Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileSize) {
+    Section       = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)FileBuffer + Offset);
+    SectionLength = CoreGetSectionLength (Section);
+    if ((SectionLength < sizeof (EFI_COMMON_SECTION_HEADER)) || (SectionLength > FileSize - Offset)) {
+      break;
+    }
+
+    if (Section->Type == EFI_SECTION_GUID_DEFINED) {
+      CoreStartSectionPrefetch (Section, SectionLength);
+    }
+
+    Offset += ALIGN_VALUE (SectionLength, 4);
+  }
+
+  CoreFreePool (FileBuffer);
+}
+
+/**
+  Return the result of decompressing a GUIDed section on an AP, if the section
+  was prefetched. The prefetch node is consumed.
+
+  @param  InputSection          The GUIDed section to extract.
+  @param  OutputBuffer          Returns the pool buffer holding the section contents.
+  @param  OutputSize            Returns the size of OutputBuffer.
+  @param  AuthenticationStatus  Returns the authentication status of the extraction.
+
+  @retval EFI_SUCCESS           The prefetched section contents were returned.
+  @retval EFI_NOT_FOUND         The section was not prefetched, or decompressing
+                                it on an AP failed.
+
+**/
+EFI_STATUS
+CoreGetPrefetchedSection (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       UINTN   *OutputSize,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  LIST_ENTRY                  *Link;
+  CORE_SECTION_PREFETCH_NODE  *Node;
+  UINTN                       SectionLength;
+
+  if (IsListEmpty (&mSectionPrefetchList)) {
+    return EFI_NOT_FOUND;
+  }
+
+  SectionLength = CoreGetSectionLength ((EFI_COMMON_SECTION_HEADER *)InputSection);
+  for (Link = mSectionPrefetchList.ForwardLink; Link != &mSectionPrefetchList; Link = Link->ForwardLink) {
+    Node = SECTION_PREFETCH_FROM_LINK (Link);
+    if ((Node->InputSize == SectionLength) &&
+        (CompareMem (Node->InputSection, InputSection, SectionLength) == 0))
+    {
+      break;
+    }
+  }
+
+  if (Link == &mSectionPrefetchList) {
+    return EFI_NOT_FOUND;
+  }
+
+  while (!Node->Done) {
+    CpuPause ();
+  }
+
+  RemoveEntryList (&Node->Link);
+  if (EFI_ERROR (Node->Status)) {
+    CoreFreeSectionPrefetchNode (Node);
+    return EFI_NOT_FOUND;
+  }
+
+  if (Node->OutputBuffer != Node->AllocatedOutputBuffer) {
+    CopyMem (Node->AllocatedOutputBuffer, Node->OutputBuffer, Node->OutputSize);
+  }
+
+  *OutputBuffer         = Node->AllocatedOutputBuffer;
+  *OutputSize           = Node->OutputSize;
+  *AuthenticationStatus = Node->AuthenticationStatus;
+
+  Node->AllocatedOutputBuffer = NULL;
+  CoreFreeSectionPrefetchNode (Node);
+  return EFI_SUCCESS;
+}
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -1556,6 +1956,13 @@ CustomGuidedSectionExtract (
   UINT32      ScratchBufferSize;
   UINT16      SectionAttribute;
 
+  //
+  // Use the result of an AP that already decompressed this section, if any
+  //
+  if (!EFI_ERROR (CoreGetPrefetchedSection (InputSection, OutputBuffer, OutputSize, AuthenticationStatus))) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Init local variable
   //
@@ -1651,3 +2058,4 @@ CustomGuidedSectionExtract (
 
   return EFI_SUCCESS;
 }
+
@@ -23,10 +23,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Ppi/RecoveryModule.h>
 #include <Ppi/CapsuleOnDisk.h>
 #include <Ppi/VectorHandoffInfo.h>
+#include <Ppi/MpServices.h>
 
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/MemoryAllocationHob.h>
 #include <Guid/FirmwareFileSystem2.h>
+#include <Guid/LzmaDecompress.h>
 
 #include <Library/DebugLib.h>
 #include <Library/PeimEntryPoint.h>
@@ -42,6 +44,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/PeiServicesTablePointerLib.h>
 #include <Library/PerformanceLib.h>
+#include <Library/SynchronizationLib.h>
 
 #define STACK_SIZE      0x20000
 #define BSP_STORE_SIZE  0x4000
@@ -198,6 +201,29 @@ CustomGuidedSectionExtract (
   OUT       UINT32                                 *AuthenticationStatus
   );
 
+/**
+  Get a section decoded on the APs.
+
+  The first request for a LZMA section of a FFS file decodes all the LZMA
+  sections of the file on the APs.
+
+  @param  InputSection          Buffer containing the input GUIDed section to be processed.
+  @param  OutputBuffer          Returns the decoded section contents.
+  @param  OutputSize            Returns the size of the decoded section contents.
+  @param  AuthenticationStatus  Returns the authentication status of the decoded section.
+
+  @retval EFI_SUCCESS           The section was decoded on the APs.
+  @retval EFI_NOT_FOUND         The section was not decoded on the APs.
+
+**/
+EFI_STATUS
+GetApDecodedSection (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       UINTN   *OutputSize,
+  OUT       UINT32  *AuthenticationStatus
+  );
+
 /**
    Decompresses a section to the output buffer.
 
@@ -586,6 +586,18 @@ CustomGuidedSectionExtract (
   //
   ScratchBuffer = NULL;
 
+  //
+  // The sections of a file may have been decoded on the APs already. DxeIpl is
+  // not shadowed to permanent memory on the S3 resume path, so its globals can
+  // not be updated there.
+  //
+  if (FeaturePcdGet (PcdPeiApSectionDecompression) && (GetBootModeHob () != BOOT_ON_S3_RESUME)) {
+    Status = GetApDecodedSection (InputSection, OutputBuffer, OutputSize, AuthenticationStatus);
+    if (!EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+  }
+
   //
   // Call GetInfo to get the size and attribute of input guided section data.
   //
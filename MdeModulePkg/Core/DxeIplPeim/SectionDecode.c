@@ -0,0 +1,329 @@
+/** @file
+  Decode the LZMA encapsulated sections of a firmware volume image file on all
+  APs at once.
+
+  A firmware volume image file may hold several independently compressed
+  firmware volume image sections. When the first of them is extracted, all the
+  LZMA sections of the file are decoded concurrently on the APs through the
+  EFI_PEI_MP_SERVICES_PPI, and the following extractions return the sections
+  already decoded.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeIpl.h"
+
+typedef struct {
+  CONST VOID                               *InputSection;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER    DecodeHandler;
+  VOID                                     *OutputBuffer;
+  UINT32                                   OutputBufferSize;
+  VOID                                     *ScratchBuffer;
+  UINT32                                   AuthenticationStatus;
+  RETURN_STATUS                            Status;
+} SECTION_DECODE_JOB;
+
+SECTION_DECODE_JOB  *mSectionDecodeJob     = NULL;
+UINT32              mSectionDecodeJobCount = 0;
+volatile UINT32     mSectionDecodeJobNext  = 0;
+
+/**
+  Find the FFS file that contains a section, in the firmware volumes known by the
+  PEI Core.
+
+  @param  Section       Pointer to the section.
+
+  @return The FFS file header, or NULL if the section is not in a known FFS file.
+
+**/
+EFI_FFS_FILE_HEADER *
+FindSectionFile (
+  IN CONST VOID  *Section
+  )
+{
+  UINTN                       Instance;
+  EFI_PEI_FV_HANDLE           VolumeHandle;
+  EFI_PEI_FILE_HANDLE         FileHandle;
+  EFI_FIRMWARE_VOLUME_HEADER  *FvHeader;
+  EFI_FFS_FILE_HEADER         *FfsFileHeader;
+  UINTN                       FileSize;
+
+  for (Instance = 0; !EFI_ERROR (PeiServicesFfsFindNextVolume (Instance, &VolumeHandle)); Instance++) {
+    FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)VolumeHandle;
+    if (((UINTN)Section < (UINTN)FvHeader) || ((UINTN)Section >= (UINTN)FvHeader + FvHeader->FvLength)) {
+      continue;
+    }
+
+    FileHandle = NULL;
+    while (!EFI_ERROR (PeiServicesFfsFindNextFile (EFI_FV_FILETYPE_ALL, VolumeHandle, &FileHandle))) {
+      FfsFileHeader = (EFI_FFS_FILE_HEADER *)FileHandle;
+      FileSize      = IS_FFS_FILE2 (FfsFileHeader) ? FFS_FILE2_SIZE (FfsFileHeader) : FFS_FILE_SIZE (FfsFileHeader);
+      if (((UINTN)Section >= (UINTN)FfsFileHeader) && ((UINTN)Section < (UINTN)FfsFileHeader + FileSize)) {
+        return FfsFileHeader;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Check if a section is a LZMA encapsulated section, and get its decode handler.
+
+  @param  Section       Pointer to the section.
+  @param  DecodeHandler Returns the decode handler of the section.
+
+  @retval TRUE          The section is a LZMA encapsulated section.
+  @retval FALSE         The section is not a LZMA encapsulated section.
+
+**/
+BOOLEAN
+IsLzmaSection (
+  IN  EFI_COMMON_SECTION_HEADER              *Section,
+  OUT EXTRACT_GUIDED_SECTION_DECODE_HANDLER  *DecodeHandler
+  )
+{
+  EFI_GUID  *SectionGuid;
+
+  if (Section->Type != EFI_SECTION_GUID_DEFINED) {
+    return FALSE;
+  }
+
+  if (IS_SECTION2 (Section)) {
+    SectionGuid = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+  } else {
+    SectionGuid = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+  }
+
+  if (!CompareGuid (SectionGuid, &gLzmaCustomDecompressGuid) &&
+      !CompareGuid (SectionGuid, &gLzmaF86CustomDecompressGuid))
+  {
+    return FALSE;
+  }
+
+  return !RETURN_ERROR (ExtractGuidedSectionGetHandlers (SectionGuid, NULL, DecodeHandler));
+}
+
+/**
+  Decode the queued sections until none is left. This is run on all APs, and
+  on the BSP to finish any section the APs did not.
+
+  The decode handlers of LZMA sections only work on the buffers given to them,
+  so they can run on APs, where PEI services are not available.
+
+  @param  Buffer        Not used.
+
+**/
+VOID
+EFIAPI
+DecodeQueuedSections (
+  IN OUT VOID  *Buffer
+  )
+{
+  UINT32              Index;
+  SECTION_DECODE_JOB  *Job;
+
+  for ( ; ;) {
+    Index = InterlockedIncrement (&mSectionDecodeJobNext) - 1;
+    if (Index >= mSectionDecodeJobCount) {
+      break;
+    }
+
+    Job         = &mSectionDecodeJob[Index];
+    Job->Status = Job->DecodeHandler (
+                         Job->InputSection,
+                         &Job->OutputBuffer,
+                         Job->ScratchBuffer,
+                         &Job->AuthenticationStatus
+                         );
+  }
+}
+
+/**
+  Queue the LZMA sections of a FFS file, and allocate their buffers.
+
+  @param  FfsFileHeader Pointer to the FFS file.
+  @param  Job           The jobs to fill in, or NULL to only count the sections.
+
+  @return The number of LZMA sections queued, or found if Job is NULL.
+
+**/
+UINT32
+QueueFileSections (
+  IN  EFI_FFS_FILE_HEADER  *FfsFileHeader,
+  OUT SECTION_DECODE_JOB   *Job  OPTIONAL
+  )
+{
+  RETURN_STATUS                          Status;
+  EFI_COMMON_SECTION_HEADER              *Section;
+  UINTN                                  SectionEnd;
+  UINTN                                  SectionSize;
+  UINT32                                 Count;
+  UINT32                                 ScratchBufferSize;
+  UINT16                                 SectionAttribute;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER  DecodeHandler;
+
+  if (IS_FFS_FILE2 (FfsFileHeader)) {
+    Section    = (EFI_COMMON_SECTION_HEADER *)((EFI_FFS_FILE_HEADER2 *)FfsFileHeader + 1);
+    SectionEnd = (UINTN)FfsFileHeader + FFS_FILE2_SIZE (FfsFileHeader);
+  } else {
+    Section    = (EFI_COMMON_SECTION_HEADER *)(FfsFileHeader + 1);
+    SectionEnd = (UINTN)FfsFileHeader + FFS_FILE_SIZE (FfsFileHeader);
+  }
+
+  Count = 0;
+  while ((UINTN)Section + sizeof (EFI_COMMON_SECTION_HEADER) <= SectionEnd) {
+    SectionSize = IS_SECTION2 (Section) ? SECTION2_SIZE (Section) : SECTION_SIZE (Section);
+    if ((SectionSize < sizeof (EFI_COMMON_SECTION_HEADER)) || ((UINTN)Section + SectionSize > SectionEnd)) {
+      break;
+    }
+
+    if (IsLzmaSection (Section, &DecodeHandler)) {
+      if (Job == NULL) {
+        Count++;
+      } else {
+        ZeroMem (&Job[Count], sizeof (SECTION_DECODE_JOB));
+        Job[Count].InputSection  = Section;
+        Job[Count].DecodeHandler = DecodeHandler;
+        Job[Count].Status        = RETURN_NOT_STARTED;
+        Status                   = ExtractGuidedSectionGetInfo (
+                                     Section,
+                                     &Job[Count].OutputBufferSize,
+                                     &ScratchBufferSize,
+                                     &SectionAttribute
+                                     );
+        if (!RETURN_ERROR (Status) && (Job[Count].OutputBufferSize != 0)) {
+          Job[Count].OutputBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Job[Count].OutputBufferSize));
+          if (ScratchBufferSize != 0) {
+            Job[Count].ScratchBuffer = AllocatePages (EFI_SIZE_TO_PAGES (ScratchBufferSize));
+          }
+
+          if ((Job[Count].OutputBuffer != NULL) && ((ScratchBufferSize == 0) || (Job[Count].ScratchBuffer != NULL))) {
+            Count++;
+          }
+        }
+      }
+    }
+
+    Section = (EFI_COMMON_SECTION_HEADER *)ALIGN_POINTER ((UINTN)Section + SectionSize, 4);
+  }
+
+  return Count;
+}
+
+/**
+  Decode the LZMA sections of the FFS file holding a section on the APs.
+
+  @param  InputSection  Pointer to the section.
+
+**/
+VOID
+DecodeFileSectionsOnAps (
+  IN CONST VOID  *InputSection
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  EFI_FFS_FILE_HEADER      *FfsFileHeader;
+  UINT32                   Count;
+  SECTION_DECODE_JOB       *Job;
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  FfsFileHeader = FindSectionFile (InputSection);
+  if (FfsFileHeader == NULL) {
+    return;
+  }
+
+  //
+  // Only files with more than one LZMA section are worth waking the APs for.
+  //
+  Count = QueueFileSections (FfsFileHeader, NULL);
+  if (Count < 2) {
+    return;
+  }
+
+  Job = AllocatePool (Count * sizeof (SECTION_DECODE_JOB));
+  if (Job == NULL) {
+    return;
+  }
+
+  mSectionDecodeJob      = Job;
+  mSectionDecodeJobCount = QueueFileSections (FfsFileHeader, Job);
+  mSectionDecodeJobNext  = 0;
+
+  DEBUG ((DEBUG_INFO, "DxeIpl: Decoding %d LZMA sections of file %g on the APs\n", mSectionDecodeJobCount, &FfsFileHeader->Name));
+  MpServices->StartupAllAPs (
+                GetPeiServicesTablePointer (),
+                MpServices,
+                DecodeQueuedSections,
+                FALSE,
+                0,
+                NULL
+                );
+
+  //
+  // Finish whatever the APs did not decode, e.g. when no AP is enabled.
+  //
+  DecodeQueuedSections (NULL);
+}
+
+/**
+  Get a section decoded on the APs.
+
+  The first request for a LZMA section of a FFS file decodes all the LZMA
+  sections of the file on the APs.
+
+  @param  InputSection          Buffer containing the input GUIDed section to be processed.
+  @param  OutputBuffer          Returns the decoded section contents.
+  @param  OutputSize            Returns the size of the decoded section contents.
+  @param  AuthenticationStatus  Returns the authentication status of the decoded section.
+
+  @retval EFI_SUCCESS           The section was decoded on the APs.
+  @retval EFI_NOT_FOUND         The section was not decoded on the APs.
+
+**/
+EFI_STATUS
+GetApDecodedSection (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       UINTN   *OutputSize,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  UINT32                                 Index;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER  DecodeHandler;
+
+  if (!IsLzmaSection ((EFI_COMMON_SECTION_HEADER *)InputSection, &DecodeHandler)) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < mSectionDecodeJobCount; Index++) {
+    if (mSectionDecodeJob[Index].InputSection == InputSection) {
+      break;
+    }
+  }
+
+  if (Index == mSectionDecodeJobCount) {
+    DecodeFileSectionsOnAps (InputSection);
+    for (Index = 0; Index < mSectionDecodeJobCount; Index++) {
+      if (mSectionDecodeJob[Index].InputSection == InputSection) {
+        break;
+      }
+    }
+  }
+
+  if ((Index == mSectionDecodeJobCount) || RETURN_ERROR (mSectionDecodeJob[Index].Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  *OutputBuffer         = mSectionDecodeJob[Index].OutputBuffer;
+  *OutputSize           = mSectionDecodeJob[Index].OutputBufferSize;
+  *AuthenticationStatus = mSectionDecodeJob[Index].AuthenticationStatus;
+  return EFI_SUCCESS;
+}
@@ -1693,6 +1693,101 @@ PeiFfsFvPpiFindFileByType (
   return FindFileEx (FvHandle, NULL, SearchType, FileHandle, NULL);
 }
 
+/**
+  Build the file name index of a FV, so that files can be found by name
+  without reading every FFS header of the FV again.
+
+  @param CoreFvHandle    The FV to build the index for.
+
+**/
+VOID
+BuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PEI_FILE_HANDLE  FileHandle;
+  UINTN                Count;
+
+  CoreFvHandle->FileIndexBuilt = TRUE;
+
+  //
+  // Count the valid files first, as PEI pool can not be freed or grown
+  //
+  Count      = 0;
+  FileHandle = NULL;
+  while (!EFI_ERROR (FindFileEx (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    Count++;
+  }
+
+  if (Count == 0) {
+    return;
+  }
+
+  CoreFvHandle->FileIndex = AllocatePool (Count * sizeof (PEI_CORE_FV_FILE_INDEX_ENTRY));
+  if (CoreFvHandle->FileIndex == NULL) {
+    return;
+  }
+
+  FileHandle = NULL;
+  while (CoreFvHandle->FileIndexCount < Count) {
+    Status = FindFileEx (CoreFvHandle->FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    CoreFvHandle->FileIndex[CoreFvHandle->FileIndexCount].NameData1 = ((EFI_FFS_FILE_HEADER *)FileHandle)->Name.Data1;
+    CoreFvHandle->FileIndex[CoreFvHandle->FileIndexCount].Offset    = (UINT32)((UINTN)FileHandle - (UINTN)CoreFvHandle->FvHeader);
+    CoreFvHandle->FileIndexCount++;
+  }
+}
+
+/**
+  Find a file within a FV by its name, through the file name index of the FV.
+  The first file of the FV with the given name is returned, as by FindFileEx().
+
+  @param CoreFvHandle    The FV to search.
+  @param FileName        The name of the file.
+  @param FileHandle      Returns the handle of the file.
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  The file was not found.
+
+**/
+EFI_STATUS
+FindFileByNameInIndex (
+  IN  PEI_CORE_FV_HANDLE   *CoreFvHandle,
+  IN  CONST EFI_GUID       *FileName,
+  OUT EFI_PEI_FILE_HANDLE  *FileHandle
+  )
+{
+  UINTN                Index;
+  EFI_FFS_FILE_HEADER  *FfsFileHeader;
+
+  if (!CoreFvHandle->FileIndexBuilt) {
+    BuildFvFileIndex (CoreFvHandle);
+  }
+
+  if (CoreFvHandle->FileIndex == NULL) {
+    *FileHandle = NULL;
+    return FindFileEx (CoreFvHandle->FvHandle, FileName, 0, FileHandle, NULL);
+  }
+
+  for (Index = 0; Index < CoreFvHandle->FileIndexCount; Index++) {
+    if (CoreFvHandle->FileIndex[Index].NameData1 != FileName->Data1) {
+      continue;
+    }
+
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)CoreFvHandle->FvHeader + CoreFvHandle->FileIndex[Index].Offset);
+    if (CompareGuid (&FfsFileHeader->Name, FileName)) {
+      *FileHandle = (EFI_PEI_FILE_HANDLE)FfsFileHeader;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
 /**
   Find a file within a volume by its name.
 
@@ -1727,16 +1822,23 @@ PeiFfsFvPpiFindFileByName (
   OUT EFI_PEI_FILE_HANDLE                 *FileHandle
   )
 {
-  EFI_STATUS         Status;
-  PEI_CORE_INSTANCE  *PrivateData;
-  UINTN              Index;
+  EFI_STATUS          Status;
+  PEI_CORE_INSTANCE   *PrivateData;
+  PEI_CORE_FV_HANDLE  *CoreFvHandle;
+  UINTN               Index;
 
   if ((FvHandle == NULL) || (FileName == NULL) || (FileHandle == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
   if (*FvHandle != NULL) {
-    Status = FindFileEx (*FvHandle, FileName, 0, FileHandle, NULL);
+    CoreFvHandle = FvHandleToCoreHandle (*FvHandle);
+    if (CoreFvHandle != NULL) {
+      Status = FindFileByNameInIndex (CoreFvHandle, FileName, FileHandle);
+    } else {
+      Status = FindFileEx (*FvHandle, FileName, 0, FileHandle, NULL);
+    }
+
     if (Status == EFI_NOT_FOUND) {
       *FileHandle = NULL;
     }
@@ -1752,7 +1854,7 @@ PeiFfsFvPpiFindFileByName (
       // Only search the FV which is associated with a EFI_PEI_FIRMWARE_VOLUME_PPI instance.
       //
       if (PrivateData->Fv[Index].FvPpi != NULL) {
-        Status = FindFileEx (PrivateData->Fv[Index].FvHandle, FileName, 0, FileHandle, NULL);
+        Status = FindFileByNameInIndex (&PrivateData->Fv[Index], FileName, FileHandle);
         if (!EFI_ERROR (Status)) {
           *FvHandle = PrivateData->Fv[Index].FvHandle;
           break;
@@ -300,6 +300,25 @@ FindFileEx (
   IN OUT    EFI_PEI_FILE_HANDLE  *AprioriFile  OPTIONAL
   );
 
+/**
+  Find a file within a FV by its name, through the file name index of the FV.
+  The first file of the FV with the given name is returned, as by FindFileEx().
+
+  @param CoreFvHandle    The FV to search.
+  @param FileName        The name of the file.
+  @param FileHandle      Returns the handle of the file.
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  The file was not found.
+
+**/
+EFI_STATUS
+FindFileByNameInIndex (
+  IN  PEI_CORE_FV_HANDLE   *CoreFvHandle,
+  IN  CONST EFI_GUID       *FileName,
+  OUT EFI_PEI_FILE_HANDLE  *FileHandle
+  );
+
 /**
   Report the information for a newly discovered FV in an unknown format.
 
@@ -68,6 +68,12 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP  32
 #define DISPATCH_NOTIFY_GROWTH_STEP  8
 
+///
+/// Minimum number of slots in the PPI hash. The hash is kept at least twice
+/// as large as the PPI list so that probe sequences stay short.
+///
+#define PPI_HASH_MIN_SIZE  128
+
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
@@ -76,6 +82,14 @@ typedef struct {
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS    *PpiPtrs;
+  ///
+  /// Open addressed hash on the first 32 bits of the PPI GUIDs. Each of the
+  /// HashSize slots holds the PpiPtrs index of a PPI plus one, or zero if the
+  /// slot is free. Only indexes are stored, so nothing in the hash needs to be
+  /// converted when the PPI descriptors are migrated.
+  ///
+  UINTN                    HashSize;
+  UINT16                   *HashSlots;
 } PEI_PPI_LIST;
 
 typedef struct {
@@ -131,6 +145,15 @@ typedef struct {
 //
 #define FV_GROWTH_STEP  8
 
+//
+// Entry of the file name index of a FV. The offset is relative to the FV
+// header, so that the index stays valid when the FV is migrated.
+//
+typedef struct {
+  UINT32    NameData1;
+  UINT32    Offset;
+} PEI_CORE_FV_FILE_INDEX_ENTRY;
+
 typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER     *FvHeader;
   EFI_PEI_FIRMWARE_VOLUME_PPI    *FvPpi;
@@ -146,6 +169,13 @@ typedef struct {
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // Index of the valid files of the FV, in FV order, built by the first
+  // lookup by name. FileIndexBuilt is also set if there is no room for it.
+  //
+  BOOLEAN                        FileIndexBuilt;
+  UINTN                          FileIndexCount;
+  PEI_CORE_FV_FILE_INDEX_ENTRY   *FileIndex;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
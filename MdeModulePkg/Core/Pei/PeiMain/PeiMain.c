@@ -219,6 +219,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs + OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.HashSlots != NULL) {
+          OldCoreData->PpiData.PpiList.HashSlots = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.HashSlots + OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs + OldCoreData->HeapOffset);
         }
@@ -236,6 +240,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (PEI_CORE_FV_FILE_INDEX_ENTRY *)((UINT8 *)OldCoreData->Fv[Index].FileIndex + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -254,6 +262,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs - OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.HashSlots != NULL) {
+          OldCoreData->PpiData.PpiList.HashSlots = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.HashSlots - OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs - OldCoreData->HeapOffset);
         }
@@ -271,6 +283,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (PEI_CORE_FV_FILE_INDEX_ENTRY *)((UINT8 *)OldCoreData->Fv[Index].FileIndex - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -427,6 +427,105 @@ DumpPpiList (
   DEBUG_CODE_END ();
 }
 
+/**
+
+  Get the first slot of the probe sequence of a GUID in the PPI hash.
+
+  @param Guid            Pointer to the GUID.
+  @param HashSize        Number of slots of the PPI hash, a power of two.
+
+  @return The index of the first slot to probe.
+
+**/
+UINTN
+PpiHashFirstSlot (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           HashSize
+  )
+{
+  UINT32  Key;
+
+  Key = ((UINT32 *)Guid)[0];
+  return (UINTN)(Key ^ (Key >> 16)) & (HashSize - 1);
+}
+
+/**
+
+  Add a PPI of the PPI list to the PPI hash.
+
+  @param PpiListPointer  Pointer to the PPI list.
+  @param Index           Index of the PPI in the PPI list.
+
+**/
+VOID
+PpiHashInsert (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         Index
+  )
+{
+  UINTN  Slot;
+
+  Slot = PpiHashFirstSlot (PpiListPointer->PpiPtrs[Index].Ppi->Guid, PpiListPointer->HashSize);
+  while (PpiListPointer->HashSlots[Slot] != 0) {
+    Slot = (Slot + 1) & (PpiListPointer->HashSize - 1);
+  }
+
+  PpiListPointer->HashSlots[Slot] = (UINT16)(Index + 1);
+}
+
+/**
+
+  Add the PPIs installed since FirstIndex to the PPI hash. The hash is rebuilt,
+  and grown if needed, when FirstIndex is zero or when the PPI list has outgrown
+  the hash. Lookups fall back to a scan of the PPI list if the hash can not be
+  allocated.
+
+  @param PpiListPointer  Pointer to the PPI list.
+  @param FirstIndex      Index of the first PPI not in the hash yet.
+
+**/
+VOID
+PpiHashUpdate (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         FirstIndex
+  )
+{
+  UINTN  HashSize;
+  UINTN  Index;
+
+  if (PpiListPointer->MaxCount >= MAX_UINT16) {
+    PpiListPointer->HashSlots = NULL;
+    PpiListPointer->HashSize  = 0;
+    return;
+  }
+
+  HashSize = PpiListPointer->HashSize;
+  if (HashSize < PpiListPointer->MaxCount * 2) {
+    //
+    // PEI pool can not be freed, the old hash is simply dropped.
+    //
+    HashSize = MAX (PPI_HASH_MIN_SIZE, GetPowerOfTwo32 ((UINT32)PpiListPointer->MaxCount * 4 - 1));
+    PpiListPointer->HashSlots = AllocatePool (HashSize * sizeof (UINT16));
+    if (PpiListPointer->HashSlots == NULL) {
+      PpiListPointer->HashSize = 0;
+      return;
+    }
+
+    PpiListPointer->HashSize = HashSize;
+    FirstIndex               = 0;
+  } else if (PpiListPointer->HashSlots == NULL) {
+    return;
+  }
+
+  if (FirstIndex == 0) {
+    ZeroMem (PpiListPointer->HashSlots, HashSize * sizeof (UINT16));
+  }
+
+  for (Index = FirstIndex; Index < PpiListPointer->CurrentCount; Index++) {
+    PpiHashInsert (PpiListPointer, Index);
+  }
+}
+
 /**
 
   This function installs an interface in the PEI PPI database by GUID.
@@ -528,6 +627,8 @@ InternalPeiInstallPpi (
     PpiList++;
   }
 
+  PpiHashUpdate (PpiListPointer, LastCount);
+
   //
   // Process any callback level notifies for newly installed PPIs.
   //
@@ -625,6 +726,12 @@ PeiReInstallPpi (
   //
   DEBUG ((DEBUG_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  if (((UINT32 *)OldPpi->Guid)[0] != ((UINT32 *)NewPpi->Guid)[0]) {
+    //
+    // The PPI is hashed under another slot now.
+    //
+    PpiHashUpdate (&PrivateData->PpiData.PpiList, 0);
+  }
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -668,17 +775,41 @@ PeiLocatePpi (
   )
 {
   PEI_CORE_INSTANCE       *PrivateData;
+  PEI_PPI_LIST            *PpiListPointer;
   UINTN                   Index;
+  UINTN                   Slot;
   EFI_GUID                *CheckGuid;
   EFI_PEI_PPI_DESCRIPTOR  *TempPtr;
 
-  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PrivateData    = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PpiListPointer = &PrivateData->PpiData.PpiList;
 
   //
   // Search the data base for the matching instance of the GUIDed PPI.
+  // Instances of a GUID are found in the hash in the order they were
+  // installed, as the hash slots are never released.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
-    TempPtr   = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
+  Slot = 0;
+  if (PpiListPointer->HashSlots != NULL) {
+    Slot = PpiHashFirstSlot (Guid, PpiListPointer->HashSize);
+  }
+
+  for (Index = 0; ; Index++) {
+    if (PpiListPointer->HashSlots != NULL) {
+      if (PpiListPointer->HashSlots[Slot] == 0) {
+        break;
+      }
+
+      TempPtr = PpiListPointer->PpiPtrs[PpiListPointer->HashSlots[Slot] - 1].Ppi;
+      Slot    = (Slot + 1) & (PpiListPointer->HashSize - 1);
+    } else {
+      if (Index >= PpiListPointer->CurrentCount) {
+        break;
+      }
+
+      TempPtr = PpiListPointer->PpiPtrs[Index].Ppi;
+    }
+
     CheckGuid = TempPtr->Guid;
 
     //
@@ -41,6 +41,15 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mLevelMask[GUARDED_HEAP_MAP_TABLE_DEPTH]
 //
 EDKII_SMM_MEMORY_ATTRIBUTE_PROTOCOL  *mSmmMemoryAttribute = NULL;
 
+//
+// State of the heap guard sampling: allocations left before the next sampled
+// one, the pseudo random generator spreading the samples, and the number of
+// allocations currently guarded.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32  mGuardSampleCountdown   = 1;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32  mGuardSampleSeed        = 0x2545F491;
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN   mGuardedAllocationCount = 0;
+
 /**
   Set corresponding bits in bitmap table to 1 according to the address.
 
@@ -663,6 +672,46 @@ IsPageTypeToGuard (
   return IsMemoryTypeToGuard (MemoryType, AllocateType, GUARD_HEAP_TYPE_PAGE);
 }
 
+/**
+  Check to see if an allocation of a memory type to guard is sampled for
+  guarding, according to PcdHeapGuardSampleRate and PcdHeapGuardSampleLimit.
+
+  @return TRUE  The allocation should be guarded.
+  @return FALSE The allocation should not be guarded.
+**/
+BOOLEAN
+IsGuardSampled (
+  VOID
+  )
+{
+  UINT32  Rate;
+
+  Rate = PcdGet32 (PcdHeapGuardSampleRate);
+  if (Rate <= 1) {
+    return TRUE;
+  }
+
+  if ((PcdGet32 (PcdHeapGuardSampleLimit) != 0) &&
+      (mGuardedAllocationCount >= PcdGet32 (PcdHeapGuardSampleLimit)))
+  {
+    return FALSE;
+  }
+
+  if (--mGuardSampleCountdown != 0) {
+    return FALSE;
+  }
+
+  //
+  // Pick the distance to the next sample uniformly in [1, 2 * Rate - 1], so the
+  // average is one in Rate allocations but the sampled ones are not periodic.
+  //
+  mGuardSampleSeed     ^= mGuardSampleSeed << 13;
+  mGuardSampleSeed     ^= mGuardSampleSeed >> 17;
+  mGuardSampleSeed     ^= mGuardSampleSeed << 5;
+  mGuardSampleCountdown = 1 + mGuardSampleSeed % (2 * Rate - 1);
+  return TRUE;
+}
+
 /**
   Check to see if the heap guard is enabled for page and/or pool allocation.
 
@@ -714,6 +763,7 @@ SetGuardForMemory (
   // Mark the memory range as Guarded
   //
   SetGuardedMemoryBits (Memory, NumberOfPages);
+  mGuardedAllocationCount++;
 }
 
 /**
@@ -737,6 +787,10 @@ UnsetGuardForMemory (
     return;
   }
 
+  if (mGuardedAllocationCount > 0) {
+    mGuardedAllocationCount--;
+  }
+
   //
   // Head Guard must be one page before, if any.
   //
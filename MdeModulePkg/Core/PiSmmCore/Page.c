@@ -730,7 +730,7 @@ SmmAllocatePages (
   EFI_STATUS  Status;
   BOOLEAN     NeedGuard;
 
-  NeedGuard = IsPageTypeToGuard (MemoryType, Type);
+  NeedGuard = IsPageTypeToGuard (MemoryType, Type) && IsGuardSampled ();
   Status    = SmmInternalAllocatePages (
                 Type,
                 MemoryType,
@@ -55,6 +55,7 @@
 #include <Library/HobLib.h>
 #include <Library/SmmMemLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/TimerLib.h>
 
 #include "PiSmmCorePrivateData.h"
 #include "HeapGuard.h"
@@ -75,12 +76,13 @@ typedef struct {
 
 #define SMI_ENTRY_SIGNATURE  SIGNATURE_32('s','m','i','e')
 
-typedef struct {
-  UINTN         Signature;
-  LIST_ENTRY    AllEntries; // All entries
+typedef struct _SMI_ENTRY {
+  UINTN                Signature;
+  LIST_ENTRY           AllEntries; // All entries
 
-  EFI_GUID      HandlerType; // Type of interrupt
-  LIST_ENTRY    SmiHandlers; // All handlers
+  EFI_GUID             HandlerType; // Type of interrupt
+  LIST_ENTRY           SmiHandlers; // All handlers
+  struct _SMI_ENTRY    *HashNext;   // Next entry of the same hash bucket
 } SMI_ENTRY;
 
 #define SMI_HANDLER_SIGNATURE  SIGNATURE_32('s','m','i','h')
@@ -91,8 +93,11 @@ typedef struct {
   EFI_SMM_HANDLER_ENTRY_POINT2    Handler;    // The smm handler's entry point
   UINTN                           CallerAddr; // The address of caller who register the SMI handler.
   SMI_ENTRY                       *SmiEntry;
-  VOID                            *Context;    // for profile
-  UINTN                           ContextSize; // for profile
+  VOID                            *Context;        // for profile
+  UINTN                           ContextSize;     // for profile
+  UINT64                          InvocationCount; // for profile
+  UINT64                          TotalTicks;      // for profile
+  UINT64                          MaxTicks;        // for profile
 } SMI_HANDLER;
 
 //
@@ -1149,6 +1154,42 @@ SmmCoreInitializeSmiHandlerProfile (
   VOID
   );
 
+/**
+  Start measuring an invocation of an SMI handler by SmiManage().
+
+  @param SmiHandler      The SMI handler about to be invoked.
+
+  @return The performance counter at the start of the invocation.
+**/
+UINT64
+SmiHandlerProfileStartInvocation (
+  IN SMI_HANDLER  *SmiHandler
+  );
+
+/**
+  Record an invocation of an SMI handler by SmiManage(): its count, its
+  execution time, and whether it is one of the slowest invocations.
+
+  @param StartTicks      The value returned by SmiHandlerProfileStartInvocation().
+  @param ReturnStatus    The status returned by the SMI handler.
+**/
+VOID
+SmiHandlerProfileEndInvocation (
+  IN UINT64      StartTicks,
+  IN EFI_STATUS  ReturnStatus
+  );
+
+/**
+  Forget an SMI handler being unregistered, so that its invocation in
+  progress is not recorded.
+
+  @param SmiHandler      The SMI handler being unregistered.
+**/
+VOID
+SmiHandlerProfileForgetInvocation (
+  IN SMI_HANDLER  *SmiHandler
+  );
+
 /**
   This function is called by SmmChildDispatcher module to report
   a new SMI handler is registered, to SmmCore.
@@ -1210,6 +1251,8 @@ SmiHandlerProfileUnregisterHandler (
 extern UINTN                 mFullSmramRangeCount;
 extern EFI_SMRAM_DESCRIPTOR  *mFullSmramRanges;
 
+extern BOOLEAN  mSmiHandlerProfileStatistics;
+
 extern EFI_SMM_DRIVER_ENTRY  *mSmmCoreDriverEntry;
 
 extern EFI_LOADED_IMAGE_PROTOCOL  *mSmmCoreLoadedImage;
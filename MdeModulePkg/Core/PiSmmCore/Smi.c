@@ -10,6 +10,14 @@
 
 LIST_ENTRY  mSmiEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mSmiEntryList);
 
+//
+// The SMI entries are also chained by hash of their handler type, so that
+// SmiManage () does not compare the GUID of every entry on each SMI.
+//
+#define SMI_ENTRY_HASH_SIZE  64
+
+STATIC SMI_ENTRY  *mSmiEntryHash[SMI_ENTRY_HASH_SIZE];
+
 SMI_ENTRY  mRootSmiEntry = {
   SMI_ENTRY_SIGNATURE,
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.AllEntries),
@@ -17,6 +25,32 @@ SMI_ENTRY  mRootSmiEntry = {
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
 };
 
+/**
+  Hash a handler type into a bucket of mSmiEntryHash.
+
+  @param  HandlerType            The type of the interrupt, which may not be aligned
+
+  @return The index of the bucket
+
+**/
+STATIC
+UINTN
+SmiEntryHash (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)HandlerType);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (SMI_ENTRY_HASH_SIZE - 1);
+}
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -33,24 +67,18 @@ SmmCoreFindSmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
-  SMI_ENTRY   *Item;
-  SMI_ENTRY   *SmiEntry;
+  UINTN      Bucket;
+  SMI_ENTRY  *SmiEntry;
 
   //
-  // Search the SMI entry list for the matching GUID
+  // Search the hash bucket of the handler type for the matching GUID
   //
-  SmiEntry = NULL;
-  for (Link = mSmiEntryList.ForwardLink;
-       Link != &mSmiEntryList;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
-    if (CompareGuid (&Item->HandlerType, HandlerType)) {
+  Bucket = SmiEntryHash (HandlerType);
+  for (SmiEntry = mSmiEntryHash[Bucket]; SmiEntry != NULL; SmiEntry = SmiEntry->HashNext) {
+    if (CompareGuid (&SmiEntry->HandlerType, HandlerType)) {
       //
       // This is the SMI entry
       //
-      SmiEntry = Item;
       break;
     }
   }
@@ -73,6 +101,8 @@ SmmCoreFindSmiEntry (
       // Add it to SMI entry list
       //
       InsertTailList (&mSmiEntryList, &SmiEntry->AllEntries);
+      SmiEntry->HashNext    = mSmiEntryHash[Bucket];
+      mSmiEntryHash[Bucket] = SmiEntry;
     }
   }
 
@@ -108,6 +138,7 @@ SmiManage (
   SMI_HANDLER  *SmiHandler;
   BOOLEAN      SuccessReturn;
   EFI_STATUS   Status;
+  UINT64       StartTicks;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -137,6 +168,11 @@ SmiManage (
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
 
+    StartTicks = 0;
+    if (mSmiHandlerProfileStatistics) {
+      StartTicks = SmiHandlerProfileStartInvocation (SmiHandler);
+    }
+
     Status = SmiHandler->Handler (
                            (EFI_HANDLE)SmiHandler,
                            Context,
@@ -144,6 +180,10 @@ SmiManage (
                            CommBufferSize
                            );
 
+    if (mSmiHandlerProfileStatistics) {
+      SmiHandlerProfileEndInvocation (StartTicks, Status);
+    }
+
     switch (Status) {
       case EFI_INTERRUPT_PENDING:
         //
@@ -283,6 +323,7 @@ SmiHandlerUnRegister (
   SMI_ENTRY    *SmiEntry;
   LIST_ENTRY   *EntryLink;
   LIST_ENTRY   *HandlerLink;
+  SMI_ENTRY    **HashLink;
 
   if (DispatchHandle == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -324,6 +365,10 @@ SmiHandlerUnRegister (
 
   SmiEntry = SmiHandler->SmiEntry;
 
+  if (mSmiHandlerProfileStatistics) {
+    SmiHandlerProfileForgetInvocation (SmiHandler);
+  }
+
   RemoveEntryList (&SmiHandler->Link);
   FreePool (SmiHandler);
 
@@ -339,6 +384,12 @@ SmiHandlerUnRegister (
     // No handler registered for this interrupt now, remove the SMI_ENTRY
     //
     RemoveEntryList (&SmiEntry->AllEntries);
+    HashLink = &mSmiEntryHash[SmiEntryHash (&SmiEntry->HandlerType)];
+    while (*HashLink != SmiEntry) {
+      HashLink = &(*HashLink)->HashNext;
+    }
+
+    *HashLink = SmiEntry->HashNext;
 
     FreePool (SmiEntry);
   }
@@ -29,6 +29,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define GET_OCCUPIED_SIZE(ActualSize, Alignment) \
   ((ActualSize) + (((Alignment) - ((ActualSize) & ((Alignment) - 1))) & ((Alignment) - 1)))
 
+//
+// The number of slowest SMI handler invocations recorded, and the nesting
+// depth of SmiManage() up to which the invocations are measured.
+//
+#define SLOW_INVOCATION_COUNT  16
+#define MAX_INVOCATION_DEPTH   8
+
 typedef struct {
   EFI_GUID            FileGuid;
   PHYSICAL_ADDRESS    EntryPoint;
@@ -39,6 +46,14 @@ typedef struct {
   CHAR8               *PdbString;
 } IMAGE_STRUCT;
 
+typedef struct {
+  EFI_GUID                        HandlerType;
+  UINT32                          HandlerCategory;
+  EFI_SMM_HANDLER_ENTRY_POINT2    Handler;
+  UINT64                          Ticks;
+  EFI_STATUS                      ReturnStatus;
+} SLOW_INVOCATION_STRUCT;
+
 /**
   Register SMI handler profile handler.
 **/
@@ -95,9 +110,24 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmImageDatabaseSize;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmRootSmiDatabaseSize;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmSmiDatabaseSize;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmHardwareSmiDatabaseSize;
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  mSmmSlowInvocationDatabaseSize;
 
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileRecordingStatus;
 
+//
+// The invocation statistics, recorded when BIT1 of PcdSmiHandlerProfilePropertyMask is set.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN  mSmiHandlerProfileStatistics;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64   mPerformanceCounterStartValue;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64   mPerformanceCounterEndValue;
+
+GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER  *mInvocationStack[MAX_INVOCATION_DEPTH];
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN        mInvocationDepth;
+
+GLOBAL_REMOVE_IF_UNREFERENCED SLOW_INVOCATION_STRUCT  mSlowInvocation[SLOW_INVOCATION_COUNT];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                  mSlowInvocationCount;
+GLOBAL_REMOVE_IF_UNREFERENCED UINT32                  mFastestSlowInvocation;
+
 GLOBAL_REMOVE_IF_UNREFERENCED SMI_HANDLER_PROFILE_PROTOCOL  mSmiHandlerProfile = {
   SmiHandlerProfileRegisterHandler,
   SmiHandlerProfileUnregisterHandler,
@@ -530,7 +560,12 @@ SmmReadyToLockInSmiHandlerProfile (
 
   RegisterSmiHandlerProfileHandler ();
 
-  if (mImageStruct != NULL) {
+  //
+  // With the invocation statistics, the database is built again on each
+  // request, and the image structures are still needed to resolve the
+  // handler addresses.
+  //
+  if ((mImageStruct != NULL) && !mSmiHandlerProfileStatistics) {
     FreePool (mImageStruct);
   }
 
@@ -617,6 +652,24 @@ GetSmmSmiDatabaseSize (
   return Size;
 }
 
+/**
+  return the size of the database of the slowest SMI handler invocations.
+
+  @return the size of the slowest SMI handler invocation database, 0 without
+          the invocation statistics.
+**/
+UINTN
+GetSmmSlowInvocationDatabaseSize (
+  VOID
+  )
+{
+  if (!mSmiHandlerProfileStatistics) {
+    return 0;
+  }
+
+  return sizeof (SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE) + mSlowInvocationCount * sizeof (SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE);
+}
+
 /**
   return SMI handler profile database size.
 
@@ -627,12 +680,13 @@ GetSmiHandlerProfileDatabaseSize (
   VOID
   )
 {
-  mSmmImageDatabaseSize       = GetSmmImageDatabaseSize ();
-  mSmmRootSmiDatabaseSize     = GetSmmSmiDatabaseSize (mSmmCoreRootSmiEntryList);
-  mSmmSmiDatabaseSize         = GetSmmSmiDatabaseSize (mSmmCoreSmiEntryList);
-  mSmmHardwareSmiDatabaseSize = GetSmmSmiDatabaseSize (mSmmCoreHardwareSmiEntryList);
+  mSmmImageDatabaseSize          = GetSmmImageDatabaseSize ();
+  mSmmRootSmiDatabaseSize        = GetSmmSmiDatabaseSize (mSmmCoreRootSmiEntryList);
+  mSmmSmiDatabaseSize            = GetSmmSmiDatabaseSize (mSmmCoreSmiEntryList);
+  mSmmHardwareSmiDatabaseSize    = GetSmmSmiDatabaseSize (mSmmCoreHardwareSmiEntryList);
+  mSmmSlowInvocationDatabaseSize = GetSmmSlowInvocationDatabaseSize ();
 
-  return mSmmImageDatabaseSize + mSmmSmiDatabaseSize + mSmmRootSmiDatabaseSize + mSmmHardwareSmiDatabaseSize;
+  return mSmmImageDatabaseSize + mSmmSmiDatabaseSize + mSmmRootSmiDatabaseSize + mSmmHardwareSmiDatabaseSize + mSmmSlowInvocationDatabaseSize;
 }
 
 /**
@@ -737,6 +791,9 @@ GetSmmSmiHandlerDataOnSmiEntry (
     SmiHandlerStruct->Handler           = (UINTN)SmiHandler->Handler;
     SmiHandlerStruct->ImageRef          = AddressToImageRef ((UINTN)SmiHandler->Handler);
     SmiHandlerStruct->ContextBufferSize = (UINT32)SmiHandler->ContextSize;
+    SmiHandlerStruct->InvocationCount   = SmiHandler->InvocationCount;
+    SmiHandlerStruct->TotalTime         = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+    SmiHandlerStruct->MaxTime           = GetTimeInNanoSecond (SmiHandler->MaxTicks);
     if (SmiHandler->ContextSize != 0) {
       SmiHandlerStruct->ContextBufferOffset = sizeof (SMM_CORE_SMI_HANDLER_STRUCTURE);
       CopyMem ((UINT8 *)SmiHandlerStruct + SmiHandlerStruct->ContextBufferOffset, SmiHandler->Context, SmiHandler->ContextSize);
@@ -813,6 +870,65 @@ GetSmmSmiDatabaseData (
   return Size;
 }
 
+/**
+  get the database of the slowest SMI handler invocations, slowest first.
+
+  @param Data           The buffer to hold the slowest SMI handler invocation database
+  @param ExpectedSize   The expected size of the slowest SMI handler invocation database
+
+  @return the slowest SMI handler invocation database size.
+**/
+UINTN
+GetSmmSlowInvocationDatabaseData (
+  IN OUT VOID   *Data,
+  IN     UINTN  ExpectedSize
+  )
+{
+  SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE  *SlowStruct;
+  SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE           *Invocation;
+  SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE           Temp;
+  UINTN                                            Size;
+  UINT32                                           Index;
+  UINT32                                           SortIndex;
+
+  if (ExpectedSize == 0) {
+    return 0;
+  }
+
+  Size = sizeof (SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE) + mSlowInvocationCount * sizeof (SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE);
+  if (Size != ExpectedSize) {
+    return 0;
+  }
+
+  SlowStruct                   = Data;
+  SlowStruct->Header.Signature = SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_SIGNATURE;
+  SlowStruct->Header.Length    = (UINT32)Size;
+  SlowStruct->Header.Revision  = SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_REVISION;
+  SlowStruct->InvocationCount  = mSlowInvocationCount;
+  ZeroMem (SlowStruct->Reserved, sizeof (SlowStruct->Reserved));
+
+  Invocation = (SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE *)(SlowStruct + 1);
+  for (Index = 0; Index < mSlowInvocationCount; Index++) {
+    CopyGuid (&Invocation[Index].HandlerType, &mSlowInvocation[Index].HandlerType);
+    Invocation[Index].HandlerCategory = mSlowInvocation[Index].HandlerCategory;
+    Invocation[Index].ImageRef        = AddressToImageRef ((UINTN)mSlowInvocation[Index].Handler);
+    Invocation[Index].Handler         = (UINTN)mSlowInvocation[Index].Handler;
+    Invocation[Index].Time            = GetTimeInNanoSecond (mSlowInvocation[Index].Ticks);
+    Invocation[Index].ReturnStatus    = (UINT64)(INT64)(INTN)mSlowInvocation[Index].ReturnStatus;
+
+    //
+    // Insert it in order, the slowest first.
+    //
+    for (SortIndex = Index; (SortIndex > 0) && (Invocation[SortIndex - 1].Time < Invocation[SortIndex].Time); SortIndex--) {
+      CopyMem (&Temp, &Invocation[SortIndex], sizeof (Temp));
+      CopyMem (&Invocation[SortIndex], &Invocation[SortIndex - 1], sizeof (Temp));
+      CopyMem (&Invocation[SortIndex - 1], &Temp, sizeof (Temp));
+    }
+  }
+
+  return Size;
+}
+
 /**
   Get SMI handler profile database.
 
@@ -830,6 +946,7 @@ GetSmiHandlerProfileDatabaseData (
   UINTN  SmmSmiDatabaseSize;
   UINTN  SmmRootSmiDatabaseSize;
   UINTN  SmmHardwareSmiDatabaseSize;
+  UINTN  SmmSlowInvocationDatabaseSize;
 
   DEBUG ((DEBUG_VERBOSE, "GetSmiHandlerProfileDatabaseData\n"));
   SmmImageDatabaseSize = GetSmmImageDatabaseData (Data, mSmmImageDatabaseSize);
@@ -856,6 +973,12 @@ GetSmiHandlerProfileDatabaseData (
     return EFI_INVALID_PARAMETER;
   }
 
+  SmmSlowInvocationDatabaseSize = GetSmmSlowInvocationDatabaseData ((UINT8 *)Data + SmmImageDatabaseSize + SmmRootSmiDatabaseSize + SmmSmiDatabaseSize + SmmHardwareSmiDatabaseSize, mSmmSlowInvocationDatabaseSize);
+  if (SmmSlowInvocationDatabaseSize != mSmmSlowInvocationDatabaseSize) {
+    DEBUG ((DEBUG_ERROR, "GetSmiHandlerProfileDatabaseData - SmmSlowInvocationDatabaseSize mismatch!\n"));
+    return EFI_INVALID_PARAMETER;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -882,6 +1005,33 @@ BuildSmiHandlerProfileDatabase (
   }
 }
 
+/**
+  build SMI handler profile database again, with the current invocation
+  statistics. The previous database is kept if the new one cannot be built.
+**/
+VOID
+RefreshSmiHandlerProfileDatabase (
+  VOID
+  )
+{
+  VOID   *Database;
+  UINTN  DatabaseSize;
+
+  Database     = mSmiHandlerProfileDatabase;
+  DatabaseSize = mSmiHandlerProfileDatabaseSize;
+
+  BuildSmiHandlerProfileDatabase ();
+  if (mSmiHandlerProfileDatabase == NULL) {
+    mSmiHandlerProfileDatabase     = Database;
+    mSmiHandlerProfileDatabaseSize = DatabaseSize;
+    return;
+  }
+
+  if (Database != NULL) {
+    FreePool (Database);
+  }
+}
+
 /**
   Copy SMI handler profile data.
 
@@ -932,6 +1082,14 @@ SmiHandlerProfileHandlerGetInfo (
   SmiHandlerProfileRecordingStatus  = mSmiHandlerProfileRecordingStatus;
   mSmiHandlerProfileRecordingStatus = FALSE;
 
+  //
+  // Take a snapshot of the invocation statistics, for the following
+  // SMI_HANDLER_PROFILE_COMMAND_GET_DATA_BY_OFFSET commands.
+  //
+  if (mSmiHandlerProfileStatistics) {
+    RefreshSmiHandlerProfileDatabase ();
+  }
+
   SmiHandlerProfileParameterGetInfo->DataSize            = mSmiHandlerProfileDatabaseSize;
   SmiHandlerProfileParameterGetInfo->Header.ReturnStatus = 0;
 
@@ -1385,6 +1543,164 @@ SmiHandlerProfileUnregisterHandler (
   return EFI_SUCCESS;
 }
 
+/**
+  return the performance counter ticks elapsed between two values of the
+  performance counter.
+
+  @param StartTicks  The performance counter at the start.
+  @param EndTicks    The performance counter at the end.
+
+  @return the elapsed ticks.
+**/
+UINT64
+GetElapsedTicks (
+  IN UINT64  StartTicks,
+  IN UINT64  EndTicks
+  )
+{
+  if (mPerformanceCounterEndValue >= mPerformanceCounterStartValue) {
+    if (EndTicks >= StartTicks) {
+      return EndTicks - StartTicks;
+    }
+
+    return (mPerformanceCounterEndValue - StartTicks) + (EndTicks - mPerformanceCounterStartValue) + 1;
+  }
+
+  if (StartTicks >= EndTicks) {
+    return StartTicks - EndTicks;
+  }
+
+  return (StartTicks - mPerformanceCounterEndValue) + (mPerformanceCounterStartValue - EndTicks) + 1;
+}
+
+/**
+  Record an invocation in the slowest invocations, if it is slower than the
+  fastest of them.
+
+  @param SmiHandler      The SMI handler invoked.
+  @param Ticks           The execution time of the invocation, in ticks.
+  @param ReturnStatus    The status returned by the SMI handler.
+**/
+VOID
+RecordSlowInvocation (
+  IN SMI_HANDLER  *SmiHandler,
+  IN UINT64       Ticks,
+  IN EFI_STATUS   ReturnStatus
+  )
+{
+  UINT32  Index;
+
+  if (mSlowInvocationCount < SLOW_INVOCATION_COUNT) {
+    Index = mSlowInvocationCount++;
+  } else if (Ticks > mSlowInvocation[mFastestSlowInvocation].Ticks) {
+    Index = mFastestSlowInvocation;
+  } else {
+    return;
+  }
+
+  if (SmiHandler->SmiEntry == &mRootSmiEntry) {
+    mSlowInvocation[Index].HandlerCategory = SmmCoreSmiHandlerCategoryRootHandler;
+  } else {
+    mSlowInvocation[Index].HandlerCategory = SmmCoreSmiHandlerCategoryGuidHandler;
+  }
+
+  CopyGuid (&mSlowInvocation[Index].HandlerType, &SmiHandler->SmiEntry->HandlerType);
+  mSlowInvocation[Index].Handler      = SmiHandler->Handler;
+  mSlowInvocation[Index].Ticks        = Ticks;
+  mSlowInvocation[Index].ReturnStatus = ReturnStatus;
+
+  if (mSlowInvocationCount == SLOW_INVOCATION_COUNT) {
+    mFastestSlowInvocation = 0;
+    for (Index = 1; Index < SLOW_INVOCATION_COUNT; Index++) {
+      if (mSlowInvocation[Index].Ticks < mSlowInvocation[mFastestSlowInvocation].Ticks) {
+        mFastestSlowInvocation = Index;
+      }
+    }
+  }
+}
+
+/**
+  Start measuring an invocation of an SMI handler by SmiManage().
+
+  @param SmiHandler      The SMI handler about to be invoked.
+
+  @return The performance counter at the start of the invocation.
+**/
+UINT64
+SmiHandlerProfileStartInvocation (
+  IN SMI_HANDLER  *SmiHandler
+  )
+{
+  if (mInvocationDepth < MAX_INVOCATION_DEPTH) {
+    mInvocationStack[mInvocationDepth] = SmiHandler;
+  }
+
+  mInvocationDepth++;
+
+  return GetPerformanceCounter ();
+}
+
+/**
+  Record an invocation of an SMI handler by SmiManage(): its count, its
+  execution time, and whether it is one of the slowest invocations.
+
+  @param StartTicks      The value returned by SmiHandlerProfileStartInvocation().
+  @param ReturnStatus    The status returned by the SMI handler.
+**/
+VOID
+SmiHandlerProfileEndInvocation (
+  IN UINT64      StartTicks,
+  IN EFI_STATUS  ReturnStatus
+  )
+{
+  SMI_HANDLER  *SmiHandler;
+  UINT64       Ticks;
+
+  Ticks = GetElapsedTicks (StartTicks, GetPerformanceCounter ());
+
+  ASSERT (mInvocationDepth > 0);
+  mInvocationDepth--;
+  if (mInvocationDepth >= MAX_INVOCATION_DEPTH) {
+    return;
+  }
+
+  //
+  // The SMI handler is NULL if it unregistered itself.
+  //
+  SmiHandler = mInvocationStack[mInvocationDepth];
+  if (SmiHandler == NULL) {
+    return;
+  }
+
+  SmiHandler->InvocationCount++;
+  SmiHandler->TotalTicks += Ticks;
+  if (Ticks > SmiHandler->MaxTicks) {
+    SmiHandler->MaxTicks = Ticks;
+  }
+
+  RecordSlowInvocation (SmiHandler, Ticks, ReturnStatus);
+}
+
+/**
+  Forget an SMI handler being unregistered, so that its invocation in
+  progress is not recorded.
+
+  @param SmiHandler      The SMI handler being unregistered.
+**/
+VOID
+SmiHandlerProfileForgetInvocation (
+  IN SMI_HANDLER  *SmiHandler
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MIN (mInvocationDepth, MAX_INVOCATION_DEPTH); Index++) {
+    if (mInvocationStack[Index] == SmiHandler) {
+      mInvocationStack[Index] = NULL;
+    }
+  }
+}
+
 /**
   Initialize SmiHandler profile feature.
 **/
@@ -1400,6 +1716,11 @@ SmmCoreInitializeSmiHandlerProfile (
   if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x1) != 0) {
     InsertTailList (&mRootSmiEntryList, &mRootSmiEntry.AllEntries);
 
+    if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x2) != 0) {
+      GetPerformanceCounterProperties (&mPerformanceCounterStartValue, &mPerformanceCounterEndValue);
+      mSmiHandlerProfileStatistics = TRUE;
+    }
+
     Status = gSmst->SmmRegisterProtocolNotify (
                       &gEfiSmmReadyToLockProtocolGuid,
                       SmmReadyToLockInSmiHandlerProfile,
@@ -10,6 +10,7 @@
 
 #define IS_SMRAM_PROFILE_ENABLED        ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT1) != 0)
 #define IS_UEFI_MEMORY_PROFILE_ENABLED  ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT0) != 0)
+#define IS_SMRAM_PROFILE_AGGREGATED     ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT2) != 0)
 
 #define GET_OCCUPIED_SIZE(ActualSize, Alignment) \
   ((ActualSize) + (((Alignment) - ((ActualSize) & ((Alignment) - 1))) & ((Alignment) - 1)))
@@ -35,6 +36,29 @@ typedef struct {
   LIST_ENTRY                   Link;
 } MEMORY_PROFILE_ALLOC_INFO_DATA;
 
+//
+// When the allocations are counted per call site, the AllocInfoList of a
+// driver holds MEMORY_PROFILE_CALL_SITE_DATA, and each allocation not freed is
+// only tracked by a MEMORY_PROFILE_ALLOC_TRACK_DATA in a hash table.
+//
+typedef struct {
+  UINT32                             Signature;
+  MEMORY_PROFILE_CALL_SITE_INFO      CallSiteInfo;
+  MEMORY_PROFILE_DRIVER_INFO_DATA    *DriverInfoData;
+  LIST_ENTRY                         Link;
+  LIST_ENTRY                         HashLink;
+} MEMORY_PROFILE_CALL_SITE_DATA;
+
+typedef struct {
+  LIST_ENTRY                       HashLink;
+  PHYSICAL_ADDRESS                 Buffer;
+  UINT64                           Size;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
+} MEMORY_PROFILE_ALLOC_TRACK_DATA;
+
+#define SMRAM_PROFILE_CALL_SITE_HASH_SIZE  64
+#define SMRAM_PROFILE_ALLOC_HASH_SIZE      256
+
 //
 // When free memory less than 4 pages, dump it.
 //
@@ -76,6 +100,9 @@ GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mSmramProfileGettingStat
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mSmramProfileRecordingEnable = MEMORY_PROFILE_RECORDING_DISABLE;
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_DEVICE_PATH_PROTOCOL  *mSmramProfileDriverPath;
 GLOBAL_REMOVE_IF_UNREFERENCED UINTN                     mSmramProfileDriverPathSize;
+GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN                   mSmramProfileAggregated = FALSE;
+GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                *mSmramProfileCallSiteHash;
+GLOBAL_REMOVE_IF_UNREFERENCED LIST_ENTRY                *mSmramProfileAllocHash;
 
 /**
   Dump SMRAM information.
@@ -639,6 +666,42 @@ RegisterSmmCore (
   return TRUE;
 }
 
+/**
+  Allocate the hash tables of the call sites and of the allocations, so that
+  the SMRAM profile counts the allocations per call site.
+
+  The SMRAM profile records each allocation if they cannot be allocated.
+
+**/
+VOID
+SmramProfileInitAggregation (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  //
+  // Use SmmInternalAllocatePool() that will not update profile for this AllocatePool action.
+  //
+  Status = SmmInternalAllocatePool (
+             EfiRuntimeServicesData,
+             (SMRAM_PROFILE_CALL_SITE_HASH_SIZE + SMRAM_PROFILE_ALLOC_HASH_SIZE) * sizeof (LIST_ENTRY),
+             (VOID **)&mSmramProfileCallSiteHash
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "SmramProfileInit: the allocations are not counted per call site - %r\n", Status));
+    return;
+  }
+
+  mSmramProfileAllocHash = mSmramProfileCallSiteHash + SMRAM_PROFILE_CALL_SITE_HASH_SIZE;
+  for (Index = 0; Index < SMRAM_PROFILE_CALL_SITE_HASH_SIZE + SMRAM_PROFILE_ALLOC_HASH_SIZE; Index++) {
+    InitializeListHead (&mSmramProfileCallSiteHash[Index]);
+  }
+
+  mSmramProfileAggregated = TRUE;
+}
+
 /**
   Initialize SMRAM profile.
 
@@ -677,6 +740,10 @@ SmramProfileInit (
   mSmramProfileDriverPath     = AllocateCopyPool (mSmramProfileDriverPathSize, PcdGetPtr (PcdMemoryProfileDriverPath));
   mSmramProfileContextPtr     = &mSmramProfileContext;
 
+  if (IS_SMRAM_PROFILE_AGGREGATED) {
+    SmramProfileInitAggregation ();
+  }
+
   RegisterSmmCore (&mSmramProfileContext);
 
   DEBUG ((DEBUG_INFO, "SmramProfileInit SmramProfileContext - 0x%x\n", &mSmramProfileContext));
@@ -1074,6 +1141,384 @@ SmramProfileUpdateFreePages (
   }
 }
 
+/**
+  Add the size of an allocation to the usage of its driver and to the total
+  usage.
+
+  @param ContextData      Memory profile context.
+  @param DriverInfoData   Memory profile driver info of the caller.
+  @param MemoryType       Memory type.
+  @param Size             Buffer size.
+
+**/
+VOID
+SmramProfileAddUsage (
+  IN MEMORY_PROFILE_CONTEXT_DATA      *ContextData,
+  IN MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData,
+  IN EFI_MEMORY_TYPE                  MemoryType,
+  IN UINTN                            Size
+  )
+{
+  MEMORY_PROFILE_CONTEXT      *Context;
+  MEMORY_PROFILE_DRIVER_INFO  *DriverInfo;
+  EFI_MEMORY_TYPE             ProfileMemoryIndex;
+
+  Context            = &ContextData->Context;
+  DriverInfo         = &DriverInfoData->DriverInfo;
+  ProfileMemoryIndex = GetProfileMemoryIndex (MemoryType);
+
+  DriverInfo->CurrentUsage += Size;
+  if (DriverInfo->PeakUsage < DriverInfo->CurrentUsage) {
+    DriverInfo->PeakUsage = DriverInfo->CurrentUsage;
+  }
+
+  DriverInfo->CurrentUsageByType[ProfileMemoryIndex] += Size;
+  if (DriverInfo->PeakUsageByType[ProfileMemoryIndex] < DriverInfo->CurrentUsageByType[ProfileMemoryIndex]) {
+    DriverInfo->PeakUsageByType[ProfileMemoryIndex] = DriverInfo->CurrentUsageByType[ProfileMemoryIndex];
+  }
+
+  Context->CurrentTotalUsage += Size;
+  if (Context->PeakTotalUsage < Context->CurrentTotalUsage) {
+    Context->PeakTotalUsage = Context->CurrentTotalUsage;
+  }
+
+  Context->CurrentTotalUsageByType[ProfileMemoryIndex] += Size;
+  if (Context->PeakTotalUsageByType[ProfileMemoryIndex] < Context->CurrentTotalUsageByType[ProfileMemoryIndex]) {
+    Context->PeakTotalUsageByType[ProfileMemoryIndex] = Context->CurrentTotalUsageByType[ProfileMemoryIndex];
+  }
+
+  SmramProfileUpdateFreePages (ContextData);
+}
+
+/**
+  Get the index of the hash table bucket of a call site.
+
+  @param CallerAddress  Address of caller who call Allocate.
+  @param Action         This Allocate action.
+  @param MemoryType     Memory type.
+
+  @return The index of the bucket in mSmramProfileCallSiteHash.
+
+**/
+STATIC
+UINTN
+SmramProfileCallSiteHash (
+  IN PHYSICAL_ADDRESS       CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType
+  )
+{
+  UINT64  Key;
+
+  Key = CallerAddress ^ LShiftU64 (Action, 32) ^ MemoryType;
+  return (UINTN)(Key ^ RShiftU64 (Key, 6) ^ RShiftU64 (Key, 12)) & (SMRAM_PROFILE_CALL_SITE_HASH_SIZE - 1);
+}
+
+/**
+  Get the index of the hash table bucket of an allocation.
+
+  @param Buffer         Buffer address.
+
+  @return The index of the bucket in mSmramProfileAllocHash.
+
+**/
+STATIC
+UINTN
+SmramProfileAllocHash (
+  IN PHYSICAL_ADDRESS  Buffer
+  )
+{
+  return (UINTN)(RShiftU64 (Buffer, 4) ^ RShiftU64 (Buffer, 12)) & (SMRAM_PROFILE_ALLOC_HASH_SIZE - 1);
+}
+
+/**
+  Count an allocation in its call site, when the SMRAM profile counts the
+  allocations per call site.
+
+  @param DriverInfoData Memory profile driver info of the caller.
+  @param CallerAddress  Address of caller who call Allocate.
+  @param Action         This Allocate action.
+  @param MemoryType     Memory type.
+  @param Size           Buffer size.
+  @param Buffer         Buffer address.
+
+  @return EFI_SUCCESS           The allocation is counted.
+  @return EFI_OUT_OF_RESOURCES  No enough resource to count the allocation.
+
+**/
+EFI_STATUS
+SmramProfileAggregateAllocate (
+  IN MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData,
+  IN PHYSICAL_ADDRESS                 CallerAddress,
+  IN MEMORY_PROFILE_ACTION            Action,
+  IN EFI_MEMORY_TYPE                  MemoryType,
+  IN UINTN                            Size,
+  IN VOID                             *Buffer
+  )
+{
+  EFI_STATUS                       Status;
+  LIST_ENTRY                       *Bucket;
+  LIST_ENTRY                       *Link;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
+  MEMORY_PROFILE_CALL_SITE_INFO    *CallSiteInfo;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+
+  CallSiteData = NULL;
+  Bucket       = &mSmramProfileCallSiteHash[SmramProfileCallSiteHash (CallerAddress, Action, MemoryType)];
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    CallSiteData = CR (
+                     Link,
+                     MEMORY_PROFILE_CALL_SITE_DATA,
+                     HashLink,
+                     MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE
+                     );
+    CallSiteInfo = &CallSiteData->CallSiteInfo;
+    if ((CallSiteInfo->CallerAddress == CallerAddress) &&
+        (CallSiteInfo->Action == Action) &&
+        (CallSiteInfo->MemoryType == MemoryType))
+    {
+      break;
+    }
+
+    CallSiteData = NULL;
+  }
+
+  //
+  // Use SmmInternalAllocatePool() that will not update profile for this AllocatePool action.
+  //
+  AllocTrackData = NULL;
+  Status         = SmmInternalAllocatePool (
+                     EfiRuntimeServicesData,
+                     sizeof (*AllocTrackData),
+                     (VOID **)&AllocTrackData
+                     );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (CallSiteData == NULL) {
+    Status = SmmInternalAllocatePool (
+               EfiRuntimeServicesData,
+               sizeof (*CallSiteData),
+               (VOID **)&CallSiteData
+               );
+    if (EFI_ERROR (Status)) {
+      SmmInternalFreePool (AllocTrackData);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ZeroMem (CallSiteData, sizeof (*CallSiteData));
+    CallSiteData->Signature        = MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE;
+    CallSiteData->DriverInfoData   = DriverInfoData;
+    CallSiteInfo                   = &CallSiteData->CallSiteInfo;
+    CallSiteInfo->Header.Signature = MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE;
+    CallSiteInfo->Header.Length    = sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+    CallSiteInfo->Header.Revision  = MEMORY_PROFILE_CALL_SITE_INFO_REVISION;
+    CallSiteInfo->CallerAddress    = CallerAddress;
+    CallSiteInfo->Action           = Action;
+    CallSiteInfo->MemoryType       = MemoryType;
+
+    InsertTailList (DriverInfoData->AllocInfoList, &CallSiteData->Link);
+    InsertTailList (Bucket, &CallSiteData->HashLink);
+    DriverInfoData->DriverInfo.AllocRecordCount++;
+  }
+
+  CallSiteInfo                = &CallSiteData->CallSiteInfo;
+  CallSiteInfo->CurrentUsage += Size;
+  if (CallSiteInfo->PeakUsage < CallSiteInfo->CurrentUsage) {
+    CallSiteInfo->PeakUsage = CallSiteInfo->CurrentUsage;
+  }
+
+  CallSiteInfo->CurrentCount++;
+  CallSiteInfo->TotalCount++;
+
+  AllocTrackData->Buffer       = (PHYSICAL_ADDRESS)(UINTN)Buffer;
+  AllocTrackData->Size         = Size;
+  AllocTrackData->CallSiteData = CallSiteData;
+  InsertTailList (&mSmramProfileAllocHash[SmramProfileAllocHash (AllocTrackData->Buffer)], &AllocTrackData->HashLink);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the tracked allocation that a Free action releases, when the SMRAM
+  profile counts the allocations per call site.
+
+  @param BasicAction        This Free basic action.
+  @param Size               Buffer size, for FreePages.
+  @param Buffer             Buffer address.
+
+  @return Pointer to the tracked allocation, or NULL if none is found.
+
+**/
+MEMORY_PROFILE_ALLOC_TRACK_DATA *
+SmramProfileFindAllocTrack (
+  IN MEMORY_PROFILE_ACTION  BasicAction,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer
+  )
+{
+  MEMORY_PROFILE_ACTION            AllocAction;
+  LIST_ENTRY                       *Bucket;
+  LIST_ENTRY                       *Link;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+  UINTN                            Index;
+
+  if (BasicAction == MemoryProfileActionFreePages) {
+    AllocAction = MemoryProfileActionAllocatePages;
+  } else {
+    AllocAction = MemoryProfileActionAllocatePool;
+  }
+
+  //
+  // Most buffers are freed from their start.
+  //
+  Bucket = &mSmramProfileAllocHash[SmramProfileAllocHash ((PHYSICAL_ADDRESS)(UINTN)Buffer)];
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    AllocTrackData = BASE_CR (Link, MEMORY_PROFILE_ALLOC_TRACK_DATA, HashLink);
+    if ((AllocTrackData->Buffer == (PHYSICAL_ADDRESS)(UINTN)Buffer) &&
+        (AllocTrackData->Size >= Size) &&
+        ((AllocTrackData->CallSiteData->CallSiteInfo.Action & MEMORY_PROFILE_ACTION_BASIC_MASK) == AllocAction))
+    {
+      return AllocTrackData;
+    }
+  }
+
+  if (BasicAction != MemoryProfileActionFreePages) {
+    return NULL;
+  }
+
+  //
+  // Pages may also be freed from the middle or the end of an allocation.
+  //
+  for (Index = 0; Index < SMRAM_PROFILE_ALLOC_HASH_SIZE; Index++) {
+    Bucket = &mSmramProfileAllocHash[Index];
+    for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+      AllocTrackData = BASE_CR (Link, MEMORY_PROFILE_ALLOC_TRACK_DATA, HashLink);
+      if ((AllocTrackData->Buffer <= (PHYSICAL_ADDRESS)(UINTN)Buffer) &&
+          ((AllocTrackData->Buffer + AllocTrackData->Size) >= ((PHYSICAL_ADDRESS)(UINTN)Buffer + Size)) &&
+          ((AllocTrackData->CallSiteData->CallSiteInfo.Action & MEMORY_PROFILE_ACTION_BASIC_MASK) == AllocAction))
+      {
+        return AllocTrackData;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Remove a Free action from the counters of the call sites, when the SMRAM
+  profile counts the allocations per call site.
+
+  @param ContextData    Memory profile context.
+  @param BasicAction    This Free basic action.
+  @param Size           Buffer size, for FreePages.
+  @param Buffer         Buffer address.
+
+  @return EFI_SUCCESS           Memory profile is updated.
+  @return EFI_NOT_FOUND         No matched allocation found for free action.
+
+**/
+EFI_STATUS
+SmramProfileAggregateFree (
+  IN MEMORY_PROFILE_CONTEXT_DATA  *ContextData,
+  IN MEMORY_PROFILE_ACTION        BasicAction,
+  IN UINTN                        Size,
+  IN VOID                         *Buffer
+  )
+{
+  EFI_STATUS                       Status;
+  MEMORY_PROFILE_CONTEXT           *Context;
+  MEMORY_PROFILE_DRIVER_INFO       *DriverInfo;
+  MEMORY_PROFILE_CALL_SITE_INFO    *CallSiteInfo;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *AllocTrackData;
+  MEMORY_PROFILE_ALLOC_TRACK_DATA  *TailTrackData;
+  EFI_MEMORY_TYPE                  ProfileMemoryIndex;
+  PHYSICAL_ADDRESS                 FreeStart;
+  PHYSICAL_ADDRESS                 FreeEnd;
+  PHYSICAL_ADDRESS                 AllocEnd;
+  UINT64                           FreedSize;
+  BOOLEAN                          Found;
+
+  Context   = &ContextData->Context;
+  FreeStart = (PHYSICAL_ADDRESS)(UINTN)Buffer;
+  FreeEnd   = FreeStart + Size;
+
+  //
+  // Need use do-while loop to find all possible record,
+  // because one address might be recorded multiple times.
+  //
+  Found = FALSE;
+  do {
+    AllocTrackData = SmramProfileFindAllocTrack (BasicAction, Size, Buffer);
+    if (AllocTrackData == NULL) {
+      //
+      // If (!Found), the allocate action of this buffer was filtered, as in
+      // SmmCoreUpdateProfileFree ().
+      //
+      return (Found ? EFI_SUCCESS : EFI_NOT_FOUND);
+    }
+
+    Found        = TRUE;
+    CallSiteInfo = &AllocTrackData->CallSiteData->CallSiteInfo;
+    DriverInfo   = &AllocTrackData->CallSiteData->DriverInfoData->DriverInfo;
+    AllocEnd     = AllocTrackData->Buffer + AllocTrackData->Size;
+
+    if ((BasicAction == MemoryProfileActionFreePool) || (Size == AllocTrackData->Size)) {
+      FreedSize = AllocTrackData->Size;
+      RemoveEntryList (&AllocTrackData->HashLink);
+      SmmInternalFreePool (AllocTrackData);
+      CallSiteInfo->CurrentCount--;
+    } else if (AllocTrackData->Buffer == FreeStart) {
+      FreedSize = Size;
+      RemoveEntryList (&AllocTrackData->HashLink);
+      AllocTrackData->Buffer = FreeEnd;
+      AllocTrackData->Size   = AllocEnd - FreeEnd;
+      InsertTailList (&mSmramProfileAllocHash[SmramProfileAllocHash (AllocTrackData->Buffer)], &AllocTrackData->HashLink);
+    } else {
+      FreedSize            = Size;
+      AllocTrackData->Size = FreeStart - AllocTrackData->Buffer;
+      if (AllocEnd != FreeEnd) {
+        //
+        // The pages are freed from the middle of the allocation, the rest of
+        // it is tracked as another allocation of the call site. If it cannot
+        // be, it is not counted anymore.
+        //
+        Status = SmmInternalAllocatePool (
+                   EfiRuntimeServicesData,
+                   sizeof (*TailTrackData),
+                   (VOID **)&TailTrackData
+                   );
+        if (EFI_ERROR (Status)) {
+          FreedSize += AllocEnd - FreeEnd;
+        } else {
+          TailTrackData->Buffer       = FreeEnd;
+          TailTrackData->Size         = AllocEnd - FreeEnd;
+          TailTrackData->CallSiteData = AllocTrackData->CallSiteData;
+          InsertTailList (&mSmramProfileAllocHash[SmramProfileAllocHash (TailTrackData->Buffer)], &TailTrackData->HashLink);
+          CallSiteInfo->CurrentCount++;
+        }
+      }
+    }
+
+    CallSiteInfo->CurrentUsage -= FreedSize;
+
+    //
+    // Update summary if and only if it is basic action.
+    //
+    if (CallSiteInfo->Action == (CallSiteInfo->Action & MEMORY_PROFILE_ACTION_BASIC_MASK)) {
+      ProfileMemoryIndex = GetProfileMemoryIndex (CallSiteInfo->MemoryType);
+
+      Context->CurrentTotalUsage                           -= FreedSize;
+      Context->CurrentTotalUsageByType[ProfileMemoryIndex] -= FreedSize;
+
+      DriverInfo->CurrentUsage                           -= FreedSize;
+      DriverInfo->CurrentUsageByType[ProfileMemoryIndex] -= FreedSize;
+    }
+  } while (TRUE);
+}
+
 /**
   Update SMRAM profile Allocate information.
 
@@ -1101,13 +1546,10 @@ SmmCoreUpdateProfileAllocate (
   )
 {
   EFI_STATUS                       Status;
-  MEMORY_PROFILE_CONTEXT           *Context;
-  MEMORY_PROFILE_DRIVER_INFO       *DriverInfo;
   MEMORY_PROFILE_ALLOC_INFO        *AllocInfo;
   MEMORY_PROFILE_CONTEXT_DATA      *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA   *AllocInfoData;
-  EFI_MEMORY_TYPE                  ProfileMemoryIndex;
   MEMORY_PROFILE_ACTION            BasicAction;
   UINTN                            ActionStringSize;
   UINTN                            ActionStringOccupiedSize;
@@ -1124,6 +1566,16 @@ SmmCoreUpdateProfileAllocate (
     return EFI_UNSUPPORTED;
   }
 
+  if (mSmramProfileAggregated) {
+    Status = SmramProfileAggregateAllocate (DriverInfoData, CallerAddress, Action, MemoryType, Size, Buffer);
+    if (!EFI_ERROR (Status) && (Action == BasicAction)) {
+      ContextData->Context.SequenceCount++;
+      SmramProfileAddUsage (ContextData, DriverInfoData, MemoryType, Size);
+    }
+
+    return Status;
+  }
+
   ActionStringSize         = 0;
   ActionStringOccupiedSize = 0;
   if (ActionString != NULL) {
@@ -1175,37 +1627,13 @@ SmmCoreUpdateProfileAllocate (
 
   InsertTailList (DriverInfoData->AllocInfoList, &AllocInfoData->Link);
 
-  Context    = &ContextData->Context;
-  DriverInfo = &DriverInfoData->DriverInfo;
-  DriverInfo->AllocRecordCount++;
+  DriverInfoData->DriverInfo.AllocRecordCount++;
 
   //
   // Update summary if and only if it is basic action.
   //
   if (Action == BasicAction) {
-    ProfileMemoryIndex = GetProfileMemoryIndex (MemoryType);
-
-    DriverInfo->CurrentUsage += Size;
-    if (DriverInfo->PeakUsage < DriverInfo->CurrentUsage) {
-      DriverInfo->PeakUsage = DriverInfo->CurrentUsage;
-    }
-
-    DriverInfo->CurrentUsageByType[ProfileMemoryIndex] += Size;
-    if (DriverInfo->PeakUsageByType[ProfileMemoryIndex] < DriverInfo->CurrentUsageByType[ProfileMemoryIndex]) {
-      DriverInfo->PeakUsageByType[ProfileMemoryIndex] = DriverInfo->CurrentUsageByType[ProfileMemoryIndex];
-    }
-
-    Context->CurrentTotalUsage += Size;
-    if (Context->PeakTotalUsage < Context->CurrentTotalUsage) {
-      Context->PeakTotalUsage = Context->CurrentTotalUsage;
-    }
-
-    Context->CurrentTotalUsageByType[ProfileMemoryIndex] += Size;
-    if (Context->PeakTotalUsageByType[ProfileMemoryIndex] < Context->CurrentTotalUsageByType[ProfileMemoryIndex]) {
-      Context->PeakTotalUsageByType[ProfileMemoryIndex] = Context->CurrentTotalUsageByType[ProfileMemoryIndex];
-    }
-
-    SmramProfileUpdateFreePages (ContextData);
+    SmramProfileAddUsage (ContextData, DriverInfoData, MemoryType, Size);
   }
 
   return EFI_SUCCESS;
@@ -1316,6 +1744,10 @@ SmmCoreUpdateProfileFree (
     return EFI_UNSUPPORTED;
   }
 
+  if (mSmramProfileAggregated) {
+    return SmramProfileAggregateFree (ContextData, BasicAction, Size, Buffer);
+  }
+
   DriverInfoData = GetMemoryProfileDriverInfoFromAddress (ContextData, CallerAddress);
 
   //
@@ -1608,6 +2040,11 @@ SmramProfileGetDataSize (
                        );
     TotalSize += DriverInfoData->DriverInfo.Header.Length;
 
+    if (mSmramProfileAggregated) {
+      TotalSize += DriverInfoData->DriverInfo.AllocRecordCount * sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+      continue;
+    }
+
     AllocInfoList = DriverInfoData->AllocInfoList;
     for (AllocLink = AllocInfoList->ForwardLink;
          AllocLink != AllocInfoList;
@@ -1676,6 +2113,7 @@ SmramProfileCopyData (
   MEMORY_PROFILE_CONTEXT_DATA      *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA   *AllocInfoData;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
   LIST_ENTRY                       *DriverInfoList;
   LIST_ENTRY                       *DriverLink;
   LIST_ENTRY                       *AllocInfoList;
@@ -1751,6 +2189,27 @@ SmramProfileCopyData (
          AllocLink != AllocInfoList;
          AllocLink = AllocLink->ForwardLink)
     {
+      if (mSmramProfileAggregated) {
+        CallSiteData = CR (
+                         AllocLink,
+                         MEMORY_PROFILE_CALL_SITE_DATA,
+                         Link,
+                         MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE
+                         );
+        if (*ProfileOffset < (Offset + sizeof (MEMORY_PROFILE_CALL_SITE_INFO))) {
+          if (RemainingSize >= sizeof (MEMORY_PROFILE_CALL_SITE_INFO)) {
+            CopyMem (ProfileBuffer, &CallSiteData->CallSiteInfo, sizeof (MEMORY_PROFILE_CALL_SITE_INFO));
+            RemainingSize -= sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+            ProfileBuffer  = (UINT8 *)ProfileBuffer + sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+          } else {
+            goto Done;
+          }
+        }
+
+        Offset += sizeof (MEMORY_PROFILE_CALL_SITE_INFO);
+        continue;
+      }
+
       AllocInfoData = CR (
                         AllocLink,
                         MEMORY_PROFILE_ALLOC_INFO_DATA,
@@ -2685,6 +3144,8 @@ DumpSmramProfile (
   MEMORY_PROFILE_CONTEXT_DATA      *ContextData;
   MEMORY_PROFILE_DRIVER_INFO_DATA  *DriverInfoData;
   MEMORY_PROFILE_ALLOC_INFO_DATA   *AllocInfoData;
+  MEMORY_PROFILE_CALL_SITE_DATA    *CallSiteData;
+  MEMORY_PROFILE_CALL_SITE_INFO    *CallSiteInfo;
   LIST_ENTRY                       *SmramDriverInfoList;
   UINTN                            DriverIndex;
   LIST_ENTRY                       *DriverLink;
@@ -2758,6 +3219,25 @@ DumpSmramProfile (
          AllocLink != AllocInfoList;
          AllocLink = AllocLink->ForwardLink, AllocIndex++)
     {
+      if (mSmramProfileAggregated) {
+        CallSiteData = CR (
+                         AllocLink,
+                         MEMORY_PROFILE_CALL_SITE_DATA,
+                         Link,
+                         MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE
+                         );
+        CallSiteInfo = &CallSiteData->CallSiteInfo;
+        DEBUG ((DEBUG_INFO, "    MEMORY_PROFILE_CALL_SITE_INFO (0x%x)\n", AllocIndex));
+        DEBUG ((DEBUG_INFO, "      CallerAddress  - 0x%016lx (Offset: 0x%08x)\n", CallSiteInfo->CallerAddress, CallSiteInfo->CallerAddress - DriverInfo->ImageBase));
+        DEBUG ((DEBUG_INFO, "      Action         - 0x%08x (%a)\n", CallSiteInfo->Action, ProfileActionToStr (CallSiteInfo->Action)));
+        DEBUG ((DEBUG_INFO, "      MemoryType     - 0x%08x (%a)\n", CallSiteInfo->MemoryType, ProfileMemoryTypeToStr (CallSiteInfo->MemoryType)));
+        DEBUG ((DEBUG_INFO, "      CurrentUsage   - 0x%016lx\n", CallSiteInfo->CurrentUsage));
+        DEBUG ((DEBUG_INFO, "      PeakUsage      - 0x%016lx\n", CallSiteInfo->PeakUsage));
+        DEBUG ((DEBUG_INFO, "      CurrentCount   - 0x%08x\n", CallSiteInfo->CurrentCount));
+        DEBUG ((DEBUG_INFO, "      TotalCount     - 0x%08x\n", CallSiteInfo->TotalCount));
+        continue;
+      }
+
       AllocInfoData = CR (
                         AllocLink,
                         MEMORY_PROFILE_ALLOC_INFO_DATA,
@@ -0,0 +1,62 @@
+/** @file
+  DXE Core service statistics GUID definition.
+
+  When PcdDxeCoreServiceStatistics is TRUE, the DXE Core counts the calls of
+  its hot services, such as the memory allocation, protocol lookup, event
+  signaling, section extraction and TPL services, and accumulates the
+  performance counter ticks spent in them. It publishes the live statistics as
+  a configuration table with this GUID, that the Dp shell command displays.
+
+  The time of a service includes the services it calls, and the notification
+  functions it dispatches. The time of a recursive call is only counted in the
+  outermost call of the service.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_DXE_CORE_SERVICE_STATISTICS_GUID_H__
+#define __EDKII_DXE_CORE_SERVICE_STATISTICS_GUID_H__
+
+#define EDKII_DXE_CORE_SERVICE_STATISTICS_GUID \
+  { \
+    0x01a4dea4, 0x1fc6, 0x4425, { 0xaa, 0xf9, 0xc2, 0x67, 0x61, 0x6e, 0x45, 0x47 } \
+  }
+
+#define DXE_CORE_SERVICE_STATISTICS_REVISION   1
+#define DXE_CORE_SERVICE_STATISTICS_NAME_SIZE  24
+
+typedef struct {
+  ///
+  /// The name of the service, a NULL-terminated ASCII string.
+  ///
+  CHAR8     Name[DXE_CORE_SERVICE_STATISTICS_NAME_SIZE];
+  ///
+  /// The number of calls of the service.
+  ///
+  UINT64    Calls;
+  ///
+  /// The performance counter ticks spent in the service.
+  ///
+  UINT64    Ticks;
+} DXE_CORE_SERVICE_STATISTICS_ENTRY;
+
+typedef struct {
+  ///
+  /// DXE_CORE_SERVICE_STATISTICS_REVISION.
+  ///
+  UINT32                               Revision;
+  ///
+  /// Number of entries following this header.
+  ///
+  UINT32                               Count;
+  ///
+  /// The frequency of the performance counter in Hz.
+  ///
+  UINT64                               Frequency;
+  DXE_CORE_SERVICE_STATISTICS_ENTRY    Entry[1];
+} DXE_CORE_SERVICE_STATISTICS;
+
+extern EFI_GUID  gEdkiiDxeCoreServiceStatisticsGuid;
+
+#endif
@@ -0,0 +1,39 @@
+/** @file
+  DXE dispatch order GUID definition.
+
+  The DXE core publishes the order in which it started DXE drivers as a
+  configuration table with this GUID when PcdDxeDispatchOrderCache is TRUE.
+  A platform may save the table across boots and hand it back to the DXE
+  core in a GUIDed HOB with the same GUID. The DXE core then evaluates the
+  dependency expressions of discovered drivers in the recorded order first,
+  so that on an identical boot each pass of the dispatcher finds the next
+  drivers ready to run. Drivers that are not in the record keep the normal
+  discovery order, and every dependency expression is still evaluated, so a
+  stale record only costs time.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_DXE_DISPATCH_ORDER_GUID_H__
+#define __EDKII_DXE_DISPATCH_ORDER_GUID_H__
+
+#define EDKII_DXE_DISPATCH_ORDER_GUID \
+  { \
+    0x92cf5904, 0x0a0c, 0x4674, { 0xb3, 0x39, 0xbf, 0x38, 0x82, 0xb3, 0xb9, 0x0b } \
+  }
+
+typedef struct {
+  ///
+  /// Number of EFI_GUID file names following this header.
+  ///
+  UINT32    Count;
+  UINT32    Reserved;
+  //
+  // EFI_GUID    FileName[Count];
+  //
+} EDKII_DXE_DISPATCH_ORDER;
+
+extern EFI_GUID  gEdkiiDxeDispatchOrderGuid;
+
+#endif // __EDKII_DXE_DISPATCH_ORDER_GUID_H__
@@ -0,0 +1,55 @@
+/** @file
+  GUID used to identify the memory debug log, the text of the status codes
+  and DEBUG() messages recorded by the status code handlers.
+
+  The PEI status code handler records the log in a GUIDed HOB. The DXE status
+  code handler copies it into a runtime buffer that keeps recording, and
+  installs that buffer as a configuration table so that a shell application
+  or the OS can read the log of the boot.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MEMORY_DEBUG_LOG_H__
+#define __MEMORY_DEBUG_LOG_H__
+
+///
+/// Global ID used to identify the GUIDed HOB and the configuration table that
+/// start with a structure of type MEMORY_DEBUG_LOG_HEADER, followed by the ring
+/// of Size bytes of ASCII text.
+///
+///  <pre>
+///  +--------+-----------------------------------------------------+
+///  | Header | Ring of Size bytes                                  |
+///  +--------+-----------------------------------------------------+
+///           ^                   ^
+///           |                   +--- Written % Size: next byte written,
+///           |                        oldest byte once Written > Size
+///           +--- oldest byte while Written <= Size
+///  </pre>
+///
+#define MEMORY_DEBUG_LOG_GUID \
+  { \
+    0x584d7f58, 0xbae3, 0x45e8, { 0xa0, 0x5a, 0x67, 0xbf, 0xff, 0xc1, 0x04, 0xa2 } \
+  }
+
+///
+/// A header structure that is followed by the ring of text of the log.
+///
+typedef struct {
+  ///
+  /// The size in bytes of the ring.
+  ///
+  UINT32    Size;
+  UINT32    Reserved;
+  ///
+  /// The number of bytes written into the log since it was created. The ring
+  /// holds the last MIN (Written, Size) of them.
+  ///
+  UINT64    Written;
+} MEMORY_DEBUG_LOG_HEADER;
+
+extern EFI_GUID  gEdkiiMemoryDebugLogGuid;
+
+#endif
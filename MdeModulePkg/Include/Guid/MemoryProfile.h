@@ -149,6 +149,26 @@ typedef struct {
   // CHAR8                         ActionString[];
 } MEMORY_PROFILE_ALLOC_INFO;
 
+#define MEMORY_PROFILE_CALL_SITE_INFO_SIGNATURE  SIGNATURE_32 ('M','P','C','S')
+#define MEMORY_PROFILE_CALL_SITE_INFO_REVISION   0x0001
+
+//
+// The allocations that a driver made from one caller address, with the same
+// action and memory type. When the profile counts the allocations per call
+// site, these records follow the MEMORY_PROFILE_DRIVER_INFO instead of the
+// MEMORY_PROFILE_ALLOC_INFO records, and AllocRecordCount counts them.
+//
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER    Header;
+  PHYSICAL_ADDRESS                CallerAddress;
+  MEMORY_PROFILE_ACTION           Action;
+  EFI_MEMORY_TYPE                 MemoryType;
+  UINT64                          CurrentUsage;
+  UINT64                          PeakUsage;
+  UINT32                          CurrentCount;   // The number of allocations not freed.
+  UINT32                          TotalCount;     // The number of allocations.
+} MEMORY_PROFILE_CALL_SITE_INFO;
+
 #define MEMORY_PROFILE_DESCRIPTOR_SIGNATURE  SIGNATURE_32 ('M','P','D','R')
 #define MEMORY_PROFILE_DESCRIPTOR_REVISION   0x0001
 
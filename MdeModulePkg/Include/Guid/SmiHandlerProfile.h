@@ -42,7 +42,10 @@ typedef struct {
 } SMM_CORE_IMAGE_DATABASE_STRUCTURE;
 
 #define SMM_CORE_SMI_DATABASE_SIGNATURE  SIGNATURE_32 ('S','C','S','D')
-#define SMM_CORE_SMI_DATABASE_REVISION   0x0001
+//
+// Revision 0x0002 adds the invocation statistics to SMM_CORE_SMI_HANDLER_STRUCTURE.
+//
+#define SMM_CORE_SMI_DATABASE_REVISION  0x0002
 
 typedef enum {
   SmmCoreSmiHandlerCategoryRootHandler,
@@ -85,6 +88,14 @@ typedef struct {
   UINT16              ContextBufferOffset;
   UINT8               Reserved[2];
   UINT32              ContextBufferSize;
+  //
+  // Invocation statistics, zero unless BIT1 of PcdSmiHandlerProfilePropertyMask
+  // is set. The times are in nanoseconds. The hardware SMI handlers are not
+  // invoked by the SMM Core, their statistics are always zero.
+  //
+  UINT64              InvocationCount;
+  UINT64              TotalTime;
+  UINT64              MaxTime;
   // UINT8                 ContextBuffer[];
 } SMM_CORE_SMI_HANDLER_STRUCTURE;
 
@@ -96,13 +107,39 @@ typedef struct {
   // SMM_CORE_SMI_HANDLER_STRUCTURE      Handler[HandlerCount];
 } SMM_CORE_SMI_DATABASE_STRUCTURE;
 
+#define SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_SIGNATURE  SIGNATURE_32 ('S','C','S','I')
+#define SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_REVISION   0x0001
+
+typedef struct {
+  EFI_GUID            HandlerType;
+  UINT32              HandlerCategory;
+  UINT32              ImageRef;
+  PHYSICAL_ADDRESS    Handler;
+  UINT64              Time;
+  UINT64              ReturnStatus;
+} SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE;
+
+//
+// The slowest invocations of the root and GUID SMI handlers, slowest first.
+// It is only present when BIT1 of PcdSmiHandlerProfilePropertyMask is set.
+// The times are in nanoseconds.
+//
+typedef struct {
+  SMM_CORE_DATABASE_COMMON_HEADER    Header;
+  UINT32                             InvocationCount;
+  UINT8                              Reserved[4];
+  // SMM_CORE_SMI_SLOW_INVOCATION_STRUCTURE  Invocation[InvocationCount];
+} SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE;
+
 //
 // Layout:
-// +-------------------------------------+
-// | SMM_CORE_IMAGE_DATABASE_STRUCTURE   |
-// +-------------------------------------+
-// | SMM_CORE_SMI_DATABASE_STRUCTURE     |
-// +-------------------------------------+
+// +-------------------------------------------------+
+// | SMM_CORE_IMAGE_DATABASE_STRUCTURE               |
+// +-------------------------------------------------+
+// | SMM_CORE_SMI_DATABASE_STRUCTURE                 |
+// +-------------------------------------------------+
+// | SMM_CORE_SMI_SLOW_INVOCATION_DATABASE_STRUCTURE |
+// +-------------------------------------------------+
 //
 
 //
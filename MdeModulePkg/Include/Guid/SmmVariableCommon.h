@@ -77,6 +77,10 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO  14
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES.
+//
+#define SMM_VARIABLE_FUNCTION_GET_NEXT_VARIABLE_NAMES  15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -108,6 +112,23 @@ typedef struct {
   CHAR16      Name[1];
 } SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME;
 
+///
+/// This structure is used to communicate with SMI handler by GetNextVariableNames,
+/// which returns as many successive names as the payload can hold.
+/// On input, Names holds the name to start after. On output, NameCount names
+/// follow each other from Names, each one starting at the UINTN boundary that
+/// SMM_VARIABLE_NEXT_VARIABLE_NAME () returns for the previous one.
+///
+typedef struct {
+  UINTN                                              NameCount;
+  BOOLEAN                                            LastName; // The last returned name is the last variable
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME    Names;
+} SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES;
+
+#define SMM_VARIABLE_NEXT_VARIABLE_NAME(VariableName) \
+  ((SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME *)((UINT8 *)(VariableName) + \
+    ALIGN_VALUE (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME, Name) + (VariableName)->NameSize, sizeof (UINTN))))
+
 ///
 /// This structure is used to communicate with SMI handler by QueryVariableInfo.
 ///
@@ -135,6 +156,7 @@ typedef struct {
   BOOLEAN                  *ReadLock;
   BOOLEAN                  *PendingUpdate;
   BOOLEAN                  *HobFlushComplete;
+  UINT32                   *StoreGeneration;    // Incremented when a reclaim moves the variables of a store.
   VARIABLE_STORE_HEADER    *RuntimeHobCache;
   VARIABLE_STORE_HEADER    *RuntimeNvCache;
   VARIABLE_STORE_HEADER    *RuntimeVolatileCache;
@@ -0,0 +1,69 @@
+/** @file
+  The lookup hints of the variables the PEI variable module reads, kept in the
+  non-volatile variable store by the DXE or SMM variable module.
+
+  The PEI variable module records, in a GUID HOB, the hash of the non-volatile
+  variables it reads. The DXE or SMM variable module saves the hashes when it
+  starts, and a reclaim of the non-volatile store writes, as the first variable
+  of the store, a table with the offset of each of these variables in the new
+  store. A variable does not move until the next reclaim, which writes a new
+  table, so a following boot can read these variables from the offset recorded
+  in the table instead of walking the store.
+
+  The table is only a hint: the header, state, name and GUID of the variable at
+  a recorded offset are always checked, and the store is walked if they do not
+  match.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_LOOKUP_HINT_H__
+#define __VARIABLE_LOOKUP_HINT_H__
+
+#define EDKII_VARIABLE_LOOKUP_HINT_GUID \
+  { 0xadfc06d9, 0x8bfe, 0x42a0, { 0x92, 0x9e, 0x85, 0x3c, 0x17, 0x92, 0xc9, 0x1b } }
+
+//
+// The variable that holds the table, the first variable of the store.
+//
+#define EDKII_VARIABLE_LOOKUP_HINT_NAME  L"VarLookupHint"
+
+//
+// The maximum number of variables in the record and in the table.
+//
+#define EDKII_VARIABLE_LOOKUP_HINT_MAX  32
+
+//
+// The hash of a variable is the 32-bit FNV-1a of the bytes of its name,
+// without the null terminator, followed by the bytes of its vendor GUID.
+//
+
+///
+/// The data of the GUID HOB built by the PEI variable module.
+///
+typedef struct {
+  UINT32    Count;
+  UINT32    Hash[EDKII_VARIABLE_LOOKUP_HINT_MAX];
+} EDKII_VARIABLE_LOOKUP_HINT_RECORD;
+
+typedef struct {
+  UINT32    Hash;
+  ///
+  /// Offset of the variable from the end of the variable store header, 0 if
+  /// the variable was not found.
+  ///
+  UINT32    Offset;
+} EDKII_VARIABLE_LOOKUP_HINT_ENTRY;
+
+///
+/// The data of the EDKII_VARIABLE_LOOKUP_HINT_NAME variable.
+///
+typedef struct {
+  UINT32                              Count;
+  // EDKII_VARIABLE_LOOKUP_HINT_ENTRY  Entry[Count];
+} EDKII_VARIABLE_LOOKUP_HINT_TABLE;
+
+extern EFI_GUID  gEdkiiVariableLookupHintGuid;
+
+#endif
@@ -0,0 +1,22 @@
+/** @file
+  Zstandard Custom decompress algorithm Guid definition.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_GUID_H__
+#define __ZSTD_DECOMPRESS_GUID_H__
+
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been compressed into a
+/// Zstandard frame.
+///
+#define ZSTD_CUSTOM_DECOMPRESS_GUID  \
+  { 0xF2E9862B, 0xCC6C, 0x4A4D, { 0xB8, 0xF0, 0x05, 0xF6, 0x8B, 0xE9, 0xF7, 0xE3 } }
+
+extern GUID  gZstdCustomDecompressGuid;
+
+#endif
@@ -0,0 +1,66 @@
+/** @file
+  Poll Library
+
+  Provides a readiness-based wait for device initialization. A condition is
+  checked with an exponentially growing interval until it is met or the timeout
+  expires, instead of stalling for the worst case delay.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef POLL_LIB_H_
+#define POLL_LIB_H_
+
+///
+/// Timeout value that makes PollLibWaitUntil() wait until the condition is met.
+///
+#define POLL_LIB_WAIT_FOREVER  MAX_UINT64
+
+/**
+  Check whether the condition that is waited for is met.
+
+  @param[in] Context  The context passed to PollLibWaitUntil().
+
+  @retval EFI_SUCCESS    The condition is met.
+  @retval EFI_NOT_READY  The condition is not met yet.
+  @retval Others         The condition cannot be checked. The wait is aborted.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *POLL_LIB_CONDITION)(
+  IN VOID  *Context
+  );
+
+/**
+  Wait until a condition is met or the timeout expires.
+
+  The condition is checked right away, and then after delays that start at one
+  microsecond and double on each check up to MaxInterval. The time spent is measured
+  with the performance counter, so the timeout does not grow with the cost of the check.
+  If MeasurementString is not NULL, the wait is recorded as an in-module performance
+  measurement with that name.
+
+  @param[in] MeasurementString  Name of the performance measurement. Optional.
+  @param[in] Condition          The function that checks the condition.
+  @param[in] Context            The context passed to Condition. Optional.
+  @param[in] Timeout            The timeout in microseconds, or POLL_LIB_WAIT_FOREVER.
+  @param[in] MaxInterval        The maximum delay between two checks in microseconds.
+
+  @retval EFI_SUCCESS            The condition is met.
+  @retval EFI_TIMEOUT            The condition is not met within Timeout.
+  @retval EFI_INVALID_PARAMETER  Condition is NULL.
+  @retval Others                 The error returned by Condition.
+**/
+EFI_STATUS
+EFIAPI
+PollLibWaitUntil (
+  IN CONST CHAR8         *MeasurementString OPTIONAL,
+  IN POLL_LIB_CONDITION  Condition,
+  IN VOID                *Context OPTIONAL,
+  IN UINT64              Timeout,
+  IN UINT32              MaxInterval
+  );
+
+#endif
@@ -53,6 +53,38 @@ PerformQuickSort (
   IN       SORT_COMPARE  CompareFunction
   );
 
+/**
+  Function to perform a stable sort on a buffer of comparable elements: the
+  elements that compare equal keep their original order.
+
+  Each element must be equally sized.
+
+  If BufferToSort is NULL, then ASSERT.
+  If CompareFunction is NULL, then ASSERT.
+
+  If Count is < 2 , then perform no action.
+  If Size is < 1 , then perform no action.
+
+  @param[in, out] BufferToSort   On call, a Buffer of (possibly sorted) elements;
+                                 on return, a buffer of sorted elements.
+  @param[in]  Count              The number of elements in the buffer to sort.
+  @param[in]  ElementSize        The size of an element in bytes.
+  @param[in]  CompareFunction    The function to call to perform the comparison
+                                 of any two elements.
+
+  @retval EFI_SUCCESS            The buffer is sorted.
+  @retval EFI_OUT_OF_RESOURCES   The merge buffer could not be allocated, the
+                                 buffer is unchanged.
+**/
+EFI_STATUS
+EFIAPI
+PerformStableSort (
+  IN OUT VOID            *BufferToSort,
+  IN CONST UINTN         Count,
+  IN CONST UINTN         ElementSize,
+  IN       SORT_COMPARE  CompareFunction
+  );
+
 /**
   Function to compare 2 device paths for use as CompareFunction.
 
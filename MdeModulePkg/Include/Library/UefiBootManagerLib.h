@@ -559,6 +559,28 @@ EfiBootManagerConnectAll (
   VOID
   );
 
+/**
+  Connect the console devices and the device of the first boot option that
+  can be booted from, rather than all the controllers.
+
+  BootNext is tried first, then the boot options of BootOrder. The search
+  stops, and all the controllers are connected, at the first boot option with
+  a short-form device path or when no boot option can be connected.
+
+  Otherwise the controllers left are connected when anything but the boot
+  target is booted and when the boot options are refreshed, so that a boot
+  target that fails to boot falls back to the other boot options.
+
+  @retval EFI_SUCCESS    The device of a boot option is connected.
+  @retval EFI_NOT_FOUND  No boot target is found, all the controllers are
+                         connected.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerConnectBootTarget (
+  VOID
+  );
+
 /**
   This function will create all handles associate with every device
   path node. If the handle associate with one device path node can not
@@ -0,0 +1,108 @@
+/** @file
+  EDKII I2C Host Batch Protocol.
+
+  Platform code that reports the SPD of many DIMMs, or polls many sensors,
+  reads registers of several devices behind the same I2C host controller.
+  Issuing one synchronous EFI_I2C_HOST_PROTOCOL.QueueRequest() per register
+  keeps the bus idle between the requests while the caller builds the next
+  one. This protocol, produced by the I2C host driver along with
+  EFI_I2C_HOST_PROTOCOL, queues a set of register reads in one call. Each read
+  is a write of the register address followed by a burst read of the
+  requested length, and the reads are processed back to back in the FIFO
+  order of the I2C host.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_I2C_HOST_BATCH_PROTOCOL_H__
+#define __EDKII_I2C_HOST_BATCH_PROTOCOL_H__
+
+#define EDKII_I2C_HOST_BATCH_PROTOCOL_GUID \
+  { \
+    0xc4211818, 0x750a, 0x44b1, { 0x92, 0x84, 0xb5, 0xaf, 0xd3, 0xcc, 0x03, 0x90 } \
+  }
+
+typedef struct _EDKII_I2C_HOST_BATCH_PROTOCOL EDKII_I2C_HOST_BATCH_PROTOCOL;
+
+///
+/// A register read of an I2C device, and its result.
+///
+typedef struct {
+  ///
+  /// Address of the device on the I2C bus, as for
+  /// EFI_I2C_HOST_PROTOCOL.QueueRequest().
+  ///
+  UINTN         SlaveAddress;
+  ///
+  /// The register to read from, and the size in bytes of its address: 0 for
+  /// a device that has no register address, 1 or 2. A 2-byte register address
+  /// is sent most significant byte first.
+  ///
+  UINT16        Register;
+  UINT8         RegisterSize;
+  ///
+  /// The buffer that receives the registers, and its size in bytes. The
+  /// buffer must stay valid until the read completes.
+  ///
+  UINT32        Length;
+  UINT8         *Buffer;
+  ///
+  /// On output, the completion status of the read, as
+  /// EFI_I2C_HOST_PROTOCOL.QueueRequest() returns it.
+  ///
+  EFI_STATUS    Status;
+} EDKII_I2C_REGISTER_READ;
+
+/**
+  Queue several register reads for execution on the I2C controller.
+
+  This routine must be called at or below TPL_NOTIFY. For synchronous
+  requests this routine must be called at or below TPL_CALLBACK.
+
+  @param[in]     This                 Address of an EDKII_I2C_HOST_BATCH_PROTOCOL instance.
+  @param[in]     I2cBusConfiguration  I2C bus configuration to access the I2C devices.
+  @param[in,out] Reads                The register reads to perform. The Status of each
+                                      read receives its result. For asynchronous
+                                      operations, the array must stay valid until Event
+                                      is signaled.
+  @param[in]     ReadCount            The number of reads.
+  @param[in]     Event                Event to signal when all the reads completed, NULL
+                                      for synchronous operations.
+
+  @retval EFI_SUCCESS                 For synchronous operations, all the reads
+                                      completed successfully. For asynchronous
+                                      operations, the reads were queued.
+  @retval EFI_INVALID_PARAMETER       Reads is NULL or ReadCount is zero.
+  @retval EFI_INVALID_PARAMETER       A read has no Buffer, a Length of zero or a
+                                      RegisterSize larger than 2.
+  @retval EFI_INVALID_PARAMETER       TPL is too high.
+  @retval EFI_NOT_FOUND               The SlaveAddress of a read exceeds the maximum
+                                      address. No read was queued.
+  @retval EFI_OUT_OF_RESOURCES        Insufficient memory for the I2C operations. No
+                                      read was queued.
+  @retval Others                      For synchronous operations, the Status of the
+                                      first read that failed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_I2C_HOST_QUEUE_REGISTER_READS)(
+  IN CONST EDKII_I2C_HOST_BATCH_PROTOCOL  *This,
+  IN UINTN                                I2cBusConfiguration,
+  IN OUT EDKII_I2C_REGISTER_READ          *Reads,
+  IN UINTN                                ReadCount,
+  IN EFI_EVENT                            Event      OPTIONAL
+  );
+
+///
+/// The EDKII_I2C_HOST_BATCH_PROTOCOL queues several register reads of the
+/// devices behind an I2C host controller in one call.
+///
+struct _EDKII_I2C_HOST_BATCH_PROTOCOL {
+  EDKII_I2C_HOST_QUEUE_REGISTER_READS    QueueRegisterReads;
+};
+
+extern EFI_GUID  gEdkiiI2cHostBatchProtocolGuid;
+
+#endif
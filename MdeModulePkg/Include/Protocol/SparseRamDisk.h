@@ -0,0 +1,141 @@
+/** @file
+  EDKII Sparse RAM Disk Protocol.
+
+  A sparse RAM disk stores its content as fixed-size chunks. Chunks that were
+  never written read as zeros and take no memory, and chunks may be stored in
+  the UEFI compressed format and decompressed when they are read. This lets a
+  large image, such as an ISO downloaded by HTTP boot, be exposed as a RAM disk
+  without keeping all of it resident.
+
+  A sparse RAM disk produces the same device path, Block I/O and Block I/O 2
+  protocols as a RAM disk registered through EFI_RAM_DISK_PROTOCOL, and is
+  unregistered with EFI_RAM_DISK_PROTOCOL.Unregister(). The starting address
+  in its RAM disk device path node only identifies the disk; it is not the
+  address of the disk content. Publish() turns the disk into a regular RAM
+  disk in reserved memory, which is reported to the OS in the NFIT.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SPARSE_RAM_DISK_PROTOCOL_H__
+#define __EDKII_SPARSE_RAM_DISK_PROTOCOL_H__
+
+#include <Protocol/DevicePath.h>
+
+#define EDKII_SPARSE_RAM_DISK_PROTOCOL_GUID \
+  { \
+    0xc4128579, 0x405c, 0x4f85, { 0x8a, 0xb2, 0x89, 0x99, 0x6a, 0x63, 0xa1, 0x91 } \
+  }
+
+typedef struct _EDKII_SPARSE_RAM_DISK_PROTOCOL EDKII_SPARSE_RAM_DISK_PROTOCOL;
+
+/**
+  Register an empty sparse RAM disk with the specified size and type.
+
+  @param[in]  RamDiskSize    The size of the RAM disk.
+  @param[in]  RamDiskType    The type of the RAM disk. The GUID can be any of
+                             the values defined in section 9.3.6.9, or a
+                             vendor defined GUID.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device. This function allocates
+                             the buffer with the boot service AllocatePool().
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_REGISTER)(
+  IN UINT64                     RamDiskSize,
+  IN EFI_GUID                   *RamDiskType,
+  IN EFI_DEVICE_PATH            *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  );
+
+/**
+  Store one chunk of a sparse RAM disk.
+
+  A chunk covers ChunkSize bytes, except the last chunk of a disk whose size
+  is not a multiple of ChunkSize. A chunk that is entirely zero is dropped
+  instead of stored.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[in]  Offset         The byte offset of the chunk on the disk. It must
+                             be a multiple of ChunkSize.
+  @param[in]  Compressed     TRUE if Buffer holds the chunk in the UEFI
+                             compressed format, FALSE if it holds the chunk
+                             as is.
+  @param[in]  Buffer         The chunk data.
+  @param[in]  BufferSize     The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS             The chunk is stored.
+  @retval EFI_INVALID_PARAMETER   Offset is not a chunk offset of the disk, or
+                                  the (decompressed) data doesn't have the size
+                                  of the chunk.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to store the
+                                  chunk.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_WRITE_CHUNK)(
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN BOOLEAN                   Compressed,
+  IN VOID                      *Buffer,
+  IN UINTN                     BufferSize
+  );
+
+/**
+  Turn a sparse RAM disk into a regular RAM disk for OS handoff.
+
+  The content of the disk is copied to reserved memory, and the disk is
+  registered again with EFI_RAM_DISK_PROTOCOL.Register(), which reports it in
+  the NFIT. The sparse RAM disk is then unregistered; DevicePath is no longer
+  valid when this function returns successfully.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[out] NewDevicePath  On return, points to a pointer to the device path
+                             of the regular RAM disk.
+
+  @retval EFI_SUCCESS             The RAM disk is published.
+  @retval EFI_INVALID_PARAMETER   DevicePath or NewDevicePath is NULL.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the disk
+                                  content.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_PUBLISH)(
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **NewDevicePath
+  );
+
+///
+/// The EDKII_SPARSE_RAM_DISK_PROTOCOL registers and fills sparse RAM disks.
+///
+struct _EDKII_SPARSE_RAM_DISK_PROTOCOL {
+  ///
+  /// The size in bytes of a chunk.
+  ///
+  UINT32                               ChunkSize;
+  EDKII_SPARSE_RAM_DISK_REGISTER       Register;
+  EDKII_SPARSE_RAM_DISK_WRITE_CHUNK    WriteChunk;
+  EDKII_SPARSE_RAM_DISK_PUBLISH        Publish;
+};
+
+extern EFI_GUID  gEdkiiSparseRamDiskProtocolGuid;
+
+#endif
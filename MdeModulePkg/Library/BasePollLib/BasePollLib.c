@@ -0,0 +1,153 @@
+/** @file
+  Poll Library
+
+  Provides a readiness-based wait with exponential backoff for device initialization.
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PollLib.h>
+#include <Library/TimerLib.h>
+
+/**
+  Return the number of performance counter ticks between two counter values.
+
+  @param[in] Previous    The earlier performance counter value.
+  @param[in] Current     The later performance counter value.
+  @param[in] StartValue  The value the performance counter starts with.
+  @param[in] EndValue    The value the performance counter ends with.
+
+  @return The number of ticks from Previous to Current, assuming the counter
+          wrapped at most once.
+**/
+UINT64
+PollLibGetTicks (
+  IN UINT64  Previous,
+  IN UINT64  Current,
+  IN UINT64  StartValue,
+  IN UINT64  EndValue
+  )
+{
+  if (StartValue < EndValue) {
+    if (Current >= Previous) {
+      return Current - Previous;
+    }
+
+    return (EndValue - Previous) + (Current - StartValue);
+  }
+
+  if (Previous >= Current) {
+    return Previous - Current;
+  }
+
+  return (Previous - EndValue) + (StartValue - Current);
+}
+
+/**
+  Wait until a condition is met or the timeout expires.
+
+  The condition is checked right away, and then after delays that start at one
+  microsecond and double on each check up to MaxInterval. The time spent is measured
+  with the performance counter, so the timeout does not grow with the cost of the check.
+  If MeasurementString is not NULL, the wait is recorded as an in-module performance
+  measurement with that name.
+
+  @param[in] MeasurementString  Name of the performance measurement. Optional.
+  @param[in] Condition          The function that checks the condition.
+  @param[in] Context            The context passed to Condition. Optional.
+  @param[in] Timeout            The timeout in microseconds, or POLL_LIB_WAIT_FOREVER.
+  @param[in] MaxInterval        The maximum delay between two checks in microseconds.
+
+  @retval EFI_SUCCESS            The condition is met.
+  @retval EFI_TIMEOUT            The condition is not met within Timeout.
+  @retval EFI_INVALID_PARAMETER  Condition is NULL.
+  @retval Others                 The error returned by Condition.
+**/
+EFI_STATUS
+EFIAPI
+PollLibWaitUntil (
+  IN CONST CHAR8         *MeasurementString OPTIONAL,
+  IN POLL_LIB_CONDITION  Condition,
+  IN VOID                *Context OPTIONAL,
+  IN UINT64              Timeout,
+  IN UINT32              MaxInterval
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      StartValue;
+  UINT64      EndValue;
+  UINT64      Previous;
+  UINT64      Current;
+  UINT64      Ticks;
+  UINT64      Elapsed;
+  UINT64      Delayed;
+  UINT64      Interval;
+
+  if (Condition == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (MaxInterval == 0) {
+    MaxInterval = 1;
+  }
+
+  if (MeasurementString != NULL) {
+    PERF_INMODULE_BEGIN (MeasurementString);
+  }
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  Previous = GetPerformanceCounter ();
+  Ticks    = 0;
+  Delayed  = 0;
+  Interval = 1;
+
+  while (TRUE) {
+    Status = Condition (Context);
+    if (Status != EFI_NOT_READY) {
+      break;
+    }
+
+    //
+    // The ticks are accumulated on every check so that a counter wrap is handled. The sum of
+    // the delays is a lower bound of the time spent, which is used when the counter does not
+    // advance.
+    //
+    Current  = GetPerformanceCounter ();
+    Ticks   += PollLibGetTicks (Previous, Current, StartValue, EndValue);
+    Previous = Current;
+    Elapsed  = MAX (Delayed, DivU64x32 (GetTimeInNanoSecond (Ticks), 1000));
+
+    if (Timeout != POLL_LIB_WAIT_FOREVER) {
+      if (Elapsed >= Timeout) {
+        Status = EFI_TIMEOUT;
+        break;
+      }
+
+      Interval = MIN (Interval, Timeout - Elapsed);
+    }
+
+    MicroSecondDelay ((UINTN)Interval);
+    Delayed += Interval;
+    Interval = MIN (LShiftU64 (Interval, 1), MaxInterval);
+  }
+
+  if (MeasurementString != NULL) {
+    PERF_INMODULE_END (MeasurementString);
+  }
+
+  DEBUG_CODE_BEGIN ();
+  if ((MeasurementString != NULL) && (Status != EFI_SUCCESS)) {
+    DEBUG ((DEBUG_VERBOSE, "%a: %a - %r\n", __func__, MeasurementString, Status));
+  }
+
+  DEBUG_CODE_END ();
+
+  return Status;
+}
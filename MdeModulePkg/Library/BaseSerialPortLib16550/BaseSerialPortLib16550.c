@@ -657,10 +657,11 @@ SerialPortWrite (
   Result = NumberOfBytes;
   while (NumberOfBytes != 0) {
     //
-    // Wait for the serial port to be ready, to make sure both the transmit FIFO
-    // and shift register empty.
+    // Wait for the transmit FIFO to be empty. The shift register may still be
+    // sending the last byte of the previous burst: the next burst is queued
+    // behind it instead of leaving the line idle for a character time.
     //
-    while ((SerialPortReadRegister (SerialRegisterBase, R_UART_LSR) & (B_UART_LSR_TEMT | B_UART_LSR_TXRDY)) != (B_UART_LSR_TEMT | B_UART_LSR_TXRDY)) {
+    while ((SerialPortReadRegister (SerialRegisterBase, R_UART_LSR) & B_UART_LSR_TXRDY) == 0) {
     }
 
     //
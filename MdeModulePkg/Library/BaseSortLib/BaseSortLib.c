@@ -60,6 +60,68 @@ PerformQuickSort (
   return;
 }
 
+/**
+  Function to perform a stable sort on a buffer of comparable elements: the
+  elements that compare equal keep their original order.
+
+  Each element must be equal sized.
+
+  if BufferToSort is NULL, then ASSERT.
+  if CompareFunction is NULL, then ASSERT.
+
+  if Count is < 2 then perform no action.
+  if Size is < 1 then perform no action.
+
+  @param[in, out] BufferToSort   on call a Buffer of (possibly sorted) elements
+                                 on return a buffer of sorted elements
+  @param[in] Count               the number of elements in the buffer to sort
+  @param[in] ElementSize         Size of an element in bytes
+  @param[in] CompareFunction     The function to call to perform the comparison
+                                 of any 2 elements
+
+  @retval EFI_SUCCESS            The buffer is sorted.
+  @retval EFI_OUT_OF_RESOURCES   The merge buffer could not be allocated, the
+                                 buffer is unchanged.
+**/
+EFI_STATUS
+EFIAPI
+PerformStableSort (
+  IN OUT VOID            *BufferToSort,
+  IN CONST UINTN         Count,
+  IN CONST UINTN         ElementSize,
+  IN       SORT_COMPARE  CompareFunction
+  )
+{
+  VOID  *Buffer;
+
+  ASSERT (BufferToSort     != NULL);
+  ASSERT (CompareFunction  != NULL);
+
+  if ((Count < 2) || (ElementSize < 1)) {
+    return EFI_SUCCESS;
+  }
+
+  if (Count > MAX_UINTN / ElementSize) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Buffer = AllocatePool (Count * ElementSize);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  StableSort (
+    BufferToSort,
+    Count,
+    ElementSize,
+    CompareFunction,
+    Buffer
+    );
+
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
 /**
   Not supported in Base version.
 
@@ -25,6 +25,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define STRING_SIZE                (FPDT_STRING_EVENT_RECORD_NAME_LENGTH * sizeof (CHAR8))
 #define FIRMWARE_RECORD_BUFFER     0x10000
 #define CACHE_HANDLE_GUID_COUNT    0x800
+#define CACHE_HANDLE_GUID_BUCKETS  0x100
+
+//
+// The bucket of the handle in the cached array, from the bits of its address
+// above the pool alignment.
+//
+#define CACHE_HANDLE_GUID_BUCKET(Handle)  (((UINTN)(Handle) >> 3) & (CACHE_HANDLE_GUID_BUCKETS - 1))
 
 BOOT_PERFORMANCE_TABLE  *mAcpiBootPerformanceTable    = NULL;
 BOOT_PERFORMANCE_TABLE  mBootPerformanceTableTemplate = {
@@ -54,10 +61,18 @@ typedef struct {
   EFI_HANDLE    Handle;
   CHAR8         NameString[FPDT_STRING_EVENT_RECORD_NAME_LENGTH];
   EFI_GUID      ModuleGuid;
+  ///
+  /// 1 + index of the previous pair cached in the same bucket, 0 for none.
+  ///
+  UINT16        Next;
 } HANDLE_GUID_MAP;
 
 HANDLE_GUID_MAP  mCacheHandleGuidTable[CACHE_HANDLE_GUID_COUNT];
 UINTN            mCachePairCount = 0;
+//
+// 1 + index of the last pair cached in each bucket, 0 for none.
+//
+UINT16  mCacheHandleGuidBuckets[CACHE_HANDLE_GUID_BUCKETS];
 
 UINT32  mLoadImageCount       = 0;
 UINT32  mPerformanceLength    = 0;
@@ -100,6 +115,8 @@ GetFpdtRecordPtr (
   IN OUT FPDT_RECORD_PTR  *FpdtRecordPtr
   )
 {
+  UINT32  NewLength;
+
   if (mFpdtBufferIsReported) {
     //
     // Append Boot records to the boot performance table.
@@ -121,17 +138,22 @@ GetFpdtRecordPtr (
     //
     // Check if pre-allocated buffer is full
     //
+    //
+    // The buffer at least doubles, so that the records are copied a bounded
+    // number of times however many of them are logged.
+    //
     if (mPerformanceLength + RecordSize > mMaxPerformanceLength) {
+      NewLength           = MAX (mMaxPerformanceLength * 2, mPerformanceLength + RecordSize + FIRMWARE_RECORD_BUFFER);
       mPerformancePointer = ReallocatePool (
                               mPerformanceLength,
-                              mPerformanceLength + RecordSize + FIRMWARE_RECORD_BUFFER,
+                              NewLength,
                               mPerformancePointer
                               );
       if (mPerformancePointer == NULL) {
         return EFI_OUT_OF_RESOURCES;
       }
 
-      mMaxPerformanceLength = mPerformanceLength + RecordSize + FIRMWARE_RECORD_BUFFER;
+      mMaxPerformanceLength = NewLength;
     }
 
     //
@@ -460,7 +482,7 @@ GetModuleInfoFromHandle (
   EFI_GUID                           *TempGuid;
   UINTN                              StartIndex;
   UINTN                              Index;
-  INTN                               Count;
+  UINTN                              Entry;
   BOOLEAN                            ModuleGuidIsGet;
   UINTN                              StringSize;
   CHAR16                             *StringPtr;
@@ -472,15 +494,14 @@ GetModuleInfoFromHandle (
   }
 
   //
-  // Try to get the ModuleGuid and name string form the caached array.
+  // Try to get the ModuleGuid and name string form the caached array, from
+  // the last pair cached in the bucket of the handle.
   //
-  if (mCachePairCount > 0) {
-    for (Count = mCachePairCount -1; Count >= 0; Count--) {
-      if (Handle == mCacheHandleGuidTable[Count].Handle) {
-        CopyGuid (ModuleGuid, &mCacheHandleGuidTable[Count].ModuleGuid);
-        AsciiStrCpyS (NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, mCacheHandleGuidTable[Count].NameString);
-        return EFI_SUCCESS;
-      }
+  for (Entry = mCacheHandleGuidBuckets[CACHE_HANDLE_GUID_BUCKET (Handle)]; Entry != 0; Entry = mCacheHandleGuidTable[Entry - 1].Next) {
+    if (Handle == mCacheHandleGuidTable[Entry - 1].Handle) {
+      CopyGuid (ModuleGuid, &mCacheHandleGuidTable[Entry - 1].ModuleGuid);
+      AsciiStrCpyS (NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, mCacheHandleGuidTable[Entry - 1].NameString);
+      return EFI_SUCCESS;
     }
   }
 
@@ -666,6 +687,9 @@ Done:
     mCacheHandleGuidTable[mCachePairCount].Handle = Handle;
     CopyGuid (&mCacheHandleGuidTable[mCachePairCount].ModuleGuid, ModuleGuid);
     AsciiStrCpyS (mCacheHandleGuidTable[mCachePairCount].NameString, FPDT_STRING_EVENT_RECORD_NAME_LENGTH, NameString);
+    Entry                                       = CACHE_HANDLE_GUID_BUCKET (Handle);
+    mCacheHandleGuidTable[mCachePairCount].Next = mCacheHandleGuidBuckets[Entry];
+    mCacheHandleGuidBuckets[Entry]              = (UINT16)(mCachePairCount + 1);
     mCachePairCount++;
   }
 
@@ -177,6 +177,137 @@ FrameBufferBltConfigure (
   return RETURN_SUCCESS;
 }
 
+/**
+  Convert a line of BLT pixels to the pixel format of the frame buffer.
+
+  The masks and shifts are read once per line rather than once per pixel, as
+  the stores into the line buffer may otherwise alias them. The common RGB
+  format only swaps the red and blue bytes of each pixel.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[in]  Blt           The BLT pixels to convert.
+  @param[out] Pixels        The converted pixels.
+  @param[in]  Width         Number of pixels to convert.
+
+**/
+STATIC
+VOID
+FrameBufferBltLibBltToPixels (
+  IN  CONST FRAME_BUFFER_CONFIGURE         *Configure,
+  IN  CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt,
+  OUT UINT8                                *Pixels,
+  IN  UINTN                                Width
+  )
+{
+  UINTN   IndexX;
+  UINT32  Uint32;
+  UINT32  BytesPerPixel;
+  UINT32  RedMask;
+  UINT32  GreenMask;
+  UINT32  BlueMask;
+  INT8    RedShl;
+  INT8    RedShr;
+  INT8    GreenShl;
+  INT8    GreenShr;
+  INT8    BlueShl;
+  INT8    BlueShr;
+
+  if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32                     = *(CONST UINT32 *)&Blt[IndexX];
+      ((UINT32 *)Pixels)[IndexX] = ((Uint32 >> 16) & 0xff) | (Uint32 & 0xff00) | ((Uint32 & 0xff) << 16);
+    }
+
+    return;
+  }
+
+  BytesPerPixel = Configure->BytesPerPixel;
+  RedMask       = Configure->PixelMasks.RedMask;
+  GreenMask     = Configure->PixelMasks.GreenMask;
+  BlueMask      = Configure->PixelMasks.BlueMask;
+  RedShl        = Configure->PixelShl[0];
+  RedShr        = Configure->PixelShr[0];
+  GreenShl      = Configure->PixelShl[1];
+  GreenShr      = Configure->PixelShr[1];
+  BlueShl       = Configure->PixelShl[2];
+  BlueShr       = Configure->PixelShr[2];
+
+  for (IndexX = 0; IndexX < Width; IndexX++) {
+    Uint32                                         = *(CONST UINT32 *)&Blt[IndexX];
+    *(UINT32 *)(Pixels + (IndexX * BytesPerPixel)) =
+      (UINT32)(
+               (((Uint32 << RedShl) >> RedShr) & RedMask) |
+               (((Uint32 << GreenShl) >> GreenShr) & GreenMask) |
+               (((Uint32 << BlueShl) >> BlueShr) & BlueMask)
+               );
+  }
+}
+
+/**
+  Convert a line of pixels in the pixel format of the frame buffer to BLT
+  pixels.
+
+  @param[in]  Configure     Pointer to a configuration which was successfully
+                            created by FrameBufferBltConfigure ().
+  @param[in]  Pixels        The pixels to convert.
+  @param[out] Blt           The converted BLT pixels.
+  @param[in]  Width         Number of pixels to convert.
+
+**/
+STATIC
+VOID
+FrameBufferBltLibPixelsToBlt (
+  IN  CONST FRAME_BUFFER_CONFIGURE   *Configure,
+  IN  CONST UINT8                    *Pixels,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt,
+  IN  UINTN                          Width
+  )
+{
+  UINTN   IndexX;
+  UINT32  Uint32;
+  UINT32  BytesPerPixel;
+  UINT32  RedMask;
+  UINT32  GreenMask;
+  UINT32  BlueMask;
+  INT8    RedShl;
+  INT8    RedShr;
+  INT8    GreenShl;
+  INT8    GreenShr;
+  INT8    BlueShl;
+  INT8    BlueShr;
+
+  if (Configure->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+    for (IndexX = 0; IndexX < Width; IndexX++) {
+      Uint32                  = ((CONST UINT32 *)Pixels)[IndexX];
+      *(UINT32 *)&Blt[IndexX] = ((Uint32 >> 16) & 0xff) | (Uint32 & 0xff00) | ((Uint32 & 0xff) << 16);
+    }
+
+    return;
+  }
+
+  BytesPerPixel = Configure->BytesPerPixel;
+  RedMask       = Configure->PixelMasks.RedMask;
+  GreenMask     = Configure->PixelMasks.GreenMask;
+  BlueMask      = Configure->PixelMasks.BlueMask;
+  RedShl        = Configure->PixelShl[0];
+  RedShr        = Configure->PixelShr[0];
+  GreenShl      = Configure->PixelShl[1];
+  GreenShr      = Configure->PixelShr[1];
+  BlueShl       = Configure->PixelShl[2];
+  BlueShr       = Configure->PixelShr[2];
+
+  for (IndexX = 0; IndexX < Width; IndexX++) {
+    Uint32                  = *(CONST UINT32 *)(Pixels + (IndexX * BytesPerPixel));
+    *(UINT32 *)&Blt[IndexX] =
+      (UINT32)(
+               (((Uint32 & RedMask) >> RedShl) << RedShr) |
+               (((Uint32 & GreenMask) >> GreenShl) << GreenShr) |
+               (((Uint32 & BlueMask) >> BlueShl) << BlueShr)
+               );
+  }
+}
+
 /**
   Performs a UEFI Graphics Output Protocol Blt Video Fill.
 
@@ -375,8 +506,6 @@ FrameBufferBltLibVideoToBltBuffer (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
   UINT8                          *Source;
   UINT8                          *Destination;
-  UINTN                          IndexX;
-  UINT32                         Uint32;
   UINTN                          Offset;
   UINTN                          WidthInBytes;
 
@@ -426,21 +555,10 @@ FrameBufferBltLibVideoToBltBuffer (
     CopyMem (Destination, Source, WidthInBytes);
 
     if (Configure->PixelFormat != PixelBlueGreenRedReserved8BitPerColor) {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)
-              ((UINT8 *)BltBuffer + (DstY * Delta) +
-               (DestinationX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-        Uint32         = *(UINT32 *)(Configure->LineBuffer + (IndexX * Configure->BytesPerPixel));
-        *(UINT32 *)Blt =
-          (UINT32)(
-                   (((Uint32 & Configure->PixelMasks.RedMask) >>
-                     Configure->PixelShl[0]) << Configure->PixelShr[0]) |
-                   (((Uint32 & Configure->PixelMasks.GreenMask) >>
-                     Configure->PixelShl[1]) << Configure->PixelShr[1]) |
-                   (((Uint32 & Configure->PixelMasks.BlueMask) >>
-                     Configure->PixelShl[2]) << Configure->PixelShr[2])
-                   );
-      }
+      Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)
+            ((UINT8 *)BltBuffer + (DstY * Delta) +
+             DestinationX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+      FrameBufferBltLibPixelsToBlt (Configure, Configure->LineBuffer, Blt, Width);
     }
   }
 
@@ -483,8 +601,6 @@ FrameBufferBltLibBufferToVideo (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
   UINT8                          *Source;
   UINT8                          *Destination;
-  UINTN                          IndexX;
-  UINT32                         Uint32;
   UINTN                          Offset;
   UINTN                          WidthInBytes;
 
@@ -525,25 +641,13 @@ FrameBufferBltLibBufferToVideo (
     if (Configure->PixelFormat == PixelBlueGreenRedReserved8BitPerColor) {
       Source = (UINT8 *)BltBuffer + (SrcY * Delta) + SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
     } else {
-      for (IndexX = 0; IndexX < Width; IndexX++) {
-        Blt =
-          (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)(
-                                            (UINT8 *)BltBuffer +
-                                            (SrcY * Delta) +
-                                            ((SourceX + IndexX) * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
-                                            );
-        Uint32                                                                   = *(UINT32 *)Blt;
-        *(UINT32 *)(Configure->LineBuffer + (IndexX * Configure->BytesPerPixel)) =
-          (UINT32)(
-                   (((Uint32 << Configure->PixelShl[0]) >> Configure->PixelShr[0]) &
-                    Configure->PixelMasks.RedMask) |
-                   (((Uint32 << Configure->PixelShl[1]) >> Configure->PixelShr[1]) &
-                    Configure->PixelMasks.GreenMask) |
-                   (((Uint32 << Configure->PixelShl[2]) >> Configure->PixelShr[2]) &
-                    Configure->PixelMasks.BlueMask)
-                   );
-      }
-
+      Blt =
+        (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)(
+                                          (UINT8 *)BltBuffer +
+                                          (SrcY * Delta) +
+                                          (SourceX * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL))
+                                          );
+      FrameBufferBltLibBltToPixels (Configure, Blt, Configure->LineBuffer, Width);
       Source = Configure->LineBuffer;
     }
 
@@ -0,0 +1,308 @@
+/** @file
+  Compact the boot time S3 boot script table before it is locked.
+
+  Consecutive memory and PCI configuration writes to contiguous addresses are
+  grouped into one opcode, and read-modify-write sequences to the same register
+  are folded, so that fewer opcodes are decoded and dispatched on S3 resume.
+
+  Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include "InternalBootScriptLib.h"
+
+//
+// The register access described by a boot script write or read-modify-write opcode.
+//
+typedef struct {
+  UINT16    WriteOpCode;     // The write opcode of the address space.
+  BOOLEAN   IsWrite;         // TRUE for a write opcode, FALSE for a read-modify-write opcode.
+  UINT32    Width;
+  UINT64    Address;
+  UINT16    Segment;
+  UINT32    Count;           // Number of values of a write opcode.
+  UINTN     HeaderSize;      // Offset of the data from the start of the opcode.
+} BOOT_SCRIPT_ACCESS;
+
+/**
+  Decode a write or read-modify-write opcode of the memory or PCI configuration space.
+
+  @param[in]  Script  Pointer to the opcode.
+  @param[out] Access  Return the register access of the opcode.
+
+  @retval TRUE   The opcode is decoded.
+  @retval FALSE  The opcode cannot be compacted.
+**/
+BOOLEAN
+S3BootScriptGetAccess (
+  IN  UINT8               *Script,
+  OUT BOOT_SCRIPT_ACCESS  *Access
+  )
+{
+  EFI_BOOT_SCRIPT_COMMON_HEADER           ScriptHeader;
+  EFI_BOOT_SCRIPT_MEM_WRITE               MemWrite;
+  EFI_BOOT_SCRIPT_MEM_READ_WRITE          MemReadWrite;
+  EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE        PciWrite;
+  EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE   PciReadWrite;
+  EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE       PciWrite2;
+  EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE  PciReadWrite2;
+
+  CopyMem ((VOID *)&ScriptHeader, Script, sizeof (EFI_BOOT_SCRIPT_COMMON_HEADER));
+  ZeroMem (Access, sizeof (*Access));
+
+  switch (ScriptHeader.OpCode) {
+    case EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE:
+      CopyMem ((VOID *)&MemWrite, Script, sizeof (EFI_BOOT_SCRIPT_MEM_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE;
+      Access->IsWrite     = TRUE;
+      Access->Address     = MemWrite.Address;
+      Access->Count       = MemWrite.Count;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_MEM_WRITE);
+      break;
+
+    case EFI_BOOT_SCRIPT_MEM_READ_WRITE_OPCODE:
+      CopyMem ((VOID *)&MemReadWrite, Script, sizeof (EFI_BOOT_SCRIPT_MEM_READ_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_MEM_WRITE_OPCODE;
+      Access->Address     = MemReadWrite.Address;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_MEM_READ_WRITE);
+      break;
+
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE:
+      CopyMem ((VOID *)&PciWrite, Script, sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE;
+      Access->IsWrite     = TRUE;
+      Access->Address     = PciWrite.Address;
+      Access->Count       = PciWrite.Count;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE);
+      break;
+
+    case EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE_OPCODE:
+      CopyMem ((VOID *)&PciReadWrite, Script, sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_PCI_CONFIG_WRITE_OPCODE;
+      Access->Address     = PciReadWrite.Address;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG_READ_WRITE);
+      break;
+
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE:
+      CopyMem ((VOID *)&PciWrite2, Script, sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE;
+      Access->IsWrite     = TRUE;
+      Access->Address     = PciWrite2.Address;
+      Access->Segment     = PciWrite2.Segment;
+      Access->Count       = PciWrite2.Count;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE);
+      break;
+
+    case EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE_OPCODE:
+      CopyMem ((VOID *)&PciReadWrite2, Script, sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE));
+      Access->WriteOpCode = EFI_BOOT_SCRIPT_PCI_CONFIG2_WRITE_OPCODE;
+      Access->Address     = PciReadWrite2.Address;
+      Access->Segment     = PciReadWrite2.Segment;
+      Access->HeaderSize  = sizeof (EFI_BOOT_SCRIPT_PCI_CONFIG2_READ_WRITE);
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  //
+  // Only the plain widths access consecutive addresses. FIFO and FILL widths are left as they are.
+  //
+  Access->Width = ScriptHeader.Width;
+  if (Access->Width > S3BootScriptWidthUint64) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Update the Length and Count fields of a write opcode.
+
+  @param[in] Script  Pointer to the write opcode.
+  @param[in] Length  The new length of the opcode.
+  @param[in] Count   The new number of values of the opcode.
+**/
+VOID
+S3BootScriptSetWriteCount (
+  IN UINT8   *Script,
+  IN UINT8   Length,
+  IN UINT32  Count
+  )
+{
+  //
+  // OpCode, Length, Width, Count share the same offsets in all write opcodes.
+  //
+  Script[OFFSET_OF (EFI_BOOT_SCRIPT_MEM_WRITE, Length)] = Length;
+  CopyMem (Script + OFFSET_OF (EFI_BOOT_SCRIPT_MEM_WRITE, Count), &Count, sizeof (Count));
+}
+
+/**
+  Try to merge an opcode into the previous opcode.
+
+  1. A write that continues the previous write to the next address is appended to it.
+  2. A read-modify-write right after a read-modify-write to the same register is folded in the
+     previous one: ((V & M1) | D1) & M2 | D2 == (V & (M1 & M2)) | ((D1 & M2) | D2).
+  3. A read-modify-write right after a single value write to the same register changes the
+     written value.
+
+  @param[in, out] Previous  Pointer to the previous opcode.
+  @param[in]      Script    Pointer to the opcode to merge.
+
+  @retval TRUE   Script is merged into Previous. Previous may become longer.
+  @retval FALSE  Script cannot be merged.
+**/
+BOOLEAN
+S3BootScriptMergeOpCode (
+  IN OUT UINT8  *Previous,
+  IN     UINT8  *Script
+  )
+{
+  BOOT_SCRIPT_ACCESS  PreviousAccess;
+  BOOT_SCRIPT_ACCESS  Access;
+  UINT8               PreviousLength;
+  UINT8               WidthInByte;
+  UINT64              Value;
+  UINT64              Data;
+  UINT64              DataMask;
+  UINT64              PreviousData;
+  UINT64              PreviousDataMask;
+
+  if (!S3BootScriptGetAccess (Previous, &PreviousAccess) || !S3BootScriptGetAccess (Script, &Access)) {
+    return FALSE;
+  }
+
+  if ((PreviousAccess.WriteOpCode != Access.WriteOpCode) ||
+      (PreviousAccess.Width != Access.Width) ||
+      (PreviousAccess.Segment != Access.Segment))
+  {
+    return FALSE;
+  }
+
+  WidthInByte    = (UINT8)(0x01 << (Access.Width & 0x03));
+  PreviousLength = Previous[OFFSET_OF (EFI_BOOT_SCRIPT_GENERIC_HEADER, Length)];
+
+  if (PreviousAccess.IsWrite && Access.IsWrite) {
+    if ((Access.Address != PreviousAccess.Address + MultU64x32 (WidthInByte, PreviousAccess.Count)) ||
+        ((UINTN)PreviousLength + WidthInByte * Access.Count > MAX_UINT8))
+    {
+      return FALSE;
+    }
+
+    CopyMem (Previous + PreviousLength, Script + Access.HeaderSize, WidthInByte * Access.Count);
+    S3BootScriptSetWriteCount (
+      Previous,
+      (UINT8)(PreviousLength + WidthInByte * Access.Count),
+      PreviousAccess.Count + Access.Count
+      );
+    return TRUE;
+  }
+
+  if (Access.IsWrite || (Access.Address != PreviousAccess.Address)) {
+    return FALSE;
+  }
+
+  Data     = 0;
+  DataMask = 0;
+  CopyMem (&Data, Script + Access.HeaderSize, WidthInByte);
+  CopyMem (&DataMask, Script + Access.HeaderSize + WidthInByte, WidthInByte);
+
+  if (PreviousAccess.IsWrite) {
+    if (PreviousAccess.Count != 1) {
+      return FALSE;
+    }
+
+    Value = 0;
+    CopyMem (&Value, Previous + PreviousAccess.HeaderSize, WidthInByte);
+    Value = (Value & DataMask) | Data;
+    CopyMem (Previous + PreviousAccess.HeaderSize, &Value, WidthInByte);
+    return TRUE;
+  }
+
+  PreviousData     = 0;
+  PreviousDataMask = 0;
+  CopyMem (&PreviousData, Previous + PreviousAccess.HeaderSize, WidthInByte);
+  CopyMem (&PreviousDataMask, Previous + PreviousAccess.HeaderSize + WidthInByte, WidthInByte);
+  PreviousData      = (PreviousData & DataMask) | Data;
+  PreviousDataMask &= DataMask;
+  CopyMem (Previous + PreviousAccess.HeaderSize, &PreviousData, WidthInByte);
+  CopyMem (Previous + PreviousAccess.HeaderSize + WidthInByte, &PreviousDataMask, WidthInByte);
+  return TRUE;
+}
+
+/**
+  Compact the boot time boot script table in place before the terminate node is appended.
+
+  Only consecutive opcodes are merged, so the order of all the register accesses that are
+  kept, and the position of all other opcodes such as labels, stalls and polls relative to
+  them are not changed.
+**/
+VOID
+S3BootScriptInternalCompileTable (
+  VOID
+  )
+{
+  UINT8                           *TableBase;
+  UINT8                           *Script;
+  UINT8                           *Write;
+  UINT8                           *Previous;
+  UINT8                           *TableEnd;
+  UINT8                           Length;
+  UINTN                           OpCodeCount;
+  UINTN                           CompiledOpCodeCount;
+  EFI_BOOT_SCRIPT_TABLE_HEADER    TableHeader;
+  EFI_BOOT_SCRIPT_GENERIC_HEADER  ScriptHeader;
+
+  TableBase = mS3BootScriptTablePtr->TableBase;
+  if ((TableBase == NULL) || (mS3BootScriptTablePtr->TableLength == 0)) {
+    return;
+  }
+
+  CopyMem ((VOID *)&TableHeader, TableBase, sizeof (EFI_BOOT_SCRIPT_TABLE_HEADER));
+  if (TableHeader.OpCode != S3_BOOT_SCRIPT_LIB_TABLE_OPCODE) {
+    return;
+  }
+
+  Script              = TableBase + TableHeader.Length;
+  Write               = Script;
+  Previous            = NULL;
+  TableEnd            = TableBase + mS3BootScriptTablePtr->TableLength;
+  OpCodeCount         = 0;
+  CompiledOpCodeCount = 0;
+
+  while (Script < TableEnd) {
+    CopyMem ((VOID *)&ScriptHeader, Script, sizeof (EFI_BOOT_SCRIPT_GENERIC_HEADER));
+    Length = ScriptHeader.Length;
+    if ((Length == 0) || (Script + Length > TableEnd)) {
+      ASSERT (FALSE);
+      break;
+    }
+
+    OpCodeCount++;
+    if ((Previous != NULL) && S3BootScriptMergeOpCode (Previous, Script)) {
+      Write = Previous + Previous[OFFSET_OF (EFI_BOOT_SCRIPT_GENERIC_HEADER, Length)];
+    } else {
+      //
+      // Data of a merged write may have been appended up to Write, which never goes past Script.
+      //
+      CopyMem (Write, Script, Length);
+      Previous = Write;
+      Write   += Length;
+      CompiledOpCodeCount++;
+    }
+
+    Script += Length;
+  }
+
+  if (Script < TableEnd) {
+    //
+    // Keep the rest of a malformed table as it is.
+    //
+    CopyMem (Write, Script, TableEnd - Script);
+    Write += TableEnd - Script;
+  }
+
+  mS3BootScriptTablePtr->TableLength = (UINT32)(Write - TableBase);
+  DEBUG ((DEBUG_INFO, "S3BootScript: %d opcodes are compacted to %d\n", OpCodeCount, CompiledOpCodeCount));
+}
@@ -251,6 +251,10 @@ S3BootScriptEventCallBack (
     // or else, that will impact the performance. However, after SmmReadyToLock, we should append terminate
     // node on every add to boot script table.
     //
+    if (FeaturePcdGet (PcdS3BootScriptCoalesce)) {
+      S3BootScriptInternalCompileTable ();
+    }
+
     S3BootScriptInternalCloseTable ();
     mS3BootScriptTablePtr->SmmLocked = TRUE;
 
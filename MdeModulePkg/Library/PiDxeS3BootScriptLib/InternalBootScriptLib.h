@@ -100,4 +100,16 @@ extern SCRIPT_TABLE_PRIVATE_DATA  *mS3BootScriptTablePtr;
 ///
 #define S3_BOOT_SCRIPT_LIB_TERMINATE_OPCODE  0xFF
 
+/**
+  Compact the boot time boot script table in place before the terminate node is appended.
+
+  Only consecutive opcodes are merged, so the order of all the register accesses that are
+  kept, and the position of all other opcodes such as labels, stalls and polls relative to
+  them are not changed.
+**/
+VOID
+S3BootScriptInternalCompileTable (
+  VOID
+  );
+
 #endif //__INTERNAL_BOOT_SCRIPT_LIB__
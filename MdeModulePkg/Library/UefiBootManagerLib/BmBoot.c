@@ -1865,6 +1865,12 @@ EfiBootManagerBoot (
     }
   }
 
+  //
+  // Connect the controllers left by EfiBootManagerConnectBootTarget() before
+  // booting anything but its boot target.
+  //
+  BmConnectAllDeferred (OptionNumber);
+
   //
   // 2. Set BootCurrent
   //
@@ -2370,6 +2376,13 @@ EfiBootManagerRefreshAllBootOption (
   UINTN                                 UpdatedBootOptionCount;
   UINTN                                 Index;
   EDKII_PLATFORM_BOOT_MANAGER_PROTOCOL  *PlatformBootManager;
+  UINT32                                *NvBootOptionHashes;
+  UINT32                                *BootOptionHashes;
+
+  //
+  // The boot options of the devices not connected yet would be deleted.
+  //
+  BmConnectAllDeferred (LoadOptionNumberUnassigned);
 
   //
   // Optionally refresh the legacy boot option
@@ -2416,6 +2429,25 @@ EfiBootManagerRefreshAllBootOption (
 
   NvBootOptions = EfiBootManagerGetLoadOptions (&NvBootOptionCount, LoadOptionTypeBoot);
 
+  //
+  // Every NV boot option is looked up in the enumerated ones and the other way
+  // around, so only the options whose device paths have the same hash are
+  // compared.
+  //
+  NvBootOptionHashes = BmGetLoadOptionHashes (NvBootOptions, NvBootOptionCount);
+  BootOptionHashes   = BmGetLoadOptionHashes (BootOptions, BootOptionCount);
+  if ((NvBootOptionHashes == NULL) || (BootOptionHashes == NULL)) {
+    if (NvBootOptionHashes != NULL) {
+      FreePool (NvBootOptionHashes);
+      NvBootOptionHashes = NULL;
+    }
+
+    if (BootOptionHashes != NULL) {
+      FreePool (BootOptionHashes);
+      BootOptionHashes = NULL;
+    }
+  }
+
   //
   // Remove invalid EFI boot options from NV
   //
@@ -2429,7 +2461,14 @@ EfiBootManagerRefreshAllBootOption (
       // Only check those added by BDS
       // so that the boot options added by end-user or OS installer won't be deleted
       //
-      if (EfiBootManagerFindLoadOption (&NvBootOptions[Index], BootOptions, BootOptionCount) == -1) {
+      if (BmFindLoadOptionByHash (
+            &NvBootOptions[Index],
+            (NvBootOptionHashes != NULL) ? NvBootOptionHashes[Index] : 0,
+            BootOptions,
+            BootOptionHashes,
+            BootOptionCount
+            ) == -1)
+      {
         Status = EfiBootManagerDeleteLoadOptionVariable (NvBootOptions[Index].OptionNumber, LoadOptionTypeBoot);
         //
         // Deleting variable with current variable implementation shouldn't fail.
@@ -2443,7 +2482,14 @@ EfiBootManagerRefreshAllBootOption (
   // Add new EFI boot options to NV
   //
   for (Index = 0; Index < BootOptionCount; Index++) {
-    if (EfiBootManagerFindLoadOption (&BootOptions[Index], NvBootOptions, NvBootOptionCount) == -1) {
+    if (BmFindLoadOptionByHash (
+          &BootOptions[Index],
+          (BootOptionHashes != NULL) ? BootOptionHashes[Index] : 0,
+          NvBootOptions,
+          NvBootOptionHashes,
+          NvBootOptionCount
+          ) == -1)
+    {
       EfiBootManagerAddLoadOptionVariable (&BootOptions[Index], (UINTN)-1);
       //
       // Try best to add the boot options so continue upon failure.
@@ -2451,6 +2497,14 @@ EfiBootManagerRefreshAllBootOption (
     }
   }
 
+  if (NvBootOptionHashes != NULL) {
+    FreePool (NvBootOptionHashes);
+  }
+
+  if (BootOptionHashes != NULL) {
+    FreePool (BootOptionHashes);
+  }
+
   EfiBootManagerFreeLoadOptions (BootOptions, BootOptionCount);
   EfiBootManagerFreeLoadOptions (NvBootOptions, NvBootOptionCount);
 }
@@ -8,6 +8,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "InternalBm.h"
 
+//
+// TRUE when EfiBootManagerConnectBootTarget() connected only the devices of
+// its boot target, mBmBootTargetOptionNumber.
+//
+BOOLEAN  mBmConnectAllDeferred     = FALSE;
+UINTN    mBmBootTargetOptionNumber = LoadOptionNumberUnassigned;
+
 /**
   Connect all the drivers to all the controllers.
 
@@ -83,6 +90,198 @@ EfiBootManagerConnectAll (
   // platform default console
   //
   EfiBootManagerConnectAllDefaultConsoles ();
+
+  mBmConnectAllDeferred = FALSE;
+}
+
+/**
+  Connect the device of a boot option, and check that it can be booted from.
+
+  @param BootOption     The boot option.
+  @param Skipped        Return TRUE if the boot option is not a boot target.
+
+  @retval EFI_SUCCESS   The device of the boot option is connected.
+  @retval EFI_NOT_FOUND The device of the boot option cannot be connected.
+  @retval EFI_UNSUPPORTED The device of the boot option is only found by
+                        connecting all the controllers.
+**/
+STATIC
+EFI_STATUS
+BmConnectBootOptionDevice (
+  IN  EFI_BOOT_MANAGER_LOAD_OPTION  *BootOption,
+  OUT BOOLEAN                       *Skipped
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath;
+  EFI_HANDLE                Handle;
+
+  //
+  // Skip the boot options that BDS does not boot automatically.
+  //
+  *Skipped = (BOOLEAN)(((BootOption->Attributes & LOAD_OPTION_ACTIVE) == 0) ||
+                       ((BootOption->Attributes & LOAD_OPTION_CATEGORY) != LOAD_OPTION_CATEGORY_BOOT));
+  if (*Skipped) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((DevicePathType (BootOption->FilePath) == MEDIA_DEVICE_PATH) &&
+      (DevicePathSubType (BootOption->FilePath) == MEDIA_PIWG_FW_VOL_DP))
+  {
+    //
+    // The firmware volumes are already there.
+    //
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Short-form device paths are expanded by connecting all the controllers.
+  //
+  if ((DevicePathType (BootOption->FilePath) != ACPI_DEVICE_PATH) &&
+      (DevicePathType (BootOption->FilePath) != HARDWARE_DEVICE_PATH))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EfiBootManagerConnectDevicePath (BootOption->FilePath, NULL);
+
+  RemainingDevicePath = BootOption->FilePath;
+  Status              = gBS->LocateDevicePath (&gEfiSimpleFileSystemProtocolGuid, &RemainingDevicePath, &Handle);
+  if (EFI_ERROR (Status)) {
+    RemainingDevicePath = BootOption->FilePath;
+    Status              = gBS->LocateDevicePath (&gEfiLoadFileProtocolGuid, &RemainingDevicePath, &Handle);
+  }
+
+  return EFI_ERROR (Status) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
+/**
+  Connect the console devices and the device of the first boot option that
+  can be booted from, rather than all the controllers.
+
+  BootNext is tried first, then the boot options of BootOrder. The search
+  stops, and all the controllers are connected, at the first boot option with
+  a short-form device path or when no boot option can be connected.
+
+  Otherwise the controllers left are connected when anything but the boot
+  target is booted and when the boot options are refreshed, so that a boot
+  target that fails to boot falls back to the other boot options.
+
+  @retval EFI_SUCCESS    The device of a boot option is connected.
+  @retval EFI_NOT_FOUND  No boot target is found, all the controllers are
+                         connected.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerConnectBootTarget (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  UINT16                        *BootNext;
+  UINTN                         BootNextSize;
+  UINT16                        *BootOrder;
+  UINTN                         BootOrderSize;
+  UINT16                        *Candidates;
+  UINTN                         CandidateCount;
+  UINTN                         Index;
+  BOOLEAN                       Skipped;
+  CHAR16                        OptionName[BM_OPTION_NAME_LEN];
+  EFI_BOOT_MANAGER_LOAD_OPTION  BootOption;
+
+  PERF_INMODULE_BEGIN ("BmConnectConsoles");
+  EfiBootManagerConnectAllDefaultConsoles ();
+  PERF_INMODULE_END ("BmConnectConsoles");
+
+  GetEfiGlobalVariable2 (L"BootNext", (VOID **)&BootNext, &BootNextSize);
+  if ((BootNext != NULL) && (BootNextSize != sizeof (UINT16))) {
+    FreePool (BootNext);
+    BootNext = NULL;
+  }
+
+  GetEfiGlobalVariable2 (L"BootOrder", (VOID **)&BootOrder, &BootOrderSize);
+  if (BootOrder == NULL) {
+    BootOrderSize = 0;
+  }
+
+  CandidateCount = BootOrderSize / sizeof (UINT16);
+  Candidates     = AllocatePool ((CandidateCount + 1) * sizeof (UINT16));
+  if (Candidates != NULL) {
+    if (BootNext != NULL) {
+      Candidates[0] = *BootNext;
+      CopyMem (&Candidates[1], BootOrder, CandidateCount * sizeof (UINT16));
+      CandidateCount++;
+    } else {
+      CopyMem (Candidates, BootOrder, CandidateCount * sizeof (UINT16));
+    }
+  } else {
+    CandidateCount = 0;
+  }
+
+  PERF_INMODULE_BEGIN ("BmConnectBootTarget");
+  Status = EFI_NOT_FOUND;
+  for (Index = 0; Index < CandidateCount; Index++) {
+    UnicodeSPrint (OptionName, sizeof (OptionName), L"%s%04x", mBmLoadOptionName[LoadOptionTypeBoot], Candidates[Index]);
+    if (EFI_ERROR (EfiBootManagerVariableToLoadOption (OptionName, &BootOption))) {
+      continue;
+    }
+
+    Status = BmConnectBootOptionDevice (&BootOption, &Skipped);
+    DEBUG ((DEBUG_INFO, "[Bds]Connect boot target %s - %r\n", OptionName, Status));
+    EfiBootManagerFreeLoadOption (&BootOption);
+    if (!EFI_ERROR (Status) || (Status == EFI_UNSUPPORTED)) {
+      break;
+    }
+  }
+
+  PERF_INMODULE_END ("BmConnectBootTarget");
+
+  if (!EFI_ERROR (Status)) {
+    mBmConnectAllDeferred     = TRUE;
+    mBmBootTargetOptionNumber = Candidates[Index];
+  } else {
+    PERF_INMODULE_BEGIN ("BmConnectAll");
+    EfiBootManagerConnectAll ();
+    PERF_INMODULE_END ("BmConnectAll");
+    Status = EFI_NOT_FOUND;
+  }
+
+  if (Candidates != NULL) {
+    FreePool (Candidates);
+  }
+
+  if (BootOrder != NULL) {
+    FreePool (BootOrder);
+  }
+
+  if (BootNext != NULL) {
+    FreePool (BootNext);
+  }
+
+  return Status;
+}
+
+/**
+  Connect the controllers that EfiBootManagerConnectBootTarget() left, unless
+  the boot target is the one to boot.
+
+  @param OptionNumber   The number of the boot option to boot, or
+                        LoadOptionNumberUnassigned if none.
+**/
+VOID
+BmConnectAllDeferred (
+  IN UINTN  OptionNumber
+  )
+{
+  if (!mBmConnectAllDeferred || (OptionNumber == mBmBootTargetOptionNumber)) {
+    return;
+  }
+
+  mBmConnectAllDeferred = FALSE;
+
+  PERF_INMODULE_BEGIN ("BmConnectAllDeferred");
+  EfiBootManagerConnectAll ();
+  PERF_INMODULE_END ("BmConnectAllDeferred");
 }
 
 /**
@@ -568,6 +568,80 @@ EfiBootManagerFindLoadOption (
   return -1;
 }
 
+/**
+  Return the hashes of the device paths of load options.
+
+  @param  Options      The load options.
+  @param  Count        The number of load options.
+
+  @return The hashes of the device paths, or NULL if there is no load option
+          or no memory. Caller is responsible to free the memory.
+**/
+UINT32 *
+BmGetLoadOptionHashes (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Options,
+  IN UINTN                               Count
+  )
+{
+  UINT32  *Hashes;
+  UINTN   Index;
+
+  if (Count == 0) {
+    return NULL;
+  }
+
+  Hashes = AllocatePool (Count * sizeof (UINT32));
+  if (Hashes == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Hashes[Index] = GetDevicePathHash (Options[Index].FilePath);
+  }
+
+  return Hashes;
+}
+
+/**
+  Find the load option like EfiBootManagerFindLoadOption(), only comparing the
+  load options whose device path hashes equal the one of Key.
+
+  @param  Key          Pointer to the load option to be found.
+  @param  KeyHash      The hash of the device path of Key.
+  @param  Array        Pointer to the array of load options to be found.
+  @param  ArrayHashes  The hashes of the device paths of Array, from
+                       BmGetLoadOptionHashes(). NULL to compare all of them.
+  @param  Count        Number of entries in the Array.
+
+  @retval -1          Key wasn't found in the Array.
+  @retval 0 ~ Count-1 The index of the Key in the Array.
+**/
+INTN
+BmFindLoadOptionByHash (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Key,
+  IN UINT32                              KeyHash,
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Array,
+  IN CONST UINT32                        *ArrayHashes OPTIONAL,
+  IN UINTN                               Count
+  )
+{
+  UINTN  Index;
+
+  if (ArrayHashes == NULL) {
+    return EfiBootManagerFindLoadOption (Key, Array, Count);
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    if ((ArrayHashes[Index] == KeyHash) &&
+        (EfiBootManagerFindLoadOption (Key, &Array[Index], 1) == 0))
+    {
+      return (INTN)Index;
+    }
+  }
+
+  return -1;
+}
+
 /**
   Delete the load option.
 
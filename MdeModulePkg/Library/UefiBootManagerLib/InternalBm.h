@@ -170,6 +170,44 @@ typedef struct {
 
 #define BM_HOTKEY_FROM_LINK(a)  CR (a, BM_HOTKEY, Link, BM_HOTKEY_SIGNATURE)
 
+/**
+  Return the hashes of the device paths of load options.
+
+  @param  Options      The load options.
+  @param  Count        The number of load options.
+
+  @return The hashes of the device paths, or NULL if there is no load option
+          or no memory. Caller is responsible to free the memory.
+**/
+UINT32 *
+BmGetLoadOptionHashes (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Options,
+  IN UINTN                               Count
+  );
+
+/**
+  Find the load option like EfiBootManagerFindLoadOption(), only comparing the
+  load options whose device path hashes equal the one of Key.
+
+  @param  Key          Pointer to the load option to be found.
+  @param  KeyHash      The hash of the device path of Key.
+  @param  Array        Pointer to the array of load options to be found.
+  @param  ArrayHashes  The hashes of the device paths of Array, from
+                       BmGetLoadOptionHashes(). NULL to compare all of them.
+  @param  Count        Number of entries in the Array.
+
+  @retval -1          Key wasn't found in the Array.
+  @retval 0 ~ Count-1 The index of the Key in the Array.
+**/
+INTN
+BmFindLoadOptionByHash (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Key,
+  IN UINT32                              KeyHash,
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Array,
+  IN CONST UINT32                        *ArrayHashes OPTIONAL,
+  IN UINTN                               Count
+  );
+
 /**
   Get the Option Number that wasn't used.
 
@@ -239,6 +277,18 @@ BmConnectUsbShortFormDevicePath (
   IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   );
 
+/**
+  Connect the controllers that EfiBootManagerConnectBootTarget() left, unless
+  the boot target is the one to boot.
+
+  @param OptionNumber   The number of the boot option to boot, or
+                        LoadOptionNumberUnassigned if none.
+**/
+VOID
+BmConnectAllDeferred (
+  IN UINTN  OptionNumber
+  );
+
 /**
   Stop the hotkey processing.
 
@@ -24,7 +24,30 @@
 #define UNIT_TEST_APP_NAME     "UefiSortLib Unit Tests"
 #define UNIT_TEST_APP_VERSION  "1.0"
 
-#define TEST_ARRAY_SIZE_9  9
+#define TEST_ARRAY_SIZE_9     9
+#define TEST_ARRAY_SIZE_1000  1000
+
+/**
+  The function is called by PerformStableSort to compare the upper 16 bits of
+  UINT32 values, in ascending order.
+
+  @param[in] Left            The pointer to first buffer.
+  @param[in] Right           The pointer to second buffer.
+
+  @retval 0                  Buffer1 equal to Buffer2.
+  @return <0                 Buffer1 is less than Buffer2.
+  @return >0                 Buffer1 is greater than Buffer2.
+
+**/
+INTN
+EFIAPI
+TestCompareKeyFunction (
+  IN CONST VOID  *Left,
+  IN CONST VOID  *Right
+  )
+{
+  return (INTN)(*(UINT32 *)Left >> 16) - (INTN)(*(UINT32 *)Right >> 16);
+}
 
 /**
   The function is called by PerformQuickSort to compare int values.
@@ -91,6 +114,100 @@ SortUINT32ArrayShouldSucceed (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for PerformQuickSort () API of the UefiSortLib, on large sorted,
+  reversed and constant buffers.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SortLargeUINT32ArrayShouldSucceed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Index;
+  UINT32  Pass;
+  UINT32  TestBuffer[TEST_ARRAY_SIZE_1000];
+
+  for (Pass = 0; Pass < 4; Pass++) {
+    for (Index = 0; Index < TEST_ARRAY_SIZE_1000; Index++) {
+      switch (Pass) {
+        case 0:
+          TestBuffer[Index] = Index;
+          break;
+        case 1:
+          TestBuffer[Index] = TEST_ARRAY_SIZE_1000 - Index;
+          break;
+        case 2:
+          TestBuffer[Index] = 7;
+          break;
+        default:
+          TestBuffer[Index] = (Index * 7919) % 613;
+          break;
+      }
+    }
+
+    PerformQuickSort (TestBuffer, TEST_ARRAY_SIZE_1000, sizeof (UINT32), (SORT_COMPARE)TestCompareFunction);
+    for (Index = 1; Index < TEST_ARRAY_SIZE_1000; Index++) {
+      UT_ASSERT_TRUE (TestBuffer[Index - 1] >= TestBuffer[Index]);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for PerformStableSort () API of the UefiSortLib.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+StableSortKeepsEqualOrderShouldSucceed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Index;
+  UINT32      TestBuffer[TEST_ARRAY_SIZE_1000];
+
+  //
+  // The upper 16 bits are the sort key, the lower 16 bits the original index.
+  //
+  for (Index = 0; Index < TEST_ARRAY_SIZE_1000; Index++) {
+    TestBuffer[Index] = (((Index * 7919) % 37) << 16) | Index;
+  }
+
+  Status = PerformStableSort (TestBuffer, TEST_ARRAY_SIZE_1000, sizeof (UINT32), (SORT_COMPARE)TestCompareKeyFunction);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  for (Index = 1; Index < TEST_ARRAY_SIZE_1000; Index++) {
+    UT_ASSERT_TRUE (TestBuffer[Index - 1] < TestBuffer[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Unit test for StringCompare () API of the UefiSortLib.
 
@@ -167,6 +284,8 @@ UnitTestingEntry (
   // --------------Suite--------Description------------Name--------------Function----------------Pre---Post---Context-----------
   //
   AddTestCase (SortTests, "Sort the Array", "Sort", SortUINT32ArrayShouldSucceed, NULL, NULL, NULL);
+  AddTestCase (SortTests, "Sort a large Array", "SortLarge", SortLargeUINT32ArrayShouldSucceed, NULL, NULL, NULL);
+  AddTestCase (SortTests, "Stable sort the Array", "StableSort", StableSortKeepsEqualOrderShouldSucceed, NULL, NULL, NULL);
   AddTestCase (SortTests, "Compare the Buffer", "Compare", CompareSameBufferShouldSucceed, NULL, NULL, NULL);
 
   //
@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 extern EFI_GET_VARIABLE  mGetVariableHelper;
 extern UINT8             *mPolicyTable;
+extern UINT32            *mPolicyIndex;
 STATIC BOOLEAN           mIsVirtualAddrConverted;
 STATIC EFI_EVENT         mVariablePolicyLibVirtualAddressChangeEvent = NULL;
 
@@ -31,6 +32,7 @@ VariablePolicyLibVirtualAddressCallback (
   )
 {
   gRT->ConvertPointer (0, (VOID **)&mPolicyTable);
+  gRT->ConvertPointer (0, (VOID **)&mPolicyIndex);
   gRT->ConvertPointer (0, (VOID **)&mGetVariableHelper);
   mIsVirtualAddrConverted = TRUE;
 }
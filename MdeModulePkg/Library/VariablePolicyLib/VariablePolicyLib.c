@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Uefi.h>
 
+#include <Library/BaseLib.h>
 #include <Library/SafeIntLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -47,6 +48,19 @@ STATIC  UINT32  mCurrentTableCount = 0;
 
 #define POLICY_TABLE_STEP_SIZE  0x1000
 
+// Index of the policy table, built when the interface is locked and the table
+// can no longer change. The policies are bucketed by namespace and name length,
+// since a policy can only match a variable of its namespace whose name has the
+// same length, wildcards included, or any variable of its namespace if it has
+// no name. The index holds the start of each bucket in the entry array, followed
+// by the entry array, the offsets of the policies in the table, in table order
+// within a bucket.
+UINT32          *mPolicyIndex           = NULL;
+STATIC  UINT32  mPolicyIndexBucketCount = 0;
+
+#define POLICY_INDEX_MIN_BUCKET_COUNT  16
+#define POLICY_INDEX_ANY_NAME          MAX_UINT32
+
 // NOTE: DO NOT USE THESE MACROS on any structure that has not been validated.
 //       Current table data has already been sanitized.
 #define GET_NEXT_POLICY(CurPolicy)  (VARIABLE_POLICY_ENTRY*)((UINT8*)CurPolicy + CurPolicy->Size)
@@ -292,6 +306,131 @@ Exit:
   return Result;
 }
 
+/**
+  This helper function returns the bucket of the policy index that holds the
+  policies of a namespace with names of a given length.
+
+  @param[in]  Namespace       The namespace of the policies.
+  @param[in]  NameLength      The length of the names in characters, or
+                              POLICY_INDEX_ANY_NAME for the policies without
+                              name.
+
+  @retval     The bucket index, smaller than mPolicyIndexBucketCount.
+
+**/
+STATIC
+UINT32
+GetPolicyIndexBucket (
+  IN CONST  EFI_GUID  *Namespace,
+  IN        UINT32    NameLength
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)Namespace) ^
+         ReadUnaligned32 ((CONST UINT32 *)Namespace + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Namespace + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Namespace + 3);
+  Hash ^= NameLength * 0x9E3779B1;
+  Hash ^= Hash >> 16;
+  Hash *= 0x85EBCA6B;
+  Hash ^= Hash >> 13;
+
+  return Hash & (mPolicyIndexBucketCount - 1);
+}
+
+/**
+  This helper function returns the key length used by the policy index for a policy.
+
+  @param[in]  Policy      Pointer to a policy of the table.
+
+  @retval     The length of the policy name in characters, or POLICY_INDEX_ANY_NAME
+              if the policy matches the entire namespace.
+
+**/
+STATIC
+UINT32
+GetPolicyIndexNameLength (
+  IN CONST  VARIABLE_POLICY_ENTRY  *Policy
+  )
+{
+  if (Policy->Size == Policy->OffsetToName) {
+    return POLICY_INDEX_ANY_NAME;
+  }
+
+  return (UINT32)StrLen (GET_POLICY_NAME (Policy));
+}
+
+/**
+  This helper function builds the index of the policy table. The table must not
+  change once the index is built.
+
+  Failing to build the index is not an error, the policy table is walked instead.
+
+**/
+STATIC
+VOID
+BuildPolicyIndex (
+  VOID
+  )
+{
+  VARIABLE_POLICY_ENTRY  *CurrentEntry;
+  UINT32                 *BucketStart;
+  UINT32                 *Entries;
+  UINT32                 BucketCount;
+  UINT32                 Bucket;
+  UINT32                 Index;
+
+  if (mCurrentTableCount == 0) {
+    return;
+  }
+
+  BucketCount = POLICY_INDEX_MIN_BUCKET_COUNT;
+  while (BucketCount < mCurrentTableCount) {
+    BucketCount <<= 1;
+  }
+
+  // One more bucket start than buckets, for the end of the last bucket.
+  BucketStart = AllocateRuntimeZeroPool ((BucketCount + 1 + mCurrentTableCount) * sizeof (UINT32));
+  if (BucketStart == NULL) {
+    DEBUG ((DEBUG_WARN, "%a - No index for %d policies.\n", __func__, mCurrentTableCount));
+    return;
+  }
+
+  Entries                 = BucketStart + BucketCount + 1;
+  mPolicyIndexBucketCount = BucketCount;
+
+  // Count the policies of each bucket, at the start of the next bucket.
+  CurrentEntry = (VARIABLE_POLICY_ENTRY *)mPolicyTable;
+  for (Index = 0; Index < mCurrentTableCount; Index++) {
+    Bucket                   = GetPolicyIndexBucket (&CurrentEntry->Namespace, GetPolicyIndexNameLength (CurrentEntry));
+    BucketStart[Bucket + 1] += 1;
+    CurrentEntry             = GET_NEXT_POLICY (CurrentEntry);
+  }
+
+  for (Bucket = 0; Bucket < BucketCount; Bucket++) {
+    BucketStart[Bucket + 1] += BucketStart[Bucket];
+  }
+
+  // Fill the buckets in table order, using the start of each bucket as its fill
+  // position. Each start is moved to the start of the next bucket on the way.
+  CurrentEntry = (VARIABLE_POLICY_ENTRY *)mPolicyTable;
+  for (Index = 0; Index < mCurrentTableCount; Index++) {
+    Bucket                       = GetPolicyIndexBucket (&CurrentEntry->Namespace, GetPolicyIndexNameLength (CurrentEntry));
+    Entries[BucketStart[Bucket]] = (UINT32)((UINT8 *)CurrentEntry - mPolicyTable);
+    BucketStart[Bucket]         += 1;
+    CurrentEntry                 = GET_NEXT_POLICY (CurrentEntry);
+  }
+
+  for (Bucket = BucketCount; Bucket > 0; Bucket--) {
+    BucketStart[Bucket] = BucketStart[Bucket - 1];
+  }
+
+  BucketStart[0] = 0;
+
+  mPolicyIndex = BucketStart;
+}
+
 /**
   This helper function walks the current policy table and returns a pointer
   to the best match, if any are found. Leverages EvaluatePolicyMatch() to
@@ -320,10 +459,43 @@ GetBestPolicyMatch (
   UINT8                  MatchPriority;
   UINT8                  CurrentPriority;
   UINTN                  Index;
+  UINT32                 NameLength[2];
+  UINT32                 Bucket;
+  UINTN                  Key;
 
   BestResult    = NULL;
   MatchPriority = MATCH_PRIORITY_EXACT;
 
+  // Once the table is indexed, only the policies with a name of the same length
+  // and those without name can match.
+  if (mPolicyIndex != NULL) {
+    NameLength[0] = (UINT32)StrLen (VariableName);
+    NameLength[1] = POLICY_INDEX_ANY_NAME;
+    for (Key = 0; Key < ARRAY_SIZE (NameLength); Key++) {
+      Bucket = GetPolicyIndexBucket (VendorGuid, NameLength[Key]);
+      for (Index = mPolicyIndex[Bucket]; Index < mPolicyIndex[Bucket + 1]; Index++) {
+        CurrentEntry = (VARIABLE_POLICY_ENTRY *)(mPolicyTable + mPolicyIndex[mPolicyIndexBucketCount + 1 + Index]);
+        if (EvaluatePolicyMatch (CurrentEntry, VariableName, VendorGuid, &CurrentPriority)) {
+          // If match is better, take it. Equal matches go to the first one in
+          // the table, as when the table is walked.
+          if ((BestResult == NULL) || (CurrentPriority < MatchPriority) ||
+              ((CurrentPriority == MatchPriority) && (CurrentEntry < BestResult)))
+          {
+            BestResult    = CurrentEntry;
+            MatchPriority = CurrentPriority;
+          }
+        }
+      }
+
+      // If you've hit the highest-priority match, can exit now.
+      if ((BestResult != NULL) && (MatchPriority == MATCH_PRIORITY_EXACT)) {
+        break;
+      }
+    }
+
+    goto Exit;
+  }
+
   // Walk all entries in the table, looking for matches.
   CurrentEntry = (VARIABLE_POLICY_ENTRY *)mPolicyTable;
   for (Index = 0; Index < mCurrentTableCount; Index++) {
@@ -345,6 +517,7 @@ GetBestPolicyMatch (
     CurrentEntry = GET_NEXT_POLICY (CurrentEntry);
   }
 
+Exit:
   // If a return priority was requested, return it.
   if (ReturnPriority != NULL) {
     *ReturnPriority = MatchPriority;
@@ -729,6 +902,10 @@ LockVariablePolicy (
   }
 
   mInterfaceLocked = TRUE;
+
+  // The policy table can no longer change, index it for ValidateSetVariable().
+  BuildPolicyIndex ();
+
   return EFI_SUCCESS;
 }
 
@@ -797,6 +974,7 @@ InitVariablePolicyLib (
     mCurrentTableSize   = 0;
     mCurrentTableUsage  = 0;
     mCurrentTableCount  = 0;
+    mPolicyIndex        = NULL;
   }
 
   return Status;
@@ -857,6 +1035,11 @@ DeinitVariablePolicyLib (
       FreePool (mPolicyTable);
       mPolicyTable = NULL;
     }
+
+    if (mPolicyIndex != NULL) {
+      FreePool (mPolicyIndex);
+      mPolicyIndex = NULL;
+    }
   }
 
   return Status;
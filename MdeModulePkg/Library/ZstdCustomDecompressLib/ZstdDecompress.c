@@ -0,0 +1,1897 @@
+/** @file
+  Zstandard Decompress interfaces
+
+  This is a one-shot decoder of the Zstandard frames of RFC 8878: the frame is
+  decoded in a single call, into a buffer that holds the whole content, so the
+  decoded content is also the window and no data is ever copied twice. The
+  entropy tables and the literals of a block are kept in the caller's scratch
+  buffer, and no memory is allocated. Dictionaries are not supported.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ZstdDecompressLibInternal.h"
+
+#define ZSTD_MAGIC_NUMBER              0xFD2FB528
+#define ZSTD_SKIPPABLE_MAGIC_MASK      0xFFFFFFF0
+#define ZSTD_SKIPPABLE_MAGIC_NUMBER    0x184D2A50
+#define ZSTD_FRAME_HEADER_SIZE_MIN     5
+#define ZSTD_BLOCK_HEADER_SIZE         3
+#define ZSTD_BLOCK_SIZE_MAX            SIZE_128KB
+#define ZSTD_CHECKSUM_SIZE             4
+
+#define ZSTD_BLOCK_TYPE_RAW         0
+#define ZSTD_BLOCK_TYPE_RLE         1
+#define ZSTD_BLOCK_TYPE_COMPRESSED  2
+
+#define ZSTD_LITERALS_TYPE_RAW         0
+#define ZSTD_LITERALS_TYPE_RLE         1
+#define ZSTD_LITERALS_TYPE_COMPRESSED  2
+#define ZSTD_LITERALS_TYPE_TREELESS    3
+
+#define ZSTD_TABLE_MODE_PREDEFINED  0
+#define ZSTD_TABLE_MODE_RLE         1
+#define ZSTD_TABLE_MODE_COMPRESSED  2
+#define ZSTD_TABLE_MODE_REPEAT      3
+
+#define ZSTD_HUFFMAN_LOG_MAX         11
+#define ZSTD_HUFFMAN_SYMBOLS_MAX     256
+#define ZSTD_WEIGHT_LOG_MAX          6
+#define ZSTD_LITERAL_LENGTH_LOG_MAX  9
+#define ZSTD_MATCH_LENGTH_LOG_MAX    9
+#define ZSTD_OFFSET_LOG_MAX          8
+#define ZSTD_FSE_LOG_MIN             5
+
+#define ZSTD_LITERAL_LENGTH_CODE_MAX  35
+#define ZSTD_MATCH_LENGTH_CODE_MAX    52
+#define ZSTD_OFFSET_CODE_MAX          31
+#define ZSTD_FSE_SYMBOLS_MAX          (ZSTD_MATCH_LENGTH_CODE_MAX + 1)
+
+//
+// The number of bits of the backward bit reader that are always available
+// after a reload, unless the start of the stream is reached.
+//
+#define ZSTD_CONTAINER_BITS       (sizeof (UINTN) * 8)
+#define ZSTD_CONTAINER_BITS_MIN   (ZSTD_CONTAINER_BITS - 7)
+#define ZSTD_CONTAINER_IS_32_BIT  (sizeof (UINTN) < sizeof (UINT64))
+
+#define ZSTD_XXH64_PRIME_1  0x9E3779B185EBCA87ULL
+#define ZSTD_XXH64_PRIME_2  0xC2B2AE3D27D4EB4FULL
+#define ZSTD_XXH64_PRIME_3  0x165667B19E3779F9ULL
+#define ZSTD_XXH64_PRIME_4  0x85EBCA77C2B2AE63ULL
+#define ZSTD_XXH64_PRIME_5  0x27D4EB2F165667C5ULL
+
+//
+// A state of a FSE decoding table: the symbol it decodes, and the next state,
+// Base plus the value of the next Bits bits of the stream.
+//
+typedef struct {
+  UINT16    Base;
+  UINT8     Symbol;
+  UINT8     Bits;
+} ZSTD_FSE_ENTRY;
+
+//
+// An entry of a Huffman decoding table, indexed by the next HuffmanLog bits of
+// the stream: the symbol they start with, and the length of its prefix code.
+//
+typedef struct {
+  UINT8    Symbol;
+  UINT8    Bits;
+} ZSTD_HUFFMAN_ENTRY;
+
+//
+// The backward bit reader of the Huffman and FSE streams. Container holds the
+// sizeof (UINTN) bytes at Current, the first Consumed bits of which, from the
+// highest one, have been read.
+//
+typedef struct {
+  CONST UINT8    *Start;
+  CONST UINT8    *Current;
+  UINTN          Container;
+  UINTN          Consumed;
+} ZSTD_BIT_READER;
+
+//
+// The decoder context, in the scratch buffer. The tables of a block may be
+// repeated by the next blocks of the frame.
+//
+typedef struct {
+  ZSTD_HUFFMAN_ENTRY    HuffmanTable[1 << ZSTD_HUFFMAN_LOG_MAX];
+  ZSTD_FSE_ENTRY        LiteralLengthTable[1 << ZSTD_LITERAL_LENGTH_LOG_MAX];
+  ZSTD_FSE_ENTRY        OffsetTable[1 << ZSTD_OFFSET_LOG_MAX];
+  ZSTD_FSE_ENTRY        MatchLengthTable[1 << ZSTD_MATCH_LENGTH_LOG_MAX];
+  UINTN                 HuffmanLog;
+  UINTN                 LiteralLengthLog;
+  UINTN                 OffsetLog;
+  UINTN                 MatchLengthLog;
+  BOOLEAN               HuffmanValid;
+  BOOLEAN               LiteralLengthValid;
+  BOOLEAN               OffsetValid;
+  BOOLEAN               MatchLengthValid;
+  UINT32                Repeat[3];
+  UINT8                 Literals[ZSTD_BLOCK_SIZE_MAX];
+} ZSTD_DECODER;
+
+//
+// The baselines and extra bits of the literal length and match length codes.
+//
+STATIC CONST UINT32  mZstdLiteralLengthBase[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  0,   1,    2,    3,    4,    5,    6,     7,     8,     9,     10,    11,
+  12,  13,   14,   15,   16,   18,   20,    22,    24,    28,    32,    40,
+  48,  64,   128,  256,  512,  1024, 2048,  4096,  8192,  16384, 32768, 65536
+};
+
+STATIC CONST UINT8  mZstdLiteralLengthBits[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,  0,
+  0, 0, 0, 0, 1, 1, 1, 1, 2, 2,  3,  3,
+  4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+
+STATIC CONST UINT32  mZstdMatchLengthBase[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  3,   4,   5,    6,    7,    8,    9,    10,   11,    12,    13,    14,    15,    16,
+  17,  18,  19,   20,   21,   22,   23,   24,   25,    26,    27,    28,    29,    30,
+  31,  32,  33,   34,   35,   37,   39,   41,   43,    47,    51,    59,    67,    83,
+  99,  131, 259,  515,  1027, 2051, 4099, 8195, 16387, 32771, 65539
+};
+
+STATIC CONST UINT8  mZstdMatchLengthBits[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,
+  0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4,  4,
+  5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+};
+
+//
+// The predefined distributions of the literal length, offset and match length
+// codes.
+//
+STATIC CONST INT16  mZstdLiteralLengthDefault[ZSTD_LITERAL_LENGTH_CODE_MAX + 1] = {
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1
+};
+
+STATIC CONST INT16  mZstdOffsetDefault[29] = {
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+STATIC CONST INT16  mZstdMatchLengthDefault[ZSTD_MATCH_LENGTH_CODE_MAX + 1] = {
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1
+};
+
+#define ZSTD_LITERAL_LENGTH_DEFAULT_LOG  6
+#define ZSTD_OFFSET_DEFAULT_LOG          5
+#define ZSTD_MATCH_LENGTH_DEFAULT_LOG    6
+
+/**
+  Reads a little endian 16-bit value.
+
+  @param  Buffer  The unaligned value.
+
+  @return The value.
+**/
+STATIC
+UINT32
+ZstdRead16 (
+  IN CONST UINT8  *Buffer
+  )
+{
+  return (UINT32)Buffer[0] | ((UINT32)Buffer[1] << 8);
+}
+
+/**
+  Reads a little endian 24-bit value.
+
+  @param  Buffer  The unaligned value.
+
+  @return The value.
+**/
+STATIC
+UINT32
+ZstdRead24 (
+  IN CONST UINT8  *Buffer
+  )
+{
+  return ZstdRead16 (Buffer) | ((UINT32)Buffer[2] << 16);
+}
+
+/**
+  Reads a little endian 32-bit value.
+
+  @param  Buffer  The unaligned value.
+
+  @return The value.
+**/
+STATIC
+UINT32
+ZstdRead32 (
+  IN CONST UINT8  *Buffer
+  )
+{
+  return ZstdRead16 (Buffer) | (ZstdRead16 (Buffer + 2) << 16);
+}
+
+/**
+  Reads a little endian 64-bit value.
+
+  @param  Buffer  The unaligned value.
+
+  @return The value.
+**/
+STATIC
+UINT64
+ZstdRead64 (
+  IN CONST UINT8  *Buffer
+  )
+{
+  return ZstdRead32 (Buffer) | LShiftU64 (ZstdRead32 (Buffer + 4), 32);
+}
+
+/**
+  Reads a little endian UINTN.
+
+  @param  Buffer  The unaligned value.
+
+  @return The value.
+**/
+STATIC
+UINTN
+ZstdReadUintn (
+  IN CONST UINT8  *Buffer
+  )
+{
+  if (ZSTD_CONTAINER_IS_32_BIT) {
+    return ZstdRead32 (Buffer);
+  }
+
+  return (UINTN)ZstdRead64 (Buffer);
+}
+
+/**
+  Returns the bit position of the highest bit set of a value.
+
+  @param  Value  The value, not zero.
+
+  @return The bit position of the highest bit set.
+**/
+STATIC
+UINTN
+ZstdHighBit (
+  IN UINT32  Value
+  )
+{
+  return (UINTN)HighBitSet32 (Value);
+}
+
+/**
+  Starts reading a backward bit stream, whose last byte holds the end mark.
+
+  @param  Reader  The bit reader.
+  @param  Buffer  The bit stream.
+  @param  Size    The size of the bit stream in bytes.
+
+  @retval RETURN_SUCCESS           The bit reader is at the start of the stream.
+  @retval RETURN_INVALID_PARAMETER The stream is empty, or has no end mark.
+**/
+STATIC
+RETURN_STATUS
+ZstdBitReaderInit (
+  OUT ZSTD_BIT_READER  *Reader,
+  IN  CONST UINT8      *Buffer,
+  IN  UINTN            Size
+  )
+{
+  UINTN  Index;
+
+  if ((Size == 0) || (Buffer[Size - 1] == 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Reader->Start = Buffer;
+  if (Size >= sizeof (UINTN)) {
+    Reader->Current   = Buffer + Size - sizeof (UINTN);
+    Reader->Container = ZstdReadUintn (Reader->Current);
+    Reader->Consumed  = 8 - ZstdHighBit (Buffer[Size - 1]);
+  } else {
+    //
+    // The whole stream is in the container, after as many consumed zero bytes
+    // as needed to fill it.
+    //
+    Reader->Current   = Buffer;
+    Reader->Container = 0;
+    for (Index = 0; Index < Size; Index++) {
+      Reader->Container |= (UINTN)Buffer[Index] << (Index * 8);
+    }
+
+    Reader->Consumed = 8 - ZstdHighBit (Buffer[Size - 1]) + (sizeof (UINTN) - Size) * 8;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Returns the next bits of a backward bit stream, without consuming them.
+
+  @param  Reader  The bit reader.
+  @param  Bits    The number of bits, at most ZSTD_CONTAINER_BITS_MIN.
+
+  @return The bits.
+**/
+STATIC
+UINTN
+ZstdBitReaderPeek (
+  IN ZSTD_BIT_READER  *Reader,
+  IN UINTN            Bits
+  )
+{
+  return ((Reader->Container << (Reader->Consumed & (ZSTD_CONTAINER_BITS - 1))) >> 1) >> (ZSTD_CONTAINER_BITS - 1 - Bits);
+}
+
+/**
+  Reads the next bits of a backward bit stream.
+
+  @param  Reader  The bit reader.
+  @param  Bits    The number of bits, at most ZSTD_CONTAINER_BITS_MIN.
+
+  @return The bits.
+**/
+STATIC
+UINTN
+ZstdBitReaderRead (
+  IN OUT ZSTD_BIT_READER  *Reader,
+  IN     UINTN            Bits
+  )
+{
+  UINTN  Value;
+
+  Value             = ZstdBitReaderPeek (Reader, Bits);
+  Reader->Consumed += Bits;
+  return Value;
+}
+
+/**
+  Refills the container of a backward bit stream, so that at least
+  ZSTD_CONTAINER_BITS_MIN bits are available, unless the start of the stream is
+  reached.
+
+  @param  Reader  The bit reader.
+**/
+STATIC
+VOID
+ZstdBitReaderReload (
+  IN OUT ZSTD_BIT_READER  *Reader
+  )
+{
+  UINTN  Bytes;
+
+  if (Reader->Consumed > ZSTD_CONTAINER_BITS) {
+    return;
+  }
+
+  Bytes = Reader->Consumed / 8;
+  if ((UINTN)(Reader->Current - Reader->Start) < Bytes) {
+    Bytes = (UINTN)(Reader->Current - Reader->Start);
+  }
+
+  if (Bytes == 0) {
+    return;
+  }
+
+  Reader->Current  -= Bytes;
+  Reader->Consumed -= Bytes * 8;
+  Reader->Container = ZstdReadUintn (Reader->Current);
+}
+
+/**
+  Returns whether more bits than the stream holds were read.
+
+  @param  Reader  The bit reader.
+
+  @retval TRUE   The stream is overread.
+  @retval FALSE  The stream is not overread.
+**/
+STATIC
+BOOLEAN
+ZstdBitReaderOverflow (
+  IN ZSTD_BIT_READER  *Reader
+  )
+{
+  return (BOOLEAN)(Reader->Consumed > ZSTD_CONTAINER_BITS);
+}
+
+/**
+  Returns whether exactly all the bits of the stream were read.
+
+  @param  Reader  The bit reader.
+
+  @retval TRUE   The stream is read to its start.
+  @retval FALSE  The stream is not read to its start, or is overread.
+**/
+STATIC
+BOOLEAN
+ZstdBitReaderFinished (
+  IN ZSTD_BIT_READER  *Reader
+  )
+{
+  return (BOOLEAN)((Reader->Current == Reader->Start) && (Reader->Consumed == ZSTD_CONTAINER_BITS));
+}
+
+/**
+  Reads bits of a forward bit stream, as zero past its end.
+
+  @param  Buffer  The bit stream.
+  @param  Size    The size of the bit stream in bytes.
+  @param  Offset  The offset of the bits in the stream, in bits.
+  @param  Bits    The number of bits, at most 24.
+
+  @return The bits.
+**/
+STATIC
+UINT32
+ZstdReadForwardBits (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size,
+  IN UINTN        Offset,
+  IN UINTN        Bits
+  )
+{
+  UINT32  Value;
+  UINTN   Index;
+
+  Value = 0;
+  for (Index = 0; Index < 4; Index++) {
+    if ((Offset / 8) + Index < Size) {
+      Value |= (UINT32)Buffer[(Offset / 8) + Index] << (Index * 8);
+    }
+  }
+
+  return (Value >> (Offset % 8)) & ((1U << Bits) - 1);
+}
+
+/**
+  Reads the description of a FSE distribution.
+
+  @param  Buffer      The description.
+  @param  Size        The size in bytes of the buffer holding the description.
+  @param  SymbolMax   The largest symbol of the distribution.
+  @param  LogMax      The largest accuracy log of the distribution.
+  @param  Counts      The distribution, SymbolMax + 1 counts, -1 for a less
+                      than one probability.
+  @param  Symbols     The number of symbols described.
+  @param  Log         The accuracy log of the distribution.
+  @param  Used        The size of the description in bytes.
+
+  @retval RETURN_SUCCESS           The distribution is read.
+  @retval RETURN_INVALID_PARAMETER The description is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdReadFseDistribution (
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN        Size,
+  IN  UINTN        SymbolMax,
+  IN  UINTN        LogMax,
+  OUT INT16        *Counts,
+  OUT UINTN        *Symbols,
+  OUT UINTN        *Log,
+  OUT UINTN        *Used
+  )
+{
+  UINTN  Offset;
+  UINTN  Symbol;
+  UINTN  Bits;
+  INTN   Remaining;
+  INTN   Threshold;
+  INTN   Max;
+  INTN   Count;
+  UINTN  Value;
+  UINTN  Repeat;
+  UINTN  Index;
+
+  if (Size == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Log = ZstdReadForwardBits (Buffer, Size, 0, 4) + ZSTD_FSE_LOG_MIN;
+  if (*Log > LogMax) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Offset    = 4;
+  Remaining = ((INTN)1 << *Log) + 1;
+  Threshold = (INTN)1 << *Log;
+  Bits      = *Log + 1;
+  Symbol    = 0;
+  while ((Remaining > 1) && (Symbol <= SymbolMax)) {
+    //
+    // The counts below Max take one bit less.
+    //
+    Max   = 2 * Threshold - 1 - Remaining;
+    Value = ZstdReadForwardBits (Buffer, Size, Offset, Bits);
+    if ((INTN)(Value & (Threshold - 1)) < Max) {
+      Count   = (INTN)(Value & (Threshold - 1));
+      Offset += Bits - 1;
+    } else {
+      Count = (INTN)(Value & (2 * Threshold - 1));
+      if (Count >= Threshold) {
+        Count -= Max;
+      }
+
+      Offset += Bits;
+    }
+
+    Count--;
+    Remaining        -= (Count < 0) ? -Count : Count;
+    Counts[Symbol++]  = (INT16)Count;
+
+    //
+    // A zero count is followed by 2-bit repeat counts of zero counts, 3 asking
+    // for another repeat count.
+    //
+    if (Count == 0) {
+      do {
+        Repeat  = ZstdReadForwardBits (Buffer, Size, Offset, 2);
+        Offset += 2;
+        if (Symbol + Repeat > SymbolMax + 1) {
+          return RETURN_INVALID_PARAMETER;
+        }
+
+        for (Index = 0; Index < Repeat; Index++) {
+          Counts[Symbol++] = 0;
+        }
+      } while (Repeat == 3 && Offset <= Size * 8);
+    }
+
+    while (Remaining < Threshold) {
+      Bits--;
+      Threshold >>= 1;
+    }
+  }
+
+  if ((Remaining != 1) || (Offset > Size * 8)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Symbols = Symbol;
+  *Used    = (Offset + 7) / 8;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Builds the decoding table of a FSE distribution.
+
+  @param  Table    The decoding table, of 1 << Log states.
+  @param  Counts   The distribution, -1 for a less than one probability.
+  @param  Symbols  The number of symbols of the distribution.
+  @param  Log      The accuracy log of the distribution.
+
+  @retval RETURN_SUCCESS           The table is built.
+  @retval RETURN_INVALID_PARAMETER The distribution is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdBuildFseTable (
+  OUT ZSTD_FSE_ENTRY  *Table,
+  IN  CONST INT16     *Counts,
+  IN  UINTN           Symbols,
+  IN  UINTN           Log
+  )
+{
+  UINT16  Next[ZSTD_FSE_SYMBOLS_MAX];
+  UINTN   Size;
+  UINTN   High;
+  UINTN   Step;
+  UINTN   Position;
+  UINTN   Symbol;
+  UINTN   Index;
+  UINTN   State;
+
+  Size = (UINTN)1 << Log;
+  High = Size - 1;
+
+  //
+  // The symbols of a less than one probability take the last states.
+  //
+  for (Symbol = 0; Symbol < Symbols; Symbol++) {
+    if (Counts[Symbol] == -1) {
+      Table[High--].Symbol = (UINT8)Symbol;
+      Next[Symbol]         = 1;
+    } else {
+      Next[Symbol] = (UINT16)Counts[Symbol];
+    }
+  }
+
+  //
+  // Spread the other symbols over the remaining states.
+  //
+  Step     = (Size >> 1) + (Size >> 3) + 3;
+  Position = 0;
+  for (Symbol = 0; Symbol < Symbols; Symbol++) {
+    for (Index = 0; (INTN)Index < Counts[Symbol]; Index++) {
+      Table[Position].Symbol = (UINT8)Symbol;
+      do {
+        Position = (Position + Step) & (Size - 1);
+      } while (Position > High);
+    }
+  }
+
+  if (Position != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < Size; Index++) {
+    State              = Next[Table[Index].Symbol]++;
+    Table[Index].Bits  = (UINT8)(Log - ZstdHighBit ((UINT32)State));
+    Table[Index].Base  = (UINT16)((State << Table[Index].Bits) - Size);
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Builds the Huffman decoding table from the weights of the symbols.
+
+  @param  Decoder   The decoder context.
+  @param  Weights   The weights of the symbols, but the last one, which is implied.
+  @param  Count     The number of weights.
+
+  @retval RETURN_SUCCESS           The table is built.
+  @retval RETURN_INVALID_PARAMETER The weights are corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdBuildHuffmanTable (
+  IN OUT ZSTD_DECODER  *Decoder,
+  IN OUT UINT8         *Weights,
+  IN     UINTN         Count
+  )
+{
+  UINT32  Total;
+  UINT32  Rest;
+  UINTN   Log;
+  UINTN   Symbol;
+  UINTN   Weight;
+  UINTN   Index;
+  UINTN   Length;
+  UINTN   Start[ZSTD_HUFFMAN_LOG_MAX + 2];
+
+  if (Count >= ZSTD_HUFFMAN_SYMBOLS_MAX) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Start, sizeof (Start));
+  Total = 0;
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    if (Weights[Symbol] > ZSTD_HUFFMAN_LOG_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if (Weights[Symbol] != 0) {
+      Total += 1U << (Weights[Symbol] - 1);
+    }
+  }
+
+  if (Total == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The weight of the last symbol completes the total to a power of two.
+  //
+  Log = ZstdHighBit (Total) + 1;
+  if (Log > ZSTD_HUFFMAN_LOG_MAX) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Rest = (1U << Log) - Total;
+  if ((Rest & (Rest - 1)) != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Weights[Count++] = (UINT8)(ZstdHighBit (Rest) + 1);
+
+  //
+  // The symbols of weight W have codes of Log + 1 - W bits, and the shorter
+  // codes follow the longer ones. Each symbol takes 1 << (W - 1) entries.
+  //
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    if (Weights[Symbol] != 0) {
+      Start[Weights[Symbol] + 1] += (UINTN)1 << (Weights[Symbol] - 1);
+    }
+  }
+
+  for (Weight = 2; Weight <= Log + 1; Weight++) {
+    Start[Weight] += Start[Weight - 1];
+  }
+
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    Weight = Weights[Symbol];
+    if (Weight == 0) {
+      continue;
+    }
+
+    Length = (UINTN)1 << (Weight - 1);
+    for (Index = Start[Weight]; Index < Start[Weight] + Length; Index++) {
+      Decoder->HuffmanTable[Index].Symbol = (UINT8)Symbol;
+      Decoder->HuffmanTable[Index].Bits   = (UINT8)(Log + 1 - Weight);
+    }
+
+    Start[Weight] += Length;
+  }
+
+  Decoder->HuffmanLog   = Log;
+  Decoder->HuffmanValid = TRUE;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Reads the Huffman tree description of a literals section, and builds its
+  decoding table.
+
+  @param  Decoder   The decoder context.
+  @param  Buffer    The tree description.
+  @param  Size      The size in bytes of the buffer holding the description.
+  @param  Used      The size of the description in bytes.
+
+  @retval RETURN_SUCCESS           The table is built.
+  @retval RETURN_INVALID_PARAMETER The description is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdReadHuffmanTree (
+  IN OUT ZSTD_DECODER  *Decoder,
+  IN     CONST UINT8   *Buffer,
+  IN     UINTN         Size,
+  OUT    UINTN         *Used
+  )
+{
+  RETURN_STATUS    Status;
+  UINT8            Weights[ZSTD_HUFFMAN_SYMBOLS_MAX];
+  ZSTD_FSE_ENTRY   Table[1 << ZSTD_WEIGHT_LOG_MAX];
+  INT16            Counts[ZSTD_HUFFMAN_LOG_MAX + 1];
+  ZSTD_BIT_READER  Reader;
+  UINTN            Count;
+  UINTN            Bytes;
+  UINTN            Symbols;
+  UINTN            Log;
+  UINTN            TableSize;
+  UINTN            State1;
+  UINTN            State2;
+
+  if (Size == 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Buffer[0] >= 128) {
+    //
+    // The weights are 4-bit values, the first one in the high bits.
+    //
+    Count = Buffer[0] - 127;
+    Bytes = (Count + 1) / 2;
+    if (Bytes + 1 > Size) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    for (Symbols = 0; Symbols < Count; Symbols++) {
+      Weights[Symbols] = (Symbols % 2 == 0) ? Buffer[1 + Symbols / 2] >> 4 : Buffer[1 + Symbols / 2] & 0xF;
+    }
+  } else {
+    //
+    // The weights are FSE compressed, with two interleaved states.
+    //
+    Bytes = Buffer[0];
+    if ((Bytes == 0) || (Bytes + 1 > Size)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Status = ZstdReadFseDistribution (Buffer + 1, Bytes, ZSTD_HUFFMAN_LOG_MAX, ZSTD_WEIGHT_LOG_MAX, Counts, &Symbols, &Log, &TableSize);
+    if (!RETURN_ERROR (Status)) {
+      Status = ZstdBuildFseTable (Table, Counts, Symbols, Log);
+    }
+
+    if (!RETURN_ERROR (Status)) {
+      Status = ZstdBitReaderInit (&Reader, Buffer + 1 + TableSize, Bytes - TableSize);
+    }
+
+    if (RETURN_ERROR (Status) || (TableSize >= Bytes)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    State1 = ZstdBitReaderRead (&Reader, Log);
+    State2 = ZstdBitReaderRead (&Reader, Log);
+    ZstdBitReaderReload (&Reader);
+    Count = 0;
+    for ( ; ;) {
+      if (Count + 2 > ZSTD_HUFFMAN_SYMBOLS_MAX - 1) {
+        return RETURN_INVALID_PARAMETER;
+      }
+
+      Weights[Count++] = Table[State1].Symbol;
+      State1           = Table[State1].Base + ZstdBitReaderRead (&Reader, Table[State1].Bits);
+      ZstdBitReaderReload (&Reader);
+      if (ZstdBitReaderOverflow (&Reader)) {
+        Weights[Count++] = Table[State2].Symbol;
+        break;
+      }
+
+      Weights[Count++] = Table[State2].Symbol;
+      State2           = Table[State2].Base + ZstdBitReaderRead (&Reader, Table[State2].Bits);
+      ZstdBitReaderReload (&Reader);
+      if (ZstdBitReaderOverflow (&Reader)) {
+        Weights[Count++] = Table[State1].Symbol;
+        break;
+      }
+    }
+  }
+
+  *Used = Bytes + 1;
+  return ZstdBuildHuffmanTable (Decoder, Weights, Count);
+}
+
+/**
+  Decodes a Huffman coded stream of literals.
+
+  @param  Decoder      The decoder context, with a Huffman table.
+  @param  Buffer       The stream.
+  @param  Size         The size of the stream in bytes.
+  @param  Literals     The decoded literals.
+  @param  Count        The number of literals of the stream.
+
+  @retval RETURN_SUCCESS           The literals are decoded.
+  @retval RETURN_INVALID_PARAMETER The stream is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeHuffmanStream (
+  IN  ZSTD_DECODER  *Decoder,
+  IN  CONST UINT8   *Buffer,
+  IN  UINTN         Size,
+  OUT UINT8         *Literals,
+  IN  UINTN         Count
+  )
+{
+  RETURN_STATUS             Status;
+  ZSTD_BIT_READER           Reader;
+  CONST ZSTD_HUFFMAN_ENTRY  *Entry;
+  UINT8                     *End;
+  UINTN                     Log;
+  UINTN                     Index;
+  UINTN                     PerReload;
+
+  Status = ZstdBitReaderInit (&Reader, Buffer, Size);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // A reload brings enough bits for 2 codes of the longest length in a 32-bit
+  // container, and 4 in a 64-bit one.
+  //
+  Log       = Decoder->HuffmanLog;
+  PerReload = ZSTD_CONTAINER_BITS_MIN / ZSTD_HUFFMAN_LOG_MAX;
+  End       = Literals + Count;
+  while ((UINTN)(End - Literals) >= PerReload) {
+    for (Index = 0; Index < PerReload; Index++) {
+      Entry            = &Decoder->HuffmanTable[ZstdBitReaderPeek (&Reader, Log)];
+      *Literals++      = Entry->Symbol;
+      Reader.Consumed += Entry->Bits;
+    }
+
+    ZstdBitReaderReload (&Reader);
+  }
+
+  while (Literals < End) {
+    Entry            = &Decoder->HuffmanTable[ZstdBitReaderPeek (&Reader, Log)];
+    *Literals++      = Entry->Symbol;
+    Reader.Consumed += Entry->Bits;
+  }
+
+  if (!ZstdBitReaderFinished (&Reader)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decodes the literals section of a compressed block.
+
+  @param  Decoder      The decoder context.
+  @param  Buffer       The literals section.
+  @param  Size         The size in bytes of the block from the literals section.
+  @param  Literals     The literals, that may be in Buffer or in the decoder.
+  @param  Count        The number of literals.
+  @param  Used         The size in bytes of the literals section.
+
+  @retval RETURN_SUCCESS           The literals are decoded.
+  @retval RETURN_INVALID_PARAMETER The section is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeLiterals (
+  IN OUT ZSTD_DECODER  *Decoder,
+  IN     CONST UINT8   *Buffer,
+  IN     UINTN         Size,
+  OUT    CONST UINT8   **Literals,
+  OUT    UINTN         *Count,
+  OUT    UINTN         *Used
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Type;
+  UINTN          Format;
+  UINTN          HeaderSize;
+  UINTN          Regenerated;
+  UINTN          Compressed;
+  UINTN          TreeSize;
+  UINTN          Segment;
+  UINTN          StreamSize[4];
+  UINTN          Index;
+  UINT32         Header;
+
+  if (Size < 1) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Type   = Buffer[0] & 3;
+  Format = (Buffer[0] >> 2) & 3;
+  if ((Type == ZSTD_LITERALS_TYPE_RAW) || (Type == ZSTD_LITERALS_TYPE_RLE)) {
+    if ((Format & 1) == 0) {
+      HeaderSize  = 1;
+      Regenerated = Buffer[0] >> 3;
+    } else if ((Format == 1) && (Size >= 2)) {
+      HeaderSize  = 2;
+      Regenerated = ZstdRead16 (Buffer) >> 4;
+    } else if ((Format == 3) && (Size >= 3)) {
+      HeaderSize  = 3;
+      Regenerated = ZstdRead24 (Buffer) >> 4;
+    } else {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if (Regenerated > ZSTD_BLOCK_SIZE_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *Count = Regenerated;
+    if (Type == ZSTD_LITERALS_TYPE_RAW) {
+      if (Regenerated > Size - HeaderSize) {
+        return RETURN_INVALID_PARAMETER;
+      }
+
+      *Literals = Buffer + HeaderSize;
+      *Used     = HeaderSize + Regenerated;
+    } else {
+      if (HeaderSize + 1 > Size) {
+        return RETURN_INVALID_PARAMETER;
+      }
+
+      SetMem (Decoder->Literals, Regenerated, Buffer[HeaderSize]);
+      *Literals = Decoder->Literals;
+      *Used     = HeaderSize + 1;
+    }
+
+    return RETURN_SUCCESS;
+  }
+
+  //
+  // The regenerated and compressed sizes share the header, after the type
+  // and size format.
+  //
+  if ((Format <= 1) && (Size >= 3)) {
+    HeaderSize  = 3;
+    Header      = ZstdRead24 (Buffer);
+    Regenerated = (Header >> 4) & 0x3FF;
+    Compressed  = Header >> 14;
+  } else if ((Format == 2) && (Size >= 4)) {
+    HeaderSize  = 4;
+    Header      = ZstdRead32 (Buffer);
+    Regenerated = (Header >> 4) & 0x3FFF;
+    Compressed  = Header >> 18;
+  } else if ((Format == 3) && (Size >= 5)) {
+    HeaderSize  = 5;
+    Header      = ZstdRead32 (Buffer);
+    Regenerated = (Header >> 4) & 0x3FFFF;
+    Compressed  = (Header >> 22) | ((UINTN)Buffer[4] << 10);
+  } else {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((Regenerated > ZSTD_BLOCK_SIZE_MAX) || (Compressed > Size - HeaderSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Buffer += HeaderSize;
+  if (Type == ZSTD_LITERALS_TYPE_COMPRESSED) {
+    Status = ZstdReadHuffmanTree (Decoder, Buffer, Compressed, &TreeSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  } else if (Decoder->HuffmanValid) {
+    TreeSize = 0;
+  } else {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Buffer     += TreeSize;
+  Compressed -= TreeSize;
+  if (Format == 0) {
+    Status = ZstdDecodeHuffmanStream (Decoder, Buffer, Compressed, Decoder->Literals, Regenerated);
+  } else {
+    //
+    // Four streams, the sizes of the first three in a jump table, each of a
+    // quarter of the literals rounded up, but the last one.
+    //
+    if (Compressed < 6) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    StreamSize[0] = ZstdRead16 (Buffer);
+    StreamSize[1] = ZstdRead16 (Buffer + 2);
+    StreamSize[2] = ZstdRead16 (Buffer + 4);
+    if (StreamSize[0] + StreamSize[1] + StreamSize[2] > Compressed - 6) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    StreamSize[3] = Compressed - 6 - StreamSize[0] - StreamSize[1] - StreamSize[2];
+    Segment       = (Regenerated + 3) / 4;
+    if (Segment * 3 > Regenerated) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Buffer += 6;
+    Status  = RETURN_SUCCESS;
+    for (Index = 0; Index < 4 && !RETURN_ERROR (Status); Index++) {
+      Status = ZstdDecodeHuffmanStream (
+                 Decoder,
+                 Buffer,
+                 StreamSize[Index],
+                 Decoder->Literals + Index * Segment,
+                 (Index < 3) ? Segment : Regenerated - 3 * Segment
+                 );
+      Buffer += StreamSize[Index];
+    }
+  }
+
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  *Literals = Decoder->Literals;
+  *Count    = Regenerated;
+  *Used     = HeaderSize + TreeSize + Compressed;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Reads the table of one of the literal length, offset and match length codes
+  of a sequences section.
+
+  @param  Mode          The table mode of the code.
+  @param  Buffer        The table description, for the FSE compressed tables.
+  @param  Size          The size in bytes of the buffer from the table.
+  @param  Table         The decoding table of the code.
+  @param  Log           The accuracy log of the table.
+  @param  Valid         Whether the table was read, for the repeat mode.
+  @param  Default       The predefined distribution of the code.
+  @param  DefaultCount  The number of symbols of the predefined distribution.
+  @param  DefaultLog    The accuracy log of the predefined distribution.
+  @param  CodeMax       The largest code.
+  @param  LogMax        The largest accuracy log.
+  @param  Used          The size of the table description in bytes.
+
+  @retval RETURN_SUCCESS           The table is read.
+  @retval RETURN_INVALID_PARAMETER The table description is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdReadSequenceTable (
+  IN     UINTN           Mode,
+  IN     CONST UINT8     *Buffer,
+  IN     UINTN           Size,
+  OUT    ZSTD_FSE_ENTRY  *Table,
+  IN OUT UINTN           *Log,
+  IN OUT BOOLEAN         *Valid,
+  IN     CONST INT16     *Default,
+  IN     UINTN           DefaultCount,
+  IN     UINTN           DefaultLog,
+  IN     UINTN           CodeMax,
+  IN     UINTN           LogMax,
+  OUT    UINTN           *Used
+  )
+{
+  RETURN_STATUS  Status;
+  INT16          Counts[ZSTD_FSE_SYMBOLS_MAX];
+  UINTN          Symbols;
+
+  *Used = 0;
+  switch (Mode) {
+    case ZSTD_TABLE_MODE_PREDEFINED:
+      *Log   = DefaultLog;
+      Status = ZstdBuildFseTable (Table, Default, DefaultCount, DefaultLog);
+      break;
+
+    case ZSTD_TABLE_MODE_RLE:
+      if ((Size < 1) || (Buffer[0] > CodeMax)) {
+        return RETURN_INVALID_PARAMETER;
+      }
+
+      Table[0].Symbol = Buffer[0];
+      Table[0].Bits   = 0;
+      Table[0].Base   = 0;
+      *Log            = 0;
+      *Used           = 1;
+      Status          = RETURN_SUCCESS;
+      break;
+
+    case ZSTD_TABLE_MODE_COMPRESSED:
+      Status = ZstdReadFseDistribution (Buffer, Size, CodeMax, LogMax, Counts, &Symbols, Log, Used);
+      if (!RETURN_ERROR (Status)) {
+        Status = ZstdBuildFseTable (Table, Counts, Symbols, *Log);
+      }
+
+      break;
+
+    default:
+      Status = *Valid ? RETURN_SUCCESS : RETURN_INVALID_PARAMETER;
+      break;
+  }
+
+  *Valid = (BOOLEAN)!RETURN_ERROR (Status);
+  return Status;
+}
+
+/**
+  Decodes and executes the sequences of a compressed block.
+
+  @param  Decoder       The decoder context, with the tables of the codes.
+  @param  Buffer        The sequences bit stream.
+  @param  Size          The size of the bit stream in bytes.
+  @param  Count         The number of sequences.
+  @param  Literals      The literals of the block.
+  @param  LiteralCount  The number of literals of the block.
+  @param  FrameStart    The start of the content of the frame.
+  @param  Output        The output of the block.
+  @param  OutputEnd     The end of the content of the frame.
+  @param  Written       The size in bytes of the output of the block.
+
+  @retval RETURN_SUCCESS           The sequences are executed.
+  @retval RETURN_INVALID_PARAMETER The sequences are corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdExecuteSequences (
+  IN OUT ZSTD_DECODER  *Decoder,
+  IN     CONST UINT8   *Buffer,
+  IN     UINTN         Size,
+  IN     UINTN         Count,
+  IN     CONST UINT8   *Literals,
+  IN     UINTN         LiteralCount,
+  IN     CONST UINT8   *FrameStart,
+  IN     UINT8         *Output,
+  IN     UINT8         *OutputEnd,
+  OUT    UINTN         *Written
+  )
+{
+  RETURN_STATUS         Status;
+  ZSTD_BIT_READER       Reader;
+  CONST ZSTD_FSE_ENTRY  *LiteralLength;
+  CONST ZSTD_FSE_ENTRY  *MatchLength;
+  CONST ZSTD_FSE_ENTRY  *Offset;
+  CONST UINT8           *LiteralsEnd;
+  CONST UINT8           *Match;
+  UINT8                 *Start;
+  UINTN                 LiteralLengthState;
+  UINTN                 MatchLengthState;
+  UINTN                 OffsetState;
+  UINTN                 LiteralLengthValue;
+  UINTN                 MatchLengthValue;
+  UINTN                 OffsetValue;
+  UINTN                 OffsetCode;
+  UINTN                 Index;
+
+  Status = ZstdBitReaderInit (&Reader, Buffer, Size);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Start       = Output;
+  LiteralsEnd = Literals + LiteralCount;
+
+  LiteralLengthState = ZstdBitReaderRead (&Reader, Decoder->LiteralLengthLog);
+  OffsetState        = ZstdBitReaderRead (&Reader, Decoder->OffsetLog);
+  if (ZSTD_CONTAINER_IS_32_BIT) {
+    ZstdBitReaderReload (&Reader);
+  }
+
+  MatchLengthState = ZstdBitReaderRead (&Reader, Decoder->MatchLengthLog);
+  ZstdBitReaderReload (&Reader);
+
+  while (Count-- > 0) {
+    LiteralLength = &Decoder->LiteralLengthTable[LiteralLengthState];
+    MatchLength   = &Decoder->MatchLengthTable[MatchLengthState];
+    Offset        = &Decoder->OffsetTable[OffsetState];
+
+    //
+    // The extra bits of the offset, then of the match length and of the
+    // literal length. An offset may need two reads in a 32-bit container.
+    //
+    OffsetCode = Offset->Symbol;
+    if (OffsetCode > ZSTD_OFFSET_CODE_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if (OffsetCode > ZSTD_CONTAINER_BITS_MIN) {
+      OffsetValue = ZstdBitReaderRead (&Reader, OffsetCode - 8) << 8;
+      ZstdBitReaderReload (&Reader);
+      OffsetValue += ZstdBitReaderRead (&Reader, 8);
+    } else {
+      OffsetValue = ZstdBitReaderRead (&Reader, OffsetCode);
+    }
+
+    OffsetValue += (UINTN)1 << OffsetCode;
+    ZstdBitReaderReload (&Reader);
+
+    MatchLengthValue = mZstdMatchLengthBase[MatchLength->Symbol] +
+                       ZstdBitReaderRead (&Reader, mZstdMatchLengthBits[MatchLength->Symbol]);
+    if (ZSTD_CONTAINER_IS_32_BIT) {
+      ZstdBitReaderReload (&Reader);
+    }
+
+    LiteralLengthValue = mZstdLiteralLengthBase[LiteralLength->Symbol] +
+                         ZstdBitReaderRead (&Reader, mZstdLiteralLengthBits[LiteralLength->Symbol]);
+    ZstdBitReaderReload (&Reader);
+
+    //
+    // The next states, but after the last sequence.
+    //
+    if (Count > 0) {
+      LiteralLengthState = LiteralLength->Base + ZstdBitReaderRead (&Reader, LiteralLength->Bits);
+      MatchLengthState   = MatchLength->Base + ZstdBitReaderRead (&Reader, MatchLength->Bits);
+      if (ZSTD_CONTAINER_IS_32_BIT) {
+        ZstdBitReaderReload (&Reader);
+      }
+
+      OffsetState = Offset->Base + ZstdBitReaderRead (&Reader, Offset->Bits);
+      ZstdBitReaderReload (&Reader);
+    }
+
+    //
+    // The offset values 1 to 3 are repeat offsets, shifted by one when there
+    // are no literals.
+    //
+    if (OffsetValue > 3) {
+      Decoder->Repeat[2] = Decoder->Repeat[1];
+      Decoder->Repeat[1] = Decoder->Repeat[0];
+      Decoder->Repeat[0] = (UINT32)(OffsetValue - 3);
+    } else {
+      Index = OffsetValue - 1 + ((LiteralLengthValue == 0) ? 1 : 0);
+      if (Index != 0) {
+        OffsetValue = (Index == 3) ? Decoder->Repeat[0] - 1 : Decoder->Repeat[Index];
+        if (Index != 1) {
+          Decoder->Repeat[2] = Decoder->Repeat[1];
+        }
+
+        Decoder->Repeat[1] = Decoder->Repeat[0];
+        Decoder->Repeat[0] = (UINT32)OffsetValue;
+      }
+    }
+
+    OffsetValue = Decoder->Repeat[0];
+
+    //
+    // Copy the literals, then the match, that may overlap its output.
+    //
+    if ((LiteralLengthValue > (UINTN)(LiteralsEnd - Literals)) ||
+        (LiteralLengthValue > (UINTN)(OutputEnd - Output)))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    CopyMem (Output, Literals, LiteralLengthValue);
+    Output   += LiteralLengthValue;
+    Literals += LiteralLengthValue;
+
+    if ((OffsetValue == 0) ||
+        (OffsetValue > (UINTN)(Output - FrameStart)) ||
+        (MatchLengthValue > (UINTN)(OutputEnd - Output)))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Match = Output - OffsetValue;
+    if (OffsetValue >= MatchLengthValue) {
+      CopyMem (Output, Match, MatchLengthValue);
+      Output += MatchLengthValue;
+    } else {
+      while (MatchLengthValue-- > 0) {
+        *Output++ = *Match++;
+      }
+    }
+  }
+
+  if (!ZstdBitReaderFinished (&Reader)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The literals left follow the last sequence.
+  //
+  if ((UINTN)(LiteralsEnd - Literals) > (UINTN)(OutputEnd - Output)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  CopyMem (Output, Literals, (UINTN)(LiteralsEnd - Literals));
+  Output  += LiteralsEnd - Literals;
+  *Written = (UINTN)(Output - Start);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decodes a compressed block.
+
+  @param  Decoder     The decoder context.
+  @param  Buffer      The block content.
+  @param  Size        The size of the block content in bytes.
+  @param  FrameStart  The start of the content of the frame.
+  @param  Output      The output of the block.
+  @param  OutputEnd   The end of the content of the frame.
+  @param  Written     The size in bytes of the output of the block.
+
+  @retval RETURN_SUCCESS           The block is decoded.
+  @retval RETURN_INVALID_PARAMETER The block is corrupted.
+**/
+STATIC
+RETURN_STATUS
+ZstdDecodeBlock (
+  IN OUT ZSTD_DECODER  *Decoder,
+  IN     CONST UINT8   *Buffer,
+  IN     UINTN         Size,
+  IN     CONST UINT8   *FrameStart,
+  IN     UINT8         *Output,
+  IN     UINT8         *OutputEnd,
+  OUT    UINTN         *Written
+  )
+{
+  RETURN_STATUS  Status;
+  CONST UINT8    *End;
+  CONST UINT8    *Literals;
+  UINTN          LiteralCount;
+  UINTN          Used;
+  UINTN          Count;
+  UINT8          Modes;
+
+  End    = Buffer + Size;
+  Status = ZstdDecodeLiterals (Decoder, Buffer, Size, &Literals, &LiteralCount, &Used);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The number of sequences takes one to three bytes.
+  //
+  Buffer += Used;
+  if (Buffer >= End) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Buffer[0] < 128) {
+    Count   = Buffer[0];
+    Buffer += 1;
+  } else if ((Buffer[0] < 255) && (End - Buffer >= 2)) {
+    Count   = ((Buffer[0] - 128) << 8) + Buffer[1];
+    Buffer += 2;
+  } else if ((Buffer[0] == 255) && (End - Buffer >= 3)) {
+    Count   = ZstdRead16 (Buffer + 1) + 0x7F00;
+    Buffer += 3;
+  } else {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Count == 0) {
+    if (LiteralCount > (UINTN)(OutputEnd - Output)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    CopyMem (Output, Literals, LiteralCount);
+    *Written = LiteralCount;
+    return RETURN_SUCCESS;
+  }
+
+  if (Buffer >= End) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Modes = *Buffer++;
+  if ((Modes & 3) != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ZstdReadSequenceTable (
+             Modes >> 6,
+             Buffer,
+             End - Buffer,
+             Decoder->LiteralLengthTable,
+             &Decoder->LiteralLengthLog,
+             &Decoder->LiteralLengthValid,
+             mZstdLiteralLengthDefault,
+             ARRAY_SIZE (mZstdLiteralLengthDefault),
+             ZSTD_LITERAL_LENGTH_DEFAULT_LOG,
+             ZSTD_LITERAL_LENGTH_CODE_MAX,
+             ZSTD_LITERAL_LENGTH_LOG_MAX,
+             &Used
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Buffer += Used;
+  Status  = ZstdReadSequenceTable (
+              (Modes >> 4) & 3,
+              Buffer,
+              End - Buffer,
+              Decoder->OffsetTable,
+              &Decoder->OffsetLog,
+              &Decoder->OffsetValid,
+              mZstdOffsetDefault,
+              ARRAY_SIZE (mZstdOffsetDefault),
+              ZSTD_OFFSET_DEFAULT_LOG,
+              ZSTD_OFFSET_CODE_MAX,
+              ZSTD_OFFSET_LOG_MAX,
+              &Used
+              );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Buffer += Used;
+  Status  = ZstdReadSequenceTable (
+              (Modes >> 2) & 3,
+              Buffer,
+              End - Buffer,
+              Decoder->MatchLengthTable,
+              &Decoder->MatchLengthLog,
+              &Decoder->MatchLengthValid,
+              mZstdMatchLengthDefault,
+              ARRAY_SIZE (mZstdMatchLengthDefault),
+              ZSTD_MATCH_LENGTH_DEFAULT_LOG,
+              ZSTD_MATCH_LENGTH_CODE_MAX,
+              ZSTD_MATCH_LENGTH_LOG_MAX,
+              &Used
+              );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Buffer += Used;
+  return ZstdExecuteSequences (
+           Decoder,
+           Buffer,
+           End - Buffer,
+           Count,
+           Literals,
+           LiteralCount,
+           FrameStart,
+           Output,
+           OutputEnd,
+           Written
+           );
+}
+
+/**
+  Mixes a lane of the XXH64 hash with 8 bytes of input.
+
+  @param  Accumulator  The lane.
+  @param  Input        The input.
+
+  @return The new lane.
+**/
+STATIC
+UINT64
+ZstdXxh64Round (
+  IN UINT64  Accumulator,
+  IN UINT64  Input
+  )
+{
+  Accumulator += MultU64x64 (Input, ZSTD_XXH64_PRIME_2);
+  Accumulator  = LRotU64 (Accumulator, 31);
+  return MultU64x64 (Accumulator, ZSTD_XXH64_PRIME_1);
+}
+
+/**
+  Merges a lane of the XXH64 hash into the hash.
+
+  @param  Hash         The hash.
+  @param  Accumulator  The lane.
+
+  @return The new hash.
+**/
+STATIC
+UINT64
+ZstdXxh64Merge (
+  IN UINT64  Hash,
+  IN UINT64  Accumulator
+  )
+{
+  Hash ^= ZstdXxh64Round (0, Accumulator);
+  return MultU64x64 (Hash, ZSTD_XXH64_PRIME_1) + ZSTD_XXH64_PRIME_4;
+}
+
+/**
+  Computes the XXH64 hash of a buffer, with a zero seed, whose low 32 bits are
+  the checksum of a frame.
+
+  @param  Buffer  The buffer.
+  @param  Size    The size of the buffer in bytes.
+
+  @return The hash.
+**/
+STATIC
+UINT64
+ZstdXxh64 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size
+  )
+{
+  CONST UINT8  *End;
+  UINT64       Lane[4];
+  UINT64       Hash;
+
+  End = Buffer + Size;
+  if (Size >= 32) {
+    Lane[0] = ZSTD_XXH64_PRIME_1 + ZSTD_XXH64_PRIME_2;
+    Lane[1] = ZSTD_XXH64_PRIME_2;
+    Lane[2] = 0;
+    Lane[3] = 0 - ZSTD_XXH64_PRIME_1;
+    do {
+      Lane[0]  = ZstdXxh64Round (Lane[0], ZstdRead64 (Buffer));
+      Lane[1]  = ZstdXxh64Round (Lane[1], ZstdRead64 (Buffer + 8));
+      Lane[2]  = ZstdXxh64Round (Lane[2], ZstdRead64 (Buffer + 16));
+      Lane[3]  = ZstdXxh64Round (Lane[3], ZstdRead64 (Buffer + 24));
+      Buffer  += 32;
+    } while (End - Buffer >= 32);
+
+    Hash = LRotU64 (Lane[0], 1) + LRotU64 (Lane[1], 7) + LRotU64 (Lane[2], 12) + LRotU64 (Lane[3], 18);
+    Hash = ZstdXxh64Merge (Hash, Lane[0]);
+    Hash = ZstdXxh64Merge (Hash, Lane[1]);
+    Hash = ZstdXxh64Merge (Hash, Lane[2]);
+    Hash = ZstdXxh64Merge (Hash, Lane[3]);
+  } else {
+    Hash = ZSTD_XXH64_PRIME_5;
+  }
+
+  Hash += Size;
+  while (End - Buffer >= 8) {
+    Hash   ^= ZstdXxh64Round (0, ZstdRead64 (Buffer));
+    Hash    = MultU64x64 (LRotU64 (Hash, 27), ZSTD_XXH64_PRIME_1) + ZSTD_XXH64_PRIME_4;
+    Buffer += 8;
+  }
+
+  if (End - Buffer >= 4) {
+    Hash   ^= MultU64x64 (ZstdRead32 (Buffer), ZSTD_XXH64_PRIME_1);
+    Hash    = MultU64x64 (LRotU64 (Hash, 23), ZSTD_XXH64_PRIME_2) + ZSTD_XXH64_PRIME_3;
+    Buffer += 4;
+  }
+
+  while (Buffer < End) {
+    Hash ^= MultU64x64 (*Buffer++, ZSTD_XXH64_PRIME_5);
+    Hash  = MultU64x64 (LRotU64 (Hash, 11), ZSTD_XXH64_PRIME_1);
+  }
+
+  Hash ^= RShiftU64 (Hash, 33);
+  Hash  = MultU64x64 (Hash, ZSTD_XXH64_PRIME_2);
+  Hash ^= RShiftU64 (Hash, 29);
+  Hash  = MultU64x64 (Hash, ZSTD_XXH64_PRIME_3);
+  Hash ^= RShiftU64 (Hash, 32);
+  return Hash;
+}
+
+/**
+  Parses the header of the first frame of a buffer, skipping the skippable
+  frames before it.
+
+  @param  Source       The buffer.
+  @param  SourceSize   The size of the buffer in bytes.
+  @param  HeaderSize   The offset in bytes of the first block of the frame.
+  @param  ContentSize  The size of the content of the frame.
+  @param  Checksum     Whether the frame ends with a checksum.
+
+  @retval RETURN_SUCCESS           The header is parsed.
+  @retval RETURN_INVALID_PARAMETER The buffer does not start with a frame.
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size,
+                                   or needs a dictionary.
+**/
+STATIC
+RETURN_STATUS
+ZstdParseFrameHeader (
+  IN  CONST UINT8  *Source,
+  IN  UINTN        SourceSize,
+  OUT UINTN        *HeaderSize,
+  OUT UINT64       *ContentSize,
+  OUT BOOLEAN      *Checksum
+  )
+{
+  UINTN   Offset;
+  UINTN   Skip;
+  UINTN   ContentSizeBytes;
+  UINT8   Descriptor;
+  UINT32  Dictionary;
+
+  Offset = 0;
+  while ((SourceSize - Offset >= 8) &&
+         ((ZstdRead32 (Source + Offset) & ZSTD_SKIPPABLE_MAGIC_MASK) == ZSTD_SKIPPABLE_MAGIC_NUMBER))
+  {
+    Skip = ZstdRead32 (Source + Offset + 4);
+    if (Skip > SourceSize - Offset - 8) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Offset += 8 + Skip;
+  }
+
+  if ((SourceSize - Offset < ZSTD_FRAME_HEADER_SIZE_MIN) ||
+      (ZstdRead32 (Source + Offset) != ZSTD_MAGIC_NUMBER))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Descriptor = Source[Offset + 4];
+  Offset    += ZSTD_FRAME_HEADER_SIZE_MIN;
+  if ((Descriptor & BIT3) != 0) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The window descriptor is of no use, the window is the whole content.
+  //
+  if ((Descriptor & BIT5) == 0) {
+    if (SourceSize - Offset < 1) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    Offset++;
+  }
+
+  Skip             = (Descriptor & 3) == 3 ? 4 : Descriptor & 3;
+  ContentSizeBytes = (Descriptor >> 6) == 0 ? ((Descriptor & BIT5) != 0 ? 1 : 0) : (UINTN)1 << (Descriptor >> 6);
+  if (SourceSize - Offset < Skip + ContentSizeBytes) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Dictionary = 0;
+  if (Skip != 0) {
+    Dictionary = ZstdRead32 (Source + Offset) & (MAX_UINT32 >> (32 - 8 * Skip));
+  }
+
+  if (Dictionary != 0) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Offset += Skip;
+  switch (Descriptor >> 6) {
+    case 0:
+      if ((Descriptor & BIT5) == 0) {
+        return RETURN_UNSUPPORTED;
+      }
+
+      *ContentSize = Source[Offset];
+      Offset      += 1;
+      break;
+    case 1:
+      *ContentSize = ZstdRead16 (Source + Offset) + 256;
+      Offset      += 2;
+      break;
+    case 2:
+      *ContentSize = ZstdRead32 (Source + Offset);
+      Offset      += 4;
+      break;
+    default:
+      *ContentSize = ZstdRead64 (Source + Offset);
+      Offset      += 8;
+      break;
+  }
+
+  *HeaderSize = Offset;
+  *Checksum   = (BOOLEAN)((Descriptor & BIT2) != 0);
+  return RETURN_SUCCESS;
+}
+
+//
+// Zstandard functions and data as defined in local ZstdDecompressLibInternal.h
+//
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The size of the uncompressed buffer is the Frame_Content_Size field of the
+  frame header, so the frame must record it.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval RETURN_SUCCESS           The size of the uncompressed data was returned
+                                   in DestinationSize and the size of the scratch
+                                   buffer was returned in ScratchSize.
+  @retval RETURN_INVALID_PARAMETER The source buffer does not start with a
+                                   Zstandard frame header.
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, the
+                                   size does not fit in a UINT32, or the frame
+                                   needs a dictionary.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          HeaderSize;
+  UINT64         ContentSize;
+  BOOLEAN        Checksum;
+
+  Status = ZstdParseFrameHeader (Source, SourceSize, &HeaderSize, &ContentSize, &Checksum);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  if (ContentSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  *DestinationSize = (UINT32)ContentSize;
+  *ScratchSize     = sizeof (ZSTD_DECODER);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data, of
+                      the size returned by ZstdUefiDecompressGetInfo().
+  @param  Scratch     A temporary scratch buffer that is used to perform the
+                      decompression, of the size returned by
+                      ZstdUefiDecompressGetInfo().
+
+  @retval RETURN_SUCCESS           Decompression completed successfully, and
+                                   the uncompressed buffer is returned in Destination.
+  @retval RETURN_INVALID_PARAMETER The source buffer specified by Source is corrupted
+                                   (not in a valid compressed format).
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, or
+                                   needs a dictionary.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS  Status;
+  ZSTD_DECODER   *Decoder;
+  CONST UINT8    *Input;
+  CONST UINT8    *InputEnd;
+  UINT8          *Output;
+  UINT8          *OutputEnd;
+  UINTN          HeaderSize;
+  UINT64         ContentSize;
+  BOOLEAN        Checksum;
+  UINT32         BlockHeader;
+  UINTN          BlockSize;
+  UINTN          Written;
+
+  Status = ZstdParseFrameHeader (Source, SourceSize, &HeaderSize, &ContentSize, &Checksum);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  if (ContentSize > MAX_UINTN) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Decoder                     = Scratch;
+  Decoder->HuffmanValid       = FALSE;
+  Decoder->LiteralLengthValid = FALSE;
+  Decoder->OffsetValid        = FALSE;
+  Decoder->MatchLengthValid   = FALSE;
+  Decoder->Repeat[0]          = 1;
+  Decoder->Repeat[1]          = 4;
+  Decoder->Repeat[2]          = 8;
+
+  Input     = (CONST UINT8 *)Source + HeaderSize;
+  InputEnd  = (CONST UINT8 *)Source + SourceSize;
+  Output    = Destination;
+  OutputEnd = Output + (UINTN)ContentSize;
+  do {
+    if (InputEnd - Input < ZSTD_BLOCK_HEADER_SIZE) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    BlockHeader = ZstdRead24 (Input);
+    BlockSize   = BlockHeader >> 3;
+    Input      += ZSTD_BLOCK_HEADER_SIZE;
+    if (BlockSize > ZSTD_BLOCK_SIZE_MAX) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    switch ((BlockHeader >> 1) & 3) {
+      case ZSTD_BLOCK_TYPE_RAW:
+        if ((BlockSize > (UINTN)(InputEnd - Input)) || (BlockSize > (UINTN)(OutputEnd - Output))) {
+          return RETURN_INVALID_PARAMETER;
+        }
+
+        CopyMem (Output, Input, BlockSize);
+        Input  += BlockSize;
+        Output += BlockSize;
+        break;
+
+      case ZSTD_BLOCK_TYPE_RLE:
+        if ((Input >= InputEnd) || (BlockSize > (UINTN)(OutputEnd - Output))) {
+          return RETURN_INVALID_PARAMETER;
+        }
+
+        SetMem (Output, BlockSize, *Input);
+        Input  += 1;
+        Output += BlockSize;
+        break;
+
+      case ZSTD_BLOCK_TYPE_COMPRESSED:
+        if (BlockSize > (UINTN)(InputEnd - Input)) {
+          return RETURN_INVALID_PARAMETER;
+        }
+
+        Status = ZstdDecodeBlock (Decoder, Input, BlockSize, Destination, Output, OutputEnd, &Written);
+        if (RETURN_ERROR (Status)) {
+          return Status;
+        }
+
+        Input  += BlockSize;
+        Output += Written;
+        break;
+
+      default:
+        return RETURN_INVALID_PARAMETER;
+    }
+  } while ((BlockHeader & BIT0) == 0);
+
+  if (Output != OutputEnd) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Checksum) {
+    if ((InputEnd - Input < ZSTD_CHECKSUM_SIZE) ||
+        ((UINT32)ZstdXxh64 (Destination, (UINTN)ContentSize) != ZstdRead32 (Input)))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
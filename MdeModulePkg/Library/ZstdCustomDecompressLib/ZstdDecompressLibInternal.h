@@ -0,0 +1,92 @@
+/** @file
+  Zstandard Decompress Library internal header file declares Zstandard
+  decompress interfaces.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_LIB_INTERNAL_H__
+#define __ZSTD_DECOMPRESS_LIB_INTERNAL_H__
+
+#include <PiPei.h>
+
+#include <Guid/ZstdDecompress.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+
+/**
+  Given a Zstandard compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The size of the uncompressed buffer is the Frame_Content_Size field of the
+  frame header, so the frame must record it.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval RETURN_SUCCESS           The size of the uncompressed data was returned
+                                   in DestinationSize and the size of the scratch
+                                   buffer was returned in ScratchSize.
+  @retval RETURN_INVALID_PARAMETER The source buffer does not start with a
+                                   Zstandard frame header.
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, the
+                                   size does not fit in a UINT32, or the frame
+                                   needs a dictionary.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a Zstandard compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data, of
+                      the size returned by ZstdUefiDecompressGetInfo().
+  @param  Scratch     A temporary scratch buffer that is used to perform the
+                      decompression, of the size returned by
+                      ZstdUefiDecompressGetInfo().
+
+  @retval RETURN_SUCCESS           Decompression completed successfully, and
+                                   the uncompressed buffer is returned in Destination.
+  @retval RETURN_INVALID_PARAMETER The source buffer specified by Source is corrupted
+                                   (not in a valid compressed format).
+  @retval RETURN_UNSUPPORTED       The frame does not record its content size, or
+                                   needs a dictionary.
+
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+#endif
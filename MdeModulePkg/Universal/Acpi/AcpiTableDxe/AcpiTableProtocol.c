@@ -97,6 +97,58 @@ ChecksumCommonTables (
   IN OUT EFI_ACPI_TABLE_INSTANCE  *AcpiTableInstance
   );
 
+/**
+  This function sets an entry of the RSDT or XSDT, or appends it, and updates
+  the checksum of the table.
+
+  Only the entry and the Length field of the table change, so the checksum is
+  adjusted by the difference of their bytes rather than computed over the whole
+  table again. The checksum of the table must be valid on entry.
+
+  @param  Sdt        Pointer to the RSDT or XSDT.
+  @param  Index      Index of the entry. If it is the number of entries in the
+                     table, the entry is appended to the table.
+  @param  Entry      Pointer to the value of the entry. It may be unaligned.
+  @param  EntrySize  Size of an entry of the table, sizeof (UINT32) for the RSDT
+                     or sizeof (UINT64) for the XSDT.
+
+**/
+STATIC
+VOID
+SetSdtEntry (
+  IN OUT EFI_ACPI_DESCRIPTION_HEADER  *Sdt,
+  IN     UINTN                        Index,
+  IN     CONST VOID                   *Entry,
+  IN     UINTN                        EntrySize
+  )
+{
+  UINT8   *SdtEntry;
+  UINT8   Checksum;
+  UINT32  EntryOffset;
+
+  EntryOffset = (UINT32)(sizeof (EFI_ACPI_DESCRIPTION_HEADER) + Index * EntrySize);
+  SdtEntry    = (UINT8 *)Sdt + EntryOffset;
+  Checksum    = Sdt->Checksum;
+
+  if (EntryOffset < Sdt->Length) {
+    //
+    // The old value of the entry is no longer part of the table.
+    //
+    Checksum = (UINT8)(Checksum + CalculateSum8 (SdtEntry, EntrySize));
+  } else {
+    //
+    // The entry is appended, so the table grows.
+    //
+    ASSERT (EntryOffset == Sdt->Length);
+    Checksum    = (UINT8)(Checksum + CalculateSum8 ((UINT8 *)&Sdt->Length, sizeof (Sdt->Length)));
+    Sdt->Length = (UINT32)(EntryOffset + EntrySize);
+    Checksum    = (UINT8)(Checksum - CalculateSum8 ((UINT8 *)&Sdt->Length, sizeof (Sdt->Length)));
+  }
+
+  CopyMem (SdtEntry, Entry, EntrySize);
+  Sdt->Checksum = (UINT8)(Checksum - CalculateSum8 (SdtEntry, EntrySize));
+}
+
 //
 // Protocol function implementations.
 //
@@ -121,8 +173,7 @@ PublishTables (
   )
 {
   EFI_STATUS  Status;
-  UINT32      *CurrentRsdtEntry;
-  VOID        *CurrentXsdtEntry;
+  UINT32      Buffer32;
   UINT64      Buffer64;
 
   //
@@ -131,35 +182,27 @@ PublishTables (
   //
 
   //
-  // Add FADT as the first entry
+  // Add FADT as the first entry. The checksums of the RSDT and XSDT are
+  // updated with the entry, so publishing does not depend on the number of
+  // tables.
   //
   if ((Version & EFI_ACPI_TABLE_VERSION_1_0B) != 0) {
-    CurrentRsdtEntry  = (UINT32 *)((UINT8 *)AcpiTableInstance->Rsdt1 + sizeof (EFI_ACPI_DESCRIPTION_HEADER));
-    *CurrentRsdtEntry = (UINT32)(UINTN)AcpiTableInstance->Fadt1;
+    Buffer32 = (UINT32)(UINTN)AcpiTableInstance->Fadt1;
+    SetSdtEntry (AcpiTableInstance->Rsdt1, 0, &Buffer32, sizeof (UINT32));
 
-    CurrentRsdtEntry  = (UINT32 *)((UINT8 *)AcpiTableInstance->Rsdt3 + sizeof (EFI_ACPI_DESCRIPTION_HEADER));
-    *CurrentRsdtEntry = (UINT32)(UINTN)AcpiTableInstance->Fadt3;
+    Buffer32 = (UINT32)(UINTN)AcpiTableInstance->Fadt3;
+    SetSdtEntry (AcpiTableInstance->Rsdt3, 0, &Buffer32, sizeof (UINT32));
   }
 
   if ((Version & ACPI_TABLE_VERSION_GTE_2_0) != 0) {
-    CurrentXsdtEntry = (VOID *)((UINT8 *)AcpiTableInstance->Xsdt + sizeof (EFI_ACPI_DESCRIPTION_HEADER));
     //
     // Add entry to XSDT, XSDT expects 64 bit pointers, but
     // the table pointers in XSDT are not aligned on 8 byte boundary.
     //
     Buffer64 = (UINT64)(UINTN)AcpiTableInstance->Fadt3;
-    CopyMem (
-      CurrentXsdtEntry,
-      &Buffer64,
-      sizeof (UINT64)
-      );
+    SetSdtEntry (AcpiTableInstance->Xsdt, 0, &Buffer64, sizeof (UINT64));
   }
 
-  //
-  // Do checksum again because Dsdt/Xsdt is updated.
-  //
-  ChecksumCommonTables (AcpiTableInstance);
-
   //
   // Add the RSD_PTR to the system table and store that we have installed the
   // tables.
@@ -343,9 +386,10 @@ ReallocateAcpiTableBuffer (
 
   CopyMem (&TempPrivateData, AcpiTableInstance, sizeof (EFI_ACPI_TABLE_INSTANCE));
   //
-  // Enlarge the max table number from mEfiAcpiMaxNumTables to mEfiAcpiMaxNumTables + EFI_ACPI_MAX_NUM_TABLES
+  // Double the max table number, so that installing tables one by one only
+  // copies the RSDT and XSDT a logarithmic number of times.
   //
-  NewMaxTableNumber = mEfiAcpiMaxNumTables + EFI_ACPI_MAX_NUM_TABLES;
+  NewMaxTableNumber = mEfiAcpiMaxNumTables * 2;
   //
   // Create RSDT, XSDT structures and allocate buffers.
   //
@@ -450,6 +494,11 @@ ReallocateAcpiTableBuffer (
   // Update the Max ACPI table number
   //
   mEfiAcpiMaxNumTables = NewMaxTableNumber;
+
+  //
+  // Checksum the RSDP again because the RSDT and XSDT addresses are updated.
+  //
+  ChecksumCommonTables (AcpiTableInstance);
   return EFI_SUCCESS;
 }
 
@@ -507,9 +556,8 @@ AddTableToList (
   EFI_ACPI_TABLE_LIST   *CurrentTableList;
   UINT32                CurrentTableSignature;
   UINT32                CurrentTableSize;
-  UINT32                *CurrentRsdtEntry;
-  VOID                  *CurrentXsdtEntry;
   EFI_PHYSICAL_ADDRESS  AllocPhysAddress;
+  UINT32                Buffer32;
   UINT64                Buffer64;
   BOOLEAN               AddToRsdt;
 
@@ -1042,23 +1090,17 @@ AddTableToList (
         ASSERT_EFI_ERROR (Status);
       }
 
-      CurrentRsdtEntry = (UINT32 *)
-                         (
-                          (UINT8 *)AcpiTableInstance->Rsdt1 +
-                          sizeof (EFI_ACPI_DESCRIPTION_HEADER) +
-                          AcpiTableInstance->NumberOfTableEntries1 *
-                          sizeof (UINT32)
-                         );
-
       //
-      // Add entry to the RSDT unless its the FACS or DSDT
+      // Add entry to the RSDT unless its the FACS or DSDT, and update the
+      // RSDT length and checksum.
       //
-      *CurrentRsdtEntry = (UINT32)(UINTN)CurrentTableList->Table;
-
-      //
-      // Update RSDT length
-      //
-      AcpiTableInstance->Rsdt1->Length = AcpiTableInstance->Rsdt1->Length + sizeof (UINT32);
+      Buffer32 = (UINT32)(UINTN)CurrentTableList->Table;
+      SetSdtEntry (
+        AcpiTableInstance->Rsdt1,
+        AcpiTableInstance->NumberOfTableEntries1,
+        &Buffer32,
+        sizeof (UINT32)
+        );
 
       AcpiTableInstance->NumberOfTableEntries1++;
     }
@@ -1082,58 +1124,44 @@ AddTableToList (
         // At this time, it is assumed that RSDT and XSDT maintain parallel lists of tables.
         // If it becomes necessary to maintain separate table lists, changes will be required.
         //
-        CurrentRsdtEntry = (UINT32 *)
-                           (
-                            (UINT8 *)AcpiTableInstance->Rsdt3 +
-                            sizeof (EFI_ACPI_DESCRIPTION_HEADER) +
-                            AcpiTableInstance->NumberOfTableEntries3 *
-                            sizeof (UINT32)
-                           );
-
         //
-        // Add entry to the RSDT
-        //
-        *CurrentRsdtEntry = (UINT32)(UINTN)CurrentTableList->Table;
-
+        // Add entry to the RSDT, and update the RSDT length and checksum.
         //
-        // Update RSDT length
-        //
-        AcpiTableInstance->Rsdt3->Length = AcpiTableInstance->Rsdt3->Length + sizeof (UINT32);
+        Buffer32 = (UINT32)(UINTN)CurrentTableList->Table;
+        SetSdtEntry (
+          AcpiTableInstance->Rsdt3,
+          AcpiTableInstance->NumberOfTableEntries3,
+          &Buffer32,
+          sizeof (UINT32)
+          );
       }
 
-      //
-      // This pointer must not be directly dereferenced as the XSDT entries may not
-      // be 64 bit aligned resulting in a possible fault.  Use CopyMem to update.
-      //
-      CurrentXsdtEntry = (VOID *)
-                         (
-                          (UINT8 *)AcpiTableInstance->Xsdt +
-                          sizeof (EFI_ACPI_DESCRIPTION_HEADER) +
-                          AcpiTableInstance->NumberOfTableEntries3 *
-                          sizeof (UINT64)
-                         );
-
       //
       // Add entry to XSDT, XSDT expects 64 bit pointers, but
       // the table pointers in XSDT are not aligned on 8 byte boundary.
+      // SetSdtEntry () uses CopyMem to update it.
       //
       Buffer64 = (UINT64)(UINTN)CurrentTableList->Table;
-      CopyMem (
-        CurrentXsdtEntry,
+      SetSdtEntry (
+        AcpiTableInstance->Xsdt,
+        AcpiTableInstance->NumberOfTableEntries3,
         &Buffer64,
         sizeof (UINT64)
         );
 
-      //
-      // Update length
-      //
-      AcpiTableInstance->Xsdt->Length = AcpiTableInstance->Xsdt->Length + sizeof (UINT64);
-
       AcpiTableInstance->NumberOfTableEntries3++;
     }
   }
 
-  ChecksumCommonTables (AcpiTableInstance);
+  //
+  // The FADT, FACS and DSDT update the RSDP, RSDT and XSDT headers. The
+  // other tables only add an entry, and SetSdtEntry () has already updated
+  // the checksums.
+  //
+  if (!AddToRsdt) {
+    ChecksumCommonTables (AcpiTableInstance);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -92,6 +92,13 @@ EFI_NARROW_GLYPH  mCursorGlyph = {
 
 CHAR16  SpaceStr[] = { NARROW_CHAR, ' ', 0 };
 
+//
+// The glyphs of gUsStdNarrowGlyphData sorted by Unicode weight, to draw the
+// characters of the standard font without the HII Font protocol.
+//
+STATIC EFI_NARROW_GLYPH  **mSortedNarrowGlyphs;
+STATIC UINTN             mSortedNarrowGlyphCount;
+
 EFI_DRIVER_BINDING_PROTOCOL  gGraphicsConsoleDriverBinding = {
   GraphicsConsoleControllerDriverSupported,
   GraphicsConsoleControllerDriverStart,
@@ -1756,9 +1763,204 @@ GetTextColors (
   return EFI_SUCCESS;
 }
 
+/**
+  Sort the glyphs of the standard narrow font by Unicode weight.
+
+  If the sorted table cannot be allocated, all the characters are drawn
+  through the HII Font protocol.
+
+**/
+STATIC
+VOID
+SortNarrowGlyphs (
+  VOID
+  )
+{
+  UINTN             Count;
+  UINTN             Index;
+  UINTN             Position;
+  EFI_NARROW_GLYPH  *Glyph;
+
+  //
+  // The last entry of gUsStdNarrowGlyphData terminates the table.
+  //
+  Count               = mNarrowFontSize / sizeof (EFI_NARROW_GLYPH) - 1;
+  mSortedNarrowGlyphs = AllocatePool (Count * sizeof (EFI_NARROW_GLYPH *));
+  if (mSortedNarrowGlyphs == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Glyph = &gUsStdNarrowGlyphData[Index];
+    for (Position = Index; Position > 0; Position--) {
+      if (mSortedNarrowGlyphs[Position - 1]->UnicodeWeight <= Glyph->UnicodeWeight) {
+        break;
+      }
+
+      mSortedNarrowGlyphs[Position] = mSortedNarrowGlyphs[Position - 1];
+    }
+
+    mSortedNarrowGlyphs[Position] = Glyph;
+  }
+
+  mSortedNarrowGlyphCount = Count;
+}
+
+/**
+  Find the glyph of a character in the standard narrow font.
+
+  @param  UnicodeWeight         The character.
+
+  @return The glyph, or NULL if the character is not in the standard font or
+          if the glyph is not a plain narrow glyph.
+
+**/
+STATIC
+EFI_NARROW_GLYPH *
+FindNarrowGlyph (
+  IN  CHAR16  UnicodeWeight
+  )
+{
+  UINTN             Low;
+  UINTN             High;
+  UINTN             Middle;
+  EFI_NARROW_GLYPH  *Glyph;
+
+  Low  = 0;
+  High = mSortedNarrowGlyphCount;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Glyph  = mSortedNarrowGlyphs[Middle];
+    if (Glyph->UnicodeWeight == UnicodeWeight) {
+      return (Glyph->Attributes == 0) ? Glyph : NULL;
+    }
+
+    if (Glyph->UnicodeWeight < UnicodeWeight) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Draw narrow characters of the standard font on the Graphics Console device's
+  screen.
+
+  The glyphs are expanded in the line buffer of the mode, and the characters
+  are drawn with a single Blt, instead of being rendered by the HII Font
+  protocol.
+
+  @param  This                  Protocol instance pointer.
+  @param  UnicodeWeight         One Unicode string to be displayed.
+  @param  Count                 The count of Unicode string.
+
+  @retval EFI_SUCCESS           The characters are drawn.
+  @retval EFI_UNSUPPORTED       A character is not in the standard font or the
+                                wide attribute is set, the characters must be
+                                drawn through the HII Font protocol.
+
+**/
+STATIC
+EFI_STATUS
+DrawNarrowGlyphsAtCursorN (
+  IN  EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL  *This,
+  IN  CHAR16                           *UnicodeWeight,
+  IN  UINTN                            Count
+  )
+{
+  GRAPHICS_CONSOLE_DEV           *Private;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Foreground;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Background;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Pixel;
+  EFI_NARROW_GLYPH               *Glyph;
+  UINTN                          Width;
+  UINTN                          Index;
+  UINTN                          PosX;
+  UINTN                          PosY;
+  UINTN                          GlyphX;
+  UINTN                          GlyphY;
+
+  Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
+
+  if ((Private->LineBuffer == NULL) || ((This->Mode->Attribute & EFI_WIDE_ATTRIBUTE) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    if (FindNarrowGlyph (UnicodeWeight[Index]) == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  GetTextColors (This, &Foreground, &Background);
+
+  //
+  // Convert Monochrome bitmaps of the Glyphs to the line buffer, whose width
+  // is the one of the characters
+  //
+  Width = Count * EFI_GLYPH_WIDTH;
+  for (Index = 0; Index < Count; Index++) {
+    Glyph = FindNarrowGlyph (UnicodeWeight[Index]);
+    for (PosY = 0; PosY < EFI_GLYPH_HEIGHT; PosY++) {
+      Pixel = &Private->LineBuffer[PosY * Width + Index * EFI_GLYPH_WIDTH];
+      for (PosX = 0; PosX < EFI_GLYPH_WIDTH; PosX++) {
+        if ((Glyph->GlyphCol1[PosY] & (BIT7 >> PosX)) != 0) {
+          Pixel[PosX] = Foreground;
+        } else {
+          Pixel[PosX] = Background;
+        }
+      }
+    }
+  }
+
+  GlyphX = This->Mode->CursorColumn * EFI_GLYPH_WIDTH + Private->ModeData[This->Mode->Mode].DeltaX;
+  GlyphY = This->Mode->CursorRow * EFI_GLYPH_HEIGHT + Private->ModeData[This->Mode->Mode].DeltaY;
+  if (Private->GraphicsOutput != NULL) {
+    return Private->GraphicsOutput->Blt (
+                                      Private->GraphicsOutput,
+                                      Private->LineBuffer,
+                                      EfiBltBufferToVideo,
+                                      0,
+                                      0,
+                                      GlyphX,
+                                      GlyphY,
+                                      Width,
+                                      EFI_GLYPH_HEIGHT,
+                                      Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                                      );
+  }
+
+  if (FeaturePcdGet (PcdUgaConsumeSupport)) {
+    return Private->UgaDraw->Blt (
+                               Private->UgaDraw,
+                               (EFI_UGA_PIXEL *)Private->LineBuffer,
+                               EfiUgaBltBufferToVideo,
+                               0,
+                               0,
+                               GlyphX,
+                               GlyphY,
+                               Width,
+                               EFI_GLYPH_HEIGHT,
+                               Width * sizeof (EFI_UGA_PIXEL)
+                               );
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Draw Unicode string on the Graphics Console device's screen.
 
+  The characters of the standard narrow font are drawn directly, the others
+  through the HII Font protocol.
+
   @param  This                  Protocol instance pointer.
   @param  UnicodeWeight         One Unicode string to be displayed.
   @param  Count                 The count of Unicode string.
@@ -1785,6 +1987,11 @@ DrawUnicodeWeightAtCursorN (
   EFI_HII_ROW_INFO       *RowInfoArray;
   UINTN                  RowInfoArraySize;
 
+  Status = DrawNarrowGlyphsAtCursorN (This, UnicodeWeight, Count);
+  if (Status != EFI_UNSUPPORTED) {
+    return Status;
+  }
+
   Private = GRAPHICS_CONSOLE_CON_OUT_DEV_FROM_THIS (This);
   Blt     = (EFI_IMAGE_OUTPUT *)AllocateZeroPool (sizeof (EFI_IMAGE_OUTPUT));
   if (Blt == NULL) {
@@ -2127,6 +2334,8 @@ InitializeGraphicsConsole (
 {
   EFI_STATUS  Status;
 
+  SortNarrowGlyphs ();
+
   //
   // Register notify function on HII Database Protocol to add font package.
   //
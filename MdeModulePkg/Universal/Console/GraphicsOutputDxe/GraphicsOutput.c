@@ -198,6 +198,63 @@ CONST GRAPHICS_OUTPUT_PRIVATE_DATA  mGraphicsOutputInstanceTemplate = {
   0                                                // FrameBufferBltLibConfigureSize
 };
 
+/**
+  Map the frame buffer write-combining, so that the stores of a BLT to it are
+  merged into burst writes instead of being issued one by one.
+
+  The frame buffer keeps its attributes when it cannot be mapped so.
+
+  @param  FrameBufferBase      Base address of the frame buffer.
+  @param  FrameBufferSize      Size of the frame buffer.
+
+**/
+STATIC
+VOID
+GraphicsOutputMapFrameBufferWriteCombine (
+  IN EFI_PHYSICAL_ADDRESS  FrameBufferBase,
+  IN UINTN                 FrameBufferSize
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR  Descriptor;
+
+  Status = gDS->GetMemorySpaceDescriptor (FrameBufferBase, &Descriptor);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  if ((Descriptor.Attributes & EFI_CACHE_ATTRIBUTE_MASK) == EFI_MEMORY_WC) {
+    return;
+  }
+
+  if (Descriptor.BaseAddress + Descriptor.Length < FrameBufferBase + FrameBufferSize) {
+    Status = EFI_UNSUPPORTED;
+    goto Done;
+  }
+
+  if ((Descriptor.Capabilities & EFI_MEMORY_WC) == 0) {
+    Status = gDS->SetMemorySpaceCapabilities (
+                    Descriptor.BaseAddress,
+                    Descriptor.Length,
+                    Descriptor.Capabilities | EFI_MEMORY_WC
+                    );
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+  }
+
+  Status = gDS->SetMemorySpaceAttributes (
+                  FrameBufferBase,
+                  FrameBufferSize,
+                  (Descriptor.Attributes & ~EFI_CACHE_ATTRIBUTE_MASK) | EFI_MEMORY_WC
+                  );
+
+Done:
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "[%a]: The frame buffer is not mapped write-combining - %r\n", gEfiCallerBaseName, Status));
+  }
+}
+
 /**
   Test whether the Controller can be managed by the driver.
 
@@ -514,6 +571,13 @@ GraphicsOutputDriverBindingStart (
     goto RestorePciAttributes;
   }
 
+  if (FeaturePcdGet (PcdGraphicsOutputWriteCombine)) {
+    GraphicsOutputMapFrameBufferWriteCombine (
+      Private->GraphicsOutputMode.FrameBufferBase,
+      Private->GraphicsOutputMode.FrameBufferSize
+      );
+  }
+
   Private->DevicePath = AppendDevicePathNode (PciDevicePath, (EFI_DEVICE_PATH_PROTOCOL *)&mGraphicsOutputAdrNode);
   if (Private->DevicePath == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
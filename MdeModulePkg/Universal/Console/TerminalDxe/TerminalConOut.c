@@ -147,6 +147,80 @@ TerminalConOutReset (
   return Status;
 }
 
+/**
+  Write the bytes gathered by OutputString() to the serial device.
+
+  @param  TerminalDevice          The terminal device.
+  @param  OutputBuffer            The gathered bytes.
+  @param  OutputLength            On input, the number of gathered bytes. On
+                                  output, zero.
+
+  @retval EFI_SUCCESS             The bytes are written.
+  @retval Others                  The serial device failed to write them.
+
+**/
+STATIC
+EFI_STATUS
+TerminalFlushOutput (
+  IN     TERMINAL_DEV  *TerminalDevice,
+  IN     UINT8         *OutputBuffer,
+  IN OUT UINTN         *OutputLength
+  )
+{
+  UINTN  Length;
+
+  if (*OutputLength == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Length        = *OutputLength;
+  *OutputLength = 0;
+  return TerminalDevice->SerialIo->Write (
+                                     TerminalDevice->SerialIo,
+                                     &Length,
+                                     OutputBuffer
+                                     );
+}
+
+/**
+  Gather bytes of OutputString(), writing the gathered bytes first when there
+  is no room left for them.
+
+  @param  TerminalDevice          The terminal device.
+  @param  OutputBuffer            The gathered bytes.
+  @param  OutputLength            The number of gathered bytes.
+  @param  Data                    The bytes to gather.
+  @param  DataLength              The number of bytes to gather.
+
+  @retval EFI_SUCCESS             The bytes are gathered.
+  @retval Others                  The serial device failed to write the bytes
+                                  gathered before.
+
+**/
+STATIC
+EFI_STATUS
+TerminalGatherOutput (
+  IN     TERMINAL_DEV  *TerminalDevice,
+  IN OUT UINT8         *OutputBuffer,
+  IN OUT UINTN         *OutputLength,
+  IN     CONST VOID    *Data,
+  IN     UINTN         DataLength
+  )
+{
+  EFI_STATUS  Status;
+
+  if (*OutputLength + DataLength > TERMINAL_OUTPUT_BUFFER_SIZE) {
+    Status = TerminalFlushOutput (TerminalDevice, OutputBuffer, OutputLength);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  CopyMem (OutputBuffer + *OutputLength, Data, DataLength);
+  *OutputLength += DataLength;
+  return EFI_SUCCESS;
+}
+
 /**
   Implements EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL.OutputString().
 
@@ -175,22 +249,24 @@ TerminalConOutOutputString (
   EFI_SIMPLE_TEXT_OUTPUT_MODE  *Mode;
   UINTN                        MaxColumn;
   UINTN                        MaxRow;
-  UINTN                        Length;
   UTF8_CHAR                    Utf8Char;
   CHAR8                        GraphicChar;
   CHAR8                        AsciiChar;
   EFI_STATUS                   Status;
   UINT8                        ValidBytes;
   CHAR8                        CrLfStr[2];
+  UINT8                        OutputBuffer[TERMINAL_OUTPUT_BUFFER_SIZE];
+  UINTN                        OutputLength;
   //
   //  flag used to indicate whether condition happens which will cause
   //  return EFI_WARN_UNKNOWN_GLYPH
   //
   BOOLEAN  Warning;
 
-  ValidBytes = 0;
-  Warning    = FALSE;
-  AsciiChar  = 0;
+  ValidBytes   = 0;
+  Warning      = FALSE;
+  AsciiChar    = 0;
+  OutputLength = 0;
 
   //
   //  get Terminal device data structure pointer.
@@ -251,14 +327,11 @@ TerminalConOutOutputString (
           GraphicChar = AsciiChar;
         }
 
-        Length = 1;
-
-        Status = TerminalDevice->SerialIo->Write (
-                                             TerminalDevice->SerialIo,
-                                             &Length,
-                                             &GraphicChar
-                                             );
-
+        //
+        // The characters are written to the serial device in chunks rather
+        // than one by one.
+        //
+        Status = TerminalGatherOutput (TerminalDevice, OutputBuffer, &OutputLength, &GraphicChar, 1);
         if (EFI_ERROR (Status)) {
           goto OutputError;
         }
@@ -267,12 +340,7 @@ TerminalConOutOutputString (
 
       case TerminalTypeVtUtf8:
         UnicodeToUtf8 (*WString, &Utf8Char, &ValidBytes);
-        Length = ValidBytes;
-        Status = TerminalDevice->SerialIo->Write (
-                                             TerminalDevice->SerialIo,
-                                             &Length,
-                                             (UINT8 *)&Utf8Char
-                                             );
+        Status = TerminalGatherOutput (TerminalDevice, OutputBuffer, &OutputLength, &Utf8Char, ValidBytes);
         if (EFI_ERROR (Status)) {
           goto OutputError;
         }
@@ -325,14 +393,7 @@ TerminalConOutOutputString (
             CrLfStr[0] = '\r';
             CrLfStr[1] = '\n';
 
-            Length = sizeof (CrLfStr);
-
-            Status = TerminalDevice->SerialIo->Write (
-                                                 TerminalDevice->SerialIo,
-                                                 &Length,
-                                                 CrLfStr
-                                                 );
-
+            Status = TerminalGatherOutput (TerminalDevice, OutputBuffer, &OutputLength, CrLfStr, sizeof (CrLfStr));
             if (EFI_ERROR (Status)) {
               goto OutputError;
             }
@@ -343,6 +404,11 @@ TerminalConOutOutputString (
     }
   }
 
+  Status = TerminalFlushOutput (TerminalDevice, OutputBuffer, &OutputLength);
+  if (EFI_ERROR (Status)) {
+    goto OutputError;
+  }
+
   if (Warning) {
     return EFI_WARN_UNKNOWN_GLYPH;
   }
@@ -186,6 +186,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  DiskIoInitializeReadAhead (Instance);
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -217,6 +219,7 @@ ErrorExit:
     }
 
     if (Instance != NULL) {
+      DiskIoFreeReadAhead (Instance);
       FreePool (Instance);
     }
 
@@ -325,6 +328,7 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    DiskIoFreeReadAhead (Instance);
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -813,6 +817,272 @@ DiskIo2RemoveCompletedTask (
   return QueueEmpty;
 }
 
+/**
+  The callback for the BlockIo2 ReadBlocksEx of the read-ahead window.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               The pointer to the notification function's context,
+                                which points to the DISK_IO_PRIVATE_DATA instance.
+**/
+VOID
+EFIAPI
+DiskIoOnReadAheadComplete (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  DISK_IO_PRIVATE_DATA  *Instance;
+
+  Instance = (DISK_IO_PRIVATE_DATA *)Context;
+
+  if (!Instance->ReadAheadDiscard && !EFI_ERROR (Instance->ReadAheadToken.TransactionStatus)) {
+    Instance->ReadAheadValidBlocks = Instance->ReadAheadBlocks;
+  } else {
+    Instance->ReadAheadValidBlocks = 0;
+  }
+
+  Instance->ReadAheadDiscard = FALSE;
+  Instance->ReadAheadPending = FALSE;
+}
+
+/**
+  Allocate the read-ahead window of a Disk I/O instance when
+  PcdDiskIoReadAheadBlockNum is not 0 and the device supports Block I/O 2.
+  Read-ahead stays disabled when the resources can't be allocated.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoInitializeReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       BufferSize;
+
+  if ((PcdGet32 (PcdDiskIoReadAheadBlockNum) == 0) || (Instance->BlockIo2 == NULL)) {
+    return;
+  }
+
+  BufferSize = PcdGet32 (PcdDiskIoReadAheadBlockNum) * Instance->BlockIo->Media->BlockSize;
+  Status     = gBS->CreateEvent (
+                      EVT_NOTIFY_SIGNAL,
+                      TPL_NOTIFY,
+                      DiskIoOnReadAheadComplete,
+                      Instance,
+                      &Instance->ReadAheadToken.Event
+                      );
+  if (EFI_ERROR (Status)) {
+    Instance->ReadAheadToken.Event = NULL;
+    return;
+  }
+
+  Instance->ReadAheadBuffer = AllocateAlignedPages (
+                                EFI_SIZE_TO_PAGES (BufferSize),
+                                Instance->BlockIo->Media->IoAlign
+                                );
+  if (Instance->ReadAheadBuffer == NULL) {
+    gBS->CloseEvent (Instance->ReadAheadToken.Event);
+    Instance->ReadAheadToken.Event = NULL;
+    return;
+  }
+
+  Instance->ReadAheadBufferSize = BufferSize;
+  Instance->ReadAheadNextOffset = MAX_UINT64;
+}
+
+/**
+  Free the read-ahead window of a Disk I/O instance, after waiting for the
+  prefetch in flight to complete.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoFreeReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  if (Instance->ReadAheadBuffer == NULL) {
+    return;
+  }
+
+  while (Instance->ReadAheadPending) {
+    gBS->Stall (10);
+  }
+
+  gBS->CloseEvent (Instance->ReadAheadToken.Event);
+  FreeAlignedPages (Instance->ReadAheadBuffer, EFI_SIZE_TO_PAGES (Instance->ReadAheadBufferSize));
+  Instance->ReadAheadBuffer = NULL;
+}
+
+/**
+  Drop the content of the read-ahead window, including the data of the
+  prefetch in flight.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoInvalidateReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Instance->ReadAheadValidBlocks = 0;
+  Instance->ReadAheadNextOffset  = MAX_UINT64;
+  if (Instance->ReadAheadPending) {
+    Instance->ReadAheadDiscard = TRUE;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Serve a read request from the read-ahead window.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium to read.
+  @param Offset      The starting byte offset on the logical block I/O device to read from.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the destination buffer for the data.
+
+  @retval TRUE       The data is copied from the read-ahead window.
+  @retval FALSE      The window doesn't hold all the requested data.
+**/
+BOOLEAN
+DiskIoReadFromReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize,
+  OUT UINT8                *Buffer
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  EFI_TPL             OldTpl;
+  UINT64              WindowStart;
+  BOOLEAN             Hit;
+
+  Media = Instance->BlockIo->Media;
+  if ((BufferSize == 0) || (Offset + BufferSize < Offset)) {
+    return FALSE;
+  }
+
+  //
+  // Wait for the prefetch in flight if it brings in the requested data.
+  //
+  WindowStart = MultU64x32 (Instance->ReadAheadLba, Media->BlockSize);
+  if (Instance->ReadAheadPending &&
+      (Offset >= WindowStart) &&
+      (Offset + BufferSize <= WindowStart + MultU64x32 (Instance->ReadAheadBlocks, Media->BlockSize)))
+  {
+    while (Instance->ReadAheadPending) {
+      gBS->Stall (10);
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if ((Instance->ReadAheadValidBlocks != 0) &&
+      ((MediaId != Instance->ReadAheadMediaId) || (Media->MediaId != Instance->ReadAheadMediaId) || !Media->MediaPresent))
+  {
+    Instance->ReadAheadValidBlocks = 0;
+  }
+
+  WindowStart = MultU64x32 (Instance->ReadAheadLba, Media->BlockSize);
+  Hit         = (BOOLEAN)(!Instance->ReadAheadPending &&
+                          (Instance->ReadAheadValidBlocks != 0) &&
+                          (Offset >= WindowStart) &&
+                          (Offset + BufferSize <= WindowStart + MultU64x32 (Instance->ReadAheadValidBlocks, Media->BlockSize)));
+  if (Hit) {
+    CopyMem (Buffer, Instance->ReadAheadBuffer + (UINTN)(Offset - WindowStart), BufferSize);
+    Instance->ReadAheadNextOffset = Offset + BufferSize;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Hit;
+}
+
+/**
+  Track the blocking reads of a Disk I/O instance, and prefetch the blocks
+  following a read which continues the previous one.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId     ID of the medium which was read.
+  @param Offset      The starting byte offset of the completed read.
+  @param BufferSize  The size in bytes of the completed read.
+**/
+VOID
+DiskIoStartReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  EFI_STATUS          Status;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  EFI_TPL             OldTpl;
+  BOOLEAN             Sequential;
+  EFI_LBA             Lba;
+  UINT64              Blocks;
+
+  Media = Instance->BlockIo->Media;
+
+  OldTpl                        = gBS->RaiseTPL (TPL_NOTIFY);
+  Sequential                    = (BOOLEAN)(Offset == Instance->ReadAheadNextOffset);
+  Instance->ReadAheadNextOffset = Offset + BufferSize;
+
+  //
+  // Large reads don't benefit from the window. Don't prefetch while
+  // non-blocking requests are in flight either, as they may write the blocks.
+  //
+  if (!Sequential || Instance->ReadAheadPending ||
+      (BufferSize >= Instance->ReadAheadBufferSize) ||
+      !IsListEmpty (&Instance->TaskQueue))
+  {
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Lba = DivU64x32 (Offset + BufferSize, Media->BlockSize);
+  if (!Media->MediaPresent || (Media->MediaId != MediaId) || (Lba > Media->LastBlock)) {
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Blocks = MIN (Instance->ReadAheadBufferSize / Media->BlockSize, Media->LastBlock - Lba + 1);
+  if (Blocks == 0) {
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Instance->ReadAheadPending     = TRUE;
+  Instance->ReadAheadDiscard     = FALSE;
+  Instance->ReadAheadValidBlocks = 0;
+  Instance->ReadAheadMediaId     = MediaId;
+  Instance->ReadAheadLba         = Lba;
+  Instance->ReadAheadBlocks      = (UINTN)Blocks;
+  gBS->RestoreTPL (OldTpl);
+
+  Instance->ReadAheadToken.TransactionStatus = EFI_SUCCESS;
+
+  Status = Instance->BlockIo2->ReadBlocksEx (
+                                 Instance->BlockIo2,
+                                 MediaId,
+                                 Lba,
+                                 &Instance->ReadAheadToken,
+                                 (UINTN)Blocks * Media->BlockSize,
+                                 Instance->ReadAheadBuffer
+                                 );
+  if (EFI_ERROR (Status)) {
+    OldTpl                     = gBS->RaiseTPL (TPL_NOTIFY);
+    Instance->ReadAheadPending = FALSE;
+    gBS->RestoreTPL (OldTpl);
+  }
+}
+
 /**
   Common routine to access the disk.
 
@@ -858,6 +1128,19 @@ DiskIo2ReadWriteDisk (
   Status   = EFI_SUCCESS;
   Blocking = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
 
+  if (Instance->ReadAheadBuffer != NULL) {
+    if (Write) {
+      DiskIoInvalidateReadAhead (Instance);
+    } else if (DiskIoReadFromReadAhead (Instance, MediaId, Offset, BufferSize, Buffer)) {
+      if (!Blocking) {
+        Token->TransactionStatus = EFI_SUCCESS;
+        gBS->SignalEvent (Token->Event);
+      }
+
+      return EFI_SUCCESS;
+    }
+  }
+
   if (Blocking) {
     //
     // Wait till pending async task is completed.
@@ -1014,6 +1297,14 @@ DiskIo2ReadWriteDisk (
 
   gBS->RestoreTPL (OldTpl);
 
+  if (Instance->ReadAheadBuffer != NULL) {
+    if (EFI_ERROR (Status)) {
+      DiskIoInvalidateReadAhead (Instance);
+    } else if (!Write && Blocking) {
+      DiskIoStartReadAhead (Instance, MediaId, Offset, BufferSize);
+    }
+  }
+
   return Status;
 }
 
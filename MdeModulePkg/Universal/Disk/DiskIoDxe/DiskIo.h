@@ -37,6 +37,21 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  //
+  // Read-ahead window for sequential blocking reads. ReadAheadBuffer is NULL
+  // when read-ahead is disabled.
+  //
+  UINT8                     *ReadAheadBuffer;
+  UINTN                     ReadAheadBufferSize;
+  EFI_BLOCK_IO2_TOKEN       ReadAheadToken;
+  UINT32                    ReadAheadMediaId;
+  EFI_LBA                   ReadAheadLba;
+  UINTN                     ReadAheadBlocks;          /// < blocks requested by the prefetch
+  UINTN                     ReadAheadValidBlocks;     /// < 0 indicates the window is empty
+  BOOLEAN                   ReadAheadPending;
+  BOOLEAN                   ReadAheadDiscard;
+  UINT64                    ReadAheadNextOffset;      /// < offset following the last read
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -335,6 +350,33 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+//
+// Read-ahead window
+//
+
+/**
+  Allocate the read-ahead window of a Disk I/O instance when
+  PcdDiskIoReadAheadBlockNum is not 0 and the device supports Block I/O 2.
+  Read-ahead stays disabled when the resources can't be allocated.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoInitializeReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Free the read-ahead window of a Disk I/O instance, after waiting for the
+  prefetch in flight to complete.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoFreeReadAhead (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
 //
 // EFI Component Name Functions
 //
@@ -165,6 +165,15 @@ RamDiskBlkIoReadBlocks (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (PrivateData->SparseChunks != NULL) {
+    return RamDiskSparseRead (
+             PrivateData,
+             MultU64x32 (Lba, PrivateData->Media.BlockSize),
+             BufferSize,
+             Buffer
+             );
+  }
+
   CopyMem (
     Buffer,
     (VOID *)(UINTN)(PrivateData->StartingAddr + MultU64x32 (Lba, PrivateData->Media.BlockSize)),
@@ -243,6 +252,15 @@ RamDiskBlkIoWriteBlocks (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (PrivateData->SparseChunks != NULL) {
+    return RamDiskSparseWrite (
+             PrivateData,
+             MultU64x32 (Lba, PrivateData->Media.BlockSize),
+             BufferSize,
+             Buffer
+             );
+  }
+
   CopyMem (
     (VOID *)(UINTN)(PrivateData->StartingAddr + MultU64x32 (Lba, PrivateData->Media.BlockSize)),
     Buffer,
@@ -23,6 +23,17 @@ EFI_RAM_DISK_PROTOCOL  mRamDiskProtocol = {
   RamDiskUnregister
 };
 
+//
+// The EDKII_SPARSE_RAM_DISK_PROTOCOL instance that is installed onto the
+// driver handle
+//
+EDKII_SPARSE_RAM_DISK_PROTOCOL  mSparseRamDiskProtocol = {
+  RAM_DISK_SPARSE_CHUNK_SIZE,
+  RamDiskSparseRegister,
+  RamDiskSparseWriteChunk,
+  RamDiskSparsePublish
+};
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 //
@@ -166,6 +177,8 @@ RamDiskDxeEntryPoint (
                   &mRamDiskHandle,
                   &gEfiRamDiskProtocolGuid,
                   &mRamDiskProtocol,
+                  &gEdkiiSparseRamDiskProtocolGuid,
+                  &mSparseRamDiskProtocol,
                   &gEfiCallerIdGuid,
                   ConfigPrivate,
                   NULL
@@ -231,6 +244,8 @@ RamDiskDxeUnload (
          mRamDiskHandle,
          &gEfiRamDiskProtocolGuid,
          &mRamDiskProtocol,
+         &gEdkiiSparseRamDiskProtocolGuid,
+         &mSparseRamDiskProtocol,
          &gEfiCallerIdGuid,
          ConfigPrivate,
          NULL
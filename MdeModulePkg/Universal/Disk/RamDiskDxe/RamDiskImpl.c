@@ -188,6 +188,8 @@ UnregisterAllRamDisks (
         FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
       }
 
+      RamDiskSparseFree (PrivateData);
+
       FreePool (PrivateData->DevicePath);
       FreePool (PrivateData);
     }
@@ -25,7 +25,9 @@
 #include <Library/PrintLib.h>
 #include <Library/PcdLib.h>
 #include <Library/DxeServicesLib.h>
+#include <Library/UefiDecompressLib.h>
 #include <Protocol/RamDisk.h>
+#include <Protocol/SparseRamDisk.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/BlockIo2.h>
 #include <Protocol/HiiConfigAccess.h>
@@ -48,6 +50,11 @@
 //
 #define RAM_DISK_DEFAULT_BLOCK_SIZE  512
 
+//
+// Chunk size of sparse RAM disks
+//
+#define RAM_DISK_SPARSE_CHUNK_SIZE  SIZE_64KB
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 //
@@ -67,6 +74,17 @@ typedef enum _RAM_DISK_CREATE_METHOD {
   RamDiskCreateHii
 } RAM_DISK_CREATE_METHOD;
 
+//
+// A chunk of a sparse RAM disk. Data is NULL for a chunk that reads as zeros.
+// CompressedSize is 0 when Data holds the chunk as is, in a buffer of
+// RAM_DISK_SPARSE_CHUNK_SIZE bytes, and the size of the compressed data
+// otherwise.
+//
+typedef struct {
+  VOID     *Data;
+  UINT32   CompressedSize;
+} RAM_DISK_SPARSE_CHUNK;
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 // The struct contains the list entry and the information of each RAM
@@ -91,6 +109,17 @@ typedef struct {
   EFI_QUESTION_ID             CheckBoxId;
   BOOLEAN                     CheckBoxChecked;
 
+  //
+  // Chunks of a sparse RAM disk, NULL for a RAM disk in contiguous memory.
+  // The last decompressed chunk is kept in SparseCache.
+  //
+  RAM_DISK_SPARSE_CHUNK       *SparseChunks;
+  UINTN                       SparseChunkCount;
+  UINT8                       *SparseCache;
+  UINTN                       SparseCacheIndex;
+  VOID                        *SparseScratch;
+  UINT32                      SparseScratchSize;
+
   LIST_ENTRY                  ThisInstance;
 } RAM_DISK_PRIVATE_DATA;
 
@@ -99,6 +128,8 @@ typedef struct {
 #define RAM_DISK_PRIVATE_FROM_BLKIO2(a)  CR (a, RAM_DISK_PRIVATE_DATA, BlockIo2, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 #define RAM_DISK_PRIVATE_FROM_THIS(a)    CR (a, RAM_DISK_PRIVATE_DATA, ThisInstance, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 
+extern RAM_DISK_PRIVATE_DATA  mRamDiskPrivateDataTemplate;
+
 ///
 /// RAM disk HII-related definitions and declarations
 ///
@@ -599,4 +630,165 @@ RamDiskPublishNfit (
   IN RAM_DISK_PRIVATE_DATA  *PrivateData
   );
 
+/**
+  Create the device path of a RAM disk, install its protocols and add it to
+  the list of registered RAM disks.
+
+  @param[in, out] PrivateData     Points to RAM disk private data, with the
+                                  address, the size and the type of the RAM
+                                  disk filled in.
+  @param[in]      ParentDevicePath
+                                  Pointer to the parent device path. If there
+                                  is no parent device path then
+                                  ParentDevicePath is NULL.
+  @param[out]     DevicePath      On return, points to a pointer to the device
+                                  path of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+RamDiskInstall (
+  IN OUT RAM_DISK_PRIVATE_DATA     *PrivateData,
+  IN     EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  OUT    EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  );
+
+/**
+  Read data from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to read from.
+  @param[in]  Size           The number of bytes to read.
+  @param[out] Buffer         The destination buffer.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A compressed chunk is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to decompress a
+                                  chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Size,
+  OUT UINT8                  *Buffer
+  );
+
+/**
+  Write data to a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to write to.
+  @param[in]  Size           The number of bytes to write.
+  @param[in]  Buffer         The source buffer.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A compressed chunk is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Size,
+  IN UINT8                  *Buffer
+  );
+
+/**
+  Free the chunks of a sparse RAM disk. Nothing is done for a RAM disk in
+  contiguous memory.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  );
+
+/**
+  Register an empty sparse RAM disk with the specified size and type.
+
+  @param[in]  RamDiskSize    The size of the RAM disk.
+  @param[in]  RamDiskType    The type of the RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseRegister (
+  IN UINT64                     RamDiskSize,
+  IN EFI_GUID                   *RamDiskType,
+  IN EFI_DEVICE_PATH            *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  );
+
+/**
+  Store one chunk of a sparse RAM disk.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[in]  Offset         The byte offset of the chunk on the disk.
+  @param[in]  Compressed     TRUE if Buffer holds the chunk in the UEFI
+                             compressed format.
+  @param[in]  Buffer         The chunk data.
+  @param[in]  BufferSize     The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS             The chunk is stored.
+  @retval EFI_INVALID_PARAMETER   Offset is not a chunk offset of the disk, or
+                                  the data doesn't have the size of the chunk.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to store the
+                                  chunk.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseWriteChunk (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN BOOLEAN                   Compressed,
+  IN VOID                      *Buffer,
+  IN UINTN                     BufferSize
+  );
+
+/**
+  Turn a sparse RAM disk into a regular RAM disk for OS handoff.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[out] NewDevicePath  On return, points to a pointer to the device path
+                             of the regular RAM disk.
+
+  @retval EFI_SUCCESS             The RAM disk is published.
+  @retval EFI_INVALID_PARAMETER   DevicePath or NewDevicePath is NULL.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the disk
+                                  content.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparsePublish (
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **NewDevicePath
+  );
+
 #endif
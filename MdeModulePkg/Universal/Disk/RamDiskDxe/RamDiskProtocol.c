@@ -150,6 +150,14 @@ RamDiskPublishNfit (
   UINT8    Checksum;
   BOOLEAN  MemoryFound;
 
+  //
+  // The content of a sparse RAM disk is not in memory the OS can map. It is
+  // published once it is turned into a regular RAM disk.
+  //
+  if (PrivateData->SparseChunks != NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
   //
   // Get the EFI memory map.
   //
@@ -559,29 +567,20 @@ RamDiskUnpublishNfit (
 }
 
 /**
-  Register a RAM disk with specified address, size and type.
-
-  @param[in]  RamDiskBase    The base address of registered RAM disk.
-  @param[in]  RamDiskSize    The size of registered RAM disk.
-  @param[in]  RamDiskType    The type of registered RAM disk. The GUID can be
-                             any of the values defined in section 9.3.6.9, or a
-                             vendor defined GUID.
-  @param[in]  ParentDevicePath
-                             Pointer to the parent device path. If there is no
-                             parent device path then ParentDevicePath is NULL.
-  @param[out] DevicePath     On return, points to a pointer to the device path
-                             of the RAM disk device.
-                             If ParentDevicePath is not NULL, the returned
-                             DevicePath is created by appending a RAM disk node
-                             to the parent device path. If ParentDevicePath is
-                             NULL, the returned DevicePath is a RAM disk device
-                             path without appending. This function is
-                             responsible for allocating the buffer DevicePath
-                             with the boot service AllocatePool().
+  Create the device path of a RAM disk, install its protocols and add it to
+  the list of registered RAM disks.
+
+  @param[in, out] PrivateData     Points to RAM disk private data, with the
+                                  address, the size and the type of the RAM
+                                  disk filled in.
+  @param[in]      ParentDevicePath
+                                  Pointer to the parent device path. If there
+                                  is no parent device path then
+                                  ParentDevicePath is NULL.
+  @param[out]     DevicePath      On return, points to a pointer to the device
+                                  path of the RAM disk device.
 
   @retval EFI_SUCCESS             The RAM disk is registered successfully.
-  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
-                                  RamDiskSize is 0.
   @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
                                   is already present in the handle database.
   @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
@@ -589,51 +588,18 @@ RamDiskUnpublishNfit (
 
 **/
 EFI_STATUS
-EFIAPI
-RamDiskRegister (
-  IN UINT64                     RamDiskBase,
-  IN UINT64                     RamDiskSize,
-  IN EFI_GUID                   *RamDiskType,
-  IN EFI_DEVICE_PATH            *ParentDevicePath     OPTIONAL,
-  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+RamDiskInstall (
+  IN OUT RAM_DISK_PRIVATE_DATA     *PrivateData,
+  IN     EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  OUT    EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   )
 {
   EFI_STATUS                  Status;
-  RAM_DISK_PRIVATE_DATA       *PrivateData;
   RAM_DISK_PRIVATE_DATA       *RegisteredPrivateData;
   MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
   UINTN                       DevicePathSize;
   LIST_ENTRY                  *Entry;
 
-  if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Add check to prevent data read across the memory boundary
-  //
-  if ((RamDiskSize > MAX_UINTN) ||
-      (RamDiskBase > MAX_UINTN - RamDiskSize + 1))
-  {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  RamDiskDevNode = NULL;
-
-  //
-  // Create a new RAM disk instance and initialize its private data
-  //
-  PrivateData = AllocateCopyPool (
-                  sizeof (RAM_DISK_PRIVATE_DATA),
-                  &mRamDiskPrivateDataTemplate
-                  );
-  if (NULL == PrivateData) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  PrivateData->StartingAddr = RamDiskBase;
-  PrivateData->Size         = RamDiskSize;
-  CopyGuid (&PrivateData->TypeGuid, RamDiskType);
   InitializeListHead (&PrivateData->ThisInstance);
 
   //
@@ -731,11 +697,87 @@ ErrorExit:
     FreePool (RamDiskDevNode);
   }
 
-  if (PrivateData != NULL) {
-    if (PrivateData->DevicePath) {
-      FreePool (PrivateData->DevicePath);
-    }
+  if (PrivateData->DevicePath != NULL) {
+    FreePool (PrivateData->DevicePath);
+    PrivateData->DevicePath = NULL;
+  }
+
+  return Status;
+}
 
+/**
+  Register a RAM disk with specified address, size and type.
+
+  @param[in]  RamDiskBase    The base address of registered RAM disk.
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk. The GUID can be
+                             any of the values defined in section 9.3.6.9, or a
+                             vendor defined GUID.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+                             If ParentDevicePath is not NULL, the returned
+                             DevicePath is created by appending a RAM disk node
+                             to the parent device path. If ParentDevicePath is
+                             NULL, the returned DevicePath is a RAM disk device
+                             path without appending. This function is
+                             responsible for allocating the buffer DevicePath
+                             with the boot service AllocatePool().
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskRegister (
+  IN UINT64                     RamDiskBase,
+  IN UINT64                     RamDiskSize,
+  IN EFI_GUID                   *RamDiskType,
+  IN EFI_DEVICE_PATH            *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  )
+{
+  EFI_STATUS             Status;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+
+  if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Add check to prevent data read across the memory boundary
+  //
+  if ((RamDiskSize > MAX_UINTN) ||
+      (RamDiskBase > MAX_UINTN - RamDiskSize + 1))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Create a new RAM disk instance and initialize its private data
+  //
+  PrivateData = AllocateCopyPool (
+                  sizeof (RAM_DISK_PRIVATE_DATA),
+                  &mRamDiskPrivateDataTemplate
+                  );
+  if (NULL == PrivateData) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  PrivateData->StartingAddr = RamDiskBase;
+  PrivateData->Size         = RamDiskSize;
+  CopyGuid (&PrivateData->TypeGuid, RamDiskType);
+
+  Status = RamDiskInstall (PrivateData, ParentDevicePath, DevicePath);
+  if (EFI_ERROR (Status)) {
     FreePool (PrivateData);
   }
 
@@ -848,6 +890,8 @@ RamDiskUnregister (
           FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
         }
 
+        RamDiskSparseFree (PrivateData);
+
         FreePool (PrivateData->DevicePath);
         FreePool (PrivateData);
         Found = TRUE;
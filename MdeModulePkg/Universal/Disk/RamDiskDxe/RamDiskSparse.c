@@ -0,0 +1,631 @@
+/** @file
+  The realization of EDKII_SPARSE_RAM_DISK_PROTOCOL.
+
+  A sparse RAM disk keeps its content in RAM_DISK_SPARSE_CHUNK_SIZE chunks.
+  Chunks that were never written take no memory and read as zeros. Chunks
+  stored compressed are decompressed when they are read, the last one into a
+  per-disk cache, and are stored uncompressed once they are written through
+  Block I/O.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "RamDiskImpl.h"
+
+/**
+  Return the number of bytes of the disk that a chunk covers. Only the last
+  chunk of a disk may be shorter than RAM_DISK_SPARSE_CHUNK_SIZE.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Index          The index of the chunk.
+
+  @return The number of bytes of the chunk.
+
+**/
+STATIC
+UINTN
+RamDiskSparseChunkLength (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  Index
+  )
+{
+  UINT64  Offset;
+
+  Offset = MultU64x32 (Index, RAM_DISK_SPARSE_CHUNK_SIZE);
+  return (UINTN)MIN (PrivateData->Size - Offset, RAM_DISK_SPARSE_CHUNK_SIZE);
+}
+
+/**
+  Decompress a compressed chunk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Index          The index of the chunk.
+  @param[out] Destination    The buffer of RAM_DISK_SPARSE_CHUNK_SIZE bytes
+                             that receives the chunk.
+
+  @retval EFI_SUCCESS             The chunk is decompressed.
+  @retval EFI_DEVICE_ERROR        The compressed data is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the scratch
+                                  buffer.
+
+**/
+STATIC
+EFI_STATUS
+RamDiskSparseDecompress (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINTN                  Index,
+  OUT UINT8                  *Destination
+  )
+{
+  EFI_STATUS             Status;
+  RAM_DISK_SPARSE_CHUNK  *Chunk;
+  UINT32                 DestinationSize;
+  UINT32                 ScratchSize;
+  VOID                   *Scratch;
+
+  Chunk  = &PrivateData->SparseChunks[Index];
+  Status = UefiDecompressGetInfo (
+             Chunk->Data,
+             Chunk->CompressedSize,
+             &DestinationSize,
+             &ScratchSize
+             );
+  if (EFI_ERROR (Status) || (DestinationSize != RamDiskSparseChunkLength (PrivateData, Index))) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (ScratchSize > PrivateData->SparseScratchSize) {
+    Scratch = AllocatePool (ScratchSize);
+    if (Scratch == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    if (PrivateData->SparseScratch != NULL) {
+      FreePool (PrivateData->SparseScratch);
+    }
+
+    PrivateData->SparseScratch     = Scratch;
+    PrivateData->SparseScratchSize = ScratchSize;
+  }
+
+  Status = UefiDecompress (Chunk->Data, Destination, PrivateData->SparseScratch);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Make sure a chunk is stored uncompressed, so that it can be written.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Index          The index of the chunk.
+
+  @retval EFI_SUCCESS             The chunk is stored uncompressed.
+  @retval EFI_DEVICE_ERROR        The compressed data is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the chunk.
+
+**/
+STATIC
+EFI_STATUS
+RamDiskSparseInflateChunk (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  Index
+  )
+{
+  EFI_STATUS             Status;
+  RAM_DISK_SPARSE_CHUNK  *Chunk;
+  UINT8                  *Data;
+
+  Chunk = &PrivateData->SparseChunks[Index];
+  if ((Chunk->Data != NULL) && (Chunk->CompressedSize == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  Data = AllocateZeroPool (RAM_DISK_SPARSE_CHUNK_SIZE);
+  if (Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Chunk->Data != NULL) {
+    if (PrivateData->SparseCacheIndex == Index) {
+      CopyMem (Data, PrivateData->SparseCache, RAM_DISK_SPARSE_CHUNK_SIZE);
+      PrivateData->SparseCacheIndex = MAX_UINTN;
+    } else {
+      Status = RamDiskSparseDecompress (PrivateData, Index, Data);
+      if (EFI_ERROR (Status)) {
+        FreePool (Data);
+        return Status;
+      }
+    }
+
+    FreePool (Chunk->Data);
+  }
+
+  Chunk->Data           = Data;
+  Chunk->CompressedSize = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read data from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to read from.
+  @param[in]  Size           The number of bytes to read.
+  @param[out] Buffer         The destination buffer.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A compressed chunk is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to decompress a
+                                  chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Size,
+  OUT UINT8                  *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  RAM_DISK_SPARSE_CHUNK  *Chunk;
+  UINTN                  Index;
+  UINT32                 ChunkOffset;
+  UINTN                  Length;
+
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  while (Size > 0) {
+    Index  = (UINTN)DivU64x32Remainder (Offset, RAM_DISK_SPARSE_CHUNK_SIZE, &ChunkOffset);
+    Length = MIN (Size, RAM_DISK_SPARSE_CHUNK_SIZE - ChunkOffset);
+    Chunk  = &PrivateData->SparseChunks[Index];
+
+    if (Chunk->Data == NULL) {
+      ZeroMem (Buffer, Length);
+    } else if (Chunk->CompressedSize == 0) {
+      CopyMem (Buffer, (UINT8 *)Chunk->Data + ChunkOffset, Length);
+    } else {
+      if (PrivateData->SparseCacheIndex != Index) {
+        PrivateData->SparseCacheIndex = MAX_UINTN;
+        Status                        = RamDiskSparseDecompress (PrivateData, Index, PrivateData->SparseCache);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+
+        PrivateData->SparseCacheIndex = Index;
+      }
+
+      CopyMem (Buffer, PrivateData->SparseCache + ChunkOffset, Length);
+    }
+
+    Offset += Length;
+    Buffer += Length;
+    Size   -= Length;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Write data to a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to write to.
+  @param[in]  Size           The number of bytes to write.
+  @param[in]  Buffer         The source buffer.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A compressed chunk is corrupted.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Size,
+  IN UINT8                  *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  RAM_DISK_SPARSE_CHUNK  *Chunk;
+  UINTN                  Index;
+  UINT32                 ChunkOffset;
+  UINTN                  Length;
+
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  while (Size > 0) {
+    Index  = (UINTN)DivU64x32Remainder (Offset, RAM_DISK_SPARSE_CHUNK_SIZE, &ChunkOffset);
+    Length = MIN (Size, RAM_DISK_SPARSE_CHUNK_SIZE - ChunkOffset);
+    Chunk  = &PrivateData->SparseChunks[Index];
+
+    //
+    // Writing zeros to a chunk that reads as zeros changes nothing.
+    //
+    if ((Chunk->Data != NULL) || !IsZeroBuffer (Buffer, Length)) {
+      Status = RamDiskSparseInflateChunk (PrivateData, Index);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      CopyMem ((UINT8 *)Chunk->Data + ChunkOffset, Buffer, Length);
+    }
+
+    Offset += Length;
+    Buffer += Length;
+    Size   -= Length;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Free the chunks of a sparse RAM disk. Nothing is done for a RAM disk in
+  contiguous memory.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  )
+{
+  UINTN  Index;
+
+  if (PrivateData->SparseChunks == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < PrivateData->SparseChunkCount; Index++) {
+    if (PrivateData->SparseChunks[Index].Data != NULL) {
+      FreePool (PrivateData->SparseChunks[Index].Data);
+    }
+  }
+
+  FreePool (PrivateData->SparseChunks);
+  PrivateData->SparseChunks = NULL;
+
+  if (PrivateData->SparseCache != NULL) {
+    FreePool (PrivateData->SparseCache);
+    PrivateData->SparseCache = NULL;
+  }
+
+  if (PrivateData->SparseScratch != NULL) {
+    FreePool (PrivateData->SparseScratch);
+    PrivateData->SparseScratch = NULL;
+  }
+}
+
+/**
+  Find a registered sparse RAM disk by its device path.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+
+  @return The private data of the RAM disk, or NULL if DevicePath is not a
+          registered sparse RAM disk.
+
+**/
+STATIC
+RAM_DISK_PRIVATE_DATA *
+RamDiskSparseFind (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  LIST_ENTRY             *Entry;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINTN                  DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  BASE_LIST_FOR_EACH (Entry, &RegisteredRamDisks) {
+    PrivateData = RAM_DISK_PRIVATE_FROM_THIS (Entry);
+    if ((PrivateData->SparseChunks != NULL) &&
+        (GetDevicePathSize (PrivateData->DevicePath) == DevicePathSize) &&
+        (CompareMem (PrivateData->DevicePath, DevicePath, DevicePathSize) == 0))
+    {
+      return PrivateData;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Register an empty sparse RAM disk with the specified size and type.
+
+  @param[in]  RamDiskSize    The size of the RAM disk.
+  @param[in]  RamDiskType    The type of the RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseRegister (
+  IN UINT64                     RamDiskSize,
+  IN EFI_GUID                   *RamDiskType,
+  IN EFI_DEVICE_PATH            *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  )
+{
+  EFI_STATUS             Status;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT64                 ChunkCount;
+
+  if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (RamDiskSize > MAX_UINT64 - RAM_DISK_SPARSE_CHUNK_SIZE) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ChunkCount = DivU64x32 (RamDiskSize + RAM_DISK_SPARSE_CHUNK_SIZE - 1, RAM_DISK_SPARSE_CHUNK_SIZE);
+  if (ChunkCount > MAX_UINTN / sizeof (RAM_DISK_SPARSE_CHUNK)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  PrivateData = AllocateCopyPool (
+                  sizeof (RAM_DISK_PRIVATE_DATA),
+                  &mRamDiskPrivateDataTemplate
+                  );
+  if (NULL == PrivateData) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  PrivateData->SparseChunkCount = (UINTN)ChunkCount;
+  PrivateData->SparseChunks     = AllocateZeroPool (PrivateData->SparseChunkCount * sizeof (RAM_DISK_SPARSE_CHUNK));
+  PrivateData->SparseCache      = AllocatePool (RAM_DISK_SPARSE_CHUNK_SIZE);
+  PrivateData->SparseCacheIndex = MAX_UINTN;
+  if ((PrivateData->SparseChunks == NULL) || (PrivateData->SparseCache == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ErrorExit;
+  }
+
+  //
+  // The chunk table gives the disk a unique address for its device path.
+  //
+  PrivateData->StartingAddr = (UINTN)PrivateData->SparseChunks;
+  PrivateData->Size         = RamDiskSize;
+  CopyGuid (&PrivateData->TypeGuid, RamDiskType);
+
+  Status = RamDiskInstall (PrivateData, ParentDevicePath, DevicePath);
+  if (!EFI_ERROR (Status)) {
+    return EFI_SUCCESS;
+  }
+
+ErrorExit:
+  if (PrivateData->SparseChunks == NULL) {
+    //
+    // RamDiskSparseFree () only frees the cache along with the chunk table.
+    //
+    if (PrivateData->SparseCache != NULL) {
+      FreePool (PrivateData->SparseCache);
+    }
+  } else {
+    RamDiskSparseFree (PrivateData);
+  }
+
+  FreePool (PrivateData);
+  return Status;
+}
+
+/**
+  Store one chunk of a sparse RAM disk.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[in]  Offset         The byte offset of the chunk on the disk.
+  @param[in]  Compressed     TRUE if Buffer holds the chunk in the UEFI
+                             compressed format.
+  @param[in]  Buffer         The chunk data.
+  @param[in]  BufferSize     The size of Buffer in bytes.
+
+  @retval EFI_SUCCESS             The chunk is stored.
+  @retval EFI_INVALID_PARAMETER   Offset is not a chunk offset of the disk, or
+                                  the data doesn't have the size of the chunk.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to store the
+                                  chunk.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseWriteChunk (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN BOOLEAN                   Compressed,
+  IN VOID                      *Buffer,
+  IN UINTN                     BufferSize
+  )
+{
+  EFI_STATUS             Status;
+  EFI_TPL                OldTpl;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  RAM_DISK_SPARSE_CHUNK  *Chunk;
+  UINTN                  Index;
+  UINTN                  ChunkLength;
+  UINT32                 Remainder;
+  UINT32                 DestinationSize;
+  UINT32                 ScratchSize;
+  VOID                   *Data;
+
+  if ((DevicePath == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PrivateData = RamDiskSparseFind (DevicePath);
+  if (PrivateData == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (Offset >= PrivateData->Size) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Index = (UINTN)DivU64x32Remainder (Offset, RAM_DISK_SPARSE_CHUNK_SIZE, &Remainder);
+  if (Remainder != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ChunkLength = RamDiskSparseChunkLength (PrivateData, Index);
+  if (Compressed) {
+    if (BufferSize > MAX_UINT32) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = UefiDecompressGetInfo (Buffer, (UINT32)BufferSize, &DestinationSize, &ScratchSize);
+    if (EFI_ERROR (Status) || (DestinationSize != ChunkLength)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Data = AllocateCopyPool (BufferSize, Buffer);
+    if (Data == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  } else {
+    if (BufferSize != ChunkLength) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Data = NULL;
+    if (!IsZeroBuffer (Buffer, BufferSize)) {
+      Data = AllocateZeroPool (RAM_DISK_SPARSE_CHUNK_SIZE);
+      if (Data == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      CopyMem (Data, Buffer, BufferSize);
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Chunk = &PrivateData->SparseChunks[Index];
+  if (Chunk->Data != NULL) {
+    FreePool (Chunk->Data);
+  }
+
+  Chunk->Data           = Data;
+  Chunk->CompressedSize = Compressed ? (UINT32)BufferSize : 0;
+  if (PrivateData->SparseCacheIndex == Index) {
+    PrivateData->SparseCacheIndex = MAX_UINTN;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Turn a sparse RAM disk into a regular RAM disk for OS handoff.
+
+  @param[in]  DevicePath     The device path of the sparse RAM disk.
+  @param[out] NewDevicePath  On return, points to a pointer to the device path
+                             of the regular RAM disk.
+
+  @retval EFI_SUCCESS             The RAM disk is published.
+  @retval EFI_INVALID_PARAMETER   DevicePath or NewDevicePath is NULL.
+  @retval EFI_NOT_FOUND           DevicePath is not a sparse RAM disk.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the disk
+                                  content.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparsePublish (
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **NewDevicePath
+  )
+{
+  EFI_STATUS                Status;
+  RAM_DISK_PRIVATE_DATA     *PrivateData;
+  EFI_DEVICE_PATH_PROTOCOL  *ParentDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+  EFI_GUID                  TypeGuid;
+  UINTN                     Pages;
+  UINT8                     *Buffer;
+
+  if ((DevicePath == NULL) || (NewDevicePath == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PrivateData = RamDiskSparseFind (DevicePath);
+  if (PrivateData == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (PrivateData->Size > MAX_UINTN) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // RamDiskPublishNfit () only reports RAM disks in reserved memory.
+  //
+  Pages  = EFI_SIZE_TO_PAGES ((UINTN)PrivateData->Size);
+  Buffer = AllocateReservedPages (Pages);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = RamDiskSparseRead (PrivateData, 0, (UINTN)PrivateData->Size, Buffer);
+  if (EFI_ERROR (Status)) {
+    FreePages (Buffer, Pages);
+    return Status;
+  }
+
+  //
+  // Register the regular RAM disk under the same parent.
+  //
+  ParentDevicePath = DuplicateDevicePath (PrivateData->DevicePath);
+  if (ParentDevicePath == NULL) {
+    FreePages (Buffer, Pages);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Node = ParentDevicePath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH) &&
+        (DevicePathSubType (Node) == MEDIA_RAM_DISK_DP))
+    {
+      SetDevicePathEndNode (Node);
+      break;
+    }
+  }
+
+  CopyGuid (&TypeGuid, &PrivateData->TypeGuid);
+  Status = RamDiskRegister (
+             (UINTN)Buffer,
+             PrivateData->Size,
+             &TypeGuid,
+             ParentDevicePath,
+             NewDevicePath
+             );
+  FreePool (ParentDevicePath);
+  if (EFI_ERROR (Status)) {
+    FreePages (Buffer, Pages);
+    return Status;
+  }
+
+  RamDiskUnregister (DevicePath);
+  return EFI_SUCCESS;
+}
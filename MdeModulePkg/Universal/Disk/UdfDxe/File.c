@@ -74,6 +74,7 @@ UdfOpenVolume (
     // There is no more open files. Read volume information again since it was
     // cleaned up on the last UdfClose() call.
     //
+    FreeMetadataCache (&PrivFsData->Volume);
     Status = ReadUdfVolumeInformation (
                PrivFsData->BlockIo,
                PrivFsData->DiskIo,
@@ -273,6 +274,10 @@ UdfOpen (
     (VOID *)&NewPrivFileData->ReadDirInfo,
     sizeof (UDF_READ_DIRECTORY_INFO)
     );
+  ZeroMem (
+    (VOID *)&NewPrivFileData->ExtentCache,
+    sizeof (UDF_FILE_EXTENT_CACHE)
+    );
 
   *NewHandle = &NewPrivFileData->FileIo;
 
@@ -385,7 +390,8 @@ UdfRead (
                PrivFileData->FileSize,
                &PrivFileData->FilePosition,
                Buffer,
-               &BufferSizeUint64
+               &BufferSizeUint64,
+               &PrivFileData->ExtentCache
                );
     ASSERT (BufferSizeUint64 <= MAX_UINTN);
     *BufferSize = (UINTN)BufferSizeUint64;
@@ -570,6 +576,8 @@ UdfClose (
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
     }
+
+    FreeFileExtentCache (&PrivFileData->ExtentCache);
   }
 
   FreePool ((VOID *)PrivFileData);
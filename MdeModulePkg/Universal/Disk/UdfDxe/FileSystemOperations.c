@@ -1004,13 +1004,14 @@ GetAedAdsData (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  return DiskIo->ReadDisk (
-                   DiskIo,
-                   BlockIo->Media->MediaId,
-                   Offset,
-                   (UINTN)(*Length),
-                   *Data
-                   );
+  return ReadVolumeMetadata (
+           BlockIo,
+           DiskIo,
+           Volume,
+           Offset,
+           (UINTN)(*Length),
+           *Data
+           );
 }
 
 /**
@@ -1053,6 +1054,71 @@ GrowUpBufferToNextAd (
   return EFI_SUCCESS;
 }
 
+/**
+  Add an extent to the extent cache of a file. The extent is merged with the
+  last one when they are contiguous on the disk.
+
+  @param[in, out] ExtentCache     The extent cache of the file.
+  @param[in]      FileOffset      Offset of the extent within the file.
+  @param[in]      DiskOffset      Byte offset of the extent on the disk.
+  @param[in]      Length          Length of the extent.
+
+  @retval EFI_SUCCESS             The extent was added.
+  @retval EFI_OUT_OF_RESOURCES    The extent was not added due to lack of
+                                  resources.
+
+**/
+EFI_STATUS
+AddFileExtent (
+  IN OUT  UDF_FILE_EXTENT_CACHE  *ExtentCache,
+  IN      UINT64                 FileOffset,
+  IN      UINT64                 DiskOffset,
+  IN      UINT64                 Length
+  )
+{
+  UDF_FILE_EXTENT  *Extent;
+  UDF_FILE_EXTENT  *Extents;
+  UINTN            MaxExtentCount;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (ExtentCache->ExtentCount != 0) {
+    Extent = &ExtentCache->Extents[ExtentCache->ExtentCount - 1];
+    if ((Extent->FileOffset + Extent->Length == FileOffset) &&
+        (Extent->DiskOffset + Extent->Length == DiskOffset))
+    {
+      Extent->Length += Length;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (ExtentCache->ExtentCount == ExtentCache->MaxExtentCount) {
+    MaxExtentCount = (ExtentCache->MaxExtentCount == 0) ?
+                     UDF_FILE_EXTENT_CACHE_MIN_COUNT :
+                     ExtentCache->MaxExtentCount * 2;
+    Extents = ReallocatePool (
+                ExtentCache->MaxExtentCount * sizeof (UDF_FILE_EXTENT),
+                MaxExtentCount * sizeof (UDF_FILE_EXTENT),
+                ExtentCache->Extents
+                );
+    if (Extents == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ExtentCache->Extents        = Extents;
+    ExtentCache->MaxExtentCount = MaxExtentCount;
+  }
+
+  Extent             = &ExtentCache->Extents[ExtentCache->ExtentCount++];
+  Extent->FileOffset = FileOffset;
+  Extent->DiskOffset = DiskOffset;
+  Extent->Length     = Length;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read data or size of either a File Entry or an Extended File Entry.
 
@@ -1116,9 +1182,10 @@ ReadFile (
   switch (ReadFileInfo->Flags) {
     case ReadFileGetFileSize:
     case ReadFileAllocateAndRead:
+    case ReadFileGetExtents:
       //
-      // Initialise ReadFileInfo structure for either getting file size, or
-      // reading file's recorded data.
+      // Initialise ReadFileInfo structure for either getting file size,
+      // reading file's recorded data or resolving its extents.
       //
       ReadFileInfo->ReadLength = 0;
       ReadFileInfo->FileData   = NULL;
@@ -1185,6 +1252,11 @@ ReadFile (
           );
 
         ReadFileInfo->FilePosition += ReadFileInfo->FileDataSize;
+      } else if (ReadFileInfo->Flags == ReadFileGetExtents) {
+        //
+        // Inline data has no extent on the disk.
+        //
+        ReadFileInfo->ReadLength = Length;
       } else {
         ASSERT (FALSE);
         return EFI_INVALID_PARAMETER;
@@ -1289,18 +1361,32 @@ ReadFile (
             //
             // Read extent's data into FileData.
             //
-            Status = DiskIo->ReadDisk (
-                               DiskIo,
-                               BlockIo->Media->MediaId,
-                               MultU64x32 (Lsn, LogicalBlockSize),
-                               ExtentLength,
-                               (VOID *)((UINT8 *)ReadFileInfo->FileData +
-                                        ReadFileInfo->ReadLength)
-                               );
+            Status = ReadVolumeMetadata (
+                       BlockIo,
+                       DiskIo,
+                       Volume,
+                       MultU64x32 (Lsn, LogicalBlockSize),
+                       ExtentLength,
+                       (VOID *)((UINT8 *)ReadFileInfo->FileData +
+                                ReadFileInfo->ReadLength)
+                       );
             if (EFI_ERROR (Status)) {
               goto Error_Read_Disk_Blk;
             }
 
+            ReadFileInfo->ReadLength += ExtentLength;
+            break;
+          case ReadFileGetExtents:
+            Status = AddFileExtent (
+                       ReadFileInfo->ExtentCache,
+                       ReadFileInfo->ReadLength,
+                       MultU64x32 (Lsn, LogicalBlockSize),
+                       ExtentLength
+                       );
+            if (EFI_ERROR (Status)) {
+              goto Done;
+            }
+
             ReadFileInfo->ReadLength += ExtentLength;
             break;
           case ReadFileSeekAndRead:
@@ -1757,13 +1843,14 @@ FindFileEntry (
   //
   // Read extent.
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 (Lsn, LogicalBlockSize),
-                     Volume->FileEntrySize,
-                     ReadBuffer
-                     );
+  Status = ReadVolumeMetadata (
+             BlockIo,
+             DiskIo,
+             Volume,
+             MultU64x32 (Lsn, LogicalBlockSize),
+             Volume->FileEntrySize,
+             ReadBuffer
+             );
   if (EFI_ERROR (Status)) {
     goto Error_Read_Disk_Blk;
   }
@@ -2848,9 +2935,236 @@ Out_Free:
   return Status;
 }
 
+/**
+  Read metadata of an UDF volume, through the metadata cache of the volume.
+
+  File entries, allocation extent descriptors and directory data are read
+  again each time a path is resolved. The cache keeps the most recently used
+  ones, up to UDF_METADATA_CACHE_MAX_SIZE bytes each.
+
+  @param[in]   BlockIo   BlockIo interface.
+  @param[in]   DiskIo    DiskIo interface.
+  @param[in]   Volume    UDF volume information structure.
+  @param[in]   Offset    The starting byte offset on the disk to read from.
+  @param[in]   Size      The size in bytes to read.
+  @param[out]  Buffer    The buffer to read the metadata into.
+
+  @retval EFI_SUCCESS          The metadata was read.
+  @retval EFI_NO_MEDIA         The device has no media.
+  @retval EFI_DEVICE_ERROR     The device reported an error.
+
+**/
+EFI_STATUS
+ReadVolumeMetadata (
+  IN   EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN   UDF_VOLUME_INFO        *Volume,
+  IN   UINT64                 Offset,
+  IN   UINTN                  Size,
+  OUT  VOID                   *Buffer
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    MediaId;
+  UINTN                     Index;
+  UDF_METADATA_CACHE_ENTRY  *Entry;
+  UDF_METADATA_CACHE_ENTRY  *Victim;
+
+  MediaId = BlockIo->Media->MediaId;
+  if (MediaId != Volume->MetadataCacheMediaId) {
+    FreeMetadataCache (Volume);
+    Volume->MetadataCacheMediaId = MediaId;
+  }
+
+  Victim = &Volume->MetadataCache[0];
+  for (Index = 0; Index < UDF_METADATA_CACHE_COUNT; Index++) {
+    Entry = &Volume->MetadataCache[Index];
+    if ((Entry->Data != NULL) && (Entry->Offset == Offset) && (Entry->Size == Size)) {
+      Entry->LastAccess = ++Volume->MetadataCacheAccess;
+      CopyMem (Buffer, Entry->Data, Size);
+      return EFI_SUCCESS;
+    }
+
+    if (Entry->LastAccess < Victim->LastAccess) {
+      Victim = Entry;
+    }
+  }
+
+  Status = DiskIo->ReadDisk (DiskIo, MediaId, Offset, Size, Buffer);
+  if (EFI_ERROR (Status) || (Size > UDF_METADATA_CACHE_MAX_SIZE)) {
+    return Status;
+  }
+
+  //
+  // Replace the least recently used entry. The metadata was read anyway, so
+  // failing to cache it is not an error.
+  //
+  if ((Victim->Data != NULL) && (Victim->Size != Size)) {
+    FreePool (Victim->Data);
+    Victim->Data = NULL;
+  }
+
+  if (Victim->Data == NULL) {
+    Victim->Data = AllocatePool (Size);
+    if (Victim->Data == NULL) {
+      Victim->LastAccess = 0;
+      return EFI_SUCCESS;
+    }
+  }
+
+  CopyMem (Victim->Data, Buffer, Size);
+  Victim->Offset     = Offset;
+  Victim->Size       = Size;
+  Victim->LastAccess = ++Volume->MetadataCacheAccess;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the metadata cache of an UDF volume.
+
+  @param[in]   Volume    UDF volume information structure.
+
+**/
+VOID
+FreeMetadataCache (
+  IN   UDF_VOLUME_INFO  *Volume
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < UDF_METADATA_CACHE_COUNT; Index++) {
+    if (Volume->MetadataCache[Index].Data != NULL) {
+      FreePool (Volume->MetadataCache[Index].Data);
+    }
+  }
+
+  ZeroMem ((VOID *)Volume->MetadataCache, sizeof (Volume->MetadataCache));
+}
+
+/**
+  Free the extent cache of a file.
+
+  @param[in, out] ExtentCache   The extent cache of the file.
+
+**/
+VOID
+FreeFileExtentCache (
+  IN OUT  UDF_FILE_EXTENT_CACHE  *ExtentCache
+  )
+{
+  if (ExtentCache->Extents != NULL) {
+    FreePool ((VOID *)ExtentCache->Extents);
+  }
+
+  ZeroMem ((VOID *)ExtentCache, sizeof (UDF_FILE_EXTENT_CACHE));
+}
+
+/**
+  Seek a file and read its data into memory through its resolved extents.
+
+  Each run of the read which is contiguous on the disk is read with a single
+  DiskIo request.
+
+  @param[in]      BlockIo       BlockIo interface.
+  @param[in]      DiskIo        DiskIo interface.
+  @param[in]      ExtentCache   The extent cache of the file.
+  @param[in]      FileSize      Size of the file.
+  @param[in, out] FilePosition  File position.
+  @param[in, out] Buffer        File data.
+  @param[in, out] BufferSize    Read size.
+
+  @retval EFI_SUCCESS          File seeked and read.
+  @retval EFI_NO_MEDIA         The device has no media.
+  @retval EFI_DEVICE_ERROR     The device reported an error.
+
+**/
+EFI_STATUS
+ReadFileExtents (
+  IN      EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN      EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN      UDF_FILE_EXTENT_CACHE  *ExtentCache,
+  IN      UINT64                 FileSize,
+  IN OUT  UINT64                 *FilePosition,
+  IN OUT  VOID                   *Buffer,
+  IN OUT  UINT64                 *BufferSize
+  )
+{
+  EFI_STATUS       Status;
+  UDF_FILE_EXTENT  *Extent;
+  UINTN            Low;
+  UINTN            High;
+  UINTN            Middle;
+  UINT64           Position;
+  UINT64           BytesLeft;
+  UINT64           Offset;
+  UINT64           DataLength;
+  UINT8            *Data;
+
+  if (*BufferSize > FileSize - *FilePosition) {
+    //
+    // About to read beyond the EOF -- truncate it.
+    //
+    *BufferSize = FileSize - *FilePosition;
+  }
+
+  Position  = *FilePosition;
+  BytesLeft = *BufferSize;
+  Data      = Buffer;
+
+  //
+  // Find the extent which holds the file position.
+  //
+  Low  = 0;
+  High = ExtentCache->ExtentCount - 1;
+  while (Low < High) {
+    Middle = (Low + High + 1) / 2;
+    if (ExtentCache->Extents[Middle].FileOffset <= Position) {
+      Low = Middle;
+    } else {
+      High = Middle - 1;
+    }
+  }
+
+  for (Extent = &ExtentCache->Extents[Low];
+       (BytesLeft > 0) && (Extent < &ExtentCache->Extents[ExtentCache->ExtentCount]);
+       Extent++)
+  {
+    if ((Position < Extent->FileOffset) ||
+        (Position >= Extent->FileOffset + Extent->Length))
+    {
+      break;
+    }
+
+    Offset     = Position - Extent->FileOffset;
+    DataLength = MIN (Extent->Length - Offset, BytesLeft);
+    Status     = DiskIo->ReadDisk (
+                           DiskIo,
+                           BlockIo->Media->MediaId,
+                           Extent->DiskOffset + Offset,
+                           (UINTN)DataLength,
+                           Data
+                           );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Data      += DataLength;
+    Position  += DataLength;
+    BytesLeft -= DataLength;
+  }
+
+  *FilePosition = Position;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Seek a file and read its data into memory on an UDF volume.
 
+  The extents of the file are resolved on its first read, the next reads
+  don't walk the allocation descriptors of the file again.
+
   @param[in]      BlockIo       BlockIo interface.
   @param[in]      DiskIo        DiskIo interface.
   @param[in]      Volume        UDF volume information structure.
@@ -2859,6 +3173,7 @@ Out_Free:
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
+  @param[in, out] ExtentCache   The extent cache of the file.
 
   @retval EFI_SUCCESS          File seeked and read.
   @retval EFI_UNSUPPORTED      Extended Allocation Descriptors not supported.
@@ -2878,12 +3193,47 @@ ReadFileData (
   IN      UINT64                 FileSize,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
-  IN OUT  UINT64                 *BufferSize
+  IN OUT  UINT64                 *BufferSize,
+  IN OUT  UDF_FILE_EXTENT_CACHE  *ExtentCache
   )
 {
   EFI_STATUS          Status;
   UDF_READ_FILE_INFO  ReadFileInfo;
 
+  if (!ExtentCache->Valid) {
+    ReadFileInfo.Flags       = ReadFileGetExtents;
+    ReadFileInfo.ExtentCache = ExtentCache;
+
+    Status = ReadFile (
+               BlockIo,
+               DiskIo,
+               Volume,
+               &File->FileIdentifierDesc->Icb,
+               File->FileEntry,
+               &ReadFileInfo
+               );
+    if (EFI_ERROR (Status)) {
+      //
+      // Fall back to walking the allocation descriptors on each read.
+      //
+      FreeFileExtentCache (ExtentCache);
+    } else {
+      ExtentCache->Valid = TRUE;
+    }
+  }
+
+  if (ExtentCache->ExtentCount != 0) {
+    return ReadFileExtents (
+             BlockIo,
+             DiskIo,
+             ExtentCache,
+             FileSize,
+             FilePosition,
+             Buffer,
+             BufferSize
+             );
+  }
+
   ReadFileInfo.Flags        = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition = *FilePosition;
   ReadFileInfo.FileData     = Buffer;
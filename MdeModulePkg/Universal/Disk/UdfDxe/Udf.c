@@ -273,6 +273,7 @@ UdfDriverBindingStop (
                     NULL
                     );
 
+    FreeMetadataCache (&PrivFsData->Volume);
     FreePool ((VOID *)PrivFsData);
   }
 
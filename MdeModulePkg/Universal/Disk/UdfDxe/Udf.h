@@ -134,17 +134,55 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtents,
 } UDF_READ_FILE_FLAGS;
 
+//
+// A run of a file's data which is contiguous on the disk
+//
+typedef struct {
+  UINT64    FileOffset;
+  UINT64    DiskOffset;
+  UINT64    Length;
+} UDF_FILE_EXTENT;
+
+//
+// The extents of a file, resolved from its allocation descriptors on the
+// first read of the file
+//
+#define UDF_FILE_EXTENT_CACHE_MIN_COUNT  16
+
+typedef struct {
+  BOOLEAN            Valid;
+  UDF_FILE_EXTENT    *Extents;
+  UINTN              ExtentCount;
+  UINTN              MaxExtentCount;
+} UDF_FILE_EXTENT_CACHE;
+
 typedef struct {
-  VOID                   *FileData;
-  UDF_READ_FILE_FLAGS    Flags;
-  UINT64                 FileDataSize;
-  UINT64                 FilePosition;
-  UINT64                 FileSize;
-  UINT64                 ReadLength;
+  VOID                     *FileData;
+  UDF_READ_FILE_FLAGS      Flags;
+  UINT64                   FileDataSize;
+  UINT64                   FilePosition;
+  UINT64                   FileSize;
+  UINT64                   ReadLength;
+  UDF_FILE_EXTENT_CACHE    *ExtentCache;
 } UDF_READ_FILE_INFO;
 
+//
+// Number and maximum size of the metadata reads (FE/EFE, AED and
+// directory data) cached per volume
+//
+#define UDF_METADATA_CACHE_COUNT     16
+#define UDF_METADATA_CACHE_MAX_SIZE  SIZE_64KB
+
+typedef struct {
+  UINT64    Offset;
+  UINTN     Size;
+  UINTN     LastAccess;
+  VOID      *Data;
+} UDF_METADATA_CACHE_ENTRY;
+
 #pragma pack(1)
 
 typedef struct {
@@ -318,6 +356,9 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR         PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR          FileSetDesc;
   UINTN                            FileEntrySize;
+  UINT32                           MetadataCacheMediaId;
+  UINTN                            MetadataCacheAccess;
+  UDF_METADATA_CACHE_ENTRY         MetadataCache[UDF_METADATA_CACHE_COUNT];
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -353,6 +394,7 @@ typedef struct {
   CHAR16                             FileName[UDF_FILENAME_LENGTH];
   UINT64                             FileSize;
   UINT64                             FilePosition;
+  UDF_FILE_EXTENT_CACHE              ExtentCache;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE  SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -965,6 +1007,7 @@ GetVolumeSize (
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
+  @param[in, out] ExtentCache   The extent cache of the file.
 
   @retval EFI_SUCCESS          File seeked and read.
   @retval EFI_UNSUPPORTED      Extended Allocation Descriptors not supported.
@@ -984,7 +1027,55 @@ ReadFileData (
   IN      UINT64                 FileSize,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
-  IN OUT  UINT64                 *BufferSize
+  IN OUT  UINT64                 *BufferSize,
+  IN OUT  UDF_FILE_EXTENT_CACHE  *ExtentCache
+  );
+
+/**
+  Free the extent cache of a file.
+
+  @param[in, out] ExtentCache   The extent cache of the file.
+
+**/
+VOID
+FreeFileExtentCache (
+  IN OUT  UDF_FILE_EXTENT_CACHE  *ExtentCache
+  );
+
+/**
+  Read metadata of an UDF volume, through the metadata cache of the volume.
+
+  @param[in]   BlockIo   BlockIo interface.
+  @param[in]   DiskIo    DiskIo interface.
+  @param[in]   Volume    UDF volume information structure.
+  @param[in]   Offset    The starting byte offset on the disk to read from.
+  @param[in]   Size      The size in bytes to read.
+  @param[out]  Buffer    The buffer to read the metadata into.
+
+  @retval EFI_SUCCESS          The metadata was read.
+  @retval EFI_NO_MEDIA         The device has no media.
+  @retval EFI_DEVICE_ERROR     The device reported an error.
+
+**/
+EFI_STATUS
+ReadVolumeMetadata (
+  IN   EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN   UDF_VOLUME_INFO        *Volume,
+  IN   UINT64                 Offset,
+  IN   UINTN                  Size,
+  OUT  VOID                   *Buffer
+  );
+
+/**
+  Free the metadata cache of an UDF volume.
+
+  @param[in]   Volume    UDF volume information structure.
+
+**/
+VOID
+FreeMetadataCache (
+  IN   UDF_VOLUME_INFO  *Volume
   );
 
 /**
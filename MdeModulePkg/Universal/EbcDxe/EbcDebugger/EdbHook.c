@@ -478,6 +478,25 @@ EbcDebuggerHookUnload (
   return;
 }
 
+/**
+
+  The hook in EbcExecute, which decides whether the decoded form of the EBC
+  instructions may be kept in a cache.
+
+  The debugger replaces instructions with BREAK instructions to set
+  breakpoints, so every instruction is decoded when it is executed.
+
+  @retval FALSE           Every instruction must be decoded when it is executed.
+
+**/
+BOOLEAN
+EbcDebuggerHookDecodeCacheSupported (
+  VOID
+  )
+{
+  return FALSE;
+}
+
 /**
 
   The hook in EbcUnloadImage.
@@ -10,6 +10,8 @@
 
 **/
 
+#include <Library/PcdLib.h>
+
 #include "EbcDebuggerHook.h"
 
 /**
@@ -29,6 +31,23 @@ EbcDebuggerHookInit (
   return;
 }
 
+/**
+
+  The hook in EbcExecute, which decides whether the decoded form of the EBC
+  instructions may be kept in a cache.
+
+  @retval TRUE            The decoded instructions may be cached.
+  @retval FALSE           Every instruction must be decoded when it is executed.
+
+**/
+BOOLEAN
+EbcDebuggerHookDecodeCacheSupported (
+  VOID
+  )
+{
+  return FeaturePcdGet (PcdEbcDecodeCache);
+}
+
 /**
 
 The hook in UnloadImage for EBC Interpreter.
@@ -46,6 +46,20 @@ EbcDebuggerHookInit (
   IN EFI_DEBUG_SUPPORT_PROTOCOL  *EbcDebugProtocol
   );
 
+/**
+
+  The hook in EbcExecute, which decides whether the decoded form of the EBC
+  instructions may be kept in a cache.
+
+  @retval TRUE            The decoded instructions may be cached.
+  @retval FALSE           Every instruction must be decoded when it is executed.
+
+**/
+BOOLEAN
+EbcDebuggerHookDecodeCacheSupported (
+  VOID
+  );
+
 /**
 
 The hook in UnloadImage for EBC Interpreter.
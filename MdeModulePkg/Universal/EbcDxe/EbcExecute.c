@@ -37,6 +37,30 @@ UINT64
   IN UINT64      Op2
   );
 
+typedef struct _EBC_DECODED_INSTRUCTION EBC_DECODED_INSTRUCTION;
+
+typedef
+EFI_STATUS
+(*DECODED_EXEC_FUNCTION) (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  );
+
+//
+// The decoded form of an instruction. The operands of the data manipulation
+// and compare instructions, and the offset of the JMP8 instruction, are
+// decoded once and kept in the decode cache.
+//
+struct _EBC_DECODED_INSTRUCTION {
+  VMIP                     Ip;              // address of the instruction, NULL if the entry is free
+  DECODED_EXEC_FUNCTION    ExecuteFunction; // NULL if the instruction has no decoded form
+  INT16                    Index16;         // Index16 or Immed16 of operand 2, or JMP8 offset
+  UINT8                    Opcode;
+  UINT8                    Operands;
+  UINT8                    Size;
+  BOOLEAN                  IsSignedOp;
+};
+
 /**
   Decode a 16-bit index to determine the offset. Given an index value:
 
@@ -445,6 +469,54 @@ ExecuteDataManip (
   IN BOOLEAN     IsSignedOp
   );
 
+/**
+  Execute a decoded EBC data manipulation instruction. This function fetches
+  the operands, dispatches to the appropriate subfunction, then writes back
+  the returned result.
+
+  @param  VmPtr             A pointer to VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_UNSUPPORTED   The opcodes/operands is not supported.
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedDataManip (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  );
+
+/**
+  Execute a decoded EBC CMP instruction.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedCMP (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  );
+
+/**
+  Execute a decoded EBC JMP8 instruction.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedJMP8 (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  );
+
 //
 // Functions that execute VM opcodes
 //
@@ -1341,6 +1413,17 @@ CONST VM_TABLE_ENTRY  mVmOpcodeTable[] = {
 //
 CONST UINT8  mJMPLen[] = { 2, 2, 6, 10 };
 
+//
+// The number of entries of the decode cache. It must be a power of 2.
+//
+#define EBC_DECODE_CACHE_SIZE  512
+
+//
+// The decoded instructions, indexed by their address. EBC instructions are
+// at least two bytes long, so bit 0 of the address is not used for the index.
+//
+EBC_DECODED_INSTRUCTION  mEbcDecodeCache[EBC_DECODE_CACHE_SIZE];
+
 /**
   Given a pointer to a new VM context, execute one or more instructions. This
   function is only used for test purposes via the EBC VM test protocol.
@@ -1405,6 +1488,157 @@ EbcExecuteInstructions (
   return Status;
 }
 
+/**
+  Decode the instruction at the IP of a VM context.
+
+  Only the data manipulation, compare and JMP8 instructions have a decoded
+  form. Instructions whose immediate data is not aligned are left to the
+  interpreter as well, so that it reports the alignment exception each time.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       Returns the decoded instruction. Its
+                            ExecuteFunction is NULL if the instruction has no
+                            decoded form.
+
+**/
+VOID
+EbcDecodeInstruction (
+  IN  VM_CONTEXT               *VmPtr,
+  OUT EBC_DECODED_INSTRUCTION  *Instruction
+  )
+{
+  UINT8  Opcode;
+  UINT8  Operands;
+
+  Opcode   = GETOPCODE (VmPtr);
+  Operands = GETOPERANDS (VmPtr);
+
+  Instruction->Ip              = VmPtr->Ip;
+  Instruction->ExecuteFunction = NULL;
+  Instruction->Index16         = 0;
+  Instruction->Opcode          = Opcode;
+  Instruction->Operands        = Operands;
+  Instruction->Size            = 2;
+  Instruction->IsSignedOp      = FALSE;
+
+  if ((Opcode & OPCODE_M_OPCODE) == OPCODE_JMP8) {
+    Instruction->Index16         = VmReadImmed8 (VmPtr, 1);
+    Instruction->ExecuteFunction = ExecuteDecodedJMP8;
+    return;
+  }
+
+  if (((Opcode & OPCODE_M_OPCODE) < OPCODE_CMPEQ) ||
+      ((Opcode & OPCODE_M_OPCODE) > OPCODE_EXTNDD))
+  {
+    return;
+  }
+
+  //
+  // CMP and the data manipulation instructions share the same format.
+  //
+  if ((Opcode & DATAMANIP_M_IMMDATA) != 0) {
+    if (!ADDRESS_IS_ALIGNED ((UINTN)VmPtr->Ip + 2, sizeof (UINT16))) {
+      return;
+    }
+
+    if (OPERAND2_INDIRECT (Operands)) {
+      Instruction->Index16 = VmReadIndex16 (VmPtr, 2);
+    } else {
+      Instruction->Index16 = VmReadImmed16 (VmPtr, 2);
+    }
+
+    Instruction->Size = 4;
+  }
+
+  if ((Opcode & OPCODE_M_OPCODE) <= OPCODE_CMPUGTE) {
+    Instruction->ExecuteFunction = ExecuteDecodedCMP;
+  } else {
+    Instruction->IsSignedOp      = (BOOLEAN)(mVmOpcodeTable[Opcode & OPCODE_M_OPCODE].ExecuteFunction == ExecuteSignedDataManip);
+    Instruction->ExecuteFunction = ExecuteDecodedDataManip;
+  }
+}
+
+/**
+  Get the decoded form of the instruction at the IP of a VM context, from the
+  decode cache if it is there, otherwise by decoding the instruction and
+  adding it to the decode cache.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       Returns the decoded instruction.
+
+  @retval TRUE              Instruction is the decoded form of the instruction.
+  @retval FALSE             The instruction has no decoded form.
+
+**/
+BOOLEAN
+EbcGetDecodedInstruction (
+  IN  VM_CONTEXT               *VmPtr,
+  OUT EBC_DECODED_INSTRUCTION  *Instruction
+  )
+{
+  EBC_DECODED_INSTRUCTION  *Entry;
+  EFI_TPL                  OldTpl;
+
+  Entry = &mEbcDecodeCache[((UINTN)VmPtr->Ip >> 1) & (EBC_DECODE_CACHE_SIZE - 1)];
+
+  //
+  // EBC code that runs in an event notification function may replace the
+  // entry while it is copied, so the copy is only used if the entry still
+  // belongs to the instruction afterwards.
+  //
+  if (Entry->Ip == VmPtr->Ip) {
+    Instruction->ExecuteFunction = Entry->ExecuteFunction;
+    Instruction->Index16         = Entry->Index16;
+    Instruction->Opcode          = Entry->Opcode;
+    Instruction->Operands        = Entry->Operands;
+    Instruction->Size            = Entry->Size;
+    Instruction->IsSignedOp      = Entry->IsSignedOp;
+    MemoryFence ();
+    if (Entry->Ip == VmPtr->Ip) {
+      Instruction->Ip = VmPtr->Ip;
+      return (BOOLEAN)(Instruction->ExecuteFunction != NULL);
+    }
+  }
+
+  EbcDecodeInstruction (VmPtr, Instruction);
+
+  //
+  // Instructions without a decoded form are cached as well, so they are not
+  // decoded again.
+  //
+  OldTpl    = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  Entry->Ip = NULL;
+  MemoryFence ();
+  Entry->ExecuteFunction = Instruction->ExecuteFunction;
+  Entry->Index16         = Instruction->Index16;
+  Entry->Opcode          = Instruction->Opcode;
+  Entry->Operands        = Instruction->Operands;
+  Entry->Size            = Instruction->Size;
+  Entry->IsSignedOp      = Instruction->IsSignedOp;
+  MemoryFence ();
+  Entry->Ip = Instruction->Ip;
+  gBS->RestoreTPL (OldTpl);
+
+  return (BOOLEAN)(Instruction->ExecuteFunction != NULL);
+}
+
+/**
+  Discard the decoded instructions that EbcExecute () has kept, because the
+  code they were decoded from is going away.
+
+**/
+VOID
+EbcFlushDecodeCache (
+  VOID
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  ZeroMem (mEbcDecodeCache, sizeof (mEbcDecodeCache));
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Execute an EBC image from an entry point or from a published protocol.
 
@@ -1423,6 +1657,9 @@ EbcExecute (
   UINT8                             StackCorrupted;
   EFI_STATUS                        Status;
   EFI_EBC_SIMPLE_DEBUGGER_PROTOCOL  *EbcSimpleDebugger;
+  BOOLEAN                           UseDecodeCache;
+  BOOLEAN                           IsDecoded;
+  EBC_DECODED_INSTRUCTION           Instruction;
 
   mVmPtr            = VmPtr;
   EbcSimpleDebugger = NULL;
@@ -1453,6 +1690,12 @@ EbcExecute (
 
   DEBUG_CODE_END ();
 
+  //
+  // A simple debugger may change the code or the IP between instructions, so
+  // decode every instruction when it is executed while one is attached.
+  //
+  UseDecodeCache = (BOOLEAN)(EbcSimpleDebugger == NULL && EbcDebuggerHookDecodeCacheSupported ());
+
   //
   // Save the start IP for debug. For example, if we take an exception we
   // can print out the location of the exception relative to the entry point,
@@ -1477,14 +1720,18 @@ EbcExecute (
     DEBUG_CODE_END ();
 
     //
-    // Use the opcode bits to index into the opcode dispatch table. If the
-    // function pointer is null then generate an exception.
+    // Execute the decoded form of the instruction if it has one. Otherwise use
+    // the opcode bits to index into the opcode dispatch table. If the function
+    // pointer is null then generate an exception.
     //
-    ExecFunc = (UINTN)mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction;
-    if (ExecFunc == (UINTN)NULL) {
-      EbcDebugSignalException (EXCEPT_EBC_INVALID_OPCODE, EXCEPTION_FLAG_FATAL, VmPtr);
-      Status = EFI_UNSUPPORTED;
-      goto Done;
+    IsDecoded = (BOOLEAN)(UseDecodeCache && EbcGetDecodedInstruction (VmPtr, &Instruction));
+    if (!IsDecoded) {
+      ExecFunc = (UINTN)mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction;
+      if (ExecFunc == (UINTN)NULL) {
+        EbcDebugSignalException (EXCEPT_EBC_INVALID_OPCODE, EXCEPTION_FLAG_FATAL, VmPtr);
+        Status = EFI_UNSUPPORTED;
+        goto Done;
+      }
     }
 
     EbcDebuggerHookExecuteStart (VmPtr);
@@ -1495,7 +1742,11 @@ EbcExecute (
     //
     MemoryFence ();
 
-    mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+    if (IsDecoded) {
+      Instruction.ExecuteFunction (VmPtr, &Instruction);
+    } else {
+      mVmOpcodeTable[(*VmPtr->Ip & OPCODE_M_OPCODE)].ExecuteFunction (VmPtr);
+    }
 
     MemoryFence ();
 
@@ -2174,6 +2425,39 @@ ExecuteJMP8 (
   return EFI_SUCCESS;
 }
 
+/**
+  Execute a decoded EBC JMP8 instruction.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedJMP8 (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  )
+{
+  EbcDebuggerHookJMP8Start (VmPtr);
+
+  //
+  // Jump unless the condition has not been met. The offset is relative to the
+  // following instruction, and divided by 2.
+  //
+  if (((Instruction->Opcode & CONDITION_M_CONDITIONAL) != 0) &&
+      ((UINT8)(((Instruction->Opcode & JMP_M_CS) != 0) ? 1 : 0) != (UINT8)VMFLAG_ISSET (VmPtr, VMFLAGS_CC)))
+  {
+    VmPtr->Ip += 2;
+  } else {
+    VmPtr->Ip += (Instruction->Index16 * 2) + 2;
+  }
+
+  EbcDebuggerHookJMP8End (VmPtr);
+  return EFI_SUCCESS;
+}
+
 /**
   Execute the EBC MOVI.
 
@@ -3197,39 +3481,65 @@ ExecuteCMP (
   IN VM_CONTEXT  *VmPtr
   )
 {
-  UINT8   Opcode;
-  UINT8   Operands;
-  UINT8   Size;
-  INT16   Index16;
-  UINT32  Flag;
-  INT64   Op2;
-  INT64   Op1;
+  EBC_DECODED_INSTRUCTION  Instruction;
 
   //
   // Get opcode and operands
   //
-  Opcode   = GETOPCODE (VmPtr);
-  Operands = GETOPERANDS (VmPtr);
-  //
-  // Get the register data we're going to compare to
-  //
-  Op1 = VmPtr->Gpr[OPERAND1_REGNUM (Operands)];
+  Instruction.Opcode   = GETOPCODE (VmPtr);
+  Instruction.Operands = GETOPERANDS (VmPtr);
   //
   // Get immediate data
   //
-  if ((Opcode & OPCODE_M_IMMDATA) != 0) {
-    if (OPERAND2_INDIRECT (Operands)) {
-      Index16 = VmReadIndex16 (VmPtr, 2);
+  if ((Instruction.Opcode & OPCODE_M_IMMDATA) != 0) {
+    if (OPERAND2_INDIRECT (Instruction.Operands)) {
+      Instruction.Index16 = VmReadIndex16 (VmPtr, 2);
     } else {
-      Index16 = VmReadImmed16 (VmPtr, 2);
+      Instruction.Index16 = VmReadImmed16 (VmPtr, 2);
     }
 
-    Size = 4;
+    Instruction.Size = 4;
   } else {
-    Index16 = 0;
-    Size    = 2;
+    Instruction.Index16 = 0;
+    Instruction.Size    = 2;
   }
 
+  return ExecuteDecodedCMP (VmPtr, &Instruction);
+}
+
+/**
+  Execute a decoded EBC CMP instruction.
+
+  @param  VmPtr             A pointer to a VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedCMP (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  )
+{
+  UINT8   Opcode;
+  UINT8   Operands;
+  UINT8   Size;
+  INT16   Index16;
+  UINT32  Flag;
+  INT64   Op2;
+  INT64   Op1;
+
+  Opcode   = Instruction->Opcode;
+  Operands = Instruction->Operands;
+  Index16  = Instruction->Index16;
+  Size     = Instruction->Size;
+
+  //
+  // Get the register data we're going to compare to
+  //
+  Op1 = VmPtr->Gpr[OPERAND1_REGNUM (Operands)];
+
   //
   // Now get Op2
   //
@@ -4199,39 +4509,70 @@ ExecuteDataManip (
   IN BOOLEAN     IsSignedOp
   )
 {
-  UINT8   Opcode;
-  INT16   Index16;
-  UINT8   Operands;
-  UINT8   Size;
-  UINT64  Op1;
-  UINT64  Op2;
-  INTN    DataManipDispatchTableIndex;
+  EBC_DECODED_INSTRUCTION  Instruction;
 
   //
   // Get opcode and operands
   //
-  Opcode   = GETOPCODE (VmPtr);
-  Operands = GETOPERANDS (VmPtr);
+  Instruction.Opcode     = GETOPCODE (VmPtr);
+  Instruction.Operands   = GETOPERANDS (VmPtr);
+  Instruction.IsSignedOp = IsSignedOp;
 
   //
   // Determine if we have immediate data by the opcode
   //
-  if ((Opcode & DATAMANIP_M_IMMDATA) != 0) {
+  if ((Instruction.Opcode & DATAMANIP_M_IMMDATA) != 0) {
     //
     // Index16 if Ry is indirect, or Immed16 if Ry direct.
     //
-    if (OPERAND2_INDIRECT (Operands)) {
-      Index16 = VmReadIndex16 (VmPtr, 2);
+    if (OPERAND2_INDIRECT (Instruction.Operands)) {
+      Instruction.Index16 = VmReadIndex16 (VmPtr, 2);
     } else {
-      Index16 = VmReadImmed16 (VmPtr, 2);
+      Instruction.Index16 = VmReadImmed16 (VmPtr, 2);
     }
 
-    Size = 4;
+    Instruction.Size = 4;
   } else {
-    Index16 = 0;
-    Size    = 2;
+    Instruction.Index16 = 0;
+    Instruction.Size    = 2;
   }
 
+  return ExecuteDecodedDataManip (VmPtr, &Instruction);
+}
+
+/**
+  Execute a decoded EBC data manipulation instruction. This function fetches
+  the operands, dispatches to the appropriate subfunction, then writes back
+  the returned result.
+
+  @param  VmPtr             A pointer to VM context.
+  @param  Instruction       The decoded instruction.
+
+  @retval EFI_UNSUPPORTED   The opcodes/operands is not supported.
+  @retval EFI_SUCCESS       The instruction is executed successfully.
+
+**/
+EFI_STATUS
+ExecuteDecodedDataManip (
+  IN VM_CONTEXT                     *VmPtr,
+  IN CONST EBC_DECODED_INSTRUCTION  *Instruction
+  )
+{
+  UINT8    Opcode;
+  INT16    Index16;
+  UINT8    Operands;
+  UINT8    Size;
+  BOOLEAN  IsSignedOp;
+  UINT64   Op1;
+  UINT64   Op2;
+  INTN     DataManipDispatchTableIndex;
+
+  Opcode     = Instruction->Opcode;
+  Operands   = Instruction->Operands;
+  Index16    = Instruction->Index16;
+  Size       = Instruction->Size;
+  IsSignedOp = Instruction->IsSignedOp;
+
   //
   // Now get operand2 (source). It's of format {@}R2 {Index16|Immed16}
   //
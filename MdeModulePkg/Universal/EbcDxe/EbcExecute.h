@@ -35,6 +35,16 @@ EbcExecute (
   IN VM_CONTEXT  *VmPtr
   );
 
+/**
+  Discard the decoded instructions that EbcExecute () has kept, because the
+  code they were decoded from is going away.
+
+**/
+VOID
+EbcFlushDecodeCache (
+  VOID
+  );
+
 /**
   Returns the version of the EBC virtual machine.
 
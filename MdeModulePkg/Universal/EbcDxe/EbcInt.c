@@ -1217,6 +1217,11 @@ EbcUnloadImage (
   //
   FreePool (ImageList);
 
+  //
+  // Another image may be loaded where this image was.
+  //
+  EbcFlushDecodeCache ();
+
   EbcDebuggerHookEbcUnloadImage (ImageHandle);
 
   return EFI_SUCCESS;
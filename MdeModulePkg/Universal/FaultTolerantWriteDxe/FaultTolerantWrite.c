@@ -597,6 +597,7 @@ FtwWrite (
 
   //
   // Restore spare backup buffer into spare block , if no failure happened during FtwWrite.
+  // An erased spare block, the usual case, only needs to be erased again.
   //
   Status = FtwEraseSpareBlock (FtwDevice);
   if (EFI_ERROR (Status)) {
@@ -604,22 +605,24 @@ FtwWrite (
     return EFI_ABORTED;
   }
 
-  Ptr = SpareBuffer;
-  for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
-    MyLength = FtwDevice->SpareBlockSize;
-    Status   = FtwDevice->FtwBackupFvb->Write (
-                                          FtwDevice->FtwBackupFvb,
-                                          FtwDevice->FtwSpareLba + Index,
-                                          0,
-                                          &MyLength,
-                                          Ptr
-                                          );
-    if (EFI_ERROR (Status)) {
-      FreePool (SpareBuffer);
-      return EFI_ABORTED;
-    }
+  if (!IsErasedFlashBuffer (SpareBuffer, SpareBufferSize)) {
+    Ptr = SpareBuffer;
+    for (Index = 0; Index < FtwDevice->NumberOfSpareBlock; Index += 1) {
+      MyLength = FtwDevice->SpareBlockSize;
+      Status   = FtwDevice->FtwBackupFvb->Write (
+                                            FtwDevice->FtwBackupFvb,
+                                            FtwDevice->FtwSpareLba + Index,
+                                            0,
+                                            &MyLength,
+                                            Ptr
+                                            );
+      if (EFI_ERROR (Status)) {
+        FreePool (SpareBuffer);
+        return EFI_ABORTED;
+      }
 
-    Ptr += MyLength;
+      Ptr += MyLength;
+    }
   }
 
   //
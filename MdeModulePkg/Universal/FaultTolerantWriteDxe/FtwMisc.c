@@ -461,6 +461,10 @@ FlushSpareBlockToBootBlock (
   Spare block is accessed by FTW backup FVB protocol interface.
   Target block is accessed by FvBlock protocol interface.
 
+  Target blocks that already hold the content of the spare block are not
+  erased nor written, so a write whose range covers unchanged blocks, or a
+  write completed again after a reset, only updates the blocks that differ.
+
 
   @param FtwDevice       The private data of FTW driver
   @param FvBlock         FVB Protocol interface to access target block
@@ -486,6 +490,7 @@ FlushSpareBlockToTargetBlock (
   EFI_STATUS  Status;
   UINTN       Length;
   UINT8       *Buffer;
+  UINT8       *TargetBuffer;
   UINTN       Count;
   UINT8       *Ptr;
   UINTN       Index;
@@ -503,6 +508,12 @@ FlushSpareBlockToTargetBlock (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  TargetBuffer = AllocatePool (BlockSize);
+  if (TargetBuffer == NULL) {
+    FreePool (Buffer);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   //
   // Read all content of spare block to memory buffer
   //
@@ -518,6 +529,7 @@ FlushSpareBlockToTargetBlock (
                                         );
     if (EFI_ERROR (Status)) {
       FreePool (Buffer);
+      FreePool (TargetBuffer);
       return Status;
     }
 
@@ -525,24 +537,33 @@ FlushSpareBlockToTargetBlock (
   }
 
   //
-  // Erase the target block
-  //
-  Status = FtwEraseBlock (FtwDevice, FvBlock, Lba, NumberOfBlocks);
-  if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
-    return EFI_ABORTED;
-  }
-
-  //
-  // Write memory buffer to block, using the FvBlock protocol interface
+  // Erase and write the target blocks that differ from the spare block, using
+  // the FvBlock protocol interface. The spare block holds the new content of
+  // all of them until the write is recorded as complete.
   //
-  Ptr = Buffer;
+  Status = EFI_SUCCESS;
+  Ptr    = Buffer;
   for (Index = 0; Index < NumberOfBlocks; Index += 1) {
+    Count  = BlockSize;
+    Status = FvBlock->Read (FvBlock, Lba + Index, 0, &Count, TargetBuffer);
+    if (!EFI_ERROR (Status) && (Count == BlockSize) && (CompareMem (TargetBuffer, Ptr, BlockSize) == 0)) {
+      Ptr += BlockSize;
+      continue;
+    }
+
+    Status = FtwEraseBlock (FtwDevice, FvBlock, Lba + Index, 1);
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      FreePool (TargetBuffer);
+      return EFI_ABORTED;
+    }
+
     Count  = BlockSize;
     Status = FvBlock->Write (FvBlock, Lba + Index, 0, &Count, Ptr);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "Ftw: FVB Write block - %r\n", Status));
       FreePool (Buffer);
+      FreePool (TargetBuffer);
       return Status;
     }
 
@@ -550,6 +571,7 @@ FlushSpareBlockToTargetBlock (
   }
 
   FreePool (Buffer);
+  FreePool (TargetBuffer);
 
   return Status;
 }
@@ -402,6 +402,7 @@ OutputConfigBody (
   @param  AppendString           NULL-terminated Unicode string.
 
   @retval EFI_INVALID_PARAMETER  Any incoming parameter is invalid.
+  @retval EFI_OUT_OF_RESOURCES   The buffer of MultiString cannot be enlarged.
   @retval EFI_SUCCESS            AppendString is append to the end of MultiString
 
 **/
@@ -411,9 +412,11 @@ AppendToMultiString (
   IN EFI_STRING      AppendString
   )
 {
-  UINTN  AppendStringSize;
-  UINTN  MultiStringSize;
-  UINTN  MaxLen;
+  UINTN       AppendStringSize;
+  UINTN       MultiStringSize;
+  UINTN       NewStringSize;
+  UINTN       BufferSize;
+  EFI_STRING  NewString;
 
   if ((MultiString == NULL) || (*MultiString == NULL) || (AppendString == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -421,27 +424,41 @@ AppendToMultiString (
 
   AppendStringSize = StrSize (AppendString);
   MultiStringSize  = StrSize (*MultiString);
-  MaxLen           = MAX_STRING_LENGTH / sizeof (CHAR16);
+  NewStringSize    = MultiStringSize + AppendStringSize - sizeof (CHAR16);
 
   //
-  // Enlarge the buffer each time when length exceeds MAX_STRING_LENGTH.
+  // The buffer is MAX_STRING_LENGTH bytes at first and doubles each time the
+  // string outgrows it, so its size is the smallest power of two multiple of
+  // MAX_STRING_LENGTH that holds the string. A <MultiConfigAltResp> built from
+  // many appends is then not reallocated and copied on every append.
   //
-  if ((MultiStringSize + AppendStringSize > MAX_STRING_LENGTH) ||
-      (MultiStringSize > MAX_STRING_LENGTH))
-  {
-    *MultiString = (EFI_STRING)ReallocatePool (
-                                 MultiStringSize,
-                                 MultiStringSize + AppendStringSize,
-                                 (VOID *)(*MultiString)
-                                 );
-    MaxLen = (MultiStringSize + AppendStringSize) / sizeof (CHAR16);
-    ASSERT (*MultiString != NULL);
+  BufferSize = MAX_STRING_LENGTH;
+  while (BufferSize < MultiStringSize) {
+    BufferSize *= 2;
+  }
+
+  if (NewStringSize > BufferSize) {
+    while (BufferSize < NewStringSize) {
+      BufferSize *= 2;
+    }
+
+    NewString = (EFI_STRING)ReallocatePool (
+                              MultiStringSize,
+                              BufferSize,
+                              (VOID *)(*MultiString)
+                              );
+    ASSERT (NewString != NULL);
+    if (NewString == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    *MultiString = NewString;
   }
 
   //
   // Append the incoming string
   //
-  StrCatS (*MultiString, MaxLen, AppendString);
+  CopyMem ((UINT8 *)*MultiString + MultiStringSize - sizeof (CHAR16), AppendString, AppendStringSize);
 
   return EFI_SUCCESS;
 }
@@ -1536,6 +1536,7 @@ AdjustStringPackage (
       // Append a EFI_HII_SIBT_END block to the end.
       //
       *BlockPtr = EFI_HII_SIBT_END;
+      HiiStringIndexFree (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = StringBlock;
       StringPackage->StringPkgHdr->Header.Length += Skip2BlockSize;
@@ -1676,6 +1677,7 @@ RemoveStringPackages (
 
     RemoveEntryList (&Package->StringEntry);
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
+    HiiStringIndexFree (Package);
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
     //
@@ -1825,6 +1827,7 @@ InsertFontPackage (
   // Insert this font package to Font package array
   //
   InsertTailList (&PackageList->FontPkgHdr, &FontPackage->FontEntry);
+  HiiFlushGlyphCache ();
   *Package = FontPackage;
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
@@ -1988,6 +1991,7 @@ RemoveFontPackages (
     }
 
     RemoveEntryList (&Package->FontEntry);
+    HiiFlushGlyphCache ();
     PackageList->PackageListHdr.PackageLength -= Package->FontPkgHdr->Header.Length;
 
     if (Package->GlyphBlock != NULL) {
@@ -2365,6 +2369,7 @@ InsertSimpleFontPackage (
   // Insert to Simple Font package array
   //
   InsertTailList (&PackageList->SimpleFontPkgHdr, &SimpleFontPackage->SimpleFontEntry);
+  HiiFlushGlyphCache ();
   *Package = SimpleFontPackage;
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
@@ -2504,6 +2509,7 @@ RemoveSimpleFontPackages (
     }
 
     RemoveEntryList (&Package->SimpleFontEntry);
+    HiiFlushGlyphCache ();
     PackageList->PackageListHdr.PackageLength -= Package->SimpleFontPkgHdr->Header.Length;
     FreePool (Package->SimpleFontPkgHdr);
     FreePool (Package);
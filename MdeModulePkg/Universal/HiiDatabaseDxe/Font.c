@@ -31,6 +31,31 @@ EFI_GRAPHICS_OUTPUT_BLT_PIXEL  mHiiEfiColors[16] = {
   { 0xff, 0xff, 0xff, 0x00 },  // WHITE
 };
 
+//
+// Number of glyphs the glyph cache holds, a power of two.
+//
+#define HII_GLYPH_CACHE_SIZE  256
+
+//
+// A glyph of the glyph cache. Font is the font package of the glyph, or NULL
+// for the glyphs of the simplified font packages.
+//
+typedef struct {
+  HII_FONT_PACKAGE_INSTANCE    *Font;
+  CHAR16                       Char;
+  UINT8                        Attributes;
+  EFI_HII_GLYPH_INFO           Cell;
+  UINT8                        *GlyphBuffer;
+  UINTN                        GlyphBufferLen;
+} HII_GLYPH_CACHE_ENTRY;
+
+//
+// Glyphs already found in the font packages, so that drawing a string does not
+// search the font packages and decode the glyph blocks for every character.
+// The cache is direct-mapped, a glyph replaces the one in its slot.
+//
+HII_GLYPH_CACHE_ENTRY  mHiiGlyphCache[HII_GLYPH_CACHE_SIZE];
+
 /**
   Insert a character cell information to the list specified by GlyphInfoList.
 
@@ -128,33 +153,76 @@ GetCell (
 }
 
 /**
-  Convert the glyph for a single character into a bitmap.
+  Empty the glyph cache. It must be emptied whenever a font or a simplified
+  font package is added or removed.
+
+**/
+VOID
+HiiFlushGlyphCache (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < HII_GLYPH_CACHE_SIZE; Index++) {
+    if (mHiiGlyphCache[Index].GlyphBuffer != NULL) {
+      FreePool (mHiiGlyphCache[Index].GlyphBuffer);
+    }
+  }
+
+  ZeroMem (mHiiGlyphCache, sizeof (mHiiGlyphCache));
+}
+
+/**
+  Get the slot of a glyph in the glyph cache.
+
+  @param  Font                    Font package of the glyph, NULL for the
+                                  simplified font packages.
+  @param  Char                    Character of the glyph.
+
+  @return The slot of the glyph.
+
+**/
+STATIC
+HII_GLYPH_CACHE_ENTRY *
+GetGlyphCacheEntry (
+  IN HII_FONT_PACKAGE_INSTANCE  *Font,
+  IN CHAR16                     Char
+  )
+{
+  return &mHiiGlyphCache[(Char ^ ((UINTN)Font >> 4)) & (HII_GLYPH_CACHE_SIZE - 1)];
+}
+
+/**
+  Convert the glyph for a single character into a bitmap, from the font
+  packages.
 
   This is a internal function.
 
   @param  Private                 HII database driver private data.
   @param  Char                    Character to retrieve.
-  @param  StringInfo              Points to the string font and color information
-                                  or NULL  if the string should use the default
-                                  system font and color.
+  @param  FontPackage             The font package of the string font, or NULL
+                                  for the default system font.
   @param  GlyphBuffer             Buffer to store the retrieved bitmap data.
   @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
-  @param  Attributes              If not NULL, output the glyph attributes if any.
+  @param  Attributes              Output the glyph attributes.
+  @param  GlyphBufferLen          Output the length of GlyphBuffer.
 
   @retval EFI_SUCCESS             Glyph bitmap outputted.
   @retval EFI_OUT_OF_RESOURCES    Unable to allocate the output buffer GlyphBuffer.
   @retval EFI_NOT_FOUND           The glyph was unknown can not be found.
-  @retval EFI_INVALID_PARAMETER   Any input parameter is invalid.
 
 **/
+STATIC
 EFI_STATUS
-GetGlyphBuffer (
+ReadGlyphBuffer (
   IN  HII_DATABASE_PRIVATE_DATA  *Private,
   IN  CHAR16                     Char,
-  IN  EFI_FONT_INFO              *StringInfo,
+  IN  HII_FONT_PACKAGE_INSTANCE  *FontPackage,
   OUT UINT8                      **GlyphBuffer,
   OUT EFI_HII_GLYPH_INFO         *Cell,
-  OUT UINT8                      *Attributes OPTIONAL
+  OUT UINT8                      *Attributes,
+  OUT UINTN                      *GlyphBufferLen
   )
 {
   HII_DATABASE_RECORD               *Node;
@@ -164,11 +232,118 @@ GetGlyphBuffer (
   UINT16                            Index;
   EFI_NARROW_GLYPH                  Narrow;
   EFI_WIDE_GLYPH                    Wide;
-  HII_GLOBAL_FONT_INFO              *GlobalFont;
   UINTN                             HeaderSize;
   EFI_NARROW_GLYPH                  *NarrowPtr;
   EFI_WIDE_GLYPH                    *WidePtr;
 
+  if (FontPackage != NULL) {
+    *Attributes = PROPORTIONAL_GLYPH;
+    return FindGlyphBlock (FontPackage, Char, GlyphBuffer, Cell, GlyphBufferLen);
+  }
+
+  //
+  // The default system font is the fixed font (narrow or wide glyph) of the
+  // simplified font packages.
+  //
+  HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
+         Link1 != &Node->PackageList->SimpleFontPkgHdr;
+         Link1 = Link1->ForwardLink
+         )
+    {
+      SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
+      //
+      // Search the narrow glyph array
+      //
+      NarrowPtr = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + HeaderSize);
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
+        CopyMem (&Narrow, NarrowPtr + Index, sizeof (EFI_NARROW_GLYPH));
+        if (Narrow.UnicodeWeight == Char) {
+          *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
+          if (*GlyphBuffer == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+          }
+
+          Cell->Width     = EFI_GLYPH_WIDTH;
+          Cell->Height    = EFI_GLYPH_HEIGHT;
+          Cell->AdvanceX  = Cell->Width;
+          *GlyphBufferLen = EFI_GLYPH_HEIGHT;
+          CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
+          *Attributes = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
+
+          return EFI_SUCCESS;
+        }
+      }
+
+      //
+      // Search the wide glyph array
+      //
+      WidePtr = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
+      for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
+        CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
+        if (Wide.UnicodeWeight == Char) {
+          *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
+          if (*GlyphBuffer == NULL) {
+            return EFI_OUT_OF_RESOURCES;
+          }
+
+          Cell->Width     = EFI_GLYPH_WIDTH * 2;
+          Cell->Height    = EFI_GLYPH_HEIGHT;
+          Cell->AdvanceX  = Cell->Width;
+          *GlyphBufferLen = EFI_GLYPH_HEIGHT * 2;
+          CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
+          CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
+          *Attributes = (UINT8)(Wide.Attributes | EFI_GLYPH_WIDE);
+
+          return EFI_SUCCESS;
+        }
+      }
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Convert the glyph for a single character into a bitmap.
+
+  This is a internal function.
+
+  @param  Private                 HII database driver private data.
+  @param  Char                    Character to retrieve.
+  @param  StringInfo              Points to the string font and color information
+                                  or NULL  if the string should use the default
+                                  system font and color.
+  @param  GlyphBuffer             Buffer to store the retrieved bitmap data.
+  @param  Cell                    Points to EFI_HII_GLYPH_INFO structure.
+  @param  Attributes              If not NULL, output the glyph attributes if any.
+
+  @retval EFI_SUCCESS             Glyph bitmap outputted.
+  @retval EFI_OUT_OF_RESOURCES    Unable to allocate the output buffer GlyphBuffer.
+  @retval EFI_NOT_FOUND           The glyph was unknown can not be found.
+  @retval EFI_INVALID_PARAMETER   Any input parameter is invalid.
+
+**/
+EFI_STATUS
+GetGlyphBuffer (
+  IN  HII_DATABASE_PRIVATE_DATA  *Private,
+  IN  CHAR16                     Char,
+  IN  EFI_FONT_INFO              *StringInfo,
+  OUT UINT8                      **GlyphBuffer,
+  OUT EFI_HII_GLYPH_INFO         *Cell,
+  OUT UINT8                      *Attributes OPTIONAL
+  )
+{
+  EFI_STATUS                 Status;
+  HII_GLOBAL_FONT_INFO       *GlobalFont;
+  HII_FONT_PACKAGE_INSTANCE  *FontPackage;
+  HII_GLYPH_CACHE_ENTRY      *Entry;
+  UINT8                      GlyphAttributes;
+  UINTN                      GlyphBufferLen;
+
   if ((GlyphBuffer == NULL) || (Cell == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
@@ -185,80 +360,54 @@ GetGlyphBuffer (
   // If NULL, try to find the character in simplified font packages since
   // default system font is the fixed font (narrow or wide glyph).
   //
+  FontPackage = NULL;
   if (StringInfo != NULL) {
     if (!IsFontInfoExisted (Private, StringInfo, NULL, NULL, &GlobalFont)) {
       return EFI_INVALID_PARAMETER;
     }
 
-    if (Attributes != NULL) {
-      *Attributes = PROPORTIONAL_GLYPH;
-    }
-
-    return FindGlyphBlock (GlobalFont->FontPackage, Char, GlyphBuffer, Cell, NULL);
-  } else {
-    HeaderSize = sizeof (EFI_HII_SIMPLE_FONT_PACKAGE_HDR);
-
-    for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
-      Node = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
-      for (Link1 = Node->PackageList->SimpleFontPkgHdr.ForwardLink;
-           Link1 != &Node->PackageList->SimpleFontPkgHdr;
-           Link1 = Link1->ForwardLink
-           )
-      {
-        SimpleFont = CR (Link1, HII_SIMPLE_FONT_PACKAGE_INSTANCE, SimpleFontEntry, HII_S_FONT_PACKAGE_SIGNATURE);
-        //
-        // Search the narrow glyph array
-        //
-        NarrowPtr = (EFI_NARROW_GLYPH *)((UINT8 *)(SimpleFont->SimpleFontPkgHdr) + HeaderSize);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs; Index++) {
-          CopyMem (&Narrow, NarrowPtr + Index, sizeof (EFI_NARROW_GLYPH));
-          if (Narrow.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
-
-            Cell->Width    = EFI_GLYPH_WIDTH;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Narrow.GlyphCol1, Cell->Height);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Narrow.Attributes | NARROW_GLYPH);
-            }
-
-            return EFI_SUCCESS;
-          }
-        }
+    FontPackage = GlobalFont->FontPackage;
+  }
 
-        //
-        // Search the wide glyph array
-        //
-        WidePtr = (EFI_WIDE_GLYPH *)(NarrowPtr + SimpleFont->SimpleFontPkgHdr->NumberOfNarrowGlyphs);
-        for (Index = 0; Index < SimpleFont->SimpleFontPkgHdr->NumberOfWideGlyphs; Index++) {
-          CopyMem (&Wide, WidePtr + Index, sizeof (EFI_WIDE_GLYPH));
-          if (Wide.UnicodeWeight == Char) {
-            *GlyphBuffer = (UINT8 *)AllocateZeroPool (EFI_GLYPH_HEIGHT * 2);
-            if (*GlyphBuffer == NULL) {
-              return EFI_OUT_OF_RESOURCES;
-            }
+  Entry = GetGlyphCacheEntry (FontPackage, Char);
+  if ((Entry->GlyphBuffer == NULL) || (Entry->Font != FontPackage) || (Entry->Char != Char)) {
+    Status = ReadGlyphBuffer (Private, Char, FontPackage, GlyphBuffer, Cell, &GlyphAttributes, &GlyphBufferLen);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
-            Cell->Width    = EFI_GLYPH_WIDTH * 2;
-            Cell->Height   = EFI_GLYPH_HEIGHT;
-            Cell->AdvanceX = Cell->Width;
-            CopyMem (*GlyphBuffer, Wide.GlyphCol1, EFI_GLYPH_HEIGHT);
-            CopyMem (*GlyphBuffer + EFI_GLYPH_HEIGHT, Wide.GlyphCol2, EFI_GLYPH_HEIGHT);
-            if (Attributes != NULL) {
-              *Attributes = (UINT8)(Wide.Attributes | EFI_GLYPH_WIDE);
-            }
+    //
+    // A glyph without bitmap has no buffer to copy, it is not cached.
+    //
+    if (GlyphBufferLen != 0) {
+      if (Entry->GlyphBuffer != NULL) {
+        FreePool (Entry->GlyphBuffer);
+      }
 
-            return EFI_SUCCESS;
-          }
-        }
+      Entry->GlyphBuffer = AllocateCopyPool (GlyphBufferLen, *GlyphBuffer);
+      if (Entry->GlyphBuffer != NULL) {
+        Entry->Font           = FontPackage;
+        Entry->Char           = Char;
+        Entry->Attributes     = GlyphAttributes;
+        Entry->GlyphBufferLen = GlyphBufferLen;
+        CopyMem (&Entry->Cell, Cell, sizeof (EFI_HII_GLYPH_INFO));
       }
     }
+  } else {
+    *GlyphBuffer = AllocateCopyPool (Entry->GlyphBufferLen, Entry->GlyphBuffer);
+    if (*GlyphBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    GlyphAttributes = Entry->Attributes;
+    CopyMem (Cell, &Entry->Cell, sizeof (EFI_HII_GLYPH_INFO));
   }
 
-  return EFI_NOT_FOUND;
+  if (Attributes != NULL) {
+    *Attributes = GlyphAttributes;
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
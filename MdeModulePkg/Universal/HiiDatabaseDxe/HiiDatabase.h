@@ -150,6 +150,16 @@ typedef struct {
 // String Package definitions
 //
 #define HII_STRING_PACKAGE_SIGNATURE  SIGNATURE_32 ('h','i','s','p')
+
+//
+// Location of a string in the string blocks, as offsets from StringBlock. A
+// TextOffset of 0 marks a string id that is not indexed.
+//
+typedef struct {
+  UINT32    BlockOffset;
+  UINT32    TextOffset;
+} HII_STRING_INDEX_ENTRY;
+
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
   UINTN                         Signature;
   EFI_HII_STRING_PACKAGE_HDR    *StringPkgHdr;
@@ -158,6 +168,7 @@ typedef struct _HII_STRING_PACKAGE_INSTANCE {
   LIST_ENTRY                    FontInfoList;          // local font info list
   UINT8                         FontId;
   EFI_STRING_ID                 MaxStringId;           // record StringId
+  HII_STRING_INDEX_ENTRY        *StringIndex;          // StringId lookup, built on first use
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -535,6 +546,18 @@ FindStringBlock (
   OUT EFI_STRING_ID                *StartStringId OPTIONAL
   );
 
+/**
+  Free the StringId index of a string package. It is built again on the next
+  lookup, and must be freed whenever the string blocks change.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+HiiStringIndexFree (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  );
+
 /**
   Parse all glyph blocks to find a glyph block specified by CharValue.
   If CharValue = (CHAR16) (-1), collect all default character cell information
@@ -565,6 +588,16 @@ FindGlyphBlock (
   OUT UINTN                      *GlyphBufferLen OPTIONAL
   );
 
+/**
+  Empty the glyph cache. It must be emptied whenever a font or a simplified
+  font package is added or removed.
+
+**/
+VOID
+HiiFlushGlyphCache (
+  VOID
+  );
+
 /**
   This function exports Form packages to a buffer.
   This is a internal function.
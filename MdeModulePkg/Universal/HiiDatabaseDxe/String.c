@@ -225,6 +225,246 @@ GetStringFontInfo (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Build the StringId index of a string package, with one walk of its string
+  blocks. The package has no index if it cannot be allocated, or if an unknown
+  block is met.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+STATIC
+VOID
+HiiStringIndexBuild (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  HII_STRING_INDEX_ENTRY   *StringIndex;
+  UINT8                    *BlockHdr;
+  UINT8                    *StringTextPtr;
+  EFI_STRING_ID            CurrentStringId;
+  UINTN                    BlockSize;
+  UINTN                    Index;
+  UINTN                    StringSize;
+  UINT16                   StringCount;
+  UINT16                   SkipCount;
+  UINT8                    Length8;
+  UINT32                   Length32;
+  EFI_HII_SIBT_EXT2_BLOCK  Ext2;
+  BOOLEAN                  Ucs2;
+
+  StringIndex = AllocateZeroPool ((StringPackage->MaxStringId + 1) * sizeof (HII_STRING_INDEX_ENTRY));
+  if (StringIndex == NULL) {
+    return;
+  }
+
+  CurrentStringId = 1;
+  BlockHdr        = StringPackage->StringBlock;
+  while (*BlockHdr != EFI_HII_SIBT_END) {
+    StringCount   = 0;
+    StringTextPtr = NULL;
+    BlockSize     = 0;
+    Ucs2          = FALSE;
+    switch (*BlockHdr) {
+      case EFI_HII_SIBT_STRING_SCSU:
+        StringCount   = 1;
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_STRING_BLOCK);
+        break;
+
+      case EFI_HII_SIBT_STRING_SCSU_FONT:
+        StringCount   = 1;
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        break;
+
+      case EFI_HII_SIBT_STRINGS_SCSU:
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_SCSU_BLOCK) - sizeof (UINT8);
+        break;
+
+      case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        break;
+
+      case EFI_HII_SIBT_STRING_UCS2:
+        StringCount   = 1;
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_STRING_BLOCK);
+        Ucs2          = TRUE;
+        break;
+
+      case EFI_HII_SIBT_STRING_UCS2_FONT:
+        StringCount   = 1;
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRING_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        Ucs2          = TRUE;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_UCS2:
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_UCS2_BLOCK) - sizeof (CHAR16);
+        Ucs2          = TRUE;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+        CopyMem (&StringCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        StringTextPtr = BlockHdr + sizeof (EFI_HII_SIBT_STRINGS_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        Ucs2          = TRUE;
+        break;
+
+      case EFI_HII_SIBT_DUPLICATE:
+        //
+        // The duplicate block itself is indexed, the lookup follows it.
+        //
+        if (CurrentStringId <= StringPackage->MaxStringId) {
+          StringIndex[CurrentStringId].BlockOffset = (UINT32)(BlockHdr - StringPackage->StringBlock);
+          StringIndex[CurrentStringId].TextOffset  = (UINT32)(BlockHdr + sizeof (EFI_HII_STRING_BLOCK) - StringPackage->StringBlock);
+        }
+
+        BlockSize = sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
+        CurrentStringId++;
+        break;
+
+      case EFI_HII_SIBT_SKIP1:
+        SkipCount       = (UINT16)(*(UINT8 *)((UINTN)BlockHdr + sizeof (EFI_HII_STRING_BLOCK)));
+        CurrentStringId = (UINT16)(CurrentStringId + SkipCount);
+        BlockSize       = sizeof (EFI_HII_SIBT_SKIP1_BLOCK);
+        break;
+
+      case EFI_HII_SIBT_SKIP2:
+        CopyMem (&SkipCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        CurrentStringId = (UINT16)(CurrentStringId + SkipCount);
+        BlockSize       = sizeof (EFI_HII_SIBT_SKIP2_BLOCK);
+        break;
+
+      case EFI_HII_SIBT_EXT1:
+        CopyMem (&Length8, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT8));
+        BlockSize = Length8;
+        break;
+
+      case EFI_HII_SIBT_EXT2:
+        CopyMem (&Ext2, BlockHdr, sizeof (EFI_HII_SIBT_EXT2_BLOCK));
+        BlockSize = Ext2.Length;
+        break;
+
+      case EFI_HII_SIBT_EXT4:
+        CopyMem (&Length32, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT32));
+        BlockSize = Length32;
+        break;
+
+      default:
+        break;
+    }
+
+    if (StringTextPtr != NULL) {
+      for (Index = 0; Index < StringCount; Index++) {
+        if (Ucs2) {
+          GetUnicodeStringTextOrSize (NULL, StringTextPtr, &StringSize);
+        } else {
+          StringSize = AsciiStrSize ((CHAR8 *)StringTextPtr);
+        }
+
+        if (CurrentStringId <= StringPackage->MaxStringId) {
+          StringIndex[CurrentStringId].BlockOffset = (UINT32)(BlockHdr - StringPackage->StringBlock);
+          StringIndex[CurrentStringId].TextOffset  = (UINT32)(StringTextPtr - StringPackage->StringBlock);
+        }
+
+        StringTextPtr += StringSize;
+        CurrentStringId++;
+      }
+
+      BlockSize = StringTextPtr - BlockHdr;
+    }
+
+    if (BlockSize == 0) {
+      FreePool (StringIndex);
+      return;
+    }
+
+    BlockHdr += BlockSize;
+  }
+
+  StringPackage->StringIndex = StringIndex;
+}
+
+/**
+  Free the StringId index of a string package. It is built again on the next
+  lookup, and must be freed whenever the string blocks change.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+HiiStringIndexFree (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex = NULL;
+  }
+}
+
+/**
+  Find the string block of a StringId in the index of the string package,
+  building the index if needed. Duplicate string blocks are followed.
+
+  @param  StringPackage           Hii string package instance.
+  @param  StringId                The string's id, which is unique within
+                                  PackageList.
+  @param  BlockType               Output the block type of found string block.
+  @param  StringBlockAddr         Output the block address of found string block.
+  @param  StringTextOffset        Offset, relative to the found block address, of
+                                  the  string text information.
+
+  @retval TRUE                    The string block is found.
+  @retval FALSE                   The StringId is not indexed, the string blocks
+                                  must be parsed.
+
+**/
+STATIC
+BOOLEAN
+HiiStringIndexLookup (
+  IN  HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN  EFI_STRING_ID                StringId,
+  OUT UINT8                        *BlockType,
+  OUT UINT8                        **StringBlockAddr,
+  OUT UINTN                        *StringTextOffset
+  )
+{
+  HII_STRING_INDEX_ENTRY  *Entry;
+  UINT8                   *BlockHdr;
+  UINTN                   Hops;
+
+  if (StringPackage->StringIndex == NULL) {
+    HiiStringIndexBuild (StringPackage);
+    if (StringPackage->StringIndex == NULL) {
+      return FALSE;
+    }
+  }
+
+  for (Hops = 0; Hops <= StringPackage->MaxStringId; Hops++) {
+    if ((StringId == 0) || (StringId > StringPackage->MaxStringId)) {
+      return FALSE;
+    }
+
+    Entry = &StringPackage->StringIndex[StringId];
+    if (Entry->TextOffset == 0) {
+      return FALSE;
+    }
+
+    BlockHdr = StringPackage->StringBlock + Entry->BlockOffset;
+    if (*BlockHdr != EFI_HII_SIBT_DUPLICATE) {
+      *BlockType        = *BlockHdr;
+      *StringBlockAddr  = BlockHdr;
+      *StringTextOffset = Entry->TextOffset - Entry->BlockOffset;
+      return TRUE;
+    }
+
+    CopyMem (&StringId, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (EFI_STRING_ID));
+  }
+
+  return FALSE;
+}
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -295,6 +535,16 @@ FindStringBlock (
     if (StringId > StringPackage->MaxStringId) {
       return EFI_NOT_FOUND;
     }
+
+    //
+    // Plain lookups are served by the index. The lookups of SetString() also
+    // need the skip block of a missing string, which only the parsing gives.
+    //
+    if ((StartStringId == NULL) &&
+        HiiStringIndexLookup (StringPackage, StringId, BlockType, StringBlockAddr, StringTextOffset))
+    {
+      return EFI_SUCCESS;
+    }
   } else {
     ASSERT (Private != NULL && Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
     if ((StringId == 0) && (LastStringId != NULL)) {
@@ -913,6 +1163,10 @@ SetStringWorker (
   ASSERT (Private != NULL && StringPackage != NULL && String != NULL);
   ASSERT (Private->Signature == HII_DATABASE_PRIVATE_DATA_SIGNATURE);
   //
+  // The string blocks are about to change.
+  //
+  HiiStringIndexFree (StringPackage);
+  //
   // Find the specified string block
   //
   Status = FindStringBlock (
@@ -1254,6 +1508,8 @@ HiiNewString (
       goto Done;
     }
 
+    HiiStringIndexFree (StringPackage);
+
     //
     // Make sure that new StringId is same in all String Packages for the different language.
     //
@@ -315,6 +315,215 @@ ConstructNonTestedMemoryRange (
   return EFI_SUCCESS;
 }
 
+/**
+  Write the memory test pattern into a range of physical memory, on the
+  calling processor only.
+
+  When the pattern covers the range contiguously and repeats a 64-bit value,
+  the range is filled with SetMem64(), whose string store implementation is
+  much faster than copying the pattern one cache line at a time.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+**/
+VOID
+FillMemoryPattern (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+
+  if (Private->MonoPatternIs64 && (Private->CoverageSpan == Private->MonoTestSize) &&
+      (Start != 0) && ((Start % sizeof (UINT64)) == 0) && ((Size % Private->MonoTestSize) == 0))
+  {
+    SetMem64 ((VOID *)(UINTN)Start, (UINTN)Size, Private->MonoPattern64);
+    return;
+  }
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
+    Address += Private->CoverageSpan;
+  }
+}
+
+/**
+  Find the first miscompare of the memory test pattern in a range of physical
+  memory, on the calling processor only.
+
+  @param[in]  Private       Point to generic memory test driver's private data.
+  @param[in]  Start         The memory range's start address.
+  @param[in]  Size          The memory range's size.
+  @param[out] ErrorAddress  The address of the first test pattern instance
+                            with a miscompare.
+
+  @retval TRUE   A miscompare was found.
+  @retval FALSE  The range matches the test pattern.
+
+**/
+BOOLEAN
+FindMemoryMiscompare (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size,
+  OUT EFI_PHYSICAL_ADDRESS         *ErrorAddress
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+  volatile UINT64       *Pointer;
+  volatile UINT64       *End;
+
+  if (Private->MonoPatternIs64 && (Private->CoverageSpan == Private->MonoTestSize) &&
+      ((Start % sizeof (UINT64)) == 0) && ((Size % Private->MonoTestSize) == 0))
+  {
+    Pointer = (volatile UINT64 *)(UINTN)Start;
+    End     = (volatile UINT64 *)(UINTN)(Start + Size);
+    for ( ; Pointer < End; Pointer++) {
+      if (*Pointer != Private->MonoPattern64) {
+        *ErrorAddress = Start + (((UINTN)Pointer - Start) / Private->MonoTestSize) * Private->MonoTestSize;
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+  }
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    if (CompareMemWithoutCheckArgument (
+          (VOID *)(UINTN)(Address),
+          Private->MonoPattern,
+          Private->MonoTestSize
+          ) != 0)
+    {
+      *ErrorAddress = Address;
+      return TRUE;
+    }
+
+    Address += Private->CoverageSpan;
+  }
+
+  return FALSE;
+}
+
+/**
+  Write or verify the chunks of a test block not taken by another processor yet.
+
+  This runs on the APs and on the BSP, so it must not use any UEFI service.
+
+  @param[in, out] Buffer  Point to the MEMORY_TEST_MP_CONTEXT of the test block.
+
+**/
+VOID
+EFIAPI
+MemoryTestChunkProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  MEMORY_TEST_MP_CONTEXT  *Context;
+  UINT32                  Chunk;
+  EFI_PHYSICAL_ADDRESS    ChunkStart;
+  UINT64                  ChunkSize;
+  EFI_PHYSICAL_ADDRESS    ErrorAddress;
+  UINT64                  Current;
+
+  Context = (MEMORY_TEST_MP_CONTEXT *)Buffer;
+  for ( ; ;) {
+    Chunk = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Chunk >= Context->ChunkCount) {
+      break;
+    }
+
+    ChunkStart = Context->Start + MultU64x32 (Context->ChunkSize, Chunk);
+    ChunkSize  = MIN (Context->ChunkSize, Context->Start + Context->Size - ChunkStart);
+    if (!Context->Verify) {
+      FillMemoryPattern (Context->Private, ChunkStart, ChunkSize);
+      continue;
+    }
+
+    if (!FindMemoryMiscompare (Context->Private, ChunkStart, ChunkSize, &ErrorAddress)) {
+      continue;
+    }
+
+    //
+    // Keep the lowest address found by any processor.
+    //
+    do {
+      Current = Context->ErrorAddress;
+      if (ErrorAddress >= Current) {
+        break;
+      }
+    } while (InterlockedCompareExchange64 ((volatile UINT64 *)&Context->ErrorAddress, Current, ErrorAddress) != Current);
+  }
+}
+
+/**
+  Write or verify the memory test pattern in a range of physical memory, with
+  the range split in chunks shared by all the enabled processors.
+
+  @param[in]  Private       Point to generic memory test driver's private data.
+  @param[in]  Start         The memory range's start address.
+  @param[in]  Size          The memory range's size.
+  @param[in]  Verify        TRUE to verify the test pattern, FALSE to write it.
+  @param[out] ErrorAddress  The address of the first test pattern instance
+                            with a miscompare, MAX_UINT64 if there is none.
+
+  @retval TRUE   The range was processed, possibly with the help of the APs.
+  @retval FALSE  The range is too small to be shared with the APs, and was not
+                 processed.
+
+**/
+BOOLEAN
+RunMemoryTestOnAllProcessors (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size,
+  IN  BOOLEAN                      Verify,
+  OUT EFI_PHYSICAL_ADDRESS         *ErrorAddress
+  )
+{
+  MEMORY_TEST_MP_CONTEXT  Context;
+
+  //
+  // Chunks stay a multiple of the coverage span so that the processors
+  // cover the same addresses the BSP would.
+  //
+  Context.ChunkSize = MAX (TEST_CHUNK_SIZE, Private->CoverageSpan);
+  if ((Private->MpServices == NULL) || (Size <= Context.ChunkSize)) {
+    return FALSE;
+  }
+
+  Context.Private      = Private;
+  Context.Start        = Start;
+  Context.Size         = Size;
+  Context.ChunkCount   = (UINT32)DivU64x64Remainder (Size + Context.ChunkSize - 1, Context.ChunkSize, NULL);
+  Context.NextChunk    = 0;
+  Context.Verify       = Verify;
+  Context.ErrorAddress = MAX_UINT64;
+
+  Private->MpServices->StartupAllAPs (
+                         Private->MpServices,
+                         MemoryTestChunkProcedure,
+                         FALSE,
+                         NULL,
+                         0,
+                         &Context,
+                         NULL
+                         );
+
+  //
+  // Finish whatever the APs did not take, e.g. when no AP is enabled.
+  //
+  MemoryTestChunkProcedure (&Context);
+
+  *ErrorAddress = Context.ErrorAddress;
+  return TRUE;
+}
+
 /**
   Write the memory test pattern into a range of physical memory.
 
@@ -333,9 +542,7 @@ WriteMemory (
   IN  UINT64                       Size
   )
 {
-  EFI_PHYSICAL_ADDRESS  Address;
-
-  Address = Start;
+  EFI_PHYSICAL_ADDRESS  ErrorAddress;
 
   //
   // Add 4G memory address check for IA32 platform
@@ -345,9 +552,8 @@ WriteMemory (
     return EFI_SUCCESS;
   }
 
-  while (Address < (Start + Size)) {
-    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
-    Address += Private->CoverageSpan;
+  if (!RunMemoryTestOnAllProcessors (Private, Start, Size, FALSE, &ErrorAddress)) {
+    FillMemoryPattern (Private, Start, Size);
   }
 
   //
@@ -383,10 +589,10 @@ VerifyMemory (
   )
 {
   EFI_PHYSICAL_ADDRESS            Address;
-  INTN                            ErrorFound;
+  BOOLEAN                         ErrorFound;
   EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
 
-  Address           = Start;
+  Address           = MAX_UINT64;
   ExtendedErrorData = NULL;
 
   //
@@ -402,43 +608,43 @@ VerifyMemory (
   // error here. If there is miscompare error here then check if generic
   // memory test driver can disable the bad DIMM.
   //
-  while (Address < (Start + Size)) {
-    ErrorFound = CompareMemWithoutCheckArgument (
-                   (VOID *)(UINTN)(Address),
-                   Private->MonoPattern,
-                   Private->MonoTestSize
-                   );
-    if (ErrorFound != 0) {
-      //
-      // Report uncorrectable errors
-      //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome              = 0x0;
-      ExtendedErrorData->Address               = Address;
-      ExtendedErrorData->Resolution            = 0x40;
-
-      REPORT_STATUS_CODE_EX (
-        EFI_ERROR_CODE,
-        EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-        0,
-        &gEfiGenericMemTestProtocolGuid,
-        NULL,
-        (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-        ExtendedErrorData->DataHeader.Size
-        );
+  // The errors are reported here on the BSP, also when the APs have helped
+  // to find them.
+  //
+  if (RunMemoryTestOnAllProcessors (Private, Start, Size, TRUE, &Address)) {
+    ErrorFound = (BOOLEAN)(Address != MAX_UINT64);
+  } else {
+    ErrorFound = FindMemoryMiscompare (Private, Start, Size, &Address);
+  }
 
-      return EFI_DEVICE_ERROR;
+  if (ErrorFound) {
+    //
+    // Report uncorrectable errors
+    //
+    ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+    if (ExtendedErrorData == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
-    Address += Private->CoverageSpan;
+    ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
+    ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+    ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
+    ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
+    ExtendedErrorData->Syndrome              = 0x0;
+    ExtendedErrorData->Address               = Address;
+    ExtendedErrorData->Resolution            = 0x40;
+
+    REPORT_STATUS_CODE_EX (
+      EFI_ERROR_CODE,
+      EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+      0,
+      &gEfiGenericMemTestProtocolGuid,
+      NULL,
+      (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+      ExtendedErrorData->DataHeader.Size
+      );
+
+    return EFI_DEVICE_ERROR;
   }
 
   return EFI_SUCCESS;
@@ -479,6 +685,17 @@ InitializeMemoryTest (
   Private->MonoPattern  = GenericMemoryTestMonoPattern;
   Private->MonoTestSize = GENERIC_CACHELINE_SIZE;
 
+  //
+  // The pattern can be written and checked 64 bits at a time if it repeats a
+  // 64-bit value.
+  //
+  Private->MonoPattern64   = *(UINT64 *)Private->MonoPattern;
+  Private->MonoPatternIs64 = (BOOLEAN)(CompareMem (
+                                         Private->MonoPattern,
+                                         (UINT8 *)Private->MonoPattern + sizeof (UINT64),
+                                         Private->MonoTestSize - sizeof (UINT64)
+                                         ) == 0);
+
   //
   // Initialize several internal link list
   //
@@ -501,6 +718,18 @@ InitializeMemoryTest (
     Private->Cpu = Cpu;
   }
 
+  //
+  // get the MP services protocol to share the memory test with the APs
+  //
+  Private->MpServices = NULL;
+  if (FeaturePcdGet (PcdMemoryTestOnAllProcessors)) {
+    gBS->LocateProtocol (
+           &gEfiMpServiceProtocolGuid,
+           NULL,
+           (VOID **)&Private->MpServices
+           );
+  }
+
   //
   // Create the CoverageSpan of the memory test base on the coverage level
   //
@@ -853,6 +1082,7 @@ GENERIC_MEMORY_TEST_PRIVATE  mGenericMemoryTestPrivate = {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE,
   NULL,
   NULL,
+  NULL,
   {
     InitializeMemoryTest,
     GenPerformMemoryTest,
@@ -865,6 +1095,8 @@ GENERIC_MEMORY_TEST_PRIVATE  mGenericMemoryTestPrivate = {
   NULL,
   0,
   0,
+  FALSE,
+  0,
   {
     NULL,
     NULL
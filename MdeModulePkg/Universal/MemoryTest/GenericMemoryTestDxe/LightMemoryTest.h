@@ -13,6 +13,7 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpService.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -23,6 +24,8 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/PcdLib.h>
 
 //
 // Some global define
@@ -43,6 +46,11 @@
 #define QUICK_SPAN_SIZE   (TEST_BLOCK_SIZE >> 2)
 #define SPARSE_SPAN_SIZE  (TEST_BLOCK_SIZE >> 4)
 
+//
+// The smallest piece of a test block handed to one processor
+//
+#define TEST_CHUNK_SIZE  SIZE_1MB
+
 //
 // This structure records every nontested memory range parsed through GCD
 // service.
@@ -81,6 +89,11 @@ typedef struct {
   //
   EFI_CPU_ARCH_PROTOCOL               *Cpu;
 
+  //
+  // MP services protocol's pointer, NULL if the APs are not used
+  //
+  EFI_MP_SERVICES_PROTOCOL            *MpServices;
+
   //
   // generic memory test driver's protocol
   //
@@ -99,6 +112,12 @@ typedef struct {
   VOID                                *MonoPattern;
   UINTN                               MonoTestSize;
 
+  //
+  // the 64-bit value the test pattern repeats, if it repeats one
+  //
+  UINT64                              MonoPattern64;
+  BOOLEAN                             MonoPatternIs64;
+
   //
   // base memory's size which tested in PEI phase
   //
@@ -118,6 +137,21 @@ typedef struct {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE \
   )
 
+//
+// This structure describes a R/W/V pass over a test block shared by all the
+// processors. Each processor takes the next TEST_CHUNK_SIZE chunk in turn.
+//
+typedef struct {
+  GENERIC_MEMORY_TEST_PRIVATE    *Private;
+  EFI_PHYSICAL_ADDRESS           Start;
+  UINT64                         Size;
+  UINT64                         ChunkSize;
+  UINT32                         ChunkCount;
+  volatile UINT32                NextChunk;
+  BOOLEAN                        Verify;
+  volatile UINT64                ErrorAddress;
+} MEMORY_TEST_MP_CONTEXT;
+
 //
 // Function Prototypes
 //
@@ -45,31 +45,46 @@ RscHandlerNotification (
   )
 {
   RSC_HANDLER_CALLBACK_ENTRY  *CallbackEntry;
-  EFI_PHYSICAL_ADDRESS        Address;
+  UINTN                       Offset;
   RSC_DATA_ENTRY              *RscData;
+  EFI_TPL                     OldTpl;
+  BOOLEAN                     Drained;
 
   CallbackEntry = (RSC_HANDLER_CALLBACK_ENTRY *)Context;
 
   //
   // Traverse the status code data buffer to parse all
-  // data to report.
+  // data to report. The buffer may be reallocated by a report at a higher
+  // TPL, so it is walked by offset.
   //
-  Address = CallbackEntry->StatusCodeDataBuffer;
-  while (Address < CallbackEntry->EndPointer) {
-    RscData = (RSC_DATA_ENTRY *)(UINTN)Address;
-    CallbackEntry->RscHandlerCallback (
-                     RscData->Type,
-                     RscData->Value,
-                     RscData->Instance,
-                     &RscData->CallerId,
-                     &RscData->Data
-                     );
-
-    Address += (OFFSET_OF (RSC_DATA_ENTRY, Data) + RscData->Data.HeaderSize + RscData->Data.Size);
-    Address  = ALIGN_VARIABLE (Address);
-  }
+  Offset = 0;
+  do {
+    while (CallbackEntry->StatusCodeDataBuffer + Offset < CallbackEntry->EndPointer) {
+      RscData = (RSC_DATA_ENTRY *)(UINTN)(CallbackEntry->StatusCodeDataBuffer + Offset);
+      CallbackEntry->RscHandlerCallback (
+                       RscData->Type,
+                       RscData->Value,
+                       RscData->Instance,
+                       &RscData->CallerId,
+                       &RscData->Data
+                       );
 
-  CallbackEntry->EndPointer = CallbackEntry->StatusCodeDataBuffer;
+      Offset += (OFFSET_OF (RSC_DATA_ENTRY, Data) + RscData->Data.HeaderSize + RscData->Data.Size);
+      Offset  = ALIGN_VARIABLE (Offset);
+    }
+
+    //
+    // The event is only signaled when the buffer becomes non-empty, so the
+    // buffer is emptied once all the data reported meanwhile is handled.
+    //
+    OldTpl  = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    Drained = (BOOLEAN)(CallbackEntry->StatusCodeDataBuffer + Offset >= CallbackEntry->EndPointer);
+    if (Drained) {
+      CallbackEntry->EndPointer = CallbackEntry->StatusCodeDataBuffer;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  } while (!Drained);
 }
 
 /**
@@ -240,6 +255,7 @@ ReportDispatcher (
   EFI_STATUS                  Status;
   VOID                        *NewBuffer;
   EFI_PHYSICAL_ADDRESS        FailSafeEndPointer;
+  BOOLEAN                     Signal;
 
   //
   // Use atom operation to avoid the reentant of report.
@@ -269,8 +285,11 @@ ReportDispatcher (
     //
     // If callback is registered with TPL lower than TPL_HIGH_LEVEL, event must be signaled at boot time to possibly wait for
     // allowed TPL to report status code. Related data should also be stored in data buffer.
+    // The event is pending while the buffer holds data, and its notification handles all of
+    // it in one batch, so it is only signaled for the first data.
     //
     FailSafeEndPointer         = CallbackEntry->EndPointer;
+    Signal                     = (BOOLEAN)(CallbackEntry->EndPointer == CallbackEntry->StatusCodeDataBuffer);
     CallbackEntry->EndPointer  = ALIGN_VARIABLE (CallbackEntry->EndPointer);
     RscData                    = (RSC_DATA_ENTRY *)(UINTN)CallbackEntry->EndPointer;
     CallbackEntry->EndPointer += sizeof (RSC_DATA_ENTRY);
@@ -320,8 +339,10 @@ ReportDispatcher (
       RscData->Data.HeaderSize = sizeof (RscData->Data);
     }
 
-    Status = gBS->SignalEvent (CallbackEntry->Event);
-    ASSERT_EFI_ERROR (Status);
+    if (Signal) {
+      Status = gBS->SignalEvent (CallbackEntry->Event);
+      ASSERT_EFI_ERROR (Status);
+    }
   }
 
   //
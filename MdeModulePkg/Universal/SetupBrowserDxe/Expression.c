@@ -826,6 +826,111 @@ IdToQuestion2 (
   return NULL;
 }
 
+/**
+  Compare two entries of the Question index of a formset.
+
+  @param  Buffer1                The first entry.
+  @param  Buffer2                The second entry.
+
+  @retval <0                     Buffer1 sorts before Buffer2.
+  @retval 0                      Buffer1 and Buffer2 are the same entry.
+  @retval >0                     Buffer1 sorts after Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareQuestionIndex (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST FORM_BROWSER_QUESTION_INDEX  *Entry1;
+  CONST FORM_BROWSER_QUESTION_INDEX  *Entry2;
+
+  Entry1 = (CONST FORM_BROWSER_QUESTION_INDEX *)Buffer1;
+  Entry2 = (CONST FORM_BROWSER_QUESTION_INDEX *)Buffer2;
+
+  if (Entry1->QuestionId != Entry2->QuestionId) {
+    return (Entry1->QuestionId < Entry2->QuestionId) ? -1 : 1;
+  }
+
+  if (Entry1->Order != Entry2->Order) {
+    return (Entry1->Order < Entry2->Order) ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+  Build the index of the Questions of a formset, so that the expressions
+  referring to Questions of other forms do not walk all the forms.
+
+  The formset has no index if it has no Question, or if the index cannot be
+  allocated.
+
+  @param  FormSet                The formset to index.
+
+**/
+STATIC
+VOID
+BuildQuestionIndex (
+  IN OUT FORM_BROWSER_FORMSET  *FormSet
+  )
+{
+  LIST_ENTRY                   *FormLink;
+  LIST_ENTRY                   *Link;
+  FORM_BROWSER_FORM            *Form;
+  FORM_BROWSER_STATEMENT       *Question;
+  FORM_BROWSER_QUESTION_INDEX  *QuestionIndex;
+  FORM_BROWSER_QUESTION_INDEX  Element;
+  UINTN                        Count;
+  UINTN                        Pass;
+
+  QuestionIndex = NULL;
+  Count         = 0;
+  for (Pass = 0; Pass < 2; Pass++) {
+    Count = 0;
+    for (FormLink = GetFirstNode (&FormSet->FormListHead);
+         !IsNull (&FormSet->FormListHead, FormLink);
+         FormLink = GetNextNode (&FormSet->FormListHead, FormLink))
+    {
+      Form = FORM_BROWSER_FORM_FROM_LINK (FormLink);
+      for (Link = GetFirstNode (&Form->StatementListHead);
+           !IsNull (&Form->StatementListHead, Link);
+           Link = GetNextNode (&Form->StatementListHead, Link))
+      {
+        Question = FORM_BROWSER_STATEMENT_FROM_LINK (Link);
+        if (Question->QuestionId == 0) {
+          continue;
+        }
+
+        if (QuestionIndex != NULL) {
+          QuestionIndex[Count].QuestionId = Question->QuestionId;
+          QuestionIndex[Count].Order      = Count;
+          QuestionIndex[Count].Form       = Form;
+          QuestionIndex[Count].Question   = Question;
+        }
+
+        Count++;
+      }
+    }
+
+    if ((Pass == 0) && (Count != 0)) {
+      QuestionIndex = AllocatePool (Count * sizeof (FORM_BROWSER_QUESTION_INDEX));
+    }
+
+    if (QuestionIndex == NULL) {
+      return;
+    }
+  }
+
+  QuickSort (QuestionIndex, Count, sizeof (FORM_BROWSER_QUESTION_INDEX), CompareQuestionIndex, &Element);
+
+  FormSet->QuestionIndex      = QuestionIndex;
+  FormSet->QuestionIndexCount = Count;
+}
+
 /**
   Search a Question in Formset scope using its QuestionId.
 
@@ -846,6 +951,9 @@ IdToQuestion (
 {
   LIST_ENTRY              *Link;
   FORM_BROWSER_STATEMENT  *Question;
+  UINTN                   Low;
+  UINTN                   High;
+  UINTN                   Middle;
 
   //
   // Search in the form scope first
@@ -856,8 +964,47 @@ IdToQuestion (
   }
 
   //
-  // Search in the formset scope
+  // Search in the formset scope, through the Question index of the formset.
+  // The first Question with this QuestionId in the formset order is found, as
+  // the search of the forms one by one finds it.
   //
+  if (QuestionId == 0) {
+    return NULL;
+  }
+
+  if (FormSet->QuestionIndex == NULL) {
+    BuildQuestionIndex (FormSet);
+  }
+
+  if (FormSet->QuestionIndex != NULL) {
+    Low  = 0;
+    High = FormSet->QuestionIndexCount;
+    while (Low < High) {
+      Middle = Low + (High - Low) / 2;
+      if (FormSet->QuestionIndex[Middle].QuestionId < QuestionId) {
+        Low = Middle + 1;
+      } else {
+        High = Middle;
+      }
+    }
+
+    if ((Low == FormSet->QuestionIndexCount) || (FormSet->QuestionIndex[Low].QuestionId != QuestionId)) {
+      return NULL;
+    }
+
+    Form     = FormSet->QuestionIndex[Low].Form;
+    Question = FormSet->QuestionIndex[Low].Question;
+    //
+    // EFI variable storage may be updated by Callback() asynchronous,
+    // to keep synchronous, always reload the Question Value.
+    //
+    if (Question->Storage->Type == EFI_HII_VARSTORE_EFI_VARIABLE) {
+      GetQuestionValue (FormSet, Form, Question, GetSetValueWithHiiDriver);
+    }
+
+    return Question;
+  }
+
   Link = GetFirstNode (&FormSet->FormListHead);
   while (!IsNull (&FormSet->FormListHead, Link)) {
     Form = FORM_BROWSER_FORM_FROM_LINK (Link);
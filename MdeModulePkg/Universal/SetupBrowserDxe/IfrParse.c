@@ -44,6 +44,15 @@ CreateStatement (
   Statement = &FormSet->StatementBuffer[mStatementIndex];
   mStatementIndex++;
 
+  //
+  // The Question index of the formset does not cover the new Statement.
+  //
+  if (FormSet->QuestionIndex != NULL) {
+    FreePool (FormSet->QuestionIndex);
+    FormSet->QuestionIndex      = NULL;
+    FormSet->QuestionIndexCount = 0;
+  }
+
   InitializeListHead (&Statement->DefaultListHead);
   InitializeListHead (&Statement->OptionListHead);
   InitializeListHead (&Statement->InconsistentListHead);
@@ -1021,6 +1030,10 @@ DestroyFormSet (
     FreePool (FormSet->ExpressionBuffer);
   }
 
+  if (FormSet->QuestionIndex != NULL) {
+    FreePool (FormSet->QuestionIndex);
+  }
+
   FreePool (FormSet);
 }
 
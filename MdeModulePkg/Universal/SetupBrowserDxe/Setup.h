@@ -430,6 +430,17 @@ typedef struct {
 
 #define FORM_BROWSER_FORMSET_SIGNATURE  SIGNATURE_32 ('F', 'B', 'F', 'S')
 
+//
+// Entry of the index of the Questions of a formset, sorted by QuestionId and
+// then by the order of the Questions in the formset.
+//
+typedef struct {
+  EFI_QUESTION_ID           QuestionId;
+  UINTN                     Order;
+  FORM_BROWSER_FORM         *Form;
+  FORM_BROWSER_STATEMENT    *Question;
+} FORM_BROWSER_QUESTION_INDEX;
+
 typedef struct {
   UINTN                             Signature;
   LIST_ENTRY                        Link;
@@ -465,6 +476,9 @@ typedef struct {
   LIST_ENTRY                        DefaultStoreListHead;    // DefaultStore list (FORMSET_DEFAULTSTORE)
   LIST_ENTRY                        FormListHead;            // Form list (FORM_BROWSER_FORM)
   LIST_ENTRY                        ExpressionListHead;      // List of Expressions (FORM_EXPRESSION)
+
+  FORM_BROWSER_QUESTION_INDEX       *QuestionIndex;          // Questions by QuestionId, built on first lookup
+  UINTN                             QuestionIndexCount;
 } FORM_BROWSER_FORMSET;
 #define FORM_BROWSER_FORMSET_FROM_LINK(a)  CR (a, FORM_BROWSER_FORMSET, Link, FORM_BROWSER_FORMSET_SIGNATURE)
 
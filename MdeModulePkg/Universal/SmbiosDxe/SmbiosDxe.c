@@ -244,33 +244,113 @@ GetSmbiosStructureSize (
 
 /**
 
-  Determin whether an SmbiosHandle has already in use.
+  Find the SMBIOS entry of an SmbiosHandle in the handle hash table.
 
-  @param Head        Pointer to the beginning of SMBIOS structure.
-  @param Handle      A unique handle will be assigned to the SMBIOS record.
+  @param Private     The SMBIOS instance.
+  @param Handle      The handle of the SMBIOS record.
 
-  @retval TRUE       Smbios handle already in use.
-  @retval FALSE      Smbios handle is NOT used.
+  @return The SMBIOS entry of the record, or NULL if the handle is NOT used.
 
 **/
-BOOLEAN
-EFIAPI
-CheckSmbiosHandleExistance (
-  IN  LIST_ENTRY         *Head,
-  IN  EFI_SMBIOS_HANDLE  Handle
+EFI_SMBIOS_ENTRY *
+SmbiosFindEntry (
+  IN SMBIOS_INSTANCE    *Private,
+  IN EFI_SMBIOS_HANDLE  Handle
   )
 {
-  LIST_ENTRY           *Link;
-  SMBIOS_HANDLE_ENTRY  *HandleEntry;
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *Head;
+  EFI_SMBIOS_ENTRY         *SmbiosEntry;
+  EFI_SMBIOS_TABLE_HEADER  *Record;
 
+  Head = &Private->HandleHashTable[SMBIOS_HANDLE_HASH (Handle)];
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK (Link);
-    if (HandleEntry->SmbiosHandle == Handle) {
-      return TRUE;
+    SmbiosEntry = SMBIOS_ENTRY_FROM_HANDLE_LINK (Link);
+    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+    if (Record->Handle == Handle) {
+      return SmbiosEntry;
     }
   }
 
-  return FALSE;
+  return NULL;
+}
+
+/**
+
+  Add the size of an SMBIOS record to, or subtract it from, the length of the
+  tables the record is in.
+
+  @param Private     The SMBIOS instance.
+  @param SmbiosEntry The SMBIOS entry of the record.
+  @param Add         TRUE to add the size of the record, FALSE to subtract it.
+
+**/
+VOID
+SmbiosUpdateTableLength (
+  IN SMBIOS_INSTANCE   *Private,
+  IN EFI_SMBIOS_ENTRY  *SmbiosEntry,
+  IN BOOLEAN           Add
+  )
+{
+  UINTN  StructureSize;
+
+  StructureSize = SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER);
+  if (SmbiosEntry->Smbios32BitTable) {
+    ASSERT (Add || (Private->Table32BitLength >= StructureSize));
+    Private->Table32BitLength = Add ? Private->Table32BitLength + StructureSize : Private->Table32BitLength - StructureSize;
+  }
+
+  if (SmbiosEntry->Smbios64BitTable) {
+    ASSERT (Add || (Private->Table64BitLength >= StructureSize));
+    Private->Table64BitLength = Add ? Private->Table64BitLength + StructureSize : Private->Table64BitLength - StructureSize;
+  }
+}
+
+/**
+  Rebuild the SMBIOS tables after a record in them has changed. If the
+  construction of the tables is deferred, only record which of them must be
+  rebuilt.
+
+  @param  Smbios32BitTable    The flag to update 32-bit table.
+  @param  Smbios64BitTable    The flag to update 64-bit table.
+
+**/
+VOID
+SmbiosUpdateTables (
+  IN BOOLEAN  Smbios32BitTable,
+  IN BOOLEAN  Smbios64BitTable
+  )
+{
+  if (!mPrivateData.DeferTableConstruction) {
+    SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+    return;
+  }
+
+  if (Smbios32BitTable) {
+    mPrivateData.Pending32BitTable = TRUE;
+  }
+
+  if (Smbios64BitTable) {
+    mPrivateData.Pending64BitTable = TRUE;
+  }
+}
+
+/**
+  Stop deferring the construction of the SMBIOS tables, and rebuild the tables
+  whose records have changed while it was deferred.
+
+**/
+VOID
+SmbiosConstructPendingTables (
+  VOID
+  )
+{
+  mPrivateData.DeferTableConstruction = FALSE;
+  if (mPrivateData.Pending32BitTable || mPrivateData.Pending64BitTable) {
+    SmbiosTableConstruction (mPrivateData.Pending32BitTable, mPrivateData.Pending64BitTable);
+    mPrivateData.Pending32BitTable = FALSE;
+    mPrivateData.Pending64BitTable = FALSE;
+  }
 }
 
 /**
@@ -313,22 +393,26 @@ GetAvailableSmbiosHandle (
   IN OUT   EFI_SMBIOS_HANDLE    *Handle
   )
 {
-  LIST_ENTRY         *Head;
   SMBIOS_INSTANCE    *Private;
   EFI_SMBIOS_HANDLE  MaxSmbiosHandle;
   EFI_SMBIOS_HANDLE  AvailableHandle;
 
   GetMaxSmbiosHandle (This, &MaxSmbiosHandle);
 
+  //
+  // The handles below FreeHandleHint are in use, so the search for the lowest
+  // available handle starts there.
+  //
   Private = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head    = &Private->AllocatedHandleListHead;
-  for (AvailableHandle = 0; AvailableHandle < MaxSmbiosHandle; AvailableHandle++) {
-    if (!CheckSmbiosHandleExistance (Head, AvailableHandle)) {
-      *Handle = AvailableHandle;
+  for (AvailableHandle = Private->FreeHandleHint; AvailableHandle < MaxSmbiosHandle; AvailableHandle++) {
+    if (SmbiosFindEntry (Private, AvailableHandle) == NULL) {
+      Private->FreeHandleHint = AvailableHandle;
+      *Handle                 = AvailableHandle;
       return EFI_SUCCESS;
     }
   }
 
+  Private->FreeHandleHint = MaxSmbiosHandle;
   return EFI_OUT_OF_RESOURCES;
 }
 
@@ -366,11 +450,9 @@ SmbiosAdd (
   UINTN                     StructureSize;
   UINTN                     NumberOfStrings;
   EFI_STATUS                Status;
-  LIST_ENTRY                *Head;
   SMBIOS_INSTANCE           *Private;
   EFI_SMBIOS_ENTRY          *SmbiosEntry;
   EFI_SMBIOS_HANDLE         MaxSmbiosHandle;
-  SMBIOS_HANDLE_ENTRY       *HandleEntry;
   EFI_SMBIOS_RECORD_HEADER  *InternalRecord;
   BOOLEAN                   Smbios32BitTable;
   BOOLEAN                   Smbios64BitTable;
@@ -383,8 +465,7 @@ SmbiosAdd (
   //
   // Check whether SmbiosHandle is already in use
   //
-  Head = &Private->AllocatedHandleListHead;
-  if ((*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) && CheckSmbiosHandleExistance (Head, *SmbiosHandle)) {
+  if ((*SmbiosHandle != SMBIOS_HANDLE_PI_RESERVED) && (SmbiosFindEntry (Private, *SmbiosHandle) != NULL)) {
     return EFI_ALREADY_STARTED;
   }
 
@@ -424,9 +505,7 @@ SmbiosAdd (
     // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
     // which is a WORD field limited to 65,535 bytes. So the max size of 32-bit table should not exceed 65,535 bytes.
     //
-    if ((EntryPointStructure != NULL) &&
-        (EntryPointStructure->TableLength + StructureSize > SMBIOS_TABLE_MAX_LENGTH))
-    {
+    if (Private->Table32BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_TABLE_MAX_LENGTH) {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Total length exceeds max 32-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       Smbios32BitTable = TRUE;
@@ -442,9 +521,7 @@ SmbiosAdd (
     // For SMBIOS 64-bit table, Structure table maximum size in SMBIOS 3.0 (64-bit) Entry Point
     // is a DWORD field limited to 0xFFFFFFFF bytes. So the max size of 64-bit table should not exceed 0xFFFFFFFF bytes.
     //
-    if ((Smbios30EntryPointStructure != NULL) &&
-        (Smbios30EntryPointStructure->TableMaximumSize + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH))
-    {
+    if (Private->Table64BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Total length exceeds max 64-bit table length with type = %d size = 0x%x\n", Record->Type, StructureSize));
     } else {
       DEBUG ((DEBUG_INFO, "SmbiosAdd: Smbios type %d with size 0x%x is added to 64-bit table\n", Record->Type, StructureSize));
@@ -479,19 +556,6 @@ SmbiosAdd (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  HandleEntry = AllocateZeroPool (sizeof (SMBIOS_HANDLE_ENTRY));
-  if (HandleEntry == NULL) {
-    EfiReleaseLock (&Private->DataLock);
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  //
-  // Build Handle Entry and insert into linked list
-  //
-  HandleEntry->Signature    = SMBIOS_HANDLE_ENTRY_SIGNATURE;
-  HandleEntry->SmbiosHandle = *SmbiosHandle;
-  InsertTailList (&Private->AllocatedHandleListHead, &HandleEntry->Link);
-
   InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(SmbiosEntry + 1);
   Raw            = (VOID *)(InternalRecord + 1);
 
@@ -516,13 +580,19 @@ SmbiosAdd (
   CopyMem (Raw, Record, StructureSize);
   ((EFI_SMBIOS_TABLE_HEADER *)Raw)->Handle = *SmbiosHandle;
 
+  //
+  // Index the record by its handle
+  //
+  InsertTailList (&Private->HandleHashTable[SMBIOS_HANDLE_HASH (*SmbiosHandle)], &SmbiosEntry->HandleLink);
+  SmbiosUpdateTableLength (Private, SmbiosEntry, TRUE);
+
   //
   // Some UEFI drivers (such as network) need some information in SMBIOS table.
   // Here we create SMBIOS table and publish it in
   // configuration table, so other UEFI drivers can get SMBIOS table from
   // configuration table without depending on PI SMBIOS protocol.
   //
-  SmbiosTableConstruction (Smbios32BitTable, Smbios64BitTable);
+  SmbiosUpdateTables (Smbios32BitTable, Smbios64BitTable);
 
   //
   // Leave critical section
@@ -559,10 +629,9 @@ SmbiosUpdateString (
   UINTN                     StrIndex;
   UINTN                     TargetStrOffset;
   UINTN                     NewEntrySize;
+  UINTN                     StructureSize;
   CHAR8                     *StrStart;
   VOID                      *Raw;
-  LIST_ENTRY                *Link;
-  LIST_ENTRY                *Head;
   EFI_STATUS                Status;
   SMBIOS_INSTANCE           *Private;
   EFI_SMBIOS_ENTRY          *SmbiosEntry;
@@ -623,170 +692,169 @@ SmbiosUpdateString (
     return Status;
   }
 
-  Head = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK (Link);
-    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
-
-    if (Record->Handle == *SmbiosHandle) {
-      //
-      // Find out the specified SMBIOS record
-      //
-      if (*StringNumber > SmbiosEntry->RecordHeader->NumberOfStrings) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_NOT_FOUND;
-      }
-
-      //
-      // Point to unformed string section
-      //
-      StrStart = (CHAR8 *)Record + Record->Length;
+  SmbiosEntry = SmbiosFindEntry (Private, *SmbiosHandle);
+  if (SmbiosEntry == NULL) {
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_INVALID_PARAMETER;
+  }
 
-      for (StrIndex = 1, TargetStrOffset = 0; StrIndex < *StringNumber; StrStart++, TargetStrOffset++) {
-        //
-        // A string ends in 00h
-        //
-        if (*StrStart == 0) {
-          StrIndex++;
-        }
+  Record = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
 
-        //
-        // String section ends in double-null (0000h)
-        //
-        if ((*StrStart == 0) && (*(StrStart + 1) == 0)) {
-          EfiReleaseLock (&Private->DataLock);
-          return EFI_NOT_FOUND;
-        }
-      }
+  if (*StringNumber > SmbiosEntry->RecordHeader->NumberOfStrings) {
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_NOT_FOUND;
+  }
 
-      if (*StrStart == 0) {
-        StrStart++;
-        TargetStrOffset++;
-      }
+  //
+  // Point to unformed string section
+  //
+  StrStart = (CHAR8 *)Record + Record->Length;
 
-      //
-      // Now we get the string target
-      //
-      TargetStrLen = AsciiStrLen (StrStart);
-      if (InputStrLen == TargetStrLen) {
-        AsciiStrCpyS (StrStart, TargetStrLen + 1, String);
-        //
-        // Some UEFI drivers (such as network) need some information in SMBIOS table.
-        // Here we create SMBIOS table and publish it in
-        // configuration table, so other UEFI drivers can get SMBIOS table from
-        // configuration table without depending on PI SMBIOS protocol.
-        //
-        SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_SUCCESS;
-      }
+  for (StrIndex = 1, TargetStrOffset = 0; StrIndex < *StringNumber; StrStart++, TargetStrOffset++) {
+    //
+    // A string ends in 00h
+    //
+    if (*StrStart == 0) {
+      StrIndex++;
+    }
 
-      SmbiosEntry->Smbios32BitTable = FALSE;
-      SmbiosEntry->Smbios64BitTable = FALSE;
-      if ((This->MajorVersion < 0x3) ||
-          ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT0) == BIT0)))
-      {
-        //
-        // 32-bit table is produced, check the valid length.
-        //
-        if ((EntryPointStructure != NULL) &&
-            (EntryPointStructure->TableLength + InputStrLen - TargetStrLen > SMBIOS_TABLE_MAX_LENGTH))
-        {
-          //
-          // The length of the entire structure table (including all strings) must be reported
-          // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
-          // which is a WORD field limited to 65,535 bytes.
-          //
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 32-bit table length\n"));
-        } else {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 32-bit table\n"));
-          SmbiosEntry->Smbios32BitTable = TRUE;
-        }
-      }
+    //
+    // String section ends in double-null (0000h)
+    //
+    if ((*StrStart == 0) && (*(StrStart + 1) == 0)) {
+      EfiReleaseLock (&Private->DataLock);
+      return EFI_NOT_FOUND;
+    }
+  }
 
-      if ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT1) == BIT1)) {
-        //
-        // 64-bit table is produced, check the valid length.
-        //
-        if ((Smbios30EntryPointStructure != NULL) &&
-            (Smbios30EntryPointStructure->TableMaximumSize + InputStrLen - TargetStrLen > SMBIOS_3_0_TABLE_MAX_LENGTH))
-        {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 64-bit table length\n"));
-        } else {
-          DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 64-bit table\n"));
-          SmbiosEntry->Smbios64BitTable = TRUE;
-        }
-      }
+  if (*StrStart == 0) {
+    StrStart++;
+    TargetStrOffset++;
+  }
 
-      if ((!SmbiosEntry->Smbios32BitTable) && (!SmbiosEntry->Smbios64BitTable)) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_UNSUPPORTED;
-      }
+  //
+  // Now we get the string target
+  //
+  TargetStrLen = AsciiStrLen (StrStart);
+  if (InputStrLen == TargetStrLen) {
+    AsciiStrCpyS (StrStart, TargetStrLen + 1, String);
+    //
+    // Some UEFI drivers (such as network) need some information in SMBIOS table.
+    // Here we create SMBIOS table and publish it in
+    // configuration table, so other UEFI drivers can get SMBIOS table from
+    // configuration table without depending on PI SMBIOS protocol.
+    //
+    SmbiosUpdateTables (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_SUCCESS;
+  }
 
+  //
+  // Decide again which tables the resized record fits in.
+  //
+  StructureSize = SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) + InputStrLen - TargetStrLen;
+  SmbiosUpdateTableLength (Private, SmbiosEntry, FALSE);
+  SmbiosEntry->Smbios32BitTable = FALSE;
+  SmbiosEntry->Smbios64BitTable = FALSE;
+  if ((This->MajorVersion < 0x3) ||
+      ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT0) == BIT0)))
+  {
+    //
+    // 32-bit table is produced, check the valid length.
+    //
+    if (Private->Table32BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_TABLE_MAX_LENGTH) {
       //
-      // Original string buffer size is not exactly match input string length.
-      // Re-allocate buffer is needed.
+      // The length of the entire structure table (including all strings) must be reported
+      // in the Structure Table Length field of the SMBIOS Structure Table Entry Point,
+      // which is a WORD field limited to 65,535 bytes.
       //
-      NewEntrySize       = SmbiosEntry->RecordSize + InputStrLen - TargetStrLen;
-      ResizedSmbiosEntry = AllocateZeroPool (NewEntrySize);
+      DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 32-bit table length\n"));
+    } else {
+      DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 32-bit table\n"));
+      SmbiosEntry->Smbios32BitTable = TRUE;
+    }
+  }
 
-      if (ResizedSmbiosEntry == NULL) {
-        EfiReleaseLock (&Private->DataLock);
-        return EFI_OUT_OF_RESOURCES;
-      }
+  if ((This->MajorVersion >= 0x3) && ((PcdGet32 (PcdSmbiosEntryPointProvideMethod) & BIT1) == BIT1)) {
+    //
+    // 64-bit table is produced, check the valid length.
+    //
+    if (Private->Table64BitLength + sizeof (EFI_SMBIOS_TABLE_END_STRUCTURE) + StructureSize > SMBIOS_3_0_TABLE_MAX_LENGTH) {
+      DEBUG ((DEBUG_INFO, "SmbiosUpdateString: Total length exceeds max 64-bit table length\n"));
+    } else {
+      DEBUG ((DEBUG_INFO, "SmbiosUpdateString: New smbios record add to 64-bit table\n"));
+      SmbiosEntry->Smbios64BitTable = TRUE;
+    }
+  }
 
-      InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(ResizedSmbiosEntry + 1);
-      Raw            = (VOID *)(InternalRecord + 1);
+  if ((!SmbiosEntry->Smbios32BitTable) && (!SmbiosEntry->Smbios64BitTable)) {
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_UNSUPPORTED;
+  }
 
-      //
-      // Build internal record Header
-      //
-      InternalRecord->Version         = EFI_SMBIOS_RECORD_HEADER_VERSION;
-      InternalRecord->HeaderSize      = (UINT16)sizeof (EFI_SMBIOS_RECORD_HEADER);
-      InternalRecord->RecordSize      = SmbiosEntry->RecordHeader->RecordSize + InputStrLen - TargetStrLen;
-      InternalRecord->ProducerHandle  = SmbiosEntry->RecordHeader->ProducerHandle;
-      InternalRecord->NumberOfStrings = SmbiosEntry->RecordHeader->NumberOfStrings;
+  //
+  // Original string buffer size is not exactly match input string length.
+  // Re-allocate buffer is needed.
+  //
+  NewEntrySize       = SmbiosEntry->RecordSize + InputStrLen - TargetStrLen;
+  ResizedSmbiosEntry = AllocateZeroPool (NewEntrySize);
 
-      //
-      // Copy SMBIOS structure and optional strings.
-      //
-      CopyMem (Raw, SmbiosEntry->RecordHeader + 1, Record->Length + TargetStrOffset);
-      CopyMem ((VOID *)((UINTN)Raw + Record->Length + TargetStrOffset), String, InputStrLen + 1);
-      CopyMem (
-        (CHAR8 *)((UINTN)Raw + Record->Length + TargetStrOffset + InputStrLen + 1),
-        (CHAR8 *)Record + Record->Length + TargetStrOffset + TargetStrLen + 1,
-        SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) - Record->Length - TargetStrOffset - TargetStrLen - 1
-        );
+  if (ResizedSmbiosEntry == NULL) {
+    SmbiosUpdateTableLength (Private, SmbiosEntry, TRUE);
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-      //
-      // Insert new record
-      //
-      ResizedSmbiosEntry->Signature        = EFI_SMBIOS_ENTRY_SIGNATURE;
-      ResizedSmbiosEntry->RecordHeader     = InternalRecord;
-      ResizedSmbiosEntry->RecordSize       = NewEntrySize;
-      ResizedSmbiosEntry->Smbios32BitTable = SmbiosEntry->Smbios32BitTable;
-      ResizedSmbiosEntry->Smbios64BitTable = SmbiosEntry->Smbios64BitTable;
-      InsertTailList (Link->ForwardLink, &ResizedSmbiosEntry->Link);
+  InternalRecord = (EFI_SMBIOS_RECORD_HEADER *)(ResizedSmbiosEntry + 1);
+  Raw            = (VOID *)(InternalRecord + 1);
 
-      //
-      // Remove old record
-      //
-      RemoveEntryList (Link);
-      FreePool (SmbiosEntry);
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
-      //
-      SmbiosTableConstruction (ResizedSmbiosEntry->Smbios32BitTable, ResizedSmbiosEntry->Smbios64BitTable);
-      EfiReleaseLock (&Private->DataLock);
-      return EFI_SUCCESS;
-    }
-  }
+  //
+  // Build internal record Header
+  //
+  InternalRecord->Version         = EFI_SMBIOS_RECORD_HEADER_VERSION;
+  InternalRecord->HeaderSize      = (UINT16)sizeof (EFI_SMBIOS_RECORD_HEADER);
+  InternalRecord->RecordSize      = SmbiosEntry->RecordHeader->RecordSize + InputStrLen - TargetStrLen;
+  InternalRecord->ProducerHandle  = SmbiosEntry->RecordHeader->ProducerHandle;
+  InternalRecord->NumberOfStrings = SmbiosEntry->RecordHeader->NumberOfStrings;
+
+  //
+  // Copy SMBIOS structure and optional strings.
+  //
+  CopyMem (Raw, SmbiosEntry->RecordHeader + 1, Record->Length + TargetStrOffset);
+  CopyMem ((VOID *)((UINTN)Raw + Record->Length + TargetStrOffset), String, InputStrLen + 1);
+  CopyMem (
+    (CHAR8 *)((UINTN)Raw + Record->Length + TargetStrOffset + InputStrLen + 1),
+    (CHAR8 *)Record + Record->Length + TargetStrOffset + TargetStrLen + 1,
+    SmbiosEntry->RecordHeader->RecordSize - sizeof (EFI_SMBIOS_RECORD_HEADER) - Record->Length - TargetStrOffset - TargetStrLen - 1
+    );
+
+  //
+  // Insert new record
+  //
+  ResizedSmbiosEntry->Signature        = EFI_SMBIOS_ENTRY_SIGNATURE;
+  ResizedSmbiosEntry->RecordHeader     = InternalRecord;
+  ResizedSmbiosEntry->RecordSize       = NewEntrySize;
+  ResizedSmbiosEntry->Smbios32BitTable = SmbiosEntry->Smbios32BitTable;
+  ResizedSmbiosEntry->Smbios64BitTable = SmbiosEntry->Smbios64BitTable;
+  InsertTailList (SmbiosEntry->Link.ForwardLink, &ResizedSmbiosEntry->Link);
+  InsertTailList (SmbiosEntry->HandleLink.ForwardLink, &ResizedSmbiosEntry->HandleLink);
+  SmbiosUpdateTableLength (Private, ResizedSmbiosEntry, TRUE);
 
+  //
+  // Remove old record
+  //
+  RemoveEntryList (&SmbiosEntry->Link);
+  RemoveEntryList (&SmbiosEntry->HandleLink);
+  FreePool (SmbiosEntry);
+  //
+  // Some UEFI drivers (such as network) need some information in SMBIOS table.
+  // Here we create SMBIOS table and publish it in
+  // configuration table, so other UEFI drivers can get SMBIOS table from
+  // configuration table without depending on PI SMBIOS protocol.
+  //
+  SmbiosUpdateTables (ResizedSmbiosEntry->Smbios32BitTable, ResizedSmbiosEntry->Smbios64BitTable);
   EfiReleaseLock (&Private->DataLock);
-  return EFI_INVALID_PARAMETER;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -806,14 +874,10 @@ SmbiosRemove (
   IN EFI_SMBIOS_HANDLE          SmbiosHandle
   )
 {
-  LIST_ENTRY               *Link;
-  LIST_ENTRY               *Head;
-  EFI_STATUS               Status;
-  EFI_SMBIOS_HANDLE        MaxSmbiosHandle;
-  SMBIOS_INSTANCE          *Private;
-  EFI_SMBIOS_ENTRY         *SmbiosEntry;
-  SMBIOS_HANDLE_ENTRY      *HandleEntry;
-  EFI_SMBIOS_TABLE_HEADER  *Record;
+  EFI_STATUS         Status;
+  EFI_SMBIOS_HANDLE  MaxSmbiosHandle;
+  SMBIOS_INSTANCE    *Private;
+  EFI_SMBIOS_ENTRY   *SmbiosEntry;
 
   //
   // Check args validity
@@ -833,57 +897,46 @@ SmbiosRemove (
     return Status;
   }
 
-  Head = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry = SMBIOS_ENTRY_FROM_LINK (Link);
-    Record      = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
-    if (Record->Handle == SmbiosHandle) {
-      //
-      // Remove specified smobios record from DataList
-      //
-      RemoveEntryList (Link);
-      //
-      // Remove this handle from AllocatedHandleList
-      //
-      Head = &Private->AllocatedHandleListHead;
-      for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-        HandleEntry = SMBIOS_HANDLE_ENTRY_FROM_LINK (Link);
-        if (HandleEntry->SmbiosHandle == SmbiosHandle) {
-          RemoveEntryList (Link);
-          FreePool (HandleEntry);
-          break;
-        }
-      }
+  SmbiosEntry = SmbiosFindEntry (Private, SmbiosHandle);
+  if (SmbiosEntry == NULL) {
+    //
+    // Leave critical section
+    //
+    EfiReleaseLock (&Private->DataLock);
+    return EFI_INVALID_PARAMETER;
+  }
 
-      //
-      // Some UEFI drivers (such as network) need some information in SMBIOS table.
-      // Here we create SMBIOS table and publish it in
-      // configuration table, so other UEFI drivers can get SMBIOS table from
-      // configuration table without depending on PI SMBIOS protocol.
-      //
-      if (SmbiosEntry->Smbios32BitTable) {
-        DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 32-bit table\n"));
-      }
+  //
+  // Remove specified smobios record from DataList and from the handle hash table
+  //
+  RemoveEntryList (&SmbiosEntry->Link);
+  RemoveEntryList (&SmbiosEntry->HandleLink);
+  SmbiosUpdateTableLength (Private, SmbiosEntry, FALSE);
+  if (SmbiosHandle < Private->FreeHandleHint) {
+    Private->FreeHandleHint = SmbiosHandle;
+  }
 
-      if (SmbiosEntry->Smbios64BitTable) {
-        DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 64-bit table\n"));
-      }
+  //
+  // Some UEFI drivers (such as network) need some information in SMBIOS table.
+  // Here we create SMBIOS table and publish it in
+  // configuration table, so other UEFI drivers can get SMBIOS table from
+  // configuration table without depending on PI SMBIOS protocol.
+  //
+  if (SmbiosEntry->Smbios32BitTable) {
+    DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 32-bit table\n"));
+  }
 
-      //
-      // Update the whole SMBIOS table again based on which table the removed SMBIOS record is in.
-      //
-      SmbiosTableConstruction (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
-      FreePool (SmbiosEntry);
-      EfiReleaseLock (&Private->DataLock);
-      return EFI_SUCCESS;
-    }
+  if (SmbiosEntry->Smbios64BitTable) {
+    DEBUG ((DEBUG_INFO, "SmbiosRemove: remove from 64-bit table\n"));
   }
 
   //
-  // Leave critical section
+  // Update the whole SMBIOS table again based on which table the removed SMBIOS record is in.
   //
+  SmbiosUpdateTables (SmbiosEntry->Smbios32BitTable, SmbiosEntry->Smbios64BitTable);
+  FreePool (SmbiosEntry);
   EfiReleaseLock (&Private->DataLock);
-  return EFI_INVALID_PARAMETER;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -914,7 +967,6 @@ SmbiosGetNext (
   OUT EFI_HANDLE                *ProducerHandle OPTIONAL
   )
 {
-  BOOLEAN                  StartPointFound;
   LIST_ENTRY               *Link;
   LIST_ENTRY               *Head;
   SMBIOS_INSTANCE          *Private;
@@ -925,51 +977,35 @@ SmbiosGetNext (
     return EFI_INVALID_PARAMETER;
   }
 
-  StartPointFound = FALSE;
-  Private         = SMBIOS_INSTANCE_FROM_THIS (This);
-  Head            = &Private->DataListHead;
-  for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
-    SmbiosEntry       = SMBIOS_ENTRY_FROM_LINK (Link);
-    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
-
+  Private = SMBIOS_INSTANCE_FROM_THIS (This);
+  Head    = &Private->DataListHead;
+  if (*SmbiosHandle == SMBIOS_HANDLE_PI_RESERVED) {
     //
     // If SmbiosHandle is 0xFFFE, the first matched SMBIOS record handle will be returned
     //
-    if (*SmbiosHandle == SMBIOS_HANDLE_PI_RESERVED) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
-      }
-
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record       = SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
-      }
-
-      return EFI_SUCCESS;
-    }
-
+    Link = Head->ForwardLink;
+  } else {
     //
     // Start this round search from the next SMBIOS handle
     //
-    if (!StartPointFound && (*SmbiosHandle == SmbiosTableHeader->Handle)) {
-      StartPointFound = TRUE;
+    SmbiosEntry = SmbiosFindEntry (Private, *SmbiosHandle);
+    Link        = (SmbiosEntry == NULL) ? Head : SmbiosEntry->Link.ForwardLink;
+  }
+
+  for ( ; Link != Head; Link = Link->ForwardLink) {
+    SmbiosEntry       = SMBIOS_ENTRY_FROM_LINK (Link);
+    SmbiosTableHeader = (EFI_SMBIOS_TABLE_HEADER *)(SmbiosEntry->RecordHeader + 1);
+    if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
       continue;
     }
 
-    if (StartPointFound) {
-      if ((Type != NULL) && (*Type != SmbiosTableHeader->Type)) {
-        continue;
-      }
-
-      *SmbiosHandle = SmbiosTableHeader->Handle;
-      *Record       = SmbiosTableHeader;
-      if (ProducerHandle != NULL) {
-        *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
-      }
-
-      return EFI_SUCCESS;
+    *SmbiosHandle = SmbiosTableHeader->Handle;
+    *Record       = SmbiosTableHeader;
+    if (ProducerHandle != NULL) {
+      *ProducerHandle = SmbiosEntry->RecordHeader->ProducerHandle;
     }
+
+    return EFI_SUCCESS;
   }
 
   *SmbiosHandle = SMBIOS_HANDLE_PI_RESERVED;
@@ -1698,6 +1734,7 @@ RetrieveSmbiosFromHob (
   EFI_STATUS                        Status;
   UINTN                             Index;
   SMBIOS_STRUCTURE_POINTER          Smbios;
+  BOOLEAN                           DeferTableConstruction;
   EFI_HOB_GUID_TYPE                 *GuidHob;
   UNIVERSAL_PAYLOAD_SMBIOS_TABLE    *SmBiosTableAdress;
   UNIVERSAL_PAYLOAD_GENERIC_HEADER  *GenericHeader;
@@ -1711,6 +1748,13 @@ RetrieveSmbiosFromHob (
   MajorVersion = 0;
   MinorVersion = 0;
 
+  //
+  // The records of the HOB are added in one batch, and the tables are
+  // built once after the last of them.
+  //
+  DeferTableConstruction              = mPrivateData.DeferTableConstruction;
+  mPrivateData.DeferTableConstruction = TRUE;
+
   for (Index = 0; Index < ARRAY_SIZE (mIsSmbiosTableValid); Index++) {
     GuidHob = GetFirstGuidHob (mIsSmbiosTableValid[Index].Guid);
     if (GuidHob == NULL) {
@@ -1732,7 +1776,8 @@ RetrieveSmbiosFromHob (
               DEBUG ((DEBUG_ERROR, "RetrieveSmbiosFromHob: Failed to parse preinstalled tables from Guid Hob\n"));
               Status = EFI_UNSUPPORTED;
             } else {
-              return EFI_SUCCESS;
+              Status = EFI_SUCCESS;
+              break;
             }
           }
         }
@@ -1740,9 +1785,36 @@ RetrieveSmbiosFromHob (
     }
   }
 
+  if (!DeferTableConstruction) {
+    SmbiosConstructPendingTables ();
+  }
+
   return Status;
 }
 
+/**
+  Build the SMBIOS tables whose construction has been deferred by
+  PcdSmbiosDeferTableConstruction, before the ReadyToBoot handlers of lower
+  TPL, such as the SMBIOS measurement, read them.
+
+  @param  Event    Event whose notification function is being invoked.
+  @param  Context  Pointer to the notification function's context, not used.
+
+**/
+VOID
+EFIAPI
+SmbiosReadyToBootNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EfiAcquireLock (&mPrivateData.DataLock);
+  SmbiosConstructPendingTables ();
+  EfiReleaseLock (&mPrivateData.DataLock);
+
+  gBS->CloseEvent (Event);
+}
+
 /**
 
   Driver to produce Smbios protocol and pre-allocate 1 page for the final SMBIOS table.
@@ -1762,6 +1834,8 @@ SmbiosDriverEntryPoint (
   )
 {
   EFI_STATUS  Status;
+  UINTN       Index;
+  EFI_EVENT   ReadyToBootEvent;
 
   mPrivateData.Signature           = SMBIOS_INSTANCE_SIGNATURE;
   mPrivateData.Smbios.Add          = SmbiosAdd;
@@ -1772,9 +1846,29 @@ SmbiosDriverEntryPoint (
   mPrivateData.Smbios.MinorVersion = (UINT8)(PcdGet16 (PcdSmbiosVersion) & 0x00ff);
 
   InitializeListHead (&mPrivateData.DataListHead);
-  InitializeListHead (&mPrivateData.AllocatedHandleListHead);
+  for (Index = 0; Index < SMBIOS_HANDLE_HASH_SIZE; Index++) {
+    InitializeListHead (&mPrivateData.HandleHashTable[Index]);
+  }
+
   EfiInitializeLock (&mPrivateData.DataLock, TPL_NOTIFY);
 
+  if (FeaturePcdGet (PcdSmbiosDeferTableConstruction)) {
+    //
+    // Build the tables once at ReadyToBoot instead of after every change of a
+    // record. The notification runs at TPL_NOTIFY, ahead of the ReadyToBoot
+    // consumers of the tables.
+    //
+    Status = EfiCreateEventReadyToBootEx (
+               TPL_NOTIFY,
+               SmbiosReadyToBootNotify,
+               NULL,
+               &ReadyToBootEvent
+               );
+    if (!EFI_ERROR (Status)) {
+      mPrivateData.DeferTableConstruction = TRUE;
+    }
+  }
+
   //
   // Make a new handle and install the protocol
   //
@@ -26,6 +26,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HobLib.h>
 #include <UniversalPayload/SmbiosTable.h>
 
+//
+// The number of buckets of the hash table that indexes the SMBIOS records by handle.
+//
+#define SMBIOS_HANDLE_HASH_SIZE  256
+#define SMBIOS_HANDLE_HASH(Handle)  ((Handle) & (SMBIOS_HANDLE_HASH_SIZE - 1))
+
 #define SMBIOS_INSTANCE_SIGNATURE  SIGNATURE_32 ('S', 'B', 'i', 's')
 typedef struct {
   UINT32                 Signature;
@@ -43,9 +49,25 @@ typedef struct {
   //
   LIST_ENTRY             DataListHead;
   //
-  // List of allocated SMBIOS handle.
+  // Hash table of EFI_SMBIOS_ENTRY structures, indexed by the handle of the record.
+  //
+  LIST_ENTRY             HandleHashTable[SMBIOS_HANDLE_HASH_SIZE];
+  //
+  // All the handles below FreeHandleHint are in use.
   //
-  LIST_ENTRY             AllocatedHandleListHead;
+  EFI_SMBIOS_HANDLE      FreeHandleHint;
+  //
+  // Total size of the records in the 32-bit and 64-bit tables, without the End-Of-Table structure.
+  //
+  UINTN                  Table32BitLength;
+  UINTN                  Table64BitLength;
+  //
+  // When TRUE, the tables are not rebuilt as records change. Pending32BitTable and
+  // Pending64BitTable record which tables must be rebuilt once it is FALSE again.
+  //
+  BOOLEAN                DeferTableConstruction;
+  BOOLEAN                Pending32BitTable;
+  BOOLEAN                Pending64BitTable;
 } SMBIOS_INSTANCE;
 
 #define SMBIOS_INSTANCE_FROM_THIS(this)  CR (this, SMBIOS_INSTANCE, Smbios, SMBIOS_INSTANCE_SIGNATURE)
@@ -74,6 +96,10 @@ typedef struct {
 typedef struct {
   UINT32                      Signature;
   LIST_ENTRY                  Link;
+  //
+  // Link in the HandleHashTable bucket of the record handle.
+  //
+  LIST_ENTRY                  HandleLink;
   EFI_SMBIOS_RECORD_HEADER    *RecordHeader;
   UINTN                       RecordSize;
   //
@@ -83,23 +109,8 @@ typedef struct {
   BOOLEAN                     Smbios64BitTable;
 } EFI_SMBIOS_ENTRY;
 
-#define SMBIOS_ENTRY_FROM_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, Link, EFI_SMBIOS_ENTRY_SIGNATURE)
-
-//
-// Private data to contain the Smbios handle that already allocated.
-//
-#define SMBIOS_HANDLE_ENTRY_SIGNATURE  SIGNATURE_32 ('S', 'h', 'r', 'd')
-
-typedef struct {
-  UINT32               Signature;
-  LIST_ENTRY           Link;
-  //
-  // Filter driver will register what record guid filter should be used.
-  //
-  EFI_SMBIOS_HANDLE    SmbiosHandle;
-} SMBIOS_HANDLE_ENTRY;
-
-#define SMBIOS_HANDLE_ENTRY_FROM_LINK(link)  CR (link, SMBIOS_HANDLE_ENTRY, Link, SMBIOS_HANDLE_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_LINK(link)         CR (link, EFI_SMBIOS_ENTRY, Link, EFI_SMBIOS_ENTRY_SIGNATURE)
+#define SMBIOS_ENTRY_FROM_HANDLE_LINK(link)  CR (link, EFI_SMBIOS_ENTRY, HandleLink, EFI_SMBIOS_ENTRY_SIGNATURE)
 
 typedef struct {
   EFI_SMBIOS_TABLE_HEADER    Header;
@@ -0,0 +1,133 @@
+/** @file
+  PEI memory debug log status code worker.
+
+  The text that the serial worker would send to the serial port is appended to
+  a ring in a GUIDed HOB, at memory speed. The DXE status code handler carries
+  the log on.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "StatusCodeHandlerPei.h"
+
+//
+// The largest log that fits in a GUIDed HOB.
+//
+#define MAX_PEI_DEBUG_LOG_SIZE  (63 * SIZE_1KB)
+
+/**
+  Append text to the ring of a memory debug log, overwriting the oldest text
+  once the ring is full.
+
+  @param  DebugLog         The memory debug log.
+  @param  Text             The text to append.
+  @param  Length           The length in bytes of Text.
+
+**/
+STATIC
+VOID
+DebugLogAppend (
+  IN OUT MEMORY_DEBUG_LOG_HEADER  *DebugLog,
+  IN CONST CHAR8                  *Text,
+  IN UINTN                        Length
+  )
+{
+  UINT8   *Ring;
+  UINT32  Offset;
+  UINTN   Chunk;
+
+  if (Length > DebugLog->Size) {
+    Text              += Length - DebugLog->Size;
+    DebugLog->Written += Length - DebugLog->Size;
+    Length             = DebugLog->Size;
+  }
+
+  Ring = (UINT8 *)(DebugLog + 1);
+  DivU64x32Remainder (DebugLog->Written, DebugLog->Size, &Offset);
+  Chunk = MIN (Length, DebugLog->Size - Offset);
+  CopyMem (Ring + Offset, Text, Chunk);
+  CopyMem (Ring, Text + Chunk, Length - Chunk);
+  DebugLog->Written += Length;
+}
+
+/**
+  Create the memory debug log GUID'ed HOB as initialization for memory debug log worker.
+
+  @retval EFI_SUCCESS           The GUID'ed HOB is created successfully.
+  @retval EFI_OUT_OF_RESOURCES  The GUID'ed HOB cannot be created.
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  )
+{
+  MEMORY_DEBUG_LOG_HEADER  *DebugLog;
+  UINT32                   Size;
+
+  Size     = MIN (PcdGet16 (PcdStatusCodeDebugLogSize) * SIZE_1KB, MAX_PEI_DEBUG_LOG_SIZE);
+  DebugLog = BuildGuidHob (&gEdkiiMemoryDebugLogGuid, sizeof (MEMORY_DEBUG_LOG_HEADER) + Size);
+  if (DebugLog == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DebugLog->Size     = Size;
+  DebugLog->Reserved = 0;
+  DebugLog->Written  = 0;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Convert status code value and extended data to readable ASCII string, append
+  the string to the memory debug log GUID'ed HOB.
+
+  @param  PeiServices      An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or
+                           software entity. This includes information about the class and
+                           subclass that is used to classify the entity as well as an operation.
+                           For progress codes, the operation is the current activity.
+                           For error codes, it is the exception.For debug codes,it is not defined at this time.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. A system may contain multiple entities that match a class/subclass
+                           pairing. The instance differentiates between them. An instance of 0 indicates
+                           that instance information is unavailable, not meaningful, or not relevant.
+                           Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      The function always return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogStatusCodeReportWorker (
+  IN CONST  EFI_PEI_SERVICES     **PeiServices,
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+  CHAR8              Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN              CharCount;
+
+  //
+  // The HOB moves when the HOB list is migrated to permanent memory.
+  //
+  GuidHob = GetFirstGuidHob (&gEdkiiMemoryDebugLogGuid);
+  if (GuidHob == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  CharCount = StatusCodeToAscii (CodeType, Value, Instance, CallerId, Data, Buffer, sizeof (Buffer));
+  DebugLogAppend (GET_GUID_HOB_DATA (GuidHob), Buffer, CharCount);
+
+  return EFI_SUCCESS;
+}
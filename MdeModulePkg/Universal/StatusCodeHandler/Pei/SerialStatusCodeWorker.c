@@ -8,9 +8,8 @@
 #include "StatusCodeHandlerPei.h"
 
 /**
-  Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
+  Convert status code value and extended data to readable ASCII string.
 
-  @param  PeiServices      An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
   @param  CodeType         Indicates the type of status code being reported.
   @param  Value            Describes the current status of a hardware or
                            software entity. This includes information about the class and
@@ -26,25 +25,26 @@
                            This parameter allows the status code driver to apply different rules to
                            different callers.
   @param  Data             This optional parameter may be used to pass additional data.
+  @param  Buffer           The buffer that receives the Null-terminated string.
+  @param  BufferSize       The size in bytes of Buffer.
 
-  @retval EFI_SUCCESS      Status code reported to serial I/O successfully.
+  @return The number of characters in Buffer, not including the Null-terminator.
 
 **/
-EFI_STATUS
-EFIAPI
-SerialStatusCodeReportWorker (
-  IN CONST  EFI_PEI_SERVICES     **PeiServices,
+UINTN
+StatusCodeToAscii (
   IN EFI_STATUS_CODE_TYPE        CodeType,
   IN EFI_STATUS_CODE_VALUE       Value,
   IN UINT32                      Instance,
   IN CONST EFI_GUID              *CallerId,
-  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL,
+  OUT CHAR8                      *Buffer,
+  IN UINTN                       BufferSize
   )
 {
   CHAR8      *Filename;
   CHAR8      *Description;
   CHAR8      *Format;
-  CHAR8      Buffer[MAX_DEBUG_MESSAGE_LENGTH];
   UINT32     ErrorLevel;
   UINT32     LineNumber;
   UINTN      CharCount;
@@ -60,7 +60,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "\n\rPEI_ASSERT!: %a (%d): %a\n\r",
                   Filename,
                   LineNumber,
@@ -74,7 +74,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiBSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   Format,
                   Marker
                   );
@@ -84,7 +84,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "ERROR: C%08x:V%08x I%x",
                   CodeType,
                   Value,
@@ -96,7 +96,7 @@ SerialStatusCodeReportWorker (
     if (CallerId != NULL) {
       CharCount += AsciiSPrint (
                      &Buffer[CharCount],
-                     (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                     (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                      " %g",
                      CallerId
                      );
@@ -105,7 +105,7 @@ SerialStatusCodeReportWorker (
     if (Data != NULL) {
       CharCount += AsciiSPrint (
                      &Buffer[CharCount],
-                     (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                     (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                      " %x",
                      Data
                      );
@@ -113,7 +113,7 @@ SerialStatusCodeReportWorker (
 
     CharCount += AsciiSPrint (
                    &Buffer[CharCount],
-                   (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                   (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                    "\n\r"
                    );
   } else if ((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_PROGRESS_CODE) {
@@ -122,7 +122,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "PROGRESS CODE: V%08x I%x\n\r",
                   Value,
                   Instance
@@ -136,7 +136,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "%a",
                   ((EFI_STATUS_CODE_STRING_DATA *)Data)->String.Ascii
                   );
@@ -146,7 +146,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "Undefined: C%08x:V%08x I%x\n\r",
                   CodeType,
                   Value,
@@ -154,6 +154,48 @@ SerialStatusCodeReportWorker (
                   );
   }
 
+  return CharCount;
+}
+
+/**
+  Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
+
+  @param  PeiServices      An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or
+                           software entity. This includes information about the class and
+                           subclass that is used to classify the entity as well as an operation.
+                           For progress codes, the operation is the current activity.
+                           For error codes, it is the exception.For debug codes,it is not defined at this time.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. A system may contain multiple entities that match a class/subclass
+                           pairing. The instance differentiates between them. An instance of 0 indicates
+                           that instance information is unavailable, not meaningful, or not relevant.
+                           Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      Status code reported to serial I/O successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+SerialStatusCodeReportWorker (
+  IN CONST  EFI_PEI_SERVICES     **PeiServices,
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  )
+{
+  CHAR8  Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN  CharCount;
+
+  CharCount = StatusCodeToAscii (CodeType, Value, Instance, CallerId, Data, Buffer, sizeof (Buffer));
+
   //
   // Call SerialPort Lib function to do print.
   //
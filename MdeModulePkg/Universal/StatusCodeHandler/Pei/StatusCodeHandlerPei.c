@@ -44,6 +44,7 @@ StatusCodeHandlerPeiEntry (
   // Dispatch initialization request to sub-statuscode-devices.
   // If enable UseSerial, then initialize serial port.
   // if enable UseMemory, then initialize memory status code worker.
+  // If the debug log has a size, then initialize memory debug log worker.
   //
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
     Status = SerialPortInitialize ();
@@ -59,5 +60,13 @@ StatusCodeHandlerPeiEntry (
     ASSERT_EFI_ERROR (Status);
   }
 
+  if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+    Status = DebugLogStatusCodeInitializeWorker ();
+    if (!EFI_ERROR (Status)) {
+      Status = RscHandlerPpi->Register (DebugLogStatusCodeReportWorker);
+      ASSERT_EFI_ERROR (Status);
+    }
+  }
+
   return EFI_SUCCESS;
 }
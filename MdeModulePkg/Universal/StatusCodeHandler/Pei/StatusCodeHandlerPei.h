@@ -12,9 +12,11 @@
 #include <Ppi/ReportStatusCodeHandler.h>
 
 #include <Guid/MemoryStatusCodeRecord.h>
+#include <Guid/MemoryDebugLog.h>
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Guid/StatusCodeDataTypeDebug.h>
 
+#include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/PrintLib.h>
 #include <Library/ReportStatusCodeLib.h>
@@ -30,6 +32,41 @@
 //
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 
+/**
+  Convert status code value and extended data to readable ASCII string.
+
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or
+                           software entity. This includes information about the class and
+                           subclass that is used to classify the entity as well as an operation.
+                           For progress codes, the operation is the current activity.
+                           For error codes, it is the exception.For debug codes,it is not defined at this time.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. A system may contain multiple entities that match a class/subclass
+                           pairing. The instance differentiates between them. An instance of 0 indicates
+                           that instance information is unavailable, not meaningful, or not relevant.
+                           Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+  @param  Buffer           The buffer that receives the Null-terminated string.
+  @param  BufferSize       The size in bytes of Buffer.
+
+  @return The number of characters in Buffer, not including the Null-terminator.
+
+**/
+UINTN
+StatusCodeToAscii (
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL,
+  OUT CHAR8                      *Buffer,
+  IN UINTN                       BufferSize
+  );
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
 
@@ -112,4 +149,51 @@ MemoryStatusCodeReportWorker (
   IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
   );
 
+/**
+  Create the memory debug log GUID'ed HOB as initialization for memory debug log worker.
+
+  @retval EFI_SUCCESS           The GUID'ed HOB is created successfully.
+  @retval EFI_OUT_OF_RESOURCES  The GUID'ed HOB cannot be created.
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  );
+
+/**
+  Convert status code value and extended data to readable ASCII string, append
+  the string to the memory debug log GUID'ed HOB.
+
+  @param  PeiServices      An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or
+                           software entity. This includes information about the class and
+                           subclass that is used to classify the entity as well as an operation.
+                           For progress codes, the operation is the current activity.
+                           For error codes, it is the exception.For debug codes,it is not defined at this time.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. A system may contain multiple entities that match a class/subclass
+                           pairing. The instance differentiates between them. An instance of 0 indicates
+                           that instance information is unavailable, not meaningful, or not relevant.
+                           Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      The function always return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogStatusCodeReportWorker (
+  IN CONST  EFI_PEI_SERVICES     **PeiServices,
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  );
+
 #endif
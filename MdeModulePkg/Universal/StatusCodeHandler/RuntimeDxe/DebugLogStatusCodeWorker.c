@@ -0,0 +1,144 @@
+/** @file
+  Runtime memory debug log status code worker.
+
+  The text that the serial worker would send to the serial port is appended to
+  a ring in runtime memory, at memory speed, starting with the log of the PEI
+  phase. The ring is installed as a configuration table so that a shell
+  application or the OS can read the log of the boot.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "StatusCodeHandlerRuntimeDxe.h"
+
+MEMORY_DEBUG_LOG_HEADER  *mRtDebugLog;
+
+/**
+  Append text to the ring of a memory debug log, overwriting the oldest text
+  once the ring is full.
+
+  @param  DebugLog         The memory debug log.
+  @param  Text             The text to append.
+  @param  Length           The length in bytes of Text.
+
+**/
+STATIC
+VOID
+DebugLogAppend (
+  IN OUT MEMORY_DEBUG_LOG_HEADER  *DebugLog,
+  IN CONST CHAR8                  *Text,
+  IN UINTN                        Length
+  )
+{
+  UINT8   *Ring;
+  UINT32  Offset;
+  UINTN   Chunk;
+
+  if (Length > DebugLog->Size) {
+    Text              += Length - DebugLog->Size;
+    DebugLog->Written += Length - DebugLog->Size;
+    Length             = DebugLog->Size;
+  }
+
+  Ring = (UINT8 *)(DebugLog + 1);
+  DivU64x32Remainder (DebugLog->Written, DebugLog->Size, &Offset);
+  Chunk = MIN (Length, DebugLog->Size - Offset);
+  CopyMem (Ring + Offset, Text, Chunk);
+  CopyMem (Ring, Text + Chunk, Length - Chunk);
+  DebugLog->Written += Length;
+}
+
+/**
+  Initialize runtime memory debug log as initialization for runtime memory debug log worker.
+
+  The log of the PEI phase, if any, is copied at the start of the runtime log.
+
+  @retval EFI_SUCCESS           Runtime memory debug log successfully initialized.
+  @retval EFI_OUT_OF_RESOURCES  The runtime memory debug log cannot be allocated.
+  @retval others                Errors from gBS->InstallConfigurationTable().
+
+**/
+EFI_STATUS
+RtDebugLogStatusCodeInitializeWorker (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  EFI_HOB_GUID_TYPE        *GuidHob;
+  MEMORY_DEBUG_LOG_HEADER  *PeiDebugLog;
+  UINT8                    *PeiRing;
+  UINT32                   Size;
+  UINT32                   Offset;
+
+  Size        = PcdGet16 (PcdStatusCodeDebugLogSize) * SIZE_1KB;
+  mRtDebugLog = AllocateRuntimePool (sizeof (MEMORY_DEBUG_LOG_HEADER) + Size);
+  if (mRtDebugLog == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mRtDebugLog->Size     = Size;
+  mRtDebugLog->Reserved = 0;
+  mRtDebugLog->Written  = 0;
+
+  //
+  // Carry the PEI log on, from its oldest byte.
+  //
+  GuidHob = GetFirstGuidHob (&gEdkiiMemoryDebugLogGuid);
+  if (GuidHob != NULL) {
+    PeiDebugLog = GET_GUID_HOB_DATA (GuidHob);
+    PeiRing     = (UINT8 *)(PeiDebugLog + 1);
+    if (PeiDebugLog->Written <= PeiDebugLog->Size) {
+      DebugLogAppend (mRtDebugLog, (CHAR8 *)PeiRing, (UINTN)PeiDebugLog->Written);
+    } else {
+      DivU64x32Remainder (PeiDebugLog->Written, PeiDebugLog->Size, &Offset);
+      DebugLogAppend (mRtDebugLog, (CHAR8 *)PeiRing + Offset, PeiDebugLog->Size - Offset);
+      DebugLogAppend (mRtDebugLog, (CHAR8 *)PeiRing, Offset);
+    }
+  }
+
+  Status = gBS->InstallConfigurationTable (&gEdkiiMemoryDebugLogGuid, mRtDebugLog);
+  if (EFI_ERROR (Status)) {
+    FreePool (mRtDebugLog);
+    mRtDebugLog = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Convert status code value and extended data to readable ASCII string, append
+  the string to the runtime memory debug log.
+
+  @param  CodeType                Indicates the type of status code being reported.
+  @param  Value                   Describes the current status of a hardware or software entity.
+                                  This included information about the class and subclass that is used to
+                                  classify the entity as well as an operation.
+  @param  Instance                The enumeration of a hardware or software entity within
+                                  the system. Valid instance numbers start with 1.
+  @param  CallerId                This optional parameter may be used to identify the caller.
+                                  This parameter allows the status code driver to apply different rules to
+                                  different callers.
+  @param  Data                    This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS             Status code successfully recorded in runtime memory debug log.
+
+**/
+EFI_STATUS
+EFIAPI
+RtDebugLogStatusCodeReportWorker (
+  IN EFI_STATUS_CODE_TYPE   CodeType,
+  IN EFI_STATUS_CODE_VALUE  Value,
+  IN UINT32                 Instance,
+  IN EFI_GUID               *CallerId,
+  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
+  )
+{
+  CHAR8  Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN  CharCount;
+
+  CharCount = StatusCodeToAscii (CodeType, Value, Instance, CallerId, Data, Buffer, sizeof (Buffer));
+  DebugLogAppend (mRtDebugLog, Buffer, CharCount);
+
+  return EFI_SUCCESS;
+}
@@ -9,7 +9,7 @@
 #include "StatusCodeHandlerRuntimeDxe.h"
 
 /**
-  Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
+  Convert status code value and extended data to readable ASCII string.
 
   @param  CodeType         Indicates the type of status code being reported.
   @param  Value            Describes the current status of a hardware or software entity.
@@ -21,26 +21,26 @@
                            This parameter allows the status code driver to apply different rules to
                            different callers.
   @param  Data             This optional parameter may be used to pass additional data.
+  @param  Buffer           The buffer that receives the Null-terminated string.
+  @param  BufferSize       The size in bytes of Buffer.
 
-  @retval EFI_SUCCESS      Status code reported to serial I/O successfully.
-  @retval EFI_DEVICE_ERROR EFI serial device cannot work after ExitBootService() is called.
-  @retval EFI_DEVICE_ERROR EFI serial device cannot work with TPL higher than TPL_CALLBACK.
+  @return The number of characters in Buffer, not including the Null-terminator.
 
 **/
-EFI_STATUS
-EFIAPI
-SerialStatusCodeReportWorker (
+UINTN
+StatusCodeToAscii (
   IN EFI_STATUS_CODE_TYPE   CodeType,
   IN EFI_STATUS_CODE_VALUE  Value,
   IN UINT32                 Instance,
   IN EFI_GUID               *CallerId,
-  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
+  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL,
+  OUT CHAR8                 *Buffer,
+  IN UINTN                  BufferSize
   )
 {
   CHAR8      *Filename;
   CHAR8      *Description;
   CHAR8      *Format;
-  CHAR8      Buffer[MAX_DEBUG_MESSAGE_LENGTH];
   UINT32     ErrorLevel;
   UINT32     LineNumber;
   UINTN      CharCount;
@@ -56,7 +56,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "\n\rDXE_ASSERT!: %a (%d): %a\n\r",
                   Filename,
                   LineNumber,
@@ -70,7 +70,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiBSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   Format,
                   Marker
                   );
@@ -80,7 +80,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "ERROR: C%08x:V%08x I%x",
                   CodeType,
                   Value,
@@ -91,7 +91,7 @@ SerialStatusCodeReportWorker (
     if (CallerId != NULL) {
       CharCount += AsciiSPrint (
                      &Buffer[CharCount],
-                     (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                     (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                      " %g",
                      CallerId
                      );
@@ -100,7 +100,7 @@ SerialStatusCodeReportWorker (
     if (Data != NULL) {
       CharCount += AsciiSPrint (
                      &Buffer[CharCount],
-                     (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                     (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                      " %x",
                      Data
                      );
@@ -108,7 +108,7 @@ SerialStatusCodeReportWorker (
 
     CharCount += AsciiSPrint (
                    &Buffer[CharCount],
-                   (sizeof (Buffer) - (sizeof (Buffer[0]) * CharCount)),
+                   (BufferSize - (sizeof (Buffer[0]) * CharCount)),
                    "\n\r"
                    );
   } else if ((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_PROGRESS_CODE) {
@@ -117,7 +117,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "PROGRESS CODE: V%08x I%x\n\r",
                   Value,
                   Instance
@@ -131,7 +131,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "%a",
                   ((EFI_STATUS_CODE_STRING_DATA *)Data)->String.Ascii
                   );
@@ -141,7 +141,7 @@ SerialStatusCodeReportWorker (
     //
     CharCount = AsciiSPrint (
                   Buffer,
-                  sizeof (Buffer),
+                  BufferSize,
                   "Undefined: C%08x:V%08x I%x\n\r",
                   CodeType,
                   Value,
@@ -149,6 +149,43 @@ SerialStatusCodeReportWorker (
                   );
   }
 
+  return CharCount;
+}
+
+/**
+  Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
+
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or software entity.
+                           This included information about the class and subclass that is used to
+                           classify the entity as well as an operation.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      Status code reported to serial I/O successfully.
+  @retval EFI_DEVICE_ERROR EFI serial device cannot work after ExitBootService() is called.
+  @retval EFI_DEVICE_ERROR EFI serial device cannot work with TPL higher than TPL_CALLBACK.
+
+**/
+EFI_STATUS
+EFIAPI
+SerialStatusCodeReportWorker (
+  IN EFI_STATUS_CODE_TYPE   CodeType,
+  IN EFI_STATUS_CODE_VALUE  Value,
+  IN UINT32                 Instance,
+  IN EFI_GUID               *CallerId,
+  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
+  )
+{
+  CHAR8  Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+  UINTN  CharCount;
+
+  CharCount = StatusCodeToAscii (CodeType, Value, Instance, CallerId, Data, Buffer, sizeof (Buffer));
+
   //
   // Call SerialPort Lib function to do print.
   //
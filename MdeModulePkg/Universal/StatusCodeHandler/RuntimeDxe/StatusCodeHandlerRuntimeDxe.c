@@ -51,6 +51,14 @@ VirtualAddressChangeCallBack (
     0,
     (VOID **)&mRtMemoryStatusCodeTable
     );
+
+  //
+  // Convert memory debug log to virtual address;
+  //
+  EfiConvertPointer (
+    0,
+    (VOID **)&mRtDebugLog
+    );
 }
 
 /**
@@ -73,6 +81,7 @@ InitializationDispatcherWorker (
   //
   // If enable UseSerial, then initialize serial port.
   // if enable UseRuntimeMemory, then initialize runtime memory status code worker.
+  // If the debug log has a size, then initialize runtime memory debug log worker.
   //
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
     //
@@ -87,6 +96,13 @@ InitializationDispatcherWorker (
     ASSERT_EFI_ERROR (Status);
   }
 
+  if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+    Status = RtDebugLogStatusCodeInitializeWorker ();
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: no memory debug log - %r\n", __func__, Status));
+    }
+  }
+
   //
   // Replay Status code which saved in GUID'ed HOB to all supported devices.
   //
@@ -176,6 +192,10 @@ StatusCodeHandlerRuntimeDxeEntry (
     mRscHandlerProtocol->Register (RtMemoryStatusCodeReportWorker, TPL_HIGH_LEVEL);
   }
 
+  if (mRtDebugLog != NULL) {
+    mRscHandlerProtocol->Register (RtDebugLogStatusCodeReportWorker, TPL_HIGH_LEVEL);
+  }
+
   Status = gBS->CreateEventEx (
                   EVT_NOTIFY_SIGNAL,
                   TPL_NOTIFY,
@@ -13,11 +13,13 @@
 #include <Protocol/ReportStatusCodeHandler.h>
 
 #include <Guid/MemoryStatusCodeRecord.h>
+#include <Guid/MemoryDebugLog.h>
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Guid/StatusCodeDataTypeDebug.h>
 #include <Guid/EventGroup.h>
 
 #include <Library/SynchronizationLib.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
@@ -36,6 +38,7 @@
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 
 extern RUNTIME_MEMORY_STATUSCODE_HEADER  *mRtMemoryStatusCodeTable;
+extern MEMORY_DEBUG_LOG_HEADER           *mRtDebugLog;
 
 /**
   Locates Serial I/O Protocol as initialization for serial status code worker.
@@ -48,6 +51,36 @@ EfiSerialStatusCodeInitializeWorker (
   VOID
   );
 
+/**
+  Convert status code value and extended data to readable ASCII string.
+
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or software entity.
+                           This included information about the class and subclass that is used to
+                           classify the entity as well as an operation.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+  @param  Buffer           The buffer that receives the Null-terminated string.
+  @param  BufferSize       The size in bytes of Buffer.
+
+  @return The number of characters in Buffer, not including the Null-terminator.
+
+**/
+UINTN
+StatusCodeToAscii (
+  IN EFI_STATUS_CODE_TYPE   CodeType,
+  IN EFI_STATUS_CODE_VALUE  Value,
+  IN UINT32                 Instance,
+  IN EFI_GUID               *CallerId,
+  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL,
+  OUT CHAR8                 *Buffer,
+  IN UINTN                  BufferSize
+  );
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
 
@@ -117,6 +150,49 @@ RtMemoryStatusCodeReportWorker (
   IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
   );
 
+/**
+  Initialize runtime memory debug log as initialization for runtime memory debug log worker.
+
+  The log of the PEI phase, if any, is copied at the start of the runtime log.
+
+  @retval EFI_SUCCESS           Runtime memory debug log successfully initialized.
+  @retval EFI_OUT_OF_RESOURCES  The runtime memory debug log cannot be allocated.
+  @retval others                Errors from gBS->InstallConfigurationTable().
+
+**/
+EFI_STATUS
+RtDebugLogStatusCodeInitializeWorker (
+  VOID
+  );
+
+/**
+  Convert status code value and extended data to readable ASCII string, append
+  the string to the runtime memory debug log.
+
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or software entity.
+                           This included information about the class and subclass that is used to
+                           classify the entity as well as an operation.
+  @param  Instance         The enumeration of a hardware or software entity within
+                           the system. Valid instance numbers start with 1.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+                           This parameter allows the status code driver to apply different rules to
+                           different callers.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      Status code successfully recorded in runtime memory debug log.
+
+**/
+EFI_STATUS
+EFIAPI
+RtDebugLogStatusCodeReportWorker (
+  IN EFI_STATUS_CODE_TYPE   CodeType,
+  IN EFI_STATUS_CODE_VALUE  Value,
+  IN UINT32                 Instance,
+  IN EFI_GUID               *CallerId,
+  IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
+  );
+
 /**
   Unregister status code callback functions only available at boot time from
   report status code router when exiting boot services.
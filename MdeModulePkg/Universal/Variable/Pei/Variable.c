@@ -798,6 +798,188 @@ GetVariableNameOrData (
   CopyMem (Buffer, NameOrData, Size);
 }
 
+/**
+  Hash a variable name and vendor GUID, as the lookup hints do.
+
+  @param  VariableName        Name of the variable.
+  @param  VendorGuid          Vendor GUID of the variable.
+
+  @return The hash of the name and GUID.
+
+**/
+STATIC
+UINT32
+GetVariableLookupHash (
+  IN CONST CHAR16    *VariableName,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  UINT32       Hash;
+  UINTN        Index;
+  CONST UINT8  *Bytes;
+
+  //
+  // FNV-1a.
+  //
+  Hash = 0x811C9DC5;
+  for ( ; *VariableName != 0; VariableName++) {
+    Hash = (Hash ^ (UINT8)*VariableName) * 0x01000193;
+    Hash = (Hash ^ (UINT8)(*VariableName >> 8)) * 0x01000193;
+  }
+
+  Bytes = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Record a variable read from the non-volatile store, so that the DXE or SMM
+  variable module keeps a lookup hint for it.
+
+  @param  VariableName        Name of the variable.
+  @param  VendorGuid          Vendor GUID of the variable.
+
+**/
+STATIC
+VOID
+RecordVariableLookup (
+  IN CONST CHAR16    *VariableName,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  EFI_HOB_GUID_TYPE                  *GuidHob;
+  EDKII_VARIABLE_LOOKUP_HINT_RECORD  *Record;
+  UINT32                             Hash;
+  UINTN                              Index;
+
+  if (!FeaturePcdGet (PcdVariableLookupHintEnable)) {
+    return;
+  }
+
+  GuidHob = GetFirstGuidHob (&gEdkiiVariableLookupHintGuid);
+  if (GuidHob != NULL) {
+    Record = (EDKII_VARIABLE_LOOKUP_HINT_RECORD *)GET_GUID_HOB_DATA (GuidHob);
+  } else {
+    Record = (EDKII_VARIABLE_LOOKUP_HINT_RECORD *)BuildGuidHob (&gEdkiiVariableLookupHintGuid, sizeof (EDKII_VARIABLE_LOOKUP_HINT_RECORD));
+    if (Record == NULL) {
+      return;
+    }
+
+    ZeroMem (Record, sizeof (EDKII_VARIABLE_LOOKUP_HINT_RECORD));
+  }
+
+  Hash = GetVariableLookupHash (VariableName, VendorGuid);
+  for (Index = 0; Index < Record->Count; Index++) {
+    if (Record->Hash[Index] == Hash) {
+      return;
+    }
+  }
+
+  if (Record->Count < EDKII_VARIABLE_LOOKUP_HINT_MAX) {
+    Record->Hash[Record->Count++] = Hash;
+  }
+}
+
+/**
+  Find a variable of the non-volatile store at the offset recorded for it in
+  the lookup hints, the first variable of the store.
+
+  A hint is only used if the variable it points to has a valid header and is
+  the added variable of the given name and GUID.
+
+  @param  StoreInfo           Pointer to the store info structure.
+  @param  VariableName        Name of the variable to be found, not an empty string.
+  @param  VendorGuid          Vendor GUID to be found.
+  @param  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+
+  @retval  EFI_SUCCESS            Variable found successfully
+  @retval  EFI_NOT_FOUND          The hints do not tell where the variable is, the store must be walked.
+
+**/
+STATIC
+EFI_STATUS
+FindVariableByLookupHint (
+  IN VARIABLE_STORE_INFO      *StoreInfo,
+  IN CONST CHAR16             *VariableName,
+  IN CONST EFI_GUID           *VendorGuid,
+  OUT VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  VARIABLE_HEADER                   *Variable;
+  VARIABLE_HEADER                   *VariableHeader;
+  UINT8                             *Data;
+  UINTN                             DataSize;
+  EDKII_VARIABLE_LOOKUP_HINT_TABLE  Table;
+  EDKII_VARIABLE_LOOKUP_HINT_ENTRY  Entry;
+  UINTN                             StoreSize;
+  UINT32                            Hash;
+  UINTN                             Index;
+
+  //
+  // The hints of a store that is partly in the spare block are not used.
+  //
+  if (!FeaturePcdGet (PcdVariableLookupHintEnable) || (StoreInfo->FtwLastWriteData != NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Variable = PtrTrack->StartPtr;
+  if (!GetVariableHeader (StoreInfo, Variable, &VariableHeader) ||
+      (VariableHeader->State != VAR_ADDED) ||
+      (CompareWithValidVariable (StoreInfo, Variable, VariableHeader, EDKII_VARIABLE_LOOKUP_HINT_NAME, &gEdkiiVariableLookupHintGuid, PtrTrack) != EFI_SUCCESS))
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  StoreSize = (UINTN)PtrTrack->EndPtr - (UINTN)PtrTrack->StartPtr;
+  Data      = GetVariableDataPtr (Variable, VariableHeader, StoreInfo->AuthFlag);
+  DataSize  = DataSizeOfVariable (VariableHeader, StoreInfo->AuthFlag);
+  if (((UINTN)Data >= (UINTN)PtrTrack->EndPtr) ||
+      (DataSize > (UINTN)PtrTrack->EndPtr - (UINTN)Data) ||
+      (DataSize < sizeof (EDKII_VARIABLE_LOOKUP_HINT_TABLE)))
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (&Table, Data, sizeof (Table));
+  if (Table.Count > (DataSize - sizeof (Table)) / sizeof (Entry)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Hash = GetVariableLookupHash (VariableName, VendorGuid);
+  for (Index = 0; Index < Table.Count; Index++) {
+    CopyMem (&Entry, Data + sizeof (Table) + Index * sizeof (Entry), sizeof (Entry));
+    if (Entry.Hash != Hash) {
+      continue;
+    }
+
+    if ((Entry.Offset == 0) ||
+        (Entry.Offset != HEADER_ALIGN (Entry.Offset)) ||
+        (Entry.Offset >= StoreSize))
+    {
+      break;
+    }
+
+    //
+    // The variable is at the recorded offset as long as it was not updated
+    // since the last reclaim.
+    //
+    Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry.Offset);
+    if (GetVariableHeader (StoreInfo, Variable, &VariableHeader) &&
+        (VariableHeader->State == VAR_ADDED) &&
+        (CompareWithValidVariable (StoreInfo, Variable, VariableHeader, VariableName, VendorGuid, PtrTrack) == EFI_SUCCESS))
+    {
+      return EFI_SUCCESS;
+    }
+
+    break;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -856,6 +1038,12 @@ FindVariableEx (
   MaxIndex       = NULL;
   VariableHeader = NULL;
 
+  if ((IndexTable != NULL) && (VariableName[0] != 0)) {
+    if (FindVariableByLookupHint (StoreInfo, VariableName, VendorGuid, PtrTrack) == EFI_SUCCESS) {
+      return EFI_SUCCESS;
+    }
+  }
+
   if (IndexTable != NULL) {
     //
     // traverse the variable index table to look for varible.
@@ -1052,6 +1240,13 @@ PeiGetVariable (
     return Status;
   }
 
+  //
+  // Only the non-volatile store has an index table.
+  //
+  if (StoreInfo.IndexTable != NULL) {
+    RecordVariableLookup (VariableName, VariableGuid);
+  }
+
   GetVariableHeader (&StoreInfo, Variable.CurrPtr, &VariableHeader);
 
   //
@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Guid/VariableFormat.h>
 #include <Guid/VariableIndexTable.h>
+#include <Guid/VariableLookupHint.h>
 #include <Guid/SystemNvDataGuid.h>
 #include <Guid/FaultTolerantWrite.h>
 
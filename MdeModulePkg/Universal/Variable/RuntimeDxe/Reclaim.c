@@ -92,6 +92,12 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Only the range from the first to the last byte that differs from the
+  variable storage space is written, in a single FTW write so that the
+  update stays fault tolerant. The variables before the first reclaimed
+  one keep their place, and the erased end of the store stays erased, so
+  the blocks holding them are neither copied to the spare block nor erased.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
 
@@ -112,6 +118,10 @@ FtwVariableSpace (
   UINTN                              VarOffset;
   UINTN                              FtwBufferSize;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
+  UINT8                              *Store;
+  UINT8                              *Buffer;
+  UINTN                              Start;
+  UINTN                              End;
 
   //
   // Locate fault tolerant write protocol.
@@ -129,17 +139,32 @@ FtwVariableSpace (
     return Status;
   }
 
+  FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
+  ASSERT (FtwBufferSize == VariableBuffer->Size);
+
+  //
+  // Find the range that changes.
+  //
+  Store  = (UINT8 *)(UINTN)VariableBase;
+  Buffer = (UINT8 *)VariableBuffer;
+  for (Start = 0; (Start < FtwBufferSize) && (Store[Start] == Buffer[Start]); Start++) {
+  }
+
+  if (Start == FtwBufferSize) {
+    return EFI_SUCCESS;
+  }
+
+  for (End = FtwBufferSize; Store[End - 1] == Buffer[End - 1]; End--) {
+  }
+
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + Start, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
-  FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
-  ASSERT (FtwBufferSize == VariableBuffer->Size);
-
   //
   // FTW write record.
   //
@@ -147,10 +172,10 @@ FtwVariableSpace (
                           FtwProtocol,
                           VarLba,                // LBA
                           VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
+                          End - Start,           // NumBytes
                           NULL,                  // PrivateData NULL
                           FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          Buffer + Start         // write buffer
                           );
 
   return Status;
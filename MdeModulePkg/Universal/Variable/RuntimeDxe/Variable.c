@@ -29,6 +29,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "VariableNonVolatile.h"
 #include "VariableParsing.h"
 #include "VariableRuntimeCache.h"
+#include "VariableIndex.h"
+#include "VariableLookupHint.h"
 
 VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
 
@@ -168,6 +170,18 @@ UpdateVariableStore (
     if ((DataPtr + DataSize) > (FvVolHdr + mNvFvHeaderCache->FvLength)) {
       return EFI_OUT_OF_RESOURCES;
     }
+
+    //
+    // The caller updates the NV cache, the runtime cache is synchronized
+    // from it once the update is complete.
+    //
+    if (DataPtr >= mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase) {
+      MarkRuntimeVariableCacheDirty (
+        &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
+        (UINTN)(DataPtr - mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase),
+        DataSize
+        );
+    }
   } else {
     //
     // Data Pointer should point to the actual Address where data is to be
@@ -182,6 +196,12 @@ UpdateVariableStore (
       if ((DataPtr + DataSize) > ((UINTN)VolatileBase + VolatileBase->Size)) {
         return EFI_OUT_OF_RESOURCES;
       }
+
+      MarkRuntimeVariableCacheDirty (
+        &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache,
+        (UINTN)(DataPtr - (UINTN)VolatileBase),
+        DataSize
+        );
     } else {
       //
       // Emulated non-volatile variable mode.
@@ -193,6 +213,12 @@ UpdateVariableStore (
       if ((DataPtr + DataSize) > ((UINTN)mNvVariableCache + mNvVariableCache->Size)) {
         return EFI_OUT_OF_RESOURCES;
       }
+
+      MarkRuntimeVariableCacheDirty (
+        &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
+        (UINTN)(DataPtr - (UINTN)mNvVariableCache),
+        DataSize
+        );
     }
 
     //
@@ -339,11 +365,7 @@ RecordVarErrorFlag (
       // Update the data in NV cache.
       //
       *VarErrFlag = TempFlag;
-      Status      =  SynchronizeRuntimeVariableCache (
-                       &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
-                       0,
-                       mNvVariableCache->Size
-                       );
+      Status      = SynchronizeDirtyRuntimeVariableCaches ();
       ASSERT_EFI_ERROR (Status);
     }
   }
@@ -545,6 +567,7 @@ Reclaim (
   VARIABLE_HEADER        *UpdatingVariable;
   VARIABLE_HEADER        *UpdatingInDeletedTransition;
   BOOLEAN                AuthFormat;
+  UINTN                  LookupHintSize;
 
   AuthFormat                  = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable            = NULL;
@@ -614,13 +637,28 @@ Reclaim (
   CopyMem (ValidBuffer, VariableStoreHeader, sizeof (VARIABLE_STORE_HEADER));
   CurrPtr = (UINT8 *)GetStartPointer ((VARIABLE_STORE_HEADER *)ValidBuffer);
 
+  //
+  // The lookup hints of the variables read in PEI go first, their offsets are
+  // filled once all the variables are in place. The old hints are dropped, and
+  // a reclaim that adds a variable leaves the room of the hints to it.
+  //
+  LookupHintSize = 0;
+  if (!IsVolatile && (NewVariable == NULL)) {
+    LookupHintSize = GetVariableLookupHintSize (AuthFormat);
+    if (LookupHintSize != 0) {
+      ReserveVariableLookupHint (CurrPtr, AuthFormat);
+      CurrPtr                 += LookupHintSize;
+      CommonVariableTotalSize += LookupHintSize;
+    }
+  }
+
   //
   // Reinstall all ADDED variables as long as they are not identical to Updating Variable.
   //
   Variable = GetStartPointer (VariableStoreHeader);
   while (IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader))) {
     NextVariable = GetNextVariablePtr (Variable, AuthFormat);
-    if ((Variable != UpdatingVariable) && (Variable->State == VAR_ADDED)) {
+    if ((Variable != UpdatingVariable) && (Variable->State == VAR_ADDED) && !IsVariableLookupHint (Variable, AuthFormat)) {
       VariableSize = (UINTN)NextVariable - (UINTN)Variable;
       CopyMem (CurrPtr, (UINT8 *)Variable, VariableSize);
       CurrPtr += VariableSize;
@@ -643,7 +681,9 @@ Reclaim (
   Variable = GetStartPointer (VariableStoreHeader);
   while (IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader))) {
     NextVariable = GetNextVariablePtr (Variable, AuthFormat);
-    if ((Variable != UpdatingVariable) && (Variable != UpdatingInDeletedTransition) && (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+    if ((Variable != UpdatingVariable) && (Variable != UpdatingInDeletedTransition) && (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) &&
+        !IsVariableLookupHint (Variable, AuthFormat))
+    {
       //
       // Buffer has cached all ADDED variable.
       // Per IN_DELETED variable, we have to guarantee that
@@ -737,6 +777,10 @@ Reclaim (
     CurrPtr += NewVariableSize;
   }
 
+  if (LookupHintSize != 0) {
+    FillVariableLookupHint ((VARIABLE_STORE_HEADER *)ValidBuffer, AuthFormat);
+  }
+
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     //
     // If volatile/emulated non-volatile variable store, just copy valid buffer.
@@ -792,8 +836,18 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables were moved, the runtime caches get the new layout with the
+  // updates below.
+  //
+  if (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.StoreGeneration != NULL) {
+    (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.StoreGeneration))++;
+  }
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    VariableIndexInvalidate ((VARIABLE_STORE_HEADER *)(UINTN)VariableBase);
+    ResetGetNextVariableCursor ();
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache,
                    0,
@@ -806,6 +860,8 @@ Done:
     // For NV variable reclaim, we use mNvVariableCache as the buffer, so copy the data back.
     //
     CopyMem (mNvVariableCache, (UINT8 *)(UINTN)VariableBase, VariableStoreHeader->Size);
+    VariableIndexInvalidate (mNvVariableCache);
+    ResetGetNextVariableCursor ();
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
                    0,
@@ -1656,6 +1712,52 @@ AutoUpdateLangVariable (
   }
 }
 
+/**
+  Check whether the data of a non-volatile variable can be updated in place.
+
+  Flash can clear bits without an erase, and a single byte is programmed
+  atomically, as the variable State updates rely on. So the new data can be
+  written over the old data when it differs from it by one byte, and that
+  byte only clears bits of the old one.
+
+  @param[in]  OldData           The data of the variable in the store.
+  @param[in]  NewData           The new data of the variable.
+  @param[in]  DataSize          The size of both data.
+  @param[out] Offset            The offset of the byte to write.
+
+  @retval TRUE                  The data can be updated in place.
+  @retval FALSE                 The variable must be written again.
+
+**/
+STATIC
+BOOLEAN
+IsInPlaceVariableUpdate (
+  IN  CONST UINT8  *OldData,
+  IN  CONST UINT8  *NewData,
+  IN  UINTN        DataSize,
+  OUT UINTN        *Offset
+  )
+{
+  UINTN    Index;
+  BOOLEAN  Found;
+
+  Found = FALSE;
+  for (Index = 0; Index < DataSize; Index++) {
+    if (OldData[Index] == NewData[Index]) {
+      continue;
+    }
+
+    if (Found || ((OldData[Index] & NewData[Index]) != NewData[Index])) {
+      return FALSE;
+    }
+
+    Found   = TRUE;
+    *Offset = Index;
+  }
+
+  return Found;
+}
+
 /**
   Update the variable region with Variable information. If EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS is set,
   index of associated public key is needed.
@@ -1701,7 +1803,7 @@ UpdateVariable (
   VARIABLE_POINTER_TRACK              *Variable;
   VARIABLE_POINTER_TRACK              NvVariable;
   VARIABLE_STORE_HEADER               *VariableStoreHeader;
-  VARIABLE_RUNTIME_CACHE              *VolatileCacheInstance;
+  EFI_STATUS                          CacheStatus;
   UINT8                               *BufferForMerge;
   UINTN                               MergedBufSize;
   BOOLEAN                             DataReady;
@@ -1899,6 +2001,36 @@ UpdateVariable (
       //
       UpdateVariableInfo (VariableName, VendorGuid, Variable->Volatile, FALSE, TRUE, FALSE, FALSE, &gVariableInfo);
       Status = EFI_SUCCESS;
+      goto Done;
+    } else if (FeaturePcdGet (PcdVariableInPlaceUpdate) &&
+               !Variable->Volatile &&
+               (Variable->InDeletedTransitionPtr == NULL) &&
+               (CacheVariable->CurrPtr->State == VAR_ADDED) &&
+               (CacheVariable->CurrPtr->Attributes == Attributes) &&
+               ((Attributes & (EFI_VARIABLE_APPEND_WRITE | VARIABLE_ATTRIBUTE_AT_AW)) == 0) &&
+               (TimeStamp == NULL) &&
+               (DataSizeOfVariable (CacheVariable->CurrPtr, AuthFormat) == DataSize) &&
+               IsInPlaceVariableUpdate (GetVariableDataPtr (CacheVariable->CurrPtr, AuthFormat), Data, DataSize, &DataOffset))
+    {
+      //
+      // Program the byte that changes, rather than appending a new copy of
+      // the variable that takes store space until the next reclaim.
+      //
+      Status = UpdateVariableStore (
+                 &mVariableModuleGlobal->VariableGlobal,
+                 FALSE,
+                 FALSE,
+                 Fvb,
+                 (UINTN)GetVariableDataPtr (Variable->CurrPtr, AuthFormat) + DataOffset,
+                 sizeof (UINT8),
+                 (UINT8 *)Data + DataOffset
+                 );
+      if (!EFI_ERROR (Status)) {
+        GetVariableDataPtr (CacheVariable->CurrPtr, AuthFormat)[DataOffset] = ((UINT8 *)Data)[DataOffset];
+        UpdateVariableInfo (VariableName, VendorGuid, FALSE, FALSE, TRUE, FALSE, FALSE, &gVariableInfo);
+        FlushHobVariableToFlash (VariableName, VendorGuid);
+      }
+
       goto Done;
     } else if ((CacheVariable->CurrPtr->State == VAR_ADDED) ||
                (CacheVariable->CurrPtr->State == (VAR_ADDED & VAR_IN_DELETED_TRANSITION)))
@@ -2386,21 +2518,14 @@ UpdateVariable (
   }
 
 Done:
+  //
+  // Copy the ranges of the stores written by this update to the runtime caches,
+  // including the ones of a failed update, which the stores already hold.
+  //
+  CacheStatus = SynchronizeDirtyRuntimeVariableCaches ();
+  ASSERT_EFI_ERROR (CacheStatus);
   if (!EFI_ERROR (Status)) {
-    if (((Variable->CurrPtr != NULL) && !Variable->Volatile) || ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)) {
-      VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache);
-    } else {
-      VolatileCacheInstance = &(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache);
-    }
-
-    if (VolatileCacheInstance->Store != NULL) {
-      Status =  SynchronizeRuntimeVariableCache (
-                  VolatileCacheInstance,
-                  0,
-                  VolatileCacheInstance->Store->Size
-                  );
-      ASSERT_EFI_ERROR (Status);
-    }
+    Status = CacheStatus;
   }
 
   return Status;
@@ -2650,6 +2775,13 @@ VariableServiceSetVariable (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // The lookup hints of the variables read in PEI are only written by a reclaim.
+  //
+  if (IsVariableLookupHintName (VariableName, VendorGuid)) {
+    return EFI_WRITE_PROTECTED;
+  }
+
   //
   // Check for reserverd bit in variable attribute.
   // EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS is deprecated but we still allow
@@ -3216,10 +3348,13 @@ ReclaimForOS (
   VOID
   )
 {
-  EFI_STATUS      Status;
-  UINTN           RemainingCommonRuntimeVariableSpace;
-  UINTN           RemainingHwErrVariableSpace;
-  STATIC BOOLEAN  Reclaimed;
+  EFI_STATUS       Status;
+  UINTN            RemainingCommonRuntimeVariableSpace;
+  UINTN            RemainingHwErrVariableSpace;
+  STATIC BOOLEAN   Reclaimed;
+  UINTN            DeletedVariableSpace;
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *NextVariable;
 
   //
   // This function will be called only once at EndOfDxe or ReadyToBoot event.
@@ -3241,12 +3376,34 @@ ReclaimForOS (
   RemainingHwErrVariableSpace = PcdGet32 (PcdHwErrStorageSize) - mVariableModuleGlobal->HwErrVariableTotalSize;
 
   //
-  // Check if the free area is below a threshold.
+  // Measure the space taken by deleted variables, which a reclaim gives back,
+  // so that it is not left for a reclaim in SetVariable () at runtime.
+  //
+  DeletedVariableSpace = 0;
+  if (PcdGet8 (PcdVariableReclaimThreshold) != 0) {
+    Variable = GetStartPointer (mNvVariableCache);
+    while (IsValidVariableHeader (Variable, GetEndPointer (mNvVariableCache))) {
+      NextVariable = GetNextVariablePtr (Variable, mVariableModuleGlobal->VariableGlobal.AuthFormat);
+      if ((Variable->State != VAR_ADDED) && (Variable->State != (VAR_ADDED & VAR_IN_DELETED_TRANSITION))) {
+        DeletedVariableSpace += (UINTN)NextVariable - (UINTN)Variable;
+      }
+
+      Variable = NextVariable;
+    }
+  }
+
+  //
+  // Check if the free area is below a threshold, the deleted variables take
+  // more than the given share of the store, or the store lacks the lookup
+  // hints of the variables read in PEI.
   //
   if (((RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxVariableSize) ||
        (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
       ((PcdGet32 (PcdHwErrStorageSize) != 0) &&
-       (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize))))
+       (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize))) ||
+      ((PcdGet8 (PcdVariableReclaimThreshold) != 0) &&
+       (DeletedVariableSpace * 100 >= (UINTN)mNvVariableCache->Size * PcdGet8 (PcdVariableReclaimThreshold))) ||
+      IsVariableLookupHintMissing (mNvVariableCache, mVariableModuleGlobal->VariableGlobal.AuthFormat))
   {
     Status = Reclaim (
                mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
@@ -3809,6 +3966,15 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved  = 0;
   VolatileVariableStore->Reserved1 = 0;
 
+  //
+  // Index the variable stores searched by FindVariable ().
+  //
+  VariableIndexCreate (VolatileVariableStore);
+  VariableIndexCreate ((VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase);
+  VariableIndexCreate (mNvVariableCache);
+
+  VariableLookupHintInitialize ();
+
   return EFI_SUCCESS;
 }
 
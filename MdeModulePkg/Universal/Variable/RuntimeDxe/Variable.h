@@ -64,6 +64,11 @@ typedef enum {
 typedef struct {
   UINT32                   PendingUpdateOffset;
   UINT32                   PendingUpdateLength;
+  //
+  // Range of the variable store written since the last synchronization.
+  //
+  UINT32                   DirtyOffset;
+  UINT32                   DirtyLength;
   VARIABLE_STORE_HEADER    *Store;
 } VARIABLE_RUNTIME_CACHE;
 
@@ -71,6 +76,7 @@ typedef struct {
   BOOLEAN                   *ReadLock;
   BOOLEAN                   *PendingUpdate;
   BOOLEAN                   *HobFlushComplete;
+  UINT32                    *StoreGeneration;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeVolatileCache;
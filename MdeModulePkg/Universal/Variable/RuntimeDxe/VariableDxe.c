@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Variable.h"
+#include "VariableIndex.h"
 
 #include <Protocol/VariablePolicy.h>
 #include <Library/VariablePolicyLib.h>
@@ -266,6 +267,11 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **)&mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **)&mNvFvHeaderCache);
 
+  for (Index = 0; Index < ARRAY_SIZE (mVariableIndexRegistration); Index++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableIndexRegistration[Index].StartPtr);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableIndexRegistration[Index].Index);
+  }
+
   if (mAuthContextOut.AddressPointer != NULL) {
     for (Index = 0; Index < mAuthContextOut.AddressPointerCount; Index++) {
       EfiConvertPointer (0x0, (VOID **)mAuthContextOut.AddressPointer[Index]);
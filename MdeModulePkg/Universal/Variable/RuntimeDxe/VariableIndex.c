@@ -0,0 +1,389 @@
+/** @file
+  The hash index of the variables of a variable store.
+
+  Each variable store may have an index of its variables, keyed by a hash of
+  the variable name and vendor GUID. The index holds the offset of every
+  variable with a valid header, whatever its state, so that it stays right
+  when the state of a variable changes in place. The state, name and GUID of
+  a candidate are always checked in the store itself.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. They may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableParsing.h"
+#include "VariableIndex.h"
+
+#define VARIABLE_INDEX_MIN_BUCKET_COUNT  16
+
+#define VARIABLE_INDEX_BUCKETS(Index)  ((UINT32 *)((VARIABLE_INDEX *)(Index) + 1))
+#define VARIABLE_INDEX_ENTRIES(Index)  ((VARIABLE_INDEX_ENTRY *)(VARIABLE_INDEX_BUCKETS (Index) + (Index)->BucketCount))
+
+VARIABLE_INDEX_REGISTRATION  mVariableIndexRegistration[VariableStoreTypeMax];
+
+/**
+  Hash a variable name and vendor GUID.
+
+  The name ends at its null terminator, or after NameSize bytes.
+
+  @param[in]  Name          The variable name, which may not be aligned.
+  @param[in]  NameSize      The maximum size in bytes of the name.
+  @param[in]  Guid          The vendor GUID.
+
+  @return The hash of the name and GUID.
+
+**/
+UINT32
+VariableIndexHash (
+  IN  CONST UINT8     *Name,
+  IN  UINTN           NameSize,
+  IN  CONST EFI_GUID  *Guid
+  )
+{
+  UINT32       Hash;
+  UINTN        Index;
+  CONST UINT8  *Bytes;
+
+  //
+  // FNV-1a.
+  //
+  Hash = 0x811C9DC5;
+  for (Index = 0; Index + 1 < NameSize; Index += sizeof (CHAR16)) {
+    if ((Name[Index] == 0) && (Name[Index + 1] == 0)) {
+      break;
+    }
+
+    Hash = (Hash ^ Name[Index]) * 0x01000193;
+    Hash = (Hash ^ Name[Index + 1]) * 0x01000193;
+  }
+
+  Bytes = (CONST UINT8 *)Guid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Empty the index of a variable store.
+
+  @param[in, out]  Index        The index of the variable store.
+
+**/
+STATIC
+VOID
+VariableIndexReset (
+  IN OUT VARIABLE_INDEX  *Index
+  )
+{
+  ZeroMem (VARIABLE_INDEX_BUCKETS (Index), Index->BucketCount * sizeof (UINT32));
+  Index->EntryCount = 0;
+  Index->IndexedEnd = 0;
+  Index->Overflow   = FALSE;
+}
+
+/**
+  Get the registration of a variable store.
+
+  @param[in]  StartPtr      The start pointer of the variable store.
+
+  @return The registration, or NULL if the store has no index.
+
+**/
+STATIC
+VARIABLE_INDEX_REGISTRATION *
+VariableIndexGetRegistration (
+  IN  VARIABLE_HEADER  *StartPtr
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mVariableIndexRegistration); Index++) {
+    if ((mVariableIndexRegistration[Index].Index != NULL) &&
+        (mVariableIndexRegistration[Index].StartPtr == StartPtr))
+    {
+      return &mVariableIndexRegistration[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add the variables written to a variable store since the last update to its
+  index.
+
+  The index overflows if the store holds more variables than it can describe,
+  or a variable whose name runs past the end of the store.
+
+  @param[in, out]  Index        The index of the variable store.
+  @param[in]       StartPtr     The start pointer of the variable store.
+  @param[in]       EndPtr       The end pointer of the variable store.
+  @param[in]       AuthFormat   TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+VariableIndexUpdate (
+  IN OUT VARIABLE_INDEX   *Index,
+  IN     VARIABLE_HEADER  *StartPtr,
+  IN     VARIABLE_HEADER  *EndPtr,
+  IN     BOOLEAN          AuthFormat
+  )
+{
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_INDEX_ENTRY  *Entry;
+  UINT32                *Bucket;
+  UINT8                 *Name;
+  UINTN                 NameSize;
+
+  Variable = (VARIABLE_HEADER *)((UINTN)StartPtr + Index->IndexedEnd);
+  while (IsValidVariableHeader (Variable, EndPtr)) {
+    Name     = (UINT8 *)GetVariableNamePtr (Variable, AuthFormat);
+    NameSize = NameSizeOfVariable (Variable, AuthFormat);
+    if ((Index->EntryCount == Index->EntryCapacity) ||
+        (NameSize > (UINTN)EndPtr - (UINTN)Name))
+    {
+      Index->Overflow = TRUE;
+      return;
+    }
+
+    Entry         = &VARIABLE_INDEX_ENTRIES (Index)[Index->EntryCount];
+    Entry->Offset = Index->IndexedEnd;
+    Entry->Hash   = VariableIndexHash (Name, NameSize, GetVendorGuidPtr (Variable, AuthFormat));
+
+    //
+    // The variables are added in the order of the store, so each chain goes
+    // from the last variable of the store to the first one.
+    //
+    Bucket      = &VARIABLE_INDEX_BUCKETS (Index)[Entry->Hash & (Index->BucketCount - 1)];
+    Entry->Next = *Bucket;
+    Index->EntryCount++;
+    *Bucket = Index->EntryCount;
+
+    Variable          = GetNextVariablePtr (Variable, AuthFormat);
+    Index->IndexedEnd = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+  }
+}
+
+/**
+  Create the index of a variable store.
+
+  The index is only created if PcdVariableLookupIndexEnable is TRUE. It is
+  allocated from runtime memory, so this must be called before the end of
+  the boot services. A store without index is searched linearly.
+
+  @param[in]  VariableStore       The variable store.
+
+**/
+VOID
+VariableIndexCreate (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  VARIABLE_INDEX_REGISTRATION  *Registration;
+  VARIABLE_INDEX               *Index;
+  VARIABLE_HEADER              *StartPtr;
+  UINTN                        StoreSize;
+  UINT32                       EntryCapacity;
+  UINT32                       BucketCount;
+  UINTN                        Slot;
+
+  if (!FeaturePcdGet (PcdVariableLookupIndexEnable) || (VariableStore == NULL)) {
+    return;
+  }
+
+  StartPtr     = GetStartPointer (VariableStore);
+  Registration = VariableIndexGetRegistration (StartPtr);
+  if (Registration != NULL) {
+    VariableIndexReset (Registration->Index);
+    return;
+  }
+
+  for (Slot = 0; Slot < ARRAY_SIZE (mVariableIndexRegistration); Slot++) {
+    if (mVariableIndexRegistration[Slot].Index == NULL) {
+      break;
+    }
+  }
+
+  if (Slot == ARRAY_SIZE (mVariableIndexRegistration)) {
+    return;
+  }
+
+  StoreSize     = (UINTN)GetEndPointer (VariableStore) - (UINTN)StartPtr;
+  EntryCapacity = (UINT32)(StoreSize / VARIABLE_INDEX_MIN_VARIABLE_SIZE);
+  BucketCount   = GetPowerOfTwo32 (MAX (EntryCapacity / 2, VARIABLE_INDEX_MIN_BUCKET_COUNT));
+  Index         = AllocateRuntimeZeroPool (
+                    sizeof (VARIABLE_INDEX) +
+                    BucketCount * sizeof (UINT32) +
+                    EntryCapacity * sizeof (VARIABLE_INDEX_ENTRY)
+                    );
+  if (Index == NULL) {
+    DEBUG ((DEBUG_WARN, "%a: No memory for the index of the variable store at %p\n", __func__, VariableStore));
+    return;
+  }
+
+  Index->BucketCount   = BucketCount;
+  Index->EntryCapacity = EntryCapacity;
+
+  mVariableIndexRegistration[Slot].StartPtr = StartPtr;
+  mVariableIndexRegistration[Slot].Index    = Index;
+}
+
+/**
+  Drop the content of the index of a variable store, after the store was
+  rewritten. The store is indexed again by the next lookup.
+
+  @param[in]  VariableStore       The variable store.
+
+**/
+VOID
+VariableIndexInvalidate (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  VARIABLE_INDEX_REGISTRATION  *Registration;
+
+  if (VariableStore == NULL) {
+    return;
+  }
+
+  Registration = VariableIndexGetRegistration (GetStartPointer (VariableStore));
+  if (Registration != NULL) {
+    VariableIndexReset (Registration->Index);
+  }
+}
+
+/**
+  Drop the content of the index of all the variable stores.
+
+**/
+VOID
+VariableIndexInvalidateAll (
+  VOID
+  )
+{
+  UINTN  Slot;
+
+  for (Slot = 0; Slot < ARRAY_SIZE (mVariableIndexRegistration); Slot++) {
+    if (mVariableIndexRegistration[Slot].Index != NULL) {
+      VariableIndexReset (mVariableIndexRegistration[Slot].Index);
+    }
+  }
+}
+
+/**
+  Find a variable by name and GUID through the index of its variable store.
+
+  The result is the one FindVariableEx () gets by walking the store.
+
+  @param[in]       VariableName        Name of the variable to be found, not an empty string.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+  @retval          EFI_UNSUPPORTED     The store has no usable index, it must be walked.
+**/
+EFI_STATUS
+VariableIndexFind (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_INDEX_REGISTRATION  *Registration;
+  VARIABLE_INDEX               *Index;
+  VARIABLE_INDEX_ENTRY         *Entry;
+  VARIABLE_HEADER              *Variable;
+  VARIABLE_HEADER              *AddedVariable;
+  VARIABLE_HEADER              *InDeletedVariable;
+  VARIABLE_HEADER              *LastInDeletedVariable;
+  UINT32                       Hash;
+  UINT32                       Next;
+
+  Registration = VariableIndexGetRegistration (PtrTrack->StartPtr);
+  if (Registration == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Index = Registration->Index;
+  if (!Index->Overflow) {
+    VariableIndexUpdate (Index, PtrTrack->StartPtr, PtrTrack->EndPtr, AuthFormat);
+  }
+
+  if (Index->Overflow) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The store walk returns the first added variable, along with the last
+  // variable in deleted transition before it. Without added variable, it
+  // returns the last variable in deleted transition. The chain goes from the
+  // end of the store to its start.
+  //
+  AddedVariable         = NULL;
+  InDeletedVariable     = NULL;
+  LastInDeletedVariable = NULL;
+
+  Hash = VariableIndexHash ((CONST UINT8 *)VariableName, StrSize (VariableName), VendorGuid);
+  for (Next = VARIABLE_INDEX_BUCKETS (Index)[Hash & (Index->BucketCount - 1)]; Next != 0; Next = Entry->Next) {
+    Entry = &VARIABLE_INDEX_ENTRIES (Index)[Next - 1];
+    if (Entry->Hash != Hash) {
+      continue;
+    }
+
+    Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry->Offset);
+    if ((Variable->State != VAR_ADDED) &&
+        (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)))
+    {
+      continue;
+    }
+
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+
+    if (!CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSizeOfVariable (Variable, AuthFormat)) != 0))
+    {
+      continue;
+    }
+
+    if (Variable->State == VAR_ADDED) {
+      AddedVariable     = Variable;
+      InDeletedVariable = NULL;
+    } else {
+      if (LastInDeletedVariable == NULL) {
+        LastInDeletedVariable = Variable;
+      }
+
+      if ((AddedVariable != NULL) && (InDeletedVariable == NULL)) {
+        InDeletedVariable = Variable;
+      }
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+  } else {
+    PtrTrack->CurrPtr                = LastInDeletedVariable;
+    PtrTrack->InDeletedTransitionPtr = NULL;
+  }
+
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
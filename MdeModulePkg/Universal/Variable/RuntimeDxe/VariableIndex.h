@@ -0,0 +1,140 @@
+/** @file
+  The hash index of the variables of a variable store, shared by the variable
+  modules that look variables up by name and GUID.
+
+  A variable store is only appended to between two reclaims, so the index
+  records the offset of the variables in the order they are found, and the
+  part of the store written since the last lookup is indexed by the next one.
+  The index must be invalidated when the store is rewritten by a reclaim.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_INDEX_H_
+#define _VARIABLE_INDEX_H_
+
+#include "Variable.h"
+
+//
+// The smallest size a variable can take in a store, a header and an empty name.
+// It bounds the number of variables in a store of a given size.
+//
+#define VARIABLE_INDEX_MIN_VARIABLE_SIZE  (HEADER_ALIGN (sizeof (VARIABLE_HEADER) + sizeof (CHAR16)))
+
+//
+// A variable of the store. The buckets and the Next links hold one more than
+// the index of an entry, 0 ends a chain.
+//
+typedef struct {
+  UINT32    Offset;   // Offset of the variable from the start pointer of the store.
+  UINT32    Hash;
+  UINT32    Next;
+} VARIABLE_INDEX_ENTRY;
+
+//
+// The index of one variable store, allocated with its buckets and entries.
+//
+typedef struct {
+  UINT32     BucketCount;
+  UINT32     EntryCapacity;
+  UINT32     EntryCount;
+  UINT32     IndexedEnd;  // Offset from the start pointer of the first variable not indexed yet.
+  BOOLEAN    Overflow;
+  // UINT32                Buckets[BucketCount];
+  // VARIABLE_INDEX_ENTRY  Entries[EntryCapacity];
+} VARIABLE_INDEX;
+
+typedef struct {
+  VARIABLE_HEADER    *StartPtr;
+  VARIABLE_INDEX     *Index;
+} VARIABLE_INDEX_REGISTRATION;
+
+//
+// The registered stores, the DXE modules convert these pointers on the
+// virtual address change.
+//
+extern VARIABLE_INDEX_REGISTRATION  mVariableIndexRegistration[VariableStoreTypeMax];
+
+/**
+  Hash a variable name and vendor GUID.
+
+  The name ends at its null terminator, or after NameSize bytes.
+
+  @param[in]  Name          The variable name, which may not be aligned.
+  @param[in]  NameSize      The maximum size in bytes of the name.
+  @param[in]  Guid          The vendor GUID.
+
+  @return The hash of the name and GUID.
+
+**/
+UINT32
+VariableIndexHash (
+  IN  CONST UINT8     *Name,
+  IN  UINTN           NameSize,
+  IN  CONST EFI_GUID  *Guid
+  );
+
+/**
+  Create the index of a variable store.
+
+  The index is only created if PcdVariableLookupIndexEnable is TRUE. It is
+  allocated from runtime memory, so this must be called before the end of
+  the boot services. A store without index is searched linearly.
+
+  @param[in]  VariableStore       The variable store.
+
+**/
+VOID
+VariableIndexCreate (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  );
+
+/**
+  Drop the content of the index of a variable store, after the store was
+  rewritten. The store is indexed again by the next lookup.
+
+  @param[in]  VariableStore       The variable store.
+
+**/
+VOID
+VariableIndexInvalidate (
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  );
+
+/**
+  Drop the content of the index of all the variable stores.
+
+**/
+VOID
+VariableIndexInvalidateAll (
+  VOID
+  );
+
+/**
+  Find a variable by name and GUID through the index of its variable store.
+
+  The result is the one FindVariableEx () gets by walking the store.
+
+  @param[in]       VariableName        Name of the variable to be found, not an empty string.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+  @retval          EFI_UNSUPPORTED     The store has no usable index, it must be walked.
+**/
+EFI_STATUS
+VariableIndexFind (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  );
+
+#endif
@@ -0,0 +1,264 @@
+/** @file
+  The lookup hints of the non-volatile variables read in PEI.
+
+  The hints are the first variable of the non-volatile variable store. They are
+  only written by a reclaim, which moves the variables, so the offsets recorded
+  in them stay right until the next reclaim. SetVariable () cannot write them.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data. They may be input in SMM mode.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableParsing.h"
+#include "VariableIndex.h"
+#include "VariableLookupHint.h"
+
+//
+// The variables read in PEI, saved when the driver starts since the HOB list
+// is not available at runtime.
+//
+STATIC EDKII_VARIABLE_LOOKUP_HINT_RECORD  mVariableLookupHintRecord;
+
+/**
+  Save the record of the variables read in PEI, from its GUID HOB.
+
+  The hints are only kept if PcdVariableLookupHintEnable is TRUE.
+
+**/
+VOID
+VariableLookupHintInitialize (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  if (!FeaturePcdGet (PcdVariableLookupHintEnable)) {
+    return;
+  }
+
+  GuidHob = GetFirstGuidHob (&gEdkiiVariableLookupHintGuid);
+  if ((GuidHob == NULL) || (GET_GUID_HOB_DATA_SIZE (GuidHob) < sizeof (EDKII_VARIABLE_LOOKUP_HINT_RECORD))) {
+    return;
+  }
+
+  CopyMem (&mVariableLookupHintRecord, GET_GUID_HOB_DATA (GuidHob), sizeof (EDKII_VARIABLE_LOOKUP_HINT_RECORD));
+  mVariableLookupHintRecord.Count = MIN (mVariableLookupHintRecord.Count, EDKII_VARIABLE_LOOKUP_HINT_MAX);
+}
+
+/**
+  Check if a variable name and GUID are the ones of the lookup hints.
+
+  @param[in]  VariableName      Name of the variable.
+  @param[in]  VendorGuid        Vendor GUID of the variable.
+
+  @retval TRUE    The variable holds the lookup hints.
+  @retval FALSE   The variable is another one.
+
+**/
+BOOLEAN
+IsVariableLookupHintName (
+  IN  CONST CHAR16    *VariableName,
+  IN  CONST EFI_GUID  *VendorGuid
+  )
+{
+  return (BOOLEAN)(FeaturePcdGet (PcdVariableLookupHintEnable) &&
+                   CompareGuid (VendorGuid, &gEdkiiVariableLookupHintGuid) &&
+                   (StrCmp (VariableName, EDKII_VARIABLE_LOOKUP_HINT_NAME) == 0));
+}
+
+/**
+  Check if a variable of a store holds the lookup hints.
+
+  @param[in]  Variable          The variable.
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE    The variable holds the lookup hints.
+  @retval FALSE   The variable is another one.
+
+**/
+BOOLEAN
+IsVariableLookupHint (
+  IN  VARIABLE_HEADER  *Variable,
+  IN  BOOLEAN          AuthFormat
+  )
+{
+  return (BOOLEAN)(FeaturePcdGet (PcdVariableLookupHintEnable) &&
+                   (NameSizeOfVariable (Variable, AuthFormat) == sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME)) &&
+                   CompareGuid (GetVendorGuidPtr (Variable, AuthFormat), &gEdkiiVariableLookupHintGuid) &&
+                   (CompareMem (GetVariableNamePtr (Variable, AuthFormat), EDKII_VARIABLE_LOOKUP_HINT_NAME, sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME)) == 0));
+}
+
+/**
+  Get the size the lookup hints take in the non-volatile variable store.
+
+  The hints are left out of a non-volatile store that has no room for them,
+  counting the space taken by its deleted variables.
+
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @return The size of the variable that holds the lookup hints, 0 if there are
+          no hints to keep or no room for them.
+
+**/
+UINTN
+GetVariableLookupHintSize (
+  IN  BOOLEAN  AuthFormat
+  )
+{
+  UINTN  Size;
+
+  if (!FeaturePcdGet (PcdVariableLookupHintEnable) || (mVariableLookupHintRecord.Count == 0) ||
+      mVariableModuleGlobal->VariableGlobal.EmuNvMode)
+  {
+    return 0;
+  }
+
+  Size = HEADER_ALIGN (
+           GetVariableHeaderSize (AuthFormat) +
+           sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME) + GET_PAD_SIZE (sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME)) +
+           sizeof (EDKII_VARIABLE_LOOKUP_HINT_TABLE) +
+           mVariableLookupHintRecord.Count * sizeof (EDKII_VARIABLE_LOOKUP_HINT_ENTRY)
+           );
+
+  //
+  // A reclaim keeps at most the space in use, so the hints always fit if the
+  // used space still has room for them.
+  //
+  if ((mVariableModuleGlobal->NonVolatileLastVariableOffset + Size > mNvVariableCache->Size) ||
+      (mVariableModuleGlobal->CommonVariableTotalSize + Size > mVariableModuleGlobal->CommonVariableSpace))
+  {
+    return 0;
+  }
+
+  return Size;
+}
+
+/**
+  Write the variable that holds the lookup hints, with no offset recorded.
+
+  @param[out]  Buffer           The buffer, of GetVariableLookupHintSize () bytes.
+  @param[in]   AuthFormat       TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+ReserveVariableLookupHint (
+  OUT UINT8    *Buffer,
+  IN  BOOLEAN  AuthFormat
+  )
+{
+  VARIABLE_HEADER                   *Variable;
+  EDKII_VARIABLE_LOOKUP_HINT_TABLE  *Table;
+  EDKII_VARIABLE_LOOKUP_HINT_ENTRY  *Entry;
+  UINTN                             Index;
+
+  Variable = (VARIABLE_HEADER *)Buffer;
+  ZeroMem (Variable, GetVariableHeaderSize (AuthFormat));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = VAR_ADDED;
+  Variable->Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+  SetNameSizeOfVariable (Variable, sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME), AuthFormat);
+  SetDataSizeOfVariable (
+    Variable,
+    sizeof (EDKII_VARIABLE_LOOKUP_HINT_TABLE) + mVariableLookupHintRecord.Count * sizeof (EDKII_VARIABLE_LOOKUP_HINT_ENTRY),
+    AuthFormat
+    );
+  CopyGuid (GetVendorGuidPtr (Variable, AuthFormat), &gEdkiiVariableLookupHintGuid);
+  CopyMem (GetVariableNamePtr (Variable, AuthFormat), EDKII_VARIABLE_LOOKUP_HINT_NAME, sizeof (EDKII_VARIABLE_LOOKUP_HINT_NAME));
+
+  Table        = (EDKII_VARIABLE_LOOKUP_HINT_TABLE *)GetVariableDataPtr (Variable, AuthFormat);
+  Table->Count = mVariableLookupHintRecord.Count;
+  Entry        = (EDKII_VARIABLE_LOOKUP_HINT_ENTRY *)(Table + 1);
+  for (Index = 0; Index < mVariableLookupHintRecord.Count; Index++) {
+    Entry[Index].Hash   = mVariableLookupHintRecord.Hash[Index];
+    Entry[Index].Offset = 0;
+  }
+}
+
+/**
+  Record the offset of the variables read in PEI in the lookup hints that are
+  the first variable of a reclaimed store.
+
+  @param[in, out]  VariableStore    The reclaimed variable store.
+  @param[in]       AuthFormat       TRUE indicates authenticated variables are used.
+                                    FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+FillVariableLookupHint (
+  IN OUT VARIABLE_STORE_HEADER  *VariableStore,
+  IN     BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER                   *StartPtr;
+  VARIABLE_HEADER                   *Variable;
+  EDKII_VARIABLE_LOOKUP_HINT_TABLE  *Table;
+  EDKII_VARIABLE_LOOKUP_HINT_ENTRY  *Entry;
+  UINTN                             Index;
+  UINT32                            Hash;
+
+  StartPtr = GetStartPointer (VariableStore);
+  if (!IsValidVariableHeader (StartPtr, GetEndPointer (VariableStore)) || !IsVariableLookupHint (StartPtr, AuthFormat)) {
+    return;
+  }
+
+  Table = (EDKII_VARIABLE_LOOKUP_HINT_TABLE *)GetVariableDataPtr (StartPtr, AuthFormat);
+  Entry = (EDKII_VARIABLE_LOOKUP_HINT_ENTRY *)(Table + 1);
+
+  Variable = GetNextVariablePtr (StartPtr, AuthFormat);
+  while (IsValidVariableHeader (Variable, GetEndPointer (VariableStore))) {
+    if (Variable->State == VAR_ADDED) {
+      Hash = VariableIndexHash (
+               (UINT8 *)GetVariableNamePtr (Variable, AuthFormat),
+               NameSizeOfVariable (Variable, AuthFormat),
+               GetVendorGuidPtr (Variable, AuthFormat)
+               );
+      for (Index = 0; Index < Table->Count; Index++) {
+        if ((Entry[Index].Hash == Hash) && (Entry[Index].Offset == 0)) {
+          Entry[Index].Offset = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+          break;
+        }
+      }
+    }
+
+    Variable = GetNextVariablePtr (Variable, AuthFormat);
+  }
+}
+
+/**
+  Check if a reclaim of a non-volatile variable store would add lookup hints
+  that it lacks.
+
+  @param[in]  VariableStore     The non-volatile variable store.
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE    The store does not start with lookup hints, and there are
+                  hints to keep.
+  @retval FALSE   The store has lookup hints, or there are none to keep.
+
+**/
+BOOLEAN
+IsVariableLookupHintMissing (
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER  *StartPtr;
+
+  if (GetVariableLookupHintSize (AuthFormat) == 0) {
+    return FALSE;
+  }
+
+  StartPtr = GetStartPointer (VariableStore);
+  return (BOOLEAN)(!IsValidVariableHeader (StartPtr, GetEndPointer (VariableStore)) ||
+                   (StartPtr->State != VAR_ADDED) ||
+                   !IsVariableLookupHint (StartPtr, AuthFormat));
+}
@@ -0,0 +1,129 @@
+/** @file
+  The lookup hints of the non-volatile variables read in PEI.
+
+  The PEI variable module records the variables it reads. A reclaim of the
+  non-volatile variable store writes the offset of these variables in the
+  reclaimed store in the first variable of the store, which tells a later boot
+  where to read them.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_LOOKUP_HINT_H_
+#define _VARIABLE_LOOKUP_HINT_H_
+
+#include "Variable.h"
+#include <Guid/VariableLookupHint.h>
+
+/**
+  Save the record of the variables read in PEI, from its GUID HOB.
+
+  The hints are only kept if PcdVariableLookupHintEnable is TRUE.
+
+**/
+VOID
+VariableLookupHintInitialize (
+  VOID
+  );
+
+/**
+  Check if a variable name and GUID are the ones of the lookup hints.
+
+  @param[in]  VariableName      Name of the variable.
+  @param[in]  VendorGuid        Vendor GUID of the variable.
+
+  @retval TRUE    The variable holds the lookup hints.
+  @retval FALSE   The variable is another one.
+
+**/
+BOOLEAN
+IsVariableLookupHintName (
+  IN  CONST CHAR16    *VariableName,
+  IN  CONST EFI_GUID  *VendorGuid
+  );
+
+/**
+  Check if a variable of a store holds the lookup hints.
+
+  @param[in]  Variable          The variable.
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE    The variable holds the lookup hints.
+  @retval FALSE   The variable is another one.
+
+**/
+BOOLEAN
+IsVariableLookupHint (
+  IN  VARIABLE_HEADER  *Variable,
+  IN  BOOLEAN          AuthFormat
+  );
+
+/**
+  Get the size the lookup hints take in the non-volatile variable store.
+
+  The hints are left out of a non-volatile store that has no room for them,
+  counting the space taken by its deleted variables.
+
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @return The size of the variable that holds the lookup hints, 0 if there are
+          no hints to keep or no room for them.
+
+**/
+UINTN
+GetVariableLookupHintSize (
+  IN  BOOLEAN  AuthFormat
+  );
+
+/**
+  Write the variable that holds the lookup hints, with no offset recorded.
+
+  @param[out]  Buffer           The buffer, of GetVariableLookupHintSize () bytes.
+  @param[in]   AuthFormat       TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+ReserveVariableLookupHint (
+  OUT UINT8    *Buffer,
+  IN  BOOLEAN  AuthFormat
+  );
+
+/**
+  Record the offset of the variables read in PEI in the lookup hints that are
+  the first variable of a reclaimed store.
+
+  @param[in, out]  VariableStore    The reclaimed variable store.
+  @param[in]       AuthFormat       TRUE indicates authenticated variables are used.
+                                    FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+FillVariableLookupHint (
+  IN OUT VARIABLE_STORE_HEADER  *VariableStore,
+  IN     BOOLEAN                AuthFormat
+  );
+
+/**
+  Check if a reclaim of a non-volatile variable store would add lookup hints
+  that it lacks.
+
+  @param[in]  VariableStore     The non-volatile variable store.
+  @param[in]  AuthFormat        TRUE indicates authenticated variables are used.
+                                FALSE indicates authenticated variables are not used.
+
+  @retval TRUE    The store does not start with lookup hints, and there are
+                  hints to keep.
+  @retval FALSE   The store has lookup hints, or there are none to keep.
+
+**/
+BOOLEAN
+IsVariableLookupHintMissing (
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  BOOLEAN                AuthFormat
+  );
+
+#endif
@@ -8,6 +8,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "VariableParsing.h"
+#include "VariableIndex.h"
+
+//
+// The variable returned by the last VariableServiceGetNextVariableInternal ()
+// call and the start of its store. The enumeration of the variables passes it
+// back to the next call, which continues from it rather than looking it up
+// again. Variables do not move between two reclaims, which reset the cursor.
+//
+STATIC VARIABLE_HEADER  *mGetNextVariableCursor      = NULL;
+STATIC VARIABLE_HEADER  *mGetNextVariableCursorStart = NULL;
 
 /**
 
@@ -470,9 +480,20 @@ FindVariableEx (
 {
   VARIABLE_HEADER  *InDeletedVariable;
   VOID             *Point;
+  EFI_STATUS       Status;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  //
+  // Look a named variable up in the index of the store, if it has one.
+  //
+  if (VariableName[0] != 0) {
+    Status = VariableIndexFind (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -518,6 +539,100 @@ FindVariableEx (
   return (PtrTrack->CurrPtr  == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
 }
 
+/**
+  Drop the variable VariableServiceGetNextVariableInternal () continues from,
+  after a variable store was rewritten.
+
+**/
+VOID
+ResetGetNextVariableCursor (
+  VOID
+  )
+{
+  mGetNextVariableCursor      = NULL;
+  mGetNextVariableCursorStart = NULL;
+}
+
+/**
+  Check whether the variable returned by the last call of
+  VariableServiceGetNextVariableInternal () is the given one, and get it.
+
+  The result is the one FindVariableEx () gets, as only a VAR_ADDED variable
+  of a store of VariableStoreList is taken.
+
+  @param[in]   VariableName      Name of the variable, not an empty string.
+  @param[in]   VendorGuid        Variable Vendor Guid.
+  @param[in]   VariableStoreList A list of variable stores that should be used to get the next variable.
+  @param[out]  PtrTrack          The variable, if found.
+  @param[in]   AuthFormat        TRUE indicates authenticated variables are used.
+                                 FALSE indicates authenticated variables are not used.
+
+  @retval TRUE                   The cursor is the variable.
+  @retval FALSE                  The variable must be looked up.
+
+**/
+STATIC
+BOOLEAN
+FindVariableAtCursor (
+  IN  CHAR16                  *VariableName,
+  IN  EFI_GUID                *VendorGuid,
+  IN  VARIABLE_STORE_HEADER   **VariableStoreList,
+  OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN  BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_STORE_TYPE  StoreType;
+  VARIABLE_HEADER      *Cursor;
+  VARIABLE_HEADER      *StartPtr;
+  VARIABLE_HEADER      *EndPtr;
+  UINTN                NameSize;
+
+  Cursor = mGetNextVariableCursor;
+  if (Cursor == NULL) {
+    return FALSE;
+  }
+
+  //
+  // The cursor must still be inside one of the given stores, which are not the
+  // same after the virtual address change or the release of the HOB store.
+  //
+  for (StoreType = (VARIABLE_STORE_TYPE)0; StoreType < VariableStoreTypeMax; StoreType++) {
+    if ((VariableStoreList[StoreType] != NULL) && (GetStartPointer (VariableStoreList[StoreType]) == mGetNextVariableCursorStart)) {
+      break;
+    }
+  }
+
+  if (StoreType == VariableStoreTypeMax) {
+    return FALSE;
+  }
+
+  StartPtr = mGetNextVariableCursorStart;
+  EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
+  if ((Cursor < StartPtr) || !IsValidVariableHeader (Cursor, EndPtr) || (Cursor->State != VAR_ADDED)) {
+    return FALSE;
+  }
+
+  if (AtRuntime () && ((Cursor->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+    return FALSE;
+  }
+
+  NameSize = NameSizeOfVariable (Cursor, AuthFormat);
+  if ((NameSize != StrSize (VariableName)) ||
+      !CompareGuid (VendorGuid, GetVendorGuidPtr (Cursor, AuthFormat)) ||
+      (CompareMem (VariableName, GetVariableNamePtr (Cursor, AuthFormat), NameSize) != 0))
+  {
+    return FALSE;
+  }
+
+  PtrTrack->StartPtr               = StartPtr;
+  PtrTrack->EndPtr                 = EndPtr;
+  PtrTrack->CurrPtr                = Cursor;
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  PtrTrack->Volatile               = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
+
+  return TRUE;
+}
+
 /**
   This code finds the next available variable.
 
@@ -563,19 +678,26 @@ VariableServiceGetNextVariableInternal (
 
   ZeroMem (&Variable, sizeof (Variable));
 
-  // Check if the variable exists in the given variable store list
-  for (StoreType = (VARIABLE_STORE_TYPE)0; StoreType < VariableStoreTypeMax; StoreType++) {
-    if (VariableStoreList[StoreType] == NULL) {
-      continue;
-    }
+  if ((VariableName[0] != 0) && FindVariableAtCursor (VariableName, VendorGuid, VariableStoreList, &Variable, AuthFormat)) {
+    //
+    // The enumeration continues from the variable returned by the last call.
+    //
+    Status = EFI_SUCCESS;
+  } else {
+    // Check if the variable exists in the given variable store list
+    for (StoreType = (VARIABLE_STORE_TYPE)0; StoreType < VariableStoreTypeMax; StoreType++) {
+      if (VariableStoreList[StoreType] == NULL) {
+        continue;
+      }
 
-    Variable.StartPtr = GetStartPointer (VariableStoreList[StoreType]);
-    Variable.EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
-    Variable.Volatile = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
+      Variable.StartPtr = GetStartPointer (VariableStoreList[StoreType]);
+      Variable.EndPtr   = GetEndPointer (VariableStoreList[StoreType]);
+      Variable.Volatile = (BOOLEAN)(StoreType == VariableStoreTypeVolatile);
 
-    Status = FindVariableEx (VariableName, VendorGuid, FALSE, &Variable, AuthFormat);
-    if (!EFI_ERROR (Status)) {
-      break;
+      Status = FindVariableEx (VariableName, VendorGuid, FALSE, &Variable, AuthFormat);
+      if (!EFI_ERROR (Status)) {
+        break;
+      }
     }
   }
 
@@ -701,6 +823,13 @@ VariableServiceGetNextVariableInternal (
   }
 
 Done:
+  if (Status == EFI_SUCCESS) {
+    mGetNextVariableCursor      = *VariablePtr;
+    mGetNextVariableCursorStart = Variable.StartPtr;
+  } else {
+    ResetGetNextVariableCursor ();
+  }
+
   return Status;
 }
 
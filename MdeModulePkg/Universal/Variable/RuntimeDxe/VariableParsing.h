@@ -311,6 +311,16 @@ VariableServiceGetNextVariableInternal (
   IN  BOOLEAN                AuthFormat
   );
 
+/**
+  Drop the variable VariableServiceGetNextVariableInternal () continues from,
+  after a variable store was rewritten.
+
+**/
+VOID
+ResetGetNextVariableCursor (
+  VOID
+  );
+
 /**
   Routine used to track statistical information about variable usage.
   The data is stored in the EFI system table so it can be accessed later.
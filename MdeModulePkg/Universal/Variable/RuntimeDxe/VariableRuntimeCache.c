@@ -156,3 +156,79 @@ SynchronizeRuntimeVariableCache (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Records a range of a variable store that was written, to be synchronized
+  to its runtime cache by SynchronizeDirtyRuntimeVariableCaches ().
+
+  The ranges recorded before a synchronization are coalesced.
+
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache of the store.
+  @param[in] Offset               Offset in bytes of the range in the store.
+  @param[in] Length               Length of the range in bytes.
+
+**/
+VOID
+MarkRuntimeVariableCacheDirty (
+  IN  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN  UINTN                   Offset,
+  IN  UINTN                   Length
+  )
+{
+  UINTN  End;
+
+  if ((VariableRuntimeCache->Store == NULL) || (Length == 0)) {
+    return;
+  }
+
+  if (VariableRuntimeCache->DirtyLength > 0) {
+    End                               = MAX ((UINTN)VariableRuntimeCache->DirtyOffset + VariableRuntimeCache->DirtyLength, Offset + Length);
+    VariableRuntimeCache->DirtyOffset = (UINT32)MIN ((UINTN)VariableRuntimeCache->DirtyOffset, Offset);
+    VariableRuntimeCache->DirtyLength = (UINT32)(End - VariableRuntimeCache->DirtyOffset);
+  } else {
+    VariableRuntimeCache->DirtyOffset = (UINT32)Offset;
+    VariableRuntimeCache->DirtyLength = (UINT32)Length;
+  }
+}
+
+/**
+  Synchronizes the ranges of the volatile and non-volatile variable stores
+  recorded by MarkRuntimeVariableCacheDirty () with their runtime caches.
+
+  @retval EFI_SUCCESS             The updates were added as pending updates successfully. If the variable runtime
+                                  cache ReadLock was available, the runtime caches were updated successfully.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+SynchronizeDirtyRuntimeVariableCaches (
+  VOID
+  )
+{
+  EFI_STATUS              Status;
+  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache[2];
+  UINTN                   Index;
+
+  VariableRuntimeCache[0] = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache;
+  VariableRuntimeCache[1] = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache;
+
+  for (Index = 0; Index < ARRAY_SIZE (VariableRuntimeCache); Index++) {
+    if (VariableRuntimeCache[Index]->DirtyLength == 0) {
+      continue;
+    }
+
+    Status = SynchronizeRuntimeVariableCache (
+               VariableRuntimeCache[Index],
+               VariableRuntimeCache[Index]->DirtyOffset,
+               VariableRuntimeCache[Index]->DirtyLength
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    VariableRuntimeCache[Index]->DirtyOffset = 0;
+    VariableRuntimeCache[Index]->DirtyLength = 0;
+  }
+
+  return EFI_SUCCESS;
+}
@@ -48,4 +48,36 @@ SynchronizeRuntimeVariableCache (
   IN  UINTN                   Length
   );
 
+/**
+  Records a range of a variable store that was written, to be synchronized
+  to its runtime cache by SynchronizeDirtyRuntimeVariableCaches ().
+
+  The ranges recorded before a synchronization are coalesced.
+
+  @param[in] VariableRuntimeCache Variable runtime cache structure for the runtime cache of the store.
+  @param[in] Offset               Offset in bytes of the range in the store.
+  @param[in] Length               Length of the range in bytes.
+
+**/
+VOID
+MarkRuntimeVariableCacheDirty (
+  IN  VARIABLE_RUNTIME_CACHE  *VariableRuntimeCache,
+  IN  UINTN                   Offset,
+  IN  UINTN                   Length
+  );
+
+/**
+  Synchronizes the ranges of the volatile and non-volatile variable stores
+  recorded by MarkRuntimeVariableCacheDirty () with their runtime caches.
+
+  @retval EFI_SUCCESS             The updates were added as pending updates successfully. If the variable runtime
+                                  cache ReadLock was available, the runtime caches were updated successfully.
+  @retval EFI_UNSUPPORTED         The volatile store to be updated is not initialized properly.
+
+**/
+EFI_STATUS
+SynchronizeDirtyRuntimeVariableCaches (
+  VOID
+  );
+
 #endif
@@ -463,6 +463,8 @@ SmmVariableHandler (
   SMM_VARIABLE_COMMUNICATE_HEADER                          *SmmVariableFunctionHeader;
   SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE                 *SmmVariableHeader;
   SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME          *GetNextVariableName;
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME          *NextVariableName;
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES         *GetNextVariableNames;
   SMM_VARIABLE_COMMUNICATE_QUERY_VARIABLE_INFO             *QueryVariableInfo;
   SMM_VARIABLE_COMMUNICATE_GET_PAYLOAD_SIZE                *GetPayloadSize;
   SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT  *RuntimeVariableCacheContext;
@@ -608,6 +610,68 @@ SmmVariableHandler (
       CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
       break;
 
+    case SMM_VARIABLE_FUNCTION_GET_NEXT_VARIABLE_NAMES:
+      if (CommBufferPayloadSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES, Names.Name)) {
+        DEBUG ((DEBUG_ERROR, "GetNextVariableNames: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      GetNextVariableNames = (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES *)mVariableBufferPayload;
+
+      NameBufferSize = CommBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES, Names.Name);
+      if ((NameBufferSize < sizeof (CHAR16)) || (GetNextVariableNames->Names.Name[NameBufferSize/sizeof (CHAR16) - 1] != L'\0')) {
+        //
+        // Make sure input VariableName is A Null-terminated string.
+        //
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
+
+      //
+      // Each name is looked up after the previous one, copied to the space of
+      // the next name. The caller defined NameSize is ignored, each name can
+      // take the rest of the payload.
+      //
+      GetNextVariableNames->NameCount = 0;
+      GetNextVariableNames->LastName  = FALSE;
+      NextVariableName                = &GetNextVariableNames->Names;
+      while (TRUE) {
+        NextVariableName->NameSize = CommBufferPayloadSize - ((UINTN)NextVariableName->Name - (UINTN)mVariableBufferPayload);
+        Status                     = VariableServiceGetNextVariableName (
+                                       &NextVariableName->NameSize,
+                                       NextVariableName->Name,
+                                       &NextVariableName->Guid
+                                       );
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+
+        GetNextVariableNames->NameCount++;
+        GetNextVariableName = NextVariableName;
+        NextVariableName    = SMM_VARIABLE_NEXT_VARIABLE_NAME (GetNextVariableName);
+        InfoSize            = (UINTN)NextVariableName - (UINTN)mVariableBufferPayload;
+        if ((InfoSize >= CommBufferPayloadSize) ||
+            (CommBufferPayloadSize - InfoSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME, Name) + GetNextVariableName->NameSize))
+        {
+          break;
+        }
+
+        CopyGuid (&NextVariableName->Guid, &GetNextVariableName->Guid);
+        CopyMem (NextVariableName->Name, GetNextVariableName->Name, GetNextVariableName->NameSize);
+      }
+
+      if (GetNextVariableNames->NameCount != 0) {
+        GetNextVariableNames->LastName = (BOOLEAN)(Status == EFI_NOT_FOUND);
+        Status                         = EFI_SUCCESS;
+      }
+
+      CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
+      break;
+
     case SMM_VARIABLE_FUNCTION_SET_VARIABLE:
       if (CommBufferPayloadSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) {
         DEBUG ((DEBUG_ERROR, "SetVariable: SMM communication buffer size invalid!\n"));
@@ -924,6 +988,16 @@ SmmVariableHandler (
         goto EXIT;
       }
 
+      if (!VariableSmmIsBufferOutsideSmmValid (
+             (UINTN)RuntimeVariableCacheContext->StoreGeneration,
+             sizeof (*(RuntimeVariableCacheContext->StoreGeneration))
+             ))
+      {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache store generation buffer in SMRAM or overflow!\n"));
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
+
       VariableCacheContext                                     = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
       VariableCacheContext->VariableRuntimeVolatileCache.Store = RuntimeVariableCacheContext->RuntimeVolatileCache;
@@ -931,6 +1005,7 @@ SmmVariableHandler (
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
       VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->StoreGeneration                    = RuntimeVariableCacheContext->StoreGeneration;
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
       VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
@@ -42,6 +42,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PrivilegePolymorphic.h"
 #include "VariableParsing.h"
+#include "VariableIndex.h"
 
 EFI_HANDLE                      mHandle                              = NULL;
 EFI_SMM_VARIABLE_PROTOCOL       *mSmmVariable                        = NULL;
@@ -62,6 +63,12 @@ BOOLEAN                         mVariableRuntimeCachePendingUpdate;
 BOOLEAN                         mVariableRuntimeCacheReadLock;
 BOOLEAN                         mVariableAuthFormat;
 BOOLEAN                         mHobFlushComplete;
+UINT32                          mVariableRuntimeCacheStoreGeneration;
+UINT32                          mVariableIndexStoreGeneration;
+UINT8                           *mVariableNameBatch = NULL;
+UINTN                           mVariableNameBatchIndex;
+UINTN                           mVariableNameBatchLastOffset;
+UINTN                           mVariableNameBatchNextOffset;
 EFI_LOCK                        mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
@@ -586,6 +593,15 @@ CheckForRuntimeCacheSync (
 
     mVariableRuntimeHobCacheBuffer = NULL;
   }
+
+  //
+  // A reclaim in SMM moved the variables of the cached stores.
+  //
+  if (mVariableIndexStoreGeneration != mVariableRuntimeCacheStoreGeneration) {
+    mVariableIndexStoreGeneration = mVariableRuntimeCacheStoreGeneration;
+    VariableIndexInvalidateAll ();
+    ResetGetNextVariableCursor ();
+  }
 }
 
 /**
@@ -944,6 +960,160 @@ GetNextVariableNameInRuntimeCache (
   return Status;
 }
 
+/**
+  Returns the next name of the names the last GetNextVariableNames request
+  copied to mVariableNameBatch.
+
+  @param[in, out] VariableNameSize   Size of the variable name.
+  @param[out]     VariableName       Pointer to variable name.
+  @param[out]     VendorGuid         Variable Vendor Guid.
+
+  @retval EFI_SUCCESS                Find the specified variable.
+  @retval EFI_BUFFER_TO_SMALL        DataSize is too small for the result.
+
+**/
+STATIC
+EFI_STATUS
+GetNextVariableNameFromBatch (
+  IN OUT  UINTN     *VariableNameSize,
+  OUT     CHAR16    *VariableName,
+  OUT     EFI_GUID  *VendorGuid
+  )
+{
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME  *NextName;
+
+  NextName = (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME *)(mVariableNameBatch + mVariableNameBatchNextOffset);
+  if (NextName->NameSize > *VariableNameSize) {
+    *VariableNameSize = NextName->NameSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *VariableNameSize = NextName->NameSize;
+  CopyGuid (VendorGuid, &NextName->Guid);
+  CopyMem (VariableName, NextName->Name, NextName->NameSize);
+
+  mVariableNameBatchIndex++;
+  mVariableNameBatchLastOffset = mVariableNameBatchNextOffset;
+  mVariableNameBatchNextOffset = (UINTN)SMM_VARIABLE_NEXT_VARIABLE_NAME (NextName) - (UINTN)mVariableNameBatch;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Finds the next available variable in the names the last GetNextVariableNames
+  request returned, if the name to start after is the last one handed out of
+  them.
+
+  The UEFI specification makes the result of an enumeration unpredictable when
+  a variable changes between two calls to GetNextVariableName (), but the names
+  are dropped anyway when this driver sets a variable.
+
+  @param[in, out] VariableNameSize   Size of the variable name.
+  @param[in, out] VariableName       Pointer to variable name.
+  @param[in, out] VendorGuid         Variable Vendor Guid.
+  @param[out]     Status             The result of the request, when it was served.
+
+  @retval TRUE                       The request was served from the names.
+  @retval FALSE                      The names must be requested from SMM.
+
+**/
+STATIC
+BOOLEAN
+GetNextVariableNameInBatch (
+  IN OUT  UINTN       *VariableNameSize,
+  IN OUT  CHAR16      *VariableName,
+  IN OUT  EFI_GUID    *VendorGuid,
+  OUT     EFI_STATUS  *Status
+  )
+{
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES  *Batch;
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME   *LastName;
+
+  Batch = (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES *)mVariableNameBatch;
+  if ((mVariableNameBatchIndex == 0) || (mVariableNameBatchIndex > Batch->NameCount)) {
+    return FALSE;
+  }
+
+  LastName = (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME *)(mVariableNameBatch + mVariableNameBatchLastOffset);
+  if (!CompareGuid (VendorGuid, &LastName->Guid) || (StrCmp (VariableName, LastName->Name) != 0)) {
+    return FALSE;
+  }
+
+  if (mVariableNameBatchIndex == Batch->NameCount) {
+    if (!Batch->LastName) {
+      return FALSE;
+    }
+
+    *Status = EFI_NOT_FOUND;
+    return TRUE;
+  }
+
+  *Status = GetNextVariableNameFromBatch (VariableNameSize, VariableName, VendorGuid);
+  return TRUE;
+}
+
+/**
+  Requests from SMM the names of the variables following a variable, as many as
+  the communication buffer can hold, and keeps them in mVariableNameBatch.
+
+  @param[in] VariableName            Pointer to variable name.
+  @param[in] VendorGuid              Variable Vendor Guid.
+
+  @retval EFI_SUCCESS                At least one name was returned.
+  @retval EFI_NOT_FOUND              The variable is the last one.
+  @retval EFI_UNSUPPORTED            The SMM variable driver does not support the request.
+  @retval Others                     The names could not be requested.
+
+**/
+STATIC
+EFI_STATUS
+GetNextVariableNamesInSmm (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid
+  )
+{
+  EFI_STATUS                                        Status;
+  UINTN                                             InVariableNameSize;
+  SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES  *SmmGetNextVariableNames;
+
+  mVariableNameBatchIndex = 0;
+  InVariableNameSize      = StrSize (VariableName);
+  SmmGetNextVariableNames = NULL;
+
+  if (InVariableNameSize > mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES, Names.Name)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = InitCommunicateBuffer ((VOID **)&SmmGetNextVariableNames, mVariableBufferPayloadSize, SMM_VARIABLE_FUNCTION_GET_NEXT_VARIABLE_NAMES);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ASSERT (SmmGetNextVariableNames != NULL);
+
+  //
+  // The rest of the payload is zeroed, the SMI handler requires the name
+  // buffer to end with a Null-terminator.
+  //
+  SmmGetNextVariableNames->Names.NameSize = InVariableNameSize;
+  CopyGuid (&SmmGetNextVariableNames->Names.Guid, VendorGuid);
+  CopyMem (SmmGetNextVariableNames->Names.Name, VariableName, InVariableNameSize);
+  ZeroMem (
+    (UINT8 *)SmmGetNextVariableNames->Names.Name + InVariableNameSize,
+    mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES, Names.Name) - InVariableNameSize
+    );
+
+  Status = SendCommunicateBuffer (mVariableBufferPayloadSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CopyMem (mVariableNameBatch, SmmGetNextVariableNames, mVariableBufferPayloadSize);
+  mVariableNameBatchNextOffset = OFFSET_OF (SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAMES, Names);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Finds the next available variable in a SMM variable store.
 
@@ -970,6 +1140,29 @@ GetNextVariableNameInSmm (
   UINTN                                            OutVariableNameSize;
   UINTN                                            InVariableNameSize;
 
+  //
+  // Enumerations get the names of the following variables in one SMI, and are
+  // served from them while they go on.
+  //
+  if (mVariableNameBatch != NULL) {
+    if (GetNextVariableNameInBatch (VariableNameSize, VariableName, VendorGuid, &Status)) {
+      return Status;
+    }
+
+    Status = GetNextVariableNamesInSmm (VariableName, VendorGuid);
+    if (!EFI_ERROR (Status)) {
+      return GetNextVariableNameFromBatch (VariableNameSize, VariableName, VendorGuid);
+    }
+
+    if (Status == EFI_NOT_FOUND) {
+      return Status;
+    }
+
+    if (Status == EFI_UNSUPPORTED) {
+      mVariableNameBatch = NULL;
+    }
+  }
+
   OutVariableNameSize    = *VariableNameSize;
   InVariableNameSize     = StrSize (VariableName);
   SmmGetNextVariableName = NULL;
@@ -1159,6 +1352,11 @@ RuntimeServiceSetVariable (
 
   AcquireLockOnlyAtBootTime (&mVariableServicesLock);
 
+  //
+  // Drop the names of the current enumeration.
+  //
+  mVariableNameBatchIndex = 0;
+
   //
   // Init the communicate buffer. The buffer data size is:
   // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + PayloadSize.
@@ -1356,11 +1554,19 @@ VariableAddressChangeEvent (
   IN VOID       *Context
   )
 {
+  UINTN  Index;
+
   EfiConvertPointer (0x0, (VOID **)&mVariableBuffer);
   EfiConvertPointer (0x0, (VOID **)&mMmCommunication2);
+  EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableNameBatch);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRuntimeVolatileCacheBuffer);
+
+  for (Index = 0; Index < ARRAY_SIZE (mVariableIndexRegistration); Index++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableIndexRegistration[Index].StartPtr);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableIndexRegistration[Index].Index);
+  }
 }
 
 /**
@@ -1570,6 +1776,7 @@ SendRuntimeVariableCacheContextToSmm (
   SmmRuntimeVarCacheContext->PendingUpdate        = &mVariableRuntimeCachePendingUpdate;
   SmmRuntimeVarCacheContext->ReadLock             = &mVariableRuntimeCacheReadLock;
   SmmRuntimeVarCacheContext->HobFlushComplete     = &mHobFlushComplete;
+  SmmRuntimeVarCacheContext->StoreGeneration      = &mVariableRuntimeCacheStoreGeneration;
 
   //
   // Request to unblock this region to be accessible from inside MM environment
@@ -1599,6 +1806,14 @@ SendRuntimeVariableCacheContextToSmm (
     goto Done;
   }
 
+  Status = MmUnblockMemoryRequest (
+             (EFI_PHYSICAL_ADDRESS)ALIGN_VALUE ((UINTN)SmmRuntimeVarCacheContext->StoreGeneration - EFI_PAGE_SIZE + 1, EFI_PAGE_SIZE),
+             EFI_SIZE_TO_PAGES (sizeof (mVariableRuntimeCacheStoreGeneration))
+             );
+  if ((Status != EFI_UNSUPPORTED) && EFI_ERROR (Status)) {
+    goto Done;
+  }
+
   //
   // Send data to SMM.
   //
@@ -1675,6 +1890,9 @@ SmmVariableReady (
         if (!EFI_ERROR (Status)) {
           Status = InitVariableCache (&mVariableRuntimeVolatileCacheBuffer, &mVariableRuntimeVolatileCacheBufferSize);
           if (!EFI_ERROR (Status)) {
+            VariableIndexCreate (mVariableRuntimeHobCacheBuffer);
+            VariableIndexCreate (mVariableRuntimeNvCacheBuffer);
+            VariableIndexCreate (mVariableRuntimeVolatileCacheBuffer);
             Status = SendRuntimeVariableCacheContextToSmm ();
             if (!EFI_ERROR (Status)) {
               SyncRuntimeCache ();
@@ -1693,6 +1911,11 @@ SmmVariableReady (
     ASSERT_EFI_ERROR (Status);
   } else {
     DEBUG ((DEBUG_INFO, "Variable driver runtime cache is disabled.\n"));
+    //
+    // GetNextVariableName () requests the names in batches, it runs without
+    // them if the buffer cannot be allocated.
+    //
+    mVariableNameBatch = AllocateRuntimePool (mVariableBufferPayloadSize);
   }
 
   gRT->GetVariable         = RuntimeServiceGetVariable;
@@ -0,0 +1,54 @@
+/** @file
+  GUID and data structure of the GUIDed HOB index.
+
+  The DXE Core publishes this index of the GUID extension HOBs of the HOB list
+  in the EFI System Configuration Table, so that HOB Library instances used
+  after the DXE Core can find GUIDed HOBs without walking the HOB list.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HOB_LIST_INDEX_GUID_H__
+#define __HOB_LIST_INDEX_GUID_H__
+
+#define HOB_LIST_INDEX_GUID \
+  { \
+    0xdaa13ea5, 0x988c, 0x4f8a, { 0xa8, 0xf9, 0x30, 0x53, 0x82, 0xed, 0x40, 0x15 } \
+  }
+
+typedef struct {
+  ///
+  /// Name of the GUID extension HOB.
+  ///
+  EFI_GUID                     Name;
+  ///
+  /// Pointer to the GUID extension HOB.
+  ///
+  EFI_HOB_GUID_TYPE            *Hob;
+} HOB_LIST_INDEX_ENTRY;
+
+typedef struct {
+  ///
+  /// The HOB list the index was built for.
+  ///
+  VOID                         *HobList;
+  ///
+  /// The end of the HOB list, the HOB of type EFI_HOB_TYPE_END_OF_HOB_LIST.
+  ///
+  VOID                         *EndOfHobList;
+  ///
+  /// Number of entries in the index.
+  ///
+  UINTN                        Count;
+  ///
+  /// The GUID extension HOBs, sorted by name. Entries of the same name are in
+  /// the order of the HOBs in the HOB list.
+  ///
+  HOB_LIST_INDEX_ENTRY         Entry[1];
+} HOB_LIST_INDEX;
+
+extern EFI_GUID  gEdkiiHobListIndexGuid;
+
+#endif
@@ -75,6 +75,13 @@
 ///
 #define HTTP_HEADER_ACCEPT_RANGES  "Accept-Ranges"
 
+///
+/// Range Request Header
+/// The Range request-header field asks the server to return only the
+/// given byte ranges of the entity instead of the entire entity.
+///
+#define HTTP_HEADER_RANGE  "Range"
+
 ///
 /// Accept-Encoding Request Header
 /// The Accept-Encoding request-header field is similar to Accept,
@@ -227,6 +234,13 @@
 ///
 #define HTTP_HEADER_ETAG  "ETag"
 
+///
+/// Digest Response Header (RFC 3230)
+/// The Digest response-header field carries one or more digests of the
+/// instance, such as "SHA-256=" followed by the base64 encoded digest.
+///
+#define HTTP_HEADER_DIGEST  "Digest"
+
 ///
 /// Custom header field checked by the iLO web server to
 /// specify a client session key.
@@ -2954,6 +2954,39 @@ QuickSort (
   OUT VOID                    *BufferOneElement
   );
 
+/**
+  Sort a buffer of equal sized elements, keeping the elements that compare
+  equal in their original order.
+
+  This is a merge sort that takes O(n log n) comparisons, and O(n) comparisons
+  on an already sorted buffer.
+
+  If BufferToSort is NULL, then ASSERT.
+  If CompareFunction is NULL, then ASSERT.
+  If ScratchBuffer is NULL, then ASSERT.
+  If ElementSize is < 1, then ASSERT.
+
+  If Count is < 2 then perform no action.
+
+  @param[in, out] BufferToSort   On call a Buffer of (possibly sorted) elements,
+                                 on return a buffer of sorted elements.
+  @param[in] Count               The number of elements in the buffer to sort.
+  @param[in] ElementSize         Size of an element in bytes.
+  @param[in] CompareFunction     The function to call to perform the comparison
+                                 of any 2 elements.
+  @param[out] ScratchBuffer      Caller provided buffer of Count * ElementSize
+                                 bytes, used for merging.
+**/
+VOID
+EFIAPI
+StableSort (
+  IN OUT VOID                 *BufferToSort,
+  IN CONST UINTN              Count,
+  IN CONST UINTN              ElementSize,
+  IN       BASE_SORT_COMPARE  CompareFunction,
+  OUT VOID                    *ScratchBuffer
+  );
+
 /**
   Shifts a 64-bit integer left between 0 and 63 bits. The low bits are filled
   with zeros. The shifted value is returned.
@@ -244,6 +244,26 @@ GetDevicePathSize (
   IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   );
 
+/**
+  Returns a hash of a device path.
+
+  Device paths with the same bytes have the same hash. A caller that compares
+  a set of device paths with others many times can compute their hashes once,
+  and only compare the bytes of the device paths whose hashes are equal.
+
+  @param  DevicePath  A pointer to a device path data structure.
+
+  @retval 0           If DevicePath is NULL or invalid.
+  @retval Others      The hash of the device path, including the end of
+                      device path node.
+
+**/
+UINT32
+EFIAPI
+GetDevicePathHash (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
 /**
   Creates a new copy of an existing device path.
 
@@ -63,6 +63,17 @@ typedef struct {
   CHAR8     Data[];
 } FDT_PROPERTY;
 
+/**
+  Flattened Device Tree index
+
+  An index that FdtIndexBuild() builds once over a FDT blob, so that the nodes
+  can be looked up by path, phandle and compatible string without scanning the
+  structure block. The layout is private to the library. The index holds the
+  node offsets of the blob, so it must be built again after the blob is
+  modified.
+**/
+typedef struct _FDT_INDEX FDT_INDEX;
+
 /**
   Convert UINT16 data of the FDT blob to little-endian
 
@@ -398,4 +409,104 @@ FdtSetProp (
   IN UINT32       Length
   );
 
+/**
+  Returns the size of the buffer that FdtIndexBuild() needs to index the FDT.
+
+  @param[in]  Fdt           The pointer to FDT blob.
+  @param[out] IndexSize     The size, in bytes, of the index buffer.
+
+  @return Zero for successfully, otherwise failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexGetSize (
+  IN  CONST VOID  *Fdt,
+  OUT UINTN       *IndexSize
+  );
+
+/**
+  Builds an index of the nodes of the FDT by path, phandle and compatible string.
+
+  The FDT blob must not be modified or moved while the index is used.
+
+  @param[in]  Fdt           The pointer to FDT blob.
+  @param[out] Index         The buffer to build the index in, aligned on a
+                            UINTN boundary.
+  @param[in]  IndexSize     The size, in bytes, of the buffer, which is at least
+                            the size returned by FdtIndexGetSize().
+
+  @return Zero for successfully, otherwise failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexBuild (
+  IN  CONST VOID  *Fdt,
+  OUT FDT_INDEX   *Index,
+  IN  UINTN       IndexSize
+  );
+
+/**
+  Returns the offset of the node with the given path, like the libfdt
+  fdt_path_offset() does.
+
+  The path is either a full path or begins with an alias of the /aliases node.
+  A path component without a unit address matches the first sibling node whose
+  name only differs by its unit address.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Path           The path to the node.
+
+  @return The offset to the node with the given path, otherwise a negative
+          value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexPathOffset (
+  IN CONST FDT_INDEX  *Index,
+  IN CONST CHAR8      *Path
+  );
+
+/**
+  Returns the offset of the node with the given phandle, like the libfdt
+  fdt_node_offset_by_phandle() does.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Phandle        The phandle of the node.
+
+  @return The offset to the node with the given phandle, otherwise a negative
+          value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexNodeOffsetByPhandle (
+  IN CONST FDT_INDEX  *Index,
+  IN UINT32           Phandle
+  );
+
+/**
+  Returns the offset of the next node that is compatible with the given string,
+  like the libfdt fdt_node_offset_by_compatible() does.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] StartOffset    The offset to the node after which to start the
+                            search, or -1 to start at the root node.
+  @param[in] Compatible     The string to match one of the strings of the
+                            compatible property against.
+
+  @return The offset to the first node after StartOffset that is compatible
+          with the given string, otherwise a negative value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexNodeOffsetByCompatible (
+  IN CONST FDT_INDEX  *Index,
+  IN INT32            StartOffset,
+  IN CONST CHAR8      *Compatible
+  );
+
 #endif /* FDT_LIB_H_ */
@@ -130,6 +130,56 @@ OrderedCollectionInit (
   IN ORDERED_COLLECTION_KEY_COMPARE   KeyCompare
   );
 
+/**
+  Return the size of the entry pool that holds EntryCount collection entries.
+
+  @param[in] EntryCount  The number of collection entries.
+
+  @return  The size in bytes of the pool.
+**/
+UINTN
+EFIAPI
+OrderedCollectionPoolSize (
+  IN UINTN  EntryCount
+  );
+
+/**
+  Allocate and initialize the ORDERED_COLLECTION structure, which takes its
+  entries from a caller-supplied pool.
+
+  The entries are carved from Pool, and the deleted entries are reused by the
+  later insertions, which avoids an allocation per entry. When Pool is
+  exhausted, the entries are allocated as with OrderedCollectionInit().
+
+  @param[in]  UserStructCompare  This caller-provided function will be used to
+                                 order two user structures linked into the
+                                 collection, during the insertion procedure.
+
+  @param[in]  KeyCompare         This caller-provided function will be used to
+                                 order the standalone search key against user
+                                 structures linked into the collection, during
+                                 the lookup procedure.
+
+  @param[in]  Pool               The entry pool, aligned on a 64-bit boundary.
+                                 It is owned by the caller, and it must remain
+                                 valid until the collection is uninitialized.
+
+  @param[in]  PoolSize           The size in bytes of Pool, see
+                                 OrderedCollectionPoolSize().
+
+  @retval NULL  If allocation failed.
+  @return       Pointer to the allocated, initialized ORDERED_COLLECTION
+                structure, otherwise.
+**/
+ORDERED_COLLECTION *
+EFIAPI
+OrderedCollectionInitWithPool (
+  IN ORDERED_COLLECTION_USER_COMPARE  UserStructCompare,
+  IN ORDERED_COLLECTION_KEY_COMPARE   KeyCompare,
+  IN VOID                             *Pool,
+  IN UINTN                            PoolSize
+  );
+
 /**
   Check whether the collection is empty (has no entries).
 
@@ -270,6 +320,70 @@ OrderedCollectionPrev (
   IN CONST ORDERED_COLLECTION_ENTRY  *Entry
   );
 
+/**
+  Find the collection entry of the least user structure that does not compare
+  less than the specified standalone key.
+
+  Read-only operation.
+
+  The entries of the user structures in a key range [KeyLow, KeyHigh) are the
+  ones from OrderedCollectionLowerBound (Collection, KeyLow) up to, but
+  excluding, OrderedCollectionLowerBound (Collection, KeyHigh), with
+  OrderedCollectionNext().
+
+  @param[in] Collection     The collection to search for StandaloneKey.
+
+  @param[in] StandaloneKey  The key to bound the user structures linked into
+                            Collection with. StandaloneKey will be passed to
+                            ORDERED_COLLECTION_KEY_COMPARE.
+
+  @retval NULL  If all the user structures in Collection compare less than
+                StandaloneKey.
+
+  @return       The collection entry that links the least user structure that
+                compares greater than or equal to StandaloneKey, otherwise.
+**/
+ORDERED_COLLECTION_ENTRY *
+EFIAPI
+OrderedCollectionLowerBound (
+  IN CONST ORDERED_COLLECTION  *Collection,
+  IN CONST VOID                *StandaloneKey
+  );
+
+/**
+  Find the collection entry of the least user structure that compares greater
+  than the specified standalone key.
+
+  Read-only operation.
+
+  The entries of the user structures in a key range [KeyLow, KeyHigh] are the
+  ones from OrderedCollectionLowerBound (Collection, KeyLow) up to, but
+  excluding, OrderedCollectionUpperBound (Collection, KeyHigh), with
+  OrderedCollectionNext(). The predecessor of OrderedCollectionUpperBound
+  (Collection, Key), or OrderedCollectionMax (Collection) if it is NULL, links
+  the greatest user structure that does not compare greater than Key, such as
+  the range containing an address in a collection of ranges ordered by their
+  start.
+
+  @param[in] Collection     The collection to search for StandaloneKey.
+
+  @param[in] StandaloneKey  The key to bound the user structures linked into
+                            Collection with. StandaloneKey will be passed to
+                            ORDERED_COLLECTION_KEY_COMPARE.
+
+  @retval NULL  If no user structure in Collection compares greater than
+                StandaloneKey.
+
+  @return       The collection entry that links the least user structure that
+                compares greater than StandaloneKey, otherwise.
+**/
+ORDERED_COLLECTION_ENTRY *
+EFIAPI
+OrderedCollectionUpperBound (
+  IN CONST ORDERED_COLLECTION  *Collection,
+  IN CONST VOID                *StandaloneKey
+  );
+
 /**
   Insert (link) a user structure into the collection, allocating a new
   collection entry.
@@ -339,6 +453,41 @@ OrderedCollectionInsert (
   IN     VOID                      *UserStruct
   );
 
+/**
+  Build an empty collection from a sorted array of user structures, in O(n)
+  time rather than the O(n log n) time of as many insertions.
+
+  Read-write operation.
+
+  @param[in,out] Collection   The empty collection to link the user structures
+                              into.
+
+  @param[in]     UserStructs  The user structures to link into the collection,
+                              in strictly increasing order per
+                              ORDERED_COLLECTION_USER_COMPARE. The array itself
+                              is not referenced after the function returns.
+
+  @param[in]     Count        The number of user structures in UserStructs.
+
+  @retval RETURN_SUCCESS            The user structures have been linked into
+                                    the collection.
+
+  @retval RETURN_INVALID_PARAMETER  Collection is not empty, or UserStructs is
+                                    not strictly increasing. The collection has
+                                    not been changed.
+
+  @retval RETURN_OUT_OF_RESOURCES   The function failed to allocate memory for
+                                    the collection entries. The collection has
+                                    not been changed.
+**/
+RETURN_STATUS
+EFIAPI
+OrderedCollectionBuildSorted (
+  IN OUT ORDERED_COLLECTION  *Collection,
+  IN     VOID                **UserStructs,
+  IN     UINTN               Count
+  );
+
 /**
   Delete an entry from the collection, unlinking the associated user structure.
 
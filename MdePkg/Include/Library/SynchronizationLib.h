@@ -14,6 +14,37 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 typedef volatile UINTN SPIN_LOCK;
 
+///
+/// Definitions for TICKET_LOCK
+///
+/// A ticket lock hands the lock to the waiters in the order they asked for it.
+/// NextTicket is the ticket a new waiter takes and NowServing is the ticket of
+/// the owner, so the lock is released when the two are equal.
+///
+typedef struct {
+  volatile UINT32    NextTicket;
+  volatile UINT32    NowServing;
+} TICKET_LOCK;
+
+///
+/// Definitions for MCS_LOCK
+///
+/// An MCS lock queues the waiters in a list of MCS_LOCK_NODE structures that
+/// the waiters provide, and every waiter spins on the Locked field of its own
+/// node rather than on the lock. The lock points to the last node in the queue,
+/// or is NULL when the lock is released. A node must stay valid from the call
+/// that acquires the lock until the call that releases it, so it is usually a
+/// local variable of the caller.
+///
+typedef struct _MCS_LOCK_NODE MCS_LOCK_NODE;
+
+struct _MCS_LOCK_NODE {
+  MCS_LOCK_NODE *volatile    Next;
+  volatile BOOLEAN           Locked;
+};
+
+typedef MCS_LOCK_NODE *volatile MCS_LOCK;
+
 /**
   Retrieves the architecture-specific spin lock alignment requirements for
   optimal spin lock performance.
@@ -127,6 +158,180 @@ ReleaseSpinLock (
   IN OUT  SPIN_LOCK  *SpinLock
   );
 
+/**
+  Initializes a ticket lock to the released state and returns the ticket lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to initialize to the released
+                      state.
+
+  @return TicketLock in release state.
+
+**/
+TICKET_LOCK *
+EFIAPI
+InitializeTicketLock (
+  OUT      TICKET_LOCK  *TicketLock
+  );
+
+/**
+  Waits until a ticket lock can be placed in the acquired state.
+
+  This function takes the next ticket of the ticket lock specified by
+  TicketLock, and waits until the ticket is served. The processors that wait for
+  the same ticket lock acquire it in the order in which they called this
+  function.
+
+  If TicketLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and TicketLock is can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired state.
+
+  @return TicketLock acquired lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+AcquireTicketLock (
+  IN OUT  TICKET_LOCK  *TicketLock
+  );
+
+/**
+  Attempts to place a ticket lock in the acquired state.
+
+  This function takes the next ticket of the ticket lock specified by
+  TicketLock only if the ticket is served at once, and returns TRUE.
+  Otherwise, FALSE is returned.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired state.
+
+  @retval TRUE  TicketLock was placed in the acquired state.
+  @retval FALSE TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketLockOrFail (
+  IN OUT  TICKET_LOCK  *TicketLock
+  );
+
+/**
+  Releases a ticket lock.
+
+  This function serves the next ticket of the ticket lock specified by
+  TicketLock and returns TicketLock.
+
+  If TicketLock is NULL, then ASSERT().
+  If TicketLock is not in the acquired state, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to release.
+
+  @return TicketLock released lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+ReleaseTicketLock (
+  IN OUT  TICKET_LOCK  *TicketLock
+  );
+
+/**
+  Initializes an MCS lock to the released state and returns the MCS lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to initialize to the released
+                   state.
+
+  @return McsLock in release state.
+
+**/
+MCS_LOCK *
+EFIAPI
+InitializeMcsLock (
+  OUT      MCS_LOCK  *McsLock
+  );
+
+/**
+  Waits until an MCS lock can be placed in the acquired state.
+
+  This function appends the node specified by Node to the queue of the MCS lock
+  specified by McsLock, and waits until the previous owner hands the lock to
+  Node. The processors that wait for the same MCS lock acquire it in the order
+  in which they called this function, and each of them waits on its own node.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and McsLock is can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     A pointer to the queue node of the caller. It must be passed
+                   to ReleaseMcsLock().
+
+  @return McsLock acquired lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+AcquireMcsLock (
+  IN OUT  MCS_LOCK       *McsLock,
+  OUT     MCS_LOCK_NODE  *Node
+  );
+
+/**
+  Attempts to place an MCS lock in the acquired state.
+
+  This function places the MCS lock specified by McsLock in the acquired state
+  with the node specified by Node and returns TRUE if the lock is released.
+  Otherwise, FALSE is returned.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     A pointer to the queue node of the caller. It must be passed
+                   to ReleaseMcsLock() if TRUE is returned.
+
+  @retval TRUE  McsLock was placed in the acquired state.
+  @retval FALSE McsLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireMcsLockOrFail (
+  IN OUT  MCS_LOCK       *McsLock,
+  OUT     MCS_LOCK_NODE  *Node
+  );
+
+/**
+  Releases an MCS lock.
+
+  This function hands the MCS lock specified by McsLock to the next node in its
+  queue, or places McsLock in the release state if no processor waits for it,
+  and returns McsLock.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+  If McsLock is not in the acquired state, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to release.
+  @param  Node     A pointer to the queue node that acquired McsLock.
+
+  @return McsLock released lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+ReleaseMcsLock (
+  IN OUT  MCS_LOCK       *McsLock,
+  IN OUT  MCS_LOCK_NODE  *Node
+  );
+
 /**
   Performs an atomic increment of a 32-bit unsigned integer.
 
@@ -349,6 +349,9 @@ DebugClearMemoryEnabled (
   Returns TRUE if any one of the bit is set both in ErrorLevel and PcdFixedDebugPrintErrorLevel.
 
   This function compares the bit mask of ErrorLevel and PcdFixedDebugPrintErrorLevel.
+  The bit mask is also compared with GetDebugPrintErrorLevel (), that DebugPrint ()
+  checks anyway, so that the DEBUG () macro skips the call and the evaluation of its
+  arguments for the error levels that are only masked at run time.
 
   @retval  TRUE    Current ErrorLevel is supported.
   @retval  FALSE   Current ErrorLevel is not supported.
@@ -360,5 +363,5 @@ DebugPrintLevelEnabled (
   IN  CONST UINTN  ErrorLevel
   )
 {
-  return (BOOLEAN)((ErrorLevel & PcdGet32 (PcdFixedDebugPrintErrorLevel)) != 0);
+  return (BOOLEAN)((ErrorLevel & PcdGet32 (PcdFixedDebugPrintErrorLevel) & GetDebugPrintErrorLevel ()) != 0);
 }
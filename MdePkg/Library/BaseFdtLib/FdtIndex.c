@@ -0,0 +1,751 @@
+/** @file
+  Flattened Device Tree index.
+
+  libfdt looks nodes up by walking the structure block from the beginning, so
+  every lookup by path, phandle or compatible string costs a scan of the whole
+  tree. The index records the nodes once, with their tree links, in tables
+  sorted by phandle and by the hash of each compatible string.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <libfdt/libfdt/libfdt.h>
+#include <Library/DebugLib.h>
+#include <Library/FdtLib.h>
+
+#define FDT_INDEX_SIGNATURE  SIGNATURE_32 ('F', 'D', 'T', 'I')
+
+//
+// The deepest node FdtIndexBuild() can index, counting the root node as 0.
+//
+#define FDT_INDEX_MAX_DEPTH  64
+
+//
+// The link of a node that has no child or next sibling.
+//
+#define FDT_INDEX_NO_NODE  MAX_UINT32
+
+///
+/// A node of the FDT, and its links to the other nodes by their index in the
+/// node table, which is in the order of the structure block. NameHash is the
+/// hash of the node name without the unit address.
+///
+typedef struct {
+  INT32     Offset;
+  UINT32    NameHash;
+  UINT32    FirstChild;
+  UINT32    NextSibling;
+} FDT_INDEX_NODE;
+
+///
+/// An entry of the phandle table, which is sorted by Phandle and Node.
+///
+typedef struct {
+  UINT32    Phandle;
+  UINT32    Node;
+} FDT_INDEX_PHANDLE;
+
+///
+/// An entry for one string of a compatible property. The table is sorted by
+/// Hash and Node, and String is the offset of the string in the FDT blob.
+///
+typedef struct {
+  UINT32    Hash;
+  UINT32    Node;
+  UINT32    String;
+} FDT_INDEX_COMPATIBLE;
+
+struct _FDT_INDEX {
+  UINT32                  Signature;
+  UINT32                  NodeCount;
+  UINT32                  PhandleCount;
+  UINT32                  CompatibleCount;
+  CONST VOID              *Fdt;
+  FDT_INDEX_NODE          *Nodes;
+  FDT_INDEX_PHANDLE       *Phandles;
+  FDT_INDEX_COMPATIBLE    *Compatibles;
+};
+
+/**
+  Returns the FNV-1a hash of a string.
+
+  @param[in] String         The string to hash.
+  @param[in] Length         The length of the string.
+
+  @return The hash of the string.
+
+**/
+STATIC
+UINT32
+FdtIndexHash (
+  IN CONST CHAR8  *String,
+  IN UINTN        Length
+  )
+{
+  UINT32  Hash;
+
+  Hash = 0x811C9DC5;
+  while (Length-- > 0) {
+    Hash  = (Hash ^ (UINT8)*String++);
+    Hash *= 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Returns the hash of a node name without its unit address.
+
+  @param[in] Name           The node name.
+  @param[in] Length         The length of the node name.
+
+  @return The hash of the node name.
+
+**/
+STATIC
+UINT32
+FdtIndexNameHash (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Length
+  )
+{
+  CONST CHAR8  *UnitAddress;
+
+  UnitAddress = ScanMem8 (Name, Length, '@');
+  if (UnitAddress != NULL) {
+    Length = (UINTN)(UnitAddress - Name);
+  }
+
+  return FdtIndexHash (Name, Length);
+}
+
+/**
+  Compares two entries of the phandle table.
+
+  @param[in] Buffer1        The first entry.
+  @param[in] Buffer2        The second entry.
+
+  @return The order of the entries.
+
+**/
+STATIC
+INTN
+EFIAPI
+FdtIndexComparePhandle (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST FDT_INDEX_PHANDLE  *Entry1;
+  CONST FDT_INDEX_PHANDLE  *Entry2;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+  if (Entry1->Phandle != Entry2->Phandle) {
+    return (Entry1->Phandle < Entry2->Phandle) ? -1 : 1;
+  }
+
+  if (Entry1->Node != Entry2->Node) {
+    return (Entry1->Node < Entry2->Node) ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+  Compares two entries of the compatible table.
+
+  @param[in] Buffer1        The first entry.
+  @param[in] Buffer2        The second entry.
+
+  @return The order of the entries.
+
+**/
+STATIC
+INTN
+EFIAPI
+FdtIndexCompareCompatible (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST FDT_INDEX_COMPATIBLE  *Entry1;
+  CONST FDT_INDEX_COMPATIBLE  *Entry2;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+  if (Entry1->Hash != Entry2->Hash) {
+    return (Entry1->Hash < Entry2->Hash) ? -1 : 1;
+  }
+
+  if (Entry1->Node != Entry2->Node) {
+    return (Entry1->Node < Entry2->Node) ? -1 : 1;
+  }
+
+  if (Entry1->String != Entry2->String) {
+    return (Entry1->String < Entry2->String) ? -1 : 1;
+  }
+
+  return 0;
+}
+
+/**
+  Walks the nodes of the FDT, and counts them and their phandles and compatible
+  strings, or records them in the index.
+
+  @param[in]  Fdt               The pointer to FDT blob.
+  @param[in]  Index             The index to record the nodes in, or NULL to
+                                only count them. The tables must be large
+                                enough for the counts of a previous walk.
+  @param[out] NodeCount         The number of nodes.
+  @param[out] PhandleCount      The number of nodes that have a phandle.
+  @param[out] CompatibleCount   The number of compatible strings.
+
+  @return Zero for successfully, otherwise failed.
+
+**/
+STATIC
+INT32
+FdtIndexWalk (
+  IN  CONST VOID  *Fdt,
+  IN  FDT_INDEX   *Index OPTIONAL,
+  OUT UINT32      *NodeCount,
+  OUT UINT32      *PhandleCount,
+  OUT UINT32      *CompatibleCount
+  )
+{
+  INT32           Offset;
+  INT32           Depth;
+  INT32           Length;
+  UINT32          Node;
+  UINT32          Phandle;
+  UINTN           StringLength;
+  CONST CHAR8     *Name;
+  CONST CHAR8     *String;
+  CONST CHAR8     *End;
+  FDT_INDEX_NODE  *Entry;
+  UINT32          Parents[FDT_INDEX_MAX_DEPTH];
+  UINT32          LastChildren[FDT_INDEX_MAX_DEPTH];
+
+  *NodeCount       = 0;
+  *PhandleCount    = 0;
+  *CompatibleCount = 0;
+
+  Depth = 0;
+  for (Offset = 0; Offset >= 0 && Depth >= 0; Offset = fdt_next_node (Fdt, Offset, &Depth)) {
+    if (Depth >= FDT_INDEX_MAX_DEPTH) {
+      return -FDT_ERR_BADSTRUCTURE;
+    }
+
+    Node = (*NodeCount)++;
+    if (Index != NULL) {
+      Name = fdt_get_name (Fdt, Offset, &Length);
+      if (Name == NULL) {
+        return Length;
+      }
+
+      Entry              = &Index->Nodes[Node];
+      Entry->Offset      = Offset;
+      Entry->NameHash    = FdtIndexNameHash (Name, (UINTN)Length);
+      Entry->FirstChild  = FDT_INDEX_NO_NODE;
+      Entry->NextSibling = FDT_INDEX_NO_NODE;
+      if (Depth > 0) {
+        //
+        // Link the node behind the last child of its parent.
+        //
+        if (LastChildren[Depth - 1] == FDT_INDEX_NO_NODE) {
+          Index->Nodes[Parents[Depth - 1]].FirstChild = Node;
+        } else {
+          Index->Nodes[LastChildren[Depth - 1]].NextSibling = Node;
+        }
+
+        LastChildren[Depth - 1] = Node;
+      }
+
+      Parents[Depth]      = Node;
+      LastChildren[Depth] = FDT_INDEX_NO_NODE;
+    }
+
+    Phandle = fdt_get_phandle (Fdt, Offset);
+    if ((Phandle != 0) && (Phandle != MAX_UINT32)) {
+      if (Index != NULL) {
+        Index->Phandles[*PhandleCount].Phandle = Phandle;
+        Index->Phandles[*PhandleCount].Node    = Node;
+      }
+
+      (*PhandleCount)++;
+    }
+
+    //
+    // The compatible property is a list of NUL terminated strings. As libfdt
+    // does, ignore the tail of the list if it is not terminated.
+    //
+    String = fdt_getprop (Fdt, Offset, "compatible", &Length);
+    if (String == NULL) {
+      continue;
+    }
+
+    End = String + Length;
+    while (String < End) {
+      if (ScanMem8 (String, (UINTN)(End - String), '\0') == NULL) {
+        break;
+      }
+
+      StringLength = AsciiStrLen (String);
+      if (Index != NULL) {
+        Index->Compatibles[*CompatibleCount].Hash   = FdtIndexHash (String, StringLength);
+        Index->Compatibles[*CompatibleCount].Node   = Node;
+        Index->Compatibles[*CompatibleCount].String = (UINT32)((UINTN)String - (UINTN)Fdt);
+      }
+
+      (*CompatibleCount)++;
+      String += StringLength + 1;
+    }
+  }
+
+  if ((Offset < 0) && (Offset != -FDT_ERR_NOTFOUND)) {
+    return Offset;
+  }
+
+  return 0;
+}
+
+/**
+  Returns the size of the index of the given counts.
+
+  @param[in] NodeCount          The number of nodes.
+  @param[in] PhandleCount       The number of nodes that have a phandle.
+  @param[in] CompatibleCount    The number of compatible strings.
+
+  @return The size, in bytes, of the index.
+
+**/
+STATIC
+UINTN
+FdtIndexSize (
+  IN UINT32  NodeCount,
+  IN UINT32  PhandleCount,
+  IN UINT32  CompatibleCount
+  )
+{
+  return ALIGN_VALUE (sizeof (FDT_INDEX), sizeof (UINT64)) +
+         NodeCount * sizeof (FDT_INDEX_NODE) +
+         PhandleCount * sizeof (FDT_INDEX_PHANDLE) +
+         CompatibleCount * sizeof (FDT_INDEX_COMPATIBLE);
+}
+
+/**
+  Returns the index of the node at the given offset in the node table.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Offset         The offset to the node.
+
+  @return The index of the node, or FDT_INDEX_NO_NODE if there is no node at
+          Offset.
+
+**/
+STATIC
+UINT32
+FdtIndexFindNode (
+  IN CONST FDT_INDEX  *Index,
+  IN INT32            Offset
+  )
+{
+  UINT32  Low;
+  UINT32  High;
+  UINT32  Middle;
+
+  Low  = 0;
+  High = Index->NodeCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (Index->Nodes[Middle].Offset < Offset) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->NodeCount) && (Index->Nodes[Low].Offset == Offset)) {
+    return Low;
+  }
+
+  return FDT_INDEX_NO_NODE;
+}
+
+/**
+  Returns the first child of a node that has the given name, as the libfdt
+  fdt_subnode_offset_namelen() does.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Node           The index of the parent node.
+  @param[in] Name           The name of the child, which may omit the unit
+                            address.
+  @param[in] NameLength     The length of the name.
+
+  @return The index of the child, or FDT_INDEX_NO_NODE if there is none.
+
+**/
+STATIC
+UINT32
+FdtIndexFindSubnode (
+  IN CONST FDT_INDEX  *Index,
+  IN UINT32           Node,
+  IN CONST CHAR8      *Name,
+  IN UINTN            NameLength
+  )
+{
+  UINT32       Child;
+  UINT32       NameHash;
+  CONST CHAR8  *ChildName;
+  INT32        ChildNameLength;
+  BOOLEAN      HasUnitAddress;
+
+  HasUnitAddress = (BOOLEAN)(ScanMem8 (Name, NameLength, '@') != NULL);
+  NameHash       = FdtIndexNameHash (Name, NameLength);
+  for (Child = Index->Nodes[Node].FirstChild;
+       Child != FDT_INDEX_NO_NODE;
+       Child = Index->Nodes[Child].NextSibling)
+  {
+    if (Index->Nodes[Child].NameHash != NameHash) {
+      continue;
+    }
+
+    ChildName = fdt_get_name (Index->Fdt, Index->Nodes[Child].Offset, &ChildNameLength);
+    if ((ChildName == NULL) || ((UINTN)ChildNameLength < NameLength) ||
+        (CompareMem (ChildName, Name, NameLength) != 0))
+    {
+      continue;
+    }
+
+    if ((ChildName[NameLength] == '\0') ||
+        (!HasUnitAddress && (ChildName[NameLength] == '@')))
+    {
+      return Child;
+    }
+  }
+
+  return FDT_INDEX_NO_NODE;
+}
+
+/**
+  Returns the size of the buffer that FdtIndexBuild() needs to index the FDT.
+
+  @param[in]  Fdt           The pointer to FDT blob.
+  @param[out] IndexSize     The size, in bytes, of the index buffer.
+
+  @return Zero for successfully, otherwise failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexGetSize (
+  IN  CONST VOID  *Fdt,
+  OUT UINTN       *IndexSize
+  )
+{
+  INT32   Status;
+  UINT32  NodeCount;
+  UINT32  PhandleCount;
+  UINT32  CompatibleCount;
+
+  ASSERT (IndexSize != NULL);
+
+  Status = fdt_check_header (Fdt);
+  if (Status != 0) {
+    return Status;
+  }
+
+  Status = FdtIndexWalk (Fdt, NULL, &NodeCount, &PhandleCount, &CompatibleCount);
+  if (Status != 0) {
+    return Status;
+  }
+
+  *IndexSize = FdtIndexSize (NodeCount, PhandleCount, CompatibleCount);
+  return 0;
+}
+
+/**
+  Builds an index of the nodes of the FDT by path, phandle and compatible string.
+
+  The FDT blob must not be modified or moved while the index is used.
+
+  @param[in]  Fdt           The pointer to FDT blob.
+  @param[out] Index         The buffer to build the index in, aligned on a
+                            UINTN boundary.
+  @param[in]  IndexSize     The size, in bytes, of the buffer, which is at least
+                            the size returned by FdtIndexGetSize().
+
+  @return Zero for successfully, otherwise failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexBuild (
+  IN  CONST VOID  *Fdt,
+  OUT FDT_INDEX   *Index,
+  IN  UINTN       IndexSize
+  )
+{
+  INT32                 Status;
+  UINT32                NodeCount;
+  UINT32                PhandleCount;
+  UINT32                CompatibleCount;
+  FDT_INDEX_PHANDLE     PhandleBuffer;
+  FDT_INDEX_COMPATIBLE  CompatibleBuffer;
+
+  ASSERT (Index != NULL);
+
+  Status = fdt_check_header (Fdt);
+  if (Status != 0) {
+    return Status;
+  }
+
+  Status = FdtIndexWalk (Fdt, NULL, &NodeCount, &PhandleCount, &CompatibleCount);
+  if (Status != 0) {
+    return Status;
+  }
+
+  if (IndexSize < FdtIndexSize (NodeCount, PhandleCount, CompatibleCount)) {
+    return -FDT_ERR_NOSPACE;
+  }
+
+  Index->Signature       = 0;
+  Index->Fdt             = Fdt;
+  Index->Nodes           = (FDT_INDEX_NODE *)((UINT8 *)Index + ALIGN_VALUE (sizeof (FDT_INDEX), sizeof (UINT64)));
+  Index->Phandles        = (FDT_INDEX_PHANDLE *)(Index->Nodes + NodeCount);
+  Index->Compatibles     = (FDT_INDEX_COMPATIBLE *)(Index->Phandles + PhandleCount);
+  Index->NodeCount       = NodeCount;
+  Index->PhandleCount    = PhandleCount;
+  Index->CompatibleCount = CompatibleCount;
+
+  Status = FdtIndexWalk (Fdt, Index, &NodeCount, &PhandleCount, &CompatibleCount);
+  if (Status != 0) {
+    return Status;
+  }
+
+  ASSERT (NodeCount == Index->NodeCount);
+  ASSERT (PhandleCount == Index->PhandleCount);
+  ASSERT (CompatibleCount == Index->CompatibleCount);
+
+  if (PhandleCount > 1) {
+    QuickSort (Index->Phandles, PhandleCount, sizeof (FDT_INDEX_PHANDLE), FdtIndexComparePhandle, &PhandleBuffer);
+  }
+
+  if (CompatibleCount > 1) {
+    QuickSort (Index->Compatibles, CompatibleCount, sizeof (FDT_INDEX_COMPATIBLE), FdtIndexCompareCompatible, &CompatibleBuffer);
+  }
+
+  Index->Signature = FDT_INDEX_SIGNATURE;
+  return 0;
+}
+
+/**
+  Returns the offset of the node with the given path, like the libfdt
+  fdt_path_offset() does.
+
+  The path is either a full path or begins with an alias of the /aliases node.
+  A path component without a unit address matches the first sibling node whose
+  name only differs by its unit address.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Path           The path to the node.
+
+  @return The offset to the node with the given path, otherwise a negative
+          value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexPathOffset (
+  IN CONST FDT_INDEX  *Index,
+  IN CONST CHAR8      *Path
+  )
+{
+  CONST CHAR8  *End;
+  CONST CHAR8  *Next;
+  CONST CHAR8  *Alias;
+  INT32        Offset;
+  UINT32       Node;
+
+  ASSERT (Index != NULL && Index->Signature == FDT_INDEX_SIGNATURE);
+  ASSERT (Path != NULL);
+
+  End  = Path + AsciiStrLen (Path);
+  Node = 0;
+
+  if (*Path != '/') {
+    //
+    // The path begins with an alias, so resolve it to the full path that the
+    // /aliases node gives.
+    //
+    Next = ScanMem8 (Path, (UINTN)(End - Path), '/');
+    if (Next == NULL) {
+      Next = End;
+    }
+
+    Offset = FdtIndexPathOffset (Index, "/aliases");
+    if (Offset < 0) {
+      return -FDT_ERR_BADPATH;
+    }
+
+    Alias = fdt_getprop_namelen (Index->Fdt, Offset, Path, (INT32)(Next - Path), NULL);
+    if ((Alias == NULL) || (*Alias != '/')) {
+      return -FDT_ERR_BADPATH;
+    }
+
+    Offset = FdtIndexPathOffset (Index, Alias);
+    if (Offset < 0) {
+      return Offset;
+    }
+
+    Node = FdtIndexFindNode (Index, Offset);
+    ASSERT (Node != FDT_INDEX_NO_NODE);
+    Path = Next;
+  }
+
+  while (Path < End) {
+    while (*Path == '/') {
+      Path++;
+      if (Path == End) {
+        return Index->Nodes[Node].Offset;
+      }
+    }
+
+    Next = ScanMem8 (Path, (UINTN)(End - Path), '/');
+    if (Next == NULL) {
+      Next = End;
+    }
+
+    Node = FdtIndexFindSubnode (Index, Node, Path, (UINTN)(Next - Path));
+    if (Node == FDT_INDEX_NO_NODE) {
+      return -FDT_ERR_NOTFOUND;
+    }
+
+    Path = Next;
+  }
+
+  return Index->Nodes[Node].Offset;
+}
+
+/**
+  Returns the offset of the node with the given phandle, like the libfdt
+  fdt_node_offset_by_phandle() does.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] Phandle        The phandle of the node.
+
+  @return The offset to the node with the given phandle, otherwise a negative
+          value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexNodeOffsetByPhandle (
+  IN CONST FDT_INDEX  *Index,
+  IN UINT32           Phandle
+  )
+{
+  UINT32  Low;
+  UINT32  High;
+  UINT32  Middle;
+
+  ASSERT (Index != NULL && Index->Signature == FDT_INDEX_SIGNATURE);
+
+  if ((Phandle == 0) || (Phandle == MAX_UINT32)) {
+    return -FDT_ERR_BADPHANDLE;
+  }
+
+  Low  = 0;
+  High = Index->PhandleCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (Index->Phandles[Middle].Phandle < Phandle) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->PhandleCount) && (Index->Phandles[Low].Phandle == Phandle)) {
+    return Index->Nodes[Index->Phandles[Low].Node].Offset;
+  }
+
+  return -FDT_ERR_NOTFOUND;
+}
+
+/**
+  Returns the offset of the next node that is compatible with the given string,
+  like the libfdt fdt_node_offset_by_compatible() does.
+
+  @param[in] Index          The index built by FdtIndexBuild().
+  @param[in] StartOffset    The offset to the node after which to start the
+                            search, or -1 to start at the root node.
+  @param[in] Compatible     The string to match one of the strings of the
+                            compatible property against.
+
+  @return The offset to the first node after StartOffset that is compatible
+          with the given string, otherwise a negative value for failed.
+
+**/
+INT32
+EFIAPI
+FdtIndexNodeOffsetByCompatible (
+  IN CONST FDT_INDEX  *Index,
+  IN INT32            StartOffset,
+  IN CONST CHAR8      *Compatible
+  )
+{
+  UINT32                      Hash;
+  UINT32                      FirstNode;
+  UINT32                      Low;
+  UINT32                      High;
+  UINT32                      Middle;
+  CONST FDT_INDEX_COMPATIBLE  *Entry;
+
+  ASSERT (Index != NULL && Index->Signature == FDT_INDEX_SIGNATURE);
+  ASSERT (Compatible != NULL);
+
+  if (StartOffset < 0) {
+    FirstNode = 0;
+  } else {
+    FirstNode = FdtIndexFindNode (Index, StartOffset);
+    if (FirstNode == FDT_INDEX_NO_NODE) {
+      return -FDT_ERR_BADOFFSET;
+    }
+
+    FirstNode++;
+  }
+
+  //
+  // Find the first entry of the hash at or after the first node, and check the
+  // strings of the entries from there, which are in the order of the nodes.
+  //
+  Hash = FdtIndexHash (Compatible, AsciiStrLen (Compatible));
+  Low  = 0;
+  High = Index->CompatibleCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Entry  = &Index->Compatibles[Middle];
+    if ((Entry->Hash < Hash) || ((Entry->Hash == Hash) && (Entry->Node < FirstNode))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  for ( ; Low < Index->CompatibleCount; Low++) {
+    Entry = &Index->Compatibles[Low];
+    if (Entry->Hash != Hash) {
+      break;
+    }
+
+    if (AsciiStrCmp ((CONST CHAR8 *)Index->Fdt + Entry->String, Compatible) == 0) {
+      return Index->Nodes[Entry->Node].Offset;
+    }
+  }
+
+  return -FDT_ERR_NOTFOUND;
+}
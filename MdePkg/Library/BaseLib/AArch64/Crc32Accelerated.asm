@@ -0,0 +1,108 @@
+;------------------------------------------------------------------------------
+;
+; CRC32 and CRC32c updates with the CRC32 instructions of AArch64
+;
+; Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+;
+; SPDX-License-Identifier: BSD-2-Clause-Patent
+;
+;------------------------------------------------------------------------------
+
+  EXPORT InternalCrc32InstructionsSupported
+  EXPORT InternalCrc32Arm
+  EXPORT InternalCrc32cArm
+  AREA BaseLib_LowLevel, CODE, READONLY
+
+;
+; Updates the CRC in w0 with the Length bytes in x2 at Buffer in x1, with the
+; byte and doubleword CRC instructions $b and $x. The bytes are taken one at a
+; time up to an 8-byte boundary, so that the doublewords are aligned.
+;
+  MACRO
+  CRC_UPDATE $b, $x
+0
+    cbz   x2, %f4
+    tst   x1, #7
+    b.eq  %f1
+    ldrb  w3, [x1], #1
+    $b    w0, w0, w3
+    sub   x2, x2, #1
+    b     %b0
+1
+    subs  x2, x2, #8
+    b.lo  %f2
+    ldr   x3, [x1], #8
+    $x    w0, w0, x3
+    b     %b1
+2
+    adds  x2, x2, #8
+    b.eq  %f4
+3
+    ldrb  w3, [x1], #1
+    $b    w0, w0, w3
+    subs  x2, x2, #1
+    b.ne  %b3
+4
+    ret
+  MEND
+
+;/**
+;  Checks ID_AA64ISAR0_EL1.CRC32 for the CRC32 and CRC32C instructions.
+;
+;  @retval TRUE   The instructions are implemented.
+;  @retval FALSE  The instructions are not implemented.
+;**/
+;BOOLEAN
+;EFIAPI
+;InternalCrc32InstructionsSupported (
+;  VOID
+;  );
+;
+InternalCrc32InstructionsSupported
+    mrs   x0, id_aa64isar0_el1
+    ubfx  x0, x0, #16, #4
+    cmp   x0, #0
+    cset  w0, ne
+    ret
+
+;/**
+;  Updates the CRC32 of ITU-T V.42 with a data buffer.
+;
+;  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+;  @param  Buffer  A pointer to the data.
+;  @param  Length  The number of bytes in the buffer Data.
+;
+;  @return The CRC updated with the data, not inverted.
+;**/
+;UINT32
+;EFIAPI
+;InternalCrc32Arm (
+;  IN UINT32       Crc,
+;  IN CONST UINT8  *Buffer,
+;  IN UINTN        Length
+;  );
+;
+InternalCrc32Arm
+    CRC_UPDATE crc32b, crc32x
+
+;/**
+;  Updates the CRC32c with a data buffer.
+;
+;  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+;  @param  Buffer  A pointer to the data.
+;  @param  Length  The number of bytes in the buffer Data.
+;
+;  @return The CRC updated with the data, not inverted.
+;**/
+;UINT32
+;EFIAPI
+;InternalCrc32cArm (
+;  IN UINT32       Crc,
+;  IN CONST UINT8  *Buffer,
+;  IN UINTN        Length
+;  );
+;
+InternalCrc32cArm
+    CRC_UPDATE crc32cb, crc32cx
+
+  END
@@ -0,0 +1,67 @@
+/** @file
+  CRC32 and CRC32c updates of AArch64, with the CRC32 instructions when the
+  processor implements them.
+
+  BaseLib has no writable data in the XIP modules, so ID_AA64ISAR0_EL1 is read
+  on each large buffer. The buffers smaller than CRC_ACCELERATED_MIN_LENGTH use
+  the slicing-by-8 tables, which are as fast as the read of the ID register for
+  them, since a hypervisor may trap it.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+#define CRC_ACCELERATED_MIN_LENGTH  512
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Update (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  if ((Length >= CRC_ACCELERATED_MIN_LENGTH) && InternalCrc32InstructionsSupported ()) {
+    return InternalCrc32Arm (Crc, Buffer, Length);
+  }
+
+  return InternalCrc32Slicing8 (Crc, Buffer, Length);
+}
+
+/**
+  Updates the CRC32c with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cUpdate (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  if ((Length >= CRC_ACCELERATED_MIN_LENGTH) && InternalCrc32InstructionsSupported ()) {
+    return InternalCrc32cArm (Crc, Buffer, Length);
+  }
+
+  return InternalCrc32cSlicing8 (Crc, Buffer, Length);
+}
@@ -553,6 +553,197 @@ InternalAsciiHexCharToUintn (
   IN      CHAR8  Char
   );
 
+/**
+  Returns the number of Unicode characters that precede the Null-terminator of
+  a Unicode string, or MaxSize if there is no Null-terminator in the first
+  MaxSize characters.
+
+  The implementation may read the aligned naturally sized words, or vectors,
+  that contain the characters it accesses. It does not read past the page that
+  contains the last character it accesses.
+
+  @param  String   A pointer to a Unicode string, aligned on a 16-bit boundary.
+  @param  MaxSize  The maximum number of characters to scan, not zero.
+
+  @return The length of String, at most MaxSize.
+
+**/
+UINTN
+EFIAPI
+InternalStrnLen (
+  IN      CONST CHAR16  *String,
+  IN      UINTN         MaxSize
+  );
+
+/**
+  Returns the number of ASCII characters that precede the Null-terminator of
+  an ASCII string, or MaxSize if there is no Null-terminator in the first
+  MaxSize characters.
+
+  The implementation may read the aligned naturally sized words, or vectors,
+  that contain the characters it accesses. It does not read past the page that
+  contains the last character it accesses.
+
+  @param  String   A pointer to an ASCII string.
+  @param  MaxSize  The maximum number of characters to scan, not zero.
+
+  @return The length of String, at most MaxSize.
+
+**/
+UINTN
+EFIAPI
+InternalAsciiStrnLen (
+  IN      CONST CHAR8  *String,
+  IN      UINTN        MaxSize
+  );
+
+/**
+  Compares two Null-terminated Unicode strings, and returns the difference
+  between the first mismatched Unicode characters.
+
+  @param  FirstString   A pointer to a Null-terminated Unicode string, aligned
+                        on a 16-bit boundary.
+  @param  SecondString  A pointer to a Null-terminated Unicode string, aligned
+                        on a 16-bit boundary.
+
+  @retval 0      FirstString is identical to SecondString.
+  @return others FirstString is not identical to SecondString.
+
+**/
+INTN
+EFIAPI
+InternalStrCmp (
+  IN      CONST CHAR16  *FirstString,
+  IN      CONST CHAR16  *SecondString
+  );
+
+/**
+  Compares two Null-terminated ASCII strings, and returns the difference
+  between the first mismatched ASCII characters.
+
+  @param  FirstString   A pointer to a Null-terminated ASCII string.
+  @param  SecondString  A pointer to a Null-terminated ASCII string.
+
+  @retval 0      FirstString is identical to SecondString.
+  @return others FirstString is not identical to SecondString.
+
+**/
+INTN
+EFIAPI
+InternalAsciiStrCmp (
+  IN      CONST CHAR8  *FirstString,
+  IN      CONST CHAR8  *SecondString
+  );
+
+/**
+  Returns the first occurrence of a Unicode character in a Null-terminated
+  Unicode string, or its Null-terminator if the character does not appear.
+
+  @param  String  A pointer to a Null-terminated Unicode string, aligned on a
+                  16-bit boundary.
+  @param  Char    The character to search for.
+
+  @return A pointer to the first Char, or to the Null-terminator of String.
+
+**/
+CONST CHAR16 *
+EFIAPI
+InternalStrChr (
+  IN      CONST CHAR16  *String,
+  IN      CHAR16        Char
+  );
+
+/**
+  Returns the first occurrence of an ASCII character in a Null-terminated
+  ASCII string, or its Null-terminator if the character does not appear.
+
+  @param  String  A pointer to a Null-terminated ASCII string.
+  @param  Char    The character to search for.
+
+  @return A pointer to the first Char, or to the Null-terminator of String.
+
+**/
+CONST CHAR8 *
+EFIAPI
+InternalAsciiStrChr (
+  IN      CONST CHAR8  *String,
+  IN      CHAR8        Char
+  );
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer, with the fastest implementation of
+  the processor.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Update (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Updates the CRC32c with a data buffer, with the fastest implementation of the processor.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cUpdate (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer, with the slicing-by-8
+  tables.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Slicing8 (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Updates the CRC32c with a data buffer, with the slicing-by-8 tables.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cSlicing8 (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
 //
 // Ia32 and x64 specific functions
 //
@@ -850,6 +1041,98 @@ InternalX86RdRand64  (
   OUT     UINT64  *Rand
   );
 
+  #if defined (MDE_CPU_X64)
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer with PCLMULQDQ.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data, a multiple of 16 and
+                  at least 64.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Pclmul (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Updates the CRC32c with a data buffer with the SSE4.2 CRC32 instruction.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cSse42 (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+  #endif
+
+#elif defined (MDE_CPU_AARCH64)
+
+/**
+  Checks if the processor implements the CRC32 and CRC32C instructions.
+
+  @retval TRUE   The instructions are implemented.
+  @retval FALSE  The instructions are not implemented.
+
+**/
+BOOLEAN
+EFIAPI
+InternalCrc32InstructionsSupported (
+  VOID
+  );
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer with the CRC32 instructions.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Arm (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Updates the CRC32c with a data buffer with the CRC32C instructions.
+
+  @param  Crc     The CRC of the data that precedes Buffer, not inverted.
+  @param  Buffer  A pointer to the data.
+  @param  Length  The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cArm (
+  IN      UINT32       Crc,
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
 #else
 
 #endif
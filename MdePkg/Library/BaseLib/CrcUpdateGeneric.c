@@ -0,0 +1,52 @@
+/** @file
+  CRC32 and CRC32c updates of the architectures without CRC instructions, with
+  the slicing-by-8 tables.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Update (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  return InternalCrc32Slicing8 (Crc, Buffer, Length);
+}
+
+/**
+  Updates the CRC32c with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cUpdate (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  return InternalCrc32cSlicing8 (Crc, Buffer, Length);
+}
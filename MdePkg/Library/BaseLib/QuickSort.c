@@ -1,5 +1,15 @@
 /** @file
-  Math worker functions.
+  Sort worker functions.
+
+  QuickSort() is an introsort: a quicksort with a median-of-three pivot and a
+  partition that splits runs of equal elements evenly, which recurses into the
+  smaller part only, switches to a heapsort when the recursion gets deeper
+  than twice the logarithm of the count, and finishes short ranges with an
+  insertion sort. It never takes more than O(n log n) comparisons, including
+  on sorted, reversed and all-equal inputs.
+
+  StableSort() is a bottom-up merge sort, which keeps equal elements in their
+  original order, and merges already ordered runs with a single comparison.
 
   Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -8,6 +18,236 @@
 
 #include "BaseLibInternals.h"
 
+//
+// The ranges of up to SORT_INSERTION_THRESHOLD elements are insertion sorted.
+//
+#define SORT_INSERTION_THRESHOLD  12
+
+//
+// The address of element Index of Buffer.
+//
+#define SORT_ELEMENT(Buffer, Index, ElementSize)  ((UINT8 *)(Buffer) + (Index) * (ElementSize))
+
+/**
+  Swap two elements.
+
+  @param[in, out] Element1     The first element.
+  @param[in, out] Element2     The second element.
+  @param[in]      ElementSize  Size of an element in bytes.
+  @param[out]     Temp         A buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+InternalSortSwap (
+  IN OUT VOID   *Element1,
+  IN OUT VOID   *Element2,
+  IN     UINTN  ElementSize,
+  OUT    VOID   *Temp
+  )
+{
+  CopyMem (Temp, Element1, ElementSize);
+  CopyMem (Element1, Element2, ElementSize);
+  CopyMem (Element2, Temp, ElementSize);
+}
+
+/**
+  Sort a short buffer with an insertion sort, which keeps equal elements in
+  their original order.
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in the buffer.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function to compare two elements.
+  @param[out]     Temp             A buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+InternalInsertionSort (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  OUT    VOID               *Temp
+  )
+{
+  UINTN  Index;
+  UINTN  Hole;
+
+  for (Index = 1; Index < Count; Index++) {
+    if (CompareFunction (SORT_ELEMENT (BufferToSort, Index - 1, ElementSize), SORT_ELEMENT (BufferToSort, Index, ElementSize)) <= 0) {
+      continue;
+    }
+
+    CopyMem (Temp, SORT_ELEMENT (BufferToSort, Index, ElementSize), ElementSize);
+    Hole = Index;
+    do {
+      CopyMem (SORT_ELEMENT (BufferToSort, Hole, ElementSize), SORT_ELEMENT (BufferToSort, Hole - 1, ElementSize), ElementSize);
+      Hole--;
+    } while (Hole > 0 && CompareFunction (SORT_ELEMENT (BufferToSort, Hole - 1, ElementSize), Temp) > 0);
+
+    CopyMem (SORT_ELEMENT (BufferToSort, Hole, ElementSize), Temp, ElementSize);
+  }
+}
+
+/**
+  Sort a buffer with a heapsort, in O(n log n) comparisons.
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in the buffer.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function to compare two elements.
+  @param[out]     Temp             A buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+InternalHeapSort (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  OUT    VOID               *Temp
+  )
+{
+  UINTN  Start;
+  UINTN  End;
+  UINTN  Root;
+  UINTN  Child;
+
+  //
+  // Build a max-heap from the last parent down to the root, then move the
+  // root of the heap to the end of the buffer, one element at a time.
+  //
+  Start = Count / 2;
+  End   = Count;
+  while (End > 1) {
+    if (Start > 0) {
+      Start--;
+    } else {
+      End--;
+      InternalSortSwap (BufferToSort, SORT_ELEMENT (BufferToSort, End, ElementSize), ElementSize, Temp);
+    }
+
+    //
+    // Sift the element at Start down the heap of End elements.
+    //
+    Root = Start;
+    for (Child = 2 * Root + 1; Child < End; Child = 2 * Root + 1) {
+      if ((Child + 1 < End) &&
+          (CompareFunction (SORT_ELEMENT (BufferToSort, Child, ElementSize), SORT_ELEMENT (BufferToSort, Child + 1, ElementSize)) < 0))
+      {
+        Child++;
+      }
+
+      if (CompareFunction (SORT_ELEMENT (BufferToSort, Root, ElementSize), SORT_ELEMENT (BufferToSort, Child, ElementSize)) >= 0) {
+        break;
+      }
+
+      InternalSortSwap (SORT_ELEMENT (BufferToSort, Root, ElementSize), SORT_ELEMENT (BufferToSort, Child, ElementSize), ElementSize, Temp);
+      Root = Child;
+    }
+  }
+}
+
+/**
+  Sort a buffer with an introsort.
+
+  @param[in, out] BufferToSort     The elements to sort.
+  @param[in]      Count            The number of elements in the buffer.
+  @param[in]      ElementSize      Size of an element in bytes.
+  @param[in]      CompareFunction  The function to compare two elements.
+  @param[in]      DepthLimit       The number of partitions left before the
+                                   heapsort takes over.
+  @param[out]     Temp             A buffer of ElementSize bytes.
+**/
+STATIC
+VOID
+InternalIntroSort (
+  IN OUT VOID               *BufferToSort,
+  IN     UINTN              Count,
+  IN     UINTN              ElementSize,
+  IN     BASE_SORT_COMPARE  CompareFunction,
+  IN     UINTN              DepthLimit,
+  OUT    VOID               *Temp
+  )
+{
+  UINT8  *Buffer;
+  UINT8  *First;
+  UINT8  *Middle;
+  UINT8  *Last;
+  UINTN  Left;
+  UINTN  Right;
+
+  Buffer = BufferToSort;
+  while (Count > SORT_INSERTION_THRESHOLD) {
+    if (DepthLimit == 0) {
+      InternalHeapSort (Buffer, Count, ElementSize, CompareFunction, Temp);
+      return;
+    }
+
+    DepthLimit--;
+
+    //
+    // Order the second, middle and last elements, and move their median, the
+    // pivot, to the first element. The first element is left out, as the
+    // previous partition leaves a large element there.
+    //
+    First  = SORT_ELEMENT (Buffer, 1, ElementSize);
+    Middle = SORT_ELEMENT (Buffer, Count / 2, ElementSize);
+    Last   = SORT_ELEMENT (Buffer, Count - 1, ElementSize);
+    if (CompareFunction (Middle, First) < 0) {
+      InternalSortSwap (Middle, First, ElementSize, Temp);
+    }
+
+    if (CompareFunction (Last, Middle) < 0) {
+      InternalSortSwap (Last, Middle, ElementSize, Temp);
+      if (CompareFunction (Middle, First) < 0) {
+        InternalSortSwap (Middle, First, ElementSize, Temp);
+      }
+    }
+
+    InternalSortSwap (Buffer, Middle, ElementSize, Temp);
+
+    //
+    // Partition the rest around the pivot. Both scans stop on the elements
+    // equal to the pivot, so that runs of equal elements are split evenly.
+    //
+    Left  = 0;
+    Right = Count;
+    for ( ; ;) {
+      do {
+        Left++;
+      } while (Left < Count && CompareFunction (SORT_ELEMENT (Buffer, Left, ElementSize), Buffer) < 0);
+
+      do {
+        Right--;
+      } while (CompareFunction (Buffer, SORT_ELEMENT (Buffer, Right, ElementSize)) < 0);
+
+      if (Left >= Right) {
+        break;
+      }
+
+      InternalSortSwap (SORT_ELEMENT (Buffer, Left, ElementSize), SORT_ELEMENT (Buffer, Right, ElementSize), ElementSize, Temp);
+    }
+
+    InternalSortSwap (Buffer, SORT_ELEMENT (Buffer, Right, ElementSize), ElementSize, Temp);
+
+    //
+    // Recurse into the smaller part, and loop on the larger one, so that the
+    // stack depth is O(log n).
+    //
+    if (Right < Count - Right - 1) {
+      InternalIntroSort (Buffer, Right, ElementSize, CompareFunction, DepthLimit, Temp);
+      Buffer = SORT_ELEMENT (Buffer, Right + 1, ElementSize);
+      Count  = Count - Right - 1;
+    } else {
+      InternalIntroSort (SORT_ELEMENT (Buffer, Right + 1, ElementSize), Count - Right - 1, ElementSize, CompareFunction, DepthLimit, Temp);
+      Count = Right;
+    }
+  }
+
+  InternalInsertionSort (Buffer, Count, ElementSize, CompareFunction, Temp);
+}
+
 /**
   This function is identical to perform QuickSort,
   except that is uses the pre-allocated buffer so the in place sorting does not need to
@@ -41,9 +281,8 @@ QuickSort (
   OUT VOID                    *BufferOneElement
   )
 {
-  VOID   *Pivot;
-  UINTN  LoopCount;
-  UINTN  NextSwapLocation;
+  UINTN  DepthLimit;
+  UINTN  Remaining;
 
   ASSERT (BufferToSort     != NULL);
   ASSERT (CompareFunction  != NULL);
@@ -54,64 +293,126 @@ QuickSort (
     return;
   }
 
-  NextSwapLocation = 0;
-
   //
-  // pick a pivot (we choose last element)
+  // Allow twice floor (log2 (Count)) partitions.
   //
-  Pivot = ((UINT8 *)BufferToSort + ((Count - 1) * ElementSize));
-
-  //
-  // Now get the pivot such that all on "left" are below it
-  // and everything "right" are above it
-  //
-  for (LoopCount = 0; LoopCount < Count -1; LoopCount++) {
-    //
-    // if the element is less than or equal to the pivot
-    //
-    if (CompareFunction ((VOID *)((UINT8 *)BufferToSort + ((LoopCount) * ElementSize)), Pivot) <= 0) {
-      //
-      // swap
-      //
-      CopyMem (BufferOneElement, (UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), ElementSize);
-      CopyMem ((UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), (UINT8 *)BufferToSort + ((LoopCount) * ElementSize), ElementSize);
-      CopyMem ((UINT8 *)BufferToSort + ((LoopCount)*ElementSize), BufferOneElement, ElementSize);
-
-      //
-      // increment NextSwapLocation
-      //
-      NextSwapLocation++;
-    }
+  DepthLimit = 0;
+  for (Remaining = Count; Remaining > 1; Remaining >>= 1) {
+    DepthLimit += 2;
   }
 
-  //
-  // swap pivot to it's final position (NextSwapLocation)
-  //
-  CopyMem (BufferOneElement, Pivot, ElementSize);
-  CopyMem (Pivot, (UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), ElementSize);
-  CopyMem ((UINT8 *)BufferToSort + (NextSwapLocation * ElementSize), BufferOneElement, ElementSize);
+  InternalIntroSort (BufferToSort, Count, ElementSize, CompareFunction, DepthLimit, BufferOneElement);
+}
+
+/**
+  Sort a buffer of equal sized elements, keeping the elements that compare
+  equal in their original order.
+
+  This is a merge sort that takes O(n log n) comparisons, and O(n) comparisons
+  on an already sorted buffer.
+
+  If BufferToSort is NULL, then ASSERT.
+  If CompareFunction is NULL, then ASSERT.
+  If ScratchBuffer is NULL, then ASSERT.
+  If ElementSize is < 1, then ASSERT.
+
+  If Count is < 2 then perform no action.
+
+  @param[in, out] BufferToSort   On call a Buffer of (possibly sorted) elements,
+                                 on return a buffer of sorted elements.
+  @param[in] Count               The number of elements in the buffer to sort.
+  @param[in] ElementSize         Size of an element in bytes.
+  @param[in] CompareFunction     The function to call to perform the comparison
+                                 of any 2 elements.
+  @param[out] ScratchBuffer      Caller provided buffer of Count * ElementSize
+                                 bytes, used for merging.
+**/
+VOID
+EFIAPI
+StableSort (
+  IN OUT VOID                 *BufferToSort,
+  IN CONST UINTN              Count,
+  IN CONST UINTN              ElementSize,
+  IN       BASE_SORT_COMPARE  CompareFunction,
+  OUT VOID                    *ScratchBuffer
+  )
+{
+  UINT8  *Source;
+  UINT8  *Destination;
+  UINT8  *Swap;
+  UINTN  Width;
+  UINTN  Start;
+  UINTN  Middle;
+  UINTN  End;
+  UINTN  Left;
+  UINTN  Right;
+  UINTN  Index;
+
+  ASSERT (BufferToSort    != NULL);
+  ASSERT (CompareFunction != NULL);
+  ASSERT (ScratchBuffer   != NULL);
+  ASSERT (ElementSize     >= 1);
+
+  if (Count < 2) {
+    return;
+  }
 
   //
-  // Now recurse on 2 partial lists.  neither of these will have the 'pivot' element
-  // IE list is sorted left half, pivot element, sorted right half...
+  // Insertion sort the runs of SORT_INSERTION_THRESHOLD elements, with the
+  // scratch buffer as the temporary element.
   //
-  if (NextSwapLocation >= 2) {
-    QuickSort (
-      BufferToSort,
-      NextSwapLocation,
+  for (Start = 0; Start < Count; Start += SORT_INSERTION_THRESHOLD) {
+    InternalInsertionSort (
+      SORT_ELEMENT (BufferToSort, Start, ElementSize),
+      MIN (SORT_INSERTION_THRESHOLD, Count - Start),
       ElementSize,
       CompareFunction,
-      BufferOneElement
+      ScratchBuffer
       );
   }
 
-  if ((Count - NextSwapLocation - 1) >= 2) {
-    QuickSort (
-      (UINT8 *)BufferToSort + (NextSwapLocation + 1) * ElementSize,
-      Count - NextSwapLocation - 1,
-      ElementSize,
-      CompareFunction,
-      BufferOneElement
-      );
+  //
+  // Merge pairs of runs of doubling width, back and forth between the buffer
+  // and the scratch buffer. A pair that is already in order is just copied.
+  //
+  Source      = BufferToSort;
+  Destination = ScratchBuffer;
+  for (Width = SORT_INSERTION_THRESHOLD; Width < Count; Width *= 2) {
+    for (Start = 0; Start < Count; Start = End) {
+      Middle = MIN (Start + Width, Count);
+      End    = MIN (Middle + Width, Count);
+      if ((Middle == End) ||
+          (CompareFunction (SORT_ELEMENT (Source, Middle - 1, ElementSize), SORT_ELEMENT (Source, Middle, ElementSize)) <= 0))
+      {
+        CopyMem (SORT_ELEMENT (Destination, Start, ElementSize), SORT_ELEMENT (Source, Start, ElementSize), (End - Start) * ElementSize);
+        continue;
+      }
+
+      Left  = Start;
+      Right = Middle;
+      for (Index = Start; Index < End; Index++) {
+        //
+        // Take from the left run on equality, to keep the order.
+        //
+        if ((Right == End) ||
+            ((Left < Middle) &&
+             (CompareFunction (SORT_ELEMENT (Source, Left, ElementSize), SORT_ELEMENT (Source, Right, ElementSize)) <= 0)))
+        {
+          CopyMem (SORT_ELEMENT (Destination, Index, ElementSize), SORT_ELEMENT (Source, Left, ElementSize), ElementSize);
+          Left++;
+        } else {
+          CopyMem (SORT_ELEMENT (Destination, Index, ElementSize), SORT_ELEMENT (Source, Right, ElementSize), ElementSize);
+          Right++;
+        }
+      }
+    }
+
+    Swap        = Source;
+    Source      = Destination;
+    Destination = Swap;
+  }
+
+  if (Source != BufferToSort) {
+    CopyMem (BufferToSort, Source, Count * ElementSize);
   }
 }
@@ -121,8 +121,6 @@ StrnLenS (
   IN UINTN         MaxSize
   )
 {
-  UINTN  Length;
-
   ASSERT (((UINTN)String & BIT0) == 0);
 
   //
@@ -136,18 +134,10 @@ StrnLenS (
   // Otherwise, the StrnLenS function returns the number of characters that precede the
   // terminating null character. If there is no null character in the first MaxSize characters of
   // String then StrnLenS returns MaxSize. At most the first MaxSize characters of String shall
-  // be accessed by StrnLenS.
+  // be accessed by StrnLenS. The bytes that follow them in the same aligned
+  // word, or vector, may be read.
   //
-  Length = 0;
-  while (String[Length] != 0) {
-    if (Length >= MaxSize - 1) {
-      return MaxSize;
-    }
-
-    Length++;
-  }
-
-  return Length;
+  return InternalStrnLen (String, MaxSize);
 }
 
 /**
@@ -1698,8 +1688,6 @@ AsciiStrnLenS (
   IN UINTN        MaxSize
   )
 {
-  UINTN  Length;
-
   //
   // If String is a null pointer or MaxSize is 0, then the AsciiStrnLenS function returns zero.
   //
@@ -1711,18 +1699,10 @@ AsciiStrnLenS (
   // Otherwise, the AsciiStrnLenS function returns the number of characters that precede the
   // terminating null character. If there is no null character in the first MaxSize characters of
   // String then AsciiStrnLenS returns MaxSize. At most the first MaxSize characters of String shall
-  // be accessed by AsciiStrnLenS.
+  // be accessed by AsciiStrnLenS. The bytes that follow them in the same aligned
+  // word, or vector, may be read.
   //
-  Length = 0;
-  while (String[Length] != 0) {
-    if (Length >= MaxSize - 1) {
-      return MaxSize;
-    }
-
-    Length++;
-  }
-
-  return Length;
+  return InternalAsciiStrnLen (String, MaxSize);
 }
 
 /**
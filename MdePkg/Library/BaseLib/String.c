@@ -36,14 +36,14 @@ StrLen (
   ASSERT (String != NULL);
   ASSERT (((UINTN)String & BIT0) == 0);
 
-  for (Length = 0; *String != L'\0'; String++, Length++) {
-    //
-    // If PcdMaximumUnicodeStringLength is not zero,
-    // length should not more than PcdMaximumUnicodeStringLength
-    //
-    if (PcdGet32 (PcdMaximumUnicodeStringLength) != 0) {
-      ASSERT (Length < PcdGet32 (PcdMaximumUnicodeStringLength));
-    }
+  Length = InternalStrnLen (String, MAX_UINTN);
+
+  //
+  // If PcdMaximumUnicodeStringLength is not zero,
+  // length should not more than PcdMaximumUnicodeStringLength
+  //
+  if (PcdGet32 (PcdMaximumUnicodeStringLength) != 0) {
+    ASSERT (Length < PcdGet32 (PcdMaximumUnicodeStringLength));
   }
 
   return Length;
@@ -117,12 +117,7 @@ StrCmp (
   ASSERT (StrSize (FirstString) != 0);
   ASSERT (StrSize (SecondString) != 0);
 
-  while ((*FirstString != L'\0') && (*FirstString == *SecondString)) {
-    FirstString++;
-    SecondString++;
-  }
-
-  return *FirstString - *SecondString;
+  return InternalStrCmp (FirstString, SecondString);
 }
 
 /**
@@ -226,8 +221,7 @@ StrStr (
   IN      CONST CHAR16  *SearchString
   )
 {
-  CONST CHAR16  *FirstMatch;
-  CONST CHAR16  *SearchStringTmp;
+  UINTN  Index;
 
   //
   // ASSERT both strings are less long than PcdMaximumUnicodeStringLength.
@@ -240,29 +234,33 @@ StrStr (
     return (CHAR16 *)String;
   }
 
-  while (*String != L'\0') {
-    SearchStringTmp = SearchString;
-    FirstMatch      = String;
+  while (TRUE) {
+    //
+    // Skip to the next occurrence of the first character of SearchString.
+    //
+    String = InternalStrChr (String, *SearchString);
+    if (*String == L'\0') {
+      return NULL;
+    }
 
-    while (  (*String == *SearchStringTmp)
-          && (*String != L'\0'))
-    {
-      String++;
-      SearchStringTmp++;
+    Index = 1;
+    while ((SearchString[Index] != L'\0') && (String[Index] == SearchString[Index])) {
+      Index++;
     }
 
-    if (*SearchStringTmp == L'\0') {
-      return (CHAR16 *)FirstMatch;
+    if (SearchString[Index] == L'\0') {
+      return (CHAR16 *)String;
     }
 
-    if (*String == L'\0') {
+    //
+    // No later match if the rest of String is shorter than SearchString.
+    //
+    if (String[Index] == L'\0') {
       return NULL;
     }
 
-    String = FirstMatch + 1;
+    String++;
   }
-
-  return NULL;
 }
 
 /**
@@ -638,14 +636,14 @@ AsciiStrLen (
 
   ASSERT (String != NULL);
 
-  for (Length = 0; *String != '\0'; String++, Length++) {
-    //
-    // If PcdMaximumUnicodeStringLength is not zero,
-    // length should not more than PcdMaximumUnicodeStringLength
-    //
-    if (PcdGet32 (PcdMaximumAsciiStringLength) != 0) {
-      ASSERT (Length < PcdGet32 (PcdMaximumAsciiStringLength));
-    }
+  Length = InternalAsciiStrnLen (String, MAX_UINTN);
+
+  //
+  // If PcdMaximumUnicodeStringLength is not zero,
+  // length should not more than PcdMaximumUnicodeStringLength
+  //
+  if (PcdGet32 (PcdMaximumAsciiStringLength) != 0) {
+    ASSERT (Length < PcdGet32 (PcdMaximumAsciiStringLength));
   }
 
   return Length;
@@ -716,12 +714,7 @@ AsciiStrCmp (
   ASSERT (AsciiStrSize (FirstString));
   ASSERT (AsciiStrSize (SecondString));
 
-  while ((*FirstString != '\0') && (*FirstString == *SecondString)) {
-    FirstString++;
-    SecondString++;
-  }
-
-  return *FirstString - *SecondString;
+  return InternalAsciiStrCmp (FirstString, SecondString);
 }
 
 /**
@@ -925,8 +918,7 @@ AsciiStrStr (
   IN      CONST CHAR8  *SearchString
   )
 {
-  CONST CHAR8  *FirstMatch;
-  CONST CHAR8  *SearchStringTmp;
+  UINTN  Index;
 
   //
   // ASSERT both strings are less long than PcdMaximumAsciiStringLength
@@ -938,29 +930,33 @@ AsciiStrStr (
     return (CHAR8 *)String;
   }
 
-  while (*String != '\0') {
-    SearchStringTmp = SearchString;
-    FirstMatch      = String;
+  while (TRUE) {
+    //
+    // Skip to the next occurrence of the first character of SearchString.
+    //
+    String = InternalAsciiStrChr (String, *SearchString);
+    if (*String == '\0') {
+      return NULL;
+    }
 
-    while (  (*String == *SearchStringTmp)
-          && (*String != '\0'))
-    {
-      String++;
-      SearchStringTmp++;
+    Index = 1;
+    while ((SearchString[Index] != '\0') && (String[Index] == SearchString[Index])) {
+      Index++;
     }
 
-    if (*SearchStringTmp == '\0') {
-      return (CHAR8 *)FirstMatch;
+    if (SearchString[Index] == '\0') {
+      return (CHAR8 *)String;
     }
 
-    if (*String == '\0') {
+    //
+    // No later match if the rest of String is shorter than SearchString.
+    //
+    if (String[Index] == '\0') {
       return NULL;
     }
 
-    String = FirstMatch + 1;
+    String++;
   }
-
-  return NULL;
 }
 
 /**
@@ -0,0 +1,321 @@
+/** @file
+  Length, compare and search primitives of the Unicode and ASCII strings.
+
+  The strings are scanned a UINTN at a time, with the loads aligned on their
+  natural boundary: they never cross a page boundary, so reading the bytes of
+  the last word that follow the Null-terminator cannot fault. Only the general
+  purpose registers are used, so that the functions are safe in the modules
+  that run before the floating point unit is enabled, or with the MMU off.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+//
+// The UINTN with the lowest bit of each byte, or of each 16-bit character,
+// set, and the UINTN with their highest bit set.
+//
+#define STRING_WORD_ONES8    (MAX_UINTN / 0xFF)
+#define STRING_WORD_HIGHS8   (STRING_WORD_ONES8 << 7)
+#define STRING_WORD_ONES16   (MAX_UINTN / 0xFFFF)
+#define STRING_WORD_HIGHS16  (STRING_WORD_ONES16 << 15)
+
+#define STRING_WORD_MASK  (sizeof (UINTN) - 1)
+
+//
+// Whether a UINTN has a zero byte, or a zero 16-bit character.
+//
+#define STRING_WORD_HAS_ZERO8(Word)   ((((Word) - STRING_WORD_ONES8) & ~(Word) & STRING_WORD_HIGHS8) != 0)
+#define STRING_WORD_HAS_ZERO16(Word)  ((((Word) - STRING_WORD_ONES16) & ~(Word) & STRING_WORD_HIGHS16) != 0)
+
+/**
+  Returns the number of Unicode characters that precede the Null-terminator of
+  a Unicode string, or MaxSize if there is no Null-terminator in the first
+  MaxSize characters.
+
+  @param  String   A pointer to a Unicode string, aligned on a 16-bit boundary.
+  @param  MaxSize  The maximum number of characters to scan, not zero.
+
+  @return The length of String, at most MaxSize.
+
+**/
+UINTN
+EFIAPI
+InternalStrnLen (
+  IN      CONST CHAR16  *String,
+  IN      UINTN         MaxSize
+  )
+{
+  CONST UINTN  *Word;
+  UINTN        Length;
+
+  for (Length = 0; ((UINTN)(String + Length) & STRING_WORD_MASK) != 0; Length++) {
+    if (Length >= MaxSize) {
+      return MaxSize;
+    }
+
+    if (String[Length] == L'\0') {
+      return Length;
+    }
+  }
+
+  //
+  // Skip the words without a Null-terminator, then find it in the last word.
+  //
+  Word = (CONST UINTN *)(String + Length);
+  while ((Length < MaxSize) && !STRING_WORD_HAS_ZERO16 (*Word)) {
+    Word++;
+    Length += sizeof (UINTN) / sizeof (CHAR16);
+  }
+
+  for ( ; Length < MaxSize; Length++) {
+    if (String[Length] == L'\0') {
+      return Length;
+    }
+  }
+
+  return MaxSize;
+}
+
+/**
+  Returns the number of ASCII characters that precede the Null-terminator of
+  an ASCII string, or MaxSize if there is no Null-terminator in the first
+  MaxSize characters.
+
+  @param  String   A pointer to an ASCII string.
+  @param  MaxSize  The maximum number of characters to scan, not zero.
+
+  @return The length of String, at most MaxSize.
+
+**/
+UINTN
+EFIAPI
+InternalAsciiStrnLen (
+  IN      CONST CHAR8  *String,
+  IN      UINTN        MaxSize
+  )
+{
+  CONST UINTN  *Word;
+  UINTN        Length;
+
+  for (Length = 0; ((UINTN)(String + Length) & STRING_WORD_MASK) != 0; Length++) {
+    if (Length >= MaxSize) {
+      return MaxSize;
+    }
+
+    if (String[Length] == '\0') {
+      return Length;
+    }
+  }
+
+  //
+  // Skip the words without a Null-terminator, then find it in the last word.
+  //
+  Word = (CONST UINTN *)(String + Length);
+  while ((Length < MaxSize) && !STRING_WORD_HAS_ZERO8 (*Word)) {
+    Word++;
+    Length += sizeof (UINTN);
+  }
+
+  for ( ; Length < MaxSize; Length++) {
+    if (String[Length] == '\0') {
+      return Length;
+    }
+  }
+
+  return MaxSize;
+}
+
+/**
+  Compares two Null-terminated Unicode strings, and returns the difference
+  between the first mismatched Unicode characters.
+
+  @param  FirstString   A pointer to a Null-terminated Unicode string, aligned
+                        on a 16-bit boundary.
+  @param  SecondString  A pointer to a Null-terminated Unicode string, aligned
+                        on a 16-bit boundary.
+
+  @retval 0      FirstString is identical to SecondString.
+  @return others FirstString is not identical to SecondString.
+
+**/
+INTN
+EFIAPI
+InternalStrCmp (
+  IN      CONST CHAR16  *FirstString,
+  IN      CONST CHAR16  *SecondString
+  )
+{
+  //
+  // The strings are compared a word at a time when they have the same
+  // alignment, until a word differs or has a Null-terminator.
+  //
+  if ((((UINTN)FirstString ^ (UINTN)SecondString) & STRING_WORD_MASK) == 0) {
+    while (((UINTN)FirstString & STRING_WORD_MASK) != 0) {
+      if ((*FirstString == L'\0') || (*FirstString != *SecondString)) {
+        return *FirstString - *SecondString;
+      }
+
+      FirstString++;
+      SecondString++;
+    }
+
+    while ((*(CONST UINTN *)FirstString == *(CONST UINTN *)SecondString) &&
+           !STRING_WORD_HAS_ZERO16 (*(CONST UINTN *)FirstString))
+    {
+      FirstString  += sizeof (UINTN) / sizeof (CHAR16);
+      SecondString += sizeof (UINTN) / sizeof (CHAR16);
+    }
+  }
+
+  while ((*FirstString != L'\0') && (*FirstString == *SecondString)) {
+    FirstString++;
+    SecondString++;
+  }
+
+  return *FirstString - *SecondString;
+}
+
+/**
+  Compares two Null-terminated ASCII strings, and returns the difference
+  between the first mismatched ASCII characters.
+
+  @param  FirstString   A pointer to a Null-terminated ASCII string.
+  @param  SecondString  A pointer to a Null-terminated ASCII string.
+
+  @retval 0      FirstString is identical to SecondString.
+  @return others FirstString is not identical to SecondString.
+
+**/
+INTN
+EFIAPI
+InternalAsciiStrCmp (
+  IN      CONST CHAR8  *FirstString,
+  IN      CONST CHAR8  *SecondString
+  )
+{
+  //
+  // The strings are compared a word at a time when they have the same
+  // alignment, until a word differs or has a Null-terminator.
+  //
+  if ((((UINTN)FirstString ^ (UINTN)SecondString) & STRING_WORD_MASK) == 0) {
+    while (((UINTN)FirstString & STRING_WORD_MASK) != 0) {
+      if ((*FirstString == '\0') || (*FirstString != *SecondString)) {
+        return *FirstString - *SecondString;
+      }
+
+      FirstString++;
+      SecondString++;
+    }
+
+    while ((*(CONST UINTN *)FirstString == *(CONST UINTN *)SecondString) &&
+           !STRING_WORD_HAS_ZERO8 (*(CONST UINTN *)FirstString))
+    {
+      FirstString  += sizeof (UINTN);
+      SecondString += sizeof (UINTN);
+    }
+  }
+
+  while ((*FirstString != '\0') && (*FirstString == *SecondString)) {
+    FirstString++;
+    SecondString++;
+  }
+
+  return *FirstString - *SecondString;
+}
+
+/**
+  Returns the first occurrence of a Unicode character in a Null-terminated
+  Unicode string, or its Null-terminator if the character does not appear.
+
+  @param  String  A pointer to a Null-terminated Unicode string, aligned on a
+                  16-bit boundary.
+  @param  Char    The character to search for.
+
+  @return A pointer to the first Char, or to the Null-terminator of String.
+
+**/
+CONST CHAR16 *
+EFIAPI
+InternalStrChr (
+  IN      CONST CHAR16  *String,
+  IN      CHAR16        Char
+  )
+{
+  CONST UINTN  *Word;
+  UINTN        Pattern;
+
+  while (((UINTN)String & STRING_WORD_MASK) != 0) {
+    if ((*String == Char) || (*String == L'\0')) {
+      return String;
+    }
+
+    String++;
+  }
+
+  //
+  // Skip the words without Char or a Null-terminator, then find the first of
+  // them in the last word.
+  //
+  Pattern = STRING_WORD_ONES16 * Char;
+  Word    = (CONST UINTN *)String;
+  while (!STRING_WORD_HAS_ZERO16 (*Word) && !STRING_WORD_HAS_ZERO16 (*Word ^ Pattern)) {
+    Word++;
+  }
+
+  String = (CONST CHAR16 *)Word;
+  while ((*String != Char) && (*String != L'\0')) {
+    String++;
+  }
+
+  return String;
+}
+
+/**
+  Returns the first occurrence of an ASCII character in a Null-terminated
+  ASCII string, or its Null-terminator if the character does not appear.
+
+  @param  String  A pointer to a Null-terminated ASCII string.
+  @param  Char    The character to search for.
+
+  @return A pointer to the first Char, or to the Null-terminator of String.
+
+**/
+CONST CHAR8 *
+EFIAPI
+InternalAsciiStrChr (
+  IN      CONST CHAR8  *String,
+  IN      CHAR8        Char
+  )
+{
+  CONST UINTN  *Word;
+  UINTN        Pattern;
+
+  while (((UINTN)String & STRING_WORD_MASK) != 0) {
+    if ((*String == Char) || (*String == '\0')) {
+      return String;
+    }
+
+    String++;
+  }
+
+  //
+  // Skip the words without Char or a Null-terminator, then find the first of
+  // them in the last word.
+  //
+  Pattern = STRING_WORD_ONES8 * (UINT8)Char;
+  Word    = (CONST UINTN *)String;
+  while (!STRING_WORD_HAS_ZERO8 (*Word) && !STRING_WORD_HAS_ZERO8 (*Word ^ Pattern)) {
+    Word++;
+  }
+
+  String = (CONST CHAR8 *)Word;
+  while ((*String != Char) && (*String != '\0')) {
+    String++;
+  }
+
+  return String;
+}
@@ -0,0 +1,85 @@
+/** @file
+  CRC32 and CRC32c updates of X64, with PCLMULQDQ and the SSE4.2 CRC32
+  instruction when the processor supports them.
+
+  BaseLib has no writable data in the XIP modules, so the processor is asked
+  with CPUID on each large buffer. The buffers smaller than
+  CRC_ACCELERATED_MIN_LENGTH use the slicing-by-8 tables, which are as fast as
+  the CPUID for them.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+#include <Register/Intel/Cpuid.h>
+
+#define CRC_ACCELERATED_MIN_LENGTH  512
+
+/**
+  Updates the CRC32 of ITU-T V.42 with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32Update (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  CPUID_VERSION_INFO_ECX  Ecx;
+  UINTN                   Folded;
+
+  if (Length >= CRC_ACCELERATED_MIN_LENGTH) {
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &Ecx.Uint32, NULL);
+    if (Ecx.Bits.PCLMULQDQ != 0) {
+      //
+      // Fold the 16-byte blocks, and leave the last bytes to the tables.
+      //
+      Folded  = Length & ~(UINTN)0xF;
+      Crc     = InternalCrc32Pclmul (Crc, Buffer, Folded);
+      Buffer += Folded;
+      Length -= Folded;
+    }
+  }
+
+  return InternalCrc32Slicing8 (Crc, Buffer, Length);
+}
+
+/**
+  Updates the CRC32c with a data buffer.
+
+  @param[in]  Crc          The CRC of the data that precedes Buffer, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer Data.
+
+  @return The CRC updated with the data, not inverted.
+
+**/
+UINT32
+EFIAPI
+InternalCrc32cUpdate (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  CPUID_VERSION_INFO_ECX  Ecx;
+
+  if (Length >= CRC_ACCELERATED_MIN_LENGTH) {
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &Ecx.Uint32, NULL);
+    if (Ecx.Bits.SSE4_2 != 0) {
+      return InternalCrc32cSse42 (Crc, Buffer, Length);
+    }
+  }
+
+  return InternalCrc32cSlicing8 (Crc, Buffer, Length);
+}
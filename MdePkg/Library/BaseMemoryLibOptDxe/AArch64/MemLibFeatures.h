@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+// SPDX-License-Identifier: BSD-2-Clause-Patent
+//
+
+#ifndef MEM_LIB_FEATURES_H_
+#define MEM_LIB_FEATURES_H_
+
+//
+// The bits of mMemLibFeatures, set by InternalMemDetectFeatures().
+//
+#define MEM_LIB_FEATURE_DETECTED      0x1
+#define MEM_LIB_FEATURE_SVE           0x2
+#define MEM_LIB_FEATURE_SVE_BIT       1
+
+//
+// Branch to \label when the SVE kernel of the function can be used. The
+// features are detected on the first call. This clobbers x16 and x17 only, so
+// it can be used at the entry of the functions, before their arguments are
+// moved.
+//
+  .macro MEM_LIB_SVE_DISPATCH label
+    adrp    x16, ASM_PFX(mMemLibFeatures)
+    ldr     w16, [x16, :lo12:ASM_PFX(mMemLibFeatures)]
+    cbnz    w16, 0f
+    stp     x29, x30, [sp, #-16]!
+    bl      ASM_PFX(InternalMemDetectFeatures)
+    ldp     x29, x30, [sp], #16
+0:  tbnz    w16, #MEM_LIB_FEATURE_SVE_BIT, \label
+  .endm
+
+#endif
@@ -10,6 +10,10 @@
 
   The implementation is also useful as a fast priority queue.
 
+  A tree may take its nodes from a caller-supplied pool, falling back to
+  MemoryAllocationLib when the pool is exhausted, and it may be built from a
+  sorted array in O(n) time.
+
   Copyright (C) 2014, Red Hat, Inc.
   Copyright (c) 2014, Intel Corporation. All rights reserved.<BR>
 
@@ -39,6 +43,15 @@ struct ORDERED_COLLECTION {
   RED_BLACK_TREE_NODE            *Root;
   RED_BLACK_TREE_USER_COMPARE    UserStructCompare;
   RED_BLACK_TREE_KEY_COMPARE     KeyCompare;
+  //
+  // The caller-supplied node pool, if any. The nodes between PoolBase and
+  // PoolNext have been handed out; the deleted ones are linked through their
+  // Right fields on FreeNodes.
+  //
+  UINT8                          *PoolBase;
+  UINT8                          *PoolNext;
+  UINT8                          *PoolEnd;
+  RED_BLACK_TREE_NODE            *FreeNodes;
 };
 
 struct ORDERED_COLLECTION_ENTRY {
@@ -121,6 +134,10 @@ OrderedCollectionInit (
   Tree->Root              = NULL;
   Tree->UserStructCompare = UserStructCompare;
   Tree->KeyCompare        = KeyCompare;
+  Tree->PoolBase          = NULL;
+  Tree->PoolNext          = NULL;
+  Tree->PoolEnd           = NULL;
+  Tree->FreeNodes         = NULL;
 
   if (FeaturePcdGet (PcdValidateOrderedCollection)) {
     RedBlackTreeValidate (Tree);
@@ -129,6 +146,138 @@ OrderedCollectionInit (
   return Tree;
 }
 
+/**
+  Return the size of the node pool that holds EntryCount tree nodes.
+
+  @param[in] EntryCount  The number of tree nodes.
+
+  @return  The size in bytes of the pool.
+**/
+UINTN
+EFIAPI
+OrderedCollectionPoolSize (
+  IN UINTN  EntryCount
+  )
+{
+  return EntryCount * sizeof (RED_BLACK_TREE_NODE);
+}
+
+/**
+  Allocate and initialize the RED_BLACK_TREE structure, which takes its nodes
+  from a caller-supplied pool.
+
+  The RED_BLACK_TREE structure is allocated via MemoryAllocationLib's
+  AllocatePool() function. The nodes are carved from Pool, and the deleted
+  nodes are reused by the later insertions. When Pool is exhausted, the nodes
+  are allocated via AllocatePool().
+
+  @param[in]  UserStructCompare  This caller-provided function will be used to
+                                 order two user structures linked into the
+                                 tree, during the insertion procedure.
+
+  @param[in]  KeyCompare         This caller-provided function will be used to
+                                 order the standalone search key against user
+                                 structures linked into the tree, during the
+                                 lookup procedure.
+
+  @param[in]  Pool               The node pool, aligned on a 64-bit boundary.
+                                 It must remain valid until the tree is
+                                 uninitialized.
+
+  @param[in]  PoolSize           The size in bytes of Pool, see
+                                 OrderedCollectionPoolSize().
+
+  @retval NULL  If allocation failed.
+
+  @return       Pointer to the allocated, initialized RED_BLACK_TREE structure,
+                otherwise.
+**/
+RED_BLACK_TREE *
+EFIAPI
+OrderedCollectionInitWithPool (
+  IN RED_BLACK_TREE_USER_COMPARE  UserStructCompare,
+  IN RED_BLACK_TREE_KEY_COMPARE   KeyCompare,
+  IN VOID                         *Pool,
+  IN UINTN                        PoolSize
+  )
+{
+  RED_BLACK_TREE  *Tree;
+
+  ASSERT (((UINTN)Pool & (sizeof (UINT64) - 1)) == 0);
+
+  Tree = OrderedCollectionInit (UserStructCompare, KeyCompare);
+  if (Tree == NULL) {
+    return NULL;
+  }
+
+  Tree->PoolBase = Pool;
+  Tree->PoolNext = Pool;
+  Tree->PoolEnd  = Tree->PoolBase + PoolSize;
+
+  return Tree;
+}
+
+/**
+  Allocate a tree node, from the free nodes or the rest of the pool of the
+  tree, if any, or else via MemoryAllocationLib's AllocatePool() function.
+
+  Internal read-write operation.
+
+  @param[in,out] Tree  The tree to allocate a node for.
+
+  @retval NULL  If allocation failed.
+
+  @return       The uninitialized tree node, otherwise.
+**/
+STATIC
+RED_BLACK_TREE_NODE *
+RedBlackTreeAllocateNode (
+  IN OUT RED_BLACK_TREE  *Tree
+  )
+{
+  RED_BLACK_TREE_NODE  *Node;
+
+  Node = Tree->FreeNodes;
+  if (Node != NULL) {
+    Tree->FreeNodes = Node->Right;
+    return Node;
+  }
+
+  if ((UINTN)(Tree->PoolEnd - Tree->PoolNext) >= sizeof *Node) {
+    Node            = (RED_BLACK_TREE_NODE *)Tree->PoolNext;
+    Tree->PoolNext += sizeof *Node;
+    return Node;
+  }
+
+  return AllocatePool (sizeof *Node);
+}
+
+/**
+  Release a tree node to the free nodes of the tree if it comes from the pool
+  of the tree, or else via MemoryAllocationLib's FreePool() function.
+
+  Internal read-write operation.
+
+  @param[in,out] Tree  The tree that Node was allocated for.
+
+  @param[in]     Node  The tree node to release.
+**/
+STATIC
+VOID
+RedBlackTreeFreeNode (
+  IN OUT RED_BLACK_TREE       *Tree,
+  IN     RED_BLACK_TREE_NODE  *Node
+  )
+{
+  if (((UINT8 *)Node >= Tree->PoolBase) && ((UINT8 *)Node < Tree->PoolEnd)) {
+    Node->Right     = Tree->FreeNodes;
+    Tree->FreeNodes = Node;
+    return;
+  }
+
+  FreePool (Node);
+}
+
 /**
   Check whether the tree is empty (has no nodes).
 
@@ -154,7 +303,8 @@ OrderedCollectionIsEmpty (
 
   Read-write operation.
 
-  Release occurs via MemoryAllocationLib's FreePool() function.
+  Release occurs via MemoryAllocationLib's FreePool() function. The node pool
+  of the tree, if any, is not released.
 
   It is the caller's responsibility to delete all nodes from the tree before
   calling this function.
@@ -386,6 +536,102 @@ OrderedCollectionPrev (
   return Walk;
 }
 
+/**
+  Find the tree node of the least user structure that does not compare less
+  than the specified standalone key.
+
+  Read-only operation.
+
+  The nodes of the user structures in a key range [KeyLow, KeyHigh) are the
+  ones from OrderedCollectionLowerBound (Tree, KeyLow) up to, but excluding,
+  OrderedCollectionLowerBound (Tree, KeyHigh), with OrderedCollectionNext().
+
+  @param[in] Tree           The tree to search for StandaloneKey.
+
+  @param[in] StandaloneKey  The key to bound the user structures linked into
+                            Tree with. StandaloneKey will be passed to
+                            Tree->KeyCompare().
+
+  @retval NULL  If all the user structures in Tree compare less than
+                StandaloneKey.
+
+  @return       The tree node that links the least user structure that compares
+                greater than or equal to StandaloneKey, otherwise.
+**/
+RED_BLACK_TREE_NODE *
+EFIAPI
+OrderedCollectionLowerBound (
+  IN CONST RED_BLACK_TREE  *Tree,
+  IN CONST VOID            *StandaloneKey
+  )
+{
+  RED_BLACK_TREE_NODE  *Node;
+  RED_BLACK_TREE_NODE  *Bound;
+
+  Bound = NULL;
+  Node  = Tree->Root;
+  while (Node != NULL) {
+    if (Tree->KeyCompare (StandaloneKey, Node->UserStruct) <= 0) {
+      Bound = Node;
+      Node  = Node->Left;
+    } else {
+      Node = Node->Right;
+    }
+  }
+
+  return Bound;
+}
+
+/**
+  Find the tree node of the least user structure that compares greater than
+  the specified standalone key.
+
+  Read-only operation.
+
+  The nodes of the user structures in a key range [KeyLow, KeyHigh] are the
+  ones from OrderedCollectionLowerBound (Tree, KeyLow) up to, but excluding,
+  OrderedCollectionUpperBound (Tree, KeyHigh), with OrderedCollectionNext().
+  The predecessor of OrderedCollectionUpperBound (Tree, Key), or
+  OrderedCollectionMax (Tree) if it is NULL, links the greatest user structure
+  that does not compare greater than Key, such as the range containing an
+  address in a tree of ranges ordered by their start.
+
+  @param[in] Tree           The tree to search for StandaloneKey.
+
+  @param[in] StandaloneKey  The key to bound the user structures linked into
+                            Tree with. StandaloneKey will be passed to
+                            Tree->KeyCompare().
+
+  @retval NULL  If no user structure in Tree compares greater than
+                StandaloneKey.
+
+  @return       The tree node that links the least user structure that compares
+                greater than StandaloneKey, otherwise.
+**/
+RED_BLACK_TREE_NODE *
+EFIAPI
+OrderedCollectionUpperBound (
+  IN CONST RED_BLACK_TREE  *Tree,
+  IN CONST VOID            *StandaloneKey
+  )
+{
+  RED_BLACK_TREE_NODE  *Node;
+  RED_BLACK_TREE_NODE  *Bound;
+
+  Bound = NULL;
+  Node  = Tree->Root;
+  while (Node != NULL) {
+    if (Tree->KeyCompare (StandaloneKey, Node->UserStruct) < 0) {
+      Bound = Node;
+      Node  = Node->Left;
+    } else {
+      Node = Node->Right;
+    }
+  }
+
+  return Bound;
+}
+
 /**
   Rotate tree nodes around Pivot to the right.
 
@@ -523,8 +769,8 @@ RedBlackTreeRotateLeft (
 
   Read-write operation.
 
-  This function allocates the new tree node with MemoryAllocationLib's
-  AllocatePool() function.
+  This function takes the new tree node from the node pool of the tree, or
+  else allocates it with MemoryAllocationLib's AllocatePool() function.
 
   @param[in,out] Tree        The tree to insert UserStruct into.
 
@@ -566,8 +812,9 @@ RedBlackTreeRotateLeft (
                                    return the new node at some point if user
                                    structure order dictates it.
 
-  @retval RETURN_OUT_OF_RESOURCES  AllocatePool() failed to allocate memory for
-                                   the new tree node. The tree has not been
+  @retval RETURN_OUT_OF_RESOURCES  The pool is exhausted, and AllocatePool()
+                                   failed to allocate memory for the new tree
+                                   node. The tree has not been
                                    changed. Existing RED_BLACK_TREE_NODE
                                    pointers into Tree remain valid.
 
@@ -623,7 +870,7 @@ OrderedCollectionInsert (
   //
   // no collision, allocate a new node
   //
-  Tmp = AllocatePool (sizeof *Tmp);
+  Tmp = RedBlackTreeAllocateNode (Tree);
   if (Tmp == NULL) {
     Status = RETURN_OUT_OF_RESOURCES;
     goto Done;
@@ -835,6 +1082,166 @@ Done:
   return Status;
 }
 
+/**
+  Recursively link the nodes of a sorted array of user structures into a
+  balanced subtree.
+
+  The middle user structure is the root of the subtree, so the depths of the
+  leaves of the whole tree differ by at most one. The nodes of the deepest,
+  incomplete level are colored red, and all the others black, so every path
+  has the same black count, and no red node has a child.
+
+  Internal read-write operation.
+
+  @param[in,out] Nodes        The chain of allocated nodes, linked through
+                              their Right fields. The nodes of the subtree are
+                              taken from it.
+
+  @param[in]     UserStructs  The sorted user structures of the subtree.
+
+  @param[in]     Count        The number of user structures in UserStructs.
+
+  @param[in]     Depth        The depth of the root of the subtree in the tree.
+
+  @param[in]     RedDepth     The depth of the incomplete level of the tree.
+
+  @param[in]     Parent       The parent node of the subtree.
+
+  @return  The root node of the subtree, or NULL if Count is zero.
+**/
+STATIC
+RED_BLACK_TREE_NODE *
+RedBlackTreeBuildSubtree (
+  IN OUT RED_BLACK_TREE_NODE  **Nodes,
+  IN     VOID                 **UserStructs,
+  IN     UINTN                Count,
+  IN     UINTN                Depth,
+  IN     UINTN                RedDepth,
+  IN     RED_BLACK_TREE_NODE  *Parent
+  )
+{
+  RED_BLACK_TREE_NODE  *Node;
+  UINTN                Middle;
+
+  if (Count == 0) {
+    return NULL;
+  }
+
+  Node   = *Nodes;
+  *Nodes = Node->Right;
+  Middle = Count / 2;
+
+  Node->UserStruct = UserStructs[Middle];
+  Node->Parent     = Parent;
+  Node->Color      = (Depth == RedDepth) ? RedBlackTreeRed : RedBlackTreeBlack;
+  Node->Left       = RedBlackTreeBuildSubtree (
+                       Nodes,
+                       UserStructs,
+                       Middle,
+                       Depth + 1,
+                       RedDepth,
+                       Node
+                       );
+  Node->Right = RedBlackTreeBuildSubtree (
+                  Nodes,
+                  UserStructs + Middle + 1,
+                  Count - Middle - 1,
+                  Depth + 1,
+                  RedDepth,
+                  Node
+                  );
+
+  return Node;
+}
+
+/**
+  Build an empty tree from a sorted array of user structures, in O(n) time.
+
+  Read-write operation.
+
+  This function takes the tree nodes from the node pool of the tree, or else
+  allocates them with MemoryAllocationLib's AllocatePool() function.
+
+  @param[in,out] Tree         The empty tree to link the user structures into.
+
+  @param[in]     UserStructs  The user structures to link into the tree, in
+                              strictly increasing order per
+                              Tree->UserStructCompare(). The array itself is
+                              not referenced after the function returns.
+
+  @param[in]     Count        The number of user structures in UserStructs.
+
+  @retval RETURN_SUCCESS            The user structures have been linked into
+                                    the tree.
+
+  @retval RETURN_INVALID_PARAMETER  Tree is not empty, or UserStructs is not
+                                    strictly increasing. The tree has not been
+                                    changed.
+
+  @retval RETURN_OUT_OF_RESOURCES   The nodes could not be allocated. The tree
+                                    has not been changed.
+**/
+RETURN_STATUS
+EFIAPI
+OrderedCollectionBuildSorted (
+  IN OUT RED_BLACK_TREE  *Tree,
+  IN     VOID            **UserStructs,
+  IN     UINTN           Count
+  )
+{
+  RED_BLACK_TREE_NODE  *Nodes;
+  RED_BLACK_TREE_NODE  *Node;
+  UINTN                Index;
+  UINTN                RedDepth;
+
+  if (!OrderedCollectionIsEmpty (Tree)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (Index = 1; Index < Count; Index++) {
+    if (Tree->UserStructCompare (UserStructs[Index - 1], UserStructs[Index]) >= 0) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  //
+  // Allocate all the nodes first, so that a failure leaves the tree empty.
+  //
+  Nodes = NULL;
+  for (Index = 0; Index < Count; Index++) {
+    Node = RedBlackTreeAllocateNode (Tree);
+    if (Node == NULL) {
+      while (Nodes != NULL) {
+        Node  = Nodes;
+        Nodes = Node->Right;
+        RedBlackTreeFreeNode (Tree, Node);
+      }
+
+      return RETURN_OUT_OF_RESOURCES;
+    }
+
+    Node->Right = Nodes;
+    Nodes       = Node;
+  }
+
+  //
+  // The incomplete level is at depth floor (log2 (Count + 1)).
+  //
+  RedDepth = 0;
+  for (Index = Count + 1; Index > 1; Index >>= 1) {
+    RedDepth++;
+  }
+
+  Tree->Root = RedBlackTreeBuildSubtree (&Nodes, UserStructs, Count, 0, RedDepth, NULL);
+  ASSERT (Nodes == NULL);
+
+  if (FeaturePcdGet (PcdValidateOrderedCollection)) {
+    RedBlackTreeValidate (Tree);
+  }
+
+  return RETURN_SUCCESS;
+}
+
 /**
   Check if a node is black, allowing for leaf nodes (see property #2).
 
@@ -884,8 +1291,9 @@ NodeIsNullOrBlack (
                              Node argument (typically used for simplicity in
                              loops that empty the tree completely).
 
-                             Node is released with MemoryAllocationLib's
-                             FreePool() function.
+                             Node is released to the node pool of the tree
+                             if it comes from it, or else with
+                             MemoryAllocationLib's FreePool() function.
 
                              Existing RED_BLACK_TREE_NODE pointers (ie.
                              iterators) *different* from Node remain valid. For
@@ -1111,7 +1519,7 @@ OrderedCollectionDelete (
     }
   }
 
-  FreePool (Node);
+  RedBlackTreeFreeNode (Tree, Node);
 
   //
   // If the node that we unlinked from its original spot (ie. Node itself, or
@@ -0,0 +1,403 @@
+/** @file
+  Implementation of the ticket lock and MCS lock functions.
+
+  A test-and-set spin lock lets every waiter compete for the same cache line
+  and grants the lock to whichever processor wins the race. A ticket lock
+  grants it in arrival order instead, and an MCS lock also lets every waiter
+  spin on a node of its own, so no cache line bounces between the waiters.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseSynchronizationLibInternals.h"
+
+///
+/// The state of the PcdSpinLockTimeout check of a waiting processor.
+///
+typedef struct {
+  UINT64    Current;
+  UINT64    Total;
+  UINT64    Timeout;
+  UINT64    Start;
+  UINT64    End;
+  INT64     Cycle;
+} SPIN_LOCK_TIMER;
+
+/**
+  Starts to measure how long a processor waits for a lock.
+
+  @param  Timer  The timer to start. Timer->Timeout is zero if
+                 PcdSpinLockTimeout is zero.
+
+**/
+VOID
+InternalStartSpinLockTimer (
+  OUT SPIN_LOCK_TIMER  *Timer
+  )
+{
+  Timer->Timeout = 0;
+  if (PcdGet32 (PcdSpinLockTimeout) == 0) {
+    return;
+  }
+
+  Timer->Current = GetPerformanceCounter ();
+  Timer->Start   = 0;
+  Timer->End     = 0;
+  Timer->Total   = 0;
+  Timer->Timeout = DivU64x32 (
+                     MultU64x32 (
+                       GetPerformanceCounterProperties (&Timer->Start, &Timer->End),
+                       PcdGet32 (PcdSpinLockTimeout)
+                       ),
+                     1000000
+                     );
+  Timer->Cycle = Timer->End - Timer->Start;
+  if (Timer->Cycle < 0) {
+    Timer->Cycle = -Timer->Cycle;
+  }
+
+  Timer->Cycle++;
+}
+
+/**
+  Pauses a waiting processor, and ASSERT()s if it has waited for longer than
+  PcdSpinLockTimeout microseconds.
+
+  @param  Timer  The timer started by InternalStartSpinLockTimer().
+
+**/
+VOID
+InternalCheckSpinLockTimer (
+  IN OUT SPIN_LOCK_TIMER  *Timer
+  )
+{
+  UINT64  Previous;
+  INT64   Delta;
+
+  CpuPause ();
+  if (Timer->Timeout == 0) {
+    return;
+  }
+
+  Previous       = Timer->Current;
+  Timer->Current = GetPerformanceCounter ();
+  Delta          = (INT64)(Timer->Current - Previous);
+  if (Timer->Start > Timer->End) {
+    Delta = -Delta;
+  }
+
+  if (Delta < 0) {
+    Delta += Timer->Cycle;
+  }
+
+  Timer->Total += Delta;
+  ASSERT (Timer->Total < Timer->Timeout);
+}
+
+/**
+  Initializes a ticket lock to the released state and returns the ticket lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to initialize to the released
+                      state.
+
+  @return TicketLock in release state.
+
+**/
+TICKET_LOCK *
+EFIAPI
+InitializeTicketLock (
+  OUT      TICKET_LOCK  *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+  TicketLock->NextTicket = 0;
+  TicketLock->NowServing = 0;
+  return TicketLock;
+}
+
+/**
+  Waits until a ticket lock can be placed in the acquired state.
+
+  This function takes the next ticket of the ticket lock specified by
+  TicketLock, and waits until the ticket is served. The processors that wait for
+  the same ticket lock acquire it in the order in which they called this
+  function.
+
+  If TicketLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and TicketLock is can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired state.
+
+  @return TicketLock acquired lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+AcquireTicketLock (
+  IN OUT  TICKET_LOCK  *TicketLock
+  )
+{
+  UINT32           Ticket;
+  SPIN_LOCK_TIMER  Timer;
+
+  ASSERT (TicketLock != NULL);
+
+  Ticket = InterlockedIncrement (&TicketLock->NextTicket) - 1;
+  if (TicketLock->NowServing != Ticket) {
+    InternalStartSpinLockTimer (&Timer);
+    while (TicketLock->NowServing != Ticket) {
+      InternalCheckSpinLockTimer (&Timer);
+    }
+  }
+
+  MemoryFence ();
+  return TicketLock;
+}
+
+/**
+  Attempts to place a ticket lock in the acquired state.
+
+  This function takes the next ticket of the ticket lock specified by
+  TicketLock only if the ticket is served at once, and returns TRUE.
+  Otherwise, FALSE is returned.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to place in the acquired state.
+
+  @retval TRUE  TicketLock was placed in the acquired state.
+  @retval FALSE TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketLockOrFail (
+  IN OUT  TICKET_LOCK  *TicketLock
+  )
+{
+  UINT32  Ticket;
+
+  ASSERT (TicketLock != NULL);
+
+  Ticket = TicketLock->NowServing;
+  if (InterlockedCompareExchange32 (&TicketLock->NextTicket, Ticket, Ticket + 1) != Ticket) {
+    return FALSE;
+  }
+
+  MemoryFence ();
+  return TRUE;
+}
+
+/**
+  Releases a ticket lock.
+
+  This function serves the next ticket of the ticket lock specified by
+  TicketLock and returns TicketLock.
+
+  If TicketLock is NULL, then ASSERT().
+  If TicketLock is not in the acquired state, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket lock to release.
+
+  @return TicketLock released lock.
+
+**/
+TICKET_LOCK *
+EFIAPI
+ReleaseTicketLock (
+  IN OUT  TICKET_LOCK  *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+  ASSERT (TicketLock->NextTicket != TicketLock->NowServing);
+
+  //
+  // Only the owner writes NowServing, so a plain store serves the next ticket.
+  //
+  MemoryFence ();
+  TicketLock->NowServing = TicketLock->NowServing + 1;
+  return TicketLock;
+}
+
+/**
+  Initializes an MCS lock to the released state and returns the MCS lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to initialize to the released
+                   state.
+
+  @return McsLock in release state.
+
+**/
+MCS_LOCK *
+EFIAPI
+InitializeMcsLock (
+  OUT      MCS_LOCK  *McsLock
+  )
+{
+  ASSERT (McsLock != NULL);
+  *McsLock = NULL;
+  return McsLock;
+}
+
+/**
+  Waits until an MCS lock can be placed in the acquired state.
+
+  This function appends the node specified by Node to the queue of the MCS lock
+  specified by McsLock, and waits until the previous owner hands the lock to
+  Node. The processors that wait for the same MCS lock acquire it in the order
+  in which they called this function, and each of them waits on its own node.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and McsLock is can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     A pointer to the queue node of the caller. It must be passed
+                   to ReleaseMcsLock().
+
+  @return McsLock acquired lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+AcquireMcsLock (
+  IN OUT  MCS_LOCK       *McsLock,
+  OUT     MCS_LOCK_NODE  *Node
+  )
+{
+  MCS_LOCK_NODE    *Predecessor;
+  SPIN_LOCK_TIMER  Timer;
+
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+
+  Node->Next   = NULL;
+  Node->Locked = TRUE;
+
+  //
+  // Swap Node in as the tail of the queue.
+  //
+  do {
+    Predecessor = *McsLock;
+  } while (InterlockedCompareExchangePointer ((VOID **)McsLock, Predecessor, Node) != Predecessor);
+
+  if (Predecessor != NULL) {
+    //
+    // Link Node behind the previous tail, and wait until its owner hands the
+    // lock over in ReleaseMcsLock().
+    //
+    Predecessor->Next = Node;
+    InternalStartSpinLockTimer (&Timer);
+    while (Node->Locked) {
+      InternalCheckSpinLockTimer (&Timer);
+    }
+  }
+
+  MemoryFence ();
+  return McsLock;
+}
+
+/**
+  Attempts to place an MCS lock in the acquired state.
+
+  This function places the MCS lock specified by McsLock in the acquired state
+  with the node specified by Node and returns TRUE if the lock is released.
+  Otherwise, FALSE is returned.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to place in the acquired state.
+  @param  Node     A pointer to the queue node of the caller. It must be passed
+                   to ReleaseMcsLock() if TRUE is returned.
+
+  @retval TRUE  McsLock was placed in the acquired state.
+  @retval FALSE McsLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireMcsLockOrFail (
+  IN OUT  MCS_LOCK       *McsLock,
+  OUT     MCS_LOCK_NODE  *Node
+  )
+{
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+
+  if (*McsLock != NULL) {
+    return FALSE;
+  }
+
+  Node->Next   = NULL;
+  Node->Locked = TRUE;
+  if (InterlockedCompareExchangePointer ((VOID **)McsLock, NULL, Node) != NULL) {
+    return FALSE;
+  }
+
+  MemoryFence ();
+  return TRUE;
+}
+
+/**
+  Releases an MCS lock.
+
+  This function hands the MCS lock specified by McsLock to the next node in its
+  queue, or places McsLock in the release state if no processor waits for it,
+  and returns McsLock.
+
+  If McsLock is NULL, then ASSERT().
+  If Node is NULL, then ASSERT().
+  If McsLock is not in the acquired state, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS lock to release.
+  @param  Node     A pointer to the queue node that acquired McsLock.
+
+  @return McsLock released lock.
+
+**/
+MCS_LOCK *
+EFIAPI
+ReleaseMcsLock (
+  IN OUT  MCS_LOCK       *McsLock,
+  IN OUT  MCS_LOCK_NODE  *Node
+  )
+{
+  MCS_LOCK_NODE  *Successor;
+
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+  ASSERT (*McsLock != NULL);
+
+  MemoryFence ();
+  Successor = Node->Next;
+  if (Successor == NULL) {
+    //
+    // Node is still the tail if no processor has queued up behind it, so the
+    // lock is released.
+    //
+    if (InterlockedCompareExchangePointer ((VOID **)McsLock, Node, NULL) == Node) {
+      return McsLock;
+    }
+
+    //
+    // A processor has swapped itself in as the tail but has not linked its
+    // node behind Node yet.
+    //
+    do {
+      CpuPause ();
+      Successor = Node->Next;
+    } while (Successor == NULL);
+  }
+
+  Successor->Locked = FALSE;
+  return McsLock;
+}
@@ -9,6 +9,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiDxe.h>
 
 #include <Guid/HobList.h>
+#include <Guid/HobListIndex.h>
 
 #include <Library/HobLib.h>
 #include <Library/UefiLib.h>
@@ -17,6 +18,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 VOID  *mHobList = NULL;
 
+HOB_LIST_INDEX  *mHobListIndex = NULL;
+
 /**
   Returns the pointer to the HOB list.
 
@@ -71,9 +74,72 @@ HobLibConstructor (
 {
   GetHobList ();
 
+  //
+  // The index of GUIDed HOBs is optional, the HOB list is walked without it.
+  //
+  EfiGetSystemConfigurationTable (&gEdkiiHobListIndexGuid, (VOID **)&mHobListIndex);
+  if ((mHobListIndex != NULL) && (mHobListIndex->HobList != mHobList)) {
+    mHobListIndex = NULL;
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Returns the first GUID extension HOB of a name at or after a HOB, through the
+  index of GUIDed HOBs published by the DXE Core.
+
+  @param  Guid          The GUID to match with in the HOB list.
+  @param  HobStart      A pointer to a Guid HOB in the HOB list.
+  @param  GuidHob       Returns the GUID extension HOB found, or NULL.
+
+  @retval TRUE          The index was searched.
+  @retval FALSE         The index is not available, or HobStart is not in the
+                        indexed HOB list.
+
+**/
+BOOLEAN
+FindGuidHobInIndex (
+  IN  CONST EFI_GUID  *Guid,
+  IN  CONST VOID      *HobStart,
+  OUT VOID            **GuidHob
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+  INTN   Result;
+
+  if ((mHobListIndex == NULL) ||
+      ((UINTN)HobStart < (UINTN)mHobListIndex->HobList) ||
+      ((UINTN)HobStart > (UINTN)mHobListIndex->EndOfHobList))
+  {
+    return FALSE;
+  }
+
+  //
+  // Find the first entry not below (Guid, HobStart).
+  //
+  Low  = 0;
+  High = mHobListIndex->Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareMem (&mHobListIndex->Entry[Middle].Name, Guid, sizeof (EFI_GUID));
+    if ((Result < 0) || ((Result == 0) && ((UINTN)mHobListIndex->Entry[Middle].Hob < (UINTN)HobStart))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  *GuidHob = NULL;
+  if ((Low < mHobListIndex->Count) && CompareGuid (&mHobListIndex->Entry[Low].Name, Guid)) {
+    *GuidHob = mHobListIndex->Entry[Low].Hob;
+  }
+
+  return TRUE;
+}
+
 /**
   Returns the next instance of a HOB type from the starting HOB.
 
@@ -173,6 +239,10 @@ GetNextGuidHob (
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
 
+  if (FindGuidHobInIndex (Guid, HobStart, (VOID **)&GuidHob.Raw)) {
+    return GuidHob.Raw;
+  }
+
   GuidHob.Raw = (UINT8 *)HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
     if (CompareGuid (Guid, &GuidHob.Guid->Name)) {
@@ -404,6 +404,46 @@ GetDevicePathSize (
   return mDevicePathLibDevicePathUtilities->GetDevicePathSize (DevicePath);
 }
 
+/**
+  Returns a hash of a device path.
+
+  Device paths with the same bytes have the same hash. A caller that compares
+  a set of device paths with others many times can compute their hashes once,
+  and only compare the bytes of the device paths whose hashes are equal.
+
+  @param  DevicePath  A pointer to a device path data structure.
+
+  @retval 0           If DevicePath is NULL or invalid.
+  @retval Others      The hash of the device path, including the end of
+                      device path node.
+
+**/
+UINT32
+EFIAPI
+GetDevicePathHash (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  CONST UINT8  *Byte;
+  UINTN        Size;
+  UINT32       Hash;
+
+  Size = GetDevicePathSize (DevicePath);
+  if (Size == 0) {
+    return 0;
+  }
+
+  //
+  // 32-bit FNV-1a over the bytes of the device path
+  //
+  Hash = 0x811C9DC5;
+  for (Byte = (CONST UINT8 *)DevicePath; Size > 0; Byte++, Size--) {
+    Hash = (Hash ^ *Byte) * 0x01000193;
+  }
+
+  return Hash;
+}
+
 /**
   Creates a new copy of an existing device path.
 
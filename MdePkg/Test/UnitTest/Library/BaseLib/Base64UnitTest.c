@@ -389,6 +389,198 @@ SafeStringContraintCheckTest (
   return UNIT_TEST_PASSED;
 }
 
+#define STRING_TEST_MAX_LENGTH  80
+
+///
+/// The strings of the length, compare and search tests, with room for every
+/// alignment of their start.
+///
+STATIC CHAR8   mAsciiString[STRING_TEST_MAX_LENGTH + 32];
+STATIC CHAR8   mAsciiOther[STRING_TEST_MAX_LENGTH + 32];
+STATIC CHAR16  mUnicodeString[STRING_TEST_MAX_LENGTH + 32];
+STATIC CHAR16  mUnicodeOther[STRING_TEST_MAX_LENGTH + 32];
+
+/**
+  Check the length, compare and search functions of the Unicode and ASCII
+  strings, for every length up to STRING_TEST_MAX_LENGTH and every alignment
+  of the strings, against the value that they must return.
+
+  @param[in]  Context   Not used.
+
+  @retval  UNIT_TEST_PASSED             All the checks passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A function returned a wrong value.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+StringPrimitivesTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Length;
+  UINTN   Offset;
+  UINTN   Index;
+  CHAR8   *Ascii;
+  CHAR8   *AsciiOther;
+  CHAR16  *Unicode;
+  CHAR16  *UnicodeOther;
+
+  for (Length = 0; Length <= STRING_TEST_MAX_LENGTH; Length++) {
+    for (Offset = 0; Offset < 16; Offset++) {
+      //
+      // Fill the buffers past the Null-terminators, so that the functions
+      // cannot stop early on a zero that follows the strings.
+      //
+      SetMem (mAsciiString, sizeof (mAsciiString), 'x');
+      SetMem (mAsciiOther, sizeof (mAsciiOther), 'x');
+      SetMem16 (mUnicodeString, sizeof (mUnicodeString), L'x');
+      SetMem16 (mUnicodeOther, sizeof (mUnicodeOther), L'x');
+
+      Ascii        = mAsciiString + Offset;
+      AsciiOther   = mAsciiOther + (Offset * 7) % 16;
+      Unicode      = mUnicodeString + Offset;
+      UnicodeOther = mUnicodeOther + (Offset * 7) % 16;
+      for (Index = 0; Index < Length; Index++) {
+        Ascii[Index]        = (CHAR8)('a' + Index % 26);
+        AsciiOther[Index]   = Ascii[Index];
+        Unicode[Index]      = (CHAR16)(0x3000 + Index);
+        UnicodeOther[Index] = Unicode[Index];
+      }
+
+      Ascii[Length]        = '\0';
+      AsciiOther[Length]   = '\0';
+      Unicode[Length]      = L'\0';
+      UnicodeOther[Length] = L'\0';
+
+      UT_ASSERT_EQUAL (AsciiStrLen (Ascii), Length);
+      UT_ASSERT_EQUAL (StrLen (Unicode), Length);
+      UT_ASSERT_EQUAL (AsciiStrnLenS (Ascii, Length / 2 + 1), MIN (Length, Length / 2 + 1));
+      UT_ASSERT_EQUAL (StrnLenS (Unicode, Length / 2 + 1), MIN (Length, Length / 2 + 1));
+      UT_ASSERT_EQUAL (AsciiStrnLenS (Ascii, Length + 1), Length);
+      UT_ASSERT_EQUAL (StrnLenS (Unicode, Length + 1), Length);
+
+      UT_ASSERT_EQUAL (AsciiStrCmp (Ascii, AsciiOther), 0);
+      UT_ASSERT_EQUAL (StrCmp (Unicode, UnicodeOther), 0);
+      if (Length == 0) {
+        UT_ASSERT_TRUE (AsciiStrStr (Ascii, "a") == NULL);
+        UT_ASSERT_TRUE (StrStr (Unicode, L"a") == NULL);
+        continue;
+      }
+
+      //
+      // The search strings are the last characters of the strings.
+      //
+      Index = Length - MIN (Length, 3);
+      UT_ASSERT_TRUE (AsciiStrStr (Ascii, AsciiOther + Index) == Ascii + Index);
+      UT_ASSERT_TRUE (StrStr (Unicode, UnicodeOther + Index) == Unicode + Index);
+
+      //
+      // Make the strings differ at their last character.
+      //
+      AsciiOther[Length - 1]   = 'A';
+      UnicodeOther[Length - 1] = 0x2000;
+      UT_ASSERT_EQUAL (AsciiStrCmp (Ascii, AsciiOther), Ascii[Length - 1] - 'A');
+      UT_ASSERT_EQUAL (AsciiStrCmp (AsciiOther, Ascii), 'A' - Ascii[Length - 1]);
+      UT_ASSERT_EQUAL (StrCmp (Unicode, UnicodeOther), Unicode[Length - 1] - 0x2000);
+      UT_ASSERT_EQUAL (StrCmp (UnicodeOther, Unicode), 0x2000 - Unicode[Length - 1]);
+      UT_ASSERT_TRUE (AsciiStrStr (Ascii, AsciiOther + Index) == NULL);
+      UT_ASSERT_TRUE (StrStr (Unicode, UnicodeOther + Index) == NULL);
+
+      //
+      // A shorter string differs at its Null-terminator.
+      //
+      AsciiOther[Length - 1]   = '\0';
+      UnicodeOther[Length - 1] = L'\0';
+      UT_ASSERT_EQUAL (AsciiStrCmp (Ascii, AsciiOther), Ascii[Length - 1]);
+      UT_ASSERT_EQUAL (StrCmp (Unicode, UnicodeOther), Unicode[Length - 1]);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+#define CRC_TEST_MAX_LENGTH  1100
+
+///
+/// The data of the CRC tests, with room for every alignment of their start.
+///
+STATIC UINT8  mCrcData[CRC_TEST_MAX_LENGTH + 8];
+
+/**
+  Reference bitwise update of a reflected 32-bit CRC.
+
+  @param[in]  Polynomial   The reflected polynomial.
+  @param[in]  Crc          The CRC of the preceding data, not inverted.
+  @param[in]  Buffer       A pointer to the data.
+  @param[in]  Length       The number of bytes in the buffer.
+
+  @return The CRC updated with the data, not inverted.
+**/
+STATIC
+UINT32
+ReferenceCrc32Update (
+  IN UINT32       Polynomial,
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINTN  Bit;
+
+  while (Length-- != 0) {
+    Crc ^= *Buffer++;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (Polynomial & (0 - (Crc & 1)));
+    }
+  }
+
+  return Crc;
+}
+
+/**
+  Check CalculateCrc32() and CalculateCrc32c() against the bitwise reference,
+  for every length up to CRC_TEST_MAX_LENGTH and every alignment of the data,
+  across the lengths where the processor instructions are used.
+
+  @param[in]  Context   Not used.
+
+  @retval  UNIT_TEST_PASSED             All the checks passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A function returned a wrong value.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CrcTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Length;
+  UINTN  Offset;
+  UINTN  Index;
+
+  for (Index = 0; Index < sizeof (mCrcData); Index++) {
+    mCrcData[Index] = (UINT8)(Index * 167 + (Index >> 8));
+  }
+
+  UT_ASSERT_EQUAL (CalculateCrc32 ("123456789", 9), 0xCBF43926);
+  UT_ASSERT_EQUAL (CalculateCrc32c ("123456789", 9, 0), 0xE3069283);
+
+  for (Length = 0; Length <= CRC_TEST_MAX_LENGTH; Length++) {
+    for (Offset = 0; Offset < 8; Offset++) {
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (mCrcData + Offset, Length),
+        ReferenceCrc32Update (0xEDB88320, 0xFFFFFFFF, mCrcData + Offset, Length) ^ 0xFFFFFFFF
+        );
+      UT_ASSERT_EQUAL (
+        CalculateCrc32c (mCrcData + Offset, Length, 0x12345678),
+        ReferenceCrc32Update (0x82F63B78, ~(UINT32)0x12345678, mCrcData + Offset, Length) ^ 0xFFFFFFFF
+        );
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialze the unit test framework, suite, and unit tests for the
   Base64 conversion APIs of BaseLib and run the unit tests.
@@ -409,6 +601,7 @@ UnitTestingEntry (
   UNIT_TEST_SUITE_HANDLE      b64EncodeTests;
   UNIT_TEST_SUITE_HANDLE      b64DecodeTests;
   UNIT_TEST_SUITE_HANDLE      SafeStringTests;
+  UNIT_TEST_SUITE_HANDLE      CrcTests;
 
   Fw = NULL;
 
@@ -479,6 +672,16 @@ UnitTestingEntry (
 
   // --------------Suite-----------Description--------------Class Name----------Function--------Pre---Post-------------------Context-----------
   AddTestCase (SafeStringTests, "SAFE_STRING_CONSTRAINT_CHECK", "SafeStringContraintCheckTest", SafeStringContraintCheckTest, NULL, NULL, NULL);
+  AddTestCase (SafeStringTests, "String length, compare and search", "StringPrimitivesTest", StringPrimitivesTest, NULL, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&CrcTests, Fw, "CRC32 and CRC32c", "BaseLib.Crc", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CrcTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (CrcTests, "CalculateCrc32() and CalculateCrc32c()", "CrcTest", CrcTest, NULL, NULL, NULL);
 
   //
   // Execute the tests.
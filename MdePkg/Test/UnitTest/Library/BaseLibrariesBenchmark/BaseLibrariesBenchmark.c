@@ -0,0 +1,995 @@
+/** @file
+  Host-based benchmarks of the hot functions of the MdePkg base libraries:
+  BaseMemoryLib, the string functions, CalculateCrc32() and CalculateCrc32c()
+  of BaseLib, BasePrintLib and SafeIntLib.
+
+  The module is built once per BaseMemoryLib instance, and the memory
+  benchmarks run across buffer sizes and alignments, so that the instances can
+  be compared on the same host. A memory, string or CRC benchmark of a large
+  buffer fails when the library is slower than a simple C loop, measured in the
+  same run, by more than BENCHMARK_REGRESSION_PERCENT.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BenchmarkLib.h>
+
+#define UNIT_TEST_NAME     "Base Libraries Benchmark"
+#define UNIT_TEST_VERSION  "1.0"
+
+///
+/// The BaseMemoryLib instance the module is built with, set by the DSC.
+///
+#ifndef BASE_MEMORY_LIB_VARIANT
+#define BASE_MEMORY_LIB_VARIANT  0
+#endif
+
+///
+/// The time of a library function on a large buffer may be at most this
+/// percentage of the time of the reference C loop.
+///
+#ifndef BENCHMARK_REGRESSION_PERCENT
+#define BENCHMARK_REGRESSION_PERCENT  150
+#endif
+
+///
+/// The regression threshold applies from this buffer size, below it the time
+/// of the calls hides the throughput.
+///
+#define BENCHMARK_REGRESSION_MIN_SIZE  SIZE_4KB
+
+#define BENCHMARK_MAX_SIZE   SIZE_4MB
+#define BENCHMARK_ALIGNMENT  64
+
+typedef struct {
+  UINTN    Size;
+  UINT8    *Source;
+  UINT8    *Destination;
+} BENCHMARK_BUFFERS;
+
+typedef struct {
+  CONST CHAR8    *Name;
+  UINTN          SourceOffset;
+  UINTN          DestinationOffset;
+} BENCHMARK_ALIGNMENT_CASE;
+
+STATIC CONST CHAR8  *mBaseMemoryLibVariants[] = {
+  "BaseMemoryLib",
+  "BaseMemoryLibOptDxe",
+  "BaseMemoryLibRepStr",
+  "BaseMemoryLibSse2"
+};
+
+///
+/// The largest size is above the cache size from which the X64 memory kernels
+/// of BaseMemoryLibOptDxe switch to non-temporal stores.
+///
+STATIC CONST UINTN  mSizes[] = {
+  16,
+  256,
+  SIZE_4KB,
+  SIZE_64KB,
+  SIZE_4MB
+};
+
+STATIC CONST BENCHMARK_ALIGNMENT_CASE  mAlignments[] = {
+  { "aligned",    0, 0 },
+  { "misaligned", 1, 3 }
+};
+
+STATIC BENCHMARK_OPTIONS  mOptions = {
+  2,      // WarmUpSamples
+  15,     // Samples
+  200000  // SampleTime, 200 us
+};
+
+STATIC UINT8              *mSourcePool;
+STATIC UINT8              *mDestinationPool;
+STATIC BENCHMARK_BUFFERS  mBuffers;
+STATIC volatile UINTN     mSink;
+
+/**
+  CopyMem() of the benchmark buffers.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchCopyMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  CopyMem (Buffers->Destination, Buffers->Source, Buffers->Size);
+}
+
+/**
+  Reference byte copy of the benchmark buffers.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefCopyMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    Buffers->Destination[Index] = Buffers->Source[Index];
+  }
+}
+
+/**
+  SetMem() of the destination buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchSetMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  SetMem (Buffers->Destination, Buffers->Size, 0xA5);
+}
+
+/**
+  Reference byte fill of the destination buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefSetMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    Buffers->Destination[Index] = 0xA5;
+  }
+}
+
+/**
+  ZeroMem() of the destination buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchZeroMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  ZeroMem (Buffers->Destination, Buffers->Size);
+}
+
+/**
+  Reference byte clear of the destination buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefZeroMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    Buffers->Destination[Index] = 0;
+  }
+}
+
+/**
+  CompareMem() of two equal buffers.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchCompareMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = (UINTN)CompareMem (Buffers->Destination, Buffers->Source, Buffers->Size);
+}
+
+/**
+  Reference byte compare of two equal buffers.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefCompareMem (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    if (Buffers->Destination[Index] != Buffers->Source[Index]) {
+      break;
+    }
+  }
+
+  mSink = Index;
+}
+
+/**
+  ScanMem8() of the source buffer, for a value that is only in its last byte.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchScanMem8 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = (UINTN)ScanMem8 (Buffers->Source, Buffers->Size, 0xC3);
+}
+
+/**
+  Reference byte scan of the source buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefScanMem8 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    if (Buffers->Source[Index] == 0xC3) {
+      break;
+    }
+  }
+
+  mSink = Index;
+}
+
+/**
+  AsciiStrLen() of the source buffer, filled as a string.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchAsciiStrLen (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = AsciiStrLen ((CHAR8 *)Buffers->Source);
+}
+
+/**
+  Reference length of the source buffer, filled as a string.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefAsciiStrLen (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Buffers->Source[Index] != '\0'; Index++) {
+  }
+
+  mSink = Index;
+}
+
+/**
+  StrLen() of the source buffer, filled as a string.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchStrLen (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = StrLen ((CHAR16 *)Buffers->Source);
+}
+
+/**
+  Reference length of the source buffer, filled as a string.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefStrLen (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  CHAR16             *String;
+  UINTN              Index;
+
+  Buffers = Context;
+  String  = (CHAR16 *)Buffers->Source;
+  for (Index = 0; String[Index] != L'\0'; Index++) {
+  }
+
+  mSink = Index;
+}
+
+/**
+  AsciiStrCmp() of two equal strings.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchAsciiStrCmp (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = (UINTN)AsciiStrCmp ((CHAR8 *)Buffers->Destination, (CHAR8 *)Buffers->Source);
+}
+
+/**
+  Reference compare of two equal strings.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefAsciiStrCmp (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Index;
+
+  Buffers = Context;
+  for (Index = 0; Buffers->Source[Index] != '\0'; Index++) {
+    if (Buffers->Destination[Index] != Buffers->Source[Index]) {
+      break;
+    }
+  }
+
+  mSink = Index;
+}
+
+/**
+  CalculateCrc32() of the source buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchCalculateCrc32 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = CalculateCrc32 (Buffers->Source, Buffers->Size);
+}
+
+/**
+  Reference bitwise CRC32 of the source buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefCalculateCrc32 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINT32             Crc;
+  UINTN              Index;
+  UINTN              Bit;
+
+  Buffers = Context;
+  Crc     = 0xFFFFFFFF;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    Crc ^= Buffers->Source[Index];
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (0xEDB88320 & (0 - (Crc & 1)));
+    }
+  }
+
+  mSink = Crc ^ 0xFFFFFFFF;
+}
+
+/**
+  CalculateCrc32c() of the source buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchCalculateCrc32c (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = CalculateCrc32c (Buffers->Source, Buffers->Size, 0);
+}
+
+/**
+  Reference bitwise CRC32c of the source buffer.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+RefCalculateCrc32c (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINT32             Crc;
+  UINTN              Index;
+  UINTN              Bit;
+
+  Buffers = Context;
+  Crc     = 0xFFFFFFFF;
+  for (Index = 0; Index < Buffers->Size; Index++) {
+    Crc ^= Buffers->Source[Index];
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ (0x82F63B78 & (0 - (Crc & 1)));
+    }
+  }
+
+  mSink = Crc ^ 0xFFFFFFFF;
+}
+
+/**
+  AsciiSPrint() of a typical DEBUG() message.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchAsciiSPrint (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+
+  Buffers = Context;
+  mSink   = AsciiSPrint (
+              (CHAR8 *)Buffers->Destination,
+              Buffers->Size,
+              "%a: Buffer 0x%p Size 0x%lx Index %d - %r\n",
+              "Benchmark",
+              Buffers->Source,
+              (UINT64)Buffers->Size,
+              (INT32)-42,
+              EFI_NOT_FOUND
+              );
+}
+
+/**
+  SafeIntLib arithmetic of a size computation, as done when parsing a table.
+
+  @param[in]  Context   The benchmark buffers.
+
+**/
+STATIC
+VOID
+EFIAPI
+BenchSafeIntLib (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFERS  *Buffers;
+  UINTN              Total;
+  UINTN              Entry;
+  UINT32             Count;
+
+  Buffers = Context;
+  SafeUintnMult (Buffers->Size, 24, &Entry);
+  SafeUintnAdd (Entry, sizeof (EFI_GUID), &Total);
+  SafeUint64ToUint32 ((UINT64)Total, &Count);
+  SafeUint32Sub (Count, 16, &Count);
+  mSink = Count;
+}
+
+/**
+  Point the benchmark buffers at a size and alignment, and fill them.
+
+  @param[in]  Size        The size of the buffers.
+  @param[in]  Alignment   The offsets of the buffers from a 64-byte boundary.
+
+**/
+STATIC
+VOID
+BenchmarkSetBuffers (
+  IN UINTN                           Size,
+  IN CONST BENCHMARK_ALIGNMENT_CASE  *Alignment
+  )
+{
+  UINTN  Index;
+
+  mBuffers.Size        = Size;
+  mBuffers.Source      = ALIGN_POINTER (mSourcePool, BENCHMARK_ALIGNMENT) + Alignment->SourceOffset;
+  mBuffers.Destination = ALIGN_POINTER (mDestinationPool, BENCHMARK_ALIGNMENT) + Alignment->DestinationOffset;
+
+  //
+  // Printable bytes, that are also valid ASCII and UCS-2 characters. The
+  // strings end at the last aligned CHAR16, and the last byte is the value
+  // that ScanMem8() looks for.
+  //
+  for (Index = 0; Index < Size; Index++) {
+    mBuffers.Source[Index] = (UINT8)(0x20 + (Index % 0x5F));
+  }
+
+  mBuffers.Source[Size - 4] = 0;
+  mBuffers.Source[Size - 3] = 0;
+  mBuffers.Source[Size - 1] = 0xC3;
+  CopyMem (mBuffers.Destination, mBuffers.Source, Size);
+}
+
+/**
+  Benchmark a function across the buffer sizes and alignments, and for large
+  buffers check it against the reference C loop.
+
+  @param[in]  Name            The name of the function.
+  @param[in]  Function        The benchmark of the library function.
+  @param[in]  Reference       The benchmark of the reference C loop, NULL if
+                              none.
+  @param[in]  EachAlignment   TRUE to run each buffer alignment, FALSE for the
+                              aligned buffers only.
+
+  @retval  UNIT_TEST_PASSED             The library function is not slower
+                                        than the threshold.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A benchmark failed to run, or the
+                                        library function is slower.
+**/
+STATIC
+UNIT_TEST_STATUS
+BenchmarkAcrossBuffers (
+  IN CONST CHAR8         *Name,
+  IN BENCHMARK_FUNCTION  Function,
+  IN BENCHMARK_FUNCTION  Reference  OPTIONAL,
+  IN BOOLEAN             EachAlignment
+  )
+{
+  CHAR8             BenchmarkName[80];
+  BENCHMARK_RESULT  Result;
+  BENCHMARK_RESULT  ReferenceResult;
+  UINTN             SizeIndex;
+  UINTN             AlignmentIndex;
+
+  for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (mSizes); SizeIndex++) {
+    for (AlignmentIndex = 0; AlignmentIndex < (EachAlignment ? ARRAY_SIZE (mAlignments) : 1); AlignmentIndex++) {
+      BenchmarkSetBuffers (mSizes[SizeIndex], &mAlignments[AlignmentIndex]);
+      AsciiSPrint (BenchmarkName, sizeof (BenchmarkName), "%a/%u/%a", Name, (UINT32)mSizes[SizeIndex], mAlignments[AlignmentIndex].Name);
+      UT_ASSERT_NOT_EFI_ERROR (RunBenchmark (BenchmarkName, Function, &mBuffers, &mOptions, &Result));
+      UT_LOG_INFO (
+        "THROUGHPUT {\"name\":\"%a\",\"bytes\":%u,\"mb_per_s\":%lu}\n",
+        BenchmarkName,
+        (UINT32)mSizes[SizeIndex],
+        DivU64x64Remainder (MultU64x32 (mSizes[SizeIndex], 1000000), MAX (Result.Median, 1), NULL)
+        );
+
+      if ((Reference == NULL) || (mSizes[SizeIndex] < BENCHMARK_REGRESSION_MIN_SIZE)) {
+        continue;
+      }
+
+      AsciiSPrint (BenchmarkName, sizeof (BenchmarkName), "Reference%a/%u/%a", Name, (UINT32)mSizes[SizeIndex], mAlignments[AlignmentIndex].Name);
+      UT_ASSERT_NOT_EFI_ERROR (RunBenchmark (BenchmarkName, Reference, &mBuffers, &mOptions, &ReferenceResult));
+      if (MultU64x32 (Result.Median, 100) > MultU64x32 (ReferenceResult.Median, BENCHMARK_REGRESSION_PERCENT)) {
+        UT_LOG_ERROR (
+          "%a/%u/%a takes %lu ps, more than %u%% of the %lu ps of the reference\n",
+          Name,
+          (UINT32)mSizes[SizeIndex],
+          mAlignments[AlignmentIndex].Name,
+          Result.Median,
+          BENCHMARK_REGRESSION_PERCENT,
+          ReferenceResult.Median
+          );
+        UT_ASSERT_TRUE (MultU64x32 (Result.Median, 100) <= MultU64x32 (ReferenceResult.Median, BENCHMARK_REGRESSION_PERCENT));
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Benchmark CopyMem().
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCopyMem (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkAcrossBuffers ("CopyMem", BenchCopyMem, RefCopyMem, TRUE);
+}
+
+/**
+  Benchmark SetMem().
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkSetMem (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkAcrossBuffers ("SetMem", BenchSetMem, RefSetMem, TRUE);
+}
+
+/**
+  Benchmark ZeroMem().
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkZeroMem (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkAcrossBuffers ("ZeroMem", BenchZeroMem, RefZeroMem, TRUE);
+}
+
+/**
+  Benchmark CompareMem().
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCompareMem (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkAcrossBuffers ("CompareMem", BenchCompareMem, RefCompareMem, TRUE);
+}
+
+/**
+  Benchmark ScanMem8().
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkScanMem8 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BenchmarkAcrossBuffers ("ScanMem8", BenchScanMem8, RefScanMem8, TRUE);
+}
+
+/**
+  Benchmark the string functions of BaseLib.
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkStrings (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+
+  Status = BenchmarkAcrossBuffers ("AsciiStrLen", BenchAsciiStrLen, RefAsciiStrLen, FALSE);
+  if (Status == UNIT_TEST_PASSED) {
+    Status = BenchmarkAcrossBuffers ("StrLen", BenchStrLen, RefStrLen, FALSE);
+  }
+
+  if (Status == UNIT_TEST_PASSED) {
+    Status = BenchmarkAcrossBuffers ("AsciiStrCmp", BenchAsciiStrCmp, RefAsciiStrCmp, FALSE);
+  }
+
+  return Status;
+}
+
+/**
+  Benchmark CalculateCrc32(), and check it against the reference.
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCalculateCrc32 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Crc;
+
+  BenchmarkSetBuffers (SIZE_4KB, &mAlignments[0]);
+  BenchCalculateCrc32 (&mBuffers);
+  Crc = mSink;
+  RefCalculateCrc32 (&mBuffers);
+  UT_ASSERT_EQUAL (Crc, mSink);
+
+  return BenchmarkAcrossBuffers ("CalculateCrc32", BenchCalculateCrc32, RefCalculateCrc32, FALSE);
+}
+
+/**
+  Benchmark CalculateCrc32c(), and check it against the reference.
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCalculateCrc32c (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Crc;
+
+  BenchmarkSetBuffers (SIZE_4KB, &mAlignments[0]);
+  BenchCalculateCrc32c (&mBuffers);
+  Crc = mSink;
+  RefCalculateCrc32c (&mBuffers);
+  UT_ASSERT_EQUAL (Crc, mSink);
+
+  return BenchmarkAcrossBuffers ("CalculateCrc32c", BenchCalculateCrc32c, RefCalculateCrc32c, FALSE);
+}
+
+/**
+  Benchmark AsciiSPrint() of BasePrintLib.
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAsciiSPrint (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BenchmarkSetBuffers (256, &mAlignments[0]);
+  UT_ASSERT_NOT_EFI_ERROR (RunBenchmark ("AsciiSPrint", BenchAsciiSPrint, &mBuffers, &mOptions, NULL));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Benchmark SafeIntLib.
+
+  @param[in]  Context    Not used.
+
+  @retval  UNIT_TEST_PASSED             The benchmark passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkSafeIntLib (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BenchmarkSetBuffers (256, &mAlignments[0]);
+  UT_ASSERT_NOT_EFI_ERROR (RunBenchmark ("SafeIntLib", BenchSafeIntLib, &mBuffers, &mOptions, NULL));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suites, and benchmarks of the base
+  libraries and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MemoryBenchmarks;
+  UNIT_TEST_SUITE_HANDLE      BaseLibBenchmarks;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a with %a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION, mBaseMemoryLibVariants[BASE_MEMORY_LIB_VARIANT]));
+
+  mSourcePool      = AllocatePool (BENCHMARK_MAX_SIZE + 2 * BENCHMARK_ALIGNMENT);
+  mDestinationPool = AllocatePool (BENCHMARK_MAX_SIZE + 2 * BENCHMARK_ALIGNMENT);
+  if ((mSourcePool == NULL) || (mDestinationPool == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&MemoryBenchmarks, Framework, (CHAR8 *)mBaseMemoryLibVariants[BASE_MEMORY_LIB_VARIANT], "Benchmark.BaseMemoryLib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for MemoryBenchmarks\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (MemoryBenchmarks, "Benchmark CopyMem()", "CopyMem", BenchmarkCopyMem, NULL, NULL, NULL);
+  AddTestCase (MemoryBenchmarks, "Benchmark SetMem()", "SetMem", BenchmarkSetMem, NULL, NULL, NULL);
+  AddTestCase (MemoryBenchmarks, "Benchmark ZeroMem()", "ZeroMem", BenchmarkZeroMem, NULL, NULL, NULL);
+  AddTestCase (MemoryBenchmarks, "Benchmark CompareMem()", "CompareMem", BenchmarkCompareMem, NULL, NULL, NULL);
+  AddTestCase (MemoryBenchmarks, "Benchmark ScanMem8()", "ScanMem8", BenchmarkScanMem8, NULL, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&BaseLibBenchmarks, Framework, "BaseLib, BasePrintLib and SafeIntLib", "Benchmark.BaseLib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BaseLibBenchmarks\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (BaseLibBenchmarks, "Benchmark the string functions", "Strings", BenchmarkStrings, NULL, NULL, NULL);
+  AddTestCase (BaseLibBenchmarks, "Benchmark CalculateCrc32()", "CalculateCrc32", BenchmarkCalculateCrc32, NULL, NULL, NULL);
+  AddTestCase (BaseLibBenchmarks, "Benchmark CalculateCrc32c()", "CalculateCrc32c", BenchmarkCalculateCrc32c, NULL, NULL, NULL);
+  AddTestCase (BaseLibBenchmarks, "Benchmark AsciiSPrint()", "AsciiSPrint", BenchmarkAsciiSPrint, NULL, NULL, NULL);
+  AddTestCase (BaseLibBenchmarks, "Benchmark SafeIntLib", "SafeIntLib", BenchmarkSafeIntLib, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mSourcePool != NULL) {
+    FreePool (mSourcePool);
+  }
+
+  if (mDestinationPool != NULL) {
+    FreePool (mDestinationPool);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based benchmark execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -809,6 +809,10 @@ EfiDhcp4Start (
 
   DhcpSb->IoStatus = EFI_ALREADY_STARTED;
 
+  if (DhcpSb->DhcpState == Dhcp4Init) {
+    DhcpLoadCachedLease (DhcpSb);
+  }
+
   if (EFI_ERROR (Status = DhcpInitRequest (DhcpSb))) {
     goto ON_ERROR;
   }
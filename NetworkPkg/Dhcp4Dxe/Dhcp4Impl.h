@@ -22,9 +22,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/BaseLib.h>
 #include <Library/NetLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _DHCP_SERVICE   DHCP_SERVICE;
 typedef struct _DHCP_PROTOCOL  DHCP_PROTOCOL;
@@ -90,6 +92,7 @@ struct _DHCP_SERVICE {
   IP4_ADDR                        ClientAddr; // lease IP or configured client address
   IP4_ADDR                        Netmask;
   IP4_ADDR                        ServerAddr;
+  BOOLEAN                         CachedLease; // INIT-REBOOT with the lease cached in a variable
 
   EFI_DHCP4_PACKET                *LastOffer; // The last received offer
   EFI_DHCP4_PACKET                *Selected;
@@ -359,6 +359,145 @@ DhcpConfigLeaseIoPort (
   return EFI_SUCCESS;
 }
 
+/**
+  Read, update or delete the variable that keeps the last lease of the NIC.
+
+  The variable is named after the MAC address (and VLAN ID) of the NIC, and
+  holds the leased address in host byte order.
+
+  @param[in]       DhcpSb         The DHCP service instance.
+  @param[in]       Write          TRUE to write ClientAddr, FALSE to read it.
+  @param[in, out]  ClientAddr     The address to write, or the cached address.
+                                  Writing zero deletes the variable.
+
+  @retval EFI_SUCCESS             The variable is read or updated.
+  @retval Others                  No lease is cached, or the variable can't be
+                                  updated.
+
+**/
+STATIC
+EFI_STATUS
+DhcpAccessCachedLease (
+  IN     DHCP_SERVICE  *DhcpSb,
+  IN     BOOLEAN       Write,
+  IN OUT IP4_ADDR      *ClientAddr
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      *MacString;
+  IP4_ADDR    Cached;
+  UINTN       DataSize;
+
+  Status = NetLibGetMacString (DhcpSb->Controller, DhcpSb->Image, &MacString);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DataSize = sizeof (Cached);
+  Status   = gRT->GetVariable (MacString, &gEfiDhcp4ProtocolGuid, NULL, &DataSize, &Cached);
+  if (!EFI_ERROR (Status) && (DataSize != sizeof (Cached))) {
+    Status = EFI_NOT_FOUND;
+  }
+
+  if (!Write) {
+    if (!EFI_ERROR (Status)) {
+      *ClientAddr = Cached;
+    }
+  } else if (*ClientAddr == 0) {
+    //
+    // Forget the lease the server refused.
+    //
+    if (!EFI_ERROR (Status)) {
+      Status = gRT->SetVariable (MacString, &gEfiDhcp4ProtocolGuid, 0, 0, NULL);
+    }
+  } else if (EFI_ERROR (Status) || (Cached != *ClientAddr)) {
+    //
+    // Only write the flash when the lease changes.
+    //
+    Status = gRT->SetVariable (
+                    MacString,
+                    &gEfiDhcp4ProtocolGuid,
+                    EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                    sizeof (IP4_ADDR),
+                    ClientAddr
+                    );
+  }
+
+  FreePool (MacString);
+  return Status;
+}
+
+/**
+  Prepare an address acquisition in INIT-REBOOT state with the lease the NIC
+  had before, if the lease cache is enabled.
+
+  The cached lease is only used when the child doesn't handle the DHCP
+  events: a callback may need the offers (for example the boot file of the
+  PXE and HTTP boot clients), and no offer is received in INIT-REBOOT state.
+
+  @param[in, out]  DhcpSb         The DHCP service instance, in Dhcp4Init state.
+
+**/
+VOID
+DhcpLoadCachedLease (
+  IN OUT DHCP_SERVICE  *DhcpSb
+  )
+{
+  IP4_ADDR  ClientAddr;
+
+  ASSERT (DhcpSb->DhcpState == Dhcp4Init);
+
+  ClientAddr          = 0;
+  DhcpSb->CachedLease = FALSE;
+
+  if (!PcdGetBool (PcdDhcpCachedLease) || (DhcpSb->ActiveConfig.Dhcp4Callback != NULL)) {
+    return;
+  }
+
+  if (EFI_ERROR (DhcpAccessCachedLease (DhcpSb, FALSE, &ClientAddr)) || (ClientAddr == 0)) {
+    return;
+  }
+
+  DhcpSb->ClientAddr  = ClientAddr;
+  DhcpSb->DhcpState   = Dhcp4InitReboot;
+  DhcpSb->CachedLease = TRUE;
+  EFI_IP4 (DhcpSb->ActiveConfig.ClientAddress) = HTONL (ClientAddr);
+}
+
+/**
+  Give up the INIT-REBOOT started from the cached lease, and start a full
+  address acquisition.
+
+  @param[in, out]  DhcpSb         The DHCP service instance.
+  @param[in]       Forget         TRUE if the server refused the lease, it is
+                                  then removed from the cache.
+
+  @retval EFI_SUCCESS             The DHCPDISCOVER is sent.
+  @retval Others                  Failed to send the DHCPDISCOVER.
+
+**/
+STATIC
+EFI_STATUS
+DhcpDropCachedLease (
+  IN OUT DHCP_SERVICE  *DhcpSb,
+  IN     BOOLEAN       Forget
+  )
+{
+  IP4_ADDR  ClientAddr;
+
+  if (Forget) {
+    ClientAddr = 0;
+    DhcpAccessCachedLease (DhcpSb, TRUE, &ClientAddr);
+  }
+
+  DhcpSb->CachedLease = FALSE;
+  DhcpSb->ClientAddr  = 0;
+  DhcpSb->DhcpState   = Dhcp4Init;
+  ZeroMem (&DhcpSb->ActiveConfig.ClientAddress, sizeof (EFI_IPv4_ADDRESS));
+
+  return DhcpInitRequest (DhcpSb);
+}
+
 /**
   Update the lease states when a new lease is acquired. It will not only
   save the acquired the address and lease time, it will also create a UDP
@@ -409,8 +548,13 @@ DhcpLeaseAcquired (
 
   if (!DHCP_IS_BOOTP (DhcpSb->Para)) {
     DhcpComputeLease (DhcpSb, DhcpSb->Para);
+
+    if (PcdGetBool (PcdDhcpCachedLease)) {
+      DhcpAccessCachedLease (DhcpSb, TRUE, &DhcpSb->ClientAddr);
+    }
   }
 
+  DhcpSb->CachedLease = FALSE;
   return DhcpSetState (DhcpSb, Dhcp4Bound, TRUE);
 }
 
@@ -431,6 +575,8 @@ DhcpCleanLease (
   DhcpSb->Netmask    = 0;
   DhcpSb->ServerAddr = 0;
 
+  DhcpSb->CachedLease = FALSE;
+
   if (DhcpSb->LastOffer != NULL) {
     FreePool (DhcpSb->LastOffer);
     DhcpSb->LastOffer = NULL;
@@ -868,6 +1014,11 @@ DhcpHandleReboot (
   if (Para->DhcpType == DHCP_MSG_NAK) {
     DhcpCallUser (DhcpSb, Dhcp4RcvdNak, Packet, NULL);
 
+    if (DhcpSb->CachedLease) {
+      Status = DhcpDropCachedLease (DhcpSb, TRUE);
+      goto ON_EXIT;
+    }
+
     DhcpSb->ClientAddr = 0;
     DhcpSb->DhcpState  = Dhcp4Init;
 
@@ -1172,7 +1323,14 @@ DhcpSendMessage (
   Head->Xid       = HTONL (DhcpSb->Xid);
   Head->Reserved  = HTONS (0x8000);     // Server, broadcast the message please.
 
-  EFI_IP4 (Head->ClientAddr) = HTONL (DhcpSb->ClientAddr);
+  //
+  // The client doesn't own the address yet in INIT-REBOOT state, ciaddr must
+  // be zero (RFC 2131 section 4.3.2).
+  //
+  if (DhcpSb->DhcpState != Dhcp4Rebooting) {
+    EFI_IP4 (Head->ClientAddr) = HTONL (DhcpSb->ClientAddr);
+  }
+
   CopyMem (Head->ClientHwAddr, DhcpSb->Mac.Addr, DhcpSb->HwLen);
 
   if ((Type == DHCP_MSG_DECLINE) || (Type == DHCP_MSG_RELEASE)) {
@@ -1497,6 +1655,18 @@ DhcpOnTimerTick (
       }
     }
 
+    //
+    // The server of the cached lease may be gone, or the NIC moved to
+    // another network. Don't insist, run the full exchange instead.
+    //
+    if ((DhcpSb->DhcpState == Dhcp4Rebooting) && DhcpSb->CachedLease) {
+      if (EFI_ERROR (DhcpDropCachedLease (DhcpSb, FALSE))) {
+        goto END_SESSION;
+      }
+
+      goto ON_EXIT;
+    }
+
     if (++DhcpSb->CurRetry < DhcpSb->MaxRetries) {
       //
       // Still has another try
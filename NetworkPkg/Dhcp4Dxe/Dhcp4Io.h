@@ -155,6 +155,22 @@ DhcpInitRequest (
   IN DHCP_SERVICE  *DhcpSb
   );
 
+/**
+  Prepare an address acquisition in INIT-REBOOT state with the lease the NIC
+  had before, if the lease cache is enabled.
+
+  The cached lease is only used when the child doesn't handle the DHCP
+  events: a callback may need the offers (for example the boot file of the
+  PXE and HTTP boot clients), and no offer is received in INIT-REBOOT state.
+
+  @param[in, out]  DhcpSb         The DHCP service instance, in Dhcp4Init state.
+
+**/
+VOID
+DhcpLoadCachedLease (
+  IN OUT DHCP_SERVICE  *DhcpSb
+  );
+
 /**
   Clean up the DHCP related states, IoStatus isn't reset.
 
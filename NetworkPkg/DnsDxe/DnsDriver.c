@@ -343,16 +343,18 @@ DnsUnload (
 {
   EFI_STATUS  Status;
 
-  LIST_ENTRY      *Entry;
-  DNS4_CACHE      *ItemCache4;
-  DNS4_SERVER_IP  *ItemServerIp4;
-  DNS6_CACHE      *ItemCache6;
-  DNS6_SERVER_IP  *ItemServerIp6;
+  LIST_ENTRY          *Entry;
+  DNS4_CACHE          *ItemCache4;
+  DNS4_SERVER_IP      *ItemServerIp4;
+  DNS6_CACHE          *ItemCache6;
+  DNS6_SERVER_IP      *ItemServerIp6;
+  DNS_NEGATIVE_CACHE  *ItemNegative;
 
   ItemCache4    = NULL;
   ItemServerIp4 = NULL;
   ItemCache6    = NULL;
   ItemServerIp6 = NULL;
+  ItemNegative  = NULL;
 
   //
   // Disconnect the driver specified by ImageHandle
@@ -379,6 +381,14 @@ DnsUnload (
       FreePool (ItemCache4);
     }
 
+    while (!IsListEmpty (&mDriverData->Dns4NegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->Dns4NegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+
     while (!IsListEmpty (&mDriverData->Dns4ServerList)) {
       Entry = NetListRemoveHead (&mDriverData->Dns4ServerList);
       ASSERT (Entry != NULL);
@@ -395,6 +405,14 @@ DnsUnload (
       FreePool (ItemCache6);
     }
 
+    while (!IsListEmpty (&mDriverData->Dns6NegativeCacheList)) {
+      Entry = NetListRemoveHead (&mDriverData->Dns6NegativeCacheList);
+      ASSERT (Entry != NULL);
+      ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+
     while (!IsListEmpty (&mDriverData->Dns6ServerList)) {
       Entry = NetListRemoveHead (&mDriverData->Dns6ServerList);
       ASSERT (Entry != NULL);
@@ -489,8 +507,10 @@ DnsDriverEntryPoint (
   }
 
   InitializeListHead (&mDriverData->Dns4CacheList);
+  InitializeListHead (&mDriverData->Dns4NegativeCacheList);
   InitializeListHead (&mDriverData->Dns4ServerList);
   InitializeListHead (&mDriverData->Dns6CacheList);
+  InitializeListHead (&mDriverData->Dns6NegativeCacheList);
   InitializeListHead (&mDriverData->Dns6ServerList);
 
   return Status;
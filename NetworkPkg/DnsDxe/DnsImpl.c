@@ -941,6 +941,82 @@ UpdateDns6Cache (
   return EFI_SUCCESS;
 }
 
+/**
+  Record, or forget, the failure to resolve a host name in a negative cache.
+
+  @param  NegativeCacheList  The Dns4 or Dns6 negative cache list.
+  @param  HostName           The host name that was queried.
+  @param  Status             EFI_SUCCESS to remove the entry of HostName, or the
+                             status the failed lookup completed with.
+
+**/
+VOID
+UpdateDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName,
+  IN EFI_STATUS  Status
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+
+  Item = FindDnsNegativeCache (NegativeCacheList, HostName);
+  if (Status == EFI_SUCCESS) {
+    if (Item != NULL) {
+      RemoveEntryList (&Item->AllCacheLink);
+      FreePool (Item->HostName);
+      FreePool (Item);
+    }
+
+    return;
+  }
+
+  if (Item == NULL) {
+    Item = AllocateZeroPool (sizeof (DNS_NEGATIVE_CACHE));
+    if (Item == NULL) {
+      return;
+    }
+
+    Item->HostName = AllocateCopyPool (StrSize (HostName), HostName);
+    if (Item->HostName == NULL) {
+      FreePool (Item);
+      return;
+    }
+
+    InsertTailList (NegativeCacheList, &Item->AllCacheLink);
+  }
+
+  Item->Status  = Status;
+  Item->Timeout = DNS_NEGATIVE_CACHE_TIMEOUT;
+}
+
+/**
+  Find the failure recorded in a negative cache for a host name.
+
+  @param  NegativeCacheList  The Dns4 or Dns6 negative cache list.
+  @param  HostName           The host name to resolve.
+
+  @return The negative cache entry, or NULL if the host name is not in the cache.
+
+**/
+DNS_NEGATIVE_CACHE *
+FindDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName
+  )
+{
+  LIST_ENTRY          *Entry;
+  DNS_NEGATIVE_CACHE  *Item;
+
+  NET_LIST_FOR_EACH (Entry, NegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (StrCmp (HostName, Item->HostName) == 0) {
+      return Item;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -1157,12 +1233,14 @@ ParseDnsResponse (
 
   EFI_STATUS  Status;
   UINT32      RemainingLength;
+  BOOLEAN     Negative;
 
   EFI_TPL  OldTpl;
 
   Item           = NULL;
   Dns4TokenEntry = NULL;
   Dns6TokenEntry = NULL;
+  Negative       = FALSE;
 
   IpCount          = 0;
   RRCount          = 0;
@@ -1291,6 +1369,14 @@ ParseDnsResponse (
       Status = EFI_DEVICE_ERROR;
     }
 
+    //
+    // Remember that the name doesn't exist (NXDOMAIN), or has no record of
+    // the queried type (NODATA). Server failures are not cached.
+    //
+    Negative = (BOOLEAN)((DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE) &&
+                         ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) ||
+                          ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NO_ERROR) && (DnsHeader->AnswersNum == 0))));
+
     goto ON_COMPLETE;
   }
 
@@ -1537,7 +1623,12 @@ ParseDnsResponse (
             Dns4CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
           }
 
-          UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+          //
+          // A TTL of zero means the record must not be cached (RFC 1035).
+          //
+          if (Dns4CacheEntry->Timeout != 0) {
+            UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+          }
 
           //
           // Free allocated CacheEntry pool.
@@ -1599,7 +1690,12 @@ ParseDnsResponse (
             Dns6CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
           }
 
-          UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+          //
+          // A TTL of zero means the record must not be cached (RFC 1035).
+          //
+          if (Dns6CacheEntry->Timeout != 0) {
+            UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+          }
 
           //
           // Free allocated CacheEntry pool.
@@ -1675,6 +1771,10 @@ ON_COMPLETE:
 
   if (Instance->Service->IpVersion == IP_VERSION_4) {
     ASSERT (Dns4TokenEntry != NULL);
+    if (!Dns4TokenEntry->GeneralLookUp && (Negative || !EFI_ERROR (Status))) {
+      UpdateDnsNegativeCache (&mDriverData->Dns4NegativeCacheList, Dns4TokenEntry->QueryHostName, Status);
+    }
+
     Dns4RemoveTokenEntry (&Instance->Dns4TxTokens, Dns4TokenEntry);
     Dns4TokenEntry->Token->Status = Status;
     if (Dns4TokenEntry->Token->Event != NULL) {
@@ -1683,6 +1783,10 @@ ON_COMPLETE:
     }
   } else {
     ASSERT (Dns6TokenEntry != NULL);
+    if (!Dns6TokenEntry->GeneralLookUp && (Negative || !EFI_ERROR (Status))) {
+      UpdateDnsNegativeCache (&mDriverData->Dns6NegativeCacheList, Dns6TokenEntry->QueryHostName, Status);
+    }
+
     Dns6RemoveTokenEntry (&Instance->Dns6TxTokens, Dns6TokenEntry);
     Dns6TokenEntry->Token->Status = Status;
     if (Dns6TokenEntry->Token->Event != NULL) {
@@ -2212,10 +2316,11 @@ DnsOnTimerUpdate (
   IN VOID       *Context
   )
 {
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
-  DNS4_CACHE  *Item4;
-  DNS6_CACHE  *Item6;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
+  DNS4_CACHE          *Item4;
+  DNS6_CACHE          *Item6;
+  DNS_NEGATIVE_CACHE  *ItemNegative;
 
   Item4 = NULL;
   Item6 = NULL;
@@ -2242,6 +2347,15 @@ DnsOnTimerUpdate (
     }
   }
 
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns4NegativeCacheList) {
+    ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (--ItemNegative->Timeout == 0) {
+      RemoveEntryList (&ItemNegative->AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+  }
+
   //
   // Iterate through all the DNS6 cache list.
   //
@@ -2263,4 +2377,13 @@ DnsOnTimerUpdate (
       Entry = Entry->ForwardLink;
     }
   }
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns6NegativeCacheList) {
+    ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (--ItemNegative->Timeout == 0) {
+      RemoveEntryList (&ItemNegative->AllCacheLink);
+      FreePool (ItemNegative->HostName);
+      FreePool (ItemNegative);
+    }
+  }
 }
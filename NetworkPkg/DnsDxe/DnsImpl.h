@@ -83,6 +83,11 @@ extern EFI_DNS6_PROTOCOL             mDns6Protocol;
 
 #define DNS_TIME_TO_GETMAP  5
 
+//
+// Seconds a failed host name lookup is remembered (RFC 2308 negative caching).
+//
+#define DNS_NEGATIVE_CACHE_TIMEOUT  30
+
 #pragma pack(1)
 
 typedef union _DNS_FLAGS DNS_FLAGS;
@@ -97,6 +102,13 @@ typedef struct {
   EFI_DNS6_CACHE_ENTRY    DnsCache;
 } DNS6_CACHE;
 
+typedef struct {
+  LIST_ENTRY    AllCacheLink;
+  CHAR16        *HostName;
+  EFI_STATUS    Status;                 /// The status the failed lookup completed with.
+  UINT32        Timeout;
+} DNS_NEGATIVE_CACHE;
+
 typedef struct {
   LIST_ENTRY          AllServerLink;
   EFI_IPv4_ADDRESS    Dns4ServerIp;
@@ -515,6 +527,37 @@ UpdateDns6Cache (
   IN EFI_DNS6_CACHE_ENTRY  DnsCacheEntry
   );
 
+/**
+  Record, or forget, the failure to resolve a host name in a negative cache.
+
+  @param  NegativeCacheList  The Dns4 or Dns6 negative cache list.
+  @param  HostName           The host name that was queried.
+  @param  Status             EFI_SUCCESS to remove the entry of HostName, or the
+                             status the failed lookup completed with.
+
+**/
+VOID
+UpdateDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName,
+  IN EFI_STATUS  Status
+  );
+
+/**
+  Find the failure recorded in a negative cache for a host name.
+
+  @param  NegativeCacheList  The Dns4 or Dns6 negative cache list.
+  @param  HostName           The host name to resolve.
+
+  @return The negative cache entry, or NULL if the host name is not in the cache.
+
+**/
+DNS_NEGATIVE_CACHE *
+FindDnsNegativeCache (
+  IN LIST_ENTRY  *NegativeCacheList,
+  IN CHAR16      *HostName
+  );
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
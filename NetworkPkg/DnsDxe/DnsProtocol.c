@@ -342,10 +342,11 @@ Dns4HostNameToIp (
 
   EFI_DNS4_CONFIG_DATA  *ConfigData;
 
-  UINTN       Index;
-  DNS4_CACHE  *Item;
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
+  UINTN               Index;
+  DNS4_CACHE          *Item;
+  DNS_NEGATIVE_CACHE  *NegativeItem;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
 
   CHAR8  *QueryName;
 
@@ -452,6 +453,24 @@ Dns4HostNameToIp (
     }
   }
 
+  //
+  // Check the failed lookups the DNS server answered recently.
+  //
+  if (ConfigData->EnableDnsCache) {
+    NegativeItem = FindDnsNegativeCache (&mDriverData->Dns4NegativeCacheList, HostName);
+    if (NegativeItem != NULL) {
+      Token->Status = NegativeItem->Status;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
+  }
+
   //
   // Construct DNS TokenEntry.
   //
@@ -1188,10 +1207,11 @@ Dns6HostNameToIp (
 
   EFI_DNS6_CONFIG_DATA  *ConfigData;
 
-  UINTN       Index;
-  DNS6_CACHE  *Item;
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
+  UINTN               Index;
+  DNS6_CACHE          *Item;
+  DNS_NEGATIVE_CACHE  *NegativeItem;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
 
   CHAR8  *QueryName;
 
@@ -1298,6 +1318,24 @@ Dns6HostNameToIp (
     }
   }
 
+  //
+  // Check the failed lookups the DNS server answered recently.
+  //
+  if (ConfigData->EnableDnsCache) {
+    NegativeItem = FindDnsNegativeCache (&mDriverData->Dns6NegativeCacheList, HostName);
+    if (NegativeItem != NULL) {
+      Token->Status = NegativeItem->Status;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      Status = EFI_SUCCESS;
+      goto ON_EXIT;
+    }
+  }
+
   //
   // Construct DNS TokenEntry.
   //
@@ -34,19 +34,47 @@ UINTN  mDpcQueueDepth    = 0;
 UINTN  mMaxDpcQueueDepth = 0;
 
 //
-// Free list of DPC entries.  As DPCs are queued, entries are removed from this
-// free list.  As DPC entries are dispatched, DPC entries are added to the free list.
-// If the free list is empty and a DPC is queued, the free list is grown by allocating
-// an additional set of DPC entries.
+// An array of DPC queues.  A DPC queue is allocated for every level EFI_TPL value.
+// As DPCs are queued, they are added to the tail of the ring buffer.
+// As DPCs are dispatched, they are removed from the head of the ring buffer.
 //
-LIST_ENTRY  mDpcEntryFreeList = INITIALIZE_LIST_HEAD_VARIABLE (mDpcEntryFreeList);
+DPC_QUEUE  mDpcQueue[TPL_HIGH_LEVEL + 1];
 
 //
-// An array of DPC queues.  A DPC queue is allocated for every level EFI_TPL value.
-// As DPCs are queued, they are added to the end of the linked list.
-// As DPCs are dispatched, they are removed from the beginning of the linked list.
+// The number of entries of the ring buffer of each DPC queue.
+//
+UINT32  mDpcQueueSize = 0;
+
+//
+// The range of the performance counter, used to measure the DPC latency.
 //
-LIST_ENTRY  mDpcQueue[TPL_HIGH_LEVEL + 1];
+UINT64  mDpcCounterStart = 0;
+UINT64  mDpcCounterEnd   = 0;
+
+/**
+  Compute the number of performance counter ticks between two counter values.
+
+  @param  Start  The counter value at the beginning of the interval.
+  @param  End    The counter value at the end of the interval.
+
+  @return The number of ticks from Start to End.
+
+**/
+UINT64
+DpcElapsedTime (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  if (mDpcCounterStart > mDpcCounterEnd) {
+    //
+    // The counter counts down.
+    //
+    return (Start >= End) ? (Start - End) : (Start - mDpcCounterEnd) + (mDpcCounterStart - End);
+  }
+
+  return (End >= Start) ? (End - Start) : (mDpcCounterEnd - Start) + (End - mDpcCounterStart);
+}
 
 /**
   Add a Deferred Procedure Call to the end of the DPC queue.
@@ -75,8 +103,9 @@ DpcQueueDpc (
 {
   EFI_STATUS  ReturnStatus;
   EFI_TPL     OriginalTpl;
+  DPC_QUEUE   *Queue;
   DPC_ENTRY   *DpcEntry;
-  UINTN       Index;
+  UINT32      Index;
 
   //
   // Make sure DpcTpl is valid
@@ -96,84 +125,45 @@ DpcQueueDpc (
   // Assume this function will succeed
   //
   ReturnStatus = EFI_SUCCESS;
+  Queue        = &mDpcQueue[DpcTpl];
 
   //
-  // Raise the TPL level to TPL_HIGH_LEVEL for DPC list operation and save the
+  // Raise the TPL level to TPL_HIGH_LEVEL for DPC queue operation and save the
   // current TPL value so it can be restored when this function returns.
   //
   OriginalTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
 
   //
-  // Check to see if there are any entries in the DPC free list
+  // The ring buffer doesn't grow: growing it would need a memory allocation,
+  // which can't be done above TPL_NOTIFY.
   //
-  if (IsListEmpty (&mDpcEntryFreeList)) {
-    //
-    // If the current TPL is greater than TPL_NOTIFY, then memory allocations
-    // can not be performed, so the free list can not be expanded.  In this case
-    // return EFI_OUT_OF_RESOURCES.
-    //
-    if (OriginalTpl > TPL_NOTIFY) {
-      ReturnStatus = EFI_OUT_OF_RESOURCES;
-      goto Done;
+  if (Queue->Count == mDpcQueueSize) {
+    if (Queue->Overflows++ == 0) {
+      DEBUG ((DEBUG_WARN, "DpcQueueDpc: DPC queue at TPL %d is full, increase PcdDpcQueueSize.\n", (UINT32)DpcTpl));
     }
 
-    //
-    // Add 64 DPC entries to the free list
-    //
-    for (Index = 0; Index < 64; Index++) {
-      //
-      // Lower the TPL level to perform a memory allocation
-      //
-      gBS->RestoreTPL (OriginalTpl);
-
-      //
-      // Allocate a new DPC entry
-      //
-      DpcEntry = AllocatePool (sizeof (DPC_ENTRY));
-
-      //
-      // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
-      //
-      gBS->RaiseTPL (TPL_HIGH_LEVEL);
-
-      //
-      // If the allocation of a DPC entry fails, and the free list is empty,
-      // then return EFI_OUT_OF_RESOURCES.
-      //
-      if (DpcEntry == NULL) {
-        if (IsListEmpty (&mDpcEntryFreeList)) {
-          ReturnStatus = EFI_OUT_OF_RESOURCES;
-          goto Done;
-        }
-      }
-
-      //
-      // Add the newly allocated DPC entry to the DPC free list
-      //
-      InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
-    }
+    ReturnStatus = EFI_OUT_OF_RESOURCES;
+    goto Done;
   }
 
   //
-  // Retrieve the first node from the free list of DPCs
+  // Fill in the entry at the tail of the ring buffer for the specified DpcTpl.
   //
-  DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcEntryFreeList));
-
-  //
-  // Remove the first node from the free list of DPCs
-  //
-  RemoveEntryList (&DpcEntry->ListEntry);
+  Index = Queue->Head + Queue->Count;
+  if (Index >= mDpcQueueSize) {
+    Index -= mDpcQueueSize;
+  }
 
-  //
-  // Fill in the DPC entry with the DpcProcedure and DpcContext
-  //
+  DpcEntry               = &Queue->Entries[Index];
   DpcEntry->DpcProcedure = DpcProcedure;
   DpcEntry->DpcContext   = DpcContext;
+  DpcEntry->QueueTime    = GetPerformanceCounter ();
 
-  //
-  // Add the DPC entry to the end of the list for the specified DplTpl.
-  //
-  InsertTailList (&mDpcQueue[DpcTpl], &DpcEntry->ListEntry);
+  Queue->Count++;
+  Queue->Queued++;
+  if (Queue->Count > Queue->MaxCount) {
+    Queue->MaxCount = Queue->Count;
+  }
 
   //
   // Increment the measured DPC queue depth across all TPLs
@@ -214,18 +204,25 @@ DpcDispatchDpc (
   IN EFI_DPC_PROTOCOL  *This
   )
 {
-  EFI_STATUS  ReturnStatus;
-  EFI_TPL     OriginalTpl;
-  EFI_TPL     Tpl;
-  DPC_ENTRY   *DpcEntry;
+  EFI_STATUS         ReturnStatus;
+  EFI_TPL            OriginalTpl;
+  EFI_TPL            Tpl;
+  DPC_QUEUE          *Queue;
+  DPC_ENTRY          *DpcEntry;
+  EFI_DPC_PROCEDURE  DpcProcedure;
+  VOID               *DpcContext;
+  UINT64             Latency;
+  UINT32             Budget;
+  UINT32             Invoked;
 
   //
   // Assume that no DPCs will be invoked
   //
   ReturnStatus = EFI_NOT_FOUND;
+  Budget       = PcdGet32 (PcdDpcDispatchBudget);
 
   //
-  // Raise the TPL level to TPL_HIGH_LEVEL for DPC list operation and save the
+  // Raise the TPL level to TPL_HIGH_LEVEL for DPC queue operation and save the
   // current TPL value so it can be restored when this function returns.
   //
   OriginalTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
@@ -238,19 +235,33 @@ DpcDispatchDpc (
     // Loop from TPL_HIGH_LEVEL down to the current TPL value
     //
     for (Tpl = TPL_HIGH_LEVEL; Tpl >= OriginalTpl; Tpl--) {
+      Queue   = &mDpcQueue[Tpl];
+      Invoked = 0;
+
       //
-      // Check to see if the DPC queue is empty
+      // Check to see if the DPC queue is empty, or if the DPCs invoked at this
+      // TPL used up the budget. The DPCs left are invoked by the next call.
       //
-      while (!IsListEmpty (&mDpcQueue[Tpl])) {
+      while ((Queue->Count > 0) && ((Budget == 0) || (Invoked < Budget))) {
         //
-        // Retrieve the first DPC entry from the DPC queue specified by Tpl
+        // Remove the DPC entry at the head of the DPC queue specified by Tpl.
+        // Its slot may be reused as soon as the TPL is lowered.
         //
-        DpcEntry = (DPC_ENTRY *)(GetFirstNode (&mDpcQueue[Tpl]));
+        DpcEntry     = &Queue->Entries[Queue->Head];
+        DpcProcedure = DpcEntry->DpcProcedure;
+        DpcContext   = DpcEntry->DpcContext;
+        Latency      = DpcElapsedTime (DpcEntry->QueueTime, GetPerformanceCounter ());
+        if (Latency > Queue->MaxLatency) {
+          Queue->MaxLatency = Latency;
+        }
 
-        //
-        // Remove the first DPC entry from the DPC queue specified by Tpl
-        //
-        RemoveEntryList (&DpcEntry->ListEntry);
+        if (++Queue->Head == mDpcQueueSize) {
+          Queue->Head = 0;
+        }
+
+        Queue->Count--;
+        Queue->Dispatched++;
+        Invoked++;
 
         //
         // Decrement the measured DPC Queue Depth across all TPLs
@@ -265,7 +276,7 @@ DpcDispatchDpc (
         //
         // Invoke the DPC passing in its context
         //
-        (DpcEntry->DpcProcedure)(DpcEntry->DpcContext);
+        DpcProcedure (DpcContext);
 
         //
         // At least one DPC has been invoked, so set the return status to EFI_SUCCESS
@@ -273,14 +284,9 @@ DpcDispatchDpc (
         ReturnStatus = EFI_SUCCESS;
 
         //
-        // Raise the TPL level back to TPL_HIGH_LEVEL for DPC list operations
+        // Raise the TPL level back to TPL_HIGH_LEVEL for DPC queue operations
         //
         gBS->RaiseTPL (TPL_HIGH_LEVEL);
-
-        //
-        // Add the invoked DPC entry to the DPC free list
-        //
-        InsertTailList (&mDpcEntryFreeList, &DpcEntry->ListEntry);
       }
     }
   }
@@ -293,6 +299,41 @@ DpcDispatchDpc (
   return ReturnStatus;
 }
 
+/**
+  Print the statistics of the DPC queues when the OS takes over.
+
+  @param  Event    The ExitBootServices event.
+  @param  Context  Not used.
+
+**/
+VOID
+EFIAPI
+DpcExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_TPL  Tpl;
+
+  DEBUG ((DEBUG_INFO, "DPC queues: maximum depth %d across all TPLs\n", (UINT32)mMaxDpcQueueDepth));
+  for (Tpl = TPL_APPLICATION; Tpl <= TPL_HIGH_LEVEL; Tpl++) {
+    if (mDpcQueue[Tpl].Queued == 0) {
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  TPL %2d: queued %ld, dispatched %ld, overflows %ld, maximum depth %d, maximum latency %ld us\n",
+      (UINT32)Tpl,
+      mDpcQueue[Tpl].Queued,
+      mDpcQueue[Tpl].Dispatched,
+      mDpcQueue[Tpl].Overflows,
+      mDpcQueue[Tpl].MaxCount,
+      DivU64x32 (GetTimeInNanoSecond (mDpcQueue[Tpl].MaxLatency), 1000)
+      ));
+  }
+}
+
 /**
   The entry point for DPC driver which installs the EFI_DPC_PROTOCOL onto a new handle.
 
@@ -313,19 +354,43 @@ DpcDriverEntryPoint (
 {
   EFI_STATUS  Status;
   UINTN       Index;
+  DPC_ENTRY   *Entries;
+  EFI_EVENT   ExitBootServicesEvent;
 
   //
   // ASSERT() if the EFI_DPC_PROTOCOL is already present in the handle database
   //
   ASSERT_PROTOCOL_ALREADY_INSTALLED (NULL, &gEfiDpcProtocolGuid);
 
+  mDpcQueueSize = PcdGet32 (PcdDpcQueueSize);
+  if (mDpcQueueSize == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  GetPerformanceCounterProperties (&mDpcCounterStart, &mDpcCounterEnd);
+
   //
-  // Initialize the DPC queue for all possible TPL values
+  // Allocate the DPC queue for all the TPL values a DPC can be queued at.
   //
-  for (Index = 0; Index <= TPL_HIGH_LEVEL; Index++) {
-    InitializeListHead (&mDpcQueue[Index]);
+  Entries = AllocateZeroPool ((TPL_HIGH_LEVEL + 1 - TPL_APPLICATION) * mDpcQueueSize * sizeof (DPC_ENTRY));
+  if (Entries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
 
+  for (Index = TPL_APPLICATION; Index <= TPL_HIGH_LEVEL; Index++) {
+    mDpcQueue[Index].Entries = Entries + (Index - TPL_APPLICATION) * mDpcQueueSize;
+  }
+
+  DEBUG_CODE_BEGIN ();
+  gBS->CreateEvent (
+         EVT_SIGNAL_EXIT_BOOT_SERVICES,
+         TPL_CALLBACK,
+         DpcExitBootServices,
+         NULL,
+         &ExitBootServicesEvent
+         );
+  DEBUG_CODE_END ();
+
   //
   // Install the EFI_DPC_PROTOCOL instance onto a new handle
   //
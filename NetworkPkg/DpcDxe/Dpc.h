@@ -21,18 +21,36 @@ Abstract:
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 #include <Protocol/Dpc.h>
 
 //
-// Internal data structure for managing DPCs.  A DPC entry is either on the free
-// list or on a DPC queue at a specific EFI_TPL.
+// Internal data structure for managing DPCs.  A DPC entry is a slot of the
+// ring buffer of the DPC queue at a specific EFI_TPL.
 //
 typedef struct {
-  LIST_ENTRY           ListEntry;
   EFI_DPC_PROCEDURE    DpcProcedure;
   VOID                 *DpcContext;
+  UINT64               QueueTime;       // Performance counter when the DPC was queued
 } DPC_ENTRY;
 
+//
+// A DPC queue at a specific EFI_TPL.  The entries are preallocated when the
+// driver starts, so queueing a DPC never allocates memory.  The counters are
+// kept for the debugger and the statistics printed at ExitBootServices().
+//
+typedef struct {
+  DPC_ENTRY    *Entries;                // Ring buffer of PcdDpcQueueSize entries
+  UINT32       Head;                    // Index of the oldest queued DPC
+  UINT32       Count;                   // Number of queued DPCs
+  UINT32       MaxCount;                // Maximum number of queued DPCs
+  UINT64       Queued;                  // Number of DPCs queued
+  UINT64       Dispatched;              // Number of DPCs invoked
+  UINT64       Overflows;               // Number of DPCs refused because the queue was full
+  UINT64       MaxLatency;              // Longest time from queueing to invocation, in performance counter ticks
+} DPC_QUEUE;
+
 /**
   Add a Deferred Procedure Call to the end of the DPC queue.
 
@@ -597,25 +597,29 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance on the boot NIC of the driver.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback function invoked by HttpIo, or NULL.
+  @param[out]   HttpIo         The HttpIo instance to initialize.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback  OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
   ASSERT (Private != NULL);
+  ASSERT (HttpIo != NULL);
 
   //
   // Get HTTP timeout value
@@ -636,15 +640,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (Private, HttpBootHttpIoCallback, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -867,6 +892,13 @@ HttpBootGetBootFileCallback (
     }
   }
 
+  //
+  // Hash the data while it is still in the cache.
+  //
+  if ((CallbackData->HashContext != NULL) && !Sha256Update (CallbackData->HashContext, Data, Length)) {
+    return EFI_ABORTED;
+  }
+
   //
   // Copy data if caller has provided a buffer.
   //
@@ -955,6 +987,7 @@ HttpBootGetBootFile (
   CHAR8                    BaseAuthValue[80];
   EFI_HTTP_HEADER          *HttpHeader;
   CHAR8                    *Data;
+  UINT8                    Digest[SHA256_DIGEST_SIZE];
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -989,6 +1022,39 @@ HttpBootGetBootFile (
   // Not found in cache, try to download it through HTTP.
   //
 
+  //
+  // 0. Split a large image over several connections if the server accepts
+  //    byte-range requests, and fall back to a single stream on failure.
+  //
+  if (!HeaderOnly && (Buffer != NULL) && Private->AcceptRanges &&
+      (PcdGet8 (PcdHttpBootParallelConnections) > 1) &&
+      (Private->BootFileSize > HTTP_BOOT_RANGE_CHUNK_SIZE) &&
+      (*BufferSize >= Private->BootFileSize))
+  {
+    Status = HttpBootGetBootFileByRanges (Private, Url, Private->BootFileSize, Buffer);
+    if (!EFI_ERROR (Status)) {
+      //
+      // The ranges arrive out of order, so the digest takes a pass of its own.
+      //
+      if (Private->DigestValid) {
+        if (!Sha256HashAll (Buffer, Private->BootFileSize, Digest) ||
+            (CompareMem (Digest, Private->Digest, SHA256_DIGEST_SIZE) != 0))
+        {
+          DEBUG ((DEBUG_ERROR, "HttpBootGetBootFile: File doesn't match the digest from the server\n"));
+          FreePool (Url);
+          return EFI_SECURITY_VIOLATION;
+        }
+      }
+
+      *BufferSize = Private->BootFileSize;
+      *ImageType  = Private->ImageType;
+      FreePool (Url);
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFile: Ranged download failed - %r, use a single connection\n", Status));
+  }
+
   //
   // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
   //
@@ -1237,6 +1303,28 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Remember whether the server accepts byte-range requests for the file.
+  //
+  if (HeaderOnly) {
+    HttpHeader = HttpFindHeader (
+                   ResponseData->HeaderCount,
+                   ResponseData->Headers,
+                   HTTP_HEADER_ACCEPT_RANGES
+                   );
+    Private->AcceptRanges = (BOOLEAN)((HttpHeader != NULL) && (AsciiStrStr (HttpHeader->FieldValue, "bytes") != NULL));
+  }
+
+  //
+  // Remember the digest of the file if the server sent one, the message-body
+  // is then hashed while it is received and checked against it.
+  //
+  Private->DigestValid = HttpBootGetHeaderDigest (
+                           ResponseData->HeaderCount,
+                           ResponseData->Headers,
+                           Private->Digest
+                           );
+
   //
   // 3.2 Cache the response header.
   //
@@ -1248,23 +1336,32 @@ HttpBootGetBootFile (
   //
   // 3.3 Init a message-body parser from the header information.
   //
-  Parser             = NULL;
-  Context.NewBlock   = FALSE;
-  Context.Block      = NULL;
-  Context.CopyedSize = 0;
-  Context.Buffer     = Buffer;
-  Context.BufferSize = *BufferSize;
-  Context.Cache      = Cache;
-  Context.Private    = Private;
-  Status             = HttpInitMsgParser (
-                         HeaderOnly ? HttpMethodHead : HttpMethodGet,
-                         ResponseData->Response.StatusCode,
-                         ResponseData->HeaderCount,
-                         ResponseData->Headers,
-                         HttpBootGetBootFileCallback,
-                         (VOID *)&Context,
-                         &Parser
-                         );
+  Parser              = NULL;
+  Context.NewBlock    = FALSE;
+  Context.Block       = NULL;
+  Context.CopyedSize  = 0;
+  Context.Buffer      = Buffer;
+  Context.BufferSize  = *BufferSize;
+  Context.Cache       = Cache;
+  Context.Private     = Private;
+  Context.HashContext = NULL;
+  if (!HeaderOnly && Private->DigestValid) {
+    Context.HashContext = AllocatePool (Sha256GetContextSize ());
+    if ((Context.HashContext == NULL) || !Sha256Init (Context.HashContext)) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ERROR_6;
+    }
+  }
+
+  Status = HttpInitMsgParser (
+             HeaderOnly ? HttpMethodHead : HttpMethodGet,
+             ResponseData->Response.StatusCode,
+             ResponseData->HeaderCount,
+             ResponseData->Headers,
+             HttpBootGetBootFileCallback,
+             (VOID *)&Context,
+             &Parser
+             );
   if (EFI_ERROR (Status)) {
     goto ERROR_6;
   }
@@ -1313,6 +1410,13 @@ HttpBootGetBootFile (
         }
 
         ReceivedSize += ResponseBody.BodyLength;
+        if ((Context.HashContext != NULL) &&
+            !Sha256Update (Context.HashContext, ResponseBody.Body, ResponseBody.BodyLength))
+        {
+          Status = EFI_ABORTED;
+          goto ERROR_6;
+        }
+
         if (Private->HttpBootCallback != NULL) {
           Status = Private->HttpBootCallback->Callback (
                                                 Private->HttpBootCallback,
@@ -1398,6 +1502,22 @@ HttpBootGetBootFile (
 
   *BufferSize = ContentLength;
 
+  //
+  // 3.6 Check the message-body against the digest sent by the server.
+  //
+  if (Context.HashContext != NULL) {
+    if (!EFI_ERROR (Status) &&
+        (!Sha256Final (Context.HashContext, Digest) ||
+         (CompareMem (Digest, Private->Digest, SHA256_DIGEST_SIZE) != 0)))
+    {
+      DEBUG ((DEBUG_ERROR, "HttpBootGetBootFile: File doesn't match the digest from the server\n"));
+      Status = EFI_SECURITY_VIOLATION;
+      goto ERROR_6;
+    }
+
+    FreePool (Context.HashContext);
+  }
+
   //
   // 4. Save the cache item to driver's cache list and return.
   //
@@ -1421,6 +1541,10 @@ ERROR_6:
     FreePool (Context.Block);
   }
 
+  if (Context.HashContext != NULL) {
+    FreePool (Context.HashContext);
+  }
+
   HttpBootFreeCache (Cache);
 
 ERROR_5:
@@ -14,6 +14,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT          "UefiHttpBoot/1.0"
 #define HTTP_BOOT_AUTHENTICATION_INFO_MAX_LEN  255
 
+//
+// Size of the byte range requested at a time by one connection of a
+// parallel download, and the number of times a failed range is resumed.
+//
+#define HTTP_BOOT_RANGE_CHUNK_SIZE  SIZE_4MB
+#define HTTP_BOOT_RANGE_MAX_RETRY   3
+
 //
 // Record the data length and start address of a data block.
 //
@@ -56,8 +63,41 @@ typedef struct {
   UINT8                      *Buffer;
 
   HTTP_BOOT_PRIVATE_DATA     *Private;
+
+  //
+  // SHA-256 context of the message-body, NULL if the server sent no digest.
+  //
+  VOID                       *HashContext;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// State of one connection in a parallel ranged download.
+//
+typedef enum {
+  HttpBootRangeIdle,
+  HttpBootRangeSending,
+  HttpBootRangeRecvHeader,
+  HttpBootRangeRecvBody
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// One connection in a parallel ranged download. The connection downloads
+// the byte range [Start, Start + Length) of the file, Received bytes of which
+// have already been stored in the caller's buffer.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   HttpCreated;
+  HTTP_BOOT_RANGE_STATE     State;
+  UINTN                     Start;
+  UINTN                     Length;
+  UINTN                     Received;
+  UINTN                     Retries;
+  HTTP_IO_HEADER            *RequestHeader;
+  EFI_HTTP_REQUEST_DATA     RequestData;
+  EFI_HTTP_RESPONSE_DATA    ResponseData;
+} HTTP_BOOT_RANGE_CONNECTION;
+
 /**
   Discover all the boot information for boot file.
 
@@ -86,6 +126,51 @@ HttpBootCreateHttpIo (
   IN     HTTP_BOOT_PRIVATE_DATA  *Private
   );
 
+/**
+  Create and configure a HttpIo instance on the boot NIC of the driver.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback function invoked by HttpIo, or NULL.
+  @param[out]   HttpIo         The HttpIo instance to initialize.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback  OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
+  );
+
+/**
+  Download the boot file over several HTTP connections at once, each of which
+  requests a different byte range of the file.
+
+  The caller must have learned from a previous HEAD request that the server
+  accepts byte-range requests for the file, and the size of the file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the file to, at
+                                   least FileSize bytes in size.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED          The server did not honor a range request.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  OUT    UINT8                   *Buffer
+  );
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
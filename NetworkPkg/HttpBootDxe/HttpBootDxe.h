@@ -32,6 +32,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HiiLib.h>
 #include <Library/PrintLib.h>
 #include <Library/DpcLib.h>
+#include <Library/BaseCryptLib.h>
 
 //
 // UEFI Driver Model Protocols
@@ -214,6 +215,9 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   CHAR8                                        *BootFileUri;
   VOID                                         *BootFileUriParser;
   UINTN                                        BootFileSize;
+  BOOLEAN                                      AcceptRanges;
+  BOOLEAN                                      DigestValid;
+  UINT8                                        Digest[SHA256_DIGEST_SIZE];
   BOOLEAN                                      NoGateway;
   HTTP_BOOT_IMAGE_TYPE                         ImageType;
 
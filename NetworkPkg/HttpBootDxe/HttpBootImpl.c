@@ -471,6 +471,8 @@ HttpBootStop (
   Private->BootFileUri       = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize      = 0;
+  Private->AcceptRanges      = FALSE;
+  Private->DigestValid       = FALSE;
   Private->SelectIndex       = 0;
   Private->SelectProxyType   = HttpOfferTypeMax;
 
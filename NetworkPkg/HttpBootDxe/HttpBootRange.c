@@ -0,0 +1,526 @@
+/** @file
+  Parallel download of the boot file with HTTP byte-range requests.
+
+  When the server accepts byte-range requests for a large boot file, the file
+  is split into HTTP_BOOT_RANGE_CHUNK_SIZE ranges that are requested over up
+  to PcdHttpBootParallelConnections connections at the same time. The message
+  body of each range is received directly into its place in the caller's
+  buffer. A connection that fails is re-created and resumes its range from the
+  last byte received, at most HTTP_BOOT_RANGE_MAX_RETRY times.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpBootDxe.h"
+
+/**
+  Build the request header for the remaining part of the range of a connection.
+
+  @param[in]       HostName        The value of the Host header.
+  @param[in]       AuthValue       The value of the Authorization header, or NULL.
+  @param[in, out]  Connection      The connection to build the request header for.
+
+  @retval EFI_SUCCESS              The request header is built.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeBuildHeader (
+  IN     CHAR8                       *HostName,
+  IN     CHAR8                       *AuthValue  OPTIONAL,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  HTTP_IO_HEADER  *HttpIoHeader;
+  CHAR8           RangeValue[48];
+  EFI_STATUS      Status;
+
+  //
+  // Host, Accept, User-Agent, Range and [Authorization]
+  //
+  HttpIoHeader = HttpIoCreateHeader ((AuthValue != NULL) ? 5 : 4);
+  if (HttpIoHeader == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "bytes=%Lu-%Lu",
+    (UINT64)(Connection->Start + Connection->Received),
+    (UINT64)(Connection->Start + Connection->Length - 1)
+    );
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_HOST, HostName);
+  if (!EFI_ERROR (Status)) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_ACCEPT, "*/*");
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_RANGE, RangeValue);
+  }
+
+  if (!EFI_ERROR (Status) && (AuthValue != NULL)) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_AUTHORIZATION, AuthValue);
+  }
+
+  if (EFI_ERROR (Status)) {
+    HttpIoFreeHeader (HttpIoHeader);
+    return Status;
+  }
+
+  Connection->RequestHeader = HttpIoHeader;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a response token on a connection, and start its timeout timer.
+
+  @param[in, out]  Connection      The connection to receive on.
+  @param[in]       Body            The buffer to receive the message-body in, or NULL
+                                   to receive the response header.
+
+  @retval EFI_SUCCESS              The response token is queued.
+  @retval Others                   Failed to queue the response token.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeRecv (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Body  OPTIONAL
+  )
+{
+  HTTP_IO           *HttpIo;
+  EFI_HTTP_MESSAGE  *Message;
+  EFI_STATUS        Status;
+
+  HttpIo  = &Connection->HttpIo;
+  Message = HttpIo->RspToken.Message;
+
+  HttpIo->RspToken.Status = EFI_NOT_READY;
+  if (Body == NULL) {
+    Message->Data.Response = &Connection->ResponseData;
+    Message->BodyLength    = 0;
+  } else {
+    Message->Data.Response = NULL;
+    Message->BodyLength    = Connection->Length - Connection->Received;
+  }
+
+  Message->HeaderCount = 0;
+  Message->Headers     = NULL;
+  Message->Body        = Body;
+
+  HttpIo->IsRxDone = FALSE;
+  Status           = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  }
+
+  return Status;
+}
+
+/**
+  Check whether the response token queued on a connection has completed.
+
+  @param[in, out]  Connection      The connection to check.
+
+  @retval EFI_NOT_READY            The response token is still pending.
+  @retval EFI_TIMEOUT              The response timed out, and the token was cancelled.
+  @retval Others                   The completion status of the response token.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeRecvDone (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  HTTP_IO  *HttpIo;
+
+  HttpIo = &Connection->HttpIo;
+  if (!HttpIo->IsRxDone) {
+    if (EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+      return EFI_NOT_READY;
+    }
+
+    HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->RspToken);
+    return EFI_TIMEOUT;
+  }
+
+  gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  HttpIo->IsRxDone = FALSE;
+  return HttpIo->RspToken.Status;
+}
+
+/**
+  Advance the state machine of one connection without blocking.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       HostName        The value of the Host header.
+  @param[in]       AuthValue       The value of the Authorization header, or NULL.
+  @param[out]      Buffer          The memory buffer the file is transferred to.
+  @param[in, out]  Connection      The connection to process.
+  @param[out]      Received        The number of bytes of the file received.
+
+  @retval EFI_SUCCESS              The connection made progress or is waiting.
+  @retval EFI_UNSUPPORTED          The server did not honor the range request.
+  @retval Others                   The connection failed.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootRangeProcess (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN     CHAR8                       *HostName,
+  IN     CHAR8                       *AuthValue  OPTIONAL,
+  OUT    UINT8                       *Buffer,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  OUT    UINTN                       *Received
+  )
+{
+  HTTP_IO           *HttpIo;
+  EFI_HTTP_MESSAGE  *Message;
+  UINTN             ContentLength;
+  EFI_STATUS        Status;
+
+  HttpIo    = &Connection->HttpIo;
+  *Received = 0;
+
+  switch (Connection->State) {
+    case HttpBootRangeIdle:
+      if (Connection->Received == Connection->Length) {
+        return EFI_SUCCESS;
+      }
+
+      Status = HttpBootRangeBuildHeader (HostName, AuthValue, Connection);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Message                 = HttpIo->ReqToken.Message;
+      HttpIo->ReqToken.Status = EFI_NOT_READY;
+      Message->Data.Request   = &Connection->RequestData;
+      Message->HeaderCount    = Connection->RequestHeader->HeaderCount;
+      Message->Headers        = Connection->RequestHeader->Headers;
+      Message->BodyLength     = 0;
+      Message->Body           = NULL;
+      HttpIo->IsTxDone        = FALSE;
+      Status                  = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Connection->State = HttpBootRangeSending;
+      break;
+
+    case HttpBootRangeSending:
+      if (!HttpIo->IsTxDone) {
+        break;
+      }
+
+      HttpIoFreeHeader (Connection->RequestHeader);
+      Connection->RequestHeader = NULL;
+      if (EFI_ERROR (HttpIo->ReqToken.Status)) {
+        return HttpIo->ReqToken.Status;
+      }
+
+      Status = HttpBootRangeRecv (Connection, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Connection->State = HttpBootRangeRecvHeader;
+      break;
+
+    case HttpBootRangeRecvHeader:
+      Status = HttpBootRangeRecvDone (Connection);
+      if (Status == EFI_NOT_READY) {
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      //
+      // Only a "206 Partial Content" response of exactly the requested length
+      // can be received in place; anything else ends the parallel download.
+      //
+      Message = HttpIo->RspToken.Message;
+      Status  = HttpIoGetContentLength (Message->HeaderCount, Message->Headers, &ContentLength);
+      if (Message->Headers != NULL) {
+        HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+        Message->Headers     = NULL;
+        Message->HeaderCount = 0;
+      }
+
+      if ((Connection->ResponseData.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) ||
+          EFI_ERROR (Status) ||
+          (ContentLength != Connection->Length - Connection->Received))
+      {
+        DEBUG ((
+          DEBUG_WARN,
+          "HttpBootRangeProcess: Range at 0x%Lx not honored, status code %d\n",
+          (UINT64)(Connection->Start + Connection->Received),
+          Connection->ResponseData.StatusCode
+          ));
+        return EFI_UNSUPPORTED;
+      }
+
+      Status = HttpBootRangeRecv (Connection, Buffer + Connection->Start + Connection->Received);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Connection->State = HttpBootRangeRecvBody;
+      break;
+
+    case HttpBootRangeRecvBody:
+      Status = HttpBootRangeRecvDone (Connection);
+      if (Status == EFI_NOT_READY) {
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Message               = HttpIo->RspToken.Message;
+      *Received             = Message->BodyLength;
+      Connection->Received += Message->BodyLength;
+      if (Private->HttpBootCallback != NULL) {
+        Status = Private->HttpBootCallback->Callback (
+                                              Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)Message->BodyLength,
+                                              Message->Body
+                                              );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      if (Connection->Received < Connection->Length) {
+        Status = HttpBootRangeRecv (Connection, Buffer + Connection->Start + Connection->Received);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      } else {
+        Connection->State   = HttpBootRangeIdle;
+        Connection->Retries = 0;
+      }
+
+      break;
+
+    default:
+      ASSERT (FALSE);
+      return EFI_DEVICE_ERROR;
+  }
+
+  HttpIo->Http->Poll (HttpIo->Http);
+  return EFI_SUCCESS;
+}
+
+/**
+  Release the HttpIo instance of a connection.
+
+  @param[in, out]  Connection      The connection to release.
+
+**/
+STATIC
+VOID
+HttpBootRangeDestroyConnection (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  if (Connection->RequestHeader != NULL) {
+    HttpIoFreeHeader (Connection->RequestHeader);
+    Connection->RequestHeader = NULL;
+  }
+
+  if (Connection->HttpCreated) {
+    HttpIoDestroyIo (&Connection->HttpIo);
+    Connection->HttpCreated = FALSE;
+  }
+
+  Connection->State = HttpBootRangeIdle;
+}
+
+/**
+  Download the boot file over several HTTP connections at once, each of which
+  requests a different byte range of the file.
+
+  The caller must have learned from a previous HEAD request that the server
+  accepts byte-range requests for the file, and the size of the file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the file to, at
+                                   least FileSize bytes in size.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED          The server did not honor a range request.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  OUT    UINT8                   *Buffer
+  )
+{
+  HTTP_BOOT_RANGE_CONNECTION  *Connections;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  UINTN                       ConnectionCount;
+  UINTN                       Index;
+  UINTN                       NextOffset;
+  UINTN                       Completed;
+  UINTN                       Received;
+  CHAR8                       *HostName;
+  CHAR8                       BaseAuthValue[80];
+  CHAR8                       *AuthValue;
+  EFI_STATUS                  Status;
+
+  ASSERT (Private != NULL);
+  ASSERT (Buffer != NULL);
+
+  ConnectionCount = MIN (
+                      PcdGet8 (PcdHttpBootParallelConnections),
+                      (FileSize + HTTP_BOOT_RANGE_CHUNK_SIZE - 1) / HTTP_BOOT_RANGE_CHUNK_SIZE
+                      );
+  if (ConnectionCount < 2) {
+    return EFI_UNSUPPORTED;
+  }
+
+  AuthValue = NULL;
+  if (Private->AuthData != NULL) {
+    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+      return EFI_UNSUPPORTED;
+    }
+
+    AsciiSPrint (BaseAuthValue, sizeof (BaseAuthValue), "%a %a", "Basic", Private->AuthData);
+    AuthValue = BaseAuthValue;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (Private->BootFileUri, Private->BootFileUriParser, &HostName);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connections = AllocateZeroPool (ConnectionCount * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  if (Connections == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  //
+  // The connections don't report the HTTP messages through HttpBootHttpIoCallback,
+  // the response to each range would restart the progress of the whole file.
+  //
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    Status     = HttpBootCreateHttpIoInstance (Private, NULL, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      if (Index < 2) {
+        goto ON_EXIT;
+      }
+
+      ConnectionCount = Index;
+      break;
+    }
+
+    Connection->HttpCreated        = TRUE;
+    Connection->RequestData.Method = HttpMethodGet;
+    Connection->RequestData.Url    = Url;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpBootGetBootFileByRanges: 0x%Lx bytes over %Lu connections\n",
+    (UINT64)FileSize,
+    (UINT64)ConnectionCount
+    ));
+
+  NextOffset = 0;
+  Completed  = 0;
+  while (Completed < FileSize) {
+    for (Index = 0; Index < ConnectionCount; Index++) {
+      Connection = &Connections[Index];
+
+      //
+      // Hand the next range of the file to an idle connection.
+      //
+      if ((Connection->State == HttpBootRangeIdle) &&
+          (Connection->Received == Connection->Length) &&
+          (NextOffset < FileSize))
+      {
+        Connection->Start    = NextOffset;
+        Connection->Length   = MIN (HTTP_BOOT_RANGE_CHUNK_SIZE, FileSize - NextOffset);
+        Connection->Received = 0;
+        NextOffset          += Connection->Length;
+      }
+
+      Status = HttpBootRangeProcess (Private, HostName, AuthValue, Buffer, Connection, &Received);
+      if (!EFI_ERROR (Status)) {
+        Completed += Received;
+        continue;
+      }
+
+      if ((Status == EFI_UNSUPPORTED) || (Connection->Retries >= HTTP_BOOT_RANGE_MAX_RETRY)) {
+        goto ON_EXIT;
+      }
+
+      //
+      // Re-create the connection, and resume the range where it stopped.
+      //
+      DEBUG ((
+        DEBUG_WARN,
+        "HttpBootGetBootFileByRanges: Connection %Lu failed - %r, resume at 0x%Lx\n",
+        (UINT64)Index,
+        Status,
+        (UINT64)(Connection->Start + Connection->Received)
+        ));
+      Connection->Retries++;
+      HttpBootRangeDestroyConnection (Connection);
+      Status = HttpBootCreateHttpIoInstance (Private, NULL, &Connection->HttpIo);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      Connection->HttpCreated = TRUE;
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  if (Connections != NULL) {
+    for (Index = 0; Index < ConnectionCount; Index++) {
+      HttpBootRangeDestroyConnection (&Connections[Index]);
+    }
+
+    FreePool (Connections);
+  }
+
+  FreePool (HostName);
+  return Status;
+}
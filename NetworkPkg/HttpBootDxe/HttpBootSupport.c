@@ -790,3 +790,66 @@ HttpBootIsHttpRedirectStatusCode (
 
   return FALSE;
 }
+
+/**
+  Get the SHA-256 digest of the file from the "Digest" header of a response
+  (RFC 3230).
+
+  @param[in]    HeaderCount      Number of HTTP header structures in Headers list.
+  @param[in]    Headers          Array containing list of HTTP headers.
+  @param[out]   Digest           The SHA-256 digest sent by the server.
+
+  @retval TRUE                   Digest holds the SHA-256 digest of the file.
+  @retval FALSE                  The server didn't send a valid SHA-256 digest.
+
+**/
+BOOLEAN
+HttpBootGetHeaderDigest (
+  IN     UINTN            HeaderCount,
+  IN     EFI_HTTP_HEADER  *Headers,
+  OUT    UINT8            *Digest
+  )
+{
+  STATIC CONST CHAR8  Algorithm[] = "SHA-256=";
+  EFI_HTTP_HEADER     *Header;
+  CHAR8               *Value;
+  CHAR8               *End;
+  UINTN               Index;
+  UINTN               DigestSize;
+
+  Header = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_DIGEST);
+  if ((Header == NULL) || (Header->FieldValue == NULL)) {
+    return FALSE;
+  }
+
+  //
+  // The value is a comma separated list of <algorithm>=<base64 digest>.
+  //
+  Value = Header->FieldValue;
+  while (*Value != '\0') {
+    while ((*Value == ' ') || (*Value == ',')) {
+      Value++;
+    }
+
+    End = Value;
+    while ((*End != '\0') && (*End != ',')) {
+      End++;
+    }
+
+    for (Index = 0; (Index < sizeof (Algorithm) - 1) && (Value + Index < End); Index++) {
+      if (AsciiCharToUpper (Value[Index]) != Algorithm[Index]) {
+        break;
+      }
+    }
+
+    if (Index == sizeof (Algorithm) - 1) {
+      DigestSize = SHA256_DIGEST_SIZE;
+      return (BOOLEAN)(!RETURN_ERROR (Base64Decode (Value + Index, End - Value - Index, Digest, &DigestSize)) &&
+                       (DigestSize == SHA256_DIGEST_SIZE));
+    }
+
+    Value = End;
+  }
+
+  return FALSE;
+}
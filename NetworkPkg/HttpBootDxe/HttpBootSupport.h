@@ -212,4 +212,23 @@ HttpBootIsHttpRedirectStatusCode (
   IN   EFI_HTTP_STATUS_CODE  StatusCode
   );
 
+/**
+  Get the SHA-256 digest of the file from the "Digest" header of a response
+  (RFC 3230).
+
+  @param[in]    HeaderCount      Number of HTTP header structures in Headers list.
+  @param[in]    Headers          Array containing list of HTTP headers.
+  @param[out]   Digest           The SHA-256 digest sent by the server.
+
+  @retval TRUE                   Digest holds the SHA-256 digest of the file.
+  @retval FALSE                  The server didn't send a valid SHA-256 digest.
+
+**/
+BOOLEAN
+HttpBootGetHeaderDigest (
+  IN     UINTN            HeaderCount,
+  IN     EFI_HTTP_HEADER  *Headers,
+  OUT    UINT8            *Digest
+  );
+
 #endif
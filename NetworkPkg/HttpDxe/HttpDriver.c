@@ -13,6 +13,16 @@
 
 EFI_HTTP_UTILITIES_PROTOCOL  *mHttpUtilities = NULL;
 
+//
+// The names of the values of HTTP_SERVICE.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mHttpStatisticsNames[HttpStatMax] = {
+  L"Requests",
+  L"Responses",
+  L"ConnectionsReused",
+  L"Errors"
+};
+
 ///
 /// Driver Binding Protocol instance
 ///
@@ -67,6 +77,8 @@ HttpCreateService (
   HttpService->ControllerHandle            = Controller;
   HttpService->ChildrenNumber              = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->ConnectionPool);
+  HttpService->Statistics = NetLibCreateStatistics (Controller, L"HTTP", HttpStatMax, mHttpStatisticsNames);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -90,6 +102,8 @@ HttpCleanService (
     return;
   }
 
+  HttpPoolFlush (HttpService, UsingIpv6);
+
   if (!UsingIpv6) {
     if (HttpService->Tcp4ChildHandle != NULL) {
       gBS->CloseProtocol (
@@ -473,6 +487,7 @@ ON_ERROR:
                     );
     if (!EFI_ERROR (Status)) {
       if ((HttpService->Tcp4ChildHandle == NULL) && (HttpService->Tcp6ChildHandle == NULL)) {
+        NetLibDestroyStatistics (HttpService->Statistics);
         FreePool (HttpService);
       }
     }
@@ -567,6 +582,7 @@ HttpDxeStop (
                &gEfiHttpServiceBindingProtocolGuid,
                ServiceBinding
                );
+        NetLibDestroyStatistics (HttpService->Statistics);
         FreePool (HttpService);
       }
 
@@ -249,19 +249,23 @@ EfiHttpRequest (
   CHAR8                  *FileUrl;
   UINTN                  RequestMsgSize;
   EFI_HANDLE             ImageHandle;
+  HTTP_POOL_CONNECTION   *PoolConnection;
+  BOOLEAN                Adopted;
 
   //
   // Initializations
   //
-  Url          = NULL;
-  UrlParser    = NULL;
-  RemotePort   = 0;
-  HostName     = NULL;
-  RequestMsg   = NULL;
-  HostNameStr  = NULL;
-  Wrap         = NULL;
-  FileUrl      = NULL;
-  TlsConfigure = FALSE;
+  Url            = NULL;
+  UrlParser      = NULL;
+  RemotePort     = 0;
+  HostName       = NULL;
+  RequestMsg     = NULL;
+  HostNameStr    = NULL;
+  Wrap           = NULL;
+  FileUrl        = NULL;
+  TlsConfigure   = FALSE;
+  PoolConnection = NULL;
+  Adopted        = FALSE;
 
   if ((This == NULL) || (Token == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -509,9 +513,18 @@ EfiHttpRequest (
 
   if (Configure) {
     //
-    // Parse Url for IPv4 or IPv6 address, if failed, perform DNS resolution.
+    // Look for an idle connection to the same server left by another HTTP
+    // instance, its remote address is already resolved.
     //
-    if (!HttpInstance->LocalAddressIsIPv6) {
+    PoolConnection = HttpPoolTake (HttpInstance, HostName, RemotePort);
+    if (PoolConnection != NULL) {
+      IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &PoolConnection->RemoteAddr);
+      IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &PoolConnection->RemoteIpv6Addr);
+      Status = EFI_SUCCESS;
+    } else if (!HttpInstance->LocalAddressIsIPv6) {
+      //
+      // Parse Url for IPv4 or IPv6 address, if failed, perform DNS resolution.
+      //
       Status = NetLibAsciiStrToIp4 (HostName, &HttpInstance->RemoteAddr);
     } else {
       Status = HttpUrlGetIp6 (Url, UrlParser, &HttpInstance->RemoteIpv6Addr);
@@ -573,6 +586,14 @@ EfiHttpRequest (
     EfiHttpCancel (This, NULL);
   }
 
+  //
+  // Take over the pooled connection, or connect as usual if that fails.
+  //
+  if (PoolConnection != NULL) {
+    Adopted        = (BOOLEAN)!EFI_ERROR (HttpPoolAdopt (HttpInstance, PoolConnection));
+    PoolConnection = NULL;
+  }
+
   //
   // Wrap the HTTP token in HTTP_TOKEN_WRAP
   //
@@ -588,18 +609,24 @@ EfiHttpRequest (
     Wrap->TcpWrap.Method = Request->Method;
   }
 
-  Status = HttpInitSession (
-             HttpInstance,
-             Wrap,
-             Configure || ReConfigure,
-             TlsConfigure
-             );
+  if (Adopted) {
+    NET_STATISTICS_INC (HttpInstance->Service->Statistics, HttpStatConnectionsReused);
+    Status = EFI_SUCCESS;
+  } else {
+    Status = HttpInitSession (
+               HttpInstance,
+               Wrap,
+               Configure || ReConfigure,
+               TlsConfigure
+               );
+  }
+
   HttpNotify (HttpEventInitSession, Status);
   if (EFI_ERROR (Status)) {
     goto Error2;
   }
 
-  if (!Configure && !ReConfigure && !TlsConfigure) {
+  if (Adopted || (!Configure && !ReConfigure && !TlsConfigure)) {
     //
     // For the new HTTP token, create TX TCP token events.
     //
@@ -666,6 +693,8 @@ EfiHttpRequest (
     goto Error5;
   }
 
+  NET_STATISTICS_INC (HttpInstance->Service->Statistics, HttpStatRequests);
+
   DispatchDpc ();
 
   if (HostName != NULL) {
@@ -713,6 +742,12 @@ Error2:
   }
 
 Error1:
+  NET_STATISTICS_INC (HttpInstance->Service->Statistics, HttpStatErrors);
+
+  if (PoolConnection != NULL) {
+    HttpPoolDestroy (HttpInstance->Service, PoolConnection);
+  }
+
   if (HostName != NULL) {
     FreePool (HostName);
   }
@@ -1148,6 +1183,7 @@ HttpResponseWorker (
 
     HttpMsg->Data.Response->StatusCode = HttpMappingToStatusCode (StatusCode);
     HttpInstance->StatusCode           = StatusCode;
+    NET_STATISTICS_INC (HttpInstance->Service->Statistics, HttpStatResponses);
 
     Status      = EFI_NOT_READY;
     ValueInItem = NULL;
@@ -1476,6 +1512,8 @@ Error2:
   }
 
 Error:
+  NET_STATISTICS_INC (HttpInstance->Service->Statistics, HttpStatErrors);
+
   Item = NetMapFindKey (&Wrap->HttpInstance->RxTokens, Wrap->HttpToken);
   if (Item != NULL) {
     NetMapRemoveItem (&Wrap->HttpInstance->RxTokens, Item, NULL);
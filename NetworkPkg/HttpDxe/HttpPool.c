@@ -0,0 +1,557 @@
+/** @file
+  The pool of idle HTTP connections shared by the HTTP instances of one HTTP
+  service.
+
+  When a HTTP instance is destroyed or reset while its keep-alive connection
+  is still usable, the TCP child and, for HTTPS, the TLS child carrying the
+  session are moved into the pool of the HTTP service. A later instance that
+  sends a request to the same host, port and scheme from the same local
+  address takes over the connection, and skips DNS resolution, the TCP
+  handshake and the TLS handshake. The TLS configuration of HttpDxe is global
+  (TlsCaCertificate, HttpTlsCipherList and PcdHttpTlsHostVerifyDisabled), so a
+  TLS session can serve any instance requesting the same server.
+
+  The pool holds at most PcdHttpConnectionPoolSize connections, the oldest one
+  being closed first, and a connection is closed once it has been idle for
+  HTTP_POOL_IDLE_TIMEOUT seconds.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpDriver.h"
+
+/**
+  Remove a connection from the connection pool and release it.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  Connection         The connection in the pool.
+
+**/
+STATIC
+VOID
+HttpPoolRemove (
+  IN  HTTP_SERVICE          *HttpService,
+  IN  HTTP_POOL_CONNECTION  *Connection
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  RemoveEntryList (&Connection->Link);
+  HttpService->PoolCount--;
+  gBS->RestoreTPL (OldTpl);
+
+  HttpPoolDestroy (HttpService, Connection);
+}
+
+/**
+  Release the connections that have been idle for too long, and the oldest ones
+  above the given count.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  MaxCount           The number of connections to keep at most.
+
+**/
+STATIC
+VOID
+HttpPoolTrim (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  UINTN         MaxCount
+  )
+{
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *NextEntry;
+  HTTP_POOL_CONNECTION  *Connection;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &HttpService->ConnectionPool) {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_POOL_CONNECTION, Link);
+    if ((HttpService->PoolCount > MaxCount) || !EFI_ERROR (gBS->CheckEvent (Connection->IdleTimer))) {
+      HttpPoolRemove (HttpService, Connection);
+    }
+  }
+}
+
+/**
+  Check whether a pooled connection can serve a request of a HTTP instance.
+
+  @param[in]  Connection         The connection in the pool.
+  @param[in]  HttpInstance       The HTTP instance that is going to send a request.
+  @param[in]  HostName           The host name of the server.
+  @param[in]  RemotePort         The port of the server.
+
+  @retval TRUE                   The connection goes to the same server from the
+                                 same local address.
+  @retval FALSE                  The connection can't be used.
+
+**/
+STATIC
+BOOLEAN
+HttpPoolMatch (
+  IN  HTTP_POOL_CONNECTION  *Connection,
+  IN  HTTP_PROTOCOL         *HttpInstance,
+  IN  CHAR8                 *HostName,
+  IN  UINT16                RemotePort
+  )
+{
+  if ((Connection->UsingIpv6 != HttpInstance->LocalAddressIsIPv6) ||
+      (Connection->UseHttps != HttpInstance->UseHttps) ||
+      (Connection->RemotePort != RemotePort) ||
+      (AsciiStriCmp (Connection->RemoteHost, HostName) != 0))
+  {
+    return FALSE;
+  }
+
+  if (Connection->UsingIpv6) {
+    return (BOOLEAN)((Connection->Ipv6Node.LocalPort == HttpInstance->Ipv6Node.LocalPort) &&
+                     EFI_IP6_EQUAL (&Connection->Ipv6Node.LocalAddress, &HttpInstance->Ipv6Node.LocalAddress));
+  }
+
+  if ((Connection->IPv4Node.UseDefaultAddress != HttpInstance->IPv4Node.UseDefaultAddress) ||
+      (Connection->IPv4Node.LocalPort != HttpInstance->IPv4Node.LocalPort))
+  {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(Connection->IPv4Node.UseDefaultAddress ||
+                   (EFI_IP4_EQUAL (&Connection->IPv4Node.LocalAddress, &HttpInstance->IPv4Node.LocalAddress) &&
+                    EFI_IP4_EQUAL (&Connection->IPv4Node.LocalSubnet, &HttpInstance->IPv4Node.LocalSubnet)));
+}
+
+/**
+  Check whether the TCP connection of a pooled connection is still established,
+  that is, the server hasn't closed it while it was idle.
+
+  @param[in]  Connection         The connection in the pool.
+
+  @retval TRUE                   The connection is established.
+  @retval FALSE                  The connection is closing or closed.
+
+**/
+STATIC
+BOOLEAN
+HttpPoolIsEstablished (
+  IN  HTTP_POOL_CONNECTION  *Connection
+  )
+{
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+
+  if (Connection->UsingIpv6) {
+    Connection->Tcp6->Poll (Connection->Tcp6);
+    return (BOOLEAN)(!EFI_ERROR (Connection->Tcp6->GetModeData (Connection->Tcp6, &Tcp6State, NULL, NULL, NULL, NULL)) &&
+                     (Tcp6State == Tcp6StateEstablished));
+  }
+
+  Connection->Tcp4->Poll (Connection->Tcp4);
+  return (BOOLEAN)(!EFI_ERROR (Connection->Tcp4->GetModeData (Connection->Tcp4, &Tcp4State, NULL, NULL, NULL, NULL)) &&
+                   (Tcp4State == Tcp4StateEstablished));
+}
+
+/**
+  Move the connection of a HTTP instance that is being cleaned up into the
+  connection pool of its service, if the connection can serve another request.
+
+  The connection is left with the instance if it is not established, the server
+  asked to close it, a message is still being received, or the pool is disabled.
+
+  @param[in, out]  HttpInstance       The HTTP instance being cleaned up.
+
+**/
+VOID
+HttpPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  HTTP_POOL_CONNECTION  *Connection;
+  EFI_STATUS            Status;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if ((PcdGet8 (PcdHttpConnectionPoolSize) == 0) ||
+      (HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      HttpInstance->ConnectionClose ||
+      (HttpInstance->RemoteHost == NULL) ||
+      (HttpInstance->MsgParser != NULL) ||
+      (HttpInstance->CacheBody != NULL) ||
+      !NetMapIsEmpty (&HttpInstance->TxTokens) ||
+      !NetMapIsEmpty (&HttpInstance->RxTokens))
+  {
+    return;
+  }
+
+  if (HttpInstance->LocalAddressIsIPv6 ? (HttpInstance->Tcp6ChildHandle == NULL) : (HttpInstance->Tcp4ChildHandle == NULL)) {
+    return;
+  }
+
+  if (HttpInstance->UseHttps &&
+      ((HttpInstance->TlsChildHandle == NULL) || (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring)))
+  {
+    return;
+  }
+
+  Connection = AllocateZeroPool (sizeof (HTTP_POOL_CONNECTION));
+  if (Connection == NULL) {
+    return;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &Connection->IdleTimer);
+  if (EFI_ERROR (Status)) {
+    FreePool (Connection);
+    return;
+  }
+
+  gBS->SetTimer (Connection->IdleTimer, TimerRelative, HTTP_POOL_IDLE_TIMEOUT * TICKS_PER_SECOND);
+
+  //
+  // Detach the TCP child from the HTTP instance, it stays opened BY_DRIVER
+  // on the controller.
+  //
+  Connection->UsingIpv6 = HttpInstance->LocalAddressIsIPv6;
+  if (Connection->UsingIpv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    Connection->TcpChildHandle    = HttpInstance->Tcp6ChildHandle;
+    Connection->Tcp6              = HttpInstance->Tcp6;
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+    IP6_COPY_ADDRESS (&Connection->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    Connection->TcpChildHandle    = HttpInstance->Tcp4ChildHandle;
+    Connection->Tcp4              = HttpInstance->Tcp4;
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+    IP4_COPY_ADDRESS (&Connection->RemoteAddr, &HttpInstance->RemoteAddr);
+  }
+
+  CopyMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (Connection->IPv4Node));
+  CopyMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Connection->Ipv6Node));
+  Connection->RemoteHost   = HttpInstance->RemoteHost;
+  Connection->RemotePort   = HttpInstance->RemotePort;
+  HttpInstance->RemoteHost = NULL;
+
+  Connection->UseHttps = HttpInstance->UseHttps;
+  if (Connection->UseHttps) {
+    Connection->TlsSb            = HttpInstance->TlsSb;
+    Connection->TlsChildHandle   = HttpInstance->TlsChildHandle;
+    Connection->Tls              = HttpInstance->Tls;
+    Connection->TlsConfiguration = HttpInstance->TlsConfiguration;
+    CopyMem (&Connection->TlsConfigData, &HttpInstance->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+    HttpInstance->TlsChildHandle = NULL;
+    HttpInstance->Tls            = NULL;
+  }
+
+  //
+  // The instance no longer owns a connection to close.
+  //
+  HttpInstance->State = HTTP_STATE_TCP_CLOSED;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&HttpService->ConnectionPool, &Connection->Link);
+  HttpService->PoolCount++;
+  gBS->RestoreTPL (OldTpl);
+
+  HttpPoolTrim (HttpService, PcdGet8 (PcdHttpConnectionPoolSize));
+}
+
+/**
+  Remove an idle connection to the given server from the connection pool.
+
+  Connections that timed out or were closed by the server are released on the
+  way.
+
+  @param[in]  HttpInstance       The HTTP instance that is going to send a request.
+  @param[in]  HostName           The host name of the server.
+  @param[in]  RemotePort         The port of the server.
+
+  @return The connection taken from the pool, or NULL if there is none.
+
+**/
+HTTP_POOL_CONNECTION *
+HttpPoolTake (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *HostName,
+  IN  UINT16         RemotePort
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *NextEntry;
+  HTTP_POOL_CONNECTION  *Connection;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+  HttpPoolTrim (HttpService, PcdGet8 (PcdHttpConnectionPoolSize));
+
+  //
+  // Take the most recently parked connection first, it is the least likely to
+  // have been closed by the server.
+  //
+  for (Entry = HttpService->ConnectionPool.BackLink; Entry != &HttpService->ConnectionPool; Entry = NextEntry) {
+    NextEntry  = Entry->BackLink;
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_POOL_CONNECTION, Link);
+    if (!HttpPoolMatch (Connection, HttpInstance, HostName, RemotePort)) {
+      continue;
+    }
+
+    if (!HttpPoolIsEstablished (Connection)) {
+      HttpPoolRemove (HttpService, Connection);
+      continue;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    RemoveEntryList (&Connection->Link);
+    HttpService->PoolCount--;
+    gBS->RestoreTPL (OldTpl);
+
+    return Connection;
+  }
+
+  return NULL;
+}
+
+/**
+  Let a HTTP instance take over a connection returned by HttpPoolTake().
+
+  The connection is consumed in all cases. On success the TCP and TLS children
+  that the instance created for itself are released, and the instance is in the
+  HTTP_STATE_TCP_CONNECTED state. On failure the instance is left unchanged,
+  and it can connect to the server as usual.
+
+  @param[in, out]  HttpInstance       The HTTP instance.
+  @param[in]       Connection         The connection taken from the pool.
+
+  @retval EFI_SUCCESS            The instance owns the connection.
+  @retval Others                 The connection was released.
+
+**/
+EFI_STATUS
+HttpPoolAdopt (
+  IN OUT HTTP_PROTOCOL         *HttpInstance,
+  IN     HTTP_POOL_CONNECTION  *Connection
+  )
+{
+  HTTP_SERVICE  *HttpService;
+  EFI_STATUS    Status;
+  VOID          *Interface;
+
+  HttpService = HttpInstance->Service;
+  ASSERT (Connection->UsingIpv6 == HttpInstance->LocalAddressIsIPv6);
+
+  Status = gBS->OpenProtocol (
+                  Connection->TcpChildHandle,
+                  Connection->UsingIpv6 ? &gEfiTcp6ProtocolGuid : &gEfiTcp4ProtocolGuid,
+                  &Interface,
+                  Connection->UsingIpv6 ? HttpService->Ip6DriverBindingHandle : HttpService->Ip4DriverBindingHandle,
+                  HttpInstance->Handle,
+                  EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                  );
+  if (EFI_ERROR (Status)) {
+    HttpPoolDestroy (HttpService, Connection);
+    return Status;
+  }
+
+  //
+  // The events of the instance are bound to its own completion flags, create
+  // those that HttpInitSession() would otherwise have created.
+  //
+  HttpCloseTcpConnCloseEvent (HttpInstance);
+  Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+  if (!EFI_ERROR (Status) && Connection->UseHttps) {
+    TlsCloseTxRxEvent (HttpInstance);
+    Status = TlsCreateTxRxEvent (HttpInstance);
+  }
+
+  if (EFI_ERROR (Status)) {
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           Connection->UsingIpv6 ? &gEfiTcp6ProtocolGuid : &gEfiTcp4ProtocolGuid,
+           Connection->UsingIpv6 ? HttpService->Ip6DriverBindingHandle : HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+    HttpPoolDestroy (HttpService, Connection);
+    return Status;
+  }
+
+  //
+  // Replace the TCP child of the instance with the pooled one.
+  //
+  if (Connection->UsingIpv6) {
+    if (HttpInstance->Tcp6ChildHandle != NULL) {
+      gBS->CloseProtocol (
+             HttpInstance->Tcp6ChildHandle,
+             &gEfiTcp6ProtocolGuid,
+             HttpService->Ip6DriverBindingHandle,
+             HttpService->ControllerHandle
+             );
+
+      gBS->CloseProtocol (
+             HttpInstance->Tcp6ChildHandle,
+             &gEfiTcp6ProtocolGuid,
+             HttpService->Ip6DriverBindingHandle,
+             HttpInstance->Handle
+             );
+
+      NetLibDestroyServiceChild (
+        HttpService->ControllerHandle,
+        HttpService->Ip6DriverBindingHandle,
+        &gEfiTcp6ServiceBindingProtocolGuid,
+        HttpInstance->Tcp6ChildHandle
+        );
+    }
+
+    HttpInstance->Tcp6ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp6            = (EFI_TCP6_PROTOCOL *)Interface;
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Connection->RemoteIpv6Addr);
+  } else {
+    if (HttpInstance->Tcp4ChildHandle != NULL) {
+      gBS->CloseProtocol (
+             HttpInstance->Tcp4ChildHandle,
+             &gEfiTcp4ProtocolGuid,
+             HttpService->Ip4DriverBindingHandle,
+             HttpService->ControllerHandle
+             );
+
+      gBS->CloseProtocol (
+             HttpInstance->Tcp4ChildHandle,
+             &gEfiTcp4ProtocolGuid,
+             HttpService->Ip4DriverBindingHandle,
+             HttpInstance->Handle
+             );
+
+      NetLibDestroyServiceChild (
+        HttpService->ControllerHandle,
+        HttpService->Ip4DriverBindingHandle,
+        &gEfiTcp4ServiceBindingProtocolGuid,
+        HttpInstance->Tcp4ChildHandle
+        );
+    }
+
+    HttpInstance->Tcp4ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp4            = (EFI_TCP4_PROTOCOL *)Interface;
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Connection->RemoteAddr);
+  }
+
+  //
+  // Replace the TLS child of the instance with the one carrying the session.
+  //
+  if (Connection->UseHttps) {
+    if ((HttpInstance->TlsSb != NULL) && (HttpInstance->TlsChildHandle != NULL)) {
+      HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+    }
+
+    HttpInstance->TlsSb            = Connection->TlsSb;
+    HttpInstance->TlsChildHandle   = Connection->TlsChildHandle;
+    HttpInstance->Tls              = Connection->Tls;
+    HttpInstance->TlsConfiguration = Connection->TlsConfiguration;
+    CopyMem (&HttpInstance->TlsConfigData, &Connection->TlsConfigData, sizeof (TLS_CONFIG_DATA));
+    HttpInstance->TlsConfigData.VerifyHost.HostName = HttpInstance->RemoteHost;
+    HttpInstance->TlsSessionState                   = EfiTlsSessionDataTransferring;
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+  gBS->CloseEvent (Connection->IdleTimer);
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+
+  DEBUG ((DEBUG_INFO, "HttpPoolAdopt: Reuse the connection to %a:%d\n", HttpInstance->RemoteHost, HttpInstance->RemotePort));
+  return EFI_SUCCESS;
+}
+
+/**
+  Close a connection that is not in the connection pool, and release it.
+
+  @param[in]  HttpService        The HTTP service the connection belongs to.
+  @param[in]  Connection         The connection to release.
+
+**/
+VOID
+HttpPoolDestroy (
+  IN  HTTP_SERVICE          *HttpService,
+  IN  HTTP_POOL_CONNECTION  *Connection
+  )
+{
+  if ((Connection->TlsSb != NULL) && (Connection->TlsChildHandle != NULL)) {
+    Connection->TlsSb->DestroyChild (Connection->TlsSb, Connection->TlsChildHandle);
+  }
+
+  //
+  // Reset the idle connection, and destroy the TCP child.
+  //
+  if (Connection->UsingIpv6) {
+    Connection->Tcp6->Configure (Connection->Tcp6, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  } else {
+    Connection->Tcp4->Configure (Connection->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  }
+
+  gBS->CloseEvent (Connection->IdleTimer);
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+}
+
+/**
+  Close and release all the IPv4 or IPv6 connections in the connection pool.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          TRUE to release the IPv6 connections, FALSE
+                                 to release the IPv4 connections.
+
+**/
+VOID
+HttpPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  )
+{
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *NextEntry;
+  HTTP_POOL_CONNECTION  *Connection;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &HttpService->ConnectionPool) {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_POOL_CONNECTION, Link);
+    if (Connection->UsingIpv6 == UsingIpv6) {
+      HttpPoolRemove (HttpService, Connection);
+    }
+  }
+}
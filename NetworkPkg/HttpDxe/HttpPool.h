@@ -0,0 +1,129 @@
+/** @file
+  The header file of the pool of idle HTTP connections shared by the HTTP
+  instances of one HTTP service.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EFI_HTTP_POOL_H__
+#define __EFI_HTTP_POOL_H__
+
+//
+// Seconds an idle connection may stay in the pool before it is closed.
+//
+#define HTTP_POOL_IDLE_TIMEOUT  30
+
+//
+// An idle keep-alive connection, with its TCP child and, for HTTPS, the TLS
+// child that carries the established session. The TCP child stays opened
+// BY_DRIVER on the controller while the connection is in the pool.
+//
+typedef struct {
+  LIST_ENTRY                        Link;     // Link to ConnectionPool in HTTP_SERVICE.
+  EFI_EVENT                         IdleTimer;
+
+  BOOLEAN                           UsingIpv6;
+  BOOLEAN                           UseHttps;
+  CHAR8                             *RemoteHost;
+  UINT16                            RemotePort;
+  EFI_IPv4_ADDRESS                  RemoteAddr;
+  EFI_IPv6_ADDRESS                  RemoteIpv6Addr;
+  EFI_HTTPv4_ACCESS_POINT           IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT           Ipv6Node;
+
+  EFI_HANDLE                        TcpChildHandle;
+  EFI_TCP4_PROTOCOL                 *Tcp4;
+  EFI_TCP6_PROTOCOL                 *Tcp6;
+
+  EFI_SERVICE_BINDING_PROTOCOL      *TlsSb;
+  EFI_HANDLE                        TlsChildHandle;
+  EFI_TLS_PROTOCOL                  *Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL    *TlsConfiguration;
+  TLS_CONFIG_DATA                   TlsConfigData;
+} HTTP_POOL_CONNECTION;
+
+/**
+  Move the connection of a HTTP instance that is being cleaned up into the
+  connection pool of its service, if the connection can serve another request.
+
+  The connection is left with the instance if it is not established, the server
+  asked to close it, a message is still being received, or the pool is disabled.
+
+  @param[in, out]  HttpInstance       The HTTP instance being cleaned up.
+
+**/
+VOID
+HttpPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Remove an idle connection to the given server from the connection pool.
+
+  Connections that timed out or were closed by the server are released on the
+  way.
+
+  @param[in]  HttpInstance       The HTTP instance that is going to send a request.
+  @param[in]  HostName           The host name of the server.
+  @param[in]  RemotePort         The port of the server.
+
+  @return The connection taken from the pool, or NULL if there is none.
+
+**/
+HTTP_POOL_CONNECTION *
+HttpPoolTake (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *HostName,
+  IN  UINT16         RemotePort
+  );
+
+/**
+  Let a HTTP instance take over a connection returned by HttpPoolTake().
+
+  The connection is consumed in all cases. On success the TCP and TLS children
+  that the instance created for itself are released, and the instance is in the
+  HTTP_STATE_TCP_CONNECTED state. On failure the instance is left unchanged,
+  and it can connect to the server as usual.
+
+  @param[in, out]  HttpInstance       The HTTP instance.
+  @param[in]       Connection         The connection taken from the pool.
+
+  @retval EFI_SUCCESS            The instance owns the connection.
+  @retval Others                 The connection was released.
+
+**/
+EFI_STATUS
+HttpPoolAdopt (
+  IN OUT HTTP_PROTOCOL         *HttpInstance,
+  IN     HTTP_POOL_CONNECTION  *Connection
+  );
+
+/**
+  Close a connection that is not in the connection pool, and release it.
+
+  @param[in]  HttpService        The HTTP service the connection belongs to.
+  @param[in]  Connection         The connection to release.
+
+**/
+VOID
+HttpPoolDestroy (
+  IN  HTTP_SERVICE          *HttpService,
+  IN  HTTP_POOL_CONNECTION  *Connection
+  );
+
+/**
+  Close and release all the IPv4 or IPv6 connections in the connection pool.
+
+  @param[in]  HttpService        The HTTP service.
+  @param[in]  UsingIpv6          TRUE to release the IPv6 connections, FALSE
+                                 to release the IPv4 connections.
+
+**/
+VOID
+HttpPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  );
+
+#endif
@@ -48,17 +48,31 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_URL_BUFFER_LEN  4096
 
+//
+// Indexes of the values of HTTP_SERVICE.Statistics.
+//
+typedef enum {
+  HttpStatRequests,
+  HttpStatResponses,
+  HttpStatConnectionsReused,
+  HttpStatErrors,
+  HttpStatMax
+} HTTP_STATISTICS_INDEX;
+
 typedef struct _HTTP_SERVICE {
-  UINT32                          Signature;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  EFI_HANDLE                      Ip4DriverBindingHandle;
-  EFI_HANDLE                      Ip6DriverBindingHandle;
-  EFI_HANDLE                      ControllerHandle;
-  EFI_HANDLE                      Tcp4ChildHandle;
-  EFI_HANDLE                      Tcp6ChildHandle;
-  LIST_ENTRY                      ChildrenList;
-  UINTN                           ChildrenNumber;
-  INTN                            State;
+  UINT32                               Signature;
+  EFI_SERVICE_BINDING_PROTOCOL         ServiceBinding;
+  EFI_HANDLE                           Ip4DriverBindingHandle;
+  EFI_HANDLE                           Ip6DriverBindingHandle;
+  EFI_HANDLE                           ControllerHandle;
+  EFI_HANDLE                           Tcp4ChildHandle;
+  EFI_HANDLE                           Tcp6ChildHandle;
+  LIST_ENTRY                           ChildrenList;
+  UINTN                                ChildrenNumber;
+  INTN                                 State;
+  LIST_ENTRY                           ConnectionPool;
+  UINTN                                PoolCount;
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -28,8 +28,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define ISCSI_MAX_CONNS_PER_SESSION  1
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN  8192
-#define MAX_RECV_DATA_SEG_LEN_IN_FFP   65536
-#define DEFAULT_MAX_OUTSTANDING_R2T    1
+
+//
+// The values offered in the login operational parameters negotiation. The
+// Data-In PDUs are received straight into the buffer of the SCSI request,
+// so large data segments and bursts only save round trips with the target.
+//
+#define MAX_RECV_DATA_SEG_LEN_IN_FFP  262144
+#define MAX_BURST_LENGTH              1048576
+#define FIRST_BURST_LENGTH            262144
+#define MAX_OUTSTANDING_R2T           4
 
 #define ISCSI_VERSION_MAX  0x00
 #define ISCSI_VERSION_MIN  0x00
@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define _NET_LIB_H_
 
 #include <Protocol/Ip6.h>
+#include <Protocol/NetworkStatistics.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -2251,4 +2252,52 @@ NetLibCreateDnsQName (
   IN  CHAR16  *DomainName
   );
 
+//
+// Increase a value of the statistics returned by NetLibInstallStatistics(),
+// which may be NULL.
+//
+#define NET_STATISTICS_INC(Statistics, Index) \
+  do { \
+    if ((Statistics) != NULL) { \
+      (Statistics)->Values[(Index)]++; \
+    } \
+  } while (FALSE)
+
+/**
+  Create the statistics of a network layer, and install the
+  EDKII_NETWORK_STATISTICS_PROTOCOL that exposes them on a new handle.
+
+  @param[in]  Controller         The NIC controller the statistics belong to,
+                                 or NULL.
+  @param[in]  Layer              The name of the layer. It must stay valid
+                                 until the statistics are destroyed.
+  @param[in]  Count              The number of values.
+  @param[in]  Names              The names of the values. They must stay valid
+                                 until the statistics are destroyed.
+
+  @return The statistics, with all the values set to zero, or NULL if they
+          can't be created.
+
+**/
+EDKII_NETWORK_STATISTICS_PROTOCOL *
+EFIAPI
+NetLibCreateStatistics (
+  IN EFI_HANDLE           Controller OPTIONAL,
+  IN CONST CHAR16         *Layer,
+  IN UINTN                Count,
+  IN CONST CHAR16 *CONST  *Names
+  );
+
+/**
+  Uninstall and free the statistics created by NetLibCreateStatistics().
+
+  @param[in]  Statistics         The statistics to destroy, or NULL.
+
+**/
+VOID
+EFIAPI
+NetLibDestroyStatistics (
+  IN EDKII_NETWORK_STATISTICS_PROTOCOL  *Statistics OPTIONAL
+  );
+
 #endif
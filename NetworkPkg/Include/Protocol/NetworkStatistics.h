@@ -0,0 +1,57 @@
+/** @file
+  This file defines the EDKII Network Statistics Protocol interface.
+
+  Each layer of the network stack installs one instance of this protocol per
+  NIC it is bound to, on a handle of its own. The producer updates the values
+  in place as packets go through, so a consumer only has to read them.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_NETWORK_STATISTICS_H_
+#define EDKII_NETWORK_STATISTICS_H_
+
+#define EDKII_NETWORK_STATISTICS_PROTOCOL_GUID \
+  { \
+    0x8fc390d8, 0x0c3a, 0x42e9, {0xb3, 0x2e, 0x08, 0x1a, 0xc8, 0x5e, 0x73, 0x8a} \
+  }
+
+#define EDKII_NETWORK_STATISTICS_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_NETWORK_STATISTICS_PROTOCOL EDKII_NETWORK_STATISTICS_PROTOCOL;
+
+///
+/// EDKII Network Statistics Protocol.
+///
+struct _EDKII_NETWORK_STATISTICS_PROTOCOL {
+  ///
+  /// The revision of the protocol, EDKII_NETWORK_STATISTICS_PROTOCOL_REVISION.
+  ///
+  UINT64                       Revision;
+  ///
+  /// The NIC controller the statistics belong to, or NULL if they are not
+  /// specific to a NIC.
+  ///
+  EFI_HANDLE                   Controller;
+  ///
+  /// The name of the layer, for example L"TCPv4".
+  ///
+  CONST CHAR16                 *Layer;
+  ///
+  /// The number of entries of Names and Values.
+  ///
+  UINTN                        Count;
+  ///
+  /// The names of the values.
+  ///
+  CONST CHAR16 *CONST          *Names;
+  ///
+  /// The values, counters unless the name says otherwise. They are only
+  /// written by the producer, at or below TPL_NOTIFY.
+  ///
+  UINT64                       *Values;
+};
+
+extern EFI_GUID  gEdkiiNetworkStatisticsProtocolGuid;
+
+#endif
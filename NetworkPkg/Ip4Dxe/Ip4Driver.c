@@ -21,6 +21,19 @@ EFI_DRIVER_BINDING_PROTOCOL  gIp4DriverBinding = {
 
 BOOLEAN  mIpSec2Installed = FALSE;
 
+//
+// The names of the values of IP4_SERVICE.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mIp4StatisticsNames[Ip4StatMax] = {
+  L"InReceives",
+  L"InFragments",
+  L"InReassembled",
+  L"InReassemblyTimeouts",
+  L"InDelivers",
+  L"OutRequests",
+  L"OutNoRoutes"
+};
+
 /**
    Callback function for IpSec2 Protocol install.
 
@@ -377,6 +390,7 @@ Ip4CreateService (
   }
 
   IpSb->OldMaxPacketSize = IpSb->MaxPacketSize;
+  IpSb->Statistics       = NetLibCreateStatistics (Controller, L"IPv4", Ip4StatMax, mIp4StatisticsNames);
   *Service               = IpSb;
 
   return EFI_SUCCESS;
@@ -441,6 +455,9 @@ Ip4CleanService (
 
   Ip4CleanAssembleTable (&IpSb->Assemble);
 
+  NetLibDestroyStatistics (IpSb->Statistics);
+  IpSb->Statistics = NULL;
+
   if (IpSb->MnpChildHandle != NULL) {
     if (IpSb->Mnp != NULL) {
       gBS->CloseProtocol (
@@ -161,6 +161,20 @@ struct _IP4_PROTOCOL {
   EFI_IP4_CONFIG_DATA    ConfigData;
 };
 
+//
+// Indexes of the values of IP4_SERVICE.Statistics.
+//
+typedef enum {
+  Ip4StatInReceives,
+  Ip4StatInFragments,
+  Ip4StatInReassembled,
+  Ip4StatInReassemblyTimeouts,
+  Ip4StatInDelivers,
+  Ip4StatOutRequests,
+  Ip4StatOutNoRoutes,
+  Ip4StatMax
+} IP4_STATISTICS_INDEX;
+
 struct _IP4_SERVICE {
   UINT32                             Signature;
   EFI_SERVICE_BINDING_PROTOCOL       ServiceBinding;
@@ -216,6 +230,12 @@ struct _IP4_SERVICE {
 
   UINT32                             MaxPacketSize;
   UINT32                             OldMaxPacketSize; ///< The MTU before IPsec enable.
+
+  //
+  // The statistics exposed through EDKII_NETWORK_STATISTICS_PROTOCOL,
+  // indexed by IP4_STATISTICS_INDEX. It may be NULL.
+  //
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 };
 
 #define IP4_INSTANCE_FROM_PROTOCOL(Ip4) \
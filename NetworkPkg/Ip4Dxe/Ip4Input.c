@@ -264,18 +264,22 @@ Ip4Reassemble (
   //
   // Find the point to insert the packet: before the first
   // fragment with THIS.Start < CUR.Start. the previous one
-  // has PREV.Start <= THIS.Start < CUR.Start.
+  // has PREV.Start <= THIS.Start < CUR.Start. The fragments
+  // are sorted by Start, and usually arrive in order, so walk
+  // the list backward from the last fragment.
   //
   Head = &Assemble->Fragments;
 
-  NET_LIST_FOR_EACH (Cur, Head) {
-    Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
+  for (Prev = Head->BackLink; Prev != Head; Prev = Prev->BackLink) {
+    Fragment = NET_LIST_USER_STRUCT (Prev, NET_BUF, List);
 
-    if (This->Start < IP4_GET_CLIP_INFO (Fragment)->Start) {
+    if (IP4_GET_CLIP_INFO (Fragment)->Start <= This->Start) {
       break;
     }
   }
 
+  Cur = Prev->ForwardLink;
+
   //
   // Check whether the current fragment overlaps with the previous one.
   // It holds that: PREV.Start <= THIS.Start < THIS.End. Only need to
@@ -784,6 +788,7 @@ Ip4PreProcessPacket (
       return EFI_INVALID_PARAMETER;
     }
 
+    NET_STATISTICS_INC (IpSb->Statistics, Ip4StatInFragments);
     *Packet = Ip4Reassemble (&IpSb->Assemble, *Packet);
 
     //
@@ -792,6 +797,8 @@ Ip4PreProcessPacket (
     if (*Packet == NULL) {
       return EFI_INVALID_PARAMETER;
     }
+
+    NET_STATISTICS_INC (IpSb->Statistics, Ip4StatInReassembled);
   }
 
   return EFI_SUCCESS;
@@ -857,6 +864,8 @@ Ip4AccpetFrame (
     goto DROP;
   }
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip4StatInReceives);
+
   if (!Ip4IsValidPacketLength (Packet)) {
     goto RESTART;
   }
@@ -934,6 +943,8 @@ Ip4AccpetFrame (
   Head                               = Packet->Ip.Ip4;
   IP4_GET_CLIP_INFO (Packet)->Status = EFI_SUCCESS;
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip4StatInDelivers);
+
   switch (Head->Protocol) {
     case EFI_IP_PROTO_ICMP:
       Ip4IcmpHandle (IpSb, Head, Packet);
@@ -1576,6 +1587,7 @@ Ip4PacketTimerTicking (
       Assemble = NET_LIST_USER_STRUCT (Entry, IP4_ASSEMBLE_ENTRY, Link);
 
       if ((Assemble->Life > 0) && (--Assemble->Life == 0)) {
+        NET_STATISTICS_INC (IpSb->Statistics, Ip4StatInReassemblyTimeouts);
         RemoveEntryList (Entry);
         Ip4FreeAssembleEntry (Assemble);
       }
@@ -227,6 +227,8 @@ Ip4Output (
   UINT32                 Num;
   BOOLEAN                RawData;
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip4StatOutRequests);
+
   //
   // Select an interface/source for system packet, application
   // should select them itself.
@@ -310,6 +312,7 @@ Ip4Output (
     }
 
     if (CacheEntry == NULL) {
+      NET_STATISTICS_INC (IpSb->Statistics, Ip4StatOutNoRoutes);
       return EFI_NOT_FOUND;
     }
 
@@ -273,6 +273,42 @@ Ip4PurgeRouteCache (
   }
 }
 
+/**
+  Remove all the cache entries to a destination on the network. When
+  a route entry is added, the cache entries to its network may have
+  been spawned from a less specific route, so they are deleted to have
+  the next packets routed through the new route entry.
+
+  @param  RtCache               Route cache to remove the entries from
+  @param  Dest                  The destination network
+  @param  Netmask               The netmask of the Dest
+
+**/
+STATIC
+VOID
+Ip4PurgeRouteCacheByNet (
+  IN OUT IP4_ROUTE_CACHE  *RtCache,
+  IN     IP4_ADDR         Dest,
+  IN     IP4_ADDR         Netmask
+  )
+{
+  LIST_ENTRY             *Entry;
+  LIST_ENTRY             *Next;
+  IP4_ROUTE_CACHE_ENTRY  *RtCacheEntry;
+  UINT32                 Index;
+
+  for (Index = 0; Index < IP4_ROUTE_CACHE_HASH_VALUE; Index++) {
+    NET_LIST_FOR_EACH_SAFE (Entry, Next, &RtCache->CacheBucket[Index]) {
+      RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
+
+      if (IP4_NET_EQUAL (RtCacheEntry->Dest, Dest, Netmask)) {
+        RemoveEntryList (Entry);
+        Ip4FreeRouteCacheEntry (RtCacheEntry);
+      }
+    }
+  }
+}
+
 /**
   Add a route entry to the route table. All the IP4_ADDRs are in
   host byte order.
@@ -332,6 +368,8 @@ Ip4AddRoute (
   InsertHeadList (Head, &RtEntry->Link);
   RtTable->TotalNum++;
 
+  Ip4PurgeRouteCacheByNet (&RtTable->Cache, Dest, Netmask);
+
   return EFI_SUCCESS;
 }
 
@@ -266,7 +266,7 @@ Ip6ConfigStartStatefulAutoConfig (
     Dhcp6CfgData.IaDescriptor.IaId     = Instance->IaId;
     Dhcp6CfgData.IaInfoEvent           = Instance->Dhcp6Event;
     Dhcp6CfgData.ReconfigureAccept     = FALSE;
-    Dhcp6CfgData.RapidCommit           = FALSE;
+    Dhcp6CfgData.RapidCommit           = PcdGetBool (PcdDhcpCachedLease);
     Dhcp6CfgData.SolicitRetransmission = NULL;
 
     Status = Dhcp6->Configure (Dhcp6, &Dhcp6CfgData);
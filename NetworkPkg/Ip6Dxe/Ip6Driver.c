@@ -21,6 +21,19 @@ EFI_DRIVER_BINDING_PROTOCOL  gIp6DriverBinding = {
 
 BOOLEAN  mIpSec2Installed = FALSE;
 
+//
+// The names of the values of IP6_SERVICE.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mIp6StatisticsNames[Ip6StatMax] = {
+  L"InReceives",
+  L"InFragments",
+  L"InReassembled",
+  L"InReassemblyTimeouts",
+  L"InDelivers",
+  L"OutRequests",
+  L"OutNoRoutes"
+};
+
 /**
    Callback function for IpSec2 Protocol install.
 
@@ -203,6 +216,9 @@ Ip6CleanService (
 
   Ip6CleanAssembleTable (&IpSb->Assemble);
 
+  NetLibDestroyStatistics (IpSb->Statistics);
+  IpSb->Statistics = NULL;
+
   if (IpSb->MnpChildHandle != NULL) {
     if (IpSb->Mnp != NULL) {
       IpSb->Mnp->Cancel (IpSb->Mnp, NULL);
@@ -266,6 +282,7 @@ Ip6CreateService (
   EFI_STATUS                            Status;
   EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *MnpToken;
   EFI_MANAGED_NETWORK_CONFIG_DATA       *Config;
+  UINTN                                 Index;
 
   ASSERT (Service != NULL);
 
@@ -325,6 +342,12 @@ Ip6CreateService (
   IpSb->RoundRobin = 0;
 
   InitializeListHead (&IpSb->NeighborTable);
+  for (Index = 0; Index < IP6_NEIGHBOR_HASH_SIZE; Index++) {
+    InitializeListHead (&IpSb->NeighborHash[Index]);
+  }
+
+  IpSb->NeighborCount = 0;
+
   InitializeListHead (&IpSb->DefaultRouterList);
   InitializeListHead (&IpSb->OnlinkPrefix);
   InitializeListHead (&IpSb->AutonomousPrefix);
@@ -482,7 +505,8 @@ Ip6CreateService (
 
   InsertHeadList (&IpSb->Interfaces, &IpSb->DefaultInterface->Link);
 
-  *Service = IpSb;
+  IpSb->Statistics = NetLibCreateStatistics (Controller, L"IPv6", Ip6StatMax, mIp6StatisticsNames);
+  *Service         = IpSb;
   return EFI_SUCCESS;
 
 ON_ERROR:
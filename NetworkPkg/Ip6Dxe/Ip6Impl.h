@@ -38,6 +38,7 @@
 #include <Library/UefiHiiServicesLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 
 #include <Guid/MdeModuleHii.h>
 
@@ -157,6 +158,20 @@ struct _IP6_PROTOCOL {
   BOOLEAN                InDestroy;
 };
 
+//
+// Indexes of the values of IP6_SERVICE.Statistics.
+//
+typedef enum {
+  Ip6StatInReceives,
+  Ip6StatInFragments,
+  Ip6StatInReassembled,
+  Ip6StatInReassemblyTimeouts,
+  Ip6StatInDelivers,
+  Ip6StatOutRequests,
+  Ip6StatOutNoRoutes,
+  Ip6StatMax
+} IP6_STATISTICS_INDEX;
+
 struct _IP6_SERVICE {
   UINT32                             Signature;
   EFI_SERVICE_BINDING_PROTOCOL       ServiceBinding;
@@ -197,6 +212,8 @@ struct _IP6_SERVICE {
   UINT32                             ReachableTime;
   UINT32                             RetransTimer;
   LIST_ENTRY                         NeighborTable;
+  LIST_ENTRY                         NeighborHash[IP6_NEIGHBOR_HASH_SIZE];
+  UINT32                             NeighborCount;
 
   LIST_ENTRY                         OnlinkPrefix;
   LIST_ENTRY                         AutonomousPrefix;
@@ -238,6 +255,12 @@ struct _IP6_SERVICE {
   CHAR16                             *MacString;
   UINT32                             MaxPacketSize;
   UINT32                             OldMaxPacketSize;
+
+  //
+  // The statistics exposed through EDKII_NETWORK_STATISTICS_PROTOCOL,
+  // indexed by IP6_STATISTICS_INDEX. It may be NULL.
+  //
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 };
 
 /**
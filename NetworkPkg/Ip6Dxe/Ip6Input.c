@@ -911,11 +911,14 @@ Ip6PreProcessPacket (
     //
     // Reassemble the packet.
     //
+    NET_STATISTICS_INC (IpSb->Statistics, Ip6StatInFragments);
     *Packet = Ip6Reassemble (&IpSb->Assemble, *Packet);
     if (*Packet == NULL) {
       return EFI_INVALID_PARAMETER;
     }
 
+    NET_STATISTICS_INC (IpSb->Statistics, Ip6StatInReassembled);
+
     //
     // Re-check the assembled packet to get the right values.
     //
@@ -1003,6 +1006,8 @@ Ip6AcceptFrame (
     goto Drop;
   }
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip6StatInReceives);
+
   //
   // Pre-Process the Ipv6 Packet and then reassemble if it is necessary.
   //
@@ -1075,6 +1080,8 @@ Ip6AcceptFrame (
   Head                               = Packet->Ip.Ip6;
   IP6_GET_CLIP_INFO (Packet)->Status = EFI_SUCCESS;
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip6StatInDelivers);
+
   switch (*LastHead) {
     case IP6_ICMP:
       Ip6IcmpHandle (IpSb, Head, Packet);
@@ -1758,6 +1765,8 @@ Ip6PacketTimerTicking (
       Assemble = NET_LIST_USER_STRUCT (Entry, IP6_ASSEMBLE_ENTRY, Link);
 
       if ((Assemble->Life > 0) && (--Assemble->Life == 0)) {
+        NET_STATISTICS_INC (IpSb->Statistics, Ip6StatInReassemblyTimeouts);
+
         //
         // If the first fragment (the one with a Fragment Offset of zero)
         // has been received, an ICMP Time Exceeded - Fragment Reassembly
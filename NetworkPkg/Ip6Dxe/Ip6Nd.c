@@ -476,6 +476,58 @@ Ip6OnArpResolved (
   }
 }
 
+/**
+  Compute the neighbor cache hash bucket of an IPv6 address, from the low order
+  bits of its interface identifier.
+
+  @param[in]  Ip6Address        Points to the IPv6 address of the neighbor.
+
+  @return The index of the hash bucket.
+
+**/
+STATIC
+UINTN
+Ip6NeighborHash (
+  IN EFI_IPv6_ADDRESS  *Ip6Address
+  )
+{
+  UINT32  Value;
+
+  Value = ((UINT32)Ip6Address->Addr[12] << 24) | ((UINT32)Ip6Address->Addr[13] << 16) |
+          ((UINT32)Ip6Address->Addr[14] << 8) | (UINT32)Ip6Address->Addr[15];
+
+  return Value % IP6_NEIGHBOR_HASH_SIZE;
+}
+
+/**
+  Make room in a full neighbor cache by removing the least recently used stale
+  entry. Entries that are being resolved, have queued frames, are static, or
+  belong to a default router are kept.
+
+  @param[in]  IpSb              The pointer to the IP6_SERVICE instance.
+
+**/
+STATIC
+VOID
+Ip6EvictNeighborEntry (
+  IN IP6_SERVICE  *IpSb
+  )
+{
+  LIST_ENTRY          *Entry;
+  IP6_NEIGHBOR_ENTRY  *Neighbor;
+
+  for (Entry = IpSb->NeighborTable.BackLink; Entry != &IpSb->NeighborTable; Entry = Entry->BackLink) {
+    Neighbor = NET_LIST_USER_STRUCT (Entry, IP6_NEIGHBOR_ENTRY, Link);
+
+    if ((Neighbor->State == EfiNeighborStale) && !Neighbor->IsRouter && !Neighbor->ArpFree &&
+        IsListEmpty (&Neighbor->Frames) && (Ip6FindDefaultRouter (IpSb, &Neighbor->Neighbor) == NULL))
+    {
+      Ip6FreeNeighborEntry (IpSb, Neighbor, FALSE, TRUE, EFI_ABORTED, NULL, NULL);
+      return;
+    }
+  }
+}
+
 /**
   Allocate and initialize an IP6 neighbor cache entry.
 
@@ -504,6 +556,10 @@ Ip6CreateNeighborEntry (
   NET_CHECK_SIGNATURE (IpSb, IP6_SERVICE_SIGNATURE);
   ASSERT (Ip6Address != NULL);
 
+  if (IpSb->NeighborCount >= IP6_NEIGHBOR_CACHE_MAX) {
+    Ip6EvictNeighborEntry (IpSb);
+  }
+
   Entry = AllocateZeroPool (sizeof (IP6_NEIGHBOR_ENTRY));
   if (Entry == NULL) {
     return NULL;
@@ -529,6 +585,8 @@ Ip6CreateNeighborEntry (
   }
 
   InsertHeadList (&IpSb->NeighborTable, &Entry->Link);
+  InsertHeadList (&IpSb->NeighborHash[Ip6NeighborHash (Ip6Address)], &Entry->HashLink);
+  IpSb->NeighborCount++;
 
   //
   // If corresponding default router entry exists, establish the relationship.
@@ -558,17 +616,20 @@ Ip6FindNeighborEntry (
   )
 {
   LIST_ENTRY          *Entry;
-  LIST_ENTRY          *Next;
   IP6_NEIGHBOR_ENTRY  *Neighbor;
 
   NET_CHECK_SIGNATURE (IpSb, IP6_SERVICE_SIGNATURE);
   ASSERT (Ip6Address != NULL);
 
-  NET_LIST_FOR_EACH_SAFE (Entry, Next, &IpSb->NeighborTable) {
-    Neighbor = NET_LIST_USER_STRUCT (Entry, IP6_NEIGHBOR_ENTRY, Link);
+  NET_LIST_FOR_EACH (Entry, &IpSb->NeighborHash[Ip6NeighborHash (Ip6Address)]) {
+    Neighbor = NET_LIST_USER_STRUCT (Entry, IP6_NEIGHBOR_ENTRY, HashLink);
     if (EFI_IP6_EQUAL (Ip6Address, &Neighbor->Neighbor)) {
-      RemoveEntryList (Entry);
-      InsertHeadList (&IpSb->NeighborTable, Entry);
+      //
+      // Promote the entry to the head of the neighbor table, so that the
+      // tail holds the least recently used entries. LRU
+      //
+      RemoveEntryList (&Neighbor->Link);
+      InsertHeadList (&IpSb->NeighborTable, &Neighbor->Link);
 
       return Neighbor;
     }
@@ -658,6 +719,8 @@ Ip6FreeNeighborEntry (
     }
 
     RemoveEntryList (&NeighborCache->Link);
+    RemoveEntryList (&NeighborCache->HashLink);
+    IpSb->NeighborCount--;
     FreePool (NeighborCache);
   }
 
@@ -2757,6 +2820,8 @@ Ip6DelNeighbor (
   }
 
   RemoveEntryList (&Neighbor->Link);
+  RemoveEntryList (&Neighbor->HashLink);
+  IpSb->NeighborCount--;
   FreePool (Neighbor);
 
   return EFI_SUCCESS;
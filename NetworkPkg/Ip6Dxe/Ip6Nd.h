@@ -12,6 +12,14 @@
 
 #define IP6_GET_TICKS(Ms)  (((Ms) + IP6_TIMER_INTERVAL_IN_MS - 1) / IP6_TIMER_INTERVAL_IN_MS)
 
+///
+/// The neighbor cache is hashed on the interface identifier of the neighbor.
+/// Beyond IP6_NEIGHBOR_CACHE_MAX entries, creating an entry evicts the least
+/// recently used stale entry.
+///
+#define IP6_NEIGHBOR_HASH_SIZE  31
+#define IP6_NEIGHBOR_CACHE_MAX  256
+
 enum {
   IP6_INF_ROUTER_LIFETIME = 0xFFFF,
 
@@ -124,7 +132,8 @@ typedef struct _IP6_DELAY_JOIN_LIST {
 } IP6_DELAY_JOIN_LIST;
 
 typedef struct _IP6_NEIGHBOR_ENTRY {
-  LIST_ENTRY                Link;
+  LIST_ENTRY                Link;       ///< Link to NeighborTable, most recently used first
+  LIST_ENTRY                HashLink;   ///< Link to the NeighborHash bucket
   LIST_ENTRY                ArpList;
   INTN                      RefCnt;
   BOOLEAN                   IsRouter;
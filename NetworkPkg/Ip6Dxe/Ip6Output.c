@@ -523,6 +523,8 @@ Ip6Output (
 
   NET_CHECK_SIGNATURE (IpSb, IP6_SERVICE_SIGNATURE);
 
+  NET_STATISTICS_INC (IpSb->Statistics, Ip6StatOutRequests);
+
   //
   // RFC2460: Each extension header is an integer multiple of 8 octets long,
   // in order to retain 8-octet alignment for subsequent headers.
@@ -702,6 +704,7 @@ Ip6Output (
       //
       RouteCache = Ip6Route (IpSb, &Head->DestinationAddress, &Head->SourceAddress);
       if (RouteCache == NULL) {
+        NET_STATISTICS_INC (IpSb->Statistics, Ip6StatOutNoRoutes);
         return EFI_NOT_FOUND;
       }
 
@@ -3373,3 +3373,95 @@ NetLibCreateDnsQName (
 
   return QueryName;
 }
+
+//
+// The statistics of a network layer, and the handle the protocol is on.
+//
+typedef struct {
+  EDKII_NETWORK_STATISTICS_PROTOCOL    Protocol;
+  EFI_HANDLE                           Handle;
+  UINT64                               Values[1];
+} NET_STATISTICS;
+
+/**
+  Create the statistics of a network layer, and install the
+  EDKII_NETWORK_STATISTICS_PROTOCOL that exposes them on a new handle.
+
+  @param[in]  Controller         The NIC controller the statistics belong to,
+                                 or NULL.
+  @param[in]  Layer              The name of the layer. It must stay valid
+                                 until the statistics are destroyed.
+  @param[in]  Count              The number of values.
+  @param[in]  Names              The names of the values. They must stay valid
+                                 until the statistics are destroyed.
+
+  @return The statistics, with all the values set to zero, or NULL if they
+          can't be created.
+
+**/
+EDKII_NETWORK_STATISTICS_PROTOCOL *
+EFIAPI
+NetLibCreateStatistics (
+  IN EFI_HANDLE           Controller OPTIONAL,
+  IN CONST CHAR16         *Layer,
+  IN UINTN                Count,
+  IN CONST CHAR16 *CONST  *Names
+  )
+{
+  NET_STATISTICS  *Statistics;
+  EFI_STATUS      Status;
+
+  ASSERT ((Layer != NULL) && (Names != NULL) && (Count != 0));
+
+  Statistics = AllocateZeroPool (OFFSET_OF (NET_STATISTICS, Values) + Count * sizeof (UINT64));
+  if (Statistics == NULL) {
+    return NULL;
+  }
+
+  Statistics->Protocol.Revision   = EDKII_NETWORK_STATISTICS_PROTOCOL_REVISION;
+  Statistics->Protocol.Controller = Controller;
+  Statistics->Protocol.Layer      = Layer;
+  Statistics->Protocol.Count      = Count;
+  Statistics->Protocol.Names      = Names;
+  Statistics->Protocol.Values     = Statistics->Values;
+
+  Status = gBS->InstallProtocolInterface (
+                  &Statistics->Handle,
+                  &gEdkiiNetworkStatisticsProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  &Statistics->Protocol
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (Statistics);
+    return NULL;
+  }
+
+  return &Statistics->Protocol;
+}
+
+/**
+  Uninstall and free the statistics created by NetLibCreateStatistics().
+
+  @param[in]  Statistics         The statistics to destroy, or NULL.
+
+**/
+VOID
+EFIAPI
+NetLibDestroyStatistics (
+  IN EDKII_NETWORK_STATISTICS_PROTOCOL  *Statistics OPTIONAL
+  )
+{
+  NET_STATISTICS  *Instance;
+
+  if (Statistics == NULL) {
+    return;
+  }
+
+  Instance = BASE_CR (Statistics, NET_STATISTICS, Protocol);
+  gBS->UninstallProtocolInterface (
+         Instance->Handle,
+         &gEdkiiNetworkStatisticsProtocolGuid,
+         &Instance->Protocol
+         );
+  FreePool (Instance);
+}
@@ -14,6 +14,212 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+//
+// NET_BUF and NET_VECTOR structures with up to NET_BUF_CACHE_BLOCKS blocks
+// are allocated with room for NET_BUF_CACHE_BLOCKS blocks, and up to
+// NET_BUF_CACHE_DEPTH of them are kept for reuse when they are freed. Every
+// packet sent or received allocates several of them.
+//
+#define NET_BUF_CACHE_BLOCKS  4
+#define NET_BUF_CACHE_DEPTH   64
+
+typedef struct {
+  UINTN    Count;
+  VOID     *Entry[NET_BUF_CACHE_DEPTH];
+} NET_BUF_CACHE;
+
+STATIC NET_BUF_CACHE  mNetBufCache;
+STATIC NET_BUF_CACHE  mNetVectorCache;
+
+/**
+  Allocate a zeroed structure, from the cache if it fits in a cached entry.
+
+  @param[in, out]  Cache          The cache to allocate from.
+  @param[in]       EntrySize      The size of the entries in the cache.
+  @param[in]       Size           The size of the structure.
+
+  @return  Pointer to the structure, or NULL if the allocation failed.
+
+**/
+STATIC
+VOID *
+NetbufCacheAlloc (
+  IN OUT NET_BUF_CACHE  *Cache,
+  IN     UINTN          EntrySize,
+  IN     UINTN          Size
+  )
+{
+  VOID     *Buffer;
+  EFI_TPL  OldTpl;
+
+  if (Size > EntrySize) {
+    return AllocateZeroPool (Size);
+  }
+
+  Buffer = NULL;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Cache->Count != 0) {
+    Cache->Count--;
+    Buffer = Cache->Entry[Cache->Count];
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Buffer == NULL) {
+    return AllocateZeroPool (EntrySize);
+  }
+
+  return ZeroMem (Buffer, Size);
+}
+
+/**
+  Free a structure allocated by NetbufCacheAlloc().
+
+  @param[in, out]  Cache          The cache the structure was allocated from.
+  @param[in]       EntrySize      The size of the entries in the cache.
+  @param[in]       Size           The size of the structure.
+  @param[in]       Buffer         Pointer to the structure.
+
+**/
+STATIC
+VOID
+NetbufCacheFree (
+  IN OUT NET_BUF_CACHE  *Cache,
+  IN     UINTN          EntrySize,
+  IN     UINTN          Size,
+  IN     VOID           *Buffer
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Size <= EntrySize) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Cache->Count < NET_BUF_CACHE_DEPTH) {
+      Cache->Entry[Cache->Count] = Buffer;
+      Cache->Count++;
+      Buffer = NULL;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+}
+
+/**
+  Allocate a zeroed NET_BUF structure.
+
+  @param[in]  BlockOpNum     The number of NET_BLOCK_OP in the net buffer.
+
+  @return  Pointer to the structure, or NULL if the allocation failed.
+
+**/
+STATIC
+NET_BUF *
+NetbufAllocNbufMem (
+  IN UINT32  BlockOpNum
+  )
+{
+  return NetbufCacheAlloc (
+           &mNetBufCache,
+           NET_BUF_SIZE (NET_BUF_CACHE_BLOCKS),
+           NET_BUF_SIZE (BlockOpNum)
+           );
+}
+
+/**
+  Free a NET_BUF structure allocated by NetbufAllocNbufMem().
+
+  @param[in]  Nbuf           Pointer to the NET_BUF structure.
+
+**/
+STATIC
+VOID
+NetbufFreeNbufMem (
+  IN NET_BUF  *Nbuf
+  )
+{
+  NetbufCacheFree (
+    &mNetBufCache,
+    NET_BUF_SIZE (NET_BUF_CACHE_BLOCKS),
+    NET_BUF_SIZE (Nbuf->BlockOpNum),
+    Nbuf
+    );
+}
+
+/**
+  Allocate a zeroed NET_VECTOR structure.
+
+  @param[in]  BlockNum       The number of NET_BLOCK in the vector.
+
+  @return  Pointer to the structure, or NULL if the allocation failed.
+
+**/
+STATIC
+NET_VECTOR *
+NetbufAllocVectorMem (
+  IN UINT32  BlockNum
+  )
+{
+  return NetbufCacheAlloc (
+           &mNetVectorCache,
+           NET_VECTOR_SIZE (NET_BUF_CACHE_BLOCKS),
+           NET_VECTOR_SIZE (BlockNum)
+           );
+}
+
+/**
+  Free a NET_VECTOR structure allocated by NetbufAllocVectorMem().
+
+  @param[in]  Vector         Pointer to the NET_VECTOR structure.
+
+**/
+STATIC
+VOID
+NetbufFreeVectorMem (
+  IN NET_VECTOR  *Vector
+  )
+{
+  NetbufCacheFree (
+    &mNetVectorCache,
+    NET_VECTOR_SIZE (NET_BUF_CACHE_BLOCKS),
+    NET_VECTOR_SIZE (Vector->BlockNum),
+    Vector
+    );
+}
+
+/**
+  Release the NET_BUF and NET_VECTOR structures kept for reuse when the
+  image the library is linked into is unloaded.
+
+  @param[in]  ImageHandle    The image handle of the module.
+  @param[in]  SystemTable    Pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS        The structures are released.
+
+**/
+EFI_STATUS
+EFIAPI
+NetbufCacheDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  while (mNetBufCache.Count != 0) {
+    mNetBufCache.Count--;
+    FreePool (mNetBufCache.Entry[mNetBufCache.Count]);
+  }
+
+  while (mNetVectorCache.Count != 0) {
+    mNetVectorCache.Count--;
+    FreePool (mNetVectorCache.Entry[mNetVectorCache.Count]);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,7 +248,7 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetbufAllocNbufMem (BlockOpNum);
 
   if (Nbuf == NULL) {
     return NULL;
@@ -54,7 +260,7 @@ NetbufAllocStruct (
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NetbufAllocVectorMem (BlockNum);
 
     if (Vector == NULL) {
       goto FreeNbuf;
@@ -70,7 +276,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufFreeNbufMem (Nbuf);
   return NULL;
 }
 
@@ -124,7 +330,8 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  NetbufFreeVectorMem (Nbuf->Vector);
+  NetbufFreeNbufMem (Nbuf);
   return NULL;
 }
 
@@ -175,7 +382,7 @@ NetbufFreeVector (
     }
   }
 
-  FreePool (Vector);
+  NetbufFreeVectorMem (Vector);
 }
 
 /**
@@ -208,7 +415,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeNbufMem (Nbuf);
   }
 }
 
@@ -234,7 +441,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetbufAllocNbufMem (Nbuf->BlockOpNum);
 
   if (Clone == NULL) {
     return NULL;
@@ -662,7 +869,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetbufFreeVectorMem (Child->Vector);
+  NetbufFreeNbufMem (Child);
   return NULL;
 }
 
@@ -1617,7 +1825,8 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64  Sum;
+  UINT32  *Word;
 
   Sum = 0;
 
@@ -1628,6 +1837,36 @@ NetblockChecksum (
     Sum += *(Bulk + Len - 1);
   }
 
+  //
+  // The one's complement sum of 32-bit words folds to the same value
+  // as the sum of 16-bit words, since 2^16 is 1 modulo 0xffff. Sum the
+  // aligned part of the data 16 bytes at a time into a 64-bit
+  // accumulator, which can't overflow for any UINT32 length.
+  //
+  if ((((UINTN)Bulk & 0x01) == 0) && (Len >= 2) && (((UINTN)Bulk & 0x02) != 0)) {
+    Sum  += *(UINT16 *)Bulk;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  if (((UINTN)Bulk & 0x03) == 0) {
+    Word = (UINT32 *)Bulk;
+
+    while (Len >= 16) {
+      Sum  += (UINT64)Word[0] + Word[1] + Word[2] + Word[3];
+      Word += 4;
+      Len  -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Word;
+      Word++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *)Word;
+  }
+
   while (Len > 1) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
@@ -1635,10 +1874,10 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 16 bits
   //
   while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+    Sum = (Sum & 0xffff) + RShiftU64 (Sum, 16);
   }
 
   return (UINT16)Sum;
@@ -1840,7 +2079,7 @@ NetIpSecNetbufFree (
       FreePool (Nbuf->Vector->Block[0].Bulk);
     }
 
-    FreePool (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeVectorMem (Nbuf->Vector);
+    NetbufFreeNbufMem (Nbuf);
   }
 }
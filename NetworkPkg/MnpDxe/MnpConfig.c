@@ -38,6 +38,17 @@ EFI_MANAGED_NETWORK_CONFIG_DATA  mMnpDefaultConfigData = {
   FALSE
 };
 
+//
+// The names of the values of MNP_DEVICE_DATA.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mMnpStatisticsNames[MnpStatMax] = {
+  L"RxFrames",
+  L"RxUndelivered",
+  L"RxQueueDrops",
+  L"TxFrames",
+  L"TxErrors"
+};
+
 /**
   Add Count of net buffers to MnpDeviceData->FreeNbufQue. The length of the net
   buffer is specified by MnpDeviceData->BufferLength.
@@ -512,6 +523,9 @@ MnpInitializeDeviceData (
   InitializeListHead (&MnpDeviceData->AllTxBufList);
   MnpDeviceData->TxBufCount = 0;
 
+  InitializeListHead (&MnpDeviceData->FreeRxDataWrapList);
+  MnpDeviceData->FreeRxDataWrapCount = 0;
+
   //
   // Create the system poll timer.
   //
@@ -560,6 +574,13 @@ MnpInitializeDeviceData (
     goto ERROR;
   }
 
+  MnpDeviceData->Statistics = NetLibCreateStatistics (
+                                ControllerHandle,
+                                L"MNP",
+                                MnpStatMax,
+                                mMnpStatisticsNames
+                                );
+
 ERROR:
   if (EFI_ERROR (Status)) {
     //
@@ -619,9 +640,12 @@ MnpDestroyDeviceData (
   LIST_ENTRY       *Entry;
   LIST_ENTRY       *NextEntry;
   MNP_TX_BUF_WRAP  *TxBufWrap;
+  MNP_RXDATA_WRAP  *RxDataWrap;
 
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  NetLibDestroyStatistics (MnpDeviceData->Statistics);
+
   //
   // Free Vlan Config variable name string
   //
@@ -653,6 +677,18 @@ MnpDestroyDeviceData (
   ASSERT (IsListEmpty (&MnpDeviceData->AllTxBufList));
   ASSERT (MnpDeviceData->TxBufCount == 0);
 
+  //
+  // Free the recycled RxDataWraps.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &MnpDeviceData->FreeRxDataWrapList) {
+    RxDataWrap = NET_LIST_USER_STRUCT (Entry, MNP_RXDATA_WRAP, WrapEntry);
+    RemoveEntryList (Entry);
+    gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+    FreePool (RxDataWrap);
+    MnpDeviceData->FreeRxDataWrapCount--;
+  }
+  ASSERT (MnpDeviceData->FreeRxDataWrapCount == 0);
+
   //
   // Free the RxNbufCache.
   //
@@ -1273,6 +1309,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
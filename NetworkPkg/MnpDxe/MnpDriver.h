@@ -37,6 +37,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 extern  EFI_DRIVER_BINDING_PROTOCOL  gMnpDriverBinding;
 
+//
+// Indexes of the values of MNP_DEVICE_DATA.Statistics.
+//
+typedef enum {
+  MnpStatRxFrames,
+  MnpStatRxUndelivered,
+  MnpStatRxQueueDrops,
+  MnpStatTxFrames,
+  MnpStatTxErrors,
+  MnpStatMax
+} MNP_STATISTICS_INDEX;
+
 typedef struct {
   UINT32                         Signature;
 
@@ -67,8 +79,20 @@ typedef struct {
   NET_BUF_QUEUE                  FreeNbufQue;
   INTN                           NbufCnt;
 
+  //
+  // Recycled MNP_RXDATA_WRAPs, with their recycle events still open.
+  //
+  LIST_ENTRY                     FreeRxDataWrapList;
+  UINTN                          FreeRxDataWrapCount;
+
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The current period of PollTimer, and the number of polls in a row
+  // that received nothing.
+  //
+  UINT64                         PollInterval;
+  UINTN                          IdlePollCount;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -85,6 +109,12 @@ typedef struct {
   UINT32                         BufferLength;
   UINT32                         PaddingSize;
   NET_BUF                        *RxNbufCache;
+
+  //
+  // The statistics exposed through EDKII_NETWORK_STATISTICS_PROTOCOL,
+  // indexed by MNP_STATISTICS_INDEX. It may be NULL.
+  //
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_BUSY_INTERVAL   (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_SYS_POLL_IDLE_COUNT      20                     // Idle polls before going back to MNP_SYS_POLL_INTERVAL
+#define MNP_RX_POLL_BUDGET           64                     // Maximum frames received per poll
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -24,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MNP_MAX_TX_BUFFER_NUM        65536
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
+#define MNP_MAX_FREE_RXDATA_WRAP      64
 
 #define MNP_RECEIVE_UNICAST    0x01
 #define MNP_RECEIVE_BROADCAST  0x02
@@ -430,6 +434,25 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets available from Snp, up to
+  MNP_RX_POLL_BUDGET of them.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  OUT    UINTN            *Received
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
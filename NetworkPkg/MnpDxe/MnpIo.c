@@ -281,6 +281,11 @@ MnpSyncSendPacket (
 
 SIGNAL_TOKEN:
 
+  NET_STATISTICS_INC (
+    MnpDeviceData->Statistics,
+    (Token->Status == EFI_SUCCESS) ? MnpStatTxFrames : MnpStatTxErrors
+    );
+
   gBS->SignalEvent (Token->Event);
 
   //
@@ -446,14 +451,24 @@ MnpRecycleRxData (
   RxDataWrap->Nbuf = NULL;
 
   //
-  // Close the recycle event.
+  // Remove this Wrap entry from the list.
   //
-  gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+  RemoveEntryList (&RxDataWrap->WrapEntry);
 
   //
-  // Remove this Wrap entry from the list.
+  // Keep the Wrap and its recycle event for the next received packet,
+  // unless enough of them are kept already.
   //
-  RemoveEntryList (&RxDataWrap->WrapEntry);
+  if (MnpDeviceData->FreeRxDataWrapCount < MNP_MAX_FREE_RXDATA_WRAP) {
+    InsertTailList (&MnpDeviceData->FreeRxDataWrapList, &RxDataWrap->WrapEntry);
+    MnpDeviceData->FreeRxDataWrapCount++;
+    return;
+  }
+
+  //
+  // Close the recycle event.
+  //
+  gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
 
   FreePool (RxDataWrap);
 }
@@ -481,6 +496,7 @@ MnpQueueRcvdPacket (
   //
   if (Instance->RcvdPacketQueueSize == MNP_MAX_RCVD_PACKET_QUE_SIZE) {
     DEBUG ((DEBUG_WARN, "MnpQueueRcvdPacket: Drop one packet bcz queue size limit reached.\n"));
+    NET_STATISTICS_INC (Instance->MnpServiceData->MnpDeviceData->Statistics, MnpStatRxQueueDrops);
 
     //
     // Get the oldest packet.
@@ -704,6 +720,33 @@ MnpWrapRxData (
 {
   EFI_STATUS       Status;
   MNP_RXDATA_WRAP  *RxDataWrap;
+  MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_EVENT        RecycleEvent;
+  EFI_TPL          OldTpl;
+
+  //
+  // Reuse a recycled Wrap if any. MnpRecycleRxData() runs at TPL_NOTIFY.
+  //
+  MnpDeviceData = Instance->MnpServiceData->MnpDeviceData;
+  RxDataWrap    = NULL;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (!IsListEmpty (&MnpDeviceData->FreeRxDataWrapList)) {
+    RxDataWrap = NET_LIST_HEAD (&MnpDeviceData->FreeRxDataWrapList, MNP_RXDATA_WRAP, WrapEntry);
+    RemoveEntryList (&RxDataWrap->WrapEntry);
+    MnpDeviceData->FreeRxDataWrapCount--;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (RxDataWrap != NULL) {
+    RecycleEvent         = RxDataWrap->RxData.RecycleEvent;
+    RxDataWrap->Instance = Instance;
+    CopyMem (&RxDataWrap->RxData, RxData, sizeof (RxDataWrap->RxData));
+    RxDataWrap->RxData.RecycleEvent = RecycleEvent;
+
+    return RxDataWrap;
+  }
 
   //
   // Allocate memory.
@@ -903,6 +946,8 @@ MnpReceivePacket (
     return EFI_DEVICE_ERROR;
   }
 
+  NET_STATISTICS_INC (MnpDeviceData->Statistics, MnpStatRxFrames);
+
   Trimmed = 0;
   if (Nbuf->TotalSize != BufLen) {
     //
@@ -935,6 +980,7 @@ MnpReceivePacket (
       NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD);
     }
 
+    NET_STATISTICS_INC (MnpDeviceData->Statistics, MnpStatRxUndelivered);
     goto EXIT;
   }
 
@@ -962,6 +1008,8 @@ MnpReceivePacket (
     //
     // No receiver for this packet.
     //
+    NET_STATISTICS_INC (MnpDeviceData->Statistics, MnpStatRxUndelivered);
+
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -985,6 +1033,45 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets available from Snp, up to
+  MNP_RX_POLL_BUDGET of them.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  OUT    UINTN            *Received
+  )
+{
+  EFI_STATUS  Status;
+
+  *Received = 0;
+
+  do {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    (*Received)++;
+  } while (*Received < MNP_RX_POLL_BUDGET);
+
+  if (*Received != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1099,17 +1186,36 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINTN            Received;
+  UINT64           PollInterval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Drain the packets from Snp, then dispatch the DPCs queued by the
+  // NotifyFunction of rx token's events for the whole batch.
   //
-  MnpReceivePacket (MnpDeviceData);
+  MnpReceivePackets (MnpDeviceData, &Received);
+  DispatchDpc ();
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+  // Poll faster while packets are arriving, and slow down again
+  // after a while without any.
   //
-  DispatchDpc ();
+  if (Received != 0) {
+    MnpDeviceData->IdlePollCount = 0;
+    PollInterval                 = MNP_SYS_POLL_BUSY_INTERVAL;
+  } else if (MnpDeviceData->IdlePollCount < MNP_SYS_POLL_IDLE_COUNT) {
+    MnpDeviceData->IdlePollCount++;
+    PollInterval = MnpDeviceData->PollInterval;
+  } else {
+    PollInterval = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if (MnpDeviceData->EnableSystemPoll && (PollInterval != MnpDeviceData->PollInterval)) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, PollInterval))) {
+      MnpDeviceData->PollInterval = PollInterval;
+    }
+  }
 }
@@ -126,6 +126,12 @@ struct _MTFTP4_PROTOCOL {
   //
   UINT64                    AckedBlock;
 
+  //
+  // TRUE once the gap in the current window has been acknowledged, the
+  // rest of the window the server already sent is then dropped silently.
+  //
+  BOOLEAN                   GapAcked;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
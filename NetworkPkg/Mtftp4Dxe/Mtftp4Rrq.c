@@ -264,6 +264,19 @@ Mtftp4RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // With a window larger than one block, the server keeps sending the
+    // blocks after a lost one. Acknowledge the gap once (RFC 7440), so
+    // that the server restarts the window a single time, and drop the
+    // following out-of-order blocks. The retransmission timer covers a
+    // lost ACK.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = (BOOLEAN)(Instance->WindowSize > 1);
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -276,6 +289,8 @@ Mtftp4RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
@@ -86,6 +86,12 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // TRUE once the gap in the current window has been acknowledged, the
+  // rest of the window the server already sent is then dropped silently.
+  //
+  BOOLEAN                   GapAcked;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
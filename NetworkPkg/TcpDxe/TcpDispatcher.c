@@ -118,7 +118,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -195,7 +195,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -563,6 +563,10 @@ TcpConfigurePcb (
   Tcb->Ssthresh = 0xffffffff;
 
   Tcb->CongestState = TCP_CONGEST_OPEN;
+  Tcb->CubicWMax    = 0;
+  Tcb->CubicEpoch   = 0;
+  Tcb->SackCount    = 0;
+  ZeroMem (&Tcb->Stats, sizeof (TCP_STATISTICS));
 
   Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
@@ -703,6 +707,21 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
+  }
+
+  //
+  // Let the receive buffer grow beyond the configured size when the
+  // window can be scaled to advertise it.
+  //
+  Tcb->RcvBufAutoMax = 0;
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS) &&
+      (PcdGet32 (PcdTcpReceiveBufferAutoTuneMax) > GET_RCV_BUFFSIZE (Sk)))
+  {
+    Tcb->RcvBufAutoMax = PcdGet32 (PcdTcpReceiveBufferAutoTuneMax);
   }
 
   //
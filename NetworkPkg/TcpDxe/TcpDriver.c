@@ -17,6 +17,17 @@ TCP_HEARTBEAT_TIMER  mTcpTimer = {
   0
 };
 
+//
+// The names of the values of TCP_SERVICE_DATA.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mTcpStatisticsNames[TcpStatMax] = {
+  L"SegmentsIn",
+  L"SegmentsOut",
+  L"Retransmits",
+  L"ResetsOut",
+  L"SmoothedRttMs"
+};
+
 EFI_TCP4_PROTOCOL  gTcp4ProtocolTemplate = {
   Tcp4GetModeData,
   Tcp4Configure,
@@ -311,6 +322,7 @@ TcpCreateService (
   }
 
   OpenData.PktRcvdNotify = TcpRxCallback;
+  OpenData.RcvdContext   = TcpServiceData;
   Status                 = IpIoOpen (TcpServiceData->IpIo, &OpenData);
   if (EFI_ERROR (Status)) {
     goto ON_ERROR;
@@ -333,6 +345,13 @@ TcpCreateService (
     goto ON_ERROR;
   }
 
+  TcpServiceData->Statistics = NetLibCreateStatistics (
+                                 Controller,
+                                 (IpVersion == IP_VERSION_4) ? L"TCPv4" : L"TCPv6",
+                                 TcpStatMax,
+                                 mTcpStatisticsNames
+                                 );
+
   return EFI_SUCCESS;
 
 ON_ERROR:
@@ -476,6 +495,8 @@ TcpDestroyService (
     IpIoDestroy (TcpServiceData->IpIo);
     TcpServiceData->IpIo = NULL;
 
+    NetLibDestroyStatistics (TcpServiceData->Statistics);
+
     //
     // Destroy the heartbeat timer.
     //
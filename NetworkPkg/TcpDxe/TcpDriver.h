@@ -20,14 +20,27 @@ typedef struct _TCP_HEARTBEAT_TIMER {
   INTN         RefCnt;
 } TCP_HEARTBEAT_TIMER;
 
+//
+// Indexes of the values of TCP_SERVICE_DATA.Statistics.
+//
+typedef enum {
+  TcpStatSegmentsIn,
+  TcpStatSegmentsOut,
+  TcpStatRetransmits,
+  TcpStatResetsOut,
+  TcpStatSmoothedRttMs,
+  TcpStatMax
+} TCP_STATISTICS_INDEX;
+
 typedef struct _TCP_SERVICE_DATA {
-  UINT32                          Signature;
-  EFI_HANDLE                      ControllerHandle;
-  EFI_HANDLE                      DriverBindingHandle;
-  UINT8                           IpVersion;
-  IP_IO                           *IpIo;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  LIST_ENTRY                      SocketList;
+  UINT32                               Signature;
+  EFI_HANDLE                           ControllerHandle;
+  EFI_HANDLE                           DriverBindingHandle;
+  UINT8                                IpVersion;
+  IP_IO                                *IpIo;
+  EFI_SERVICE_BINDING_PROTOCOL         ServiceBinding;
+  LIST_ENTRY                           SocketList;
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 } TCP_SERVICE_DATA;
 
 typedef struct _TCP_PROTO_DATA {
@@ -35,6 +48,12 @@ typedef struct _TCP_PROTO_DATA {
   TCP_CB              *TcpPcb;
 } TCP_PROTO_DATA;
 
+//
+// The statistics of the TCP service a TCB belongs to.
+//
+#define TCP_STATISTICS(Tcb) \
+  (((TCP_PROTO_DATA *)(Tcb)->Sk->ProtoReserved)->TcpService->Statistics)
+
 #define TCP_SERVICE_FROM_THIS(a) \
   CR ( \
   (a), \
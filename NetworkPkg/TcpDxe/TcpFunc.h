@@ -359,6 +359,23 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the first hole in the SACK scoreboard, at or above sequence
+  Seq, that hasn't been retransmitted in this recovery.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Seq     The sequence number to look for a hole from.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole was retransmitted.
+
+**/
+INTN
+TcpSackRetransmitHole (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -498,6 +515,57 @@ TcpInput (
   IN UINT8           Version
   );
 
+/**
+  Reduce the congestion window on a congestion event as CUBIC does,
+  and remember the window the cubic function grows back to.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicOnCongestion (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Grow the congestion window in congestion avoidance as CUBIC does.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes acknowledged.
+
+**/
+VOID
+TcpCubicCongestionAvoid (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+/**
+  Update the SACK scoreboard with an acceptable ACK.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      The segment that carries the ACK.
+  @param[in]       Option   The options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEG     *Seg,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Grow the receive buffer so that the receive window doesn't limit the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpRcvBufAutoTune (
+  IN OUT TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
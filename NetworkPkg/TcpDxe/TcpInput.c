@@ -29,6 +29,324 @@ TcpSeqAcceptable (
           TCP_SEQ_LT (Seg->Seq, Tcb->RcvWl2 + Tcb->RcvWnd));
 }
 
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value    The value, less than 2^63.
+
+  @return The largest integer whose cube doesn't exceed Value.
+
+**/
+STATIC
+UINT32
+TcpCubeRoot (
+  IN UINT64  Value
+  )
+{
+  UINT32  Root;
+  UINT32  Bit;
+  UINT32  Try;
+
+  Root = 0;
+  for (Bit = BIT20; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+    if (MultU64x32 (MultU64x32 (Try, Try), Try) <= Value) {
+      Root = Try;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Reduce the congestion window on a congestion event as CUBIC does,
+  and remember the window the cubic function grows back to.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicOnCongestion (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  //
+  // Fast convergence: when the window didn't grow back to the last
+  // maximum, plateau lower to release bandwidth to competing flows.
+  //
+  if (Tcb->CWnd < Tcb->CubicWMax) {
+    Tcb->CubicWMax = (UINT32)RShiftU64 (MultU64x32 (Tcb->CWnd, TCP_CUBIC_FAST_CONVERGENCE), 10);
+  } else {
+    Tcb->CubicWMax = Tcb->CWnd;
+  }
+
+  Tcb->Ssthresh = (UINT32)RShiftU64 (MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA), 10);
+  Tcb->Ssthresh = MAX (Tcb->Ssthresh, (UINT32)(2 * Tcb->SndMss));
+
+  Tcb->CubicEpoch = 0;
+}
+
+/**
+  Grow the congestion window in congestion avoidance as CUBIC does.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes acknowledged.
+
+**/
+VOID
+TcpCubicCongestionAvoid (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  UINT32   Rtt;
+  UINT64   Elapsed;
+  UINT64   Delta;
+  UINT64   Offset;
+  UINT64   Target;
+  BOOLEAN  Above;
+
+  //
+  // The first ACK after a window reduction starts a new epoch.
+  //
+  if (Tcb->CubicEpoch == 0) {
+    Tcb->CubicEpoch = MAX (mTcpTick, 1);
+    Tcb->CubicWEst  = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK = TcpCubeRoot (
+                      DivU64x32 (
+                        MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, TCP_CUBIC_K_SCALE),
+                        Tcb->SndMss
+                        )
+                      );
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // Aim at W_cubic (t + RTT) = C * (t + RTT - K)^3 + W_max, with the
+  // times in ms. The distance from K is capped to keep it in 64 bits.
+  //
+  Rtt     = MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1) * TCP_TICK;
+  Elapsed = MultU64x32 (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch), TCP_TICK) + Rtt;
+
+  Above = (BOOLEAN)(Elapsed >= Tcb->CubicK);
+  Delta = Above ? Elapsed - Tcb->CubicK : Tcb->CubicK - Elapsed;
+  Delta = MIN (Delta, TCP_CUBIC_MAX_DELTA);
+
+  Offset = DivU64x32 (
+             MultU64x32 (MultU64x64 (MultU64x64 (Delta, Delta), Delta), Tcb->SndMss),
+             TCP_CUBIC_K_SCALE
+             );
+
+  if (Above) {
+    Target = Tcb->CubicOrigin + Offset;
+  } else {
+    Target = (Offset < Tcb->CubicOrigin) ? Tcb->CubicOrigin - Offset : 0;
+  }
+
+  //
+  // Don't grow slower than Reno would have.
+  //
+  Tcb->CubicWEst += (UINT32)RShiftU64 (
+                              DivU64x32 (
+                                MultU64x32 (MultU64x32 (Acked, Tcb->SndMss), TCP_CUBIC_ALPHA),
+                                Tcb->CWnd
+                                ),
+                              10
+                              );
+
+  Target = MAX (Target, Tcb->CubicWEst);
+
+  //
+  // Move toward the target, by at most half the window per RTT.
+  //
+  if (Target > Tcb->CWnd) {
+    Target     = MIN (Target, Tcb->CWnd + (Tcb->CWnd >> 1));
+    Tcb->CWnd += MAX ((UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Acked), Tcb->CWnd), 1);
+  }
+}
+
+/**
+  Merge a range SACKed by the peer into the scoreboard.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Start    The first sequence number of the range.
+  @param[in]       End      The sequence number following the range.
+
+**/
+STATIC
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Start,
+  IN     TCP_SEQNO  End
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  UINT8           Index;
+  UINT8           Last;
+
+  Block = Tcb->SackBlock;
+
+  //
+  // Skip the ranges below, then absorb the ranges that overlap
+  // or touch the new one.
+  //
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_GEQ (Block[Index].End, Start)) {
+      break;
+    }
+  }
+
+  for (Last = Index; Last < Tcb->SackCount; Last++) {
+    if (TCP_SEQ_GT (Block[Last].Start, End)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Block[Last].Start, Start)) {
+      Start = Block[Last].Start;
+    }
+
+    if (TCP_SEQ_GT (Block[Last].End, End)) {
+      End = Block[Last].End;
+    }
+  }
+
+  if (Last == Index) {
+    //
+    // Insert a new range. When the scoreboard is full, forget the
+    // highest range, which is the least useful for recovery.
+    //
+    if (Tcb->SackCount == TCP_SACK_SCOREBOARD_SIZE) {
+      if (Index == TCP_SACK_SCOREBOARD_SIZE) {
+        return;
+      }
+
+      Tcb->SackCount--;
+    }
+
+    CopyMem (&Block[Index + 1], &Block[Index], (Tcb->SackCount - Index) * sizeof (TCP_SACK_BLOCK));
+    Tcb->SackCount++;
+  } else if (Last > Index + 1) {
+    CopyMem (&Block[Index + 1], &Block[Last], (Tcb->SackCount - Last) * sizeof (TCP_SACK_BLOCK));
+    Tcb->SackCount = (UINT8)(Tcb->SackCount - (Last - Index - 1));
+  }
+
+  Block[Index].Start = Start;
+  Block[Index].End   = End;
+}
+
+/**
+  Update the SACK scoreboard with an acceptable ACK.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg      The segment that carries the ACK.
+  @param[in]       Option   The options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEG     *Seg,
+  IN     TCP_OPTION  *Option
+  )
+{
+  UINT8      Index;
+  UINT8      Keep;
+  TCP_SEQNO  Start;
+  TCP_SEQNO  End;
+
+  //
+  // Forget what the cumulative ACK covers.
+  //
+  Keep = 0;
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].End, Seg->Ack)) {
+      continue;
+    }
+
+    Tcb->SackBlock[Keep] = Tcb->SackBlock[Index];
+    if (TCP_SEQ_LT (Tcb->SackBlock[Keep].Start, Seg->Ack)) {
+      Tcb->SackBlock[Keep].Start = Seg->Ack;
+    }
+
+    Keep++;
+  }
+
+  Tcb->SackCount = Keep;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Start = Option->SackBlock[Index].Start;
+    End   = Option->SackBlock[Index].End;
+
+    //
+    // Ignore D-SACK blocks and blocks outside the data in flight.
+    //
+    if (TCP_SEQ_GEQ (Start, End) || TCP_SEQ_LEQ (End, Seg->Ack) || TCP_SEQ_GT (End, Tcb->SndNxt)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Start, Seg->Ack)) {
+      Start = Seg->Ack;
+    }
+
+    TcpSackInsert (Tcb, Start, End);
+  }
+}
+
+/**
+  Grow the receive buffer so that the receive window doesn't limit the
+  peer. The buffer follows twice the data received in the last RTT, up
+  to RcvBufAutoMax.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpRcvBufAutoTune (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  Rtt;
+  UINT32  Received;
+  UINT32  BufSize;
+
+  if ((Tcb->RcvBufAutoMax == 0) || (Tcb->RcvWndScale == 0)) {
+    return;
+  }
+
+  Rtt = MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1);
+  if (TCP_SUB_TIME (mTcpTick, Tcb->RcvSpaceTime) < Rtt) {
+    return;
+  }
+
+  Received = TCP_SUB_SEQ (Tcb->RcvNxt, Tcb->RcvSpaceSeq);
+  BufSize  = MIN (Received, Tcb->RcvBufAutoMax / 2) * 2;
+
+  if (BufSize > GET_RCV_BUFFSIZE (Tcb->Sk)) {
+    DEBUG (
+      (DEBUG_NET,
+       "TcpRcvBufAutoTune: grow the receive buffer of TCB %p to %d\n",
+       Tcb,
+       BufSize)
+      );
+
+    SET_RCV_BUFFSIZE (Tcb->Sk, BufSize);
+  }
+
+  Tcb->RcvSpaceSeq  = Tcb->RcvNxt;
+  Tcb->RcvSpaceTime = mTcpTick;
+}
+
 /**
   NewReno fast recovery defined in RFC3782.
 
@@ -50,14 +368,15 @@ TcpFastRecover (
   //
   if (Tcb->CongestState != TCP_CONGEST_RECOVER) {
     //
-    // Step 1A: Invoking fast retransmission.
+    // Step 1A: Invoking fast retransmission. The window
+    // is reduced by CUBIC rather than halved.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
-    Tcb->Recover  = Tcb->SndNxt;
+    TcpCubicOnCongestion (Tcb);
+    Tcb->Recover     = Tcb->SndNxt;
+    Tcb->SackHighRxt = Tcb->SndUna;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
+    Tcb->Stats.FastRecoveries++;
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
 
     //
@@ -87,7 +406,15 @@ TcpFastRecover (
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    // With SACK, the ACK is spent on retransmitting the
+    // next hole in the scoreboard instead, if any.
+    //
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) ||
+        (TcpSackRetransmitHole (Tcb, Tcb->SndUna) == 0))
+    {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +446,18 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. If the field has been
+      // retransmitted already, move on to the next hole
+      // the peer reported by SACK.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) &&
+          TCP_SEQ_LT (Seg->Ack, Tcb->SackHighRxt))
+      {
+        TcpSackRetransmitHole (Tcb, Seg->Ack);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -240,6 +576,13 @@ TcpComputeRtt (
     Tcb->Rto = TCP_RTO_MAX;
   }
 
+  //
+  // The statistics report the smoothed RTT of the latest measure.
+  //
+  if (TCP_STATISTICS (Tcb) != NULL) {
+    TCP_STATISTICS (Tcb)->Values[TcpStatSmoothedRttMs] = (Tcb->SRtt * TCP_TICK) >> TCP_RTT_SHIFT;
+  }
+
   DEBUG (
     (DEBUG_NET,
      "TcpComputeRtt: new RTT for TCB %p computed SRTT: %d RTTVAR: %d RTO: %d\n",
@@ -509,6 +852,8 @@ TcpDeliverData (
     }
 
     if (Nbuf->TotalSize != 0) {
+      Tcb->Stats.BytesReceived += Nbuf->TotalSize;
+
       Urgent = 0;
 
       if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_URG) &&
@@ -563,6 +908,15 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  //
+  // Remember the last out-of-order segment, it is
+  // reported first in the SACK option.
+  //
+  if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+    Tcb->SackRecent = Seg->Seq;
+    Tcb->Stats.OutOfOrder++;
+  }
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -786,6 +1140,7 @@ TcpInput (
   }
 
   Seg = TcpFormatNetbuf (Tcb, Nbuf);
+  Tcb->Stats.SegmentsReceived++;
 
   //
   // RFC1122 recommended reaction to illegal option
@@ -1202,6 +1557,13 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Record the ranges the peer has SACKed.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+    TcpSackUpdate (Tcb, Seg, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1225,10 +1587,11 @@ TcpInput (
       if (Tcb->CWnd < Tcb->Ssthresh) {
         Tcb->CWnd += Tcb->SndMss;
       } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+        TcpCubicCongestionAvoid (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
       }
 
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      Tcb->CWnd          = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      Tcb->Stats.MaxCWnd = MAX (Tcb->Stats.MaxCWnd, Tcb->CWnd);
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -1480,6 +1843,8 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    TcpRcvBufAutoTune (Tcb);
+
     if (!IsListEmpty (&Tcb->RcvQue)) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_ACK_NOW);
     }
@@ -33,6 +33,7 @@ TcpRxCallback (
   )
 {
   if (EFI_SUCCESS == Status) {
+    NET_STATISTICS_INC (((TCP_SERVICE_DATA *)Context)->Statistics, TcpStatSegmentsIn);
     TcpInput (Pkt, &NetSession->Source, &NetSession->Dest, NetSession->IpVersion);
   } else {
     TcpIcmpInput (
@@ -67,12 +68,13 @@ TcpSendIpPacket (
   IN UINT8           Version
   )
 {
-  EFI_STATUS      Status;
-  IP_IO           *IpIo;
-  IP_IO_OVERRIDE  Override;
-  SOCKET          *Sock;
-  VOID            *IpSender;
-  TCP_PROTO_DATA  *TcpProto;
+  EFI_STATUS        Status;
+  IP_IO             *IpIo;
+  IP_IO_OVERRIDE    Override;
+  SOCKET            *Sock;
+  VOID              *IpSender;
+  TCP_PROTO_DATA    *TcpProto;
+  TCP_SERVICE_DATA  *TcpService;
 
   if (NULL == Tcb) {
     IpIo     = NULL;
@@ -132,6 +134,17 @@ TcpSendIpPacket (
     return -1;
   }
 
+  //
+  // The IpIo found for a segment without TCB may be owned by another driver.
+  //
+  TcpService = (TCP_SERVICE_DATA *)IpIo->RcvdContext;
+  if ((IpIo->PktRcvdNotify == TcpRxCallback) && (TcpService != NULL)) {
+    NET_STATISTICS_INC (TcpService->Statistics, TcpStatSegmentsOut);
+    if ((Nbuf->Tcp != NULL) && TCP_FLG_ON (Nbuf->Tcp->Flag, TCP_FLG_RST)) {
+      NET_STATISTICS_INC (TcpService->Statistics, TcpStatResetsOut);
+    }
+  }
+
   return 0;
 }
 
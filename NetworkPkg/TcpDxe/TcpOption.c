@@ -82,7 +82,10 @@ TcpComputeScale (
 
   ASSERT ((Tcb != NULL) && (Tcb->Sk != NULL));
 
-  BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
+  //
+  // Leave room for the receive buffer to grow by auto-tuning.
+  //
+  BufSize = MAX (GET_RCV_BUFFSIZE (Tcb->Sk), Tcb->RcvBufAutoMax);
 
   Scale = 0;
   while ((Scale < TCP_OPTION_MAX_WS) && ((UINT32)(TCP_OPTION_MAX_WIN << Scale) < BufSize)) {
@@ -160,6 +163,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when configured
+  // to use SACK, and either we are doing active open
+  // or the peer has permitted SACK.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +197,89 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Collect the SACK blocks to report for the out-of-order data in the
+  reassemble queue. As RFC2018 requires, the first block contains the
+  most recently received segment.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array receiving the blocks.
+  @param[in]   MaxCount  The number of entries in Block.
+
+  @return The number of blocks stored in Block.
+
+**/
+UINT8
+TcpGetSackBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxCount
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Range;
+  UINT8           Count;
+  BOOLEAN         Found;
+
+  ASSERT (MaxCount > 0);
+
+  //
+  // Block[0] is reserved for the range that holds SackRecent.
+  //
+  Seg         = NULL;
+  Count       = 1;
+  Found       = FALSE;
+  Range.Start = Tcb->RcvNxt;
+  Range.End   = Tcb->RcvNxt;
+
+  for (Entry = Tcb->RcvQue.ForwardLink; ; Entry = Entry->ForwardLink) {
+    if (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+      if (TCP_SEQ_LEQ (Seg->Seq, Tcb->RcvNxt) || (Seg->Seq == Seg->End)) {
+        continue;
+      }
+
+      if ((Range.Start != Range.End) && (Seg->Seq == Range.End)) {
+        Range.End = Seg->End;
+        continue;
+      }
+    }
+
+    //
+    // The current range is complete.
+    //
+    if (Range.Start != Range.End) {
+      if (!Found && TCP_SEQ_LEQ (Range.Start, Tcb->SackRecent) && TCP_SEQ_LT (Tcb->SackRecent, Range.End)) {
+        Block[0] = Range;
+        Found    = TRUE;
+      } else if (Count < MaxCount) {
+        Block[Count++] = Range;
+      }
+    }
+
+    if (Entry == &Tcb->RcvQue) {
+      break;
+    }
+
+    Range.Start = Seg->Seq;
+    Range.End   = Seg->End;
+  }
+
+  if (!Found) {
+    //
+    // The segment isn't out of order any more, move the last
+    // range to the reserved slot.
+    //
+    Count--;
+    if (Count != 0) {
+      Block[0] = Block[Count];
+    }
+  }
+
+  return Count;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -187,8 +295,12 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCK];
+  UINT8           Count;
+  UINT8           Index;
+  UINT32          Room;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -214,6 +326,46 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if there is out-of-order data. The
+  // option must not push a data segment beyond SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    Count = (UINT8)((TCP_MAX_OPTION_LEN - Len - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN);
+    Count = MIN (Count, TCP_OPTION_MAX_SACK_BLOCK);
+
+    Room = 0;
+    if (Tcb->SndMss > Nbuf->TotalSize + TCP_OPTION_SACK_ALIGNED_LEN) {
+      Room = (Tcb->SndMss - Nbuf->TotalSize - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN;
+    }
+
+    Count = (UINT8)MIN (Count, Room);
+    if (Count != 0) {
+      Count = TcpGetSackBlocks (Tcb, Block, Count);
+    }
+
+    if (Count != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               TCP_OPTION_SACK_ALIGNED_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len += TCP_OPTION_SACK_ALIGNED_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN;
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (TCP_OPTION_SACK_LEN + Count * TCP_OPTION_SACK_BLOCK_LEN));
+      for (Index = 0; Index < Count; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Start);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].End);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,10 +391,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +465,41 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < TCP_OPTION_SACK_LEN + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - TCP_OPTION_SACK_LEN) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        for (Index = 0; Index < (Len - TCP_OPTION_SACK_LEN) / TCP_OPTION_SACK_BLOCK_LEN; Index++) {
+          if (Option->SackCount < TCP_OPTION_MAX_SACK_BLOCK) {
+            Option->SackBlock[Option->SackCount].Start = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+            Option->SackBlock[Option->SackCount].End   = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+            Option->SackCount++;
+          }
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
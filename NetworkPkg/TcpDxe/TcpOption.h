@@ -16,13 +16,20 @@
 #define TCP_OPTION_EOP             0  ///< End Of oPtion
 #define TCP_OPTION_NOP             1  ///< No-Option.
 #define TCP_OPTION_MSS             2  ///< Maximum Segment Size
-#define TCP_OPTION_WS              3  ///< Window scale
-#define TCP_OPTION_TS              8  ///< Timestamp
-#define TCP_OPTION_MSS_LEN         4  ///< Length of MSS option
-#define TCP_OPTION_WS_LEN          3  ///< Length of window scale option
-#define TCP_OPTION_TS_LEN          10 ///< Length of timestamp option
-#define TCP_OPTION_WS_ALIGNED_LEN  4  ///< Length of window scale option, aligned
-#define TCP_OPTION_TS_ALIGNED_LEN  12 ///< Length of timestamp option, aligned
+#define TCP_OPTION_WS                     3  ///< Window scale
+#define TCP_OPTION_SACK_PERM              4  ///< SACK permitted
+#define TCP_OPTION_SACK                   5  ///< SACK
+#define TCP_OPTION_TS                     8  ///< Timestamp
+#define TCP_OPTION_MSS_LEN                4  ///< Length of MSS option
+#define TCP_OPTION_WS_LEN                 3  ///< Length of window scale option
+#define TCP_OPTION_SACK_PERM_LEN          2  ///< Length of SACK permitted option
+#define TCP_OPTION_SACK_LEN               2  ///< Length of SACK option without blocks
+#define TCP_OPTION_SACK_BLOCK_LEN         8  ///< Length of a SACK block
+#define TCP_OPTION_TS_LEN                 10 ///< Length of timestamp option
+#define TCP_OPTION_WS_ALIGNED_LEN         4  ///< Length of window scale option, aligned
+#define TCP_OPTION_SACK_PERM_ALIGNED_LEN  4  ///< Length of SACK permitted option, aligned
+#define TCP_OPTION_SACK_ALIGNED_LEN       4  ///< Length of SACK option without blocks, aligned
+#define TCP_OPTION_TS_ALIGNED_LEN         12 ///< Length of timestamp option, aligned
 
 //
 // recommend format of timestamp window scale
@@ -39,25 +46,40 @@
 
 #define TCP_OPTION_MSS_FAST  ((TCP_OPTION_MSS << 24) | (TCP_OPTION_MSS_LEN << 16))
 
+#define TCP_OPTION_SACK_PERM_FAST  ((TCP_OPTION_NOP << 24) |       \
+                                    (TCP_OPTION_NOP << 16) |       \
+                                    (TCP_OPTION_SACK_PERM << 8) |  \
+                                    (TCP_OPTION_SACK_PERM_LEN))
+
+#define TCP_OPTION_SACK_FAST  ((TCP_OPTION_NOP << 24) |  \
+                               (TCP_OPTION_NOP << 16) |  \
+                               (TCP_OPTION_SACK << 8))
+
 //
 // Other misc definitions
 //
 #define TCP_OPTION_RCVD_MSS  0x01
 #define TCP_OPTION_RCVD_WS   0x02
-#define TCP_OPTION_RCVD_TS   0x04
-#define TCP_OPTION_MAX_WS    14            ///< Maximum window scale value
-#define TCP_OPTION_MAX_WIN   0xffff        ///< Max window size in TCP header
+#define TCP_OPTION_RCVD_TS         0x04
+#define TCP_OPTION_RCVD_SACK_PERM  0x08
+#define TCP_OPTION_RCVD_SACK       0x10
+#define TCP_OPTION_MAX_WS          14      ///< Maximum window scale value
+#define TCP_OPTION_MAX_WIN         0xffff  ///< Max window size in TCP header
+#define TCP_OPTION_MAX_SACK_BLOCK  4       ///< Max SACK blocks in a segment
+#define TCP_MAX_OPTION_LEN         40      ///< Max length of the TCP options
 
 ///
 /// The structure to store the parse option value.
 /// ParseOption only parses the options, doesn't process them.
 ///
 typedef struct _TCP_OPTION {
-  UINT8     Flag;     ///< Flag such as TCP_OPTION_RCVD_MSS
-  UINT8     WndScale; ///< The WndScale received
-  UINT16    Mss;      ///< The Mss received
-  UINT32    TSVal;    ///< The TSVal field in a timestamp option
-  UINT32    TSEcr;    ///< The TSEcr field in a timestamp option
+  UINT8             Flag;                                 ///< Flag such as TCP_OPTION_RCVD_MSS
+  UINT8             WndScale;                             ///< The WndScale received
+  UINT16            Mss;                                  ///< The Mss received
+  UINT32            TSVal;                                ///< The TSVal field in a timestamp option
+  UINT32            TSEcr;                                ///< The TSEcr field in a timestamp option
+  UINT8             SackCount;                            ///< The number of blocks in SackBlock
+  TCP_SACK_BLOCK    SackBlock[TCP_OPTION_MAX_SACK_BLOCK]; ///< The blocks in a SACK option
 } TCP_OPTION;
 
 /**
@@ -88,6 +110,24 @@ TcpSynBuildOption (
   IN NET_BUF  *Nbuf
   );
 
+/**
+  Collect the SACK blocks to report for the out-of-order data in the
+  reassemble queue.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array receiving the blocks.
+  @param[in]   MaxCount  The number of entries in Block.
+
+  @return The number of blocks stored in Block.
+
+**/
+UINT8
+TcpGetSackBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxCount
+  );
+
 /**
   Build the TCP option in synchronized states.
 
@@ -374,6 +374,9 @@ TcpTransmitSegment (
   //
   Tcb->DelayedAck = 0;
 
+  Tcb->Stats.SegmentsSent++;
+  Tcb->Stats.BytesSent += DataLen;
+
   return TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion);
 }
 
@@ -692,6 +695,13 @@ TcpRetransmit (
     Tcb->RetxmitSeqMax = Seq;
   }
 
+  if (TCP_SEQ_GT (TCPSEG_NETBUF (Nbuf)->End, Tcb->SackHighRxt)) {
+    Tcb->SackHighRxt = TCPSEG_NETBUF (Nbuf)->End;
+  }
+
+  Tcb->Stats.Retransmits++;
+  NET_STATISTICS_INC (TCP_STATISTICS (Tcb), TcpStatRetransmits);
+
   //
   // The retransmitted buffer may be on the SndQue,
   // trim TCP head because all the buffers on SndQue
@@ -712,6 +722,57 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the first hole in the SACK scoreboard, at or above sequence
+  Seq, that hasn't been retransmitted in this recovery. A hole is only
+  considered lost when the peer has SACKed data above it.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Seq     The sequence number to look for a hole from.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole was retransmitted.
+
+**/
+INTN
+TcpSackRetransmitHole (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  )
+{
+  UINT8    Index;
+  BOOLEAN  Lost;
+
+  if (TCP_SEQ_LT (Seq, Tcb->SackHighRxt)) {
+    Seq = Tcb->SackHighRxt;
+  }
+
+  Lost = FALSE;
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Start)) {
+      Lost = TRUE;
+      break;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].End)) {
+      Seq = Tcb->SackBlock[Index].End;
+    }
+  }
+
+  if (!Lost || TCP_SEQ_GEQ (Seq, Tcb->SndNxt)) {
+    return 0;
+  }
+
+  TcpRetransmit (Tcb, Seq);
+
+  if (TCP_SEQ_LEQ (Tcb->SackHighRxt, Seq)) {
+    return 0;
+  }
+
+  Tcb->Stats.SackRetransmits++;
+  return 1;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
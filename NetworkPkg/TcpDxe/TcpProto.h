@@ -70,6 +70,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_SACK          0x10000  ///< Both ends permit SACK.
 
 //
 // Timer related values
@@ -123,6 +125,24 @@
 #define TCP_FIN_WAIT2_TIME_MAX    (4 * TCP_TICK_HZ)
 #define TCP_TIME_WAIT_TIME_MAX    (60 * TCP_TICK_HZ)
 
+//
+// The number of ranges SACKed by the peer that the sender remembers.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  16
+
+//
+// CUBIC parameters of RFC9438, scaled by 1024: the multiplicative
+// decrease factor, the fast convergence factor (1 + beta) / 2 and the
+// additive increase of the Reno-friendly estimate 3 * (1 - beta) / (1 + beta).
+// TCP_CUBIC_K_SCALE is 1 / C for C = 0.4, scaled to express K in ms, and
+// TCP_CUBIC_MAX_DELTA caps the distance in ms from K.
+//
+#define TCP_CUBIC_BETA              717
+#define TCP_CUBIC_FAST_CONVERGENCE  870
+#define TCP_CUBIC_ALPHA             542
+#define TCP_CUBIC_K_SCALE           2500000000U
+#define TCP_CUBIC_MAX_DELTA         60000
+
 ///
 /// TCP_CONNECTED: both ends have synchronized their ISN.
 ///
@@ -224,6 +244,30 @@ typedef struct _TCP_PEER {
   TCP_PORTNO        Port; ///< Port number, in network byte order.
 } TCP_PEER;
 
+///
+/// A range of sequence numbers reported by a SACK option.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Start; ///< The first sequence number of the range.
+  TCP_SEQNO    End;   ///< The sequence number following the range.
+} TCP_SACK_BLOCK;
+
+///
+/// Statistics of a TCP connection, reported when it is closed.
+///
+typedef struct _TCP_STATISTICS {
+  UINT64    BytesSent;        ///< Data bytes sent, including retransmission.
+  UINT64    BytesReceived;    ///< Data bytes delivered to the socket.
+  UINT32    SegmentsSent;     ///< Segments sent.
+  UINT32    SegmentsReceived; ///< Segments received.
+  UINT32    OutOfOrder;       ///< Segments received out of order.
+  UINT32    Retransmits;      ///< Segments retransmitted.
+  UINT32    SackRetransmits;  ///< Holes retransmitted from the SACK scoreboard.
+  UINT32    FastRecoveries;   ///< Times fast recovery was entered.
+  UINT32    Timeouts;         ///< Retransmission timeouts.
+  UINT32    MaxCWnd;          ///< The largest congestion window.
+} TCP_STATISTICS;
+
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
 ///
@@ -306,6 +350,31 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC9438 CUBIC congestion avoidance.
+  //
+  UINT32              CubicWMax;   ///< CWnd before the last window reduction.
+  UINT32              CubicEpoch;  ///< When congestion avoidance started, 0 if not.
+  UINT32              CubicK;      ///< Time in ms to grow back to CubicOrigin.
+  UINT32              CubicOrigin; ///< The window the cubic function plateaus at.
+  UINT32              CubicWEst;   ///< Reno-friendly window estimate.
+
+  //
+  // RFC2018 and RFC6675 variables, about selective acknowledgment.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Ranges SACKed by the peer, sorted.
+  UINT8               SackCount;                           ///< Number of ranges in SackBlock.
+  TCP_SEQNO           SackHighRxt;                         ///< Highest seq retransmitted in recovery.
+  TCP_SEQNO           SackRecent;                          ///< Seq of the last out-of-order segment.
+
+  //
+  // Receive buffer auto-tuning. The buffer grows to twice the
+  // data received in an RTT, up to RcvBufAutoMax.
+  //
+  UINT32              RcvBufAutoMax; ///< Limit of the receive buffer, 0 if not tuned.
+  TCP_SEQNO           RcvSpaceSeq;   ///< RcvNxt when the measurement started.
+  UINT32              RcvSpaceTime;  ///< When the measurement started.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -335,6 +404,8 @@ struct _TCP_CONTROL_BLOCK {
   BOOLEAN             RemoteIpZero; ///< RemoteEnd.Ip is ZERO when configured.
   IP_IO_IP_INFO       *IpInfo;      ///< Pointer reference to Ip used to send pkt
   UINT32              Tick;         ///< 1 tick = 200ms
+
+  TCP_STATISTICS      Stats;
 };
 
 #endif
@@ -100,6 +100,36 @@ TcpClose (
   NetbufFreeList (&Tcb->SndQue);
   NetbufFreeList (&Tcb->RcvQue);
 
+  if (Tcb->Stats.SegmentsSent != 0) {
+    DEBUG (
+      (DEBUG_INFO,
+       "TcpClose: TCB %p sent %Ld bytes in %d segments, received %Ld bytes in %d segments\n",
+       Tcb,
+       Tcb->Stats.BytesSent,
+       Tcb->Stats.SegmentsSent,
+       Tcb->Stats.BytesReceived,
+       Tcb->Stats.SegmentsReceived)
+      );
+
+    DEBUG (
+      (DEBUG_INFO,
+       "TcpClose: %d retransmits (%d SACK), %d fast recoveries, %d timeouts, %d out-of-order\n",
+       Tcb->Stats.Retransmits,
+       Tcb->Stats.SackRetransmits,
+       Tcb->Stats.FastRecoveries,
+       Tcb->Stats.Timeouts,
+       Tcb->Stats.OutOfOrder)
+      );
+
+    DEBUG (
+      (DEBUG_INFO,
+       "TcpClose: SRTT %d ms, max CWnd %d, receive buffer %d\n",
+       (Tcb->SRtt >> TCP_RTT_SHIFT) * TCP_TICK,
+       Tcb->Stats.MaxCWnd,
+       GET_RCV_BUFFSIZE (Tcb->Sk))
+      );
+  }
+
   TcpSetState (Tcb, TCP_CLOSED);
 }
 
@@ -180,8 +210,6 @@ TcpRexmitTimeout (
   IN OUT TCP_CB  *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG (
     (DEBUG_WARN,
      "TcpRexmitTimeout: transmission timeout for TCB %p\n",
@@ -189,15 +217,19 @@ TcpRexmitTimeout (
     );
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window. The threshold is only reduced
+  // once per loss event, fast recovery may have done it already.
+  // The SACK scoreboard is dropped as the peer may renege.
   //
-  FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  if (Tcb->CongestState == TCP_CONGEST_OPEN) {
+    TcpCubicOnCongestion (Tcb);
+  }
 
+  Tcb->CubicEpoch  = 0;
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
+  Tcb->SackCount   = 0;
+  Tcb->Stats.Timeouts++;
 
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
@@ -10,6 +10,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 UINT16  mUdp4RandomPort;
 
+//
+// The names of the values of UDP4_SERVICE_DATA.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mUdp4StatisticsNames[Udp4StatMax] = {
+  L"InDatagrams",
+  L"OutDatagrams",
+  L"NoPorts",
+  L"InErrors"
+};
+
 /**
   This function checks and timeouts the I/O datagrams holding by the corresponding
   service context.
@@ -332,6 +342,8 @@ Udp4CreateService (
     goto ON_ERROR;
   }
 
+  Udp4Service->Statistics = NetLibCreateStatistics (ControllerHandle, L"UDPv4", Udp4StatMax, mUdp4StatisticsNames);
+
   return EFI_SUCCESS;
 
 ON_ERROR:
@@ -370,6 +382,9 @@ Udp4CleanService (
   // Destroy the IpIo.
   //
   IpIoDestroy (Udp4Service->IpIo);
+
+  NetLibDestroyStatistics (Udp4Service->Statistics);
+  Udp4Service->Statistics = NULL;
 }
 
 /**
@@ -1591,6 +1606,7 @@ Udp4Demultiplex (
   UINTN                  Enqueued;
 
   if (Packet->TotalSize < sizeof (EFI_UDP_HEADER)) {
+    NET_STATISTICS_INC (Udp4Service->Statistics, Udp4StatInErrors);
     NetbufFree (Packet);
     return;
   }
@@ -1616,6 +1632,7 @@ Udp4Demultiplex (
       //
       // Wrong checksum.
       //
+      NET_STATISTICS_INC (Udp4Service->Statistics, Udp4StatInErrors);
       NetbufFree (Packet);
       return;
     }
@@ -1640,7 +1657,11 @@ Udp4Demultiplex (
   //
   Enqueued = Udp4EnqueueDgram (Udp4Service, Packet, &RxData);
 
+  NET_STATISTICS_INC (Udp4Service->Statistics, Udp4StatInDatagrams);
+
   if (Enqueued == 0) {
+    NET_STATISTICS_INC (Udp4Service->Statistics, Udp4StatNoPorts);
+
     //
     // Send the port unreachable ICMP packet before we free this NET_BUF
     //
@@ -55,16 +55,28 @@ extern UINT16                        mUdp4RandomPort;
   UDP4_SERVICE_DATA_SIGNATURE \
   )
 
+//
+// Indexes of the values of UDP4_SERVICE_DATA.Statistics.
+//
+typedef enum {
+  Udp4StatInDatagrams,
+  Udp4StatOutDatagrams,
+  Udp4StatNoPorts,
+  Udp4StatInErrors,
+  Udp4StatMax
+} UDP4_STATISTICS_INDEX;
+
 typedef struct _UDP4_SERVICE_DATA_ {
-  UINT32                          Signature;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  EFI_HANDLE                      ImageHandle;
-  EFI_HANDLE                      ControllerHandle;
-  LIST_ENTRY                      ChildrenList;
-  UINTN                           ChildrenNumber;
-  IP_IO                           *IpIo;
-
-  EFI_EVENT                       TimeoutEvent;
+  UINT32                               Signature;
+  EFI_SERVICE_BINDING_PROTOCOL         ServiceBinding;
+  EFI_HANDLE                           ImageHandle;
+  EFI_HANDLE                           ControllerHandle;
+  LIST_ENTRY                           ChildrenList;
+  UINTN                                ChildrenNumber;
+  IP_IO                                *IpIo;
+
+  EFI_EVENT                            TimeoutEvent;
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 } UDP4_SERVICE_DATA;
 
 #define UDP4_INSTANCE_DATA_SIGNATURE  SIGNATURE_32('U', 'd', 'p', 'I')
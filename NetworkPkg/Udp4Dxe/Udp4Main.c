@@ -667,6 +667,8 @@ Udp4Transmit (
     // Remove this token from the TxTokens.
     //
     Udp4RemoveToken (&Instance->TxTokens, Token);
+  } else {
+    NET_STATISTICS_INC (Udp4Service->Statistics, Udp4StatOutDatagrams);
   }
 
 FREE_PACKET:
@@ -11,6 +11,16 @@
 
 UINT16  mUdp6RandomPort;
 
+//
+// The names of the values of UDP6_SERVICE_DATA.Statistics.
+//
+STATIC CONST CHAR16 *CONST  mUdp6StatisticsNames[Udp6StatMax] = {
+  L"InDatagrams",
+  L"OutDatagrams",
+  L"NoPorts",
+  L"InErrors"
+};
+
 /**
   This function checks and timeouts the I/O datagrams holding by the corresponding
   service context.
@@ -356,6 +366,8 @@ Udp6CreateService (
     goto ON_ERROR;
   }
 
+  Udp6Service->Statistics = NetLibCreateStatistics (ControllerHandle, L"UDPv6", Udp6StatMax, mUdp6StatisticsNames);
+
   return EFI_SUCCESS;
 
 ON_ERROR:
@@ -392,6 +404,8 @@ Udp6CleanService (
   IpIoDestroy (Udp6Service->IpIo);
   Udp6Service->IpIo = NULL;
 
+  NetLibDestroyStatistics (Udp6Service->Statistics);
+
   ZeroMem (Udp6Service, sizeof (UDP6_SERVICE_DATA));
 }
 
@@ -1596,6 +1610,7 @@ Udp6Demultiplex (
   UINTN                  Enqueued;
 
   if (Packet->TotalSize < UDP6_HEADER_SIZE) {
+    NET_STATISTICS_INC (Udp6Service->Statistics, Udp6StatInErrors);
     NetbufFree (Packet);
     return;
   }
@@ -1625,6 +1640,7 @@ Udp6Demultiplex (
       //
       // Wrong checksum.
       //
+      NET_STATISTICS_INC (Udp6Service->Statistics, Udp6StatInErrors);
       NetbufFree (Packet);
       return;
     }
@@ -1649,7 +1665,11 @@ Udp6Demultiplex (
   //
   Enqueued = Udp6EnqueueDgram (Udp6Service, Packet, &RxData);
 
+  NET_STATISTICS_INC (Udp6Service->Statistics, Udp6StatInDatagrams);
+
   if (Enqueued == 0) {
+    NET_STATISTICS_INC (Udp6Service->Statistics, Udp6StatNoPorts);
+
     //
     // Send the port unreachable ICMP packet before we free this NET_BUF
     //
@@ -64,15 +64,27 @@ extern UINT16                        mUdp6RandomPort;
 //
 // Udp6 service contest data
 //
+//
+// Indexes of the values of UDP6_SERVICE_DATA.Statistics.
+//
+typedef enum {
+  Udp6StatInDatagrams,
+  Udp6StatOutDatagrams,
+  Udp6StatNoPorts,
+  Udp6StatInErrors,
+  Udp6StatMax
+} UDP6_STATISTICS_INDEX;
+
 typedef struct _UDP6_SERVICE_DATA {
-  UINT32                          Signature;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  EFI_HANDLE                      ImageHandle;
-  EFI_HANDLE                      ControllerHandle;
-  LIST_ENTRY                      ChildrenList;
-  UINTN                           ChildrenNumber;
-  IP_IO                           *IpIo;
-  EFI_EVENT                       TimeoutEvent;
+  UINT32                               Signature;
+  EFI_SERVICE_BINDING_PROTOCOL         ServiceBinding;
+  EFI_HANDLE                           ImageHandle;
+  EFI_HANDLE                           ControllerHandle;
+  LIST_ENTRY                           ChildrenList;
+  UINTN                                ChildrenNumber;
+  IP_IO                                *IpIo;
+  EFI_EVENT                            TimeoutEvent;
+  EDKII_NETWORK_STATISTICS_PROTOCOL    *Statistics;
 } UDP6_SERVICE_DATA;
 
 typedef struct _UDP6_INSTANCE_DATA {
@@ -643,6 +643,8 @@ Udp6Transmit (
     // Remove this token from the TxTokens.
     //
     Udp6RemoveToken (&Instance->TxTokens, Token);
+  } else {
+    NET_STATISTICS_INC (Udp6Service->Statistics, Udp6StatOutDatagrams);
   }
 
 FREE_PACKET:
@@ -151,6 +151,29 @@ PlatformGetSystemMemorySizeBelow4gb (
   IN EFI_HOB_PLATFORM_INFO  *PlatformInfoHob
   );
 
+/**
+  Get the range of the memory below 4GB that is left unaccepted before DXE.
+
+  If PcdAcceptPartialMemorySize is not zero, a TDX or SEV-SNP guest only
+  accepts the memory below the end of the DXE memory FV and the top
+  PcdAcceptPartialMemorySize bytes of the memory below 4GB before DXE. The
+  memory in between is reported as unaccepted memory.
+
+  @param[in]  PlatformInfoHob  The platform info HOB. LowMemory must be set.
+  @param[out] Start            The start address of the range.
+  @param[out] End              The end address of the range.
+
+  @retval TRUE   The range is not empty.
+  @retval FALSE  All the memory below 4GB is accepted before DXE.
+**/
+BOOLEAN
+EFIAPI
+PlatformGetUnacceptedMemoryRange (
+  IN  EFI_HOB_PLATFORM_INFO  *PlatformInfoHob,
+  OUT EFI_PHYSICAL_ADDRESS   *Start,
+  OUT EFI_PHYSICAL_ADDRESS   *End
+  );
+
 /**
   Initialize the PhysMemAddressWidth field in PlatformInfoHob based on guest RAM size.
 **/
@@ -86,6 +86,12 @@ typedef struct _SEC_TDX_WORK_AREA {
   UINT32                   Gpaw;
   UINT64                   HobList;
   TDX_MEASUREMENTS_DATA    TdxMeasurementsData;
+  //
+  // The range of the memory below 4GB that SEC leaves unaccepted, see
+  // PcdAcceptPartialMemorySize. Both are zero if all of it is accepted.
+  //
+  UINT64                   UnacceptedMemoryStart;
+  UINT64                   UnacceptedMemoryEnd;
 } SEC_TDX_WORK_AREA;
 
 typedef struct _TDX_WORK_AREA {
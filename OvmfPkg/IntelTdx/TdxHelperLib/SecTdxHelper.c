@@ -310,6 +310,113 @@ MpAcceptMemoryResourceRange (
   return EFI_SUCCESS;
 }
 
+/**
+  Decide the range of the memory below 4GB that SEC leaves unaccepted, and save
+  it in the TDX work area.
+
+  Firmware only needs the memory below PcdOvmfDxeMemFvBase + PcdOvmfDxeMemFvSize
+  and the memory at the top of the memory below 4GB, where the permanent PEI
+  memory and the DXE allocations come from. If PcdAcceptPartialMemorySize is
+  not zero, only the top PcdAcceptPartialMemorySize bytes are accepted besides
+  the low memory. The memory in between is reported as unaccepted memory, which
+  DXE accepts on demand and the OS accepts when it uses it.
+
+  @param[in] VmmHobList    The Hoblist pass the firmware
+**/
+STATIC
+VOID
+SetUnacceptedMemoryRange (
+  IN CONST VOID  *VmmHobList
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  EFI_PHYSICAL_ADDRESS  PhysicalEnd;
+  EFI_PHYSICAL_ADDRESS  LowMemoryEnd;
+  EFI_PHYSICAL_ADDRESS  UnacceptedStart;
+  EFI_PHYSICAL_ADDRESS  UnacceptedEnd;
+  UINT64                AcceptSize;
+  OVMF_WORK_AREA        *WorkArea;
+
+  WorkArea = (OVMF_WORK_AREA *)FixedPcdGet32 (PcdOvmfWorkAreaBase);
+  WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart = 0;
+  WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd   = 0;
+
+  AcceptSize = FixedPcdGet64 (PcdAcceptPartialMemorySize);
+  if (AcceptSize == 0) {
+    return;
+  }
+
+  LowMemoryEnd = 0;
+  for (Hob.Raw = (UINT8 *)VmmHobList; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if ((Hob.Header->HobType == EFI_HOB_TYPE_RESOURCE_DESCRIPTOR) &&
+        (Hob.ResourceDescriptor->ResourceType == BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED) &&
+        (Hob.ResourceDescriptor->PhysicalStart < BASE_4GB))
+    {
+      PhysicalEnd  = MIN (Hob.ResourceDescriptor->PhysicalStart + Hob.ResourceDescriptor->ResourceLength, BASE_4GB);
+      LowMemoryEnd = MAX (LowMemoryEnd, PhysicalEnd);
+    }
+  }
+
+  UnacceptedStart = ALIGN_VALUE (FixedPcdGet32 (PcdOvmfDxeMemFvBase) + FixedPcdGet32 (PcdOvmfDxeMemFvSize), SIZE_2MB);
+  if (LowMemoryEnd <= UnacceptedStart + AcceptSize) {
+    return;
+  }
+
+  UnacceptedEnd = (LowMemoryEnd - AcceptSize) & ~(UINT64)ALIGNED_2MB_MASK;
+  if (UnacceptedEnd <= UnacceptedStart) {
+    return;
+  }
+
+  DEBUG ((DEBUG_INFO, "Leave 0x%llx - 0x%llx unaccepted\n", UnacceptedStart, UnacceptedEnd));
+  WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart = UnacceptedStart;
+  WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd   = UnacceptedEnd;
+}
+
+/**
+  Get a part of a memory region that SEC accepts.
+
+  The range that SEC leaves unaccepted splits a memory region into at most two
+  parts to be accepted, the one below the range (Part 0) and the one above the
+  range (Part 1).
+
+  @param[in]      Part            The part to get, 0 or 1
+  @param[in, out] PhysicalStart   On input, the start address of the memory region.
+                                  On output, the start address of the part.
+  @param[in, out] PhysicalEnd     On input, the end address of the memory region.
+                                  On output, the end address of the part.
+
+  @retval  TRUE    The part is not empty
+  @retval  FALSE   The part is empty
+**/
+STATIC
+BOOLEAN
+GetAcceptedPart (
+  IN     UINTN                 Part,
+  IN OUT EFI_PHYSICAL_ADDRESS  *PhysicalStart,
+  IN OUT EFI_PHYSICAL_ADDRESS  *PhysicalEnd
+  )
+{
+  OVMF_WORK_AREA        *WorkArea;
+  EFI_PHYSICAL_ADDRESS  UnacceptedStart;
+  EFI_PHYSICAL_ADDRESS  UnacceptedEnd;
+
+  WorkArea        = (OVMF_WORK_AREA *)FixedPcdGet32 (PcdOvmfWorkAreaBase);
+  UnacceptedStart = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart;
+  UnacceptedEnd   = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd;
+
+  if (UnacceptedStart == UnacceptedEnd) {
+    return (Part == 0) && (*PhysicalStart < *PhysicalEnd);
+  }
+
+  if (Part == 0) {
+    *PhysicalEnd = MIN (*PhysicalEnd, UnacceptedStart);
+  } else {
+    *PhysicalStart = MAX (*PhysicalStart, UnacceptedEnd);
+  }
+
+  return *PhysicalStart < *PhysicalEnd;
+}
+
 /**
   BSP accept a small piece of memory which will be used as APs stack.
 
@@ -335,6 +442,7 @@ AcceptMemoryForAPsStack (
   EFI_PHYSICAL_ADDRESS  PhysicalStart;
   UINT64                ResourceLength;
   BOOLEAN               MemoryRegionFound;
+  UINTN                 Part;
 
   ASSERT (VmmHobList != NULL);
 
@@ -361,17 +469,26 @@ AcceptMemoryForAPsStack (
         DEBUG ((DEBUG_INFO, "ResourceLength: 0x%llx\n", ResourceLength));
         DEBUG ((DEBUG_INFO, "Owner: %g\n\n", &Hob.ResourceDescriptor->Owner));
 
-        if (ResourceLength >= APsStackSize) {
-          MemoryRegionFound = TRUE;
-          if (ResourceLength > ACCEPT_CHUNK_SIZE) {
-            PhysicalEnd = Hob.ResourceDescriptor->PhysicalStart + APsStackSize;
+        for (Part = 0; Part < 2 && !MemoryRegionFound; Part++) {
+          PhysicalStart = Hob.ResourceDescriptor->PhysicalStart;
+          PhysicalEnd   = PhysicalStart + ResourceLength;
+          if (!GetAcceptedPart (Part, &PhysicalStart, &PhysicalEnd)) {
+            continue;
+          }
+
+          if (PhysicalEnd - PhysicalStart >= APsStackSize) {
+            MemoryRegionFound = TRUE;
+            if (PhysicalEnd - PhysicalStart > ACCEPT_CHUNK_SIZE) {
+              PhysicalEnd = PhysicalStart + APsStackSize;
+            }
+          }
+
+          Status = BspAcceptMemoryResourceRange (PhysicalStart, PhysicalEnd);
+          if (EFI_ERROR (Status)) {
+            break;
           }
         }
 
-        Status = BspAcceptMemoryResourceRange (
-                   Hob.ResourceDescriptor->PhysicalStart,
-                   PhysicalEnd
-                   );
         if (EFI_ERROR (Status)) {
           break;
         }
@@ -412,7 +529,10 @@ AcceptMemory (
   EFI_PEI_HOB_POINTERS  Hob;
   EFI_PHYSICAL_ADDRESS  PhysicalStart;
   EFI_PHYSICAL_ADDRESS  PhysicalEnd;
+  EFI_PHYSICAL_ADDRESS  PartStart;
+  EFI_PHYSICAL_ADDRESS  PartEnd;
   EFI_PHYSICAL_ADDRESS  AcceptMemoryEndAddress;
+  UINTN                 Part;
 
   Status                 = EFI_SUCCESS;
   AcceptMemoryEndAddress = BASE_4GB;
@@ -459,16 +579,25 @@ AcceptMemory (
         DEBUG ((DEBUG_INFO, "ResourceLength: 0x%llx\n", Hob.ResourceDescriptor->ResourceLength));
         DEBUG ((DEBUG_INFO, "Owner: %g\n\n", &Hob.ResourceDescriptor->Owner));
 
-        // Now we're ready to accept memory [PhysicalStart, PhysicalEnd)
-        if (CpusNum == 1) {
-          Status = BspAcceptMemoryResourceRange (PhysicalStart, PhysicalEnd);
-        } else {
-          Status = MpAcceptMemoryResourceRange (
-                     PhysicalStart,
-                     PhysicalEnd,
-                     APsStackStartAddress,
-                     CpusNum
-                     );
+        // Now we're ready to accept memory [PhysicalStart, PhysicalEnd),
+        // except the range that is left unaccepted.
+        for (Part = 0; Part < 2 && !EFI_ERROR (Status); Part++) {
+          PartStart = PhysicalStart;
+          PartEnd   = PhysicalEnd;
+          if (!GetAcceptedPart (Part, &PartStart, &PartEnd)) {
+            continue;
+          }
+
+          if (CpusNum == 1) {
+            Status = BspAcceptMemoryResourceRange (PartStart, PartEnd);
+          } else {
+            Status = MpAcceptMemoryResourceRange (
+                       PartStart,
+                       PartEnd,
+                       APsStackStartAddress,
+                       CpusNum
+                       );
+          }
         }
 
         if (EFI_ERROR (Status)) {
@@ -732,6 +861,8 @@ ProcessHobList (
 
   CpusNum = GetCpusNum ();
 
+  SetUnacceptedMemoryRange (VmmHobList);
+
   //
   // If there are mutli-vCPU in a TDX guest, accept memory is split into 2 phases.
   // Phase-1 accepts a small piece of memory by BSP. This piece of memory
@@ -21,6 +21,7 @@
 #include <Library/PlatformInitLib.h>
 #include <OvmfPlatforms.h>
 #include <Pi/PrePiHob.h>
+#include <WorkArea.h>
 #include "PeilessStartupInternal.h"
 
 /**
@@ -77,8 +78,12 @@ ConstructFwHobList (
   EFI_PEI_HOB_POINTERS  Hob;
   EFI_PHYSICAL_ADDRESS  PhysicalEnd;
   UINT64                ResourceLength;
+  EFI_PHYSICAL_ADDRESS  PhysicalStart;
   EFI_PHYSICAL_ADDRESS  LowMemoryStart;
   UINT64                LowMemoryLength;
+  EFI_PHYSICAL_ADDRESS  UnacceptedStart;
+  EFI_PHYSICAL_ADDRESS  UnacceptedEnd;
+  OVMF_WORK_AREA        *WorkArea;
 
   ASSERT (VmmHobList != NULL);
 
@@ -87,18 +92,40 @@ ConstructFwHobList (
   LowMemoryLength = 0;
   LowMemoryStart  = 0;
 
+  //
+  // SEC may leave a range of the memory under 4GB unaccepted (see
+  // PcdAcceptPartialMemorySize). The Fw hoblist cannot be put there.
+  //
+  WorkArea        = (OVMF_WORK_AREA *)(UINTN)FixedPcdGet32 (PcdOvmfWorkAreaBase);
+  UnacceptedStart = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart;
+  UnacceptedEnd   = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd;
+
   //
   // Parse the HOB list until end of list or matching type is found.
   //
   while (!END_OF_HOB_LIST (Hob)) {
     if (Hob.Header->HobType == EFI_HOB_TYPE_RESOURCE_DESCRIPTOR) {
       if (Hob.ResourceDescriptor->ResourceType == BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED) {
-        PhysicalEnd    = Hob.ResourceDescriptor->PhysicalStart + Hob.ResourceDescriptor->ResourceLength;
+        PhysicalStart  = Hob.ResourceDescriptor->PhysicalStart;
+        PhysicalEnd    = PhysicalStart + Hob.ResourceDescriptor->ResourceLength;
         ResourceLength = Hob.ResourceDescriptor->ResourceLength;
 
         if (PhysicalEnd <= BASE_4GB) {
+          if ((PhysicalStart < UnacceptedEnd) && (PhysicalEnd > UnacceptedStart)) {
+            //
+            // Use the larger accepted part of the memory region.
+            //
+            if (MAX (PhysicalStart, UnacceptedStart) - PhysicalStart >= PhysicalEnd - MIN (PhysicalEnd, UnacceptedEnd)) {
+              PhysicalEnd = MAX (PhysicalStart, UnacceptedStart);
+            } else {
+              PhysicalStart = UnacceptedEnd;
+            }
+
+            ResourceLength = PhysicalEnd - PhysicalStart;
+          }
+
           if (ResourceLength > LowMemoryLength) {
-            LowMemoryStart  = Hob.ResourceDescriptor->PhysicalStart;
+            LowMemoryStart  = PhysicalStart;
             LowMemoryLength = ResourceLength;
           }
         } else {
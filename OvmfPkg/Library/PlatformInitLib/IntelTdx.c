@@ -23,7 +23,10 @@
 
 /**
  * Build ResourceDescriptorHob for the unaccepted memory region.
- * This memory region may be splitted into 2 parts because of lazy accept.
+ * This memory region may be splitted into several parts because of lazy
+ * accept. SEC has accepted the memory under 4G, except the range recorded
+ * in the TDX work area (see PcdAcceptPartialMemorySize). The memory above 4G
+ * and the memory in that range are not accepted.
  *
  * @param Hob     Point to the EFI_HOB_RESOURCE_DESCRIPTOR
  * @return VOID
@@ -35,44 +38,64 @@ BuildResourceDescriptorHobForUnacceptedMemory (
 {
   EFI_PHYSICAL_ADDRESS         PhysicalStart;
   EFI_PHYSICAL_ADDRESS         PhysicalEnd;
-  UINT64                       ResourceLength;
+  EFI_PHYSICAL_ADDRESS         PartEnd;
   EFI_RESOURCE_TYPE            ResourceType;
   EFI_RESOURCE_ATTRIBUTE_TYPE  ResourceAttribute;
-  UINT64                       MaxAcceptedMemoryAddress;
+  EFI_PHYSICAL_ADDRESS         Boundaries[3];
+  BOOLEAN                      Accepted;
+  UINTN                        Index;
+  OVMF_WORK_AREA               *WorkArea;
 
   ASSERT (Hob->ResourceType == BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED);
 
-  ResourceType      = BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED;
-  ResourceAttribute = Hob->ResourceAttribute;
-  PhysicalStart     = Hob->PhysicalStart;
-  ResourceLength    = Hob->ResourceLength;
-  PhysicalEnd       = PhysicalStart + ResourceLength;
+  PhysicalStart = Hob->PhysicalStart;
+  PhysicalEnd   = PhysicalStart + Hob->ResourceLength;
 
   //
-  // In the first stage of lazy-accept, all the memory under 4G will be accepted.
-  // The memory above 4G will not be accepted.
+  // The memory in [0, Boundaries[0]) and [Boundaries[1], Boundaries[2]) has
+  // been accepted. The memory in [Boundaries[0], Boundaries[1]) and above
+  // Boundaries[2] has not been accepted.
   //
-  MaxAcceptedMemoryAddress = BASE_4GB;
+  WorkArea      = (OVMF_WORK_AREA *)(UINTN)FixedPcdGet32 (PcdOvmfWorkAreaBase);
+  Boundaries[0] = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart;
+  Boundaries[1] = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd;
+  Boundaries[2] = BASE_4GB;
+  if (Boundaries[0] == Boundaries[1]) {
+    Boundaries[0] = BASE_4GB;
+    Boundaries[1] = BASE_4GB;
+  }
+
+  Index = 0;
+  while (PhysicalStart < PhysicalEnd) {
+    while ((Index < ARRAY_SIZE (Boundaries)) && (PhysicalStart >= Boundaries[Index])) {
+      Index++;
+    }
 
-  if (PhysicalEnd <= MaxAcceptedMemoryAddress) {
-    //
-    // This memory region has been accepted.
-    //
-    ResourceType       = EFI_RESOURCE_SYSTEM_MEMORY;
-    ResourceAttribute |= (EFI_RESOURCE_ATTRIBUTE_PRESENT | EFI_RESOURCE_ATTRIBUTE_INITIALIZED | EFI_RESOURCE_ATTRIBUTE_TESTED);
-  } else if (PhysicalStart >= MaxAcceptedMemoryAddress) {
     //
-    // This memory region hasn't been accepted.
-    // So keep the ResourceType and ResourceAttribute unchange.
+    // Index is even in an accepted part and odd in an unaccepted part.
     //
-  }
+    Accepted = (BOOLEAN)((Index % 2) == 0 && Index < ARRAY_SIZE (Boundaries));
+    PartEnd  = PhysicalEnd;
+    if ((Index < ARRAY_SIZE (Boundaries)) && (Boundaries[Index] < PartEnd)) {
+      PartEnd = Boundaries[Index];
+    }
 
-  BuildResourceDescriptorHob (
-    ResourceType,
-    ResourceAttribute,
-    PhysicalStart,
-    ResourceLength
-    );
+    ResourceType      = BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED;
+    ResourceAttribute = Hob->ResourceAttribute;
+    if (Accepted) {
+      ResourceType       = EFI_RESOURCE_SYSTEM_MEMORY;
+      ResourceAttribute |= (EFI_RESOURCE_ATTRIBUTE_PRESENT | EFI_RESOURCE_ATTRIBUTE_INITIALIZED | EFI_RESOURCE_ATTRIBUTE_TESTED);
+    }
+
+    BuildResourceDescriptorHob (
+      ResourceType,
+      ResourceAttribute,
+      PhysicalStart,
+      PartEnd - PhysicalStart
+      );
+
+    PhysicalStart = PartEnd;
+  }
 }
 
 /**
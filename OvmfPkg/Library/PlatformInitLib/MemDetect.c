@@ -20,6 +20,9 @@ Module Name:
 #include <IndustryStandard/Xen/arch-x86/hvm/start_info.h>
 #include <PiPei.h>
 #include <Register/Intel/SmramSaveStateMap.h>
+#include <Register/Amd/Msr.h>
+#include <WorkArea.h>
+#include <ConfidentialComputingGuestAttr.h>
 
 //
 // The Library classes this module consumes
@@ -402,6 +405,77 @@ PlatformGetSystemMemorySizeBelow4gb (
   PlatformInfoHob->LowMemory = (UINT32)(((UINTN)((Cmos0x35 << 8) + Cmos0x34) << 16) + SIZE_16MB);
 }
 
+/**
+  Get the range of the memory below 4GB that is left unaccepted before DXE.
+
+  If PcdAcceptPartialMemorySize is not zero, a TDX or SEV-SNP guest only
+  accepts the memory below the end of the DXE memory FV and the top
+  PcdAcceptPartialMemorySize bytes of the memory below 4GB before DXE. The
+  memory in between is reported as unaccepted memory. TDX SEC saves the range
+  in the TDX work area; for SEV-SNP it is computed from the low memory size.
+
+  @param[in]  PlatformInfoHob  The platform info HOB. LowMemory must be set.
+  @param[out] Start            The start address of the range.
+  @param[out] End              The end address of the range.
+
+  @retval TRUE   The range is not empty.
+  @retval FALSE  All the memory below 4GB is accepted before DXE.
+**/
+BOOLEAN
+EFIAPI
+PlatformGetUnacceptedMemoryRange (
+  IN  EFI_HOB_PLATFORM_INFO  *PlatformInfoHob,
+  OUT EFI_PHYSICAL_ADDRESS   *Start,
+  OUT EFI_PHYSICAL_ADDRESS   *End
+  )
+{
+  OVMF_WORK_AREA           *WorkArea;
+  MSR_SEV_STATUS_REGISTER  SevStatus;
+  UINT64                   AcceptSize;
+
+  *Start     = 0;
+  *End       = 0;
+  AcceptSize = FixedPcdGet64 (PcdAcceptPartialMemorySize);
+  if ((AcceptSize == 0) || (FixedPcdGet32 (PcdOvmfWorkAreaSize) == 0)) {
+    return FALSE;
+  }
+
+  WorkArea = (OVMF_WORK_AREA *)(UINTN)FixedPcdGet32 (PcdOvmfWorkAreaBase);
+  switch (WorkArea->Header.GuestType) {
+    case CcGuestTypeIntelTdx:
+      *Start = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryStart;
+      *End   = WorkArea->TdxWorkArea.SecTdxWorkArea.UnacceptedMemoryEnd;
+      break;
+
+    case CcGuestTypeAmdSev:
+      SevStatus.Uint32 = (UINT32)WorkArea->SevWorkArea.SevEsWorkArea.SevStatusMsrValue;
+      if (!SevStatus.Bits.SevSnpBit) {
+        return FALSE;
+      }
+
+      *Start = ALIGN_VALUE (
+                 (UINT64)FixedPcdGet32 (PcdOvmfDxeMemFvBase) + FixedPcdGet32 (PcdOvmfDxeMemFvSize),
+                 SIZE_2MB
+                 );
+      if (PlatformInfoHob->LowMemory > *Start + AcceptSize) {
+        *End = (PlatformInfoHob->LowMemory - AcceptSize) & ~(UINT64)(SIZE_2MB - 1);
+      }
+
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  if (*Start >= *End) {
+    *Start = 0;
+    *End   = 0;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 STATIC
 UINT64
 PlatformGetSystemMemorySizeAbove4gb (
@@ -0,0 +1,212 @@
+# @file
+# Boot-phase timing benchmark of OVMF under QEMU
+#
+# Boots the firmware image several times, timestamps on the host the first
+# DEBUG message of each boot phase as it reaches the debug console, and reports
+# the median duration of the SEC, PEI, DXE and BDS phases with a confidence
+# interval. The results can be compared with a stored baseline, and a phase
+# that got significantly slower fails the benchmark.
+#
+# The phases are taken from the debug console rather than the FPDT, so that any
+# DEBUG or NOOPT image can be measured, without the performance libraries and
+# the Dp shell command. With KVM the messages are timestamped to a few
+# microseconds; with TCG the times are much noisier.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+##
+import argparse
+import json
+import logging
+import math
+import os
+import shlex
+import statistics
+import subprocess
+import sys
+import threading
+import time
+
+#
+# The first DEBUG message of each phase, in boot order. A phase ends when the
+# next one starts, and BDS ends when it boots the first boot option.
+#
+PHASE_MARKERS = (
+    ("SEC", b"SecCoreStartupWithStack("),
+    ("PEI", b"Install PPI:"),
+    ("DXE", b"Loading DXE CORE at"),
+    ("BDS", b"[Bds] Entry..."),
+)
+BOOT_MARKER = b"[Bds]Booting "
+
+DEFAULT_TIMEOUT = 300
+DEFAULT_TOLERANCE = 10
+DEFAULT_CONFIDENCE = 0.95
+
+
+def BootOnce(Cmd, Timeout=DEFAULT_TIMEOUT):
+    ''' Boot QEMU until BDS boots the first boot option, and return the
+    time of each marker in seconds from the start of QEMU. '''
+    Markers = PHASE_MARKERS + (("Boot", BOOT_MARKER),)
+    Times = {}
+    Start = time.monotonic()
+    Proc = subprocess.Popen(Cmd, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    Timer = threading.Timer(Timeout, Proc.kill)
+    Timer.start()
+    try:
+        for Line in Proc.stdout:
+            Now = time.monotonic() - Start
+            for Name, Marker in Markers:
+                if Name not in Times and Marker in Line:
+                    Times[Name] = Now
+            if "Boot" in Times:
+                break
+    finally:
+        Timer.cancel()
+        Proc.kill()
+        Proc.wait()
+
+    Missing = [Name for Name, _ in Markers if Name not in Times]
+    if Missing:
+        raise RuntimeError("boot markers not found on the debug console: " + ", ".join(Missing) +
+                           " (is it a DEBUG image, and did it boot within %d seconds?)" % Timeout)
+    return Times
+
+
+def PhaseDurations(Times):
+    ''' Split the marker times of a boot into the durations of the phases. '''
+    Names = [Name for Name, _ in PHASE_MARKERS] + ["Boot"]
+    Durations = {"Launch": Times[Names[0]]}
+    for Index in range(len(Names) - 1):
+        Durations[Names[Index]] = Times[Names[Index + 1]] - Times[Names[Index]]
+    Durations["Total"] = Times["Boot"]
+    return Durations
+
+
+def MedianConfidenceInterval(Values, Confidence=DEFAULT_CONFIDENCE):
+    ''' Return the distribution-free confidence interval of the median, from
+    the order statistics of the samples. With fewer than six samples, the 95%
+    interval is the range of the samples. '''
+    Sorted = sorted(Values)
+    Count = len(Sorted)
+    Alpha = (1 - Confidence) / 2
+    Cumulative = 0
+    Rank = 0
+    for Index in range(Count):
+        Cumulative += math.comb(Count, Index) / 2 ** Count
+        if Cumulative > Alpha:
+            break
+        Rank = Index + 1
+    if Rank == 0:
+        return (Sorted[0], Sorted[-1])
+    return (Sorted[Rank - 1], Sorted[Count - Rank])
+
+
+def Summarize(Samples, Confidence=DEFAULT_CONFIDENCE):
+    ''' Reduce the durations of each boot to the statistics of each phase. '''
+    Phases = {}
+    for Name in Samples[0]:
+        Values = [Durations[Name] for Durations in Samples]
+        Lower, Upper = MedianConfidenceInterval(Values, Confidence)
+        Phases[Name] = {
+            "median": statistics.median(Values),
+            "ci_low": Lower,
+            "ci_high": Upper,
+            "min": min(Values),
+            "max": max(Values),
+        }
+    return {"boots": len(Samples), "confidence": Confidence, "phases": Phases}
+
+
+def CompareWithBaseline(Results, Baseline, Tolerance=DEFAULT_TOLERANCE):
+    ''' Return the phases that regressed: whose median is more than Tolerance
+    percent above the baseline median, and whose whole confidence interval is
+    above it, so that noise alone does not fail the benchmark. '''
+    Regressions = []
+    for Name, Phase in Results["phases"].items():
+        Base = Baseline.get("phases", {}).get(Name)
+        if Base is None:
+            continue
+        if Phase["median"] > Base["median"] * (1 + Tolerance / 100) and Phase["ci_low"] > Base["median"]:
+            Regressions.append(Name)
+    return Regressions
+
+
+def LogResults(Results, Baseline=None):
+    logging.info("Boot benchmark, %d boots, median and %d%% confidence interval in ms:",
+                 Results["boots"], round(Results["confidence"] * 100))
+    for Name, Phase in Results["phases"].items():
+        Line = "  %-6s %9.1f  [%9.1f, %9.1f]" % (Name, Phase["median"] * 1000, Phase["ci_low"] * 1000,
+                                                 Phase["ci_high"] * 1000)
+        Base = None if Baseline is None else Baseline.get("phases", {}).get(Name)
+        if Base is not None:
+            Line += "  baseline %9.1f  %+6.1f%%" % (Base["median"] * 1000,
+                                                    (Phase["median"] / Base["median"] - 1) * 100)
+        logging.info(Line)
+
+
+def Run(Cmd, Boots, OutputFile=None, BaselineFile=None, Tolerance=DEFAULT_TOLERANCE, Timeout=DEFAULT_TIMEOUT):
+    ''' Run the boot benchmark, write the results to OutputFile, and compare
+    them with the results in BaselineFile. Return 0 on success, 1 when a
+    phase regressed or the image did not boot. '''
+    if os.access("/dev/kvm", os.R_OK | os.W_OK):
+        #
+        # The first accelerator that initializes is used, so KVM is preferred
+        # over the TCG that the command may ask for.
+        #
+        Cmd = [Cmd[0], "-accel", "kvm"] + Cmd[1:]
+    else:
+        logging.warning("KVM is not available, the boot times of TCG are noisy")
+
+    try:
+        #
+        # The first boot creates the boot options and variables, it is a
+        # warm-up that is not measured.
+        #
+        BootOnce(Cmd, Timeout)
+        Samples = []
+        for Index in range(Boots):
+            Samples.append(PhaseDurations(BootOnce(Cmd, Timeout)))
+    except (OSError, RuntimeError) as Error:
+        logging.error("Boot benchmark failed: %s" % Error)
+        return 1
+
+    Results = Summarize(Samples)
+    if OutputFile is not None:
+        with open(OutputFile, "w") as File:
+            json.dump(Results, File, indent=2)
+        logging.info("Boot benchmark results written to %s" % OutputFile)
+
+    Baseline = None
+    if BaselineFile is not None:
+        with open(BaselineFile, "r") as File:
+            Baseline = json.load(File)
+    LogResults(Results, Baseline)
+
+    if Baseline is not None:
+        Regressions = CompareWithBaseline(Results, Baseline, Tolerance)
+        if Regressions:
+            logging.error("Boot time regression of more than %d%% in: %s" % (Tolerance, ", ".join(Regressions)))
+            return 1
+    return 0
+
+
+def main():
+    Parser = argparse.ArgumentParser(description="Boot-phase timing benchmark of OVMF under QEMU.")
+    Parser.add_argument("-n", "--boots", type=int, default=10, help="number of measured boots, 10 by default")
+    Parser.add_argument("-o", "--output", help="JSON file of the results, to use as a future baseline")
+    Parser.add_argument("-b", "--baseline", help="JSON file of the baseline results to compare with")
+    Parser.add_argument("-t", "--tolerance", type=int, default=DEFAULT_TOLERANCE,
+                        help="regression threshold in percent of the baseline median, %d by default" % DEFAULT_TOLERANCE)
+    Parser.add_argument("qemu", nargs=argparse.REMAINDER,
+                        help="QEMU command line, with the debug console on stdio")
+    Args = Parser.parse_args()
+    if not Args.qemu:
+        Parser.error("the QEMU command line is required")
+
+    logging.basicConfig(level=logging.INFO, format="%(message)s")
+    return Run(Args.qemu, Args.boots, Args.output, Args.baseline, Args.tolerance)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
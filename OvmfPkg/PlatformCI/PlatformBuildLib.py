@@ -7,6 +7,9 @@
 import os
 import logging
 import io
+import shlex
+
+import BootBenchmark
 
 from edk2toolext.environment import shell_environment
 from edk2toolext.environment.uefi_build import UefiBuilder
@@ -212,6 +215,21 @@ class PlatformBuilder( UefiBuilder, BuildSettingsManager):
             args += " -pflash " + os.path.join(OutputPath_FV, "OVMF.fd")    # path to firmware
 
 
+        #
+        # QEMU_BENCHMARK_BOOTS=N boots the image N times to measure the boot
+        # phases, instead of running it to the shell.
+        #
+        Boots = int(self.env.GetValue("QEMU_BENCHMARK_BOOTS", "0"))
+        if Boots > 0:
+            if "-display none" not in args:
+                args += " -display none"
+            return BootBenchmark.Run(
+                [cmd] + shlex.split(args, posix=(os.name != "nt")),
+                Boots,
+                os.path.join(self.env.GetValue("BUILD_OUTPUT_BASE"), "BootBenchmark.json"),
+                self.env.GetValue("QEMU_BENCHMARK_BASELINE"),
+                int(self.env.GetValue("QEMU_BENCHMARK_TOLERANCE", str(BootBenchmark.DEFAULT_TOLERANCE))))
+
         if (self.env.GetValue("MAKE_STARTUP_NSH").upper() == "TRUE"):
             f = open(os.path.join(VirtualDrive, "startup.nsh"), "w")
             f.write("BOOT SUCCESS !!! \n")
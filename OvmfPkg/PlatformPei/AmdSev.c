@@ -31,20 +31,73 @@ GetHypervisorFeature (
   VOID
   );
 
+/**
+  Split the part of a system memory resource HOB that is left unaccepted off
+  the HOB.
+
+  The HOB keeps its lowest part, and HOBs are built for the other parts. The
+  built system memory HOB is validated when the caller reaches it.
+
+  @param[in, out] ResourceHob      The system memory resource HOB that overlaps
+                                   the range.
+  @param[in]      UnacceptedStart  The start address of the range.
+  @param[in]      UnacceptedEnd    The end address of the range.
+
+**/
+STATIC
+VOID
+AmdSevSnpSplitUnacceptedMemory (
+  IN OUT EFI_HOB_RESOURCE_DESCRIPTOR  *ResourceHob,
+  IN     EFI_PHYSICAL_ADDRESS         UnacceptedStart,
+  IN     EFI_PHYSICAL_ADDRESS         UnacceptedEnd
+  )
+{
+  EFI_PHYSICAL_ADDRESS  PhysicalEnd;
+
+  PhysicalEnd = ResourceHob->PhysicalStart + ResourceHob->ResourceLength;
+  if (PhysicalEnd > UnacceptedEnd) {
+    BuildResourceDescriptorHob (
+      EFI_RESOURCE_SYSTEM_MEMORY,
+      ResourceHob->ResourceAttribute,
+      UnacceptedEnd,
+      PhysicalEnd - UnacceptedEnd
+      );
+    PhysicalEnd = UnacceptedEnd;
+  }
+
+  if (ResourceHob->PhysicalStart < UnacceptedStart) {
+    BuildResourceDescriptorHob (
+      BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED,
+      ResourceHob->ResourceAttribute,
+      UnacceptedStart,
+      PhysicalEnd - UnacceptedStart
+      );
+    PhysicalEnd = UnacceptedStart;
+  } else {
+    ResourceHob->ResourceType = BZ3937_EFI_RESOURCE_MEMORY_UNACCEPTED;
+  }
+
+  ResourceHob->ResourceLength = PhysicalEnd - ResourceHob->PhysicalStart;
+}
+
 /**
   Initialize SEV-SNP support if running as an SEV-SNP guest.
 
+  @param[in]  PlatformInfoHob   Pointer to the platform info HOB.
+
 **/
 STATIC
 VOID
 AmdSevSnpInitialize (
-  VOID
+  IN EFI_HOB_PLATFORM_INFO  *PlatformInfoHob
   )
 {
   EFI_PEI_HOB_POINTERS         Hob;
   EFI_HOB_RESOURCE_DESCRIPTOR  *ResourceHob;
   UINT64                       HvFeatures;
   EFI_STATUS                   PcdStatus;
+  EFI_PHYSICAL_ADDRESS         UnacceptedStart;
+  EFI_PHYSICAL_ADDRESS         UnacceptedEnd;
 
   if (!MemEncryptSevSnpIsEnabled ()) {
     return;
@@ -59,8 +112,10 @@ AmdSevSnpInitialize (
   ASSERT_RETURN_ERROR (PcdStatus);
 
   //
-  // Iterate through the system RAM and validate it.
+  // Iterate through the system RAM and validate it, except the memory that is
+  // left unaccepted (see PcdAcceptPartialMemorySize).
   //
+  PlatformGetUnacceptedMemoryRange (PlatformInfoHob, &UnacceptedStart, &UnacceptedEnd);
   for (Hob.Raw = GetHobList (); !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
     if ((Hob.Raw != NULL) && (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_RESOURCE_DESCRIPTOR)) {
       ResourceHob = Hob.ResourceDescriptor;
@@ -71,6 +126,15 @@ AmdSevSnpInitialize (
           continue;
         }
 
+        if ((ResourceHob->PhysicalStart < UnacceptedEnd) &&
+            (ResourceHob->PhysicalStart + ResourceHob->ResourceLength > UnacceptedStart))
+        {
+          AmdSevSnpSplitUnacceptedMemory (ResourceHob, UnacceptedStart, UnacceptedEnd);
+          if (ResourceHob->ResourceType != EFI_RESOURCE_SYSTEM_MEMORY) {
+            continue;
+          }
+        }
+
         MemEncryptSevSnpPreValidateSystemRam (
           ResourceHob->PhysicalStart,
           EFI_SIZE_TO_PAGES ((UINTN)ResourceHob->ResourceLength)
@@ -359,7 +423,7 @@ AmdSevInitialize (
   // is because the system RAM must be validated before it is made shared.
   // The AmdSevSnpInitialize() validates the system RAM.
   //
-  AmdSevSnpInitialize ();
+  AmdSevSnpInitialize (PlatformInfoHob);
 
   //
   // Set Memory Encryption Mask PCD
@@ -270,6 +270,8 @@ PublishPeiMemory (
   UINT32                PeiMemoryCap;
   UINT32                S3AcpiReservedMemoryBase;
   UINT32                S3AcpiReservedMemorySize;
+  EFI_PHYSICAL_ADDRESS  UnacceptedStart;
+  EFI_PHYSICAL_ADDRESS  UnacceptedEnd;
 
   PlatformGetSystemMemorySizeBelow4gb (PlatformInfoHob);
   LowerMemorySize = PlatformInfoHob->LowMemory;
@@ -330,6 +332,18 @@ PublishPeiMemory (
       MemoryBase = LowerMemorySize - PeiMemoryCap;
       MemorySize = PeiMemoryCap;
     }
+
+    //
+    // The permanent PEI RAM must not overlap the memory that is left
+    // unaccepted (see PcdAcceptPartialMemorySize).
+    //
+    if (PlatformGetUnacceptedMemoryRange (PlatformInfoHob, &UnacceptedStart, &UnacceptedEnd) &&
+        (MemoryBase < UnacceptedEnd))
+    {
+      ASSERT (UnacceptedEnd < LowerMemorySize);
+      MemoryBase = UnacceptedEnd;
+      MemorySize = LowerMemorySize - MemoryBase;
+    }
   }
 
   //
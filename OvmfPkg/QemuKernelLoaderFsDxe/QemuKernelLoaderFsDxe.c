@@ -71,6 +71,26 @@ STATIC KERNEL_BLOB  mKernelBlob[KernelBlobTypeMax] = {
 
 STATIC UINT64  mTotalBlobBytes;
 
+//
+// The size of the fw_cfg transfers that fetch a blob. In SEV and TDX guests,
+// each transfer goes through a bounce buffer, and IoMmuDxe keeps bounce
+// buffers of up to this size in shared memory.
+//
+#define BLOB_CHUNK_SIZE  SIZE_2MB
+
+STATIC
+VOID
+ReadBlobData (
+  IN  CONST KERNEL_BLOB  *Blob,
+  OUT UINT8              *Buffer
+  );
+
+STATIC
+EFI_STATUS
+GetBlobData (
+  IN OUT KERNEL_BLOB  *Blob
+  );
+
 //
 // Device path for the handle that incorporates our "EFI stub filesystem".
 //
@@ -355,9 +375,10 @@ StubFileRead (
   OUT VOID              *Buffer
   )
 {
-  STUB_FILE          *StubFile;
-  CONST KERNEL_BLOB  *Blob;
-  UINT64             Left;
+  STUB_FILE    *StubFile;
+  KERNEL_BLOB  *Blob;
+  UINT64       Left;
+  EFI_STATUS   Status;
 
   StubFile = STUB_FILE_FROM_FILE (This);
 
@@ -365,8 +386,6 @@ StubFileRead (
   // Scanning the root directory?
   //
   if (StubFile->BlobType == KernelBlobTypeMax) {
-    EFI_STATUS  Status;
-
     if (StubFile->Position == KernelBlobTypeMax) {
       //
       // Scanning complete.
@@ -401,6 +420,13 @@ StubFileRead (
     *BufferSize = (UINTN)Left;
   }
 
+  if (*BufferSize > 0) {
+    Status = GetBlobData (Blob);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   if (Blob->Data != NULL) {
     CopyMem (Buffer, Blob->Data + StubFile->Position, *BufferSize);
   }
@@ -884,6 +910,7 @@ InitrdLoadFile2 (
   )
 {
   CONST KERNEL_BLOB  *InitrdBlob = &mKernelBlob[KernelBlobTypeInitrd];
+  EFI_STATUS         Status;
 
   ASSERT (InitrdBlob->Size > 0);
 
@@ -906,7 +933,20 @@ InitrdLoadFile2 (
     return EFI_BUFFER_TOO_SMALL;
   }
 
-  CopyMem (Buffer, InitrdBlob->Data, InitrdBlob->Size);
+  if (InitrdBlob->Data != NULL) {
+    CopyMem (Buffer, InitrdBlob->Data, InitrdBlob->Size);
+  } else {
+    //
+    // The initrd has not been fetched yet, read it from fw_cfg straight into
+    // the caller's buffer, and verify it there.
+    //
+    ReadBlobData (InitrdBlob, Buffer);
+    Status = VerifyBlob (InitrdBlob->Name, Buffer, InitrdBlob->Size);
+    if (EFI_ERROR (Status)) {
+      ZeroMem (Buffer, InitrdBlob->Size);
+      return Status;
+    }
+  }
 
   *BufferSize = InitrdBlob->Size;
   return EFI_SUCCESS;
@@ -921,30 +961,19 @@ STATIC CONST EFI_LOAD_FILE2_PROTOCOL  mInitrdLoadFile2 = {
 //
 
 /**
-  Populate a blob in mKernelBlob.
-
-  param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob that is
-                      to be filled from fw_cfg.
+  Read the size of a blob in mKernelBlob from fw_cfg.
 
-  @retval EFI_SUCCESS           Blob has been populated. If fw_cfg reported a
-                                size of zero for the blob, then Blob->Data has
-                                been left unchanged.
-
-  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory for Blob->Data.
+  param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob whose
+                      size is to be read.
 **/
 STATIC
-EFI_STATUS
-FetchBlob (
+VOID
+FetchBlobSize (
   IN OUT KERNEL_BLOB  *Blob
   )
 {
-  UINT32  Left;
-  UINTN   Idx;
-  UINT8   *ChunkData;
+  UINTN  Idx;
 
-  //
-  // Read blob size.
-  //
   Blob->Size = 0;
   for (Idx = 0; Idx < ARRAY_SIZE (Blob->FwCfgItem); Idx++) {
     if (Blob->FwCfgItem[Idx].SizeKey == 0) {
@@ -955,7 +984,74 @@ FetchBlob (
     Blob->FwCfgItem[Idx].Size = QemuFwCfgRead32 ();
     Blob->Size               += Blob->FwCfgItem[Idx].Size;
   }
+}
+
+/**
+  Read the data of a blob in mKernelBlob from fw_cfg.
+
+  param[in]  Blob    Pointer to the KERNEL_BLOB element in mKernelBlob whose
+                     size has been read with FetchBlobSize().
+  param[out] Buffer  The buffer of Blob->Size bytes to read the data into.
+**/
+STATIC
+VOID
+ReadBlobData (
+  IN  CONST KERNEL_BLOB  *Blob,
+  OUT UINT8              *Buffer
+  )
+{
+  UINT32  Left;
+  UINTN   Idx;
+  UINT8   *ChunkData;
+
+  ChunkData = Buffer;
+  for (Idx = 0; Idx < ARRAY_SIZE (Blob->FwCfgItem); Idx++) {
+    if (Blob->FwCfgItem[Idx].DataKey == 0) {
+      break;
+    }
+
+    QemuFwCfgSelectItem (Blob->FwCfgItem[Idx].DataKey);
+
+    Left = Blob->FwCfgItem[Idx].Size;
+    while (Left > 0) {
+      UINT32  Chunk;
 
+      Chunk = (Left < BLOB_CHUNK_SIZE) ? Left : BLOB_CHUNK_SIZE;
+      QemuFwCfgReadBytes (Chunk, ChunkData + Blob->FwCfgItem[Idx].Size - Left);
+      Left -= Chunk;
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "%a: %Ld bytes remaining for \"%s\" (%d)\n",
+        __func__,
+        (INT64)Left,
+        Blob->Name,
+        (INT32)Idx
+        ));
+    }
+
+    ChunkData += Blob->FwCfgItem[Idx].Size;
+  }
+}
+
+/**
+  Populate a blob in mKernelBlob.
+
+  param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob that is
+                      to be filled from fw_cfg. Its size has been read with
+                      FetchBlobSize().
+
+  @retval EFI_SUCCESS           Blob has been populated. If fw_cfg reported a
+                                size of zero for the blob, then Blob->Data has
+                                been left unchanged.
+
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory for Blob->Data.
+**/
+STATIC
+EFI_STATUS
+FetchBlob (
+  IN OUT KERNEL_BLOB  *Blob
+  )
+{
   if (Blob->Size == 0) {
     return EFI_SUCCESS;
   }
@@ -983,35 +1079,49 @@ FetchBlob (
     Blob->Name
     ));
 
-  ChunkData = Blob->Data;
-  for (Idx = 0; Idx < ARRAY_SIZE (Blob->FwCfgItem); Idx++) {
-    if (Blob->FwCfgItem[Idx].DataKey == 0) {
-      break;
-    }
+  ReadBlobData (Blob, Blob->Data);
+  return EFI_SUCCESS;
+}
 
-    QemuFwCfgSelectItem (Blob->FwCfgItem[Idx].DataKey);
+/**
+  Make sure that the data of a blob in mKernelBlob has been fetched and
+  verified.
 
-    Left = Blob->FwCfgItem[Idx].Size;
-    while (Left > 0) {
-      UINT32  Chunk;
+  The initrd is not fetched by the entry point, so that it is only read when
+  it is used, and InitrdLoadFile2() can read it straight into the buffer of
+  the caller. This function fetches it when it is read through the file
+  system instead.
 
-      Chunk = (Left < SIZE_1MB) ? Left : SIZE_1MB;
-      QemuFwCfgReadBytes (Chunk, ChunkData + Blob->FwCfgItem[Idx].Size - Left);
-      Left -= Chunk;
-      DEBUG ((
-        DEBUG_VERBOSE,
-        "%a: %Ld bytes remaining for \"%s\" (%d)\n",
-        __func__,
-        (INT64)Left,
-        Blob->Name,
-        (INT32)Idx
-        ));
-    }
+  param[in,out] Blob  Pointer to the KERNEL_BLOB element in mKernelBlob.
 
-    ChunkData += Blob->FwCfgItem[Idx].Size;
+  @retval EFI_SUCCESS  Blob->Data holds the verified data of the blob.
+
+  @return              Error codes from FetchBlob() or VerifyBlob().
+**/
+STATIC
+EFI_STATUS
+GetBlobData (
+  IN OUT KERNEL_BLOB  *Blob
+  )
+{
+  EFI_STATUS  Status;
+
+  if ((Blob->Data != NULL) || (Blob->Size == 0)) {
+    return EFI_SUCCESS;
   }
 
-  return EFI_SUCCESS;
+  Status = FetchBlob (Blob);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = VerifyBlob (Blob->Name, Blob->Data, Blob->Size);
+  if (EFI_ERROR (Status)) {
+    FreePool (Blob->Data);
+    Blob->Data = NULL;
+  }
+
+  return Status;
 }
 
 //
@@ -1060,7 +1170,17 @@ QemuKernelLoaderFsDxeEntrypoint (
   //
   for (BlobType = 0; BlobType < KernelBlobTypeMax; ++BlobType) {
     CurrentBlob = &mKernelBlob[BlobType];
-    Status      = FetchBlob (CurrentBlob);
+    FetchBlobSize (CurrentBlob);
+
+    //
+    // A non-empty initrd is fetched and verified when it is read.
+    //
+    if ((BlobType == KernelBlobTypeInitrd) && (CurrentBlob->Size > 0)) {
+      mTotalBlobBytes += CurrentBlob->Size;
+      continue;
+    }
+
+    Status = FetchBlob (CurrentBlob);
     if (EFI_ERROR (Status)) {
       goto FreeBlobs;
     }
@@ -211,17 +211,14 @@ NorFlashWriteSingleWord (
 /*
  * Writes data to the NOR Flash using the Buffered Programming method.
  *
- * The maximum size of the on-chip buffer is 32-words, because of hardware restrictions.
- * Therefore this function will only handle buffers up to 32 words or 128 bytes.
- * To deal with larger buffers, call this function again.
+ * The size of the on-chip buffer is Instance->WriteBufferSize, as reported by the CFI query.
+ * A single buffered write must not cross a boundary of that size.
+ * To deal with larger buffers, call this function again, or use NorFlashProgram ().
  *
  * This function presumes that both the TargetAddress and the TargetAddress+BufferSize
  * exist entirely within the NOR Flash. Therefore these conditions will not be checked here.
  *
- * In buffered programming, if the target address not at the beginning of a 32-bit word boundary,
- * then programming time is doubled and power consumption is increased.
- * Therefore, it is a requirement to align buffer writes to 32-bit word boundaries.
- * i.e. the last 4 bits of the target start address must be zero: 0x......00
+ * The target address must be aligned to a 32-bit word.
  */
 EFI_STATUS
 NorFlashWriteBuffer (
@@ -242,8 +239,13 @@ NorFlashWriteBuffer (
   WaitForBuffer   = MAX_BUFFERED_PROG_ITERATIONS;
   BufferAvailable = FALSE;
 
-  // Check that the target address does not cross a 32-word boundary.
-  if ((TargetAddress & BOUNDARY_OF_32_WORDS) != 0) {
+  // Check that the device can do buffered programming
+  if (Instance->WriteBufferSize == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  // Check that the target address is aligned to a 32-bit word.
+  if ((TargetAddress & 0x3) != 0) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -253,7 +255,7 @@ NorFlashWriteBuffer (
   }
 
   // Check that the buffer size does not exceed the maximum hardware buffer size on chip.
-  if (BufferSizeInBytes > P30_MAX_BUFFER_SIZE_IN_BYTES) {
+  if (BufferSizeInBytes > Instance->WriteBufferSize) {
     return EFI_BAD_BUFFER_SIZE;
   }
 
@@ -262,6 +264,11 @@ NorFlashWriteBuffer (
     return EFI_BAD_BUFFER_SIZE;
   }
 
+  // Check that the write does not cross a boundary of the on-chip buffer.
+  if (((TargetAddress & (Instance->WriteBufferSize - 1)) + BufferSizeInBytes) > Instance->WriteBufferSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   // Pre-programming conditions checked, now start the algorithm.
 
   // Prepare the data destination address
@@ -336,6 +343,143 @@ NorFlashWriteBuffer (
   return Status;
 }
 
+/*
+ * Returns the size in bytes of the write buffer of the NOR Flash, as reported by
+ * the CFI query, or 0 if the device does not report one. In that case the data
+ * are programmed one word at a time.
+ */
+UINTN
+NorFlashGetWriteBufferSize (
+  IN NOR_FLASH_INSTANCE  *Instance
+  )
+{
+  UINT32  Qry;
+  UINTN   Index;
+  UINT32  Value;
+  UINT32  Shift;
+
+  // Put the device into CFI query mode
+  SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_CFI_QUERY);
+
+  // The unique ASCII string "QRY" is at 3 consecutive CFI addresses
+  Qry = 0;
+  for (Index = 0; Index < 3; Index++) {
+    Qry |= GET_LOW_BYTE (MmioRead32 (CREATE_NOR_ADDRESS (Instance->DeviceBaseAddress, P30_CFI_ADDR_QUERY_UNIQUE_QRY + Index))) << (Index * 8);
+  }
+
+  Value = MmioRead32 (CREATE_NOR_ADDRESS (Instance->DeviceBaseAddress, P30_CFI_ADDR_WRITE_BUFFER_SIZE));
+
+  // Put device back into Read Array mode
+  SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
+
+  if (Qry != CFI_QRY) {
+    DEBUG ((DEBUG_INFO, "NorFlashGetWriteBufferSize: No CFI query data at 0x%08x\n", Instance->DeviceBaseAddress));
+    return 0;
+  }
+
+  // Both chips take the same buffered write, use the smallest of their buffers
+  Shift = MIN (GET_LOW_BYTE (Value), GET_HIGH_BYTE (Value));
+  if ((Shift < 2) || (Shift > P30_MAX_BUFFER_SIZE_SHIFT) || ((2 << Shift) > Instance->BlockSize)) {
+    DEBUG ((DEBUG_INFO, "NorFlashGetWriteBufferSize: No usable write buffer (CFI 0x%x)\n", Value));
+    return 0;
+  }
+
+  DEBUG ((DEBUG_INFO, "NorFlashGetWriteBufferSize: Write buffer of %d bytes\n", 2 << Shift));
+  return (UINTN)2 << Shift;
+}
+
+/*
+ * Programs a range of the NOR Flash, using the Buffered Programming method if the device
+ * has a write buffer and the Single Word Programming method otherwise.
+ *
+ * The range must be word aligned, and the programming must only clear bits of the current
+ * content, i.e. the range must have been erased or hold data that only lose bits. Buffers
+ * or words that are all 1s do not change the content and are not programmed.
+ *
+ * This function presumes that the range is unlocked and does not put the device back into
+ * Read Array mode.
+ */
+EFI_STATUS
+NorFlashProgram (
+  IN NOR_FLASH_INSTANCE  *Instance,
+  IN UINTN               TargetAddress,
+  IN UINTN               BufferSizeInBytes,
+  IN UINT32              *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ChunkSizeInBytes;
+  UINTN       ChunkSizeInWords;
+  UINTN       Index;
+
+  if (((TargetAddress & 0x3) != 0) || ((BufferSizeInBytes & 0x3) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  while (BufferSizeInBytes > 0) {
+    // Stop each buffered write at a boundary of the on-chip buffer
+    if (Instance->WriteBufferSize != 0) {
+      ChunkSizeInBytes = Instance->WriteBufferSize - (TargetAddress & (Instance->WriteBufferSize - 1));
+      ChunkSizeInBytes = MIN (ChunkSizeInBytes, BufferSizeInBytes);
+    } else {
+      ChunkSizeInBytes = 4;
+    }
+
+    ChunkSizeInWords = ChunkSizeInBytes / 4;
+
+    // Check the chunk to see if it contains any data (not set all 1s).
+    for (Index = 0; Index < ChunkSizeInWords; Index++) {
+      if (~Buffer[Index] != 0) {
+        break;
+      }
+    }
+
+    if (Index < ChunkSizeInWords) {
+      if (Instance->WriteBufferSize != 0) {
+        Status = NorFlashWriteBuffer (Instance, TargetAddress, ChunkSizeInBytes, Buffer);
+      } else {
+        Status = NorFlashWriteSingleWord (Instance, TargetAddress, *Buffer);
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    TargetAddress     += ChunkSizeInBytes;
+    BufferSizeInBytes -= ChunkSizeInBytes;
+    Buffer            += ChunkSizeInWords;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/*
+ * Checks whether a block of the NOR Flash is erased, i.e. all its bits are set.
+ * The device is left in Read Array mode.
+ */
+BOOLEAN
+NorFlashBlockIsErased (
+  IN NOR_FLASH_INSTANCE  *Instance,
+  IN UINTN               BlockAddress
+  )
+{
+  CONST UINT32  *BlockData;
+  UINTN         Index;
+
+  // Put the device into Read Array mode
+  SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
+
+  BlockData = (CONST UINT32 *)BlockAddress;
+  for (Index = 0; Index < Instance->BlockSize / 4; Index++) {
+    if (~BlockData[Index] != 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 EFI_STATUS
 NorFlashWriteBlocks (
   IN NOR_FLASH_INSTANCE  *Instance,
@@ -519,7 +663,10 @@ NorFlashWriteSingleBlock (
   UINTN       CurOffset;
   UINTN       BlockSize;
   UINTN       BlockAddress;
+  UINTN       AlignedOffset;
+  UINTN       AlignedSize;
   UINT8       *OrigData;
+  BOOLEAN     Changed;
 
   DEBUG ((DEBUG_BLKIO, "NorFlashWriteSingleBlock(Parameters: Lba=%ld, Offset=0x%x, *NumBytes=0x%x, Buffer @ 0x%08x)\n", Lba, Offset, *NumBytes, Buffer));
 
@@ -548,84 +695,71 @@ NorFlashWriteSingleBlock (
     return EFI_BAD_BUFFER_SIZE;
   }
 
-  // Pick P30_MAX_BUFFER_SIZE_IN_BYTES (== 128 bytes) as a good start for word
-  // operations as opposed to erasing the block and writing the data regardless
-  // if an erase is really needed.  It looks like most individual NV variable
-  // writes are smaller than 128 bytes.
-  // To avoid pathological cases were a 2 byte write is disregarded because it
-  // occurs right at a 128 byte buffered write alignment boundary, permit up to
-  // twice the max buffer size, and perform two writes if needed.
-  if ((*NumBytes + (Offset & BOUNDARY_OF_32_WORDS)) <= (2 * P30_MAX_BUFFER_SIZE_IN_BYTES)) {
-    // Check to see if we need to erase before programming the data into NOR.
-    // If the destination bits are only changing from 1s to 0s we can just write.
-    // After a block is erased all bits in the block is set to 1.
-    // If any byte requires us to erase we just give up and rewrite all of it.
-
-    // Read the old version of the data into the shadow buffer
-    Status = NorFlashRead (
-               Instance,
-               Lba,
-               Offset & ~BOUNDARY_OF_32_WORDS,
-               (*NumBytes | BOUNDARY_OF_32_WORDS) + 1,
-               Instance->ShadowBuffer
-               );
-    if (EFI_ERROR (Status)) {
-      return EFI_DEVICE_ERROR;
-    }
+  // Check to see if we need to erase before programming the data into NOR.
+  // If the destination bits are only changing from 1s to 0s we can just write,
+  // whatever the size of the write. It is the case of most NV variable writes,
+  // which append to the store or clear bits of the state of a variable.
+  // After a block is erased all bits in the block is set to 1.
+  // If any byte requires us to erase we just give up and rewrite all of it.
+  AlignedOffset = Offset & ~(UINTN)0x3;
+  AlignedSize   = ALIGN_VALUE (Offset + *NumBytes, 4) - AlignedOffset;
+
+  // Read the old version of the data into the shadow buffer
+  Status = NorFlashRead (
+             Instance,
+             Lba,
+             AlignedOffset,
+             AlignedSize,
+             Instance->ShadowBuffer
+             );
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
 
-    // Make OrigData point to the start of the old version of the data inside
-    // the word aligned buffer
-    OrigData = Instance->ShadowBuffer + (Offset & BOUNDARY_OF_32_WORDS);
+  // Make OrigData point to the start of the old version of the data inside
+  // the word aligned buffer
+  OrigData = (UINT8 *)Instance->ShadowBuffer + (Offset & 0x3);
 
-    // Update the buffer containing the old version of the data with the new
-    // contents, while checking whether the old version had any bits cleared
-    // that we want to set. In that case, we will need to erase the block first.
-    for (CurOffset = 0; CurOffset < *NumBytes; CurOffset++) {
-      if (~OrigData[CurOffset] & Buffer[CurOffset]) {
-        goto DoErase;
-      }
+  // Update the buffer containing the old version of the data with the new
+  // contents, while checking whether the old version had any bits cleared
+  // that we want to set. In that case, we will need to erase the block first.
+  Changed = FALSE;
+  for (CurOffset = 0; CurOffset < *NumBytes; CurOffset++) {
+    if (~OrigData[CurOffset] & Buffer[CurOffset]) {
+      goto DoErase;
+    }
 
+    if (OrigData[CurOffset] != Buffer[CurOffset]) {
       OrigData[CurOffset] = Buffer[CurOffset];
+      Changed             = TRUE;
     }
+  }
 
-    //
-    // Write the updated buffer to NOR.
-    //
-    BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba, BlockSize);
+  // Nothing to do if the flash already holds the data
+  if (!Changed) {
+    return EFI_SUCCESS;
+  }
 
-    // Unlock the block if we have to
-    Status = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
-    if (EFI_ERROR (Status)) {
-      goto Exit;
-    }
+  //
+  // Write the updated buffer to NOR.
+  //
+  BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba, BlockSize);
 
-    Status = NorFlashWriteBuffer (
+  // Unlock the block if we have to
+  Status = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
+  if (!EFI_ERROR (Status)) {
+    Status = NorFlashProgram (
                Instance,
-               BlockAddress + (Offset & ~BOUNDARY_OF_32_WORDS),
-               P30_MAX_BUFFER_SIZE_IN_BYTES,
+               BlockAddress + AlignedOffset,
+               AlignedSize,
                Instance->ShadowBuffer
                );
-    if (EFI_ERROR (Status)) {
-      goto Exit;
-    }
-
-    if ((*NumBytes + (Offset & BOUNDARY_OF_32_WORDS)) > P30_MAX_BUFFER_SIZE_IN_BYTES) {
-      BlockAddress += P30_MAX_BUFFER_SIZE_IN_BYTES;
-
-      Status = NorFlashWriteBuffer (
-                 Instance,
-                 BlockAddress + (Offset & ~BOUNDARY_OF_32_WORDS),
-                 P30_MAX_BUFFER_SIZE_IN_BYTES,
-                 Instance->ShadowBuffer + P30_MAX_BUFFER_SIZE_IN_BYTES
-                 );
-    }
+  }
 
-Exit:
-    // Put device back into Read Array mode
-    SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
+  // Put device back into Read Array mode
+  SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
 
-    return Status;
-  }
+  return Status;
 
 DoErase:
   // Read NOR Flash data into shadow buffer
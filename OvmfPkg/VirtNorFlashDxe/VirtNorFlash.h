@@ -56,16 +56,16 @@
 // Device Commands for Intel StrataFlash(R) Embedded Memory (P30) Family
 
 // On chip buffer size for buffered programming operations
-// There are 2 chips, each chip can buffer up to 32 (16-bit)words, and each word is 2 bytes.
-// Therefore the total size of the buffer is 2 x 32 x 2 = 128 bytes
-#define P30_MAX_BUFFER_SIZE_IN_BYTES  ((UINTN)128)
-#define P30_MAX_BUFFER_SIZE_IN_WORDS  (P30_MAX_BUFFER_SIZE_IN_BYTES/((UINTN)4))
+// The size of the buffer of each chip is reported by the CFI query, as a power of 2
+// of bytes. There are 2 chips, so the total size of the buffer is twice that size.
+// The word count of the buffered program command is 16-bit, which bounds the size.
+#define P30_MAX_BUFFER_SIZE_SHIFT     16
 #define MAX_BUFFERED_PROG_ITERATIONS  10000000
-#define BOUNDARY_OF_32_WORDS          0x7F
 
 // CFI Addresses
-#define P30_CFI_ADDR_QUERY_UNIQUE_QRY  0x10
-#define P30_CFI_ADDR_VENDOR_ID         0x13
+#define P30_CFI_ADDR_QUERY_UNIQUE_QRY   0x10
+#define P30_CFI_ADDR_VENDOR_ID          0x13
+#define P30_CFI_ADDR_WRITE_BUFFER_SIZE  0x2A
 
 // CFI Data
 #define CFI_QRY  0x00595251
@@ -129,6 +129,7 @@ struct _NOR_FLASH_INSTANCE {
   EFI_LBA                                StartLba;
   EFI_LBA                                LastBlock;
   UINT32                                 BlockSize;
+  UINTN                                  WriteBufferSize; // 0 if the device has no write buffer
 
   EFI_FIRMWARE_VOLUME_BLOCK2_PROTOCOL    FvbProtocol;
   VOID                                   *ShadowBuffer;
@@ -152,6 +153,25 @@ NorFlashWriteBuffer (
   IN UINT32              *Buffer
   );
 
+UINTN
+NorFlashGetWriteBufferSize (
+  IN NOR_FLASH_INSTANCE  *Instance
+  );
+
+EFI_STATUS
+NorFlashProgram (
+  IN NOR_FLASH_INSTANCE  *Instance,
+  IN UINTN               TargetAddress,
+  IN UINTN               BufferSizeInBytes,
+  IN UINT32              *Buffer
+  );
+
+BOOLEAN
+NorFlashBlockIsErased (
+  IN NOR_FLASH_INSTANCE  *Instance,
+  IN UINTN               BlockAddress
+  );
+
 //
 // NorFlashFvbDxe.c
 //
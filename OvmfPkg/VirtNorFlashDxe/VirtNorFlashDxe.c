@@ -36,6 +36,7 @@ NOR_FLASH_INSTANCE  mNorFlashInstanceTemplate = {
   0, // StartLba
   0, // LastBlock
   0, // BlockSize
+  0, // WriteBufferSize ... NEED TO BE FILLED
 
   {
     FvbGetAttributes,      // GetAttributes
@@ -193,23 +194,18 @@ NorFlashWriteFullBlock (
   )
 {
   EFI_STATUS  Status;
-  UINTN       WordAddress;
+  UINT32      *BlockData;
   UINT32      WordIndex;
-  UINTN       BufferIndex;
   UINTN       BlockAddress;
-  UINTN       BuffersInBlock;
-  UINTN       RemainingWords;
+  BOOLEAN     Changed;
+  BOOLEAN     NeedErase;
   EFI_TPL     OriginalTPL;
-  UINTN       Cnt;
 
   Status = EFI_SUCCESS;
 
   // Get the physical address of the block
   BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba, BlockSizeInWords * 4);
 
-  // Start writing from the first address at the start of the block
-  WordAddress = BlockAddress;
-
   if (!EfiAtRuntime ()) {
     // Raise TPL to TPL_HIGH to stop anyone from interrupting us.
     OriginalTPL = gBS->RaiseTPL (TPL_HIGH_LEVEL);
@@ -219,66 +215,44 @@ NorFlashWriteFullBlock (
     OriginalTPL = TPL_HIGH_LEVEL;
   }
 
-  Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "WriteSingleBlock: ERROR - Failed to Unlock and Erase the single block at 0x%X\n", BlockAddress));
-    goto EXIT;
-  }
-
-  // To speed up the programming operation, NOR Flash is programmed using the Buffered Programming method.
-
-  // Check that the address starts at a 32-word boundary, i.e. last 7 bits must be zero
-  if ((WordAddress & BOUNDARY_OF_32_WORDS) == 0x00) {
-    // First, break the entire block into buffer-sized chunks.
-    BuffersInBlock = (UINTN)(BlockSizeInWords * 4) / P30_MAX_BUFFER_SIZE_IN_BYTES;
+  // Compare the block with the new data. The block only needs to be erased if
+  // some bits change from 0 to 1, and it is not written at all if it already
+  // holds the data, e.g. when the spare block of the FTW is flushed to a block
+  // that was already updated.
+  SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
 
-    // Then feed each buffer chunk to the NOR Flash
-    // If a buffer does not contain any data, don't write it.
-    for (BufferIndex = 0;
-         BufferIndex < BuffersInBlock;
-         BufferIndex++, WordAddress += P30_MAX_BUFFER_SIZE_IN_BYTES, DataBuffer += P30_MAX_BUFFER_SIZE_IN_WORDS
-         )
-    {
-      // Check the buffer to see if it contains any data (not set all 1s).
-      for (Cnt = 0; Cnt < P30_MAX_BUFFER_SIZE_IN_WORDS; Cnt++) {
-        if (~DataBuffer[Cnt] != 0 ) {
-          // Some data found, write the buffer.
-          Status = NorFlashWriteBuffer (
-                     Instance,
-                     WordAddress,
-                     P30_MAX_BUFFER_SIZE_IN_BYTES,
-                     DataBuffer
-                     );
-          if (EFI_ERROR (Status)) {
-            goto EXIT;
-          }
-
-          break;
-        }
+  BlockData = (UINT32 *)BlockAddress;
+  Changed   = FALSE;
+  NeedErase = FALSE;
+  for (WordIndex = 0; WordIndex < BlockSizeInWords; WordIndex++) {
+    if (BlockData[WordIndex] != DataBuffer[WordIndex]) {
+      Changed = TRUE;
+      if ((~BlockData[WordIndex] & DataBuffer[WordIndex]) != 0) {
+        NeedErase = TRUE;
+        break;
       }
     }
+  }
 
-    // Finally, finish off any remaining words that are less than the maximum size of the buffer
-    RemainingWords = BlockSizeInWords % P30_MAX_BUFFER_SIZE_IN_WORDS;
+  if (!Changed) {
+    goto EXIT;
+  }
 
-    if (RemainingWords != 0) {
-      Status = NorFlashWriteBuffer (Instance, WordAddress, (RemainingWords * 4), DataBuffer);
-      if (EFI_ERROR (Status)) {
-        goto EXIT;
-      }
-    }
+  if (NeedErase) {
+    Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
   } else {
-    // For now, use the single word programming algorithm
-    // It is unlikely that the NOR Flash will exist in an address which falls within a 32 word boundary range,
-    // i.e. which ends in the range 0x......01 - 0x......7F.
-    for (WordIndex = 0; WordIndex < BlockSizeInWords; WordIndex++, DataBuffer++, WordAddress = WordAddress + 4) {
-      Status = NorFlashWriteSingleWord (Instance, WordAddress, *DataBuffer);
-      if (EFI_ERROR (Status)) {
-        goto EXIT;
-      }
-    }
+    Status = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "WriteSingleBlock: ERROR - Failed to Unlock and Erase the single block at 0x%X\n", BlockAddress));
+    goto EXIT;
   }
 
+  // To speed up the programming operation, NOR Flash is programmed using the Buffered Programming method
+  // if the device has a write buffer. The buffers that do not contain any data are not written.
+  Status = NorFlashProgram (Instance, BlockAddress, BlockSizeInWords * 4, DataBuffer);
+
 EXIT:
   // Put device back into Read Array mode
   SEND_NOR_COMMAND (Instance->DeviceBaseAddress, 0, P30_CMD_READ_ARRAY);
@@ -289,7 +263,7 @@ EXIT:
   }
 
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "NOR FLASH Programming [WriteSingleBlock] failed at address 0x%08x. Exit Status = \"%r\".\n", WordAddress, Status));
+    DEBUG ((DEBUG_ERROR, "NOR FLASH Programming [WriteSingleBlock] failed at address 0x%08x. Exit Status = \"%r\".\n", BlockAddress, Status));
   }
 
   return Status;
@@ -405,6 +379,9 @@ NorFlashFvbInitialize (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  // Program through the write buffer of the device, if it has one
+  Instance->WriteBufferSize = NorFlashGetWriteBufferSize (Instance);
+
   mFlashNvStorageVariableBase = (PcdGet64 (PcdFlashNvStorageVariableBase64) != 0) ?
                                 PcdGet64 (PcdFlashNvStorageVariableBase64) : PcdGet32 (PcdFlashNvStorageVariableBase);
 
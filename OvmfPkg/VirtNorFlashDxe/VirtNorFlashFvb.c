@@ -721,13 +721,18 @@ FvbEraseBlocks (
                        Instance->BlockSize
                        );
 
-      // Erase it
-      DEBUG ((DEBUG_BLKIO, "FvbEraseBlocks: Erasing Lba=%ld @ 0x%08x.\n", Instance->StartLba + StartingLba, BlockAddress));
-      Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
-      if (EFI_ERROR (Status)) {
-        VA_END (Args);
-        Status = EFI_DEVICE_ERROR;
-        goto EXIT;
+      // Erase it, unless it is already erased. The FTW erases its spare blocks
+      // before each write, and they are often still blank from the last erase.
+      if (NorFlashBlockIsErased (Instance, BlockAddress)) {
+        DEBUG ((DEBUG_BLKIO, "FvbEraseBlocks: Lba=%ld @ 0x%08x is already erased.\n", Instance->StartLba + StartingLba, BlockAddress));
+      } else {
+        DEBUG ((DEBUG_BLKIO, "FvbEraseBlocks: Erasing Lba=%ld @ 0x%08x.\n", Instance->StartLba + StartingLba, BlockAddress));
+        Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
+        if (EFI_ERROR (Status)) {
+          VA_END (Args);
+          Status = EFI_DEVICE_ERROR;
+          goto EXIT;
+        }
       }
 
       // Move to the next Lba
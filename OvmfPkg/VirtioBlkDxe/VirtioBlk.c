@@ -6,9 +6,10 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - EFI_BLOCK_IO2_PROTOCOL requests are kept in flight in per-virtqueue request
+    slots, spread over up to VBLK_MAX_QUEUES virtqueues if VIRTIO_BLK_F_MQ is
+    offered, and reaped by a timer. Blocking requests share the slots and poll
+    for their completion.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -176,19 +177,198 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
+  Complete the request in a slot of a virtqueue: unmap its data buffer, and
+  report the host status through the token or the blocking caller's status.
 
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev    The virtio-blk device.
+
+  @param[in out] Queue  The virtqueue the request was submitted to.
+
+  @param[in] SlotIndex  The slot of the request in Queue.
+
+**/
+STATIC
+VOID
+CompleteRequest (
+  IN OUT VBLK_DEV    *Dev,
+  IN OUT VBLK_QUEUE  *Queue,
+  IN     UINT16      SlotIndex
+  )
+{
+  VBLK_REQUEST  *Request;
+  EFI_STATUS    Status;
+  EFI_STATUS    UnmapStatus;
+
+  Request = &Queue->Requests[SlotIndex];
+  ASSERT (Request->InUse);
+
+  Status = (Queue->Shared[SlotIndex].HostStatus == VIRTIO_BLK_S_OK) ?
+           EFI_SUCCESS :
+           EFI_DEVICE_ERROR;
+
+  if (Request->BufferSize > 0) {
+    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (
+                                 Dev->VirtIo,
+                                 Request->BufferMapping
+                                 );
+    if (EFI_ERROR (UnmapStatus) && !Request->RequestIsWrite) {
+      //
+      // Data from the bus master may not reach the caller; fail the request.
+      //
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  Request->InUse = FALSE;
+  ASSERT (Dev->InFlight > 0);
+  Dev->InFlight--;
+
+  if (Request->Token != NULL) {
+    Request->Token->TransactionStatus = Status;
+    gBS->SignalEvent (Request->Token->Event);
+  } else if (Request->CompletionStatus != NULL) {
+    *Request->CompletionStatus = Status;
+  }
+}
+
+/**
+
+  Reap the requests that the device has placed in the used rings of all
+  virtqueues.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+ProcessCompletions (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  UINT16                          QueueIndex;
+  VBLK_QUEUE                      *Queue;
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINT32                          HeadDescIdx;
+
+  for (QueueIndex = 0; QueueIndex < Dev->QueueCount; QueueIndex++) {
+    Queue = &Dev->Queues[QueueIndex];
+
+    //
+    // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+    //
+    MemoryFence ();
+    while (Queue->LastUsedIdx != *Queue->Ring.Used.Idx) {
+      MemoryFence ();
+      UsedElem    = &Queue->Ring.Used.UsedElem[Queue->LastUsedIdx % Queue->Ring.QueueSize];
+      HeadDescIdx = UsedElem->Id;
+      Queue->LastUsedIdx++;
+
+      //
+      // With indirect descriptors, slot N owns ring descriptor N; otherwise
+      // it owns ring descriptors [3*N, 3*N+2].
+      //
+      if (!Dev->IndirectDesc) {
+        HeadDescIdx /= 3;
+      }
+
+      ASSERT (HeadDescIdx < Queue->RequestCount);
+      if (HeadDescIdx < Queue->RequestCount) {
+        CompleteRequest (Dev, Queue, (UINT16)HeadDescIdx);
+      }
+    }
+  }
+}
+
+/**
+
+  Timer notification function reaping the completions of non-blocking
+  requests. The timer is cancelled once no request is in flight.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkPollTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VBLK_DEV  *Dev;
+
+  Dev = Context;
+  ProcessCompletions (Dev);
+  if ((Dev->InFlight == 0) && Dev->PollTimerArmed) {
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+    Dev->PollTimerArmed = FALSE;
+  }
+}
+
+/**
+
+  Wait until the device completes all requests in flight.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+WaitForInFlightRequests (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL  OldTpl;
+  UINTN    InFlight;
+
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessCompletions (Dev);
+    InFlight = Dev->InFlight;
+    gBS->RestoreTPL (OldTpl);
+
+    if (InFlight == 0) {
+      break;
+    }
+
+    gBS->Stall (10);
+  }
+}
+
+/**
+
+  Format a read / write / flush request in a free request slot of one of the
+  virtqueues, and push it to the host without waiting for the response.
+
+  The request uses a single ring descriptor that points to the slot's indirect
+  descriptor table if VIRTIO_F_RING_INDIRECT_DESC has been negotiated, and
+  three consecutive ring descriptors owned by the slot otherwise. Virtqueues
+  are picked round-robin. If all slots are busy, the function polls the used
+  rings until one is freed.
+
+  The function may only be called after the request parameters have been
+  verified by
+  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks() and their
+    EFI_BLOCK_IO2_PROTOCOL counterparts, and
   - VerifyReadWriteRequest() (for read/write only).
 
   Parameters handled commonly:
 
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
+    @param[in] Dev               The virtio-blk device the request is targeted
+                                 at.
+
+    @param[in] Token             The token to signal on completion, for a
+                                 non-blocking request. NULL otherwise.
+
+    @param[out] CompletionStatus For a blocking request, the variable that
+                                 receives the result on completion. It must be
+                                 preset to EFI_NOT_READY. NULL otherwise.
 
   Flush request:
 
@@ -215,53 +395,47 @@ VerifyReadWriteRequest (
     @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
                                device.
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
 
+  @retval EFI_SUCCESS          The request has been submitted; its result is
+                               reported through Token or CompletionStatus.
 
-  @retval EFI_SUCCESS          Transfer complete.
-
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+  @retval EFI_DEVICE_ERROR     Failed to map Buffer for a bus master
+                               operation, or to notify host side via VirtIo
+                               write. Token and CompletionStatus are not used.
 
 **/
 STATIC
 EFI_STATUS
-EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV  *Dev,
-  IN              EFI_LBA   Lba,
-  IN              UINTN     BufferSize,
-  IN OUT volatile VOID      *Buffer,
-  IN              BOOLEAN   RequestIsWrite
+SubmitRequest (
+  IN              VBLK_DEV             *Dev,
+  IN              EFI_LBA              Lba,
+  IN              UINTN                BufferSize,
+  IN OUT volatile VOID                 *Buffer,
+  IN              BOOLEAN              RequestIsWrite,
+  IN              EFI_BLOCK_IO2_TOKEN  *Token             OPTIONAL,
+  OUT    volatile EFI_STATUS           *CompletionStatus  OPTIONAL
   )
 {
-  UINT32                   BlockSize;
-  volatile VIRTIO_BLK_REQ  Request;
-  volatile UINT8           *HostStatus;
-  VOID                     *HostStatusBuffer;
-  DESC_INDICES             Indices;
-  VOID                     *RequestMapping;
-  VOID                     *StatusMapping;
-  VOID                     *BufferMapping;
-  EFI_PHYSICAL_ADDRESS     BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     RequestDeviceAddress;
-  EFI_STATUS               Status;
-  EFI_STATUS               UnmapStatus;
+  UINT32                BlockSize;
+  EFI_TPL               OldTpl;
+  UINT16                QueueIndex;
+  UINT16                Attempt;
+  UINT16                SlotIndex;
+  VBLK_QUEUE            *Queue;
+  VBLK_SHARED_SLOT      *Shared;
+  VBLK_REQUEST          *Request;
+  EFI_PHYSICAL_ADDRESS  SlotDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  VOID                  *BufferMapping;
+  volatile VRING_DESC   *Desc;
+  UINT16                DescBase;
+  UINT16                DescCount;
+  UINT16                HeadDescIdx;
+  UINT16                NextAvailIdx;
+  EFI_STATUS            Status;
 
   BlockSize = Dev->BlockIoMedia.BlockSize;
 
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
-
   //
   // ensured by VirtioBlkInit()
   //
@@ -274,51 +448,20 @@ SynchronousRequest (
   ASSERT (BufferSize % BlockSize == 0);
 
   //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request.Type = RequestIsWrite ?
-                 (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                 VIRTIO_BLK_T_IN;
-  Request.IoPrio = 0;
-  Request.Sector = MultU64x32 (Lba, BlockSize / 512);
-
+  // From virtio-0.9.5, 2.3.2 Descriptor Table:
+  // "no descriptor chain may be more than 2^32 bytes long in total".
   //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
+  // The predicate is ensured by the call contract above (for flush), or
+  // VerifyReadWriteRequest() (for read/write). It also implies that
+  // converting BufferSize to UINT32 will not truncate it.
   //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
-  }
-
-  HostStatus = HostStatusBuffer;
-
-  //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)&Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
-  }
+  ASSERT (BufferSize <= SIZE_1GB);
 
   //
   // Map data buffer
   //
+  BufferMapping       = NULL;
+  BufferDeviceAddress = 0;
   if (BufferSize > 0) {
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
@@ -331,130 +474,207 @@ SynchronousRequest (
                &BufferMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
+      return EFI_DEVICE_ERROR;
     }
   }
 
   //
-  // preset a host status for ourselves that we do not accept as success
-  //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
+  // Find a free request slot, reaping completions while there is none. Set
+  // QueueIndex, Queue and SlotIndex to suppress incorrect compiler/analyzer
+  // warnings.
+  //
+  QueueIndex = 0;
+  Queue      = NULL;
+  SlotIndex  = 0;
+  OldTpl     = gBS->RaiseTPL (TPL_NOTIFY);
+  for ( ; ;) {
+    for (Attempt = 0; Attempt < Dev->QueueCount; Attempt++) {
+      QueueIndex = (UINT16)((Dev->NextQueue + Attempt) % Dev->QueueCount);
+      Queue      = &Dev->Queues[QueueIndex];
+      for (SlotIndex = 0; SlotIndex < Queue->RequestCount; SlotIndex++) {
+        if (!Queue->Requests[SlotIndex].InUse) {
+          goto FoundSlot;
+        }
+      }
+    }
 
-  //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
+    ProcessCompletions (Dev);
+    gBS->RestoreTPL (OldTpl);
+    gBS->Stall (10);
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   }
 
-  VirtioPrepare (&Dev->Ring, &Indices);
+FoundSlot:
+  Dev->NextQueue = (UINT16)((QueueIndex + 1) % Dev->QueueCount);
+
+  Request                   = &Queue->Requests[SlotIndex];
+  Request->InUse            = TRUE;
+  Request->RequestIsWrite   = RequestIsWrite;
+  Request->BufferSize       = BufferSize;
+  Request->BufferMapping    = BufferMapping;
+  Request->Token            = Token;
+  Request->CompletionStatus = CompletionStatus;
+  Dev->InFlight++;
 
   //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
-  //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  // Prepare virtio-blk request header, setting zero size for flush.
+  // IO Priority is homogeneously 0. Preset a host status for ourselves that
+  // we do not accept as success.
+  //
+  Shared                 = &Queue->Shared[SlotIndex];
+  SlotDeviceAddress      = Queue->SharedDeviceAddress + SlotIndex * sizeof *Shared;
+  Shared->Request.Type   = RequestIsWrite ?
+                           (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
+                           VIRTIO_BLK_T_IN;
+  Shared->Request.IoPrio = 0;
+  Shared->Request.Sector = MultU64x32 (Lba, BlockSize / 512);
+  Shared->HostStatus     = VIRTIO_BLK_S_IOERR;
+
+  if (Dev->IndirectDesc) {
+    Desc        = Shared->Indirect;
+    DescBase    = 0;
+    HeadDescIdx = SlotIndex;
+  } else {
+    Desc        = &Queue->Ring.Desc[SlotIndex * 3];
+    DescBase    = (UINT16)(SlotIndex * 3);
+    HeadDescIdx = DescBase;
+  }
 
   //
   // virtio-blk header in first desc
   //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
-    VRING_DESC_F_NEXT,
-    &Indices
-    );
+  Desc[0].Addr  = SlotDeviceAddress + OFFSET_OF (VBLK_SHARED_SLOT, Request);
+  Desc[0].Len   = sizeof Shared->Request;
+  Desc[0].Flags = VRING_DESC_F_NEXT;
+  Desc[0].Next  = (UINT16)(DescBase + 1);
+  DescCount     = 1;
 
   //
-  // data buffer for read/write in second desc
+  // data buffer for read/write in second desc; VRING_DESC_F_WRITE is
+  // interpreted from the host's point of view.
   //
   if (BufferSize > 0) {
-    //
-    // From virtio-0.9.5, 2.3.2 Descriptor Table:
-    // "no descriptor chain may be more than 2^32 bytes long in total".
-    //
-    // The predicate is ensured by the call contract above (for flush), or
-    // VerifyReadWriteRequest() (for read/write). It also implies that
-    // converting BufferSize to UINT32 will not truncate it.
-    //
-    ASSERT (BufferSize <= SIZE_1GB);
-
-    //
-    // VRING_DESC_F_WRITE is interpreted from the host's point of view.
-    //
-    VirtioAppendDesc (
-      &Dev->Ring,
-      BufferDeviceAddress,
-      (UINT32)BufferSize,
-      VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
-      &Indices
-      );
+    Desc[DescCount].Addr  = BufferDeviceAddress;
+    Desc[DescCount].Len   = (UINT32)BufferSize;
+    Desc[DescCount].Flags = VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE);
+    Desc[DescCount].Next  = (UINT16)(DescBase + DescCount + 1);
+    DescCount++;
   }
 
   //
   // host status in last (second or third) desc
   //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
-    VRING_DESC_F_WRITE,
-    &Indices
-    );
-
-  //
-  // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
-  //
-  if ((VirtioFlush (
-         Dev->VirtIo,
-         0,
-         &Dev->Ring,
-         &Indices,
-         NULL
-         ) == EFI_SUCCESS) &&
-      (*HostStatus == VIRTIO_BLK_S_OK))
-  {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
+  Desc[DescCount].Addr  = SlotDeviceAddress + OFFSET_OF (VBLK_SHARED_SLOT, HostStatus);
+  Desc[DescCount].Len   = sizeof Shared->HostStatus;
+  Desc[DescCount].Flags = VRING_DESC_F_WRITE;
+  Desc[DescCount].Next  = 0;
+  DescCount++;
+
+  if (Dev->IndirectDesc) {
+    Queue->Ring.Desc[HeadDescIdx].Addr  = SlotDeviceAddress + OFFSET_OF (VBLK_SHARED_SLOT, Indirect);
+    Queue->Ring.Desc[HeadDescIdx].Len   = DescCount * sizeof (VRING_DESC);
+    Queue->Ring.Desc[HeadDescIdx].Flags = VRING_DESC_F_INDIRECT;
+    Queue->Ring.Desc[HeadDescIdx].Next  = 0;
   }
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field
+  //
+  NextAvailIdx = *Queue->Ring.Avail.Idx;
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
+  Queue->Ring.Avail.Ring[NextAvailIdx++ % Queue->Ring.QueueSize] = HeadDescIdx;
+  MemoryFence ();
+  *Queue->Ring.Avail.Idx = NextAvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
+  //
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, QueueIndex);
+  if (EFI_ERROR (Status)) {
+    //
+    // The descriptors are published already; leave the slot to be reaped if
+    // the device ever completes it, but don't report through the caller's
+    // objects.
+    //
+    Request->Token            = NULL;
+    Request->CompletionStatus = NULL;
+    Status                    = EFI_DEVICE_ERROR;
+  } else if ((Token != NULL) && !Dev->PollTimerArmed) {
+    if (!EFI_ERROR (gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD))) {
+      Dev->PollTimerArmed = TRUE;
     }
   }
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+  Submit a read / write / flush request and poll for the response.
 
-  return Status;
+  See SubmitRequest() for the parameters.
+
+  @retval EFI_SUCCESS          Transfer complete.
+
+  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
+                               unable to parse host response, or host response
+                               is not VIRTIO_BLK_S_OK or failed to map Buffer
+                               for a bus master operation.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+SynchronousRequest (
+  IN              VBLK_DEV  *Dev,
+  IN              EFI_LBA   Lba,
+  IN              UINTN     BufferSize,
+  IN OUT volatile VOID      *Buffer,
+  IN              BOOLEAN   RequestIsWrite
+  )
+{
+  volatile EFI_STATUS  CompletionStatus;
+  EFI_STATUS           Status;
+  EFI_TPL              OldTpl;
+  UINTN                PollPeriodUsecs;
+
+  CompletionStatus = EFI_NOT_READY;
+  Status           = SubmitRequest (
+                       Dev,
+                       Lba,
+                       BufferSize,
+                       Buffer,
+                       RequestIsWrite,
+                       NULL,
+                       &CompletionStatus
+                       );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessCompletions (Dev);
+    Status = CompletionStatus;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Status != EFI_NOT_READY) {
+      return Status;
+    }
+
+    gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
+
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
 }
 
 /**
@@ -601,6 +821,195 @@ VirtioBlkFlushBlocks (
          EFI_SUCCESS;
 }
 
+/**
+
+  Report the synchronous completion of a non-blocking request that needed no
+  device access.
+
+  @param[in out] Token   The token of the request, or NULL.
+
+  @param[in] Status      The result of the request.
+
+  @return  Status.
+
+**/
+STATIC
+EFI_STATUS
+CompleteTokenNow (
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token   OPTIONAL,
+  IN     EFI_STATUS           Status
+  )
+{
+  if ((Token != NULL) && (Token->Event != NULL) && !EFI_ERROR (Status)) {
+    Token->TransactionStatus = Status;
+    gBS->SignalEvent (Token->Event);
+  }
+
+  return Status;
+}
+
+//
+// UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  //
+  // Let the requests in flight complete; the device itself is not reset.
+  //
+  WaitForInFlightRequests (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Common part of ReadBlocksEx() and WriteBlocksEx().
+
+**/
+STATIC
+EFI_STATUS
+ReadWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN OUT VOID                    *Buffer,
+  IN     BOOLEAN                 RequestIsWrite
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  if (BufferSize == 0) {
+    return CompleteTokenNow (Token, EFI_SUCCESS);
+  }
+
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return SynchronousRequest (Dev, Lba, BufferSize, Buffer, RequestIsWrite);
+  }
+
+  Token->TransactionStatus = EFI_NOT_READY;
+  return SubmitRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           RequestIsWrite,
+           Token,
+           NULL
+           );
+}
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  The request is served synchronously if Token is NULL or Token->Event is
+  NULL. Otherwise it is queued to one of the virtqueues, and Token->Event is
+  signaled when the device completes it.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  return ReadWriteBlocksEx (
+           This,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           FALSE       // RequestIsWrite
+           );
+}
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  The request is served synchronously if Token is NULL or Token->Event is
+  NULL. Otherwise it is queued to one of the virtqueues, and Token->Event is
+  signaled when the device completes it.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  return ReadWriteBlocksEx (
+           This,
+           Lba,
+           Token,
+           BufferSize,
+           Buffer,
+           TRUE        // RequestIsWrite
+           );
+}
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  The flush is issued after all requests in flight complete, so that it covers
+  every write submitted earlier.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  VBLK_DEV  *Dev;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    return CompleteTokenNow (Token, EFI_SUCCESS);
+  }
+
+  //
+  // virtio-blk flushes cover the writes completed before the flush request.
+  //
+  WaitForInFlightRequests (Dev);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return SynchronousRequest (Dev, 0, 0, NULL, TRUE);
+  }
+
+  Token->TransactionStatus = EFI_NOT_READY;
+  return SubmitRequest (Dev, 0, 0, NULL, TRUE, Token, NULL);
+}
+
 /**
 
   Device probe function for this driver.
@@ -684,6 +1093,184 @@ VirtioBlkDriverBindingSupported (
   return Status;
 }
 
+/**
+
+  Allocate, map and report one virtqueue of a virtio-blk device, together
+  with the device-accessible part of its request slots.
+
+  @param[in out] Dev      The driver instance. Dev->IndirectDesc must be set.
+
+  @param[in] QueueIndex   The index of the virtqueue to set up.
+
+  @retval EFI_SUCCESS      The virtqueue is ready for requests.
+
+  @retval EFI_UNSUPPORTED  The virtqueue is too small.
+
+  @return                  Error codes from VirtioRingInit(), VirtioRingMap(),
+                           the VirtIo protocol, or
+                           VirtioMapAllBytesInSharedBuffer().
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkInitQueue (
+  IN OUT VBLK_DEV  *Dev,
+  IN     UINT16    QueueIndex
+  )
+{
+  VBLK_QUEUE  *Queue;
+  EFI_STATUS  Status;
+  UINT16      QueueSize;
+  UINT64      RingBaseShift;
+  UINTN       SharedPages;
+
+  Queue = &Dev->Queues[QueueIndex];
+
+  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, QueueIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (QueueSize < 3) {
+    // a request uses at most three descriptors
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Queue->Ring);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // If anything fails from here on, we must release the ring resources
+  //
+  Status = VirtioRingMap (
+             Dev->VirtIo,
+             &Queue->Ring,
+             &RingBaseShift,
+             &Queue->RingMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto ReleaseQueue;
+  }
+
+  //
+  // Additional steps for MMIO: align the queue appropriately, and set the
+  // size. If anything fails from here on, we must unmap the ring resources.
+  //
+  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  //
+  // step 4c -- Report GPFN (guest-physical frame number) of queue.
+  //
+  Status = Dev->VirtIo->SetQueueAddress (
+                          Dev->VirtIo,
+                          &Queue->Ring,
+                          RingBaseShift
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  //
+  // A request takes one ring descriptor with an indirect table, and three
+  // otherwise.
+  //
+  Queue->RequestCount = (UINT16)MIN (
+                                  Dev->IndirectDesc ? QueueSize : QueueSize / 3,
+                                  VBLK_MAX_QUEUE_REQUESTS
+                                  );
+
+  //
+  // The request headers, host statuses and indirect tables are accessed by
+  // both processor and device.
+  //
+  SharedPages = EFI_SIZE_TO_PAGES (Queue->RequestCount * sizeof (VBLK_SHARED_SLOT));
+  Status      = Dev->VirtIo->AllocateSharedPages (
+                               Dev->VirtIo,
+                               SharedPages,
+                               (VOID **)&Queue->Shared
+                               );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  ZeroMem (Queue->Shared, EFI_PAGES_TO_SIZE (SharedPages));
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Queue->Shared,
+             EFI_PAGES_TO_SIZE (SharedPages),
+             &Queue->SharedDeviceAddress,
+             &Queue->SharedMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeShared;
+  }
+
+  //
+  // Completions are polled for.
+  //
+  *Queue->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+  Queue->LastUsedIdx       = 0;
+  return EFI_SUCCESS;
+
+FreeShared:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, SharedPages, Queue->Shared);
+
+UnmapQueue:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->RingMap);
+
+ReleaseQueue:
+  VirtioRingUninit (Dev->VirtIo, &Queue->Ring);
+
+  return Status;
+}
+
+/**
+
+  Release the resources of a virtqueue set up with VirtioBlkInitQueue(). The
+  device must have been reset.
+
+  @param[in out] Dev      The driver instance.
+
+  @param[in] QueueIndex   The index of the virtqueue to release.
+
+**/
+STATIC
+VOID
+VirtioBlkUninitQueue (
+  IN OUT VBLK_DEV  *Dev,
+  IN     UINT16    QueueIndex
+  )
+{
+  VBLK_QUEUE  *Queue;
+
+  Queue = &Dev->Queues[QueueIndex];
+
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->SharedMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Queue->RequestCount * sizeof (VBLK_SHARED_SLOT)),
+                 Queue->Shared
+                 );
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Queue->RingMap);
+  VirtioRingUninit (Dev->VirtIo, &Queue->Ring);
+}
+
 /**
 
   Set up all BlockIo and virtio-blk aspects of this driver for the specified
@@ -719,8 +1306,8 @@ VirtioBlkInit (
   UINT8   PhysicalBlockExp;
   UINT8   AlignmentOffset;
   UINT32  OptIoSize;
-  UINT16  QueueSize;
-  UINT64  RingBaseShift;
+  UINT16  NumQueues;
+  UINT16  QueueIndex;
 
   PhysicalBlockExp = 0;
   AlignmentOffset  = 0;
@@ -819,10 +1406,27 @@ VirtioBlkInit (
     }
   }
 
+  NumQueues = 1;
+  if (Features & VIRTIO_BLK_F_MQ) {
+    Status = VIRTIO_CFG_READ (Dev, NumQueues, &NumQueues);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+
+    if (NumQueues == 0) {
+      Status = EFI_UNSUPPORTED;
+      goto Failed;
+    }
+  }
+
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
+              VIRTIO_BLK_F_FLUSH | VIRTIO_BLK_F_MQ |
+              VIRTIO_F_RING_INDIRECT_DESC | VIRTIO_F_VERSION_1 |
               VIRTIO_F_IOMMU_PLATFORM;
 
+  Dev->IndirectDesc = (BOOLEAN)((Features & VIRTIO_F_RING_INDIRECT_DESC) != 0);
+  Dev->QueueCount   = (UINT16)MIN (NumQueues, VBLK_MAX_QUEUES);
+
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
   // discovery, and the device can also reject the selected set of features.
@@ -835,66 +1439,13 @@ VirtioBlkInit (
   }
 
   //
-  // step 4b -- allocate virtqueue
+  // step 4b -- allocate virtqueues
   //
-  Status = Dev->VirtIo->SetQueueSel (Dev->VirtIo, 0);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  Status = Dev->VirtIo->GetQueueNumMax (Dev->VirtIo, &QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  if (QueueSize < 3) {
-    // SynchronousRequest() uses at most three descriptors
-    Status = EFI_UNSUPPORTED;
-    goto Failed;
-  }
-
-  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring);
-  if (EFI_ERROR (Status)) {
-    goto Failed;
-  }
-
-  //
-  // If anything fails from here on, we must release the ring resources
-  //
-  Status = VirtioRingMap (
-             Dev->VirtIo,
-             &Dev->Ring,
-             &RingBaseShift,
-             &Dev->RingMap
-             );
-  if (EFI_ERROR (Status)) {
-    goto ReleaseQueue;
-  }
-
-  //
-  // Additional steps for MMIO: align the queue appropriately, and set the
-  // size. If anything fails from here on, we must unmap the ring resources.
-  //
-  Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
-  }
-
-  Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
-  }
-
-  //
-  // step 4c -- Report GPFN (guest-physical frame number) of queue.
-  //
-  Status = Dev->VirtIo->SetQueueAddress (
-                          Dev->VirtIo,
-                          &Dev->Ring,
-                          RingBaseShift
-                          );
-  if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+  for (QueueIndex = 0; QueueIndex < Dev->QueueCount; QueueIndex++) {
+    Status = VirtioBlkInitQueue (Dev, QueueIndex);
+    if (EFI_ERROR (Status)) {
+      goto ReleaseQueues;
+    }
   }
 
   //
@@ -904,7 +1455,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto ReleaseQueues;
     }
   }
 
@@ -914,7 +1465,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto ReleaseQueues;
   }
 
   //
@@ -927,6 +1478,11 @@ VirtioBlkInit (
   Dev->BlockIo.ReadBlocks            = &VirtioBlkReadBlocks;
   Dev->BlockIo.WriteBlocks           = &VirtioBlkWriteBlocks;
   Dev->BlockIo.FlushBlocks           = &VirtioBlkFlushBlocks;
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
   Dev->BlockIoMedia.MediaId          = 0;
   Dev->BlockIoMedia.RemovableMedia   = FALSE;
   Dev->BlockIoMedia.MediaPresent     = TRUE;
@@ -947,6 +1503,14 @@ VirtioBlkInit (
     Dev->BlockIoMedia.BlockSize,
     Dev->BlockIoMedia.LastBlock + 1
     ));
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: Queues=%u RequestsPerQueue=%u IndirectDesc=%d\n",
+    __func__,
+    Dev->QueueCount,
+    Dev->Queues[0].RequestCount,
+    Dev->IndirectDesc
+    ));
 
   if (Features & VIRTIO_BLK_F_TOPOLOGY) {
     Dev->BlockIo.Revision = EFI_BLOCK_IO_PROTOCOL_REVISION3;
@@ -972,11 +1536,10 @@ VirtioBlkInit (
 
   return EFI_SUCCESS;
 
-UnmapQueue:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-
-ReleaseQueue:
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+ReleaseQueues:
+  while (QueueIndex > 0) {
+    VirtioBlkUninitQueue (Dev, --QueueIndex);
+  }
 
 Failed:
   //
@@ -1004,15 +1567,19 @@ VirtioBlkUninit (
   IN OUT VBLK_DEV  *Dev
   )
 {
+  UINT16  QueueIndex;
+
   //
-  // Reset the virtual device -- see virtio-0.9.5, 2.2.2.1 Device Status. When
+  // Let the requests in flight complete, then reset the virtual device -- see virtio-0.9.5, 2.2.2.1 Device Status. When
   // VIRTIO_CFG_WRITE() returns, the host will have learned to stay away from
   // the old comms area.
   //
+  WaitForInFlightRequests (Dev);
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
-  VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
+  for (QueueIndex = 0; QueueIndex < Dev->QueueCount; QueueIndex++) {
+    VirtioBlkUninitQueue (Dev, QueueIndex);
+  }
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
@@ -1125,21 +1692,42 @@ VirtioBlkDriverBindingStart (
   }
 
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // The timer reaping non-blocking requests is armed while they are in
+  // flight.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  &VirtioBlkPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
+  //
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto ClosePollTimer;
   }
 
   return EFI_SUCCESS;
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1162,7 +1750,8 @@ FreeVirtioBlk:
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo and BlockIo2
+  interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -1212,15 +1801,19 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  gBS->CloseEvent (Dev->PollTimer);
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
@@ -13,13 +13,70 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Upper limits on the number of request virtqueues driven, and on the number
+// of requests kept in flight on each of them.
+//
+#define VBLK_MAX_QUEUES          4
+#define VBLK_MAX_QUEUE_REQUESTS  64
+
+//
+// Period of the timer that reaps the completions of non-blocking requests, in
+// 100ns units.
+//
+#define VBLK_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+//
+// The part of a request slot that the device accesses: the indirect
+// descriptor table (used only if VIRTIO_F_RING_INDIRECT_DESC is negotiated),
+// the virtio-blk request header and the host status. Padded to keep the
+// indirect tables 16-byte aligned.
+//
+#pragma pack(1)
+typedef struct {
+  VRING_DESC        Indirect[3];
+  VIRTIO_BLK_REQ    Request;
+  UINT8             HostStatus;
+  UINT8             Reserved[15];
+} VBLK_SHARED_SLOT;
+#pragma pack()
+
+//
+// The driver side bookkeeping of a request slot.
+//
+typedef struct {
+  BOOLEAN                InUse;
+  BOOLEAN                RequestIsWrite;
+  UINTN                  BufferSize;
+  VOID                   *BufferMapping;
+  //
+  // The token of a non-blocking request, or the status to set for a blocking
+  // one. Both are NULL for a request whose submission failed half-way.
+  //
+  EFI_BLOCK_IO2_TOKEN    *Token;
+  volatile EFI_STATUS    *CompletionStatus;
+} VBLK_REQUEST;
+
+typedef struct {
+  VRING                   Ring;
+  VOID                    *RingMap;
+  UINT16                  LastUsedIdx;
+  UINT16                  RequestCount;
+  VBLK_SHARED_SLOT        *Shared;
+  VOID                    *SharedMap;
+  EFI_PHYSICAL_ADDRESS    SharedDeviceAddress;
+  VBLK_REQUEST            Requests[VBLK_MAX_QUEUE_REQUESTS];
+} VBLK_QUEUE;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -28,18 +85,28 @@ typedef struct {
   //
   //                     field                    init function       init dpth
   //                     ---------------------    ------------------  ---------
-  UINT32                    Signature;         // DriverBindingStart  0
-  VIRTIO_DEVICE_PROTOCOL    *VirtIo;           // DriverBindingStart  0
-  EFI_EVENT                 ExitBoot;          // DriverBindingStart  0
-  VRING                     Ring;              // VirtioRingInit      2
-  EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
-  EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
-  VOID                      *RingMap;          // VirtioRingMap       2
+  UINT32                    Signature;          // DriverBindingStart  0
+  VIRTIO_DEVICE_PROTOCOL    *VirtIo;            // DriverBindingStart  0
+  EFI_EVENT                 ExitBoot;           // DriverBindingStart  0
+  EFI_EVENT                 PollTimer;          // DriverBindingStart  0
+  BOOLEAN                   PollTimerArmed;     // SubmitRequest       1
+  BOOLEAN                   IndirectDesc;       // VirtioBlkInit       1
+  UINT16                    QueueCount;         // VirtioBlkInit       1
+  UINT16                    NextQueue;          // SubmitRequest       1
+  UINTN                     InFlight;           // SubmitRequest       1
+  VBLK_QUEUE                Queues[VBLK_MAX_QUEUES];
+                                                // VirtioBlkInitQueue  2
+  EFI_BLOCK_IO_PROTOCOL     BlockIo;            // VirtioBlkInit       1
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;           // VirtioBlkInit       1
+  EFI_BLOCK_IO_MEDIA        BlockIoMedia;       // VirtioBlkInit       1
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -123,7 +190,8 @@ VirtioBlkDriverBindingStart (
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo and BlockIo2
+  interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -244,6 +312,74 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.10, 13.10 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  The request is served synchronously if Token is NULL or Token->Event is
+  NULL. Otherwise it is queued to one of the virtqueues, and Token->Event is
+  signaled when the device completes it.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  The request is served synchronously if Token is NULL or Token->Event is
+  NULL. Otherwise it is queued to one of the virtqueues, and Token->Event is
+  signaled when the device completes it.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  The flush is issued after all requests in flight complete, so that it covers
+  every write submitted earlier.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
@@ -9,8 +9,8 @@
 #include "VirtioFsDxe.h"
 
 /**
-  Make the Virtio Filesysem device drop one reference count from a NodeId that
-  the driver looked up by filename.
+  Make the Virtio Filesysem device drop one or more reference counts from a
+  NodeId that the driver looked up by filename.
 
   Send the FUSE_FORGET request to the Virtio Filesysem device for this. Unlike
   most other FUSE requests, FUSE_FORGET doesn't elicit a response, not even the
@@ -23,9 +23,11 @@
                            request to. On output, the FUSE request counter
                            "VirtioFs->RequestId" will have been incremented.
 
-  @param[in] NodeId        The inode number that the client learned by way of
-                           lookup, and that the server should now un-reference
-                           exactly once.
+  @param[in] NodeId           The inode number that the client learned by way
+                              of lookup, and that the server should now
+                              un-reference.
+
+  @param[in] NumberOfLookups  The number of lookup references to drop.
 
   @retval EFI_SUCCESS  The FUSE_FORGET request has been submitted.
 
@@ -33,9 +35,10 @@
                        VirtioFsFuseNewRequest(), VirtioFsSgListsSubmit().
 **/
 EFI_STATUS
-VirtioFsFuseForget (
+VirtioFsFuseForgetLookups (
   IN OUT VIRTIO_FS  *VirtioFs,
-  IN     UINT64     NodeId
+  IN     UINT64     NodeId,
+  IN     UINT64     NumberOfLookups
   )
 {
   VIRTIO_FS_FUSE_REQUEST         CommonReq;
@@ -80,7 +83,7 @@ VirtioFsFuseForget (
   //
   // Populate the FUSE_FORGET-specific fields.
   //
-  ForgetReq.NumberOfLookups = 1;
+  ForgetReq.NumberOfLookups = NumberOfLookups;
 
   //
   // Submit the request. There's not going to be a response.
@@ -88,3 +91,39 @@ VirtioFsFuseForget (
   Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, NULL);
   return Status;
 }
+
+/**
+  Drop one reference count from a NodeId that the driver looked up by
+  filename.
+
+  If a valid directory entry in the cache resolves to NodeId, the cache keeps
+  the reference for a later lookup, and no FUSE_FORGET request is sent.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_FORGET
+                           request to, if needed.
+
+  @param[in] NodeId        The inode number that the client learned by way of
+                           lookup, and that the server should now un-reference
+                           exactly once.
+
+  @retval EFI_SUCCESS  The reference has been kept in the cache, or the
+                       FUSE_FORGET request has been submitted.
+
+  @return              Error codes propagated from
+                       VirtioFsFuseForgetLookups().
+**/
+EFI_STATUS
+VirtioFsFuseForget (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  if (VirtioFsDentryCacheKeepLookup (VirtioFs, NodeId)) {
+    return EFI_SUCCESS;
+  }
+
+  return VirtioFsFuseForgetLookups (VirtioFs, NodeId, 1);
+}
@@ -12,6 +12,9 @@
   Send a FUSE_GETATTR request to the Virtio Filesystem device, for fetching the
   attributes of an inode.
 
+  The attributes are served from the attribute cache while the validity period
+  that the device reported for them has not expired.
+
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
@@ -52,6 +55,10 @@ VirtioFsFuseGetAttr (
   VIRTIO_FS_SCATTER_GATHER_LIST    RespSgList;
   EFI_STATUS                       Status;
 
+  if (VirtioFsAttrCacheGet (VirtioFs, NodeId, FuseAttr)) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Set up the scatter-gather lists.
   //
@@ -124,5 +131,15 @@ VirtioFsFuseGetAttr (
     Status = VirtioFsErrnoToEfiStatus (CommonResp.Error);
   }
 
+  if (!EFI_ERROR (Status)) {
+    VirtioFsAttrCacheUpdate (
+      VirtioFs,
+      NodeId,
+      FuseAttr,
+      GetAttrResp.AttrValid,
+      GetAttrResp.AttrValidNsec
+      );
+  }
+
   return Status;
 }
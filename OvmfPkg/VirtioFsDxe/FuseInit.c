@@ -150,5 +150,10 @@ VirtioFsFuseInitSession (
   // Save the maximum write buffer size for FUSE_WRITE requests.
   //
   VirtioFs->MaxWrite = InitResp.MaxWrite;
+
+  //
+  // Start the session with empty lookup and attribute caches.
+  //
+  VirtioFsCacheInit (VirtioFs);
   return EFI_SUCCESS;
 }
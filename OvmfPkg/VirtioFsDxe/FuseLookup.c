@@ -17,6 +17,10 @@
   The function returns EFI_NOT_FOUND exclusively if the Virtio Filesystem
   device explicitly responds with ENOENT -- "No such file or directory".
 
+  While the directory entry cache keeps a lookup reference for Name, that
+  reference is handed to the caller instead, and FuseAttr is fetched with
+  VirtioFsFuseGetAttr().
+
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
@@ -68,6 +72,16 @@ VirtioFsFuseLookup (
   VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList;
   EFI_STATUS                     Status;
 
+  if (VirtioFsDentryCacheGet (VirtioFs, DirNodeId, Name, NodeId)) {
+    Status = VirtioFsFuseGetAttr (VirtioFs, *NodeId, FuseAttr);
+    if (EFI_ERROR (Status)) {
+      VirtioFsFuseForget (VirtioFs, *NodeId);
+      goto Fail;
+    }
+
+    return EFI_SUCCESS;
+  }
+
   //
   // Set up the scatter-gather lists.
   //
@@ -148,6 +162,22 @@ VirtioFsFuseLookup (
   // Output the NodeId to which Name has been resolved to.
   //
   *NodeId = NodeResp.NodeId;
+
+  VirtioFsAttrCacheUpdate (
+    VirtioFs,
+    NodeResp.NodeId,
+    FuseAttr,
+    NodeResp.AttrValid,
+    NodeResp.AttrValidNsec
+    );
+  VirtioFsDentryCacheUpdate (
+    VirtioFs,
+    DirNodeId,
+    Name,
+    NodeResp.NodeId,
+    NodeResp.EntryValid,
+    NodeResp.EntryValidNsec
+    );
   return EFI_SUCCESS;
 
 Fail:
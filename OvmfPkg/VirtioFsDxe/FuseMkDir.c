@@ -87,6 +87,11 @@ VirtioFsFuseMkDir (
     return Status;
   }
 
+  //
+  // The timestamps of the parent directory are about to change.
+  //
+  VirtioFsAttrCacheInvalidate (VirtioFs, ParentNodeId);
+
   //
   // Populate the common request header.
   //
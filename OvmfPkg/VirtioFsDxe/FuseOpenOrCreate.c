@@ -96,6 +96,11 @@ VirtioFsFuseOpenOrCreate (
     return Status;
   }
 
+  //
+  // The timestamps of the parent directory are about to change.
+  //
+  VirtioFsAttrCacheInvalidate (VirtioFs, ParentNodeId);
+
   //
   // Populate the common request header.
   //
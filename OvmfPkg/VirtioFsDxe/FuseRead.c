@@ -203,3 +203,217 @@ VirtioFsFuseReadFileOrDir (
   *Size = (UINT32)TailBufferFill;
   return EFI_SUCCESS;
 }
+
+/**
+  Read a range of a regular file by keeping several FUSE_READ requests in
+  flight on the Virtio Filesystem device at the same time.
+
+  The range is split into chunks of at most "VirtioFs->MaxWrite" bytes, and up
+  to VIRTIO_FS_MAX_EXCHANGES chunks are submitted together with
+  VirtioFsSgListsSubmitMultiple().
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per chunk.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in,out] Size      On input, the number of bytes to read. On successful
+                           return, the number of bytes actually read, which may
+                           be smaller than the value on input. The reading
+                           stops at the first chunk that the device returns
+                           short, hence EOF can be detected by passing in a
+                           nonzero Size, and finding a zero Size on output.
+
+  @param[out] Data         Buffer to read the bytes from the regular file into.
+                           The caller is responsible for providing room for (at
+                           least) as many bytes in Data as Size is on input.
+
+  @retval EFI_SUCCESS  Read successful. The caller is responsible for checking
+                       Size to learn the actual byte count transferred.
+
+  @return              The "errno" value mapped to an EFI_STATUS code, if the
+                       Virtio Filesystem device explicitly reported an error
+                       for the first chunk.
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest(),
+                       VirtioFsSgListsSubmitMultiple(),
+                       VirtioFsFuseCheckResponse(), for the first chunk.
+**/
+EFI_STATUS
+VirtioFsFuseReadFileMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST         CommonReq[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_FUSE_READ_REQUEST    ReadReq[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_IO_VECTOR            ReqIoVec[VIRTIO_FS_MAX_EXCHANGES][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_SCATTER_GATHER_LIST  *ReqSgListPtr[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_FUSE_RESPONSE        CommonResp[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_IO_VECTOR            RespIoVec[VIRTIO_FS_MAX_EXCHANGES][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList[VIRTIO_FS_MAX_EXCHANGES];
+  VIRTIO_FS_SCATTER_GATHER_LIST  *RespSgListPtr[VIRTIO_FS_MAX_EXCHANGES];
+  UINTN                          MaxExchanges;
+  UINTN                          NumExchanges;
+  UINTN                          Exchange;
+  UINTN                          Queued;
+  UINT32                         ChunkSize;
+  UINTN                          TailBufferFill;
+  UINTN                          Transferred;
+  EFI_STATUS                     Status;
+
+  //
+  // Each exchange takes four descriptors.
+  //
+  MaxExchanges = MIN (VIRTIO_FS_MAX_EXCHANGES, VirtioFs->QueueSize / 4);
+  if (MaxExchanges == 0) {
+    MaxExchanges = 1;
+  }
+
+  Status      = EFI_SUCCESS;
+  Transferred = 0;
+  while (Transferred < *Size) {
+    //
+    // Set up the scatter-gather lists for the next batch of chunks.
+    //
+    Queued = 0;
+    for (NumExchanges = 0;
+         NumExchanges < MaxExchanges && Transferred + Queued < *Size;
+         NumExchanges++)
+    {
+      ChunkSize = (UINT32)MIN ((UINTN)VirtioFs->MaxWrite, *Size - (Transferred + Queued));
+
+      ReqIoVec[NumExchanges][0].Buffer = &CommonReq[NumExchanges];
+      ReqIoVec[NumExchanges][0].Size   = sizeof CommonReq[NumExchanges];
+      ReqIoVec[NumExchanges][1].Buffer = &ReadReq[NumExchanges];
+      ReqIoVec[NumExchanges][1].Size   = sizeof ReadReq[NumExchanges];
+      ReqSgList[NumExchanges].IoVec    = ReqIoVec[NumExchanges];
+      ReqSgList[NumExchanges].NumVec   = ARRAY_SIZE (ReqIoVec[NumExchanges]);
+      ReqSgListPtr[NumExchanges]       = &ReqSgList[NumExchanges];
+
+      RespIoVec[NumExchanges][0].Buffer = &CommonResp[NumExchanges];
+      RespIoVec[NumExchanges][0].Size   = sizeof CommonResp[NumExchanges];
+      RespIoVec[NumExchanges][1].Buffer = (UINT8 *)Data + Transferred + Queued;
+      RespIoVec[NumExchanges][1].Size   = ChunkSize;
+      RespSgList[NumExchanges].IoVec    = RespIoVec[NumExchanges];
+      RespSgList[NumExchanges].NumVec   = ARRAY_SIZE (RespIoVec[NumExchanges]);
+      RespSgListPtr[NumExchanges]       = &RespSgList[NumExchanges];
+
+      //
+      // Validate the scatter-gather lists; calculate the total transfer
+      // sizes.
+      //
+      Status = VirtioFsSgListsValidate (
+                 VirtioFs,
+                 &ReqSgList[NumExchanges],
+                 &RespSgList[NumExchanges]
+                 );
+      if (EFI_ERROR (Status)) {
+        goto Done;
+      }
+
+      //
+      // Populate the common request header.
+      //
+      Status = VirtioFsFuseNewRequest (
+                 VirtioFs,
+                 &CommonReq[NumExchanges],
+                 ReqSgList[NumExchanges].TotalSize,
+                 VirtioFsFuseOpRead,
+                 NodeId
+                 );
+      if (EFI_ERROR (Status)) {
+        goto Done;
+      }
+
+      //
+      // Populate the FUSE_READ-specific fields.
+      //
+      ReadReq[NumExchanges].FileHandle = FuseHandle;
+      ReadReq[NumExchanges].Offset     = Offset + Transferred + Queued;
+      ReadReq[NumExchanges].Size       = ChunkSize;
+      ReadReq[NumExchanges].ReadFlags  = 0;
+      ReadReq[NumExchanges].LockOwner  = 0;
+      ReadReq[NumExchanges].Flags      = 0;
+      ReadReq[NumExchanges].Padding    = 0;
+
+      Queued += ChunkSize;
+    }
+
+    //
+    // Submit the requests.
+    //
+    Status = VirtioFsSgListsSubmitMultiple (
+               VirtioFs,
+               NumExchanges,
+               ReqSgListPtr,
+               RespSgListPtr
+               );
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    //
+    // Verify the responses in file order, and stop at the first chunk that
+    // failed or came back short.
+    //
+    for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+      Status = VirtioFsFuseCheckResponse (
+                 &RespSgList[Exchange],
+                 CommonReq[Exchange].Unique,
+                 &TailBufferFill
+                 );
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((
+            DEBUG_ERROR,
+            "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n",
+            __func__,
+            VirtioFs->Label,
+            NodeId,
+            FuseHandle,
+            ReadReq[Exchange].Offset,
+            ReadReq[Exchange].Size,
+            CommonResp[Exchange].Error
+            ));
+          Status = VirtioFsErrnoToEfiStatus (CommonResp[Exchange].Error);
+        }
+
+        goto Done;
+      }
+
+      Transferred += TailBufferFill;
+      if (TailBufferFill < ReadReq[Exchange].Size) {
+        goto Done;
+      }
+    }
+  }
+
+Done:
+  //
+  // Errors after some data has been transferred only truncate the read.
+  //
+  if ((Transferred > 0) || !EFI_ERROR (Status)) {
+    *Size = Transferred;
+    return EFI_SUCCESS;
+  }
+
+  return Status;
+}
@@ -92,6 +92,12 @@ VirtioFsFuseRename (
     return Status;
   }
 
+  //
+  // Both names are about to change meaning.
+  //
+  VirtioFsDentryCacheInvalidate (VirtioFs, OldParentNodeId, OldName);
+  VirtioFsDentryCacheInvalidate (VirtioFs, NewParentNodeId, NewName);
+
   //
   // Populate the common request header.
   //
@@ -98,6 +98,11 @@ VirtioFsFuseSetAttr (
     return Status;
   }
 
+  //
+  // The attributes are about to change.
+  //
+  VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
+
   //
   // Populate the common request header.
   //
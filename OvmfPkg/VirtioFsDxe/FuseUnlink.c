@@ -78,6 +78,11 @@ VirtioFsFuseRemoveFileOrDir (
     return Status;
   }
 
+  //
+  // The name is about to go away.
+  //
+  VirtioFsDentryCacheInvalidate (VirtioFs, ParentNodeId, Name);
+
   //
   // Populate the common request header.
   //
@@ -104,6 +104,11 @@ VirtioFsFuseWrite (
     return Status;
   }
 
+  //
+  // The size and the timestamps of the file are about to change.
+  //
+  VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
+
   //
   // Populate the common request header.
   //
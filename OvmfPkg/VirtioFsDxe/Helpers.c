@@ -6,11 +6,12 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
-#include <Library/BaseLib.h>             // StrLen()
-#include <Library/BaseMemoryLib.h>       // CopyMem()
-#include <Library/MemoryAllocationLib.h> // AllocatePool()
-#include <Library/TimeBaseLib.h>         // EpochToEfiTime()
-#include <Library/VirtioLib.h>           // Virtio10WriteFeatures()
+#include <Library/BaseLib.h>                  // StrLen()
+#include <Library/BaseMemoryLib.h>            // CopyMem()
+#include <Library/MemoryAllocationLib.h>      // AllocatePool()
+#include <Library/TimeBaseLib.h>              // EpochToEfiTime()
+#include <Library/UefiBootServicesTableLib.h> // gBS
+#include <Library/VirtioLib.h>                // Virtio10WriteFeatures()
 
 #include "VirtioFsDxe.h"
 
@@ -531,8 +532,7 @@ VirtioFsSgListsValidate (
                             more response bytes than ResponseSgList->TotalSize.
 
   @return                   Error codes propagated from
-                            VirtioMapAllBytesInSharedBuffer(), VirtioFlush(),
-                            or VirtioFs->Virtio->UnmapSharedBuffer().
+                            VirtioFsSgListsSubmitMultiple().
 **/
 EFI_STATUS
 VirtioFsSgListsSubmit (
@@ -541,157 +541,327 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   )
 {
-  VIRTIO_FS_SCATTER_GATHER_LIST  *SgListParam[2];
-  VIRTIO_MAP_OPERATION           SgListVirtioMapOp[ARRAY_SIZE (SgListParam)];
-  UINT16                         SgListDescriptorFlag[ARRAY_SIZE (SgListParam)];
-  UINTN                          ListId;
-  VIRTIO_FS_SCATTER_GATHER_LIST  *SgList;
-  UINTN                          IoVecIdx;
-  VIRTIO_FS_IO_VECTOR            *IoVec;
-  EFI_STATUS                     Status;
-  DESC_INDICES                   Indices;
-  UINT32                         TotalBytesWrittenByDevice;
-  UINT32                         BytesPermittedForWrite;
-
-  SgListParam[0]          = RequestSgList;
+  return VirtioFsSgListsSubmitMultiple (
+           VirtioFs,
+           1,
+           &RequestSgList,
+           &ResponseSgList
+           );
+}
+
+/**
+  Submit several validated pairs of (request buffer list, response buffer list)
+  to the Virtio Filesystem device at once, and wait until the device completes
+  all of them.
+
+  All descriptor chains are placed on the virtio queue before the device is
+  notified, so the device can process the exchanges in parallel, and complete
+  them in any order.
+
+  The requirements on input and the fields updated on output are the same as
+  for VirtioFsSgListsSubmit(), for each exchange.
+
+  The function may only be called after VirtioFsInit() returns successfully and
+  before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs         The Virtio Filesystem device that the
+                                  request-response exchanges should now be
+                                  submitted to.
+
+  @param[in] NumExchanges         The number of elements in RequestSgLists and
+                                  ResponseSgLists.
+
+  @param[in,out] RequestSgLists   The scatter-gather lists that describe the
+                                  request parts of the exchanges.
+
+  @param[in,out] ResponseSgLists  The scatter-gather lists that describe the
+                                  response parts of the exchanges. An element
+                                  may be NULL if and only if NULL was passed to
+                                  VirtioFsSgListsValidate() as ResponseSgList
+                                  for the exchange.
+
+  @retval EFI_SUCCESS            Transfers complete. The caller should
+                                 investigate the VIRTIO_FS_IO_VECTOR.Transferred
+                                 fields in each response list.
+
+  @retval EFI_INVALID_PARAMETER  NumExchanges is zero.
+
+  @retval EFI_UNSUPPORTED        NumExchanges exceeds VIRTIO_FS_MAX_EXCHANGES,
+                                 or the descriptor chains don't fit in the
+                                 virtio queue together.
+
+  @retval EFI_DEVICE_ERROR       The Virtio Filesystem device reported a chain
+                                 that was not submitted, or populating more
+                                 response bytes than the TotalSize of a
+                                 response list.
+
+  @return                        Error codes propagated from
+                                 VirtioMapAllBytesInSharedBuffer(),
+                                 VirtioFs->Virtio->SetQueueNotify(), or
+                                 VirtioFs->Virtio->UnmapSharedBuffer().
+**/
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumExchanges,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **ResponseSgLists
+  )
+{
+  VIRTIO_FS_SCATTER_GATHER_LIST   *SgListParam[2];
+  VIRTIO_MAP_OPERATION            SgListVirtioMapOp[ARRAY_SIZE (SgListParam)];
+  UINT16                          SgListDescriptorFlag[ARRAY_SIZE (SgListParam)];
+  UINT16                          HeadDescIdx[VIRTIO_FS_MAX_EXCHANGES];
+  UINT32                          BytesWrittenByDevice[VIRTIO_FS_MAX_EXCHANGES];
+  BOOLEAN                         Completed[VIRTIO_FS_MAX_EXCHANGES];
+  UINTN                           Exchange;
+  UINTN                           ListId;
+  VIRTIO_FS_SCATTER_GATHER_LIST   *SgList;
+  UINTN                           IoVecIdx;
+  VIRTIO_FS_IO_VECTOR             *IoVec;
+  UINTN                           DescriptorsNeeded;
+  EFI_STATUS                      Status;
+  DESC_INDICES                    Indices;
+  UINT16                          NextAvailIdx;
+  UINT16                          UsedIdx;
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINTN                           PollPeriodUsecs;
+  UINT32                          TotalBytesWrittenByDevice;
+  UINT32                          BytesPermittedForWrite;
+
+  if (NumExchanges == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (NumExchanges > VIRTIO_FS_MAX_EXCHANGES) {
+    return EFI_UNSUPPORTED;
+  }
+
   SgListVirtioMapOp[0]    = VirtioOperationBusMasterRead;
   SgListDescriptorFlag[0] = 0;
 
-  SgListParam[1]          = ResponseSgList;
   SgListVirtioMapOp[1]    = VirtioOperationBusMasterWrite;
   SgListDescriptorFlag[1] = VRING_DESC_F_WRITE;
 
   //
-  // Map all IO Vectors.
+  // VirtioFsSgListsValidate() has checked the descriptor chains one by one;
+  // make sure they also fit in the virtio queue together.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  DescriptorsNeeded = 0;
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    DescriptorsNeeded += RequestSgLists[Exchange]->NumVec;
+    if (ResponseSgLists[Exchange] != NULL) {
+      DescriptorsNeeded += ResponseSgLists[Exchange]->NumVec;
     }
+  }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Map this IO Vector.
-      //
-      Status = VirtioMapAllBytesInSharedBuffer (
-                 VirtioFs->Virtio,
-                 SgListVirtioMapOp[ListId],
-                 IoVec->Buffer,
-                 IoVec->Size,
-                 &IoVec->MappedAddress,
-                 &IoVec->Mapping
-                 );
-      if (EFI_ERROR (Status)) {
-        goto Unmap;
+  if (DescriptorsNeeded > VirtioFs->QueueSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Map all IO Vectors.
+  //
+  Status = EFI_SUCCESS;
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0] = RequestSgLists[Exchange];
+    SgListParam[1] = ResponseSgLists[Exchange];
+
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
       }
 
-      IoVec->Mapped = TRUE;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Map this IO Vector.
+        //
+        Status = VirtioMapAllBytesInSharedBuffer (
+                   VirtioFs->Virtio,
+                   SgListVirtioMapOp[ListId],
+                   IoVec->Buffer,
+                   IoVec->Size,
+                   &IoVec->MappedAddress,
+                   &IoVec->Mapping
+                   );
+        if (EFI_ERROR (Status)) {
+          goto Unmap;
+        }
+
+        IoVec->Mapped = TRUE;
+      }
     }
   }
 
   //
-  // Compose the descriptor chain.
+  // Compose the descriptor chains back to back, and expose their heads in the
+  // available ring.
   //
   VirtioPrepare (&VirtioFs->Ring, &Indices);
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
+  NextAvailIdx = *VirtioFs->Ring.Avail.Idx;
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0] = RequestSgLists[Exchange];
+    SgListParam[1] = ResponseSgLists[Exchange];
+
+    Indices.HeadDescIdx   = Indices.NextDescIdx;
+    HeadDescIdx[Exchange] = Indices.HeadDescIdx;
+    Completed[Exchange]   = FALSE;
+
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      UINT16  NextFlag;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        UINT16  NextFlag;
 
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Set VRING_DESC_F_NEXT on all except the very last descriptor.
-      //
-      NextFlag = VRING_DESC_F_NEXT;
-      if ((ListId == ARRAY_SIZE (SgListParam) - 1) &&
-          (IoVecIdx == SgList->NumVec - 1))
-      {
-        NextFlag = 0;
-      }
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Set VRING_DESC_F_NEXT on all except the very last descriptor of the
+        // chain.
+        //
+        NextFlag = VRING_DESC_F_NEXT;
+        if (((ListId == ARRAY_SIZE (SgListParam) - 1) ||
+             (SgListParam[ARRAY_SIZE (SgListParam) - 1] == NULL)) &&
+            (IoVecIdx == SgList->NumVec - 1))
+        {
+          NextFlag = 0;
+        }
 
-      VirtioAppendDesc (
-        &VirtioFs->Ring,
-        IoVec->MappedAddress,
-        (UINT32)IoVec->Size,
-        SgListDescriptorFlag[ListId] | NextFlag,
-        &Indices
-        );
+        VirtioAppendDesc (
+          &VirtioFs->Ring,
+          IoVec->MappedAddress,
+          (UINT32)IoVec->Size,
+          SgListDescriptorFlag[ListId] | NextFlag,
+          &Indices
+          );
+      }
     }
+
+    VirtioFs->Ring.Avail.Ring[NextAvailIdx++ % VirtioFs->Ring.QueueSize] =
+      HeadDescIdx[Exchange];
   }
 
   //
-  // Submit the descriptor chain.
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field, and 2.4.1.4 Notifying the
+  // Device.
   //
-  Status = VirtioFlush (
-             VirtioFs->Virtio,
-             VIRTIO_FS_REQUEST_QUEUE,
-             &VirtioFs->Ring,
-             &Indices,
-             &TotalBytesWrittenByDevice
-             );
+  MemoryFence ();
+  *VirtioFs->Ring.Avail.Idx = NextAvailIdx;
+  MemoryFence ();
+  Status = VirtioFs->Virtio->SetQueueNotify (
+                               VirtioFs->Virtio,
+                               VIRTIO_FS_REQUEST_QUEUE
+                               );
   if (EFI_ERROR (Status)) {
     goto Unmap;
   }
 
   //
-  // Sanity-check: the Virtio Filesystem device should not have written more
-  // bytes than what we offered buffers for.
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device. With all
+  // chains in flight, the device catches up with the available ring once it
+  // has completed all of them. Keep slowing down until we reach a poll period
+  // of slightly above 1 ms.
   //
-  if (ResponseSgList == NULL) {
-    BytesPermittedForWrite = 0;
-  } else {
-    BytesPermittedForWrite = ResponseSgList->TotalSize;
-  }
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (*VirtioFs->Ring.Used.Idx != NextAvailIdx) {
+    gBS->Stall (PollPeriodUsecs);
 
-  if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
-    Status = EFI_DEVICE_ERROR;
-    goto Unmap;
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    MemoryFence ();
   }
 
+  MemoryFence ();
+
   //
-  // Update the transfer sizes in the IO Vectors.
+  // Match the used elements to the exchanges by head descriptor index.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  for (UsedIdx = (UINT16)(NextAvailIdx - NumExchanges);
+       UsedIdx != NextAvailIdx;
+       UsedIdx++)
+  {
+    UsedElem = &VirtioFs->Ring.Used.UsedElem[UsedIdx % VirtioFs->Ring.QueueSize];
+    for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+      if (!Completed[Exchange] && (HeadDescIdx[Exchange] == UsedElem->Id)) {
+        break;
+      }
     }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
-        //
-        // We report that the Virtio Filesystem device has read all buffers in
-        // the request.
-        //
-        IoVec->Transferred = IoVec->Size;
-      } else {
-        //
-        // Regarding the response, calculate how much of the current IO Vector
-        // has been populated by the Virtio Filesystem device. In
-        // "TotalBytesWrittenByDevice", VirtioFlush() reported the total count
-        // across all device-writeable descriptors, in the order they were
-        // chained on the ring.
-        //
-        IoVec->Transferred = MIN (
-                               (UINTN)TotalBytesWrittenByDevice,
-                               IoVec->Size
-                               );
-        TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
-      }
+    if (Exchange == NumExchanges) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
     }
+
+    Completed[Exchange]            = TRUE;
+    BytesWrittenByDevice[Exchange] = UsedElem->Len;
   }
 
-  //
-  // By now, "TotalBytesWrittenByDevice" has been exhausted.
-  //
-  ASSERT (TotalBytesWrittenByDevice == 0);
+  for (Exchange = 0; Exchange < NumExchanges; Exchange++) {
+    SgListParam[0] = RequestSgLists[Exchange];
+    SgListParam[1] = ResponseSgLists[Exchange];
+
+    //
+    // Sanity-check: the Virtio Filesystem device should not have written more
+    // bytes than what we offered buffers for.
+    //
+    if (SgListParam[1] == NULL) {
+      BytesPermittedForWrite = 0;
+    } else {
+      BytesPermittedForWrite = SgListParam[1]->TotalSize;
+    }
+
+    TotalBytesWrittenByDevice = BytesWrittenByDevice[Exchange];
+    if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
+    }
+
+    //
+    // Update the transfer sizes in the IO Vectors.
+    //
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
+          //
+          // We report that the Virtio Filesystem device has read all buffers
+          // in the request.
+          //
+          IoVec->Transferred = IoVec->Size;
+        } else {
+          //
+          // Regarding the response, calculate how much of the current IO
+          // Vector has been populated by the Virtio Filesystem device. In
+          // "TotalBytesWrittenByDevice", the used element reported the total
+          // count across all device-writeable descriptors of the chain, in the
+          // order they were chained on the ring.
+          //
+          IoVec->Transferred = MIN (
+                                 (UINTN)TotalBytesWrittenByDevice,
+                                 IoVec->Size
+                                 );
+          TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+        }
+      }
+    }
+
+    //
+    // By now, "TotalBytesWrittenByDevice" has been exhausted.
+    //
+    ASSERT (TotalBytesWrittenByDevice == 0);
+  }
 
   //
   // We've succeeded; fall through.
@@ -702,49 +872,54 @@ Unmap:
   // unmapping occurs in reverse order of mapping, in an attempt to avoid
   // memory fragmentation.
   //
-  ListId = ARRAY_SIZE (SgListParam);
-  while (ListId > 0) {
-    --ListId;
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
-
-    IoVecIdx = SgList->NumVec;
-    while (IoVecIdx > 0) {
-      EFI_STATUS  UnmapStatus;
-
-      --IoVecIdx;
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Unmap this IO Vector, if it has been mapped.
-      //
-      if (!IoVec->Mapped) {
+  Exchange = NumExchanges;
+  while (Exchange > 0) {
+    --Exchange;
+    SgListParam[0] = RequestSgLists[Exchange];
+    SgListParam[1] = ResponseSgLists[Exchange];
+
+    ListId = ARRAY_SIZE (SgListParam);
+    while (ListId > 0) {
+      --ListId;
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
         continue;
       }
 
-      UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
-                                        VirtioFs->Virtio,
-                                        IoVec->Mapping
-                                        );
-      //
-      // Re-set the following fields to the values they initially got from
-      // VirtioFsSgListsValidate() -- the above unmapping attempt is considered
-      // final, even if it fails.
-      //
-      IoVec->Mapped        = FALSE;
-      IoVec->MappedAddress = 0;
-      IoVec->Mapping       = NULL;
+      IoVecIdx = SgList->NumVec;
+      while (IoVecIdx > 0) {
+        EFI_STATUS  UnmapStatus;
 
-      //
-      // If we are on the success path, but the unmapping failed, we need to
-      // transparently flip to the failure path -- the caller must learn they
-      // should not consult the response buffers.
-      //
-      // The branch below can be taken at most once.
-      //
-      if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
-        Status = UnmapStatus;
+        --IoVecIdx;
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Unmap this IO Vector, if it has been mapped.
+        //
+        if (!IoVec->Mapped) {
+          continue;
+        }
+
+        UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
+                                          VirtioFs->Virtio,
+                                          IoVec->Mapping
+                                          );
+        //
+        // Re-set the following fields to the values they initially got from
+        // VirtioFsSgListsValidate() -- the above unmapping attempt is
+        // considered final, even if it fails.
+        //
+        IoVec->Mapped        = FALSE;
+        IoVec->MappedAddress = 0;
+        IoVec->Mapping       = NULL;
+
+        //
+        // If we are on the success path, but the unmapping failed, we need to
+        // transparently flip to the failure path -- the caller must learn
+        // they should not consult the response buffers.
+        //
+        if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
+          Status = UnmapStatus;
+        }
       }
     }
   }
@@ -0,0 +1,446 @@
+/** @file
+  Directory entry and attribute caches for the Virtio Filesystem driver.
+
+  The caches honor the validity periods that the Virtio Filesystem device
+  reports in FUSE_LOOKUP and FUSE_GETATTR responses ("entry_valid" and
+  "attr_valid").
+
+  A directory entry that is in the cache keeps the lookup references that
+  VirtioFsFuseForget() would otherwise return to the device; a later lookup of
+  the same name takes such a reference back without a FUSE_LOOKUP round trip.
+  The references are returned to the device when the entry is evicted or
+  invalidated.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Library/BaseLib.h>         // AsciiStrCmp()
+#include <Library/BaseMemoryLib.h>   // ZeroMem()
+#include <Library/TimerLib.h>        // GetPerformanceCounter()
+
+#include "VirtioFsDxe.h"
+
+/**
+  Compute the point in time, in nanoseconds, when an object that the device
+  declared valid for Seconds + Nanoseconds from now expires.
+
+  @param[in] Seconds      The "entry_valid" or "attr_valid" field.
+
+  @param[in] Nanoseconds  The "entry_valid_nsec" or "attr_valid_nsec" field.
+
+  @return  The expiration time, or 0 if the object must not be cached.
+**/
+STATIC
+UINT64
+VirtioFsCacheExpiry (
+  IN UINT64  Seconds,
+  IN UINT32  Nanoseconds
+  )
+{
+  if ((Seconds == 0) && (Nanoseconds == 0)) {
+    return 0;
+  }
+
+  Seconds = MIN (Seconds, VIRTIO_FS_CACHE_MAX_VALID_SECONDS);
+  return GetTimeInNanoSecond (GetPerformanceCounter ()) +
+         MultU64x32 (Seconds, 1000000000) + MIN (Nanoseconds, 999999999);
+}
+
+/**
+  Check whether a cache entry is still valid.
+
+  @param[in] Expiry  The expiration time of the entry, from
+                     VirtioFsCacheExpiry().
+
+  @retval TRUE   The entry can be used.
+
+  @retval FALSE  The entry has expired, or it is empty.
+**/
+STATIC
+BOOLEAN
+VirtioFsCacheValid (
+  IN UINT64  Expiry
+  )
+{
+  return (BOOLEAN)((Expiry != 0) &&
+                   (GetTimeInNanoSecond (GetPerformanceCounter ()) < Expiry));
+}
+
+/**
+  Empty the directory entry and attribute caches, without returning any lookup
+  references to the device. Called when a FUSE session is started.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+**/
+VOID
+VirtioFsCacheInit (
+  IN OUT VIRTIO_FS  *VirtioFs
+  )
+{
+  ZeroMem (VirtioFs->AttrCache, sizeof VirtioFs->AttrCache);
+  ZeroMem (VirtioFs->DentryCache, sizeof VirtioFs->DentryCache);
+  VirtioFs->CacheAccess = 0;
+}
+
+/**
+  Look up the attributes of an inode in the attribute cache.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in] NodeId        The inode number.
+
+  @param[out] FuseAttr     The cached attributes, on success.
+
+  @retval TRUE   FuseAttr has been filled in from the cache.
+
+  @retval FALSE  The attributes are not cached, or they have expired.
+**/
+BOOLEAN
+VirtioFsAttrCacheGet (
+  IN OUT VIRTIO_FS                        *VirtioFs,
+  IN     UINT64                           NodeId,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  )
+{
+  UINTN                       Index;
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_ATTR_CACHE_SIZE; Index++) {
+    Entry = &VirtioFs->AttrCache[Index];
+    if ((Entry->NodeId == NodeId) && (Entry->Expiry != 0)) {
+      if (!VirtioFsCacheValid (Entry->Expiry)) {
+        Entry->Expiry = 0;
+        return FALSE;
+      }
+
+      Entry->LastAccess = ++VirtioFs->CacheAccess;
+      CopyMem (FuseAttr, &Entry->Attr, sizeof *FuseAttr);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Store the attributes of an inode, as returned by the device, in the
+  attribute cache.
+
+  @param[in,out] VirtioFs   The Virtio Filesystem device.
+
+  @param[in] NodeId         The inode number.
+
+  @param[in] FuseAttr       The attributes of the inode.
+
+  @param[in] AttrValid      The "attr_valid" field of the response.
+
+  @param[in] AttrValidNsec  The "attr_valid_nsec" field of the response.
+**/
+VOID
+VirtioFsAttrCacheUpdate (
+  IN OUT VIRTIO_FS                           *VirtioFs,
+  IN     UINT64                              NodeId,
+  IN     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  IN     UINT64                              AttrValid,
+  IN     UINT32                              AttrValidNsec
+  )
+{
+  UINT64                      Expiry;
+  UINTN                       Index;
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Entry;
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Victim;
+
+  Expiry = VirtioFsCacheExpiry (AttrValid, AttrValidNsec);
+  if (Expiry == 0) {
+    VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
+    return;
+  }
+
+  //
+  // Reuse the entry of the inode, or else an empty entry, or else the least
+  // recently used one.
+  //
+  Victim = &VirtioFs->AttrCache[0];
+  for (Index = 0; Index < VIRTIO_FS_ATTR_CACHE_SIZE; Index++) {
+    Entry = &VirtioFs->AttrCache[Index];
+    if (Entry->NodeId == NodeId) {
+      Victim = Entry;
+      break;
+    }
+
+    if ((Victim->Expiry != 0) &&
+        ((Entry->Expiry == 0) || (Entry->LastAccess < Victim->LastAccess)))
+    {
+      Victim = Entry;
+    }
+  }
+
+  Victim->NodeId     = NodeId;
+  Victim->Expiry     = Expiry;
+  Victim->LastAccess = ++VirtioFs->CacheAccess;
+  CopyMem (&Victim->Attr, FuseAttr, sizeof Victim->Attr);
+}
+
+/**
+  Drop the cached attributes of an inode, after an operation that may have
+  changed them.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in] NodeId        The inode number.
+**/
+VOID
+VirtioFsAttrCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < VIRTIO_FS_ATTR_CACHE_SIZE; Index++) {
+    if (VirtioFs->AttrCache[Index].NodeId == NodeId) {
+      VirtioFs->AttrCache[Index].Expiry = 0;
+    }
+  }
+}
+
+/**
+  Empty a directory entry cache slot, returning the lookup references it keeps
+  to the device.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in,out] Entry     The directory entry cache slot.
+**/
+STATIC
+VOID
+VirtioFsDentryCacheEvict (
+  IN OUT VIRTIO_FS                     *VirtioFs,
+  IN OUT VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry
+  )
+{
+  UINT64  Lookups;
+
+  Lookups        = Entry->Lookups;
+  Entry->Lookups = 0;
+  Entry->Expiry  = 0;
+  if (Lookups > 0) {
+    VirtioFsFuseForgetLookups (VirtioFs, Entry->NodeId, Lookups);
+  }
+}
+
+/**
+  Find the directory entry cache slot of a name in a directory.
+
+  @param[in] VirtioFs   The Virtio Filesystem device.
+
+  @param[in] DirNodeId  The inode number of the directory.
+
+  @param[in] Name       The single-component filename.
+
+  @return  The slot, or NULL if the name is not cached.
+**/
+STATIC
+VIRTIO_FS_DENTRY_CACHE_ENTRY *
+VirtioFsDentryCacheFind (
+  IN VIRTIO_FS  *VirtioFs,
+  IN UINT64     DirNodeId,
+  IN CHAR8      *Name
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_DENTRY_CACHE_SIZE; Index++) {
+    Entry = &VirtioFs->DentryCache[Index];
+    if (((Entry->Expiry != 0) || (Entry->Lookups > 0)) &&
+        (Entry->DirNodeId == DirNodeId) &&
+        (AsciiStrCmp (Entry->Name, Name) == 0))
+    {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Resolve a name in a directory from the directory entry cache.
+
+  On success, the caller receives one of the lookup references that the cache
+  keeps; it is expected to release it with VirtioFsFuseForget(), exactly as if
+  it had been returned by FUSE_LOOKUP.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in] DirNodeId     The inode number of the directory.
+
+  @param[in] Name          The single-component filename.
+
+  @param[out] NodeId       The inode number which Name has been resolved to.
+
+  @retval TRUE   NodeId has been set, and a lookup reference has been handed
+                 over to the caller.
+
+  @retval FALSE  The name is not cached, the entry has expired, or the cache
+                 keeps no lookup reference to hand over.
+**/
+BOOLEAN
+VirtioFsDentryCacheGet (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name,
+  OUT UINT64        *NodeId
+  )
+{
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry;
+
+  Entry = VirtioFsDentryCacheFind (VirtioFs, DirNodeId, Name);
+  if (Entry == NULL) {
+    return FALSE;
+  }
+
+  if (!VirtioFsCacheValid (Entry->Expiry)) {
+    VirtioFsDentryCacheEvict (VirtioFs, Entry);
+    return FALSE;
+  }
+
+  if (Entry->Lookups == 0) {
+    return FALSE;
+  }
+
+  Entry->Lookups--;
+  Entry->LastAccess = ++VirtioFs->CacheAccess;
+  *NodeId           = Entry->NodeId;
+  return TRUE;
+}
+
+/**
+  Record the result of a successful FUSE_LOOKUP in the directory entry cache.
+  The lookup reference stays with the caller.
+
+  @param[in,out] VirtioFs    The Virtio Filesystem device.
+
+  @param[in] DirNodeId       The inode number of the directory.
+
+  @param[in] Name            The single-component filename.
+
+  @param[in] NodeId          The inode number which Name has been resolved to.
+
+  @param[in] EntryValid      The "entry_valid" field of the response.
+
+  @param[in] EntryValidNsec  The "entry_valid_nsec" field of the response.
+**/
+VOID
+VirtioFsDentryCacheUpdate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name,
+  IN     UINT64     NodeId,
+  IN     UINT64     EntryValid,
+  IN     UINT32     EntryValidNsec
+  )
+{
+  UINT64                        Expiry;
+  UINTN                         Index;
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry;
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Victim;
+
+  Expiry = VirtioFsCacheExpiry (EntryValid, EntryValidNsec);
+  Entry  = VirtioFsDentryCacheFind (VirtioFs, DirNodeId, Name);
+  if ((Entry != NULL) && ((Entry->NodeId != NodeId) || (Expiry == 0))) {
+    VirtioFsDentryCacheEvict (VirtioFs, Entry);
+  }
+
+  if ((Expiry == 0) || (AsciiStrSize (Name) > sizeof Entry->Name)) {
+    return;
+  }
+
+  if ((Entry == NULL) || (Entry->Expiry == 0)) {
+    //
+    // Take an empty slot, or else the least recently used one.
+    //
+    Victim = &VirtioFs->DentryCache[0];
+    for (Index = 0; Index < VIRTIO_FS_DENTRY_CACHE_SIZE; Index++) {
+      Entry = &VirtioFs->DentryCache[Index];
+      if ((Entry->Expiry == 0) && (Entry->Lookups == 0)) {
+        Victim = Entry;
+        break;
+      }
+
+      if (Entry->LastAccess < Victim->LastAccess) {
+        Victim = Entry;
+      }
+    }
+
+    VirtioFsDentryCacheEvict (VirtioFs, Victim);
+    Entry            = Victim;
+    Entry->DirNodeId = DirNodeId;
+    Entry->NodeId    = NodeId;
+    AsciiStrCpyS (Entry->Name, sizeof Entry->Name, Name);
+  }
+
+  Entry->Expiry     = Expiry;
+  Entry->LastAccess = ++VirtioFs->CacheAccess;
+}
+
+/**
+  Let the directory entry cache keep a lookup reference that the driver is
+  about to return to the device.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in] NodeId        The inode number that the reference belongs to.
+
+  @retval TRUE   The cache keeps the reference; FUSE_FORGET must not be sent.
+
+  @retval FALSE  No valid directory entry resolves to NodeId.
+**/
+BOOLEAN
+VirtioFsDentryCacheKeepLookup (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  UINTN                         Index;
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < VIRTIO_FS_DENTRY_CACHE_SIZE; Index++) {
+    Entry = &VirtioFs->DentryCache[Index];
+    if ((Entry->NodeId == NodeId) && VirtioFsCacheValid (Entry->Expiry)) {
+      Entry->Lookups++;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Drop a name from the directory entry cache, after an operation that removed
+  or renamed it. The cached attributes of the inode it resolved to, and of the
+  directory, are dropped as well.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device.
+
+  @param[in] DirNodeId     The inode number of the directory.
+
+  @param[in] Name          The single-component filename.
+**/
+VOID
+VirtioFsDentryCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name
+  )
+{
+  VIRTIO_FS_DENTRY_CACHE_ENTRY  *Entry;
+
+  VirtioFsAttrCacheInvalidate (VirtioFs, DirNodeId);
+
+  Entry = VirtioFsDentryCacheFind (VirtioFs, DirNodeId, Name);
+  if (Entry != NULL) {
+    VirtioFsAttrCacheInvalidate (VirtioFs, Entry->NodeId);
+    VirtioFsDentryCacheEvict (VirtioFs, Entry);
+  }
+}
@@ -377,7 +377,6 @@ ReadRegularFile (
   EFI_STATUS                          Status;
   VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  FuseAttr;
   UINTN                               Transferred;
-  UINTN                               Left;
 
   VirtioFs = VirtioFsFile->OwnerFs;
   //
@@ -388,31 +387,17 @@ ReadRegularFile (
     return EFI_DEVICE_ERROR;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32  ReadSize;
-
-    //
-    // FUSE_READ cannot express a >=4GB buffer size.
-    //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status   = VirtioFsFuseReadFileOrDir (
-                 VirtioFs,
-                 VirtioFsFile->NodeId,
-                 VirtioFsFile->FuseHandle,
-                 FALSE,                                  // IsDir
-                 VirtioFsFile->FilePosition + Transferred,
-                 &ReadSize,
-                 (UINT8 *)Buffer + Transferred
-                 );
-    if (EFI_ERROR (Status) || (ReadSize == 0)) {
-      break;
-    }
-
-    Transferred += ReadSize;
-    Left        -= ReadSize;
+  Transferred = *BufferSize;
+  Status      = VirtioFsFuseReadFileMultiple (
+                  VirtioFs,
+                  VirtioFsFile->NodeId,
+                  VirtioFsFile->FuseHandle,
+                  VirtioFsFile->FilePosition,
+                  &Transferred,
+                  Buffer
+                  );
+  if (EFI_ERROR (Status)) {
+    Transferred = 0;
   }
 
   *BufferSize                 = Transferred;
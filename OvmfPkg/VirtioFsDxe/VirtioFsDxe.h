@@ -52,6 +52,28 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Number of inodes whose attributes are cached, number of directory entries
+// cached, and the longest name (in bytes, including the terminating '\0') a
+// cached directory entry may have.
+//
+#define VIRTIO_FS_ATTR_CACHE_SIZE    64
+#define VIRTIO_FS_DENTRY_CACHE_SIZE  64
+#define VIRTIO_FS_DENTRY_NAME_SIZE   64
+
+//
+// Upper limit on the validity period of cached attributes and directory
+// entries, regardless of what the Virtio Filesystem device permits.
+//
+#define VIRTIO_FS_CACHE_MAX_VALID_SECONDS  3600
+
+//
+// Maximum number of request-response exchanges that
+// VirtioFsSgListsSubmitMultiple() keeps in flight; this is the depth of the
+// FUSE_READ pipeline for regular files.
+//
+#define VIRTIO_FS_MAX_EXCHANGES  8
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -59,6 +81,31 @@
 //
 typedef CHAR16 VIRTIO_FS_LABEL[VIRTIO_FS_TAG_BYTES + 1];
 
+//
+// Attributes of an inode, cached until Expiry (in nanoseconds, on the
+// performance counter's time base). An Expiry of zero marks an empty entry.
+//
+typedef struct {
+  UINT64                                NodeId;
+  UINT64                                Expiry;
+  UINT64                                LastAccess;
+  VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE    Attr;
+} VIRTIO_FS_ATTR_CACHE_ENTRY;
+
+//
+// A name in a directory resolved to an inode, cached until Expiry. Lookups
+// counts the FUSE_LOOKUP references to NodeId that the cache keeps on behalf
+// of the driver.
+//
+typedef struct {
+  UINT64    DirNodeId;
+  UINT64    NodeId;
+  UINT64    Lookups;
+  UINT64    Expiry;
+  UINT64    LastAccess;
+  CHAR8     Name[VIRTIO_FS_DENTRY_NAME_SIZE];
+} VIRTIO_FS_DENTRY_CACHE_ENTRY;
+
 //
 // Main context structure, expressing an EFI_SIMPLE_FILE_SYSTEM_PROTOCOL
 // interface on top of the Virtio Filesystem device.
@@ -71,17 +118,22 @@ typedef struct {
   //
   //                              field         init function       init depth
   //                              -----------   ------------------  ----------
-  UINT64                             Signature; // DriverBindingStart  0
-  VIRTIO_DEVICE_PROTOCOL             *Virtio;   // DriverBindingStart  0
-  VIRTIO_FS_LABEL                    Label;     // VirtioFsInit        1
-  UINT16                             QueueSize; // VirtioFsInit        1
-  VRING                              Ring;      // VirtioRingInit      2
-  VOID                               *RingMap;  // VirtioRingMap       2
-  UINT64                             RequestId; // FuseInitSession     1
-  UINT32                             MaxWrite;  // FuseInitSession     1
-  EFI_EVENT                          ExitBoot;  // DriverBindingStart  0
-  LIST_ENTRY                         OpenFiles; // DriverBindingStart  0
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;  // DriverBindingStart  0
+  UINT64                             Signature;   // DriverBindingStart  0
+  VIRTIO_DEVICE_PROTOCOL             *Virtio;     // DriverBindingStart  0
+  VIRTIO_FS_LABEL                    Label;       // VirtioFsInit        1
+  UINT16                             QueueSize;   // VirtioFsInit        1
+  VRING                              Ring;        // VirtioRingInit      2
+  VOID                               *RingMap;    // VirtioRingMap       2
+  UINT64                             RequestId;   // FuseInitSession     1
+  UINT32                             MaxWrite;    // FuseInitSession     1
+  UINT64                             CacheAccess; // VirtioFsCacheInit   2
+  VIRTIO_FS_ATTR_CACHE_ENTRY         AttrCache[VIRTIO_FS_ATTR_CACHE_SIZE];
+                                                  // VirtioFsCacheInit   2
+  VIRTIO_FS_DENTRY_CACHE_ENTRY       DentryCache[VIRTIO_FS_DENTRY_CACHE_SIZE];
+                                                  // VirtioFsCacheInit   2
+  EFI_EVENT                          ExitBoot;    // DriverBindingStart  0
+  LIST_ENTRY                         OpenFiles;   // DriverBindingStart  0
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;    // DriverBindingStart  0
 } VIRTIO_FS;
 
 #define VIRTIO_FS_FROM_SIMPLE_FS(SimpleFsReference) \
@@ -218,6 +270,14 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   );
 
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumExchanges,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  **ResponseSgLists
+  );
+
 EFI_STATUS
 VirtioFsFuseNewRequest (
   IN OUT VIRTIO_FS              *VirtioFs,
@@ -308,6 +368,68 @@ VirtioFsGetFuseModeUpdate (
   OUT UINT32            *Mode
   );
 
+//
+// Directory entry and attribute caches.
+//
+
+VOID
+VirtioFsCacheInit (
+  IN OUT VIRTIO_FS  *VirtioFs
+  );
+
+BOOLEAN
+VirtioFsAttrCacheGet (
+  IN OUT VIRTIO_FS                        *VirtioFs,
+  IN     UINT64                           NodeId,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  );
+
+VOID
+VirtioFsAttrCacheUpdate (
+  IN OUT VIRTIO_FS                           *VirtioFs,
+  IN     UINT64                              NodeId,
+  IN     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  IN     UINT64                              AttrValid,
+  IN     UINT32                              AttrValidNsec
+  );
+
+VOID
+VirtioFsAttrCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
+BOOLEAN
+VirtioFsDentryCacheGet (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name,
+  OUT UINT64        *NodeId
+  );
+
+VOID
+VirtioFsDentryCacheUpdate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name,
+  IN     UINT64     NodeId,
+  IN     UINT64     EntryValid,
+  IN     UINT32     EntryValidNsec
+  );
+
+BOOLEAN
+VirtioFsDentryCacheKeepLookup (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
+VOID
+VirtioFsDentryCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     DirNodeId,
+  IN     CHAR8      *Name
+  );
+
 //
 // Wrapper functions for FUSE commands (primitives).
 //
@@ -327,6 +449,13 @@ VirtioFsFuseForget (
   IN     UINT64     NodeId
   );
 
+EFI_STATUS
+VirtioFsFuseForgetLookups (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     NumberOfLookups
+  );
+
 EFI_STATUS
 VirtioFsFuseGetAttr (
   IN OUT VIRTIO_FS                        *VirtioFs,
@@ -379,6 +508,16 @@ VirtioFsFuseReadFileOrDir (
   OUT VOID          *Data
   );
 
+EFI_STATUS
+VirtioFsFuseReadFileMultiple (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  );
+
 EFI_STATUS
 VirtioFsFuseWrite (
   IN OUT VIRTIO_FS  *VirtioFs,
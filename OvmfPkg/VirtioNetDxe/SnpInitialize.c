@@ -426,6 +426,13 @@ VirtioNetInitRx (
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = RxAlwaysPending;
 
+  //
+  // VirtioNetReceive() returns descriptors to the device in batches of a
+  // quarter of the ring, so that the device is notified less often.
+  //
+  Dev->RxUnnotified  = 0;
+  Dev->RxNotifyBatch = MAX (RxAlwaysPending / 4, 1);
+
   //
   // At this point reception may already be running. In order to make it sure,
   // kick the hypervisor. If we fail to kick it, we must first abort reception
@@ -175,11 +175,22 @@ RecycleDesc:
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = AvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device: the device doesn't need a
+  // notification while VRING_USED_F_NO_NOTIFY is set. Otherwise, as the
+  // device still owns most of the ring, notify it only once per batch.
+  //
   MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  ++Dev->RxUnnotified;
+  if ((Dev->RxUnnotified >= Dev->RxNotifyBatch) &&
+      ((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) == 0))
+  {
+    Dev->RxUnnotified = 0;
+    NotifyStatus      = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
@@ -173,8 +173,13 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
+  //
   MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) == 0) {
+    Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  }
 
 Exit:
   gBS->RestoreTPL (OldTpl);
@@ -14,6 +14,7 @@
 
 #include <IndustryStandard/VirtioNet.h>
 #include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
 #include <Library/VirtioLib.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/ComponentName2.h>
@@ -27,7 +28,7 @@
 //
 // maximum number of pending packets, separately for each direction
 //
-#define VNET_MAX_PENDING  64
+#define VNET_MAX_PENDING  FixedPcdGet16 (PcdVirtioNetMaxPending)
 
 //
 // State diagram:
@@ -82,6 +83,8 @@ typedef struct {
                                                   // VirtioNetInitRing
   UINT8                          *RxBuf;          // VirtioNetInitRx
   UINT16                         RxLastUsed;      // VirtioNetInitRx
+  UINT16                         RxUnnotified;    // VirtioNetInitRx
+  UINT16                         RxNotifyBatch;   // VirtioNetInitRx
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
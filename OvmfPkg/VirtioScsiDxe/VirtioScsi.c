@@ -7,16 +7,16 @@
 
   - No hotplug / hot-unplug.
 
-  - Although EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() could be a good match
-    for multiple in-flight virtio-scsi requests, we stick to synchronous
-    requests for now.
+  - EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() keeps several virtio-scsi
+    requests in flight when called with an Event. Completions are polled for,
+    in a timer callback for non-blocking requests.
 
   - Timeouts are not supported for EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru().
 
   - Only one channel is supported. (At the time of this writing, host-side
     virtio-scsi supports a single channel too.)
 
-  - Only one request queue is used (for the one synchronous request).
+  - Only one request queue is used.
 
   - The ResetChannel() and ResetTargetLun() functions of
     EFI_EXT_SCSI_PASS_THRU_PROTOCOL are not supported (which is allowed by the
@@ -410,41 +410,238 @@ ReportHostAdapterError (
   return EFI_DEVICE_ERROR;
 }
 
-//
-// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
-// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
-// - 14.1 SCSI Driver Model Overview,
-// - 14.7 Extended SCSI Pass Thru Protocol.
-//
+/**
 
-EFI_STATUS
+  Complete the request in a slot: parse the response into the caller's
+  packet, release the data buffers, and report the result through the
+  caller's event or the blocking caller's status.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev    The virtio-scsi host device.
+
+  @param[in] SlotIndex  The slot of the request.
+
+**/
+STATIC
+VOID
+CompleteRequest (
+  IN OUT VSCSI_DEV  *Dev,
+  IN     UINT16     SlotIndex
+  )
+{
+  VSCSI_REQUEST                               *Request;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  EFI_STATUS                                  Status;
+
+  Request = &Dev->Requests[SlotIndex];
+  ASSERT (Request->InUse);
+
+  Packet = Request->Packet;
+  Status = EFI_DEVICE_ERROR;
+  if (Packet != NULL) {
+    Status = ParseResponse (Packet, &Dev->Shared[SlotIndex].Response);
+
+    //
+    // If the request was a CPU read request then we have used an intermediate
+    // buffer. Copy the data from intermediate buffer to the final buffer.
+    //
+    if (Request->InDataBuffer != NULL) {
+      CopyMem (
+        Packet->InDataBuffer,
+        Request->InDataBuffer,
+        Packet->InTransferLength
+        );
+    }
+  }
+
+  if (Request->OutDataMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Request->OutDataMapping);
+  }
+
+  if (Request->InDataBuffer != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Request->InDataMapping);
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   Request->InDataNumPages,
+                   Request->InDataBuffer
+                   );
+  }
+
+  Request->InUse = FALSE;
+  ASSERT (Dev->InFlight > 0);
+  Dev->InFlight--;
+
+  if (Packet == NULL) {
+    return;
+  }
+
+  if (Request->Event != NULL) {
+    gBS->SignalEvent (Request->Event);
+  } else if (Request->Completion != NULL) {
+    Request->Completion->Status = Status;
+    Request->Completion->Done   = TRUE;
+  }
+}
+
+/**
+
+  Reap the requests that the device has placed in the used ring of the
+  request queue.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+ProcessCompletions (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINT32                          SlotIndex;
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  while (Dev->LastUsedIdx != *Dev->Ring.Used.Idx) {
+    MemoryFence ();
+    UsedElem = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx % Dev->Ring.QueueSize];
+    Dev->LastUsedIdx++;
+
+    //
+    // Slot N owns ring descriptors [4*N, 4*N+3].
+    //
+    SlotIndex = UsedElem->Id / VSCSI_DESCS_PER_REQUEST;
+    ASSERT (SlotIndex < Dev->RequestCount);
+    if (SlotIndex < Dev->RequestCount) {
+      CompleteRequest (Dev, (UINT16)SlotIndex);
+    }
+  }
+}
+
+/**
+
+  Timer notification function reaping the completions of non-blocking
+  requests. The timer is cancelled once no request is in flight.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VSCSI_DEV structure.
+
+**/
+STATIC
+VOID
 EFIAPI
-VirtioScsiPassThru (
-  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
-  IN     UINT8                                       *Target,
+VirtioScsiPollTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VSCSI_DEV  *Dev;
+
+  Dev = Context;
+  ProcessCompletions (Dev);
+  if ((Dev->InFlight == 0) && Dev->PollTimerArmed) {
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+    Dev->PollTimerArmed = FALSE;
+  }
+}
+
+/**
+
+  Wait until the device completes all requests in flight.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+WaitForInFlightRequests (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  EFI_TPL  OldTpl;
+  UINTN    InFlight;
+
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessCompletions (Dev);
+    InFlight = Dev->InFlight;
+    gBS->RestoreTPL (OldTpl);
+
+    if (InFlight == 0) {
+      break;
+    }
+
+    gBS->Stall (10);
+  }
+}
+
+/**
+
+  Translate an Extended SCSI Pass Thru Protocol packet to a virtio-scsi
+  request in a free request slot, and push it to the host without waiting for
+  the response. If all slots are busy, the function polls the used ring until
+  one is freed.
+
+  @param[in] Dev               The virtio-scsi host device the packet targets.
+
+  @param[in] Target            The SCSI target controlled by the virtio-scsi
+                               host device.
+
+  @param[in] Lun               The Logical Unit Number under the SCSI target.
+
+  @param[in out] Packet        The Extended SCSI Pass Thru Protocol packet to
+                               submit. It is updated on completion, or on
+                               failure to submit.
+
+  @param[in] Event             The event to signal on completion, for a
+                               non-blocking request. NULL otherwise.
+
+  @param[out] Completion       For a blocking request, the record that
+                               receives the PassThru() status code on
+                               completion. Its Done field must be preset to
+                               FALSE. NULL otherwise.
+
+
+  @retval EFI_SUCCESS  The request has been submitted; its result is reported
+                       through Packet, and Event or Completion.
+
+  @return              PassThru() status codes mandated by UEFI Spec 2.3.1 +
+                       Errata C, 14.7 Extended SCSI Pass Thru Protocol, if the
+                       request could not be submitted. Event and Completion
+                       are not used then.
+
+**/
+STATIC
+EFI_STATUS
+SubmitRequest (
+  IN     VSCSI_DEV                                   *Dev,
+  IN     UINT16                                      Target,
   IN     UINT64                                      Lun,
   IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
-  IN     EFI_EVENT                                   Event   OPTIONAL
+  IN     EFI_EVENT                                   Event       OPTIONAL,
+  OUT    volatile VSCSI_COMPLETION                   *Completion OPTIONAL
   )
 {
-  VSCSI_DEV                  *Dev;
-  UINT16                     TargetValue;
-  EFI_STATUS                 Status;
-  volatile VIRTIO_SCSI_REQ   Request;
-  volatile VIRTIO_SCSI_RESP  *Response;
-  VOID                       *ResponseBuffer;
-  DESC_INDICES               Indices;
-  VOID                       *RequestMapping;
-  VOID                       *ResponseMapping;
-  VOID                       *InDataMapping;
-  VOID                       *OutDataMapping;
-  EFI_PHYSICAL_ADDRESS       RequestDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       ResponseDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       InDataDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       OutDataDeviceAddress;
-  VOID                       *InDataBuffer;
-  UINTN                      InDataNumPages;
-  BOOLEAN                    OutDataBufferIsMapped;
+  EFI_STATUS            Status;
+  EFI_TPL               OldTpl;
+  UINT16                SlotIndex;
+  VSCSI_SHARED_SLOT     *Shared;
+  VSCSI_REQUEST         *Request;
+  EFI_PHYSICAL_ADDRESS  SlotDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  InDataDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  OutDataDeviceAddress;
+  VOID                  *InDataMapping;
+  VOID                  *OutDataMapping;
+  VOID                  *InDataBuffer;
+  UINTN                 InDataNumPages;
+  DESC_INDICES          Indices;
+  UINT16                NextAvailIdx;
 
   //
   // Set InDataMapping,OutDataMapping,InDataDeviceAddress and OutDataDeviceAddress to
@@ -455,34 +652,8 @@ VirtioScsiPassThru (
   InDataDeviceAddress  = 0;
   OutDataDeviceAddress = 0;
 
-  ZeroMem ((VOID *)&Request, sizeof (Request));
-
-  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
-  CopyMem (&TargetValue, Target, sizeof TargetValue);
-
-  InDataBuffer          = NULL;
-  OutDataBufferIsMapped = FALSE;
-  InDataNumPages        = 0;
-
-  Status = PopulateRequest (Dev, TargetValue, Lun, Packet, &Request);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
-  //
-  // Map the virtio-scsi Request header buffer
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)&Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    return ReportHostAdapterError (Packet);
-  }
+  InDataBuffer   = NULL;
+  InDataNumPages = 0;
 
   //
   // Map the input buffer
@@ -510,8 +681,7 @@ VirtioScsiPassThru (
                                     &InDataBuffer
                                     );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto UnmapRequestBuffer;
+      return ReportHostAdapterError (Packet);
     }
 
     ZeroMem (InDataBuffer, Packet->InTransferLength);
@@ -546,66 +716,62 @@ VirtioScsiPassThru (
       Status = ReportHostAdapterError (Packet);
       goto UnmapInDataBuffer;
     }
-
-    OutDataBufferIsMapped = TRUE;
   }
 
   //
-  // Response header is bi-direction (we preset with host status and expect
-  // the device to update it). Allocate a response buffer which can be mapped
-  // to access equally by both processor and device.
+  // Find a free request slot, reaping completions while there is none.
   //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *Response),
-                          &ResponseBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    Status = ReportHostAdapterError (Packet);
-    goto UnmapOutDataBuffer;
-  }
-
-  Response = ResponseBuffer;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for ( ; ;) {
+    for (SlotIndex = 0; SlotIndex < Dev->RequestCount; SlotIndex++) {
+      if (!Dev->Requests[SlotIndex].InUse) {
+        goto FoundSlot;
+      }
+    }
 
-  ZeroMem ((VOID *)Response, sizeof (*Response));
+    ProcessCompletions (Dev);
+    gBS->RestoreTPL (OldTpl);
+    gBS->Stall (10);
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  }
 
+FoundSlot:
   //
-  // preset a host status for ourselves that we do not accept as success
+  // The virtio-scsi request and response headers live in the slot's part of
+  // the shared buffer. Preset a host status for ourselves that we do not
+  // accept as success.
   //
-  Response->Response = VIRTIO_SCSI_S_FAILURE;
+  Shared            = &Dev->Shared[SlotIndex];
+  SlotDeviceAddress = Dev->SharedDeviceAddress + SlotIndex * sizeof *Shared;
+  ZeroMem (Shared, sizeof *Shared);
+  Status = PopulateRequest (Dev, Target, Lun, Packet, &Shared->Request);
+  ASSERT_EFI_ERROR (Status);
+  Shared->Response.Response = VIRTIO_SCSI_S_FAILURE;
 
-  //
-  // Map the response buffer with BusMasterCommonBuffer so that response
-  // buffer can be accessed by both host and device.
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             ResponseBuffer,
-             sizeof (*Response),
-             &ResponseDeviceAddress,
-             &ResponseMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = ReportHostAdapterError (Packet);
-    goto FreeResponseBuffer;
-  }
-
-  VirtioPrepare (&Dev->Ring, &Indices);
+  Request                   = &Dev->Requests[SlotIndex];
+  Request->InUse            = TRUE;
+  Request->Packet           = Packet;
+  Request->InDataBuffer     = InDataBuffer;
+  Request->InDataNumPages   = InDataNumPages;
+  Request->InDataMapping    = InDataMapping;
+  Request->OutDataMapping   = OutDataMapping;
+  Request->Event            = Event;
+  Request->Completion       = Completion;
+  Dev->InFlight++;
 
   //
-  // ensured by VirtioScsiInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
+  // The slot owns a fixed range of ring descriptors.
   //
-  ASSERT (Dev->Ring.QueueSize >= 4);
+  Indices.HeadDescIdx = (UINT16)(SlotIndex * VSCSI_DESCS_PER_REQUEST);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
 
   //
   // enqueue Request
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
+    SlotDeviceAddress + OFFSET_OF (VSCSI_SHARED_SLOT, Request),
+    sizeof Shared->Request,
     VRING_DESC_F_NEXT,
     &Indices
     );
@@ -628,8 +794,8 @@ VirtioScsiPassThru (
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    ResponseDeviceAddress,
-    sizeof *Response,
+    SlotDeviceAddress + OFFSET_OF (VSCSI_SHARED_SLOT, Response),
+    sizeof Shared->Response,
     VRING_DESC_F_WRITE | (Packet->InTransferLength > 0 ? VRING_DESC_F_NEXT : 0),
     &Indices
     );
@@ -647,47 +813,39 @@ VirtioScsiPassThru (
       );
   }
 
-  // If kicking the host fails, we must fake a host adapter error.
-  // EFI_NOT_READY would save us the effort, but it would also suggest that the
-  // caller retry.
-  //
-  if (VirtioFlush (
-        Dev->VirtIo,
-        VIRTIO_SCSI_REQUEST_QUEUE,
-        &Dev->Ring,
-        &Indices,
-        NULL
-        ) != EFI_SUCCESS)
-  {
-    Status = ReportHostAdapterError (Packet);
-    goto UnmapResponseBuffer;
-  }
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field
+  //
+  NextAvailIdx = *Dev->Ring.Avail.Idx;
 
-  Status = ParseResponse (Packet, Response);
+  Dev->Ring.Avail.Ring[NextAvailIdx++ % Dev->Ring.QueueSize] =
+    Indices.HeadDescIdx;
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = NextAvailIdx;
 
   //
-  // If virtio request was successful and it was a CPU read request then we
-  // have used an intermediate buffer. Copy the data from intermediate buffer
-  // to the final buffer.
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
   //
-  if (InDataBuffer != NULL) {
-    CopyMem (Packet->InDataBuffer, InDataBuffer, Packet->InTransferLength);
+  // If kicking the host fails, we must fake a host adapter error.
+  // EFI_NOT_READY would save us the effort, but it would also suggest that the
+  // caller retry. The descriptors are published already; leave the slot to be
+  // reaped if the device ever completes it, but don't report through the
+  // caller's objects.
+  //
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_SCSI_REQUEST_QUEUE);
+  if (EFI_ERROR (Status)) {
+    Request->Packet = NULL;
+    Status          = ReportHostAdapterError (Packet);
+  } else if ((Event != NULL) && !Dev->PollTimerArmed) {
+    if (!EFI_ERROR (gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VSCSI_POLL_PERIOD))) {
+      Dev->PollTimerArmed = TRUE;
+    }
   }
 
-UnmapResponseBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, ResponseMapping);
-
-FreeResponseBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *Response),
-                 ResponseBuffer
-                 );
-
-UnmapOutDataBuffer:
-  if (OutDataBufferIsMapped) {
-    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, OutDataMapping);
-  }
+  gBS->RestoreTPL (OldTpl);
+  return Status;
 
 UnmapInDataBuffer:
   if (InDataBuffer != NULL) {
@@ -699,12 +857,88 @@ FreeInDataBuffer:
     Dev->VirtIo->FreeSharedPages (Dev->VirtIo, InDataNumPages, InDataBuffer);
   }
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
-
   return Status;
 }
 
+//
+// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
+// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
+// - 14.1 SCSI Driver Model Overview,
+// - 14.7 Extended SCSI Pass Thru Protocol.
+//
+
+EFI_STATUS
+EFIAPI
+VirtioScsiPassThru (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
+  IN     UINT8                                       *Target,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event   OPTIONAL
+  )
+{
+  VSCSI_DEV                  *Dev;
+  UINT16                     TargetValue;
+  EFI_STATUS                 Status;
+  volatile VIRTIO_SCSI_REQ   Request;
+  volatile VSCSI_COMPLETION  Completion;
+  EFI_TPL                    OldTpl;
+  BOOLEAN                    Done;
+  UINTN                      PollPeriodUsecs;
+
+  ZeroMem ((VOID *)&Request, sizeof (Request));
+
+  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
+  CopyMem (&TargetValue, Target, sizeof TargetValue);
+
+  //
+  // Validate the packet before any resources are taken; SubmitRequest()
+  // populates the request header anew in the slot it picks.
+  //
+  Status = PopulateRequest (Dev, TargetValue, Lun, Packet, &Request);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Event != NULL) {
+    return SubmitRequest (Dev, TargetValue, Lun, Packet, Event, NULL);
+  }
+
+  Completion.Done = FALSE;
+  Status          = SubmitRequest (
+                      Dev,
+                      TargetValue,
+                      Lun,
+                      Packet,
+                      NULL,
+                      &Completion
+                      );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessCompletions (Dev);
+    Done = Completion.Done;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Done) {
+      return Completion.Status;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+}
+
 EFI_STATUS
 EFIAPI
 VirtioScsiGetNextTargetLun (
@@ -932,6 +1166,7 @@ VirtioScsiInit (
   UINT16      MaxChannel; // for validation only
   UINT32      NumQueues;  // for validation only
   UINT16      QueueSize;
+  UINTN       SharedPages;
 
   //
   // Execute virtio-0.9.5, 2.2.1 Device Initialization Sequence.
@@ -1057,7 +1292,7 @@ VirtioScsiInit (
   //
   // VirtioScsiPassThru() uses at most four descriptors
   //
-  if (QueueSize < 4) {
+  if (QueueSize < VSCSI_DESCS_PER_REQUEST) {
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -1106,6 +1341,44 @@ VirtioScsiInit (
     goto UnmapQueue;
   }
 
+  //
+  // A request takes four ring descriptors at most; each request slot owns a
+  // fixed range of them. The request and response headers of the slots are
+  // accessed by both processor and device.
+  //
+  Dev->RequestCount = (UINT16)MIN (
+                                QueueSize / VSCSI_DESCS_PER_REQUEST,
+                                VSCSI_MAX_REQUESTS
+                                );
+  SharedPages = EFI_SIZE_TO_PAGES (Dev->RequestCount * sizeof (VSCSI_SHARED_SLOT));
+  Status      = Dev->VirtIo->AllocateSharedPages (
+                               Dev->VirtIo,
+                               SharedPages,
+                               (VOID **)&Dev->Shared
+                               );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  ZeroMem (Dev->Shared, EFI_PAGES_TO_SIZE (SharedPages));
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Dev->Shared,
+             EFI_PAGES_TO_SIZE (SharedPages),
+             &Dev->SharedDeviceAddress,
+             &Dev->SharedMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeShared;
+  }
+
+  //
+  // Completions are polled for.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+  Dev->LastUsedIdx       = 0;
+
   //
   // step 5 -- Report understood features and guest-tuneables.
   //
@@ -1113,7 +1386,7 @@ VirtioScsiInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto UnmapShared;
     }
   }
 
@@ -1123,12 +1396,12 @@ VirtioScsiInit (
   //
   Status = VIRTIO_CFG_WRITE (Dev, CdbSize, VIRTIO_SCSI_CDB_SIZE);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapShared;
   }
 
   Status = VIRTIO_CFG_WRITE (Dev, SenseSize, VIRTIO_SCSI_SENSE_SIZE);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapShared;
   }
 
   //
@@ -1137,7 +1410,7 @@ VirtioScsiInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapShared;
   }
 
   //
@@ -1164,7 +1437,8 @@ VirtioScsiInit (
   // SCSI Pass Thru Protocol.
   //
   Dev->PassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
-                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
 
   //
   // no restriction on transfer buffer alignment
@@ -1173,6 +1447,12 @@ VirtioScsiInit (
 
   return EFI_SUCCESS;
 
+UnmapShared:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedMap);
+
+FreeShared:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, SharedPages, Dev->Shared);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1202,6 +1482,11 @@ VirtioScsiUninit (
   IN OUT VSCSI_DEV  *Dev
   )
 {
+  //
+  // Let the requests in flight complete, so that their buffers are released.
+  //
+  WaitForInFlightRequests (Dev);
+
   //
   // Reset the virtual device -- see virtio-0.9.5, 2.2.2.1 Device Status. When
   // VIRTIO_CFG_WRITE() returns, the host will have learned to stay away from
@@ -1214,6 +1499,12 @@ VirtioScsiUninit (
   Dev->MaxLun         = 0;
   Dev->MaxSectors     = 0;
 
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Dev->RequestCount * sizeof (VSCSI_SHARED_SLOT)),
+                 Dev->Shared
+                 );
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
@@ -1356,6 +1647,21 @@ VirtioScsiDriverBindingStart (
     goto UninitDev;
   }
 
+  //
+  // The timer reaping non-blocking requests is armed while they are in
+  // flight.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  &VirtioScsiPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
   //
   // Setup complete, attempt to export the driver instance's PassThru
   // interface.
@@ -1368,11 +1674,14 @@ VirtioScsiDriverBindingStart (
                           &Dev->PassThru
                           );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto ClosePollTimer;
   }
 
   return EFI_SUCCESS;
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1432,6 +1741,7 @@ VirtioScsiDriverBindingStop (
     return Status;
   }
 
+  gBS->CloseEvent (Dev->PollTimer);
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioScsiUninit (Dev);
@@ -17,6 +17,7 @@
 #include <Protocol/ScsiPassThruExt.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioScsi.h>
 
 //
 // This driver supports 2-byte target identifiers and 4-byte LUN identifiers.
@@ -34,6 +35,56 @@
 
 #define VSCSI_SIG  SIGNATURE_32 ('V', 'S', 'C', 'S')
 
+//
+// The number of request slots, and the number of ring descriptors each of
+// them owns: request header, "dataout", response header, "datain".
+//
+#define VSCSI_MAX_REQUESTS       32
+#define VSCSI_DESCS_PER_REQUEST  4
+
+//
+// Period of the timer that reaps the completions of non-blocking requests, in
+// 100ns units.
+//
+#define VSCSI_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+//
+// The part of a request slot that the device accesses.
+//
+typedef struct {
+  VIRTIO_SCSI_REQ     Request;
+  VIRTIO_SCSI_RESP    Response;
+} VSCSI_SHARED_SLOT;
+
+//
+// The result of a blocking request.
+//
+typedef struct {
+  BOOLEAN       Done;
+  EFI_STATUS    Status;
+} VSCSI_COMPLETION;
+
+//
+// The driver side bookkeeping of a request slot.
+//
+typedef struct {
+  BOOLEAN                                       InUse;
+  //
+  // NULL for a request whose submission failed half-way.
+  //
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  VOID                                          *InDataBuffer;
+  UINTN                                         InDataNumPages;
+  VOID                                          *InDataMapping;
+  VOID                                          *OutDataMapping;
+  //
+  // The event of a non-blocking request, or the completion record of a
+  // blocking one.
+  //
+  EFI_EVENT                                     Event;
+  volatile VSCSI_COMPLETION                     *Completion;
+} VSCSI_REQUEST;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -53,6 +104,17 @@ typedef struct {
   EFI_EXT_SCSI_PASS_THRU_PROTOCOL    PassThru;       // VirtioScsiInit      1
   EFI_EXT_SCSI_PASS_THRU_MODE        PassThruMode;   // VirtioScsiInit      1
   VOID                               *RingMap;       // VirtioRingMap       2
+  EFI_EVENT                          PollTimer;      // DriverBindingStart  0
+  BOOLEAN                            PollTimerArmed; // SubmitRequest       1
+  UINT16                             RequestCount;   // VirtioScsiInit      1
+  UINT16                             LastUsedIdx;    // VirtioScsiInit      1
+  UINTN                              InFlight;       // SubmitRequest       1
+  VSCSI_SHARED_SLOT                  *Shared;        // VirtioScsiInit      1
+  VOID                               *SharedMap;     // VirtioScsiInit      1
+  EFI_PHYSICAL_ADDRESS               SharedDeviceAddress;
+                                                     // VirtioScsiInit      1
+  VSCSI_REQUEST                      Requests[VSCSI_MAX_REQUESTS];
+                                                     // SubmitRequest       1
 } VSCSI_DEV;
 
 #define VIRTIO_SCSI_FROM_PASS_THRU(PassThruPointer) \
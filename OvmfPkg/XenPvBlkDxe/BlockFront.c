@@ -59,6 +59,115 @@ XenBusReadUint64 (
   return Status;
 }
 
+/**
+  Take a page from the pool of granted pages of a device, granting a new
+  one if the pool is empty.
+
+  @param Dev  A XEN_BLOCK_FRONT_DEVICE instance.
+
+  @return The granted page, or NULL if the memory allocation failed.
+**/
+STATIC
+XEN_BLOCK_FRONT_GRANT *
+XenPvBlockGetGrant (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev
+  )
+{
+  XENBUS_PROTOCOL        *XenBusIo = Dev->XenBusIo;
+  XEN_BLOCK_FRONT_GRANT  *Grant;
+  LIST_ENTRY             *Link;
+
+  if (!IsListEmpty (&Dev->FreeGrants)) {
+    //
+    // Reuse the most recently released page first, so that a backend
+    // limiting the grants it maps persistently sees the same subset.
+    //
+    Link = GetFirstNode (&Dev->FreeGrants);
+    RemoveEntryList (Link);
+    return XEN_BLOCK_FRONT_GRANT_FROM_LINK (Link);
+  }
+
+  Grant = AllocateZeroPool (sizeof (XEN_BLOCK_FRONT_GRANT));
+  if (Grant == NULL) {
+    return NULL;
+  }
+
+  Grant->Page = AllocatePages (1);
+  if (Grant->Page == NULL) {
+    FreePool (Grant);
+    return NULL;
+  }
+
+  Grant->Signature = XEN_BLOCK_FRONT_GRANT_SIGNATURE;
+  XenBusIo->GrantAccess (
+              XenBusIo,
+              Dev->DomainId,
+              (UINTN)Grant->Page >> EFI_PAGE_SHIFT,
+              FALSE,
+              &Grant->GrantRef
+              );
+  Dev->NumGrants++;
+  return Grant;
+}
+
+/**
+  Release a page to the pool of granted pages of a device. The page is
+  ungranted and freed if the pool holds more than what two requests use.
+
+  @param Dev    A XEN_BLOCK_FRONT_DEVICE instance.
+  @param Grant  The page to release.
+**/
+STATIC
+VOID
+XenPvBlockPutGrant (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev,
+  IN XEN_BLOCK_FRONT_GRANT   *Grant
+  )
+{
+  XENBUS_PROTOCOL  *XenBusIo = Dev->XenBusIo;
+
+  if (Dev->NumGrants > 2 * (Dev->MediaInfo.MaxSegments + 1)) {
+    XenBusIo->GrantEndAccess (XenBusIo, Grant->GrantRef);
+    FreePages (Grant->Page, 1);
+    FreePool (Grant);
+    Dev->NumGrants--;
+    return;
+  }
+
+  InsertHeadList (&Dev->FreeGrants, &Grant->Link);
+}
+
+/**
+  Remove the nodes the frontend has written to XenStore.
+
+  @param Dev  A XEN_BLOCK_FRONT_DEVICE instance.
+**/
+STATIC
+VOID
+XenPvBlockRemoveNodes (
+  IN XEN_BLOCK_FRONT_DEVICE  *Dev
+  )
+{
+  XENBUS_PROTOCOL  *XenBusIo = Dev->XenBusIo;
+  CHAR8            Node[sizeof ("ring-ref") + 2];
+  UINT32           Index;
+
+  if (Dev->RingPageOrder == 0) {
+    XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
+  } else {
+    for (Index = 0; Index < (1U << Dev->RingPageOrder); Index++) {
+      AsciiSPrint (Node, sizeof (Node), "ring-ref%d", Index);
+      XenBusIo->XsRemove (XenBusIo, XST_NIL, Node);
+    }
+
+    XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-page-order");
+  }
+
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenBusIo->XsRemove (XenBusIo, XST_NIL, "feature-persistent");
+}
+
 /**
   Free an instance of XEN_BLOCK_FRONT_DEVICE.
 
@@ -70,14 +179,28 @@ XenPvBlockFree (
   IN XEN_BLOCK_FRONT_DEVICE  *Dev
   )
 {
-  XENBUS_PROTOCOL  *XenBusIo = Dev->XenBusIo;
+  XENBUS_PROTOCOL        *XenBusIo = Dev->XenBusIo;
+  XEN_BLOCK_FRONT_GRANT  *Grant;
+  LIST_ENTRY             *Link;
+  UINT32                 Index;
+
+  while (!IsListEmpty (&Dev->FreeGrants)) {
+    Link  = GetFirstNode (&Dev->FreeGrants);
+    Grant = XEN_BLOCK_FRONT_GRANT_FROM_LINK (Link);
+    RemoveEntryList (Link);
+    XenBusIo->GrantEndAccess (XenBusIo, Grant->GrantRef);
+    FreePages (Grant->Page, 1);
+    FreePool (Grant);
+  }
 
-  if (Dev->RingRef != 0) {
-    XenBusIo->GrantEndAccess (XenBusIo, Dev->RingRef);
+  for (Index = 0; Index < (1U << Dev->RingPageOrder); Index++) {
+    if (Dev->RingRef[Index] != 0) {
+      XenBusIo->GrantEndAccess (XenBusIo, Dev->RingRef[Index]);
+    }
   }
 
   if (Dev->Ring.sring != NULL) {
-    FreePages (Dev->Ring.sring, 1);
+    FreePages (Dev->Ring.sring, 1 << Dev->RingPageOrder);
   }
 
   if (Dev->EventChannel != 0) {
@@ -162,6 +285,9 @@ XenPvBlockFrontInitialization (
   XenbusState             State;
   UINT64                  Value;
   CHAR8                   *Params;
+  CHAR8                   Node[sizeof ("ring-ref") + 2];
+  UINT32                  RingPages;
+  UINT32                  Index;
 
   ASSERT (NodeName != NULL);
 
@@ -174,6 +300,8 @@ XenPvBlockFrontInitialization (
   Dev->NodeName  = NodeName;
   Dev->XenBusIo  = XenBusIo;
   Dev->DeviceId  = XenBusIo->DeviceId;
+  InitializeListHead (&Dev->FreeGrants);
+  Dev->MediaInfo.MaxSegments = BLKIF_MAX_SEGMENTS_PER_REQUEST;
 
   XenBusIo->XsRead (XenBusIo, XST_NIL, "device-type", (VOID **)&DeviceType);
   if (AsciiStrCmp (DeviceType, "cdrom") == 0) {
@@ -213,16 +341,30 @@ XenPvBlockFrontInitialization (
   Dev->DomainId = (domid_t)Value;
   XenBusIo->EventChannelAllocate (XenBusIo, Dev->DomainId, &Dev->EventChannel);
 
-  SharedRing = (blkif_sring_t *)AllocatePages (1);
+  //
+  // Use a multi-page ring if the backend supports it.
+  //
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "max-ring-page-order", TRUE, &Value);
+  Dev->RingPageOrder = (UINT32)MIN (Value, XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER);
+  RingPages          = 1U << Dev->RingPageOrder;
+
+  SharedRing = (blkif_sring_t *)AllocatePages (RingPages);
+  if (SharedRing == NULL) {
+    goto Error;
+  }
+
   SHARED_RING_INIT (SharedRing);
-  FRONT_RING_INIT (&Dev->Ring, SharedRing, EFI_PAGE_SIZE);
-  XenBusIo->GrantAccess (
-              XenBusIo,
-              Dev->DomainId,
-              (INTN)SharedRing >> EFI_PAGE_SHIFT,
-              FALSE,
-              &Dev->RingRef
-              );
+  FRONT_RING_INIT (&Dev->Ring, SharedRing, EFI_PAGES_TO_SIZE (RingPages));
+  for (Index = 0; Index < RingPages; Index++) {
+    XenBusIo->GrantAccess (
+                XenBusIo,
+                Dev->DomainId,
+                ((UINTN)SharedRing >> EFI_PAGE_SHIFT) + Index,
+                FALSE,
+                &Dev->RingRef[Index]
+                );
+  }
 
 Again:
   Status = XenBusIo->XsTransactionStart (XenBusIo, &Transaction);
@@ -231,14 +373,37 @@ Again:
     goto Error;
   }
 
-  Status = XenBusIo->XsPrintf (
-                       XenBusIo,
-                       &Transaction,
-                       NodeName,
-                       "ring-ref",
-                       "%d",
-                       Dev->RingRef
-                       );
+  if (Dev->RingPageOrder == 0) {
+    Status = XenBusIo->XsPrintf (
+                         XenBusIo,
+                         &Transaction,
+                         NodeName,
+                         "ring-ref",
+                         "%d",
+                         Dev->RingRef[0]
+                         );
+  } else {
+    Status = XenBusIo->XsPrintf (
+                         XenBusIo,
+                         &Transaction,
+                         NodeName,
+                         "ring-page-order",
+                         "%d",
+                         Dev->RingPageOrder
+                         );
+    for (Index = 0; (Index < RingPages) && (Status == XENSTORE_STATUS_SUCCESS); Index++) {
+      AsciiSPrint (Node, sizeof (Node), "ring-ref%d", Index);
+      Status = XenBusIo->XsPrintf (
+                           XenBusIo,
+                           &Transaction,
+                           NodeName,
+                           Node,
+                           "%d",
+                           Dev->RingRef[Index]
+                           );
+    }
+  }
+
   if (Status != XENSTORE_STATUS_SUCCESS) {
     DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write ring-ref.\n"));
     goto AbortTransaction;
@@ -270,6 +435,19 @@ Again:
     goto AbortTransaction;
   }
 
+  Status = XenBusIo->XsPrintf (
+                       XenBusIo,
+                       &Transaction,
+                       NodeName,
+                       "feature-persistent",
+                       "%d",
+                       1
+                       );
+  if (Status != XENSTORE_STATUS_SUCCESS) {
+    DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to write feature-persistent.\n"));
+    goto AbortTransaction;
+  }
+
   Status = XenBusIo->SetState (XenBusIo, &Transaction, XenbusStateConnected);
   if (Status != XENSTORE_STATUS_SUCCESS) {
     DEBUG ((DEBUG_ERROR, "XenPvBlk: Failed to switch state.\n"));
@@ -354,21 +532,45 @@ Again:
     Dev->MediaInfo.FeatureFlushCache = FALSE;
   }
 
+  //
+  // With persistent grants, the data goes through pages of the pool which
+  // stay granted, instead of granting the caller's buffer on every request.
+  //
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "feature-persistent", TRUE, &Value);
+  if (Value == 1) {
+    Dev->MediaInfo.FeaturePersistent = TRUE;
+  } else {
+    Dev->MediaInfo.FeaturePersistent = FALSE;
+  }
+
+  // Default value
+  Value = 0;
+  XenBusReadUint64 (XenBusIo, "feature-max-indirect-segments", TRUE, &Value);
+  if (Value > BLKIF_MAX_SEGMENTS_PER_REQUEST) {
+    Dev->MediaInfo.MaxSegments = (UINT32)MIN (Value, XEN_BLOCK_FRONT_MAX_SEGMENTS);
+  }
+
   DEBUG ((
     DEBUG_INFO,
     "XenPvBlk: New disk with %ld sectors of %d bytes\n",
     Dev->MediaInfo.Sectors,
     Dev->MediaInfo.SectorSize
     ));
+  DEBUG ((
+    DEBUG_INFO,
+    "XenPvBlk: %d ring pages, %d segments per request, persistent grants %d\n",
+    1U << Dev->RingPageOrder,
+    Dev->MediaInfo.MaxSegments,
+    Dev->MediaInfo.FeaturePersistent
+    ));
 
   *DevPtr = Dev;
   return EFI_SUCCESS;
 
 Error2:
   XenBusIo->UnregisterWatch (XenBusIo, Dev->StateWatchToken);
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenPvBlockRemoveNodes (Dev);
   goto Error;
 AbortTransaction:
   XenBusIo->XsTransactionEnd (XenBusIo, &Transaction, TRUE);
@@ -464,9 +666,7 @@ XenPvBlockFrontShutdown (
 
 Close:
   XenBusIo->UnregisterWatch (XenBusIo, Dev->StateWatchToken);
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "ring-ref");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "event-channel");
-  XenBusIo->XsRemove (XenBusIo, XST_NIL, "protocol");
+  XenPvBlockRemoveNodes (Dev);
 
   XenPvBlockFree (Dev);
 }
@@ -496,13 +696,16 @@ XenPvBlockAsyncIo (
   IN     BOOLEAN             IsWrite
   )
 {
-  XEN_BLOCK_FRONT_DEVICE  *Dev      = IoData->Dev;
-  XENBUS_PROTOCOL         *XenBusIo = Dev->XenBusIo;
-  blkif_request_t         *Request;
-  RING_IDX                RingIndex;
-  BOOLEAN                 Notify;
-  INT32                   NumSegments, Index;
-  UINTN                   Start, End;
+  XEN_BLOCK_FRONT_DEVICE        *Dev      = IoData->Dev;
+  XENBUS_PROTOCOL               *XenBusIo = Dev->XenBusIo;
+  blkif_request_t               *Request;
+  blkif_request_indirect_t      *IndirectRequest;
+  struct blkif_request_segment  *Segments;
+  XEN_BLOCK_FRONT_GRANT         *IndirectGrant;
+  RING_IDX                      RingIndex;
+  BOOLEAN                       Notify;
+  INT32                         NumSegments, Index;
+  UINTN                         Start, End, Length;
 
   // Can't io at non-sector-aligned location
   ASSERT (!(IoData->Sector & ((Dev->MediaInfo.SectorSize / 512) - 1)));
@@ -511,40 +714,114 @@ XenPvBlockAsyncIo (
   // Can't io non-sector-aligned buffer
   ASSERT (!((UINTN)IoData->Buffer & (Dev->MediaInfo.SectorSize - 1)));
 
-  Start          = (UINTN)IoData->Buffer & ~EFI_PAGE_MASK;
-  End            = ((UINTN)IoData->Buffer + IoData->Size + EFI_PAGE_SIZE - 1) & ~EFI_PAGE_MASK;
-  IoData->NumRef = NumSegments = (INT32)((End - Start) / EFI_PAGE_SIZE);
+  IoData->IsWrite       = IsWrite;
+  IoData->NumRef        = 0;
+  IoData->NumGrants     = 0;
+  IoData->NumDataGrants = 0;
+  IndirectGrant         = NULL;
 
-  ASSERT (NumSegments <= BLKIF_MAX_SEGMENTS_PER_REQUEST);
+  if (Dev->MediaInfo.FeaturePersistent) {
+    //
+    // The data is copied to or from the pages of the pool, packed from
+    // the start of the first page.
+    //
+    Start       = 0;
+    NumSegments = (INT32)((IoData->Size + EFI_PAGE_SIZE - 1) / EFI_PAGE_SIZE);
+  } else {
+    Start       = (UINTN)IoData->Buffer & ~EFI_PAGE_MASK;
+    End         = ((UINTN)IoData->Buffer + IoData->Size + EFI_PAGE_SIZE - 1) & ~EFI_PAGE_MASK;
+    NumSegments = (INT32)((End - Start) / EFI_PAGE_SIZE);
+  }
+
+  ASSERT (NumSegments <= (INT32)Dev->MediaInfo.MaxSegments);
+
+  //
+  // Take the pages the request needs from the pool first.
+  //
+  if (Dev->MediaInfo.FeaturePersistent) {
+    for (Index = 0; Index < NumSegments; Index++) {
+      IoData->Grants[Index] = XenPvBlockGetGrant (Dev);
+      if (IoData->Grants[Index] == NULL) {
+        goto OutOfResources;
+      }
+
+      IoData->NumGrants++;
+    }
+
+    IoData->NumDataGrants = NumSegments;
+  }
+
+  if (NumSegments > BLKIF_MAX_SEGMENTS_PER_REQUEST) {
+    IndirectGrant = XenPvBlockGetGrant (Dev);
+    if (IndirectGrant == NULL) {
+      goto OutOfResources;
+    }
+
+    IoData->Grants[IoData->NumGrants++] = IndirectGrant;
+  }
 
   XenPvBlockWaitSlot (Dev);
   RingIndex = Dev->Ring.req_prod_pvt;
   Request   = RING_GET_REQUEST (&Dev->Ring, RingIndex);
 
-  Request->operation     = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
-  Request->nr_segments   = (UINT8)NumSegments;
-  Request->handle        = Dev->DeviceId;
-  Request->id            = (UINTN)IoData;
-  Request->sector_number = IoData->Sector;
+  //
+  // The segments of an indirect request are in the indirect page.
+  //
+  if (IndirectGrant != NULL) {
+    Segments = (struct blkif_request_segment *)IndirectGrant->Page;
+  } else {
+    Segments = Request->seg;
+  }
 
   for (Index = 0; Index < NumSegments; Index++) {
-    Request->seg[Index].first_sect = 0;
-    Request->seg[Index].last_sect  = EFI_PAGE_SIZE / 512 - 1;
+    Segments[Index].first_sect = 0;
+    Segments[Index].last_sect  = EFI_PAGE_SIZE / 512 - 1;
   }
 
-  Request->seg[0].first_sect              = (UINT8)(((UINTN)IoData->Buffer & EFI_PAGE_MASK) / 512);
-  Request->seg[NumSegments - 1].last_sect =
-    (UINT8)((((UINTN)IoData->Buffer + IoData->Size - 1) & EFI_PAGE_MASK) / 512);
-  for (Index = 0; Index < NumSegments; Index++) {
-    UINTN  Data = Start + Index * EFI_PAGE_SIZE;
-    XenBusIo->GrantAccess (
-                XenBusIo,
-                Dev->DomainId,
-                Data >> EFI_PAGE_SHIFT,
-                IsWrite,
-                &Request->seg[Index].gref
-                );
-    IoData->GrantRef[Index] = Request->seg[Index].gref;
+  if (Dev->MediaInfo.FeaturePersistent) {
+    for (Index = 0; Index < NumSegments; Index++) {
+      Length = MIN (EFI_PAGE_SIZE, IoData->Size - Index * EFI_PAGE_SIZE);
+      if (IsWrite) {
+        CopyMem (IoData->Grants[Index]->Page, IoData->Buffer + Index * EFI_PAGE_SIZE, Length);
+      }
+
+      Segments[Index].gref      = IoData->Grants[Index]->GrantRef;
+      Segments[Index].last_sect = (UINT8)(Length / 512 - 1);
+    }
+  } else {
+    Segments[0].first_sect              = (UINT8)(((UINTN)IoData->Buffer & EFI_PAGE_MASK) / 512);
+    Segments[NumSegments - 1].last_sect =
+      (UINT8)((((UINTN)IoData->Buffer + IoData->Size - 1) & EFI_PAGE_MASK) / 512);
+    for (Index = 0; Index < NumSegments; Index++) {
+      UINTN  Data = Start + Index * EFI_PAGE_SIZE;
+      XenBusIo->GrantAccess (
+                  XenBusIo,
+                  Dev->DomainId,
+                  Data >> EFI_PAGE_SHIFT,
+                  IsWrite,
+                  &Segments[Index].gref
+                  );
+      IoData->GrantRef[Index] = Segments[Index].gref;
+    }
+
+    IoData->NumRef = NumSegments;
+  }
+
+  if (IndirectGrant != NULL) {
+    IndirectRequest                    = (blkif_request_indirect_t *)Request;
+    IndirectRequest->operation         = BLKIF_OP_INDIRECT;
+    IndirectRequest->indirect_op       = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
+    IndirectRequest->nr_segments       = (UINT16)NumSegments;
+    IndirectRequest->handle            = Dev->DeviceId;
+    IndirectRequest->id                = (UINTN)IoData;
+    IndirectRequest->sector_number     = IoData->Sector;
+    IndirectRequest->indirect_grefs[0] = IndirectGrant->GrantRef;
+  } else {
+    Request->operation     = IsWrite ? BLKIF_OP_WRITE : BLKIF_OP_READ;
+    Request->nr_segments   = (UINT8)NumSegments;
+    Request->handle        = Dev->DeviceId;
+    Request->id            = (UINTN)IoData;
+    Request->sector_number = IoData->Sector;
   }
 
   Dev->Ring.req_prod_pvt = RingIndex + 1;
@@ -563,6 +840,16 @@ XenPvBlockAsyncIo (
         ));
     }
   }
+
+  return;
+
+OutOfResources:
+  for (Index = 0; Index < IoData->NumGrants; Index++) {
+    XenPvBlockPutGrant (Dev, IoData->Grants[Index]);
+  }
+
+  IoData->NumGrants = 0;
+  IoData->Status    = EFI_OUT_OF_RESOURCES;
 }
 
 EFI_STATUS
@@ -673,15 +960,17 @@ XenPvBlockAsyncIoPoll (
       switch (Response->operation) {
         case BLKIF_OP_READ:
         case BLKIF_OP_WRITE:
+        case BLKIF_OP_INDIRECT:
         {
           INT32  Index;
+          UINTN  Length;
 
           if (Status != BLKIF_RSP_OKAY) {
             DEBUG ((
               DEBUG_ERROR,
               "XenPvBlk: "
               "%a error %d on %a at sector %Lx, num bytes %Lx\n",
-              Response->operation == BLKIF_OP_READ ? "read" : "write",
+              IoData->IsWrite ? "write" : "read",
               Status,
               IoData->Dev->NodeName,
               (UINT64)IoData->Sector,
@@ -693,6 +982,17 @@ XenPvBlockAsyncIoPoll (
             Dev->XenBusIo->GrantEndAccess (Dev->XenBusIo, IoData->GrantRef[Index]);
           }
 
+          if (!IoData->IsWrite && (Status == BLKIF_RSP_OKAY)) {
+            for (Index = 0; Index < IoData->NumDataGrants; Index++) {
+              Length = MIN (EFI_PAGE_SIZE, IoData->Size - Index * EFI_PAGE_SIZE);
+              CopyMem (IoData->Buffer + Index * EFI_PAGE_SIZE, IoData->Grants[Index]->Page, Length);
+            }
+          }
+
+          for (Index = 0; Index < IoData->NumGrants; Index++) {
+            XenPvBlockPutGrant (Dev, IoData->Grants[Index]);
+          }
+
           break;
         }
 
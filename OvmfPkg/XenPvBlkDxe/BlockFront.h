@@ -11,18 +11,56 @@
 #include <IndustryStandard/Xen/event_channel.h>
 #include <IndustryStandard/Xen/io/blkif.h>
 
+//
+// Largest ring the frontend negotiates, as a power of two of pages.
+//
+#define XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER  2
+#define XEN_BLOCK_FRONT_MAX_RING_PAGES       (1 << XEN_BLOCK_FRONT_MAX_RING_PAGE_ORDER)
+
+//
+// Largest number of segments of an indirect request. The segments of such
+// a request fit in a single indirect page.
+//
+#define XEN_BLOCK_FRONT_MAX_SEGMENTS  64
+#define XEN_BLOCK_FRONT_SEGMENTS_PER_INDIRECT_PAGE \
+  (EFI_PAGE_SIZE / sizeof (struct blkif_request_segment))
+
 typedef struct _XEN_BLOCK_FRONT_DEVICE  XEN_BLOCK_FRONT_DEVICE;
 typedef struct _XEN_BLOCK_FRONT_IO      XEN_BLOCK_FRONT_IO;
 
+//
+// A page granted to the backend once, and reused by the requests either
+// as a persistent data page or as an indirect segment page.
+//
+#define XEN_BLOCK_FRONT_GRANT_SIGNATURE  SIGNATURE_32 ('X', 'p', 'v', 'G')
+typedef struct {
+  UINT32         Signature;
+  LIST_ENTRY     Link;
+  VOID           *Page;
+  grant_ref_t    GrantRef;
+} XEN_BLOCK_FRONT_GRANT;
+
+#define XEN_BLOCK_FRONT_GRANT_FROM_LINK(l) \
+  CR (l, XEN_BLOCK_FRONT_GRANT, Link, XEN_BLOCK_FRONT_GRANT_SIGNATURE)
+
 struct _XEN_BLOCK_FRONT_IO {
   XEN_BLOCK_FRONT_DEVICE    *Dev;
   UINT8                     *Buffer;
   UINTN                     Size;
   UINTN                     Sector; ///< 512 bytes sector.
+  BOOLEAN                   IsWrite;
 
-  grant_ref_t               GrantRef[BLKIF_MAX_SEGMENTS_PER_REQUEST];
+  grant_ref_t               GrantRef[XEN_BLOCK_FRONT_MAX_SEGMENTS];
   INT32                     NumRef;
 
+  //
+  // Pages of the pool used by the request: the persistent data pages
+  // first, then the indirect page.
+  //
+  XEN_BLOCK_FRONT_GRANT     *Grants[XEN_BLOCK_FRONT_MAX_SEGMENTS + 1];
+  INT32                     NumGrants;
+  INT32                     NumDataGrants;
+
   EFI_STATUS                Status;
 };
 
@@ -34,6 +72,8 @@ typedef struct {
   BOOLEAN    CdRom;
   BOOLEAN    FeatureBarrier;
   BOOLEAN    FeatureFlushCache;
+  BOOLEAN    FeaturePersistent;
+  UINT32     MaxSegments;   ///< Segments per request, more than BLKIF_MAX_SEGMENTS_PER_REQUEST is indirect.
 } XEN_BLOCK_FRONT_MEDIA_INFO;
 
 #define XEN_BLOCK_FRONT_SIGNATURE  SIGNATURE_32 ('X', 'p', 'v', 'B')
@@ -43,7 +83,8 @@ struct _XEN_BLOCK_FRONT_DEVICE {
   domid_t                       DomainId;
 
   blkif_front_ring_t            Ring;
-  grant_ref_t                   RingRef;
+  UINT32                        RingPageOrder;
+  grant_ref_t                   RingRef[XEN_BLOCK_FRONT_MAX_RING_PAGES];
   evtchn_port_t                 EventChannel;
   blkif_vdev_t                  DeviceId;
 
@@ -53,6 +94,13 @@ struct _XEN_BLOCK_FRONT_DEVICE {
   VOID                          *StateWatchToken;
 
   XENBUS_PROTOCOL               *XenBusIo;
+
+  //
+  // Pool of granted pages. The pages beyond what two requests
+  // use are released when they are returned to the pool.
+  //
+  LIST_ENTRY                    FreeGrants;
+  UINTN                         NumGrants;
 };
 
 #define XEN_BLOCK_FRONT_FROM_BLOCK_IO(b) \
@@ -76,6 +76,7 @@ XenPvBlkDxeBlockIoReadWriteBlocks (
   XEN_BLOCK_FRONT_IO  IoData;
   EFI_BLOCK_IO_MEDIA  *Media = This->Media;
   UINTN               Sector;
+  UINTN               MaxSegments;
   EFI_STATUS          Status;
 
   if (Buffer == NULL) {
@@ -150,18 +151,25 @@ XenPvBlkDxeBlockIoReadWriteBlocks (
     return Status;
   }
 
-  IoData.Dev = XEN_BLOCK_FRONT_FROM_BLOCK_IO (This);
-  Sector     = (UINTN)MultU64x32 (Lba, Media->BlockSize / 512);
+  IoData.Dev  = XEN_BLOCK_FRONT_FROM_BLOCK_IO (This);
+  Sector      = (UINTN)MultU64x32 (Lba, Media->BlockSize / 512);
+  MaxSegments = IoData.Dev->MediaInfo.MaxSegments;
 
   while (BufferSize > 0) {
-    if (((UINTN)Buffer & EFI_PAGE_MASK) == 0) {
+    //
+    // With persistent grants, the data is packed in the pages of the pool,
+    // so the alignment of the buffer doesn't matter.
+    //
+    if (IoData.Dev->MediaInfo.FeaturePersistent ||
+        (((UINTN)Buffer & EFI_PAGE_MASK) == 0))
+    {
       IoData.Size = MIN (
-                      BLKIF_MAX_SEGMENTS_PER_REQUEST * EFI_PAGE_SIZE,
+                      MaxSegments * EFI_PAGE_SIZE,
                       BufferSize
                       );
     } else {
       IoData.Size = MIN (
-                      (BLKIF_MAX_SEGMENTS_PER_REQUEST - 1) * EFI_PAGE_SIZE,
+                      (MaxSegments - 1) * EFI_PAGE_SIZE,
                       BufferSize
                       );
     }
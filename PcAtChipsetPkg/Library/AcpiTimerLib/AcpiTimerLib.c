@@ -14,11 +14,20 @@
 #include <Library/IoLib.h>
 #include <Library/DebugLib.h>
 #include <IndustryStandard/Acpi.h>
+#include <Register/Intel/Cpuid.h>
 
 GUID  mFrequencyHobGuid = {
   0x3fca54f6, 0xe1a2, 0x4b20, { 0xbe, 0x76, 0x92, 0x6b, 0x4b, 0x48, 0xbf, 0xaa }
 };
 
+//
+// The CPUID leaves of the hypervisors: EAX of the first one is the largest
+// hypervisor leaf, and EAX of the timing leaf, that KVM, VMware and other
+// hypervisors provide, is the TSC frequency in kHz.
+//
+#define CPUID_HYPERVISOR_INFORMATION  0x40000000
+#define CPUID_HYPERVISOR_TIMING       0x40000010
+
 /**
   Internal function to retrieves the 64-bit frequency in Hz.
 
@@ -337,11 +346,61 @@ GetTimeInNanoSecond (
   return NanoSeconds;
 }
 
+/**
+  Get the exact TSC frequency that CPUID enumerates: the timing leaf of the
+  hypervisor in a virtual machine, else the crystal clock frequency and ratio
+  of leaf 0x15.
+
+  @return The number of TSC counts per second, 0 if CPUID does not enumerate
+          it.
+
+**/
+STATIC
+UINT64
+InternalCpuidTscFrequency (
+  VOID
+  )
+{
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
+  UINT32                  MaxLeaf;
+  UINT32                  RegEax;
+  UINT32                  RegEbx;
+  UINT32                  RegEcx;
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+  if (VersionInfoEcx.Bits.ParaVirtualized != 0) {
+    AsmCpuid (CPUID_HYPERVISOR_INFORMATION, &MaxLeaf, NULL, NULL, NULL);
+    if ((MaxLeaf >= CPUID_HYPERVISOR_TIMING) && (MaxLeaf < CPUID_HYPERVISOR_INFORMATION + 0x100)) {
+      AsmCpuid (CPUID_HYPERVISOR_TIMING, &RegEax, NULL, NULL, NULL);
+      if (RegEax != 0) {
+        return MultU64x32 (RegEax, 1000);
+      }
+    }
+  }
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_TIME_STAMP_COUNTER) {
+    return 0;
+  }
+
+  //
+  // TSC frequency = ECX * EBX / EAX, when the leaf enumerates the crystal
+  // clock frequency in ECX and its ratio to the TSC in EBX / EAX.
+  //
+  AsmCpuid (CPUID_TIME_STAMP_COUNTER, &RegEax, &RegEbx, &RegEcx, NULL);
+  if ((RegEax == 0) || (RegEbx == 0) || (RegEcx == 0)) {
+    return 0;
+  }
+
+  return DivU64x32 (MultU64x32 (RegEcx, RegEbx) + (UINT64)(RegEax >> 1), RegEax);
+}
+
 /**
   Calculate TSC frequency.
 
-  The TSC counting frequency is determined by comparing how far it counts
-  during a 101.4 us period as determined by the ACPI timer.
+  The TSC frequency is read from CPUID when it enumerates it, which takes no
+  time. Otherwise, the TSC counting frequency is determined by comparing how
+  far it counts during a 101.4 us period as determined by the ACPI timer.
   The ACPI timer is used because it counts at a known frequency.
   The TSC is sampled, followed by waiting 363 counts of the ACPI timer,
   or 101.4 us. The TSC is then sampled again. The difference multiplied by
@@ -364,6 +423,11 @@ InternalCalculateTscFrequency (
   UINT64   TscFrequency;
   BOOLEAN  InterruptState;
 
+  TscFrequency = InternalCpuidTscFrequency ();
+  if (TscFrequency != 0) {
+    return TscFrequency;
+  }
+
   InterruptState = SaveAndDisableInterrupts ();
 
   TimerAddr = InternalAcpiGetAcpiTimerIoPort ();
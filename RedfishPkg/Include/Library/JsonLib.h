@@ -817,6 +817,67 @@ JsonLoadBuffer (
   IN OUT EDKII_JSON_ERROR  *Error
   );
 
+/**
+  The function called by JsonLoadBufferStream() for each element of a streamed
+  array.
+
+  @param[in]   Key           The key of the top level object member holding the
+                             array, or NULL for the elements of a top level array.
+  @param[in]   Index         The index of the element in the array.
+  @param[in]   Element       The element. It is released when the function returns,
+                             use JsonIncreaseReference() to keep it.
+  @param[in]   Context       The context given to JsonLoadBufferStream().
+
+  @retval      EFI_SUCCESS   Continue the loading.
+  @retval      Others        Stop the loading, JsonLoadBufferStream() returns NULL.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_JSON_STREAM_CALLBACK)(
+  IN CONST CHAR8       *Key OPTIONAL,
+  IN UINTN             Index,
+  IN EDKII_JSON_VALUE  Element,
+  IN VOID              *Context
+  );
+
+/**
+  Load JSON from a buffer, streaming the elements of its arrays to a callback.
+
+  The buffer holds a JSON object or array. The elements of a top level array,
+  and of the arrays held by the members of a top level object, such as the
+  "Members" of a Redfish collection, are passed to Callback one at a time
+  while the buffer is parsed. They are not kept in the returned value, where
+  the arrays are left empty, so the memory needed to load a large collection
+  is bounded by the size of its largest element.
+
+  @param[in]   Buffer        Buffer to the JSON payload.
+  @param[in]   BufferLen     Length of the buffer.
+  @param[in]   Flags         Flag of loading JSON buffer, the value
+                             could be the combination of below flags.
+                               - EDKII_JSON_REJECT_DUPLICATES
+                               - EDKII_JSON_DISABLE_EOF_CHECK
+                               - EDKII_JSON_DECODE_INT_AS_REAL
+                               - EDKII_JSON_ALLOW_NUL
+  @param[in]   Callback      The function called for each streamed element.
+  @param[in]   Context       The context passed to Callback.
+
+  @param[in,out]   Error     Pointer EDKII_JSON_ERROR structure
+
+  @retval      EDKII_JSON_VALUE  The top level value without the streamed elements.
+                                 NULL means fail to load JSON payload, or Callback
+                                 stopped the loading.
+**/
+EDKII_JSON_VALUE
+EFIAPI
+JsonLoadBufferStream (
+  IN    CONST CHAR8                 *Buffer,
+  IN    UINTN                       BufferLen,
+  IN    UINTN                       Flags,
+  IN    EDKII_JSON_STREAM_CALLBACK  Callback,
+  IN    VOID                        *Context,
+  IN OUT EDKII_JSON_ERROR           *Error
+  );
+
 /**
   The reference count is used to track whether a value is still in use or not.
   When a value is created, it's reference count is set to 1.
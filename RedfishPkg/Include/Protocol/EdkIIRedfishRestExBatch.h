@@ -0,0 +1,71 @@
+/** @file
+  This file defines the EDKII_REDFISH_REST_EX_BATCH_PROTOCOL interface.
+
+  The protocol is installed by the Redfish REST EX driver next to each
+  EFI_REST_EX_PROTOCOL instance. It lets a REST client submit several requests
+  at once, so that the driver can pipeline them on the HTTP connection of the
+  instance instead of waiting for each response before sending the next
+  request.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_REDFISH_REST_EX_BATCH_H_
+#define EDKII_REDFISH_REST_EX_BATCH_H_
+
+#include <Protocol/Http.h>
+
+typedef struct _EDKII_REDFISH_REST_EX_BATCH_PROTOCOL EDKII_REDFISH_REST_EX_BATCH_PROTOCOL;
+
+#define EDKII_REDFISH_REST_EX_BATCH_PROTOCOL_GUID \
+    {  \
+      0x5d8f6c36, 0x1b7e, 0x4b5a, { 0x9c, 0x2e, 0x83, 0x47, 0xa1, 0x6d, 0x0f, 0xb9 }  \
+    }
+
+#define EDKII_REDFISH_REST_EX_BATCH_PROTOCOL_REVISION  0x00010000
+
+/**
+  Send a batch of HTTP requests to the REST service of a REST EX instance, and
+  return the responses in the order of the requests.
+
+  Each pair of RequestMessages[Index] and ResponseMessages[Index] is processed
+  as by EFI_REST_EX_PROTOCOL.SendReceive(), and the result of that request is
+  returned in Statuses[Index]. Consecutive GET requests may be sent before their
+  responses are received, up to the pipeline depth the platform configured.
+  The other requests are always sent one at a time.
+
+  The caller must zero the ResponseMessages entries before the call, and free
+  the headers and the body of every response afterwards.
+
+  @param[in]   This               Pointer to the EDKII_REDFISH_REST_EX_BATCH_PROTOCOL instance.
+  @param[in]   Count              The number of requests in the batch.
+  @param[in]   RequestMessages    The array of Count HTTP requests.
+  @param[out]  ResponseMessages   The array of Count HTTP responses.
+  @param[out]  Statuses           The array of Count statuses of the requests.
+
+  @retval EFI_SUCCESS             All the requests were processed. Statuses
+                                  holds the result of each of them.
+  @retval EFI_INVALID_PARAMETER   This, RequestMessages, ResponseMessages or Statuses
+                                  is NULL, or Count is zero.
+  @retval EFI_NO_MEDIA            There is no media on the network interface.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_REDFISH_REST_EX_SEND_RECEIVE_BATCH)(
+  IN     EDKII_REDFISH_REST_EX_BATCH_PROTOCOL  *This,
+  IN     UINTN                                 Count,
+  IN     EFI_HTTP_MESSAGE                      *RequestMessages,
+  OUT    EFI_HTTP_MESSAGE                      *ResponseMessages,
+  OUT    EFI_STATUS                            *Statuses
+  );
+
+struct _EDKII_REDFISH_REST_EX_BATCH_PROTOCOL {
+  UINT32                                      Revision;
+  EDKII_REDFISH_REST_EX_SEND_RECEIVE_BATCH    SendReceiveBatch;
+};
+
+extern EFI_GUID  gEdkIIRedfishRestExBatchProtocolGuid;
+
+#endif
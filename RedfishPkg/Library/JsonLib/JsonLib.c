@@ -21,6 +21,31 @@
 
 extern volatile UINT32  hashtable_seed;
 
+//
+// The streamed loader in load.c, the edk2 override of the jansson loader.
+//
+typedef int (*json_element_callback_t)(
+  const char  *key,
+  size_t      index,
+  json_t      *element,
+  void        *data
+  );
+
+json_t *
+json_loadb_stream (
+  const char               *buffer,
+  size_t                   buflen,
+  size_t                   flags,
+  json_element_callback_t  callback,
+  void                     *data,
+  json_error_t             *error
+  );
+
+typedef struct {
+  EDKII_JSON_STREAM_CALLBACK    Callback;
+  VOID                          *Context;
+} JSON_STREAM_CONTEXT;
+
 /**
   The function is used to initialize a JSON value which contains a new JSON array,
   or NULL on error. Initially, the array is empty.
@@ -1004,6 +1029,74 @@ JsonLoadBuffer (
   return json_loadb (Buffer, BufferLen, Flags, (json_error_t *)Error);
 }
 
+/**
+  Forward an element of a streamed array to the callback of JsonLoadBufferStream().
+
+  @param[in]   Key           The key of the member holding the array, or NULL.
+  @param[in]   Index         The index of the element in the array.
+  @param[in]   Element       The element.
+  @param[in]   Data          Pointer to JSON_STREAM_CONTEXT.
+
+  @retval      0             Continue the loading.
+  @retval      -1            Stop the loading.
+**/
+STATIC
+int
+JsonStreamElement (
+  const char  *Key,
+  size_t      Index,
+  json_t      *Element,
+  void        *Data
+  )
+{
+  JSON_STREAM_CONTEXT  *StreamContext;
+
+  StreamContext = (JSON_STREAM_CONTEXT *)Data;
+  if (EFI_ERROR (StreamContext->Callback (Key, Index, (EDKII_JSON_VALUE)Element, StreamContext->Context))) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Load JSON from a buffer, streaming the elements of its arrays to a callback.
+
+  See JsonLib.h for the details.
+
+  @param[in]       Buffer        Buffer to the JSON payload.
+  @param[in]       BufferLen     Length of the buffer.
+  @param[in]       Flags         Flag of loading JSON buffer, see JsonLoadBuffer().
+  @param[in]       Callback      The function called for each streamed element.
+  @param[in]       Context       The context passed to Callback.
+  @param[in,out]   Error         Pointer EDKII_JSON_ERROR structure.
+
+  @retval      EDKII_JSON_VALUE  NULL means fail to load JSON payload, or Callback
+                                 stopped the loading.
+**/
+EDKII_JSON_VALUE
+EFIAPI
+JsonLoadBufferStream (
+  IN    CONST CHAR8                 *Buffer,
+  IN    UINTN                       BufferLen,
+  IN    UINTN                       Flags,
+  IN    EDKII_JSON_STREAM_CALLBACK  Callback,
+  IN    VOID                        *Context,
+  IN OUT EDKII_JSON_ERROR           *Error
+  )
+{
+  JSON_STREAM_CONTEXT  StreamContext;
+
+  if (Callback == NULL) {
+    return NULL;
+  }
+
+  StreamContext.Callback = Callback;
+  StreamContext.Context  = Context;
+
+  return json_loadb_stream (Buffer, BufferLen, Flags, JsonStreamElement, &StreamContext, (json_error_t *)Error);
+}
+
 /**
   The reference count is used to track whether a value is still in use or not.
   When a value is created, it's reference count is set to 1.
@@ -1236,6 +1236,244 @@ json_loadb (
   return result;
 }
 
+/*
+ * edk2: streamed loading. The elements of the top level array, or of the
+ * arrays held by the members of the top level object, are handed to a
+ * callback one at a time and released, instead of being kept in the tree.
+ * The memory needed to load a large collection is then bounded by the size
+ * of its largest member.
+ */
+typedef int (*json_element_callback_t)(
+  const char  *key,
+  size_t      index,
+  json_t      *element,
+  void        *data
+  );
+
+static json_t *
+parse_streamed_array (
+  lex_t                    *lex,
+  const char               *key,
+  size_t                   flags,
+  json_element_callback_t  callback,
+  void                     *data,
+  json_error_t             *error
+  )
+{
+  json_t  *elem;
+  size_t  index;
+
+  lex->depth++;
+  if (lex->depth > JSON_PARSER_MAX_DEPTH) {
+    error_set (error, lex, json_error_stack_overflow, "maximum parsing depth reached");
+    return NULL;
+  }
+
+  lex_scan (lex, error);
+  if (lex->token == ']') {
+    lex->depth--;
+    return json_array ();
+  }
+
+  index = 0;
+  while (lex->token) {
+    elem = parse_value (lex, flags, error);
+    if (!elem) {
+      return NULL;
+    }
+
+    if (callback (key, index, elem, data)) {
+      json_decref (elem);
+      error_set (error, lex, json_error_unknown, "stopped by the element callback");
+      return NULL;
+    }
+
+    json_decref (elem);
+    index++;
+
+    lex_scan (lex, error);
+    if (lex->token != ',') {
+      break;
+    }
+
+    lex_scan (lex, error);
+  }
+
+  if (lex->token != ']') {
+    error_set (error, lex, json_error_invalid_syntax, "']' expected");
+    return NULL;
+  }
+
+  lex->depth--;
+  return json_array ();
+}
+
+static json_t *
+parse_streamed_object (
+  lex_t                    *lex,
+  size_t                   flags,
+  json_element_callback_t  callback,
+  void                     *data,
+  json_error_t             *error
+  )
+{
+  json_t  *object = json_object ();
+
+  if (!object) {
+    return NULL;
+  }
+
+  lex->depth++;
+
+  lex_scan (lex, error);
+  if (lex->token == '}') {
+    return object;
+  }
+
+  while (1) {
+    char    *key;
+    size_t  len;
+    json_t  *value;
+
+    if (lex->token != TOKEN_STRING) {
+      error_set (error, lex, json_error_invalid_syntax, "string or '}' expected");
+      goto error;
+    }
+
+    key = lex_steal_string (lex, &len);
+    if (!key) {
+      goto error;
+    }
+
+    if (memchr (key, '\0', len)) {
+      jsonp_free (key);
+      error_set (
+        error,
+        lex,
+        json_error_null_byte_in_key,
+        "NUL byte in object key not supported"
+        );
+      goto error;
+    }
+
+    if (flags & JSON_REJECT_DUPLICATES) {
+      if (json_object_get (object, key)) {
+        jsonp_free (key);
+        error_set (error, lex, json_error_duplicate_key, "duplicate object key");
+        goto error;
+      }
+    }
+
+    lex_scan (lex, error);
+    if (lex->token != ':') {
+      jsonp_free (key);
+      error_set (error, lex, json_error_invalid_syntax, "':' expected");
+      goto error;
+    }
+
+    lex_scan (lex, error);
+    if (lex->token == '[') {
+      value = parse_streamed_array (lex, key, flags, callback, data, error);
+    } else {
+      value = parse_value (lex, flags, error);
+    }
+
+    if (!value) {
+      jsonp_free (key);
+      goto error;
+    }
+
+    if (json_object_set_new_nocheck (object, key, value)) {
+      jsonp_free (key);
+      goto error;
+    }
+
+    jsonp_free (key);
+
+    lex_scan (lex, error);
+    if (lex->token != ',') {
+      break;
+    }
+
+    lex_scan (lex, error);
+  }
+
+  if (lex->token != '}') {
+    error_set (error, lex, json_error_invalid_syntax, "'}' expected");
+    goto error;
+  }
+
+  return object;
+
+error:
+  json_decref (object);
+  return NULL;
+}
+
+json_t *
+json_loadb_stream (
+  const char               *buffer,
+  size_t                   buflen,
+  size_t                   flags,
+  json_element_callback_t  callback,
+  void                     *data,
+  json_error_t             *error
+  )
+{
+  lex_t          lex;
+  json_t         *result;
+  buffer_data_t  stream_data;
+
+  jsonp_error_init (error, "<buffer>");
+
+  if ((buffer == NULL) || (callback == NULL)) {
+    error_set (error, NULL, json_error_invalid_argument, "wrong arguments");
+    return NULL;
+  }
+
+  stream_data.data = buffer;
+  stream_data.pos  = 0;
+  stream_data.len  = buflen;
+
+  if (lex_init (&lex, buffer_get, flags, (void *)&stream_data)) {
+    return NULL;
+  }
+
+  lex.depth = 0;
+
+  lex_scan (&lex, error);
+  if (lex.token == '{') {
+    result = parse_streamed_object (&lex, flags, callback, data, error);
+  } else if (lex.token == '[') {
+    result = parse_streamed_array (&lex, NULL, flags, callback, data, error);
+  } else {
+    error_set (error, &lex, json_error_invalid_syntax, "'[' or '{' expected");
+    result = NULL;
+  }
+
+  if (result && !(flags & JSON_DISABLE_EOF_CHECK)) {
+    lex_scan (&lex, error);
+    if (lex.token != TOKEN_EOF) {
+      error_set (
+        error,
+        &lex,
+        json_error_end_of_input_expected,
+        "end of file expected"
+        );
+      json_decref (result);
+      result = NULL;
+    }
+  }
+
+  if (result && error) {
+    /* Save the position even though there was no error */
+    error->position = (int)lex.stream.position;
+  }
+
+  lex_close (&lex);
+  return result;
+}
+
 json_t *
 json_loadf (
   FILE          *input,
@@ -356,6 +356,100 @@ RedfishGetByUri (
   return EFI_SUCCESS;
 }
 
+/**
+  Get a redfish response addressed by URI, unless the resource still has the
+  given ETag.
+
+  The request carries the ETag in an If-None-Match header. A Redfish service
+  that finds the resource unchanged answers 304 Not Modified without a body,
+  and the caller can skip loading and applying it. Otherwise the resource is
+  returned as by RedfishGetByUri(), with its new ETag, if any, as the only
+  header of the response.
+
+  Callers are responsible for freeing the HTTP StatusCode, Headers and Payload returned in
+  redfish response data.
+
+  @param[in]    RedfishService    The Service to access the URI resources.
+  @param[in]    Uri               String to address a resource.
+  @param[in]    Etag              The ETag of the copy of the resource the caller has.
+  @param[out]   RedResponse       Pointer to the Redfish response data.
+
+  @retval EFI_SUCCESS             The operation is successful, indicates the HTTP StatusCode is not
+                                  NULL and the value is 2XX or 304. If it is 304, the resource did not
+                                  change and Payload is NULL. Otherwise the corresponding redfish
+                                  resource has been returned in Payload within RedResponse.
+  @retval EFI_INVALID_PARAMETER   RedfishService, Uri, Etag, or RedResponse is NULL.
+  @retval EFI_DEVICE_ERROR        An unexpected system or network error occurred. Callers can get
+                                  more error info from returned HTTP StatusCode and Payload
+                                  within RedResponse:
+                                  1. If the returned Payload is NULL, indicates any error happen.
+                                  2. If the returned StatusCode is NULL, indicates any error happen.
+                                  3. If the returned StatusCode is not 2XX, indicates any error happen.
+**/
+EFI_STATUS
+EFIAPI
+RedfishGetByUriIfNoneMatch (
+  IN     REDFISH_SERVICE   RedfishService,
+  IN     CONST CHAR8       *Uri,
+  IN     CONST CHAR8       *Etag,
+  OUT    REDFISH_RESPONSE  *RedResponse
+  )
+{
+  EDKII_JSON_VALUE  JsonValue;
+  CHAR8             *NewEtag;
+  EFI_HTTP_HEADER   *Headers;
+  EFI_STATUS        Status;
+
+  if ((RedfishService == NULL) || (Uri == NULL) || (Etag == NULL) || (RedResponse == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (RedResponse, sizeof (REDFISH_RESPONSE));
+
+  NewEtag   = NULL;
+  JsonValue = getUriFromServiceEx (RedfishService, Uri, Etag, &RedResponse->StatusCode, &NewEtag);
+  if ((RedResponse->StatusCode != NULL) && (*(RedResponse->StatusCode) == HTTP_STATUS_304_NOT_MODIFIED)) {
+    if (JsonValue != NULL) {
+      JsonValueFree (JsonValue);
+    }
+
+    if (NewEtag != NULL) {
+      FreePool (NewEtag);
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  RedResponse->Payload = createRedfishPayload (JsonValue, RedfishService);
+
+  if (NewEtag != NULL) {
+    Headers = AllocateZeroPool (sizeof (EFI_HTTP_HEADER));
+    if (Headers != NULL) {
+      Status = HttpSetFieldNameAndValue (Headers, HTTP_HEADER_ETAG, NewEtag);
+      if (EFI_ERROR (Status)) {
+        HttpFreeHeaderFields (Headers, 1);
+      } else {
+        RedResponse->HeaderCount = 1;
+        RedResponse->Headers     = Headers;
+      }
+    }
+
+    FreePool (NewEtag);
+  }
+
+  if ((RedResponse->Payload == NULL) || (RedResponse->StatusCode == NULL)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((*(RedResponse->StatusCode) < HTTP_STATUS_200_OK) || \
+      (*(RedResponse->StatusCode) > HTTP_STATUS_206_PARTIAL_CONTENT))
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Get a redfish response addressed by the input Payload and relative RedPath string,
   including HTTP StatusCode, Headers and Payload which record any HTTP response messages.
@@ -104,6 +104,15 @@ getUriFromService (
   EFI_HTTP_STATUS_CODE  **StatusCode
   );
 
+json_t *
+getUriFromServiceEx (
+  redfishService        *service,
+  const char            *uri,
+  const char            *ifNoneMatch,
+  EFI_HTTP_STATUS_CODE  **StatusCode,
+  char                  **etag
+  );
+
 json_t *
 patchUriFromService (
   redfishService        *service,
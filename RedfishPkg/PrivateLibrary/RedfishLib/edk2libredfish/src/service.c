@@ -402,10 +402,12 @@ ON_EXIT:
 }
 
 json_t *
-getUriFromService (
+getUriFromServiceEx (
   redfishService        *service,
   const char            *uri,
-  EFI_HTTP_STATUS_CODE  **StatusCode
+  const char            *ifNoneMatch,
+  EFI_HTTP_STATUS_CODE  **StatusCode,
+  char                  **etag
   )
 {
   char                   *url;
@@ -416,12 +418,16 @@ getUriFromService (
   EFI_HTTP_MESSAGE       *RequestMsg  = NULL;
   EFI_HTTP_MESSAGE       ResponseMsg;
   EFI_HTTP_HEADER        *ContentEncodedHeader;
+  EFI_HTTP_HEADER        *EtagHeader;
 
   if ((service == NULL) || (uri == NULL) || (StatusCode == NULL)) {
     return NULL;
   }
 
   *StatusCode = NULL;
+  if (etag != NULL) {
+    *etag = NULL;
+  }
 
   url = makeUrlForService (service, uri);
   if (!url) {
@@ -433,12 +439,17 @@ getUriFromService (
   //
   // Step 1: Create HTTP request message with 4 headers:
   //
-  HttpIoHeader = HttpIoCreateHeader ((service->sessionToken || service->basicAuthStr) ? 6 : 5);
+  HttpIoHeader = HttpIoCreateHeader (((service->sessionToken || service->basicAuthStr) ? 6 : 5) + ((ifNoneMatch != NULL) ? 1 : 0));
   if (HttpIoHeader == NULL) {
     ret = NULL;
     goto ON_EXIT;
   }
 
+  if (ifNoneMatch != NULL) {
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_IF_NONE_MATCH, (char *)ifNoneMatch);
+    ASSERT_EFI_ERROR (Status);
+  }
+
   if (service->sessionToken) {
     Status = HttpIoSetHeader (HttpIoHeader, "X-Auth-Token", service->sessionToken);
     ASSERT_EFI_ERROR (Status);
@@ -510,6 +521,13 @@ getUriFromService (
     **StatusCode = ResponseMsg.Data.Response->StatusCode;
   }
 
+  if (etag != NULL) {
+    EtagHeader = HttpFindHeader (ResponseMsg.HeaderCount, ResponseMsg.Headers, HTTP_HEADER_ETAG);
+    if (EtagHeader != NULL) {
+      *etag = AllocateCopyPool (AsciiStrSize (EtagHeader->FieldValue), EtagHeader->FieldValue);
+    }
+  }
+
   if ((ResponseMsg.BodyLength != 0) && (ResponseMsg.Body != NULL)) {
     //
     // Check if data is encoded.
@@ -557,6 +575,16 @@ ON_EXIT:
   return ret;
 }
 
+json_t *
+getUriFromService (
+  redfishService        *service,
+  const char            *uri,
+  EFI_HTTP_STATUS_CODE  **StatusCode
+  )
+{
+  return getUriFromServiceEx (service, uri, NULL, StatusCode, NULL);
+}
+
 json_t *
 patchUriFromService (
   redfishService        *service,
@@ -114,6 +114,7 @@ RestExCreateInstance (
   RestExIns->Service   = Service;
 
   CopyMem (&RestExIns->RestEx, &mRedfishRestExProtocol, sizeof (RestExIns->RestEx));
+  CopyMem (&RestExIns->RestExBatch, &mRedfishRestExBatchProtocol, sizeof (RestExIns->RestExBatch));
 
   //
   // Create a HTTP_IO to access the HTTP service.
@@ -631,12 +632,14 @@ RedfishRestExServiceBindingCreateChild (
   ASSERT (Instance != NULL);
 
   //
-  // Install the RestEx protocol onto ChildHandle
+  // Install the RestEx protocols onto ChildHandle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   ChildHandle,
                   &gEfiRestExProtocolGuid,
                   &Instance->RestEx,
+                  &gEdkIIRedfishRestExBatchProtocolGuid,
+                  &Instance->RestExBatch,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -661,6 +664,8 @@ RedfishRestExServiceBindingCreateChild (
            Instance->ChildHandle,
            &gEfiRestExProtocolGuid,
            &Instance->RestEx,
+           &gEdkIIRedfishRestExBatchProtocolGuid,
+           &Instance->RestExBatch,
            NULL
            );
 
@@ -693,6 +698,8 @@ RedfishRestExServiceBindingCreateChild (
            Instance->ChildHandle,
            &gEfiRestExProtocolGuid,
            &Instance->RestEx,
+           &gEdkIIRedfishRestExBatchProtocolGuid,
+           &Instance->RestExBatch,
            NULL
            );
 
@@ -804,12 +811,15 @@ RedfishRestExServiceBindingDestroyChild (
   gBS->RestoreTPL (OldTpl);
 
   //
-  // Uninstall the RestEx protocol first to enable a top down destruction.
+  // Uninstall the RestEx protocols first to enable a top down destruction.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   ChildHandle,
                   &gEfiRestExProtocolGuid,
-                  RestEx
+                  RestEx,
+                  &gEdkIIRedfishRestExBatchProtocolGuid,
+                  &Instance->RestExBatch,
+                  NULL
                   );
 
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
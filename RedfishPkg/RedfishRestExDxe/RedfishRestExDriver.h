@@ -30,6 +30,7 @@
 /// UEFI Driver Model Protocols
 ///
 #include <Protocol/DriverBinding.h>
+#include <Protocol/EdkIIRedfishRestExBatch.h>
 #include <Protocol/RestEx.h>
 #include <Protocol/ServiceBinding.h>
 
@@ -43,6 +44,8 @@ extern EFI_UNICODE_STRING_TABLE      *gRedfishRestExControllerNameTable;
 extern EFI_DRIVER_BINDING_PROTOCOL   gRedfishRestExDriverBinding;
 extern EFI_SERVICE_BINDING_PROTOCOL  mRedfishRestExServiceBinding;
 extern EFI_REST_EX_PROTOCOL          mRedfishRestExProtocol;
+
+extern EDKII_REDFISH_REST_EX_BATCH_PROTOCOL  mRedfishRestExBatchProtocol;
 ///
 /// RestEx service block
 ///
@@ -67,6 +70,9 @@ typedef struct _RESTEX_INSTANCE RESTEX_INSTANCE;
 #define RESTEX_INSTANCE_FROM_THIS(a)  \
   CR (a, RESTEX_INSTANCE, RestEx, RESTEX_INSTANCE_SIGNATURE)
 
+#define RESTEX_INSTANCE_FROM_BATCH(a)  \
+  CR (a, RESTEX_INSTANCE, RestExBatch, RESTEX_INSTANCE_SIGNATURE)
+
 #define RESTEX_STATE_UNCONFIGED  0
 #define RESTEX_STATE_CONFIGED    1
 
@@ -94,25 +100,26 @@ struct _RESTEX_SERVICE {
 #define RESTEX_INSTANCE_FLAGS_TCP_ERROR_RETRY  0x00000002
 
 struct _RESTEX_INSTANCE {
-  UINT32                     Signature;
-  LIST_ENTRY                 Link;
+  UINT32                                  Signature;
+  LIST_ENTRY                              Link;
 
-  EFI_REST_EX_PROTOCOL       RestEx;
+  EFI_REST_EX_PROTOCOL                    RestEx;
+  EDKII_REDFISH_REST_EX_BATCH_PROTOCOL    RestExBatch;
 
-  INTN                       State;
-  BOOLEAN                    InDestroy;
+  INTN                                    State;
+  BOOLEAN                                 InDestroy;
 
-  RESTEX_SERVICE             *Service;
-  EFI_HANDLE                 ChildHandle;
+  RESTEX_SERVICE                          *Service;
+  EFI_HANDLE                              ChildHandle;
 
-  EFI_REST_EX_CONFIG_DATA    ConfigData;
+  EFI_REST_EX_CONFIG_DATA                 ConfigData;
 
   //
   // HTTP_IO to access the HTTP service
   //
-  HTTP_IO                    HttpIo;
+  HTTP_IO                                 HttpIo;
 
-  UINT32                     Flags;
+  UINT32                                  Flags;
 };
 
 typedef struct {
@@ -167,3 +167,163 @@ RedfishHttpAddExpectation (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Receive the response of a request that was sent ahead on the HTTP connection
+  of a REST EX instance.
+
+  The whole message is received, including its body, so that the response of
+  the next pipelined request starts on a message boundary. The interim 100
+  Continue responses are skipped.
+
+  @param[in]   Instance          Pointer to the REST EX instance.
+  @param[out]  ResponseMessage   The HTTP response. On success the caller frees
+                                 its response data, headers and body.
+
+  @retval EFI_SUCCESS            The response was received, whatever its HTTP
+                                 status code.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to receive the response.
+  @retval Others                 The HTTP connection failed, ResponseMessage is
+                                 cleared.
+
+**/
+EFI_STATUS
+RedfishRestExReceiveMessage (
+  IN  RESTEX_INSTANCE   *Instance,
+  OUT EFI_HTTP_MESSAGE  *ResponseMessage
+  )
+{
+  EFI_STATUS             Status;
+  HTTP_IO_RESPONSE_DATA  ResponseData;
+  LIST_ENTRY             *ChunkListLink;
+  HTTP_IO_CHUNKS         *ThisChunk;
+  UINTN                  TotalReceivedSize;
+
+  ZeroMem (ResponseMessage, sizeof (EFI_HTTP_MESSAGE));
+
+  while (TRUE) {
+    ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+    Status = HttpIoRecvResponse (&(Instance->HttpIo), TRUE, &ResponseData);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (ResponseData.Response.StatusCode != HTTP_STATUS_100_CONTINUE) {
+      break;
+    }
+
+    if (ResponseData.Headers != NULL) {
+      FreePool (ResponseData.Headers);
+    }
+  }
+
+  ResponseMessage->HeaderCount = ResponseData.HeaderCount;
+  ResponseMessage->Headers     = ResponseData.Headers;
+
+  ResponseMessage->Data.Response = AllocateZeroPool (sizeof (EFI_HTTP_RESPONSE_DATA));
+  if (ResponseMessage->Data.Response == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  ResponseMessage->Data.Response->StatusCode = ResponseData.Response.StatusCode;
+  if ((ResponseData.Response.StatusCode == HTTP_STATUS_204_NO_CONTENT) ||
+      (ResponseData.Response.StatusCode == HTTP_STATUS_304_NOT_MODIFIED))
+  {
+    return EFI_SUCCESS;
+  }
+
+  Status = HttpIoGetContentLength (ResponseMessage->HeaderCount, ResponseMessage->Headers, &ResponseMessage->BodyLength);
+  if (Status == EFI_NOT_FOUND) {
+    //
+    // Without Content-Length, the body is either chunked or empty.
+    //
+    ResponseMessage->BodyLength = 0;
+    Status                      = HttpIoGetChunkedTransferContent (
+                                    &(Instance->HttpIo),
+                                    ResponseMessage->HeaderCount,
+                                    ResponseMessage->Headers,
+                                    &ChunkListLink,
+                                    &ResponseMessage->BodyLength
+                                    );
+    if (Status == EFI_NOT_FOUND) {
+      return EFI_SUCCESS;
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    if (ResponseMessage->BodyLength != 0) {
+      ResponseMessage->Body = AllocateZeroPool (ResponseMessage->BodyLength);
+      if (ResponseMessage->Body == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+      }
+    }
+
+    TotalReceivedSize = 0;
+    while (!IsListEmpty (ChunkListLink)) {
+      ThisChunk = (HTTP_IO_CHUNKS *)GetFirstNode (ChunkListLink);
+      if (ResponseMessage->Body != NULL) {
+        CopyMem ((UINT8 *)ResponseMessage->Body + TotalReceivedSize, ThisChunk->Data, ThisChunk->Length);
+        TotalReceivedSize += ThisChunk->Length;
+      }
+
+      RemoveEntryList (&ThisChunk->NextChunk);
+      FreePool ((VOID *)ThisChunk->Data);
+      FreePool ((VOID *)ThisChunk);
+    }
+
+    FreePool ((VOID *)ChunkListLink);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (ResponseMessage->BodyLength == 0) {
+    return EFI_SUCCESS;
+  }
+
+  ResponseMessage->Body = AllocateZeroPool (ResponseMessage->BodyLength);
+  if (ResponseMessage->Body == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  TotalReceivedSize = 0;
+  while (TotalReceivedSize < ResponseMessage->BodyLength) {
+    ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+    ResponseData.BodyLength = ResponseMessage->BodyLength - TotalReceivedSize;
+    ResponseData.Body       = (CHAR8 *)ResponseMessage->Body + TotalReceivedSize;
+    Status                  = HttpIoRecvResponse (&(Instance->HttpIo), FALSE, &ResponseData);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    TotalReceivedSize += ResponseData.BodyLength;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  if (ResponseMessage->Body != NULL) {
+    FreePool (ResponseMessage->Body);
+  }
+
+  if (ResponseMessage->Headers != NULL) {
+    FreePool (ResponseMessage->Headers);
+  }
+
+  if (ResponseMessage->Data.Response != NULL) {
+    FreePool (ResponseMessage->Data.Response);
+  }
+
+  ZeroMem (ResponseMessage, sizeof (EFI_HTTP_MESSAGE));
+  return Status;
+}
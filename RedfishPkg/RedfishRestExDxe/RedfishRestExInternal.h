@@ -31,6 +31,7 @@
 /// UEFI Driver Model Protocols
 ///
 #include <Protocol/DriverBinding.h>
+#include <Protocol/EdkIIRedfishRestExBatch.h>
 #include <Protocol/RestEx.h>
 #include <Protocol/ServiceBinding.h>
 
@@ -125,6 +126,58 @@ RedfishRestExSendReceive (
   OUT     EFI_HTTP_MESSAGE      *ResponseMessage
   );
 
+/**
+  Receive the response of a request that was sent ahead on the HTTP connection
+  of a REST EX instance.
+
+  The whole message is received, including its body, so that the response of
+  the next pipelined request starts on a message boundary. The interim 100
+  Continue responses are skipped.
+
+  @param[in]   Instance          Pointer to the REST EX instance.
+  @param[out]  ResponseMessage   The HTTP response. On success the caller frees
+                                 its response data, headers and body.
+
+  @retval EFI_SUCCESS            The response was received, whatever its HTTP
+                                 status code.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to receive the response.
+  @retval Others                 The HTTP connection failed, ResponseMessage is
+                                 cleared.
+
+**/
+EFI_STATUS
+RedfishRestExReceiveMessage (
+  IN  RESTEX_INSTANCE   *Instance,
+  OUT EFI_HTTP_MESSAGE  *ResponseMessage
+  );
+
+/**
+  Send a batch of HTTP requests to the REST service of a REST EX instance, and
+  return the responses in the order of the requests.
+
+  @param[in]   This               Pointer to the EDKII_REDFISH_REST_EX_BATCH_PROTOCOL instance.
+  @param[in]   Count              The number of requests in the batch.
+  @param[in]   RequestMessages    The array of Count HTTP requests.
+  @param[out]  ResponseMessages   The array of Count HTTP responses.
+  @param[out]  Statuses           The array of Count statuses of the requests.
+
+  @retval EFI_SUCCESS             All the requests were processed. Statuses
+                                  holds the result of each of them.
+  @retval EFI_INVALID_PARAMETER   This, RequestMessages, ResponseMessages or Statuses
+                                  is NULL, or Count is zero.
+  @retval EFI_NO_MEDIA            There is no media on the network interface.
+
+**/
+EFI_STATUS
+EFIAPI
+RedfishRestExSendReceiveBatch (
+  IN     EDKII_REDFISH_REST_EX_BATCH_PROTOCOL  *This,
+  IN     UINTN                                 Count,
+  IN     EFI_HTTP_MESSAGE                      *RequestMessages,
+  OUT    EFI_HTTP_MESSAGE                      *ResponseMessages,
+  OUT    EFI_STATUS                            *Statuses
+  );
+
 /**
   Obtain the current time from this REST service instance.
 
@@ -22,6 +22,11 @@ EFI_REST_EX_PROTOCOL  mRedfishRestExProtocol = {
   RedfishRestExEventService
 };
 
+EDKII_REDFISH_REST_EX_BATCH_PROTOCOL  mRedfishRestExBatchProtocol = {
+  EDKII_REDFISH_REST_EX_BATCH_PROTOCOL_REVISION,
+  RedfishRestExSendReceiveBatch
+};
+
 /**
   Provides a simple HTTP-like interface to send and receive resources from a REST service.
 
@@ -265,6 +270,23 @@ ReSendRequest:;
     DEBUG ((DEBUG_MANAGEABILITY, "HTTP_STATUS_201_CREATED\n"));
   } else if (ResponseData->Response.StatusCode == HTTP_STATUS_202_ACCEPTED) {
     DEBUG ((DEBUG_MANAGEABILITY, "HTTP_STATUS_202_ACCEPTED\n"));
+  } else if (ResponseData->Response.StatusCode == HTTP_STATUS_304_NOT_MODIFIED) {
+    DEBUG ((DEBUG_REDFISH_NETWORK, "HTTP_STATUS_304_NOT_MODIFIED\n"));
+
+    //
+    // The resource did not change since the ETag given in If-None-Match. A 304
+    // response never has a body, whatever its Content-Length header says.
+    //
+    ResponseMessage->Data.Response = AllocateZeroPool (sizeof (EFI_HTTP_RESPONSE_DATA));
+    if (ResponseMessage->Data.Response == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ON_EXIT;
+    }
+
+    ResponseMessage->Data.Response->StatusCode = ResponseData->Response.StatusCode;
+    ResponseMessage->HeaderCount               = ResponseData->HeaderCount;
+    ResponseMessage->Headers                   = ResponseData->Headers;
+    goto ON_EXIT;
   } else if (ResponseData->Response.StatusCode == HTTP_STATUS_413_REQUEST_ENTITY_TOO_LARGE) {
     DEBUG ((DEBUG_REDFISH_NETWORK, "HTTP_STATUS_413_REQUEST_ENTITY_TOO_LARGE\n"));
 
@@ -465,6 +487,186 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Translate the HTTP status code of a pipelined response into the status
+  SendReceive() returns for it.
+
+  @param[in, out]  ResponseMessage   The HTTP response. Its headers and body are
+                                     released when the status is an error.
+
+  @return The status of the request.
+
+**/
+STATIC
+EFI_STATUS
+RedfishRestExResponseStatus (
+  IN OUT EFI_HTTP_MESSAGE  *ResponseMessage
+  )
+{
+  EFI_STATUS  Status;
+
+  switch (ResponseMessage->Data.Response->StatusCode) {
+    case HTTP_STATUS_200_OK:
+    case HTTP_STATUS_201_CREATED:
+    case HTTP_STATUS_202_ACCEPTED:
+    case HTTP_STATUS_204_NO_CONTENT:
+    case HTTP_STATUS_304_NOT_MODIFIED:
+    case HTTP_STATUS_400_BAD_REQUEST:
+      return EFI_SUCCESS;
+
+    case HTTP_STATUS_405_METHOD_NOT_ALLOWED:
+      Status = EFI_ACCESS_DENIED;
+      break;
+
+    case HTTP_STATUS_413_REQUEST_ENTITY_TOO_LARGE:
+      Status = EFI_BAD_BUFFER_SIZE;
+      break;
+
+    default:
+      DumpHttpStatusCode (DEBUG_REDFISH_NETWORK, ResponseMessage->Data.Response->StatusCode);
+      Status = EFI_UNSUPPORTED;
+      break;
+  }
+
+  //
+  // Only the status code is delivered back to the caller, as SendReceive() does.
+  //
+  if (ResponseMessage->Headers != NULL) {
+    FreePool (ResponseMessage->Headers);
+    ResponseMessage->Headers = NULL;
+  }
+
+  ResponseMessage->HeaderCount = 0;
+  if (ResponseMessage->Body != NULL) {
+    FreePool (ResponseMessage->Body);
+    ResponseMessage->Body = NULL;
+  }
+
+  ResponseMessage->BodyLength = 0;
+  return Status;
+}
+
+/**
+  Send a batch of HTTP requests to the REST service of a REST EX instance, and
+  return the responses in the order of the requests.
+
+  Up to PcdRedfishRestExPipelineDepth consecutive GET requests are sent before
+  their responses are received. When the connection fails in the middle of a
+  pipeline, it is reset and the requests left without a response are sent
+  again one at a time, which is safe as GET requests are idempotent. The other
+  requests go through SendReceive().
+
+  @param[in]   This               Pointer to the EDKII_REDFISH_REST_EX_BATCH_PROTOCOL instance.
+  @param[in]   Count              The number of requests in the batch.
+  @param[in]   RequestMessages    The array of Count HTTP requests.
+  @param[out]  ResponseMessages   The array of Count HTTP responses.
+  @param[out]  Statuses           The array of Count statuses of the requests.
+
+  @retval EFI_SUCCESS             All the requests were processed. Statuses
+                                  holds the result of each of them.
+  @retval EFI_INVALID_PARAMETER   This, RequestMessages, ResponseMessages or Statuses
+                                  is NULL, or Count is zero.
+  @retval EFI_NO_MEDIA            There is no media on the network interface.
+
+**/
+EFI_STATUS
+EFIAPI
+RedfishRestExSendReceiveBatch (
+  IN     EDKII_REDFISH_REST_EX_BATCH_PROTOCOL  *This,
+  IN     UINTN                                 Count,
+  IN     EFI_HTTP_MESSAGE                      *RequestMessages,
+  OUT    EFI_HTTP_MESSAGE                      *ResponseMessages,
+  OUT    EFI_STATUS                            *Statuses
+  )
+{
+  EFI_STATUS        Status;
+  RESTEX_INSTANCE   *Instance;
+  EFI_HTTP_MESSAGE  *Request;
+  BOOLEAN           MediaPresent;
+  BOOLEAN           Reset;
+  UINTN             Index;
+  UINTN             Sent;
+  UINTN             Received;
+
+  if ((This == NULL) || (RequestMessages == NULL) || (ResponseMessages == NULL) || (Statuses == NULL) || (Count == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance = RESTEX_INSTANCE_FROM_BATCH (This);
+
+  MediaPresent = TRUE;
+  NetLibDetectMedia (Instance->Service->ControllerHandle, &MediaPresent);
+  if (!MediaPresent) {
+    DEBUG ((DEBUG_REDFISH_NETWORK, "RedfishRestExSendReceiveBatch(): No MediaPresent.\n"));
+    return EFI_NO_MEDIA;
+  }
+
+  Index = 0;
+  while (Index < Count) {
+    //
+    // Send the consecutive GET requests ahead, up to the pipeline depth.
+    //
+    Reset = FALSE;
+    Sent  = 0;
+    if (FixedPcdGet8 (PcdRedfishRestExPipelineDepth) > 1) {
+      while ((Index + Sent < Count) && (Sent < FixedPcdGet8 (PcdRedfishRestExPipelineDepth))) {
+        Request = &RequestMessages[Index + Sent];
+        if ((Request->Data.Request->Method != HttpMethodGet) || (Request->BodyLength != 0)) {
+          break;
+        }
+
+        DEBUG ((DEBUG_REDFISH_NETWORK, "*** Pipeline HTTP Request Method - %d, URL: %s\n", Request->Data.Request->Method, Request->Data.Request->Url));
+        Status = HttpIoSendRequest (
+                   &(Instance->HttpIo),
+                   Request->Data.Request,
+                   Request->HeaderCount,
+                   Request->Headers,
+                   0,
+                   NULL
+                   );
+        if (EFI_ERROR (Status)) {
+          Reset = TRUE;
+          break;
+        }
+
+        Sent++;
+      }
+    }
+
+    //
+    // Receive the responses in the order of the requests.
+    //
+    for (Received = 0; Received < Sent; Received++) {
+      Status = RedfishRestExReceiveMessage (Instance, &ResponseMessages[Index + Received]);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_REDFISH_NETWORK, "RedfishRestExSendReceiveBatch(): Pipeline broken after %d responses - %r\n", Received, Status));
+        Reset = TRUE;
+        break;
+      }
+
+      Statuses[Index + Received] = RedfishRestExResponseStatus (&ResponseMessages[Index + Received]);
+    }
+
+    Index += Received;
+    if (Reset) {
+      ResetHttpTslSession (Instance);
+    } else if (Sent != 0) {
+      continue;
+    }
+
+    //
+    // Send the request that is not pipelined, or the first one that lost its
+    // response, alone.
+    //
+    if (Index < Count) {
+      Statuses[Index] = RedfishRestExSendReceive (&Instance->RestEx, &RequestMessages[Index], &ResponseMessages[Index]);
+      Index++;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Obtain the current time from this REST service instance.
 
@@ -93,6 +93,79 @@ InstallPreHashFvPpi (
   ASSERT_EFI_ERROR (Status);
 }
 
+/**
+  Hash the queued FVs until none is left. This is run on all the processors at
+  once, and on the BSP to finish any FV the other processors did not.
+
+  The hash functions only work on the buffers given to them, so they can run
+  on APs, where PEI services are not available.
+
+  @param[in, out]  Buffer    The FV_HASH_QUEUE of the FVs to hash.
+
+**/
+STATIC
+VOID
+EFIAPI
+HashQueuedFvs (
+  IN OUT VOID  *Buffer
+  )
+{
+  FV_HASH_QUEUE  *Queue;
+  FV_HASH_JOB    *Job;
+  UINT32         Index;
+
+  Queue = (FV_HASH_QUEUE *)Buffer;
+  for ( ; ;) {
+    Index = InterlockedIncrement (&Queue->JobNext) - 1;
+    if (Index >= Queue->JobCount) {
+      break;
+    }
+
+    Job         = &Queue->Job[Index];
+    Job->Result = Queue->HashAll (Job->Buffer, Job->Length, Job->HashValue);
+  }
+}
+
+/**
+  Hash the memory copies of the FVs, on all the processors at once if the MP
+  services are available.
+
+  @param[in, out]  Queue    The FVs to hash.
+
+**/
+STATIC
+VOID
+HashFvs (
+  IN OUT FV_HASH_QUEUE  *Queue
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices2Ppi;
+
+  Queue->JobNext = 0;
+
+  //
+  // Only more than one FV is worth waking the APs for.
+  //
+  if (Queue->JobCount > 1) {
+    Status = PeiServicesLocatePpi (
+               &gEdkiiPeiMpServices2PpiGuid,
+               0,
+               NULL,
+               (VOID **)&MpServices2Ppi
+               );
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "Hashing %d FVs on all processors\r\n", Queue->JobCount));
+      MpServices2Ppi->StartupAllCPUs (MpServices2Ppi, HashQueuedFvs, 0, Queue);
+    }
+  }
+
+  //
+  // Hash whatever FV is left, e.g. when the APs could not be started.
+  //
+  HashQueuedFvs (Queue);
+}
+
 /**
   Calculate and verify hash value for given FV.
 
@@ -121,6 +194,10 @@ VerifyHashedFv (
   VOID                                  *FvBuffer;
   EDKII_PEI_FIRMWARE_VOLUME_SHADOW_PPI  *FvShadowPpi;
   EFI_STATUS                            Status;
+  FV_HASH_QUEUE                         Queue;
+  FV_HASH_JOB                           *Job;
+  UINT8                                 *FvDigest;
+  UINT32                                Index;
 
   if ((HashInfo == NULL) ||
       (HashInfo->HashSize == 0) ||
@@ -149,11 +226,17 @@ VerifyHashedFv (
   //
   HashValue = AllocateZeroPool (AlgInfo->HashSize * (FvNumber + 1));
   ASSERT (HashValue != NULL);
+  FvDigest = AllocateZeroPool (AlgInfo->HashSize * FvNumber);
+  ASSERT (FvDigest != NULL);
+  Job = AllocateZeroPool (sizeof (FV_HASH_JOB) * FvNumber);
+  ASSERT (Job != NULL);
 
   //
-  // Calculate hash value for each FV first.
+  // Copy the FVs to permanent memory first, the FVs are then hashed at once.
   //
-  FvHashValue = HashValue;
+  Queue.HashAll  = AlgInfo->HashAll;
+  Queue.Job      = Job;
+  Queue.JobCount = 0;
   for (FvIndex = 0; FvIndex < FvNumber; ++FvIndex) {
     //
     // Not meant for verified boot and/or measured boot?
@@ -217,21 +300,38 @@ VerifyHashedFv (
         );
     }
 
-    if (!AlgInfo->HashAll (FvBuffer, (UINTN)FvInfo[FvIndex].Length, FvHashValue)) {
+    Job[Queue.JobCount].FvIndex   = FvIndex;
+    Job[Queue.JobCount].Buffer    = FvBuffer;
+    Job[Queue.JobCount].Length    = (UINTN)FvInfo[FvIndex].Length;
+    Job[Queue.JobCount].HashValue = FvDigest + AlgInfo->HashSize * Queue.JobCount;
+    Queue.JobCount++;
+  }
+
+  //
+  // Calculate hash value for each FV.
+  //
+  HashFvs (&Queue);
+  for (Index = 0; Index < Queue.JobCount; ++Index) {
+    if (!Job[Index].Result) {
       Status = EFI_ABORTED;
       goto Done;
     }
+  }
+
+  FvHashValue = HashValue;
+  for (Index = 0; Index < Queue.JobCount; ++Index) {
+    FvIndex = Job[Index].FvIndex;
 
     //
     // Report the FV measurement.
     //
     if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_MEASURED_BOOT) != 0) {
       InstallPreHashFvPpi (
-        FvBuffer,
-        (UINTN)FvInfo[FvIndex].Length,
+        Job[Index].Buffer,
+        Job[Index].Length,
         HashInfo->HashAlgoId,
         HashInfo->HashSize,
-        FvHashValue
+        Job[Index].HashValue
         );
     }
 
@@ -239,13 +339,14 @@ VerifyHashedFv (
     // Don't keep the hash value of current FV if we don't need to verify it.
     //
     if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_VERIFIED_BOOT) != 0) {
+      CopyMem (FvHashValue, Job[Index].HashValue, AlgInfo->HashSize);
       FvHashValue += AlgInfo->HashSize;
     }
 
     //
     // Use memory copy of the FV from now on.
     //
-    FvInfo[FvIndex].Base = (UINT64)(UINTN)FvBuffer;
+    FvInfo[FvIndex].Base = (UINT64)(UINTN)Job[Index].Buffer;
   }
 
   //
@@ -261,6 +362,8 @@ VerifyHashedFv (
   }
 
 Done:
+  FreePool (Job);
+  FreePool (FvDigest);
   FreePool (HashValue);
   return Status;
 }
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Ppi/FirmwareVolumeInfoStoredHashFv.h>
 #include <Ppi/FirmwareVolumeShadowPpi.h>
+#include <Ppi/MpServices2.h>
 
 #include <Library/PeiServicesLib.h>
 #include <Library/PcdLib.h>
@@ -24,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseCryptLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/SynchronizationLib.h>
 
 #define HASH_INFO_PTR(PreHashedFvPpi)  \
   (HASH_INFO *)((UINT8 *)(PreHashedFvPpi) + sizeof (EDKII_PEI_FIRMWARE_VOLUME_INFO_PREHASHED_FV_PPI))
@@ -119,4 +121,25 @@ typedef struct {
   HASH_ALL_METHOD       HashAll;
 } HASH_ALG_INFO;
 
+//
+// The hash of the memory copy of one FV.
+//
+typedef struct {
+  UINTN         FvIndex;
+  VOID          *Buffer;
+  UINTN         Length;
+  UINT8         *HashValue;
+  BOOLEAN       Result;
+} FV_HASH_JOB;
+
+//
+// The FVs to hash, shared by the processors hashing them.
+//
+typedef struct {
+  HASH_ALL_METHOD    HashAll;
+  FV_HASH_JOB        *Job;
+  UINT32             JobCount;
+  volatile UINT32    JobNext;
+} FV_HASH_QUEUE;
+
 #endif //__FV_REPORT_PEI_H__
@@ -0,0 +1,163 @@
+/** @file
+  EDKII_PKCS7_BATCH_VERIFY_PROTOCOL verifies several PKCS7 signatures against
+  the same signature databases in one call.
+
+  It is produced along with EFI_PKCS7_VERIFY_PROTOCOL. Each signature of a batch
+  gets the result EFI_PKCS7_VERIFY_PROTOCOL would return for it, but the
+  databases are validated once for the batch, and the certificate of AllowedDb
+  that verified a signature is tried first for the next ones, since the
+  signatures of a batch are usually issued by the same signer.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_PKCS7_BATCH_VERIFY_PROTOCOL_H__
+#define __EDKII_PKCS7_BATCH_VERIFY_PROTOCOL_H__
+
+#include <Protocol/Pkcs7Verify.h>
+
+// {BAAAE171-DDD3-445A-8FE3-FC3EFB6056C5}
+#define EDKII_PKCS7_BATCH_VERIFY_PROTOCOL_GUID \
+  { \
+    0xbaaae171, 0xddd3, 0x445a, { 0x8f, 0xe3, 0xfc, 0x3e, 0xfb, 0x60, 0x56, 0xc5 } \
+  }
+
+typedef struct _EDKII_PKCS7_BATCH_VERIFY_PROTOCOL EDKII_PKCS7_BATCH_VERIFY_PROTOCOL;
+
+///
+/// A PKCS7 signature with embedded or detached content, and its result.
+///
+typedef struct {
+  ///
+  /// Buffer containing ASN.1 DER-encoded PKCS7 signature, and its size in bytes.
+  ///
+  VOID          *SignedData;
+  UINTN         SignedDataSize;
+  ///
+  /// In case of detached signature, the raw message data previously signed and
+  /// its size in bytes. NULL and 0 if SignedData contains embedded data.
+  ///
+  VOID          *InData;
+  UINTN         InDataSize;
+  ///
+  /// Optional caller-allocated buffer that receives the content after the
+  /// verification succeeds. On input, ContentSize is the size of the buffer,
+  /// on output the size of the content. ContentSize must be 0 if Content is NULL.
+  ///
+  VOID          *Content;
+  UINTN         ContentSize;
+  ///
+  /// On output, what EFI_PKCS7_VERIFY_BUFFER returns for this signature.
+  ///
+  EFI_STATUS    Status;
+} EDKII_PKCS7_VERIFY_BUFFER_ENTRY;
+
+///
+/// A detached PKCS7 signature with the caller calculated hash of the data, and
+/// its result.
+///
+typedef struct {
+  ///
+  /// Buffer containing ASN.1 DER-encoded PKCS detached signature, and its size
+  /// in bytes.
+  ///
+  VOID          *Signature;
+  UINTN         SignatureSize;
+  ///
+  /// The caller calculated hash of the data, and its size in bytes.
+  ///
+  VOID          *InHash;
+  UINTN         InHashSize;
+  ///
+  /// On output, what EFI_PKCS7_VERIFY_SIGNATURE returns for this signature.
+  ///
+  EFI_STATUS    Status;
+} EDKII_PKCS7_VERIFY_SIGNATURE_ENTRY;
+
+/**
+  Processes several buffers containing binary DER-encoded PKCS7 signatures, as
+  EFI_PKCS7_VERIFY_PROTOCOL.VerifyBuffer () does for one of them.
+
+  @param[in]     This                 Pointer to EDKII_PKCS7_BATCH_VERIFY_PROTOCOL instance.
+  @param[in,out] Entries              The signatures to verify. The Status of each entry
+                                      receives its result.
+  @param[in]     EntryCount           The number of entries.
+  @param[in]     AllowedDb            Pointer to a list of pointers to EFI_SIGNATURE_LIST
+                                      structures of approved signers, terminated by a null
+                                      pointer. This parameter is required.
+  @param[in]     RevokedDb            Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of revoked signers and
+                                      revoked file hashes, terminated by a null pointer.
+  @param[in]     TimeStampDb          Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of trusted time stamp
+                                      signers, terminated by a null pointer.
+
+  @retval EFI_SUCCESS                 All the signatures were verified.
+  @retval EFI_INVALID_PARAMETER       Entries is NULL, EntryCount is zero or AllowedDb is
+                                      NULL.
+  @retval EFI_ABORTED                 Unsupported or invalid format in TimeStampDb,
+                                      RevokedDb or AllowedDb list contents was detected.
+                                      No entry was processed.
+  @retval Others                      The Status of the first entry that failed to verify.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PKCS7_VERIFY_BUFFERS)(
+  IN EDKII_PKCS7_BATCH_VERIFY_PROTOCOL    *This,
+  IN OUT EDKII_PKCS7_VERIFY_BUFFER_ENTRY  *Entries,
+  IN UINTN                                EntryCount,
+  IN EFI_SIGNATURE_LIST                   **AllowedDb,
+  IN EFI_SIGNATURE_LIST                   **RevokedDb      OPTIONAL,
+  IN EFI_SIGNATURE_LIST                   **TimeStampDb    OPTIONAL
+  );
+
+/**
+  Processes several buffers containing binary DER-encoded detached PKCS7
+  signatures of caller calculated hashes, as
+  EFI_PKCS7_VERIFY_PROTOCOL.VerifySignature () does for one of them.
+
+  @param[in]     This                 Pointer to EDKII_PKCS7_BATCH_VERIFY_PROTOCOL instance.
+  @param[in,out] Entries              The signatures to verify. The Status of each entry
+                                      receives its result.
+  @param[in]     EntryCount           The number of entries.
+  @param[in]     AllowedDb            Pointer to a list of pointers to EFI_SIGNATURE_LIST
+                                      structures of approved signers, terminated by a null
+                                      pointer. This parameter is required.
+  @param[in]     RevokedDb            Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of revoked signers and
+                                      revoked file hashes, terminated by a null pointer.
+  @param[in]     TimeStampDb          Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of trusted time stamp
+                                      counter-signers, terminated by a null pointer.
+
+  @retval EFI_SUCCESS                 All the signatures were verified.
+  @retval EFI_INVALID_PARAMETER       Entries is NULL, EntryCount is zero or AllowedDb is
+                                      NULL.
+  @retval Others                      The Status of the first entry that failed to verify.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PKCS7_VERIFY_SIGNATURES)(
+  IN EDKII_PKCS7_BATCH_VERIFY_PROTOCOL       *This,
+  IN OUT EDKII_PKCS7_VERIFY_SIGNATURE_ENTRY  *Entries,
+  IN UINTN                                   EntryCount,
+  IN EFI_SIGNATURE_LIST                      **AllowedDb,
+  IN EFI_SIGNATURE_LIST                      **RevokedDb      OPTIONAL,
+  IN EFI_SIGNATURE_LIST                      **TimeStampDb    OPTIONAL
+  );
+
+///
+/// The EDKII_PKCS7_BATCH_VERIFY_PROTOCOL is used to verify several PKCS7
+/// signatures against the same signature databases.
+///
+struct _EDKII_PKCS7_BATCH_VERIFY_PROTOCOL {
+  EDKII_PKCS7_VERIFY_BUFFERS       VerifyBuffers;
+  EDKII_PKCS7_VERIFY_SIGNATURES    VerifySignatures;
+};
+
+extern EFI_GUID  gEdkiiPkcs7BatchVerifyProtocolGuid;
+
+#endif
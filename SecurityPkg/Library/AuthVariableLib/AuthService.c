@@ -56,6 +56,9 @@ EFI_SIGNATURE_ITEM  mSupportSigItem[] = {
   { EFI_CERT_X509_SHA512_GUID,    0, 80            }
 };
 
+STATIC KEK_SIGNER_CACHE_ENTRY  mKekSignerCache[KEK_SIGNER_CACHE_SIZE];
+STATIC UINTN                   mKekSignerCacheNext = 0;
+
 /**
   Finds variable in storage blocks of volatile and non-volatile storage areas.
 
@@ -663,6 +666,13 @@ ProcessVarWithPk (
                );
   }
 
+  if (!EFI_ERROR (Status)) {
+    //
+    // PK or KEK changed, the signers of db/dbx/dbt must be verified again.
+    //
+    KekSignerCacheInvalidate ();
+  }
+
   if (!EFI_ERROR (Status) && IsPk) {
     if ((mPlatformMode == SETUP_MODE) && !Del) {
       //
@@ -1790,6 +1800,232 @@ CleanCertsFromDb (
   return Status;
 }
 
+/**
+  Drop the KEK certificates cached for the signers of the db/dbx/dbt updates.
+  It must be called when PK or KEK changes.
+
+**/
+VOID
+KekSignerCacheInvalidate (
+  VOID
+  )
+{
+  ZeroMem (mKekSignerCache, sizeof (mKekSignerCache));
+  mKekSignerCacheNext = 0;
+}
+
+/**
+  Check whether a KEK certificate is cached for any signer.
+
+  @retval  TRUE      No KEK certificate is cached.
+  @retval  FALSE     Some KEK certificate is cached.
+
+**/
+STATIC
+BOOLEAN
+KekSignerCacheIsEmpty (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < KEK_SIGNER_CACHE_SIZE; Index++) {
+    if (mKekSignerCache[Index].Valid) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Find the cache entry of a signer.
+
+  @param[in]  SignerCertHash    SHA256 digest of the signer certificate.
+
+  @return The cache entry, or NULL if the signer is not cached.
+
+**/
+STATIC
+KEK_SIGNER_CACHE_ENTRY *
+KekSignerCacheFind (
+  IN CONST UINT8  *SignerCertHash
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < KEK_SIGNER_CACHE_SIZE; Index++) {
+    if (mKekSignerCache[Index].Valid &&
+        (CompareMem (mKekSignerCache[Index].SignerCertHash, SignerCertHash, SHA256_DIGEST_SIZE) == 0))
+    {
+      return &mKekSignerCache[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Record the KEK certificate that verified a signature of a signer, replacing the
+  previous one of the same signer or the oldest entry.
+
+  @param[in]  SignerCertHash    SHA256 digest of the signer certificate.
+  @param[in]  TrustedCert       The KEK certificate.
+  @param[in]  TrustedCertSize   Size of the KEK certificate in bytes.
+
+**/
+STATIC
+VOID
+KekSignerCacheRecord (
+  IN CONST UINT8  *SignerCertHash,
+  IN UINT8        *TrustedCert,
+  IN UINTN        TrustedCertSize
+  )
+{
+  KEK_SIGNER_CACHE_ENTRY  *Entry;
+
+  Entry = KekSignerCacheFind (SignerCertHash);
+  if (Entry == NULL) {
+    Entry               = &mKekSignerCache[mKekSignerCacheNext];
+    mKekSignerCacheNext = (mKekSignerCacheNext + 1) % KEK_SIGNER_CACHE_SIZE;
+  }
+
+  Entry->Valid = Sha256HashAll (TrustedCert, TrustedCertSize, Entry->TrustedCertHash);
+  CopyMem (Entry->SignerCertHash, SignerCertHash, SHA256_DIGEST_SIZE);
+}
+
+/**
+  Calculate the SHA256 digest of the signer certificate of a PKCS#7 SignedData.
+
+  @param[in]   SigData           Pointer to the PKCS#7 SignedData.
+  @param[in]   SigDataSize       Size of the PKCS#7 SignedData in bytes.
+  @param[out]  SignerCertHash    SHA256 digest of the signer certificate.
+
+  @retval  TRUE      The digest is calculated.
+  @retval  FALSE     The signer certificate could not be found.
+
+**/
+STATIC
+BOOLEAN
+GetSignerCertHash (
+  IN  UINT8  *SigData,
+  IN  UINTN  SigDataSize,
+  OUT UINT8  *SignerCertHash
+  )
+{
+  UINT8          *SignerCerts;
+  UINTN          CertStackSize;
+  UINT8          *TopLevelCert;
+  UINTN          TopLevelCertSize;
+  EFI_CERT_DATA  *CertDataPtr;
+  BOOLEAN        Result;
+
+  if (!Pkcs7GetSigners (SigData, SigDataSize, &SignerCerts, &CertStackSize, &TopLevelCert, &TopLevelCertSize)) {
+    return FALSE;
+  }
+
+  //
+  // The signer certificate is the first one of the stack.
+  //
+  Result = FALSE;
+  if ((SignerCerts != NULL) && (*SignerCerts != 0)) {
+    CertDataPtr = (EFI_CERT_DATA *)(SignerCerts + 1);
+    Result      = Sha256HashAll (
+                    CertDataPtr->CertDataBuffer,
+                    ReadUnaligned32 ((UINT32 *)&(CertDataPtr->CertDataLength)),
+                    SignerCertHash
+                    );
+  }
+
+  Pkcs7FreeSigners (TopLevelCert);
+  Pkcs7FreeSigners (SignerCerts);
+
+  return Result;
+}
+
+/**
+  Verify a PKCS#7 SignedData against the X.509 certificates of the KEK database.
+
+  @param[in]   KekData             The KEK database.
+  @param[in]   KekDataSize         Size of the KEK database in bytes.
+  @param[in]   SigData             Pointer to the PKCS#7 SignedData.
+  @param[in]   SigDataSize         Size of the PKCS#7 SignedData in bytes.
+  @param[in]   NewData             The signed content.
+  @param[in]   NewDataSize         Size of the signed content in bytes.
+  @param[in]   TrustedCertHash     If not NULL, only the certificate with this SHA256
+                                   digest is tried.
+  @param[out]  Attempts            The number of certificates that were tried.
+  @param[out]  TrustedCert         The certificate that verified the SignedData.
+  @param[out]  TrustedCertSize     Size of the certificate in bytes.
+
+  @retval  TRUE      A certificate of KEK verified the SignedData.
+  @retval  FALSE     No certificate of KEK verified the SignedData.
+
+**/
+STATIC
+BOOLEAN
+VerifyWithKek (
+  IN  VOID         *KekData,
+  IN  UINTN        KekDataSize,
+  IN  UINT8        *SigData,
+  IN  UINTN        SigDataSize,
+  IN  UINT8        *NewData,
+  IN  UINTN        NewDataSize,
+  IN  CONST UINT8  *TrustedCertHash OPTIONAL,
+  OUT UINTN        *Attempts,
+  OUT UINT8        **TrustedCert,
+  OUT UINTN        *TrustedCertSize
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               Index;
+  UINTN               CertCount;
+  UINT32              RemainingSize;
+  UINT8               CertHash[SHA256_DIGEST_SIZE];
+
+  *Attempts = 0;
+
+  //
+  // Go through KEK Signature Database to find out X.509 CertList.
+  //
+  RemainingSize = (UINT32)KekDataSize;
+  CertList      = (EFI_SIGNATURE_LIST *)KekData;
+  while ((RemainingSize > 0) && (RemainingSize >= CertList->SignatureListSize)) {
+    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
+      Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+      for (Index = 0; Index < CertCount; Index++) {
+        //
+        // Iterate each Signature Data Node within this CertList for a verify
+        //
+        *TrustedCert     = Cert->SignatureData;
+        *TrustedCertSize = CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1);
+
+        if ((TrustedCertHash == NULL) ||
+            (Sha256HashAll (*TrustedCert, *TrustedCertSize, CertHash) &&
+             (CompareMem (CertHash, TrustedCertHash, SHA256_DIGEST_SIZE) == 0)))
+        {
+          //
+          // Verify Pkcs7 SignedData via Pkcs7Verify library.
+          //
+          (*Attempts)++;
+          if (Pkcs7Verify (SigData, SigDataSize, *TrustedCert, *TrustedCertSize, NewData, NewDataSize)) {
+            return TRUE;
+          }
+        }
+
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+    }
+
+    RemainingSize -= CertList->SignatureListSize;
+    CertList       = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  return FALSE;
+}
+
 /**
   Process variable with EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS set
 
@@ -1842,9 +2078,6 @@ VerifyTimeBasedPayload (
   EFI_STATUS                     Status;
   EFI_SIGNATURE_LIST             *CertList;
   EFI_SIGNATURE_DATA             *Cert;
-  UINTN                          Index;
-  UINTN                          CertCount;
-  UINT32                         KekDataSize;
   UINT8                          *NewData;
   UINTN                          NewDataSize;
   UINT8                          *Buffer;
@@ -1859,6 +2092,10 @@ VerifyTimeBasedPayload (
   UINT32                         CertsSizeinDb;
   UINT8                          Sha256Digest[SHA256_DIGEST_SIZE];
   EFI_CERT_DATA                  *CertDataPtr;
+  UINT8                          SignerCertHash[SHA256_DIGEST_SIZE];
+  BOOLEAN                        SignerCertHashValid;
+  KEK_SIGNER_CACHE_ENTRY         *KekSignerEntry;
+  UINTN                          Attempts;
 
   //
   // 1. TopLevelCert is the top-level issuer certificate in signature Signer Cert Chain
@@ -2103,42 +2340,57 @@ VerifyTimeBasedPayload (
     }
 
     //
-    // Ready to verify Pkcs7 SignedData. Go through KEK Signature Database to find out X.509 CertList.
-    //
-    KekDataSize = (UINT32)DataSize;
-    CertList    = (EFI_SIGNATURE_LIST *)Data;
-    while ((KekDataSize > 0) && (KekDataSize >= CertList->SignatureListSize)) {
-      if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-        Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-        CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-        for (Index = 0; Index < CertCount; Index++) {
-          //
-          // Iterate each Signature Data Node within this CertList for a verify
-          //
-          TrustedCert     = Cert->SignatureData;
-          TrustedCertSize = CertList->SignatureSize - (sizeof (EFI_SIGNATURE_DATA) - 1);
+    // Ready to verify Pkcs7 SignedData. If a certificate of KEK verified the last
+    // signature of the same signer, try it first: updates from the OS are signed
+    // by the same signer, and the certificates of KEK are otherwise tried in turn.
+    //
+    SignerCertHashValid = FALSE;
+    if (!KekSignerCacheIsEmpty ()) {
+      SignerCertHashValid = GetSignerCertHash (SigData, SigDataSize, SignerCertHash);
+      KekSignerEntry      = SignerCertHashValid ? KekSignerCacheFind (SignerCertHash) : NULL;
+      if (KekSignerEntry != NULL) {
+        VerifyStatus = VerifyWithKek (
+                         Data,
+                         DataSize,
+                         SigData,
+                         SigDataSize,
+                         NewData,
+                         NewDataSize,
+                         KekSignerEntry->TrustedCertHash,
+                         &Attempts,
+                         &TrustedCert,
+                         &TrustedCertSize
+                         );
+        if (VerifyStatus) {
+          goto Exit;
+        }
+      }
+    }
 
-          //
-          // Verify Pkcs7 SignedData via Pkcs7Verify library.
-          //
-          VerifyStatus = Pkcs7Verify (
-                           SigData,
-                           SigDataSize,
-                           TrustedCert,
-                           TrustedCertSize,
-                           NewData,
-                           NewDataSize
-                           );
-          if (VerifyStatus) {
-            goto Exit;
-          }
+    VerifyStatus = VerifyWithKek (
+                     Data,
+                     DataSize,
+                     SigData,
+                     SigDataSize,
+                     NewData,
+                     NewDataSize,
+                     NULL,
+                     &Attempts,
+                     &TrustedCert,
+                     &TrustedCertSize
+                     );
 
-          Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-        }
+    //
+    // Remember the certificate if others were tried before it.
+    //
+    if (VerifyStatus && (Attempts > 1)) {
+      if (!SignerCertHashValid) {
+        SignerCertHashValid = GetSignerCertHash (SigData, SigDataSize, SignerCertHash);
       }
 
-      KekDataSize -= CertList->SignatureListSize;
-      CertList     = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+      if (SignerCertHashValid) {
+        KekSignerCacheRecord (SignerCertHash, TrustedCert, TrustedCertSize);
+      }
     }
   } else if (AuthVarType == AuthVarTypePriv) {
     //
@@ -87,6 +87,20 @@ typedef struct {
 } AUTH_CERT_DB_DATA;
 #pragma pack()
 
+///
+/// The KEK certificate that verified the last signature of a signer, for the
+/// db/dbx/dbt updates. The next signature of the same signer is verified against
+/// that certificate first, rather than against each certificate of KEK in turn.
+/// The entries are dropped when PK or KEK changes.
+///
+#define KEK_SIGNER_CACHE_SIZE  4
+
+typedef struct {
+  BOOLEAN    Valid;
+  UINT8      SignerCertHash[SHA256_DIGEST_SIZE];
+  UINT8      TrustedCertHash[SHA256_DIGEST_SIZE];
+} KEK_SIGNER_CACHE_ENTRY;
+
 extern UINT8   *mCertDbStore;
 extern UINT32  mMaxCertDbSize;
 extern UINT32  mPlatformMode;
@@ -365,4 +379,14 @@ AuthServiceInternalUpdateVariableWithTimeStamp (
   IN EFI_TIME  *TimeStamp
   );
 
+/**
+  Drop the KEK certificates cached for the signers of the db/dbx/dbt updates.
+  It must be called when PK or KEK changes.
+
+**/
+VOID
+KekSignerCacheInvalidate (
+  VOID
+  );
+
 #endif
@@ -71,6 +71,24 @@ HASH_TABLE  mHash[] = {
 
 EFI_STRING  mHashTypeStr;
 
+//
+// SHA256 digests of the images that passed the verification, and the digest of
+// the security databases they were verified against.
+//
+STATIC UINT8  mVerifiedImageDigest[VERIFIED_IMAGE_CACHE_SIZE][SHA256_DIGEST_SIZE];
+STATIC UINTN  mVerifiedImageCount = 0;
+STATIC UINTN  mVerifiedImageNext  = 0;
+STATIC UINT8  mVerifiedImageDbDigest[SHA256_DIGEST_SIZE];
+
+//
+// The security databases a verification depends on.
+//
+STATIC CHAR16  *mSecurityDatabaseName[] = {
+  EFI_IMAGE_SECURITY_DATABASE,
+  EFI_IMAGE_SECURITY_DATABASE1,
+  EFI_IMAGE_SECURITY_DATABASE2
+};
+
 /**
   SecureBoot Hook for processing image verification.
 
@@ -826,6 +844,116 @@ AddImageExeInfo (
   }
 }
 
+/**
+  Search the hashes of a TBSCertificate in the index of the forbidden database (DBX).
+
+  @param[in]  TBSCert           Pointer to the TBSCertificate of the X.509 Certificate.
+  @param[in]  TBSCertSize       Size of the TBSCertificate.
+  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
+  @param[in]  SignatureListSize Size of Signature List.
+  @param[out] RevocationTime    Return the time that the certificate was revoked.
+  @param[out] IsFound           Search result. Only valid if EFI_SUCCESS returned.
+
+  @retval EFI_SUCCESS           Finished the search without any error.
+  @retval EFI_UNSUPPORTED       The forbidden database is not indexed.
+  @retval Others                Error occurred in the search of database.
+
+**/
+STATIC
+EFI_STATUS
+FindCertHashInDbxIndex (
+  IN  UINT8               *TBSCert,
+  IN  UINTN               TBSCertSize,
+  IN  EFI_SIGNATURE_LIST  *SignatureList,
+  IN  UINTN               SignatureListSize,
+  OUT EFI_TIME            *RevocationTime,
+  OUT BOOLEAN             *IsFound
+  )
+{
+  EFI_STATUS             Status;
+  UINT32                 HashAlg[3];
+  EFI_GUID               *HashType[3];
+  UINTN                  Index;
+  VOID                   *HashCtx;
+  UINT8                  CertDigest[MAX_DIGEST_SIZE];
+  SIGNATURE_INDEX_ENTRY  Entry;
+  SIGNATURE_INDEX_ENTRY  FirstEntry;
+  UINT32                 FirstHashAlg;
+  BOOLEAN                Result;
+
+  HashAlg[0]  = HASHALG_SHA256;
+  HashType[0] = &gEfiCertX509Sha256Guid;
+  HashAlg[1]  = HASHALG_SHA384;
+  HashType[1] = &gEfiCertX509Sha384Guid;
+  HashAlg[2]  = HASHALG_SHA512;
+  HashType[2] = &gEfiCertX509Sha512Guid;
+
+  FirstHashAlg = HASHALG_MAX;
+  ZeroMem (&FirstEntry, sizeof (FirstEntry));
+
+  for (Index = 0; Index < ARRAY_SIZE (HashAlg); Index++) {
+    //
+    // Calculate the hash value of the TBSCertificate for comparision.
+    //
+    if (mHash[HashAlg[Index]].GetContextSize == NULL) {
+      return EFI_UNSUPPORTED;
+    }
+
+    HashCtx = AllocatePool (mHash[HashAlg[Index]].GetContextSize ());
+    if (HashCtx == NULL) {
+      return EFI_ABORTED;
+    }
+
+    ZeroMem (CertDigest, MAX_DIGEST_SIZE);
+    Result = mHash[HashAlg[Index]].HashInit (HashCtx) &&
+             mHash[HashAlg[Index]].HashUpdate (HashCtx, TBSCert, TBSCertSize) &&
+             mHash[HashAlg[Index]].HashFinal (HashCtx, CertDigest);
+    FreePool (HashCtx);
+    if (!Result) {
+      return EFI_ABORTED;
+    }
+
+    Status = SignatureIndexFind (
+               EFI_IMAGE_SECURITY_DATABASE1,
+               (UINT8 *)SignatureList,
+               SignatureListSize,
+               HashType[Index],
+               CertDigest,
+               mHash[HashAlg[Index]].DigestLength,
+               &Entry
+               );
+    if (Status == EFI_UNSUPPORTED) {
+      return Status;
+    }
+
+    //
+    // The walk of the database finds the hash of the first signature list.
+    //
+    if ((Status == EFI_SUCCESS) &&
+        ((FirstEntry.Signature == NULL) || ((UINTN)Entry.Signature < (UINTN)FirstEntry.Signature)))
+    {
+      CopyMem (&FirstEntry, &Entry, sizeof (Entry));
+      FirstHashAlg = HashAlg[Index];
+    }
+  }
+
+  *IsFound = FALSE;
+  if (FirstEntry.Signature != NULL) {
+    *IsFound = TRUE;
+
+    //
+    // Return the revocation time, a signature without one is always revoked.
+    //
+    if (FirstEntry.SignatureList->SignatureSize >= sizeof (EFI_GUID) + mHash[FirstHashAlg].DigestLength + sizeof (EFI_TIME)) {
+      CopyMem (RevocationTime, FirstEntry.Key + mHash[FirstHashAlg].DigestLength, sizeof (EFI_TIME));
+    } else {
+      ZeroMem (RevocationTime, sizeof (EFI_TIME));
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Check whether the hash of an given X.509 certificate is in forbidden database (DBX).
 
@@ -882,6 +1010,13 @@ IsCertHashFoundInDbx (
     return Status;
   }
 
+  Status = FindCertHashInDbxIndex (TBSCert, TBSCertSize, SignatureList, SignatureListSize, RevocationTime, IsFound);
+  if (Status != EFI_UNSUPPORTED) {
+    return Status;
+  }
+
+  Status = EFI_ABORTED;
+
   while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
     //
     // Determine Hash Algorithm of Certificate in the forbidden database.
@@ -988,12 +1123,13 @@ IsSignatureFoundInDatabase (
   )
 {
   EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
+  EFI_SIGNATURE_LIST     *CertList;
+  EFI_SIGNATURE_DATA     *Cert;
+  UINTN                  DataSize;
+  UINT8                  *Data;
+  UINTN                  Index;
+  UINTN                  CertCount;
+  SIGNATURE_INDEX_ENTRY  Entry;
 
   //
   // Read signature database variable.
@@ -1023,6 +1159,32 @@ IsSignatureFoundInDatabase (
     goto Done;
   }
 
+  //
+  // The whole signature data is compared, except for the X.509 certificate hashes.
+  //
+  if (!CompareGuid (CertType, &gEfiCertX509Sha256Guid) &&
+      !CompareGuid (CertType, &gEfiCertX509Sha384Guid) &&
+      !CompareGuid (CertType, &gEfiCertX509Sha512Guid))
+  {
+    Status = SignatureIndexFind (VariableName, Data, DataSize, CertType, Signature, SignatureSize, &Entry);
+    if (Status != EFI_UNSUPPORTED) {
+      if (Status == EFI_SUCCESS) {
+        *IsFound = TRUE;
+        //
+        // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+        //
+        if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+          SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, Entry.SignatureList->SignatureSize, Entry.Signature);
+        }
+      }
+
+      Status = EFI_SUCCESS;
+      goto Done;
+    }
+
+    Status = EFI_SUCCESS;
+  }
+
   //
   // Enumerate all signature data in SigDB to check if signature exists for executable.
   //
@@ -1606,6 +1768,146 @@ Done:
   return VerifyStatus;
 }
 
+/**
+  Calculate the SHA256 digest of the content of the security databases db, dbx
+  and dbt.
+
+  @param[out]  Digest     The digest of the security databases.
+
+  @retval TRUE            The digest is calculated.
+  @retval FALSE           The security databases could not be read.
+
+**/
+STATIC
+BOOLEAN
+GetSecurityDatabaseDigest (
+  OUT UINT8  *Digest
+  )
+{
+  VOID        *HashCtx;
+  UINTN       Index;
+  EFI_STATUS  Status;
+  UINT8       *Data;
+  UINTN       DataSize;
+  BOOLEAN     Result;
+
+  HashCtx = AllocatePool (Sha256GetContextSize ());
+  if (HashCtx == NULL) {
+    return FALSE;
+  }
+
+  Result = Sha256Init (HashCtx);
+  for (Index = 0; Result && (Index < ARRAY_SIZE (mSecurityDatabaseName)); Index++) {
+    Data     = NULL;
+    DataSize = 0;
+    Status   = GetVariable2 (mSecurityDatabaseName[Index], &gEfiImageSecurityDatabaseGuid, (VOID **)&Data, &DataSize);
+    if (Status == EFI_NOT_FOUND) {
+      DataSize = 0;
+    } else if (EFI_ERROR (Status)) {
+      Result = FALSE;
+      break;
+    }
+
+    Result = Sha256Update (HashCtx, &DataSize, sizeof (DataSize));
+    if (Result && (Data != NULL)) {
+      Result = Sha256Update (HashCtx, Data, DataSize);
+    }
+
+    if (Data != NULL) {
+      FreePool (Data);
+    }
+  }
+
+  if (Result) {
+    Result = Sha256Final (HashCtx, Digest);
+  }
+
+  FreePool (HashCtx);
+  return Result;
+}
+
+/**
+  Check whether an image passed the verification before.
+
+  The images are remembered until the security databases change, they are told
+  apart by the SHA256 digest of the whole file, certificates included. The
+  indexes of the databases are kept as long.
+
+  @param[in]   FileBuffer     The image.
+  @param[in]   FileSize       The size of the image.
+  @param[out]  ImageDigest    The digest of the image.
+  @param[out]  IsVerified     TRUE if the image passed the verification before.
+
+  @retval TRUE                ImageDigest is valid, and it may be remembered.
+  @retval FALSE               The image cannot be remembered.
+
+**/
+STATIC
+BOOLEAN
+IsVerifiedImage (
+  IN  VOID     *FileBuffer,
+  IN  UINTN    FileSize,
+  OUT UINT8    *ImageDigest,
+  OUT BOOLEAN  *IsVerified
+  )
+{
+  UINT8  DbDigest[SHA256_DIGEST_SIZE];
+  UINTN  Index;
+
+  *IsVerified = FALSE;
+
+  if (!GetSecurityDatabaseDigest (DbDigest)) {
+    mVerifiedImageCount = 0;
+    SignatureIndexFree ();
+    SignatureIndexEnable (FALSE);
+    return FALSE;
+  }
+
+  if (CompareMem (DbDigest, mVerifiedImageDbDigest, sizeof (DbDigest)) != 0) {
+    CopyMem (mVerifiedImageDbDigest, DbDigest, sizeof (DbDigest));
+    mVerifiedImageCount = 0;
+    mVerifiedImageNext  = 0;
+    SignatureIndexFree ();
+  }
+
+  //
+  // The databases are not changed while the image is verified.
+  //
+  SignatureIndexEnable (TRUE);
+
+  if (!Sha256HashAll (FileBuffer, FileSize, ImageDigest)) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < mVerifiedImageCount; Index++) {
+    if (CompareMem (mVerifiedImageDigest[Index], ImageDigest, SHA256_DIGEST_SIZE) == 0) {
+      *IsVerified = TRUE;
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Remember an image that passed the verification.
+
+  @param[in]  ImageDigest    The digest of the image returned by IsVerifiedImage().
+
+**/
+STATIC
+VOID
+AddVerifiedImage (
+  IN UINT8  *ImageDigest
+  )
+{
+  CopyMem (mVerifiedImageDigest[mVerifiedImageNext], ImageDigest, SHA256_DIGEST_SIZE);
+  mVerifiedImageNext = (mVerifiedImageNext + 1) % VERIFIED_IMAGE_CACHE_SIZE;
+  if (mVerifiedImageCount < VERIFIED_IMAGE_CACHE_SIZE) {
+    mVerifiedImageCount++;
+  }
+}
+
 /**
   Provide verification service for signed images, which include both signature validation
   and platform policy control. For signature types, both UEFI WIN_CERTIFICATE_UEFI_GUID and
@@ -1690,6 +1992,9 @@ DxeImageVerificationHandler (
   EFI_STATUS                    VarStatus;
   UINT32                        VarAttr;
   BOOLEAN                       IsFound;
+  UINT8                         VerifiedImageDigest[SHA256_DIGEST_SIZE];
+  BOOLEAN                       IsRemembered;
+  BOOLEAN                       CanRemember;
 
   SignatureList     = NULL;
   SignatureListSize = 0;
@@ -1772,6 +2077,14 @@ DxeImageVerificationHandler (
     return EFI_ACCESS_DENIED;
   }
 
+  //
+  // Skip verification if the image passed it with the same security databases.
+  //
+  CanRemember = IsVerifiedImage (FileBuffer, FileSize, VerifiedImageDigest, &IsRemembered);
+  if (IsRemembered) {
+    return EFI_SUCCESS;
+  }
+
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
 
@@ -1871,6 +2184,10 @@ DxeImageVerificationHandler (
       //
       // Image Hash is in allowed database (DB).
       //
+      if (CanRemember) {
+        AddVerifiedImage (VerifiedImageDigest);
+      }
+
       return EFI_SUCCESS;
     }
 
@@ -2007,6 +2324,10 @@ DxeImageVerificationHandler (
   }
 
   if (IsVerified) {
+    if (CanRemember) {
+      AddVerifiedImage (VerifiedImageDigest);
+    }
+
     return EFI_SUCCESS;
   }
 
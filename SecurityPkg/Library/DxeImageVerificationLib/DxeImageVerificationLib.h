@@ -73,6 +73,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
+
+//
+// Number of images whose successful verification is remembered
+//
+#define VERIFIED_IMAGE_CACHE_SIZE  32
+
+//
+// A signature of a security database, in the index of the database
+//
+typedef struct {
+  EFI_GUID              *SignatureType;
+  UINT8                 *Key;
+  UINTN                 KeySize;
+  EFI_SIGNATURE_LIST    *SignatureList;
+  EFI_SIGNATURE_DATA    *Signature;
+} SIGNATURE_INDEX_ENTRY;
 //
 //
 // PKCS7 Certificate definition
@@ -195,4 +211,59 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+/**
+  Drop the indexes of the databases, after their content changed.
+
+**/
+VOID
+SignatureIndexFree (
+  VOID
+  );
+
+/**
+  Tell whether the indexes of the databases may be used.
+
+  The indexes may only be used while the content of the databases is known to
+  be the one they were built from.
+
+  @param[in]  Enable     TRUE if the content of the databases is known.
+
+**/
+VOID
+SignatureIndexEnable (
+  IN BOOLEAN  Enable
+  );
+
+/**
+  Search a signature in a database through its index.
+
+  The signature found is the first one of the database with the given type and
+  key, so the result is the one a walk of the database gets. The key of the
+  X.509 certificate hashes is the hash, the key of the other signatures is the
+  whole signature data.
+
+  @param[in]  VariableName   Name of the database variable.
+  @param[in]  Data           The content of the database.
+  @param[in]  DataSize       The size of the content of the database.
+  @param[in]  SignatureType  The type of the signature.
+  @param[in]  Key            The key of the signature.
+  @param[in]  KeySize        The size of the key.
+  @param[out] Entry          The signature, if found.
+
+  @retval EFI_SUCCESS        The signature is found.
+  @retval EFI_NOT_FOUND      The signature is not in the database.
+  @retval EFI_UNSUPPORTED    The database is not indexed, it must be walked.
+
+**/
+EFI_STATUS
+SignatureIndexFind (
+  IN  CHAR16                 *VariableName,
+  IN  UINT8                  *Data,
+  IN  UINTN                  DataSize,
+  IN  EFI_GUID               *SignatureType,
+  IN  UINT8                  *Key,
+  IN  UINTN                  KeySize,
+  OUT SIGNATURE_INDEX_ENTRY  *Entry
+  );
+
 #endif
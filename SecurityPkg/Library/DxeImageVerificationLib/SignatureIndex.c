@@ -0,0 +1,405 @@
+/** @file
+  Sorted index of the signatures of the image security databases.
+
+  The signatures of a database are sorted by signature type, length and data,
+  so that a hash of the image or of a certificate is looked up by a binary
+  search instead of a walk over every EFI_SIGNATURE_LIST. An index is built
+  from the content of a database the first time it is searched, and dropped
+  when the content of the databases change.
+
+  Caution: This file may receive untrusted input.
+  The content of the databases is checked before it is indexed, a database that
+  is not well formed is not indexed and searched by the callers as before.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+typedef struct {
+  CHAR16                   *VariableName;
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  BOOLEAN                  Malformed;
+  SIGNATURE_INDEX_ENTRY    *Entry;
+  UINTN                    EntryCount;
+} SIGNATURE_INDEX;
+
+STATIC SIGNATURE_INDEX  mSignatureIndex[3];
+STATIC BOOLEAN          mSignatureIndexEnabled = FALSE;
+
+/**
+  Get the size of the part of a signature that is compared by the searches.
+
+  The X.509 certificate hashes are followed by their revocation time, only
+  the hash is compared.
+
+  @param[in]  SignatureType     The type of the signature list.
+  @param[in]  DataSize          The size of the signature data.
+
+  @return The size of the key of the signature.
+
+**/
+STATIC
+UINTN
+GetSignatureKeySize (
+  IN EFI_GUID  *SignatureType,
+  IN UINTN     DataSize
+  )
+{
+  if (CompareGuid (SignatureType, &gEfiCertX509Sha256Guid)) {
+    return SHA256_DIGEST_SIZE;
+  }
+
+  if (CompareGuid (SignatureType, &gEfiCertX509Sha384Guid)) {
+    return SHA384_DIGEST_SIZE;
+  }
+
+  if (CompareGuid (SignatureType, &gEfiCertX509Sha512Guid)) {
+    return SHA512_DIGEST_SIZE;
+  }
+
+  return DataSize;
+}
+
+/**
+  Compare the keys of two signatures.
+
+  @param[in]  Entry1     The first signature.
+  @param[in]  Entry2     The second signature.
+
+  @retval 0      The keys are the same.
+  @retval < 0    Entry1 is sorted before Entry2.
+  @retval > 0    Entry1 is sorted after Entry2.
+
+**/
+STATIC
+INTN
+CompareSignatureKey (
+  IN CONST SIGNATURE_INDEX_ENTRY  *Entry1,
+  IN CONST SIGNATURE_INDEX_ENTRY  *Entry2
+  )
+{
+  INTN  Result;
+
+  Result = CompareMem (Entry1->SignatureType, Entry2->SignatureType, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->KeySize != Entry2->KeySize) {
+    return (Entry1->KeySize < Entry2->KeySize) ? -1 : 1;
+  }
+
+  return CompareMem (Entry1->Key, Entry2->Key, Entry1->KeySize);
+}
+
+/**
+  Compare two signatures of an index, signatures with the same key are kept in
+  the order of the database.
+
+  @param[in]  Buffer1     The first SIGNATURE_INDEX_ENTRY.
+  @param[in]  Buffer2     The second SIGNATURE_INDEX_ENTRY.
+
+  @retval 0      The signatures are the same.
+  @retval < 0    Buffer1 is sorted before Buffer2.
+  @retval > 0    Buffer1 is sorted after Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareSignatureEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST SIGNATURE_INDEX_ENTRY  *Entry1;
+  CONST SIGNATURE_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer2;
+  Result = CompareSignatureKey (Entry1, Entry2);
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->Signature == Entry2->Signature) {
+    return 0;
+  }
+
+  return ((UINTN)Entry1->Signature < (UINTN)Entry2->Signature) ? -1 : 1;
+}
+
+/**
+  Add the signatures of a database to its index, or count them.
+
+  @param[in]  Index         The index, with the copy of the database.
+  @param[in]  Entry         Receives the signatures, or NULL to count them.
+
+  @return The number of signatures, or MAX_UINTN if the database is not well
+          formed.
+
+**/
+STATIC
+UINTN
+CollectSignatures (
+  IN SIGNATURE_INDEX        *Index,
+  IN SIGNATURE_INDEX_ENTRY  *Entry  OPTIONAL
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               Size;
+  UINTN               CertCount;
+  UINTN               CertIndex;
+  UINTN               DataSize;
+  UINTN               KeySize;
+  UINTN               Count;
+
+  Count    = 0;
+  Size     = Index->DataSize;
+  CertList = (EFI_SIGNATURE_LIST *)Index->Data;
+  while (Size > 0) {
+    if ((Size < sizeof (EFI_SIGNATURE_LIST)) ||
+        (CertList->SignatureListSize > Size) ||
+        (CertList->SignatureSize <= sizeof (EFI_GUID)) ||
+        (CertList->SignatureHeaderSize > CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST)))
+    {
+      return MAX_UINTN;
+    }
+
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    DataSize  = CertList->SignatureSize - sizeof (EFI_GUID);
+    KeySize   = GetSignatureKeySize (&CertList->SignatureType, DataSize);
+    if (KeySize <= DataSize) {
+      for (CertIndex = 0; CertIndex < CertCount; CertIndex++) {
+        if (Entry != NULL) {
+          Entry[Count].SignatureType = &CertList->SignatureType;
+          Entry[Count].Key           = Cert->SignatureData;
+          Entry[Count].KeySize       = KeySize;
+          Entry[Count].SignatureList = CertList;
+          Entry[Count].Signature     = Cert;
+        }
+
+        Count++;
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+    }
+
+    Size    -= CertList->SignatureListSize;
+    CertList = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  return Count;
+}
+
+/**
+  Release an index.
+
+  @param[in]  Index      The index.
+
+**/
+STATIC
+VOID
+FreeSignatureIndex (
+  IN SIGNATURE_INDEX  *Index
+  )
+{
+  if (Index->Data != NULL) {
+    FreePool (Index->Data);
+  }
+
+  if (Index->Entry != NULL) {
+    FreePool (Index->Entry);
+  }
+
+  ZeroMem (Index, sizeof (SIGNATURE_INDEX));
+}
+
+/**
+  Drop the indexes of the databases, after their content changed.
+
+**/
+VOID
+SignatureIndexFree (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureIndex); Index++) {
+    FreeSignatureIndex (&mSignatureIndex[Index]);
+  }
+}
+
+/**
+  Tell whether the indexes of the databases may be used.
+
+  The indexes may only be used while the content of the databases is known to
+  be the one they were built from.
+
+  @param[in]  Enable     TRUE if the content of the databases is known.
+
+**/
+VOID
+SignatureIndexEnable (
+  IN BOOLEAN  Enable
+  )
+{
+  mSignatureIndexEnabled = Enable;
+}
+
+/**
+  Get the index of a database, and build it if needed.
+
+  @param[in]  VariableName   Name of the database variable.
+  @param[in]  Data           The content of the database.
+  @param[in]  DataSize       The size of the content of the database.
+
+  @return The index, or NULL if the database is not indexed.
+
+**/
+STATIC
+SIGNATURE_INDEX *
+GetSignatureIndex (
+  IN CHAR16  *VariableName,
+  IN UINT8   *Data,
+  IN UINTN   DataSize
+  )
+{
+  SIGNATURE_INDEX        *Index;
+  SIGNATURE_INDEX_ENTRY  Swap;
+  UINTN                  Slot;
+  UINTN                  Count;
+
+  if (!mSignatureIndexEnabled) {
+    return NULL;
+  }
+
+  Index = NULL;
+  for (Slot = 0; Slot < ARRAY_SIZE (mSignatureIndex); Slot++) {
+    if ((mSignatureIndex[Slot].VariableName != NULL) && (StrCmp (mSignatureIndex[Slot].VariableName, VariableName) == 0)) {
+      Index = &mSignatureIndex[Slot];
+      break;
+    }
+
+    if ((Index == NULL) && (mSignatureIndex[Slot].VariableName == NULL)) {
+      Index = &mSignatureIndex[Slot];
+    }
+  }
+
+  if (Index == NULL) {
+    return NULL;
+  }
+
+  if (Index->VariableName != NULL) {
+    if (Index->DataSize == DataSize) {
+      return Index->Malformed ? NULL : Index;
+    }
+
+    FreeSignatureIndex (Index);
+  }
+
+  Index->VariableName = VariableName;
+  Index->DataSize     = DataSize;
+  Index->Data         = AllocateCopyPool (DataSize, Data);
+  if (Index->Data == NULL) {
+    FreeSignatureIndex (Index);
+    return NULL;
+  }
+
+  Count = CollectSignatures (Index, NULL);
+  if (Count == MAX_UINTN) {
+    FreePool (Index->Data);
+    Index->Data      = NULL;
+    Index->Malformed = TRUE;
+    return NULL;
+  }
+
+  if (Count != 0) {
+    Index->Entry = AllocatePool (Count * sizeof (SIGNATURE_INDEX_ENTRY));
+    if (Index->Entry == NULL) {
+      FreeSignatureIndex (Index);
+      return NULL;
+    }
+
+    CollectSignatures (Index, Index->Entry);
+    QuickSort (Index->Entry, Count, sizeof (SIGNATURE_INDEX_ENTRY), CompareSignatureEntry, &Swap);
+  }
+
+  Index->EntryCount = Count;
+  return Index;
+}
+
+/**
+  Search a signature in a database through its index.
+
+  The signature found is the first one of the database with the given type and
+  key, so the result is the one a walk of the database gets. The key of the
+  X.509 certificate hashes is the hash, the key of the other signatures is the
+  whole signature data.
+
+  @param[in]  VariableName   Name of the database variable.
+  @param[in]  Data           The content of the database.
+  @param[in]  DataSize       The size of the content of the database.
+  @param[in]  SignatureType  The type of the signature.
+  @param[in]  Key            The key of the signature.
+  @param[in]  KeySize        The size of the key.
+  @param[out] Entry          The signature, if found.
+
+  @retval EFI_SUCCESS        The signature is found.
+  @retval EFI_NOT_FOUND      The signature is not in the database.
+  @retval EFI_UNSUPPORTED    The database is not indexed, it must be walked.
+
+**/
+EFI_STATUS
+SignatureIndexFind (
+  IN  CHAR16                 *VariableName,
+  IN  UINT8                  *Data,
+  IN  UINTN                  DataSize,
+  IN  EFI_GUID               *SignatureType,
+  IN  UINT8                  *Key,
+  IN  UINTN                  KeySize,
+  OUT SIGNATURE_INDEX_ENTRY  *Entry
+  )
+{
+  SIGNATURE_INDEX        *Index;
+  SIGNATURE_INDEX_ENTRY  Probe;
+  UINTN                  Low;
+  UINTN                  High;
+  UINTN                  Middle;
+
+  Index = GetSignatureIndex (VariableName, Data, DataSize);
+  if (Index == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Probe.SignatureType = SignatureType;
+  Probe.Key           = Key;
+  Probe.KeySize       = KeySize;
+
+  //
+  // Find the first signature that is not sorted before the key.
+  //
+  Low  = 0;
+  High = Index->EntryCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (CompareSignatureKey (&Index->Entry[Middle], &Probe) < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low == Index->EntryCount) || (CompareSignatureKey (&Index->Entry[Low], &Probe) != 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Entry, &Index->Entry[Low], sizeof (SIGNATURE_INDEX_ENTRY));
+  return EFI_SUCCESS;
+}
@@ -299,31 +299,43 @@ Rsa2048Sha256GuidedSectionHandler (
   }
 
   //
-  // Generate & Initialize RSA Context.
+  // Get the RSA Context of the public key from the RSA public key cache, the
+  // sections signed with the same key share it.
   //
-  Rsa = RsaNew ();
+  Rsa = RsaGetCachedPublicKey (
+          CertBlockRsa2048Sha256->PublicKey,
+          sizeof (CertBlockRsa2048Sha256->PublicKey),
+          mRsaE,
+          sizeof (mRsaE)
+          );
   if (Rsa == NULL) {
-    DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaNew() failed\n"));
-    *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
-    goto Done;
-  }
+    //
+    // Generate & Initialize RSA Context.
+    //
+    Rsa = RsaNew ();
+    if (Rsa == NULL) {
+      DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaNew() failed\n"));
+      *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
+      goto Done;
+    }
 
-  //
-  // Set RSA Key Components.
-  // NOTE: Only N and E are needed to be set as RSA public key for signature verification.
-  //
-  CryptoStatus = RsaSetKey (Rsa, RsaKeyN, CertBlockRsa2048Sha256->PublicKey, sizeof (CertBlockRsa2048Sha256->PublicKey));
-  if (!CryptoStatus) {
-    DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaSetKey(RsaKeyN) failed\n"));
-    *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
-    goto Done;
-  }
+    //
+    // Set RSA Key Components.
+    // NOTE: Only N and E are needed to be set as RSA public key for signature verification.
+    //
+    CryptoStatus = RsaSetKey (Rsa, RsaKeyN, CertBlockRsa2048Sha256->PublicKey, sizeof (CertBlockRsa2048Sha256->PublicKey));
+    if (!CryptoStatus) {
+      DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaSetKey(RsaKeyN) failed\n"));
+      *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
+      goto Done;
+    }
 
-  CryptoStatus = RsaSetKey (Rsa, RsaKeyE, mRsaE, sizeof (mRsaE));
-  if (!CryptoStatus) {
-    DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaSetKey(RsaKeyE) failed\n"));
-    *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
-    goto Done;
+    CryptoStatus = RsaSetKey (Rsa, RsaKeyE, mRsaE, sizeof (mRsaE));
+    if (!CryptoStatus) {
+      DEBUG ((DEBUG_ERROR, "DxeRsa2048Sha256: RsaSetKey(RsaKeyE) failed\n"));
+      *AuthenticationStatus |= EFI_AUTH_STATUS_TEST_FAILED;
+      goto Done;
+    }
   }
 
   //
@@ -151,32 +151,44 @@ FmpAuthenticatedHandlerRsa2048Sha256 (
   }
 
   //
-  // Generate & Initialize RSA Context.
+  // Get the RSA Context of the public key from the RSA public key cache, the
+  // capsules signed with the same key share it.
   //
-  Rsa = RsaNew ();
+  Rsa = RsaGetCachedPublicKey (
+          CertBlockRsa2048Sha256->PublicKey,
+          sizeof (CertBlockRsa2048Sha256->PublicKey),
+          mRsaE,
+          sizeof (mRsaE)
+          );
   if (Rsa == NULL) {
-    CryptoStatus = FALSE;
-    DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaNew() failed\n"));
-    Status = RETURN_OUT_OF_RESOURCES;
-    goto Done;
-  }
+    //
+    // Generate & Initialize RSA Context.
+    //
+    Rsa = RsaNew ();
+    if (Rsa == NULL) {
+      CryptoStatus = FALSE;
+      DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaNew() failed\n"));
+      Status = RETURN_OUT_OF_RESOURCES;
+      goto Done;
+    }
 
-  //
-  // Set RSA Key Components.
-  // NOTE: Only N and E are needed to be set as RSA public key for signature verification.
-  //
-  CryptoStatus = RsaSetKey (Rsa, RsaKeyN, CertBlockRsa2048Sha256->PublicKey, sizeof (CertBlockRsa2048Sha256->PublicKey));
-  if (!CryptoStatus) {
-    DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaSetKey(RsaKeyN) failed\n"));
-    Status = RETURN_OUT_OF_RESOURCES;
-    goto Done;
-  }
+    //
+    // Set RSA Key Components.
+    // NOTE: Only N and E are needed to be set as RSA public key for signature verification.
+    //
+    CryptoStatus = RsaSetKey (Rsa, RsaKeyN, CertBlockRsa2048Sha256->PublicKey, sizeof (CertBlockRsa2048Sha256->PublicKey));
+    if (!CryptoStatus) {
+      DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaSetKey(RsaKeyN) failed\n"));
+      Status = RETURN_OUT_OF_RESOURCES;
+      goto Done;
+    }
 
-  CryptoStatus = RsaSetKey (Rsa, RsaKeyE, mRsaE, sizeof (mRsaE));
-  if (!CryptoStatus) {
-    DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaSetKey(RsaKeyE) failed\n"));
-    Status = RETURN_OUT_OF_RESOURCES;
-    goto Done;
+    CryptoStatus = RsaSetKey (Rsa, RsaKeyE, mRsaE, sizeof (mRsaE));
+    if (!CryptoStatus) {
+      DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerRsa2048Sha256: RsaSetKey(RsaKeyE) failed\n"));
+      Status = RETURN_OUT_OF_RESOURCES;
+      goto Done;
+    }
   }
 
   //
@@ -13,8 +13,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/HashLib.h>
+#include <Library/PcdLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID    Guid;
   UINT32      Mask;
@@ -72,3 +75,59 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count++;
 }
+
+/**
+  The function updates the hash sequence of all the hash engines enabled by
+  PcdTpm2HashMask, in a single pass over the data.
+
+  @param HashInterface      Hash interfaces
+  @param HashInterfaceCount Number of hash interfaces
+  @param HashCtx            Hash contexts, one per hash interface
+  @param DataToHash         Data to be hashed
+  @param DataToHashLen      Data size
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateAll (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  BOOLEAN  Enabled[HASH_COUNT];
+  UINTN    EnabledCount;
+  UINTN    Index;
+  UINT8    *Chunk;
+  UINTN    ChunkSize;
+  UINTN    ChunkLimit;
+
+  ASSERT (HashInterfaceCount <= HASH_COUNT);
+
+  EnabledCount = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    Enabled[Index] = (BOOLEAN)((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & PcdGet32 (PcdTpm2HashMask)) != 0);
+    if (Enabled[Index]) {
+      EnabledCount++;
+    }
+  }
+
+  //
+  // A single engine reads the data once anyway.
+  //
+  ChunkLimit = (EnabledCount > 1) ? HASH_UPDATE_CHUNK_SIZE : MAX_UINTN;
+
+  Chunk = DataToHash;
+  do {
+    ChunkSize = MIN (DataToHashLen, ChunkLimit);
+    for (Index = 0; Index < HashInterfaceCount; Index++) {
+      if (Enabled[Index]) {
+        HashInterface[Index].HashUpdate (HashCtx[Index], Chunk, ChunkSize);
+      }
+    }
+
+    Chunk         += ChunkSize;
+    DataToHashLen -= ChunkSize;
+  } while (DataToHashLen != 0);
+}
@@ -9,6 +9,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// The data of a hash sequence is given to the hash engines one chunk at a time,
+// so that all the engines hash a chunk while it is still in the cache.
+//
+#define HASH_UPDATE_CHUNK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +41,24 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES      *Digest
   );
 
+/**
+  The function updates the hash sequence of all the hash engines enabled by
+  PcdTpm2HashMask, in a single pass over the data.
+
+  @param HashInterface      Hash interfaces
+  @param HashInterfaceCount Number of hash interfaces
+  @param HashCtx            Hash contexts, one per hash interface
+  @param DataToHash         Data to be hashed
+  @param DataToHashLen      Data size
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateAll (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/BaseCryptLib.h>
 #include <Protocol/Pkcs7Verify.h>
+#include <Protocol/Pkcs7BatchVerify.h>
 
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
 
@@ -855,6 +856,9 @@ _Exit:
   @param[in]  AllowedDb       Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which contains lists of X.509 certificates
                               of approved signers.
+  @param[in,out] TrustedIndex Optional index in AllowedDb of the list to try first,
+                              MAX_UINTN if none. On output, the index of the list
+                              that verified the signedData.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is trusted.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -875,7 +879,8 @@ P7CheckTrustByHash (
   IN UINTN               SignedDataSize,
   IN UINT8               *InHash,
   IN UINTN               InHashSize,
-  IN EFI_SIGNATURE_LIST  **AllowedDb
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN OUT UINTN           *TrustedIndex  OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -894,6 +899,23 @@ P7CheckTrustByHash (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Try the list that verified the previous signedData of a batch first, the
+  // signatures of a batch are usually issued by the same signer.
+  //
+  if ((TrustedIndex != NULL) && (*TrustedIndex != MAX_UINTN)) {
+    SigList = (EFI_SIGNATURE_LIST *)(AllowedDb[*TrustedIndex]);
+    SigData = (EFI_SIGNATURE_DATA *)((UINT8 *)SigList + sizeof (EFI_SIGNATURE_LIST) +
+                                     SigList->SignatureHeaderSize);
+
+    TrustCert     = SigData->SignatureData;
+    TrustCertSize = SigList->SignatureSize - sizeof (EFI_GUID);
+
+    if (AuthenticodeVerify (SignedData, SignedDataSize, TrustCert, TrustCertSize, InHash, InHashSize)) {
+      return EFI_SUCCESS;
+    }
+  }
+
   //
   // Build Certificate Stack with all valid X509 certificates in the supplied
   // Signature List for PKCS7 Verification.
@@ -909,12 +931,16 @@ P7CheckTrustByHash (
     }
 
     //
-    // Ignore any non-X509-format entry in the list.
+    // Ignore any non-X509-format entry in the list, and the list already tried.
     //
     if (!CompareGuid (&SigList->SignatureType, &gEfiCertX509Guid)) {
       continue;
     }
 
+    if ((TrustedIndex != NULL) && (*TrustedIndex == Index)) {
+      continue;
+    }
+
     SigData = (EFI_SIGNATURE_DATA *)((UINT8 *)SigList + sizeof (EFI_SIGNATURE_LIST) +
                                      SigList->SignatureHeaderSize);
 
@@ -928,6 +954,10 @@ P7CheckTrustByHash (
       //
       // The SignedData was verified successfully by one entry in Trusted Database
       //
+      if (TrustedIndex != NULL) {
+        *TrustedIndex = Index;
+      }
+
       Status = EFI_SUCCESS;
       break;
     }
@@ -949,6 +979,9 @@ P7CheckTrustByHash (
   @param[in]  AllowedDb       Pointer to a list of pointers to EFI_SIGNATURE_LIST
                               structures which contains lists of X.509 certificates
                               of approved signers.
+  @param[in,out] TrustedIndex Optional index in AllowedDb of the list to try first,
+                              MAX_UINTN if none. On output, the index of the list
+                              that verified the signedData.
 
   @retval  EFI_SUCCESS             The PKCS7 signedData is trusted.
   @retval  EFI_SECURITY_VIOLATION  Fail to verify the signature in PKCS7 signedData.
@@ -969,7 +1002,8 @@ P7CheckTrust (
   IN UINTN               SignedDataSize,
   IN UINT8               *InData,
   IN UINTN               InDataSize,
-  IN EFI_SIGNATURE_LIST  **AllowedDb
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN OUT UINTN           *TrustedIndex  OPTIONAL
   )
 {
   EFI_STATUS          Status;
@@ -988,6 +1022,23 @@ P7CheckTrust (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Try the list that verified the previous signedData of a batch first, the
+  // signatures of a batch are usually issued by the same signer.
+  //
+  if ((TrustedIndex != NULL) && (*TrustedIndex != MAX_UINTN)) {
+    SigList = (EFI_SIGNATURE_LIST *)(AllowedDb[*TrustedIndex]);
+    SigData = (EFI_SIGNATURE_DATA *)((UINT8 *)SigList + sizeof (EFI_SIGNATURE_LIST) +
+                                     SigList->SignatureHeaderSize);
+
+    TrustCert     = SigData->SignatureData;
+    TrustCertSize = SigList->SignatureSize - sizeof (EFI_GUID);
+
+    if (Pkcs7Verify (SignedData, SignedDataSize, TrustCert, TrustCertSize, InData, InDataSize)) {
+      return EFI_SUCCESS;
+    }
+  }
+
   //
   // Build Certificate Stack with all valid X509 certificates in the supplied
   // Signature List for PKCS7 Verification.
@@ -1003,12 +1054,16 @@ P7CheckTrust (
     }
 
     //
-    // Ignore any non-X509-format entry in the list.
+    // Ignore any non-X509-format entry in the list, and the list already tried.
     //
     if (!CompareGuid (&SigList->SignatureType, &gEfiCertX509Guid)) {
       continue;
     }
 
+    if ((TrustedIndex != NULL) && (*TrustedIndex == Index)) {
+      continue;
+    }
+
     SigData = (EFI_SIGNATURE_DATA *)((UINT8 *)SigList + sizeof (EFI_SIGNATURE_LIST) +
                                      SigList->SignatureHeaderSize);
 
@@ -1022,6 +1077,10 @@ P7CheckTrust (
       //
       // The SignedData was verified successfully by one entry in Trusted Database
       //
+      if (TrustedIndex != NULL) {
+        *TrustedIndex = Index;
+      }
+
       Status = EFI_SUCCESS;
       break;
     }
@@ -1030,6 +1089,197 @@ P7CheckTrust (
   return Status;
 }
 
+/**
+  Check whether the entries of a list of signature lists are well formed.
+
+  @param[in]  Db      Pointer to a list of pointers to EFI_SIGNATURE_LIST
+                      structures, terminated by a null pointer.
+
+  @retval  TRUE       All the signature lists are well formed.
+  @retval  FALSE      A signature list has an invalid format.
+
+**/
+STATIC
+BOOLEAN
+IsSignatureDbFormatValid (
+  IN EFI_SIGNATURE_LIST  **Db
+  )
+{
+  EFI_SIGNATURE_LIST  *SigList;
+  UINTN               Index;
+
+  for (Index = 0; ; Index++) {
+    SigList = (EFI_SIGNATURE_LIST *)(Db[Index]);
+
+    if (SigList == NULL) {
+      break;
+    }
+
+    if (SigList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST) +
+        SigList->SignatureHeaderSize +
+        SigList->SignatureSize)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Verify a PKCS7 signedData against signature databases whose format was
+  checked, and return its content if requested.
+
+  @param[in]      SignedData      Points to buffer containing ASN.1 DER-encoded PKCS7
+                                  signature.
+  @param[in]      SignedDataSize  The size of SignedData buffer in bytes.
+  @param[in]      InData          The detached content, or NULL.
+  @param[in]      InDataSize      The size of InData buffer in bytes.
+  @param[in]      AllowedDb       The list of trusted signature lists.
+  @param[in]      RevokedDb       The list of revoked signature lists, or NULL.
+  @param[in]      TimeStampDb     The list of time stamp signature lists, or NULL.
+  @param[out]     Content         The optional buffer that receives the content.
+  @param[in, out] ContentSize     The size of the Content buffer.
+  @param[in, out] TrustedIndex    Optional index in AllowedDb of the list to try
+                                  first, updated on success. See P7CheckTrust ().
+
+  @return The status EFI_PKCS7_VERIFY_PROTOCOL.VerifyBuffer () returns.
+
+**/
+STATIC
+EFI_STATUS
+VerifyBufferWithDb (
+  IN VOID                *SignedData,
+  IN UINTN               SignedDataSize,
+  IN VOID                *InData          OPTIONAL,
+  IN UINTN               InDataSize,
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN EFI_SIGNATURE_LIST  **RevokedDb      OPTIONAL,
+  IN EFI_SIGNATURE_LIST  **TimeStampDb    OPTIONAL,
+  OUT VOID               *Content         OPTIONAL,
+  IN OUT UINTN           *ContentSize,
+  IN OUT UINTN           *TrustedIndex    OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *AttachedData;
+  UINTN       AttachedDataSize;
+  UINT8       *DataPtr;
+  UINTN       DataSize;
+
+  //
+  // Try to retrieve the attached content from PKCS7 signedData
+  //
+  AttachedData     = NULL;
+  AttachedDataSize = 0;
+  if (!Pkcs7GetAttachedContent (
+         SignedData,
+         SignedDataSize,
+         (VOID **)&AttachedData,
+         &AttachedDataSize
+         ))
+  {
+    //
+    // The SignedData buffer was not correctly formatted for processing
+    //
+    return EFI_UNSUPPORTED;
+  }
+
+  if (AttachedData != NULL) {
+    if (InData != NULL) {
+      //
+      // The embedded content is found in SignedData but InData is not NULL
+      //
+      Status = EFI_UNSUPPORTED;
+      goto _Exit;
+    }
+
+    //
+    // PKCS7-formatted signedData with attached content; Use the embedded
+    // content for verification
+    //
+    DataPtr  = AttachedData;
+    DataSize = AttachedDataSize;
+  } else if (InData != NULL) {
+    //
+    // PKCS7-formatted signedData with detached content; Use the user-supplied
+    // input data for verification
+    //
+    DataPtr  = (UINT8 *)InData;
+    DataSize = InDataSize;
+  } else {
+    //
+    // Content not found because InData is NULL and no content attached in SignedData
+    //
+    Status = EFI_NOT_FOUND;
+    goto _Exit;
+  }
+
+  Status = EFI_UNSUPPORTED;
+
+  //
+  // Verify PKCS7 SignedData with Revoked database
+  //
+  if (RevokedDb != NULL) {
+    Status = P7CheckRevocation (
+               SignedData,
+               SignedDataSize,
+               DataPtr,
+               DataSize,
+               RevokedDb,
+               TimeStampDb
+               );
+    if (!EFI_ERROR (Status)) {
+      //
+      // The PKCS7 SignedData is revoked
+      //
+      Status = EFI_SECURITY_VIOLATION;
+      goto _Exit;
+    }
+  }
+
+  //
+  // Verify PKCS7 SignedData with AllowedDB
+  //
+  Status = P7CheckTrust (
+             SignedData,
+             SignedDataSize,
+             DataPtr,
+             DataSize,
+             AllowedDb,
+             TrustedIndex
+             );
+  if (EFI_ERROR (Status)) {
+    //
+    // Verification failed with AllowedDb
+    //
+    goto _Exit;
+  }
+
+  //
+  // Copy the content portion after verification succeeds
+  //
+  if (Content != NULL) {
+    if (*ContentSize < DataSize) {
+      //
+      // Caller-allocated buffer is too small to contain content
+      //
+      *ContentSize = DataSize;
+      Status       = EFI_BUFFER_TOO_SMALL;
+    } else {
+      *ContentSize = DataSize;
+      CopyMem (Content, DataPtr, DataSize);
+    }
+  }
+
+_Exit:
+  if (AttachedData != NULL) {
+    FreePool (AttachedData);
+  }
+
+  return Status;
+}
+
 /**
   Processes a buffer containing binary DER-encoded PKCS7 signature.
   The signed data content may be embedded within the buffer or separated. Function
@@ -1131,14 +1381,6 @@ VerifyBuffer (
   IN OUT UINTN                  *ContentSize
   )
 {
-  EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *SigList;
-  UINTN               Index;
-  UINT8               *AttachedData;
-  UINTN               AttachedDataSize;
-  UINT8               *DataPtr;
-  UINTN               DataSize;
-
   //
   // Parameters Checking
   //
@@ -1151,171 +1393,95 @@ VerifyBuffer (
   }
 
   //
-  // Check if any invalid entry format in AllowedDb list contents
-  //
-  for (Index = 0; ; Index++) {
-    SigList = (EFI_SIGNATURE_LIST *)(AllowedDb[Index]);
-
-    if (SigList == NULL) {
-      break;
-    }
-
-    if (SigList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST) +
-        SigList->SignatureHeaderSize +
-        SigList->SignatureSize)
-    {
-      return EFI_ABORTED;
-    }
-  }
-
-  //
-  // Check if any invalid entry format in RevokedDb list contents
-  //
-  if (RevokedDb != NULL) {
-    for (Index = 0; ; Index++) {
-      SigList = (EFI_SIGNATURE_LIST *)(RevokedDb[Index]);
-
-      if (SigList == NULL) {
-        break;
-      }
-
-      if (SigList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST) +
-          SigList->SignatureHeaderSize +
-          SigList->SignatureSize)
-      {
-        return EFI_ABORTED;
-      }
-    }
-  }
-
-  //
-  // Check if any invalid entry format in TimeStampDb list contents
-  //
-  if (TimeStampDb != NULL) {
-    for (Index = 0; ; Index++) {
-      SigList = (EFI_SIGNATURE_LIST *)(TimeStampDb[Index]);
-
-      if (SigList == NULL) {
-        break;
-      }
-
-      if (SigList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST) +
-          SigList->SignatureHeaderSize +
-          SigList->SignatureSize)
-      {
-        return EFI_ABORTED;
-      }
-    }
-  }
-
-  //
-  // Try to retrieve the attached content from PKCS7 signedData
+  // Check if any invalid entry format in AllowedDb, RevokedDb or TimeStampDb
+  // list contents
   //
-  AttachedData     = NULL;
-  AttachedDataSize = 0;
-  if (!Pkcs7GetAttachedContent (
-         SignedData,
-         SignedDataSize,
-         (VOID **)&AttachedData,
-         &AttachedDataSize
-         ))
+  if (  !IsSignatureDbFormatValid (AllowedDb)
+     || ((RevokedDb != NULL) && !IsSignatureDbFormatValid (RevokedDb))
+     || ((TimeStampDb != NULL) && !IsSignatureDbFormatValid (TimeStampDb)))
   {
-    //
-    // The SignedData buffer was not correctly formatted for processing
-    //
-    return EFI_UNSUPPORTED;
+    return EFI_ABORTED;
   }
 
-  if (AttachedData != NULL) {
-    if (InData != NULL) {
-      //
-      // The embedded content is found in SignedData but InData is not NULL
-      //
-      Status = EFI_UNSUPPORTED;
-      goto _Exit;
-    }
+  return VerifyBufferWithDb (
+           SignedData,
+           SignedDataSize,
+           InData,
+           InDataSize,
+           AllowedDb,
+           RevokedDb,
+           TimeStampDb,
+           Content,
+           ContentSize,
+           NULL
+           );
+}
 
-    //
-    // PKCS7-formatted signedData with attached content; Use the embedded
-    // content for verification
-    //
-    DataPtr  = AttachedData;
-    DataSize = AttachedDataSize;
-  } else if (InData != NULL) {
-    //
-    // PKCS7-formatted signedData with detached content; Use the user-supplied
-    // input data for verification
-    //
-    DataPtr  = (UINT8 *)InData;
-    DataSize = InDataSize;
-  } else {
-    //
-    // Content not found because InData is NULL and no content attached in SignedData
-    //
-    Status = EFI_NOT_FOUND;
-    goto _Exit;
-  }
+/**
+  Verify a detached PKCS7 signature of a caller calculated hash against
+  signature databases.
+
+  @param[in]      Signature       Points to buffer containing ASN.1 DER-encoded PKCS
+                                  detached signature.
+  @param[in]      SignatureSize   The size of Signature buffer in bytes.
+  @param[in]      InHash          The caller calculated hash of the data.
+  @param[in]      InHashSize      The size in bytes of InHash buffer.
+  @param[in]      AllowedDb       The list of trusted signature lists.
+  @param[in]      RevokedDb       The list of revoked signature lists, or NULL.
+  @param[in]      TimeStampDb     The list of time stamp signature lists, or NULL.
+  @param[in, out] TrustedIndex    Optional index in AllowedDb of the list to try
+                                  first, updated on success. See P7CheckTrustByHash ().
+
+  @return The status EFI_PKCS7_VERIFY_PROTOCOL.VerifySignature () returns.
 
-  Status = EFI_UNSUPPORTED;
+**/
+STATIC
+EFI_STATUS
+VerifySignatureWithDb (
+  IN VOID                *Signature,
+  IN UINTN               SignatureSize,
+  IN VOID                *InHash,
+  IN UINTN               InHashSize,
+  IN EFI_SIGNATURE_LIST  **AllowedDb,
+  IN EFI_SIGNATURE_LIST  **RevokedDb       OPTIONAL,
+  IN EFI_SIGNATURE_LIST  **TimeStampDb     OPTIONAL,
+  IN OUT UINTN           *TrustedIndex     OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
 
   //
   // Verify PKCS7 SignedData with Revoked database
   //
   if (RevokedDb != NULL) {
-    Status = P7CheckRevocation (
-               SignedData,
-               SignedDataSize,
-               DataPtr,
-               DataSize,
+    Status = P7CheckRevocationByHash (
+               Signature,
+               SignatureSize,
+               InHash,
+               InHashSize,
                RevokedDb,
                TimeStampDb
                );
+
     if (!EFI_ERROR (Status)) {
       //
       // The PKCS7 SignedData is revoked
       //
-      Status = EFI_SECURITY_VIOLATION;
-      goto _Exit;
+      return EFI_SECURITY_VIOLATION;
     }
   }
 
   //
   // Verify PKCS7 SignedData with AllowedDB
   //
-  Status = P7CheckTrust (
-             SignedData,
-             SignedDataSize,
-             DataPtr,
-             DataSize,
-             AllowedDb
+  Status = P7CheckTrustByHash (
+             Signature,
+             SignatureSize,
+             InHash,
+             InHashSize,
+             AllowedDb,
+             TrustedIndex
              );
-  if (EFI_ERROR (Status)) {
-    //
-    // Verification failed with AllowedDb
-    //
-    goto _Exit;
-  }
-
-  //
-  // Copy the content portion after verification succeeds
-  //
-  if (Content != NULL) {
-    if (*ContentSize < DataSize) {
-      //
-      // Caller-allocated buffer is too small to contain content
-      //
-      *ContentSize = DataSize;
-      Status       = EFI_BUFFER_TOO_SMALL;
-    } else {
-      *ContentSize = DataSize;
-      CopyMem (Content, DataPtr, DataSize);
-    }
-  }
-
-_Exit:
-  if (AttachedData != NULL) {
-    FreePool (AttachedData);
-  }
 
   return Status;
 }
@@ -1399,8 +1565,6 @@ VerifySignature (
   IN EFI_SIGNATURE_LIST         **TimeStampDb     OPTIONAL
   )
 {
-  EFI_STATUS  Status;
-
   //
   // Parameters Checking
   //
@@ -1410,37 +1574,174 @@ VerifySignature (
     return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Verify PKCS7 SignedData with Revoked database
-  //
-  if (RevokedDb != NULL) {
-    Status = P7CheckRevocationByHash (
-               Signature,
-               SignatureSize,
-               InHash,
-               InHashSize,
-               RevokedDb,
-               TimeStampDb
-               );
+  return VerifySignatureWithDb (
+           Signature,
+           SignatureSize,
+           InHash,
+           InHashSize,
+           AllowedDb,
+           RevokedDb,
+           TimeStampDb,
+           NULL
+           );
+}
 
-    if (!EFI_ERROR (Status)) {
-      //
-      // The PKCS7 SignedData is revoked
-      //
-      return EFI_SECURITY_VIOLATION;
+/**
+  Processes several buffers containing binary DER-encoded PKCS7 signatures, as
+  VerifyBuffer () does for one of them.
+
+  The signature databases are checked once for the batch, and the certificate
+  of AllowedDb that verified a signature is tried first for the next ones.
+
+  @param[in]     This                 Pointer to EDKII_PKCS7_BATCH_VERIFY_PROTOCOL instance.
+  @param[in,out] Entries              The signatures to verify. The Status of each entry
+                                      receives its result.
+  @param[in]     EntryCount           The number of entries.
+  @param[in]     AllowedDb            Pointer to a list of pointers to EFI_SIGNATURE_LIST
+                                      structures of approved signers.
+  @param[in]     RevokedDb            Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of revoked signers and
+                                      revoked file hashes.
+  @param[in]     TimeStampDb          Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of trusted time stamp
+                                      signers.
+
+  @retval EFI_SUCCESS                 All the signatures were verified.
+  @retval EFI_INVALID_PARAMETER       Entries is NULL, EntryCount is zero or AllowedDb is
+                                      NULL.
+  @retval EFI_ABORTED                 Unsupported or invalid format in TimeStampDb,
+                                      RevokedDb or AllowedDb list contents was detected.
+  @retval Others                      The Status of the first entry that failed to verify.
+
+**/
+EFI_STATUS
+EFIAPI
+VerifyBuffers (
+  IN EDKII_PKCS7_BATCH_VERIFY_PROTOCOL    *This,
+  IN OUT EDKII_PKCS7_VERIFY_BUFFER_ENTRY  *Entries,
+  IN UINTN                                EntryCount,
+  IN EFI_SIGNATURE_LIST                   **AllowedDb,
+  IN EFI_SIGNATURE_LIST                   **RevokedDb      OPTIONAL,
+  IN EFI_SIGNATURE_LIST                   **TimeStampDb    OPTIONAL
+  )
+{
+  EFI_STATUS                       Status;
+  EDKII_PKCS7_VERIFY_BUFFER_ENTRY  *Entry;
+  UINTN                            Index;
+  UINTN                            TrustedIndex;
+
+  if ((Entries == NULL) || (EntryCount == 0) || (AllowedDb == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (  !IsSignatureDbFormatValid (AllowedDb)
+     || ((RevokedDb != NULL) && !IsSignatureDbFormatValid (RevokedDb))
+     || ((TimeStampDb != NULL) && !IsSignatureDbFormatValid (TimeStampDb)))
+  {
+    return EFI_ABORTED;
+  }
+
+  Status       = EFI_SUCCESS;
+  TrustedIndex = MAX_UINTN;
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entry = &Entries[Index];
+    if ((Entry->SignedData == NULL) || (Entry->SignedDataSize == 0)) {
+      Entry->Status = EFI_INVALID_PARAMETER;
+    } else {
+      Entry->Status = VerifyBufferWithDb (
+                        Entry->SignedData,
+                        Entry->SignedDataSize,
+                        Entry->InData,
+                        Entry->InDataSize,
+                        AllowedDb,
+                        RevokedDb,
+                        TimeStampDb,
+                        Entry->Content,
+                        &Entry->ContentSize,
+                        &TrustedIndex
+                        );
+    }
+
+    if (EFI_ERROR (Entry->Status) && !EFI_ERROR (Status)) {
+      Status = Entry->Status;
     }
   }
 
-  //
-  // Verify PKCS7 SignedData with AllowedDB
-  //
-  Status = P7CheckTrustByHash (
-             Signature,
-             SignatureSize,
-             InHash,
-             InHashSize,
-             AllowedDb
-             );
+  return Status;
+}
+
+/**
+  Processes several buffers containing binary DER-encoded detached PKCS7
+  signatures of caller calculated hashes, as VerifySignature () does for one
+  of them.
+
+  The certificate of AllowedDb that verified a signature is tried first for the
+  next ones.
+
+  @param[in]     This                 Pointer to EDKII_PKCS7_BATCH_VERIFY_PROTOCOL instance.
+  @param[in,out] Entries              The signatures to verify. The Status of each entry
+                                      receives its result.
+  @param[in]     EntryCount           The number of entries.
+  @param[in]     AllowedDb            Pointer to a list of pointers to EFI_SIGNATURE_LIST
+                                      structures of approved signers.
+  @param[in]     RevokedDb            Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of revoked signers and
+                                      revoked file hashes.
+  @param[in]     TimeStampDb          Optional pointer to a list of pointers to
+                                      EFI_SIGNATURE_LIST structures of trusted time stamp
+                                      counter-signers.
+
+  @retval EFI_SUCCESS                 All the signatures were verified.
+  @retval EFI_INVALID_PARAMETER       Entries is NULL, EntryCount is zero or AllowedDb is
+                                      NULL.
+  @retval Others                      The Status of the first entry that failed to verify.
+
+**/
+EFI_STATUS
+EFIAPI
+VerifySignatures (
+  IN EDKII_PKCS7_BATCH_VERIFY_PROTOCOL       *This,
+  IN OUT EDKII_PKCS7_VERIFY_SIGNATURE_ENTRY  *Entries,
+  IN UINTN                                   EntryCount,
+  IN EFI_SIGNATURE_LIST                      **AllowedDb,
+  IN EFI_SIGNATURE_LIST                      **RevokedDb      OPTIONAL,
+  IN EFI_SIGNATURE_LIST                      **TimeStampDb    OPTIONAL
+  )
+{
+  EFI_STATUS                          Status;
+  EDKII_PKCS7_VERIFY_SIGNATURE_ENTRY  *Entry;
+  UINTN                               Index;
+  UINTN                               TrustedIndex;
+
+  if ((Entries == NULL) || (EntryCount == 0) || (AllowedDb == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status       = EFI_SUCCESS;
+  TrustedIndex = MAX_UINTN;
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entry = &Entries[Index];
+    if (  (Entry->Signature == NULL) || (Entry->SignatureSize == 0)
+       || (Entry->InHash == NULL) || (Entry->InHashSize == 0))
+    {
+      Entry->Status = EFI_INVALID_PARAMETER;
+    } else {
+      Entry->Status = VerifySignatureWithDb (
+                        Entry->Signature,
+                        Entry->SignatureSize,
+                        Entry->InHash,
+                        Entry->InHashSize,
+                        AllowedDb,
+                        RevokedDb,
+                        TimeStampDb,
+                        &TrustedIndex
+                        );
+    }
+
+    if (EFI_ERROR (Entry->Status) && !EFI_ERROR (Status)) {
+      Status = Entry->Status;
+    }
+  }
 
   return Status;
 }
@@ -1453,6 +1754,14 @@ EFI_PKCS7_VERIFY_PROTOCOL  mPkcs7Verify = {
   VerifySignature
 };
 
+//
+// The PKCS7 Batch Verification Protocol
+//
+EDKII_PKCS7_BATCH_VERIFY_PROTOCOL  mPkcs7BatchVerify = {
+  VerifyBuffers,
+  VerifySignatures
+};
+
 /**
   The user Entry Point for the PKCS7 Verification driver.
 
@@ -1484,13 +1793,15 @@ Pkcs7VerifyDriverEntry (
   }
 
   //
-  // Install UEFI Pkcs7 Verification Protocol
+  // Install UEFI Pkcs7 Verification Protocol and its batch extension
   //
   Handle = NULL;
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &Handle,
                   &gEfiPkcs7VerifyProtocolGuid,
                   &mPkcs7Verify,
+                  &gEdkiiPkcs7BatchVerifyProtocolGuid,
+                  &mPkcs7BatchVerify,
                   NULL
                   );
 
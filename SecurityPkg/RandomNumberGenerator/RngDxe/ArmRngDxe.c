@@ -103,7 +103,7 @@ RngGetRNG (
 
 FoundAlgo:
   if (CompareGuid (RNGAlgorithm, PcdGetPtr (PcdCpuRngSupportedAlgorithm))) {
-    Status = RngGetBytes (RNGValueLength, RNGValue);
+    Status = RngPoolGetBytes (RNGValueLength, RNGValue);
     return Status;
   }
 
@@ -108,7 +108,7 @@ RngGetRNG (
   // NIST SP800-90-AES-CTR-256 supported by RDRAND
   //
   if (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmSp80090Ctr256Guid)) {
-    Status = RngGetBytes (RNGValueLength, RNGValue);
+    Status = RngPoolGetBytes (RNGValueLength, RNGValue);
     return Status;
   }
 
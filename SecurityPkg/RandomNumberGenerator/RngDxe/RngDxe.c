@@ -75,6 +75,8 @@ RngDriverEntry (
     return EFI_REQUEST_UNLOAD_IMAGE;
   }
 
+  RngPoolInit ();
+
   //
   // Install UEFI RNG (Random Number Generator) Protocol
   //
@@ -86,6 +88,7 @@ RngDriverEntry (
                   NULL
                   );
   if (EFI_ERROR (Status)) {
+    RngPoolFree ();
     FreeAvailableAlgorithms ();
   }
 
@@ -111,8 +114,9 @@ RngDriverUnLoad (
   )
 {
   //
-  // Free the list of available algorithm.
+  // Free the pool of random bytes and the list of available algorithm.
   //
+  RngPoolFree ();
   FreeAvailableAlgorithms ();
   return EFI_SUCCESS;
 }
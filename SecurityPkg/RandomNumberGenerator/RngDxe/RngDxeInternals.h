@@ -135,4 +135,44 @@ GenerateEntropy (
   OUT UINT8  *Entropy
   );
 
+/**
+  Allocate and fill the pool, if PcdRngPoolSize is not zero.
+
+  The driver runs without pool if it cannot be set up.
+
+**/
+VOID
+RngPoolInit (
+  VOID
+  );
+
+/**
+  Erase and free the pool.
+
+**/
+VOID
+RngPoolFree (
+  VOID
+  );
+
+/**
+  Fill a buffer with random bytes of the default algorithm, taken from the pool
+  when it holds enough of them.
+
+  A request larger than half the pool, or that the pool cannot serve, runs the
+  CPU RNG instruction directly.
+
+  @param[in]   Length        Size of the buffer, in bytes, to fill with.
+  @param[out]  RandBuffer    Pointer to the buffer to store the random result.
+
+  @retval EFI_SUCCESS        Random bytes generation succeeded.
+  @retval EFI_NOT_READY      Failed to request random bytes.
+
+**/
+EFI_STATUS
+RngPoolGetBytes (
+  IN UINTN   Length,
+  OUT UINT8  *RandBuffer
+  );
+
 #endif // RNGDXE_INTERNALS_H_
@@ -0,0 +1,235 @@
+/** @file
+  Pool of random bytes for the default algorithm of the RNG driver.
+
+  Many consumers (TLS, TCP initial sequence numbers, random identifiers) ask
+  for a few bytes at a time, and each request otherwise runs the CPU RNG
+  instruction loop. When PcdRngPoolSize is not zero, the driver keeps that many
+  bytes generated by the same instructions ahead of time. A request takes its
+  bytes from the pool, which are erased as they are handed out so that a byte
+  is never returned twice nor kept once returned, and the pool is refilled
+  from an event at TPL_CALLBACK once it is half empty.
+
+  The pool only serves the default algorithm; EFI_RNG_ALGORITHM_RAW and the
+  conditioning of the seeds always run the instructions on request.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Guid/EventGroup.h>
+
+#include "RngDxeInternals.h"
+
+//
+// Size of the bytes the refill generates before taking them into the pool.
+//
+#define RNG_POOL_CHUNK_SIZE  64
+
+STATIC UINT8      *mRngPool;
+STATIC UINTN      mRngPoolSize;
+STATIC UINTN      mRngPoolLevel;
+STATIC EFI_EVENT  mRngPoolRefillEvent;
+STATIC EFI_EVENT  mRngPoolExitBootServicesEvent;
+
+/**
+  Refill the pool.
+
+  The bytes are generated at the TPL of the event, only their copy into the
+  pool is done at TPL_NOTIFY.
+
+  @param[in]  Event      Event whose notification function is being invoked.
+  @param[in]  Context    Not used.
+
+**/
+STATIC
+VOID
+EFIAPI
+RngPoolRefill (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  UINT8       Chunk[RNG_POOL_CHUNK_SIZE];
+  UINTN       Length;
+  BOOLEAN     Full;
+
+  if (mRngPool == NULL) {
+    return;
+  }
+
+  do {
+    Status = RngGetBytes (sizeof (Chunk), Chunk);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Length = MIN (sizeof (Chunk), mRngPoolSize - mRngPoolLevel);
+    CopyMem (mRngPool + mRngPoolLevel, Chunk, Length);
+    mRngPoolLevel += Length;
+    Full           = (BOOLEAN)(mRngPoolLevel == mRngPoolSize);
+    gBS->RestoreTPL (OldTpl);
+  } while (!Full);
+
+  ZeroMem (Chunk, sizeof (Chunk));
+}
+
+/**
+  Erase the pool when the OS takes over, the driver is not used anymore.
+
+  @param[in]  Event      Event whose notification function is being invoked.
+  @param[in]  Context    Not used.
+
+**/
+STATIC
+VOID
+EFIAPI
+RngPoolOnExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  if (mRngPool != NULL) {
+    ZeroMem (mRngPool, mRngPoolSize);
+    mRngPoolLevel = 0;
+  }
+}
+
+/**
+  Allocate and fill the pool, if PcdRngPoolSize is not zero.
+
+  The driver runs without pool if it cannot be set up.
+
+**/
+VOID
+RngPoolInit (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  mRngPoolSize = PcdGet32 (PcdRngPoolSize);
+  if (mRngPoolSize == 0) {
+    return;
+  }
+
+  mRngPool = AllocateZeroPool (mRngPoolSize);
+  if (mRngPool == NULL) {
+    return;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  RngPoolRefill,
+                  NULL,
+                  &mRngPoolRefillEvent
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    RngPoolOnExitBootServices,
+                    NULL,
+                    &gEfiEventExitBootServicesGuid,
+                    &mRngPoolExitBootServicesEvent
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: the random bytes are not pooled - %r\n", __func__, Status));
+    RngPoolFree ();
+    return;
+  }
+
+  RngPoolRefill (mRngPoolRefillEvent, NULL);
+}
+
+/**
+  Erase and free the pool.
+
+**/
+VOID
+RngPoolFree (
+  VOID
+  )
+{
+  if (mRngPoolExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (mRngPoolExitBootServicesEvent);
+    mRngPoolExitBootServicesEvent = NULL;
+  }
+
+  if (mRngPoolRefillEvent != NULL) {
+    gBS->CloseEvent (mRngPoolRefillEvent);
+    mRngPoolRefillEvent = NULL;
+  }
+
+  if (mRngPool != NULL) {
+    ZeroMem (mRngPool, mRngPoolSize);
+    FreePool (mRngPool);
+    mRngPool = NULL;
+  }
+
+  mRngPoolSize  = 0;
+  mRngPoolLevel = 0;
+}
+
+/**
+  Fill a buffer with random bytes of the default algorithm, taken from the pool
+  when it holds enough of them.
+
+  A request larger than half the pool, or that the pool cannot serve, runs the
+  CPU RNG instruction directly.
+
+  @param[in]   Length        Size of the buffer, in bytes, to fill with.
+  @param[out]  RandBuffer    Pointer to the buffer to store the random result.
+
+  @retval EFI_SUCCESS        Random bytes generation succeeded.
+  @retval EFI_NOT_READY      Failed to request random bytes.
+
+**/
+EFI_STATUS
+RngPoolGetBytes (
+  IN UINTN   Length,
+  OUT UINT8  *RandBuffer
+  )
+{
+  EFI_TPL  OldTpl;
+  BOOLEAN  Served;
+  BOOLEAN  Refill;
+
+  if ((mRngPool == NULL) || (Length > mRngPoolSize / 2)) {
+    return RngGetBytes (Length, RandBuffer);
+  }
+
+  //
+  // The bytes are taken from the end of the pool, and erased from it.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Served = (BOOLEAN)(mRngPoolLevel >= Length);
+  if (Served) {
+    mRngPoolLevel -= Length;
+    CopyMem (RandBuffer, mRngPool + mRngPoolLevel, Length);
+    ZeroMem (mRngPool + mRngPoolLevel, Length);
+  }
+
+  Refill = (BOOLEAN)(mRngPoolLevel < mRngPoolSize / 2);
+  gBS->RestoreTPL (OldTpl);
+
+  if (Refill) {
+    gBS->SignalEvent (mRngPoolRefillEvent);
+  }
+
+  if (!Served) {
+    return RngGetBytes (Length, RandBuffer);
+  }
+
+  return EFI_SUCCESS;
+}
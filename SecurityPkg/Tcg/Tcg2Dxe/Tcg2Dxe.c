@@ -1535,6 +1535,38 @@ EFI_TCG2_PROTOCOL  mTcg2Protocol = {
   Tcg2GetResultOfSetActivePcrBanks,
 };
 
+/**
+  Get the size of the events the PEI phase passed for an event log format.
+
+  @param[in]   EventGuid      The GUID of the HOBs that hold the events.
+  @param[out]  MaxEventSize   The size of the largest event.
+
+  @return The size of all the events.
+
+**/
+STATIC
+UINTN
+GetPeiEventLogSize (
+  IN  EFI_GUID  *EventGuid,
+  OUT UINTN     *MaxEventSize
+  )
+{
+  EFI_PEI_HOB_POINTERS  GuidHob;
+  UINTN                 Size;
+
+  Size          = 0;
+  *MaxEventSize = 0;
+  for (GuidHob.Raw = GetNextGuidHob (EventGuid, GetHobList ());
+       GuidHob.Raw != NULL;
+       GuidHob.Raw = GetNextGuidHob (EventGuid, GET_NEXT_HOB (GuidHob)))
+  {
+    Size         += GET_GUID_HOB_DATA_SIZE (GuidHob.Guid);
+    *MaxEventSize = MAX (*MaxEventSize, GET_GUID_HOB_DATA_SIZE (GuidHob.Guid));
+  }
+
+  return Size;
+}
+
 /**
   Initialize the Event Log and log events passed from the PEI phase.
 
@@ -1568,6 +1600,9 @@ SetupEventLog (
   UINT8                            *VendorInfoSize;
   UINT32                           NumberOfAlgorithms;
   TCG_EfiStartupLocalityEvent      StartupLocalityEvent;
+  UINTN                            Laml;
+  UINTN                            PeiEventLogSize;
+  UINTN                            PeiMaxEventSize;
 
   DEBUG ((DEBUG_INFO, "SetupEventLog\n"));
 
@@ -1577,18 +1612,32 @@ SetupEventLog (
   for (Index = 0; Index < sizeof (mTcg2EventInfo)/sizeof (mTcg2EventInfo[0]); Index++) {
     if ((mTcgDxeData.BsCap.SupportedEventLogs & mTcg2EventInfo[Index].LogFormat) != 0) {
       mTcgDxeData.EventLogAreaStruct[Index].EventLogFormat = mTcg2EventInfo[Index].LogFormat;
+
+      //
+      // The log area is sized once for the whole boot. The events passed by the
+      // PEI phase are added to PcdTcgLogAreaMinLen, so that they do not take the
+      // room left to the events measured from now on.
+      //
+      PeiEventLogSize = GetPeiEventLogSize (mTcg2EventInfo[Index].EventGuid, &PeiMaxEventSize);
+      Laml            = PcdGet32 (PcdTcgLogAreaMinLen);
+      if (PeiEventLogSize <= MAX_UINT32 - EFI_PAGE_SIZE - Laml) {
+        Laml = EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (Laml + PeiEventLogSize));
+      }
+
+      DEBUG ((DEBUG_INFO, "  PeiEventLogSize - 0x%x, Laml - 0x%x\n", PeiEventLogSize, Laml));
+
       if (PcdGet8 (PcdTpm2AcpiTableRev) >= 4) {
         Status = gBS->AllocatePages (
                         AllocateAnyPages,
                         EfiACPIMemoryNVS,
-                        EFI_SIZE_TO_PAGES (PcdGet32 (PcdTcgLogAreaMinLen)),
+                        EFI_SIZE_TO_PAGES (Laml),
                         &Lasa
                         );
       } else {
         Status = gBS->AllocatePages (
                         AllocateAnyPages,
                         EfiBootServicesData,
-                        EFI_SIZE_TO_PAGES (PcdGet32 (PcdTcgLogAreaMinLen)),
+                        EFI_SIZE_TO_PAGES (Laml),
                         &Lasa
                         );
       }
@@ -1598,7 +1647,7 @@ SetupEventLog (
       }
 
       mTcgDxeData.EventLogAreaStruct[Index].Lasa                  = Lasa;
-      mTcgDxeData.EventLogAreaStruct[Index].Laml                  = PcdGet32 (PcdTcgLogAreaMinLen);
+      mTcgDxeData.EventLogAreaStruct[Index].Laml                  = Laml;
       mTcgDxeData.EventLogAreaStruct[Index].Next800155EventOffset = 0;
 
       if ((PcdGet8 (PcdTpm2AcpiTableRev) >= 4) ||
@@ -1616,7 +1665,7 @@ SetupEventLog (
       // To initialize them as 0xFF is recommended
       // because the OS can know the last entry for that.
       //
-      SetMem ((VOID *)(UINTN)Lasa, PcdGet32 (PcdTcgLogAreaMinLen), 0xFF);
+      SetMem ((VOID *)(UINTN)Lasa, Laml, 0xFF);
       //
       // Create first entry for Log Header Entry Data
       //
@@ -1819,13 +1868,27 @@ SetupEventLog (
   Status = EFI_SUCCESS;
   for (Index = 0; Index < sizeof (mTcg2EventInfo)/sizeof (mTcg2EventInfo[0]); Index++) {
     if ((mTcgDxeData.BsCap.SupportedEventLogs & mTcg2EventInfo[Index].LogFormat) != 0) {
+      //
+      // The events are filtered in a copy, one buffer holds each of them in turn.
+      //
+      GetPeiEventLogSize (mTcg2EventInfo[Index].EventGuid, &PeiMaxEventSize);
+      if (PeiMaxEventSize == 0) {
+        Status = EFI_SUCCESS;
+        continue;
+      }
+
+      TcgEvent = AllocatePool (PeiMaxEventSize);
+      ASSERT (TcgEvent != NULL);
+      if (TcgEvent == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
       GuidHob.Raw = GetHobList ();
       Status      = EFI_SUCCESS;
       while (!EFI_ERROR (Status) &&
              (GuidHob.Raw = GetNextGuidHob (mTcg2EventInfo[Index].EventGuid, GuidHob.Raw)) != NULL)
       {
-        TcgEvent = AllocateCopyPool (GET_GUID_HOB_DATA_SIZE (GuidHob.Guid), GET_GUID_HOB_DATA (GuidHob.Guid));
-        ASSERT (TcgEvent != NULL);
+        CopyMem (TcgEvent, GET_GUID_HOB_DATA (GuidHob.Guid), GET_GUID_HOB_DATA_SIZE (GuidHob.Guid));
         GuidHob.Raw = GET_NEXT_HOB (GuidHob);
         switch (mTcg2EventInfo[Index].LogFormat) {
           case EFI_TCG2_EVENT_LOG_FORMAT_TCG_1_2:
@@ -1879,9 +1942,9 @@ SetupEventLog (
                        );
             break;
         }
-
-        FreePool (TcgEvent);
       }
+
+      FreePool (TcgEvent);
     }
   }
 
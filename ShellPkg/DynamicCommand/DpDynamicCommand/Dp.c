@@ -85,6 +85,7 @@ STATIC CONST SHELL_PARAM_ITEM  ParamList[] = {
   { L"-c", TypeValue }, // -c   Display cumulative data.
   { L"-n", TypeValue }, // -n # Number of records to display for A and R
   { L"-t", TypeValue }, // -t # Threshold of interest
+  { L"-o", TypeValue }, // -o   Save the boot performance table to a file
   { NULL,  TypeMax   }
 };
 
@@ -655,6 +656,45 @@ InitSummaryData (
   SummaryData.NumGlobal     = 0;
 }
 
+/**
+  Save the boot performance table to a file, so that the boot performance can
+  be analyzed, or compared between firmware builds, outside the shell.
+
+  @param[in] FileName         The name of the file.
+
+  @retval SHELL_SUCCESS       The table is saved.
+  @retval SHELL_DEVICE_ERROR  The file cannot be written.
+**/
+SHELL_STATUS
+SaveBootPerformanceTable (
+  IN CONST CHAR16  *FileName
+  )
+{
+  EFI_STATUS         Status;
+  SHELL_FILE_HANDLE  FileHandle;
+  UINTN              Size;
+
+  if (!EFI_ERROR (ShellFileExists (FileName))) {
+    ShellDeleteFileByName (FileName);
+  }
+
+  Status = ShellOpenFileByName (FileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
+  if (EFI_ERROR (Status)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_OPEN_FAIL), mDpHiiHandle, FileName, Status);
+    return SHELL_DEVICE_ERROR;
+  }
+
+  Size   = mBootPerformanceTableSize;
+  Status = ShellWriteFile (FileHandle, &Size, mBootPerformanceTable);
+  ShellCloseFile (&FileHandle);
+  if (EFI_ERROR (Status)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_WRITE_FAIL), mDpHiiHandle, FileName, Status);
+    return SHELL_DEVICE_ERROR;
+  }
+
+  return SHELL_SUCCESS;
+}
+
 /**
   Dump performance data.
 
@@ -688,6 +728,7 @@ RunDp (
   BOOLEAN        CumulativeMode;
   CONST CHAR16   *CustomCumulativeToken;
   PERF_CUM_DATA  *CustomCumulativeData;
+  CONST CHAR16   *OutputFileName;
   UINTN          NameSize;
   SHELL_STATUS   ShellStatus;
   TIMER_INFO     TimerInfo;
@@ -701,6 +742,7 @@ RunDp (
   ExcludeMode          = FALSE;
   CumulativeMode       = FALSE;
   CustomCumulativeData = NULL;
+  OutputFileName       = NULL;
   ShellStatus          = SHELL_SUCCESS;
 
   //
@@ -783,6 +825,14 @@ RunDp (
     mInterestThreshold = DEFAULT_THRESHOLD;  // 1ms := 1,000 us
   }
 
+  if (ShellCommandLineGetFlag (ParamPackage, L"-o")) {
+    OutputFileName = ShellCommandLineGetValue (ParamPackage, L"-o");
+    if (OutputFileName == NULL) {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_TOO_FEW), mDpHiiHandle);
+      return SHELL_INVALID_PARAMETER;
+    }
+  }
+
   if (ShellCommandLineGetFlag (ParamPackage, L"-c")) {
     CustomCumulativeToken = ShellCommandLineGetValue (ParamPackage, L"-c");
     if (CustomCumulativeToken == NULL) {
@@ -824,6 +874,14 @@ RunDp (
     goto Done;
   }
 
+  //
+  // The saved table is analyzed outside the shell, nothing is displayed.
+  //
+  if (OutputFileName != NULL) {
+    ShellStatus = SaveBootPerformanceTable (OutputFileName);
+    goto Done;
+  }
+
   //
   // 2. Cache the ModuleGuid and hanlde mapping table.
   //
@@ -918,6 +976,7 @@ RunDp (
   GatherStatistics (CustomCumulativeData);
   if (CumulativeMode) {
     ProcessCumulative (CustomCumulativeData);
+    ProcessCoreServices ();
   } else if (AllMode) {
     Status = DumpAllTrace (Number2Display, ExcludeMode);
     if (Status == EFI_ABORTED) {
@@ -953,6 +1012,7 @@ RunDp (
       }
 
       ProcessCumulative (NULL);
+      ProcessCoreServices ();
     }
   } // ------------- End of Cooked Mode Processing
 
@@ -14,6 +14,7 @@
 #include <Guid/Performance.h>
 #include <Guid/ExtendedFirmwarePerformance.h>
 #include <Guid/FirmwarePerformance.h>
+#include <Guid/DxeCoreServiceStatistics.h>
 
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/DevicePath.h>
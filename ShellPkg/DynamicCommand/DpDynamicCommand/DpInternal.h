@@ -312,4 +312,16 @@ ProcessCumulative (
   IN PERF_CUM_DATA  *CustomCumulativeData OPTIONAL
   );
 
+/**
+  Print the call counts and durations of the DXE Core services.
+
+  The statistics are only available when the DXE Core was built with
+  PcdDxeCoreServiceStatistics, otherwise nothing is printed.
+
+**/
+VOID
+ProcessCoreServices (
+  VOID
+  );
+
 #endif
@@ -1048,3 +1048,92 @@ ProcessCumulative (
       );
   }
 }
+
+/**
+  Convert performance counter ticks of the DXE Core service statistics into
+  microseconds.
+
+  @param[in]    Ticks       The number of ticks.
+  @param[in]    Frequency   The frequency of the performance counter, in Hz.
+
+  @return The time in microseconds.
+
+**/
+STATIC
+UINT64
+CoreServiceTicksInMicroSeconds (
+  IN UINT64  Ticks,
+  IN UINT64  Frequency
+  )
+{
+  UINT64  Seconds;
+  UINT64  Remainder;
+
+  Seconds = DivU64x64Remainder (Ticks, Frequency, &Remainder);
+  return MultU64x32 (Seconds, 1000000) + DivU64x64Remainder (MultU64x32 (Remainder, 1000000), Frequency, NULL);
+}
+
+/**
+  Print the call counts and durations of the DXE Core services.
+
+  The statistics are only available when the DXE Core was built with
+  PcdDxeCoreServiceStatistics, otherwise nothing is printed.
+
+**/
+VOID
+ProcessCoreServices (
+  VOID
+  )
+{
+  EFI_STATUS                         Status;
+  DXE_CORE_SERVICE_STATISTICS        *Statistics;
+  DXE_CORE_SERVICE_STATISTICS_ENTRY  *Entry;
+  UINT64                             Dur;
+  UINT64                             AvgDur;
+  EFI_STRING                         StringPtr;
+  EFI_STRING                         StringPtrUnknown;
+  UINTN                              Index;
+
+  Status = EfiGetSystemConfigurationTable (&gEdkiiDxeCoreServiceStatisticsGuid, (VOID **)&Statistics);
+  if (EFI_ERROR (Status) || (Statistics->Frequency == 0)) {
+    return;
+  }
+
+  StringPtrUnknown = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_ALIT_UNKNOWN), NULL);
+  StringPtr        = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_DP_SECTION_CORE_SERVICES), NULL);
+  ShellPrintHiiEx (
+    -1,
+    -1,
+    NULL,
+    STRING_TOKEN (STR_DP_SECTION_HEADER),
+    mDpHiiHandle,
+    (StringPtr == NULL) ? StringPtrUnknown : StringPtr
+    );
+  FreePool (StringPtr);
+  FreePool (StringPtrUnknown);
+
+  ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_CORE_SERVICES_SECT_1), mDpHiiHandle);
+  ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_CORE_SERVICES_SECT_2), mDpHiiHandle);
+  ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_DASHES), mDpHiiHandle);
+
+  for (Index = 0; Index < Statistics->Count; Index++) {
+    Entry = &Statistics->Entry[Index];
+    if (Entry->Calls == 0) {
+      continue;
+    }
+
+    Dur    = CoreServiceTicksInMicroSeconds (Entry->Ticks, Statistics->Frequency);
+    AvgDur = DivU64x64Remainder (Dur, Entry->Calls, NULL);
+    ShellPrintHiiEx (
+      -1,
+      -1,
+      NULL,
+      STRING_TOKEN (STR_DP_CORE_SERVICES_STATS),
+      mDpHiiHandle,
+      Entry->Name,
+      Entry->Calls,
+      Dur,
+      AvgDur
+      );
+  }
+}
@@ -11,6 +11,11 @@
 #include <Guid/FileSystemInfo.h>
 #include <Guid/FileSystemVolumeLabelInfo.h>
 
+///
+/// The largest buffer that the data of a file is copied with.
+///
+#define CP_MAX_BUFFER_SIZE  SIZE_16MB
+
 /**
   Function to take a list of files to copy and a destination location and do
   the verification and copying of those files to that location.  This function
@@ -37,6 +42,274 @@ ValidateAndCopyFiles (
   IN VOID                       **Resp
   );
 
+/**
+  Wait for a ReadEx() or WriteEx() request to complete.
+
+  @param[in] Token      The token of the request.
+
+  @return               The status of the request.
+**/
+STATIC
+EFI_STATUS
+CopyWaitForToken (
+  IN EFI_FILE_IO_TOKEN  *Token
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  Status = gBS->WaitForEvent (1, &Token->Event, &Index);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return Token->Status;
+}
+
+/**
+  Copy the data of a file to another file with EFI_FILE_PROTOCOL.ReadEx() and
+  WriteEx(), so that each buffer is written while the other one is read.
+
+  @param[in] SourceFile   The file to read.
+  @param[in] DestFile     The file to write.
+  @param[in] Buffer       The two buffers to copy the data with.
+  @param[in] BufferSize   The size of each buffer.
+  @param[out] Copied      The number of bytes written to DestFile.
+  @param[out] ReadError   TRUE if the error returned is an error of reading
+                          SourceFile.
+
+  @retval EFI_SUCCESS     The data was copied.
+  @return                 The error of reading or writing the file.
+**/
+STATIC
+EFI_STATUS
+CopyFileDataOverlapped (
+  IN  EFI_FILE_PROTOCOL  *SourceFile,
+  IN  EFI_FILE_PROTOCOL  *DestFile,
+  IN  VOID               **Buffer,
+  IN  UINTN              BufferSize,
+  OUT UINT64             *Copied,
+  OUT BOOLEAN            *ReadError
+  )
+{
+  EFI_FILE_IO_TOKEN  ReadToken;
+  EFI_FILE_IO_TOKEN  WriteToken;
+  EFI_STATUS         Status;
+  EFI_STATUS         ReadStatus;
+  UINTN              Index;
+
+  ZeroMem (&ReadToken, sizeof (ReadToken));
+  ZeroMem (&WriteToken, sizeof (WriteToken));
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &ReadToken.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &WriteToken.Event);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (ReadToken.Event);
+    return Status;
+  }
+
+  //
+  // Fill the first buffer, then write each buffer while the next one is read.
+  // The end of the file is reached when a read returns no data.
+  //
+  Index                = 0;
+  ReadToken.Buffer     = Buffer[Index];
+  ReadToken.BufferSize = BufferSize;
+  Status               = SourceFile->ReadEx (SourceFile, &ReadToken);
+  if (!EFI_ERROR (Status)) {
+    Status = CopyWaitForToken (&ReadToken);
+  }
+
+  if (EFI_ERROR (Status)) {
+    *ReadError = TRUE;
+  }
+
+  while (!EFI_ERROR (Status) && (ReadToken.BufferSize != 0)) {
+    WriteToken.Buffer     = Buffer[Index];
+    WriteToken.BufferSize = ReadToken.BufferSize;
+    Status                = DestFile->WriteEx (DestFile, &WriteToken);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Index                = 1 - Index;
+    ReadToken.Buffer     = Buffer[Index];
+    ReadToken.BufferSize = BufferSize;
+    ReadStatus           = SourceFile->ReadEx (SourceFile, &ReadToken);
+    if (!EFI_ERROR (ReadStatus)) {
+      ReadStatus = CopyWaitForToken (&ReadToken);
+    }
+
+    Status = CopyWaitForToken (&WriteToken);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    *Copied += WriteToken.BufferSize;
+    if (EFI_ERROR (ReadStatus)) {
+      Status     = ReadStatus;
+      *ReadError = TRUE;
+    }
+  }
+
+  gBS->CloseEvent (ReadToken.Event);
+  gBS->CloseEvent (WriteToken.Event);
+  return Status;
+}
+
+/**
+  Copy the data of a file to another file.
+
+  The data is copied with two buffers of up to CP_MAX_BUFFER_SIZE bytes, which
+  are smaller if the file is or if the memory for them can not be allocated,
+  but not smaller than PcdShellFileOperationSize. If both files support
+  EFI_FILE_PROTOCOL.ReadEx() and WriteEx(), reading the source file and writing
+  the destination file overlap. Otherwise one buffer is read and written in
+  turn.
+
+  @param[in] SourceHandle   The file to read.
+  @param[in] DestHandle     The file to write.
+  @param[in] FileSize       The size of the source file.
+  @param[out] Copied        The number of bytes written to DestHandle.
+  @param[out] ReadError     TRUE if the error returned is an error of reading
+                            SourceHandle.
+
+  @retval EFI_SUCCESS           The data was copied.
+  @retval EFI_OUT_OF_RESOURCES  The buffers could not be allocated.
+  @return                       The error of reading or writing the file.
+**/
+STATIC
+EFI_STATUS
+CopyFileData (
+  IN  SHELL_FILE_HANDLE  SourceHandle,
+  IN  SHELL_FILE_HANDLE  DestHandle,
+  IN  UINT64             FileSize,
+  OUT UINT64             *Copied,
+  OUT BOOLEAN            *ReadError
+  )
+{
+  EFI_FILE_PROTOCOL  *SourceFile;
+  EFI_FILE_PROTOCOL  *DestFile;
+  VOID               *Buffer[2];
+  UINTN              BufferSize;
+  UINTN              MinBufferSize;
+  UINTN              ReadSize;
+  EFI_STATUS         Status;
+
+  *Copied    = 0;
+  *ReadError = FALSE;
+
+  MinBufferSize = PcdGet32 (PcdShellFileOperationSize);
+  BufferSize    = (UINTN)MIN (FileSize, CP_MAX_BUFFER_SIZE);
+  BufferSize    = MAX (BufferSize, MinBufferSize);
+  while (TRUE) {
+    Buffer[0] = AllocatePool (BufferSize);
+    Buffer[1] = AllocatePool (BufferSize);
+    if ((Buffer[0] != NULL) && (Buffer[1] != NULL)) {
+      break;
+    }
+
+    SHELL_FREE_NON_NULL (Buffer[0]);
+    SHELL_FREE_NON_NULL (Buffer[1]);
+    if (BufferSize <= MinBufferSize) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    BufferSize = MAX (BufferSize / 2, MinBufferSize);
+  }
+
+  SourceFile = ConvertShellHandleToEfiFileProtocol (SourceHandle);
+  DestFile   = ConvertShellHandleToEfiFileProtocol (DestHandle);
+  Status     = EFI_UNSUPPORTED;
+  if (  (SourceFile->Revision >= EFI_FILE_PROTOCOL_REVISION2)
+     && (DestFile->Revision >= EFI_FILE_PROTOCOL_REVISION2))
+  {
+    Status = CopyFileDataOverlapped (SourceFile, DestFile, Buffer, BufferSize, Copied, ReadError);
+  }
+
+  if ((Status == EFI_UNSUPPORTED) && (*Copied == 0)) {
+    //
+    // Start over with Read() and Write(), which every file supports.
+    //
+    *ReadError = FALSE;
+    Status     = ShellSetFilePosition (SourceHandle, 0);
+    if (EFI_ERROR (Status)) {
+      *ReadError = TRUE;
+    }
+
+    while (!EFI_ERROR (Status)) {
+      ReadSize = BufferSize;
+      Status   = ShellReadFile (SourceHandle, &ReadSize, Buffer[0]);
+      if (EFI_ERROR (Status)) {
+        *ReadError = TRUE;
+        break;
+      }
+
+      if (ReadSize == 0) {
+        break;
+      }
+
+      Status = ShellWriteFile (DestHandle, &ReadSize, Buffer[0]);
+      if (!EFI_ERROR (Status)) {
+        *Copied += ReadSize;
+      }
+    }
+  }
+
+  FreePool (Buffer[0]);
+  FreePool (Buffer[1]);
+  return Status;
+}
+
+/**
+  Print how fast the data of a file was copied.
+
+  @param[in] Copied     The number of bytes copied.
+  @param[in] StartTime  The time at which the copy started.
+  @param[in] EndTime    The time at which the copy completed.
+**/
+STATIC
+VOID
+CopyPrintThroughput (
+  IN UINT64          Copied,
+  IN CONST EFI_TIME  *StartTime,
+  IN CONST EFI_TIME  *EndTime
+  )
+{
+  UINT32  Start;
+  UINT32  End;
+  UINT32  Elapsed;
+
+  Start = ((StartTime->Hour * 60 + StartTime->Minute) * 60 + StartTime->Second) * 1000 + StartTime->Nanosecond / 1000000;
+  End   = ((EndTime->Hour * 60 + EndTime->Minute) * 60 + EndTime->Second) * 1000 + EndTime->Nanosecond / 1000000;
+  if (End < Start) {
+    //
+    // The copy went past midnight.
+    //
+    End += 24 * 60 * 60 * 1000;
+  }
+
+  Elapsed = End - Start;
+  if ((Copied == 0) || (Elapsed == 0)) {
+    return;
+  }
+
+  ShellPrintHiiEx (
+    -1,
+    -1,
+    NULL,
+    STRING_TOKEN (STR_CP_THROUGHPUT),
+    gShellLevel2HiiHandle,
+    Copied,
+    Elapsed / 1000,
+    Elapsed % 1000,
+    RShiftU64 (DivU64x32 (MultU64x32 (Copied, 1000), Elapsed), 10)
+    );
+}
+
 /**
   Function to Copy one file to another location
 
@@ -60,11 +333,9 @@ CopySingleFile (
   )
 {
   VOID                  *Response;
-  UINTN                 ReadSize;
   SHELL_FILE_HANDLE     SourceHandle;
   SHELL_FILE_HANDLE     DestHandle;
   EFI_STATUS            Status;
-  VOID                  *Buffer;
   CHAR16                *TempName;
   UINTN                 Size;
   EFI_SHELL_FILE_INFO   *List;
@@ -74,6 +345,12 @@ CopySingleFile (
   EFI_FILE_PROTOCOL     *DestVolumeFP;
   EFI_FILE_SYSTEM_INFO  *DestVolumeInfo;
   UINTN                 DestVolumeInfoSize;
+  UINT64                CopySize;
+  UINT64                Copied;
+  BOOLEAN               ReadError;
+  EFI_TIME              StartTime;
+  EFI_TIME              EndTime;
+  EFI_STATUS            TimeStatus;
 
   ASSERT (Resp != NULL);
 
@@ -84,7 +361,6 @@ CopySingleFile (
   DestVolumeInfo = NULL;
   ShellStatus    = SHELL_SUCCESS;
 
-  ReadSize = PcdGet32 (PcdShellFileOperationSize);
   // Why bother copying a file to itself
   if (StrCmp (Source, Dest) == 0) {
     return (SHELL_SUCCESS);
@@ -178,6 +454,7 @@ CopySingleFile (
     //
     ShellGetFileSize (SourceHandle, &SourceFileSize);
     ShellGetFileSize (DestHandle, &DestFileSize);
+    CopySize = SourceFileSize;
 
     //
     // if the destination file already exists then it will be replaced, meaning the sourcefile effectively needs less storage space
@@ -225,26 +502,20 @@ CopySingleFile (
       //
       // copy data between files
       //
-      Buffer = AllocateZeroPool (ReadSize);
-      if (Buffer == NULL) {
+      TimeStatus = gRT->GetTime (&StartTime, NULL);
+      Status     = CopyFileData (SourceHandle, DestHandle, CopySize, &Copied, &ReadError);
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        ShellStatus = SHELL_OUT_OF_RESOURCES;
         ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_OUT_MEM), gShellLevel2HiiHandle, CmdName);
-        return SHELL_OUT_OF_RESOURCES;
-      }
-
-      while (ReadSize == PcdGet32 (PcdShellFileOperationSize) && !EFI_ERROR (Status)) {
-        Status = ShellReadFile (SourceHandle, &ReadSize, Buffer);
-        if (!EFI_ERROR (Status)) {
-          Status = ShellWriteFile (DestHandle, &ReadSize, Buffer);
-          if (EFI_ERROR (Status)) {
-            ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
-            ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_WRITE_ERROR), gShellLevel2HiiHandle, CmdName, Dest);
-            break;
-          }
-        } else {
-          ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
+      } else if (EFI_ERROR (Status)) {
+        ShellStatus = (SHELL_STATUS)(Status & (~MAX_BIT));
+        if (ReadError) {
           ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_READ_ERROR), gShellLevel2HiiHandle, CmdName, Source);
-          break;
+        } else {
+          ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_CPY_WRITE_ERROR), gShellLevel2HiiHandle, CmdName, Dest);
         }
+      } else if (!SilentMode && !EFI_ERROR (TimeStatus) && !EFI_ERROR (gRT->GetTime (&EndTime, NULL))) {
+        CopyPrintThroughput (Copied, &StartTime, &EndTime);
       }
     }
 
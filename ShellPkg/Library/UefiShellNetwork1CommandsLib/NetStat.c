@@ -0,0 +1,179 @@
+/** @file
+  The implementation for Shell command netstat, which displays the counters
+  published by the network stack through the network statistics protocol.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UefiShellNetwork1CommandsLib.h"
+
+STATIC CONST SHELL_PARAM_ITEM  mNetStatCheckList[] = {
+  {
+    L"-l",
+    TypeValue
+  },
+  {
+    L"-r",
+    TypeFlag
+  },
+  {
+    NULL,
+    TypeMax
+  },
+};
+
+/**
+  Display the counters of one network statistics instance.
+
+  @param[in]  Statistics     The network statistics instance.
+
+**/
+STATIC
+VOID
+NetStatDisplay (
+  IN EDKII_NETWORK_STATISTICS_PROTOCOL  *Statistics
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      *MacString;
+  UINTN       Index;
+
+  MacString = NULL;
+  if (Statistics->Controller != NULL) {
+    Status = NetLibGetMacString (Statistics->Controller, NULL, &MacString);
+    if (EFI_ERROR (Status)) {
+      MacString = NULL;
+    }
+  }
+
+  ShellPrintHiiEx (
+    -1,
+    -1,
+    NULL,
+    STRING_TOKEN (STR_NETSTAT_LAYER),
+    gShellNetwork1HiiHandle,
+    Statistics->Layer,
+    (MacString != NULL) ? MacString : L"-"
+    );
+
+  for (Index = 0; Index < Statistics->Count; Index++) {
+    ShellPrintHiiEx (
+      -1,
+      -1,
+      NULL,
+      STRING_TOKEN (STR_NETSTAT_VALUE),
+      gShellNetwork1HiiHandle,
+      Statistics->Names[Index],
+      Statistics->Values[Index]
+      );
+  }
+
+  if (MacString != NULL) {
+    FreePool (MacString);
+  }
+}
+
+/**
+  Function for 'netstat' command.
+
+  @param[in] ImageHandle  Handle to the Image (NULL if Internal).
+  @param[in] SystemTable  Pointer to the System Table (NULL if Internal).
+**/
+SHELL_STATUS
+EFIAPI
+ShellCommandRunNetstat (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                         Status;
+  SHELL_STATUS                       ShellStatus;
+  LIST_ENTRY                         *ParamPackage;
+  CHAR16                             *ProblemParam;
+  CONST CHAR16                       *Layer;
+  BOOLEAN                            Reset;
+  EFI_HANDLE                         *Handles;
+  UINTN                              HandleCount;
+  UINTN                              Index;
+  EDKII_NETWORK_STATISTICS_PROTOCOL  *Statistics;
+  BOOLEAN                            Found;
+
+  ShellStatus  = SHELL_SUCCESS;
+  ProblemParam = NULL;
+  Handles      = NULL;
+  Found        = FALSE;
+
+  Status = ShellCommandLineParse (mNetStatCheckList, &ParamPackage, &ProblemParam, TRUE);
+  if (EFI_ERROR (Status)) {
+    if ((Status == EFI_VOLUME_CORRUPTED) && (ProblemParam != NULL)) {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_PROBLEM), gShellNetwork1HiiHandle, L"netstat", ProblemParam);
+      FreePool (ProblemParam);
+    } else {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_PARAM_INV), gShellNetwork1HiiHandle, L"netstat", L"");
+    }
+
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  if (ShellCommandLineGetCount (ParamPackage) > 1) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_TOO_MANY), gShellNetwork1HiiHandle, L"netstat");
+    ShellStatus = SHELL_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Layer = NULL;
+  if (ShellCommandLineGetFlag (ParamPackage, L"-l")) {
+    Layer = ShellCommandLineGetValue (ParamPackage, L"-l");
+    if (Layer == NULL) {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_GEN_NO_VALUE), gShellNetwork1HiiHandle, L"netstat", L"-l");
+      ShellStatus = SHELL_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+  }
+
+  Reset = ShellCommandLineGetFlag (ParamPackage, L"-r");
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEdkiiNetworkStatisticsProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &Handles
+                  );
+  if (EFI_ERROR (Status)) {
+    HandleCount = 0;
+  }
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (Handles[Index], &gEdkiiNetworkStatisticsProtocolGuid, (VOID **)&Statistics);
+    if (EFI_ERROR (Status) || (Statistics->Revision < EDKII_NETWORK_STATISTICS_PROTOCOL_REVISION)) {
+      continue;
+    }
+
+    if ((Layer != NULL) && (StrCmp (Layer, Statistics->Layer) != 0)) {
+      continue;
+    }
+
+    Found = TRUE;
+    if (Reset) {
+      ZeroMem (Statistics->Values, Statistics->Count * sizeof (UINT64));
+    } else {
+      NetStatDisplay (Statistics);
+    }
+  }
+
+  if (!Found) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_NETSTAT_NOT_FOUND), gShellNetwork1HiiHandle, L"netstat");
+    ShellStatus = SHELL_NOT_FOUND;
+  }
+
+ON_EXIT:
+  if (Handles != NULL) {
+    FreePool (Handles);
+  }
+
+  ShellCommandLineFreeVarList (ParamPackage);
+
+  return ShellStatus;
+}
@@ -66,4 +66,17 @@ ShellCommandRunIfconfig (
   IN EFI_SYSTEM_TABLE  *SystemTable
   );
 
+/**
+  Function for 'netstat' command.
+
+  @param[in] ImageHandle  Handle to the Image (NULL if Internal).
+  @param[in] SystemTable  Pointer to the System Table (NULL if Internal).
+**/
+SHELL_STATUS
+EFIAPI
+ShellCommandRunNetstat (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
 #endif
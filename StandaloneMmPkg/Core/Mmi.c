@@ -19,12 +19,13 @@
 
 #define MMI_ENTRY_SIGNATURE  SIGNATURE_32('m','m','i','e')
 
-typedef struct {
-  UINTN         Signature;
-  LIST_ENTRY    AllEntries; // All entries
+typedef struct _MMI_ENTRY {
+  UINTN                Signature;
+  LIST_ENTRY           AllEntries; // All entries
 
-  EFI_GUID      HandlerType; // Type of interrupt
-  LIST_ENTRY    MmiHandlers; // All handlers
+  EFI_GUID             HandlerType; // Type of interrupt
+  LIST_ENTRY           MmiHandlers; // All handlers
+  struct _MMI_ENTRY    *HashNext;   // Next entry of the same hash bucket
 } MMI_ENTRY;
 
 #define MMI_HANDLER_SIGNATURE  SIGNATURE_32('m','m','i','h')
@@ -39,6 +40,40 @@ typedef struct {
 LIST_ENTRY  mRootMmiHandlerList = INITIALIZE_LIST_HEAD_VARIABLE (mRootMmiHandlerList);
 LIST_ENTRY  mMmiEntryList       = INITIALIZE_LIST_HEAD_VARIABLE (mMmiEntryList);
 
+//
+// The MMI entries are also chained by hash of their handler type, so that
+// MmiManage () does not compare the GUID of every entry on each MMI.
+//
+#define MMI_ENTRY_HASH_SIZE  64
+
+STATIC MMI_ENTRY  *mMmiEntryHash[MMI_ENTRY_HASH_SIZE];
+
+/**
+  Hash a handler type into a bucket of mMmiEntryHash.
+
+  @param  HandlerType            The type of the interrupt, which may not be aligned
+
+  @return The index of the bucket
+
+**/
+STATIC
+UINTN
+MmiEntryHash (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)HandlerType);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (MMI_ENTRY_HASH_SIZE - 1);
+}
+
 /**
   Finds the MMI entry for the requested handler type.
 
@@ -55,24 +90,18 @@ MmCoreFindMmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
-  MMI_ENTRY   *Item;
-  MMI_ENTRY   *MmiEntry;
+  UINTN      Bucket;
+  MMI_ENTRY  *MmiEntry;
 
   //
-  // Search the MMI entry list for the matching GUID
+  // Search the hash bucket of the handler type for the matching GUID
   //
-  MmiEntry = NULL;
-  for (Link = mMmiEntryList.ForwardLink;
-       Link != &mMmiEntryList;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, MMI_ENTRY, AllEntries, MMI_ENTRY_SIGNATURE);
-    if (CompareGuid (&Item->HandlerType, HandlerType)) {
+  Bucket = MmiEntryHash (HandlerType);
+  for (MmiEntry = mMmiEntryHash[Bucket]; MmiEntry != NULL; MmiEntry = MmiEntry->HashNext) {
+    if (CompareGuid (&MmiEntry->HandlerType, HandlerType)) {
       //
       // This is the MMI entry
       //
-      MmiEntry = Item;
       break;
     }
   }
@@ -95,6 +124,8 @@ MmCoreFindMmiEntry (
       // Add it to MMI entry list
       //
       InsertTailList (&mMmiEntryList, &MmiEntry->AllEntries);
+      MmiEntry->HashNext    = mMmiEntryHash[Bucket];
+      mMmiEntryHash[Bucket] = MmiEntry;
     }
   }
 
@@ -298,6 +329,7 @@ MmiHandlerUnRegister (
 {
   MMI_HANDLER  *MmiHandler;
   MMI_ENTRY    *MmiEntry;
+  MMI_ENTRY    **HashLink;
 
   MmiHandler = (MMI_HANDLER *)DispatchHandle;
 
@@ -326,6 +358,12 @@ MmiHandlerUnRegister (
     // No handler registered for this interrupt now, remove the MMI_ENTRY
     //
     RemoveEntryList (&MmiEntry->AllEntries);
+    HashLink = &mMmiEntryHash[MmiEntryHash (&MmiEntry->HandlerType)];
+    while (*HashLink != MmiEntry) {
+      HashLink = &(*HashLink)->HashNext;
+    }
+
+    *HashLink = MmiEntry->HashNext;
 
     FreePool (MmiEntry);
   }
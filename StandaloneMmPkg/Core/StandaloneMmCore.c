@@ -84,11 +84,12 @@ EFI_MM_SYSTEM_TABLE  gMmCoreMmst = {
 // Table of MMI Handlers that are registered by the MM Core when it is initialized
 //
 MM_CORE_MMI_HANDLERS  mMmCoreMmiHandlers[] = {
-  { MmReadyToLockHandler,     &gEfiDxeMmReadyToLockProtocolGuid, NULL, TRUE  },
-  { MmEndOfDxeHandler,        &gEfiEndOfDxeEventGroupGuid,       NULL, FALSE },
-  { MmExitBootServiceHandler, &gEfiEventExitBootServicesGuid,    NULL, FALSE },
-  { MmReadyToBootHandler,     &gEfiEventReadyToBootGuid,         NULL, FALSE },
-  { NULL,                     NULL,                              NULL, FALSE },
+  { MmReadyToLockHandler,      &gEfiDxeMmReadyToLockProtocolGuid, NULL, TRUE  },
+  { MmEndOfDxeHandler,         &gEfiEndOfDxeEventGroupGuid,       NULL, FALSE },
+  { MmExitBootServiceHandler,  &gEfiEventExitBootServicesGuid,    NULL, FALSE },
+  { MmReadyToBootHandler,      &gEfiEventReadyToBootGuid,         NULL, FALSE },
+  { MmMultiCommunicateHandler, &gEdkiiMmMultiCommunicateGuid,     NULL, FALSE },
+  { NULL,                      NULL,                              NULL, FALSE },
 };
 
 EFI_SYSTEM_TABLE      *mEfiSystemTable;
@@ -206,6 +207,85 @@ MmReadyToBootHandler (
   return Status;
 }
 
+/**
+  MMI handler that dispatches the messages of an MM communication with
+  gEdkiiMmMultiCommunicateGuid, one after the other.
+
+  @param  DispatchHandle  The unique handle assigned to this handler by MmiHandlerRegister().
+  @param  Context         Points to an optional handler context which was specified when the handler was registered.
+  @param  CommBuffer      A pointer to a collection of data in memory that will
+                          be conveyed from a non-MM environment into an MM environment.
+  @param  CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+
+**/
+EFI_STATUS
+EFIAPI
+MmMultiCommunicateHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  MM_MULTI_COMMUNICATE_ENTRY  *Entry;
+  UINT64                      MessageCount;
+  UINT64                      Index;
+  UINTN                       BufferSize;
+  UINTN                       Offset;
+  UINTN                       EntrySize;
+  UINTN                       MessageLength;
+  EFI_GUID                    HeaderGuid;
+  EFI_STATUS                  Status;
+
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  BufferSize = *CommBufferSize;
+  if (BufferSize < sizeof (MM_MULTI_COMMUNICATE_HEADER)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The sizes are read once from the buffer, which the caller may still
+  // access.
+  //
+  MessageCount = ((MM_MULTI_COMMUNICATE_HEADER *)CommBuffer)->MessageCount;
+  Offset       = sizeof (MM_MULTI_COMMUNICATE_HEADER);
+  for (Index = 0; Index < MessageCount; Index++) {
+    if (BufferSize - Offset < OFFSET_OF (MM_MULTI_COMMUNICATE_ENTRY, Data)) {
+      break;
+    }
+
+    Entry = (MM_MULTI_COMMUNICATE_ENTRY *)((UINT8 *)CommBuffer + Offset);
+    if ((Entry->EntrySize < OFFSET_OF (MM_MULTI_COMMUNICATE_ENTRY, Data)) ||
+        (Entry->EntrySize > BufferSize - Offset) ||
+        ((Entry->EntrySize & (sizeof (UINT64) - 1)) != 0))
+    {
+      break;
+    }
+
+    EntrySize     = (UINTN)Entry->EntrySize;
+    MessageLength = (UINTN)Entry->MessageLength;
+    CopyGuid (&HeaderGuid, &Entry->HeaderGuid);
+    if ((Entry->MessageLength > EntrySize - OFFSET_OF (MM_MULTI_COMMUNICATE_ENTRY, Data)) ||
+        CompareGuid (&HeaderGuid, &gEdkiiMmMultiCommunicateGuid))
+    {
+      Entry->ReturnStatus = EFI_INVALID_PARAMETER;
+    } else {
+      Status               = MmiManage (&HeaderGuid, NULL, Entry->Data, &MessageLength);
+      Entry->MessageLength = MIN (MessageLength, EntrySize - OFFSET_OF (MM_MULTI_COMMUNICATE_ENTRY, Data));
+      Entry->ReturnStatus  = (Status == EFI_SUCCESS) ? EFI_SUCCESS : EFI_NOT_FOUND;
+    }
+
+    Offset += EntrySize;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Software MMI handler that is called when the DxeMmReadyToLock protocol is added
   or if gEfiEventReadyToBootGuid is signaled.  This function unregisters the
@@ -0,0 +1,60 @@
+/** @file
+  GUID and message format to carry several MM communication messages in one
+  MM entry.
+
+  The Standalone MM Core dispatches a message whose HeaderGuid is
+  gEdkiiMmMultiCommunicateGuid as a sequence of entries, one after the other,
+  to the MMI handlers of their own HeaderGuid, as if each one had been sent
+  alone. It saves the world switch of each message on platforms where entering
+  MM is expensive.
+
+  The Data of the message is an MM_MULTI_COMMUNICATE_HEADER, followed by
+  MessageCount entries. Each entry starts at an 8-byte boundary from the
+  previous one, and takes EntrySize bytes. On output, the MessageLength of
+  each entry is the one its handler returned, and its ReturnStatus is the one
+  the MM communication would have returned for it alone. The entries following
+  one whose EntrySize is invalid are not dispatched.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MM_MULTI_COMMUNICATE_H_
+#define MM_MULTI_COMMUNICATE_H_
+
+#define EDKII_MM_MULTI_COMMUNICATE_GUID \
+  { 0x154914da, 0x5d55, 0x46f7, { 0xa5, 0xc8, 0xe7, 0x6d, 0x5e, 0xc1, 0xfb, 0xba }}
+
+extern EFI_GUID  gEdkiiMmMultiCommunicateGuid;
+
+#pragma pack(1)
+
+typedef struct {
+  ///
+  /// Number of entries following the header.
+  ///
+  UINT64    MessageCount;
+} MM_MULTI_COMMUNICATE_HEADER;
+
+typedef struct {
+  ///
+  /// Size of the entry in bytes, including this header and the space available
+  /// for the message data. A multiple of 8.
+  ///
+  UINT64        EntrySize;
+  ///
+  /// On output, EFI_SUCCESS if a handler processed the message, EFI_NOT_FOUND
+  /// if none did, and EFI_INVALID_PARAMETER if the entry was not dispatched.
+  ///
+  UINT64        ReturnStatus;
+  ///
+  /// The message, as in EFI_MM_COMMUNICATE_HEADER.
+  ///
+  EFI_GUID      HeaderGuid;
+  UINT64        MessageLength;
+  UINT8         Data[1];
+} MM_MULTI_COMMUNICATE_ENTRY;
+
+#pragma pack()
+
+#endif
@@ -0,0 +1,64 @@
+/** @file
+  The SMI latency histograms that PiSmmCpuDxeSmm records when
+  PcdCpuSmmLatencyHistogram is TRUE, and the MM communication to read them.
+
+  A bucket N of a histogram counts the durations D, in ticks of the
+  performance counter, for which HighBitSet64 (D) is N. Bucket 0 also counts
+  the durations of 0, and the last bucket all the longer durations. The
+  counters only grow and wrap around, readers are expected to compare two
+  snapshots.
+
+  To read the histograms, MM communicate with gEdkiiSmmLatencyHistogramGuid
+  as header GUID and a message of at least OFFSET_OF (SMM_LATENCY_HISTOGRAMS,
+  Rendezvous) bytes. The handler sets Size to the size of the histograms, and
+  copies them into the message if it is large enough.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef SMM_LATENCY_HISTOGRAM_H_
+#define SMM_LATENCY_HISTOGRAM_H_
+
+#define EDKII_SMM_LATENCY_HISTOGRAM_GUID \
+  { \
+    0xa54d1620, 0x8bf1, 0x4ac8, { 0x85, 0x91, 0xef, 0x5d, 0x2a, 0x90, 0x98, 0x88 } \
+  }
+
+#define SMM_LATENCY_HISTOGRAM_BUCKET_COUNT  32
+
+typedef UINT32 SMM_LATENCY_HISTOGRAM[SMM_LATENCY_HISTOGRAM_BUCKET_COUNT];
+
+typedef struct {
+  ///
+  /// Size of the histograms, including the SMI histogram of each processor.
+  ///
+  UINT32                   Size;
+  UINT32                   NumberOfProcessors;
+  ///
+  /// Frequency of the performance counter, in Hz.
+  ///
+  UINT64                   Frequency;
+  ///
+  /// Time from the SMI entry of the BSP to the invocation of the SMI handlers,
+  /// which includes the wait for the APs in the traditional sync mode.
+  ///
+  SMM_LATENCY_HISTOGRAM    Rendezvous;
+  ///
+  /// Time the SMM Foundation spends in the SMI handlers, per SMI.
+  ///
+  SMM_LATENCY_HISTOGRAM    Handler;
+  ///
+  /// Time from the arrival of the first processor of an SMI to the arrival of
+  /// each other processor that joins it.
+  ///
+  SMM_LATENCY_HISTOGRAM    ArrivalSkew;
+  ///
+  /// Time each processor spends in an SMI, NumberOfProcessors histograms.
+  ///
+  SMM_LATENCY_HISTOGRAM    Smi[];
+} SMM_LATENCY_HISTOGRAMS;
+
+extern EFI_GUID  gEdkiiSmmLatencyHistogramGuid;
+
+#endif
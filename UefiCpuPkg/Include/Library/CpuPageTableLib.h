@@ -108,6 +108,67 @@ typedef struct {
   IA32_MAP_ATTRIBUTE    Attribute;
 } IA32_MAP_ENTRY;
 
+typedef struct {
+  UINT64                LinearAddress;
+  UINT64                Length;
+  IA32_MAP_ATTRIBUTE    Attribute;
+  IA32_MAP_ATTRIBUTE    Mask;
+} IA32_MAP_BATCH_ENTRY;
+
+typedef struct {
+  UINT64    LinearAddress;
+  UINT64    Length;
+} IA32_MAP_FLUSH_RANGE;
+
+/**
+  Create or update page table to map multiple linear address ranges with specified attributes.
+
+  Each entry is applied in the same way as PageTableMap(). After all entries are applied, page directories
+  in the updated ranges whose entries are all non-present, or all map contiguous physical memory with the
+  same attribute, are replaced by a single 2M or 1G entry (when supported by PagingMode).
+  The page directories that are no longer referenced are not reused by the library.
+
+  @param[in, out] PageTable       The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+  @param[in]      PagingMode      The paging mode.
+  @param[in]      Buffer          The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize      The buffer size.
+                                  On return, the remaining buffer size.
+                                  The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                  BufferSize in the second call to this API.
+  @param[in]      Entries         The linear address ranges to map, sorted by LinearAddress and not overlapping each other.
+                                  Attribute and Mask of each entry follow the same rules as PageTableMap().
+  @param[in]      EntryCount      The number of entries in Entries.
+  @param[out]     FlushRanges     Return the sorted linear address ranges whose TLB entries need to be invalidated.
+  @param[in, out] FlushRangeCount On input, the maximum number of entries that FlushRanges can hold.
+                                  On output, the number of entries in FlushRanges.
+                                  When more ranges are modified than FlushRanges can hold, neighbouring ranges are combined
+                                  so the returned ranges always cover all the modified linear addresses.
+  @param[out]     IsModified      TRUE means page table is modified. FALSE means page table is not modified.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize or Entries is NULL.
+  @retval RETURN_INVALID_PARAMETER  Entries are not sorted or overlap each other.
+  @retval RETURN_INVALID_PARAMETER  *FlushRangeCount is not 0 but FlushRanges is NULL.
+  @retval RETURN_INVALID_PARAMETER  Any entry is rejected by the same parameter checks as PageTableMap().
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    The expected buffer size may be larger than what is finally consumed.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or EntryCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapBatch (
+  IN OUT UINTN                 *PageTable  OPTIONAL,
+  IN     PAGING_MODE           PagingMode,
+  IN     VOID                  *Buffer,
+  IN OUT UINTN                 *BufferSize,
+  IN     IA32_MAP_BATCH_ENTRY  *Entries,
+  IN     UINTN                 EntryCount,
+  OUT    IA32_MAP_FLUSH_RANGE  *FlushRanges      OPTIONAL,
+  IN OUT UINTN                 *FlushRangeCount  OPTIONAL,
+  OUT    BOOLEAN               *IsModified       OPTIONAL
+  );
+
 /**
   Parse page table.
 
@@ -618,6 +618,100 @@ PageTableLibMapInLevel (
   return RETURN_SUCCESS;
 }
 
+/**
+  Get the top level paging entry that is used to walk the page table.
+
+  For an existing PAE page table, the 4 PDPTEs are copied to a temporary 4KB-aligned buffer
+  so that ReadWrite, UserSupervisor and Nx can be treated as the non-leaf entry attributes.
+
+  @param[in]  PageTable      The page table to update, or 0 if a new page table is to be created.
+  @param[in]  PagingMode     The paging mode.
+  @param[in]  BufferInStack  The buffer to hold the temporary PDPTEs.
+                             It should be at least (SIZE_4KB - 1 + MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY)) bytes.
+  @param[out] TopPagingEntry Return the top level paging entry.
+**/
+VOID
+PageTableLibGetTopPagingEntry (
+  IN  UINTN              PageTable,
+  IN  PAGING_MODE        PagingMode,
+  IN  UINT8              *BufferInStack,
+  OUT IA32_PAGING_ENTRY  *TopPagingEntry
+  )
+{
+  UINTN              Index;
+  IA32_PAGING_ENTRY  *PagingEntry;
+
+  TopPagingEntry->Uintn = PageTable;
+  if (TopPagingEntry->Uintn != 0) {
+    if (PagingMode == PagingPae) {
+      //
+      // Create 4 temporary PDPTE at a 4k-aligned address.
+      // Copy the original PDPTE content and set ReadWrite, UserSupervisor to 1, set Nx to 0.
+      //
+      TopPagingEntry->Uintn = ALIGN_VALUE ((UINTN)BufferInStack, BASE_4KB);
+      PagingEntry           = (IA32_PAGING_ENTRY *)(TopPagingEntry->Uintn);
+      CopyMem (PagingEntry, (VOID *)PageTable, MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY));
+      for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
+        PagingEntry[Index].Pnle.Bits.ReadWrite      = 1;
+        PagingEntry[Index].Pnle.Bits.UserSupervisor = 1;
+        PagingEntry[Index].Pnle.Bits.Nx             = 0;
+      }
+    }
+
+    TopPagingEntry->Pce.Present        = 1;
+    TopPagingEntry->Pce.ReadWrite      = 1;
+    TopPagingEntry->Pce.UserSupervisor = 1;
+    TopPagingEntry->Pce.Nx             = 0;
+  }
+}
+
+/**
+  Write the top level paging entry back to the page table after the page table walk.
+
+  @param[in, out] PageTable      The pointer to the page table that was updated, or pointer to NULL
+                                 if a new page table was created.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      TopPagingEntry The top level paging entry returned by PageTableLibGetTopPagingEntry().
+**/
+VOID
+PageTableLibSetTopPagingEntry (
+  IN OUT UINTN              *PageTable,
+  IN     PAGING_MODE        PagingMode,
+  IN     IA32_PAGING_ENTRY  *TopPagingEntry
+  )
+{
+  UINTN              Index;
+  IA32_PAGING_ENTRY  *PagingEntry;
+
+  PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)(TopPagingEntry->Uintn & IA32_PE_BASE_ADDRESS_MASK_40);
+
+  if (PagingMode == PagingPae) {
+    //
+    // These MustBeZero fields are treated as RW and other attributes by the common map logic. So they might be set to 1.
+    //
+    for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
+      PagingEntry[Index].PdptePae.Bits.MustBeZero  = 0;
+      PagingEntry[Index].PdptePae.Bits.MustBeZero2 = 0;
+      PagingEntry[Index].PdptePae.Bits.MustBeZero3 = 0;
+    }
+
+    if (*PageTable != 0) {
+      //
+      // Copy temp PDPTE to original PDPTE.
+      //
+      CopyMem ((VOID *)(*PageTable), PagingEntry, MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY));
+    }
+  }
+
+  if (*PageTable == 0) {
+    //
+    // Do not assign the *PageTable when it's an existing page table.
+    // If it's an existing PAE page table, PagingEntry is the temp buffer in stack.
+    //
+    *PageTable = (UINTN)PagingEntry;
+  }
+}
+
 /**
   Create or update page table to map [LinearAddress, LinearAddress + Length) with specified attribute.
 
@@ -671,8 +765,6 @@ PageTableMap (
   IA32_PAGE_LEVEL     MaxLeafLevel;
   IA32_MAP_ATTRIBUTE  ParentAttribute;
   BOOLEAN             LocalIsModified;
-  UINTN               Index;
-  IA32_PAGING_ENTRY   *PagingEntry;
   UINT8               BufferInStack[SIZE_4KB - 1 + MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY)];
 
   if (Length == 0) {
@@ -727,28 +819,7 @@ PageTableMap (
     return RETURN_INVALID_PARAMETER;
   }
 
-  TopPagingEntry.Uintn = *PageTable;
-  if (TopPagingEntry.Uintn != 0) {
-    if (PagingMode == PagingPae) {
-      //
-      // Create 4 temporary PDPTE at a 4k-aligned address.
-      // Copy the original PDPTE content and set ReadWrite, UserSupervisor to 1, set Nx to 0.
-      //
-      TopPagingEntry.Uintn = ALIGN_VALUE ((UINTN)BufferInStack, BASE_4KB);
-      PagingEntry          = (IA32_PAGING_ENTRY *)(TopPagingEntry.Uintn);
-      CopyMem (PagingEntry, (VOID *)(*PageTable), MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY));
-      for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
-        PagingEntry[Index].Pnle.Bits.ReadWrite      = 1;
-        PagingEntry[Index].Pnle.Bits.UserSupervisor = 1;
-        PagingEntry[Index].Pnle.Bits.Nx             = 0;
-      }
-    }
-
-    TopPagingEntry.Pce.Present        = 1;
-    TopPagingEntry.Pce.ReadWrite      = 1;
-    TopPagingEntry.Pce.UserSupervisor = 1;
-    TopPagingEntry.Pce.Nx             = 0;
-  }
+  PageTableLibGetTopPagingEntry (*PageTable, PagingMode, BufferInStack, &TopPagingEntry);
 
   if (IsModified == NULL) {
     IsModified = &LocalIsModified;
@@ -818,34 +889,490 @@ PageTableMap (
              );
 
   if (!RETURN_ERROR (Status)) {
-    PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)(TopPagingEntry.Uintn & IA32_PE_BASE_ADDRESS_MASK_40);
+    PageTableLibSetTopPagingEntry (PageTable, PagingMode, &TopPagingEntry);
+  }
 
-    if (PagingMode == PagingPae) {
+  return Status;
+}
+
+/**
+  Add a linear address range to the sorted TLB flush ranges.
+
+  Overlapping or adjacent ranges are combined. When there is no free slot, the new range
+  is combined with its neighbour so the flush ranges always cover all the added ranges.
+
+  @param[in, out] FlushRanges        The sorted flush ranges.
+  @param[in]      FlushRangeCapacity The maximum number of entries that FlushRanges can hold.
+  @param[in, out] FlushRangeCount    The number of entries in FlushRanges.
+  @param[in]      LinearAddress      The start of the linear address range.
+  @param[in]      Length             The length of the linear address range.
+**/
+VOID
+PageTableLibAddFlushRange (
+  IN OUT IA32_MAP_FLUSH_RANGE  *FlushRanges,
+  IN     UINTN                 FlushRangeCapacity,
+  IN OUT UINTN                 *FlushRangeCount,
+  IN     UINT64                LinearAddress,
+  IN     UINT64                Length
+  )
+{
+  UINTN   Index;
+  UINTN   MoveIndex;
+  UINT64  Limit;
+
+  if (FlushRangeCapacity == 0) {
+    return;
+  }
+
+  Limit = LinearAddress + Length;
+
+  //
+  // Find the first range that ends at or after LinearAddress.
+  //
+  for (Index = 0; Index < *FlushRangeCount; Index++) {
+    if (FlushRanges[Index].LinearAddress + FlushRanges[Index].Length >= LinearAddress) {
+      break;
+    }
+  }
+
+  if ((Index == *FlushRangeCount) || (FlushRanges[Index].LinearAddress > Limit)) {
+    if (*FlushRangeCount < FlushRangeCapacity) {
       //
-      // These MustBeZero fields are treated as RW and other attributes by the common map logic. So they might be set to 1.
+      // Insert the new range before FlushRanges[Index].
       //
-      for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
-        PagingEntry[Index].PdptePae.Bits.MustBeZero  = 0;
-        PagingEntry[Index].PdptePae.Bits.MustBeZero2 = 0;
-        PagingEntry[Index].PdptePae.Bits.MustBeZero3 = 0;
+      for (MoveIndex = *FlushRangeCount; MoveIndex > Index; MoveIndex--) {
+        FlushRanges[MoveIndex] = FlushRanges[MoveIndex - 1];
       }
 
-      if (*PageTable != 0) {
-        //
-        // Copy temp PDPTE to original PDPTE.
-        //
-        CopyMem ((VOID *)(*PageTable), PagingEntry, MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY));
+      FlushRanges[Index].LinearAddress = LinearAddress;
+      FlushRanges[Index].Length        = Length;
+      (*FlushRangeCount)++;
+      return;
+    }
+
+    //
+    // No free slot. Combine the new range with its neighbour.
+    //
+    if (Index == *FlushRangeCount) {
+      Index--;
+    }
+  }
+
+  //
+  // Extend FlushRanges[Index] to cover the new range and absorb the following ranges that
+  // overlap or are adjacent to it.
+  //
+  Limit                            = MAX (Limit, FlushRanges[Index].LinearAddress + FlushRanges[Index].Length);
+  FlushRanges[Index].LinearAddress = MIN (LinearAddress, FlushRanges[Index].LinearAddress);
+  while ((Index + 1 < *FlushRangeCount) && (FlushRanges[Index + 1].LinearAddress <= Limit)) {
+    Limit = MAX (Limit, FlushRanges[Index + 1].LinearAddress + FlushRanges[Index + 1].Length);
+    for (MoveIndex = Index + 1; MoveIndex + 1 < *FlushRangeCount; MoveIndex++) {
+      FlushRanges[MoveIndex] = FlushRanges[MoveIndex + 1];
+    }
+
+    (*FlushRangeCount)--;
+  }
+
+  FlushRanges[Index].Length = Limit - FlushRanges[Index].LinearAddress;
+}
+
+/**
+  Replace the page directory referenced by a non-leaf entry with one leaf entry when all entries in the
+  page directory are non-present, or all entries map contiguous physical memory with the same attribute.
+  The page directories referenced by the entries that map [LinearAddress, LinearAddress + Length) are
+  checked first, so that the promotion can propagate from 4K to 2M and to 1G.
+
+  @param[in, out] ParentPagingEntry  The pointer to the present non-leaf entry to check.
+  @param[in]      ParentAttribute    The accumulated attribute of all parents' attribute.
+  @param[in]      Level              Page level of the entries in the page directory referenced by ParentPagingEntry.
+  @param[in]      MaxLeafLevel       Maximum level that can be a leaf entry. Could be 1, 2 or 3 (if Page 1G is supported).
+  @param[in]      RegionStart        The linear address mapped by ParentPagingEntry.
+  @param[in]      LinearAddress      The start of the linear address range.
+  @param[in]      Length             The length of the linear address range.
+  @param[in, out] FlushRanges        The sorted TLB flush ranges.
+  @param[in]      FlushRangeCapacity The maximum number of entries that FlushRanges can hold.
+  @param[in, out] FlushRangeCount    The number of entries in FlushRanges.
+  @param[out]     IsModified         Set to TRUE when any entry is replaced.
+**/
+VOID
+PageTableLibPromoteInLevel (
+  IN OUT IA32_PAGING_ENTRY     *ParentPagingEntry,
+  IN     IA32_MAP_ATTRIBUTE    *ParentAttribute,
+  IN     IA32_PAGE_LEVEL       Level,
+  IN     IA32_PAGE_LEVEL       MaxLeafLevel,
+  IN     UINT64                RegionStart,
+  IN     UINT64                LinearAddress,
+  IN     UINT64                Length,
+  IN OUT IA32_MAP_FLUSH_RANGE  *FlushRanges,
+  IN     UINTN                 FlushRangeCapacity,
+  IN OUT UINTN                 *FlushRangeCount,
+  OUT    BOOLEAN               *IsModified
+  )
+{
+  UINTN               BitStart;
+  UINTN               Index;
+  UINTN               PagingEntryIndex;
+  UINTN               PagingEntryIndexEnd;
+  IA32_PAGING_ENTRY   *PagingEntry;
+  UINT64              RegionLength;
+  UINT64              Start;
+  UINT64              End;
+  IA32_MAP_ATTRIBUTE  AllOneMask;
+  IA32_MAP_ATTRIBUTE  ChildAttribute;
+  IA32_MAP_ATTRIBUTE  FirstAttribute;
+  IA32_MAP_ATTRIBUTE  CurrentAttribute;
+  IA32_PAGING_ENTRY   NewPagingEntry;
+
+  ASSERT (ParentPagingEntry->Pce.Present == 1);
+
+  AllOneMask.Uint64     = ~0ull;
+  BitStart              = 12 + (Level - 1) * 9;
+  RegionLength          = REGION_LENGTH (Level);
+  ChildAttribute.Uint64 = PageTableLibGetPnleMapAttribute (&ParentPagingEntry->Pnle, ParentAttribute);
+  PagingEntry           = (IA32_PAGING_ENTRY *)(UINTN)IA32_PNLE_PAGE_TABLE_BASE_ADDRESS (&ParentPagingEntry->Pnle);
+
+  //
+  // Check the page directories referenced by the entries that map the range first.
+  //
+  if (Level > 1) {
+    Start               = MAX (LinearAddress, RegionStart);
+    End                 = MIN (LinearAddress + Length, RegionStart + MultU64x32 (RegionLength, 512));
+    PagingEntryIndex    = (UINTN)BitFieldRead64 (Start, BitStart, BitStart + 9 - 1);
+    PagingEntryIndexEnd = (UINTN)BitFieldRead64 (End - 1, BitStart, BitStart + 9 - 1);
+    for (Index = PagingEntryIndex; Index <= PagingEntryIndexEnd; Index++) {
+      if ((PagingEntry[Index].Pce.Present == 1) && !IsPle (&PagingEntry[Index], Level)) {
+        PageTableLibPromoteInLevel (
+          &PagingEntry[Index],
+          &ChildAttribute,
+          Level - 1,
+          MaxLeafLevel,
+          RegionStart + MultU64x32 (RegionLength, (UINT32)Index),
+          LinearAddress,
+          Length,
+          FlushRanges,
+          FlushRangeCapacity,
+          FlushRangeCount,
+          IsModified
+          );
       }
     }
+  }
+
+  if (Level + 1 > MaxLeafLevel) {
+    //
+    // ParentPagingEntry cannot be a leaf entry.
+    //
+    return;
+  }
+
+  FirstAttribute.Uint64 = 0;
+  for (Index = 0; Index < 512; Index++) {
+    if (PagingEntry[Index].Pce.Present != PagingEntry[0].Pce.Present) {
+      return;
+    }
+
+    if (PagingEntry[Index].Pce.Present == 0) {
+      continue;
+    }
+
+    if (Level == 1) {
+      CurrentAttribute.Uint64 = PageTableLibGetPte4KMapAttribute (&PagingEntry[Index].Pte4K, &ChildAttribute);
+    } else if (IsPle (&PagingEntry[Index], Level)) {
+      CurrentAttribute.Uint64 = PageTableLibGetPleBMapAttribute (&PagingEntry[Index].PleB, &ChildAttribute);
+    } else {
+      return;
+    }
+
+    if (Index == 0) {
+      FirstAttribute.Uint64 = CurrentAttribute.Uint64;
+      if ((IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&FirstAttribute) & (MultU64x32 (RegionLength, 512) - 1)) != 0) {
+        return;
+      }
+    } else if (CurrentAttribute.Uint64 != FirstAttribute.Uint64 + MultU64x32 (RegionLength, (UINT32)Index)) {
+      return;
+    }
+  }
+
+  //
+  // The page directory is uniform. Map the whole region in ParentPagingEntry.
+  // The attributes inherited from the parent entries are kept in the new leaf entry.
+  //
+  NewPagingEntry.Uint64 = 0;
+  if (PagingEntry[0].Pce.Present == 1) {
+    PageTableLibSetPle (Level + 1, &NewPagingEntry, 0, &FirstAttribute, &AllOneMask);
+  }
+
+  ParentPagingEntry->Uint64 = NewPagingEntry.Uint64;
+  *IsModified               = TRUE;
+  PageTableLibAddFlushRange (FlushRanges, FlushRangeCapacity, FlushRangeCount, RegionStart, MultU64x32 (RegionLength, 512));
+}
+
+/**
+  Create or update page table to map multiple linear address ranges with specified attributes.
+
+  Each entry is applied in the same way as PageTableMap(). After all entries are applied, page directories
+  in the updated ranges whose entries are all non-present, or all map contiguous physical memory with the
+  same attribute, are replaced by a single 2M or 1G entry (when supported by PagingMode).
+  The page directories that are no longer referenced are not reused by the library.
+
+  @param[in, out] PageTable       The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+  @param[in]      PagingMode      The paging mode.
+  @param[in]      Buffer          The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize      The buffer size.
+                                  On return, the remaining buffer size.
+                                  The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                  BufferSize in the second call to this API.
+  @param[in]      Entries         The linear address ranges to map, sorted by LinearAddress and not overlapping each other.
+                                  Attribute and Mask of each entry follow the same rules as PageTableMap().
+  @param[in]      EntryCount      The number of entries in Entries.
+  @param[out]     FlushRanges     Return the sorted linear address ranges whose TLB entries need to be invalidated.
+  @param[in, out] FlushRangeCount On input, the maximum number of entries that FlushRanges can hold.
+                                  On output, the number of entries in FlushRanges.
+                                  When more ranges are modified than FlushRanges can hold, neighbouring ranges are combined
+                                  so the returned ranges always cover all the modified linear addresses.
+  @param[out]     IsModified      TRUE means page table is modified. FALSE means page table is not modified.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize or Entries is NULL.
+  @retval RETURN_INVALID_PARAMETER  Entries are not sorted or overlap each other.
+  @retval RETURN_INVALID_PARAMETER  *FlushRangeCount is not 0 but FlushRanges is NULL.
+  @retval RETURN_INVALID_PARAMETER  Any entry is rejected by the same parameter checks as PageTableMap().
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    The expected buffer size may be larger than what is finally consumed.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or EntryCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapBatch (
+  IN OUT UINTN                 *PageTable  OPTIONAL,
+  IN     PAGING_MODE           PagingMode,
+  IN     VOID                  *Buffer,
+  IN OUT UINTN                 *BufferSize,
+  IN     IA32_MAP_BATCH_ENTRY  *Entries,
+  IN     UINTN                 EntryCount,
+  OUT    IA32_MAP_FLUSH_RANGE  *FlushRanges      OPTIONAL,
+  IN OUT UINTN                 *FlushRangeCount  OPTIONAL,
+  OUT    BOOLEAN               *IsModified       OPTIONAL
+  )
+{
+  RETURN_STATUS       Status;
+  IA32_PAGING_ENTRY   TopPagingEntry;
+  INTN                RequiredSize;
+  UINT64              MaxLinearAddress;
+  UINT64              PreviousLimit;
+  IA32_PAGE_LEVEL     MaxLevel;
+  IA32_PAGE_LEVEL     MaxLeafLevel;
+  IA32_MAP_ATTRIBUTE  ParentAttribute;
+  BOOLEAN             LocalIsModified;
+  BOOLEAN             EntryIsModified;
+  UINTN               Index;
+  UINTN               FlushRangeCapacity;
+  UINTN               LocalFlushRangeCount;
+  UINT8               BufferInStack[SIZE_4KB - 1 + MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY)];
+
+  if ((PagingMode == Paging32bit) || (PagingMode >= PagingModeMax)) {
+    //
+    // 32bit paging is never supported.
+    //
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((PageTable == NULL) || (BufferSize == NULL) || ((Entries == NULL) && (EntryCount != 0))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (*BufferSize % SIZE_4KB != 0) {
+    //
+    // BufferSize should be multiple of 4K.
+    //
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((*BufferSize != 0) && (Buffer == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  FlushRangeCapacity = (FlushRangeCount == NULL) ? 0 : *FlushRangeCount;
+  if ((FlushRangeCapacity != 0) && (FlushRanges == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  MaxLeafLevel     = (IA32_PAGE_LEVEL)(UINT8)PagingMode;
+  MaxLevel         = (IA32_PAGE_LEVEL)(UINT8)(PagingMode >> 8);
+  MaxLinearAddress = (PagingMode == PagingPae) ? LShiftU64 (1, 32) : LShiftU64 (1, 12 + MaxLevel * 9);
+
+  PreviousLimit = 0;
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Entries[Index].Length == 0) {
+      continue;
+    }
 
-    if (*PageTable == 0) {
+    if (((UINTN)Entries[Index].LinearAddress % SIZE_4KB != 0) || ((UINTN)Entries[Index].Length % SIZE_4KB != 0)) {
       //
-      // Do not assign the *PageTable when it's an existing page table.
-      // If it's an existing PAE page table, PagingEntry is the temp buffer in stack.
+      // LinearAddress and Length should be multiple of 4K.
       //
-      *PageTable = (UINTN)PagingEntry;
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if ((Entries[Index].LinearAddress > MaxLinearAddress) || (Entries[Index].Length > MaxLinearAddress - Entries[Index].LinearAddress)) {
+      //
+      // Maximum linear address is (1 << 32), (1 << 48) or (1 << 57)
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if (Entries[Index].LinearAddress < PreviousLimit) {
+      //
+      // Entries should be sorted and should not overlap each other.
+      //
+      return RETURN_INVALID_PARAMETER;
     }
+
+    //
+    // If to map the range as non-present, all attributes except Present should not be provided.
+    //
+    if ((Entries[Index].Attribute.Bits.Present == 0) && (Entries[Index].Mask.Bits.Present == 1) && (Entries[Index].Mask.Uint64 > 1)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    PreviousLimit = Entries[Index].LinearAddress + Entries[Index].Length;
   }
 
-  return Status;
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  *IsModified          = FALSE;
+  LocalFlushRangeCount = 0;
+
+  if (PreviousLimit == 0) {
+    //
+    // No entry has a non-zero length.
+    //
+    if (FlushRangeCount != NULL) {
+      *FlushRangeCount = 0;
+    }
+
+    return RETURN_SUCCESS;
+  }
+
+  PageTableLibGetTopPagingEntry (*PageTable, PagingMode, BufferInStack, &TopPagingEntry);
+
+  ParentAttribute.Uint64                       = 0;
+  ParentAttribute.Bits.PageTableBaseAddressLow = 1;
+  ParentAttribute.Bits.Present                 = 1;
+  ParentAttribute.Bits.ReadWrite               = 1;
+  ParentAttribute.Bits.UserSupervisor          = 1;
+  ParentAttribute.Bits.Nx                      = 0;
+
+  //
+  // Query the required buffer size without modifying the page table.
+  // Each entry is checked against the original page table. Because the entries don't overlap and applying one
+  // entry never takes away the page directories another entry could use, the sum is never less than what is
+  // consumed when the entries are applied one after another.
+  //
+  RequiredSize = 0;
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Entries[Index].Length == 0) {
+      continue;
+    }
+
+    EntryIsModified = FALSE;
+    Status          = PageTableLibMapInLevel (
+                        &TopPagingEntry,
+                        &ParentAttribute,
+                        FALSE,
+                        NULL,
+                        &RequiredSize,
+                        MaxLevel,
+                        MaxLeafLevel,
+                        Entries[Index].LinearAddress,
+                        Entries[Index].Length,
+                        0,
+                        &Entries[Index].Attribute,
+                        &Entries[Index].Mask,
+                        &EntryIsModified
+                        );
+    ASSERT (EntryIsModified == FALSE);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  RequiredSize = -RequiredSize;
+
+  if ((UINTN)RequiredSize > *BufferSize) {
+    *BufferSize = RequiredSize;
+    return RETURN_BUFFER_TOO_SMALL;
+  }
+
+  if ((RequiredSize != 0) && (Buffer == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Update the page table when the supplied buffer is sufficient.
+  //
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Entries[Index].Length == 0) {
+      continue;
+    }
+
+    EntryIsModified = FALSE;
+    Status          = PageTableLibMapInLevel (
+                        &TopPagingEntry,
+                        &ParentAttribute,
+                        TRUE,
+                        Buffer,
+                        (INTN *)BufferSize,
+                        MaxLevel,
+                        MaxLeafLevel,
+                        Entries[Index].LinearAddress,
+                        Entries[Index].Length,
+                        0,
+                        &Entries[Index].Attribute,
+                        &Entries[Index].Mask,
+                        &EntryIsModified
+                        );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    if (EntryIsModified) {
+      *IsModified = TRUE;
+      PageTableLibAddFlushRange (FlushRanges, FlushRangeCapacity, &LocalFlushRangeCount, Entries[Index].LinearAddress, Entries[Index].Length);
+    }
+  }
+
+  //
+  // Promote the uniform page directories in the updated ranges to large pages.
+  //
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((Entries[Index].Length == 0) || (TopPagingEntry.Pce.Present == 0)) {
+      continue;
+    }
+
+    PageTableLibPromoteInLevel (
+      &TopPagingEntry,
+      &ParentAttribute,
+      MaxLevel,
+      MaxLeafLevel,
+      0,
+      Entries[Index].LinearAddress,
+      Entries[Index].Length,
+      FlushRanges,
+      FlushRangeCapacity,
+      &LocalFlushRangeCount,
+      IsModified
+      );
+  }
+
+  PageTableLibSetTopPagingEntry (PageTable, PagingMode, &TopPagingEntry);
+
+  if (FlushRangeCount != NULL) {
+    *FlushRangeCount = LocalFlushRangeCount;
+  }
+
+  return RETURN_SUCCESS;
 }
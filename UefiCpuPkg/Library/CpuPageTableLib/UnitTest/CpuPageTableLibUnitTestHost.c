@@ -821,6 +821,127 @@ TestCaseToCheckMapMaskAndAttr (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Check PageTableMapBatch promotes uniform page directories to large pages
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseBatchMapPromote (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                 PageTable;
+  PAGING_MODE           PagingMode;
+  VOID                  *Buffer;
+  UINTN                 PageTableBufferSize;
+  IA32_MAP_ATTRIBUTE    MapAttribute;
+  IA32_MAP_ATTRIBUTE    MapMask;
+  IA32_MAP_BATCH_ENTRY  Entries[2];
+  IA32_MAP_BATCH_ENTRY  TempEntry;
+  IA32_MAP_FLUSH_RANGE  FlushRanges[4];
+  UINTN                 FlushRangeCount;
+  BOOLEAN               IsModified;
+  IA32_PAGING_ENTRY     *Pml4;
+  IA32_PAGING_ENTRY     *Pdpte;
+  RETURN_STATUS         Status;
+  UNIT_TEST_STATUS      TestStatus;
+
+  //
+  // Create Page table to cover [0,1G] with one 1G entry.
+  //
+  PagingMode                  = Paging4Level1GB;
+  PageTableBufferSize         = 0;
+  PageTable                   = 0;
+  Buffer                      = NULL;
+  MapAttribute.Uint64         = 0;
+  MapMask.Uint64              = MAX_UINT64;
+  MapAttribute.Bits.Present   = 1;
+  MapAttribute.Bits.ReadWrite = 1;
+  Status                      = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, (UINT64)0, (UINT64)SIZE_1GB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+  Status = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, (UINT64)0, (UINT64)SIZE_1GB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+
+  //
+  // Set [0, 4K] as ReadOnly so the 1G entry is split to 2M and 4K entries.
+  //
+  MapAttribute.Uint64         = 0;
+  MapMask.Uint64              = 0;
+  MapMask.Bits.ReadWrite      = 1;
+  MapAttribute.Bits.ReadWrite = 0;
+  PageTableBufferSize         = 0;
+  Status                      = PageTableMap (&PageTable, PagingMode, NULL, &PageTableBufferSize, (UINT64)0, (UINT64)SIZE_4KB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+  Status = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, (UINT64)0, (UINT64)SIZE_4KB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+
+  Pml4  = (IA32_PAGING_ENTRY *)PageTable;
+  Pdpte = (IA32_PAGING_ENTRY *)(UINTN)IA32_PNLE_PAGE_TABLE_BASE_ADDRESS (&Pml4[0].Pnle);
+  UT_ASSERT_FALSE (IsPle (&Pdpte[0], 3));
+
+  //
+  // Set [0, 4K] back to ReadWrite in a batch with an entry that doesn't change anything.
+  //
+  Entries[0].LinearAddress            = 0;
+  Entries[0].Length                   = SIZE_4KB;
+  Entries[0].Attribute.Uint64         = 0;
+  Entries[0].Attribute.Bits.ReadWrite = 1;
+  Entries[0].Mask.Uint64              = 0;
+  Entries[0].Mask.Bits.ReadWrite      = 1;
+  Entries[1].LinearAddress            = SIZE_512MB;
+  Entries[1].Length                   = SIZE_4KB;
+  Entries[1].Attribute.Uint64         = Entries[0].Attribute.Uint64;
+  Entries[1].Mask.Uint64              = Entries[0].Mask.Uint64;
+
+  //
+  // Entries should be sorted.
+  //
+  TempEntry           = Entries[0];
+  Entries[0]          = Entries[1];
+  Entries[1]          = TempEntry;
+  PageTableBufferSize = 0;
+  Status              = PageTableMapBatch (&PageTable, PagingMode, NULL, &PageTableBufferSize, Entries, ARRAY_SIZE (Entries), NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_INVALID_PARAMETER);
+  Entries[1] = Entries[0];
+  Entries[0] = TempEntry;
+
+  PageTableBufferSize = 0;
+  FlushRangeCount     = ARRAY_SIZE (FlushRanges);
+  Status              = PageTableMapBatch (&PageTable, PagingMode, NULL, &PageTableBufferSize, Entries, ARRAY_SIZE (Entries), FlushRanges, &FlushRangeCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_TRUE (IsModified);
+
+  //
+  // The 4K and 2M page directories are replaced by the 1G entry again.
+  //
+  UT_ASSERT_TRUE (IsPle (&Pdpte[0], 3));
+  UT_ASSERT_EQUAL (Pdpte[0].PleB.Bits.ReadWrite, 1);
+  UT_ASSERT_EQUAL (FlushRangeCount, 1);
+  UT_ASSERT_EQUAL (FlushRanges[0].LinearAddress, 0);
+  UT_ASSERT_EQUAL (FlushRanges[0].Length, SIZE_1GB);
+
+  TestStatus = IsPageTableValid (PageTable, PagingMode);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   sample unit tests and run the unit tests.
@@ -871,6 +992,7 @@ UefiTestMain (
   AddTestCase (ManualTestCase, "Check if the parent entry has different Nx attribute", "Manual Test Case6", TestCaseManualChangeNx, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check if the needed size is expected", "Manual Test Case7", TestCaseManualSizeNotMatch, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check MapMask when creating new page table or mapping not-present range", "Manual Test Case8", TestCaseToCheckMapMaskAndAttr, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check PageTableMapBatch promotes uniform page directories", "Manual Test Case9", TestCaseBatchMapPromote, NULL, NULL, NULL);
   //
   // Populate the Random Test Cases.
   //
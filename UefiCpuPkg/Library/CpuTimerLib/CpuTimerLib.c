@@ -1,6 +1,10 @@
 /** @file
   CPUID Leaf 0x15 for Core Crystal Clock frequency instance of Timer Library.
 
+  The TSC frequency is read from CPUID, never calibrated: from the timing leaf
+  of the hypervisor in a virtual machine, else from leaf 0x15, else from the
+  processor base frequency of leaf 0x16.
+
   Copyright (c) 2019 Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -17,6 +21,14 @@ GUID  mCpuCrystalFrequencyHobGuid = {
   0xe1ec5ad0, 0x8569, 0x46bd, { 0x8d, 0xcd, 0x3b, 0x9f, 0x6f, 0x45, 0x82, 0x7a }
 };
 
+//
+// The CPUID leaves of the hypervisors: EAX of the first one is the largest
+// hypervisor leaf, and EAX of the timing leaf, that KVM, VMware and other
+// hypervisors provide, is the TSC frequency in kHz.
+//
+#define CPUID_HYPERVISOR_INFORMATION  0x40000000
+#define CPUID_HYPERVISOR_TIMING       0x40000010
+
 /**
   Internal function to retrieves the 64-bit frequency in Hz.
 
@@ -30,11 +42,72 @@ InternalGetPerformanceCounterFrequency (
   VOID
   );
 
+/**
+  Get the TSC frequency from the timing leaf of the hypervisor.
+
+  @return The number of TSC counts per second, 0 if not running in a virtual
+          machine that provides it.
+
+**/
+STATIC
+UINT64
+CpuidHypervisorTscFrequency (
+  VOID
+  )
+{
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
+  UINT32                  MaxLeaf;
+  UINT32                  RegEax;
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+  if (VersionInfoEcx.Bits.ParaVirtualized == 0) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_HYPERVISOR_INFORMATION, &MaxLeaf, NULL, NULL, NULL);
+  if ((MaxLeaf < CPUID_HYPERVISOR_TIMING) || (MaxLeaf >= CPUID_HYPERVISOR_INFORMATION + 0x100)) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_HYPERVISOR_TIMING, &RegEax, NULL, NULL, NULL);
+  return MultU64x32 (RegEax, 1000);
+}
+
+/**
+  Get the TSC frequency from the processor base frequency of CPUID leaf 0x16,
+  that the TSC counts at, to the MHz.
+
+  @return The number of TSC counts per second, 0 if not enumerated.
+
+**/
+STATIC
+UINT64
+CpuidBaseFrequencyTscFrequency (
+  VOID
+  )
+{
+  CPUID_PROCESSOR_FREQUENCY_EAX  Eax;
+  UINT32                         MaxLeaf;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_PROCESSOR_FREQUENCY) {
+    return 0;
+  }
+
+  AsmCpuid (CPUID_PROCESSOR_FREQUENCY, &Eax.Uint32, NULL, NULL, NULL);
+  return MultU64x32 (Eax.Bits.ProcessorBaseFrequency, 1000000);
+}
+
 /**
   CPUID Leaf 0x15 for Core Crystal Clock Frequency.
 
   The TSC counting frequency is determined by using CPUID leaf 0x15. Frequency in MHz = Core XTAL frequency * EBX/EAX.
   In newer flavors of the CPU, core xtal frequency is returned in ECX or 0 if not supported.
+
+  In a virtual machine the timing leaf of the hypervisor is preferred, and
+  where leaf 0x15 does not enumerate the ratio, the processor base frequency
+  of leaf 0x16 is used.
+
   @return The number of TSC counts per second.
 
 **/
@@ -45,24 +118,28 @@ CpuidCoreClockCalculateTscFrequency (
 {
   UINT64  TscFrequency;
   UINT64  CoreXtalFrequency;
+  UINT32  MaxLeaf;
   UINT32  RegEax;
   UINT32  RegEbx;
   UINT32  RegEcx;
 
-  //
-  // Use CPUID leaf 0x15 Time Stamp Counter and Nominal Core Crystal Clock Information
-  // EBX returns 0 if not supported. ECX, if non zero, provides Core Xtal Frequency in hertz.
-  // TSC frequency = (ECX, Core Xtal Frequency) * EBX/EAX.
-  //
-  AsmCpuid (CPUID_TIME_STAMP_COUNTER, &RegEax, &RegEbx, &RegEcx, NULL);
+  TscFrequency = CpuidHypervisorTscFrequency ();
+  if (TscFrequency != 0) {
+    return TscFrequency;
+  }
 
-  //
-  // If EAX or EBX returns 0, the XTAL ratio is not enumerated.
-  //
-  if ((RegEax == 0) || (RegEbx == 0)) {
-    ASSERT (RegEax != 0);
-    ASSERT (RegEbx != 0);
-    return 0;
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_TIME_STAMP_COUNTER) {
+    RegEax = 0;
+    RegEbx = 0;
+    RegEcx = 0;
+  } else {
+    //
+    // Use CPUID leaf 0x15 Time Stamp Counter and Nominal Core Crystal Clock Information
+    // EBX returns 0 if not supported. ECX, if non zero, provides Core Xtal Frequency in hertz.
+    // TSC frequency = (ECX, Core Xtal Frequency) * EBX/EAX.
+    //
+    AsmCpuid (CPUID_TIME_STAMP_COUNTER, &RegEax, &RegEbx, &RegEcx, NULL);
   }
 
   //
@@ -75,6 +152,15 @@ CpuidCoreClockCalculateTscFrequency (
     CoreXtalFrequency = (UINT64)RegEcx;
   }
 
+  //
+  // If EAX or EBX returns 0, the XTAL ratio is not enumerated.
+  //
+  if ((RegEax == 0) || (RegEbx == 0) || (CoreXtalFrequency == 0)) {
+    TscFrequency = CpuidBaseFrequencyTscFrequency ();
+    ASSERT (TscFrequency != 0);
+    return TscFrequency;
+  }
+
   //
   // Calculate TSC frequency = (ECX, Core Xtal Frequency) * EBX/EAX
   //
@@ -511,6 +511,13 @@ CollectProcessorCount (
   CPU_INFO_IN_HOB  *CpuInfoInHob;
   BOOLEAN          X2Apic;
 
+  //
+  // If the BSP is already in x2APIC mode, the APs follow it while they check
+  // in, instead of being woken up once more to switch, which is costly with
+  // many APs.
+  //
+  CpuMpData->X2ApicOnInit = (BOOLEAN)(GetApicMode () == LOCAL_APIC_MODE_X2APIC);
+
   //
   // Send 1st broadcast IPI to APs to wakeup APs
   //
@@ -545,7 +552,7 @@ CollectProcessorCount (
     }
   }
 
-  if (X2Apic) {
+  if (X2Apic && !CpuMpData->X2ApicOnInit) {
     DEBUG ((DEBUG_INFO, "Force x2APIC mode!\n"));
     //
     // Wakeup all APs to enable x2APIC mode
@@ -731,6 +738,13 @@ ApWakeupFunction (
   AP_STACK_DATA     *ApStackData;
   UINT32            OriginalValue;
 
+  if ((CpuMpData->InitFlag == ApInitConfig) && CpuMpData->X2ApicOnInit) {
+    //
+    // Follow the BSP into x2APIC mode before the APIC ID is recorded.
+    //
+    SetApicMode (LOCAL_APIC_MODE_X2APIC);
+  }
+
   //
   // AP's local APIC settings will be lost after received INIT IPI
   // We need to re-initialize them at here
@@ -743,6 +757,7 @@ ApWakeupFunction (
   SyncLocalApicTimerSetting (CpuMpData);
 
   CurrentApicMode = GetApicMode ();
+  ProcessorNumber = MAX_UINTN;
   while (TRUE) {
     if (CpuMpData->InitFlag == ApInitConfig) {
       ProcessorNumber = ApIndex;
@@ -763,9 +778,19 @@ ApWakeupFunction (
       ApStartupSignalBuffer = CpuMpData->CpuData[ProcessorNumber].StartupApSignal;
     } else {
       //
-      // Execute AP function if AP is ready
+      // Execute AP function if AP is ready. An AP staying in its MWAIT or run
+      // loop keeps its processor number from the previous wakeup, so only look
+      // it up again when it no longer matches, e.g. after the processors were
+      // sorted or the BSP was switched. Looking it up on every wakeup costs each
+      // AP a scan of all the processors.
       //
-      GetProcessorNumber (CpuMpData, &ProcessorNumber);
+      CpuInfoInHob = (CPU_INFO_IN_HOB *)(UINTN)CpuMpData->CpuInfoInHob;
+      if ((ProcessorNumber >= CpuMpData->CpuCount) ||
+          (CpuInfoInHob[ProcessorNumber].ApicId != GetApicId ()))
+      {
+        GetProcessorNumber (CpuMpData, &ProcessorNumber);
+      }
+
       //
       // Clear AP start-up signal when AP waken up
       //
@@ -1207,6 +1232,17 @@ FreeResetVector (
 /**
   This function will be called by BSP to wakeup AP.
 
+  How the APs are woken up is the same in PEI and DXE:
+  - An INIT-SIPI-SIPI (or a SIPI only, see PcdFirstTimeWakeUpAPsBySipi) is
+    broadcast to all APs for the initial configuration, where the APs are not
+    known yet and get their stacks from a lock free counter in the exchange
+    buffer.
+  - An INIT-SIPI-SIPI is broadcast for all later wakeups of all APs if the
+    APs are in HLT loop mode (WakeUpByInitSipiSipi), or sent to the one
+    APIC ID for the wakeup of a single AP.
+  - Otherwise the APs are in MWAIT or run loop mode, and only the startup
+    signal of each AP being woken up is written; no IPI is sent.
+
   @param[in] CpuMpData          Pointer to CPU MP Data
   @param[in] Broadcast          TRUE:  Send broadcast IPI to all APs
                                 FALSE: Send IPI to AP by ApicId
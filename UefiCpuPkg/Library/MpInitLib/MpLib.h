@@ -292,6 +292,13 @@ struct _CPU_MP_DATA {
   UINT64                           MicrocodePatchAddress;
   UINT64                           MicrocodePatchRegionSize;
 
+  //
+  // Whether the APs switch to x2APIC mode as soon as they are woken up
+  // for the initial configuration. It is set when the BSP is already in
+  // x2APIC mode, so that no second wakeup is needed to switch the APs.
+  //
+  BOOLEAN        X2ApicOnInit;
+
   //
   // Whether need to use Init-Sipi-Sipi to wake up the APs.
   // Two cases need to set this value to TRUE. One is in HLT
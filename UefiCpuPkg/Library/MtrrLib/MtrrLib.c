@@ -2014,6 +2014,140 @@ MtrrLibMergeVariableMtrr (
   }
 }
 
+/**
+  Try to satisfy the memory attribute requests by adding variable MTRRs on top
+  of the existing variable MTRRs, without recalculating all of them.
+
+  The incremental update is only used when the result is exactly the same as the
+  one the full calculation would produce:
+  1. Each range above 1MB is a naturally aligned power of two so one MTRR covers it.
+  2. Each range lies strictly inside an existing variable MTRR.
+  3. Each range is UC, and all the existing MTRRs overlapping it are not UC; or
+     each range is WT, and all the existing MTRRs overlapping it are WB.
+     Because UC has the highest precedence and WT overrides WB, the new MTRR
+     determines the memory type of the whole range.
+  4. The ranges do not overlap each other.
+  5. There are enough free variable MTRRs for the new ranges.
+
+  @param VariableMtrr              The variable MTRR array.
+  @param VariableMtrrCount         The count of variable MTRRs.
+  @param FirmwareVariableMtrrCount The count of variable MTRRs firmware can use.
+  @param Ranges                    The memory ranges to set.
+  @param RangeCount                The count of memory ranges to set.
+  @param Modified                  Flag array to indicate which variable MTRR is modified.
+
+  @retval TRUE  The requests are satisfied by the new variable MTRRs.
+  @retval FALSE The requests cannot be satisfied incrementally. VariableMtrr
+                and Modified are not changed.
+**/
+BOOLEAN
+MtrrLibAddVariableMtrrIncrementally (
+  IN OUT MTRR_MEMORY_RANGE        *VariableMtrr,
+  IN     UINT32                   VariableMtrrCount,
+  IN     UINT32                   FirmwareVariableMtrrCount,
+  IN     CONST MTRR_MEMORY_RANGE  *Ranges,
+  IN     UINTN                    RangeCount,
+  IN OUT BOOLEAN                  *Modified
+  )
+{
+  UINTN    Index;
+  UINTN    Index2;
+  UINT32   MtrrIndex;
+  UINT32   UsedMtrrCount;
+  UINTN    NewMtrrCount;
+  BOOLEAN  Covered;
+  UINT64   Limit;
+
+  UsedMtrrCount = 0;
+  for (MtrrIndex = 0; MtrrIndex < VariableMtrrCount; MtrrIndex++) {
+    if (VariableMtrr[MtrrIndex].Length != 0) {
+      UsedMtrrCount++;
+    }
+  }
+
+  NewMtrrCount = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    Limit = Ranges[Index].BaseAddress + Ranges[Index].Length;
+    if (Limit <= BASE_1MB) {
+      //
+      // Fixed MTRRs take care of the range below 1MB.
+      //
+      continue;
+    }
+
+    if ((Ranges[Index].BaseAddress < BASE_1MB) ||
+        (GetPowerOfTwo64 (Ranges[Index].Length) != Ranges[Index].Length) ||
+        ((Ranges[Index].BaseAddress & (Ranges[Index].Length - 1)) != 0) ||
+        ((Ranges[Index].Type != CacheUncacheable) && (Ranges[Index].Type != CacheWriteThrough)))
+    {
+      return FALSE;
+    }
+
+    Covered = FALSE;
+    for (MtrrIndex = 0; MtrrIndex < VariableMtrrCount; MtrrIndex++) {
+      if ((VariableMtrr[MtrrIndex].Length == 0) ||
+          (VariableMtrr[MtrrIndex].BaseAddress >= Limit) ||
+          (VariableMtrr[MtrrIndex].BaseAddress + VariableMtrr[MtrrIndex].Length <= Ranges[Index].BaseAddress))
+      {
+        continue;
+      }
+
+      if (Ranges[Index].Type == CacheUncacheable) {
+        if (VariableMtrr[MtrrIndex].Type == CacheUncacheable) {
+          return FALSE;
+        }
+      } else if (VariableMtrr[MtrrIndex].Type != CacheWriteBack) {
+        return FALSE;
+      }
+
+      if ((VariableMtrr[MtrrIndex].BaseAddress <= Ranges[Index].BaseAddress) &&
+          (VariableMtrr[MtrrIndex].BaseAddress + VariableMtrr[MtrrIndex].Length >= Limit) &&
+          (VariableMtrr[MtrrIndex].Length > Ranges[Index].Length))
+      {
+        Covered = TRUE;
+      }
+    }
+
+    if (!Covered) {
+      return FALSE;
+    }
+
+    for (Index2 = Index + 1; Index2 < RangeCount; Index2++) {
+      if ((Ranges[Index2].BaseAddress < Limit) &&
+          (Ranges[Index2].BaseAddress + Ranges[Index2].Length > Ranges[Index].BaseAddress))
+      {
+        return FALSE;
+      }
+    }
+
+    NewMtrrCount++;
+  }
+
+  if ((NewMtrrCount == 0) || (UsedMtrrCount + NewMtrrCount > FirmwareVariableMtrrCount)) {
+    return FALSE;
+  }
+
+  //
+  // Put the new MTRRs to the free slots.
+  //
+  MtrrIndex = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (Ranges[Index].BaseAddress < BASE_1MB) {
+      continue;
+    }
+
+    while (VariableMtrr[MtrrIndex].Length != 0) {
+      MtrrIndex++;
+    }
+
+    ASSERT (MtrrIndex < VariableMtrrCount);
+    CopyMem (&VariableMtrr[MtrrIndex], &Ranges[Index], sizeof (Ranges[Index]));
+    Modified[MtrrIndex] = TRUE;
+  }
+
+  return TRUE;
+}
+
 /**
   Calculate the variable MTRR settings for all memory ranges.
 
@@ -2459,6 +2593,24 @@ MtrrSetMemoryAttributesInMtrrSettings (
       }
     }
 
+    //
+    // 2.3.1. Skip the full calculation when the new ranges can be set by adding
+    //        MTRRs on top of the existing variable MTRRs.
+    //
+    if (Modified &&
+        MtrrLibAddVariableMtrrIncrementally (
+          OriginalVariableMtrr,
+          OriginalVariableMtrrCount,
+          FirmwareVariableMtrrCount,
+          Ranges,
+          RangeCount,
+          VariableSettingModified
+          ))
+    {
+      DEBUG ((DEBUG_CACHE, "  Incremental variable MTRR update.\n"));
+      Modified = FALSE;
+    }
+
     if (Modified) {
       //
       // 2.4. Calculate the Variable MTRR settings based on the Ranges.
@@ -301,6 +301,170 @@ UnitTestMtrrSetMemoryAttributesInMtrrSettings (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Benchmark of MtrrLib service MtrrSetMemoryAttributesInMtrrSettings()
+
+  Each round sets a randomized memory layout in one call and then punches an
+  UC hole inside one of the generated non-UC MTRRs, which is the common pattern
+  of carving MMIO holes out of the memory cover. The time spent in both steps is
+  logged so that the MTRR calculation time can be tracked.
+
+  @param[in]  Context    Pointer to MTRR_LIB_SYSTEM_PARAMETER.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrSetMemoryAttributesBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST MTRR_LIB_SYSTEM_PARAMETER  *SystemParameter;
+  RETURN_STATUS                    Status;
+  UINT32                           UcCount;
+  UINT32                           WtCount;
+  UINT32                           WbCount;
+  UINT32                           WpCount;
+  UINT32                           WcCount;
+
+  UINTN          Round;
+  UINT32         Index;
+  UINT8          *Scratch;
+  UINTN          ScratchSize;
+  MTRR_SETTINGS  LocalMtrrs;
+  clock_t        Start;
+  clock_t        FullTime;
+  clock_t        HoleTime;
+
+  MTRR_MEMORY_RANGE  RawMtrrRange[MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  MTRR_MEMORY_RANGE  ExpectedMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINT32             ExpectedVariableMtrrUsage;
+  UINTN              ExpectedMemoryRangesCount;
+
+  MTRR_MEMORY_RANGE  ActualMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINT32             ActualVariableMtrrUsage;
+  UINTN              ActualMemoryRangesCount;
+
+  SystemParameter = (MTRR_LIB_SYSTEM_PARAMETER *)Context;
+  ScratchSize     = SCRATCH_BUFFER_SIZE;
+  Scratch         = calloc (ScratchSize, sizeof (UINT8));
+  FullTime        = 0;
+  HoleTime        = 0;
+
+  for (Round = 0; Round < MTRR_BENCHMARK_ROUNDS; Round++) {
+    GenerateRandomMemoryTypeCombination (
+      SystemParameter->VariableMtrrCount - PatchPcdGet32 (PcdCpuNumberOfReservedVariableMtrrs),
+      &UcCount,
+      &WtCount,
+      &WbCount,
+      &WpCount,
+      &WcCount
+      );
+    GenerateValidAndConfigurableMtrrPairs (
+      SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+      RawMtrrRange,
+      UcCount,
+      WtCount,
+      WbCount,
+      WpCount,
+      WcCount
+      );
+
+    ExpectedVariableMtrrUsage = UcCount + WtCount + WbCount + WpCount + WcCount;
+    ExpectedMemoryRangesCount = ARRAY_SIZE (ExpectedMemoryRanges);
+    GetEffectiveMemoryRanges (
+      SystemParameter->DefaultCacheType,
+      SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+      RawMtrrRange,
+      ExpectedVariableMtrrUsage,
+      ExpectedMemoryRanges,
+      &ExpectedMemoryRangesCount
+      );
+
+    ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+    LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+
+    Start  = clock ();
+    Status = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, ExpectedMemoryRanges, ExpectedMemoryRangesCount);
+    if (Status == RETURN_BUFFER_TOO_SMALL) {
+      Scratch = realloc (Scratch, ScratchSize);
+      Status  = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, ExpectedMemoryRanges, ExpectedMemoryRangesCount);
+    }
+
+    FullTime += clock () - Start;
+    UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+
+    //
+    // Punch an UC hole in the upper half of the first non-UC MTRR above 1MB.
+    //
+    for (Index = 0; Index < ExpectedVariableMtrrUsage; Index++) {
+      if ((RawMtrrRange[Index].Type != CacheUncacheable) &&
+          (RawMtrrRange[Index].BaseAddress >= BASE_1MB) &&
+          (RawMtrrRange[Index].Length >= 2 * SIZE_4KB))
+      {
+        break;
+      }
+    }
+
+    if (Index == ExpectedVariableMtrrUsage) {
+      continue;
+    }
+
+    RawMtrrRange[ExpectedVariableMtrrUsage].BaseAddress = RawMtrrRange[Index].BaseAddress + RShiftU64 (RawMtrrRange[Index].Length, 1);
+    RawMtrrRange[ExpectedVariableMtrrUsage].Length      = RShiftU64 (RawMtrrRange[Index].Length, 1);
+    RawMtrrRange[ExpectedVariableMtrrUsage].Type        = CacheUncacheable;
+
+    Start  = clock ();
+    Status = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, &RawMtrrRange[ExpectedVariableMtrrUsage], 1);
+    if (Status == RETURN_BUFFER_TOO_SMALL) {
+      Scratch = realloc (Scratch, ScratchSize);
+      Status  = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, &RawMtrrRange[ExpectedVariableMtrrUsage], 1);
+    }
+
+    HoleTime += clock () - Start;
+    UT_ASSERT_TRUE (Status == RETURN_SUCCESS || Status == RETURN_OUT_OF_RESOURCES);
+    if (Status == RETURN_OUT_OF_RESOURCES) {
+      continue;
+    }
+
+    ExpectedMemoryRangesCount = ARRAY_SIZE (ExpectedMemoryRanges);
+    GetEffectiveMemoryRanges (
+      SystemParameter->DefaultCacheType,
+      SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+      RawMtrrRange,
+      ExpectedVariableMtrrUsage + 1,
+      ExpectedMemoryRanges,
+      &ExpectedMemoryRangesCount
+      );
+
+    ActualMemoryRangesCount = ARRAY_SIZE (ActualMemoryRanges);
+    CollectTestResult (
+      SystemParameter->DefaultCacheType,
+      SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+      SystemParameter->VariableMtrrCount,
+      &LocalMtrrs,
+      ActualMemoryRanges,
+      &ActualMemoryRangesCount,
+      &ActualVariableMtrrUsage
+      );
+    VerifyMemoryRanges (ExpectedMemoryRanges, ExpectedMemoryRangesCount, ActualMemoryRanges, ActualMemoryRangesCount);
+  }
+
+  free (Scratch);
+
+  UT_LOG_INFO (
+    "%d rounds: full layout %lld us, UC hole %lld us\n",
+    MTRR_BENCHMARK_ROUNDS,
+    (INT64)FullTime * 1000000 / CLOCKS_PER_SEC,
+    (INT64)HoleTime * 1000000 / CLOCKS_PER_SEC
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Test routine to check whether invalid base/size can be rejected.
 
@@ -1144,6 +1308,8 @@ UnitTestingEntry (
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings", "MtrrSetMemoryAttributeInMtrrSettings", UnitTestMtrrSetMemoryAttributeInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesInMtrrSettings", UnitTestMtrrSetMemoryAttributesInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
     }
+
+    AddTestCase (MtrrApiTests, "Benchmark MtrrSetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesBenchmark", UnitTestMtrrSetMemoryAttributesBenchmark, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
   }
 
   //
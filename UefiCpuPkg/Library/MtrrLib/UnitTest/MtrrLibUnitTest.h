@@ -34,6 +34,11 @@
 
 #define SCRATCH_BUFFER_SIZE  SIZE_16KB
 
+//
+// Number of random layouts used by the MtrrSetMemoryAttributesInMtrrSettings() benchmark.
+//
+#define MTRR_BENCHMARK_ROUNDS  100
+
 typedef struct {
   UINT8                     PhysicalAddressBits;
   BOOLEAN                   MtrrSupported;
@@ -1011,14 +1011,14 @@ ProgramProcessorRegister (
       // MemoryMapped operations
       //
       case MemoryMapped:
-        AcquireSpinLock (&CpuFlags->MemoryMappedLock);
+        AcquireTicketLock (&CpuFlags->MemoryMappedLock);
         MmioBitFieldWrite32 (
           (UINTN)(RegisterTableEntry->Index | LShiftU64 (RegisterTableEntry->HighIndex, 32)),
           RegisterTableEntry->ValidBitStart,
           RegisterTableEntry->ValidBitStart + RegisterTableEntry->ValidBitLength - 1,
           (UINT32)RegisterTableEntry->Value
           );
-        ReleaseSpinLock (&CpuFlags->MemoryMappedLock);
+        ReleaseTicketLock (&CpuFlags->MemoryMappedLock);
         break;
       //
       // Enable or disable cache
@@ -58,7 +58,7 @@ typedef struct {
 // Flags used when program the register.
 //
 typedef struct {
-  volatile UINTN     MemoryMappedLock;              // Spinlock used to program mmio
+  TICKET_LOCK        MemoryMappedLock;              // Ticket lock used to program mmio
   volatile UINT32    *CoreSemaphoreCount;           // Semaphore containers used to program Core semaphore.
   volatile UINT32    *PackageSemaphoreCount;        // Semaphore containers used to program Package semaphore.
 } PROGRAM_CPU_REGISTER_FLAGS;
@@ -873,7 +873,7 @@ RegisterCpuFeature (
   CpuFeaturesData = GetCpuFeaturesData ();
   if (CpuFeaturesData->FeaturesCount == 0) {
     InitializeListHead (&CpuFeaturesData->FeatureList);
-    InitializeSpinLock (&CpuFeaturesData->CpuFlags.MemoryMappedLock);
+    InitializeTicketLock (&CpuFeaturesData->CpuFlags.MemoryMappedLock);
     //
     // Code assumes below three PCDs have PCD same buffer size.
     //
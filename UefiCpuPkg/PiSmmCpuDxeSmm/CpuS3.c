@@ -31,11 +31,18 @@ typedef struct {
   UINTN    LongJumpOffset;
 } MP_ASSEMBLY_ADDRESS_MAP;
 
+//
+// Number of the spin locks used to program the MemoryMapped entries. An entry
+// takes the lock selected by the cache line of its address, so the processors
+// rarely wait for each other when they program different registers.
+//
+#define CPU_S3_MEMORY_MAPPED_LOCK_COUNT  16
+
 //
 // Flags used when program the register.
 //
 typedef struct {
-  volatile UINTN     MemoryMappedLock;              // Spinlock used to program mmio
+  TICKET_LOCK        MemoryMappedLock[CPU_S3_MEMORY_MAPPED_LOCK_COUNT]; // Ticket locks used to program mmio
   volatile UINT32    *CoreSemaphoreCount;           // Semaphore container used to program
                                                     // core level semaphore.
   volatile UINT32    *PackageSemaphoreCount;        // Semaphore container used to program
@@ -247,6 +254,8 @@ ProgramProcessorRegister (
   UINT8                     *ThreadCountPerCore;
   EFI_STATUS                Status;
   UINT64                    CurrentValue;
+  UINTN                     Address;
+  TICKET_LOCK               *MemoryMappedLock;
 
   //
   // Traverse Register Table of this logical processor
@@ -339,14 +348,16 @@ ProgramProcessorRegister (
       // MemoryMapped operations
       //
       case MemoryMapped:
-        AcquireSpinLock (&CpuFlags->MemoryMappedLock);
+        Address          = (UINTN)(RegisterTableEntry->Index | LShiftU64 (RegisterTableEntry->HighIndex, 32));
+        MemoryMappedLock = &CpuFlags->MemoryMappedLock[(Address >> 6) & (CPU_S3_MEMORY_MAPPED_LOCK_COUNT - 1)];
+        AcquireTicketLock (MemoryMappedLock);
         MmioBitFieldWrite32 (
-          (UINTN)(RegisterTableEntry->Index | LShiftU64 (RegisterTableEntry->HighIndex, 32)),
+          Address,
           RegisterTableEntry->ValidBitStart,
           RegisterTableEntry->ValidBitStart + RegisterTableEntry->ValidBitLength - 1,
           (UINT32)RegisterTableEntry->Value
           );
-        ReleaseSpinLock (&CpuFlags->MemoryMappedLock);
+        ReleaseTicketLock (MemoryMappedLock);
         break;
       //
       // Enable or disable cache
@@ -635,18 +646,15 @@ PrepareApStartupVector (
   The function is invoked before SMBASE relocation in S3 path. It does first time microcode load
   and restores MTRRs for both BSP and APs.
 
+  The APs are started first, so that the BSP restores its own registers while
+  the APs restore theirs.
+
 **/
 VOID
 InitializeCpuBeforeRebase (
   VOID
   )
 {
-  LoadMtrrData (mAcpiCpuData.MtrrTable);
-
-  SetRegister (TRUE);
-
-  ProgramVirtualWireMode ();
-
   PrepareApStartupVector (mAcpiCpuData.StartupVector);
 
   if (FeaturePcdGet (PcdCpuHotPlugSupport)) {
@@ -668,6 +676,12 @@ InitializeCpuBeforeRebase (
   //
   SendInitSipiSipiAllExcludingSelf ((UINT32)mAcpiCpuData.StartupVector);
 
+  LoadMtrrData (mAcpiCpuData.MtrrTable);
+
+  SetRegister (TRUE);
+
+  ProgramVirtualWireMode ();
+
   while (mNumberToFinish > 0) {
     CpuPause ();
   }
@@ -714,6 +728,32 @@ InitializeCpuAfterRebase (
   }
 }
 
+/**
+  Get the time between two values of the performance counter.
+
+  @param[in]  Begin       The first value of the performance counter.
+  @param[in]  End         The second value of the performance counter.
+
+  @return The time between the two values, in microseconds.
+**/
+STATIC
+UINT64
+S3ElapsedMicroseconds (
+  IN UINT64  Begin,
+  IN UINT64  End
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (EndValue < StartValue) {
+    return DivU64x32 (GetTimeInNanoSecond (Begin - End), 1000);
+  }
+
+  return DivU64x32 (GetTimeInNanoSecond (End - Begin), 1000);
+}
+
 /**
   Restore SMM Configuration in S3 boot path.
 
@@ -767,6 +807,10 @@ SmmRestoreCpu (
   IA32_DESCRIPTOR           X64Idtr;
   IA32_IDT_GATE_DESCRIPTOR  IdtEntryTable[EXCEPTION_VECTOR_NUMBER];
   EFI_STATUS                Status;
+  UINT64                    Begin;
+  UINT64                    Rebase;
+  UINT64                    Rebased;
+  UINT64                    End;
 
   DEBUG ((DEBUG_INFO, "SmmRestoreCpu()\n"));
 
@@ -813,6 +857,8 @@ SmmRestoreCpu (
     InitializeDebugAgent (DEBUG_AGENT_INIT_THUNK_PEI_IA32TOX64, (VOID *)&Ia32Idtr, NULL);
   }
 
+  Begin = GetPerformanceCounter ();
+
   //
   // Skip initialization if mAcpiCpuData is not valid
   //
@@ -823,6 +869,8 @@ SmmRestoreCpu (
     InitializeCpuBeforeRebase ();
   }
 
+  Rebase = GetPerformanceCounter ();
+
   DEBUG ((DEBUG_INFO, "SmmRestoreCpu: mSmmRelocated is %d\n", mSmmRelocated));
 
   //
@@ -841,6 +889,8 @@ SmmRestoreCpu (
     ExecuteFirstSmiInit ();
   }
 
+  Rebased = GetPerformanceCounter ();
+
   //
   // Skip initialization if mAcpiCpuData is not valid
   //
@@ -851,6 +901,17 @@ SmmRestoreCpu (
     InitializeCpuAfterRebase ();
   }
 
+  End = GetPerformanceCounter ();
+  DEBUG ((
+    DEBUG_INFO,
+    "SmmRestoreCpu: %d CPUs restored in %ld us (before rebase %ld us, SMM init %ld us, after rebase %ld us)\n",
+    mNumberOfCpus,
+    S3ElapsedMicroseconds (Begin, End),
+    S3ElapsedMicroseconds (Begin, Rebase),
+    S3ElapsedMicroseconds (Rebase, Rebased),
+    S3ElapsedMicroseconds (Rebased, End)
+    ));
+
   //
   // Set a flag to restore SMM configuration in S3 path.
   //
@@ -1130,6 +1191,7 @@ GetAcpiCpuData (
   VOID                    *IdtForAp;
   VOID                    *MachineCheckHandlerForAp;
   CPU_STATUS_INFORMATION  *CpuStatus;
+  UINTN                   Index;
 
   if (!mAcpiS3Enable) {
     return;
@@ -1211,7 +1273,9 @@ GetAcpiCpuData (
                                         );
     ASSERT (mCpuFlags.PackageSemaphoreCount != NULL);
 
-    InitializeSpinLock ((SPIN_LOCK *)&mCpuFlags.MemoryMappedLock);
+    for (Index = 0; Index < CPU_S3_MEMORY_MAPPED_LOCK_COUNT; Index++) {
+      InitializeTicketLock (&mCpuFlags.MemoryMappedLock[Index]);
+    }
   }
 }
 
@@ -28,7 +28,7 @@ SmmInitPageTable (
   //
   // Initialize spin lock
   //
-  InitializeSpinLock (mPFLock);
+  InitializeMcsLock (mPFLock);
 
   mPhysicalAddressBits = 32;
   mPagingMode          = PagingPae;
@@ -93,13 +93,18 @@ SmiPFHandler (
   IN EFI_SYSTEM_CONTEXT  SystemContext
   )
 {
-  UINTN  PFAddress;
-  UINTN  GuardPageAddress;
-  UINTN  CpuIndex;
+  UINTN          PFAddress;
+  UINTN          GuardPageAddress;
+  UINTN          CpuIndex;
+  MCS_LOCK_NODE  PFLockNode;
 
   ASSERT (InterruptType == EXCEPT_IA32_PAGE_FAULT);
 
-  AcquireSpinLock (mPFLock);
+  //
+  // All the processors may take page faults at the same time, so queue them
+  // up on the MCS lock and let each of them wait on its own node.
+  //
+  AcquireMcsLock (mPFLock, &PFLockNode);
 
   PFAddress = AsmReadCr2 ();
 
@@ -200,7 +205,7 @@ SmiPFHandler (
   }
 
 Exit:
-  ReleaseSpinLock (mPFLock);
+  ReleaseMcsLock (mPFLock, &PFLockNode);
 }
 
 /**
@@ -19,7 +19,7 @@ SMM_DISPATCHER_MP_SYNC_DATA  *mSmmMpSyncData = NULL;
 UINTN                        mSmmMpSyncDataSize;
 SMM_CPU_SEMAPHORES           mSmmCpuSemaphores;
 UINTN                        mSemaphoreSize;
-SPIN_LOCK                    *mPFLock = NULL;
+MCS_LOCK                     *mPFLock = NULL;
 SMM_CPU_SYNC_MODE            mCpuSmmSyncMode;
 BOOLEAN                      mMachineCheckSupported = FALSE;
 MM_COMPLETION                mSmmStartupThisApToken;
@@ -29,6 +29,17 @@ MM_COMPLETION                mSmmStartupThisApToken;
 //
 UINT32  *mPackageFirstThreadIndex = NULL;
 
+//
+// The CPUs of each package, for PcdCpuSmmHierarchicalSync. The CPUs of package
+// P are mSmmCpuSyncMember[mSmmCpuSyncMemberStart[P]] up to
+// mSmmCpuSyncMember[mSmmCpuSyncMemberStart[P + 1]] excluded.
+//
+BOOLEAN  mSmmCpuSyncHierarchical = FALSE;
+UINT32   mSmmCpuSyncPackageCount = 1;
+UINT32   *mSmmCpuSyncPackage     = NULL;
+UINT32   *mSmmCpuSyncMemberStart = NULL;
+UINT32   *mSmmCpuSyncMember      = NULL;
+
 /**
   Performs an atomic compare exchange operation to get semaphore.
   The compare exchange operation must be performed using
@@ -121,9 +132,30 @@ LockdownSemaphore (
   return Value;
 }
 
+/**
+  Get the arrival counter of a package.
+
+  @param   Package          Index of the package.
+
+  @return  The semaphore counting the arrivals of the APs of the package.
+
+**/
+STATIC
+volatile UINT32 *
+GetPackageArrival (
+  IN      UINT32  Package
+  )
+{
+  return (volatile UINT32 *)((UINTN)mSmmMpSyncData->PackageArrival + mSemaphoreSize * Package);
+}
+
 /**
   Wait all APs to performs an atomic compare exchange operation to release semaphore.
 
+  With PcdCpuSmmHierarchicalSync, the APs count their arrivals on the counter of
+  their package, and the BSP takes the counts of each package at once rather
+  than one arrival at a time from its own semaphore.
+
   @param   NumberOfAPs      AP number
 
 **/
@@ -132,7 +164,29 @@ WaitForAllAPs (
   IN      UINTN  NumberOfAPs
   )
 {
-  UINTN  BspIndex;
+  UINTN            BspIndex;
+  UINT32           Package;
+  volatile UINT32  *Arrival;
+  UINT32           Value;
+
+  if (mSmmCpuSyncHierarchical) {
+    while (NumberOfAPs > 0) {
+      for (Package = 0; Package < mSmmCpuSyncPackageCount; Package++) {
+        Arrival = GetPackageArrival (Package);
+        Value   = *Arrival;
+        if ((Value != 0) &&
+            (InterlockedCompareExchange32 ((UINT32 *)Arrival, Value, 0) == Value))
+        {
+          ASSERT (Value <= NumberOfAPs);
+          NumberOfAPs -= Value;
+        }
+      }
+
+      CpuPause ();
+    }
+
+    return;
+  }
 
   BspIndex = mSmmMpSyncData->BspIndex;
   while (NumberOfAPs-- > 0) {
@@ -140,6 +194,26 @@ WaitForAllAPs (
   }
 }
 
+/**
+  Signal the BSP the arrival of an AP at a rendezvous of the SMI handlers.
+
+  @param   CpuIndex         AP processor Index.
+  @param   BspIndex         BSP processor Index.
+
+**/
+VOID
+ReleaseBsp (
+  IN      UINTN  CpuIndex,
+  IN      UINTN  BspIndex
+  )
+{
+  if (mSmmCpuSyncHierarchical) {
+    ReleaseSemaphore (GetPackageArrival (mSmmCpuSyncPackage[CpuIndex]));
+  } else {
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  }
+}
+
 /**
   Performs an atomic compare exchange operation to release semaphore
   for each AP.
@@ -159,6 +233,72 @@ ReleaseAllAPs (
   }
 }
 
+/**
+  Release all the APs at a rendezvous of BSPHandler (), which happen once the
+  counter of the checked-in processors is locked down.
+
+  With PcdCpuSmmHierarchicalSync, the BSP only releases the first present AP of
+  each package, which releases the other present APs of its package in
+  WaitForBsp ().
+
+**/
+VOID
+ReleaseAllAPsInSync (
+  VOID
+  )
+{
+  UINT32  Package;
+  UINT32  Member;
+  UINTN   Index;
+
+  if (!mSmmCpuSyncHierarchical) {
+    ReleaseAllAPs ();
+    return;
+  }
+
+  for (Package = 0; Package < mSmmCpuSyncPackageCount; Package++) {
+    for (Member = mSmmCpuSyncMemberStart[Package]; Member < mSmmCpuSyncMemberStart[Package + 1]; Member++) {
+      Index = mSmmCpuSyncMember[Member];
+      if (IsPresentAp (Index)) {
+        *(mSmmMpSyncData->CpuData[Index].Forward) = TRUE;
+        ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+        break;
+      }
+    }
+  }
+}
+
+/**
+  Wait for the signal of the BSP to an AP, and release the other present APs
+  of its package if the BSP asked this AP to forward the signal.
+
+  @param   CpuIndex         AP processor Index.
+
+**/
+VOID
+WaitForBsp (
+  IN      UINTN  CpuIndex
+  )
+{
+  UINT32  Package;
+  UINT32  Member;
+  UINTN   Index;
+
+  WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+
+  if (mSmmCpuSyncHierarchical && *(mSmmMpSyncData->CpuData[CpuIndex].Forward)) {
+    *(mSmmMpSyncData->CpuData[CpuIndex].Forward) = FALSE;
+
+    Package = mSmmCpuSyncPackage[CpuIndex];
+    for (Member = mSmmCpuSyncMemberStart[Package]; Member < mSmmCpuSyncMemberStart[Package + 1]; Member++) {
+      Index = mSmmCpuSyncMember[Member];
+      if ((Index != CpuIndex) && IsPresentAp (Index)) {
+        ReleaseSemaphore (mSmmMpSyncData->CpuData[Index].Run);
+      }
+    }
+  }
+}
+
 /**
   Check whether the index of CPU perform the package level register
   programming during System Management Mode initialization.
@@ -573,6 +713,7 @@ BSPHandler (
   UINTN          ApCount;
   BOOLEAN        ClearTopLevelSmiResult;
   UINTN          PresentCount;
+  UINT64         HandlerBegin;
 
   ASSERT (CpuIndex == mSmmMpSyncData->BspIndex);
   ApCount = 0;
@@ -631,7 +772,7 @@ BSPHandler (
       //
       // Signal all APs it's time for backup MTRRs
       //
-      ReleaseAllAPs ();
+      ReleaseAllAPsInSync ();
 
       //
       // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
@@ -651,7 +792,7 @@ BSPHandler (
       //
       // Let all processors program SMM MTRRs together
       //
-      ReleaseAllAPs ();
+      ReleaseAllAPsInSync ();
 
       //
       // WaitForSemaphore() may wait for ever if an AP happens to enter SMM at
@@ -680,8 +821,17 @@ BSPHandler (
   //
   // Invoke SMM Foundation EntryPoint with the processor information context.
   //
+  HandlerBegin = 0;
+  if (FeaturePcdGet (PcdCpuSmmLatencyHistogram)) {
+    HandlerBegin = SmmLatencyBeginHandler (CpuIndex);
+  }
+
   gSmmCpuPrivate->SmmCoreEntry (&gSmmCpuPrivate->SmmCoreEntryContext);
 
+  if (FeaturePcdGet (PcdCpuSmmLatencyHistogram)) {
+    SmmLatencyEndHandler (HandlerBegin);
+  }
+
   //
   // Make sure all APs have completed their pending none-block tasks
   //
@@ -724,7 +874,7 @@ BSPHandler (
   // Notify all APs to exit
   //
   *mSmmMpSyncData->InsideSmm = FALSE;
-  ReleaseAllAPs ();
+  ReleaseAllAPsInSync ();
 
   //
   // Wait for all APs to complete their pending tasks
@@ -735,7 +885,7 @@ BSPHandler (
     //
     // Signal APs to restore MTRRs
     //
-    ReleaseAllAPs ();
+    ReleaseAllAPsInSync ();
 
     //
     // Restore OS MTRRs
@@ -758,7 +908,7 @@ BSPHandler (
   //
   // Signal APs to Reset states/semaphore for this processor
   //
-  ReleaseAllAPs ();
+  ReleaseAllAPsInSync ();
 
   //
   // Perform pending operations for hot-plug
@@ -785,6 +935,10 @@ BSPHandler (
     MigrateMpPerf (gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus, CpuIndex);
     );
 
+  if (FeaturePcdGet (PcdCpuSmmLatencyHistogram)) {
+    SmmLatencyCollectArrivals ();
+  }
+
   //
   // Reset the tokens buffer.
   //
@@ -900,14 +1054,14 @@ APHandler (
     //
     // Notify BSP of arrival at this point
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseBsp (CpuIndex, BspIndex);
   }
 
   if (SmmCpuFeaturesNeedConfigureMtrrs ()) {
     //
     // Wait for the signal from BSP to backup MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Backup OS MTRRs
@@ -917,12 +1071,12 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseBsp (CpuIndex, BspIndex);
 
     //
     // Wait for BSP's signal to program MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Replace OS MTRRs with SMI MTRRs
@@ -932,14 +1086,14 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseBsp (CpuIndex, BspIndex);
   }
 
   while (TRUE) {
     //
     // Wait for something to happen
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Check if BSP wants to exit SMM
@@ -979,12 +1133,12 @@ APHandler (
     //
     // Notify BSP the readiness of this AP to program MTRRs
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseBsp (CpuIndex, BspIndex);
 
     //
     // Wait for the signal from BSP to program MTRRs
     //
-    WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+    WaitForBsp (CpuIndex);
 
     //
     // Restore OS MTRRs
@@ -996,12 +1150,12 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to Reset states/semaphore for this processor
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseBsp (CpuIndex, BspIndex);
 
   //
   // Wait for the signal from BSP to Reset states/semaphore for this processor
   //
-  WaitForSemaphore (mSmmMpSyncData->CpuData[CpuIndex].Run);
+  WaitForBsp (CpuIndex);
 
   //
   // Reset states/semaphore for this processor
@@ -1011,7 +1165,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to exit SMM
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseBsp (CpuIndex, BspIndex);
 }
 
 /**
@@ -1063,11 +1217,13 @@ AllocateTokenBuffer (
   )
 {
   UINTN            SpinLockSize;
+  UINTN            ProcTokenSize;
   UINT32           TokenCountPerChunk;
   UINTN            Index;
   SPIN_LOCK        *SpinLock;
   UINT8            *SpinLockBuffer;
-  PROCEDURE_TOKEN  *ProcTokens;
+  UINT8            *ProcTokenBuffer;
+  PROCEDURE_TOKEN  *ProcToken;
 
   SpinLockSize = GetSpinLockProperties ();
 
@@ -1086,21 +1242,28 @@ AllocateTokenBuffer (
   SpinLockBuffer = AllocatePool (SpinLockSize * TokenCountPerChunk);
   ASSERT (SpinLockBuffer != NULL);
 
-  ProcTokens = AllocatePool (sizeof (PROCEDURE_TOKEN) * TokenCountPerChunk);
-  ASSERT (ProcTokens != NULL);
+  //
+  // The APs decrement RunningApCount of the token of their procedure, each token
+  // takes at least the size of a spin lock so that the counters of two tokens do
+  // not share a cache line.
+  //
+  ProcTokenSize   = ALIGN_VALUE (sizeof (PROCEDURE_TOKEN), SpinLockSize);
+  ProcTokenBuffer = AllocatePool (ProcTokenSize * TokenCountPerChunk);
+  ASSERT (ProcTokenBuffer != NULL);
 
   for (Index = 0; Index < TokenCountPerChunk; Index++) {
     SpinLock = (SPIN_LOCK *)(SpinLockBuffer + SpinLockSize * Index);
     InitializeSpinLock (SpinLock);
 
-    ProcTokens[Index].Signature      = PROCEDURE_TOKEN_SIGNATURE;
-    ProcTokens[Index].SpinLock       = SpinLock;
-    ProcTokens[Index].RunningApCount = 0;
+    ProcToken                 = (PROCEDURE_TOKEN *)(ProcTokenBuffer + ProcTokenSize * Index);
+    ProcToken->Signature      = PROCEDURE_TOKEN_SIGNATURE;
+    ProcToken->SpinLock       = SpinLock;
+    ProcToken->RunningApCount = 0;
 
-    InsertTailList (&gSmmCpuPrivate->TokenList, &ProcTokens[Index].Link);
+    InsertTailList (&gSmmCpuPrivate->TokenList, &ProcToken->Link);
   }
 
-  return &ProcTokens[0].Link;
+  return &((PROCEDURE_TOKEN *)ProcTokenBuffer)->Link;
 }
 
 /**
@@ -1361,28 +1524,28 @@ InternalSmmStartupAllAPs (
     return EFI_NOT_STARTED;
   }
 
+  //
+  // The token only counts the APs that run the procedure, so that the excluded
+  // processors do not have to be marked as finished one by one.
+  //
   if (Token != NULL) {
-    ProcToken = GetFreeToken ((UINT32)mMaxNumberOfCpus);
+    ProcToken = GetFreeToken ((UINT32)CpuCount);
     *Token    = (MM_COMPLETION)ProcToken->SpinLock;
   } else {
     ProcToken = NULL;
   }
 
-  //
-  // Make sure all BUSY should be acquired.
-  //
-  // Because former code already check mSmmMpSyncData->CpuData[***].Busy for each AP.
-  // Here code always use AcquireSpinLock instead of AcquireSpinLockOrFail for not
-  // block mode.
-  //
   for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
     if (IsPresentAp (Index)) {
+      //
+      // Make sure all BUSY should be acquired.
+      //
+      // Because former code already check mSmmMpSyncData->CpuData[***].Busy for each AP.
+      // Here code always use AcquireSpinLock instead of AcquireSpinLockOrFail for not
+      // block mode. The AP does not run before ReleaseAllAPs (), so its mailbox
+      // is filled as soon as it is acquired.
+      //
       AcquireSpinLock (mSmmMpSyncData->CpuData[Index].Busy);
-    }
-  }
-
-  for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
-    if (IsPresentAp (Index)) {
       mSmmMpSyncData->CpuData[Index].Procedure = (EFI_AP_PROCEDURE2)Procedure;
       mSmmMpSyncData->CpuData[Index].Parameter = ProcedureArguments;
       if (ProcToken != NULL) {
@@ -1403,13 +1566,6 @@ InternalSmmStartupAllAPs (
       if (CPUStatus != NULL) {
         CPUStatus[Index] = EFI_NOT_STARTED;
       }
-
-      //
-      // Decrease the count to mark this processor(AP or BSP) as finished.
-      //
-      if (ProcToken != NULL) {
-        WaitForSemaphore (&ProcToken->RunningApCount);
-      }
     }
   }
 
@@ -1603,6 +1759,7 @@ SmiRendezvous (
   BOOLEAN     BspInProgress;
   UINTN       Index;
   UINTN       Cr2;
+  UINT64      Entry;
 
   ASSERT (CpuIndex < mMaxNumberOfCpus);
 
@@ -1636,6 +1793,11 @@ SmiRendezvous (
     return;
   }
 
+  Entry = 0;
+  if (FeaturePcdGet (PcdCpuSmmLatencyHistogram) || FeaturePcdGet (PcdCpuSmmProfileSampling)) {
+    Entry = GetPerformanceCounter ();
+  }
+
   //
   // Call the user register Startup function first.
   //
@@ -1708,6 +1870,10 @@ SmiRendezvous (
       // after AP's present flag is detected.
       //
       InitializeSpinLock (mSmmMpSyncData->CpuData[CpuIndex].Busy);
+
+      if (FeaturePcdGet (PcdCpuSmmLatencyHistogram)) {
+        SmmLatencyArrive (CpuIndex, Entry);
+      }
     }
 
     if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
@@ -1769,7 +1935,7 @@ SmiRendezvous (
           }
         }
 
-        if (FeaturePcdGet (PcdCpuSmmProfileEnable)) {
+        if (FeaturePcdGet (PcdCpuSmmProfileEnable) || FeaturePcdGet (PcdCpuSmmProfileSampling)) {
           SmmProfileRecordSmiNum ();
         }
 
@@ -1808,6 +1974,14 @@ Exit:
     MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmRendezvousExit));
     );
 
+  if (FeaturePcdGet (PcdCpuSmmLatencyHistogram)) {
+    SmmLatencyExit (CpuIndex, Entry);
+  }
+
+  if (FeaturePcdGet (PcdCpuSmmProfileSampling)) {
+    SmmProfileRecordSample (CpuIndex, Entry);
+  }
+
   //
   // Restore Cr2
   //
@@ -1872,6 +2046,82 @@ InitializeDataForMmMp (
   gSmmCpuPrivate->FirstFreeToken = AllocateTokenBuffer ();
 }
 
+/**
+  Group the processors by package for PcdCpuSmmHierarchicalSync.
+
+  The hierarchical synchronization is not used with CPU hot-plug, since the
+  package of the processors added later is not known, nor on a single package.
+
+**/
+VOID
+InitializeSmmCpuSyncTopology (
+  VOID
+  )
+{
+  UINT32  Index;
+  UINT32  Package;
+  UINT32  PackageCount;
+
+  if (!FeaturePcdGet (PcdCpuSmmHierarchicalSync) || FeaturePcdGet (PcdCpuHotPlugSupport)) {
+    return;
+  }
+
+  PackageCount = 1;
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    PackageCount = MAX (PackageCount, gSmmCpuPrivate->ProcessorInfo[Index].Location.Package + 1);
+  }
+
+  if ((PackageCount < 2) || (PackageCount > mNumberOfCpus)) {
+    return;
+  }
+
+  mSmmCpuSyncPackage     = AllocatePool (sizeof (UINT32) * mNumberOfCpus);
+  mSmmCpuSyncMember      = AllocatePool (sizeof (UINT32) * mNumberOfCpus);
+  mSmmCpuSyncMemberStart = AllocateZeroPool (sizeof (UINT32) * (PackageCount + 1));
+  if ((mSmmCpuSyncPackage == NULL) || (mSmmCpuSyncMember == NULL) || (mSmmCpuSyncMemberStart == NULL)) {
+    DEBUG ((DEBUG_WARN, "%a: hierarchical SMI synchronization is not used\n", __func__));
+    if (mSmmCpuSyncPackage != NULL) {
+      FreePool (mSmmCpuSyncPackage);
+    }
+
+    if (mSmmCpuSyncMember != NULL) {
+      FreePool (mSmmCpuSyncMember);
+    }
+
+    if (mSmmCpuSyncMemberStart != NULL) {
+      FreePool (mSmmCpuSyncMemberStart);
+    }
+
+    return;
+  }
+
+  //
+  // Count the processors of each package, then list them package after package.
+  //
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    Package                   = gSmmCpuPrivate->ProcessorInfo[Index].Location.Package;
+    mSmmCpuSyncPackage[Index] = Package;
+    mSmmCpuSyncMemberStart[Package + 1]++;
+  }
+
+  for (Package = 0; Package < PackageCount; Package++) {
+    mSmmCpuSyncMemberStart[Package + 1] += mSmmCpuSyncMemberStart[Package];
+  }
+
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    mSmmCpuSyncMember[mSmmCpuSyncMemberStart[mSmmCpuSyncPackage[Index]]++] = Index;
+  }
+
+  for (Package = PackageCount; Package > 0; Package--) {
+    mSmmCpuSyncMemberStart[Package] = mSmmCpuSyncMemberStart[Package - 1];
+  }
+
+  mSmmCpuSyncMemberStart[0] = 0;
+  mSmmCpuSyncPackageCount   = PackageCount;
+  mSmmCpuSyncHierarchical   = TRUE;
+  DEBUG ((DEBUG_INFO, "SMI synchronization across %d packages\n", PackageCount));
+}
+
 /**
   Allocate buffer for all semaphores and spin locks.
 
@@ -1885,16 +2135,20 @@ InitializeSmmCpuSemaphores (
   UINTN  TotalSize;
   UINTN  GlobalSemaphoresSize;
   UINTN  CpuSemaphoresSize;
+  UINTN  PackageSemaphoresSize;
   UINTN  SemaphoreSize;
   UINTN  Pages;
   UINTN  *SemaphoreBlock;
   UINTN  SemaphoreAddr;
 
-  SemaphoreSize        = GetSpinLockProperties ();
-  ProcessorCount       = gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
-  GlobalSemaphoresSize = (sizeof (SMM_CPU_SEMAPHORE_GLOBAL) / sizeof (VOID *)) * SemaphoreSize;
-  CpuSemaphoresSize    = (sizeof (SMM_CPU_SEMAPHORE_CPU) / sizeof (VOID *)) * ProcessorCount * SemaphoreSize;
-  TotalSize            = GlobalSemaphoresSize + CpuSemaphoresSize;
+  InitializeSmmCpuSyncTopology ();
+
+  SemaphoreSize         = GetSpinLockProperties ();
+  ProcessorCount        = gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
+  GlobalSemaphoresSize  = (sizeof (SMM_CPU_SEMAPHORE_GLOBAL) / sizeof (VOID *)) * SemaphoreSize;
+  CpuSemaphoresSize     = (sizeof (SMM_CPU_SEMAPHORE_CPU) / sizeof (VOID *)) * ProcessorCount * SemaphoreSize;
+  PackageSemaphoresSize = mSmmCpuSyncPackageCount * SemaphoreSize;
+  TotalSize             = GlobalSemaphoresSize + CpuSemaphoresSize + PackageSemaphoresSize;
   DEBUG ((DEBUG_INFO, "One Semaphore Size    = 0x%x\n", SemaphoreSize));
   DEBUG ((DEBUG_INFO, "Total Semaphores Size = 0x%x\n", TotalSize));
   Pages          = EFI_SIZE_TO_PAGES (TotalSize);
@@ -1909,7 +2163,7 @@ InitializeSmmCpuSemaphores (
   SemaphoreAddr                                  += SemaphoreSize;
   mSmmCpuSemaphores.SemaphoreGlobal.AllCpusInSync = (BOOLEAN *)SemaphoreAddr;
   SemaphoreAddr                                  += SemaphoreSize;
-  mSmmCpuSemaphores.SemaphoreGlobal.PFLock        = (SPIN_LOCK *)SemaphoreAddr;
+  mSmmCpuSemaphores.SemaphoreGlobal.PFLock        = (MCS_LOCK *)SemaphoreAddr;
   SemaphoreAddr                                  += SemaphoreSize;
   mSmmCpuSemaphores.SemaphoreGlobal.CodeAccessCheckLock
                  = (SPIN_LOCK *)SemaphoreAddr;
@@ -1921,6 +2175,11 @@ InitializeSmmCpuSemaphores (
   mSmmCpuSemaphores.SemaphoreCpu.Run     = (UINT32 *)SemaphoreAddr;
   SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
   mSmmCpuSemaphores.SemaphoreCpu.Present = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Forward = (BOOLEAN *)SemaphoreAddr;
+
+  SemaphoreAddr                    = (UINTN)SemaphoreBlock + GlobalSemaphoresSize + CpuSemaphoresSize;
+  mSmmCpuSemaphores.PackageArrival = (UINT32 *)SemaphoreAddr;
 
   mPFLock                       = mSmmCpuSemaphores.SemaphoreGlobal.PFLock;
   mConfigSmmCodeAccessCheckLock = mSmmCpuSemaphores.SemaphoreGlobal.CodeAccessCheckLock;
@@ -1943,10 +2202,11 @@ InitializeMpSyncData (
   if (mSmmMpSyncData != NULL) {
     //
     // mSmmMpSyncDataSize includes one structure of SMM_DISPATCHER_MP_SYNC_DATA, one
-    // CpuData array of SMM_CPU_DATA_BLOCK and one CandidateBsp array of BOOLEAN.
+    // CpuData array of SMM_CPU_DATA_BLOCK aligned on SMM_CPU_DATA_BLOCK_SIZE and one
+    // CandidateBsp array of BOOLEAN.
     //
     ZeroMem (mSmmMpSyncData, mSmmMpSyncDataSize);
-    mSmmMpSyncData->CpuData      = (SMM_CPU_DATA_BLOCK *)((UINT8 *)mSmmMpSyncData + sizeof (SMM_DISPATCHER_MP_SYNC_DATA));
+    mSmmMpSyncData->CpuData      = (SMM_CPU_DATA_BLOCK *)((UINT8 *)mSmmMpSyncData + ALIGN_VALUE (sizeof (SMM_DISPATCHER_MP_SYNC_DATA), SMM_CPU_DATA_BLOCK_SIZE));
     mSmmMpSyncData->CandidateBsp = (BOOLEAN *)(mSmmMpSyncData->CpuData + gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
     if (FeaturePcdGet (PcdCpuSmmEnableBspElection)) {
       //
@@ -1958,6 +2218,7 @@ InitializeMpSyncData (
     mSmmMpSyncData->EffectiveSyncMode = mCpuSmmSyncMode;
 
     mSmmMpSyncData->Counter       = mSmmCpuSemaphores.SemaphoreGlobal.Counter;
+    mSmmMpSyncData->PackageArrival = mSmmCpuSemaphores.PackageArrival;
     mSmmMpSyncData->InsideSmm     = mSmmCpuSemaphores.SemaphoreGlobal.InsideSmm;
     mSmmMpSyncData->AllCpusInSync = mSmmCpuSemaphores.SemaphoreGlobal.AllCpusInSync;
     ASSERT (
@@ -1967,6 +2228,7 @@ InitializeMpSyncData (
     *mSmmMpSyncData->Counter       = 0;
     *mSmmMpSyncData->InsideSmm     = FALSE;
     *mSmmMpSyncData->AllCpusInSync = FALSE;
+    ZeroMem ((VOID *)mSmmMpSyncData->PackageArrival, mSmmCpuSyncPackageCount * mSemaphoreSize);
 
     mSmmMpSyncData->AllApArrivedWithException = FALSE;
 
@@ -1977,9 +2239,12 @@ InitializeMpSyncData (
         (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Run + mSemaphoreSize * CpuIndex);
       mSmmMpSyncData->CpuData[CpuIndex].Present =
         (BOOLEAN *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Present + mSemaphoreSize * CpuIndex);
+      mSmmMpSyncData->CpuData[CpuIndex].Forward =
+        (BOOLEAN *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.Forward + mSemaphoreSize * CpuIndex);
       *(mSmmMpSyncData->CpuData[CpuIndex].Busy)    = 0;
       *(mSmmMpSyncData->CpuData[CpuIndex].Run)     = 0;
       *(mSmmMpSyncData->CpuData[CpuIndex].Present) = FALSE;
+      *(mSmmMpSyncData->CpuData[CpuIndex].Forward) = FALSE;
     }
   }
 }
@@ -2021,7 +2286,8 @@ InitializeMpServiceData (
   //
   // Initialize mSmmMpSyncData
   //
-  mSmmMpSyncDataSize = sizeof (SMM_DISPATCHER_MP_SYNC_DATA) +
+  ASSERT (sizeof (SMM_CPU_DATA_BLOCK) == SMM_CPU_DATA_BLOCK_SIZE);
+  mSmmMpSyncDataSize = ALIGN_VALUE (sizeof (SMM_DISPATCHER_MP_SYNC_DATA), SMM_CPU_DATA_BLOCK_SIZE) +
                        (sizeof (SMM_CPU_DATA_BLOCK) + sizeof (BOOLEAN)) * gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus;
   mSmmMpSyncData = (SMM_DISPATCHER_MP_SYNC_DATA *)AllocatePages (EFI_SIZE_TO_PAGES (mSmmMpSyncDataSize));
   ASSERT (mSmmMpSyncData != NULL);
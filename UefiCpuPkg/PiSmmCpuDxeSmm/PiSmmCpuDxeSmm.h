@@ -64,6 +64,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "CpuService.h"
 #include "SmmProfile.h"
 #include "SmmMpPerf.h"
+#include "SmmLatency.h"
 
 //
 // CET definition
@@ -398,8 +399,15 @@ SmmRelocationSemaphoreComplete (
   VOID
   );
 
+//
+// The size of the SMM CPU Information of each processor, and the alignment of
+// their array, so that the BSP posting a procedure to an AP does not share a
+// cache line with the other APs that run theirs.
+//
+#define SMM_CPU_DATA_BLOCK_SIZE  64
+
 ///
-/// The type of SMM CPU Information
+/// The type of SMM CPU Information, the mailbox of a processor.
 ///
 typedef struct {
   SPIN_LOCK                     *Busy;
@@ -407,8 +415,12 @@ typedef struct {
   volatile VOID                 *Parameter;
   volatile UINT32               *Run;
   volatile BOOLEAN              *Present;
+  volatile BOOLEAN              *Forward;
   PROCEDURE_TOKEN               *Token;
   EFI_STATUS                    *Status;
+#if defined (MDE_CPU_IA32)
+  UINT32                        Reserved[8];
+#endif
 } SMM_CPU_DATA_BLOCK;
 
 typedef enum {
@@ -424,6 +436,11 @@ typedef struct {
   //
   SMM_CPU_DATA_BLOCK            *CpuData;
   volatile UINT32               *Counter;
+  //
+  // The first of the per-package arrival counters, one semaphore apart, used
+  // instead of the Run semaphore of the BSP with PcdCpuSmmHierarchicalSync.
+  //
+  volatile UINT32               *PackageArrival;
   volatile UINT32               BspIndex;
   volatile BOOLEAN              *InsideSmm;
   volatile BOOLEAN              *AllCpusInSync;
@@ -444,7 +461,7 @@ typedef struct {
   volatile UINT32     *Counter;
   volatile BOOLEAN    *InsideSmm;
   volatile BOOLEAN    *AllCpusInSync;
-  SPIN_LOCK           *PFLock;
+  MCS_LOCK            *PFLock;
   SPIN_LOCK           *CodeAccessCheckLock;
 } SMM_CPU_SEMAPHORE_GLOBAL;
 
@@ -455,6 +472,7 @@ typedef struct {
   SPIN_LOCK           *Busy;
   volatile UINT32     *Run;
   volatile BOOLEAN    *Present;
+  volatile BOOLEAN    *Forward;
   SPIN_LOCK           *Token;
 } SMM_CPU_SEMAPHORE_CPU;
 
@@ -464,6 +482,7 @@ typedef struct {
 typedef struct {
   SMM_CPU_SEMAPHORE_GLOBAL    SemaphoreGlobal;
   SMM_CPU_SEMAPHORE_CPU       SemaphoreCpu;
+  volatile UINT32             *PackageArrival;
 } SMM_CPU_SEMAPHORES;
 
 extern IA32_DESCRIPTOR               gcSmiGdtr;
@@ -480,7 +499,7 @@ extern EFI_SMM_CPU_SERVICE_PROTOCOL  mSmmCpuService;
 extern IA32_DESCRIPTOR               gcSmiInitGdtr;
 extern SMM_CPU_SEMAPHORES            mSmmCpuSemaphores;
 extern UINTN                         mSemaphoreSize;
-extern SPIN_LOCK                     *mPFLock;
+extern MCS_LOCK                      *mPFLock;
 extern SPIN_LOCK                     *mConfigSmmCodeAccessCheckLock;
 extern EFI_SMRAM_DESCRIPTOR          *mSmmCpuSmramRanges;
 extern UINTN                         mSmmCpuSmramRangeCount;
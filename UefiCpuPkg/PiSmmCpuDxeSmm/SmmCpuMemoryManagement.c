@@ -1377,53 +1377,142 @@ GetUefiMemoryMap (
   GetUefiMemoryAttributesTable ();
 }
 
+/**
+  Function to compare 2 IA32_MAP_BATCH_ENTRY based on linear address.
+
+  @param[in] Buffer1            pointer to first IA32_MAP_BATCH_ENTRY to compare
+  @param[in] Buffer2            pointer to second IA32_MAP_BATCH_ENTRY to compare
+
+  @retval 0                     Buffer1 equal to Buffer2
+  @retval <0                    Buffer1 is less than Buffer2
+  @retval >0                    Buffer1 is greater than Buffer2
+**/
+STATIC
+INTN
+EFIAPI
+MapBatchEntryCompare (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  if (((IA32_MAP_BATCH_ENTRY *)Buffer1)->LinearAddress > ((IA32_MAP_BATCH_ENTRY *)Buffer2)->LinearAddress) {
+    return 1;
+  } else if (((IA32_MAP_BATCH_ENTRY *)Buffer1)->LinearAddress < ((IA32_MAP_BATCH_ENTRY *)Buffer2)->LinearAddress) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Add a range to be marked as not present in SMM page table.
+
+  A range beyond the maximum supported address is not added, as
+  ConvertMemoryPageAttributes () would reject it.
+
+  @param[in, out]  Entries          The array of ranges.
+  @param[in, out]  EntryCount       The number of ranges in Entries.
+  @param[in]       BaseAddress      The start address of the range.
+  @param[in]       Length           The size in bytes of the range.
+**/
+STATIC
+VOID
+AddNotPresentRange (
+  IN OUT IA32_MAP_BATCH_ENTRY  *Entries,
+  IN OUT UINTN                 *EntryCount,
+  IN     EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN     UINT64                Length
+  )
+{
+  UINT64  MaximumSupportMemAddress;
+
+  MaximumSupportMemAddress = LShiftU64 (1, mPhysicalAddressBits) - 1;
+  if ((Length == 0) || (BaseAddress > MaximumSupportMemAddress) || (Length - 1 > MaximumSupportMemAddress - BaseAddress)) {
+    return;
+  }
+
+  //
+  // When map a range to non-present, all attributes except Present should not be provided.
+  //
+  Entries[*EntryCount].LinearAddress     = BaseAddress;
+  Entries[*EntryCount].Length            = Length;
+  Entries[*EntryCount].Attribute.Uint64  = 0;
+  Entries[*EntryCount].Mask.Uint64       = 0;
+  Entries[*EntryCount].Mask.Bits.Present = 1;
+  (*EntryCount)++;
+}
+
 /**
   This function sets UEFI memory attribute according to UEFI memory map.
 
   The normal memory region is marked as not present, such as
   EfiLoaderCode/Data, EfiBootServicesCode/Data, EfiConventionalMemory,
   EfiUnusableMemory, EfiACPIReclaimMemory.
+
+  The ranges from the UEFI memory map, the GCD memory map and the UEFI memory
+  attributes table are sorted and merged before they are applied in one
+  PageTableMapBatch () call, so the page table is only split where the
+  accessibility changes, and the page directories left uniform are mapped by
+  2M or 1G pages again.
 **/
 VOID
 SetUefiMemMapAttributes (
   VOID
   )
 {
-  EFI_STATUS             Status;
+  RETURN_STATUS          Status;
   EFI_MEMORY_DESCRIPTOR  *MemoryMap;
   UINTN                  MemoryMapEntryCount;
   UINTN                  Index;
   EFI_MEMORY_DESCRIPTOR  *Entry;
   BOOLEAN                WpEnabled;
   BOOLEAN                CetEnabled;
+  IA32_MAP_BATCH_ENTRY   *Entries;
+  IA32_MAP_BATCH_ENTRY   TempEntry;
+  UINTN                  EntryCount;
+  UINTN                  MergedCount;
+  UINTN                  PageTable;
+  UINTN                  PageTableBufferSize;
+  VOID                   *PageTableBuffer;
+  BOOLEAN                IsModified;
 
   PERF_FUNCTION_BEGIN ();
 
   DEBUG ((DEBUG_INFO, "SetUefiMemMapAttributes\n"));
 
-  DisableReadOnlyPageWriteProtect (&WpEnabled, &CetEnabled);
+  MemoryMapEntryCount = (mUefiMemoryMap == NULL) ? 0 : mUefiMemoryMapSize / mUefiDescriptorSize;
+  EntryCount          = MemoryMapEntryCount + mGcdMemNumberOfDesc;
+  if (mUefiMemoryAttributesTable != NULL) {
+    EntryCount += mUefiMemoryAttributesTable->NumberOfEntries;
+  }
 
-  if (mUefiMemoryMap != NULL) {
-    MemoryMapEntryCount = mUefiMemoryMapSize/mUefiDescriptorSize;
-    MemoryMap           = mUefiMemoryMap;
-    for (Index = 0; Index < MemoryMapEntryCount; Index++) {
-      if (IsUefiPageNotPresent (MemoryMap)) {
-        Status = SmmSetMemoryAttributes (
-                   MemoryMap->PhysicalStart,
-                   EFI_PAGES_TO_SIZE ((UINTN)MemoryMap->NumberOfPages),
-                   EFI_MEMORY_RP
-                   );
-        DEBUG ((
-          DEBUG_INFO,
-          "UefiMemory protection: 0x%lx - 0x%lx %r\n",
-          MemoryMap->PhysicalStart,
-          MemoryMap->PhysicalStart + (UINT64)EFI_PAGES_TO_SIZE ((UINTN)MemoryMap->NumberOfPages),
-          Status
-          ));
-      }
+  if (EntryCount == 0) {
+    PERF_FUNCTION_END ();
+    return;
+  }
 
-      MemoryMap = NEXT_MEMORY_DESCRIPTOR (MemoryMap, mUefiDescriptorSize);
+  Entries = AllocatePool (EntryCount * sizeof (IA32_MAP_BATCH_ENTRY));
+  ASSERT (Entries != NULL);
+  if (Entries == NULL) {
+    PERF_FUNCTION_END ();
+    return;
+  }
+
+  EntryCount = 0;
+
+  MemoryMap = mUefiMemoryMap;
+  for (Index = 0; Index < MemoryMapEntryCount; Index++) {
+    if (IsUefiPageNotPresent (MemoryMap)) {
+      DEBUG ((
+        DEBUG_INFO,
+        "UefiMemory protection: 0x%lx - 0x%lx\n",
+        MemoryMap->PhysicalStart,
+        MemoryMap->PhysicalStart + (UINT64)EFI_PAGES_TO_SIZE ((UINTN)MemoryMap->NumberOfPages)
+        ));
+      AddNotPresentRange (Entries, &EntryCount, MemoryMap->PhysicalStart, EFI_PAGES_TO_SIZE ((UINTN)MemoryMap->NumberOfPages));
     }
+
+    MemoryMap = NEXT_MEMORY_DESCRIPTOR (MemoryMap, mUefiDescriptorSize);
   }
 
   //
@@ -1433,21 +1522,14 @@ SetUefiMemMapAttributes (
   //
   // Set untested memory as not present.
   //
-  if (mGcdMemSpace != NULL) {
-    for (Index = 0; Index < mGcdMemNumberOfDesc; Index++) {
-      Status = SmmSetMemoryAttributes (
-                 mGcdMemSpace[Index].BaseAddress,
-                 mGcdMemSpace[Index].Length,
-                 EFI_MEMORY_RP
-                 );
-      DEBUG ((
-        DEBUG_INFO,
-        "GcdMemory protection: 0x%lx - 0x%lx %r\n",
-        mGcdMemSpace[Index].BaseAddress,
-        mGcdMemSpace[Index].BaseAddress + mGcdMemSpace[Index].Length,
-        Status
-        ));
-    }
+  for (Index = 0; Index < mGcdMemNumberOfDesc; Index++) {
+    DEBUG ((
+      DEBUG_INFO,
+      "GcdMemory protection: 0x%lx - 0x%lx\n",
+      mGcdMemSpace[Index].BaseAddress,
+      mGcdMemSpace[Index].BaseAddress + mGcdMemSpace[Index].Length
+      ));
+    AddNotPresentRange (Entries, &EntryCount, mGcdMemSpace[Index].BaseAddress, mGcdMemSpace[Index].Length);
   }
 
   //
@@ -1462,18 +1544,13 @@ SetUefiMemMapAttributes (
     for (Index = 0; Index < mUefiMemoryAttributesTable->NumberOfEntries; Index++) {
       if ((Entry->Type == EfiRuntimeServicesCode) || (Entry->Type == EfiRuntimeServicesData)) {
         if ((Entry->Attribute & EFI_MEMORY_RO) != 0) {
-          Status = SmmSetMemoryAttributes (
-                     Entry->PhysicalStart,
-                     EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages),
-                     EFI_MEMORY_RP
-                     );
           DEBUG ((
             DEBUG_INFO,
-            "UefiMemoryAttribute protection: 0x%lx - 0x%lx %r\n",
+            "UefiMemoryAttribute protection: 0x%lx - 0x%lx\n",
             Entry->PhysicalStart,
-            Entry->PhysicalStart + (UINT64)EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages),
-            Status
+            Entry->PhysicalStart + (UINT64)EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages)
             ));
+          AddNotPresentRange (Entries, &EntryCount, Entry->PhysicalStart, EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages));
         }
       }
 
@@ -1481,12 +1558,53 @@ SetUefiMemMapAttributes (
     }
   }
 
-  EnableReadOnlyPageWriteProtect (WpEnabled, CetEnabled);
-
   //
   // Do not free mUefiMemoryAttributesTable, it will be checked in IsSmmCommBufferForbiddenAddress().
   //
 
+  //
+  // Merge the overlapping and adjacent ranges, so that no page is split at the
+  // boundary between two of them.
+  //
+  QuickSort (Entries, EntryCount, sizeof (IA32_MAP_BATCH_ENTRY), MapBatchEntryCompare, &TempEntry);
+  MergedCount = 0;
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((MergedCount != 0) &&
+        (Entries[Index].LinearAddress <= Entries[MergedCount - 1].LinearAddress + Entries[MergedCount - 1].Length))
+    {
+      Entries[MergedCount - 1].Length = MAX (
+                                          Entries[MergedCount - 1].Length,
+                                          Entries[Index].LinearAddress + Entries[Index].Length - Entries[MergedCount - 1].LinearAddress
+                                          );
+    } else {
+      CopyMem (&Entries[MergedCount], &Entries[Index], sizeof (IA32_MAP_BATCH_ENTRY));
+      MergedCount++;
+    }
+  }
+
+  DisableReadOnlyPageWriteProtect (&WpEnabled, &CetEnabled);
+
+  IsModified          = FALSE;
+  PageTable           = AsmReadCr3 () & PAGING_4K_ADDRESS_MASK_64;
+  PageTableBufferSize = 0;
+  Status              = PageTableMapBatch (&PageTable, mPagingMode, NULL, &PageTableBufferSize, Entries, MergedCount, NULL, NULL, &IsModified);
+  if (Status == RETURN_BUFFER_TOO_SMALL) {
+    PageTableBuffer = AllocatePageTableMemory (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+    ASSERT (PageTableBuffer != NULL);
+    Status = PageTableMapBatch (&PageTable, mPagingMode, PageTableBuffer, &PageTableBufferSize, Entries, MergedCount, NULL, NULL, &IsModified);
+  }
+
+  DEBUG ((DEBUG_INFO, "UefiMemory protection: %d ranges - %r\n", MergedCount, Status));
+  ASSERT_RETURN_ERROR (Status);
+
+  EnableReadOnlyPageWriteProtect (WpEnabled, CetEnabled);
+
+  if (IsModified) {
+    FlushTlbForAll ();
+  }
+
+  FreePool (Entries);
+
   PERF_FUNCTION_END ();
 }
 
@@ -1639,15 +1757,17 @@ GenSmmPageTable (
   IN UINT8        PhysicalAddressBits
   )
 {
-  UINTN               PageTableBufferSize;
-  UINTN               PageTable;
-  VOID                *PageTableBuffer;
-  IA32_MAP_ATTRIBUTE  MapAttribute;
-  IA32_MAP_ATTRIBUTE  MapMask;
-  RETURN_STATUS       Status;
-  UINTN               GuardPage;
-  UINTN               Index;
-  UINT64              Length;
+  UINTN                 PageTableBufferSize;
+  UINTN                 PageTable;
+  VOID                  *PageTableBuffer;
+  IA32_MAP_ATTRIBUTE    MapAttribute;
+  IA32_MAP_ATTRIBUTE    MapMask;
+  RETURN_STATUS         Status;
+  UINTN                 GuardPage;
+  UINTN                 Index;
+  UINT64                Length;
+  IA32_MAP_BATCH_ENTRY  *Entries;
+  UINTN                 EntryCount;
 
   Length                           = LShiftU64 (1, PhysicalAddressBits);
   PageTable                        = 0;
@@ -1669,23 +1789,53 @@ GenSmmPageTable (
   ASSERT (Status == RETURN_SUCCESS);
   ASSERT (PageTableBufferSize == 0);
 
+  //
+  // Collect the ranges to be marked as non-present in ascending order, and apply them
+  // in one PageTableMapBatch() call.
+  //
+  Entries = AllocateZeroPool ((gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus + 1) * sizeof (IA32_MAP_BATCH_ENTRY));
+  ASSERT (Entries != NULL);
+  EntryCount = 0;
+
+  if ((PcdGet8 (PcdNullPointerDetectionPropertyMask) & BIT1) != 0) {
+    //
+    // Mark [0, 4k] as non-present
+    //
+    Entries[EntryCount].LinearAddress = 0;
+    Entries[EntryCount].Length        = SIZE_4KB;
+    EntryCount++;
+  }
+
   if (FeaturePcdGet (PcdCpuSmmStackGuard)) {
     //
     // Mark the 4KB guard page between known good stack and smm stack as non-present
     //
     for (Index = 0; Index < gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus; Index++) {
-      GuardPage = mSmmStackArrayBase + EFI_PAGE_SIZE + Index * (mSmmStackSize + mSmmShadowStackSize);
-      Status    = ConvertMemoryPageAttributes (PageTable, PagingMode, GuardPage, SIZE_4KB, EFI_MEMORY_RP, TRUE, NULL);
+      GuardPage                         = mSmmStackArrayBase + EFI_PAGE_SIZE + Index * (mSmmStackSize + mSmmShadowStackSize);
+      Entries[EntryCount].LinearAddress = GuardPage;
+      Entries[EntryCount].Length        = SIZE_4KB;
+      EntryCount++;
     }
   }
 
-  if ((PcdGet8 (PcdNullPointerDetectionPropertyMask) & BIT1) != 0) {
-    //
-    // Mark [0, 4k] as non-present
-    //
-    Status = ConvertMemoryPageAttributes (PageTable, PagingMode, 0, SIZE_4KB, EFI_MEMORY_RP, TRUE, NULL);
+  //
+  // When map a range to non-present, all attributes except Present should not be provided.
+  //
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entries[Index].Mask.Bits.Present = 1;
   }
 
+  PageTableBufferSize = 0;
+  Status              = PageTableMapBatch (&PageTable, PagingMode, NULL, &PageTableBufferSize, Entries, EntryCount, NULL, NULL, NULL);
+  if (Status == RETURN_BUFFER_TOO_SMALL) {
+    PageTableBuffer = AllocatePageTableMemory (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+    ASSERT (PageTableBuffer != NULL);
+    Status = PageTableMapBatch (&PageTable, PagingMode, PageTableBuffer, &PageTableBufferSize, Entries, EntryCount, NULL, NULL, NULL);
+  }
+
+  ASSERT_RETURN_ERROR (Status);
+  FreePool (Entries);
+
   return (UINTN)PageTable;
 }
 
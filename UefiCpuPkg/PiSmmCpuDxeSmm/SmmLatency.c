@@ -0,0 +1,228 @@
+/** @file
+SMI latency histograms.
+
+Every processor only counts into the histograms it owns: its own SMI
+histogram, and the BSP of the current SMI the Rendezvous, Handler and
+ArrivalSkew ones. No lock or atomic operation is needed, and recording a
+duration costs a read of the performance counter and an increment.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCpuDxeSmm.h"
+
+#include <Library/SmmMemLib.h>
+
+SMM_LATENCY_HISTOGRAMS  *mSmmLatency        = NULL;
+UINT64                  *mSmmLatencyArrival = NULL;
+UINTN                   mSmmLatencyNumberOfCpus;
+BOOLEAN                 mSmmLatencyCountUp;
+
+/**
+  Count a duration into a histogram.
+
+  @param Histogram       The histogram.
+  @param Begin           The performance counter value at the beginning.
+  @param End             The performance counter value at the end.
+**/
+STATIC
+VOID
+SmmLatencyRecord (
+  IN OUT SMM_LATENCY_HISTOGRAM  Histogram,
+  IN     UINT64                 Begin,
+  IN     UINT64                 End
+  )
+{
+  UINT64  Duration;
+  INTN    Bucket;
+
+  Duration = mSmmLatencyCountUp ? End - Begin : Begin - End;
+  Bucket   = HighBitSet64 (Duration);
+  if (Bucket < 0) {
+    Bucket = 0;
+  } else if (Bucket >= SMM_LATENCY_HISTOGRAM_BUCKET_COUNT) {
+    Bucket = SMM_LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+  }
+
+  Histogram[Bucket]++;
+}
+
+/**
+  MM communication handler returning the histograms.
+
+  @param[in]     DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param[in]     Context         Points to an optional handler context which was specified when the
+                                 handler was registered.
+  @param[in,out] CommBuffer      A pointer to a collection of data in memory that will
+                                 be conveyed from a non-SMM environment into an SMM environment.
+  @param[in,out] CommBufferSize  The size of the CommBuffer.
+
+  @retval EFI_SUCCESS            The interrupt was handled and quiesced. No other handlers
+                                 should still be called.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+SmmLatencyHistogramHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  UINTN  TempCommBufferSize;
+
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  TempCommBufferSize = *CommBufferSize;
+  if (TempCommBufferSize < OFFSET_OF (SMM_LATENCY_HISTOGRAMS, Rendezvous)) {
+    DEBUG ((DEBUG_ERROR, "%a: SMM communication buffer size invalid!\n", __func__));
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((UINTN)CommBuffer, TempCommBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "%a: SMM communication buffer in SMRAM or overflow!\n", __func__));
+    return EFI_SUCCESS;
+  }
+
+  if (TempCommBufferSize < mSmmLatency->Size) {
+    CopyMem (CommBuffer, mSmmLatency, OFFSET_OF (SMM_LATENCY_HISTOGRAMS, Rendezvous));
+  } else {
+    CopyMem (CommBuffer, mSmmLatency, mSmmLatency->Size);
+    *CommBufferSize = mSmmLatency->Size;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Allocate the histograms and register the MM communication handler that
+  returns them.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmmLatency (
+  IN UINTN  NumberofCpus
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Size;
+  UINT64      StartValue;
+  UINT64      EndValue;
+  EFI_HANDLE  DispatchHandle;
+
+  Size               = sizeof (SMM_LATENCY_HISTOGRAMS) + NumberofCpus * sizeof (SMM_LATENCY_HISTOGRAM);
+  mSmmLatency        = AllocateZeroPool (Size);
+  mSmmLatencyArrival = AllocateZeroPool (NumberofCpus * sizeof (*mSmmLatencyArrival));
+  ASSERT ((mSmmLatency != NULL) && (mSmmLatencyArrival != NULL));
+
+  mSmmLatency->Size               = (UINT32)Size;
+  mSmmLatency->NumberOfProcessors = (UINT32)NumberofCpus;
+  mSmmLatency->Frequency          = GetPerformanceCounterProperties (&StartValue, &EndValue);
+  mSmmLatencyCountUp              = (BOOLEAN)(EndValue >= StartValue);
+  mSmmLatencyNumberOfCpus         = NumberofCpus;
+
+  Status = gSmst->SmiHandlerRegister (SmmLatencyHistogramHandler, &gEdkiiSmmLatencyHistogramGuid, &DispatchHandle);
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Record the SMI arrival of a processor that joined the synchronization.
+
+  @param CpuIndex        The index of the CPU.
+  @param Arrival         The performance counter value at the SMI entry.
+**/
+VOID
+SmmLatencyArrive (
+  IN UINTN   CpuIndex,
+  IN UINT64  Arrival
+  )
+{
+  mSmmLatencyArrival[CpuIndex] = Arrival;
+}
+
+/**
+  Record the time from the SMI entry of the BSP to the invocation of the SMI
+  handlers.
+
+  @param CpuIndex        The index of the BSP.
+
+  @return The performance counter value, the beginning of the SMI handlers.
+**/
+UINT64
+SmmLatencyBeginHandler (
+  IN UINTN  CpuIndex
+  )
+{
+  UINT64  Begin;
+
+  Begin = GetPerformanceCounter ();
+  SmmLatencyRecord (mSmmLatency->Rendezvous, mSmmLatencyArrival[CpuIndex], Begin);
+
+  return Begin;
+}
+
+/**
+  Record the time the SMI handlers took.
+
+  @param Begin           The value that SmmLatencyBeginHandler () returned.
+**/
+VOID
+SmmLatencyEndHandler (
+  IN UINT64  Begin
+  )
+{
+  SmmLatencyRecord (mSmmLatency->Handler, Begin, GetPerformanceCounter ());
+}
+
+/**
+  Record the arrival skew of the processors of the SMI, once they all left
+  APHandler () and the BSP is the only one to use the arrivals.
+**/
+VOID
+SmmLatencyCollectArrivals (
+  VOID
+  )
+{
+  UINTN   Index;
+  UINT64  First;
+
+  //
+  // The first arrival is the smallest value of a counter that counts up, the
+  // largest otherwise.
+  //
+  First = 0;
+  for (Index = 0; Index < mSmmLatencyNumberOfCpus; Index++) {
+    if ((mSmmLatencyArrival[Index] != 0) &&
+        ((First == 0) || (mSmmLatencyCountUp == (mSmmLatencyArrival[Index] < First))))
+    {
+      First = mSmmLatencyArrival[Index];
+    }
+  }
+
+  for (Index = 0; Index < mSmmLatencyNumberOfCpus; Index++) {
+    if (mSmmLatencyArrival[Index] != 0) {
+      SmmLatencyRecord (mSmmLatency->ArrivalSkew, First, mSmmLatencyArrival[Index]);
+      mSmmLatencyArrival[Index] = 0;
+    }
+  }
+}
+
+/**
+  Record the time a processor spent in the SMI.
+
+  @param CpuIndex        The index of the CPU.
+  @param Entry           The performance counter value at the SMI entry.
+**/
+VOID
+SmmLatencyExit (
+  IN UINTN   CpuIndex,
+  IN UINT64  Entry
+  )
+{
+  SmmLatencyRecord (mSmmLatency->Smi[CpuIndex], Entry, GetPerformanceCounter ());
+}
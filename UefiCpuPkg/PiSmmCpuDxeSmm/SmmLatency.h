@@ -0,0 +1,80 @@
+/** @file
+SMI latency histograms.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef SMM_LATENCY_H_
+#define SMM_LATENCY_H_
+
+#include <Guid/SmmLatencyHistogram.h>
+
+/**
+  Allocate the histograms and register the MM communication handler that
+  returns them.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmmLatency (
+  IN UINTN  NumberofCpus
+  );
+
+/**
+  Record the SMI arrival of a processor that joined the synchronization.
+
+  @param CpuIndex        The index of the CPU.
+  @param Arrival         The performance counter value at the SMI entry.
+**/
+VOID
+SmmLatencyArrive (
+  IN UINTN   CpuIndex,
+  IN UINT64  Arrival
+  );
+
+/**
+  Record the time from the SMI entry of the BSP to the invocation of the SMI
+  handlers.
+
+  @param CpuIndex        The index of the BSP.
+
+  @return The performance counter value, the beginning of the SMI handlers.
+**/
+UINT64
+SmmLatencyBeginHandler (
+  IN UINTN  CpuIndex
+  );
+
+/**
+  Record the time the SMI handlers took.
+
+  @param Begin           The value that SmmLatencyBeginHandler () returned.
+**/
+VOID
+SmmLatencyEndHandler (
+  IN UINT64  Begin
+  );
+
+/**
+  Record the arrival skew of the processors of the SMI, once they all left
+  APHandler () and the BSP is the only one to use the arrivals.
+**/
+VOID
+SmmLatencyCollectArrivals (
+  VOID
+  );
+
+/**
+  Record the time a processor spent in the SMI.
+
+  @param CpuIndex        The index of the CPU.
+  @param Entry           The performance counter value at the SMI entry.
+**/
+VOID
+SmmLatencyExit (
+  IN UINTN   CpuIndex,
+  IN UINT64  Entry
+  );
+
+#endif
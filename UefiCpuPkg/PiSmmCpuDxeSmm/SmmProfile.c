@@ -117,6 +117,13 @@ UINTN         mSplitMemRangeCount = 0;
 //
 UINT32  mSmiCommandPort;
 
+//
+// The number of samples each processor recorded, and the size of its ring
+// buffer, in the sampling mode.
+//
+UINT64  *mSmmProfileSampleCount;
+UINTN   mSmmProfileSamplesPerCpu;
+
 /**
   Disable branch trace store.
 
@@ -765,6 +772,152 @@ InitSmmProfileCallBack (
   return EFI_SUCCESS;
 }
 
+/**
+  Publish the SMM profile data of the sampling mode in SmmReadyToLock protocol
+  callback function, and start to record the samples.
+
+  @param  Protocol   Points to the protocol's unique identifier.
+  @param  Interface  Points to the interface instance.
+  @param  Handle     The handle on which the interface was installed.
+
+  @retval EFI_SUCCESS SmmReadyToLock protocol callback runs successfully.
+**/
+EFI_STATUS
+EFIAPI
+InitSmmProfileSamplingCallBack (
+  IN CONST EFI_GUID  *Protocol,
+  IN VOID            *Interface,
+  IN EFI_HANDLE      Handle
+  )
+{
+  //
+  // Save to variable so that SMM profile data can be found.
+  //
+  gRT->SetVariable (
+         SMM_PROFILE_NAME,
+         &gEfiCallerIdGuid,
+         EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+         sizeof (mSmmProfileBase),
+         &mSmmProfileBase
+         );
+
+  //
+  // Get Software SMI from FADT
+  //
+  GetSmiCommandPort ();
+
+  mSmmProfileStart = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initialize the SMM profile data structures of the sampling mode.
+
+  Nothing is trapped in this mode, each processor records a sample in its ring
+  buffer when it leaves an SMI.
+
+**/
+VOID
+InitSmmProfileSampling (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  Base;
+  VOID                  *Registration;
+
+  mSmmProfileSize = PcdGet32 (PcdCpuSmmProfileSize);
+  ASSERT ((mSmmProfileSize & 0xFFF) == 0);
+
+  mSmmProfileSamplesPerCpu = (mSmmProfileSize - sizeof (SMM_PROFILE_HEADER)) / sizeof (SMM_PROFILE_SAMPLE) / mMaxNumberOfCpus;
+  if (mSmmProfileSamplesPerCpu == 0) {
+    DEBUG ((DEBUG_ERROR, "%a: PcdCpuSmmProfileSize is too small for %d processors\n", __func__, mMaxNumberOfCpus));
+    return;
+  }
+
+  mSmmProfileSampleCount = (UINT64 *)AllocateZeroPool (sizeof (UINT64) * mMaxNumberOfCpus);
+  ASSERT (mSmmProfileSampleCount != NULL);
+  if (mSmmProfileSampleCount == NULL) {
+    return;
+  }
+
+  Base   = 0xFFFFFFFF;
+  Status = gBS->AllocatePages (
+                  AllocateMaxAddress,
+                  EfiReservedMemoryType,
+                  EFI_SIZE_TO_PAGES (mSmmProfileSize),
+                  &Base
+                  );
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    FreePool (mSmmProfileSampleCount);
+    mSmmProfileSampleCount = NULL;
+    return;
+  }
+
+  ZeroMem ((VOID *)(UINTN)Base, mSmmProfileSize);
+  mSmmProfileBase = (SMM_PROFILE_HEADER *)(UINTN)Base;
+
+  //
+  // Initialize SMM profile data header.
+  //
+  mSmmProfileBase->HeaderSize     = sizeof (SMM_PROFILE_HEADER);
+  mSmmProfileBase->MaxDataEntries = (UINT64)(mSmmProfileSamplesPerCpu * mMaxNumberOfCpus);
+  mSmmProfileBase->MaxDataSize    = MultU64x64 (mSmmProfileBase->MaxDataEntries, sizeof (SMM_PROFILE_SAMPLE));
+  mSmmProfileBase->TsegStart      = mCpuHotPlugData.SmrrBase;
+  mSmmProfileBase->TsegSize       = mCpuHotPlugData.SmrrSize;
+  mSmmProfileBase->NumCpus        = mMaxNumberOfCpus;
+  mSmmProfileBase->SamplesPerCpu  = mSmmProfileSamplesPerCpu;
+  mSmmProfileBase->Frequency      = GetPerformanceCounterProperties (NULL, NULL);
+
+  //
+  // Start SMM profile when SmmReadyToLock protocol is installed.
+  //
+  Status = gSmst->SmmRegisterProtocolNotify (
+                    &gEfiSmmReadyToLockProtocolGuid,
+                    InitSmmProfileSamplingCallBack,
+                    &Registration
+                    );
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Record the sample of a processor leaving an SMI, in the sampling mode.
+
+  @param  CpuIndex  The index of the processor.
+  @param  Entry     The performance counter value at the SMI entry.
+
+**/
+VOID
+SmmProfileRecordSample (
+  IN UINTN   CpuIndex,
+  IN UINT64  Entry
+  )
+{
+  SMM_PROFILE_SAMPLE  *Sample;
+  UINT64              Rip;
+
+  if (!mSmmProfileStart || (mSmmProfileSampleCount == NULL)) {
+    return;
+  }
+
+  Sample  = (SMM_PROFILE_SAMPLE *)(mSmmProfileBase + 1) + CpuIndex * mSmmProfileSamplesPerCpu;
+  Sample += (UINTN)ModU64x32 (mSmmProfileSampleCount[CpuIndex], (UINT32)mSmmProfileSamplesPerCpu);
+  mSmmProfileSampleCount[CpuIndex]++;
+
+  Rip = 0;
+  SmmReadSaveState (&mSmmCpu, sizeof (Rip), EFI_SMM_SAVE_STATE_REGISTER_RIP, CpuIndex, &Rip);
+
+  Sample->SmiNum = mSmmProfileBase->NumSmis;
+  Sample->CpuNum = CpuIndex;
+  Sample->ApicId = gSmmCpuPrivate->ProcessorInfo[CpuIndex].ProcessorId;
+  Sample->Entry  = Entry;
+  Sample->Exit   = GetPerformanceCounter ();
+  Sample->Rip    = Rip;
+  Sample->SmiCmd = (mSmiCommandPort == 0) ? 0 : IoRead8 (mSmiCommandPort);
+}
+
 /**
   Initialize SMM profile data structures.
 
@@ -1097,6 +1250,13 @@ InitSmmProfile (
       !HEAP_GUARD_NONSTOP_MODE &&
       !NULL_DETECTION_NONSTOP_MODE)
   {
+    //
+    // The sampling mode records the SMIs without trapping the accesses.
+    //
+    if (FeaturePcdGet (PcdCpuSmmProfileSampling)) {
+      InitSmmProfileSampling ();
+    }
+
     return;
   }
 
@@ -46,6 +46,19 @@ SmmProfileRecordSmiNum (
   VOID
   );
 
+/**
+  Record the sample of a processor leaving an SMI, in the sampling mode.
+
+  @param  CpuIndex  The index of the processor.
+  @param  Entry     The performance counter value at the SMI entry.
+
+**/
+VOID
+SmmProfileRecordSample (
+  IN UINTN   CpuIndex,
+  IN UINT64  Entry
+  );
+
 /**
   The Page fault handler to save SMM profile data.
 
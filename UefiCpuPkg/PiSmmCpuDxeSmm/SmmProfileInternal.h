@@ -84,6 +84,13 @@ typedef struct {
   UINT64    TsegSize;
   UINT64    NumSmis;
   UINT64    NumCpus;
+  //
+  // In the sampling mode, the number of SMM_PROFILE_SAMPLE in the ring buffer
+  // of each processor, and the frequency of the performance counter. 0 when
+  // the data entries are SMM_PROFILE_ENTRY.
+  //
+  UINT64    SamplesPerCpu;
+  UINT64    Frequency;
 } SMM_PROFILE_HEADER;
 
 typedef struct {
@@ -96,6 +103,21 @@ typedef struct {
   UINT64    SmiCmd;
 } SMM_PROFILE_ENTRY;
 
+//
+// A sample of the sampling mode, recorded by a processor when it leaves an
+// SMI. The ring buffer of processor N is the Nth group of SamplesPerCpu
+// samples after the header, the sample with the largest SmiNum is the last one.
+//
+typedef struct {
+  UINT64    SmiNum;
+  UINT64    CpuNum;
+  UINT64    ApicId;
+  UINT64    Entry;        // Performance counter value at the SMI entry.
+  UINT64    Exit;         // Performance counter value at the SMI exit.
+  UINT64    Rip;          // The RIP the SMI interrupted.
+  UINT64    SmiCmd;
+} SMM_PROFILE_SAMPLE;
+
 extern SMM_S3_RESUME_STATE  *mSmmS3ResumeState;
 extern UINTN                gSmiExceptionHandlers[];
 extern BOOLEAN              mXdSupported;
@@ -192,7 +192,7 @@ SmmInitPageTable (
   //
   // Initialize spin lock
   //
-  InitializeSpinLock (mPFLock);
+  InitializeMcsLock (mPFLock);
 
   mCpuSmmRestrictedMemoryAccess = PcdGetBool (PcdCpuSmmRestrictedMemoryAccess);
   m1GPageTableSupport           = Is1GPageSupport ();
@@ -850,14 +850,19 @@ SmiPFHandler (
   IN EFI_SYSTEM_CONTEXT  SystemContext
   )
 {
-  UINTN  PFAddress;
-  UINTN  GuardPageAddress;
-  UINTN  ShadowStackGuardPageAddress;
-  UINTN  CpuIndex;
+  UINTN          PFAddress;
+  UINTN          GuardPageAddress;
+  UINTN          ShadowStackGuardPageAddress;
+  UINTN          CpuIndex;
+  MCS_LOCK_NODE  PFLockNode;
 
   ASSERT (InterruptType == EXCEPT_IA32_PAGE_FAULT);
 
-  AcquireSpinLock (mPFLock);
+  //
+  // All the processors may take page faults at the same time, so queue them
+  // up on the MCS lock and let each of them wait on its own node.
+  //
+  AcquireMcsLock (mPFLock, &PFLockNode);
 
   PFAddress = AsmReadCr2 ();
 
@@ -971,7 +976,7 @@ SmiPFHandler (
   }
 
 Exit:
-  ReleaseSpinLock (mPFLock);
+  ReleaseMcsLock (mPFLock, &PFLockNode);
 }
 
 /**
@@ -282,49 +282,93 @@ IsHobNeed (
 }
 
 /**
-  It will build HOBs based on information from bootloaders.
+  Check whether the HOB list from bootloader can be used by payload in place,
+  and remove the HOBs that are needn't inside Payload from it if so.
 
-  @param[in]  BootloaderParameter   The starting memory address of bootloader parameter block.
-  @param[out] DxeFv                 The pointer to the DXE FV in memory.
+  The HOB list can be used in place if its PHIT HOB is in an available Resource
+  Descriptor, the free memory of the PHIT HOB is large enough for payload and
+  directly follows the end of the HOB list, and the HOB list has no FV HOB, so
+  the FV HOB of the DXE FV that is built later is still the first one.
 
-  @retval EFI_SUCCESS        If it completed successfully.
-  @retval Others             If it failed to build required HOBs.
+  @param[in] HobStart           The starting address of the HOB list from bootloader.
+  @param[in] PhitResourceHob    The Resource Descriptor HOB that contains the PHIT HOB range.
+  @param[in] MinimalNeededSize  The minimal size of the free memory needed by payload.
+
+  @retval TRUE  The HOB list is used in place. mHobList still points to it.
+  @retval FALSE The HOB list needs to be copied to a new HOB list.
 **/
-EFI_STATUS
-BuildHobs (
-  IN  UINTN                       BootloaderParameter,
-  OUT EFI_FIRMWARE_VOLUME_HEADER  **DxeFv
+BOOLEAN
+ReuseHobList (
+  IN VOID                         *HobStart,
+  IN EFI_HOB_RESOURCE_DESCRIPTOR  *PhitResourceHob,
+  IN UINTN                        MinimalNeededSize
   )
 {
-  EFI_PEI_HOB_POINTERS          Hob;
-  UINTN                         MinimalNeededSize;
-  EFI_PHYSICAL_ADDRESS          FreeMemoryBottom;
-  EFI_PHYSICAL_ADDRESS          FreeMemoryTop;
-  EFI_PHYSICAL_ADDRESS          MemoryBottom;
-  EFI_PHYSICAL_ADDRESS          MemoryTop;
-  EFI_HOB_RESOURCE_DESCRIPTOR   *PhitResourceHob;
-  EFI_HOB_RESOURCE_DESCRIPTOR   *ResourceHob;
-  UNIVERSAL_PAYLOAD_EXTRA_DATA  *ExtraData;
-  UINT8                         *GuidHob;
-  EFI_HOB_FIRMWARE_VOLUME       *FvHob;
-  UNIVERSAL_PAYLOAD_ACPI_TABLE  *AcpiTable;
-  ACPI_BOARD_INFO               *AcpiBoardInfo;
-  EFI_HOB_HANDOFF_INFO_TABLE    *HobInfo;
-  UINT8                         Idx;
+  EFI_PEI_HOB_POINTERS        Hob;
+  EFI_HOB_HANDOFF_INFO_TABLE  *HobInfo;
 
-  Hob.Raw           = (UINT8 *)BootloaderParameter;
-  MinimalNeededSize = FixedPcdGet32 (PcdSystemMemoryUefiRegionSize);
+  HobInfo = (EFI_HOB_HANDOFF_INFO_TABLE *)HobStart;
+  if (PhitResourceHob == NULL) {
+    return FALSE;
+  }
 
-  ASSERT (Hob.Raw != NULL);
-  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiFreeMemoryTop == Hob.HandoffInformationTable->EfiFreeMemoryTop);
-  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiMemoryTop == Hob.HandoffInformationTable->EfiMemoryTop);
-  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiFreeMemoryBottom == Hob.HandoffInformationTable->EfiFreeMemoryBottom);
-  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiMemoryBottom == Hob.HandoffInformationTable->EfiMemoryBottom);
+  if ((HobInfo->EfiFreeMemoryTop < HobInfo->EfiFreeMemoryBottom) ||
+      (HobInfo->EfiFreeMemoryTop - HobInfo->EfiFreeMemoryBottom < MinimalNeededSize) ||
+      (HobInfo->EfiEndOfHobList + sizeof (EFI_HOB_GENERIC_HEADER) > HobInfo->EfiFreeMemoryBottom))
+  {
+    return FALSE;
+  }
+
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_FV) {
+      return FALSE;
+    }
+  }
+
+  if ((UINTN)Hob.Raw != HobInfo->EfiEndOfHobList) {
+    return FALSE;
+  }
 
   //
-  // Try to find Resource Descriptor HOB that contains Hob range EfiMemoryBottom..EfiMemoryTop
+  // Mark the HOBs that are needn't inside Payload as unused instead of
+  // dropping them while copying. The PHIT HOB is kept as the PHIT HOB of payload.
   //
-  PhitResourceHob = FindResourceDescriptorByRange (Hob.Raw, Hob.HandoffInformationTable->EfiMemoryBottom, Hob.HandoffInformationTable->EfiMemoryTop);
+  for (Hob.Raw = GET_NEXT_HOB (HobStart); !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (!IsHobNeed (Hob)) {
+      Hob.Header->HobType = EFI_HOB_TYPE_UNUSED;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Create a new HOB list for payload, and copy the HOBs from bootloader to it.
+
+  @param[in] HobStart           The starting address of the HOB list from bootloader.
+  @param[in] PhitResourceHob    The Resource Descriptor HOB that contains the PHIT HOB range,
+                                or NULL if no available Resource Descriptor contains it.
+  @param[in] MinimalNeededSize  The minimal size of the free memory needed by payload.
+
+  @retval EFI_SUCCESS        The new HOB list was created. mHobList points to it.
+  @retval EFI_NOT_FOUND      No memory is large enough for the new HOB list.
+**/
+EFI_STATUS
+CopyHobList (
+  IN VOID                         *HobStart,
+  IN EFI_HOB_RESOURCE_DESCRIPTOR  *PhitResourceHob,
+  IN UINTN                        MinimalNeededSize
+  )
+{
+  EFI_PEI_HOB_POINTERS         Hob;
+  EFI_PHYSICAL_ADDRESS         FreeMemoryBottom;
+  EFI_PHYSICAL_ADDRESS         FreeMemoryTop;
+  EFI_PHYSICAL_ADDRESS         MemoryBottom;
+  EFI_PHYSICAL_ADDRESS         MemoryTop;
+  EFI_HOB_RESOURCE_DESCRIPTOR  *ResourceHob;
+  EFI_HOB_HANDOFF_INFO_TABLE   *HobInfo;
+
+  Hob.Raw = (UINT8 *)HobStart;
   if (PhitResourceHob == NULL) {
     //
     // Boot loader's Phit Hob is not in an available Resource Descriptor, find another Resource Descriptor for new Phit Hob
@@ -392,6 +436,62 @@ BuildHobs (
     Hob.Raw = GET_NEXT_HOB (Hob);
   }
 
+  return EFI_SUCCESS;
+}
+
+/**
+  It will build HOBs based on information from bootloaders.
+
+  @param[in]  BootloaderParameter   The starting memory address of bootloader parameter block.
+  @param[out] DxeFv                 The pointer to the DXE FV in memory.
+
+  @retval EFI_SUCCESS        If it completed successfully.
+  @retval Others             If it failed to build required HOBs.
+**/
+EFI_STATUS
+BuildHobs (
+  IN  UINTN                       BootloaderParameter,
+  OUT EFI_FIRMWARE_VOLUME_HEADER  **DxeFv
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_PEI_HOB_POINTERS          Hob;
+  UINTN                         MinimalNeededSize;
+  EFI_HOB_RESOURCE_DESCRIPTOR   *PhitResourceHob;
+  UNIVERSAL_PAYLOAD_EXTRA_DATA  *ExtraData;
+  UINT8                         *GuidHob;
+  EFI_HOB_FIRMWARE_VOLUME       *FvHob;
+  UNIVERSAL_PAYLOAD_ACPI_TABLE  *AcpiTable;
+  ACPI_BOARD_INFO               *AcpiBoardInfo;
+  UINT8                         Idx;
+
+  Hob.Raw           = (UINT8 *)BootloaderParameter;
+  MinimalNeededSize = FixedPcdGet32 (PcdSystemMemoryUefiRegionSize);
+
+  ASSERT (Hob.Raw != NULL);
+  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiFreeMemoryTop == Hob.HandoffInformationTable->EfiFreeMemoryTop);
+  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiMemoryTop == Hob.HandoffInformationTable->EfiMemoryTop);
+  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiFreeMemoryBottom == Hob.HandoffInformationTable->EfiFreeMemoryBottom);
+  ASSERT ((UINTN)Hob.HandoffInformationTable->EfiMemoryBottom == Hob.HandoffInformationTable->EfiMemoryBottom);
+
+  //
+  // Try to find Resource Descriptor HOB that contains Hob range EfiMemoryBottom..EfiMemoryTop
+  //
+  PhitResourceHob = FindResourceDescriptorByRange (Hob.Raw, Hob.HandoffInformationTable->EfiMemoryBottom, Hob.HandoffInformationTable->EfiMemoryTop);
+
+  if (FeaturePcdGet (PcdHandOffHobListInPlace) && ReuseHobList (Hob.Raw, PhitResourceHob, MinimalNeededSize)) {
+    DEBUG ((DEBUG_INFO, "Use the HOB list from boot loader in place\n"));
+    //
+    // Create an empty FvHob for the DXE FV that contains DXE core.
+    //
+    BuildFvHob ((EFI_PHYSICAL_ADDRESS)0, 0);
+  } else {
+    Status = CopyHobList (Hob.Raw, PhitResourceHob, MinimalNeededSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   //
   // Get DXE FV location
   //
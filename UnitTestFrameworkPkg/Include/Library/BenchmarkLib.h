@@ -0,0 +1,137 @@
+/** @file
+  Provides a microbenchmark harness for the unit tests.
+
+  RunBenchmark() calls a function in a loop, with enough iterations per sample
+  for the performance counter of TimerLib to measure the sample accurately,
+  runs warm-up samples that are not measured, and reports robust statistics of
+  the time of one call: the median and the median absolute deviation of the
+  samples, and the mean of the samples that are not outliers.
+
+  The statistics are recorded in the log of the running unit test as a line of
+  JSON, so that the result report of UnitTestLib lists them with the test, and
+  they can be extracted from the report and compared between builds:
+
+    [UT_INFO] BENCHMARK {"name":"...","iterations":N,"samples":N,"outliers":N,
+    "min_ns":X,"median_ns":X,"mean_ns":X,"max_ns":X,"deviation_ns":X}
+
+  The same benchmark runs in a host-based unit test, with the time of the host,
+  and in a target unit test, with the TimerLib instance of the platform, for
+  example the TSC or the generic timer counter.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __BENCHMARK_LIB_H__
+#define __BENCHMARK_LIB_H__
+
+#include <Library/UnitTestLib.h>
+
+///
+/// The default number of measured samples.
+///
+#define BENCHMARK_DEFAULT_SAMPLES  31
+
+///
+/// The default number of warm-up samples.
+///
+#define BENCHMARK_DEFAULT_WARM_UP_SAMPLES  3
+
+///
+/// The default minimum time of a sample, in nanoseconds.
+///
+#define BENCHMARK_DEFAULT_SAMPLE_TIME  1000000
+
+/**
+  The prototype of the function that a benchmark measures.
+
+  @param[in]  Context   The context passed to RunBenchmark().
+
+**/
+typedef
+VOID
+(EFIAPI *BENCHMARK_FUNCTION)(
+  IN VOID  *Context OPTIONAL
+  );
+
+///
+/// How a benchmark is run. Zero members take their default value.
+///
+typedef struct {
+  ///
+  /// The samples that are run before the measured samples, so that the caches,
+  /// the TLB and the branch predictors are warm, and the lazy initializations
+  /// of the function are done.
+  ///
+  UINT32    WarmUpSamples;
+  ///
+  /// The number of measured samples.
+  ///
+  UINT32    Samples;
+  ///
+  /// The minimum time of a sample in nanoseconds. The number of calls per
+  /// sample is doubled until a sample lasts at least this long.
+  ///
+  UINT64    SampleTime;
+} BENCHMARK_OPTIONS;
+
+///
+/// The statistics of a benchmark. The times are those of one call of the
+/// function, in picoseconds.
+///
+typedef struct {
+  ///
+  /// The number of calls in each sample.
+  ///
+  UINT64    Iterations;
+  ///
+  /// The number of measured samples, and the number of them that are outliers:
+  /// farther from the median than three times the estimated standard deviation.
+  ///
+  UINT32    Samples;
+  UINT32    Outliers;
+  UINT64    Minimum;
+  UINT64    Median;
+  ///
+  /// The mean of the samples that are not outliers.
+  ///
+  UINT64    Mean;
+  UINT64    Maximum;
+  ///
+  /// The median absolute deviation of the samples, scaled to estimate the
+  /// standard deviation of normally distributed samples.
+  ///
+  UINT64    Deviation;
+} BENCHMARK_RESULT;
+
+/**
+  Measure the time of a function, and record the statistics in the log of the
+  running unit test.
+
+  This function must be called from a unit test function.
+
+  @param[in]  Name      The name of the benchmark, recorded in the log.
+  @param[in]  Function  The function to measure.
+  @param[in]  Context   The context passed to Function.
+  @param[in]  Options   How the benchmark is run, NULL for the default options.
+  @param[out] Result    The statistics of the benchmark. Optional.
+
+  @retval EFI_SUCCESS            The benchmark ran, the statistics are recorded.
+  @retval EFI_INVALID_PARAMETER  Name or Function is NULL.
+  @retval EFI_OUT_OF_RESOURCES   The samples cannot be allocated.
+  @retval EFI_UNSUPPORTED        The performance counter of TimerLib does not
+                                 advance.
+
+**/
+EFI_STATUS
+EFIAPI
+RunBenchmark (
+  IN  CONST CHAR8              *Name,
+  IN  BENCHMARK_FUNCTION       Function,
+  IN  VOID                     *Context  OPTIONAL,
+  IN  CONST BENCHMARK_OPTIONS  *Options  OPTIONAL,
+  OUT BENCHMARK_RESULT         *Result   OPTIONAL
+  );
+
+#endif
@@ -0,0 +1,295 @@
+/** @file
+  Microbenchmark harness for the unit tests.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BenchmarkLib.h>
+
+///
+/// When this many calls take no time, the performance counter does not
+/// advance, as with the null TimerLib instance.
+///
+#define BENCHMARK_COUNTER_CHECK_ITERATIONS  SIZE_1MB
+
+///
+/// The number of calls per sample is not doubled anymore past this one.
+///
+#define BENCHMARK_MAX_ITERATIONS  BIT40
+
+/**
+  Compare two UINT64 for QuickSort().
+
+  @param[in] Buffer1  The first UINT64.
+  @param[in] Buffer2  The second UINT64.
+
+  @retval <0  The first is smaller.
+  @retval 0   They are equal.
+  @retval >0  The first is larger.
+
+**/
+STATIC
+INTN
+EFIAPI
+BenchmarkCompareUint64 (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  UINT64  Value1;
+  UINT64  Value2;
+
+  Value1 = *(CONST UINT64 *)Buffer1;
+  Value2 = *(CONST UINT64 *)Buffer2;
+  if (Value1 < Value2) {
+    return -1;
+  }
+
+  return (Value1 > Value2) ? 1 : 0;
+}
+
+/**
+  Sort an array of UINT64, and get its median.
+
+  @param[in, out] Values  The array.
+  @param[in]      Count   The number of values, not zero.
+
+  @return The median of the values.
+
+**/
+STATIC
+UINT64
+BenchmarkSortMedian (
+  IN OUT UINT64  *Values,
+  IN     UINTN   Count
+  )
+{
+  UINT64  Swap;
+
+  QuickSort (Values, Count, sizeof (UINT64), BenchmarkCompareUint64, &Swap);
+  if ((Count & 1) != 0) {
+    return Values[Count / 2];
+  }
+
+  return Values[Count / 2 - 1] + (Values[Count / 2] - Values[Count / 2 - 1]) / 2;
+}
+
+/**
+  Call the function of a benchmark in a loop, and measure the time.
+
+  @param[in] Function     The function to measure.
+  @param[in] Context      The context passed to Function.
+  @param[in] Iterations   The number of calls.
+
+  @return The time of the calls in nanoseconds.
+
+**/
+STATIC
+UINT64
+BenchmarkSample (
+  IN BENCHMARK_FUNCTION  Function,
+  IN VOID                *Context,
+  IN UINT64              Iterations
+  )
+{
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Ticks;
+  UINT64  Index;
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < Iterations; Index++) {
+    Function (Context);
+  }
+
+  End = GetPerformanceCounter ();
+
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterEnd >= CounterStart) {
+    if (End >= Start) {
+      Ticks = End - Start;
+    } else {
+      Ticks = (CounterEnd - Start) + (End - CounterStart) + 1;
+    }
+  } else {
+    if (Start >= End) {
+      Ticks = Start - End;
+    } else {
+      Ticks = (Start - CounterEnd) + (CounterStart - End) + 1;
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Measure the time of a function, and record the statistics in the log of the
+  running unit test.
+
+  This function must be called from a unit test function.
+
+  @param[in]  Name      The name of the benchmark, recorded in the log.
+  @param[in]  Function  The function to measure.
+  @param[in]  Context   The context passed to Function.
+  @param[in]  Options   How the benchmark is run, NULL for the default options.
+  @param[out] Result    The statistics of the benchmark. Optional.
+
+  @retval EFI_SUCCESS            The benchmark ran, the statistics are recorded.
+  @retval EFI_INVALID_PARAMETER  Name or Function is NULL.
+  @retval EFI_OUT_OF_RESOURCES   The samples cannot be allocated.
+  @retval EFI_UNSUPPORTED        The performance counter of TimerLib does not
+                                 advance.
+
+**/
+EFI_STATUS
+EFIAPI
+RunBenchmark (
+  IN  CONST CHAR8              *Name,
+  IN  BENCHMARK_FUNCTION       Function,
+  IN  VOID                     *Context  OPTIONAL,
+  IN  CONST BENCHMARK_OPTIONS  *Options  OPTIONAL,
+  OUT BENCHMARK_RESULT         *Result   OPTIONAL
+  )
+{
+  BENCHMARK_RESULT  Stats;
+  UINT32            WarmUpSamples;
+  UINT64            SampleTime;
+  UINT64            *Times;
+  UINT64            *Deviations;
+  UINT64            Elapsed;
+  UINT64            Limit;
+  UINT64            Sum;
+  UINT32            Index;
+
+  if ((Name == NULL) || (Function == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (&Stats, sizeof (Stats));
+  WarmUpSamples = BENCHMARK_DEFAULT_WARM_UP_SAMPLES;
+  Stats.Samples = BENCHMARK_DEFAULT_SAMPLES;
+  SampleTime    = BENCHMARK_DEFAULT_SAMPLE_TIME;
+  if (Options != NULL) {
+    if (Options->WarmUpSamples != 0) {
+      WarmUpSamples = Options->WarmUpSamples;
+    }
+
+    if (Options->Samples != 0) {
+      Stats.Samples = Options->Samples;
+    }
+
+    if (Options->SampleTime != 0) {
+      SampleTime = Options->SampleTime;
+    }
+  }
+
+  Times = AllocatePool (2 * Stats.Samples * sizeof (UINT64));
+  if (Times == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Deviations = Times + Stats.Samples;
+
+  //
+  // Double the calls of a sample until it is long enough for the resolution
+  // of the performance counter. The calibration also warms up the function.
+  //
+  Stats.Iterations = 1;
+  do {
+    Elapsed = BenchmarkSample (Function, Context, Stats.Iterations);
+    if ((Elapsed == 0) && (Stats.Iterations >= BENCHMARK_COUNTER_CHECK_ITERATIONS)) {
+      UT_LOG_ERROR ("BENCHMARK %a: the performance counter does not advance\n", Name);
+      FreePool (Times);
+      return EFI_UNSUPPORTED;
+    }
+
+    if ((Elapsed >= SampleTime) || (Stats.Iterations >= BENCHMARK_MAX_ITERATIONS)) {
+      break;
+    }
+
+    Stats.Iterations = LShiftU64 (Stats.Iterations, 1);
+  } while (TRUE);
+
+  for (Index = 0; Index < WarmUpSamples; Index++) {
+    BenchmarkSample (Function, Context, Stats.Iterations);
+  }
+
+  //
+  // The time of one call, in picoseconds, so that short functions keep their
+  // precision.
+  //
+  for (Index = 0; Index < Stats.Samples; Index++) {
+    Elapsed      = BenchmarkSample (Function, Context, Stats.Iterations);
+    Times[Index] = DivU64x64Remainder (MultU64x32 (Elapsed, 1000), Stats.Iterations, NULL);
+  }
+
+  //
+  // The median and the median absolute deviation are not skewed by the samples
+  // that an interrupt or an SMI made longer.
+  //
+  Stats.Median = BenchmarkSortMedian (Times, Stats.Samples);
+  for (Index = 0; Index < Stats.Samples; Index++) {
+    if (Times[Index] >= Stats.Median) {
+      Deviations[Index] = Times[Index] - Stats.Median;
+    } else {
+      Deviations[Index] = Stats.Median - Times[Index];
+    }
+  }
+
+  Stats.Deviation = DivU64x32 (MultU64x32 (BenchmarkSortMedian (Deviations, Stats.Samples), 14826), 10000);
+  Stats.Minimum   = Times[0];
+  Stats.Maximum   = Times[Stats.Samples - 1];
+
+  Limit = MultU64x32 (Stats.Deviation, 3);
+  Sum   = 0;
+  for (Index = 0; Index < Stats.Samples; Index++) {
+    if ((Times[Index] + Limit < Stats.Median) || (Times[Index] > Stats.Median + Limit)) {
+      Stats.Outliers++;
+    } else {
+      Sum += Times[Index];
+    }
+  }
+
+  //
+  // The median is never an outlier.
+  //
+  Stats.Mean = DivU64x32 (Sum, Stats.Samples - Stats.Outliers);
+
+  FreePool (Times);
+
+  UT_LOG_INFO (
+    "BENCHMARK {\"name\":\"%a\",\"iterations\":%lu,\"samples\":%u,\"outliers\":%u,"
+    "\"min_ns\":%lu.%03u,\"median_ns\":%lu.%03u,\"mean_ns\":%lu.%03u,\"max_ns\":%lu.%03u,\"deviation_ns\":%lu.%03u}\n",
+    Name,
+    Stats.Iterations,
+    Stats.Samples,
+    Stats.Outliers,
+    DivU64x32 (Stats.Minimum, 1000),
+    ModU64x32 (Stats.Minimum, 1000),
+    DivU64x32 (Stats.Median, 1000),
+    ModU64x32 (Stats.Median, 1000),
+    DivU64x32 (Stats.Mean, 1000),
+    ModU64x32 (Stats.Mean, 1000),
+    DivU64x32 (Stats.Maximum, 1000),
+    ModU64x32 (Stats.Maximum, 1000),
+    DivU64x32 (Stats.Deviation, 1000),
+    ModU64x32 (Stats.Deviation, 1000)
+    );
+
+  if (Result != NULL) {
+    CopyMem (Result, &Stats, sizeof (Stats));
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/** @file
+  This is a sample to demonstrate the usage of the Benchmark Library next to the
+  Unit Test Library, in the UEFI Shell and host execution environments.
+
+  Copyright (c) Microsoft Corporation.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/BenchmarkLib.h>
+
+#define UNIT_TEST_NAME     "Sample Benchmark"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define SAMPLE_BUFFER_SIZE  SIZE_4KB
+
+///
+/// Buffers copied and summed by the benchmarks
+///
+UINT32  mSampleSource[SAMPLE_BUFFER_SIZE / sizeof (UINT32)];
+UINT32  mSampleDestination[SAMPLE_BUFFER_SIZE / sizeof (UINT32)];
+UINT32  mSampleSum;
+
+/**
+  The function measured by the CopyMem() benchmark.
+
+  @param[in]  Context   The size to copy.
+
+**/
+VOID
+EFIAPI
+SampleCopyMem (
+  IN VOID  *Context
+  )
+{
+  CopyMem (mSampleDestination, mSampleSource, *(UINTN *)Context);
+}
+
+/**
+  The function measured by the CalculateSum32() benchmark.
+
+  @param[in]  Context   Not used.
+
+**/
+VOID
+EFIAPI
+SampleCalculateSum32 (
+  IN VOID  *Context
+  )
+{
+  mSampleSum = CalculateSum32 (mSampleSource, sizeof (mSampleSource));
+}
+
+/**
+  Benchmark CopyMem() of a 4 KB buffer, and check that it copied the buffer.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark did not run.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCopyMem (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Size;
+
+  SetMem32 (mSampleSource, sizeof (mSampleSource), 0x5A5A5A5A);
+  Size = sizeof (mSampleSource);
+  UT_ASSERT_NOT_EFI_ERROR (RunBenchmark ("CopyMem 4KB", SampleCopyMem, &Size, NULL, NULL));
+  UT_ASSERT_MEM_EQUAL (mSampleDestination, mSampleSource, sizeof (mSampleSource));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Benchmark CalculateSum32() of a 4 KB buffer, with more samples than the
+  default, and check the statistics.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The benchmark did not run.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkCalculateSum32 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BENCHMARK_OPTIONS  Options;
+  BENCHMARK_RESULT   Result;
+
+  ZeroMem (&Options, sizeof (Options));
+  Options.Samples = 101;
+  UT_ASSERT_NOT_EFI_ERROR (RunBenchmark ("CalculateSum32 4KB", SampleCalculateSum32, NULL, &Options, &Result));
+  UT_ASSERT_EQUAL (Result.Samples, 101);
+  UT_ASSERT_TRUE (Result.Minimum <= Result.Median);
+  UT_ASSERT_TRUE (Result.Median <= Result.Maximum);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and benchmarks for the sample
+  benchmarks and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the benchmarks.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Benchmark Suite.
+  //
+  Status = CreateUnitTestSuite (&BenchmarkTests, Framework, "Sample Benchmarks", "Sample.Benchmark", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BenchmarkTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (BenchmarkTests, "Benchmark CopyMem() of 4 KB", "CopyMem", BenchmarkCopyMem, NULL, NULL, NULL);
+  AddTestCase (BenchmarkTests, "Benchmark CalculateSum32() of 4 KB", "CalculateSum32", BenchmarkCalculateSum32, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard UEFI entry point for target based benchmark execution from UEFI Shell.
+**/
+EFI_STATUS
+EFIAPI
+DxeEntryPoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return UefiTestMain ();
+}
+
+/**
+  Standard POSIX C entry point for host based benchmark execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}